@@ -440,6 +440,197 @@ RsdsFakeFallback(PVOID Context, CHAR * PdbFile, SIZE_T PdbFileSize, GUID * Guid,
     return TRUE;
 }
 
+/**
+ * @brief Writes a fixture into a file and optionally sets its last write time
+ *
+ * @param Path The path of the file to write
+ * @param Buffer The contents of the file
+ * @param Size The size of the contents in bytes
+ * @param LastWriteTime The last write time to set, or 0 to keep the time of writing
+ *
+ * @return BOOLEAN TRUE if the file was written, FALSE otherwise
+ */
+static BOOLEAN
+RsdsWriteFixtureFile(const CHAR * Path, const BYTE * Buffer, SIZE_T Size, UINT64 LastWriteTime)
+{
+    DWORD    BytesWritten = 0;
+    FILETIME FileTime     = {(DWORD)LastWriteTime, (DWORD)(LastWriteTime >> 32)};
+    HANDLE   FileHandle   = CreateFileA(Path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    BOOLEAN IsWritten = WriteFile(FileHandle, Buffer, (DWORD)Size, &BytesWritten, NULL) && BytesWritten == Size;
+
+    if (IsWritten && LastWriteTime != 0)
+    {
+        IsWritten = SetFileTime(FileHandle, NULL, NULL, &FileTime);
+    }
+
+    CloseHandle(FileHandle);
+    return IsWritten;
+}
+
+/**
+ * @brief Checks that a file identity was read (or taken from the cache) as expected
+ *
+ * @param Path The path of the image file
+ * @param ExpectedHit Whether the identity is expected to be taken from the cache
+ * @param ExpectedAge The expected age of the RSDS record
+ *
+ * @return BOOLEAN TRUE if the identity matches the expected values, FALSE otherwise
+ */
+static BOOLEAN
+RsdsExpectCachedIdentity(const CHAR * Path, BOOLEAN ExpectedHit, DWORD ExpectedAge)
+{
+    SYMBOL_RSDS_IDENTITY Identity;
+    BOOLEAN              IsCacheHit = !ExpectedHit;
+
+    return SymRsdsCacheGetIdentity(Path, &Identity, &IsCacheHit) && IsCacheHit == ExpectedHit &&
+           Identity.IsRsdsFound && Identity.FileSize == RsdsFixtureSize && strcmp(Identity.PdbFile, "cached.pdb") == 0 &&
+           RsdsGuidEquals(Identity.Guid, RsdsGuid64) && Identity.Age == ExpectedAge;
+}
+
+/**
+ * @brief Runs the test cases of reading the identities from the image files and of their cache
+ *
+ * @param TestNum The number of the last test case, it's updated for each test case
+ *
+ * @return BOOLEAN TRUE if all test cases passed, FALSE if any test case failed
+ */
+static BOOLEAN
+RsdsTestFileIdentityCache(INT32 & TestNum)
+{
+    BYTE                 Buffer[RsdsFixtureSize] = {0};
+    CHAR                 TempPath[MAX_PATH]      = {0};
+    SYMBOL_RSDS_IDENTITY Identity;
+    BOOLEAN              IsPassed;
+
+    GetTempPathA(MAX_PATH, TempPath);
+
+    std::string ImagePath = std::string(TempPath) + "hyperdbg-rsds-test.dll";
+    std::string CachePath = std::string(TempPath) + "hyperdbg-rsds-test.cache";
+
+    DeleteFileA(CachePath.c_str());
+    SymRsdsCacheSetFilePath(CachePath.c_str());
+
+    RsdsBuildMinimalPe(Buffer, FALSE);
+    RsdsWriteValidDebugEntry(Buffer, RsdsGuid64, 7, "symbols\\valid64.pdb");
+    TestNum++;
+    if (RsdsWriteFixtureFile(ImagePath.c_str(), Buffer, sizeof(Buffer), 0) &&
+        SymReadRsdsIdentityFromFile(ImagePath.c_str(), &Identity) && Identity.IsRsdsFound &&
+        Identity.FileSize == RsdsFixtureSize && Identity.LastWriteTime != 0 && strcmp(Identity.PdbFile, "valid64.pdb") == 0 &&
+        RsdsGuidEquals(Identity.Guid, RsdsGuid64) && Identity.Age == 7)
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] mapped image file did not give the same identity as its bytes\n");
+        return FALSE;
+    }
+
+    ZeroMemory(Buffer, sizeof(Buffer));
+    TestNum++;
+    if (RsdsWriteFixtureFile(ImagePath.c_str(), Buffer, sizeof(Buffer), 0) &&
+        SymReadRsdsIdentityFromFile(ImagePath.c_str(), &Identity) && !Identity.IsRsdsFound)
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] image file without RSDS record was not read or reported an identity\n");
+        return FALSE;
+    }
+
+    //
+    // A fixed time, so the rewritten fixtures are not in the same tick
+    //
+    const UINT64 LastWriteTime = 0x01db000000000000ull;
+
+    RsdsBuildMinimalPe(Buffer, FALSE);
+    RsdsWriteValidDebugEntry(Buffer, RsdsGuid64, 3, "cached.pdb");
+    RsdsWriteFixtureFile(ImagePath.c_str(), Buffer, sizeof(Buffer), LastWriteTime);
+
+    TestNum++;
+    IsPassed = RsdsExpectCachedIdentity(ImagePath.c_str(), FALSE, 3) && RsdsExpectCachedIdentity(ImagePath.c_str(), TRUE, 3);
+    if (IsPassed)
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] unchanged image file was read again instead of using the cache\n");
+        return FALSE;
+    }
+
+    SymRsdsCacheUnload();
+    TestNum++;
+    if (RsdsExpectCachedIdentity(ImagePath.c_str(), TRUE, 3))
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] cached identity was not loaded from the cache file\n");
+        return FALSE;
+    }
+
+    RsdsWriteValidDebugEntry(Buffer, RsdsGuid64, 4, "cached.pdb");
+    RsdsWriteFixtureFile(ImagePath.c_str(), Buffer, sizeof(Buffer), LastWriteTime + 10000000);
+    TestNum++;
+    IsPassed = RsdsExpectCachedIdentity(ImagePath.c_str(), FALSE, 4);
+    SymRsdsCacheUnload();
+    if (IsPassed && RsdsExpectCachedIdentity(ImagePath.c_str(), TRUE, 4))
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] changed image file used its stale cached identity\n");
+        return FALSE;
+    }
+
+    RsdsWriteFixtureFile(CachePath.c_str(), (const BYTE *)"corrupted\tcache\n", sizeof("corrupted\tcache\n") - 1, 0);
+    SymRsdsCacheUnload();
+    TestNum++;
+    if (RsdsExpectCachedIdentity(ImagePath.c_str(), FALSE, 4) && RsdsExpectCachedIdentity(ImagePath.c_str(), TRUE, 4))
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] corrupted cache file was used or not rebuilt\n");
+        return FALSE;
+    }
+
+    DeleteFileA(ImagePath.c_str());
+    TestNum++;
+    if (!SymRsdsCacheGetIdentity(ImagePath.c_str(), &Identity, NULL))
+    {
+        printf("[+] Test number %d Passed\n", TestNum);
+    }
+    else
+    {
+        printf("[-] Test number %d Failed\n", TestNum);
+        printf("[x] missing image file reported a cached identity\n");
+        return FALSE;
+    }
+
+    DeleteFileA(CachePath.c_str());
+    SymRsdsCacheSetFilePath(NULL);
+
+    return TRUE;
+}
+
 /**
  * @brief Runs a series of test cases to validate the behavior of the RSDS parser helper functions
  *
@@ -928,5 +1119,5 @@ TestCodeViewRsdsParser()
         return FALSE;
     }
 
-    return TRUE;
+    return RsdsTestFileIdentityCache(TestNum);
 }
@@ -29,6 +29,8 @@ using namespace std;
 #include <string>
 #include <conio.h>
 #include <vector>
+#include <unordered_map>
+#include <algorithm>
 #include <regex>
 #include <sstream>
 #include <iomanip>
@@ -50,6 +52,7 @@ using namespace std;
 #include "header/testcases.h"
 #include "header/pdb-identity.h"
 #include "header/codeview-rsds.h"
+#include "header/rsds-reader.h"
 
 //
 // Components
@@ -13,6 +13,29 @@
 
 #if ActivateHyperEvadeProject != TRUE
 
+/**
+ * @brief Compile the matchers of the footprint lists
+ * when the Transparency mode is disabled
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TransparentCompileFootprintMatchers()
+{
+    return TRUE;
+}
+
+/**
+ * @brief Free the matchers of the footprint lists
+ * when the Transparency mode is disabled
+ *
+ * @return VOID
+ */
+VOID
+TransparentFreeFootprintMatchers()
+{
+}
+
 /**
  * @brief Handle The triggered hook on KiSystemCall64 system call handler
  * when the Transparency mode is disabled
@@ -54,6 +77,125 @@ TransparentCallbackHandleAfterSyscall(GUEST_REGS *                      Regs,
 
 #else  // ActivateHyperEvadeProject != TRUE
 
+/**
+ * @brief Compile a list of footprints into an automaton
+ *
+ * @param Automaton The automaton to be built
+ * @param Patterns The list of footprints
+ * @param NumberOfPatterns Number of the footprints
+ * @param Wide Whether the footprints are WCHAR strings
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+TransparentCompileFootprintMatcher(PAHO_CORASICK_AUTOMATON Automaton,
+                                   const VOID * const *    Patterns,
+                                   UINT32                  NumberOfPatterns,
+                                   BOOLEAN                 Wide)
+{
+    SIZE_T Size    = AhoCorasickGetRequiredSize(Patterns, NumberOfPatterns, Wide);
+    PVOID  Storage = NULL;
+
+    if (Size == 0)
+    {
+        return FALSE;
+    }
+
+    Storage = PlatformMemAllocateZeroedNonPagedPool(Size);
+
+    if (Storage == NULL)
+    {
+        return FALSE;
+    }
+
+    if (!AhoCorasickBuild(Automaton, Patterns, NumberOfPatterns, Wide, Storage, Size))
+    {
+        PlatformMemFreePool(Storage);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Compile the matchers of the footprint lists
+ * @details The matchers are compiled once and stay valid until the
+ * project is unloaded
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TransparentCompileFootprintMatchers()
+{
+    if (g_TransparentFootprintMatchers.Compiled)
+    {
+        return TRUE;
+    }
+
+    if (!TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.Files,
+                                            (const VOID * const *)HV_FILES,
+                                            sizeof(HV_FILES) / sizeof(HV_FILES[0]),
+                                            TRUE) ||
+        !TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.Directories,
+                                            (const VOID * const *)HV_DIRS,
+                                            sizeof(HV_DIRS) / sizeof(HV_DIRS[0]),
+                                            TRUE) ||
+        !TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.RegistryKeys,
+                                            (const VOID * const *)HV_REGKEYS,
+                                            sizeof(HV_REGKEYS) / sizeof(HV_REGKEYS[0]),
+                                            TRUE) ||
+        !TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.Drivers,
+                                            (const VOID * const *)HV_DRIVER,
+                                            sizeof(HV_DRIVER) / sizeof(HV_DRIVER[0]),
+                                            FALSE) ||
+        !TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.Processes,
+                                            (const VOID * const *)HV_PROCESSES,
+                                            sizeof(HV_PROCESSES) / sizeof(HV_PROCESSES[0]),
+                                            TRUE) ||
+        !TransparentCompileFootprintMatcher(&g_TransparentFootprintMatchers.FirmwareNames,
+                                            (const VOID * const *)HV_FIRM_NAMES,
+                                            sizeof(HV_FIRM_NAMES) / sizeof(HV_FIRM_NAMES[0]),
+                                            FALSE))
+    {
+        LogError("Err, unable to compile the transparent footprint matchers");
+
+        TransparentFreeFootprintMatchers();
+        return FALSE;
+    }
+
+    g_TransparentFootprintMatchers.Compiled = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the matchers of the footprint lists
+ *
+ * @return VOID
+ */
+VOID
+TransparentFreeFootprintMatchers()
+{
+    PAHO_CORASICK_AUTOMATON Automata[] = {
+        &g_TransparentFootprintMatchers.Files,
+        &g_TransparentFootprintMatchers.Directories,
+        &g_TransparentFootprintMatchers.RegistryKeys,
+        &g_TransparentFootprintMatchers.Drivers,
+        &g_TransparentFootprintMatchers.Processes,
+        &g_TransparentFootprintMatchers.FirmwareNames,
+    };
+
+    for (ULONG i = 0; i < (sizeof(Automata) / sizeof(Automata[0])); i++)
+    {
+        if (Automata[i]->Storage != NULL)
+        {
+            PlatformMemFreePool(Automata[i]->Storage);
+        }
+    }
+
+    memset(&g_TransparentFootprintMatchers, 0, sizeof(TRANSPARENT_FOOTPRINT_MATCHERS));
+}
+
 /**
  * @brief Handle The triggered hook on KiSystemCall64 system call handler
  * when the Transparency mode is enabled
@@ -361,18 +503,14 @@ TransparentHandleNtQueryAttributesFileSyscall(GUEST_REGS * Regs)
         //
         // If the file Attributes request is for a listed file, insert the SYSCALL trap flag and continue execution
         //
-        for (UINT16 j = 0; j < (sizeof(HV_FILES) / sizeof(HV_FILES[0])); j++)
+        if (FilePath != NULL &&
+            AhoCorasickContains(&g_TransparentFootprintMatchers.Files, FilePath, AHO_CORASICK_NULL_TERMINATED, TRUE))
         {
-            if (wcsstr(FilePath, HV_FILES[j]))
-            {
-                g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
-                                                                   HANDLE_TO_UINT32(PsGetCurrentProcessId()),
-                                                                   HANDLE_TO_UINT32(PsGetCurrentThreadId()),
-                                                                   Regs->rax,
-                                                                   &ContextParams);
-
-                break;
-            }
+            g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
+                                                               HANDLE_TO_UINT32(PsGetCurrentProcessId()),
+                                                               HANDLE_TO_UINT32(PsGetCurrentThreadId()),
+                                                               Regs->rax,
+                                                               &ContextParams);
         }
 
         //
@@ -417,18 +555,13 @@ TransparentHandleNtOpenDirectoryObjectSyscall(GUEST_REGS * Regs)
         //
         // If the directory object request is for a listed directory, insert the SYSCALL trap flag and continue execution
         //
-        for (UINT16 j = 0; j < (sizeof(HV_DIRS) / sizeof(HV_DIRS[0])); j++)
+        if (AhoCorasickContains(&g_TransparentFootprintMatchers.Directories, DirPath, AHO_CORASICK_NULL_TERMINATED, TRUE))
         {
-            if (wcsstr(DirPath, HV_DIRS[j]))
-            {
-                g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
-                                                                   HANDLE_TO_UINT32(PsGetCurrentProcessId()),
-                                                                   HANDLE_TO_UINT32(PsGetCurrentThreadId()),
-                                                                   Regs->rax,
-                                                                   &ContextParams);
-
-                break;
-            }
+            g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
+                                                               HANDLE_TO_UINT32(PsGetCurrentProcessId()),
+                                                               HANDLE_TO_UINT32(PsGetCurrentThreadId()),
+                                                               Regs->rax,
+                                                               &ContextParams);
         }
 
         //
@@ -522,31 +655,27 @@ TransparentHandleNtOpenFileSyscall(GUEST_REGS * Regs)
         // Check if the requested file includes any hypervisor specific strings
         // This also checks parent directory names of the requested file
         //
-        for (UINT16 j = 0; j < (sizeof(HV_FILES) / sizeof(HV_FILES[0])); j++)
+        if (AhoCorasickContains(&g_TransparentFootprintMatchers.Files, FileName, AHO_CORASICK_NULL_TERMINATED, TRUE))
         {
-            if (wcsstr(FileName, HV_FILES[j]))
-            {
-                LogInfo("A call to NtOpenFile systemcall for a hypervisor specific file was made");
-
-                //
-                // If a match was found, corrupt the user-mode pointers in CPU registers, so that, when the kernel-mode execution continues, it would fail.
-                //
-                Regs->r8  = 0x0;
-                Regs->r10 = 0x0;
+            LogInfo("A call to NtOpenFile systemcall for a hypervisor specific file was made");
 
-                //
-                // Set the trap flag to intercept the SYSRET instruction
-                //
-                SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
-                g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
-                                                                   HANDLE_TO_UINT32(PsGetCurrentProcessId()),
-                                                                   HANDLE_TO_UINT32(PsGetCurrentThreadId()),
-                                                                   Regs->rax,
-                                                                   &ContextParams);
+            //
+            // If a match was found, corrupt the user-mode pointers in CPU registers, so that, when the kernel-mode execution continues, it would fail.
+            //
+            Regs->r8  = 0x0;
+            Regs->r10 = 0x0;
 
-                break;
-            }
+            //
+            // Set the trap flag to intercept the SYSRET instruction
+            //
+            SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
+            g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
+                                                               HANDLE_TO_UINT32(PsGetCurrentProcessId()),
+                                                               HANDLE_TO_UINT32(PsGetCurrentThreadId()),
+                                                               Regs->rax,
+                                                               &ContextParams);
         }
+
         //
         // Clean up the allocated memory
         //
@@ -584,27 +713,22 @@ TransparentHandleNtOpenKeySyscall(GUEST_REGS * Regs)
         //
         // Check if the requested registry entry path includes any hypervisor specific strings
         //
-        for (UINT16 j = 0; j < (sizeof(HV_REGKEYS) / sizeof(HV_REGKEYS[0])); j++)
+        if (AhoCorasickContains(&g_TransparentFootprintMatchers.RegistryKeys, KeyName, AHO_CORASICK_NULL_TERMINATED, TRUE))
         {
-            if (wcsstr(KeyName, HV_REGKEYS[j]) > 0)
-            {
-                //
-                // If a match was found, corrupt the user-mode pointer in CPU registers, so that, when the kernel-mode execution continues, it would fail.
-                //
-                Regs->r8 = 0x0;
-
-                //
-                // Set the trap flag to intercept the SYSRET instruction
-                //
-                SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
-                g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
-                                                                   HANDLE_TO_UINT32(PsGetCurrentProcessId()),
-                                                                   HANDLE_TO_UINT32(PsGetCurrentThreadId()),
-                                                                   Regs->rax,
-                                                                   &ContextParams);
+            //
+            // If a match was found, corrupt the user-mode pointer in CPU registers, so that, when the kernel-mode execution continues, it would fail.
+            //
+            Regs->r8 = 0x0;
 
-                break;
-            }
+            //
+            // Set the trap flag to intercept the SYSRET instruction
+            //
+            SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
+            g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
+                                                               HANDLE_TO_UINT32(PsGetCurrentProcessId()),
+                                                               HANDLE_TO_UINT32(PsGetCurrentThreadId()),
+                                                               Regs->rax,
+                                                               &ContextParams);
         }
 
         //
@@ -614,6 +738,28 @@ TransparentHandleNtOpenKeySyscall(GUEST_REGS * Regs)
     }
 }
 
+/**
+ * @brief Stop the search of a registry key name on the first hypervisor specific
+ * string (the first entry of HV_REGKEYS is not checked for the names)
+ *
+ * @param Context Pointer to a BOOLEAN that is set if a match is found
+ * @param Match The match of the search
+ *
+ * @return BOOLEAN Whether the search should be continued or not
+ */
+static BOOLEAN
+TransparentStopOnRegistryKeyMatch(PVOID Context, const AHO_CORASICK_MATCH * Match)
+{
+    if (Match->PatternIndex == 0)
+    {
+        return TRUE;
+    }
+
+    *(BOOLEAN *)Context = TRUE;
+
+    return FALSE;
+}
+
 /**
  * @brief Handle The NtQueryValueKey system call
  * when the Transparent mode is enabled
@@ -722,30 +868,34 @@ TransparentHandleNtQueryValueKeySyscall(GUEST_REGS * Regs)
         // If the call was for a registry key that contains a hypervisor specific string,
         // The user-mode caller should just receive an error return code not a modified data buffer
         //
-        for (UINT16 j = 1; j < (sizeof(HV_REGKEYS) / sizeof(HV_REGKEYS[0])); j++)
-        {
-            if (wcsstr(KeyName, HV_REGKEYS[j]) > 0)
-            {
-                //
-                // When the match is found, corrupt the buffer pointers in the registers
-                // and set the SYSRET callback trap flag
-                //
-                SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
+        BOOLEAN MatchFound = FALSE;
 
-                Regs->rdx = 0x0;
-                Regs->r9  = 0x0;
+        AhoCorasickForEachMatch(&g_TransparentFootprintMatchers.RegistryKeys,
+                                KeyName,
+                                AHO_CORASICK_NULL_TERMINATED,
+                                TRUE,
+                                TransparentStopOnRegistryKeyMatch,
+                                &MatchFound);
 
-                //
-                // Set the trap flag to intercept the SYSRET instruction
-                //
-                g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
-                                                                   HANDLE_TO_UINT32(PsGetCurrentProcessId()),
-                                                                   HANDLE_TO_UINT32(PsGetCurrentThreadId()),
-                                                                   Regs->rax,
-                                                                   &ContextParams);
+        if (MatchFound)
+        {
+            //
+            // When the match is found, corrupt the buffer pointers in the registers
+            // and set the SYSRET callback trap flag
+            //
+            SYSCALL_CALLBACK_CONTEXT_PARAMS ContextParams = {0};
 
-                break;
-            }
+            Regs->rdx = 0x0;
+            Regs->r9  = 0x0;
+
+            //
+            // Set the trap flag to intercept the SYSRET instruction
+            //
+            g_Callbacks.SyscallCallbackSetTrapFlagAfterSyscall(Regs,
+                                                               HANDLE_TO_UINT32(PsGetCurrentProcessId()),
+                                                               HANDLE_TO_UINT32(PsGetCurrentThreadId()),
+                                                               Regs->rax,
+                                                               &ContextParams);
         }
 
         //
@@ -845,26 +995,21 @@ TransparentHandleModuleInformationQuery(PVOID Ptr, UINT64 VirtualAddress, UINT32
     {
         PCHAR Path = (PCHAR)ModuleList[i].FullPathName;
 
-        for (UINT16 j = 0; j < (sizeof(HV_DRIVER) / sizeof(HV_DRIVER[0])); j++)
+        if (AhoCorasickContains(&g_TransparentFootprintMatchers.Drivers, Path, AHO_CORASICK_NULL_TERMINATED, FALSE))
         {
-            if (strstr(Path, HV_DRIVER[j]))
+            //
+            // If a module file name matches, remove the entry from the list by shifting it forward by one entry
+            //
+            for (UINT16 k = i; k < StructBuf->Count - 1; k++)
             {
-                //
-                // If a module file name matches, remove the entry from the list by shifting it forward by one entry
-                //
-                for (UINT16 k = i; k < StructBuf->Count - 1; k++)
-                {
-                    ModuleList[k] = ModuleList[k + 1];
-                }
-
-                //
-                // Decrement the list size as one entry has been removed
-                //
-                i--;
-                StructBuf->Count--;
-
-                break;
+                ModuleList[k] = ModuleList[k + 1];
             }
+
+            //
+            // Decrement the list size as one entry has been removed
+            //
+            i--;
+            StructBuf->Count--;
         }
     }
     if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(VirtualAddress, Ptr, BufferSize))
@@ -953,46 +1098,45 @@ TransparentHandleProcessInformationQuery(SYSCALL_CALLBACK_CONTEXT_PARAMS * Param
             }
 
             //
-            // Loop through the known list of identifiable hypervisor related processes
+            // Check the known list of identifiable hypervisor related processes
             //
-            for (UINT16 i = 0; i < (sizeof(HV_PROCESSES) / sizeof(HV_PROCESSES[0])); i++)
+            if (AhoCorasickMatchesWhole(&g_TransparentFootprintMatchers.Processes,
+                                        ImageName,
+                                        CurStructBuf.ImageName.Length / sizeof(WCHAR),
+                                        TRUE,
+                                        NULL))
             {
-                if (!_wcsnicmp(ImageName, HV_PROCESSES[i], (CurStructBuf.ImageName.Length) / sizeof(WCHAR)))
-                {
-                    //
-                    // If the name matches, bypass it by increasing the previous entries .nextEntryOffset value
-                    //
-
-                    //
-                    // The offset to this matching entry need to preserved for zeroing later
-                    //
-                    PrevOffset = PrevStructBuf.NextEntryOffset;
+                //
+                // If the name matches, bypass it by increasing the previous entries .nextEntryOffset value
+                //
 
-                    PrevStructBuf.NextEntryOffset = PrevStructBuf.NextEntryOffset + CurStructBuf.NextEntryOffset;
+                //
+                // The offset to this matching entry need to preserved for zeroing later
+                //
+                PrevOffset = PrevStructBuf.NextEntryOffset;
 
-                    MatchFound = TRUE;
+                PrevStructBuf.NextEntryOffset = PrevStructBuf.NextEntryOffset + CurStructBuf.NextEntryOffset;
 
-                    //
-                    // Write the modified offset back to the usermode buffer
-                    //
-                    if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess((UINT64)(Params->OptionalParam2 + WriteOffset), &PrevStructBuf, sizeof(SYSTEM_PROCESS_INFORMATION)))
-                    {
-                        LogError("Failed to modify memory buffer for the SystemProcessInformation query system call");
-                    }
+                MatchFound = TRUE;
 
-                    //
-                    // The entry gets bypassed, but since the Image name is a pointer in the struct, to completely clear any presence of these processes
-                    // zero out the name buffer as well
-                    //
-                    memset(StringBuf, 0x0, CurStructBuf.ImageName.Length);
-                    ULONG BufOffset = (ULONG)((PBYTE)&CurStructBuf.ImageName.Length - (PBYTE)&CurStructBuf) + sizeof(USHORT);
+                //
+                // Write the modified offset back to the usermode buffer
+                //
+                if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess((UINT64)(Params->OptionalParam2 + WriteOffset), &PrevStructBuf, sizeof(SYSTEM_PROCESS_INFORMATION)))
+                {
+                    LogError("Failed to modify memory buffer for the SystemProcessInformation query system call");
+                }
 
-                    if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess((UINT64)(Params->OptionalParam2 + WriteOffset + PrevOffset + BufOffset), StringBuf, CurStructBuf.ImageName.Length))
-                    {
-                        LogError("Failed to modify memory buffer for the SystemProcessInformation query system call");
-                    }
+                //
+                // The entry gets bypassed, but since the Image name is a pointer in the struct, to completely clear any presence of these processes
+                // zero out the name buffer as well
+                //
+                memset(StringBuf, 0x0, CurStructBuf.ImageName.Length);
+                ULONG BufOffset = (ULONG)((PBYTE)&CurStructBuf.ImageName.Length - (PBYTE)&CurStructBuf) + sizeof(USHORT);
 
-                    break;
+                if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess((UINT64)(Params->OptionalParam2 + WriteOffset + PrevOffset + BufOffset), StringBuf, CurStructBuf.ImageName.Length))
+                {
+                    LogError("Failed to modify memory buffer for the SystemProcessInformation query system call");
                 }
             }
 
@@ -1132,101 +1276,111 @@ TransparentHandleFirmwareInformationQuery(UINT64 Ptr, UINT32 BufMaxSize, UINT64
          StructBuf->ProviderSignature == 0x41435049 ||
          StructBuf->ProviderSignature == 0x4649524D))
     {
-        PCHAR StringBuf = (PCHAR)StructBuf->TableBuffer;
+        PCHAR              StringBuf = (PCHAR)StructBuf->TableBuffer;
+        AHO_CORASICK_MATCH Match     = {0};
+        ULONG              Offset    = 0;
 
-        for (ULONG i = 0; i < (sizeof(HV_FIRM_NAMES) / sizeof(HV_FIRM_NAMES[0])); i++)
+        //
+        // Scan the table once for all of the known names, continuing after each replacement
+        //
+        while (Offset < StructBuf->TableBufferLength &&
+               AhoCorasickFindFirst(&g_TransparentFootprintMatchers.FirmwareNames,
+                                    StringBuf + Offset,
+                                    StructBuf->TableBufferLength - Offset,
+                                    FALSE,
+                                    &Match))
         {
-            for (ULONG j = 0; j < StructBuf->TableBufferLength; j++)
+            WORD  Count      = 0;
+            PCHAR MatchStart = StringBuf + Offset + Match.Offset;
+
+            LogInfo("Found Match for %s", HV_FIRM_NAMES[Match.PatternIndex]);
+
+            PCHAR NewVendorString  = NULL;
+            ULONG NewSubstringSize = 0;
+
+            //
+            // Replace the first occurace of the vendor string with AMERICAN MEGATRENDS INC.
+            // The rest with To Be Filled By O.E.M.
+            //
+            if (Count == 0)
             {
-                WORD  Count      = 0;
-                PCHAR MatchStart = strstr(StringBuf + j, HV_FIRM_NAMES[i]);
-                if (MatchStart != 0)
-                {
-                    LogInfo("Found Match for %s", HV_FIRM_NAMES[i]);
+                NewVendorString  = "AMERICAN MEGATRENDS INC.";
+                NewSubstringSize = 24 * sizeof(CHAR);
+            }
+            else
+            {
+                NewVendorString  = "To Be Filled By O.E.M.";
+                NewSubstringSize = 22 * sizeof(CHAR);
+            }
 
-                    PCHAR NewVendorString  = NULL;
-                    ULONG NewSubstringSize = 0;
+            //
+            // Obtain the lengths of all the strings and substring
+            //
 
-                    //
-                    // Replace the first occurace of the vendor string with AMERICAN MEGATRENDS INC.
-                    // The rest with To Be Filled By O.E.M.
-                    //
-                    if (Count == 0)
-                    {
-                        NewVendorString  = "AMERICAN MEGATRENDS INC.";
-                        NewSubstringSize = 24 * sizeof(CHAR);
-                    }
-                    else
-                    {
-                        NewVendorString  = "To Be Filled By O.E.M.";
-                        NewSubstringSize = 22 * sizeof(CHAR);
-                    }
+            ULONG MatchedStringLen = Match.Length;
+            ULONG OldLength        = StructBuf->TableBufferLength;
 
-                    //
-                    // Obtain the lengths of all the strings and substring
-                    //
+            ULONG NewStringSize = OldLength - MatchedStringLen + NewSubstringSize;
 
-                    ULONG MatchedStringLen = (ULONG)strlen(HV_FIRM_NAMES[i]);
-                    ULONG OldLength        = StructBuf->TableBufferLength;
+            //
+            // Check if the buffer size allows the modification, in case of expansion
+            //
+            if (BufSize - MatchedStringLen + NewSubstringSize > BufMaxSize)
+            {
+                //
+                // If adding the new string exceeds the user allocated size,
+                // zero out the buffer
+                //
+                memset(Buf, 0x0, BufMaxSize);
+                g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Ptr, Buf, BufMaxSize);
 
-                    ULONG NewStringSize = OldLength - MatchedStringLen + NewSubstringSize;
+                //
+                // Update the required buffer size for the next call
+                //
+                BufSize = (BufSize - OldLength) + NewStringSize;
+                g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(BufSizePtr, &BufSize, sizeof(ULONG));
 
-                    //
-                    // Check if the buffer size allows the modification, in case of expansion
-                    //
-                    if (BufSize - MatchedStringLen + NewSubstringSize > BufMaxSize)
-                    {
-                        //
-                        // If adding the new string exceeds the user allocated size,
-                        // zero out the buffer
-                        //
-                        memset(Buf, 0x0, BufMaxSize);
-                        g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Ptr, Buf, BufMaxSize);
-
-                        //
-                        // Update the required buffer size for the next call
-                        //
-                        BufSize = (BufSize - OldLength) + NewStringSize;
-                        g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(BufSizePtr, &BufSize, sizeof(ULONG));
-
-                        //
-                        // And return STATUS_BUFFER_TOO_SMALL error
-                        //
-
-                        PlatformMemFreePool(Buf);
-                        return (UINT64)(UINT32)STATUS_BUFFER_TOO_SMALL;
-                    }
+                //
+                // And return STATUS_BUFFER_TOO_SMALL error
+                //
 
-                    //
-                    // Calculate the positions of the replacement
-                    //
-                    ULONG MatchOffset = (ULONG)((MatchStart - StringBuf));
-                    PCHAR MatchEnd    = StringBuf + MatchOffset + MatchedStringLen;
+                PlatformMemFreePool(Buf);
+                return (UINT64)(UINT32)STATUS_BUFFER_TOO_SMALL;
+            }
 
-                    //
-                    // Move the data after the matched string forward
-                    // and replace the identified hypervisor string with the genuine one
-                    //
-                    memmove((PVOID)(StringBuf + MatchOffset + NewSubstringSize), (PVOID)MatchEnd, OldLength - MatchedStringLen - MatchOffset);
-                    memcpy((PVOID)MatchStart, (PVOID)NewVendorString, NewSubstringSize);
+            //
+            // Calculate the positions of the replacement
+            //
+            ULONG MatchOffset = (ULONG)((MatchStart - StringBuf));
+            PCHAR MatchEnd    = StringBuf + MatchOffset + MatchedStringLen;
 
-                    StructBuf->TableBufferLength = NewStringSize;
-                    BufSize                      = BufSize - MatchedStringLen + NewSubstringSize;
+            //
+            // Move the data after the matched string forward
+            // and replace the identified hypervisor string with the genuine one
+            //
+            memmove((PVOID)(StringBuf + MatchOffset + NewSubstringSize), (PVOID)MatchEnd, OldLength - MatchedStringLen - MatchOffset);
+            memcpy((PVOID)MatchStart, (PVOID)NewVendorString, NewSubstringSize);
 
-                    //
-                    // Write the changes back to the user buffers
-                    //
-                    if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Ptr, Buf, BufSize))
-                    {
-                        LogInfo("Error writing to user-mode buffer: %llx", Ptr);
-                    }
-
-                    if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(BufSizePtr, &BufSize, sizeof(ULONG)))
-                    {
-                        LogInfo("Error writing to user-mode buffer: %llx", BufSizePtr);
-                    }
-                }
+            StructBuf->TableBufferLength = NewStringSize;
+            BufSize                      = BufSize - MatchedStringLen + NewSubstringSize;
+
+            //
+            // Write the changes back to the user buffers
+            //
+            if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Ptr, Buf, BufSize))
+            {
+                LogInfo("Error writing to user-mode buffer: %llx", Ptr);
             }
+
+            if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(BufSizePtr, &BufSize, sizeof(ULONG)))
+            {
+                LogInfo("Error writing to user-mode buffer: %llx", BufSizePtr);
+            }
+
+            //
+            // Continue right after the new string
+            //
+            Offset = MatchOffset + NewSubstringSize;
         }
     }
 
@@ -1315,122 +1469,122 @@ TransparentReplaceVendorStringFromBufferWChar(SYSCALL_CALLBACK_CONTEXT_PARAMS *
         PWCH StringBuf = (PWCH)((PBYTE)Buf + DataOffset);
 
         //
-        // Traverse the list of registry key names and vendor strings that are specific to common hypervisors
-        // if a match is found perform the modification
+        // Scan the data once for all of the registry key names and vendor strings that are specific to
+        // common hypervisors, if a match is found perform the modification and continue after it
         //
-        for (UINT16 i = 0; i < (sizeof(HV_REGKEYS) / sizeof(HV_REGKEYS[0])); i++)
+        AHO_CORASICK_MATCH Match  = {0};
+        ULONG              Offset = 0;
+
+        while (AhoCorasickFindFirst(&g_TransparentFootprintMatchers.RegistryKeys,
+                                    StringBuf + Offset,
+                                    AHO_CORASICK_NULL_TERMINATED,
+                                    TRUE,
+                                    &Match))
         {
-            PWCH MatchStart = wcsstr(StringBuf, HV_REGKEYS[i]);
+            UINT32 i               = Match.PatternIndex;
+            PWCH   MatchStart      = StringBuf + Offset + Match.Offset;
+            PWCH   NewVendorString = NULL;
 
-            while (MatchStart != 0)
+            //
+            // If the match was for a device id, the replacement should be with a different ID string not vendor name
+            //
+            if (i < 3)
             {
-                PWCH NewVendorString = NULL;
-
                 //
-                // If the match was for a device id, the replacement should be with a different ID string not vendor name
+                // SPOOFS PCI device ID's(in the registry), This might be implemented in other ways that are not part of this implementation
                 //
-                if (i < 3)
-                {
-                    //
-                    // SPOOFS PCI device ID's(in the registry), This might be implemented in other ways that are not part of this implementation
-                    //
-                    WORD Idx        = g_TransparentGenuineVendorStringIndex % (sizeof(TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR) / sizeof(TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR[0]));
-                    NewVendorString = TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR[Idx];
-                }
+                WORD Idx        = g_TransparentGenuineVendorStringIndex % (sizeof(TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR) / sizeof(TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR[0]));
+                NewVendorString = TRANSPARENT_LEGIT_DEVICE_ID_VENDOR_STRINGS_WCHAR[Idx];
+            }
 
+            //
+            // Remove common VM strings from the data
+            //
+            else if (i < 9)
+            {
+                NewVendorString = L" ";
+            }
+            else
+            {
                 //
-                // Remove common VM strings from the data
+                // Obtain the replacement vendor name string, randomized when the transparency mode was enabled
                 //
-                else if (i < 9)
-                {
-                    NewVendorString = L" ";
-                }
-                else
-                {
-                    //
-                    // Obtain the replacement vendor name string, randomized when the transparency mode was enabled
-                    //
-                    NewVendorString = TRANSPARENT_LEGIT_VENDOR_STRINGS_WCHAR[g_TransparentGenuineVendorStringIndex];
-                }
+                NewVendorString = TRANSPARENT_LEGIT_VENDOR_STRINGS_WCHAR[g_TransparentGenuineVendorStringIndex];
+            }
 
-                //
-                // Obtain the lengths of all the strings and substring
-                //
-                ULONG TempSize = (ULONG)wcslen(NewVendorString) * sizeof(WCHAR);
+            //
+            // Obtain the lengths of all the strings and substring
+            //
+            ULONG TempSize = (ULONG)wcslen(NewVendorString) * sizeof(WCHAR);
 
-                ULONG MatchedStringLen = (ULONG)wcslen(HV_REGKEYS[i]) * sizeof(WCHAR);
-                ULONG OldLength        = *((PBYTE)Buf + DataLenOffset);
+            ULONG MatchedStringLen = Match.Length * sizeof(WCHAR);
+            ULONG OldLength        = *((PBYTE)Buf + DataLenOffset);
 
-                ULONG NewStringSize = OldLength - MatchedStringLen + TempSize;
+            ULONG NewStringSize = OldLength - MatchedStringLen + TempSize;
 
+            //
+            // Check if the buffer size allows the modification, in case of expansion
+            //
+            if (BufSize - MatchedStringLen + TempSize > Params->OptionalParam3)
+            {
                 //
-                // Check if the buffer size allows the modification, in case of expansion
+                // If adding the new string exceeds the user allocated size,
+                // zero out the buffer
                 //
-                if (BufSize - MatchedStringLen + TempSize > Params->OptionalParam3)
-                {
-                    //
-                    // If adding the new string exceeds the user allocated size,
-                    // zero out the buffer
-                    //
-                    memset(Buf, 0x0, Params->OptionalParam3);
-                    g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam2, Buf, Params->OptionalParam3);
-
-                    //
-                    // Update the required buffer size for the next call
-                    //
-                    BufSize = (TempSize - MatchedStringLen) + OldLength;
-                    g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam4, &BufSize, sizeof(ULONG));
-
-                    //
-                    // And return STATUS_BUFFER_OVERFLOW error
-                    //
-
-                    if (PoolAlloc)
-                        PlatformMemFreePool(Buf);
-                    return (UINT64)(UINT32)STATUS_BUFFER_OVERFLOW;
-                }
+                memset(Buf, 0x0, Params->OptionalParam3);
+                g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam2, Buf, Params->OptionalParam3);
 
                 //
-                // Calculate the positions of the replacement
+                // Update the required buffer size for the next call
                 //
-                ULONG MatchOffset = (ULONG)((MatchStart - StringBuf));
-                PWCH  MatchEnd    = StringBuf + MatchOffset + (MatchedStringLen / sizeof(WCHAR));
+                BufSize = (TempSize - MatchedStringLen) + OldLength;
+                g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam4, &BufSize, sizeof(ULONG));
 
                 //
-                // Move the data after the matched string forward
+                // And return STATUS_BUFFER_OVERFLOW error
                 //
-                memmove((PVOID)(StringBuf + MatchOffset + (TempSize / sizeof(WCHAR))), (PVOID)MatchEnd, OldLength - MatchedStringLen - (MatchOffset * sizeof(WCHAR)));
 
-                //
-                // Replace the identified hypervisor string with the genuine one, if needed
-                //
-                memcpy((PVOID)MatchStart, (PVOID)NewVendorString, TempSize);
+                if (PoolAlloc)
+                    PlatformMemFreePool(Buf);
+                return (UINT64)(UINT32)STATUS_BUFFER_OVERFLOW;
+            }
 
-                *(PULONG)((PBYTE)Buf + DataLenOffset) = NewStringSize;
-                BufSize                               = BufSize - MatchedStringLen + TempSize;
+            //
+            // Calculate the positions of the replacement
+            //
+            ULONG MatchOffset = (ULONG)((MatchStart - StringBuf));
+            PWCH  MatchEnd    = StringBuf + MatchOffset + (MatchedStringLen / sizeof(WCHAR));
 
-                //
-                // Write the changes back to the user buffers
-                //
-                if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam2, Buf, BufSize))
-                {
-                    goto ReturnWithError;
-                }
+            //
+            // Move the data after the matched string forward
+            //
+            memmove((PVOID)(StringBuf + MatchOffset + (TempSize / sizeof(WCHAR))), (PVOID)MatchEnd, OldLength - MatchedStringLen - (MatchOffset * sizeof(WCHAR)));
 
-                if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam4, &BufSize, sizeof(ULONG)))
-                {
-                    goto ReturnWithError;
-                }
+            //
+            // Replace the identified hypervisor string with the genuine one, if needed
+            //
+            memcpy((PVOID)MatchStart, (PVOID)NewVendorString, TempSize);
 
-                //
-                // Cleanup
-                //
+            *(PULONG)((PBYTE)Buf + DataLenOffset) = NewStringSize;
+            BufSize                               = BufSize - MatchedStringLen + TempSize;
 
-                MatchStart = wcsstr(StringBuf, HV_REGKEYS[i]);
+            //
+            // Write the changes back to the user buffers
+            //
+            if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam2, Buf, BufSize))
+            {
+                goto ReturnWithError;
+            }
 
-                if (!MatchStart)
-                    i = 0;
+            if (!g_Callbacks.MemoryMapperWriteMemorySafeOnTargetProcess(Params->OptionalParam4, &BufSize, sizeof(ULONG)))
+            {
+                goto ReturnWithError;
             }
+
+            //
+            // Continue right after the new string, so the replacements are never matched again
+            //
+            Offset = MatchOffset + (TempSize / sizeof(WCHAR));
         }
 
         //
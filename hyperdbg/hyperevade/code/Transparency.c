@@ -76,6 +76,15 @@ TransparentHideDebugger(HYPEREVADE_CALLBACKS *                        Hyperevade
                                                 (sizeof(TRANSPARENT_LEGIT_VENDOR_STRINGS_WCHAR) / sizeof(TRANSPARENT_LEGIT_VENDOR_STRINGS_WCHAR[0]));
 #endif
 
+        //
+        // Compile the footprint lists into matchers (kept until the module is unloaded)
+        //
+        if (!TransparentCompileFootprintMatchers())
+        {
+            TransparentModeRequest->KernelStatus = DEBUGGER_ERROR_UNABLE_TO_HIDE_OR_UNHIDE_DEBUGGER;
+            return FALSE;
+        }
+
         //
         // Enable the transparent mode
         //
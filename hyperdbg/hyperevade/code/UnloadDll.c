@@ -41,5 +41,10 @@ DllInitialize(
 NTSTATUS
 DllUnload(VOID)
 {
+    //
+    // Free the compiled footprint matchers
+    //
+    TransparentFreeFootprintMatchers();
+
     return STATUS_SUCCESS;
 }
@@ -142,6 +142,26 @@ NTSTATUS(*g_NtCreateFileOrig)
     PVOID              EaBuffer,
     ULONG              EaLength);
 
+/**
+ * @brief Compiled matchers of the footprint lists
+ *
+ * @details Each list is compiled once into an automaton, so each intercepted
+ * string is scanned once for all of the entries of the list, instead of
+ * being scanned once for every entry
+ *
+ */
+typedef struct _TRANSPARENT_FOOTPRINT_MATCHERS
+{
+    BOOLEAN                Compiled;
+    AHO_CORASICK_AUTOMATON Files;         // HV_FILES
+    AHO_CORASICK_AUTOMATON Directories;   // HV_DIRS
+    AHO_CORASICK_AUTOMATON RegistryKeys;  // HV_REGKEYS
+    AHO_CORASICK_AUTOMATON Drivers;       // HV_DRIVER
+    AHO_CORASICK_AUTOMATON Processes;     // HV_PROCESSES
+    AHO_CORASICK_AUTOMATON FirmwareNames; // HV_FIRM_NAMES
+
+} TRANSPARENT_FOOTPRINT_MATCHERS, *PTRANSPARENT_FOOTPRINT_MATCHERS;
+
 //////////////////////////////////////////////////
 //				     Globals        			//
 //////////////////////////////////////////////////
@@ -157,6 +177,11 @@ static WORD g_TransparentGenuineVendorStringIndex = 0;
  */
 SYSTEM_CALL_NUMBERS_INFORMATION g_SystemCallNumbersInformation;
 
+/**
+ * @brief Compiled matchers of the footprint lists
+ */
+TRANSPARENT_FOOTPRINT_MATCHERS g_TransparentFootprintMatchers;
+
 //////////////////////////////////////////////////
 //				   Constants        			//
 //////////////////////////////////////////////////
@@ -618,6 +643,12 @@ static const PCHAR HV_FIRM_NAMES[] = {
 //				   Functions					//
 //////////////////////////////////////////////////
 
+BOOLEAN
+TransparentCompileFootprintMatchers();
+
+VOID
+TransparentFreeFootprintMatchers();
+
 VOID
 TransparentHandleNtQuerySystemInformationSyscall(GUEST_REGS * Regs);
 
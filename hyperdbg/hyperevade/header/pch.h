@@ -75,6 +75,11 @@
 //
 #include "SDK/modules/HyperEvade.h"
 
+//
+// Multi-string matcher for the footprint lists
+//
+#include "components/ahocorasick/header/AhoCorasick.h"
+
 //
 // Transparency and footprints headers
 //
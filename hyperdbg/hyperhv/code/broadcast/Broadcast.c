@@ -536,3 +536,14 @@ BroadcastDisablePmlOnAllProcessors()
 {
     KeGenericCallDpc(DpcRoutineDisablePml, 0x0);
 }
+
+/**
+ * @brief routines for flushing PML buffers on all cores
+ *
+ * @return VOID
+ */
+VOID
+BroadcastFlushPmlOnAllProcessors()
+{
+    KeGenericCallDpc(DpcRoutineFlushPml, 0x0);
+}
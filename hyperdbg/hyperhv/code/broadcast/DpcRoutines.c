@@ -663,6 +663,32 @@ DpcRoutineDisablePml(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, P
     PlatformBroadcastSynchronizeEndOfRoutine(SystemArgument1, SystemArgument2);
 }
 
+/**
+ * @brief Broadcast flush PML buffers on all cores
+ *
+ * @param Dpc
+ * @param DeferredContext
+ * @param SystemArgument1
+ * @param SystemArgument2
+ * @return VOID
+ */
+VOID
+DpcRoutineFlushPml(KDPC * Dpc, PVOID DeferredContext, PVOID SystemArgument1, PVOID SystemArgument2)
+{
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(DeferredContext);
+
+    //
+    // Flush the PML buffer into the dirty bitmap from vmx-root
+    //
+    AsmVmxVmcall(VMCALL_FLUSH_DIRTY_LOGGING_BUFFER, 0, 0, 0);
+
+    // ------------------------------------------------------------------------------
+    // Synchronize the end of this routine with the caller
+    //
+    PlatformBroadcastSynchronizeEndOfRoutine(SystemArgument1, SystemArgument2);
+}
+
 /**
  * @brief Disable Msr Bitmaps on all cores (vm-exit on all msrs)
  *
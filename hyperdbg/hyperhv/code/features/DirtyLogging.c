@@ -12,6 +12,73 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Count the physical pages (up to the end of the highest RAM range)
+ *
+ * @return UINT64
+ */
+static UINT64
+DirtyLoggingQueryNumberOfPhysicalPages()
+{
+    PPHYSICAL_MEMORY_RANGE PhysicalMemoryRanges;
+    UINT64                 HighestAddress = 0;
+
+    //
+    // Read the RAM regions (BIOS) gives these details to Windows
+    //
+    PhysicalMemoryRanges = MmGetPhysicalMemoryRanges();
+
+    if (PhysicalMemoryRanges == NULL)
+    {
+        return 0;
+    }
+
+    for (UINT32 i = 0; PhysicalMemoryRanges[i].BaseAddress.QuadPart || PhysicalMemoryRanges[i].NumberOfBytes.QuadPart; i++)
+    {
+        UINT64 EndAddress = PhysicalMemoryRanges[i].BaseAddress.QuadPart + PhysicalMemoryRanges[i].NumberOfBytes.QuadPart;
+
+        if (EndAddress > HighestAddress)
+        {
+            HighestAddress = EndAddress;
+        }
+    }
+
+    ExFreePool(PhysicalMemoryRanges);
+
+    return (HighestAddress + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
+/**
+ * @brief Free the PML buffers and the bitmap of the dirty pages
+ *
+ * @return VOID
+ */
+static VOID
+DirtyLoggingFreeBuffers()
+{
+    ULONG          ProcessorsCount = KeQueryActiveProcessorCount(0);
+    DIRTY_BITMAP * DirtyBitmap     = g_DirtyBitmap;
+
+    for (SIZE_T i = 0; i < ProcessorsCount; i++)
+    {
+        if (g_GuestState[i].PmlBufferAddress != NULL)
+        {
+            PlatformMemFreePool(g_GuestState[i].PmlBufferAddress);
+            g_GuestState[i].PmlBufferAddress = NULL;
+        }
+    }
+
+    //
+    // The bitmap is detached before it's freed
+    //
+    g_DirtyBitmap = NULL;
+
+    if (DirtyBitmap != NULL)
+    {
+        PlatformMemFreePool(DirtyBitmap);
+    }
+}
+
 /**
  * @brief Initialize the dirty logging mechanism
  *
@@ -65,13 +132,7 @@ DirtyLoggingInitialize()
             //
             // Allocation failed
             //
-            for (SIZE_T j = 0; j < ProcessorsCount; j++)
-            {
-                if (g_GuestState[j].PmlBufferAddress != NULL)
-                {
-                    PlatformMemFreePool(g_GuestState[j].PmlBufferAddress);
-                }
-            }
+            DirtyLoggingFreeBuffers();
 
             return FALSE;
         }
@@ -82,6 +143,28 @@ DirtyLoggingInitialize()
         RtlZeroBytes(g_GuestState[i].PmlBufferAddress, PAGE_SIZE);
     }
 
+    //
+    // The flushed addresses are kept in a bitmap of all of the physical pages
+    // (the flushes of all of the cores fill the same bitmap)
+    //
+    if (g_DirtyBitmap == NULL)
+    {
+        UINT64 NumberOfPages = DirtyLoggingQueryNumberOfPhysicalPages();
+
+        if (NumberOfPages != 0)
+        {
+            g_DirtyBitmap = PlatformMemAllocateZeroedNonPagedPool(DIRTY_BITMAP_SIZE(NumberOfPages));
+        }
+
+        if (g_DirtyBitmap == NULL || !DirtyBitmapInitialize(g_DirtyBitmap, NumberOfPages))
+        {
+            LogWarning("err, unable to allocate the bitmap of the dirty pages");
+            DirtyLoggingFreeBuffers();
+
+            return FALSE;
+        }
+    }
+
     //
     // Broadcast VMCALL to adjust PML controls from vmx-root
     //
@@ -174,35 +257,22 @@ DirtyLoggingDisable(VIRTUAL_MACHINE_STATE * VCpu)
 }
 
 /**
- * @brief Initialize the dirty logging mechanism
+ * @brief Uninitialize the dirty logging mechanism
  *
  * @return VOID
  */
 VOID
 DirtyLoggingUninitialize()
 {
-    ULONG ProcessorsCount;
-
-    //
-    // Query count of active processors
-    //
-    ProcessorsCount = KeQueryActiveProcessorCount(0);
-
     //
     // Broadcast VMCALL to disable PML controls from vmx-root
     //
     BroadcastDisablePmlOnAllProcessors();
 
     //
-    // Free the allocated pool buffers
+    // Free the allocated pool buffers (no more PML vm-exits after disabling it)
     //
-    for (SIZE_T i = 0; i < ProcessorsCount; i++)
-    {
-        if (g_GuestState[i].PmlBufferAddress != NULL)
-        {
-            PlatformMemFreePool(g_GuestState[i].PmlBufferAddress);
-        }
-    }
+    DirtyLoggingFreeBuffers();
 }
 
 /**
@@ -224,6 +294,14 @@ DirtyLoggingHandlePageModificationLog(VIRTUAL_MACHINE_STATE * VCpu)
     }
 }
 
+/**
+ * @brief Flush the PML buffer into the bitmap of the dirty pages
+ * @details should be called in vmx-root mode
+ *
+ * @param VCpu The virtual processor's state
+ *
+ * @return BOOLEAN
+ */
 BOOLEAN
 DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
 {
@@ -271,6 +349,15 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
             continue;
         }
 
+        //
+        // Keep the page in the bitmap, the dirty flag of a large page is for
+        // all of its pages, so all of them are marked
+        //
+        if (g_DirtyBitmap != NULL)
+        {
+            DirtyBitmapMarkPage(g_DirtyBitmap, AccessedPhysAddr, IsLargePage);
+        }
+
         if (IsLargePage)
         {
             ((PEPT_PML2_ENTRY)PmlEntry)->Dirty = FALSE;
@@ -281,6 +368,12 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
         }
     }
 
+    //
+    // The cleared dirty flags might be cached, so invalidate them to get
+    // the next writes to these pages logged again (each core has its own EPT)
+    //
+    EptInveptSingleContext(VCpu->EptPointer.AsUInt);
+
     //
     // reset PML index
     //
@@ -289,6 +382,106 @@ DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu)
     return TRUE;
 }
 
+/**
+ * @brief Perform actions related to the dirty logging
+ *
+ * @param DirtyLoggingRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DirtyLoggingPerformOperation(DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest)
+{
+    switch (DirtyLoggingRequest->DirtyLoggingOperationType)
+    {
+    case DIRTY_LOGGING_OPERATION_REQUEST_TYPE_ENABLE:
+
+        if (!g_CompatibilityCheck.PmlSupport)
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_LOGGING_NOT_SUPPORTED;
+            return FALSE;
+        }
+
+        if (g_DirtyBitmap != NULL)
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_LOGGING_ALREADY_ENABLED;
+            return FALSE;
+        }
+
+        if (!DirtyLoggingInitialize())
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_LOGGING_CANNOT_BE_INITIALIZED;
+            return FALSE;
+        }
+
+        DirtyLoggingRequest->NumberOfPages = g_DirtyBitmap->NumberOfPages;
+
+        break;
+
+    case DIRTY_LOGGING_OPERATION_REQUEST_TYPE_DISABLE:
+
+        if (g_DirtyBitmap == NULL)
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_LOGGING_NOT_ENABLED;
+            return FALSE;
+        }
+
+        DirtyLoggingUninitialize();
+
+        break;
+
+    case DIRTY_LOGGING_OPERATION_REQUEST_TYPE_QUERY:
+
+        if (g_DirtyBitmap == NULL)
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_DIRTY_LOGGING_NOT_ENABLED;
+            return FALSE;
+        }
+
+        if (DirtyLoggingRequest->FirstPage % 64 != 0 || DirtyLoggingRequest->FirstPage >= g_DirtyBitmap->NumberOfPages)
+        {
+            DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_INVALID_DIRTY_LOGGING_OPERATION_PARAMETERS;
+            return FALSE;
+        }
+
+        //
+        // Get the addresses that are still in the PML buffers of the cores into the bitmap
+        //
+        BroadcastFlushPmlOnAllProcessors();
+
+        //
+        // Fetch (and reset) the range, the pages that are marked while it's fetched
+        // are either in this range or remain for the next query
+        //
+        DirtyLoggingRequest->DirtyPages = DirtyBitmapFetch(g_DirtyBitmap,
+                                                           DirtyLoggingRequest->FirstPage,
+                                                           DIRTY_LOGGING_MAXIMUM_PAGES_PER_QUERY,
+                                                           DirtyLoggingRequest->Bitmap,
+                                                           DirtyLoggingRequest->ResetBitmap);
+
+        DirtyLoggingRequest->FetchedPages   = g_DirtyBitmap->NumberOfPages - DirtyLoggingRequest->FirstPage;
+        DirtyLoggingRequest->NumberOfPages  = g_DirtyBitmap->NumberOfPages;
+        DirtyLoggingRequest->Epoch          = g_DirtyBitmap->Epoch;
+        DirtyLoggingRequest->DroppedEntries = g_DirtyBitmap->DroppedEntries;
+
+        if (DirtyLoggingRequest->FetchedPages > DIRTY_LOGGING_MAXIMUM_PAGES_PER_QUERY)
+        {
+            DirtyLoggingRequest->FetchedPages = DIRTY_LOGGING_MAXIMUM_PAGES_PER_QUERY;
+        }
+
+        break;
+
+    default:
+
+        DirtyLoggingRequest->KernelStatus = DEBUGGER_ERROR_INVALID_DIRTY_LOGGING_OPERATION_PARAMETERS;
+        return FALSE;
+    }
+
+    DirtyLoggingRequest->KernelStatus = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return TRUE;
+}
+
 /**
  * @brief Handling vm-exits of PML
  *
@@ -305,13 +498,7 @@ DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu)
     //
 
     //
-    // Test log
-    //
-    LogInfo("Dirty Logging VM-exit");
-    // DirtyLoggingHandlePageModificationLog(VCpu);
-
-    //
-    // Flush the PML buffer
+    // Flush the PML buffer into the bitmap
     //
     DirtyLoggingFlushPmlBuffer(VCpu);
 
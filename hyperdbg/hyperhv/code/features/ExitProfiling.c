@@ -0,0 +1,161 @@
+/**
+ * @file ExitProfiling.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Profiling the latency of the vm-exits (per core and per exit reason)
+ * @details The exits are recorded by the vm-exit handler of each core into
+ * its own profiler, so there is no lock in the vm-exit path
+ *
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate the profilers of the cores
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ExitProfilingInitialize()
+{
+    ULONG                ProcessorsCount = KeQueryActiveProcessorCount(0);
+    EXIT_PROFILER_CORE * ExitProfiler;
+
+    if (g_ExitProfiler != NULL)
+    {
+        //
+        // The profilers are kept until the VMM is terminated
+        //
+        return TRUE;
+    }
+
+    ExitProfiler = PlatformMemAllocateZeroedNonPagedPool(sizeof(EXIT_PROFILER_CORE) * ProcessorsCount);
+
+    if (ExitProfiler == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // The zeroed profilers are in the first generation
+    //
+    g_ExitProfilerGeneration = 0;
+    g_ExitProfiler           = ExitProfiler;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the profilers of the cores
+ * @details Should be called after all of the cores are terminated
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilingUninitialize()
+{
+    g_ExitProfilerEnabled = FALSE;
+
+    if (g_ExitProfiler != NULL)
+    {
+        PlatformMemFreePool(g_ExitProfiler);
+        g_ExitProfiler = NULL;
+    }
+}
+
+/**
+ * @brief Perform actions related to the vm-exit profiler
+ *
+ * @param ExitProfilerRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ExitProfilingPerformOperation(EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest)
+{
+    ULONG ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    switch (ExitProfilerRequest->ExitProfilerOperationType)
+    {
+    case EXIT_PROFILER_OPERATION_REQUEST_TYPE_ENABLE:
+
+        if (!ExitProfilingInitialize())
+        {
+            ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_EXIT_PROFILER_CANNOT_BE_INITIALIZED;
+            return FALSE;
+        }
+
+        //
+        // The profilers are visible before the vm-exit handlers start recording
+        //
+        KeMemoryBarrier();
+        g_ExitProfilerEnabled = TRUE;
+
+        break;
+
+    case EXIT_PROFILER_OPERATION_REQUEST_TYPE_DISABLE:
+
+        if (!g_ExitProfilerEnabled)
+        {
+            ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_EXIT_PROFILER_NOT_ENABLED;
+            return FALSE;
+        }
+
+        //
+        // The statistics are kept for the next queries
+        //
+        g_ExitProfilerEnabled = FALSE;
+
+        break;
+
+    case EXIT_PROFILER_OPERATION_REQUEST_TYPE_RESET:
+
+        if (g_ExitProfiler == NULL)
+        {
+            ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_EXIT_PROFILER_NOT_ENABLED;
+            return FALSE;
+        }
+
+        //
+        // Each core resets its own profiler on its next exit (the cores that are
+        // not reset yet are queried as empty)
+        //
+        InterlockedIncrement64((volatile LONG64 *)&g_ExitProfilerGeneration);
+
+        break;
+
+    case EXIT_PROFILER_OPERATION_REQUEST_TYPE_QUERY:
+
+        if (g_ExitProfiler == NULL)
+        {
+            ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_EXIT_PROFILER_NOT_ENABLED;
+            return FALSE;
+        }
+
+        if (ExitProfilerRequest->CoreId >= ProcessorsCount)
+        {
+            ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_INVALID_EXIT_PROFILER_OPERATION_PARAMETERS;
+            return FALSE;
+        }
+
+        ExitProfilerSnapshot(&g_ExitProfiler[ExitProfilerRequest->CoreId],
+                             g_ExitProfilerGeneration,
+                             &ExitProfilerRequest->Statistics);
+
+        break;
+
+    default:
+
+        ExitProfilerRequest->KernelStatus = DEBUGGER_ERROR_INVALID_EXIT_PROFILER_OPERATION_PARAMETERS;
+        return FALSE;
+    }
+
+    ExitProfilerRequest->NumberOfCores = ProcessorsCount;
+    ExitProfilerRequest->IsEnabled     = g_ExitProfilerEnabled;
+    ExitProfilerRequest->KernelStatus  = DEBUGGER_OPERATION_WAS_SUCCESSFUL;
+
+    return TRUE;
+}
@@ -13,18 +13,152 @@
  */
 #include "pch.h"
 
+/**
+ * @brief Get a pre-allocated table for looking up hooked pages or detours
+ * @details The pool is reserved by EptHookReservePreallocatedPoolsForEptHooks
+ *
+ * @return HASH_TABLE* The table or NULL if there is no pre-allocated pool
+ */
+static HASH_TABLE *
+EptHookAllocateLookupTable()
+{
+    PVOID Buffer;
+
+    Buffer = (PVOID)PoolManagerCallbackRequestPool(EPT_HOOK_LOOKUP_TABLE, FALSE, 0);
+
+    if (Buffer == NULL)
+    {
+        return NULL;
+    }
+
+    if (!HashTableInitialize(Buffer, EPT_HOOK_LOOKUP_TABLE_CAPACITY))
+    {
+        PoolManagerCallbackFreePool((UINT64)Buffer);
+        return NULL;
+    }
+
+    return (HASH_TABLE *)Buffer;
+}
+
+/**
+ * @brief Add a hooked page to the table of hooked pages
+ * @details Should be called after the hooked page is added to g_EptState->HookedPagesList
+ *
+ * @param HookedPage
+ *
+ * @return VOID
+ */
+static VOID
+EptHookTrackHookedPage(EPT_HOOKED_PAGE_DETAIL * HookedPage)
+{
+    HASH_TABLE * Table = g_EptHookedPagesTable;
+
+    if (Table != NULL)
+    {
+        HashTableInsert(Table, HookedPage->PhysicalBaseAddress >> PAGE_SHIFT, (UINT64)HookedPage);
+        return;
+    }
+
+    //
+    // This is the first hooked page, if there is no pre-allocated table
+    // then the hooked pages are found by walking the list
+    //
+    Table = EptHookAllocateLookupTable();
+
+    if (Table == NULL)
+    {
+        return;
+    }
+
+    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
+    {
+        HashTableInsert(Table, CurrEntity->PhysicalBaseAddress >> PAGE_SHIFT, (UINT64)CurrEntity);
+    }
+
+    //
+    // The table is published after it's filled, as the other cores might
+    // look up the hooked pages at the same time
+    //
+    _ReadWriteBarrier();
+    g_EptHookedPagesTable = Table;
+}
+
+/**
+ * @brief Remove a hooked page from the table of hooked pages
+ *
+ * @param HookedPage
+ *
+ * @return VOID
+ */
+static VOID
+EptHookUntrackHookedPage(EPT_HOOKED_PAGE_DETAIL * HookedPage)
+{
+    if (g_EptHookedPagesTable != NULL)
+    {
+        HashTableRemove(g_EptHookedPagesTable, HookedPage->PhysicalBaseAddress >> PAGE_SHIFT);
+    }
+}
+
+/**
+ * @brief Add a detour to the table of hidden hooks detours
+ * @details Should be called after the detour is added to g_EptHook2sDetourListHead
+ *
+ * @param DetourHookDetails
+ *
+ * @return VOID
+ */
+static VOID
+EptHookTrackDetour(HIDDEN_HOOKS_DETOUR_DETAILS * DetourHookDetails)
+{
+    HASH_TABLE * Table = g_EptHook2sDetourTable;
+
+    if (Table != NULL)
+    {
+        HashTableInsert(Table, (UINT64)DetourHookDetails->HookedFunctionAddress, (UINT64)DetourHookDetails);
+        return;
+    }
+
+    Table = EptHookAllocateLookupTable();
+
+    if (Table == NULL)
+    {
+        return;
+    }
+
+    LIST_FOR_EACH_LINK(g_EptHook2sDetourListHead, HIDDEN_HOOKS_DETOUR_DETAILS, OtherHooksList, CurrentHookedDetails)
+    {
+        HashTableInsert(Table, (UINT64)CurrentHookedDetails->HookedFunctionAddress, (UINT64)CurrentHookedDetails);
+    }
+
+    _ReadWriteBarrier();
+    g_EptHook2sDetourTable = Table;
+}
+
 /**
  * @brief Check whether the desired PhysicalAddress is already in the g_EptState->HookedPagesList hooks or not
+ * @details Could be called from vmx-root on all cores at the same time
  *
  * @param PhysicalBaseAddress
  *
  * @return PEPT_HOOKED_PAGE_DETAIL  if the address was already hooked, or FALSE
  */
 _Must_inspect_result_
-_Success_(return == TRUE)
-static EPT_HOOKED_PAGE_DETAIL *
+EPT_HOOKED_PAGE_DETAIL *
 EptHookFindByPhysAddress(_In_ UINT64 PhysicalBaseAddress)
 {
+    HASH_TABLE *             Table = g_EptHookedPagesTable;
+    EPT_HOOKED_PAGE_DETAIL * HookedPage;
+
+    if (HashTableIsReliable(Table))
+    {
+        HookedPage = (EPT_HOOKED_PAGE_DETAIL *)HashTableFind(Table, PhysicalBaseAddress >> PAGE_SHIFT);
+
+        return (HookedPage != NULL && HookedPage->PhysicalBaseAddress == PhysicalBaseAddress) ? HookedPage : NULL;
+    }
+
+    //
+    // There is no table (or not all of the hooked pages are in the table)
+    //
     LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, CurrEntity)
     {
         if (CurrEntity->PhysicalBaseAddress == PhysicalBaseAddress)
@@ -36,6 +170,40 @@ EptHookFindByPhysAddress(_In_ UINT64 PhysicalBaseAddress)
     return NULL;
 }
 
+/**
+ * @brief Find the details of a hidden hook detour by the hooked function address
+ * @details Could be called on all cores at the same time
+ *
+ * @param HookedFunctionAddress
+ *
+ * @return HIDDEN_HOOKS_DETOUR_DETAILS* The details or NULL if not found
+ */
+HIDDEN_HOOKS_DETOUR_DETAILS *
+EptHookFindDetourByHookedFunction(PVOID HookedFunctionAddress)
+{
+    HASH_TABLE * Table = g_EptHook2sDetourTable;
+
+    if (HashTableIsReliable(Table))
+    {
+        return (HIDDEN_HOOKS_DETOUR_DETAILS *)HashTableFind(Table, (UINT64)HookedFunctionAddress);
+    }
+
+    if (!g_IsEptHook2sDetourListInitialized)
+    {
+        return NULL;
+    }
+
+    LIST_FOR_EACH_LINK(g_EptHook2sDetourListHead, HIDDEN_HOOKS_DETOUR_DETAILS, OtherHooksList, CurrentHookedDetails)
+    {
+        if (CurrentHookedDetails->HookedFunctionAddress == HookedFunctionAddress)
+        {
+            return CurrentHookedDetails;
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Calculate the breakpoint offset
  *
@@ -96,6 +264,17 @@ EptHookReservePreallocatedPoolsForEptHooks(UINT32 Count)
     // Request pages to be allocated for detour hooked pages details
     //
     PoolManagerCallbackRequestAllocation(sizeof(HIDDEN_HOOKS_DETOUR_DETAILS), Count, DETOUR_HOOK_DETAILS);
+
+    //
+    // Request pages to be allocated for the tables of looking up hooked pages
+    // and detours (one table for each of them, shared by all of the hooks)
+    //
+    if (!g_EptHookLookupTablesReserved)
+    {
+        g_EptHookLookupTablesReserved = TRUE;
+
+        PoolManagerCallbackRequestAllocation(HASH_TABLE_SIZE(EPT_HOOK_LOOKUP_TABLE_CAPACITY), 2, EPT_HOOK_LOOKUP_TABLE);
+    }
 }
 
 /**
@@ -353,6 +532,11 @@ EptHookCreateHookPage(_Inout_ VIRTUAL_MACHINE_STATE * VCpu,
             // Add it to the list
             //
             InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
+
+            //
+            // Add it to the table of hooked pages
+            //
+            EptHookTrackHookedPage(HookedPage);
         }
 
         //
@@ -971,6 +1155,11 @@ EptHookInstructionMemory(PEPT_HOOKED_PAGE_DETAIL Hook,
     //
     InsertHeadList(&g_EptHook2sDetourListHead, &(DetourHookDetails->OtherHooksList));
 
+    //
+    // Add it to the table of detours
+    //
+    EptHookTrackDetour(DetourHookDetails);
+
     //
     // Write the absolute jump to our shadow page memory to jump to our hook
     //
@@ -1007,8 +1196,6 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
     PEPT_PML1_ENTRY         TargetPage;
     PEPT_HOOKED_PAGE_DETAIL HookedPage;
     CR3_TYPE                Cr3OfCurrentProcess;
-    PLIST_ENTRY             TempList      = 0;
-    PEPT_HOOKED_PAGE_DETAIL HookedEntry   = NULL;
     BOOLEAN                 UnsetExecute  = FALSE;
     BOOLEAN                 UnsetRead     = FALSE;
     BOOLEAN                 UnsetWrite    = FALSE;
@@ -1083,22 +1270,14 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
     //
     // try to see if we can find the address
     //
-    TempList = &g_EptState->HookedPagesList;
-
-    while (&g_EptState->HookedPagesList != TempList->Flink)
+    if (EptHookFindByPhysAddress(PhysicalBaseAddress) != NULL)
     {
-        TempList    = TempList->Flink;
-        HookedEntry = CONTAINING_RECORD(TempList, EPT_HOOKED_PAGE_DETAIL, PageHookList);
-
-        if (HookedEntry->PhysicalBaseAddress == PhysicalBaseAddress)
-        {
-            //
-            // Means that we find the address and !epthook2 doesn't support
-            // multiple breakpoints in on page
-            //
-            VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
-            return FALSE;
-        }
+        //
+        // Means that we find the address and !epthook2 doesn't support
+        // multiple breakpoints in on page
+        //
+        VmmCallbackSetLastError(DEBUGGER_ERROR_EPT_MULTIPLE_HOOKS_IN_A_SINGLE_PAGE);
+        return FALSE;
     }
 
     //
@@ -1353,6 +1532,11 @@ EptHookPerformPageHookMonitorAndInlineHook(VIRTUAL_MACHINE_STATE * VCpu,
             // Add it to the list
             //
             InsertHeadList(&g_EptState->HookedPagesList, &(HookedPage->PageHookList));
+
+            //
+            // Add it to the table of hooked pages
+            //
+            EptHookTrackHookedPage(HookedPage);
         }
 
         //
@@ -1859,6 +2043,11 @@ EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(UINT64 Address)
             //
             RemoveEntryList(&CurrentHookedDetails->OtherHooksList);
 
+            if (g_EptHook2sDetourTable != NULL)
+            {
+                HashTableRemove(g_EptHook2sDetourTable, Address);
+            }
+
             //
             // Free the pool in next ioctl
             //
@@ -1956,9 +2145,10 @@ EptHookUnHookSingleAddressDetoursAndMonitor(PEPT_HOOKED_PAGE_DETAIL
     }
 
     //
-    // remove the entry from the list
+    // remove the entry from the list (and the table)
     //
     RemoveEntryList(&HookedEntry->PageHookList);
+    EptHookUntrackHookedPage(HookedEntry);
 
     //
     // we add the hooked entry to the list
@@ -2105,9 +2295,10 @@ EptHookUnHookSingleAddressHiddenBreakpoint(PEPT_HOOKED_PAGE_DETAIL             H
                 }
 
                 //
-                // remove the entry from the list
+                // remove the entry from the list (and the table)
                 //
                 RemoveEntryList(&HookedEntry->PageHookList);
+                EptHookUntrackHookedPage(HookedEntry);
 
                 //
                 // we add the hooked entry to the list
@@ -2481,6 +2672,8 @@ EptHookUnHookAll()
             EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(CurrEntity->VirtualAddress);
         }
 
+        EptHookUntrackHookedPage(CurrEntity);
+
         //
         // As we are in vmx-root here, we add the hooked entry to the list
         // of pools that will be deallocated on next IOCTL
@@ -2490,6 +2683,24 @@ EptHookUnHookAll()
             LogError("Err, something goes wrong, the pool not found in the list of previously allocated pools by pool manager");
         }
     }
+
+    //
+    // The lookup tables are not used anymore, they will be deallocated
+    // on next IOCTL and requested again for the next hooks
+    //
+    if (g_EptHookedPagesTable != NULL)
+    {
+        PoolManagerCallbackFreePool((UINT64)g_EptHookedPagesTable);
+        g_EptHookedPagesTable = NULL;
+    }
+
+    if (g_EptHook2sDetourTable != NULL)
+    {
+        PoolManagerCallbackFreePool((UINT64)g_EptHook2sDetourTable);
+        g_EptHook2sDetourTable = NULL;
+    }
+
+    g_EptHookLookupTablesReserved = FALSE;
 }
 
 /**
@@ -2502,8 +2713,8 @@ EptHookUnHookAll()
 PVOID
 EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom)
 {
-    PLIST_ENTRY       TempList    = 0;
-    EPT_HOOKS_CONTEXT TempContext = {0};
+    PHIDDEN_HOOKS_DETOUR_DETAILS DetourHookDetails;
+    EPT_HOOKS_CONTEXT            TempContext = {0};
 
     //
     // The RSP register is the at the RCX and we just added (reverse by stack) to it's
@@ -2546,20 +2757,14 @@ EptHook2GeneralDetourEventHandler(PGUEST_REGS Regs, PVOID CalledFrom)
     DispatchEventHiddenHookExecDetours(VCpu, &TempContext);
 
     //
-    // Iterate through the list of hooked pages details to find
-    // and return where want to jump after this functions
+    // Find the details of the hooked function to return
+    // where want to jump after this functions
     //
-    TempList = &g_EptHook2sDetourListHead;
+    DetourHookDetails = EptHookFindDetourByHookedFunction(CalledFrom);
 
-    while (&g_EptHook2sDetourListHead != TempList->Flink)
+    if (DetourHookDetails != NULL)
     {
-        TempList                                          = TempList->Flink;
-        PHIDDEN_HOOKS_DETOUR_DETAILS CurrentHookedDetails = CONTAINING_RECORD(TempList, HIDDEN_HOOKS_DETOUR_DETAILS, OtherHooksList);
-
-        if (CurrentHookedDetails->HookedFunctionAddress == CalledFrom)
-        {
-            return CurrentHookedDetails->ReturnAddress;
-        }
+        return DetourHookDetails->ReturnAddress;
     }
 
     //
@@ -29,12 +29,37 @@ VmmCallbackTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
                          BOOLEAN *                             PostEventRequired,
                          GUEST_REGS *                          Regs)
 {
+    VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE Status;
+    VIRTUAL_MACHINE_STATE *                   VCpu;
+    UINT64                                    EventTsc;
+
     if (g_Callbacks.VmmCallbackTriggerEvents == NULL)
     {
         return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_SUCCESSFUL_NO_INITIALIZED;
     }
 
-    return g_Callbacks.VmmCallbackTriggerEvents(EventType, CallingStage, Context, PostEventRequired, Regs);
+    if (!g_ExitProfilerEnabled)
+    {
+        return g_Callbacks.VmmCallbackTriggerEvents(EventType, CallingStage, Context, PostEventRequired, Regs);
+    }
+
+    VCpu = &g_GuestState[KeGetCurrentProcessorNumberEx(NULL)];
+
+    //
+    // Only the events that are triggered by the vm-exits are profiled
+    //
+    if (!VCpu->IsOnVmxRootMode)
+    {
+        return g_Callbacks.VmmCallbackTriggerEvents(EventType, CallingStage, Context, PostEventRequired, Regs);
+    }
+
+    EventTsc = __rdtsc();
+
+    Status = g_Callbacks.VmmCallbackTriggerEvents(EventType, CallingStage, Context, PostEventRequired, Regs);
+
+    ExitProfilerAddEventCycles(&g_ExitProfiler[VCpu->CoreId], __rdtsc() - EventTsc);
+
+    return Status;
 }
 
 /**
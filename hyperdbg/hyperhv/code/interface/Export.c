@@ -1170,3 +1170,29 @@ VmFuncSmmPerformSmiOperation(SMI_OPERATION_PACKETS * SmiOperationRequest,
 {
     return SmmPerformSmiOperation(SmiOperationRequest, ApplyFromVmxRootMode);
 }
+
+/**
+ * @brief Perform actions related to the dirty logging (PML)
+ *
+ * @param DirtyLoggingRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+VmFuncDirtyLoggingPerformOperation(DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest)
+{
+    return DirtyLoggingPerformOperation(DirtyLoggingRequest);
+}
+
+/**
+ * @brief Perform actions related to the vm-exit profiler
+ *
+ * @param ExitProfilerRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+VmFuncExitProfilingPerformOperation(EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest)
+{
+    return ExitProfilingPerformOperation(ExitProfilerRequest);
+}
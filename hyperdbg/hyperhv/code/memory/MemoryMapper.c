@@ -702,6 +702,20 @@ MemoryMapperInitialize()
         //
         g_MemoryMapper[i].VirualAddressForWrite     = (UINT64)MemoryMapperMapPageAndGetPte(&TempPte);
         g_MemoryMapper[i].PteVirtualAddressForWrite = TempPte;
+
+        //
+        // Initial and reserve a range for the batched read operations (multiple pages)
+        //
+        g_MemoryMapper[i].VirtualAddressForBatchRead = (UINT64)MemoryMapperMapReservedPageRange(MEMORY_MAPPER_BATCH_READ_PAGES * PAGE_SIZE);
+
+        if (g_MemoryMapper[i].VirtualAddressForBatchRead != NULL64_ZERO)
+        {
+            for (UINT32 j = 0; j < MEMORY_MAPPER_BATCH_READ_PAGES; j++)
+            {
+                g_MemoryMapper[i].PteVirtualAddressesForBatchRead[j] =
+                    (UINT64)MemoryMapperGetPte((PVOID)(g_MemoryMapper[i].VirtualAddressForBatchRead + j * PAGE_SIZE));
+            }
+        }
     }
 }
 
@@ -732,11 +746,19 @@ MemoryMapperUninitialize()
             MemoryMapperUnmapReservedPageRange((PVOID)g_MemoryMapper[i].VirualAddressForWrite);
         }
 
+        if (g_MemoryMapper[i].VirtualAddressForBatchRead != NULL64_ZERO)
+        {
+            MemoryMapperUnmapReservedPageRange((PVOID)g_MemoryMapper[i].VirtualAddressForBatchRead);
+        }
+
         g_MemoryMapper[i].VirualAddressForRead     = NULL64_ZERO;
         g_MemoryMapper[i].PteVirtualAddressForRead = NULL64_ZERO;
 
         g_MemoryMapper[i].VirualAddressForWrite     = NULL64_ZERO;
         g_MemoryMapper[i].PteVirtualAddressForWrite = NULL64_ZERO;
+
+        g_MemoryMapper[i].VirtualAddressForBatchRead = NULL64_ZERO;
+        RtlZeroMemory(g_MemoryMapper[i].PteVirtualAddressesForBatchRead, sizeof(g_MemoryMapper[i].PteVirtualAddressesForBatchRead));
     }
 
     //
@@ -832,6 +854,232 @@ MemoryMapperReadMemorySafeByPte(PHYSICAL_ADDRESS PaAddressToRead,
     return TRUE;
 }
 
+/**
+ * @brief Read physically contiguous memory (up to MEMORY_MAPPER_BATCH_READ_PAGES pages)
+ * by mapping all of its pages into the reserved range of the core
+ * @param PaAddressToRead Physical address to read
+ * @param BufferToSaveMemory buffer to save the memory
+ * @param SizeToRead Size
+ * @param MemoryMapper Memory mapper details of the current core
+ *
+ * @return BOOLEAN returns TRUE if it was successful and FALSE if there was error
+ */
+_Use_decl_annotations_
+BOOLEAN
+MemoryMapperReadMemorySafeByPteRange(UINT64                   PaAddressToRead,
+                                     PVOID                    BufferToSaveMemory,
+                                     SIZE_T                   SizeToRead,
+                                     PMEMORY_MAPPER_ADDRESSES MemoryMapper)
+{
+    PAGE_ENTRY  PageEntry;
+    PPAGE_ENTRY Pte;
+    UINT64      Va            = MemoryMapper->VirtualAddressForBatchRead;
+    UINT64      NumberOfPages = ((PaAddressToRead & PAGE_4KB_OFFSET) + SizeToRead + PAGE_4KB_OFFSET) >> 12;
+
+    if (NumberOfPages > MEMORY_MAPPER_BATCH_READ_PAGES)
+    {
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i < NumberOfPages; i++)
+    {
+        Pte = (PAGE_ENTRY *)MemoryMapper->PteVirtualAddressesForBatchRead[i];
+
+        //
+        // Same as the entry of a single page (present, writable and global)
+        //
+        PageEntry.Flags                  = Pte->Flags;
+        PageEntry.Fields.Present         = 1;
+        PageEntry.Fields.Write           = 1;
+        PageEntry.Fields.Global          = 1;
+        PageEntry.Fields.PageFrameNumber = (PaAddressToRead >> 12) + i;
+
+        Pte->Flags = PageEntry.Flags;
+
+        //
+        // Each of the remapped pages should be invalidated separately
+        //
+        CpuInvlpg((PVOID)(Va + i * PAGE_SIZE));
+    }
+
+    //
+    // The pages are virtually contiguous, so the whole buffer is copied at once
+    //
+    memcpy(BufferToSaveMemory, (PVOID)(Va + (PaAddressToRead & PAGE_4KB_OFFSET)), SizeToRead);
+
+    //
+    // Unmap addresses
+    //
+    for (UINT64 i = 0; i < NumberOfPages; i++)
+    {
+        ((PAGE_ENTRY *)MemoryMapper->PteVirtualAddressesForBatchRead[i])->Flags = NULL64_ZERO;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read physically contiguous memory (with any size) by the
+ * reserved range of the core
+ * @param PaAddressToRead Physical address to read
+ * @param BufferToSaveMemory buffer to save the memory
+ * @param SizeToRead Size
+ * @param MemoryMapper Memory mapper details of the current core
+ *
+ * @return BOOLEAN returns TRUE if it was successful and FALSE if there was error
+ */
+_Use_decl_annotations_
+BOOLEAN
+MemoryMapperReadPhysicalRunSafe(UINT64                   PaAddressToRead,
+                                UINT64                   BufferToSaveMemory,
+                                SIZE_T                   SizeToRead,
+                                PMEMORY_MAPPER_ADDRESSES MemoryMapper)
+{
+    while (SizeToRead != 0)
+    {
+        SIZE_T ReadSize = MEMORY_MAPPER_BATCH_READ_PAGES * PAGE_SIZE - (PaAddressToRead & PAGE_4KB_OFFSET);
+
+        if (ReadSize > SizeToRead)
+        {
+            ReadSize = SizeToRead;
+        }
+
+        if (!MemoryMapperReadMemorySafeByPteRange(PaAddressToRead, (PVOID)BufferToSaveMemory, ReadSize, MemoryMapper))
+        {
+            return FALSE;
+        }
+
+        PaAddressToRead    = PaAddressToRead + ReadSize;
+        BufferToSaveMemory = BufferToSaveMemory + ReadSize;
+        SizeToRead         = SizeToRead - ReadSize;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read an entry of the page tables (callback of the page walks)
+ * @param Context Not used
+ * @param PhysicalAddress Physical address of the entry
+ * @param Entry The entry
+ *
+ * @return BOOLEAN returns TRUE if the entry is read
+ */
+_Use_decl_annotations_
+BOOLEAN
+MemoryMapperReadPageTableEntry(PVOID Context, UINT64 PhysicalAddress, UINT64 * Entry)
+{
+    PUINT64 EntryVa;
+
+    UNREFERENCED_PARAMETER(Context);
+
+    //
+    // The same as MemoryMapperGetPteVaWithoutSwitchingByCr3, the tables are
+    // accessed by their virtual addresses
+    //
+    EntryVa = (UINT64 *)PhysicalAddressToVirtualAddress(PhysicalAddress);
+
+    if (EntryVa == NULL)
+    {
+        return FALSE;
+    }
+
+    *Entry = *EntryVa;
+
+    return TRUE;
+}
+
+/**
+ * @brief Read multiple pages by translating the range into physically
+ * contiguous runs (the page tables are walked once for each range and
+ * large pages are read as a single run)
+ * @details The reading stops at the first address that is not translated,
+ * the remaining bytes should be read page by page
+ *
+ * @param TypeOfRead Type of read
+ * @param AddressToRead Address to read
+ * @param BufferToSaveMemory Destination to save
+ * @param SizeToRead Size
+ * @param TargetProcessId The process pid
+ * @param MemoryMapper Memory mapper details of the current core
+ *
+ * @return SIZE_T Count of the bytes that are read
+ */
+_Use_decl_annotations_
+SIZE_T
+MemoryMapperReadMemorySafeByRuns(MEMORY_MAPPER_WRAPPER_FOR_MEMORY_READ TypeOfRead,
+                                 UINT64                                AddressToRead,
+                                 UINT64                                BufferToSaveMemory,
+                                 SIZE_T                                SizeToRead,
+                                 UINT32                                TargetProcessId,
+                                 PMEMORY_MAPPER_ADDRESSES              MemoryMapper)
+{
+    PAGE_WALK_CACHE PageWalkCache;
+    PAGE_WALK_RUN   Runs[MEMORY_MAPPER_BATCH_READ_PAGES];
+    SIZE_T          TotalReadSize = 0;
+    UINT64          TranslatedSize;
+    UINT32          NumberOfRuns;
+
+    if (MemoryMapper->VirtualAddressForBatchRead == NULL64_ZERO)
+    {
+        return 0;
+    }
+
+    if (TypeOfRead == MEMORY_MAPPER_WRAPPER_READ_PHYSICAL_MEMORY)
+    {
+        //
+        // The whole buffer is a single run
+        //
+        return MemoryMapperReadPhysicalRunSafe(AddressToRead, BufferToSaveMemory, SizeToRead, MemoryMapper) ? SizeToRead : 0;
+    }
+
+    if (TypeOfRead == MEMORY_MAPPER_WRAPPER_READ_VIRTUAL_MEMORY_UNSAFE && TargetProcessId != NULL_ZERO)
+    {
+        //
+        // Addresses of other processes are translated page by page
+        //
+        return 0;
+    }
+
+    //
+    // Walk the page tables of the current layout (the same as VirtualAddressToPhysicalAddress)
+    //
+    PageWalkInitialize(&PageWalkCache, __readcr3(), MemoryMapperReadPageTableEntry, NULL);
+
+    while (TotalReadSize < SizeToRead)
+    {
+        NumberOfRuns = PageWalkBuildRuns(&PageWalkCache,
+                                         AddressToRead + TotalReadSize,
+                                         SizeToRead - TotalReadSize,
+                                         Runs,
+                                         MEMORY_MAPPER_BATCH_READ_PAGES,
+                                         &TranslatedSize);
+
+        if (NumberOfRuns == 0)
+        {
+            break;
+        }
+
+        for (UINT32 i = 0; i < NumberOfRuns; i++)
+        {
+            if (!MemoryMapperReadPhysicalRunSafe(Runs[i].PhysicalAddress,
+                                                 BufferToSaveMemory + (Runs[i].VirtualAddress - AddressToRead),
+                                                 Runs[i].Size,
+                                                 MemoryMapper))
+            {
+                //
+                // Count of the bytes of the previous runs
+                //
+                return Runs[i].VirtualAddress - AddressToRead;
+            }
+        }
+
+        TotalReadSize += TranslatedSize;
+    }
+
+    return TotalReadSize;
+}
+
 /**
  * @brief Write memory safely by mapping the buffer using PTE
  *
@@ -1021,11 +1269,26 @@ MemoryMapperReadMemorySafeWrapper(
         //
         UINT64 ReadSize = AddressToCheck;
 
+        //
+        // Read the physically contiguous runs of the range through the reserved
+        // range of the core, the remaining bytes (if any) are read page by page
+        //
+        ReadSize = MemoryMapperReadMemorySafeByRuns(TypeOfRead,
+                                                    AddressToRead,
+                                                    BufferToSaveMemory,
+                                                    SizeToRead,
+                                                    TargetProcessId,
+                                                    &g_MemoryMapper[CurrentCore]);
+
+        SizeToRead         = SizeToRead - ReadSize;
+        AddressToRead      = AddressToRead + ReadSize;
+        BufferToSaveMemory = BufferToSaveMemory + ReadSize;
+
         while (SizeToRead != 0)
         {
             ReadSize = (UINT64)PAGE_ALIGN(AddressToRead + PAGE_SIZE) - AddressToRead;
 
-            if (ReadSize == PAGE_SIZE && SizeToRead < PAGE_SIZE)
+            if (ReadSize > SizeToRead)
             {
                 ReadSize = SizeToRead;
             }
@@ -951,106 +951,104 @@ EptHandlePageHookExit(VIRTUAL_MACHINE_STATE *              VCpu,
                       VMX_EXIT_QUALIFICATION_EPT_VIOLATION ViolationQualification,
                       UINT64                               GuestPhysicalAddr)
 {
-    PVOID   TargetPage;
-    UINT64  CurrentRip;
-    UINT32  CurrentInstructionLength;
-    BOOLEAN IsHandled               = FALSE;
-    BOOLEAN ResultOfHandlingHook    = FALSE;
-    BOOLEAN IgnoreReadOrWriteOrExec = FALSE;
-    BOOLEAN IsExecViolation         = FALSE;
-
-    LIST_FOR_EACH_LINK(g_EptState->HookedPagesList, EPT_HOOKED_PAGE_DETAIL, PageHookList, HookedEntry)
+    PVOID                   TargetPage;
+    PEPT_HOOKED_PAGE_DETAIL HookedEntry;
+    UINT64                  CurrentRip;
+    UINT32                  CurrentInstructionLength;
+    BOOLEAN                 IsHandled               = FALSE;
+    BOOLEAN                 ResultOfHandlingHook    = FALSE;
+    BOOLEAN                 IgnoreReadOrWriteOrExec = FALSE;
+    BOOLEAN                 IsExecViolation         = FALSE;
+
+    //
+    // Find the hooked page of the address (without walking all of the hooked pages)
+    //
+    HookedEntry = EptHookFindByPhysAddress((SIZE_T)PAGE_ALIGN(GuestPhysicalAddr));
+
+    if (HookedEntry != NULL)
     {
-        if (HookedEntry->PhysicalBaseAddress == (SIZE_T)PAGE_ALIGN(GuestPhysicalAddr))
-        {
-            //
-            // *** We found an address that matches the details ***
-            //
+        //
+        // *** We found an address that matches the details ***
+        //
 
+        //
+        // Returning true means that the caller should return to the ept state to
+        // the previous state when this instruction is executed
+        // by setting the Monitor Trap Flag. Return false means that nothing special
+        // for the caller to do
+        //
+
+        //
+        // Reaching here means that the hooks was actually caused VM-exit because of
+        // our configurations, but here we double whether the hook needs to trigger
+        // any event or not because the hooking address (physical) might not be in the
+        // target range. For example we might hook 0x123b000 to 0x123b300 but the hook
+        // happens on 0x123b4600, so we perform the necessary checks here
+        //
+
+        if (GuestPhysicalAddr >= HookedEntry->StartOfTargetPhysicalAddress && GuestPhysicalAddr <= HookedEntry->EndOfTargetPhysicalAddress)
+        {
+            ResultOfHandlingHook = EptHookHandleHookedPage(VCpu,
+                                                           HookedEntry,
+                                                           ViolationQualification,
+                                                           GuestPhysicalAddr,
+                                                           &HookedEntry->LastContextState,
+                                                           &IgnoreReadOrWriteOrExec,
+                                                           &IsExecViolation);
+        }
+        else
+        {
             //
-            // Returning true means that the caller should return to the ept state to
-            // the previous state when this instruction is executed
-            // by setting the Monitor Trap Flag. Return false means that nothing special
-            // for the caller to do
+            // Here we assume the hook is handled as the hook needs to be
+            // restored (just not within the range)
             //
+            ResultOfHandlingHook = TRUE;
+        }
 
+        if (ResultOfHandlingHook)
+        {
             //
-            // Reaching here means that the hooks was actually caused VM-exit because of
-            // our configurations, but here we double whether the hook needs to trigger
-            // any event or not because the hooking address (physical) might not be in the
-            // target range. For example we might hook 0x123b000 to 0x123b300 but the hook
-            // happens on 0x123b4600, so we perform the necessary checks here
+            // Here we check whether the event should be ignored or not,
+            // if we don't apply the below restorations routines, the event
+            // won't redo and the emulation of the memory access is passed
             //
-
-            if (GuestPhysicalAddr >= HookedEntry->StartOfTargetPhysicalAddress && GuestPhysicalAddr <= HookedEntry->EndOfTargetPhysicalAddress)
-            {
-                ResultOfHandlingHook = EptHookHandleHookedPage(VCpu,
-                                                               HookedEntry,
-                                                               ViolationQualification,
-                                                               GuestPhysicalAddr,
-                                                               &HookedEntry->LastContextState,
-                                                               &IgnoreReadOrWriteOrExec,
-                                                               &IsExecViolation);
-            }
-            else
+            if (!IgnoreReadOrWriteOrExec)
             {
                 //
-                // Here we assume the hook is handled as the hook needs to be
-                // restored (just not within the range)
+                // Pointer to the page entry in the page table
                 //
-                ResultOfHandlingHook = TRUE;
-            }
+                TargetPage = EptGetPml1Entry(VCpu->EptPageTable, HookedEntry->PhysicalBaseAddress);
 
-            if (ResultOfHandlingHook)
-            {
                 //
-                // Here we check whether the event should be ignored or not,
-                // if we don't apply the below restorations routines, the event
-                // won't redo and the emulation of the memory access is passed
+                // Restore to its original entry for one instruction
                 //
-                if (!IgnoreReadOrWriteOrExec)
-                {
-                    //
-                    // Pointer to the page entry in the page table
-                    //
-                    TargetPage = EptGetPml1Entry(VCpu->EptPageTable, HookedEntry->PhysicalBaseAddress);
-
-                    //
-                    // Restore to its original entry for one instruction
-                    //
-                    EptSetPML1AndInvalidateTLB(VCpu,
-                                               TargetPage,
-                                               HookedEntry->OriginalEntry,
-                                               InveptSingleContext);
+                EptSetPML1AndInvalidateTLB(VCpu,
+                                           TargetPage,
+                                           HookedEntry->OriginalEntry,
+                                           InveptSingleContext);
 
-                    //
-                    // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
-                    //
-                    VCpu->MtfEptHookRestorePoint = HookedEntry;
+                //
+                // Next we have to save the current hooked entry to restore on the next instruction's vm-exit
+                //
+                VCpu->MtfEptHookRestorePoint = HookedEntry;
 
-                    //
-                    // The following codes are added because we realized if the execution takes long then
-                    // the execution might be switched to another routines, thus, MTF might conclude on
-                    // another routine and we might (and will) trigger the same instruction soon
-                    //
+                //
+                // The following codes are added because we realized if the execution takes long then
+                // the execution might be switched to another routines, thus, MTF might conclude on
+                // another routine and we might (and will) trigger the same instruction soon
+                //
 
-                    //
-                    // We have to set Monitor trap flag and give it the HookedEntry to work with
-                    //
-                    HvEnableMtfAndChangeExternalInterruptState(VCpu);
-                }
+                //
+                // We have to set Monitor trap flag and give it the HookedEntry to work with
+                //
+                HvEnableMtfAndChangeExternalInterruptState(VCpu);
             }
-
-            //
-            // Indicate that we handled the ept violation
-            //
-            IsHandled = TRUE;
-
-            //
-            // Get out of the loop
-            //
-            break;
         }
+
+        //
+        // Indicate that we handled the ept violation
+        //
+        IsHandled = TRUE;
     }
 
     //
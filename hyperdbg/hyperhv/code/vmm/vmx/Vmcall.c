@@ -437,6 +437,13 @@ VmxVmcallHandler(VIRTUAL_MACHINE_STATE * VCpu,
         VmcallStatus = STATUS_SUCCESS;
         break;
     }
+    case VMCALL_FLUSH_DIRTY_LOGGING_BUFFER:
+    {
+        DirtyLoggingFlushPmlBuffer(VCpu);
+
+        VmcallStatus = STATUS_SUCCESS;
+        break;
+    }
     case VMCALL_CHANGE_TO_MBEC_SUPPORTED_EPTP:
     {
         ExecTrapChangeToUserDisabledMbecEptp(VCpu);
@@ -24,6 +24,16 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     UINT32                  ExitReason = 0;
     BOOLEAN                 Result     = FALSE;
     VIRTUAL_MACHINE_STATE * VCpu       = NULL;
+    BOOLEAN                 IsProfiled = g_ExitProfilerEnabled;
+    UINT64                  ExitTsc    = 0;
+
+    //
+    // Read the time-stamp of the exit (if the vm-exits are profiled)
+    //
+    if (IsProfiled)
+    {
+        ExitTsc = __rdtsc();
+    }
 
     //
     // *********** SEND MESSAGE AFTER WE SET THE STATE ***********
@@ -363,6 +373,17 @@ VmxVmexitHandler(_Inout_ PGUEST_REGS GuestRegs)
     //
     VCpu->IsOnVmxRootMode = FALSE;
 
+    //
+    // Record the latency of the exit into the profiler of this core
+    //
+    if (IsProfiled)
+    {
+        ExitProfilerRecordExit(&g_ExitProfiler[VCpu->CoreId],
+                               ExitReason,
+                               __rdtsc() - ExitTsc,
+                               g_ExitProfilerGeneration);
+    }
+
     //
     // By default it's FALSE, if we want to exit vmx then it's TRUE
     //
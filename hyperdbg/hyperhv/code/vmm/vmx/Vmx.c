@@ -1173,6 +1173,11 @@ VmxPerformTermination()
     //
     MemoryMapperUninitialize();
 
+    //
+    // Free the vm-exit profilers
+    //
+    ExitProfilingUninitialize();
+
     //
     // Free g_GuestState
     //
@@ -33,6 +33,9 @@ BroadcastEnablePmlOnAllProcessors();
 VOID
 BroadcastDisablePmlOnAllProcessors();
 
+VOID
+BroadcastFlushPmlOnAllProcessors();
+
 VOID
 BroadcastChangeToMbecSupportedEptpOnAllProcessors();
 
@@ -35,3 +35,9 @@ DirtyLoggingUninitialize();
 
 VOID
 DirtyLoggingHandleVmexits(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+DirtyLoggingFlushPmlBuffer(VIRTUAL_MACHINE_STATE * VCpu);
+
+BOOLEAN
+DirtyLoggingPerformOperation(DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest);
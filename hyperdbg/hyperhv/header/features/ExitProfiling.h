@@ -0,0 +1,22 @@
+/**
+ * @file ExitProfiling.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for profiling the latency of the vm-exits
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//				   Functions					//
+//////////////////////////////////////////////////
+
+VOID
+ExitProfilingUninitialize();
+
+BOOLEAN
+ExitProfilingPerformOperation(EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest);
@@ -61,6 +61,48 @@ LIST_ENTRY g_EptHook2sDetourListHead;
  */
 BOOLEAN g_IsEptHook2sDetourListInitialized;
 
+/**
+ * @brief Table of hooked pages (keyed by the PFN of the hooked page)
+ *
+ */
+HASH_TABLE * g_EptHookedPagesTable;
+
+/**
+ * @brief Table of hidden hooks detour (keyed by the hooked function address)
+ *
+ */
+HASH_TABLE * g_EptHook2sDetourTable;
+
+/**
+ * @brief Whether the pools of the lookup tables of EPT hooks are requested
+ *
+ */
+BOOLEAN g_EptHookLookupTablesReserved;
+
+/**
+ * @brief Bitmap of the pages that are dirtied by the guest (filled from the PML buffers)
+ *
+ */
+DIRTY_BITMAP * g_DirtyBitmap;
+
+/**
+ * @brief Profilers of the vm-exits (one for each core)
+ *
+ */
+EXIT_PROFILER_CORE * g_ExitProfiler;
+
+/**
+ * @brief Whether the vm-exits are profiled
+ *
+ */
+volatile BOOLEAN g_ExitProfilerEnabled;
+
+/**
+ * @brief Generation of the vm-exit profilers (increased for resetting the profilers)
+ *
+ */
+volatile UINT64 g_ExitProfilerGeneration;
+
 /**
  * @brief Local APIC Base
  *
@@ -94,6 +94,13 @@ PVOID(*ExAllocatePoolWithTagOrig)
  */
 #define MAX_EXEC_TRAMPOLINE_SIZE 100
 
+/**
+ * @brief Number of the slots of the tables of looking up EPT hooks and
+ * detours (a power of two)
+ *
+ */
+#define EPT_HOOK_LOOKUP_TABLE_CAPACITY 4096
+
 // ----------------------------------------------------------------------
 
 /**
@@ -324,6 +331,24 @@ EptHookGetCountOfEpthooks(BOOLEAN IsEptHook2);
 BOOLEAN
 EptHookRemoveEntryAndFreePoolFromEptHook2sDetourList(UINT64 Address);
 
+/**
+ * @brief Find the details of a hooked page by its physical address
+ *
+ * @param PhysicalBaseAddress
+ * @return EPT_HOOKED_PAGE_DETAIL*
+ */
+EPT_HOOKED_PAGE_DETAIL *
+EptHookFindByPhysAddress(UINT64 PhysicalBaseAddress);
+
+/**
+ * @brief Find the details of a hidden hook detour by the hooked function address
+ *
+ * @param HookedFunctionAddress
+ * @return HIDDEN_HOOKS_DETOUR_DETAILS*
+ */
+HIDDEN_HOOKS_DETOUR_DETAILS *
+EptHookFindDetourByHookedFunction(PVOID HookedFunctionAddress);
+
 /**
  * @brief routines to generally handle breakpoint hit for detour
  * @param Regs
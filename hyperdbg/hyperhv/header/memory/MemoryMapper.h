@@ -23,6 +23,12 @@
 #define PAGE_4MB_OFFSET ((UINT64)(1 << 22) - 1)
 #define PAGE_1GB_OFFSET ((UINT64)(1 << 30) - 1)
 
+/**
+ * @brief Count of the reserved pages of each core for the batched reads
+ *
+ */
+#define MEMORY_MAPPER_BATCH_READ_PAGES 16
+
 //////////////////////////////////////////////////
 //					   Enums  					//
 //////////////////////////////////////////////////
@@ -108,6 +114,9 @@ typedef struct _MEMORY_MAPPER_ADDRESSES
 
     UINT64 PteVirtualAddressForWrite; // The virtual address of PTE for write operations
     UINT64 VirualAddressForWrite;     // The actual kernel virtual address to write
+
+    UINT64 VirtualAddressForBatchRead;                                      // The reserved range to read multiple pages at once
+    UINT64 PteVirtualAddressesForBatchRead[MEMORY_MAPPER_BATCH_READ_PAGES]; // The virtual addresses of PTEs of the reserved range
 } MEMORY_MAPPER_ADDRESSES, *PMEMORY_MAPPER_ADDRESSES;
 
 //////////////////////////////////////////////////
@@ -162,6 +171,31 @@ MemoryMapperWriteMemorySafeByPte(_In_ PVOID            SourceVA,
                                  _Inout_ UINT64        MappingVa,
                                  _In_ BOOLEAN          InvalidateVpids);
 
+static BOOLEAN
+MemoryMapperReadPageTableEntry(_In_ PVOID    Context,
+                               _In_ UINT64   PhysicalAddress,
+                               _Out_ UINT64 * Entry);
+
+static BOOLEAN
+MemoryMapperReadMemorySafeByPteRange(_In_ UINT64                   PaAddressToRead,
+                                     _Inout_ PVOID                 BufferToSaveMemory,
+                                     _In_ SIZE_T                   SizeToRead,
+                                     _In_ PMEMORY_MAPPER_ADDRESSES MemoryMapper);
+
+static BOOLEAN
+MemoryMapperReadPhysicalRunSafe(_In_ UINT64                   PaAddressToRead,
+                                _Inout_ UINT64                BufferToSaveMemory,
+                                _In_ SIZE_T                   SizeToRead,
+                                _In_ PMEMORY_MAPPER_ADDRESSES MemoryMapper);
+
+static SIZE_T
+MemoryMapperReadMemorySafeByRuns(_In_ MEMORY_MAPPER_WRAPPER_FOR_MEMORY_READ TypeOfRead,
+                                 _In_ UINT64                                AddressToRead,
+                                 _Inout_ UINT64                             BufferToSaveMemory,
+                                 _In_ SIZE_T                                SizeToRead,
+                                 _In_ UINT32                                TargetProcessId,
+                                 _In_ PMEMORY_MAPPER_ADDRESSES              MemoryMapper);
+
 static UINT64
 MemoryMapperReadMemorySafeByPhysicalAddressWrapperAddressMaker(
     _In_ MEMORY_MAPPER_WRAPPER_FOR_MEMORY_READ TypeOfRead,
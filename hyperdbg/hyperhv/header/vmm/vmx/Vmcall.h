@@ -374,6 +374,12 @@
  */
 #define VMCALL_UNSET_CLEAR_GUEST_IA32_LBR_CTL 0x0000003A
 
+/**
+ * @brief VMCALL to flush the PML buffer into the dirty bitmap
+ *
+ */
+#define VMCALL_FLUSH_DIRTY_LOGGING_BUFFER 0x0000003B
+
 //////////////////////////////////////////////////
 //				    Functions					//
 //////////////////////////////////////////////////
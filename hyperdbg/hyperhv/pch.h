@@ -127,6 +127,7 @@
 #include "hooks/SyscallCallback.h"
 #include "interface/Callback.h"
 #include "features/DirtyLogging.h"
+#include "features/ExitProfiling.h"
 #include "features/CompatibilityChecks.h"
 #include "mmio/MmioShadowing.h"
 
@@ -164,6 +165,31 @@
 //
 #include "components/spinlock/header/Spinlock.h"
 
+//
+// Atomic operations of the components
+//
+#include "components/atomics/header/Atomics.h"
+
+//
+// Hash tables
+//
+#include "components/hashtable/header/HashTable.h"
+
+//
+// Dirty page bitmaps
+//
+#include "components/dirtybitmap/header/DirtyBitmap.h"
+
+//
+// Page walks
+//
+#include "components/pagewalk/header/PageWalk.h"
+
+//
+// Vm-exit profiler
+//
+#include "components/exitprofiler/header/ExitProfiler.h"
+
 //
 // Global Variables should be the last header to include
 //
@@ -440,6 +440,82 @@ HaltedBroadcastUnhookSinglePageAllCores(EPT_SINGLE_HOOK_UNHOOKING_DETAILS * Unho
                                     &DirectVmcallOptions);
 }
 
+/**
+ * @brief This function broadcasts set exception bitmap and invalidate EPT (a single
+ * context) to all cores in a single round
+ * @details Should be called from VMX root-mode
+ *
+ * @param ExceptionIndex
+ *
+ * @return VOID
+ */
+VOID
+HaltedBroadcastSetExceptionBitmapAndInvalidateSingleContextAllCores(UINT64 ExceptionIndex)
+{
+    DIRECT_VMCALL_PARAMETERS ExceptionBitmapOptions = {0};
+    DIRECT_VMCALL_PARAMETERS InveptOptions          = {0};
+    TASK_BROADCAST_ROUND     Round;
+
+    //
+    // Set the parameters for the direct VMCALLs
+    //
+    ExceptionBitmapOptions.OptionalParam1 = ExceptionIndex;
+
+    //
+    // Set the target tasks (performed in the same order)
+    //
+    TaskBroadcastRoundInitialize(&Round, TRUE);
+    TaskBroadcastRoundAddTask(&Round, DEBUGGER_HALTED_CORE_TASK_SET_EXCEPTION_BITMAP, &ExceptionBitmapOptions);
+    TaskBroadcastRoundAddTask(&Round, DEBUGGER_HALTED_CORE_TASK_INVEPT_SINGLE_CONTEXT, &InveptOptions);
+
+    //
+    // Send request for the target tasks to the halted cores (synchronized)
+    //
+    HaltedCoreBroadcastRoundAllCores(&g_DbgState[KeGetCurrentProcessorNumberEx(NULL)],
+                                     &Round,
+                                     TRUE);
+}
+
+/**
+ * @brief This function broadcasts restore a single EPT entry and invalidate EPT cache
+ * and unset exception bitmap to all cores in a single round
+ * @details Should be called from VMX root-mode
+ *
+ * @param UnhookingDetail
+ * @param ExceptionIndex
+ *
+ * @return VOID
+ */
+VOID
+HaltedBroadcastUnhookSinglePageAndUnSetExceptionBitmapAllCores(EPT_SINGLE_HOOK_UNHOOKING_DETAILS * UnhookingDetail,
+                                                                UINT64                              ExceptionIndex)
+{
+    DIRECT_VMCALL_PARAMETERS UnhookOptions          = {0};
+    DIRECT_VMCALL_PARAMETERS ExceptionBitmapOptions = {0};
+    TASK_BROADCAST_ROUND     Round;
+
+    //
+    // Set the parameters for the direct VMCALLs
+    //
+    UnhookOptions.OptionalParam1          = UnhookingDetail->PhysicalAddress;
+    UnhookOptions.OptionalParam2          = UnhookingDetail->OriginalEntry;
+    ExceptionBitmapOptions.OptionalParam1 = ExceptionIndex;
+
+    //
+    // Set the target tasks (performed in the same order)
+    //
+    TaskBroadcastRoundInitialize(&Round, TRUE);
+    TaskBroadcastRoundAddTask(&Round, DEBUGGER_HALTED_CORE_TASK_UNHOOK_SINGLE_PAGE, &UnhookOptions);
+    TaskBroadcastRoundAddTask(&Round, DEBUGGER_HALTED_CORE_TASK_UNSET_EXCEPTION_BITMAP, &ExceptionBitmapOptions);
+
+    //
+    // Send request for the target tasks to the halted cores (synchronized)
+    //
+    HaltedCoreBroadcastRoundAllCores(&g_DbgState[KeGetCurrentProcessorNumberEx(NULL)],
+                                     &Round,
+                                     TRUE);
+}
+
 /**
  * @brief This function broadcasts disable external interrupt exiting only to clear !interrupt commands to all cores
  * @details Should be called from VMX root-mode
@@ -722,6 +722,120 @@ DebuggerCommandEditMemoryVmxRoot(PDEBUGGER_EDIT_MEMORY EditMemRequest)
     return TRUE;
 }
 
+/**
+ * @brief Save (or show) a matched address of the search
+ *
+ * @param Context The DEBUGGER_SEARCH_MEMORY_RESULTS of the search
+ * @param Address The matched address
+ * @param PatternIndex Index of the matched pattern
+ *
+ * @return BOOLEAN Whether the search should be continued or not
+ */
+static BOOLEAN
+PerformSearchAddressSaveResult(PVOID Context, UINT64 Address, UINT32 PatternIndex)
+{
+    PDEBUGGER_SEARCH_MEMORY_RESULTS Results = (PDEBUGGER_SEARCH_MEMORY_RESULTS)Context;
+
+    UNREFERENCED_PARAMETER(PatternIndex);
+
+    if (Results->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
+    {
+        //
+        // It's a physical memory
+        //
+        Address = VirtualAddressToPhysicalAddress((PVOID)Address);
+    }
+
+    if (Results->IsDebuggeePaused)
+    {
+        Log("%llx\n", Address);
+    }
+    else
+    {
+        Results->AddressToSaveResults[Results->CountOfOccurance] = Address;
+    }
+
+    Results->CountOfOccurance++;
+
+    //
+    // Stop the search if the result buffer is full
+    //
+    return Results->CountOfOccurance < MaximumSearchResults;
+}
+
+/**
+ * @brief Search a pattern that is longer than the patterns of the search
+ * engine (MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE)
+ *
+ * @details The pattern is compared in place at each multiple of the chunk
+ * size, value by value, without keeping a copy of it. The caller should
+ * already be in the memory layout of the target process
+ *
+ * @param Results The results of the search
+ * @param Values The values of the pattern (one value in each UINT64)
+ * @param CountOfValues Number of the values
+ * @param LengthOfEachChunk Size of each value
+ * @param StartAddress valid start address based on target process
+ * @param EndAddress valid end address based on target process
+ * @return VOID
+ */
+static VOID
+PerformSearchAddressLongPattern(PDEBUGGER_SEARCH_MEMORY_RESULTS Results,
+                                const UINT64 *                  Values,
+                                UINT32                          CountOfValues,
+                                UINT32                          LengthOfEachChunk,
+                                UINT64                          StartAddress,
+                                UINT64                          EndAddress)
+{
+    UINT64  PatternSize = (UINT64)CountOfValues * LengthOfEachChunk;
+    UINT64  Cmp64       = 0;
+    BOOLEAN StillMatch  = FALSE;
+
+    if (EndAddress - StartAddress < PatternSize)
+    {
+        return;
+    }
+
+    for (UINT64 Address = StartAddress; Address <= EndAddress - PatternSize; Address += LengthOfEachChunk)
+    {
+        StillMatch = TRUE;
+
+        for (UINT32 i = 0; i < CountOfValues; i++)
+        {
+            //
+            // Check if we should access the memory directly, or through safe memory
+            // routine from vmx-root
+            //
+            if (Results->IsDebuggeePaused)
+            {
+                if (!MemoryMapperReadMemorySafe(Address + (UINT64)i * LengthOfEachChunk, &Cmp64, LengthOfEachChunk))
+                {
+                    StillMatch = FALSE;
+                    break;
+                }
+            }
+            else
+            {
+                RtlCopyMemory(&Cmp64, (PVOID)(Address + (UINT64)i * LengthOfEachChunk), LengthOfEachChunk);
+            }
+
+            if (memcmp(&Cmp64, &Values[i], LengthOfEachChunk) != 0)
+            {
+                StillMatch = FALSE;
+                break;
+            }
+        }
+
+        if (StillMatch && !PerformSearchAddressSaveResult(Results, Address, 0))
+        {
+            //
+            // The result buffer is full!
+            //
+            return;
+        }
+    }
+}
+
 /**
  * @brief Search on virtual memory (not work on physical memory)
  *
@@ -731,6 +845,11 @@ DebuggerCommandEditMemoryVmxRoot(PDEBUGGER_EDIT_MEMORY EditMemRequest)
  * instead call : SearchAddressWrapper
  * the address between StartAddress and EndAddress should be contiguous
  *
+ * The memory is given to the search engine page by page (read once by
+ * the safe memory routines if the debuggee is paused), and the matches
+ * that span two pages are found by the engine. The patterns that are
+ * longer than MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE are compared in place
+ *
  * @param AddressToSaveResults Address to save the search results
  * @param SearchMemRequest request structure of searching memory
  * @param StartAddress valid start address based on target process
@@ -748,15 +867,16 @@ PerformSearchAddress(UINT64 *                AddressToSaveResults,
                      BOOLEAN                 IsDebuggeePaused,
                      PUINT32                 CountOfMatchedCases)
 {
-    UINT32   CountOfOccurance      = 0;
-    UINT64   Cmp64                 = 0;
-    UINT32   IndexToArrayOfResults = 0;
-    UINT32   LengthOfEachChunk     = 0;
-    PVOID    TempSourceAddress     = 0;
-    PVOID    SourceAddress         = 0;
-    BOOLEAN  StillMatch            = FALSE;
-    UINT64   TempValue             = (UINT64)NULL;
-    CR3_TYPE CurrentProcessCr3     = {0};
+    MEMORY_SEARCH_CONTEXT          SearchContext;
+    DEBUGGER_SEARCH_MEMORY_RESULTS Results = {0};
+    UINT8                          Pattern[MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE];
+    UINT32                         LengthOfEachChunk = 0;
+    UINT64                         PatternSize       = 0;
+    PUINT64                        Values            = NULL;
+    const UINT8 *                  Chunk             = NULL;
+    UINT64                         ChunkEnd          = 0;
+    UINT32                         ChunkSize         = 0;
+    CR3_TYPE                       CurrentProcessCr3 = {0};
 
     //
     // set chunk size in each modification
@@ -788,8 +908,36 @@ PerformSearchAddress(UINT64 *                AddressToSaveResults,
         SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
     {
         //
-        // Search the memory
+        // Build the pattern from the values we received from user-mode
+        // (each value is LengthOfEachChunk bytes of the pattern)
         //
+        PatternSize = (UINT64)SearchMemRequest->CountOf64Chunks * LengthOfEachChunk;
+
+        if (PatternSize == 0)
+        {
+            LogError("Err, the search pattern is empty");
+            return FALSE;
+        }
+
+        Values = (PUINT64)((UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY);
+
+        Results.AddressToSaveResults = AddressToSaveResults;
+        Results.MemoryType           = SearchMemRequest->MemoryType;
+        Results.IsDebuggeePaused     = IsDebuggeePaused;
+
+        if (PatternSize <= MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE)
+        {
+            for (UINT32 i = 0; i < SearchMemRequest->CountOf64Chunks; i++)
+            {
+                memcpy(&Pattern[i * LengthOfEachChunk], &Values[i], LengthOfEachChunk);
+            }
+
+            //
+            // The matches are only reported at the multiples of the chunk size
+            //
+            MemorySearchInitialize(&SearchContext, StartAddress, PerformSearchAddressSaveResult, &Results);
+            MemorySearchAddPattern(&SearchContext, Pattern, NULL, (UINT32)PatternSize, LengthOfEachChunk);
+        }
 
         //
         // Change the memory layout (cr3), if the user specified a
@@ -810,169 +958,59 @@ PerformSearchAddress(UINT64 *                AddressToSaveResults,
             }
         }
 
-        //
-        // Here we iterate through the buffer we received from
-        // user-mode
-        //
-        SourceAddress = (PVOID)((UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY);
-
-        for (SIZE_T BaseIterator = (SIZE_T)StartAddress; BaseIterator < ((UINT64)EndAddress); BaseIterator += LengthOfEachChunk)
+        if (PatternSize > MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE)
         {
             //
-            // *** Search the memory ***
+            // The pattern doesn't fit in the search engine, compare it in place
             //
-
-            //
-            // Copy 64bit, 32bit or one byte value into Cmp64 buffer and then compare it
-            // Check if we should access the memory directly, or through safe memory
-            // routine from vmx-root
-            //
-            if (IsDebuggeePaused)
-            {
-                MemoryMapperReadMemorySafe((UINT64)BaseIterator, &Cmp64, LengthOfEachChunk);
-            }
-            else
-            {
-                RtlCopyMemory(&Cmp64, (PVOID)BaseIterator, LengthOfEachChunk);
-            }
-
-            //
-            // Get the searching bytes
-            //
-            TempValue = *(UINT64 *)SourceAddress;
-
+            PerformSearchAddressLongPattern(&Results,
+                                            Values,
+                                            SearchMemRequest->CountOf64Chunks,
+                                            LengthOfEachChunk,
+                                            StartAddress,
+                                            EndAddress);
+        }
+        else
+        {
             //
-            // Check whether the byte matches the source or not
+            // *** Search the memory page by page ***
             //
-            if (Cmp64 == TempValue)
+            for (UINT64 Address = StartAddress; Address < EndAddress; Address = ChunkEnd)
             {
-                //
-                // Indicate that it matches until now
-                //
-                StillMatch = TRUE;
+                ChunkEnd  = (UINT64)PAGE_ALIGN(Address) + PAGE_SIZE;
+                ChunkEnd  = ChunkEnd < EndAddress ? ChunkEnd : EndAddress;
+                ChunkSize = (UINT32)(ChunkEnd - Address);
 
                 //
-                // Try to check each element (we don't start from the very first element as
-                // it checked before )
+                // Check if we should access the memory directly, or through safe memory
+                // routine from vmx-root
                 //
-                for (SIZE_T i = LengthOfEachChunk; i < SearchMemRequest->CountOf64Chunks; i++)
+                if (IsDebuggeePaused)
                 {
-                    //
-                    // I know, we have a double check here ;)
-                    //
-                    TempSourceAddress = (PVOID)((UINT64)SearchMemRequest + SIZEOF_DEBUGGER_SEARCH_MEMORY + (i * sizeof(UINT64)));
-
-                    //
-                    // Add i to BaseIterator and recompute the Cmp64
-                    // Check if we should access the memory directly, or through safe memory
-                    // routine from vmx-root
-                    //
-                    if (IsDebuggeePaused)
-                    {
-                        MemoryMapperReadMemorySafe((UINT64)(BaseIterator + (LengthOfEachChunk * i)), &Cmp64, LengthOfEachChunk);
-                    }
-                    else
+                    if (!MemoryMapperReadMemorySafe(Address, g_SearchMemoryPageBuffer, ChunkSize))
                     {
-                        RtlCopyMemory(&Cmp64, (PVOID)(BaseIterator + (LengthOfEachChunk * i)), LengthOfEachChunk);
-                    }
-
-                    //
-                    // Check if we should access the memory directly,
-                    // or through safe memory routine from vmx-root
-                    //
-                    if (IsDebuggeePaused)
-                    {
-                        MemoryMapperReadMemorySafe((UINT64)TempSourceAddress, &TempValue, sizeof(UINT64));
-                    }
-                    else
-                    {
-                        TempValue = *(UINT64 *)TempSourceAddress;
-                    }
-
-                    if (!(Cmp64 == TempValue))
-                    {
-                        //
-                        // One thing didn't match so this is not the pattern
                         //
-                        StillMatch = FALSE;
-
-                        //
-                        // Break from the loop
+                        // Skip the page, the engine won't match across it as the
+                        // next page is not contiguous to the previous page anymore
                         //
-                        break;
+                        continue;
                     }
-                }
 
-                //
-                // Check if we find the pattern or not
-                //
-                if (StillMatch)
+                    Chunk = g_SearchMemoryPageBuffer;
+                }
+                else
                 {
-                    //
-                    // We found the a matching address, let's save the
-                    // address for future use
-                    //
-                    CountOfOccurance++;
-
-                    if (IsDebuggeePaused)
-                    {
-                        if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
-                        {
-                            //
-                            // It's a physical memory
-                            //
-                            Log("%llx\n", VirtualAddressToPhysicalAddress((PVOID)BaseIterator));
-                        }
-                        else
-                        {
-                            //
-                            // It's a virtual memory
-                            //
-                            Log("%llx\n", BaseIterator);
-                        }
-                    }
-                    else
-                    {
-                        if (SearchMemRequest->MemoryType == SEARCH_PHYSICAL_FROM_VIRTUAL_MEMORY)
-                        {
-                            //
-                            // It's a physical memory
-                            //
-                            AddressToSaveResults[IndexToArrayOfResults] = VirtualAddressToPhysicalAddress((PVOID)BaseIterator);
-                        }
-                        else
-                        {
-                            //
-                            // It's a virtual memory
-                            //
-                            AddressToSaveResults[IndexToArrayOfResults] = BaseIterator;
-                        }
-                    }
+                    Chunk = (const UINT8 *)Address;
+                }
 
+                if (!MemorySearchScan(&SearchContext, Address, Chunk, ChunkSize))
+                {
                     //
-                    // Increase the array pointer if it doesn't exceed the limitation
+                    // The result buffer is full!
                     //
-                    if (MaximumSearchResults > IndexToArrayOfResults)
-                    {
-                        IndexToArrayOfResults++;
-                    }
-                    else
-                    {
-                        //
-                        // The result buffer is full!
-                        //
-                        *CountOfMatchedCases = CountOfOccurance;
-                        return TRUE;
-                    }
+                    break;
                 }
             }
-            else
-            {
-                //
-                // Not found in the place
-                //
-                continue;
-            }
         }
 
         //
@@ -1005,7 +1043,7 @@ PerformSearchAddress(UINT64 *                AddressToSaveResults,
     //
     // As we're here the search is finished without error
     //
-    *CountOfMatchedCases = CountOfOccurance;
+    *CountOfMatchedCases = Results.CountOfOccurance;
     return TRUE;
 }
 
@@ -1121,6 +1121,14 @@ DebuggerRegisterEvent(PDEBUGGER_EVENT Event)
     {
         InsertHeadList(TargetEventList, &(Event->EventsOfSameTypeList));
 
+        //
+        // The newer events are triggered first (same as the list of events),
+        // the event is indexed after it's applied, as applying the event sets
+        // the options that its key is taken from (e.g., the physical address
+        // of the detours)
+        //
+        Event->IndexEntry.Order = ++g_EventsIndexOrder;
+
         return TRUE;
     }
     else
@@ -1129,6 +1137,153 @@ DebuggerRegisterEvent(PDEBUGGER_EVENT Event)
     }
 }
 
+/**
+ * @brief Get the key that an event is triggered for
+ * @details The key is the same value that is checked for the event
+ * in DebuggerTriggerEvents
+ *
+ * @param Event Event structure
+ * @param Key The key of the event
+ * @return BOOLEAN TRUE if the event has a key and FALSE if the event
+ * is triggered for all of the keys
+ */
+static BOOLEAN
+DebuggerGetEventIndexKey(PDEBUGGER_EVENT Event, UINT64 * Key)
+{
+    *Key = Event->Options.OptionalParam1;
+
+    switch (Event->EventType)
+    {
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+
+        //
+        // The hooking tag is same as the event tag
+        //
+        *Key = Event->Tag;
+        return TRUE;
+
+    case EXTERNAL_INTERRUPT_OCCURRED:
+    case HIDDEN_HOOK_EXEC_CC:
+    case HIDDEN_HOOK_EXEC_DETOURS:
+    case CONTROL_REGISTER_MODIFIED:
+        return TRUE;
+
+    case RDMSR_INSTRUCTION_EXECUTION:
+    case WRMSR_INSTRUCTION_EXECUTION:
+        return *Key != DEBUGGER_EVENT_MSR_READ_OR_WRITE_ALL_MSRS;
+
+    case EXCEPTION_OCCURRED:
+        return *Key != DEBUGGER_EVENT_EXCEPTIONS_ALL_FIRST_32_ENTRIES;
+
+    case IN_INSTRUCTION_EXECUTION:
+    case OUT_INSTRUCTION_EXECUTION:
+        return *Key != DEBUGGER_EVENT_ALL_IO_PORTS;
+
+    case SYSCALL_HOOK_EFER_SYSCALL:
+        return *Key != DEBUGGER_EVENT_SYSCALL_ALL_SYSRET_OR_SYSCALLS;
+
+    case CPUID_INSTRUCTION_EXECUTION:
+    case XSETBV_INSTRUCTION_EXECUTION:
+
+        //
+        // The first parameter shows whether the user needs a special CPUID (XCR)
+        //
+        *Key = Event->Options.OptionalParam2;
+        return Event->Options.OptionalParam1 != (UINT64)NULL /*FALSE*/;
+
+    default: // All other events that don't have a key
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Add an event to the index of its type
+ * @details The index is used for dispatching the triggered events, an event
+ * is indexed once (re-applying the event keeps its key) and stays in the index
+ * until it's cleared, the disabled events are skipped by DebuggerTriggerEvents
+ *
+ * @param Event Event structure
+ * @return VOID
+ */
+VOID
+DebuggerIndexEvent(PDEBUGGER_EVENT Event)
+{
+    UINT64  Key;
+    BOOLEAN HasKey;
+
+    if (g_EventsIndex == NULL || (UINT32)Event->EventType >= DEBUGGER_EVENT_TYPES_COUNT)
+    {
+        return;
+    }
+
+    HasKey = DebuggerGetEventIndexKey(Event, &Key);
+
+    //
+    // The entry of the event is never linked again, as the other cores might
+    // be walking the index at the same time
+    //
+    if (!EventIndexInsert(&g_EventsIndex[Event->EventType], &Event->IndexEntry, Key, !HasKey))
+    {
+        LogError("Err, the key of the event (tag: %llx) is changed after it's indexed", Event->Tag);
+    }
+}
+
+/**
+ * @brief Remove an event from the index of its type
+ * @details The other cores might still be on the event, so it should be
+ * freed after the cores are synchronized (e.g., after the event is terminated)
+ *
+ * @param Event Event structure
+ * @return VOID
+ */
+VOID
+DebuggerUnindexEvent(PDEBUGGER_EVENT Event)
+{
+    if (g_EventsIndex == NULL || (UINT32)Event->EventType >= DEBUGGER_EVENT_TYPES_COUNT)
+    {
+        return;
+    }
+
+    EventIndexRemove(&g_EventsIndex[Event->EventType], &Event->IndexEntry);
+}
+
+/**
+ * @brief Remove all of the events from the index of their types
+ * @details The other cores might still be on the events, so they should be
+ * freed after the cores are synchronized (e.g., after the events are terminated)
+ *
+ * @return VOID
+ */
+VOID
+DebuggerUnindexAllEvents()
+{
+    PLIST_ENTRY TempList  = 0;
+    PLIST_ENTRY TempList2 = 0;
+
+    //
+    // We have to iterate through all events
+    //
+    for (SIZE_T i = 0; i < sizeof(DEBUGGER_CORE_EVENTS) / sizeof(LIST_ENTRY); i++)
+    {
+        TempList  = (PLIST_ENTRY)((UINT64)(g_Events) + (i * sizeof(LIST_ENTRY)));
+        TempList2 = TempList;
+
+        while (TempList2 != TempList->Flink)
+        {
+            TempList                     = TempList->Flink;
+            PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+
+            DebuggerUnindexEvent(CurrentEvent);
+        }
+    }
+}
+
 /**
  * @brief Trigger events of a special type to be managed by debugger
  *
@@ -1153,8 +1308,9 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
     DebuggerCheckForCondition *      ConditionFunc;
     DEBUGGER_TRIGGERED_EVENT_DETAILS EventTriggerDetail = {0};
     PEPT_HOOKS_CONTEXT               EptContext;
-    PLIST_ENTRY                      TempList        = 0;
-    PLIST_ENTRY                      TempList2       = 0;
+    EVENT_INDEX_ITERATOR             Iterator;
+    PEVENT_INDEX_ENTRY               IndexEntry;
+    UINT64                           Key;
     const PVOID                      OriginalContext = Context;
 
     //
@@ -1174,20 +1330,48 @@ DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
     DbgState = &g_DbgState[KeGetCurrentProcessorNumberEx(NULL)];
 
     //
-    // Find the debugger events list base on the type of the event
+    // Find the index of the events base on the type of the event
     //
-    TempList  = DebuggerGetEventListByEventType(EventType);
-    TempList2 = TempList;
-
-    if (TempList == NULL)
+    if ((UINT32)EventType >= DEBUGGER_EVENT_TYPES_COUNT)
     {
         return VMM_CALLBACK_TRIGGERING_EVENT_STATUS_INVALID_EVENT_TYPE;
     }
 
-    while (TempList2 != TempList->Flink)
+    //
+    // Get the key that the events are triggered for (the events are
+    // indexed by the same key in DebuggerIndexEvent)
+    //
+    switch (EventType)
     {
-        TempList                     = TempList->Flink;
-        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(TempList, DEBUGGER_EVENT, EventsOfSameTypeList);
+    case HIDDEN_HOOK_READ_AND_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ_AND_WRITE:
+    case HIDDEN_HOOK_READ_AND_EXECUTE:
+    case HIDDEN_HOOK_WRITE_AND_EXECUTE:
+    case HIDDEN_HOOK_READ:
+    case HIDDEN_HOOK_WRITE:
+    case HIDDEN_HOOK_EXECUTE:
+        Key = OriginalContext != NULL ? ((PEPT_HOOKS_CONTEXT)OriginalContext)->HookingTag : NULL64_ZERO;
+        break;
+
+    case HIDDEN_HOOK_EXEC_DETOURS:
+        Key = OriginalContext != NULL ? ((PEPT_HOOKS_CONTEXT)OriginalContext)->PhysicalAddress : NULL64_ZERO;
+        break;
+
+    default:
+        Key = (UINT64)OriginalContext;
+        break;
+    }
+
+    //
+    // Only visit the events of this key and the events of all keys, the
+    // conditions of the events are still checked as different keys might
+    // share a bucket of the index
+    //
+    for (IndexEntry = EventIndexFirst(&g_EventsIndex[EventType], Key, &Iterator);
+         IndexEntry != NULL;
+         IndexEntry = EventIndexNext(&Iterator))
+    {
+        PDEBUGGER_EVENT CurrentEvent = CONTAINING_RECORD(IndexEntry, DEBUGGER_EVENT, IndexEntry);
 
         //
         // check if the event is enabled or not
@@ -2376,7 +2560,7 @@ DebuggerEnableEvent(UINT64 Tag)
     }
 
     //
-    // Enable the event
+    // Enable the event (the event is already in the index)
     //
     Event->Enabled = TRUE;
 
@@ -2438,7 +2622,8 @@ DebuggerDisableEvent(UINT64 Tag)
     }
 
     //
-    // Disable the event
+    // Disable the event (the event stays in the index, so it could be
+    // enabled again without linking it again)
     //
     Event->Enabled = FALSE;
 
@@ -2469,9 +2654,14 @@ DebuggerClearEvent(UINT64 Tag, BOOLEAN InputFromVmxRoot, BOOLEAN PoolManagerAllo
     //
 
     //
-    // First, disable just one event
+    // First, disable just one event and remove it from the index, the cores
+    // are synchronized by the termination, so no core is on the event when
+    // it's freed
     //
-    DebuggerDisableEvent(Tag);
+    if (DebuggerDisableEvent(Tag))
+    {
+        DebuggerUnindexEvent(DebuggerGetEventByTag(Tag));
+    }
 
     //
     // Second, terminate it
@@ -2506,9 +2696,12 @@ DebuggerClearAllEvents(BOOLEAN InputFromVmxRoot, BOOLEAN PoolManagerAllocatedMem
     //
 
     //
-    // First, disable all events
+    // First, disable all events and remove them from the index, the cores
+    // are synchronized by the termination, so no core is on the events when
+    // they're freed
     //
     DebuggerEnableOrDisableAllEvents(FALSE);
+    DebuggerUnindexAllEvents();
 
     //
     // Second, terminate all events
@@ -2603,9 +2796,10 @@ DebuggerRemoveEventFromEventList(UINT64 Tag)
             if (CurrentEvent->Tag == Tag)
             {
                 //
-                // We have to remove the event from the list
+                // We have to remove the event from the list (and the index)
                 //
                 RemoveEntryList(&CurrentEvent->EventsOfSameTypeList);
+                DebuggerUnindexEvent(CurrentEvent);
                 return TRUE;
             }
         }
@@ -3157,6 +3351,13 @@ DebuggerApplyEvent(PDEBUGGER_EVENT                   Event,
     }
     }
 
+    //
+    // The key of the event is taken from the options that are set by applying
+    // the event, so the event is indexed here (re-applying the event keeps it
+    // where it is)
+    //
+    DebuggerIndexEvent(Event);
+
     //
     // Set the status
     //
@@ -3317,8 +3518,8 @@ DebuggerParseEvent(PDEBUGGER_GENERAL_EVENT_DETAIL    EventDetails,
 }
 
 /**
- * @brief Routine for validating and parsing actions that are coming from
- * the user-mode
+ * @brief Routine for validating and parsing actions without enabling
+ * the target event
  *
  * @param ActionDetails Structure that describes the action that comes from the
  * user-mode
@@ -3329,10 +3530,10 @@ DebuggerParseEvent(PDEBUGGER_GENERAL_EVENT_DETAIL    EventDetails,
  * @return BOOLEAN if action was parsed and added successfully, return TRUE
  * otherwise, returns FALSE
  */
-BOOLEAN
-DebuggerParseAction(PDEBUGGER_GENERAL_ACTION          ActionDetails,
-                    PDEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn,
-                    BOOLEAN                           InputFromVmxRoot)
+static BOOLEAN
+DebuggerParseActionWithoutEnablingEvent(PDEBUGGER_GENERAL_ACTION          ActionDetails,
+                                        PDEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn,
+                                        BOOLEAN                           InputFromVmxRoot)
 {
     DEBUGGER_EVENT_ACTION * Action = NULL;
 
@@ -3481,17 +3682,182 @@ DebuggerParseAction(PDEBUGGER_GENERAL_ACTION          ActionDetails,
         return FALSE;
     }
 
+    ResultsToReturn->IsSuccessful = TRUE;
+    ResultsToReturn->Error        = 0;
+
+    return TRUE;
+}
+
+/**
+ * @brief Routine for validating and parsing actions that are coming from
+ * the user-mode
+ *
+ * @param ActionDetails Structure that describes the action that comes from the
+ * user-mode
+ * @param ResultsToReturn The buffer address that should be returned
+ * to the user-mode as the result
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return BOOLEAN if action was parsed and added successfully, return TRUE
+ * otherwise, returns FALSE
+ */
+BOOLEAN
+DebuggerParseAction(PDEBUGGER_GENERAL_ACTION          ActionDetails,
+                    PDEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn,
+                    BOOLEAN                           InputFromVmxRoot)
+{
+    if (!DebuggerParseActionWithoutEnablingEvent(ActionDetails, ResultsToReturn, InputFromVmxRoot))
+    {
+        return FALSE;
+    }
+
     //
     // Enable the event
     //
-    DebuggerEnableEvent(Event->Tag);
-
-    ResultsToReturn->IsSuccessful = TRUE;
-    ResultsToReturn->Error        = 0;
+    DebuggerEnableEvent(ActionDetails->EventTag);
 
     return TRUE;
 }
 
+/**
+ * @brief Routine for validating and parsing a set of events and their actions
+ * @details The set is validated as a whole before creating any of the events,
+ * if any of the entries fails, all of the events of the set are removed, the
+ * events are only enabled once all of the entries are applied. The error and
+ * the failed entry are set in the result on every failure
+ *
+ * @param EventSet The set of the events and actions
+ * @param BufferLength Length of the buffer that contains the set
+ * @param ResultsToReturn The buffer address that should be returned
+ * to the user-mode as the result
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return BOOLEAN TRUE if all of the entries of the set are applied, otherwise
+ * returns FALSE and none of the entries are applied
+ */
+BOOLEAN
+DebuggerParseEventSet(PDEBUGGER_EVENT_SET        EventSet,
+                      UINT32                     BufferLength,
+                      PDEBUGGER_EVENT_SET_RESULT ResultsToReturn,
+                      BOOLEAN                    InputFromVmxRoot)
+{
+    DEBUGGER_EVENT_AND_ACTION_RESULT EntryResult  = {0};
+    PDEBUGGER_EVENT_SET_ENTRY        Entry        = NULL;
+    PROCESSOR_DEBUGGING_STATE *      DbgState     = NULL;
+    BOOLEAN                          IsSuccessful = TRUE;
+    UINT32                           Offset;
+    UINT32                           Index;
+
+    //
+    // Validate all of the entries before applying anything
+    //
+    if (!ValidateEventSet(EventSet, BufferLength, ResultsToReturn, InputFromVmxRoot))
+    {
+        return FALSE;
+    }
+
+    //
+    // The halted cores are changed once for the whole set (rather than
+    // a broadcast for each event)
+    //
+    if (InputFromVmxRoot)
+    {
+        DbgState = &g_DbgState[KeGetCurrentProcessorNumberEx(NULL)];
+
+        HaltedCoreBeginBatch();
+    }
+
+    //
+    // Create and apply the events and add the actions (the events are
+    // still disabled)
+    //
+    for (Index = 0, Offset = sizeof(DEBUGGER_EVENT_SET); Index < EventSet->NumberOfEntries; Index++, Offset += Entry->Length)
+    {
+        Entry = (PDEBUGGER_EVENT_SET_ENTRY)((UINT64)EventSet + Offset);
+
+        //
+        // The result of the previous entry is not kept
+        //
+        RtlZeroMemory(&EntryResult, sizeof(DEBUGGER_EVENT_AND_ACTION_RESULT));
+
+        if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT)
+        {
+            IsSuccessful = DebuggerParseEvent((PDEBUGGER_GENERAL_EVENT_DETAIL)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY)),
+                                              &EntryResult,
+                                              InputFromVmxRoot);
+        }
+        else
+        {
+            IsSuccessful = DebuggerParseActionWithoutEnablingEvent((PDEBUGGER_GENERAL_ACTION)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY)),
+                                                                   &EntryResult,
+                                                                   InputFromVmxRoot);
+        }
+
+        if (!IsSuccessful)
+        {
+            break;
+        }
+    }
+
+    if (IsSuccessful)
+    {
+        //
+        // Enable the events that have actions
+        //
+        for (Index = 0, Offset = sizeof(DEBUGGER_EVENT_SET); Index < EventSet->NumberOfEntries; Index++, Offset += Entry->Length)
+        {
+            Entry = (PDEBUGGER_EVENT_SET_ENTRY)((UINT64)EventSet + Offset);
+
+            if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION)
+            {
+                DebuggerEnableEvent(((PDEBUGGER_GENERAL_ACTION)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY)))->EventTag);
+            }
+        }
+
+        ResultsToReturn->IsSuccessful = TRUE;
+        ResultsToReturn->Error        = 0;
+        ResultsToReturn->FailedEntry  = 0;
+    }
+    else
+    {
+        ResultsToReturn->IsSuccessful = FALSE;
+        ResultsToReturn->Error        = EntryResult.Error != 0 ? EntryResult.Error : DEBUGGER_ERROR_EVENT_SET_ENTRY_CANNOT_BE_APPLIED;
+        ResultsToReturn->FailedEntry  = Index;
+    }
+
+    //
+    // Apply the deferred changes to the halted cores
+    //
+    if (InputFromVmxRoot)
+    {
+        HaltedCoreEndBatch(DbgState);
+    }
+
+    if (!IsSuccessful)
+    {
+        //
+        // Remove the events that are created before the failed entry (a failed
+        // event is already removed by the parser). It's done after the batch,
+        // so the termination of the events is broadcast right away (after their
+        // creation is applied to the other cores) and not deferred after their
+        // buffers are freed
+        //
+        for (Index = 0, Offset = sizeof(DEBUGGER_EVENT_SET); Index < ResultsToReturn->FailedEntry; Index++, Offset += Entry->Length)
+        {
+            Entry = (PDEBUGGER_EVENT_SET_ENTRY)((UINT64)EventSet + Offset);
+
+            if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT)
+            {
+                DebuggerClearEvent(((PDEBUGGER_GENERAL_EVENT_DETAIL)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY)))->Tag,
+                                   InputFromVmxRoot,
+                                   InputFromVmxRoot);
+            }
+        }
+    }
+
+    return IsSuccessful;
+}
+
 /**
  * @brief Terminate one event's effect by its tag
  *
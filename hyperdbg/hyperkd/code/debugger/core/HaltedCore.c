@@ -383,94 +383,333 @@ HaltedCoreRunTaskOnSingleCore(UINT32  TargetCoreId,
 }
 
 /**
- * @brief Broadcast tasks to halted cores
+ * @brief Perform the tasks of the broadcast round on a halted core (if any)
  * @details This function should be called from VMX root-mode
  *
  * @param DbgState The state of the debugger on the current core
- * @param TargetTask The target task
- * @param LockAgainAfterTask Lock the core after the task
+ * @param LockAgainAfterTask Whether the core is locked again after the tasks
+ *
+ * @return BOOLEAN TRUE if a round is performed
+ */
+BOOLEAN
+HaltedCorePerformBroadcastTasks(PROCESSOR_DEBUGGING_STATE * DbgState,
+                                BOOLEAN *                   LockAgainAfterTask)
+{
+    PTASK_BROADCAST_ROUND Round;
+
+    Round = TaskBroadcastTake(&g_HaltedCoreBroadcast, &DbgState->HaltedCoreTask.BroadcastSequence);
+
+    if (Round == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+    {
+        HaltedCorePerformTargetTask(DbgState, Round->Tasks[i].TargetTask, Round->Tasks[i].Context);
+    }
+
+    *LockAgainAfterTask = Round->WaitAfterTasks;
+
+    //
+    // The core should be locked before the countdown, so once the round is
+    // completed, all of the cores are locked again
+    //
+    if (*LockAgainAfterTask)
+    {
+        SpinlockLock(&DbgState->Lock);
+    }
+
+    TaskBroadcastComplete(&g_HaltedCoreBroadcast);
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish a round of tasks to halted cores
+ * @details This function should be called from VMX root-mode
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Round The tasks (the contexts should be valid until the round is finished)
+ * @param PerformOnCurrentCore Whether the tasks are performed on the current core
  * @param Synchronize Whether the function should wait for all cores to synchronize
  * and lock again or not
- * @param Context optional parameter passed to the functions
  *
- * @return BOOLEAN
+ * @return VOID
  */
-BOOLEAN
-HaltedCoreBroadcastTaskAllCores(PROCESSOR_DEBUGGING_STATE * DbgState,
-                                UINT64                      TargetTask,
-                                BOOLEAN                     LockAgainAfterTask,
-                                BOOLEAN                     Synchronize,
-                                PVOID                       Context)
+static VOID
+HaltedCorePublishRound(PROCESSOR_DEBUGGING_STATE * DbgState,
+                       PTASK_BROADCAST_ROUND       Round,
+                       BOOLEAN                     PerformOnCurrentCore,
+                       BOOLEAN                     Synchronize)
 {
     ULONG ProcessorsCount;
 
     ProcessorsCount = KeQueryActiveProcessorCount(0);
 
     //
-    // Synchronization is not possible when the locking after the task is
-    // not expected
+    // Wait for the previous round (if it's not synchronized) and then publish
+    // the round for all cores except current core
     //
-    if (Synchronize && !LockAgainAfterTask)
+    while (!TaskBroadcastPublish(&g_HaltedCoreBroadcast,
+                                 Round,
+                                 ProcessorsCount - 1,
+                                 &DbgState->HaltedCoreTask.BroadcastSequence))
     {
-        LogWarning("Synchronization is not possible when the locking after the task is not expected");
-        return FALSE;
+        _mm_pause();
     }
 
     //
-    // Apply the task to all cores except current core
+    // Unlock the halted cores, all of them take the round at the same time
     //
     for (UINT32 i = 0; i < ProcessorsCount; i++)
     {
         if (DbgState->CoreId != i)
         {
-            //
-            // apply task to the target core
-            //
-            HaltedCoreApplyTaskOnTargetCore(i, TargetTask, LockAgainAfterTask, Context);
+            KdUnlockTheHaltedCore(&g_DbgState[i]);
         }
-        else
+    }
+
+    //
+    // Perform the tasks for the current core
+    //
+    if (PerformOnCurrentCore)
+    {
+        for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
         {
-            //
-            // Perform the task for the current core
-            //
-            HaltedCorePerformTargetTask(DbgState, TargetTask, Context);
+            HaltedCorePerformTargetTask(DbgState, Round->Tasks[i].TargetTask, Round->Tasks[i].Context);
         }
     }
 
     //
-    // If synchronization is expected, we need to check to make sure
-    // all cores are synchronized (locked) at this point or not
+    // If synchronization is expected, we need to wait for the countdown of the
+    // round (each core is locked again before finishing the round)
     //
     if (Synchronize)
     {
-        for (SIZE_T i = 0; i < ProcessorsCount; i++)
+        while (!TaskBroadcastIsCompleted(&g_HaltedCoreBroadcast))
+        {
+            _mm_pause();
+        }
+    }
+}
+
+/**
+ * @brief Check whether a task could be deferred to the batch of tasks
+ * @details Only the tasks that enable an exiting (or invalidate EPT) with
+ * a DIRECT_VMCALL_PARAMETERS context are deferred, so the tasks of a batch
+ * never undo each other
+ *
+ * @param TargetTask
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+HaltedCoreIsBatchableTask(UINT64 TargetTask)
+{
+    switch (TargetTask)
+    {
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_READ:
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_MSR_BITMAP_WRITE:
+    case DEBUGGER_HALTED_CORE_TASK_CHANGE_IO_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDPMC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_SET_RDTSC_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_DEBUG_REGS_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_SET_EXCEPTION_BITMAP:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_EXTERNAL_INTERRUPT_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_MOV_TO_CONTROL_REGS_EXITING:
+    case DEBUGGER_HALTED_CORE_TASK_ENABLE_SYSCALL_HOOK_EFER:
+    case DEBUGGER_HALTED_CORE_TASK_INVEPT_ALL_CONTEXTS:
+    case DEBUGGER_HALTED_CORE_TASK_INVEPT_SINGLE_CONTEXT:
+
+        return TRUE;
+
+    default:
+
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Defer the tasks of a round to the batch of tasks (if possible)
+ * @details This function should be called from VMX root-mode
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Round
+ *
+ * @return BOOLEAN FALSE if the round could not be deferred
+ */
+static BOOLEAN
+HaltedCoreDeferRoundToBatch(PROCESSOR_DEBUGGING_STATE * DbgState,
+                            PTASK_BROADCAST_ROUND       Round)
+{
+    for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+    {
+        if (!HaltedCoreIsBatchableTask(Round->Tasks[i].TargetTask))
         {
-            if (DbgState->CoreId != i)
+            return FALSE;
+        }
+    }
+
+    //
+    // Make room for all of the tasks of the round
+    //
+    if (g_HaltedCoreBatch.NumberOfTasks + Round->NumberOfTasks > TASK_BROADCAST_BATCH_MAXIMUM_TASKS)
+    {
+        HaltedCoreFlushBatch(DbgState);
+    }
+
+    for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+    {
+        TaskBroadcastBatchAddTask(&g_HaltedCoreBatch,
+                                  Round->Tasks[i].TargetTask,
+                                  Round->Tasks[i].Context,
+                                  sizeof(DIRECT_VMCALL_PARAMETERS));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Start deferring the synchronized tasks of the halted cores to a batch
+ * @details This function should be called from VMX root-mode, the tasks are
+ * performed on the current core immediately and on the other cores once the
+ * batch is flushed
+ *
+ * @return VOID
+ */
+VOID
+HaltedCoreBeginBatch()
+{
+    TaskBroadcastBatchInitialize(&g_HaltedCoreBatch);
+
+    g_HaltedCoreBatchActive = TRUE;
+}
+
+/**
+ * @brief Broadcast the deferred tasks of the batch to the halted cores
+ * @details This function should be called from VMX root-mode
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+HaltedCoreFlushBatch(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    TASK_BROADCAST_ROUND Round;
+
+    //
+    // The tasks are already performed on the current core
+    //
+    while (TaskBroadcastBatchNextRound(&g_HaltedCoreBatch, &Round, TRUE))
+    {
+        HaltedCorePublishRound(DbgState, &Round, FALSE, TRUE);
+    }
+
+    TaskBroadcastBatchInitialize(&g_HaltedCoreBatch);
+}
+
+/**
+ * @brief Broadcast the deferred tasks and stop deferring the tasks
+ * @details This function should be called from VMX root-mode
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+HaltedCoreEndBatch(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    HaltedCoreFlushBatch(DbgState);
+
+    g_HaltedCoreBatchActive = FALSE;
+}
+
+/**
+ * @brief Broadcast a round of tasks to halted cores
+ * @details This function should be called from VMX root-mode, all of the
+ * halted cores perform the tasks of the round at the same time
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param Round The tasks (the contexts should be valid until the round is finished)
+ * @param Synchronize Whether the function should wait for all cores to synchronize
+ * and lock again or not
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HaltedCoreBroadcastRoundAllCores(PROCESSOR_DEBUGGING_STATE * DbgState,
+                                 PTASK_BROADCAST_ROUND       Round,
+                                 BOOLEAN                     Synchronize)
+{
+    //
+    // Synchronization is not possible when the locking after the task is
+    // not expected
+    //
+    if (Synchronize && !Round->WaitAfterTasks)
+    {
+        LogWarning("Synchronization is not possible when the locking after the task is not expected");
+        return FALSE;
+    }
+
+    if (g_HaltedCoreBatchActive)
+    {
+        //
+        // The synchronized rounds are deferred to the batch (if possible) and
+        // only performed on the current core
+        //
+        if (Synchronize && HaltedCoreDeferRoundToBatch(DbgState, Round))
+        {
+            for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
             {
-                //
-                // Wait until the core is locked again
-                //
-                while (TRUE)
-                {
-                    //
-                    // Keep checking to make sure the target core finished the
-                    // execution its task and locked again
-                    //
-                    if (KdCheckTheHaltedCore(&g_DbgState[i]) == FALSE)
-                    {
-                        continue;
-                    }
-                    else
-                    {
-                        break;
-                    }
-                }
+                HaltedCorePerformTargetTask(DbgState, Round->Tasks[i].TargetTask, Round->Tasks[i].Context);
             }
+
+            return TRUE;
         }
+
+        //
+        // The deferred tasks are performed before this round to keep the order
+        //
+        HaltedCoreFlushBatch(DbgState);
     }
 
+    HaltedCorePublishRound(DbgState, Round, TRUE, Synchronize);
+
     //
     // All cores locked again
     //
     return TRUE;
 }
+
+/**
+ * @brief Broadcast tasks to halted cores
+ * @details This function should be called from VMX root-mode
+ *
+ * @param DbgState The state of the debugger on the current core
+ * @param TargetTask The target task
+ * @param LockAgainAfterTask Lock the core after the task
+ * @param Synchronize Whether the function should wait for all cores to synchronize
+ * and lock again or not
+ * @param Context optional parameter passed to the functions
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HaltedCoreBroadcastTaskAllCores(PROCESSOR_DEBUGGING_STATE * DbgState,
+                                UINT64                      TargetTask,
+                                BOOLEAN                     LockAgainAfterTask,
+                                BOOLEAN                     Synchronize,
+                                PVOID                       Context)
+{
+    TASK_BROADCAST_ROUND Round;
+
+    //
+    // A round with a single task
+    //
+    TaskBroadcastRoundInitialize(&Round, LockAgainAfterTask);
+    TaskBroadcastRoundAddTask(&Round, TargetTask, Context);
+
+    return HaltedCoreBroadcastRoundAllCores(DbgState, &Round, Synchronize);
+}
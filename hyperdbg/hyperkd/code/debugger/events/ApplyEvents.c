@@ -334,13 +334,8 @@ ApplyEventEptHookExecCcEvent(PDEBUGGER_EVENT                   Event,
         //
 
         //
-        // First, breakpoints have to be intercepted as the caller to the
-        // direct hook function have to broadcast it by its own
-        //
-        HaltedBroadcastSetExceptionBitmapAllCores(EXCEPTION_VECTOR_BREAKPOINT);
-
-        //
-        // Invoke the hooker
+        // Invoke the hooker (other cores are halted, so the breakpoints are
+        // intercepted before any of them runs the hooked page)
         //
         if (!ConfigureEptHookFromVmxRoot((PVOID)Event->InitOptions.OptionalParam1))
         {
@@ -355,10 +350,12 @@ ApplyEventEptHookExecCcEvent(PDEBUGGER_EVENT                   Event,
         else
         {
             //
-            // As the call to hook adjuster was successful, we have to
-            // invalidate the TLB of EPT caches for all cores here
+            // As the call to hook adjuster was successful, breakpoints have to be
+            // intercepted as the caller to the direct hook function have to broadcast
+            // it by its own, and we have to invalidate the TLB of EPT caches for all
+            // cores here (both of them in a single round)
             //
-            HaltedBroadcastInvalidateSingleContextAllCores();
+            HaltedBroadcastSetExceptionBitmapAndInvalidateSingleContextAllCores(EXCEPTION_VECTOR_BREAKPOINT);
         }
     }
     else
@@ -1650,18 +1650,21 @@ TerminateEptHookUnHookSingleAddressFromVmxRootAndApplyInvalidation(UINT64 Virtua
     {
         //
         // It's the responsibility of the caller to restore EPT entries and
-        // invalidate EPT caches
+        // invalidate EPT caches, and also to clear #BPs directly from VMX-root
+        // mode if applied from VMX-root mode (if the hook was the last hook),
+        // both of them are broadcast in a single round if needed
         //
-        if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt)
+        if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt &&
+            TargetUnhookingDetails.RemoveBreakpointInterception)
+        {
+            HaltedBroadcastUnhookSinglePageAndUnSetExceptionBitmapAllCores(&TargetUnhookingDetails,
+                                                                            EXCEPTION_VECTOR_BREAKPOINT);
+        }
+        else if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt)
         {
             HaltedBroadcastUnhookSinglePageAllCores(&TargetUnhookingDetails);
         }
-
-        //
-        // It's the responsibility of the caller to clear #BPs directly from
-        // VMX-root mode if applied from VMX-root mode
-        //
-        if (TargetUnhookingDetails.RemoveBreakpointInterception)
+        else if (TargetUnhookingDetails.RemoveBreakpointInterception)
         {
             //
             // The hook was the last hook and we can broadcast to
@@ -1710,18 +1713,21 @@ UnhookNextPossibleTag:
 
         //
         // It's the responsibility of the caller to restore EPT entries and
-        // invalidate EPT caches
+        // invalidate EPT caches, and also to clear #BPs directly from VMX-root
+        // mode if applied from VMX-root mode (if the hook was the last hook),
+        // both of them are broadcast in a single round if needed
         //
-        if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt)
+        if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt &&
+            TargetUnhookingDetails.RemoveBreakpointInterception)
+        {
+            HaltedBroadcastUnhookSinglePageAndUnSetExceptionBitmapAllCores(&TargetUnhookingDetails,
+                                                                            EXCEPTION_VECTOR_BREAKPOINT);
+        }
+        else if (TargetUnhookingDetails.CallerNeedsToRestoreEntryAndInvalidateEpt)
         {
             HaltedBroadcastUnhookSinglePageAllCores(&TargetUnhookingDetails);
         }
-
-        //
-        // It's the responsibility of the caller to clear #BPs directly from
-        // VMX-root mode if applied from VMX-root mode
-        //
-        if (TargetUnhookingDetails.RemoveBreakpointInterception)
+        else if (TargetUnhookingDetails.RemoveBreakpointInterception)
         {
             //
             // The hook was the last hook and we can broadcast to
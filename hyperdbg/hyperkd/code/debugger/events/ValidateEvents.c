@@ -313,3 +313,187 @@ ValidateEventEptHookHiddenBreakpointAndInlineHooks(PDEBUGGER_GENERAL_EVENT_DETAI
     //
     return TRUE;
 }
+
+/**
+ * @brief Check whether an event with the tag is among the first entries of a set
+ * @details The entries before the end offset should be already validated
+ *
+ * @param EventSet
+ * @param EndOffset Offset of the first entry that is not checked
+ * @param Tag
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+ValidateEventSetHasEvent(PDEBUGGER_EVENT_SET EventSet, UINT32 EndOffset, UINT64 Tag)
+{
+    PDEBUGGER_EVENT_SET_ENTRY Entry;
+
+    for (UINT32 Offset = sizeof(DEBUGGER_EVENT_SET); Offset < EndOffset; Offset += Entry->Length)
+    {
+        Entry = (PDEBUGGER_EVENT_SET_ENTRY)((UINT64)EventSet + Offset);
+
+        if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT &&
+            ((PDEBUGGER_GENERAL_EVENT_DETAIL)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY)))->Tag == Tag)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Validating the entries of an event set (as a whole)
+ * @details Checks the bounds of the entries, the parameters of each event, the
+ * buffers of each action and that each action belongs to an event of the same set
+ *
+ * @param EventSet The set of the events and actions
+ * @param BufferLength Length of the buffer that contains the set
+ * @param ResultsToReturn Result buffer that should be returned to
+ * the user-mode
+ * @param InputFromVmxRoot Whether the input comes from VMX root-mode or IOCTL
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ValidateEventSet(PDEBUGGER_EVENT_SET        EventSet,
+                 UINT32                     BufferLength,
+                 PDEBUGGER_EVENT_SET_RESULT ResultsToReturn,
+                 BOOLEAN                    InputFromVmxRoot)
+{
+    DEBUGGER_EVENT_AND_ACTION_RESULT EventResult = {0};
+    PDEBUGGER_EVENT_SET_ENTRY        Entry;
+    PDEBUGGER_GENERAL_EVENT_DETAIL   EventDetails;
+    PDEBUGGER_GENERAL_ACTION         ActionDetails;
+    UINT32                           Offset = sizeof(DEBUGGER_EVENT_SET);
+    UINT32                           Index;
+
+    ResultsToReturn->IsSuccessful = FALSE;
+    ResultsToReturn->Error        = DEBUGGER_ERROR_INVALID_EVENT_SET;
+    ResultsToReturn->FailedEntry  = 0;
+
+    if (BufferLength < sizeof(DEBUGGER_EVENT_SET) ||
+        EventSet->Length < sizeof(DEBUGGER_EVENT_SET) ||
+        EventSet->Length > BufferLength ||
+        EventSet->NumberOfEntries == 0)
+    {
+        return FALSE;
+    }
+
+    for (Index = 0; Index < EventSet->NumberOfEntries; Index++)
+    {
+        ResultsToReturn->FailedEntry = Index;
+        ResultsToReturn->Error       = DEBUGGER_ERROR_INVALID_EVENT_SET;
+
+        //
+        // Check the bounds of the entry
+        //
+        if (EventSet->Length - Offset < sizeof(DEBUGGER_EVENT_SET_ENTRY))
+        {
+            return FALSE;
+        }
+
+        Entry = (PDEBUGGER_EVENT_SET_ENTRY)((UINT64)EventSet + Offset);
+
+        if (Entry->Length < sizeof(DEBUGGER_EVENT_SET_ENTRY) ||
+            Entry->Length > EventSet->Length - Offset ||
+            Entry->Length % DEBUGGER_EVENT_SET_ENTRY_ALIGNMENT != 0)
+        {
+            return FALSE;
+        }
+
+        if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT)
+        {
+            EventDetails = (PDEBUGGER_GENERAL_EVENT_DETAIL)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY));
+
+            if (Entry->Length - sizeof(DEBUGGER_EVENT_SET_ENTRY) < sizeof(DEBUGGER_GENERAL_EVENT_DETAIL) ||
+                EventDetails->ConditionBufferSize > Entry->Length - sizeof(DEBUGGER_EVENT_SET_ENTRY) - sizeof(DEBUGGER_GENERAL_EVENT_DETAIL))
+            {
+                return FALSE;
+            }
+
+            //
+            // The tag should not be used by another event
+            //
+            if (DebuggerIsTagValid(EventDetails->Tag) || ValidateEventSetHasEvent(EventSet, Offset, EventDetails->Tag))
+            {
+                ResultsToReturn->Error = DEBUGGER_ERROR_EVENT_SET_TAG_IS_NOT_UNIQUE;
+                return FALSE;
+            }
+
+            //
+            // Validate the parameters of the event (the error of the previous
+            // entry is not kept)
+            //
+            RtlZeroMemory(&EventResult, sizeof(DEBUGGER_EVENT_AND_ACTION_RESULT));
+
+            if (!DebuggerValidateEvent(EventDetails, &EventResult, InputFromVmxRoot))
+            {
+                if (EventResult.Error != 0)
+                {
+                    ResultsToReturn->Error = EventResult.Error;
+                }
+
+                return FALSE;
+            }
+        }
+        else if (Entry->Type == DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION)
+        {
+            ActionDetails = (PDEBUGGER_GENERAL_ACTION)((UINT64)Entry + sizeof(DEBUGGER_EVENT_SET_ENTRY));
+
+            if (Entry->Length - sizeof(DEBUGGER_EVENT_SET_ENTRY) < sizeof(DEBUGGER_GENERAL_ACTION))
+            {
+                return FALSE;
+            }
+
+            //
+            // Check the buffer of the action
+            //
+            if (ActionDetails->ActionType == RUN_CUSTOM_CODE || ActionDetails->ActionType == RUN_SCRIPT)
+            {
+                UINT32 ActionBufferSize = ActionDetails->ActionType == RUN_CUSTOM_CODE ? ActionDetails->CustomCodeBufferSize : ActionDetails->ScriptBufferSize;
+
+                if (ActionBufferSize == 0)
+                {
+                    ResultsToReturn->Error = DEBUGGER_ERROR_ACTION_BUFFER_SIZE_IS_ZERO;
+                    return FALSE;
+                }
+
+                if (ActionBufferSize > Entry->Length - sizeof(DEBUGGER_EVENT_SET_ENTRY) - sizeof(DEBUGGER_GENERAL_ACTION))
+                {
+                    return FALSE;
+                }
+            }
+            else if (ActionDetails->ActionType != BREAK_TO_DEBUGGER)
+            {
+                ResultsToReturn->Error = DEBUGGER_ERROR_INVALID_ACTION_TYPE;
+                return FALSE;
+            }
+
+            //
+            // The actions of a set are only added to the events of the same set
+            //
+            if (!ValidateEventSetHasEvent(EventSet, Offset, ActionDetails->EventTag))
+            {
+                ResultsToReturn->Error = DEBUGGER_ERROR_EVENT_SET_ACTION_WITHOUT_EVENT;
+                return FALSE;
+            }
+        }
+        else
+        {
+            return FALSE;
+        }
+
+        Offset += Entry->Length;
+    }
+
+    //
+    // The set is valid at this stage
+    //
+    ResultsToReturn->IsSuccessful = TRUE;
+    ResultsToReturn->Error        = 0;
+    ResultsToReturn->FailedEntry  = 0;
+
+    return TRUE;
+}
@@ -1161,9 +1161,10 @@ KdHandleInstrumentationStepIn(PROCESSOR_DEBUGGING_STATE * DbgState)
         // Only 16 bit is needed however, vmwrite might write on other bits
         // and corrupt other variables, that's why we get 64bit
         //
-        UINT64                           CsSel         = NULL64_ZERO;
-        DEBUGGER_TRIGGERED_EVENT_DETAILS TargetContext = {0};
-        UINT64                           LastVmexitRip = VmFuncGetLastVmexitRip(DbgState->CoreId);
+        UINT64                           CsSel            = NULL64_ZERO;
+        DEBUGGER_TRIGGERED_EVENT_DETAILS TargetContext    = {0};
+        UINT64                           LastVmexitRip    = VmFuncGetLastVmexitRip(DbgState->CoreId);
+        BOOLEAN                          IsBatchContinued = FALSE;
 
         //
         // Check if the cs selector changed or not, which indicates that the
@@ -1180,6 +1181,14 @@ KdHandleInstrumentationStepIn(PROCESSOR_DEBUGGING_STATE * DbgState)
         //
         DbgState->InstrumentationStepInTrace.CsSel = 0;
 
+        //
+        // Record the executed instruction if the debuggee is stepping a batch of instructions
+        //
+        if (DbgState->BatchedSteppingMode)
+        {
+            IsBatchContinued = TracingHandleBatchedStep(DbgState);
+        }
+
         //
         // Check and handle if there is a software defined breakpoint
         //
@@ -1188,6 +1197,27 @@ KdHandleInstrumentationStepIn(PROCESSOR_DEBUGGING_STATE * DbgState)
                                                                 DEBUGGEE_PAUSING_REASON_DEBUGGEE_STEPPED,
                                                                 TRUE))
         {
+            if (IsBatchContinued)
+            {
+                //
+                // Step the next instruction of the batch without halting the debuggee
+                //
+                KdGuaranteedStepInstruction(DbgState);
+                return;
+            }
+
+            if (DbgState->BatchedSteppingMode)
+            {
+                //
+                // The batch is finished (the records are sent before the pause packet)
+                //
+                TargetContext.Context = (PVOID)LastVmexitRip;
+                KdHandleBreakpointAndDebugBreakpoints(DbgState,
+                                                      DEBUGGEE_PAUSING_REASON_DEBUGGEE_BATCHED_STEPPED,
+                                                      &TargetContext);
+                return;
+            }
+
             //
             // Handle the step (if the disassembly ignored here, it means the debugger wants to use it
             // as a tracking mechanism, so we'll change the reason for that)
@@ -1632,6 +1662,59 @@ KdPerformAddActionToEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET Ac
 #endif // EnableInstantEventMechanism
 }
 
+/**
+ * @brief Register a set of events and their actions (or send it to user-mode)
+ * @param EventSetHeader
+ * @param DebuggerEventSetResult
+ *
+ * @return BOOLEAN Shows whether the debuggee should be continued or not
+ */
+BOOLEAN
+KdPerformRegisterEventSet(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET EventSetHeader,
+                          DEBUGGER_EVENT_SET_RESULT *                         DebuggerEventSetResult)
+{
+#if EnableInstantEventMechanism
+
+    DEBUGGER_EVENT_SET * EventSet = NULL;
+
+    EventSet = (PDEBUGGER_EVENT_SET)(((CHAR *)EventSetHeader) +
+                                     sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET));
+
+    //
+    // Check to see whether all cores are halted (in instant event)
+    //
+    if (!KdCheckAllCoresAreLocked())
+    {
+        DebuggerEventSetResult->IsSuccessful = FALSE;
+        DebuggerEventSetResult->Error        = DEBUGGER_ERROR_NOT_ALL_CORES_ARE_LOCKED_FOR_APPLYING_INSTANT_EVENT;
+        DebuggerEventSetResult->FailedEntry  = 0;
+    }
+    else
+    {
+        //
+        // Parse the whole set from the VMX-root mode
+        //
+        DebuggerParseEventSet(EventSet, EventSetHeader->Length, DebuggerEventSetResult, TRUE);
+    }
+
+    return FALSE;
+
+#else
+
+    //
+    // Check if the priority buffer is full or not
+    //
+    KdCheckUserModePriorityBuffers();
+
+    LogCallbackSendBuffer(OPERATION_DEBUGGEE_REGISTER_EVENT_SET,
+                          ((CHAR *)EventSetHeader + sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
+                          EventSetHeader->Length,
+                          TRUE);
+    return TRUE;
+
+#endif // EnableInstantEventMechanism
+}
+
 /**
  * @brief Query state of the RFLAG's traps
  *
@@ -2292,6 +2375,7 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
     UINT32                                              ReturnSize                   = 0;
     DEBUGGEE_RESULT_OF_SEARCH_PACKET                    SearchPacketResult           = {0};
     DEBUGGER_EVENT_AND_ACTION_RESULT                    DebuggerEventAndActionResult = {0};
+    DEBUGGER_EVENT_SET_RESULT                           DebuggerEventSetResult       = {0};
     PDEBUGGEE_PCITREE_REQUEST_RESPONSE_PACKET           PcitreePacket                = {0};
     PDEBUGGEE_PCIDEVINFO_REQUEST_RESPONSE_PACKET        PcidevinfoPacket             = {0};
 
@@ -2397,6 +2481,35 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                     break;
 
+                case DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN:
+                case DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN_FOR_TRACKING:
+
+                    //
+                    // Batched steps (the debuggee steps the instructions by itself
+                    // and sends back the records of the steps in chunks)
+                    //
+                    TracingStartBatchedStepping(DbgState,
+                                                SteppingPacket->BatchedStepCount,
+                                                SteppingPacket->BatchedWithRegisters,
+                                                SteppingPacket->BatchedWithInstructionBytes);
+
+                    //
+                    // Unlock just on core
+                    //
+                    KdContinueDebuggeeJustCurrentCore(DbgState);
+
+                    if (SteppingPacket->StepType == DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN_FOR_TRACKING)
+                    {
+                        DbgState->IgnoreDisasmInNextPacket = TRUE;
+                    }
+
+                    //
+                    // No need to wait for new commands
+                    //
+                    EscapeFromTheLoop = TRUE;
+
+                    break;
+
                 case DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_OVER:
                 case DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_OVER_FOR_GU:
                 case DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_OVER_FOR_GU_LAST_INSTRUCTION:
@@ -2887,6 +3000,34 @@ KdDispatchAndPerformCommandsFromDebugger(PROCESSOR_DEBUGGING_STATE * DbgState)
 
                 break;
 
+            case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_REGISTER_EVENT_SET:
+
+                EventRegPacket = (DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
+
+                //
+                // Parsing the set either in the VMX-root mode or pass it to the user-mode
+                //
+                if (KdPerformRegisterEventSet(EventRegPacket, &DebuggerEventSetResult))
+                {
+                    //
+                    // Continue Debuggee (Send the set buffer to user-mode debuggee)
+                    //
+                    KdContinueDebuggee(DbgState, TRUE, DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENT_SET);
+                    EscapeFromTheLoop = TRUE;
+                }
+                else
+                {
+                    //
+                    // Send the response of registering the set to the debugger
+                    //
+                    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENT_SET,
+                                               (CHAR *)&DebuggerEventSetResult,
+                                               sizeof(DEBUGGER_EVENT_SET_RESULT));
+                }
+
+                break;
+
             case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_QUERY_AND_MODIFY_EVENT:
 
                 QueryAndModifyEventPacket = (DEBUGGER_MODIFY_EVENTS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -3280,6 +3421,7 @@ KdManageSystemHaltOnVmxRoot(PROCESSOR_DEBUGGING_STATE *       DbgState,
     ULONG                     ExitInstructionLength = 0;
     RFLAGS                    Rflags                = {0};
     UINT64                    LastVmexitRip         = 0;
+    BOOLEAN                   LockAgainAfterTask    = FALSE;
 
     //
     // Perform Pre-halt tasks
@@ -3297,6 +3439,15 @@ StartAgain:
         //
         // *** Current Operating Core  ***
         //
+
+        //
+        // Send the remaining records of the batched steps before the pause packet
+        //
+        if (DbgState->BatchedSteppingMode)
+        {
+            TracingFinishBatchedStepping(DbgState);
+        }
+
         RtlZeroMemory(&PausePacket, sizeof(DEBUGGEE_KD_PAUSED_PACKET));
 
         //
@@ -3429,12 +3580,22 @@ StartAgain:
         );
 
         //
-        // Check if any task needs to be executed on this core or not
+        // Check if any task is broadcast to the halted cores or not
         //
-        if (DbgState->HaltedCoreTask.PerformHaltedTask)
+        if (HaltedCorePerformBroadcastTasks(DbgState, &LockAgainAfterTask))
+        {
+            //
+            // The core is already locked again (if needed)
+            //
+            if (LockAgainAfterTask)
+            {
+                goto StartAgain;
+            }
+        }
+        else if (DbgState->HaltedCoreTask.PerformHaltedTask)
         {
             //
-            // Indicate that the halted core is no longer needed to execute a task
+            // A task needs to be executed only on this core, indicate that the halted core is no longer needed to execute a task
             // as the current task is executed once
             //
             DbgState->HaltedCoreTask.PerformHaltedTask = FALSE;
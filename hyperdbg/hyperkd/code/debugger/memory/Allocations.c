@@ -37,6 +37,17 @@ GlobalDebuggingStateAllocateZeroedMemory(VOID)
         return FALSE;
     }
 
+    //
+    // The cores have not taken any broadcast round yet (their sequences are zero)
+    //
+    TaskBroadcastInitialize(&g_HaltedCoreBroadcast);
+
+    //
+    // No task is deferred (the batch is only used while applying event sets)
+    //
+    TaskBroadcastBatchInitialize(&g_HaltedCoreBatch);
+    g_HaltedCoreBatchActive = FALSE;
+
     return TRUE;
 }
 
@@ -76,7 +87,23 @@ GlobalEventsAllocateZeroedMemory(VOID)
         RtlZeroBytes(g_Events, sizeof(DEBUGGER_CORE_EVENTS));
     }
 
-    return g_Events != NULL;
+    //
+    // Allocate buffer for the index of the events of each type
+    //
+    if (!g_EventsIndex)
+    {
+        g_EventsIndex = PlatformMemAllocateNonPagedPool(sizeof(EVENT_INDEX) * DEBUGGER_EVENT_TYPES_COUNT);
+    }
+
+    if (g_EventsIndex)
+    {
+        //
+        // Zero the buffer
+        //
+        RtlZeroBytes(g_EventsIndex, sizeof(EVENT_INDEX) * DEBUGGER_EVENT_TYPES_COUNT);
+    }
+
+    return g_Events != NULL && g_EventsIndex != NULL;
 }
 
 /**
@@ -92,4 +119,10 @@ GlobalEventsFreeMemory(VOID)
         PlatformMemFreePool(g_Events);
         g_Events = NULL;
     }
+
+    if (g_EventsIndex != NULL)
+    {
+        PlatformMemFreePool(g_EventsIndex);
+        g_EventsIndex = NULL;
+    }
 }
@@ -40,6 +40,186 @@ PlmgrFreeRequestNewAllocation(VOID)
     g_RequestNewAllocation = NULL;
 }
 
+/**
+ * @brief Make sure that the table of the addresses has enough space for the new pools
+ * @details If the table is rebuilt, the previous table is freed once the cores
+ * that might still look it up are finished. Should be called with
+ * LockForReadingPool held (and not from vmx-root)
+ *
+ * @param NumberOfNewPools
+ * @return BOOLEAN FALSE if the table couldn't be allocated (the pools are
+ * found by walking the list of pools)
+ */
+BOOLEAN
+PlmgrEnsurePoolAddressTable(UINT32 NumberOfNewPools)
+{
+    HASH_TABLE * Table    = g_PoolAddressTable.Table;
+    HASH_TABLE * NewTable = NULL;
+    UINT64       Needed   = NumberOfNewPools;
+    UINT32       Capacity = MinimumPoolAddressTableCapacity;
+
+    if (Table != NULL && !Table->Overflowed &&
+        (UINT64)(Table->UsedSlots + NumberOfNewPools) * 100 <= (UINT64)Table->Capacity * HASH_TABLE_MAXIMUM_LOAD)
+    {
+        return TRUE;
+    }
+
+    //
+    // Rebuild the table with twice the needed slots
+    //
+    if (Table != NULL)
+    {
+        Needed += Table->Count;
+    }
+
+    while ((UINT64)Capacity < Needed * 2)
+    {
+        Capacity <<= 1;
+    }
+
+    NewTable = PlatformMemAllocateZeroedNonPagedPool(HASH_TABLE_SIZE(Capacity));
+
+    if (NewTable == NULL || !HashTableInitialize(NewTable, Capacity))
+    {
+        if (NewTable != NULL)
+        {
+            PlatformMemFreePool(NewTable);
+        }
+
+        return FALSE;
+    }
+
+    LIST_FOR_EACH_LINK(g_ListOfAllocatedPoolsHead, POOL_TABLE, PoolsList, PoolTable)
+    {
+        HashTableInsert(NewTable, PoolTable->Address, (UINT64)PoolTable);
+    }
+
+    //
+    // The other cores might still look up the previous table, so it's freed
+    // after they are finished
+    //
+    Table = HashTableReplaceReference(&g_PoolAddressTable, NewTable);
+
+    if (Table != NULL)
+    {
+        PlatformMemFreePool(Table);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get a pool table (a spare one or a new one)
+ *
+ * @return PPOOL_TABLE
+ */
+PPOOL_TABLE
+PlmgrGetPoolTable(VOID)
+{
+    PPOOL_TABLE PoolTable;
+
+    if (IsListEmpty(&g_ListOfSparePoolTablesHead))
+    {
+        return PlatformMemAllocateZeroedNonPagedPool(sizeof(POOL_TABLE));
+    }
+
+    PoolTable = CONTAINING_RECORD(RemoveHeadList(&g_ListOfSparePoolTablesHead), POOL_TABLE, PoolsList);
+
+    RtlZeroMemory(PoolTable, sizeof(POOL_TABLE));
+
+    return PoolTable;
+}
+
+/**
+ * @brief Free the pool of a pool table and keep the pool table as a spare one
+ * @details Should be called with LockForReadingPool held
+ *
+ * @param PoolTable
+ * @return VOID
+ */
+VOID
+PlmgrReleasePoolTable(PPOOL_TABLE PoolTable)
+{
+    //
+    // Set the flag to indicate that we freed
+    //
+    PoolTable->AlreadyFreed = TRUE;
+
+    if (g_PoolAddressTable.Table != NULL)
+    {
+        HashTableRemove(g_PoolAddressTable.Table, PoolTable->Address);
+    }
+
+    //
+    // This item should be freed
+    //
+    PlatformMemFreePool((PVOID)PoolTable->Address);
+
+    //
+    // Now we should remove the entry from the g_ListOfAllocatedPoolsHead
+    // and keep the structure, as another core might have read it from the
+    // free lists just before it's taken
+    //
+    RemoveEntryList(&PoolTable->PoolsList);
+    InsertHeadList(&g_ListOfSparePoolTablesHead, &PoolTable->PoolsList);
+}
+
+/**
+ * @brief Request to allocate new buffers
+ *
+ * @param Size Request new buffer to allocate
+ * @param Count Count of chunks
+ * @param Intention The intention of chunks (buffer tag)
+ * @param IsReplacement Whether the buffers replace the taken buffers or they are reserved
+ * @return BOOLEAN If the request is save it returns true otherwise it returns false
+ */
+BOOLEAN
+PlmgrRequestAllocation(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention, BOOLEAN IsReplacement)
+{
+    BOOLEAN FoundAPlace = FALSE;
+
+    //
+    // ******** We check to find a free place to store ********
+    //
+
+    SpinlockLock(&LockForRequestAllocation);
+
+    for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
+    {
+        REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
+
+        if (CurrentItem->Size == 0)
+        {
+            CurrentItem->Count     = Count;
+            CurrentItem->Intention = Intention;
+            CurrentItem->Size      = Size;
+
+            FoundAPlace = TRUE;
+
+            break;
+        }
+    }
+
+    if (!FoundAPlace)
+    {
+        SpinlockUnlock(&LockForRequestAllocation);
+        return FALSE;
+    }
+
+    //
+    // Keep track of the buffers that will be added to the free lists
+    //
+    PoolCacheReserve(g_PoolCache, Intention, Size, Count, IsReplacement);
+
+    //
+    // Signals to show that we have new allocations
+    //
+    g_IsNewRequestForAllocationReceived = TRUE;
+
+    SpinlockUnlock(&LockForRequestAllocation);
+    return TRUE;
+}
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
@@ -52,6 +232,8 @@ PlmgrFreeRequestNewAllocation(VOID)
 BOOLEAN
 PoolManagerInitialize()
 {
+    ULONG ProcessorsCount;
+
     //
     // Allocate global requesting variable
     //
@@ -62,10 +244,32 @@ PoolManagerInitialize()
         return FALSE;
     }
 
+    //
+    // Allocate the free lists of the pools (with a cache for each core)
+    //
+    ProcessorsCount = KeQueryActiveProcessorCount(0);
+
+    g_PoolCache = PlatformMemAllocateZeroedNonPagedPool(POOL_CACHE_SIZE(ProcessorsCount, POOL_ALLOCATION_INTENTION_COUNT));
+
+    if (!g_PoolCache || !PoolCacheInitialize(g_PoolCache, ProcessorsCount, POOL_ALLOCATION_INTENTION_COUNT))
+    {
+        if (g_PoolCache)
+        {
+            PlatformMemFreePool(g_PoolCache);
+            g_PoolCache = NULL;
+        }
+
+        PlmgrFreeRequestNewAllocation();
+
+        LogError("Err, insufficient memory");
+        return FALSE;
+    }
+
     //
     // Initialize list head
     //
     InitializeListHead(&g_ListOfAllocatedPoolsHead);
+    InitializeListHead(&g_ListOfSparePoolTablesHead);
 
     //
     // Nothing to deallocate or allocate at the beginning
@@ -134,6 +338,26 @@ PoolManagerUninitialize()
     }
 
     InitializeListHead(&g_ListOfAllocatedPoolsHead);
+
+    //
+    // Free the spare pool tables
+    //
+    while (!IsListEmpty(&g_ListOfSparePoolTablesHead))
+    {
+        PlatformMemFreePool(CONTAINING_RECORD(RemoveHeadList(&g_ListOfSparePoolTablesHead), POOL_TABLE, PoolsList));
+    }
+
+    //
+    // Free the free lists and the tables of the addresses
+    //
+    if (g_PoolAddressTable.Table != NULL)
+    {
+        PlatformMemFreePool(HashTableReplaceReference(&g_PoolAddressTable, NULL));
+    }
+
+    PlatformMemFreePool(g_PoolCache);
+    g_PoolCache = NULL;
+
     g_IsNewRequestForDeAllocation       = FALSE;
     g_IsNewRequestForAllocationReceived = FALSE;
 
@@ -153,10 +377,41 @@ PoolManagerUninitialize()
 BOOLEAN
 PoolManagerFreePool(UINT64 AddressToFree)
 {
-    PLIST_ENTRY ListTemp = 0;
-    BOOLEAN     Result   = FALSE;
-    ListTemp             = &g_ListOfAllocatedPoolsHead;
+    PLIST_ENTRY  ListTemp = 0;
+    BOOLEAN      Result   = FALSE;
+    HASH_TABLE * Table;
+    LONG         Epoch;
+    PPOOL_TABLE  PoolTable;
+    ListTemp              = &g_ListOfAllocatedPoolsHead;
+
+    //
+    // Find the pool in the table of the addresses (without holding the lock),
+    // the table is not freed until it's released
+    //
+    Table = HashTableAcquireReference(&g_PoolAddressTable, &Epoch);
+
+    if (HashTableIsReliable(Table))
+    {
+        PoolTable = (PPOOL_TABLE)HashTableFind(Table, AddressToFree);
+
+        HashTableReleaseReference(&g_PoolAddressTable, Epoch);
 
+        if (PoolTable == NULL)
+        {
+            return FALSE;
+        }
+
+        PoolTable->ShouldBeFreed      = TRUE;
+        g_IsNewRequestForDeAllocation = TRUE;
+
+        return TRUE;
+    }
+
+    HashTableReleaseReference(&g_PoolAddressTable, Epoch);
+
+    //
+    // The table is not available, so all of the pools are checked
+    //
     SpinlockLock(&LockForReadingPool);
 
     while (&g_ListOfAllocatedPoolsHead != ListTemp->Flink)
@@ -166,7 +421,7 @@ PoolManagerFreePool(UINT64 AddressToFree)
         //
         // Get the head of the record
         //
-        PPOOL_TABLE PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
+        PoolTable = (PPOOL_TABLE)CONTAINING_RECORD(ListTemp, POOL_TABLE, PoolsList);
 
         if (PoolTable->Address == AddressToFree)
         {
@@ -213,6 +468,36 @@ PoolManagerShowPreAllocatedPools()
                 PoolTable->ShouldBeFreed ? "true" : "false",
                 PoolTable->AlreadyFreed ? "true" : "false");
     }
+
+    //
+    // Show the statistics of the free lists
+    //
+    for (UINT32 Intention = 0; Intention < POOL_ALLOCATION_INTENTION_COUNT; Intention++)
+    {
+        for (UINT32 SizeClass = 0; SizeClass < POOL_CACHE_SIZE_CLASSES; SizeClass++)
+        {
+            PPOOL_CACHE_CLASS Class = PoolCacheGetClass(g_PoolCache, Intention, SizeClass);
+
+            if (Class->Target == 0 && Class->Statistics.Requests == 0 && Class->Statistics.Failures == 0)
+            {
+                continue;
+            }
+
+            LogInfo("Pool statistics, Pool intention: %x | Pool size: %llx | Free: %d | Pending: %d | Reserved: %d | "
+                    "Requests: %lld | Core cache hits: %lld | Taken from other cores: %lld | Failures: %lld | Recycled: %lld | Refills: %lld\n",
+                    Intention,
+                    Class->BlockSize,
+                    Class->Available,
+                    Class->Pending,
+                    Class->Target,
+                    Class->Statistics.Requests,
+                    Class->Statistics.CacheHits,
+                    Class->Statistics.Steals,
+                    Class->Statistics.Failures,
+                    Class->Statistics.Recycled,
+                    Class->Statistics.Refills);
+        }
+    }
 }
 
 /**
@@ -229,18 +514,34 @@ PoolManagerShowPreAllocatedPools()
 UINT64
 PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPool, UINT32 Size)
 {
-    UINT64 Address = 0;
+    UINT64            Address      = 0;
+    BOOLEAN           RefillNeeded = FALSE;
+    PPOOL_CACHE_ENTRY Entry;
+    PPOOL_TABLE       PoolTable;
 
-    ScopedSpinlock(
-        LockForReadingPool,
-        LIST_FOR_EACH_LINK(g_ListOfAllocatedPoolsHead, POOL_TABLE, PoolsList, PoolTable) {
-            if (PoolTable->Intention == Intention && PoolTable->IsBusy == FALSE)
-            {
-                PoolTable->IsBusy = TRUE;
-                Address           = PoolTable->Address;
-                break;
-            }
-        });
+    if (g_PoolCache == NULL)
+    {
+        return NULL64_ZERO;
+    }
+
+    //
+    // Take a free pool from the free lists of the intention (the cache of the
+    // current core is checked first), the size is only valid if a new pool is
+    // requested, otherwise the pool uses one of the reserved pools
+    //
+    Entry = PoolCacheTake(g_PoolCache,
+                          Intention,
+                          RequestNewPool ? Size : 0,
+                          KeGetCurrentProcessorNumberEx(NULL),
+                          RequestNewPool,
+                          &RefillNeeded);
+
+    if (Entry != NULL)
+    {
+        PoolTable         = CONTAINING_RECORD(Entry, POOL_TABLE, CacheEntry);
+        PoolTable->IsBusy = TRUE;
+        Address           = PoolTable->Address;
+    }
 
     //
     // Check if we need additional pools e.g another pool or the pool
@@ -248,7 +549,16 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
     //
     if (RequestNewPool)
     {
-        PoolManagerRequestAllocation(Size, 1, Intention);
+        PlmgrRequestAllocation(Size, 1, Intention, TRUE);
+    }
+
+    //
+    // The free pools of the intention are running out, they will be refilled
+    // on the next IOCTL (before all of them are used)
+    //
+    if (RefillNeeded)
+    {
+        g_IsNewRequestForAllocationReceived = TRUE;
     }
 
     //
@@ -264,17 +574,24 @@ PoolManagerRequestPool(POOL_ALLOCATION_INTENTION Intention, BOOLEAN RequestNewPo
  * @param Size Size of each chunk
  * @param Count Count of chunks
  * @param Intention The Intention of the buffer (buffer tag)
+ * @param IsPending Whether the chunks are previously requested (or they refill the free lists)
  * @return BOOLEAN If the allocation was successful it returns true and if it was
  * unsuccessful then it returns false
  */
 BOOLEAN
-PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention)
+PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention, BOOLEAN IsPending)
 {
+    //
+    // If the table of the addresses is not available, the pools are freed
+    // by walking the list of pools
+    //
+    PlmgrEnsurePoolAddressTable(Count);
+
     for (SIZE_T i = 0; i < Count; i++)
     {
         POOL_TABLE * SinglePool = NULL;
 
-        SinglePool = PlatformMemAllocateZeroedNonPagedPool(sizeof(POOL_TABLE));
+        SinglePool = PlmgrGetPoolTable();
 
         if (!SinglePool)
         {
@@ -289,7 +606,7 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
 
         if (!SinglePool->Address)
         {
-            PlatformMemFreePool(SinglePool);
+            InsertHeadList(&g_ListOfSparePoolTablesHead, &(SinglePool->PoolsList));
 
             LogError("Err, insufficient memory");
             return FALSE;
@@ -305,6 +622,16 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
         // Add it to the list
         //
         InsertHeadList(&g_ListOfAllocatedPoolsHead, &(SinglePool->PoolsList));
+
+        if (g_PoolAddressTable.Table != NULL)
+        {
+            HashTableInsert(g_PoolAddressTable.Table, SinglePool->Address, (UINT64)SinglePool);
+        }
+
+        //
+        // Now, the pool could be taken by other cores
+        //
+        PoolCacheInsert(g_PoolCache, &SinglePool->CacheEntry, Intention, Size, IsPending);
     }
 
     return TRUE;
@@ -319,7 +646,8 @@ PoolManagerAllocateAndAddToPoolTable(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_
 BOOLEAN
 PoolManagerCheckAndPerformAllocationAndDeallocation()
 {
-    BOOLEAN Result = TRUE;
+    BOOLEAN Result                 = TRUE;
+    BOOLEAN IsDeAllocationDeferred = FALSE;
 
     //
     // Make sure we're on vmx non-root and also we have new allocation
@@ -342,32 +670,8 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
     SpinlockLock(&LockForReadingPool);
 
     //
-    // Check for new allocation
-    //
-    if (g_IsNewRequestForAllocationReceived)
-    {
-        for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
-        {
-            REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
-
-            if (CurrentItem->Size != 0)
-            {
-                Result = PoolManagerAllocateAndAddToPoolTable(CurrentItem->Size,
-                                                              CurrentItem->Count,
-                                                              CurrentItem->Intention);
-
-                //
-                // Free the data for future use
-                //
-                CurrentItem->Count     = 0;
-                CurrentItem->Intention = 0;
-                CurrentItem->Size      = 0;
-            }
-        }
-    }
-
-    //
-    // Check for deallocation
+    // Check for deallocation (before the new allocations, so the freed pools
+    // could be used instead of the requested pools of the same intention)
     //
     if (g_IsNewRequestForDeAllocation)
     {
@@ -386,37 +690,105 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
             // Check whether this pool should be freed or not and
             // also check whether it's already freed or not
             //
-            if (PoolTable->ShouldBeFreed && !PoolTable->AlreadyFreed)
+            if (PoolTable->ShouldBeFreed && !PoolTable->AlreadyFreed && !PoolTable->IsBusy &&
+                !PoolCacheRemove(g_PoolCache, &PoolTable->CacheEntry))
             {
                 //
-                // Set the flag to indicate that we freed
+                // The pool is not used but it's not in the free lists either,
+                // so it's just taken by another core, it's freed on the next
+                // IOCTL (once it's marked as used)
                 //
-                PoolTable->AlreadyFreed = TRUE;
-
+                IsDeAllocationDeferred = TRUE;
+            }
+            else if (PoolTable->ShouldBeFreed && !PoolTable->AlreadyFreed)
+            {
                 //
-                // This item should be freed
+                // The free pools are removed from the free lists above (and their
+                // reservations are released)
                 //
-                PlatformMemFreePool((PVOID)PoolTable->Address);
+                if (PoolCacheClaimPending(g_PoolCache, &PoolTable->CacheEntry))
+                {
+                    //
+                    // The pool is cleared and used as one of the requested pools
+                    //
+                    RtlZeroMemory((PVOID)PoolTable->Address, PoolTable->Size);
+
+                    PoolTable->IsBusy        = FALSE;
+                    PoolTable->ShouldBeFreed = FALSE;
+
+                    PoolCacheInsert(g_PoolCache, &PoolTable->CacheEntry, PoolTable->Intention, PoolTable->Size, TRUE);
+                }
+                else
+                {
+                    //
+                    // This item should be freed
+                    //
+                    PlmgrReleasePoolTable(PoolTable);
+                }
+            }
+
+            Link = Next;
+        }
+    }
+
+    //
+    // Check for new allocation
+    //
+    if (g_IsNewRequestForAllocationReceived)
+    {
+        for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
+        {
+            REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
 
+            if (CurrentItem->Size != 0)
+            {
                 //
-                // Now we should remove the entry from the g_ListOfAllocatedPoolsHead
+                // Some of the requested pools might be replaced by the freed pools
                 //
-                RemoveEntryList(Link);
+                UINT32 Recycled = PoolCacheConsumeCancelled(g_PoolCache,
+                                                            CurrentItem->Intention,
+                                                            CurrentItem->Size,
+                                                            CurrentItem->Count);
+
+                if (CurrentItem->Count > Recycled)
+                {
+                    Result = PoolManagerAllocateAndAddToPoolTable(CurrentItem->Size,
+                                                                  CurrentItem->Count - Recycled,
+                                                                  CurrentItem->Intention,
+                                                                  TRUE);
+                }
 
                 //
-                // Free the structure pool
+                // Free the data for future use
                 //
-                PlatformMemFreePool(PoolTable);
+                CurrentItem->Count     = 0;
+                CurrentItem->Intention = 0;
+                CurrentItem->Size      = 0;
             }
+        }
 
-            Link = Next;
+        //
+        // Refill the free lists that reached their low watermark
+        //
+        for (UINT32 Intention = 0; Intention < POOL_ALLOCATION_INTENTION_COUNT; Intention++)
+        {
+            for (UINT32 SizeClass = 0; SizeClass < POOL_CACHE_SIZE_CLASSES; SizeClass++)
+            {
+                SIZE_T BlockSize   = 0;
+                UINT32 RefillCount = PoolCacheGetRefillCount(g_PoolCache, Intention, SizeClass, &BlockSize);
+
+                if (RefillCount != 0)
+                {
+                    Result = PoolManagerAllocateAndAddToPoolTable(BlockSize, RefillCount, Intention, FALSE);
+                }
+            }
         }
     }
 
     //
     // All allocation and deallocation are performed
     //
-    g_IsNewRequestForDeAllocation       = FALSE;
+    g_IsNewRequestForDeAllocation       = IsDeAllocationDeferred;
     g_IsNewRequestForAllocationReceived = FALSE;
 
     SpinlockUnlock(&LockForReadingPool);
@@ -435,41 +807,11 @@ PoolManagerCheckAndPerformAllocationAndDeallocation()
 BOOLEAN
 PoolManagerRequestAllocation(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention)
 {
-    BOOLEAN FoundAPlace = FALSE;
-
-    //
-    // ******** We check to find a free place to store ********
-    //
-
-    SpinlockLock(&LockForRequestAllocation);
-
-    for (SIZE_T i = 0; i < MaximumRequestsQueueDepth; i++)
-    {
-        REQUEST_NEW_ALLOCATION * CurrentItem = &g_RequestNewAllocation[i];
-
-        if (CurrentItem->Size == 0)
-        {
-            CurrentItem->Count     = Count;
-            CurrentItem->Intention = Intention;
-            CurrentItem->Size      = Size;
-
-            FoundAPlace = TRUE;
-
-            break;
-        }
-    }
-
-    if (!FoundAPlace)
-    {
-        SpinlockUnlock(&LockForRequestAllocation);
-        return FALSE;
-    }
-
     //
-    // Signals to show that we have new allocations
+    // The buffers are reserved, so the free lists of the intention are
+    // refilled up to the remaining reservations once they reach their low
+    // watermark (a reservation is released once its pool is taken without
+    // requesting a replacement, or the pool is freed before it's used)
     //
-    g_IsNewRequestForAllocationReceived = TRUE;
-
-    SpinlockUnlock(&LockForRequestAllocation);
-    return TRUE;
+    return PlmgrRequestAllocation(Size, Count, Intention, FALSE);
 }
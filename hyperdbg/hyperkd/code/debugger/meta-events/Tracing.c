@@ -167,3 +167,188 @@ TracingPerformRegularStepInInstruction()
         VmFuncSetInterruptibilityState(Interruptibility);
     }
 }
+
+/**
+ * @brief Read the registers that are tracked in the records of the batched steps
+ * @param DbgState The state of the debugger on the current core
+ * @param Registers
+ *
+ * @return VOID
+ */
+static VOID
+TracingReadBatchedSteppingRegisters(PROCESSOR_DEBUGGING_STATE * DbgState, UINT64 * Registers)
+{
+    RtlCopyMemory(Registers, VmFuncGetGuestRegs(DbgState->CoreId), sizeof(GUEST_REGS));
+
+    Registers[STEP_RECORD_REGISTER_RFLAGS] = VmFuncGetRflags();
+}
+
+/**
+ * @brief Read and classify the instruction that is executed on the next MTF
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+static VOID
+TracingReadBatchedSteppingInstruction(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    UINT32 ReadLength;
+
+    g_BatchedStepping.PendingRip     = VmFuncGetLastVmexitRip(DbgState->CoreId);
+    g_BatchedStepping.PendingIs32Bit = KdIsGuestOnUsermode32Bit();
+
+    RtlZeroMemory(g_BatchedStepping.PendingInstructionBytes, MAXIMUM_INSTR_SIZE);
+
+    //
+    // Read the instruction (only the bytes that are safe to be read)
+    //
+    ReadLength = CheckAddressMaximumInstructionLength((PVOID)g_BatchedStepping.PendingRip);
+
+    MemoryMapperReadMemorySafeOnTargetProcess(g_BatchedStepping.PendingRip,
+                                              g_BatchedStepping.PendingInstructionBytes,
+                                              ReadLength);
+
+    g_BatchedStepping.PendingLength = DisassemblerLengthDisassembleEngine(g_BatchedStepping.PendingInstructionBytes,
+                                                                          g_BatchedStepping.PendingIs32Bit);
+
+    if (g_BatchedStepping.PendingLength > ReadLength)
+    {
+        g_BatchedStepping.PendingLength = 0;
+    }
+
+    g_BatchedStepping.PendingKind = StepRecordClassify(g_BatchedStepping.PendingInstructionBytes,
+                                                       g_BatchedStepping.PendingLength,
+                                                       g_BatchedStepping.PendingIs32Bit);
+}
+
+/**
+ * @brief Send the current chunk of the records of the batched steps
+ * @param NextRip Rip after the last record of the chunk
+ * @param IsLastChunk
+ *
+ * @return VOID
+ */
+static VOID
+TracingSendBatchedSteppingChunk(UINT64 NextRip, BOOLEAN IsLastChunk)
+{
+    UINT32 ChunkSize;
+
+    ChunkSize = StepRecordEncoderFinish(&g_BatchedStepping.Encoder, NextRip, IsLastChunk);
+
+    KdResponsePacketToDebugger(DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGEE_TO_DEBUGGER,
+                               DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BATCHED_STEPPING,
+                               (CHAR *)g_BatchedStepping.Buffer,
+                               ChunkSize);
+}
+
+/**
+ * @brief Start stepping a batch of instructions (instrumentation step-in) on the
+ * debuggee without a round trip to the debugger for each step
+ * @param DbgState The state of the debugger on the current core
+ * @param StepCount
+ * @param WithRegisters Whether the deltas of all registers are recorded (otherwise only RFLAGS)
+ * @param WithInstructionBytes Whether the bytes of the instructions are recorded
+ *
+ * @return VOID
+ */
+VOID
+TracingStartBatchedStepping(PROCESSOR_DEBUGGING_STATE * DbgState,
+                            UINT32                      StepCount,
+                            BOOLEAN                     WithRegisters,
+                            BOOLEAN                     WithInstructionBytes)
+{
+    UINT64 Registers[STEP_RECORD_NUMBER_OF_REGISTERS];
+    UINT32 Flags = 0;
+
+    if (StepCount == 0 || StepCount > DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT)
+    {
+        StepCount = DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT;
+    }
+
+    if (WithRegisters)
+    {
+        Flags |= STEP_RECORD_CHUNK_FLAG_REGISTERS;
+    }
+
+    if (WithInstructionBytes)
+    {
+        Flags |= STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES;
+    }
+
+    g_BatchedStepping.RemainingSteps = StepCount;
+
+    TracingReadBatchedSteppingInstruction(DbgState);
+    TracingReadBatchedSteppingRegisters(DbgState, Registers);
+
+    StepRecordEncoderInitialize(&g_BatchedStepping.Encoder,
+                                g_BatchedStepping.Buffer,
+                                sizeof(g_BatchedStepping.Buffer),
+                                Flags,
+                                g_BatchedStepping.PendingIs32Bit,
+                                Registers);
+
+    DbgState->BatchedSteppingMode = TRUE;
+
+    //
+    // Step the first instruction
+    //
+    KdGuaranteedStepInstruction(DbgState);
+}
+
+/**
+ * @brief Record the instruction that is executed by a batched step
+ * @details This function will be called from vmx-root mode on the MTF
+ *
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return BOOLEAN TRUE if the batch is not finished
+ */
+BOOLEAN
+TracingHandleBatchedStep(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    UINT64           Registers[STEP_RECORD_NUMBER_OF_REGISTERS];
+    BYTE             ExecutedBytes[MAXIMUM_INSTR_SIZE];
+    UINT64           ExecutedRip     = g_BatchedStepping.PendingRip;
+    UINT32           ExecutedLength  = g_BatchedStepping.PendingLength;
+    STEP_RECORD_KIND ExecutedKind    = g_BatchedStepping.PendingKind;
+    BOOLEAN          ExecutedIs32Bit = g_BatchedStepping.PendingIs32Bit;
+
+    RtlCopyMemory(ExecutedBytes, g_BatchedStepping.PendingInstructionBytes, MAXIMUM_INSTR_SIZE);
+
+    //
+    // The current instruction is executed on the next MTF
+    //
+    TracingReadBatchedSteppingInstruction(DbgState);
+    TracingReadBatchedSteppingRegisters(DbgState, Registers);
+
+    if (!StepRecordEncode(&g_BatchedStepping.Encoder, ExecutedRip, ExecutedBytes, ExecutedLength, ExecutedKind, ExecutedIs32Bit, Registers))
+    {
+        //
+        // The chunk is full, send it (the executed instruction is after its last
+        // record) and continue on the next chunk
+        //
+        TracingSendBatchedSteppingChunk(ExecutedRip, FALSE);
+        StepRecordEncoderNextChunk(&g_BatchedStepping.Encoder);
+
+        StepRecordEncode(&g_BatchedStepping.Encoder, ExecutedRip, ExecutedBytes, ExecutedLength, ExecutedKind, ExecutedIs32Bit, Registers);
+    }
+
+    g_BatchedStepping.RemainingSteps--;
+
+    return g_BatchedStepping.RemainingSteps != 0;
+}
+
+/**
+ * @brief Send the remaining records of the batched steps (before the debuggee
+ * is halted, either the batch is finished or a breakpoint or an event halted it)
+ * @param DbgState The state of the debugger on the current core
+ *
+ * @return VOID
+ */
+VOID
+TracingFinishBatchedStepping(PROCESSOR_DEBUGGING_STATE * DbgState)
+{
+    DbgState->BatchedSteppingMode = FALSE;
+
+    TracingSendBatchedSteppingChunk(g_BatchedStepping.PendingRip, TRUE);
+}
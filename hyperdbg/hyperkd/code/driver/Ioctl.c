@@ -429,7 +429,11 @@ DrvDispatchVmmIoControl(PIRP Irp, PIO_STACK_LOCATION IrpStack, BOOLEAN * DoNotCh
     PDEBUGGER_PREPARE_DEBUGGEE                              DebuggeeRequest;
     PDEBUGGER_PAUSE_PACKET_RECEIVED                         DebuggerPauseKernelRequest;
     PDEBUGGER_GENERAL_ACTION                                DebuggerNewActionRequest;
+    PDEBUGGER_EVENT_SET                                     DebuggerNewEventSetRequest;
+    DEBUGGER_EVENT_SET_RESULT                               DebuggerEventSetResult;
     PSMI_OPERATION_PACKETS                                  SmiOperationRequest;
+    PDIRTY_LOGGING_OPERATION_PACKETS                        DirtyLoggingOperationRequest;
+    PEXIT_PROFILER_OPERATION_PACKETS                        ExitProfilerOperationRequest;
     PVOID                                                   BufferToStoreThreadsAndProcessesDetails;
     ULONG                                                   InBuffLength;  // Input buffer length
     ULONG                                                   OutBuffLength; // Output buffer length
@@ -611,6 +615,41 @@ DrvDispatchVmmIoControl(PIRP Irp, PIO_STACK_LOCATION IrpStack, BOOLEAN * DoNotCh
 
         break;
 
+    case IOCTL_DEBUGGER_REGISTER_EVENT_SET:
+
+        //
+        // Validate and adjust the parameters, and set the target buffer to the system buffer of the IRP
+        //
+        if (!DrvValidateAndAdjustIoctlParameter(sizeof(DEBUGGER_EVENT_SET),
+                                                (PVOID *)&DebuggerNewEventSetRequest,
+                                                Irp,
+                                                IrpStack,
+                                                &InBuffLength,
+                                                &OutBuffLength) ||
+            OutBuffLength < sizeof(DEBUGGER_EVENT_SET_RESULT))
+        {
+            Status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // The result is written after parsing the whole set as the set and
+        // the result are at the same place
+        //
+        DebuggerParseEventSet(DebuggerNewEventSetRequest,
+                              InBuffLength,
+                              &DebuggerEventSetResult,
+                              FALSE);
+
+        memcpy(Irp->AssociatedIrp.SystemBuffer, &DebuggerEventSetResult, sizeof(DEBUGGER_EVENT_SET_RESULT));
+
+        //
+        // Adjust the status and output size
+        //
+        DrvAdjustStatusAndSetOutputSize(sizeof(DEBUGGER_EVENT_SET_RESULT), DoNotChangeInformation, Irp, &Status);
+
+        break;
+
     case IOCTL_DEBUGGER_HIDE_AND_UNHIDE_TO_TRANSPARENT_THE_DEBUGGER:
 
         //
@@ -1217,6 +1256,62 @@ DrvDispatchVmmIoControl(PIRP Irp, PIO_STACK_LOCATION IrpStack, BOOLEAN * DoNotCh
 
         break;
 
+    case IOCTL_PERFORM_DIRTY_LOGGING_OPERATION:
+
+        //
+        // Validate and adjust the parameters, and set the target buffer to the system buffer of the IRP
+        //
+        if (!DrvValidateAndAdjustIoctlParameter(SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS,
+                                                (PVOID *)&DirtyLoggingOperationRequest,
+                                                Irp,
+                                                IrpStack,
+                                                &InBuffLength,
+                                                &OutBuffLength))
+        {
+            Status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Perform the dirty logging operation
+        //
+        VmFuncDirtyLoggingPerformOperation(DirtyLoggingOperationRequest);
+
+        //
+        // Adjust the status and output size
+        //
+        DrvAdjustStatusAndSetOutputSize(SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS, DoNotChangeInformation, Irp, &Status);
+
+        break;
+
+    case IOCTL_PERFORM_EXIT_PROFILER_OPERATION:
+
+        //
+        // Validate and adjust the parameters, and set the target buffer to the system buffer of the IRP
+        //
+        if (!DrvValidateAndAdjustIoctlParameter(SIZEOF_EXIT_PROFILER_OPERATION_PACKETS,
+                                                (PVOID *)&ExitProfilerOperationRequest,
+                                                Irp,
+                                                IrpStack,
+                                                &InBuffLength,
+                                                &OutBuffLength))
+        {
+            Status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Perform the vm-exit profiler operation
+        //
+        VmFuncExitProfilingPerformOperation(ExitProfilerOperationRequest);
+
+        //
+        // Adjust the status and output size
+        //
+        DrvAdjustStatusAndSetOutputSize(SIZEOF_EXIT_PROFILER_OPERATION_PACKETS, DoNotChangeInformation, Irp, &Status);
+
+        break;
+
     case IOCTL_SEND_USER_DEBUGGER_COMMANDS:
 
         //
@@ -1567,6 +1662,7 @@ DrvDispatchHyperTraceIoControl(PIRP Irp, PIO_STACK_LOCATION IrpStack, BOOLEAN *
 {
     PHYPERTRACE_LBR_OPERATION_PACKETS HyperTraceLbrOperationRequest;
     PHYPERTRACE_LBR_DUMP_PACKETS      HyperTraceLbrdumpRequest;
+    PHYPERTRACE_LBR_SAMPLE_PACKETS    HyperTraceLbrSampleRequest;
     PHYPERTRACE_PT_OPERATION_PACKETS  HyperTracePtOperationRequest;
     PHYPERTRACE_PT_MMAP_PACKETS       HyperTracePtMmapRequest;
     ULONG                             InBuffLength;
@@ -1646,6 +1742,34 @@ DrvDispatchHyperTraceIoControl(PIRP Irp, PIO_STACK_LOCATION IrpStack, BOOLEAN *
 
         break;
 
+    case IOCTL_PERFORM_HYPERTRACE_LBR_SAMPLE:
+
+        //
+        // Validate and adjust the parameters, and set the target buffer to the system buffer of the IRP
+        //
+        if (!DrvValidateAndAdjustIoctlParameter(SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS,
+                                                (PVOID *)&HyperTraceLbrSampleRequest,
+                                                Irp,
+                                                IrpStack,
+                                                &InBuffLength,
+                                                &OutBuffLength))
+        {
+            Status = STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Perform the HyperTrace LBR sampling operation
+        //
+        HyperTraceLbrPerformSampleOperation(HyperTraceLbrSampleRequest);
+
+        //
+        // Adjust the status and output size
+        //
+        DrvAdjustStatusAndSetOutputSize(SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS, DoNotChangeInformation, Irp, &Status);
+
+        break;
+
     case IOCTL_PERFORM_HYPERTRACE_PT_OPERATION:
 
         //
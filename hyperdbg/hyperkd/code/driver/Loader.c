@@ -126,6 +126,7 @@ LoaderInitHyperLog()
     MsgTracingCallbacks.VmxOperationCheck            = VmFuncVmxGetCurrentExecutionMode;
     MsgTracingCallbacks.CheckImmediateMessageSending = KdCheckImmediateMessagingMechanism;
     MsgTracingCallbacks.SendImmediateMessage         = KdLoggingResponsePacketToDebugger;
+    MsgTracingCallbacks.PerCoreRingSize              = LogPerCoreRingSize;
 
     //
     // Initialize message tracer (if not already initialized)
@@ -57,6 +57,13 @@ HaltedBroadcastInvalidateSingleContextAllCores();
 VOID
 HaltedBroadcastUnhookSinglePageAllCores(EPT_SINGLE_HOOK_UNHOOKING_DETAILS * UnhookingDetail);
 
+VOID
+HaltedBroadcastSetExceptionBitmapAndInvalidateSingleContextAllCores(UINT64 ExceptionIndex);
+
+VOID
+HaltedBroadcastUnhookSinglePageAndUnSetExceptionBitmapAllCores(EPT_SINGLE_HOOK_UNHOOKING_DETAILS * UnhookingDetail,
+                                                                UINT64                              ExceptionIndex);
+
 VOID
 HaltedBroadcastSetDisableExternalInterruptExitingOnlyOnClearingInterruptEventsAllCores();
 
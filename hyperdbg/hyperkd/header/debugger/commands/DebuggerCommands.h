@@ -13,6 +13,23 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				     Structures		      		//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Results of searching the memory (the 's' commands)
+ *
+ */
+typedef struct _DEBUGGER_SEARCH_MEMORY_RESULTS
+{
+    UINT64 *                    AddressToSaveResults; // NULL if the debuggee is paused
+    DEBUGGER_SEARCH_MEMORY_TYPE MemoryType;
+    BOOLEAN                     IsDebuggeePaused;
+    UINT32                      CountOfOccurance;
+
+} DEBUGGER_SEARCH_MEMORY_RESULTS, *PDEBUGGER_SEARCH_MEMORY_RESULTS;
+
 //////////////////////////////////////////////////
 //				     Functions		      		//
 //////////////////////////////////////////////////
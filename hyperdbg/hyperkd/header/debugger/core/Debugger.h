@@ -25,6 +25,11 @@
  */
 #define DEBUGGER_DEBUG_REGISTER_FOR_THREAD_MANAGEMENT 1
 
+/**
+ * @brief Count of the types of the events (VMM_EVENT_TYPE_ENUM)
+ */
+#define DEBUGGER_EVENT_TYPES_COUNT (XSETBV_INSTRUCTION_EXECUTION + 1)
+
 //////////////////////////////////////////////////
 //					Structures					//
 //////////////////////////////////////////////////
@@ -135,6 +140,9 @@ typedef struct _DEBUGGER_EVENT
     PVOID  ConditionBufferAddress; // Address of the condition buffer (most of the
                                    // time at the end of this buffer)
 
+    EVENT_INDEX_ENTRY IndexEntry; // Entry of the event in the index of its type
+                                  // (only the enabled events are indexed)
+
 } DEBUGGER_EVENT, *PDEBUGGER_EVENT;
 
 /* ==============================================================================================
@@ -230,6 +238,15 @@ DebuggerAddActionToEvent(PDEBUGGER_EVENT                                 Event,
 BOOLEAN
 DebuggerRegisterEvent(PDEBUGGER_EVENT Event);
 
+VOID
+DebuggerIndexEvent(PDEBUGGER_EVENT Event);
+
+VOID
+DebuggerUnindexEvent(PDEBUGGER_EVENT Event);
+
+VOID
+DebuggerUnindexAllEvents();
+
 VMM_CALLBACK_TRIGGERING_EVENT_STATUS_TYPE
 DebuggerTriggerEvents(VMM_EVENT_TYPE_ENUM                   EventType,
                       VMM_CALLBACK_EVENT_CALLING_STAGE_TYPE CallingStage,
@@ -261,6 +278,12 @@ DebuggerParseAction(PDEBUGGER_GENERAL_ACTION          Action,
                     PDEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn,
                     BOOLEAN                           InputFromVmxRoot);
 
+BOOLEAN
+DebuggerParseEventSet(PDEBUGGER_EVENT_SET        EventSet,
+                      UINT32                     BufferLength,
+                      PDEBUGGER_EVENT_SET_RESULT ResultsToReturn,
+                      BOOLEAN                    InputFromVmxRoot);
+
 BOOLEAN
 DebuggerParseEventsModification(PDEBUGGER_MODIFY_EVENTS DebuggerEventModificationRequest,
                                 BOOLEAN                 InputFromVmxRoot,
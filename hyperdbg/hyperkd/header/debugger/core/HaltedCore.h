@@ -197,6 +197,24 @@ HaltedCoreBroadcastTaskAllCores(PROCESSOR_DEBUGGING_STATE * DbgState,
                                 BOOLEAN                     Synchronize,
                                 PVOID                       Context);
 
+BOOLEAN
+HaltedCoreBroadcastRoundAllCores(PROCESSOR_DEBUGGING_STATE * DbgState,
+                                 PTASK_BROADCAST_ROUND       Round,
+                                 BOOLEAN                     Synchronize);
+
+VOID
+HaltedCoreBeginBatch();
+
+VOID
+HaltedCoreFlushBatch(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+HaltedCoreEndBatch(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+BOOLEAN
+HaltedCorePerformBroadcastTasks(PROCESSOR_DEBUGGING_STATE * DbgState,
+                                BOOLEAN *                   LockAgainAfterTask);
+
 VOID
 HaltedCoreRunTaskOnSingleCore(UINT32  TargetCoreId,
                               UINT64  TargetTask,
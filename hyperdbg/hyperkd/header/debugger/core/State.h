@@ -139,6 +139,7 @@ typedef struct _DEBUGGEE_HALTED_CORE_TASK
     UINT64  TargetTask;
     PVOID   Context;
     UINT64  KernelStatus;
+    UINT64  BroadcastSequence; // sequence of the last broadcast round that is taken by the core
 
 } DEBUGGEE_HALTED_CORE_TASK, *PDEBUGGEE_HALTED_CORE_TASK;
 
@@ -170,7 +171,8 @@ typedef struct _PROCESSOR_DEBUGGING_STATE
     BOOLEAN                                    BreakStarterCore;
     BOOLEAN                                    Test; // Used for testing purposes
     BOOLEAN                                    DoNotNmiNotifyOtherCoresByThisCore;
-    BOOLEAN                                    TracingMode; // Indicate that the target processor is on the tracing mode or not
+    BOOLEAN                                    TracingMode;         // Indicate that the target processor is on the tracing mode or not
+    BOOLEAN                                    BatchedSteppingMode; // Indicate that the target processor is stepping a batch of instructions or not
     PROCESSOR_DEBUGGING_MSR_READ_OR_WRITE      MsrState;
     DATE_TIME_HOLDER                           DateTimeHolder;
     PDEBUGGEE_BP_DESCRIPTOR                    SoftwareBreakpointState;
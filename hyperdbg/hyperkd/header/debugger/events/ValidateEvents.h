@@ -40,3 +40,9 @@ BOOLEAN
 ValidateEventEptHookHiddenBreakpointAndInlineHooks(PDEBUGGER_GENERAL_EVENT_DETAIL    EventDetails,
                                                    PDEBUGGER_EVENT_AND_ACTION_RESULT ResultsToReturn,
                                                    BOOLEAN                           InputFromVmxRoot);
+
+BOOLEAN
+ValidateEventSet(PDEBUGGER_EVENT_SET        EventSet,
+                 UINT32                     BufferLength,
+                 PDEBUGGER_EVENT_SET_RESULT ResultsToReturn,
+                 BOOLEAN                    InputFromVmxRoot);
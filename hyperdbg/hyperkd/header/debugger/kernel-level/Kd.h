@@ -136,6 +136,10 @@ static BOOLEAN
 KdPerformAddActionToEvent(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET ActionDetailHeader,
                           DEBUGGER_EVENT_AND_ACTION_RESULT *                  DebuggerEventAndActionResult);
 
+static BOOLEAN
+KdPerformRegisterEventSet(PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET EventSetHeader,
+                          DEBUGGER_EVENT_SET_RESULT *                         DebuggerEventSetResult);
+
 static VOID
 KdQuerySystemState();
 
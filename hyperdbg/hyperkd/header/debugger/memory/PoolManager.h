@@ -22,6 +22,12 @@
 #define MaximumRequestsQueueDepth   300
 #define NumberOfPreAllocatedBuffers 10
 
+/**
+ * @brief Minimum number of the slots of the table of the addresses of the pools
+ *
+ */
+#define MinimumPoolAddressTableCapacity 1024
+
 //////////////////////////////////////////////////
 //                   Structures		   			//
 //////////////////////////////////////////////////
@@ -39,6 +45,7 @@ typedef struct _POOL_TABLE
     BOOLEAN                   IsBusy;
     BOOLEAN                   ShouldBeFreed;
     BOOLEAN                   AlreadyFreed;
+    POOL_CACHE_ENTRY          CacheEntry; // Entry of the free lists (when the pool is not busy)
 
 } POOL_TABLE, *PPOOL_TABLE;
 
@@ -100,6 +107,26 @@ BOOLEAN g_IsNewRequestForDeAllocation;
  */
 LIST_ENTRY g_ListOfAllocatedPoolsHead;
 
+/**
+ * @brief Free lists of the pools (for each intention and size)
+ *
+ */
+POOL_CACHE * g_PoolCache;
+
+/**
+ * @brief Table of the pools (keyed by the address of the pool), the previous
+ * table is freed once its readers are finished
+ *
+ */
+HASH_TABLE_REFERENCE g_PoolAddressTable;
+
+/**
+ * @brief List of the pool tables that are not used anymore (the pool tables
+ * are never freed as they might be still read from the free lists)
+ *
+ */
+LIST_ENTRY g_ListOfSparePoolTablesHead;
+
 //////////////////////////////////////////////////
 //                   Functions		  			//
 //////////////////////////////////////////////////
@@ -116,6 +143,18 @@ PlmgrAllocateRequestNewAllocation(SIZE_T NumberOfBytes);
 
 static VOID PlmgrFreeRequestNewAllocation(VOID);
 
+static BOOLEAN
+PlmgrEnsurePoolAddressTable(UINT32 NumberOfNewPools);
+
+static PPOOL_TABLE
+PlmgrGetPoolTable(VOID);
+
+static VOID
+PlmgrReleasePoolTable(PPOOL_TABLE PoolTable);
+
+static BOOLEAN
+PlmgrRequestAllocation(SIZE_T Size, UINT32 Count, POOL_ALLOCATION_INTENTION Intention, BOOLEAN IsReplacement);
+
 // ----------------------------------------------------------------------------
 // Public Interfaces
 //
@@ -11,6 +11,28 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//				   Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The state of the batched steps
+ * @details Only one core steps a batch at a time (the other cores are halted)
+ *
+ */
+typedef struct _TRACING_BATCHED_STEPPING_STATE
+{
+    UINT32              RemainingSteps;
+    UINT64              PendingRip; // the instruction that is executed on the next MTF
+    UINT32              PendingLength;
+    STEP_RECORD_KIND    PendingKind;
+    BOOLEAN             PendingIs32Bit;
+    UINT8               PendingInstructionBytes[MAXIMUM_INSTR_SIZE];
+    STEP_RECORD_ENCODER Encoder;
+    UINT8               Buffer[DEBUGGER_REMOTE_BATCHED_STEPPING_CHUNK_SIZE];
+
+} TRACING_BATCHED_STEPPING_STATE, *PTRACING_BATCHED_STEPPING_STATE;
+
 //////////////////////////////////////////////////
 //				   Functions					//
 //////////////////////////////////////////////////
@@ -32,3 +54,15 @@ TracingRegularStepInInstruction();
 
 VOID
 TracingPerformRegularStepInInstruction();
+
+VOID
+TracingStartBatchedStepping(PROCESSOR_DEBUGGING_STATE * DbgState,
+                            UINT32                      StepCount,
+                            BOOLEAN                     WithRegisters,
+                            BOOLEAN                     WithInstructionBytes);
+
+BOOLEAN
+TracingHandleBatchedStep(PROCESSOR_DEBUGGING_STATE * DbgState);
+
+VOID
+TracingFinishBatchedStepping(PROCESSOR_DEBUGGING_STATE * DbgState);
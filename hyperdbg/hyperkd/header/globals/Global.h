@@ -70,6 +70,19 @@ UINT32 g_UserDebuggerWaitingCommandOutputBufferLength;
  */
 UINT64 * g_ScriptGlobalVariables;
 
+/**
+ * @brief Buffer of the pages that are searched while the debuggee is paused
+ * (the 's' commands)
+ *
+ */
+UINT8 g_SearchMemoryPageBuffer[PAGE_SIZE];
+
+/**
+ * @brief State (and the buffer of the records) of the batched steps
+ *
+ */
+TRACING_BATCHED_STEPPING_STATE g_BatchedStepping;
+
 /**
  * @brief State of the trap-flag
  *
@@ -89,6 +102,41 @@ BOOLEAN g_HandleInUse;
  */
 DEBUGGER_CORE_EVENTS * g_Events;
 
+/**
+ * @brief index of the enabled events of each type (for dispatching
+ * the triggered events)
+ *
+ */
+EVENT_INDEX * g_EventsIndex;
+
+/**
+ * @brief order of the last registered event (the newer events are
+ * triggered first)
+ *
+ */
+UINT64 g_EventsIndexOrder;
+
+/**
+ * @brief The shared descriptor of the tasks that are broadcast
+ * to the halted cores
+ *
+ */
+TASK_BROADCAST g_HaltedCoreBroadcast;
+
+/**
+ * @brief The tasks that are deferred while an event set is applied
+ * to the halted cores
+ *
+ */
+TASK_BROADCAST_BATCH g_HaltedCoreBatch;
+
+/**
+ * @brief Whether the synchronized tasks of the halted cores are
+ * deferred to the batch or not
+ *
+ */
+BOOLEAN g_HaltedCoreBatchActive;
+
 /**
  * @brief Holds the requests to pause the break of debuggee until
  * a special event happens
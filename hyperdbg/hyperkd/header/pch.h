@@ -97,6 +97,41 @@
 #include "components/optimizations/header/BinarySearch.h"
 #include "components/optimizations/header/InsertionSort.h"
 
+//
+// Memory search engine
+//
+#include "components/memsearch/header/MemorySearch.h"
+
+//
+// Atomic operations of the components
+//
+#include "components/atomics/header/Atomics.h"
+
+//
+// Index of the events
+//
+#include "components/eventindex/header/EventIndex.h"
+
+//
+// Hash tables
+//
+#include "components/hashtable/header/HashTable.h"
+
+//
+// Free lists of the pools
+//
+#include "components/poolcache/header/PoolCache.h"
+
+//
+// Broadcasting tasks to the cores
+//
+#include "components/taskbroadcast/header/TaskBroadcast.h"
+
+//
+// Records of the batched steps
+//
+#include "components/steprecord/header/StepRecord.h"
+
 //
 // Debugger Types
 //
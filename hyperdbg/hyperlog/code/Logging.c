@@ -88,6 +88,71 @@ BOOLEAN inline LogSendImmediateMessage(CHAR * OptionalBuffer,
     return SendImmediateMessage(OptionalBuffer, OptionalBufferLength, OperationCode);
 }
 
+/**
+ * @brief Get the size of the per-core rings
+ * @param RequestedSize The size that is requested by the caller (zero for the default)
+ *
+ * @return UINT32 A power of two which is at least LOG_RING_MINIMUM_SIZE
+ */
+static UINT32
+LogGetPerCoreRingSize(UINT32 RequestedSize)
+{
+    UINT32 Size = LOG_RING_MINIMUM_SIZE;
+
+    if (RequestedSize == 0)
+    {
+        RequestedSize = LogPerCoreRingSize;
+    }
+
+    while (Size < RequestedSize && Size < 0x80000000)
+    {
+        Size <<= 1;
+    }
+
+    return Size;
+}
+
+/**
+ * @brief Allocate the per-core rings of vmx-root messages
+ * @param ProcessorsCount Number of the cores
+ * @param RingSize Size of each ring
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+LogInitializeVmxRootRings(UINT32 ProcessorsCount, UINT32 RingSize)
+{
+    g_VmxRootLogRings              = PlatformMemAllocateZeroedNonPagedPool(sizeof(LOG_RING) * ProcessorsCount);
+    g_VmxRootCoreBufferInformation = PlatformMemAllocateZeroedNonPagedPool(sizeof(LOG_CORE_BUFFER_INFORMATION) * ProcessorsCount);
+
+    if (!g_VmxRootLogRings || !g_VmxRootCoreBufferInformation)
+    {
+        return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+    }
+
+    g_VmxRootLogRingsCount = ProcessorsCount;
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        //
+        // The ring doesn't need to be zeroed as the records are only read after they're written
+        //
+        if (!LogRingInitialize(&g_VmxRootLogRings[i], PlatformMemAllocateNonPagedPool(RingSize), RingSize))
+        {
+            return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+        }
+
+        g_VmxRootCoreBufferInformation[i].BufferForMultipleNonImmediateMessage = (UINT64)PlatformMemAllocateZeroedNonPagedPool(PacketChunkSize);
+
+        if (!g_VmxRootCoreBufferInformation[i].BufferForMultipleNonImmediateMessage)
+        {
+            return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+        }
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Initialize the buffer relating to log message tracing
  * @param MsgTracingCallbacks specify the callbacks
@@ -159,15 +224,24 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
         PlatformSpinlockInitialize(&g_MessageBufferInformation[i].BufferLockForNonImmMessage);
 
         //
-        // allocate the buffer for regular buffers
+        // allocate the buffer for regular buffers (the regular messages of
+        // vmx-root are saved in the per-core rings)
         //
-        g_MessageBufferInformation[i].BufferStartAddress                   = (UINT64)PlatformMemAllocateNonPagedPool(LogBufferSize);
-        g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage = (UINT64)PlatformMemAllocateNonPagedPool(PacketChunkSize);
-
-        if (!g_MessageBufferInformation[i].BufferStartAddress ||
-            !g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage)
+        if (i == 0)
         {
-            return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+            g_MessageBufferInformation[i].BufferStartAddress                   = (UINT64)PlatformMemAllocateNonPagedPool(LogBufferSize);
+            g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage = (UINT64)PlatformMemAllocateNonPagedPool(PacketChunkSize);
+
+            if (!g_MessageBufferInformation[i].BufferStartAddress ||
+                !g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage)
+            {
+                return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+            }
+
+            PlatformZeroMemory((PVOID)g_MessageBufferInformation[i].BufferStartAddress, LogBufferSize);
+            PlatformZeroMemory((PVOID)g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage, PacketChunkSize);
+
+            g_MessageBufferInformation[i].BufferEndAddress = (UINT64)g_MessageBufferInformation[i].BufferStartAddress + LogBufferSize;
         }
 
         //
@@ -183,17 +257,23 @@ LogInitialize(MESSAGE_TRACING_CALLBACKS * MsgTracingCallbacks)
         //
         // Zeroing the buffer
         //
-        PlatformZeroMemory((PVOID)g_MessageBufferInformation[i].BufferStartAddress, LogBufferSize);
-        PlatformZeroMemory((PVOID)g_MessageBufferInformation[i].BufferForMultipleNonImmediateMessage, PacketChunkSize);
         PlatformZeroMemory((PVOID)g_MessageBufferInformation[i].BufferStartAddressPriority, LogBufferSizePriority);
 
         //
         // Set the end address
         //
-        g_MessageBufferInformation[i].BufferEndAddress         = (UINT64)g_MessageBufferInformation[i].BufferStartAddress + LogBufferSize;
         g_MessageBufferInformation[i].BufferEndAddressPriority = (UINT64)g_MessageBufferInformation[i].BufferStartAddressPriority + LogBufferSizePriority;
     }
 
+    //
+    // Allocate the per-core rings of vmx-root messages
+    //
+    if (!LogInitializeVmxRootRings(ProcessorsCount, LogGetPerCoreRingSize(MsgTracingCallbacks->PerCoreRingSize)))
+    {
+        LogUnInitialize();
+        return FALSE; // STATUS_INSUFFICIENT_RESOURCES
+    }
+
     //
     // Copy the callbacks into the global callback holder
     //
@@ -250,6 +330,37 @@ LogUnInitialize()
         PlatformMemFreePool((PVOID)g_MessageBufferInformation);
         g_MessageBufferInformation = NULL;
     }
+
+    //
+    // de-allocate the per-core rings of vmx-root messages
+    //
+    for (UINT32 i = 0; i < g_VmxRootLogRingsCount; i++)
+    {
+        if (g_VmxRootLogRings != NULL && g_VmxRootLogRings[i].Buffer != NULL)
+        {
+            PlatformMemFreePool(g_VmxRootLogRings[i].Buffer);
+        }
+
+        if (g_VmxRootCoreBufferInformation != NULL &&
+            g_VmxRootCoreBufferInformation[i].BufferForMultipleNonImmediateMessage != NULL64_ZERO)
+        {
+            PlatformMemFreePool((PVOID)g_VmxRootCoreBufferInformation[i].BufferForMultipleNonImmediateMessage);
+        }
+    }
+
+    if (g_VmxRootLogRings != NULL)
+    {
+        PlatformMemFreePool(g_VmxRootLogRings);
+        g_VmxRootLogRings = NULL;
+    }
+
+    if (g_VmxRootCoreBufferInformation != NULL)
+    {
+        PlatformMemFreePool(g_VmxRootCoreBufferInformation);
+        g_VmxRootCoreBufferInformation = NULL;
+    }
+
+    g_VmxRootLogRingsCount = 0;
 }
 
 /**
@@ -277,6 +388,18 @@ LogCallbackCheckIfBufferIsFull(BOOLEAN Priority)
         // Set the index
         //
         Index = 1;
+
+        //
+        // Regular messages of vmx-root are saved in the ring of the current core,
+        // the ring is full if a message with the maximum size doesn't fit in it
+        //
+        if (!Priority)
+        {
+            ULONG CurrentCore = PlatformCpuGetCurrentProcessorNumber();
+
+            return CurrentCore >= g_VmxRootLogRingsCount ||
+                   !LogRingHasSpace(&g_VmxRootLogRings[CurrentCore], PacketChunkSize - 1);
+        }
     }
     else
     {
@@ -335,6 +458,71 @@ LogCallbackCheckIfBufferIsFull(BOOLEAN Priority)
     return Header->Valid;
 }
 
+/**
+ * @brief Notify the thread that waits for messages (if any)
+ *
+ * @param IsVmxRoot Whether the new message is in the vmx-root pool
+ * @return VOID
+ */
+static VOID
+LogNotifyWaitingThread(BOOLEAN IsVmxRoot)
+{
+    //
+    // Take the notify record, so only one of the cores inserts its DPC
+    //
+    NOTIFY_RECORD * NotifyRecord = InterlockedExchangePointer((PVOID volatile *)&g_GlobalNotifyRecord, NULL);
+
+    if (NotifyRecord != NULL)
+    {
+        //
+        // set the target pool
+        //
+        NotifyRecord->CheckVmxRootMessagePool = IsVmxRoot;
+
+        //
+        // Insert dpc to queue
+        //
+        PlatformDpcInsertQueueDpc(&NotifyRecord->Dpc, NotifyRecord, NULL);
+    }
+}
+
+/**
+ * @brief Save buffer to the ring of the current core (vmx-root regular messages)
+ * @details Each core only writes to its own ring and the interrupts are disabled
+ * in vmx-root, so there is no need to take any lock
+ *
+ * @param OperationCode The operation code that will be send to user mode
+ * @param Buffer Buffer to be send to user mode
+ * @param BufferLength Length of the buffer
+ * @return BOOLEAN Returns false if the message is dropped
+ */
+static BOOLEAN
+LogSendBufferToCoreRing(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength)
+{
+    ULONG CurrentCore = PlatformCpuGetCurrentProcessorNumber();
+
+    if (CurrentCore >= g_VmxRootLogRingsCount)
+    {
+        return FALSE;
+    }
+
+    //
+    // If the ring is full, the message is dropped and counted (the reader reports
+    // the count of the dropped messages to the user-mode)
+    //
+    if (!LogRingWrite(&g_VmxRootLogRings[CurrentCore], OperationCode, __rdtsc(), Buffer, BufferLength))
+    {
+        return FALSE;
+    }
+
+    //
+    // check if there is any thread in IRP Pending state, so we can complete their request
+    //
+    LogNotifyWaitingThread(TRUE);
+
+    return TRUE;
+}
+
 /**
  * @brief Save buffer to the pool
  *
@@ -409,6 +597,14 @@ LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, B
         return TRUE;
     }
 
+    //
+    // Regular messages of vmx-root are saved in the ring of the current core
+    //
+    if (IsVmxRoot && !Priority)
+    {
+        return LogSendBufferToCoreRing(OperationCode, Buffer, BufferLength);
+    }
+
     //
     // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
     // if not we use the windows spinlock
@@ -517,27 +713,7 @@ LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, B
     //
     // check if there is any thread in IRP Pending state, so we can complete their request
     //
-    if (g_GlobalNotifyRecord != NULL)
-    {
-        //
-        // there is some threads that needs to be completed
-        //
-
-        //
-        // set the target pool
-        //
-        g_GlobalNotifyRecord->CheckVmxRootMessagePool = IsVmxRoot;
-
-        //
-        // Insert dpc to queue
-        //
-        PlatformDpcInsertQueueDpc(&g_GlobalNotifyRecord->Dpc, g_GlobalNotifyRecord, NULL);
-
-        //
-        // set notify routine to null
-        //
-        g_GlobalNotifyRecord = NULL;
-    }
+    LogNotifyWaitingThread(IsVmxRoot);
 
     //
     // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
@@ -558,6 +734,29 @@ LogCallbackSendBuffer(UINT32 OperationCode, PVOID Buffer, UINT32 BufferLength, B
     return TRUE;
 }
 
+/**
+ * @brief Discard the messages of the per-core rings
+ * @details The caller should hold g_VmxRootLoggingLock
+ *
+ * @return UINT32 return count of messages that set to invalid
+ */
+static UINT32
+LogMarkAllCoreRingsAsRead()
+{
+    UINT32 ResultsOfBuffersSetToRead = 0;
+
+    for (UINT32 i = 0; i < g_VmxRootLogRingsCount; i++)
+    {
+        while (LogRingPeek(&g_VmxRootLogRings[i]) != NULL)
+        {
+            LogRingRelease(&g_VmxRootLogRings[i]);
+            ResultsOfBuffersSetToRead++;
+        }
+    }
+
+    return ResultsOfBuffersSetToRead;
+}
+
 /**
  * @brief Mark all buffers as read
  * @details Priority buffers won't be set as read
@@ -587,6 +786,15 @@ LogMarkAllAsRead(BOOLEAN IsVmxRoot)
         // Acquire the lock
         //
         SpinlockLock(&g_VmxRootLoggingLock);
+
+        //
+        // Regular messages of vmx-root are saved in the per-core rings
+        //
+        ResultsOfBuffersSetToRead = LogMarkAllCoreRingsAsRead();
+
+        SpinlockUnlock(&g_VmxRootLoggingLock);
+
+        return ResultsOfBuffersSetToRead;
     }
     else
     {
@@ -695,6 +903,130 @@ LogMarkAllAsRead(BOOLEAN IsVmxRoot)
     return ResultsOfBuffersSetToRead;
 }
 
+#if ShowMessagesOnDebugger
+
+/**
+ * @brief Show a message on the debugger (DbgPrint)
+ *
+ * @param OperationNumber The operation code of the message
+ * @param SendingBuffer The message
+ * @param BufferLength Length of the message
+ * @return VOID
+ */
+static VOID
+LogShowMessageOnDebugger(UINT32 OperationNumber, PVOID SendingBuffer, UINT32 BufferLength)
+{
+    //
+    // Means that show just messages
+    //
+    if (OperationNumber <= OPERATION_LOG_NON_IMMEDIATE_MESSAGE)
+    {
+        //
+        // We're in Dpc level here so it's safe to use DbgPrint
+        // DbgPrint limitation is 512 Byte
+        //
+        if (BufferLength > DbgPrintLimitation)
+        {
+            for (SIZE_T i = 0; i <= BufferLength / DbgPrintLimitation; i++)
+            {
+                if (i != 0)
+                {
+                    PlatformDbgPrint("%s", (CHAR *)((UINT64)SendingBuffer + (DbgPrintLimitation * i) - 2));
+                }
+                else
+                {
+                    PlatformDbgPrint("%s", (CHAR *)((UINT64)SendingBuffer + (DbgPrintLimitation * i)));
+                }
+            }
+        }
+        else
+        {
+            PlatformDbgPrint("%s", (CHAR *)SendingBuffer);
+        }
+    }
+}
+
+#endif
+
+/**
+ * @brief Attempt to read the per-core rings of vmx-root messages
+ * @details The caller should hold g_VmxRootLoggingLock. The dropped messages
+ * of each core are reported first, then the message with the lowest
+ * time-stamp of all of the cores is read
+ *
+ * @param BufferToSaveMessage Target buffer to save the message
+ * @param ReturnedLength The actual length of the buffer that this function used it
+ * @return BOOLEAN return of this function shows whether the read was successful
+ * or not (e.g FALSE shows there's no new buffer available.)
+ */
+static BOOLEAN
+LogReadCoreRings(PVOID BufferToSaveMessage, UINT32 * ReturnedLength)
+{
+    const LOG_RING_RECORD * Record;
+    UINT32                  OperationCode;
+    UINT32                  RingIndex;
+    UINT64                  DroppedRecords;
+    CHAR *                  SavingAddress = (CHAR *)BufferToSaveMessage + sizeof(UINT32);
+
+    //
+    // Report the messages that are dropped as the ring of the core was full
+    //
+    for (UINT32 i = 0; i < g_VmxRootLogRingsCount; i++)
+    {
+        DroppedRecords = g_VmxRootLogRings[i].DroppedRecords;
+
+        if (DroppedRecords != g_VmxRootLogRings[i].ReportedDroppedRecords)
+        {
+            OperationCode = OPERATION_LOG_WARNING_MESSAGE;
+            PlatformWriteMemory(BufferToSaveMessage, &OperationCode, sizeof(UINT32));
+
+            sprintf_s(SavingAddress,
+                      PacketChunkSize - 1,
+                      "warning, %llu message(s) of core %d are dropped as the log buffer of the core was full\n",
+                      DroppedRecords - g_VmxRootLogRings[i].ReportedDroppedRecords,
+                      i);
+
+            g_VmxRootLogRings[i].ReportedDroppedRecords = DroppedRecords;
+
+            *ReturnedLength = (UINT32)strnlen_s(SavingAddress, PacketChunkSize - 1) + sizeof(UINT32);
+
+            return TRUE;
+        }
+    }
+
+    //
+    // Take the oldest message of all of the cores
+    //
+    RingIndex = LogRingPeekOldest(g_VmxRootLogRings, g_VmxRootLogRingsCount, &Record);
+
+    if (RingIndex == LOG_RING_NO_RECORD)
+    {
+        //
+        // there is nothing to send
+        //
+        return FALSE;
+    }
+
+    PlatformWriteMemory(BufferToSaveMessage, &Record->OperationCode, sizeof(UINT32));
+    PlatformWriteMemory(SavingAddress, (PVOID)(Record + 1), Record->Length);
+
+#if ShowMessagesOnDebugger
+    LogShowMessageOnDebugger(Record->OperationCode, SavingAddress, Record->Length);
+#endif
+
+    //
+    // Set the length to show as the ReturnedByted in usermode ioctl function + size of header
+    //
+    *ReturnedLength = Record->Length + sizeof(UINT32);
+
+    //
+    // Remove the message from the ring of the core
+    //
+    LogRingRelease(&g_VmxRootLogRings[RingIndex]);
+
+    return TRUE;
+}
+
 /**
  * @brief Attempt to read the buffer
  *
@@ -752,6 +1084,18 @@ LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLen
 
     if (!Header->Valid)
     {
+        //
+        // Regular messages of vmx-root are saved in the per-core rings
+        //
+        if (IsVmxRoot)
+        {
+            BOOLEAN Result = LogReadCoreRings(BufferToSaveMessage, ReturnedLength);
+
+            SpinlockUnlock(&g_VmxRootLoggingLock);
+
+            return Result;
+        }
+
         //
         // Check for regular message
         //
@@ -818,35 +1162,7 @@ LogReadBuffer(BOOLEAN IsVmxRoot, PVOID BufferToSaveMessage, UINT32 * ReturnedLen
     PlatformWriteMemory(SavingAddress, SendingBuffer, Header->BufferLength);
 
 #if ShowMessagesOnDebugger
-
-    //
-    // Means that show just messages
-    //
-    if (Header->OperationNumber <= OPERATION_LOG_NON_IMMEDIATE_MESSAGE)
-    {
-        //
-        // We're in Dpc level here so it's safe to use DbgPrint
-        // DbgPrint limitation is 512 Byte
-        //
-        if (Header->BufferLength > DbgPrintLimitation)
-        {
-            for (SIZE_T i = 0; i <= Header->BufferLength / DbgPrintLimitation; i++)
-            {
-                if (i != 0)
-                {
-                    PlatformDbgPrint("%s", (CHAR *)((UINT64)SendingBuffer + (DbgPrintLimitation * i) - 2));
-                }
-                else
-                {
-                    PlatformDbgPrint("%s", (CHAR *)((UINT64)SendingBuffer + (DbgPrintLimitation * i)));
-                }
-            }
-        }
-        else
-        {
-            PlatformDbgPrint("%s", (CHAR *)SendingBuffer);
-        }
-    }
+    LogShowMessageOnDebugger(Header->OperationNumber, SendingBuffer, Header->BufferLength);
 #endif
 
     //
@@ -937,6 +1253,24 @@ LogCheckForNewMessage(BOOLEAN IsVmxRoot, BOOLEAN Priority)
     if (IsVmxRoot)
     {
         Index = 1;
+
+        //
+        // Regular messages of vmx-root are saved in the per-core rings (the
+        // dropped messages are also reported as a message)
+        //
+        if (!Priority)
+        {
+            for (UINT32 i = 0; i < g_VmxRootLogRingsCount; i++)
+            {
+                if (!LogRingIsEmpty(&g_VmxRootLogRings[i]) ||
+                    g_VmxRootLogRings[i].DroppedRecords != g_VmxRootLogRings[i].ReportedDroppedRecords)
+                {
+                    return TRUE;
+                }
+            }
+
+            return FALSE;
+        }
     }
     else
     {
@@ -1213,10 +1547,11 @@ LogCallbackPrepareAndSendMessageToQueue(UINT32       OperationCode,
 BOOLEAN
 LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage, CHAR * LogMessage, UINT32 BufferLen, BOOLEAN Priority)
 {
-    BOOLEAN Result;
-    UINT32  Index;
-    BOOLEAN IsVmxRootMode;
-    KIRQL   OldIRQL = NULL_ZERO;
+    BOOLEAN  Result;
+    BOOLEAN  IsVmxRootMode;
+    UINT64 * NonImmBuffer;
+    UINT32 * CurrentLengthOfNonImmBuffer;
+    KIRQL    OldIRQL = NULL_ZERO;
 
     //
     // Set Vmx State
@@ -1266,29 +1601,32 @@ LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage,
     else
     {
         //
-        // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-        // if not we use the windows spinlock
+        // Check if we're in Vmx-root, if it is then we use the buffer of the current core
+        // (no lock is needed as the interrupts are disabled), if not we use the windows spinlock
         //
         if (IsVmxRootMode)
         {
-            //
-            // Set the index
-            //
-            Index = 1;
-            SpinlockLock(&g_VmxRootLoggingLockForNonImmBuffers);
+            ULONG CurrentCore = PlatformCpuGetCurrentProcessorNumber();
+
+            if (CurrentCore >= g_VmxRootLogRingsCount)
+            {
+                return FALSE;
+            }
+
+            NonImmBuffer                = &g_VmxRootCoreBufferInformation[CurrentCore].BufferForMultipleNonImmediateMessage;
+            CurrentLengthOfNonImmBuffer = &g_VmxRootCoreBufferInformation[CurrentCore].CurrentLengthOfNonImmBuffer;
         }
         else
         {
-            //
-            // Set the index
-            //
-            Index = 0;
-
             //
             // Acquire the lock
             //
-            PlatformSpinlockAcquire(&g_MessageBufferInformation[Index].BufferLockForNonImmMessage, &OldIRQL);
+            PlatformSpinlockAcquire(&g_MessageBufferInformation[0].BufferLockForNonImmMessage, &OldIRQL);
+
+            NonImmBuffer                = &g_MessageBufferInformation[0].BufferForMultipleNonImmediateMessage;
+            CurrentLengthOfNonImmBuffer = &g_MessageBufferInformation[0].CurrentLengthOfNonImmBuffer;
         }
+
         //
         // Set the result to True
         //
@@ -1297,50 +1635,42 @@ LogCallbackSendMessageToQueue(UINT32 OperationCode, BOOLEAN IsImmediateMessage,
         //
         // If log message WrittenSize is above the buffer then we have to send the previous buffer
         //
-        if ((g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer + BufferLen) > PacketChunkSize - 1 && g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer != 0)
+        if ((*CurrentLengthOfNonImmBuffer + BufferLen) > PacketChunkSize - 1 && *CurrentLengthOfNonImmBuffer != 0)
         {
             //
             // Send the previous buffer (non-immediate message),
             // accumulated messages don't have priority
             //
             Result = LogCallbackSendBuffer(OPERATION_LOG_NON_IMMEDIATE_MESSAGE,
-                                           (PVOID)g_MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage,
-                                           g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer,
+                                           (PVOID)*NonImmBuffer,
+                                           *CurrentLengthOfNonImmBuffer,
                                            FALSE);
 
             //
             // Free the immediate buffer
             //
-            g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer = 0;
-            PlatformZeroMemory((PVOID)g_MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage, PacketChunkSize);
+            *CurrentLengthOfNonImmBuffer = 0;
+            PlatformZeroMemory((PVOID)*NonImmBuffer, PacketChunkSize);
         }
 
         //
         // We have to save the message
         //
-        PlatformWriteMemory((PVOID)(g_MessageBufferInformation[Index].BufferForMultipleNonImmediateMessage +
-                                    g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer),
+        PlatformWriteMemory((PVOID)(*NonImmBuffer + *CurrentLengthOfNonImmBuffer),
                             LogMessage,
                             BufferLen);
 
         //
         // add the length
         //
-        g_MessageBufferInformation[Index].CurrentLengthOfNonImmBuffer += BufferLen;
+        *CurrentLengthOfNonImmBuffer += BufferLen;
 
-        // Check if we're in Vmx-root, if it is then we use our customized HIGH_IRQL Spinlock,
-        // if not we use the windows spinlock
         //
-        if (IsVmxRootMode)
-        {
-            SpinlockUnlock(&g_VmxRootLoggingLockForNonImmBuffers);
-        }
-        else
+        // Release the windows spinlock (vmx non-root)
+        //
+        if (!IsVmxRootMode)
         {
-            //
-            // Release the lock
-            //
-            PlatformSpinlockRelease(&g_MessageBufferInformation[Index].BufferLockForNonImmMessage, OldIRQL);
+            PlatformSpinlockRelease(&g_MessageBufferInformation[0].BufferLockForNonImmMessage, OldIRQL);
         }
 
         return Result;
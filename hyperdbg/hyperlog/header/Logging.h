@@ -93,6 +93,21 @@ typedef struct _LOG_BUFFER_INFORMATION
 
 } LOG_BUFFER_INFORMATION, *PLOG_BUFFER_INFORMATION;
 
+/**
+ * @brief Core-specific buffers of vmx-root messages
+ *
+ * @details Regular messages of each core in vmx-root are written to the
+ * ring of the core (g_VmxRootLogRings), so the cores never wait for each
+ * other, only the priority messages still use the shared buffers
+ *
+ */
+typedef struct _LOG_CORE_BUFFER_INFORMATION
+{
+    UINT64 BufferForMultipleNonImmediateMessage; // Start address of the buffer for accumulating non-immediate messages
+    UINT32 CurrentLengthOfNonImmBuffer;          // the current size of the buffer for accumulating non-immediate messages
+
+} LOG_CORE_BUFFER_INFORMATION, *PLOG_CORE_BUFFER_INFORMATION;
+
 //////////////////////////////////////////////////
 //				Global Variables				//
 //////////////////////////////////////////////////
@@ -105,15 +120,29 @@ LOG_BUFFER_INFORMATION * g_MessageBufferInformation;
 
 /**
  * @brief Vmx-root lock for logging
+ * @details Protects the priority buffers of vmx-root and serializes the
+ * readers of the rings (the writers of the rings never take it)
  *
  */
 volatile LONG g_VmxRootLoggingLock;
 
 /**
- * @brief Vmx-root lock for logging
+ * @brief Per-core rings of vmx-root messages
+ *
+ */
+LOG_RING * g_VmxRootLogRings;
+
+/**
+ * @brief Per-core buffers of vmx-root non-immediate messages
  *
  */
-volatile LONG g_VmxRootLoggingLockForNonImmBuffers;
+LOG_CORE_BUFFER_INFORMATION * g_VmxRootCoreBufferInformation;
+
+/**
+ * @brief Number of the per-core rings
+ *
+ */
+UINT32 g_VmxRootLogRingsCount;
 
 //////////////////////////////////////////////////
 //					Illustration				//
@@ -162,6 +191,28 @@ each chunk has PacketChunkSize + sizeof(BUFFER_HEADER) size
             |                         |
             |_________________________|
 
+In vmx-root, the regular messages are not written to the above buffer, each
+core has its own ring (LOG_RING) instead, and the records of the ring have
+variable lengths
+
+             _________________________
+            |     LOG_RING_RECORD     |  <- Tail (consumer)
+            |  TimeStamp, Op, Length  |
+            |_________________________|
+            |     BODY (Length)       |
+            |_________________________|
+            |     LOG_RING_RECORD     |
+            |_________________________|
+            |     BODY (Length)       |
+            |_________________________|
+            |                         |  <- Head (producer)
+            |          free           |
+            |_________________________|
+            |     padding record      |  (if a record doesn't fit at the end)
+            |_________________________|
+
+The reader takes the record with the lowest time-stamp of all of the rings
+
 */
 
 //////////////////////////////////////////////////
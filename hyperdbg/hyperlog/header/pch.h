@@ -43,6 +43,8 @@
 #include "SDK/modules/HyperLog.h"
 #include "SDK/imports/kernel/HyperDbgHyperLogImports.h"
 #include "components/spinlock/header/Spinlock.h"
+#include "components/atomics/header/Atomics.h"
+#include "components/logring/header/LogRing.h"
 #include "Logging.h"
 
 //
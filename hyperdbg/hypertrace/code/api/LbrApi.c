@@ -95,6 +95,25 @@ HyperTraceLbrDumpSetKernelStatus(
     }
 }
 
+/**
+ * @brief Set the kernel status in the HyperTrace LBR sampling request structure
+ *
+ * @param LbrSampleRequest Pointer to the HyperTrace LBR sampling request packet
+ * @param Status The kernel status code to write into the request
+ *
+ * @return VOID
+ */
+VOID
+HyperTraceLbrSampleSetKernelStatus(
+    HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest,
+    UINT32                          Status)
+{
+    if (LbrSampleRequest != NULL)
+    {
+        LbrSampleRequest->KernelStatus = Status;
+    }
+}
+
 /**
  * @brief Check if LBR is supported and enabled on the current core
  *
@@ -584,3 +603,103 @@ HyperTraceLbrPerformOperation(HYPERTRACE_LBR_OPERATION_PACKETS * LbrOperationReq
 
     return Status;
 }
+
+/**
+ * @brief Perform actions related to HyperTrace LBR sampling
+ *
+ * @details The samples are taken whenever the LBR is saved (e.g., by lbr_save()
+ * in the script of an event), so the sampling doesn't need the LBR to be
+ * enabled while it's started
+ *
+ * @param LbrSampleRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperTraceLbrPerformSampleOperation(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest)
+{
+    UINT32 RingSize;
+
+    //
+    // Check if the hypertrace module is initialized before performing any operation
+    //
+    if (!g_HyperTraceCallbacksInitialized)
+    {
+        HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_HYPERTRACE_NOT_INITIALIZED);
+        return FALSE;
+    }
+
+    LbrSampleRequest->NumberOfCores   = PlatformCpuGetActiveProcessorCount();
+    LbrSampleRequest->NumberOfSamples = 0;
+    LbrSampleRequest->BufferLength    = 0;
+    LbrSampleRequest->DroppedSamples  = 0;
+
+    switch (LbrSampleRequest->LbrSampleOperationType)
+    {
+    case HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_START:
+
+        RingSize = LbrSampleRequest->RingSize;
+
+        //
+        // The ring should be a power of two (or zero for the default size)
+        //
+        if (RingSize != 0 &&
+            (RingSize < LOG_RING_MINIMUM_SIZE || RingSize > LBR_SAMPLING_MAXIMUM_RING_SIZE || (RingSize & (RingSize - 1)) != 0))
+        {
+            HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_INVALID_LBR_SAMPLING_PARAMETERS);
+            return FALSE;
+        }
+
+        if (!LbrSamplingStart(&RingSize))
+        {
+            HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_LBR_SAMPLING_CANNOT_BE_INITIALIZED);
+            return FALSE;
+        }
+
+        LbrSampleRequest->RingSize = RingSize;
+
+        break;
+
+    case HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_STOP:
+
+        if (!g_LbrSamplingEnabled)
+        {
+            HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_LBR_SAMPLING_NOT_STARTED);
+            return FALSE;
+        }
+
+        LbrSamplingStop();
+
+        break;
+
+    case HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_DRAIN:
+
+        //
+        // The remaining samples can be drained after the sampling is stopped
+        //
+        if (g_LbrSamplingCores == NULL)
+        {
+            HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_LBR_SAMPLING_NOT_STARTED);
+            return FALSE;
+        }
+
+        if (!LbrSamplingDrain(LbrSampleRequest))
+        {
+            HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_INVALID_CORE_ID);
+            return FALSE;
+        }
+
+        break;
+
+    default:
+
+        HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_ERROR_INVALID_HYPERTRACE_OPERATION_TYPE);
+        return FALSE;
+    }
+
+    LbrSampleRequest->IsSampling = g_LbrSamplingEnabled;
+
+    HyperTraceLbrSampleSetKernelStatus(LbrSampleRequest, DEBUGGER_OPERATION_WAS_SUCCESSFUL);
+
+    return TRUE;
+}
@@ -119,6 +119,11 @@ HyperTraceUninit()
         HyperTraceLbrDisable(NULL);
     }
 
+    //
+    // Stop the LBR sampling and free its rings
+    //
+    LbrSamplingUninit();
+
     //
     // Unallocate the global LBR state list if it is allocated
     //
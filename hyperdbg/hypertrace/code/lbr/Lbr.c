@@ -1132,6 +1132,14 @@ LbrSave()
             xrdmsr(MSR_LASTBRANCH_INFO_0 + i, &State->LastBranchInfo[i].AsUInt);
         }
     }
+
+    //
+    // Write the saved stack as a sample if the LBR sampling is started
+    //
+    if (g_LbrSamplingEnabled)
+    {
+        LbrSamplingRecord(CurrentCore, State);
+    }
 }
 
 /**
@@ -0,0 +1,265 @@
+/**
+ * @file LbrSampling.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Sampling the LBR stack into the rings of the cores
+ * @details Whenever the LBR is saved on a core (e.g., by lbr_save() in the
+ * script of an event) while the sampling is started, the saved stack is also
+ * written as a sample into the ring of the core. The rings are drained by the
+ * user-mode, which aggregates the samples into the profiles
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Allocate the rings of the cores
+ *
+ * @param RingSize
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+LbrSamplingAllocateRings(UINT32 RingSize)
+{
+    UINT32              ProcessorsCount = PlatformCpuGetActiveProcessorCount();
+    LBR_SAMPLING_CORE * Cores;
+
+    Cores = (LBR_SAMPLING_CORE *)PlatformMemAllocateZeroedNonPagedPool(sizeof(LBR_SAMPLING_CORE) * ProcessorsCount);
+
+    if (Cores == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < ProcessorsCount; i++)
+    {
+        if (!LogRingInitialize(&Cores[i].Ring, PlatformMemAllocateNonPagedPool(RingSize), RingSize))
+        {
+            for (UINT32 j = 0; j < i; j++)
+            {
+                PlatformMemFreePool(Cores[j].Ring.Buffer);
+            }
+
+            PlatformMemFreePool(Cores);
+            return FALSE;
+        }
+    }
+
+    g_LbrSamplingCoresCount = ProcessorsCount;
+    g_LbrSamplingRingSize   = RingSize;
+    g_LbrSamplingCores      = Cores;
+
+    return TRUE;
+}
+
+/**
+ * @brief Start the sampling of the LBR
+ *
+ * @details The rings are allocated by the first start and kept until the
+ * hypertrace is unloaded, so the later starts keep the size of the rings
+ * (a core might still be writing a sample after the sampling is stopped)
+ *
+ * @param RingSize The size of the ring of each core (zero for the default
+ * size), the size of the rings is returned
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LbrSamplingStart(UINT32 * RingSize)
+{
+    if (g_LbrSamplingCores == NULL)
+    {
+        if (*RingSize == 0)
+        {
+            *RingSize = HYPERTRACE_LBR_SAMPLE_DEFAULT_RING_SIZE;
+        }
+
+        if (!LbrSamplingAllocateRings(*RingSize))
+        {
+            return FALSE;
+        }
+    }
+
+    *RingSize = g_LbrSamplingRingSize;
+
+    g_LbrSamplingEnabled = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Stop the sampling of the LBR (the remaining samples can be drained)
+ *
+ * @return VOID
+ */
+VOID
+LbrSamplingStop()
+{
+    g_LbrSamplingEnabled = FALSE;
+}
+
+/**
+ * @brief Write the saved LBR stack of the current core into its ring
+ *
+ * @details Called on the core itself (both in vmx-root and vmx non-root) after
+ * the LBR stack is saved, the entries are written in the order of the MSRs and
+ * the user-mode puts them in the order of the execution
+ *
+ * @param CoreId
+ * @param State
+ *
+ * @return VOID
+ */
+VOID
+LbrSamplingRecord(UINT32 CoreId, LBR_STACK_ENTRY * State)
+{
+    LBR_SAMPLING_CORE * Core;
+    LBR_SAMPLE_HEADER * Header;
+    LBR_SAMPLE_ENTRY *  Entries;
+    UINT32              NumberOfEntries = (UINT32)g_LbrCapacity;
+
+    if (!g_LbrSamplingEnabled || CoreId >= g_LbrSamplingCoresCount || NumberOfEntries == 0)
+    {
+        return;
+    }
+
+    Core = &g_LbrSamplingCores[CoreId];
+
+    //
+    // A vm-exit in the middle of saving a sample in vmx non-root could save
+    // another sample on the same core, the ring only has a single producer
+    //
+    if (Core->IsRecording)
+    {
+        Core->NestedSamples++;
+        return;
+    }
+
+    Core->IsRecording = TRUE;
+
+    if (NumberOfEntries > MAXIMUM_LBR_CAPACITY)
+    {
+        NumberOfEntries = MAXIMUM_LBR_CAPACITY;
+    }
+
+    Header  = (LBR_SAMPLE_HEADER *)Core->Sample;
+    Entries = (LBR_SAMPLE_ENTRY *)(Header + 1);
+
+    Header->TimeStamp       = __rdtsc();
+    Header->CoreId          = CoreId;
+    Header->NumberOfEntries = (UINT8)NumberOfEntries;
+    Header->Tos             = g_ArchBasedLastBranchRecord ? 0 : (UINT8)(State->Tos % NumberOfEntries);
+    Header->ArchBasedLbr    = g_ArchBasedLastBranchRecord ? 1 : 0;
+    Header->Reserved        = 0;
+
+    for (UINT32 i = 0; i < NumberOfEntries; i++)
+    {
+        Entries[i].From = State->BranchEntry[i].From;
+        Entries[i].To   = State->BranchEntry[i].To;
+        Entries[i].Info = State->LastBranchInfo[i];
+    }
+
+    //
+    // A full ring drops the sample (and counts it)
+    //
+    LogRingWrite(&Core->Ring,
+                 LBR_SAMPLING_RECORD_OPERATION_CODE,
+                 Header->TimeStamp,
+                 Header,
+                 sizeof(LBR_SAMPLE_HEADER) + NumberOfEntries * sizeof(LBR_SAMPLE_ENTRY));
+
+    Core->IsRecording = FALSE;
+}
+
+/**
+ * @brief Move the samples of a core into the buffer of the request
+ *
+ * @param LbrSampleRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LbrSamplingDrain(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest)
+{
+    LBR_SAMPLING_CORE *     Core;
+    const LOG_RING_RECORD * Record;
+    UINT64                  DroppedRecords;
+    UINT64                  NestedSamples;
+    UINT32                  BufferLength    = 0;
+    UINT32                  NumberOfSamples = 0;
+
+    if (LbrSampleRequest->CoreId >= g_LbrSamplingCoresCount)
+    {
+        return FALSE;
+    }
+
+    Core = &g_LbrSamplingCores[LbrSampleRequest->CoreId];
+
+    LbrSampleRequest->HasMoreSamples = FALSE;
+
+    //
+    // The ring only has a single consumer
+    //
+    SpinlockLock(&g_LbrSamplingDrainLock);
+
+    while ((Record = LogRingPeek(&Core->Ring)) != NULL)
+    {
+        if (Record->Length > HYPERTRACE_LBR_SAMPLE_BUFFER_SIZE - BufferLength)
+        {
+            LbrSampleRequest->HasMoreSamples = TRUE;
+            break;
+        }
+
+        memcpy(&LbrSampleRequest->Buffer[BufferLength], Record + 1, Record->Length);
+
+        BufferLength += Record->Length;
+        NumberOfSamples++;
+
+        LogRingRelease(&Core->Ring);
+    }
+
+    DroppedRecords                   = Core->Ring.DroppedRecords;
+    NestedSamples                    = Core->NestedSamples;
+    LbrSampleRequest->DroppedSamples = (DroppedRecords - Core->Ring.ReportedDroppedRecords) +
+                                       (NestedSamples - Core->ReportedNested);
+
+    Core->Ring.ReportedDroppedRecords = DroppedRecords;
+    Core->ReportedNested              = NestedSamples;
+
+    SpinlockUnlock(&g_LbrSamplingDrainLock);
+
+    LbrSampleRequest->BufferLength    = BufferLength;
+    LbrSampleRequest->NumberOfSamples = NumberOfSamples;
+
+    return TRUE;
+}
+
+/**
+ * @brief Free the rings of the cores
+ *
+ * @return VOID
+ */
+VOID
+LbrSamplingUninit()
+{
+    g_LbrSamplingEnabled = FALSE;
+
+    if (g_LbrSamplingCores == NULL)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < g_LbrSamplingCoresCount; i++)
+    {
+        PlatformMemFreePool(g_LbrSamplingCores[i].Ring.Buffer);
+    }
+
+    PlatformMemFreePool(g_LbrSamplingCores);
+
+    g_LbrSamplingCores      = NULL;
+    g_LbrSamplingCoresCount = 0;
+    g_LbrSamplingRingSize   = 0;
+}
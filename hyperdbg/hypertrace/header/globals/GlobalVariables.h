@@ -71,6 +71,36 @@ CPUID28_LEAFS g_Cpuid28Leafs;
  */
 UINT64 g_LbrFilterOptions;
 
+/**
+ * @brief The flag indicating whether the saved LBR stacks are also written into the sampling rings
+ *
+ */
+volatile BOOLEAN g_LbrSamplingEnabled;
+
+/**
+ * @brief Dynamically allocated array to hold the LBR sampling rings for each core
+ *
+ */
+LBR_SAMPLING_CORE * g_LbrSamplingCores;
+
+/**
+ * @brief Count of the cores of the LBR sampling rings
+ *
+ */
+UINT32 g_LbrSamplingCoresCount;
+
+/**
+ * @brief Size of the LBR sampling ring of each core
+ *
+ */
+UINT32 g_LbrSamplingRingSize;
+
+/**
+ * @brief The lock of the consumer of the LBR sampling rings
+ *
+ */
+volatile LONG g_LbrSamplingDrainLock;
+
 /**
  * @brief The flag indicating whether the hypertrace Processor Trace is initialized or not
  *
@@ -0,0 +1,74 @@
+/**
+ * @file LbrSampling.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of sampling the LBR stack into the rings of the cores
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Operation code of the records of the LBR samples in the rings
+ *
+ */
+#define LBR_SAMPLING_RECORD_OPERATION_CODE 0x1
+
+/**
+ * @brief Maximum size of the ring of each core
+ *
+ */
+#define LBR_SAMPLING_MAXIMUM_RING_SIZE 0x1000000
+
+/**
+ * @brief Size of the largest sample (a full LBR stack)
+ *
+ */
+#define LBR_SAMPLING_MAXIMUM_SAMPLE_SIZE (sizeof(LBR_SAMPLE_HEADER) + MAXIMUM_LBR_CAPACITY * sizeof(LBR_SAMPLE_ENTRY))
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The sampling state of a core
+ *
+ * @details Only the core itself writes into its ring, and the sample is built
+ * in the core's buffer (not on the stack of the vmx-root)
+ *
+ */
+typedef struct _LBR_SAMPLING_CORE
+{
+    LOG_RING Ring;
+    BOOLEAN  IsRecording;    // a sample of the core is being written
+    UINT64   NestedSamples;  // samples that are dropped as they interrupted another sample
+    UINT64   ReportedNested; // nested samples that are reported by the drains
+    BYTE     Sample[LBR_SAMPLING_MAXIMUM_SAMPLE_SIZE];
+
+} LBR_SAMPLING_CORE, *PLBR_SAMPLING_CORE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+LbrSamplingStart(UINT32 * RingSize);
+
+VOID
+LbrSamplingStop();
+
+VOID
+LbrSamplingRecord(UINT32 CoreId, LBR_STACK_ENTRY * State);
+
+BOOLEAN
+LbrSamplingDrain(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest);
+
+VOID
+LbrSamplingUninit();
@@ -83,6 +83,16 @@
 //
 #include "components/spinlock/header/Spinlock.h"
 
+//
+// Atomic operations of the components
+//
+#include "components/atomics/header/Atomics.h"
+
+//
+// Log ring headers (used by the LBR sampling)
+//
+#include "components/logring/header/LogRing.h"
+
 //
 // Hypertrace Callbacks
 //
@@ -97,6 +107,7 @@
 // Definition of tracing types and structures (Last Branch Record)
 //
 #include "lbr/Lbr.h"
+#include "lbr/LbrSampling.h"
 #include "api/LbrApi.h"
 
 //
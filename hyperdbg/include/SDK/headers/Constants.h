@@ -215,6 +215,14 @@ const UCHAR BuildSignature[] = {
 #define LogBufferSizePriority \
     MaximumPacketsCapacityPriority *(PacketChunkSize + sizeof(BUFFER_HEADER))
 
+/**
+ * @brief Default size of the per-core rings of vmx-root messages
+ * @details Should be a power of two, the records have variable lengths
+ * so the count of the messages depends on their size
+ *
+ */
+#define LogPerCoreRingSize 0x40000
+
 /**
  * @brief limitation of Windows DbgPrint message size
  * @details currently is not functional
@@ -388,6 +396,7 @@ const UCHAR BuildSignature[] = {
 #define OPERATION_HYPERVISOR_DRIVER_END_OF_IRPS                    14U | OPERATION_MANDATORY_DEBUGGEE_BIT
 #define OPERATION_COMMAND_FROM_DEBUGGER_RELOAD_SYMBOL              15U | OPERATION_MANDATORY_DEBUGGEE_BIT
 #define OPERATION_NOTIFICATION_FROM_USER_DEBUGGER_PAUSE            16U | OPERATION_MANDATORY_DEBUGGEE_BIT
+#define OPERATION_DEBUGGEE_REGISTER_EVENT_SET                      17U | OPERATION_MANDATORY_DEBUGGEE_BIT
 
 //////////////////////////////////////////////////
 //       Breakpoints & Debug Breakpoints        //
@@ -92,6 +92,16 @@ typedef enum _POOL_ALLOCATION_INTENTION
     INSTANT_REGULAR_SAFE_BUFFER_FOR_EVENTS,
     INSTANT_BIG_SAFE_BUFFER_FOR_EVENTS,
 
+    //
+    // Use for the tables of looking up EPT hooks and detours
+    //
+    EPT_HOOK_LOOKUP_TABLE,
+
+    //
+    // Count of the intentions (should be the last one)
+    //
+    POOL_ALLOCATION_INTENTION_COUNT,
+
 } POOL_ALLOCATION_INTENTION;
 
 //////////////////////////////////////////////////
@@ -653,6 +653,99 @@
  */
 #define DEBUGGER_ERROR_CANNOT_INITIALIZE_DEBUGGER 0xc0000065
 
+/**
+ * @brief error, the processor doesn't support PML for dirty logging
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_LOGGING_NOT_SUPPORTED 0xc0000066
+
+/**
+ * @brief error, unable to initialize the dirty logging
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_LOGGING_CANNOT_BE_INITIALIZED 0xc0000067
+
+/**
+ * @brief error, the dirty logging is already enabled
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_LOGGING_ALREADY_ENABLED 0xc0000068
+
+/**
+ * @brief error, the dirty logging is not enabled
+ *
+ */
+#define DEBUGGER_ERROR_DIRTY_LOGGING_NOT_ENABLED 0xc0000069
+
+/**
+ * @brief error, invalid parameters for dirty logging operation request
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_DIRTY_LOGGING_OPERATION_PARAMETERS 0xc000006a
+
+/**
+ * @brief error, unable to initialize the vm-exit profiler
+ *
+ */
+#define DEBUGGER_ERROR_EXIT_PROFILER_CANNOT_BE_INITIALIZED 0xc000006b
+
+/**
+ * @brief error, the vm-exit profiler is not enabled
+ *
+ */
+#define DEBUGGER_ERROR_EXIT_PROFILER_NOT_ENABLED 0xc000006c
+
+/**
+ * @brief error, invalid parameters for vm-exit profiler operation request
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EXIT_PROFILER_OPERATION_PARAMETERS 0xc000006d
+
+/**
+ * @brief error, the event set is malformed
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_EVENT_SET 0xc000006e
+
+/**
+ * @brief error, an action of the event set belongs to an event which
+ * is not in the same set
+ *
+ */
+#define DEBUGGER_ERROR_EVENT_SET_ACTION_WITHOUT_EVENT 0xc000006f
+
+/**
+ * @brief error, the tag of an event of the event set is used more than
+ * once or already used by another event
+ *
+ */
+#define DEBUGGER_ERROR_EVENT_SET_TAG_IS_NOT_UNIQUE 0xc0000070
+
+/**
+ * @brief error, the rings of the LBR sampling cannot be allocated
+ *
+ */
+#define DEBUGGER_ERROR_LBR_SAMPLING_CANNOT_BE_INITIALIZED 0xc0000071
+
+/**
+ * @brief error, the LBR sampling is not started
+ *
+ */
+#define DEBUGGER_ERROR_LBR_SAMPLING_NOT_STARTED 0xc0000072
+
+/**
+ * @brief error, invalid parameters are passed to the LBR sampling
+ *
+ */
+#define DEBUGGER_ERROR_INVALID_LBR_SAMPLING_PARAMETERS 0xc0000073
+
+/**
+ * @brief error, an entry of the event set cannot be applied (and the
+ * entries before it are removed)
+ *
+ */
+#define DEBUGGER_ERROR_EVENT_SET_ENTRY_CANNOT_BE_APPLIED 0xc0000074
+
 //
 // WHEN YOU ADD ANYTHING TO THIS LIST OF ERRORS, THEN
 // MAKE SURE TO ADD AN ERROR MESSAGE TO ShowErrorMessage(UINT32 Error)
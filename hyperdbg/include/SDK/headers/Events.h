@@ -435,4 +435,64 @@ typedef struct _DEBUGGER_EVENT_AND_ACTION_RESULT
 
 } DEBUGGER_EVENT_AND_ACTION_RESULT, *PDEBUGGER_EVENT_AND_ACTION_RESULT;
 
+//////////////////////////////////////////////////
+//                  Event Sets                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Alignment of the entries of an event set
+ *
+ */
+#define DEBUGGER_EVENT_SET_ENTRY_ALIGNMENT 8
+
+/**
+ * @brief Types of the entries of an event set
+ *
+ */
+typedef enum _DEBUGGER_EVENT_SET_ENTRY_TYPE
+{
+    DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT,  // DEBUGGER_GENERAL_EVENT_DETAIL + condition buffer
+    DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION, // DEBUGGER_GENERAL_ACTION + custom code or script buffer
+
+} DEBUGGER_EVENT_SET_ENTRY_TYPE;
+
+/**
+ * @brief Header of each entry of an event set
+ * @details The event or the action is right after this header and the length
+ * (including this header) is aligned to DEBUGGER_EVENT_SET_ENTRY_ALIGNMENT
+ *
+ */
+typedef struct _DEBUGGER_EVENT_SET_ENTRY
+{
+    DEBUGGER_EVENT_SET_ENTRY_TYPE Type;
+    UINT32                        Length;
+
+} DEBUGGER_EVENT_SET_ENTRY, *PDEBUGGER_EVENT_SET_ENTRY;
+
+/**
+ * @brief Multiple events and their actions that are registered at once
+ * @details The entries are right after this header, the actions of each
+ * event come after the event itself; the set is either applied as a whole
+ * or not applied at all
+ *
+ */
+typedef struct _DEBUGGER_EVENT_SET
+{
+    UINT32 NumberOfEntries;
+    UINT32 Length; // length of the set (including this header)
+
+} DEBUGGER_EVENT_SET, *PDEBUGGER_EVENT_SET;
+
+/**
+ * @brief Status of registering an event set
+ *
+ */
+typedef struct _DEBUGGER_EVENT_SET_RESULT
+{
+    BOOLEAN IsSuccessful;
+    UINT32  Error;       // If IsSuccessful was, FALSE
+    UINT32  FailedEntry; // index of the entry that caused the error
+
+} DEBUGGER_EVENT_SET_RESULT, *PDEBUGGER_EVENT_SET_RESULT;
+
 #define SIZEOF_REGISTER_EVENT sizeof(REGISTER_NOTIFY_BUFFER)
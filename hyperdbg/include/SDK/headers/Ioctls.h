@@ -389,6 +389,27 @@
 #define IOCTL_PERFORM_SMI_OPERATION \
     CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_VMM_IOCTL + 0x26, METHOD_BUFFERED, FILE_ANY_ACCESS)
 
+/**
+ * @brief ioctl, to perform dirty logging operations
+ *
+ */
+#define IOCTL_PERFORM_DIRTY_LOGGING_OPERATION \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_VMM_IOCTL + 0x27, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to perform vm-exit profiler operations
+ *
+ */
+#define IOCTL_PERFORM_EXIT_PROFILER_OPERATION \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_VMM_IOCTL + 0x28, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, register a set of events and their actions at once
+ *
+ */
+#define IOCTL_DEBUGGER_REGISTER_EVENT_SET \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_VMM_IOCTL + 0x29, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
 //////////////////////////////////////////////////
 //               HyperTrace IOCTLs              //
 //////////////////////////////////////////////////
@@ -428,3 +449,10 @@
  */
 #define IOCTL_PERFORM_HYPERTRACE_PT_MMAP \
     CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_HYPERTRACE_IOCTL + 0x05, METHOD_BUFFERED, FILE_ANY_ACCESS)
+
+/**
+ * @brief ioctl, to perform HyperTrace LBR sampling operations
+ *
+ */
+#define IOCTL_PERFORM_HYPERTRACE_LBR_SAMPLE \
+    CTL_CODE(FILE_DEVICE_UNKNOWN, IOCTL_HYPERTRACE_IOCTL + 0x06, METHOD_BUFFERED, FILE_ANY_ACCESS)
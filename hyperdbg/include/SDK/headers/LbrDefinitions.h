@@ -169,3 +169,34 @@ typedef struct _LBR_STACK_ENTRY
     UINT8            Tos;
 
 } LBR_STACK_ENTRY, PLBR_STACK_ENTRY;
+
+/**
+ * @brief Header of a sample of the LBR stack (used by the LBR sampling mode)
+ *
+ * @details The header is followed by NumberOfEntries LBR_SAMPLE_ENTRY in the
+ * same order as the MSRs (so the Tos is needed to find the most recent branch
+ * in the legacy LBR)
+ *
+ */
+typedef struct _LBR_SAMPLE_HEADER
+{
+    UINT64 TimeStamp; // time-stamp counter when the sample is taken
+    UINT32 CoreId;
+    UINT8  NumberOfEntries;
+    UINT8  Tos;
+    UINT8  ArchBasedLbr;
+    UINT8  Reserved;
+
+} LBR_SAMPLE_HEADER, *PLBR_SAMPLE_HEADER;
+
+/**
+ * @brief An entry of a sample of the LBR stack
+ *
+ */
+typedef struct _LBR_SAMPLE_ENTRY
+{
+    UINT64       From;
+    UINT64       To;
+    MSR_LBR_INFO Info;
+
+} LBR_SAMPLE_ENTRY, *PLBR_SAMPLE_ENTRY;
@@ -1046,6 +1046,8 @@ typedef enum _DEBUGGER_REMOTE_STEPPING_REQUEST
     DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_IN,
     DEBUGGER_REMOTE_STEPPING_REQUEST_INSTRUMENTATION_STEP_IN,
     DEBUGGER_REMOTE_STEPPING_REQUEST_INSTRUMENTATION_STEP_IN_FOR_TRACKING,
+    DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN,
+    DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN_FOR_TRACKING,
 
     DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_OVER,
     DEBUGGER_REMOTE_STEPPING_REQUEST_STEP_OVER_FOR_GU,
@@ -1068,6 +1070,14 @@ typedef struct _DEBUGGEE_STEP_PACKET
     BOOLEAN IsCurrentInstructionACall;
     UINT32  CallLength;
 
+    //
+    // Only in the case of batched steps (the debuggee steps
+    // the instructions by itself and sends back the records)
+    //
+    UINT32  BatchedStepCount;
+    BOOLEAN BatchedWithRegisters;
+    BOOLEAN BatchedWithInstructionBytes;
+
 } DEBUGGEE_STEP_PACKET, *PDEBUGGEE_STEP_PACKET;
 
 /**
@@ -1076,6 +1086,20 @@ typedef struct _DEBUGGEE_STEP_PACKET
  */
 #define DEBUGGER_REMOTE_TRACKING_DEFAULT_COUNT_OF_STEPPING 0xffffffff
 
+/**
+ * @brief maximum number of instructions that are stepped in a single batch
+ * @details the debugger sends more batches for larger counts (which keeps
+ * CTRL+C responsive as the other cores are halted during a batch)
+ *
+ */
+#define DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT 0x4000
+
+/**
+ * @brief size of the chunks of the records of the batched steps
+ *
+ */
+#define DEBUGGER_REMOTE_BATCHED_STEPPING_CHUNK_SIZE 8 * NORMAL_PAGE_SIZE
+
 // ==============================================================================================
 
 /**
@@ -1277,6 +1301,137 @@ typedef struct _SMI_OPERATION_PACKETS
 
 // ==============================================================================================
 
+/**
+ * @brief Perform actions related to the dirty logging (PML)
+ *
+ */
+typedef enum _DIRTY_LOGGING_OPERATION_REQUEST_TYPE
+{
+    DIRTY_LOGGING_OPERATION_REQUEST_TYPE_ENABLE,
+    DIRTY_LOGGING_OPERATION_REQUEST_TYPE_DISABLE,
+    DIRTY_LOGGING_OPERATION_REQUEST_TYPE_QUERY,
+
+} DIRTY_LOGGING_OPERATION_REQUEST_TYPE;
+
+/**
+ * @brief Maximum number of pages that their dirty bits are fetched by each query (1 GB)
+ *
+ */
+#define DIRTY_LOGGING_MAXIMUM_PAGES_PER_QUERY 0x40000
+
+/**
+ * @brief The structure of dirty logging result packet in HyperDbg
+ *
+ * @details The dirty bits of the pages are fetched in ranges, the first page
+ * of each range should be a multiple of 64 and a query of the first range
+ * (FirstPage = 0) with ResetBitmap starts a new epoch
+ *
+ */
+typedef struct _DIRTY_LOGGING_OPERATION_PACKETS
+{
+    DIRTY_LOGGING_OPERATION_REQUEST_TYPE DirtyLoggingOperationType;
+    BOOLEAN                              ResetBitmap;
+    UINT64                               FirstPage;
+    UINT64                               FetchedPages;   // pages of this range
+    UINT64                               NumberOfPages;  // pages of the whole bitmap
+    UINT64                               DirtyPages;     // dirty pages of this range
+    UINT64                               Epoch;
+    UINT64                               DroppedEntries; // logged addresses beyond the bitmap
+    UINT32                               KernelStatus;
+    UINT64                               Bitmap[DIRTY_LOGGING_MAXIMUM_PAGES_PER_QUERY / 64];
+
+} DIRTY_LOGGING_OPERATION_PACKETS, *PDIRTY_LOGGING_OPERATION_PACKETS;
+
+/**
+ * @brief Debugger size of DIRTY_LOGGING_OPERATION_PACKETS
+ *
+ */
+#define SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS \
+    sizeof(DIRTY_LOGGING_OPERATION_PACKETS)
+
+// ==============================================================================================
+
+/**
+ * @brief Count of the exit reasons that are profiled (basic exit reasons)
+ *
+ */
+#define EXIT_PROFILER_MAXIMUM_EXIT_REASONS 80
+
+/**
+ * @brief Count of the buckets of the latency histograms (log2 of TSC cycles)
+ *
+ */
+#define EXIT_PROFILER_HISTOGRAM_BUCKETS 32
+
+/**
+ * @brief Statistics of a single exit reason
+ *
+ * @details Bucket 'n' of the histograms counts the latencies between 2^n and
+ * 2^(n+1) - 1 cycles (bucket 0 also counts zero), the handler cycles include
+ * the cycles of the events that are triggered by the exit
+ *
+ */
+typedef struct _EXIT_PROFILER_REASON_STATISTICS
+{
+    UINT64 Count;
+    UINT64 HandlerCycles;
+    UINT64 EventCount;  // triggering events (and scripts) by the exits
+    UINT64 EventCycles; // cycles of the triggered events (and scripts)
+    UINT32 HandlerHistogram[EXIT_PROFILER_HISTOGRAM_BUCKETS];
+    UINT32 EventHistogram[EXIT_PROFILER_HISTOGRAM_BUCKETS];
+
+} EXIT_PROFILER_REASON_STATISTICS, *PEXIT_PROFILER_REASON_STATISTICS;
+
+/**
+ * @brief Statistics of the vm-exits of a core
+ *
+ */
+typedef struct _EXIT_PROFILER_STATISTICS
+{
+    EXIT_PROFILER_REASON_STATISTICS Reasons[EXIT_PROFILER_MAXIMUM_EXIT_REASONS];
+    UINT64                          UnknownExits; // exit reasons beyond the profiled reasons
+
+} EXIT_PROFILER_STATISTICS, *PEXIT_PROFILER_STATISTICS;
+
+/**
+ * @brief Perform actions related to the vm-exit profiler
+ *
+ */
+typedef enum _EXIT_PROFILER_OPERATION_REQUEST_TYPE
+{
+    EXIT_PROFILER_OPERATION_REQUEST_TYPE_ENABLE,
+    EXIT_PROFILER_OPERATION_REQUEST_TYPE_DISABLE,
+    EXIT_PROFILER_OPERATION_REQUEST_TYPE_RESET,
+    EXIT_PROFILER_OPERATION_REQUEST_TYPE_QUERY,
+
+} EXIT_PROFILER_OPERATION_REQUEST_TYPE;
+
+/**
+ * @brief The structure of vm-exit profiler result packet in HyperDbg
+ *
+ * @details Each query fetches the statistics of a single core (CoreId)
+ *
+ */
+typedef struct _EXIT_PROFILER_OPERATION_PACKETS
+{
+    EXIT_PROFILER_OPERATION_REQUEST_TYPE ExitProfilerOperationType;
+    UINT32                               CoreId;
+    UINT32                               NumberOfCores;
+    BOOLEAN                              IsEnabled;
+    UINT32                               KernelStatus;
+    EXIT_PROFILER_STATISTICS             Statistics;
+
+} EXIT_PROFILER_OPERATION_PACKETS, *PEXIT_PROFILER_OPERATION_PACKETS;
+
+/**
+ * @brief Debugger size of EXIT_PROFILER_OPERATION_PACKETS
+ *
+ */
+#define SIZEOF_EXIT_PROFILER_OPERATION_PACKETS \
+    sizeof(EXIT_PROFILER_OPERATION_PACKETS)
+
+// ==============================================================================================
+
 /**
  * @brief Perform actions related to HyperTrace for LBR
  *
@@ -1345,6 +1500,63 @@ typedef struct _HYPERTRACE_LBR_DUMP_PACKETS
 
 // ==============================================================================================
 
+/**
+ * @brief Default size of the ring of the LBR samples of each core
+ *
+ */
+#define HYPERTRACE_LBR_SAMPLE_DEFAULT_RING_SIZE 0x40000
+
+/**
+ * @brief Size of the buffer of the LBR samples that are drained by each request
+ *
+ */
+#define HYPERTRACE_LBR_SAMPLE_BUFFER_SIZE 0x8000
+
+/**
+ * @brief Perform actions related to the LBR sampling
+ *
+ */
+typedef enum _HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE
+{
+    HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_START,
+    HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_STOP,
+    HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_DRAIN,
+
+} HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE;
+
+/**
+ * @brief The structure of HyperTrace LBR sampling result packet in HyperDbg
+ *
+ * @details Each drain request moves the samples of a single core (CoreId)
+ * into the buffer, the buffer contains LBR_SAMPLE_HEADERs, each of them is
+ * followed by its entries
+ *
+ */
+typedef struct _HYPERTRACE_LBR_SAMPLE_PACKETS
+{
+    HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE LbrSampleOperationType;
+    UINT32                             CoreId;
+    UINT32                             NumberOfCores;
+    UINT32                             RingSize; // size of the ring of each core (start)
+    BOOLEAN                            IsSampling;
+    BOOLEAN                            HasMoreSamples; // the buffer is full, the core should be drained again
+    UINT32                             NumberOfSamples;
+    UINT32                             BufferLength;
+    UINT32                             KernelStatus;
+    UINT64                             DroppedSamples; // dropped samples of the core since the last drain
+    BYTE                               Buffer[HYPERTRACE_LBR_SAMPLE_BUFFER_SIZE];
+
+} HYPERTRACE_LBR_SAMPLE_PACKETS, *PHYPERTRACE_LBR_SAMPLE_PACKETS;
+
+/**
+ * @brief Debugger size of HYPERTRACE_LBR_SAMPLE_PACKETS
+ *
+ */
+#define SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS \
+    sizeof(HYPERTRACE_LBR_SAMPLE_PACKETS)
+
+// ==============================================================================================
+
 /**
  * @brief Perform actions related to HyperTrace for PT
  *
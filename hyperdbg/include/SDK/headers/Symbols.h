@@ -96,3 +96,86 @@ typedef struct _DEBUGGEE_SYMBOL_UPDATE_RESULT
 /*
 ==============================================================================================
  */
+
+//////////////////////////////////////////////////
+//              Type Layouts                    //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Kinds of the members of a compiled type layout
+ *
+ */
+typedef enum _SYMBOL_TYPE_LAYOUT_KIND
+{
+    SYMBOL_TYPE_LAYOUT_KIND_INTEGER,
+    SYMBOL_TYPE_LAYOUT_KIND_FLOAT,
+    SYMBOL_TYPE_LAYOUT_KIND_POINTER,
+    SYMBOL_TYPE_LAYOUT_KIND_ARRAY,
+    SYMBOL_TYPE_LAYOUT_KIND_ENUM,
+    SYMBOL_TYPE_LAYOUT_KIND_UDT,
+    SYMBOL_TYPE_LAYOUT_KIND_OTHER,
+
+} SYMBOL_TYPE_LAYOUT_KIND;
+
+/**
+ * @brief A member of a compiled type layout
+ *
+ * @details The names are offsets in the pool of the names of the layout, and
+ * the offsets are from the top of the compiled type (also for the members of
+ * the nested types)
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT_MEMBER
+{
+    UINT32  Name;
+    UINT32  TypeName;
+    UINT32  Offset;
+    UINT32  Size;             // size of the type (the storage unit of the bitfields)
+    UINT32  ElementSize;      // size of the elements of the arrays
+    UINT32  FirstChild;       // members of the nested (inline) structures and unions
+    UINT32  NumberOfChildren;
+    UINT32  FirstEnumerator;  // values of the enums
+    UINT32  NumberOfEnumerators;
+    UINT8   Kind;             // SYMBOL_TYPE_LAYOUT_KIND
+    UINT8   ElementKind;      // SYMBOL_TYPE_LAYOUT_KIND of the elements of the arrays
+    UINT8   BitPosition;
+    UINT8   BitLength;        // zero if it's not a bitfield
+    BOOLEAN IsSigned;
+    BOOLEAN IsUnnamed;        // the nested type doesn't have a name (<unnamed-tag>)
+
+} SYMBOL_TYPE_LAYOUT_MEMBER, *PSYMBOL_TYPE_LAYOUT_MEMBER;
+
+/**
+ * @brief A value of an enum of a compiled type layout
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT_ENUMERATOR
+{
+    UINT64 Value;
+    UINT32 Name;
+
+} SYMBOL_TYPE_LAYOUT_ENUMERATOR, *PSYMBOL_TYPE_LAYOUT_ENUMERATOR;
+
+/**
+ * @brief A type that is compiled once into a flat table of members
+ *
+ * @details The members of the type itself are the first NumberOfTopLevelMembers
+ * members of the table, the layout stays valid until the symbols are unloaded
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT
+{
+    UINT64                                TypeSize;
+    UINT32                                NumberOfMembers;
+    UINT32                                NumberOfTopLevelMembers;
+    UINT32                                NumberOfEnumerators;
+    UINT32                                TypeName;
+    const SYMBOL_TYPE_LAYOUT_MEMBER *     Members;
+    const SYMBOL_TYPE_LAYOUT_ENUMERATOR * Enumerators;
+    const CHAR *                          Names;
+
+} SYMBOL_TYPE_LAYOUT, *PSYMBOL_TYPE_LAYOUT;
+
+/*
+==============================================================================================
+ */
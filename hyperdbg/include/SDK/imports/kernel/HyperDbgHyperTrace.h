@@ -72,6 +72,9 @@ HyperTraceLbrPerformDump(HYPERTRACE_LBR_DUMP_PACKETS * LbrDumpRequest);
 IMPORT_EXPORT_HYPERTRACE BOOLEAN
 HyperTraceLbrPerformOperation(HYPERTRACE_LBR_OPERATION_PACKETS * LbrOperationRequest);
 
+IMPORT_EXPORT_HYPERTRACE BOOLEAN
+HyperTraceLbrPerformSampleOperation(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest);
+
 //////////////////////////////////////////////////
 //                 PT Functions 	    		//
 //////////////////////////////////////////////////
@@ -205,6 +205,12 @@ IMPORT_EXPORT_VMM BOOLEAN
 VmFuncSmmPerformSmiOperation(SMI_OPERATION_PACKETS * SmiOperationRequest,
                              BOOLEAN                 ApplyFromVmxRootMode);
 
+IMPORT_EXPORT_VMM BOOLEAN
+VmFuncDirtyLoggingPerformOperation(DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest);
+
+IMPORT_EXPORT_VMM BOOLEAN
+VmFuncExitProfilingPerformOperation(EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest);
+
 IMPORT_EXPORT_VMM UINT16
 VmFuncGetCsSelector();
 
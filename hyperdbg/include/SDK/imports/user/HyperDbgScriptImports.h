@@ -104,6 +104,9 @@ ScriptEngineGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffs
 IMPORT_EXPORT_HYPERDBG_SCRIPT_ENGINE BOOLEAN
 ScriptEngineGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize);
 
+IMPORT_EXPORT_HYPERDBG_SCRIPT_ENGINE const SYMBOL_TYPE_LAYOUT *
+ScriptEngineGetTypeLayout(const CHAR * TypeName);
+
 IMPORT_EXPORT_HYPERDBG_SCRIPT_ENGINE BOOLEAN
 ScriptEngineCreateSymbolTableForDisassembler(PVOID CallbackFunction);
 
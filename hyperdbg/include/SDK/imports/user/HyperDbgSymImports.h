@@ -61,6 +61,9 @@ SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset);
 IMPORT_EXPORT_HYPERDBG_SYMBOL_PARSER BOOLEAN
 SymGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize);
 
+IMPORT_EXPORT_HYPERDBG_SYMBOL_PARSER const SYMBOL_TYPE_LAYOUT *
+SymGetTypeLayout(const CHAR * TypeName);
+
 IMPORT_EXPORT_HYPERDBG_SYMBOL_PARSER BOOLEAN
 SymCreateSymbolTableForDisassembler(PVOID CallbackFunction);
 
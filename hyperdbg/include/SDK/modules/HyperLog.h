@@ -50,5 +50,6 @@ typedef struct _MESSAGE_TRACING_CALLBACKS
     CHECK_VMX_OPERATION             VmxOperationCheck;
     CHECK_IMMEDIATE_MESSAGE_SENDING CheckImmediateMessageSending;
     SEND_IMMEDIATE_MESSAGE          SendImmediateMessage;
+    UINT32                          PerCoreRingSize; // Size of the per-core rings of vmx-root messages (zero for LogPerCoreRingSize)
 
 } MESSAGE_TRACING_CALLBACKS, *PMESSAGE_TRACING_CALLBACKS;
@@ -0,0 +1,544 @@
+/**
+ * @file AhoCorasick.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Case-insensitive multi-string matcher (Aho-Corasick)
+ * @details A list of strings is compiled once into a complete automaton,
+ * then each text is checked against all of the strings in a single pass
+ * (one table lookup per character). The texts and the patterns are either
+ * narrow (CHAR) or wide (WCHAR) strings, and only the ASCII letters are
+ * case-folded. The matcher doesn't allocate memory, so it's used both in
+ * the kernel and in the user-mode tests
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Read a character of a narrow or wide string
+ *
+ * @param String
+ * @param Index
+ * @param Wide
+ *
+ * @return UINT32
+ */
+static UINT32
+AhoCorasickGetChar(const VOID * String, SIZE_T Index, BOOLEAN Wide)
+{
+    return Wide ? (UINT32)((const WCHAR *)String)[Index] : (UINT32)((const UINT8 *)String)[Index];
+}
+
+/**
+ * @brief Fold the case of an ASCII letter
+ *
+ * @param Char
+ *
+ * @return UINT32
+ */
+static UINT32
+AhoCorasickFoldChar(UINT32 Char)
+{
+    return (Char >= 'A' && Char <= 'Z') ? Char + ('a' - 'A') : Char;
+}
+
+/**
+ * @brief Get the class of a character of the text
+ *
+ * @param Automaton
+ * @param Char
+ *
+ * @return UINT32
+ */
+static UINT32
+AhoCorasickGetClass(const AHO_CORASICK_AUTOMATON * Automaton, UINT32 Char)
+{
+    return Char < 256 ? Automaton->Classes[Char] : 0;
+}
+
+/**
+ * @brief Get the length of a pattern (zero if the pattern can't be compiled)
+ *
+ * @param Pattern
+ * @param Wide
+ *
+ * @return SIZE_T
+ */
+static SIZE_T
+AhoCorasickGetPatternLength(const VOID * Pattern, BOOLEAN Wide)
+{
+    SIZE_T Length = 0;
+    UINT32 Char;
+
+    while ((Char = AhoCorasickGetChar(Pattern, Length, Wide)) != 0)
+    {
+        if (Char >= 256)
+        {
+            return 0;
+        }
+
+        Length++;
+    }
+
+    return Length;
+}
+
+/**
+ * @brief Compute the size of the storage that is needed for compiling the patterns
+ *
+ * @param Patterns Array of the narrow or the wide null-terminated strings
+ * @param NumberOfPatterns
+ * @param Wide Whether the patterns are wide strings or not
+ *
+ * @return SIZE_T The size in bytes (zero if the patterns can't be compiled)
+ */
+SIZE_T
+AhoCorasickGetRequiredSize(const VOID * const * Patterns, UINT32 NumberOfPatterns, BOOLEAN Wide)
+{
+    BOOLEAN Seen[256]       = {0};
+    SIZE_T  NumberOfStates  = 1;
+    SIZE_T  NumberOfClasses = 1;
+    SIZE_T  Length;
+
+    if (NumberOfPatterns == 0 || NumberOfPatterns >= AHO_CORASICK_NO_PATTERN)
+    {
+        return 0;
+    }
+
+    for (UINT32 i = 0; i < NumberOfPatterns; i++)
+    {
+        Length = AhoCorasickGetPatternLength(Patterns[i], Wide);
+
+        if (Length == 0)
+        {
+            return 0;
+        }
+
+        for (SIZE_T j = 0; j < Length; j++)
+        {
+            UINT32 Char = AhoCorasickFoldChar(AhoCorasickGetChar(Patterns[i], j, Wide));
+
+            if (!Seen[Char])
+            {
+                Seen[Char] = TRUE;
+                NumberOfClasses++;
+            }
+        }
+
+        NumberOfStates += Length;
+    }
+
+    //
+    // The number of the states is an upper bound (the patterns usually share
+    // prefixes)
+    //
+    if (NumberOfStates > AHO_CORASICK_MAXIMUM_STATES)
+    {
+        return 0;
+    }
+
+    return NumberOfStates * sizeof(AHO_CORASICK_NODE) +
+           NumberOfStates * NumberOfClasses * sizeof(UINT16) +
+           NumberOfStates * sizeof(UINT16);
+}
+
+/**
+ * @brief Compile the patterns into an automaton
+ *
+ * @param Automaton
+ * @param Patterns Array of the narrow or the wide null-terminated strings
+ * @param NumberOfPatterns
+ * @param Wide Whether the patterns are wide strings or not
+ * @param Storage Memory of the automaton (kept by the automaton)
+ * @param StorageSize At least the size from AhoCorasickGetRequiredSize
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+AhoCorasickBuild(PAHO_CORASICK_AUTOMATON Automaton,
+                 const VOID * const *    Patterns,
+                 UINT32                  NumberOfPatterns,
+                 BOOLEAN                 Wide,
+                 PVOID                   Storage,
+                 SIZE_T                  StorageSize)
+{
+    SIZE_T   RequiredSize = AhoCorasickGetRequiredSize(Patterns, NumberOfPatterns, Wide);
+    SIZE_T   MaximumStates;
+    UINT32   NumberOfClasses = 1;
+    UINT32   NumberOfStates  = 1;
+    UINT32   Class;
+    UINT32   State;
+    UINT32   Next;
+    UINT32   Failure;
+    UINT32   Head = 0;
+    UINT32   Tail = 0;
+    UINT16 * Queue;
+
+    if (RequiredSize == 0 || StorageSize < RequiredSize)
+    {
+        return FALSE;
+    }
+
+    memset(Automaton, 0, sizeof(AHO_CORASICK_AUTOMATON));
+    memset(Storage, 0, RequiredSize);
+
+    //
+    // Assign the classes of the characters
+    //
+    for (UINT32 i = 0; i < NumberOfPatterns; i++)
+    {
+        for (SIZE_T j = 0; AhoCorasickGetChar(Patterns[i], j, Wide) != 0; j++)
+        {
+            UINT32 Char = AhoCorasickFoldChar(AhoCorasickGetChar(Patterns[i], j, Wide));
+
+            if (Automaton->Classes[Char] == 0)
+            {
+                Automaton->Classes[Char] = (UINT8)NumberOfClasses++;
+
+                if (Char >= 'a' && Char <= 'z')
+                {
+                    Automaton->Classes[Char - ('a' - 'A')] = Automaton->Classes[Char];
+                }
+            }
+        }
+    }
+
+    //
+    // Lay out the storage, the upper bound of the states is computed from
+    // the required size
+    //
+    MaximumStates = RequiredSize / (sizeof(AHO_CORASICK_NODE) + NumberOfClasses * sizeof(UINT16) + sizeof(UINT16));
+
+    Automaton->Storage         = Storage;
+    Automaton->StorageSize     = StorageSize;
+    Automaton->NumberOfClasses = NumberOfClasses;
+    Automaton->Nodes           = (AHO_CORASICK_NODE *)Storage;
+    Automaton->Transitions     = (UINT16 *)(Automaton->Nodes + MaximumStates);
+    Queue                      = Automaton->Transitions + MaximumStates * NumberOfClasses;
+
+    Automaton->Nodes[0].Pattern = AHO_CORASICK_NO_PATTERN;
+
+    //
+    // Build the trie (a zero transition means there is no edge, as no edge
+    // goes back to the root)
+    //
+    for (UINT32 i = 0; i < NumberOfPatterns; i++)
+    {
+        State = 0;
+
+        for (SIZE_T j = 0; AhoCorasickGetChar(Patterns[i], j, Wide) != 0; j++)
+        {
+            Class = AhoCorasickGetClass(Automaton, AhoCorasickGetChar(Patterns[i], j, Wide));
+            Next  = Automaton->Transitions[State * NumberOfClasses + Class];
+
+            if (Next == 0)
+            {
+                Next = NumberOfStates++;
+
+                Automaton->Nodes[Next].Depth   = Automaton->Nodes[State].Depth + 1;
+                Automaton->Nodes[Next].Pattern = AHO_CORASICK_NO_PATTERN;
+
+                Automaton->Transitions[State * NumberOfClasses + Class] = (UINT16)Next;
+            }
+
+            State = Next;
+        }
+
+        if (Automaton->Nodes[State].Pattern == AHO_CORASICK_NO_PATTERN)
+        {
+            Automaton->Nodes[State].Pattern = (UINT16)i;
+        }
+
+        if (Automaton->Nodes[State].Depth > Automaton->MaximumPatternLength)
+        {
+            Automaton->MaximumPatternLength = Automaton->Nodes[State].Depth;
+        }
+    }
+
+    Automaton->NumberOfStates = NumberOfStates;
+
+    //
+    // Compute the failure links in the breadth-first order, and complete the
+    // transitions of each state from the transitions of its failure state
+    // (which is shallower, so it's already completed)
+    //
+    for (Class = 0; Class < NumberOfClasses; Class++)
+    {
+        Next = Automaton->Transitions[Class];
+
+        if (Next != 0)
+        {
+            Queue[Tail++] = (UINT16)Next;
+        }
+    }
+
+    while (Head < Tail)
+    {
+        State   = Queue[Head++];
+        Failure = Automaton->Nodes[State].Failure;
+
+        for (Class = 0; Class < NumberOfClasses; Class++)
+        {
+            Next = Automaton->Transitions[State * NumberOfClasses + Class];
+
+            if (Next != 0)
+            {
+                UINT32 NextFailure = Automaton->Transitions[Failure * NumberOfClasses + Class];
+
+                Automaton->Nodes[Next].Failure = (UINT16)NextFailure;
+                Automaton->Nodes[Next].Output  = Automaton->Nodes[NextFailure].Pattern != AHO_CORASICK_NO_PATTERN
+                                                     ? (UINT16)NextFailure
+                                                     : Automaton->Nodes[NextFailure].Output;
+
+                Queue[Tail++] = (UINT16)Next;
+            }
+            else
+            {
+                Automaton->Transitions[State * NumberOfClasses + Class] = Automaton->Transitions[Failure * NumberOfClasses + Class];
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the state after a character
+ *
+ * @param Automaton
+ * @param State
+ * @param Char
+ *
+ * @return UINT32
+ */
+static UINT32
+AhoCorasickStep(const AHO_CORASICK_AUTOMATON * Automaton, UINT32 State, UINT32 Char)
+{
+    return Automaton->Transitions[State * Automaton->NumberOfClasses + AhoCorasickGetClass(Automaton, Char)];
+}
+
+/**
+ * @brief Get the state of the longest pattern that ends in a state
+ *
+ * @param Automaton
+ * @param State
+ *
+ * @return UINT32 The state (zero if no pattern ends in the state)
+ */
+static UINT32
+AhoCorasickGetLongestOutput(const AHO_CORASICK_AUTOMATON * Automaton, UINT32 State)
+{
+    return Automaton->Nodes[State].Pattern != AHO_CORASICK_NO_PATTERN ? State : Automaton->Nodes[State].Output;
+}
+
+/**
+ * @brief Report all of the matches of the patterns in the text
+ *
+ * @param Automaton
+ * @param Text
+ * @param Length Length of the text in characters (or AHO_CORASICK_NULL_TERMINATED)
+ * @param Wide Whether the text is a wide string or not
+ * @param Callback Called for each match, in the order of the end of the matches
+ * @param Context Passed to the callback
+ *
+ * @return BOOLEAN FALSE if the search is stopped by the callback
+ */
+BOOLEAN
+AhoCorasickForEachMatch(const AHO_CORASICK_AUTOMATON * Automaton,
+                        const VOID *                   Text,
+                        SIZE_T                         Length,
+                        BOOLEAN                        Wide,
+                        AHO_CORASICK_MATCH_CALLBACK    Callback,
+                        PVOID                          Context)
+{
+    AHO_CORASICK_MATCH Match;
+    UINT32             State = 0;
+    UINT32             Char;
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        Char = AhoCorasickGetChar(Text, i, Wide);
+
+        if (Char == 0 && Length == AHO_CORASICK_NULL_TERMINATED)
+        {
+            break;
+        }
+
+        State = AhoCorasickStep(Automaton, State, Char);
+
+        for (UINT32 Output = AhoCorasickGetLongestOutput(Automaton, State); Output != 0; Output = Automaton->Nodes[Output].Output)
+        {
+            Match.Offset       = i + 1 - Automaton->Nodes[Output].Depth;
+            Match.Length       = Automaton->Nodes[Output].Depth;
+            Match.PatternIndex = Automaton->Nodes[Output].Pattern;
+
+            if (!Callback(Context, &Match))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether any of the patterns appears in the text
+ *
+ * @param Automaton
+ * @param Text
+ * @param Length Length of the text in characters (or AHO_CORASICK_NULL_TERMINATED)
+ * @param Wide Whether the text is a wide string or not
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+AhoCorasickContains(const AHO_CORASICK_AUTOMATON * Automaton, const VOID * Text, SIZE_T Length, BOOLEAN Wide)
+{
+    UINT32 State = 0;
+    UINT32 Char;
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        Char = AhoCorasickGetChar(Text, i, Wide);
+
+        if (Char == 0 && Length == AHO_CORASICK_NULL_TERMINATED)
+        {
+            break;
+        }
+
+        State = AhoCorasickStep(Automaton, State, Char);
+
+        if (AhoCorasickGetLongestOutput(Automaton, State) != 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Find the leftmost match of the patterns in the text (and the
+ * longest of the matches that start there)
+ *
+ * @param Automaton
+ * @param Text
+ * @param Length Length of the text in characters (or AHO_CORASICK_NULL_TERMINATED)
+ * @param Wide Whether the text is a wide string or not
+ * @param Match The found match
+ *
+ * @return BOOLEAN Whether any of the patterns is found or not
+ */
+BOOLEAN
+AhoCorasickFindFirst(const AHO_CORASICK_AUTOMATON * Automaton,
+                     const VOID *                   Text,
+                     SIZE_T                         Length,
+                     BOOLEAN                        Wide,
+                     PAHO_CORASICK_MATCH            Match)
+{
+    BOOLEAN Found = FALSE;
+    UINT32  State = 0;
+    UINT32  Output;
+    UINT32  Char;
+    SIZE_T  Start;
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        //
+        // The matches that end later can't start at or before the found
+        // match anymore
+        //
+        if (Found && i >= Match->Offset + Automaton->MaximumPatternLength)
+        {
+            break;
+        }
+
+        Char = AhoCorasickGetChar(Text, i, Wide);
+
+        if (Char == 0 && Length == AHO_CORASICK_NULL_TERMINATED)
+        {
+            break;
+        }
+
+        State  = AhoCorasickStep(Automaton, State, Char);
+        Output = AhoCorasickGetLongestOutput(Automaton, State);
+
+        if (Output == 0)
+        {
+            continue;
+        }
+
+        //
+        // The longest pattern that ends here is the one that starts first
+        //
+        Start = i + 1 - Automaton->Nodes[Output].Depth;
+
+        if (!Found || Start < Match->Offset || (Start == Match->Offset && Automaton->Nodes[Output].Depth > Match->Length))
+        {
+            Match->Offset       = Start;
+            Match->Length       = Automaton->Nodes[Output].Depth;
+            Match->PatternIndex = Automaton->Nodes[Output].Pattern;
+            Found               = TRUE;
+        }
+    }
+
+    return Found;
+}
+
+/**
+ * @brief Check whether the whole text is one of the patterns
+ *
+ * @param Automaton
+ * @param Text
+ * @param Length Length of the text in characters (or AHO_CORASICK_NULL_TERMINATED)
+ * @param Wide Whether the text is a wide string or not
+ * @param PatternIndex Index of the matched pattern (optional)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+AhoCorasickMatchesWhole(const AHO_CORASICK_AUTOMATON * Automaton,
+                        const VOID *                   Text,
+                        SIZE_T                         Length,
+                        BOOLEAN                        Wide,
+                        PUINT32                        PatternIndex)
+{
+    UINT32 State = 0;
+    UINT32 Char;
+    SIZE_T i;
+
+    for (i = 0; i < Length; i++)
+    {
+        Char = AhoCorasickGetChar(Text, i, Wide);
+
+        if (Char == 0 && Length == AHO_CORASICK_NULL_TERMINATED)
+        {
+            break;
+        }
+
+        State = AhoCorasickStep(Automaton, State, Char);
+
+        //
+        // Falling back to a suffix means that the text is not a path of the trie
+        //
+        if (Automaton->Nodes[State].Depth != i + 1)
+        {
+            return FALSE;
+        }
+    }
+
+    if (i == 0 || Automaton->Nodes[State].Pattern == AHO_CORASICK_NO_PATTERN)
+    {
+        return FALSE;
+    }
+
+    if (PatternIndex != NULL)
+    {
+        *PatternIndex = Automaton->Nodes[State].Pattern;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file AhoCorasick.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the case-insensitive multi-string matcher (Aho-Corasick)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Shows that a state doesn't end any pattern
+ *
+ */
+#define AHO_CORASICK_NO_PATTERN 0xffff
+
+/**
+ * @brief Maximum number of the states of an automaton
+ *
+ */
+#define AHO_CORASICK_MAXIMUM_STATES 0xfffe
+
+/**
+ * @brief Length of the texts that end with a null character
+ *
+ */
+#define AHO_CORASICK_NULL_TERMINATED ((SIZE_T)-1)
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A state of the automaton
+ *
+ */
+typedef struct _AHO_CORASICK_NODE
+{
+    UINT16 Depth;   // length of the string that leads to this state
+    UINT16 Pattern; // index of the pattern that ends in this state
+    UINT16 Failure; // state of the longest proper suffix
+    UINT16 Output;  // next state on the failure chain that ends a pattern (zero if none)
+
+} AHO_CORASICK_NODE, *PAHO_CORASICK_NODE;
+
+/**
+ * @brief A match of a pattern in the text
+ *
+ */
+typedef struct _AHO_CORASICK_MATCH
+{
+    SIZE_T Offset;       // offset of the match in the text (in characters)
+    UINT32 Length;       // length of the match (in characters)
+    UINT32 PatternIndex; // index of the matched pattern
+
+} AHO_CORASICK_MATCH, *PAHO_CORASICK_MATCH;
+
+/**
+ * @brief Callback that is called for each match (returning FALSE stops
+ * the search)
+ *
+ */
+typedef BOOLEAN (*AHO_CORASICK_MATCH_CALLBACK)(PVOID Context, const AHO_CORASICK_MATCH * Match);
+
+/**
+ * @brief A compiled automaton
+ *
+ * @details The transitions are a complete table (no failure links are
+ * followed while matching), indexed by the state and the class of the
+ * character. Each character that appears in the patterns has its own class
+ * (the upper and lower case letters share the same class), and all of the
+ * other characters are class zero. The patterns that only differ in case
+ * end in the same state, which reports the first of them
+ *
+ */
+typedef struct _AHO_CORASICK_AUTOMATON
+{
+    PVOID               Storage;
+    SIZE_T              StorageSize;
+    UINT32              NumberOfStates;
+    UINT32              NumberOfClasses;
+    UINT32              MaximumPatternLength;
+    UINT8               Classes[256];
+    AHO_CORASICK_NODE * Nodes;
+    UINT16 *            Transitions;
+
+} AHO_CORASICK_AUTOMATON, *PAHO_CORASICK_AUTOMATON;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+SIZE_T
+AhoCorasickGetRequiredSize(const VOID * const * Patterns, UINT32 NumberOfPatterns, BOOLEAN Wide);
+
+BOOLEAN
+AhoCorasickBuild(PAHO_CORASICK_AUTOMATON Automaton,
+                 const VOID * const *    Patterns,
+                 UINT32                  NumberOfPatterns,
+                 BOOLEAN                 Wide,
+                 PVOID                   Storage,
+                 SIZE_T                  StorageSize);
+
+BOOLEAN
+AhoCorasickForEachMatch(const AHO_CORASICK_AUTOMATON * Automaton,
+                        const VOID *                   Text,
+                        SIZE_T                         Length,
+                        BOOLEAN                        Wide,
+                        AHO_CORASICK_MATCH_CALLBACK    Callback,
+                        PVOID                          Context);
+
+BOOLEAN
+AhoCorasickContains(const AHO_CORASICK_AUTOMATON * Automaton, const VOID * Text, SIZE_T Length, BOOLEAN Wide);
+
+BOOLEAN
+AhoCorasickFindFirst(const AHO_CORASICK_AUTOMATON * Automaton,
+                     const VOID *                   Text,
+                     SIZE_T                         Length,
+                     BOOLEAN                        Wide,
+                     PAHO_CORASICK_MATCH            Match);
+
+BOOLEAN
+AhoCorasickMatchesWhole(const AHO_CORASICK_AUTOMATON * Automaton,
+                        const VOID *                   Text,
+                        SIZE_T                         Length,
+                        BOOLEAN                        Wide,
+                        PUINT32                        PatternIndex);
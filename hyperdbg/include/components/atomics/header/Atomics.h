@@ -0,0 +1,337 @@
+/**
+ * @file Atomics.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Atomic operations of the components that are shared between the cores
+ * @details The loads and the stores only stop the reorders of the compiler on
+ * MSVC (x64 doesn't reorder the loads with the loads or the stores with the
+ * stores), the other compilers use their atomic built-ins. The read-modify-write
+ * operations are full barriers (the same as the Interlocked functions)
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Read a 64-bit value that is published by another core
+ *
+ * @param Target
+ *
+ * @return UINT64
+ */
+static inline UINT64
+AtomicLoadAcquire64(volatile UINT64 * Target)
+{
+#if defined(_MSC_VER)
+    UINT64 Value = *Target;
+    _ReadWriteBarrier();
+
+    return Value;
+#else
+    return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Publish a 64-bit value to the other cores
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return VOID
+ */
+static inline VOID
+AtomicStoreRelease64(volatile UINT64 * Target, UINT64 Value)
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *Target = Value;
+#else
+    __atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief Read a 32-bit value that is published by another core
+ *
+ * @param Target
+ *
+ * @return LONG
+ */
+static inline LONG
+AtomicLoadAcquire32(volatile LONG * Target)
+{
+#if defined(_MSC_VER)
+    LONG Value = *Target;
+    _ReadWriteBarrier();
+
+    return Value;
+#else
+    return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Read a pointer that is published by another core
+ *
+ * @param Target
+ *
+ * @return PVOID
+ */
+static inline PVOID
+AtomicLoadAcquirePointer(PVOID volatile * Target)
+{
+#if defined(_MSC_VER)
+    PVOID Value = *Target;
+    _ReadWriteBarrier();
+
+    return Value;
+#else
+    return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+/**
+ * @brief Publish a pointer to the other cores
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return VOID
+ */
+static inline VOID
+AtomicStoreReleasePointer(PVOID volatile * Target, PVOID Value)
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *Target = Value;
+#else
+    __atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+#endif
+}
+
+/**
+ * @brief Increment a 32-bit counter
+ *
+ * @param Target
+ *
+ * @return LONG The new value of the counter
+ */
+static inline LONG
+AtomicIncrement(volatile LONG * Target)
+{
+#if defined(_MSC_VER)
+    return InterlockedIncrement(Target);
+#else
+    return __atomic_add_fetch(Target, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Decrement a 32-bit counter
+ *
+ * @param Target
+ *
+ * @return LONG The new value of the counter
+ */
+static inline LONG
+AtomicDecrement(volatile LONG * Target)
+{
+#if defined(_MSC_VER)
+    return InterlockedDecrement(Target);
+#else
+    return __atomic_sub_fetch(Target, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Add to a 32-bit counter
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return LONG The new value of the counter
+ */
+static inline LONG
+AtomicAdd(volatile LONG * Target, LONG Value)
+{
+#if defined(_MSC_VER)
+    return InterlockedExchangeAdd(Target, Value) + Value;
+#else
+    return __atomic_add_fetch(Target, Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Add to a 64-bit counter
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return UINT64 The new value of the counter
+ */
+static inline UINT64
+AtomicAdd64(volatile UINT64 * Target, UINT64 Value)
+{
+#if defined(_MSC_VER)
+    return (UINT64)InterlockedExchangeAdd64((volatile LONG64 *)Target, (LONG64)Value) + Value;
+#else
+    return __atomic_add_fetch(Target, Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Set the bits of a 64-bit value
+ *
+ * @param Target
+ * @param Mask
+ *
+ * @return UINT64 The previous value
+ */
+static inline UINT64
+AtomicOr64(volatile UINT64 * Target, UINT64 Mask)
+{
+#if defined(_MSC_VER)
+    return (UINT64)InterlockedOr64((volatile LONG64 *)Target, (LONG64)Mask);
+#else
+    return __atomic_fetch_or(Target, Mask, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Change a 32-bit value
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return LONG The previous value
+ */
+static inline LONG
+AtomicExchange(volatile LONG * Target, LONG Value)
+{
+#if defined(_MSC_VER)
+    return InterlockedExchange(Target, Value);
+#else
+    return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Change a 64-bit value
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return UINT64 The previous value
+ */
+static inline UINT64
+AtomicExchange64(volatile UINT64 * Target, UINT64 Value)
+{
+#if defined(_MSC_VER)
+    return (UINT64)InterlockedExchange64((volatile LONG64 *)Target, (LONG64)Value);
+#else
+    return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Change a pointer
+ *
+ * @param Target
+ * @param Value
+ *
+ * @return PVOID The previous pointer
+ */
+static inline PVOID
+AtomicExchangePointer(PVOID volatile * Target, PVOID Value)
+{
+#if defined(_MSC_VER)
+    return InterlockedExchangePointer(Target, Value);
+#else
+    return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * @brief Change a 32-bit value if it's not changed by others
+ *
+ * @param Target
+ * @param Exchange
+ * @param Comperand
+ *
+ * @return LONG The previous value (the value is changed if it's Comperand)
+ */
+static inline LONG
+AtomicCompareExchange(volatile LONG * Target, LONG Exchange, LONG Comperand)
+{
+#if defined(_MSC_VER)
+    return InterlockedCompareExchange(Target, Exchange, Comperand);
+#else
+    __atomic_compare_exchange_n(Target, &Comperand, Exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+    return Comperand;
+#endif
+}
+
+/**
+ * @brief Change a 64-bit value if it's not changed by others
+ *
+ * @param Target
+ * @param Exchange
+ * @param Comperand
+ *
+ * @return UINT64 The previous value (the value is changed if it's Comperand)
+ */
+static inline UINT64
+AtomicCompareExchange64(volatile UINT64 * Target, UINT64 Exchange, UINT64 Comperand)
+{
+#if defined(_MSC_VER)
+    return (UINT64)InterlockedCompareExchange64((volatile LONG64 *)Target, (LONG64)Exchange, (LONG64)Comperand);
+#else
+    __atomic_compare_exchange_n(Target, &Comperand, Exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+    return Comperand;
+#endif
+}
+
+/**
+ * @brief Change a pointer if it's not changed by others
+ *
+ * @param Target
+ * @param Exchange
+ * @param Comperand
+ *
+ * @return PVOID The previous pointer (the pointer is changed if it's Comperand)
+ */
+static inline PVOID
+AtomicCompareExchangePointer(PVOID volatile * Target, PVOID Exchange, PVOID Comperand)
+{
+#if defined(_MSC_VER)
+    return InterlockedCompareExchangePointer(Target, Exchange, Comperand);
+#else
+    __atomic_compare_exchange_n(Target, &Comperand, Exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+    return Comperand;
+#endif
+}
+
+/**
+ * @brief Tell the processor that the core is waiting for another core
+ *
+ * @return VOID
+ */
+static inline VOID
+AtomicPause(VOID)
+{
+#if defined(_MSC_VER)
+    _mm_pause();
+#else
+    __builtin_ia32_pause();
+#endif
+}
@@ -0,0 +1,436 @@
+/**
+ * @file DirtyBitmap.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Bitmaps of the dirty pages and the incremental snapshots
+ * @details The bitmaps are filled from the page-modification logs (PML) and
+ * the incremental snapshots only contain the pages that are marked in a
+ * fetched bitmap. The bitmaps don't allocate any memory, the caller gives a
+ * pre-allocated buffer, so they could be used in vmx-root
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the count of the set bits of a word
+ *
+ * @param Word
+ *
+ * @return UINT64
+ */
+static UINT64
+DirtyBitmapCountBits(UINT64 Word)
+{
+    Word = Word - ((Word >> 1) & 0x5555555555555555ull);
+    Word = (Word & 0x3333333333333333ull) + ((Word >> 2) & 0x3333333333333333ull);
+    Word = (Word + (Word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+
+    return (Word * 0x0101010101010101ull) >> 56;
+}
+
+/**
+ * @brief Get the index of the lowest set bit
+ *
+ * @param Word A non-zero word
+ *
+ * @return UINT64
+ */
+static UINT64
+DirtyBitmapLowestBit(UINT64 Word)
+{
+#if defined(_MSC_VER)
+    unsigned long Index = 0;
+
+    _BitScanForward64(&Index, Word);
+
+    return Index;
+#else
+    return (UINT64)__builtin_ctzll(Word);
+#endif
+}
+
+/**
+ * @brief Get the mask of the bits of a word for a range of pages
+ *
+ * @param FirstBit
+ * @param NumberOfBits
+ *
+ * @return UINT64
+ */
+static UINT64
+DirtyBitmapGetMask(UINT64 FirstBit, UINT64 NumberOfBits)
+{
+    UINT64 Mask = NumberOfBits >= 64 ? ~0ull : ((1ull << NumberOfBits) - 1);
+
+    return Mask << FirstBit;
+}
+
+/**
+ * @brief Initialize a bitmap in a buffer
+ *
+ * @param Buffer A zeroed buffer with the size of DIRTY_BITMAP_SIZE(NumberOfPages)
+ * @param NumberOfPages Count of the physical pages (from address zero)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+DirtyBitmapInitialize(PVOID Buffer, UINT64 NumberOfPages)
+{
+    PDIRTY_BITMAP Bitmap = (PDIRTY_BITMAP)Buffer;
+
+    if (Buffer == NULL || NumberOfPages == 0)
+    {
+        return FALSE;
+    }
+
+    Bitmap->NumberOfPages  = NumberOfPages;
+    Bitmap->Epoch          = 0;
+    Bitmap->MarkedPages    = 0;
+    Bitmap->DroppedEntries = 0;
+    Bitmap->Bits           = (volatile UINT64 *)(Bitmap + 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Mark the page of a physical address as dirty
+ * @details Could be called from all of the cores at the same time
+ *
+ * @param Bitmap
+ * @param PhysicalAddress
+ * @param IsLargePage Whether the address is mapped by a large (2 MB) page, then
+ * all of its pages are marked, as the writes to the other pages of a dirty large
+ * page are not logged
+ *
+ * @return BOOLEAN FALSE if the address is beyond the bitmap
+ */
+BOOLEAN
+DirtyBitmapMarkPage(PDIRTY_BITMAP Bitmap, UINT64 PhysicalAddress, BOOLEAN IsLargePage)
+{
+    UINT64 Page          = PhysicalAddress >> DIRTY_BITMAP_PAGE_SHIFT;
+    UINT64 NumberOfPages = 1;
+    UINT64 Marked        = 0;
+
+    if (IsLargePage)
+    {
+        Page &= ~(UINT64)(DIRTY_BITMAP_LARGE_PAGE_PAGES - 1);
+        NumberOfPages = DIRTY_BITMAP_LARGE_PAGE_PAGES;
+    }
+
+    if (Page >= Bitmap->NumberOfPages)
+    {
+        AtomicAdd64(&Bitmap->DroppedEntries, 1);
+        return FALSE;
+    }
+
+    if (NumberOfPages > Bitmap->NumberOfPages - Page)
+    {
+        NumberOfPages = Bitmap->NumberOfPages - Page;
+    }
+
+    while (NumberOfPages != 0)
+    {
+        UINT64 FirstBit = Page % 64;
+        UINT64 Count    = 64 - FirstBit < NumberOfPages ? 64 - FirstBit : NumberOfPages;
+        UINT64 Mask     = DirtyBitmapGetMask(FirstBit, Count);
+
+        //
+        // Only the new bits are counted (most of the pages are marked again)
+        //
+        if ((AtomicLoadAcquire64(&Bitmap->Bits[Page / 64]) & Mask) != Mask)
+        {
+            Marked += DirtyBitmapCountBits(~AtomicOr64(&Bitmap->Bits[Page / 64], Mask) & Mask);
+        }
+
+        Page += Count;
+        NumberOfPages -= Count;
+    }
+
+    if (Marked != 0)
+    {
+        AtomicAdd64(&Bitmap->MarkedPages, Marked);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Copy a range of a bitmap (and clear it)
+ * @details Each word is read and cleared at once, so none of the pages that
+ * are marked at the same time is lost. If the whole bitmap is fetched in more
+ * than one range, a new epoch is started by the range of the first page
+ *
+ * @param Bitmap
+ * @param FirstPage The first page of the range (a multiple of 64)
+ * @param NumberOfPages Count of the pages of the range
+ * @param Destination Receives DIRTY_BITMAP_WORDS(NumberOfPages) words
+ * @param Reset Whether the range is cleared
+ *
+ * @return UINT64 Count of the dirty pages of the range
+ */
+UINT64
+DirtyBitmapFetch(PDIRTY_BITMAP Bitmap, UINT64 FirstPage, UINT64 NumberOfPages, UINT64 * Destination, BOOLEAN Reset)
+{
+    UINT64 DirtyPages = 0;
+    UINT64 Words;
+
+    if (FirstPage % 64 != 0 || FirstPage >= Bitmap->NumberOfPages)
+    {
+        return 0;
+    }
+
+    if (NumberOfPages > Bitmap->NumberOfPages - FirstPage)
+    {
+        NumberOfPages = Bitmap->NumberOfPages - FirstPage;
+    }
+
+    if (Reset && FirstPage == 0)
+    {
+        AtomicAdd64(&Bitmap->Epoch, 1);
+        Bitmap->MarkedPages = 0;
+    }
+
+    Words = DIRTY_BITMAP_WORDS(NumberOfPages);
+
+    for (UINT64 i = 0; i < Words; i++)
+    {
+        volatile UINT64 * Word = &Bitmap->Bits[FirstPage / 64 + i];
+
+        Destination[i] = Reset ? AtomicExchange64(Word, 0) : AtomicLoadAcquire64(Word);
+        DirtyPages += DirtyBitmapCountBits(Destination[i]);
+    }
+
+    return DirtyPages;
+}
+
+/**
+ * @brief Get the count of the dirty pages of a fetched bitmap
+ *
+ * @param Bits
+ * @param NumberOfPages
+ *
+ * @return UINT64
+ */
+UINT64
+DirtyBitmapCountPages(const UINT64 * Bits, UINT64 NumberOfPages)
+{
+    UINT64 DirtyPages = 0;
+
+    for (UINT64 i = 0; i < NumberOfPages / 64; i++)
+    {
+        DirtyPages += DirtyBitmapCountBits(Bits[i]);
+    }
+
+    if (NumberOfPages % 64 != 0)
+    {
+        DirtyPages += DirtyBitmapCountBits(Bits[NumberOfPages / 64] & DirtyBitmapGetMask(0, NumberOfPages % 64));
+    }
+
+    return DirtyPages;
+}
+
+/**
+ * @brief Find the next run of contiguous dirty pages in a fetched bitmap
+ *
+ * @param Bits
+ * @param NumberOfPages
+ * @param StartPage The page to start the search from
+ * @param RunLength Receives the count of the pages of the run
+ *
+ * @return UINT64 The first page of the run (or NumberOfPages if there is no run)
+ */
+UINT64
+DirtyBitmapFindRun(const UINT64 * Bits, UINT64 NumberOfPages, UINT64 StartPage, UINT64 * RunLength)
+{
+    UINT64 Page = StartPage;
+    UINT64 End;
+    UINT64 Word;
+
+    *RunLength = 0;
+
+    //
+    // Skip the clean words at once
+    //
+    while (Page < NumberOfPages)
+    {
+        Word = Bits[Page / 64] >> (Page % 64);
+
+        if (Word != 0)
+        {
+            Page += DirtyBitmapLowestBit(Word);
+            break;
+        }
+
+        Page = (Page / 64 + 1) * 64;
+    }
+
+    if (Page >= NumberOfPages)
+    {
+        return NumberOfPages;
+    }
+
+    //
+    // Find the first clean page after the run
+    //
+    End = Page;
+
+    while (End < NumberOfPages)
+    {
+        Word = ~Bits[End / 64] >> (End % 64);
+
+        if (Word != 0)
+        {
+            End += DirtyBitmapLowestBit(Word);
+            break;
+        }
+
+        End = (End / 64 + 1) * 64;
+    }
+
+    if (End > NumberOfPages)
+    {
+        End = NumberOfPages;
+    }
+
+    *RunLength = End - Page;
+
+    return Page;
+}
+
+/**
+ * @brief Write an incremental snapshot of the dirty pages of a fetched bitmap
+ *
+ * @param Bits
+ * @param NumberOfPages Count of the pages of the bitmap (and the snapshot)
+ * @param Epoch The epoch of the fetched bitmap
+ * @param Buffer A buffer for reading the pages
+ * @param BufferPages Count of the pages of the buffer (the longer runs are split)
+ * @param ReadPages Reads the content of the pages
+ * @param Write Writes the snapshot
+ * @param Context Passed to the callbacks
+ *
+ * @return BOOLEAN FALSE if any of the callbacks failed
+ */
+BOOLEAN
+DirtyBitmapWriteDelta(const UINT64 *            Bits,
+                      UINT64                    NumberOfPages,
+                      UINT64                    Epoch,
+                      PVOID                     Buffer,
+                      UINT32                    BufferPages,
+                      DIRTY_SNAPSHOT_READ_PAGES ReadPages,
+                      DIRTY_SNAPSHOT_WRITE      Write,
+                      PVOID                     Context)
+{
+    DIRTY_SNAPSHOT_DELTA_HEADER Header;
+    DIRTY_SNAPSHOT_DELTA_RUN    Run;
+    UINT64                      Page;
+    UINT64                      RunLength;
+
+    if (BufferPages == 0)
+    {
+        return FALSE;
+    }
+
+    memset(&Header, 0, sizeof(Header));
+    memset(&Run, 0, sizeof(Run));
+
+    Header.Magic         = DIRTY_SNAPSHOT_DELTA_MAGIC;
+    Header.Version       = DIRTY_SNAPSHOT_DELTA_VERSION;
+    Header.Epoch         = Epoch;
+    Header.NumberOfPages = NumberOfPages;
+
+    //
+    // Count the runs first, so the snapshot could be read without seeking
+    //
+    for (Page = DirtyBitmapFindRun(Bits, NumberOfPages, 0, &RunLength);
+         Page < NumberOfPages;
+         Page = DirtyBitmapFindRun(Bits, NumberOfPages, Page + RunLength, &RunLength))
+    {
+        Header.NumberOfRuns += (RunLength + BufferPages - 1) / BufferPages;
+        Header.NumberOfDirtyPages += RunLength;
+    }
+
+    if (!Write(Context, &Header, sizeof(Header)))
+    {
+        return FALSE;
+    }
+
+    for (Page = DirtyBitmapFindRun(Bits, NumberOfPages, 0, &RunLength);
+         Page < NumberOfPages;
+         Page = DirtyBitmapFindRun(Bits, NumberOfPages, Page + RunLength, &RunLength))
+    {
+        for (UINT64 Offset = 0; Offset < RunLength; Offset += Run.NumberOfPages)
+        {
+            Run.FirstPage     = Page + Offset;
+            Run.NumberOfPages = RunLength - Offset < BufferPages ? RunLength - Offset : BufferPages;
+
+            if (!ReadPages(Context, Run.FirstPage, (UINT32)Run.NumberOfPages, Buffer) ||
+                !Write(Context, &Run, sizeof(Run)) ||
+                !Write(Context, Buffer, Run.NumberOfPages * DIRTY_BITMAP_PAGE_SIZE))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Apply an incremental snapshot to an image of the pages (e.g., to
+ * restore the previous snapshot)
+ *
+ * @param Delta
+ * @param DeltaSize
+ * @param Image
+ * @param ImagePages Count of the pages of the image
+ *
+ * @return BOOLEAN FALSE if the snapshot is not valid (the image might be partially changed)
+ */
+BOOLEAN
+DirtyBitmapApplyDelta(const VOID * Delta, UINT64 DeltaSize, PVOID Image, UINT64 ImagePages)
+{
+    const UINT8 *               Cursor = (const UINT8 *)Delta;
+    const UINT8 *               End    = Cursor + DeltaSize;
+    DIRTY_SNAPSHOT_DELTA_HEADER Header;
+    DIRTY_SNAPSHOT_DELTA_RUN    Run;
+
+    if (DeltaSize < sizeof(Header))
+    {
+        return FALSE;
+    }
+
+    memcpy(&Header, Cursor, sizeof(Header));
+    Cursor += sizeof(Header);
+
+    if (Header.Magic != DIRTY_SNAPSHOT_DELTA_MAGIC || Header.Version != DIRTY_SNAPSHOT_DELTA_VERSION ||
+        Header.NumberOfPages > ImagePages)
+    {
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i < Header.NumberOfRuns; i++)
+    {
+        if ((UINT64)(End - Cursor) < sizeof(Run))
+        {
+            return FALSE;
+        }
+
+        memcpy(&Run, Cursor, sizeof(Run));
+        Cursor += sizeof(Run);
+
+        if (Run.FirstPage >= Header.NumberOfPages || Run.NumberOfPages > Header.NumberOfPages - Run.FirstPage ||
+            Run.NumberOfPages > (UINT64)(End - Cursor) / DIRTY_BITMAP_PAGE_SIZE)
+        {
+            return FALSE;
+        }
+
+        memcpy((UINT8 *)Image + Run.FirstPage * DIRTY_BITMAP_PAGE_SIZE, Cursor, Run.NumberOfPages * DIRTY_BITMAP_PAGE_SIZE);
+        Cursor += Run.NumberOfPages * DIRTY_BITMAP_PAGE_SIZE;
+    }
+
+    return TRUE;
+}
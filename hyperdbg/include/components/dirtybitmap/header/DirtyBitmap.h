@@ -0,0 +1,151 @@
+/**
+ * @file DirtyBitmap.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the bitmaps of the dirty pages and the incremental snapshots
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the pages that are tracked by the bitmaps
+ *
+ */
+#define DIRTY_BITMAP_PAGE_SHIFT 12
+#define DIRTY_BITMAP_PAGE_SIZE  (1ull << DIRTY_BITMAP_PAGE_SHIFT)
+
+/**
+ * @brief Count of the pages of a large (2 MB) page
+ *
+ */
+#define DIRTY_BITMAP_LARGE_PAGE_PAGES 512
+
+/**
+ * @brief Count of the UINT64 words of a bitmap for a number of pages
+ *
+ */
+#define DIRTY_BITMAP_WORDS(NumberOfPages) (((NumberOfPages) + 63) / 64)
+
+/**
+ * @brief Size of a bitmap (including its words) for a number of pages
+ *
+ */
+#define DIRTY_BITMAP_SIZE(NumberOfPages) (sizeof(DIRTY_BITMAP) + DIRTY_BITMAP_WORDS(NumberOfPages) * sizeof(UINT64))
+
+/**
+ * @brief Magic of the incremental snapshots ('HDSD')
+ *
+ */
+#define DIRTY_SNAPSHOT_DELTA_MAGIC 0x44534448
+
+/**
+ * @brief Version of the format of the incremental snapshots
+ *
+ */
+#define DIRTY_SNAPSHOT_DELTA_VERSION 1
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A bitmap of the dirty pages (a bit for each physical page)
+ *
+ * @details The pages are marked from all of the cores at the same time
+ * (e.g., when the page-modification logs are flushed in vmx-root) and the
+ * bitmap is fetched and reset word by word, so a page that is marked while
+ * the bitmap is fetched is either in the fetched bits or remains for the
+ * next fetch, but it's never lost
+ *
+ */
+typedef struct _DIRTY_BITMAP
+{
+    UINT64          NumberOfPages;
+    volatile UINT64 Epoch;          // count of the fetches that reset the whole bitmap
+    volatile UINT64 MarkedPages;    // pages marked since the last reset
+    volatile UINT64 DroppedEntries; // addresses beyond the bitmap
+
+    volatile UINT64 * Bits;
+
+} DIRTY_BITMAP, *PDIRTY_BITMAP;
+
+/**
+ * @brief Header of an incremental snapshot
+ *
+ * @details The header is followed by the runs of the dirty pages, each run
+ * is a DIRTY_SNAPSHOT_DELTA_RUN followed by the content of its pages
+ *
+ */
+typedef struct _DIRTY_SNAPSHOT_DELTA_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT64 Epoch;
+    UINT64 NumberOfPages; // pages of the whole snapshot
+    UINT64 NumberOfRuns;
+    UINT64 NumberOfDirtyPages;
+
+} DIRTY_SNAPSHOT_DELTA_HEADER, *PDIRTY_SNAPSHOT_DELTA_HEADER;
+
+/**
+ * @brief A run of contiguous dirty pages in an incremental snapshot
+ *
+ */
+typedef struct _DIRTY_SNAPSHOT_DELTA_RUN
+{
+    UINT64 FirstPage;
+    UINT64 NumberOfPages;
+
+} DIRTY_SNAPSHOT_DELTA_RUN, *PDIRTY_SNAPSHOT_DELTA_RUN;
+
+/**
+ * @brief Read the content of the pages of a run (returns FALSE on failure)
+ *
+ */
+typedef BOOLEAN (*DIRTY_SNAPSHOT_READ_PAGES)(PVOID Context, UINT64 FirstPage, UINT32 NumberOfPages, PVOID Buffer);
+
+/**
+ * @brief Write a part of the incremental snapshot (returns FALSE on failure)
+ *
+ */
+typedef BOOLEAN (*DIRTY_SNAPSHOT_WRITE)(PVOID Context, const VOID * Buffer, UINT64 Size);
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+DirtyBitmapInitialize(PVOID Buffer, UINT64 NumberOfPages);
+
+BOOLEAN
+DirtyBitmapMarkPage(PDIRTY_BITMAP Bitmap, UINT64 PhysicalAddress, BOOLEAN IsLargePage);
+
+UINT64
+DirtyBitmapFetch(PDIRTY_BITMAP Bitmap, UINT64 FirstPage, UINT64 NumberOfPages, UINT64 * Destination, BOOLEAN Reset);
+
+UINT64
+DirtyBitmapCountPages(const UINT64 * Bits, UINT64 NumberOfPages);
+
+UINT64
+DirtyBitmapFindRun(const UINT64 * Bits, UINT64 NumberOfPages, UINT64 StartPage, UINT64 * RunLength);
+
+BOOLEAN
+DirtyBitmapWriteDelta(const UINT64 *            Bits,
+                      UINT64                    NumberOfPages,
+                      UINT64                    Epoch,
+                      PVOID                     Buffer,
+                      UINT32                    BufferPages,
+                      DIRTY_SNAPSHOT_READ_PAGES ReadPages,
+                      DIRTY_SNAPSHOT_WRITE      Write,
+                      PVOID                     Context);
+
+BOOLEAN
+DirtyBitmapApplyDelta(const VOID * Delta, UINT64 DeltaSize, PVOID Image, UINT64 ImagePages);
@@ -0,0 +1,183 @@
+/**
+ * @file EventIndex.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Index of the events (used to dispatch the triggered events)
+ * @details The events of each type are indexed by the key that they are
+ * triggered for (e.g., the hooking tag, syscall number, MSR, I/O port or the
+ * vector), so triggering an event only visits the events that might match
+ * the key, plus the events that are triggered for all of the keys. The index
+ * doesn't allocate any memory, so it could be changed in vmx-root too
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the chain of a key
+ *
+ * @param Index
+ * @param Key
+ * @param IsWildcard
+ *
+ * @return PEVENT_INDEX_ENTRY volatile *
+ */
+static PEVENT_INDEX_ENTRY volatile *
+EventIndexGetChain(PEVENT_INDEX Index, UINT64 Key, BOOLEAN IsWildcard)
+{
+    if (IsWildcard)
+    {
+        return &Index->Wildcards;
+    }
+
+    return &Index->Buckets[(Key * 0x9e3779b97f4a7c15ull) >> EVENT_INDEX_BUCKETS_SHIFT];
+}
+
+/**
+ * @brief Add an entry to the index
+ * @details The order of the entry should be set by the caller. The readers
+ * might be on an indexed or a removed entry, so these entries are not linked
+ * again (see EVENT_INDEX)
+ *
+ * @param Index
+ * @param Entry
+ * @param Key The key that the entry is triggered for
+ * @param IsWildcard Whether the entry is triggered for all of the keys
+ *
+ * @return BOOLEAN TRUE if the entry is indexed by the key and FALSE if the
+ * entry is removed or is already indexed by another key
+ */
+BOOLEAN
+EventIndexInsert(PEVENT_INDEX Index, PEVENT_INDEX_ENTRY Entry, UINT64 Key, BOOLEAN IsWildcard)
+{
+    PEVENT_INDEX_ENTRY volatile * Link;
+
+    if (Entry->IsIndexed)
+    {
+        return Entry->IsWildcard == IsWildcard && (IsWildcard || Entry->Key == Key);
+    }
+
+    if (Entry->IsRemoved)
+    {
+        return FALSE;
+    }
+
+    Entry->Key        = Key;
+    Entry->IsWildcard = IsWildcard;
+
+    //
+    // Keep the chain sorted by the order of the entries
+    //
+    Link = EventIndexGetChain(Index, Key, IsWildcard);
+
+    while (*Link != NULL && (*Link)->Order > Entry->Order)
+    {
+        Link = &(*Link)->Next;
+    }
+
+    Entry->Next = *Link;
+    AtomicStoreReleasePointer((PVOID volatile *)Link, Entry);
+
+    Entry->IsIndexed = TRUE;
+    Index->Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove an entry from the index
+ * @details The entry still points to the rest of its chain, so the readers
+ * that are on the entry continue to the next entries. The entry can't be
+ * inserted again
+ *
+ * @param Index
+ * @param Entry
+ *
+ * @return VOID
+ */
+VOID
+EventIndexRemove(PEVENT_INDEX Index, PEVENT_INDEX_ENTRY Entry)
+{
+    PEVENT_INDEX_ENTRY volatile * Link;
+
+    if (!Entry->IsIndexed)
+    {
+        return;
+    }
+
+    Link = EventIndexGetChain(Index, Entry->Key, Entry->IsWildcard);
+
+    while (*Link != NULL && *Link != Entry)
+    {
+        Link = &(*Link)->Next;
+    }
+
+    if (*Link == Entry)
+    {
+        AtomicStoreReleasePointer((PVOID volatile *)Link, Entry->Next);
+        Index->Count--;
+    }
+
+    Entry->IsIndexed = FALSE;
+    Entry->IsRemoved = TRUE;
+}
+
+/**
+ * @brief Start walking the entries that might be triggered for a key
+ *
+ * @param Index
+ * @param Key
+ * @param Iterator
+ *
+ * @return PEVENT_INDEX_ENTRY The first entry (or NULL if there is no entry)
+ */
+PEVENT_INDEX_ENTRY
+EventIndexFirst(PEVENT_INDEX Index, UINT64 Key, PEVENT_INDEX_ITERATOR Iterator)
+{
+    Iterator->Keyed    = *EventIndexGetChain(Index, Key, FALSE);
+    Iterator->Wildcard = Index->Wildcards;
+    Iterator->Key      = Key;
+
+    return EventIndexNext(Iterator);
+}
+
+/**
+ * @brief Get the next entry that might be triggered for the key of the iterator
+ * @details The entries of the key and the wildcard entries are merged by their
+ * order, so the entries are visited in the same order as they are registered.
+ * The entries of the other keys in the same bucket are skipped
+ *
+ * @param Iterator
+ *
+ * @return PEVENT_INDEX_ENTRY The next entry (or NULL if there is no more entry)
+ */
+PEVENT_INDEX_ENTRY
+EventIndexNext(PEVENT_INDEX_ITERATOR Iterator)
+{
+    PEVENT_INDEX_ENTRY Entry;
+
+    while (Iterator->Keyed != NULL && Iterator->Keyed->Key != Iterator->Key)
+    {
+        Iterator->Keyed = Iterator->Keyed->Next;
+    }
+
+    if (Iterator->Keyed != NULL &&
+        (Iterator->Wildcard == NULL || Iterator->Keyed->Order > Iterator->Wildcard->Order))
+    {
+        Entry           = Iterator->Keyed;
+        Iterator->Keyed = Entry->Next;
+    }
+    else
+    {
+        Entry = Iterator->Wildcard;
+
+        if (Entry != NULL)
+        {
+            Iterator->Wildcard = Entry->Next;
+        }
+    }
+
+    return Entry;
+}
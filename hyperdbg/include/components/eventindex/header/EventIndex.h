@@ -0,0 +1,103 @@
+/**
+ * @file EventIndex.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the index of the events (used to dispatch the triggered events)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of the buckets of each index (a power of two)
+ *
+ */
+#define EVENT_INDEX_BUCKETS_COUNT 256
+
+/**
+ * @brief Shift of the hash of the keys to get the bucket
+ *
+ */
+#define EVENT_INDEX_BUCKETS_SHIFT (64 - 8)
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An entry of the index (embedded in the indexed object)
+ *
+ */
+typedef struct _EVENT_INDEX_ENTRY
+{
+    struct _EVENT_INDEX_ENTRY * volatile Next;
+
+    UINT64  Key;        // address, tag, syscall number, MSR, I/O port, vector, etc.
+    UINT64  Order;      // the entries with a higher order are visited first
+    BOOLEAN IsWildcard; // the entry is visited for all of the keys
+    BOOLEAN IsIndexed;  // whether the entry is in the index or not
+    BOOLEAN IsRemoved;  // the entry is removed, so it's never inserted again
+
+} EVENT_INDEX_ENTRY, *PEVENT_INDEX_ENTRY;
+
+/**
+ * @brief Index of the entries of a single type of event
+ *
+ * @details The entries with a key are chained in the bucket of their key and
+ * the entries without a key are chained in the wildcards list. Each chain is
+ * sorted by the order of the entries (higher orders first). The chains are
+ * only changed by a single writer, and the readers can walk them at the same
+ * time, as an entry is published after it's completely linked, and a removed
+ * entry still points to the rest of its chain
+ *
+ * A reader might be on an entry (or hold the entry after it) at any time, so
+ * the key and the next entry of an entry are never changed after it's linked:
+ * an entry is inserted once (inserting it again with the same key does
+ * nothing) and a removed entry is never inserted again. For indexing an
+ * object by another key, a new entry should be used, and the memory of a
+ * removed entry is only freed (or reused) after all of the cores are
+ * synchronized, so none of the readers are on it anymore
+ *
+ */
+typedef struct _EVENT_INDEX
+{
+    PEVENT_INDEX_ENTRY volatile Buckets[EVENT_INDEX_BUCKETS_COUNT];
+    PEVENT_INDEX_ENTRY volatile Wildcards;
+    UINT32                      Count;
+
+} EVENT_INDEX, *PEVENT_INDEX;
+
+/**
+ * @brief The state of walking the candidate entries of a key
+ *
+ */
+typedef struct _EVENT_INDEX_ITERATOR
+{
+    PEVENT_INDEX_ENTRY Keyed;
+    PEVENT_INDEX_ENTRY Wildcard;
+    UINT64             Key;
+
+} EVENT_INDEX_ITERATOR, *PEVENT_INDEX_ITERATOR;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+EventIndexInsert(PEVENT_INDEX Index, PEVENT_INDEX_ENTRY Entry, UINT64 Key, BOOLEAN IsWildcard);
+
+VOID
+EventIndexRemove(PEVENT_INDEX Index, PEVENT_INDEX_ENTRY Entry);
+
+PEVENT_INDEX_ENTRY
+EventIndexFirst(PEVENT_INDEX Index, UINT64 Key, PEVENT_INDEX_ITERATOR Iterator);
+
+PEVENT_INDEX_ENTRY
+EventIndexNext(PEVENT_INDEX_ITERATOR Iterator);
@@ -0,0 +1,530 @@
+/**
+ * @file ExitProfiler.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Profiling the latency of the vm-exits (per exit reason)
+ * @details The vm-exit handler of each core records the exits into the
+ * profiler of the same core without any lock, and the statistics of the
+ * cores are merged, compared (for sampling intervals), and computed into
+ * rows in the user-mode
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Names of the basic exit reasons
+ *
+ */
+static const CHAR * ExitProfilerReasonNames[EXIT_PROFILER_MAXIMUM_EXIT_REASONS] = {
+    "EXCEPTION_OR_NMI",
+    "EXTERNAL_INTERRUPT",
+    "TRIPLE_FAULT",
+    "INIT_SIGNAL",
+    "STARTUP_IPI",
+    "IO_SMI",
+    "SMI",
+    "INTERRUPT_WINDOW",
+    "NMI_WINDOW",
+    "TASK_SWITCH",
+    "EXECUTE_CPUID",
+    "EXECUTE_GETSEC",
+    "EXECUTE_HLT",
+    "EXECUTE_INVD",
+    "EXECUTE_INVLPG",
+    "EXECUTE_RDPMC",
+    "EXECUTE_RDTSC",
+    "EXECUTE_RSM_IN_SMM",
+    "EXECUTE_VMCALL",
+    "EXECUTE_VMCLEAR",
+    "EXECUTE_VMLAUNCH",
+    "EXECUTE_VMPTRLD",
+    "EXECUTE_VMPTRST",
+    "EXECUTE_VMREAD",
+    "EXECUTE_VMRESUME",
+    "EXECUTE_VMWRITE",
+    "EXECUTE_VMXOFF",
+    "EXECUTE_VMXON",
+    "MOV_CR",
+    "MOV_DR",
+    "EXECUTE_IO_INSTRUCTION",
+    "EXECUTE_RDMSR",
+    "EXECUTE_WRMSR",
+    "ERROR_INVALID_GUEST_STATE",
+    "ERROR_MSR_LOAD",
+    "RESERVED_35",
+    "EXECUTE_MWAIT",
+    "MONITOR_TRAP_FLAG",
+    "RESERVED_38",
+    "EXECUTE_MONITOR",
+    "EXECUTE_PAUSE",
+    "ERROR_MACHINE_CHECK",
+    "RESERVED_42",
+    "TPR_BELOW_THRESHOLD",
+    "APIC_ACCESS",
+    "VIRTUALIZED_EOI",
+    "GDTR_IDTR_ACCESS",
+    "LDTR_TR_ACCESS",
+    "EPT_VIOLATION",
+    "EPT_MISCONFIGURATION",
+    "EXECUTE_INVEPT",
+    "EXECUTE_RDTSCP",
+    "VMX_PREEMPTION_TIMER_EXPIRED",
+    "EXECUTE_INVVPID",
+    "EXECUTE_WBINVD",
+    "EXECUTE_XSETBV",
+    "APIC_WRITE",
+    "EXECUTE_RDRAND",
+    "EXECUTE_INVPCID",
+    "EXECUTE_VMFUNC",
+    "EXECUTE_ENCLS",
+    "EXECUTE_RDSEED",
+    "PAGE_MODIFICATION_LOG_FULL",
+    "EXECUTE_XSAVES",
+    "EXECUTE_XRSTORS",
+    "EXECUTE_PCONFIG",
+    "SPP_RELATED_EVENT",
+    "EXECUTE_UMWAIT",
+    "EXECUTE_TPAUSE",
+    "EXECUTE_LOADIWKEY",
+    "EXECUTE_ENCLV",
+    "RESERVED_71",
+    "ENQCMD_PASID_TRANSLATION_FAILURE",
+    "ENQCMDS_PASID_TRANSLATION_FAILURE",
+    "BUS_LOCK",
+    "INSTRUCTION_TIMEOUT",
+    "EXECUTE_SEAMCALL",
+    "EXECUTE_TDCALL",
+    "EXECUTE_RDMSRLIST",
+    "EXECUTE_WRMSRLIST",
+};
+
+/**
+ * @brief Get the bucket of the histograms for a latency (log2 of the cycles)
+ *
+ * @param Cycles
+ *
+ * @return UINT32 The last bucket also counts all of the larger latencies
+ */
+UINT32
+ExitProfilerGetBucket(UINT64 Cycles)
+{
+    UINT32 Bucket;
+
+    if (Cycles == 0)
+    {
+        return 0;
+    }
+
+#if defined(_MSC_VER)
+    unsigned long Index;
+
+    _BitScanReverse64(&Index, Cycles);
+    Bucket = (UINT32)Index;
+#else
+    Bucket = 63 - (UINT32)__builtin_clzll(Cycles);
+#endif
+
+    if (Bucket >= EXIT_PROFILER_HISTOGRAM_BUCKETS)
+    {
+        Bucket = EXIT_PROFILER_HISTOGRAM_BUCKETS - 1;
+    }
+
+    return Bucket;
+}
+
+/**
+ * @brief Reset the profiler of a core
+ * @details Should be called by the same core (or before the core records any exit)
+ *
+ * @param Core
+ * @param Generation The generation of the statistics after the reset
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerResetCore(PEXIT_PROFILER_CORE Core, UINT64 Generation)
+{
+    memset(&Core->Statistics, 0, sizeof(EXIT_PROFILER_STATISTICS));
+
+    Core->PendingEventCount  = 0;
+    Core->PendingEventCycles = 0;
+    Core->Generation         = Generation;
+}
+
+/**
+ * @brief Add the cycles of the triggered events (and scripts) to the current exit
+ * @details Should be called by the same core that records the exit
+ *
+ * @param Core
+ * @param Cycles
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerAddEventCycles(PEXIT_PROFILER_CORE Core, UINT64 Cycles)
+{
+    Core->PendingEventCount++;
+    Core->PendingEventCycles += Cycles;
+}
+
+/**
+ * @brief Record an exit into the profiler of the current core
+ *
+ * @param Core
+ * @param ExitReason Basic exit reason
+ * @param HandlerCycles Cycles of handling the exit (including its events)
+ * @param Generation The global generation (increased for resetting the profilers)
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerRecordExit(PEXIT_PROFILER_CORE Core, UINT32 ExitReason, UINT64 HandlerCycles, UINT64 Generation)
+{
+    PEXIT_PROFILER_REASON_STATISTICS Reason;
+    UINT64                           EventCount  = Core->PendingEventCount;
+    UINT64                           EventCycles = Core->PendingEventCycles;
+
+    //
+    // The profilers are reset by their own cores, so there is no lock between
+    // the reset and the recorded exits
+    //
+    if (Core->Generation != Generation)
+    {
+        ExitProfilerResetCore(Core, Generation);
+    }
+
+    Core->PendingEventCount  = 0;
+    Core->PendingEventCycles = 0;
+
+    if (ExitReason >= EXIT_PROFILER_MAXIMUM_EXIT_REASONS)
+    {
+        Core->Statistics.UnknownExits++;
+        return;
+    }
+
+    Reason = &Core->Statistics.Reasons[ExitReason];
+
+    Reason->Count++;
+    Reason->HandlerCycles += HandlerCycles;
+    Reason->HandlerHistogram[ExitProfilerGetBucket(HandlerCycles)]++;
+
+    if (EventCount != 0)
+    {
+        Reason->EventCount += EventCount;
+        Reason->EventCycles += EventCycles;
+        Reason->EventHistogram[ExitProfilerGetBucket(EventCycles)]++;
+    }
+}
+
+/**
+ * @brief Copy the statistics of a core (from any core)
+ * @details The statistics are not locked, so a snapshot might miss the exit
+ * that is recorded at the same time
+ *
+ * @param Core
+ * @param Generation The global generation
+ * @param Statistics
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerSnapshot(PEXIT_PROFILER_CORE Core, UINT64 Generation, PEXIT_PROFILER_STATISTICS Statistics)
+{
+    if (Core->Generation != Generation)
+    {
+        //
+        // The core is not recorded any exit since the last reset
+        //
+        memset(Statistics, 0, sizeof(EXIT_PROFILER_STATISTICS));
+        return;
+    }
+
+    memcpy(Statistics, &Core->Statistics, sizeof(EXIT_PROFILER_STATISTICS));
+}
+
+/**
+ * @brief Add the statistics (e.g., of a core) to the total statistics
+ *
+ * @param Total
+ * @param Statistics
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerMerge(PEXIT_PROFILER_STATISTICS Total, const EXIT_PROFILER_STATISTICS * Statistics)
+{
+    for (UINT32 i = 0; i < EXIT_PROFILER_MAXIMUM_EXIT_REASONS; i++)
+    {
+        PEXIT_PROFILER_REASON_STATISTICS        Destination = &Total->Reasons[i];
+        const EXIT_PROFILER_REASON_STATISTICS * Source      = &Statistics->Reasons[i];
+
+        if (Source->Count == 0)
+        {
+            continue;
+        }
+
+        Destination->Count += Source->Count;
+        Destination->HandlerCycles += Source->HandlerCycles;
+        Destination->EventCount += Source->EventCount;
+        Destination->EventCycles += Source->EventCycles;
+
+        for (UINT32 j = 0; j < EXIT_PROFILER_HISTOGRAM_BUCKETS; j++)
+        {
+            Destination->HandlerHistogram[j] += Source->HandlerHistogram[j];
+            Destination->EventHistogram[j] += Source->EventHistogram[j];
+        }
+    }
+
+    Total->UnknownExits += Statistics->UnknownExits;
+}
+
+/**
+ * @brief Compute the statistics of an interval from two snapshots
+ * @details If an exit reason is reset between the snapshots, the current
+ * statistics of the exit reason are the statistics of the interval
+ *
+ * @param Delta
+ * @param Current
+ * @param Previous
+ *
+ * @return VOID
+ */
+VOID
+ExitProfilerDelta(PEXIT_PROFILER_STATISTICS       Delta,
+                  const EXIT_PROFILER_STATISTICS * Current,
+                  const EXIT_PROFILER_STATISTICS * Previous)
+{
+    for (UINT32 i = 0; i < EXIT_PROFILER_MAXIMUM_EXIT_REASONS; i++)
+    {
+        PEXIT_PROFILER_REASON_STATISTICS        Destination = &Delta->Reasons[i];
+        const EXIT_PROFILER_REASON_STATISTICS * After       = &Current->Reasons[i];
+        const EXIT_PROFILER_REASON_STATISTICS * Before      = &Previous->Reasons[i];
+
+        if (After->Count < Before->Count)
+        {
+            memcpy(Destination, After, sizeof(EXIT_PROFILER_REASON_STATISTICS));
+            continue;
+        }
+
+        Destination->Count         = After->Count - Before->Count;
+        Destination->HandlerCycles = After->HandlerCycles - Before->HandlerCycles;
+        Destination->EventCount    = After->EventCount - Before->EventCount;
+        Destination->EventCycles   = After->EventCycles - Before->EventCycles;
+
+        for (UINT32 j = 0; j < EXIT_PROFILER_HISTOGRAM_BUCKETS; j++)
+        {
+            Destination->HandlerHistogram[j] = After->HandlerHistogram[j] - Before->HandlerHistogram[j];
+            Destination->EventHistogram[j]   = After->EventHistogram[j] - Before->EventHistogram[j];
+        }
+    }
+
+    Delta->UnknownExits = Current->UnknownExits >= Previous->UnknownExits ? Current->UnknownExits - Previous->UnknownExits
+                                                                          : Current->UnknownExits;
+}
+
+/**
+ * @brief Estimate a percentile of the latencies from a histogram
+ *
+ * @param Histogram
+ * @param Percent
+ *
+ * @return UINT64 The upper bound of the bucket of the percentile (zero if
+ * the histogram is empty)
+ */
+UINT64
+ExitProfilerPercentile(const UINT32 * Histogram, UINT32 Percent)
+{
+    UINT64 Total      = 0;
+    UINT64 Cumulative = 0;
+    UINT64 Target;
+
+    for (UINT32 i = 0; i < EXIT_PROFILER_HISTOGRAM_BUCKETS; i++)
+    {
+        Total += Histogram[i];
+    }
+
+    if (Total == 0)
+    {
+        return 0;
+    }
+
+    //
+    // The rank of the percentile (at least the first sample)
+    //
+    Target = (Total * Percent + 99) / 100;
+
+    if (Target == 0)
+    {
+        Target = 1;
+    }
+
+    for (UINT32 i = 0; i < EXIT_PROFILER_HISTOGRAM_BUCKETS; i++)
+    {
+        Cumulative += Histogram[i];
+
+        if (Cumulative >= Target)
+        {
+            return ((UINT64)1 << (i + 1)) - 1;
+        }
+    }
+
+    return ((UINT64)1 << EXIT_PROFILER_HISTOGRAM_BUCKETS) - 1;
+}
+
+/**
+ * @brief Compute the rows of the exit reasons (sorted by the handler cycles)
+ *
+ * @param Statistics
+ * @param Rows
+ * @param MaximumRows
+ *
+ * @return UINT32 Count of the rows (the exit reasons without any exit are skipped)
+ */
+UINT32
+ExitProfilerBuildRows(const EXIT_PROFILER_STATISTICS * Statistics, PEXIT_PROFILER_ROW Rows, UINT32 MaximumRows)
+{
+    UINT64 TotalCount   = 0;
+    UINT64 TotalCycles  = 0;
+    UINT32 NumberOfRows = 0;
+
+    for (UINT32 i = 0; i < EXIT_PROFILER_MAXIMUM_EXIT_REASONS; i++)
+    {
+        TotalCount += Statistics->Reasons[i].Count;
+        TotalCycles += Statistics->Reasons[i].HandlerCycles;
+    }
+
+    for (UINT32 i = 0; i < EXIT_PROFILER_MAXIMUM_EXIT_REASONS && NumberOfRows < MaximumRows; i++)
+    {
+        const EXIT_PROFILER_REASON_STATISTICS * Reason = &Statistics->Reasons[i];
+        EXIT_PROFILER_ROW                       Row;
+        UINT32                                  Position;
+
+        if (Reason->Count == 0)
+        {
+            continue;
+        }
+
+        Row.ExitReason     = i;
+        Row.Count          = Reason->Count;
+        Row.HandlerCycles  = Reason->HandlerCycles;
+        Row.AverageCycles  = Reason->HandlerCycles / Reason->Count;
+        Row.MedianCycles   = ExitProfilerPercentile(Reason->HandlerHistogram, 50);
+        Row.P99Cycles      = ExitProfilerPercentile(Reason->HandlerHistogram, 99);
+        Row.EventCount     = Reason->EventCount;
+        Row.EventCycles    = Reason->EventCycles;
+        Row.EventP99Cycles = ExitProfilerPercentile(Reason->EventHistogram, 99);
+        Row.CountPermille  = (UINT32)(Reason->Count * 1000 / TotalCount);
+        Row.CyclesPermille = TotalCycles == 0 ? 0 : (UINT32)(Reason->HandlerCycles * 1000 / TotalCycles);
+
+        //
+        // Insert the row (there are only a few exit reasons)
+        //
+        Position = NumberOfRows;
+
+        while (Position != 0 && Rows[Position - 1].HandlerCycles < Row.HandlerCycles)
+        {
+            Rows[Position] = Rows[Position - 1];
+            Position--;
+        }
+
+        Rows[Position] = Row;
+        NumberOfRows++;
+    }
+
+    return NumberOfRows;
+}
+
+/**
+ * @brief Get the name of an exit reason
+ *
+ * @param ExitReason
+ *
+ * @return const CHAR *
+ */
+const CHAR *
+ExitProfilerGetReasonName(UINT32 ExitReason)
+{
+    if (ExitReason >= EXIT_PROFILER_MAXIMUM_EXIT_REASONS)
+    {
+        return "UNKNOWN";
+    }
+
+    return ExitProfilerReasonNames[ExitReason];
+}
+
+/**
+ * @brief Write the statistics of the cores as a dump
+ *
+ * @param Cores
+ * @param NumberOfCores
+ * @param Write
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+ExitProfilerWriteDump(const EXIT_PROFILER_STATISTICS * Cores,
+                      UINT32                           NumberOfCores,
+                      EXIT_PROFILER_WRITE              Write,
+                      PVOID                            Context)
+{
+    EXIT_PROFILER_DUMP_HEADER Header;
+
+    memset(&Header, 0, sizeof(Header));
+
+    Header.Magic           = EXIT_PROFILER_DUMP_MAGIC;
+    Header.Version         = EXIT_PROFILER_DUMP_VERSION;
+    Header.NumberOfCores   = NumberOfCores;
+    Header.NumberOfReasons = EXIT_PROFILER_MAXIMUM_EXIT_REASONS;
+    Header.NumberOfBuckets = EXIT_PROFILER_HISTOGRAM_BUCKETS;
+
+    if (!Write(Context, &Header, sizeof(Header)))
+    {
+        return FALSE;
+    }
+
+    return Write(Context, Cores, (UINT64)NumberOfCores * sizeof(EXIT_PROFILER_STATISTICS));
+}
+
+/**
+ * @brief Read the statistics of the cores from a dump
+ *
+ * @param Dump
+ * @param DumpSize
+ * @param NumberOfCores Count of the cores of the dump
+ * @param Cores The statistics of the cores (if NULL, only the dump is validated)
+ *
+ * @return BOOLEAN FALSE if the dump is not valid
+ */
+BOOLEAN
+ExitProfilerReadDump(const VOID * Dump, UINT64 DumpSize, UINT32 * NumberOfCores, PEXIT_PROFILER_STATISTICS Cores)
+{
+    EXIT_PROFILER_DUMP_HEADER Header;
+
+    if (DumpSize < sizeof(Header))
+    {
+        return FALSE;
+    }
+
+    memcpy(&Header, Dump, sizeof(Header));
+
+    if (Header.Magic != EXIT_PROFILER_DUMP_MAGIC || Header.Version != EXIT_PROFILER_DUMP_VERSION ||
+        Header.NumberOfReasons != EXIT_PROFILER_MAXIMUM_EXIT_REASONS ||
+        Header.NumberOfBuckets != EXIT_PROFILER_HISTOGRAM_BUCKETS || Header.NumberOfCores == 0 ||
+        (DumpSize - sizeof(Header)) / sizeof(EXIT_PROFILER_STATISTICS) < Header.NumberOfCores)
+    {
+        return FALSE;
+    }
+
+    *NumberOfCores = Header.NumberOfCores;
+
+    if (Cores != NULL)
+    {
+        memcpy(Cores, (const UINT8 *)Dump + sizeof(Header), (SIZE_T)Header.NumberOfCores * sizeof(EXIT_PROFILER_STATISTICS));
+    }
+
+    return TRUE;
+}
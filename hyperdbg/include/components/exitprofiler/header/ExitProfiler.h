@@ -0,0 +1,141 @@
+/**
+ * @file ExitProfiler.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for profiling the latency of the vm-exits (per exit reason)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Magic of the dumps of the vm-exit profiler ('HDXP')
+ *
+ */
+#define EXIT_PROFILER_DUMP_MAGIC 0x50584448
+
+/**
+ * @brief Version of the format of the dumps of the vm-exit profiler
+ *
+ */
+#define EXIT_PROFILER_DUMP_VERSION 1
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The profiler of a single core
+ *
+ * @details Each core only records into its own profiler (no lock), the
+ * statistics are reset lazily by the core itself whenever the generation of
+ * the profiler is not the same as the global generation, and the cycles of
+ * the events are kept as pending until the exit is recorded
+ *
+ */
+typedef struct _EXIT_PROFILER_CORE
+{
+    EXIT_PROFILER_STATISTICS Statistics;
+    volatile UINT64          Generation;
+    UINT64                   PendingEventCount;  // events of the current exit
+    UINT64                   PendingEventCycles; // cycles of the events of the current exit
+
+} EXIT_PROFILER_CORE, *PEXIT_PROFILER_CORE;
+
+/**
+ * @brief A computed row of the statistics of an exit reason
+ *
+ * @details The percentiles are the upper bounds of the buckets of the
+ * histograms, and the permilles are relative to all of the exits
+ *
+ */
+typedef struct _EXIT_PROFILER_ROW
+{
+    UINT32 ExitReason;
+    UINT32 CountPermille;
+    UINT32 CyclesPermille;
+    UINT64 Count;
+    UINT64 HandlerCycles;
+    UINT64 AverageCycles;
+    UINT64 MedianCycles;
+    UINT64 P99Cycles;
+    UINT64 EventCount;
+    UINT64 EventCycles;
+    UINT64 EventP99Cycles;
+
+} EXIT_PROFILER_ROW, *PEXIT_PROFILER_ROW;
+
+/**
+ * @brief Header of a dump of the vm-exit profiler
+ *
+ * @details The header is followed by an EXIT_PROFILER_STATISTICS for each core
+ *
+ */
+typedef struct _EXIT_PROFILER_DUMP_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT32 NumberOfCores;
+    UINT32 NumberOfReasons;
+    UINT32 NumberOfBuckets;
+    UINT32 Reserved;
+
+} EXIT_PROFILER_DUMP_HEADER, *PEXIT_PROFILER_DUMP_HEADER;
+
+/**
+ * @brief Write a part of the dump (returns FALSE on failure)
+ *
+ */
+typedef BOOLEAN (*EXIT_PROFILER_WRITE)(PVOID Context, const VOID * Buffer, UINT64 Size);
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT32
+ExitProfilerGetBucket(UINT64 Cycles);
+
+VOID
+ExitProfilerResetCore(PEXIT_PROFILER_CORE Core, UINT64 Generation);
+
+VOID
+ExitProfilerAddEventCycles(PEXIT_PROFILER_CORE Core, UINT64 Cycles);
+
+VOID
+ExitProfilerRecordExit(PEXIT_PROFILER_CORE Core, UINT32 ExitReason, UINT64 HandlerCycles, UINT64 Generation);
+
+VOID
+ExitProfilerSnapshot(PEXIT_PROFILER_CORE Core, UINT64 Generation, PEXIT_PROFILER_STATISTICS Statistics);
+
+VOID
+ExitProfilerMerge(PEXIT_PROFILER_STATISTICS Total, const EXIT_PROFILER_STATISTICS * Statistics);
+
+VOID
+ExitProfilerDelta(PEXIT_PROFILER_STATISTICS       Delta,
+                  const EXIT_PROFILER_STATISTICS * Current,
+                  const EXIT_PROFILER_STATISTICS * Previous);
+
+UINT64
+ExitProfilerPercentile(const UINT32 * Histogram, UINT32 Percent);
+
+UINT32
+ExitProfilerBuildRows(const EXIT_PROFILER_STATISTICS * Statistics, PEXIT_PROFILER_ROW Rows, UINT32 MaximumRows);
+
+const CHAR *
+ExitProfilerGetReasonName(UINT32 ExitReason);
+
+BOOLEAN
+ExitProfilerWriteDump(const EXIT_PROFILER_STATISTICS * Cores,
+                      UINT32                           NumberOfCores,
+                      EXIT_PROFILER_WRITE              Write,
+                      PVOID                            Context);
+
+BOOLEAN
+ExitProfilerReadDump(const VOID * Dump, UINT64 DumpSize, UINT32 * NumberOfCores, PEXIT_PROFILER_STATISTICS Cores);
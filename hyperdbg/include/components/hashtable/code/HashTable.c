@@ -0,0 +1,327 @@
+/**
+ * @file HashTable.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Open-addressing hash tables (lookups without locks)
+ * @details The tables don't allocate any memory, the caller gives a
+ * pre-allocated buffer to the table, so they could be used in vmx-root
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the first slot of a key
+ *
+ * @param Table
+ * @param Key
+ *
+ * @return UINT32
+ */
+static UINT32
+HashTableGetSlot(PHASH_TABLE Table, UINT64 Key)
+{
+    Key ^= Key >> 33;
+    Key *= 0xff51afd7ed558ccdull;
+    Key ^= Key >> 33;
+
+    return (UINT32)Key & (Table->Capacity - 1);
+}
+
+/**
+ * @brief Initialize a table in a buffer
+ *
+ * @param Buffer A zeroed buffer with the size of HASH_TABLE_SIZE(Capacity)
+ * @param Capacity Count of the slots (a power of two)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HashTableInitialize(PVOID Buffer, UINT32 Capacity)
+{
+    PHASH_TABLE Table = (PHASH_TABLE)Buffer;
+
+    if (Buffer == NULL || Capacity == 0 || (Capacity & (Capacity - 1)) != 0)
+    {
+        return FALSE;
+    }
+
+    Table->Capacity   = Capacity;
+    Table->Count      = 0;
+    Table->UsedSlots  = 0;
+    Table->Overflowed = FALSE;
+    Table->Slots      = (PHASH_TABLE_SLOT)(Table + 1);
+
+    for (UINT32 i = 0; i < Capacity; i++)
+    {
+        Table->Slots[i].Key   = HASH_TABLE_EMPTY_SLOT;
+        Table->Slots[i].Value = 0;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Add an entry to the table (or change the value of the key)
+ * @details Only a single writer should change the table at a time
+ *
+ * @param Table
+ * @param Key Any value except 0xfffffffffffffffe and 0xffffffffffffffff
+ * @param Value A non-zero value
+ *
+ * @return BOOLEAN FALSE if the table is full (the table is marked as overflowed)
+ */
+BOOLEAN
+HashTableInsert(PHASH_TABLE Table, UINT64 Key, UINT64 Value)
+{
+    UINT64           StoredKey = Key + 1;
+    UINT32           Index     = HashTableGetSlot(Table, Key);
+    PHASH_TABLE_SLOT Removed   = NULL;
+    PHASH_TABLE_SLOT Slot      = &Table->Slots[Index];
+
+    if (Value == 0 || StoredKey == HASH_TABLE_EMPTY_SLOT || StoredKey == HASH_TABLE_REMOVED_SLOT)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Table->Capacity; i++)
+    {
+        Slot = &Table->Slots[(Index + i) & (Table->Capacity - 1)];
+
+        if (Slot->Key == StoredKey)
+        {
+            AtomicStoreRelease64(&Slot->Value, Value);
+            return TRUE;
+        }
+
+        if (Slot->Key == HASH_TABLE_REMOVED_SLOT && Removed == NULL)
+        {
+            Removed = Slot;
+        }
+        else if (Slot->Key == HASH_TABLE_EMPTY_SLOT)
+        {
+            break;
+        }
+    }
+
+    //
+    // Reuse a removed slot, or use a new slot if the table is not too full
+    //
+    if (Removed != NULL)
+    {
+        Slot = Removed;
+    }
+    else if (Slot->Key == HASH_TABLE_EMPTY_SLOT &&
+             (UINT64)(Table->UsedSlots + 1) * 100 <= (UINT64)Table->Capacity * HASH_TABLE_MAXIMUM_LOAD)
+    {
+        Table->UsedSlots++;
+    }
+    else
+    {
+        Table->Overflowed = TRUE;
+        return FALSE;
+    }
+
+    //
+    // The value is published before the key
+    //
+    AtomicStoreRelease64(&Slot->Value, Value);
+    AtomicStoreRelease64(&Slot->Key, StoredKey);
+
+    Table->Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Remove an entry from the table
+ * @details Only a single writer should change the table at a time
+ *
+ * @param Table
+ * @param Key
+ *
+ * @return BOOLEAN FALSE if the key is not found
+ */
+BOOLEAN
+HashTableRemove(PHASH_TABLE Table, UINT64 Key)
+{
+    UINT64           StoredKey = Key + 1;
+    UINT32           Index     = HashTableGetSlot(Table, Key);
+    PHASH_TABLE_SLOT Slot;
+
+    for (UINT32 i = 0; i < Table->Capacity; i++)
+    {
+        Slot = &Table->Slots[(Index + i) & (Table->Capacity - 1)];
+
+        if (Slot->Key == HASH_TABLE_EMPTY_SLOT)
+        {
+            break;
+        }
+
+        if (Slot->Key == StoredKey)
+        {
+            AtomicStoreRelease64(&Slot->Value, 0);
+            AtomicStoreRelease64(&Slot->Key, HASH_TABLE_REMOVED_SLOT);
+
+            Table->Count--;
+
+            //
+            // Once the table is empty, none of the readers could find
+            // anything, so the removed slots are cleared
+            //
+            if (Table->Count == 0)
+            {
+                for (UINT32 j = 0; j < Table->Capacity; j++)
+                {
+                    AtomicStoreRelease64(&Table->Slots[j].Key, HASH_TABLE_EMPTY_SLOT);
+                }
+
+                Table->UsedSlots = 0;
+            }
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Find the value of a key
+ * @details Could be called at the same time as the writer changes the table
+ *
+ * @param Table
+ * @param Key
+ *
+ * @return UINT64 The value of the key (or zero if the key is not found)
+ */
+UINT64
+HashTableFind(PHASH_TABLE Table, UINT64 Key)
+{
+    UINT64           StoredKey = Key + 1;
+    UINT32           Index     = HashTableGetSlot(Table, Key);
+    UINT64           CurrentKey;
+    UINT64           Value;
+    PHASH_TABLE_SLOT Slot;
+
+    for (UINT32 i = 0; i < Table->Capacity; i++)
+    {
+        Slot       = &Table->Slots[(Index + i) & (Table->Capacity - 1)];
+        CurrentKey = AtomicLoadAcquire64(&Slot->Key);
+
+        if (CurrentKey == HASH_TABLE_EMPTY_SLOT)
+        {
+            break;
+        }
+
+        if (CurrentKey == StoredKey)
+        {
+            Value = AtomicLoadAcquire64(&Slot->Value);
+
+            //
+            // Make sure that the slot is not reused for another key
+            //
+            if (AtomicLoadAcquire64(&Slot->Key) == StoredKey)
+            {
+                return Value;
+            }
+
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether the table has all of the entries (it's not overflowed)
+ *
+ * @param Table
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HashTableIsReliable(PHASH_TABLE Table)
+{
+    return Table != NULL && !Table->Overflowed;
+}
+
+/**
+ * @brief Get the table of a reference to look it up
+ * @details The table should be released by HashTableReleaseReference with
+ * the same epoch, a reader never waits for the writer
+ *
+ * @param Reference
+ * @param Epoch The epoch that the reader is counted in
+ *
+ * @return PHASH_TABLE The table (or NULL if the reference has no table)
+ */
+PHASH_TABLE
+HashTableAcquireReference(PHASH_TABLE_REFERENCE Reference, LONG * Epoch)
+{
+    *Epoch = AtomicLoadAcquire32(&Reference->Epoch) & 1;
+
+    AtomicIncrement(&Reference->Readers[*Epoch]);
+
+    //
+    // The table is read by an interlocked operation (a full barrier), so it's
+    // read after the reader is counted
+    //
+    return (PHASH_TABLE)AtomicCompareExchangePointer((PVOID volatile *)&Reference->Table, NULL, NULL);
+}
+
+/**
+ * @brief Finish a lookup of the table of a reference
+ *
+ * @param Reference
+ * @param Epoch The epoch that is returned by HashTableAcquireReference
+ *
+ * @return VOID
+ */
+VOID
+HashTableReleaseReference(PHASH_TABLE_REFERENCE Reference, LONG Epoch)
+{
+    AtomicDecrement(&Reference->Readers[Epoch]);
+}
+
+/**
+ * @brief Replace the table of a reference and wait for the readers that
+ * might still read the previous table
+ * @details Only a single writer should replace the table at a time, and it
+ * shouldn't be called from a reader (or with the readers stopped on the
+ * same core)
+ *
+ * @param Reference
+ * @param NewTable
+ *
+ * @return PHASH_TABLE The previous table (no reader uses it anymore, so it
+ * could be freed)
+ */
+PHASH_TABLE
+HashTableReplaceReference(PHASH_TABLE_REFERENCE Reference, PHASH_TABLE NewTable)
+{
+    PHASH_TABLE PreviousTable;
+    LONG        Epoch;
+
+    PreviousTable = (PHASH_TABLE)AtomicExchangePointer((PVOID volatile *)&Reference->Table, NewTable);
+
+    //
+    // A reader that read the previous table was counted before the table is
+    // replaced, but it might have read the epoch long before that, so the
+    // readers of both epochs are waited for (the new readers are counted in
+    // the other epoch, so the waits are finished)
+    //
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        Epoch = AtomicExchange(&Reference->Epoch, (Reference->Epoch + 1) & 1) & 1;
+
+        while (AtomicLoadAcquire32(&Reference->Readers[Epoch]) != 0)
+        {
+            AtomicPause();
+        }
+    }
+
+    return PreviousTable;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file HashTable.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the open-addressing hash tables (lookups without locks)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The slot was never used (the probing stops at it)
+ *
+ */
+#define HASH_TABLE_EMPTY_SLOT 0
+
+/**
+ * @brief The entry of the slot is removed (the probing continues after it)
+ *
+ */
+#define HASH_TABLE_REMOVED_SLOT 0xffffffffffffffff
+
+/**
+ * @brief Maximum count of the used slots of a table (in percent)
+ *
+ */
+#define HASH_TABLE_MAXIMUM_LOAD 75
+
+/**
+ * @brief Size of a table (including its slots) for a number of slots
+ *
+ */
+#define HASH_TABLE_SIZE(Capacity) (sizeof(HASH_TABLE) + (Capacity) * sizeof(HASH_TABLE_SLOT))
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A slot of the table
+ *
+ */
+typedef struct _HASH_TABLE_SLOT
+{
+    volatile UINT64 Key;   // key + 1 (or one of the special values)
+    volatile UINT64 Value; // never zero for the entries of the table
+
+} HASH_TABLE_SLOT, *PHASH_TABLE_SLOT;
+
+/**
+ * @brief A table of non-zero values (e.g., pointers) with UINT64 keys
+ *
+ * @details The table is changed by a single writer at a time and is read
+ * without any lock (e.g., from all of the cores in vmx-root). The value of
+ * an entry is written before its key, and the key is checked again after
+ * reading the value, so a reader never gets the value of another key. The
+ * removed slots are reused for the new entries and are cleared once the
+ * table becomes empty. If the table gets full, it is marked as overflowed
+ * (until it's initialized again) and the caller should use its own (slower)
+ * way of finding the entries
+ *
+ */
+typedef struct _HASH_TABLE
+{
+    UINT32  Capacity;   // count of the slots (a power of two)
+    UINT32  Count;      // count of the entries
+    UINT32  UsedSlots;  // count of the slots that are not empty (entries and removed slots)
+    BOOLEAN Overflowed; // an entry couldn't be added to the table
+
+    PHASH_TABLE_SLOT Slots;
+
+} HASH_TABLE, *PHASH_TABLE;
+
+/**
+ * @brief A table that could be replaced (e.g., rebuilt with more slots)
+ * while the readers look it up
+ *
+ * @details The readers count themselves in one of the two counters (the
+ * counter of the current epoch) before reading the table, and the writer
+ * flips the epoch twice after replacing the table and waits for the readers
+ * of each epoch, so the previous table is freed only after all of the
+ * readers that might have read it are finished (the readers never wait)
+ *
+ */
+typedef struct _HASH_TABLE_REFERENCE
+{
+    PHASH_TABLE volatile Table;
+    volatile LONG        Epoch;
+    volatile LONG        Readers[2];
+
+} HASH_TABLE_REFERENCE, *PHASH_TABLE_REFERENCE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+HashTableInitialize(PVOID Buffer, UINT32 Capacity);
+
+BOOLEAN
+HashTableInsert(PHASH_TABLE Table, UINT64 Key, UINT64 Value);
+
+BOOLEAN
+HashTableRemove(PHASH_TABLE Table, UINT64 Key);
+
+UINT64
+HashTableFind(PHASH_TABLE Table, UINT64 Key);
+
+BOOLEAN
+HashTableIsReliable(PHASH_TABLE Table);
+
+PHASH_TABLE
+HashTableAcquireReference(PHASH_TABLE_REFERENCE Reference, LONG * Epoch);
+
+VOID
+HashTableReleaseReference(PHASH_TABLE_REFERENCE Reference, LONG Epoch);
+
+PHASH_TABLE
+HashTableReplaceReference(PHASH_TABLE_REFERENCE Reference, PHASH_TABLE NewTable);
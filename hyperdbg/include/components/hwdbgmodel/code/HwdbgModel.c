@@ -0,0 +1,1109 @@
+/**
+ * @file HwdbgModel.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Cycle-level software model of the hwdbg script stages
+ * @details The model has the same registers as the script execution engine of
+ * the chip (exec.scala, eval.scala, get_value.scala, and set_value.scala) and
+ * is configured by the same script buffers (script_buffer_handler.scala), so
+ * the scripts can be tested and the trade-off between the number of stages and
+ * the latency can be measured on the host without synthesizing an instance.
+ * Each call to HwdbgModelClock is a clock of the chip. The registers without a
+ * reset value start from zero, and a division (or modulo) by zero results in
+ * zero (both of them are undefined in the chip)
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Same as log2Ceil of Chisel (the width of a value that holds a
+ * number from 0 to Count - 1, which is zero for a single value)
+ *
+ * @param Count
+ *
+ * @return UINT32
+ */
+static UINT32
+HwdbgModelLog2Ceil(UINT64 Count)
+{
+    UINT32 Width = 0;
+
+    while (Width < 64 && (1ull << Width) < Count)
+    {
+        Width++;
+    }
+
+    return Width;
+}
+
+/**
+ * @brief Get the mask of a value with the given width
+ *
+ * @param Width
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgModelMask(UINT32 Width)
+{
+    return Width >= 64 ? ~0ull : ((1ull << Width) - 1);
+}
+
+/**
+ * @brief Check the instance info (only the instances that can be generated
+ * by the Chisel design are supported)
+ *
+ * @param InstanceInfo
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+HwdbgModelIsInstanceSupported(const HWDBG_INSTANCE_INFORMATION * InstanceInfo)
+{
+    //
+    // The first and the last stages only hold the input and the output pins,
+    // so at least two stages are needed
+    //
+    if (InstanceInfo->maximumNumberOfStages < 2 ||
+        InstanceInfo->maximumNumberOfStages > 0x10000 ||
+        InstanceInfo->numberOfPins == 0 ||
+        InstanceInfo->numberOfPins > 0x10000 ||
+        InstanceInfo->numberOfPorts > InstanceInfo->numberOfPins ||
+        InstanceInfo->maximumNumberOfSupportedGetScriptOperators == 0 ||
+        InstanceInfo->maximumNumberOfSupportedGetScriptOperators > 0x100 ||
+        InstanceInfo->maximumNumberOfSupportedSetScriptOperators == 0 ||
+        InstanceInfo->maximumNumberOfSupportedSetScriptOperators > 0x100 ||
+        InstanceInfo->numberOfSupportedLocalAndGlobalVariables > 0x10000 ||
+        InstanceInfo->numberOfSupportedTemporaryVariables > 0x10000)
+    {
+        return FALSE;
+    }
+
+    //
+    // Each field of the script buffer is a single read of the BRAM
+    //
+    if (InstanceInfo->scriptVariableLength < 8 ||
+        InstanceInfo->scriptVariableLength > 64 ||
+        InstanceInfo->bramDataWidth < InstanceInfo->scriptVariableLength ||
+        InstanceInfo->bramDataWidth > 64)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the size of the buffer that holds the registers of the model
+ *
+ * @param InstanceInfo
+ *
+ * @return SIZE_T zero if the instance is not supported
+ */
+SIZE_T
+HwdbgModelGetBufferSize(const HWDBG_INSTANCE_INFORMATION * InstanceInfo)
+{
+    SIZE_T NumberOfStages   = InstanceInfo->maximumNumberOfStages;
+    SIZE_T NumberOfPinWords = HWDBG_MODEL_PIN_WORDS(InstanceInfo->numberOfPins);
+    SIZE_T NumberOfOperands = InstanceInfo->maximumNumberOfSupportedGetScriptOperators +
+                              InstanceInfo->maximumNumberOfSupportedSetScriptOperators;
+    SIZE_T NumberOfValues   = NumberOfPinWords +
+                            InstanceInfo->numberOfSupportedTemporaryVariables +
+                            InstanceInfo->numberOfSupportedLocalAndGlobalVariables;
+
+    if (!HwdbgModelIsInstanceSupported(InstanceInfo))
+    {
+        return 0;
+    }
+
+    //
+    // The stages, the operands of the stages, the registers of the stages, the
+    // pins of the configuration, and the ports (in the order of the alignment)
+    //
+    return NumberOfStages * sizeof(HWDBG_MODEL_STAGE) +
+           NumberOfStages * NumberOfOperands * sizeof(HWDBG_SHORT_SYMBOL) +
+           (NumberOfStages * NumberOfValues + NumberOfPinWords) * sizeof(UINT64) +
+           InstanceInfo->numberOfPorts * sizeof(UINT32);
+}
+
+/**
+ * @brief Initialize the model of an instance (all of the registers are
+ * zero and the stages are not configured)
+ *
+ * @param Model
+ * @param InstanceInfo
+ * @param PortsConfiguration The size of each port (numberOfPorts entries)
+ * @param Buffer A buffer of HwdbgModelGetBufferSize bytes (8-byte aligned)
+ * @param BufferSize
+ *
+ * @return BOOLEAN FALSE if the instance is not supported
+ */
+BOOLEAN
+HwdbgModelInitialize(HWDBG_MODEL *                      Model,
+                     const HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                     const UINT32 *                     PortsConfiguration,
+                     PVOID                              Buffer,
+                     SIZE_T                             BufferSize)
+{
+    SIZE_T   NeededSize     = HwdbgModelGetBufferSize(InstanceInfo);
+    UINT32   NumberOfStages = InstanceInfo->maximumNumberOfStages;
+    UINT64   SumOfPorts     = 0;
+    BYTE *   Current        = (BYTE *)Buffer;
+    UINT64 * Values         = NULL;
+
+    if (NeededSize == 0 || BufferSize < NeededSize || (InstanceInfo->numberOfPorts != 0 && PortsConfiguration == NULL))
+    {
+        return FALSE;
+    }
+
+    //
+    // The ports are the slices of the pins (from the first pin)
+    //
+    for (UINT32 i = 0; i < InstanceInfo->numberOfPorts; i++)
+    {
+        if (PortsConfiguration[i] == 0)
+        {
+            return FALSE;
+        }
+
+        SumOfPorts += PortsConfiguration[i];
+    }
+
+    if (SumOfPorts > InstanceInfo->numberOfPins)
+    {
+        return FALSE;
+    }
+
+    memset(Model, 0, sizeof(HWDBG_MODEL));
+    memset(Buffer, 0, NeededSize);
+
+    Model->InstanceInfo     = *InstanceInfo;
+    Model->NumberOfPinWords = HWDBG_MODEL_PIN_WORDS(InstanceInfo->numberOfPins);
+    Model->ValueMask        = HwdbgModelMask(InstanceInfo->scriptVariableLength);
+    Model->StageIndexMask   = HwdbgModelMask(HwdbgModelLog2Ceil((UINT64)NumberOfStages *
+                                                              (InstanceInfo->maximumNumberOfSupportedGetScriptOperators +
+                                                               InstanceInfo->maximumNumberOfSupportedSetScriptOperators + 1)));
+    Model->ConfigState      = HWDBG_MODEL_CONFIG_STAGE_SYMBOL;
+
+    Model->Stages = (HWDBG_MODEL_STAGE *)Current;
+    Current += NumberOfStages * sizeof(HWDBG_MODEL_STAGE);
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        Model->Stages[i].GetOperatorSymbols = (HWDBG_SHORT_SYMBOL *)Current;
+        Current += InstanceInfo->maximumNumberOfSupportedGetScriptOperators * sizeof(HWDBG_SHORT_SYMBOL);
+
+        Model->Stages[i].SetOperatorSymbols = (HWDBG_SHORT_SYMBOL *)Current;
+        Current += InstanceInfo->maximumNumberOfSupportedSetScriptOperators * sizeof(HWDBG_SHORT_SYMBOL);
+    }
+
+    Values = (UINT64 *)Current;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        Model->Stages[i].PinValues = Values;
+        Values += Model->NumberOfPinWords;
+
+        Model->Stages[i].TempVariables = Values;
+        Values += InstanceInfo->numberOfSupportedTemporaryVariables;
+
+        Model->Stages[i].LocalGlobalVariables = Values;
+        Values += InstanceInfo->numberOfSupportedLocalAndGlobalVariables;
+    }
+
+    Model->ZeroPins = Values;
+    Values += Model->NumberOfPinWords;
+
+    Model->PortsConfiguration = (UINT32 *)Values;
+
+    if (InstanceInfo->numberOfPorts != 0)
+    {
+        memcpy(Model->PortsConfiguration, PortsConfiguration, InstanceInfo->numberOfPorts * sizeof(UINT32));
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the number of clocks from a pin change on the input pins to the
+ * output pins
+ *
+ * @details The first stage holds the input pins and the output pins are the
+ * stage before the last stage, so the stages between them evaluate the script
+ *
+ * @param Model
+ *
+ * @return UINT32
+ */
+UINT32
+HwdbgModelGetLatency(const HWDBG_MODEL * Model)
+{
+    return Model->InstanceInfo.maximumNumberOfStages - 1;
+}
+
+/**
+ * @brief Get the index of an element of a vector of registers (the index is
+ * truncated to the width of the index of the vector the same as Chisel)
+ *
+ * @param Value
+ * @param Size
+ * @param Index
+ *
+ * @return BOOLEAN FALSE if the element is not in the vector (the value of
+ * the element is undefined in the chip, a read is zero and a write is ignored)
+ */
+static BOOLEAN
+HwdbgModelGetVectorIndex(UINT64 Value, UINT32 Size, UINT32 * Index)
+{
+    UINT64 Truncated = Value & HwdbgModelMask(HwdbgModelLog2Ceil(Size));
+
+    if (Truncated >= Size)
+    {
+        return FALSE;
+    }
+
+    *Index = (UINT32)Truncated;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the bits of the pins (at most 64 bits)
+ *
+ * @param Pins
+ * @param Low
+ * @param Width
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgModelGetPins(const UINT64 * Pins, UINT32 Low, UINT32 Width)
+{
+    UINT64 Value = 0;
+
+    for (UINT32 i = 0; i < Width && i < 64; i++)
+    {
+        Value |= ((Pins[(Low + i) / 64] >> ((Low + i) % 64)) & 1) << i;
+    }
+
+    return Value;
+}
+
+/**
+ * @brief Set the bits of the pins (the bits above the first 64 bits are zero)
+ *
+ * @param Pins
+ * @param Low
+ * @param Width
+ * @param Value
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgModelSetPins(UINT64 * Pins, UINT32 Low, UINT32 Width, UINT64 Value)
+{
+    for (UINT32 i = 0; i < Width; i++)
+    {
+        UINT64 Bit = i < 64 ? (Value >> i) & 1 : 0;
+
+        Pins[(Low + i) / 64] = (Pins[(Low + i) / 64] & ~(1ull << ((Low + i) % 64))) | (Bit << ((Low + i) % 64));
+    }
+}
+
+/**
+ * @brief Get the value of a GET operand (ScriptEngineGetValue)
+ *
+ * @param Model
+ * @param Stage
+ * @param Symbol
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgModelGetValue(const HWDBG_MODEL * Model, const HWDBG_MODEL_STAGE * Stage, const HWDBG_SHORT_SYMBOL * Symbol)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo = &Model->InstanceInfo;
+    UINT32                             Index        = 0;
+    UINT32                             Low          = 0;
+    UINT64                             Value        = Symbol->Value;
+
+    switch (Symbol->Type & HwdbgModelMask(HWDBG_MODEL_SYMBOL_TYPE_WIDTH))
+    {
+    case SYMBOL_GLOBAL_ID_TYPE:
+    case SYMBOL_LOCAL_ID_TYPE:
+
+        if (InstanceInfo->scriptCapabilities.assign_local_global_var &&
+            HwdbgModelGetVectorIndex(Value, InstanceInfo->numberOfSupportedLocalAndGlobalVariables, &Index))
+        {
+            return Stage->LocalGlobalVariables[Index];
+        }
+
+        return 0;
+
+    case SYMBOL_NUM_TYPE:
+
+        return Value;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        if (!InstanceInfo->scriptCapabilities.assign_registers)
+        {
+            return 0;
+        }
+
+        if (Value < InstanceInfo->numberOfPins)
+        {
+            return HwdbgModelGetPins(Stage->PinValues, (UINT32)Value, 1);
+        }
+
+        //
+        // The ports are the slices of the pins, truncated to the length of the
+        // script variables
+        //
+        if (!HwdbgModelGetVectorIndex((Value - InstanceInfo->numberOfPins) & Model->ValueMask, InstanceInfo->numberOfPorts, &Index))
+        {
+            return 0;
+        }
+
+        for (UINT32 i = 0; i < Index; i++)
+        {
+            Low += Model->PortsConfiguration[i];
+        }
+
+        return HwdbgModelGetPins(Stage->PinValues, Low, Model->PortsConfiguration[Index]) & Model->ValueMask;
+
+    case SYMBOL_TEMP_TYPE:
+
+        if (InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators &&
+            HwdbgModelGetVectorIndex(Value, InstanceInfo->numberOfSupportedTemporaryVariables, &Index))
+        {
+            return Stage->TempVariables[Index];
+        }
+
+        return 0;
+
+    default:
+
+        //
+        // The pseudo-registers and the stack are not implemented in the chip
+        //
+        return 0;
+    }
+}
+
+/**
+ * @brief Write the result of a stage into the pins and the variables of the
+ * next stage (ScriptEngineSetValue)
+ *
+ * @param Model
+ * @param Stage
+ * @param Symbol
+ * @param Value
+ * @param NextStage
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgModelSetValue(const HWDBG_MODEL *        Model,
+                   const HWDBG_MODEL_STAGE *  Stage,
+                   const HWDBG_SHORT_SYMBOL * Symbol,
+                   UINT64                     Value,
+                   HWDBG_MODEL_STAGE *        NextStage)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo = &Model->InstanceInfo;
+    UINT32                             Index        = 0;
+    UINT32                             Low          = 0;
+    UINT32                             Width        = 0;
+    UINT64                             Operand      = Symbol->Value;
+    BOOLEAN                            PassPins     = FALSE;
+    BOOLEAN                            PassValues   = FALSE;
+
+    switch (Symbol->Type & HwdbgModelMask(HWDBG_MODEL_SYMBOL_TYPE_WIDTH))
+    {
+    case SYMBOL_UNDEFINED:
+
+        PassPins   = TRUE;
+        PassValues = TRUE;
+        break;
+
+    case SYMBOL_GLOBAL_ID_TYPE:
+    case SYMBOL_LOCAL_ID_TYPE:
+
+        PassPins   = InstanceInfo->scriptCapabilities.assign_local_global_var;
+        PassValues = InstanceInfo->scriptCapabilities.assign_local_global_var;
+        break;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        PassValues = InstanceInfo->scriptCapabilities.assign_registers;
+        break;
+
+    case SYMBOL_PSEUDO_REG_TYPE:
+
+        PassValues = InstanceInfo->scriptCapabilities.assign_pseudo_registers;
+        break;
+
+    case SYMBOL_STACK_INDEX_TYPE:
+
+        PassPins   = InstanceInfo->scriptCapabilities.stack_assignments;
+        PassValues = InstanceInfo->scriptCapabilities.stack_assignments;
+        break;
+
+    case SYMBOL_TEMP_TYPE:
+
+        PassPins   = InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators;
+        PassValues = InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators;
+        break;
+
+    default:
+
+        break;
+    }
+
+    //
+    // The pins (and the variables) are zero if the operand is not supported
+    //
+    if (PassPins)
+    {
+        memcpy(NextStage->PinValues, Stage->PinValues, Model->NumberOfPinWords * sizeof(UINT64));
+    }
+    else
+    {
+        memset(NextStage->PinValues, 0, Model->NumberOfPinWords * sizeof(UINT64));
+    }
+
+    //
+    // The variables are only passed to the next stage if they are implemented
+    //
+    if (InstanceInfo->scriptCapabilities.assign_local_global_var)
+    {
+        if (PassValues)
+        {
+            memcpy(NextStage->LocalGlobalVariables, Stage->LocalGlobalVariables, InstanceInfo->numberOfSupportedLocalAndGlobalVariables * sizeof(UINT64));
+        }
+        else
+        {
+            memset(NextStage->LocalGlobalVariables, 0, InstanceInfo->numberOfSupportedLocalAndGlobalVariables * sizeof(UINT64));
+        }
+    }
+
+    if (InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators)
+    {
+        if (PassValues)
+        {
+            memcpy(NextStage->TempVariables, Stage->TempVariables, InstanceInfo->numberOfSupportedTemporaryVariables * sizeof(UINT64));
+        }
+        else
+        {
+            memset(NextStage->TempVariables, 0, InstanceInfo->numberOfSupportedTemporaryVariables * sizeof(UINT64));
+        }
+    }
+
+    if (!PassValues)
+    {
+        return;
+    }
+
+    switch (Symbol->Type & HwdbgModelMask(HWDBG_MODEL_SYMBOL_TYPE_WIDTH))
+    {
+    case SYMBOL_GLOBAL_ID_TYPE:
+    case SYMBOL_LOCAL_ID_TYPE:
+
+        if (HwdbgModelGetVectorIndex(Operand, InstanceInfo->numberOfSupportedLocalAndGlobalVariables, &Index))
+        {
+            NextStage->LocalGlobalVariables[Index] = Value;
+        }
+
+        break;
+
+    case SYMBOL_TEMP_TYPE:
+
+        if (HwdbgModelGetVectorIndex(Operand, InstanceInfo->numberOfSupportedTemporaryVariables, &Index))
+        {
+            NextStage->TempVariables[Index] = Value;
+        }
+
+        break;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        if (Operand < InstanceInfo->numberOfPins)
+        {
+            //
+            // A pin is set by the least significant bit
+            //
+            memcpy(NextStage->PinValues, Stage->PinValues, Model->NumberOfPinWords * sizeof(UINT64));
+            HwdbgModelSetPins(NextStage->PinValues, (UINT32)Operand, 1, Value & 1);
+            break;
+        }
+
+        //
+        // Find the port (the pins stay zero if there is no such port)
+        //
+        for (Index = 0; Index < InstanceInfo->numberOfPorts; Index++)
+        {
+            if (Operand == (UINT64)Index + InstanceInfo->numberOfPins)
+            {
+                break;
+            }
+
+            Low += Model->PortsConfiguration[Index];
+        }
+
+        if (Index == InstanceInfo->numberOfPorts)
+        {
+            break;
+        }
+
+        Width = Model->PortsConfiguration[Index];
+        memcpy(NextStage->PinValues, Stage->PinValues, Model->NumberOfPinWords * sizeof(UINT64));
+
+        if (Width > InstanceInfo->scriptVariableLength)
+        {
+            //
+            // The value is appended with zeros if the port is wider than the
+            // script variables
+            //
+            HwdbgModelSetPins(NextStage->PinValues, Low, Width - InstanceInfo->scriptVariableLength, 0);
+            HwdbgModelSetPins(NextStage->PinValues, Low + Width - InstanceInfo->scriptVariableLength, InstanceInfo->scriptVariableLength, Value);
+        }
+        else
+        {
+            HwdbgModelSetPins(NextStage->PinValues, Low, Width, Value);
+        }
+
+        //
+        // The last port only keeps the pins below it (the pins above the
+        // ports are cleared)
+        //
+        if (Index != 0 && Index == InstanceInfo->numberOfPorts - 1)
+        {
+            HwdbgModelSetPins(NextStage->PinValues, Low + Width, InstanceInfo->numberOfPins - (Low + Width), 0);
+        }
+
+        break;
+
+    default:
+
+        break;
+    }
+}
+
+/**
+ * @brief Evaluate a stage and write the result into the next stage
+ * (ScriptEngineEval)
+ *
+ * @param Model
+ * @param Stage
+ * @param NextStage
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgModelEvaluate(const HWDBG_MODEL * Model, const HWDBG_MODEL_STAGE * Stage, HWDBG_MODEL_STAGE * NextStage)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo   = &Model->InstanceInfo;
+    BOOLEAN                            IsConditional  = InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators;
+    UINT64                             OperatorNumber = Stage->StageSymbol.Value & HwdbgModelMask(HWDBG_MODEL_OPERATOR_WIDTH);
+    UINT64                             Source0        = HwdbgModelGetValue(Model, Stage, &Stage->GetOperatorSymbols[0]);
+    UINT64                             Source1        = 0;
+    UINT64                             Shift          = 0;
+    UINT64                             Destination    = 0;
+    UINT64                             TargetStage    = 0;
+    BOOLEAN                            IsSupported    = FALSE;
+
+    if (InstanceInfo->maximumNumberOfSupportedGetScriptOperators > 1)
+    {
+        Source1 = HwdbgModelGetValue(Model, Stage, &Stage->GetOperatorSymbols[1]);
+    }
+
+    //
+    // The operators are followed by two GET operands and a SET operand (the
+    // jumps and the move change the target stage)
+    //
+    TargetStage = Stage->StageIndex + 4;
+    Shift       = Source1 & HwdbgModelMask(HwdbgModelLog2Ceil(InstanceInfo->scriptVariableLength) + 1);
+
+    switch (OperatorNumber)
+    {
+    case FUNC_OR:
+        IsSupported = InstanceInfo->scriptCapabilities.func_or;
+        Destination = Source0 | Source1;
+        break;
+
+    case FUNC_XOR:
+        IsSupported = InstanceInfo->scriptCapabilities.func_xor;
+        Destination = Source0 ^ Source1;
+        break;
+
+    case FUNC_AND:
+        IsSupported = InstanceInfo->scriptCapabilities.func_and;
+        Destination = Source0 & Source1;
+        break;
+
+    case FUNC_ASR:
+        IsSupported = InstanceInfo->scriptCapabilities.func_asr;
+        Destination = Shift >= 64 ? 0 : Source0 >> Shift;
+        break;
+
+    case FUNC_ASL:
+        IsSupported = InstanceInfo->scriptCapabilities.func_asl;
+        Destination = Shift >= 64 ? 0 : Source0 << Shift;
+        break;
+
+    case FUNC_ADD:
+        IsSupported = InstanceInfo->scriptCapabilities.func_add;
+        Destination = Source0 + Source1;
+        break;
+
+    case FUNC_SUB:
+        IsSupported = InstanceInfo->scriptCapabilities.func_sub;
+        Destination = Source0 - Source1;
+        break;
+
+    case FUNC_MUL:
+        IsSupported = InstanceInfo->scriptCapabilities.func_mul;
+        Destination = Source0 * Source1;
+        break;
+
+    case FUNC_DIV:
+        IsSupported = InstanceInfo->scriptCapabilities.func_div;
+        Destination = Source1 == 0 ? 0 : Source0 / Source1;
+        break;
+
+    case FUNC_MOD:
+        IsSupported = InstanceInfo->scriptCapabilities.func_mod;
+        Destination = Source1 == 0 ? 0 : Source0 % Source1;
+        break;
+
+    case FUNC_GT:
+        IsSupported = InstanceInfo->scriptCapabilities.func_gt && IsConditional;
+        Destination = Source0 > Source1;
+        break;
+
+    case FUNC_LT:
+        IsSupported = InstanceInfo->scriptCapabilities.func_lt && IsConditional;
+        Destination = Source0 < Source1;
+        break;
+
+    case FUNC_EGT:
+        IsSupported = InstanceInfo->scriptCapabilities.func_egt && IsConditional;
+        Destination = Source0 >= Source1;
+        break;
+
+    case FUNC_ELT:
+
+        //
+        // The chip checks the capability of 'egt' for 'elt'
+        //
+        IsSupported = InstanceInfo->scriptCapabilities.func_egt && IsConditional;
+        Destination = Source0 <= Source1;
+        break;
+
+    case FUNC_EQUAL:
+        IsSupported = InstanceInfo->scriptCapabilities.func_equal && IsConditional;
+        Destination = Source0 == Source1;
+        break;
+
+    case FUNC_NEQ:
+        IsSupported = InstanceInfo->scriptCapabilities.func_neq && IsConditional;
+        Destination = Source0 != Source1;
+        break;
+
+    case FUNC_JMP:
+        IsSupported = InstanceInfo->scriptCapabilities.func_jmp && IsConditional;
+        TargetStage = Source0;
+        break;
+
+    case FUNC_JZ:
+        IsSupported = InstanceInfo->scriptCapabilities.func_jz && IsConditional;
+        TargetStage = Source1 == 0 ? Source0 : Stage->StageIndex + 3;
+        break;
+
+    case FUNC_JNZ:
+        IsSupported = InstanceInfo->scriptCapabilities.func_jnz && IsConditional;
+        TargetStage = Source1 != 0 ? Source0 : Stage->StageIndex + 3;
+        break;
+
+    case FUNC_MOV:
+        IsSupported = InstanceInfo->scriptCapabilities.func_mov;
+        Destination = Source0;
+        TargetStage = Stage->StageIndex + 3;
+        break;
+
+    default:
+
+        //
+        // The other operators (and 'printf') are not implemented in the chip
+        //
+        break;
+    }
+
+    //
+    // The result of an operator that is not supported is zero and the target
+    // stage is the first stage, but the SET operand is still applied
+    //
+    if (!IsSupported)
+    {
+        Destination = 0;
+        TargetStage = 0;
+    }
+
+    HwdbgModelSetValue(Model, Stage, &Stage->SetOperatorSymbols[0], Destination & Model->ValueMask, NextStage);
+
+    NextStage->TargetStage = TargetStage & Model->StageIndexMask;
+}
+
+/**
+ * @brief Configure a symbol of the stages (the configuration states of
+ * ScriptExecutionEngine)
+ *
+ * @param Model
+ * @param Symbol
+ * @param Finished Whether it is the last symbol of the script
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgModelConfigureSymbol(HWDBG_MODEL * Model, const HWDBG_SHORT_SYMBOL * Symbol, BOOLEAN Finished)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo  = &Model->InstanceInfo;
+    HWDBG_MODEL_STAGE *                Stage         = NULL;
+    UINT64                             OperandMask   = 0;
+    UINT32                             OperandNumber = 0;
+
+    //
+    // The stage number wraps around on its width, and the stages that are not
+    // implemented are not configured
+    //
+    if (Model->ConfigStageNumber < InstanceInfo->maximumNumberOfStages)
+    {
+        Stage = &Model->Stages[Model->ConfigStageNumber];
+    }
+
+    OperandMask = HwdbgModelMask(HwdbgModelLog2Ceil(InstanceInfo->maximumNumberOfSupportedGetScriptOperators > InstanceInfo->maximumNumberOfSupportedSetScriptOperators
+                                                        ? InstanceInfo->maximumNumberOfSupportedGetScriptOperators
+                                                        : InstanceInfo->maximumNumberOfSupportedSetScriptOperators));
+
+    switch (Model->ConfigState)
+    {
+    case HWDBG_MODEL_CONFIG_STAGE_SYMBOL:
+
+        Model->StageConfigurationValid = FALSE;
+
+        if (Stage != NULL)
+        {
+            Stage->StageSymbol = *Symbol;
+            Stage->StageIndex  = Model->ConfigStageIndex;
+        }
+
+        Model->ConfigStageIndex = (Model->ConfigStageIndex + 1) & Model->StageIndexMask;
+
+        //
+        // The first symbol of a script disables all of the stages
+        //
+        if (Model->ConfigStageNumber == 0)
+        {
+            for (UINT32 i = 0; i < InstanceInfo->maximumNumberOfStages; i++)
+            {
+                Model->Stages[i].StageEnable = FALSE;
+            }
+        }
+
+        Model->ConfigState = HWDBG_MODEL_CONFIG_GET_SYMBOL;
+        break;
+
+    case HWDBG_MODEL_CONFIG_GET_SYMBOL:
+
+        if (HwdbgModelGetVectorIndex(Model->ConfigOperandNumber, InstanceInfo->maximumNumberOfSupportedGetScriptOperators, &OperandNumber) && Stage != NULL)
+        {
+            Stage->GetOperatorSymbols[OperandNumber] = *Symbol;
+        }
+
+        //
+        // The empty operands are not counted in the index of the stages
+        //
+        if (Symbol->Type != 0)
+        {
+            Model->ConfigStageIndex = (Model->ConfigStageIndex + 1) & Model->StageIndexMask;
+        }
+
+        if (Model->ConfigOperandNumber == InstanceInfo->maximumNumberOfSupportedGetScriptOperators - 1)
+        {
+            Model->ConfigOperandNumber = 0;
+            Model->ConfigState         = HWDBG_MODEL_CONFIG_SET_SYMBOL;
+        }
+        else
+        {
+            Model->ConfigOperandNumber = (Model->ConfigOperandNumber + 1) & OperandMask;
+        }
+
+        break;
+
+    case HWDBG_MODEL_CONFIG_SET_SYMBOL:
+
+        if (HwdbgModelGetVectorIndex(Model->ConfigOperandNumber, InstanceInfo->maximumNumberOfSupportedSetScriptOperators, &OperandNumber) && Stage != NULL)
+        {
+            Stage->SetOperatorSymbols[OperandNumber] = *Symbol;
+        }
+
+        if (Stage != NULL)
+        {
+            Stage->StageEnable = TRUE;
+        }
+
+        if (Symbol->Type != 0)
+        {
+            Model->ConfigStageIndex = (Model->ConfigStageIndex + 1) & Model->StageIndexMask;
+        }
+
+        if (Model->ConfigOperandNumber == InstanceInfo->maximumNumberOfSupportedSetScriptOperators - 1)
+        {
+            Model->ConfigOperandNumber = 0;
+            Model->ConfigState         = HWDBG_MODEL_CONFIG_STAGE_SYMBOL;
+
+            //
+            // The script is only applied once its last stage is configured
+            //
+            if (Finished)
+            {
+                Model->ConfigStageNumber       = 0;
+                Model->ConfigStageIndex        = 0;
+                Model->StageConfigurationValid = TRUE;
+            }
+            else
+            {
+                Model->ConfigStageNumber = (Model->ConfigStageNumber + 1) & HwdbgModelMask(HwdbgModelLog2Ceil(InstanceInfo->maximumNumberOfStages));
+            }
+        }
+        else
+        {
+            Model->ConfigOperandNumber = (Model->ConfigOperandNumber + 1) & OperandMask;
+        }
+
+        break;
+
+    default:
+
+        break;
+    }
+}
+
+/**
+ * @brief Perform a clock of the chip
+ *
+ * @param Model
+ * @param InputPins The input pins of this clock
+ * @param OutputPins The output pins of this clock (can be NULL)
+ * @param Symbol The symbol that is configured in this clock (or NULL)
+ * @param Finished Whether the symbol is the last symbol of the script
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgModelStep(HWDBG_MODEL *              Model,
+               const UINT64 *             InputPins,
+               UINT64 *                   OutputPins,
+               const HWDBG_SHORT_SYMBOL * Symbol,
+               BOOLEAN                    Finished)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo   = &Model->InstanceInfo;
+    UINT32                             NumberOfStages = InstanceInfo->maximumNumberOfStages;
+    SIZE_T                             PinsSize       = Model->NumberOfPinWords * sizeof(UINT64);
+
+    //
+    // The output pins are the registers of the stage before the last stage
+    // (before this clock)
+    //
+    if (OutputPins != NULL)
+    {
+        memcpy(OutputPins, Model->Stages[NumberOfStages - 2].PinValues, PinsSize);
+    }
+
+    //
+    // Each stage reads the registers of the previous stage, so the stages are
+    // moved from the last one to keep the previous registers of this clock
+    //
+    for (UINT32 i = NumberOfStages - 2; i >= 1; i--)
+    {
+        HWDBG_MODEL_STAGE * Previous = &Model->Stages[i - 1];
+        HWDBG_MODEL_STAGE * Current  = &Model->Stages[i];
+
+        if (Model->StageConfigurationValid && Previous->StageIndex == Previous->TargetStage && Previous->StageEnable)
+        {
+            HwdbgModelEvaluate(Model, Previous, Current);
+            continue;
+        }
+
+        memcpy(Current->PinValues, Previous->PinValues, PinsSize);
+        Current->TargetStage = Previous->TargetStage;
+
+        if (InstanceInfo->scriptCapabilities.assign_local_global_var)
+        {
+            memcpy(Current->LocalGlobalVariables, Previous->LocalGlobalVariables, InstanceInfo->numberOfSupportedLocalAndGlobalVariables * sizeof(UINT64));
+        }
+
+        if (InstanceInfo->scriptCapabilities.conditional_statements_and_comparison_operators)
+        {
+            memcpy(Current->TempVariables, Previous->TempVariables, InstanceInfo->numberOfSupportedTemporaryVariables * sizeof(UINT64));
+        }
+    }
+
+    //
+    // Each input starts from the first target stage (the variables of the
+    // first stage are never assigned)
+    //
+    memcpy(Model->Stages[0].PinValues, InputPins, PinsSize);
+    Model->Stages[0].TargetStage = 0;
+
+    //
+    // Only the configured registers of the stages are changed by the
+    // configuration, so it's applied after the stages are moved
+    //
+    if (Symbol != NULL)
+    {
+        HwdbgModelConfigureSymbol(Model, Symbol, Finished);
+    }
+
+    Model->NumberOfCycles++;
+}
+
+/**
+ * @brief Perform a clock of the chip
+ *
+ * @param Model
+ * @param InputPins The input pins of this clock (HWDBG_MODEL_PIN_WORDS words)
+ * @param OutputPins The output pins of this clock (can be NULL)
+ *
+ * @return VOID
+ */
+VOID
+HwdbgModelClock(HWDBG_MODEL * Model, const UINT64 * InputPins, UINT64 * OutputPins)
+{
+    HwdbgModelStep(Model, InputPins, OutputPins, NULL, FALSE);
+}
+
+/**
+ * @brief Read a field of the script buffer (a read of the BRAM)
+ *
+ * @param Model
+ * @param Buffer
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgModelReadChunk(const HWDBG_MODEL * Model, const BYTE * Buffer)
+{
+    UINT32 NumberOfBytes = (Model->InstanceInfo.bramDataWidth + 7) / 8;
+    UINT64 Value         = 0;
+
+    for (UINT32 i = 0; i < NumberOfBytes; i++)
+    {
+        Value |= (UINT64)Buffer[i] << (i * 8);
+    }
+
+    return Value & HwdbgModelMask(Model->InstanceInfo.bramDataWidth);
+}
+
+/**
+ * @brief Configure the stages with a script buffer (the number of the
+ * symbols, and the Type and the Value of each symbol, as written by the host
+ * after the packet)
+ *
+ * @details A symbol is configured at each clock (with zero input pins), and
+ * the stages only pass the pins through until the last symbol is configured
+ *
+ * @param Model
+ * @param ScriptBuffer
+ * @param ScriptBufferSize
+ *
+ * @return BOOLEAN FALSE if the buffer is truncated or the script is not
+ * applied (its symbols are not a multiple of the operands of a stage)
+ */
+BOOLEAN
+HwdbgModelConfigureScript(HWDBG_MODEL * Model, const BYTE * ScriptBuffer, SIZE_T ScriptBufferSize)
+{
+    SIZE_T             ChunkSize       = (Model->InstanceInfo.bramDataWidth + 7) / 8;
+    UINT64             NumberOfSymbols = 0;
+    HWDBG_SHORT_SYMBOL Symbol;
+
+    if (ScriptBufferSize < ChunkSize)
+    {
+        return FALSE;
+    }
+
+    //
+    // The number of the symbols is one less than the symbols of the script
+    //
+    NumberOfSymbols = HwdbgModelReadChunk(Model, ScriptBuffer);
+
+    if (NumberOfSymbols >= (ScriptBufferSize / ChunkSize - 1) / 2)
+    {
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i <= NumberOfSymbols; i++)
+    {
+        Symbol.Type  = HwdbgModelReadChunk(Model, ScriptBuffer + (1 + i * 2) * ChunkSize) & Model->ValueMask;
+        Symbol.Value = HwdbgModelReadChunk(Model, ScriptBuffer + (2 + i * 2) * ChunkSize) & Model->ValueMask;
+
+        HwdbgModelStep(Model, Model->ZeroPins, NULL, &Symbol, i == NumberOfSymbols);
+    }
+
+    return Model->StageConfigurationValid;
+}
+
+/**
+ * @brief Receive a packet from the BRAM (only the packets that configure the
+ * script buffer are handled)
+ *
+ * @param Model
+ * @param Bram The content of the BRAM
+ * @param BramSize
+ *
+ * @return BOOLEAN FALSE if the packet is invalid or the script is not applied
+ */
+BOOLEAN
+HwdbgModelReceivePacket(HWDBG_MODEL * Model, const BYTE * Bram, SIZE_T BramSize)
+{
+    const HWDBG_INSTANCE_INFORMATION * InstanceInfo = &Model->InstanceInfo;
+    DEBUGGER_REMOTE_PACKET             Packet;
+    SIZE_T                             DataOffset   = 0;
+
+    //
+    // The debugger can only write before the area of the debuggee
+    //
+    if (InstanceInfo->debuggeeAreaOffset > InstanceInfo->debuggerAreaOffset && InstanceInfo->debuggeeAreaOffset < BramSize)
+    {
+        BramSize = InstanceInfo->debuggeeAreaOffset;
+    }
+
+    if (BramSize < InstanceInfo->debuggerAreaOffset || BramSize - InstanceInfo->debuggerAreaOffset < sizeof(DEBUGGER_REMOTE_PACKET))
+    {
+        return FALSE;
+    }
+
+    memcpy(&Packet, Bram + InstanceInfo->debuggerAreaOffset, sizeof(DEBUGGER_REMOTE_PACKET));
+
+    if (Packet.Indicator != INDICATOR_OF_HYPERDBG_PACKET ||
+        Packet.TypeOfThePacket != DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_HARDWARE_LEVEL ||
+        Packet.RequestedActionOfThePacket != (DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION)hwdbgActionConfigureScriptBuffer)
+    {
+        return FALSE;
+    }
+
+    //
+    // The buffer is read after the requested action (a read of the BRAM)
+    //
+    DataOffset = InstanceInfo->debuggerAreaOffset + offsetof(DEBUGGER_REMOTE_PACKET, RequestedActionOfThePacket) + InstanceInfo->bramDataWidth / 8;
+
+    if (DataOffset > BramSize)
+    {
+        return FALSE;
+    }
+
+    return HwdbgModelConfigureScript(Model, Bram + DataOffset, BramSize - DataOffset);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file HwdbgModel.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the cycle-level software model of the hwdbg script stages
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Width of the usable part of the Type of the symbols and the Value of
+ * the operators in the chip (ScriptDataTypes and ScriptOperators enums)
+ *
+ */
+#define HWDBG_MODEL_SYMBOL_TYPE_WIDTH 5
+#define HWDBG_MODEL_OPERATOR_WIDTH    8
+
+/**
+ * @brief Number of the 64-bit words that hold the pins
+ *
+ */
+#define HWDBG_MODEL_PIN_WORDS(NumberOfPins) (((NumberOfPins) + 63) / 64)
+
+/**
+ * @brief States of the configuration of the stages (ScriptExecutionEngine)
+ *
+ */
+#define HWDBG_MODEL_CONFIG_STAGE_SYMBOL 0
+#define HWDBG_MODEL_CONFIG_GET_SYMBOL   1
+#define HWDBG_MODEL_CONFIG_SET_SYMBOL   2
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Registers of a stage
+ *
+ * @details The symbols, the index and the enable bit are configured by the
+ * script buffer, and the other registers are passed to the next stage at each
+ * clock
+ *
+ */
+typedef struct _HWDBG_MODEL_STAGE
+{
+    HWDBG_SHORT_SYMBOL   StageSymbol;
+    HWDBG_SHORT_SYMBOL * GetOperatorSymbols;
+    HWDBG_SHORT_SYMBOL * SetOperatorSymbols;
+    UINT64               StageIndex;
+    BOOLEAN              StageEnable;
+
+    UINT64 * PinValues;
+    UINT64 * TempVariables;
+    UINT64 * LocalGlobalVariables;
+    UINT64   TargetStage;
+
+} HWDBG_MODEL_STAGE, *PHWDBG_MODEL_STAGE;
+
+/**
+ * @brief The model of an instance of hwdbg
+ *
+ */
+typedef struct _HWDBG_MODEL
+{
+    HWDBG_INSTANCE_INFORMATION InstanceInfo;
+    UINT32 *                   PortsConfiguration;
+    HWDBG_MODEL_STAGE *        Stages;
+    UINT64 *                   ZeroPins; // the pins while the stages are configured
+    UINT32                     NumberOfPinWords;
+    UINT64                     ValueMask;      // scriptVariableLength bits
+    UINT64                     StageIndexMask; // width of the stage index and the target stage
+
+    BOOLEAN StageConfigurationValid;
+    UINT32  ConfigState;
+    UINT64  ConfigStageNumber;
+    UINT64  ConfigOperandNumber;
+    UINT64  ConfigStageIndex;
+
+    UINT64 NumberOfCycles;
+
+} HWDBG_MODEL, *PHWDBG_MODEL;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+SIZE_T
+HwdbgModelGetBufferSize(const HWDBG_INSTANCE_INFORMATION * InstanceInfo);
+
+BOOLEAN
+HwdbgModelInitialize(HWDBG_MODEL *                      Model,
+                     const HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                     const UINT32 *                     PortsConfiguration,
+                     PVOID                              Buffer,
+                     SIZE_T                             BufferSize);
+
+UINT32
+HwdbgModelGetLatency(const HWDBG_MODEL * Model);
+
+VOID
+HwdbgModelClock(HWDBG_MODEL * Model, const UINT64 * InputPins, UINT64 * OutputPins);
+
+BOOLEAN
+HwdbgModelConfigureScript(HWDBG_MODEL * Model, const BYTE * ScriptBuffer, SIZE_T ScriptBufferSize);
+
+BOOLEAN
+HwdbgModelReceivePacket(HWDBG_MODEL * Model, const BYTE * Bram, SIZE_T BramSize);
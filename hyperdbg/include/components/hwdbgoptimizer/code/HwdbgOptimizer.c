@@ -0,0 +1,1145 @@
+/**
+ * @file HwdbgOptimizer.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Optimizer of the hwdbg script stages
+ * @details Each operator of a hwdbg script is a stage of the pipeline of the
+ * chip (the stages only move forward, so a jump only targets the later stages)
+ * and the flip-flops of an instance grow with the number of the stages. The
+ * optimizer folds the constants, propagates the copies into the operands,
+ * writes the results directly into the destination of the following move,
+ * removes the dead, unreachable and no-op stages, and renumbers the temporary
+ * variables to reuse them
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the number of GET and SET operands of the operators that are
+ * supported by hwdbg
+ *
+ * @param Operator
+ * @param NumberOfGetOperands
+ * @param NumberOfSetOperands
+ *
+ * @return BOOLEAN FALSE if the operator is not supported by hwdbg
+ */
+BOOLEAN
+HwdbgOptimizerGetNumberOfOperands(UINT64 Operator, UINT32 * NumberOfGetOperands, UINT32 * NumberOfSetOperands)
+{
+    switch (Operator)
+    {
+    case FUNC_OR:
+    case FUNC_XOR:
+    case FUNC_AND:
+    case FUNC_ASR:
+    case FUNC_ASL:
+    case FUNC_ADD:
+    case FUNC_SUB:
+    case FUNC_MUL:
+    case FUNC_DIV:
+    case FUNC_MOD:
+    case FUNC_GT:
+    case FUNC_LT:
+    case FUNC_EGT:
+    case FUNC_ELT:
+    case FUNC_EQUAL:
+    case FUNC_NEQ:
+
+        *NumberOfGetOperands = 2;
+        *NumberOfSetOperands = 1;
+
+        return TRUE;
+
+    case FUNC_JMP:
+
+        *NumberOfGetOperands = 1;
+        *NumberOfSetOperands = 0;
+
+        return TRUE;
+
+    case FUNC_JZ:
+    case FUNC_JNZ:
+
+        *NumberOfGetOperands = 2;
+        *NumberOfSetOperands = 0;
+
+        return TRUE;
+
+    case FUNC_MOV:
+
+        *NumberOfGetOperands = 1;
+        *NumberOfSetOperands = 1;
+
+        return TRUE;
+
+    default:
+
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Count the stages (operators) of a script
+ *
+ * @param Symbols
+ * @param NumberOfSymbols
+ *
+ * @return UINT32
+ */
+UINT32
+HwdbgOptimizerCountStages(const SYMBOL * Symbols, UINT32 NumberOfSymbols)
+{
+    UINT32 NumberOfStages = 0;
+
+    for (UINT32 i = 0; i < NumberOfSymbols; i++)
+    {
+        if (Symbols[i].Type == SYMBOL_SEMANTIC_RULE_TYPE)
+        {
+            NumberOfStages++;
+        }
+    }
+
+    return NumberOfStages;
+}
+
+/**
+ * @brief Check whether the operator of a stage is a jump
+ *
+ * @param Stage
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+HwdbgOptimizerIsJump(const HWDBG_OPTIMIZER_STAGE * Stage)
+{
+    return Stage->Operator.Value == FUNC_JMP ||
+           Stage->Operator.Value == FUNC_JZ ||
+           Stage->Operator.Value == FUNC_JNZ;
+}
+
+/**
+ * @brief Check whether an operand is a temporary variable
+ *
+ * @param Operand
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+HwdbgOptimizerIsTemp(const SYMBOL * Operand)
+{
+    return Operand->Type == SYMBOL_TEMP_TYPE;
+}
+
+/**
+ * @brief Check whether two operands are the same variable (the local and global
+ * variables are stored in the same registers of the chip)
+ *
+ * @param First
+ * @param Second
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+HwdbgOptimizerIsSameVariable(const SYMBOL * First, const SYMBOL * Second)
+{
+    UINT64 FirstType  = First->Type == SYMBOL_GLOBAL_ID_TYPE ? SYMBOL_LOCAL_ID_TYPE : First->Type;
+    UINT64 SecondType = Second->Type == SYMBOL_GLOBAL_ID_TYPE ? SYMBOL_LOCAL_ID_TYPE : Second->Type;
+
+    return FirstType == SecondType && First->Value == Second->Value;
+}
+
+/**
+ * @brief Get the mask of the values of the script variables
+ *
+ * @param ScriptVariableLength
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgOptimizerGetValueMask(UINT32 ScriptVariableLength)
+{
+    return ScriptVariableLength >= 64 ? ~0ull : (1ull << ScriptVariableLength) - 1;
+}
+
+/**
+ * @brief Get the mask of the shift counts (the chip only uses the low
+ * log2Ceil(ScriptVariableLength) + 1 bits of the count)
+ *
+ * @param ScriptVariableLength
+ *
+ * @return UINT64
+ */
+static UINT64
+HwdbgOptimizerGetShiftMask(UINT32 ScriptVariableLength)
+{
+    UINT32 Log2Ceil = 0;
+
+    while ((1u << Log2Ceil) < ScriptVariableLength)
+    {
+        Log2Ceil++;
+    }
+
+    return (2ull << Log2Ceil) - 1;
+}
+
+/**
+ * @brief Compute an operator with constant operands the same way as the chip
+ *
+ * @param Operator
+ * @param First
+ * @param Second
+ * @param ScriptVariableLength
+ * @param Value
+ *
+ * @return BOOLEAN FALSE if the operator could not be computed (e.g., a division by zero)
+ */
+static BOOLEAN
+HwdbgOptimizerFoldOperator(UINT64   Operator,
+                           UINT64   First,
+                           UINT64   Second,
+                           UINT32   ScriptVariableLength,
+                           UINT64 * Value)
+{
+    UINT64 Mask  = HwdbgOptimizerGetValueMask(ScriptVariableLength);
+    UINT64 Shift = Second & HwdbgOptimizerGetShiftMask(ScriptVariableLength);
+    UINT64 Result;
+
+    First &= Mask;
+    Second &= Mask;
+
+    switch (Operator)
+    {
+    case FUNC_OR:
+        Result = First | Second;
+        break;
+    case FUNC_XOR:
+        Result = First ^ Second;
+        break;
+    case FUNC_AND:
+        Result = First & Second;
+        break;
+    case FUNC_ASR:
+        Result = Shift >= 64 ? 0 : First >> Shift;
+        break;
+    case FUNC_ASL:
+        Result = Shift >= 64 ? 0 : First << Shift;
+        break;
+    case FUNC_ADD:
+        Result = First + Second;
+        break;
+    case FUNC_SUB:
+        Result = First - Second;
+        break;
+    case FUNC_MUL:
+        Result = First * Second;
+        break;
+    case FUNC_DIV:
+    case FUNC_MOD:
+
+        if (Second == 0)
+        {
+            return FALSE;
+        }
+
+        Result = Operator == FUNC_DIV ? First / Second : First % Second;
+        break;
+
+    case FUNC_GT:
+        Result = First > Second;
+        break;
+    case FUNC_LT:
+        Result = First < Second;
+        break;
+    case FUNC_EGT:
+        Result = First >= Second;
+        break;
+    case FUNC_ELT:
+        Result = First <= Second;
+        break;
+    case FUNC_EQUAL:
+        Result = First == Second;
+        break;
+    case FUNC_NEQ:
+        Result = First != Second;
+        break;
+    default:
+        return FALSE;
+    }
+
+    *Value = Result & Mask;
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the operand of an operator that makes it a move of the other
+ * operand (e.g., x + 0 or x * 1)
+ *
+ * @param Stage
+ * @param ScriptVariableLength
+ *
+ * @return INT32 Index of the operand that is moved, or -1
+ */
+static INT32
+HwdbgOptimizerFindIdentityOperand(const HWDBG_OPTIMIZER_STAGE * Stage, UINT32 ScriptVariableLength)
+{
+    UINT64 Mask      = HwdbgOptimizerGetValueMask(ScriptVariableLength);
+    UINT64 ShiftMask = HwdbgOptimizerGetShiftMask(ScriptVariableLength);
+
+    for (INT32 Constant = 1; Constant >= 0; Constant--)
+    {
+        UINT64 Value;
+
+        if (Stage->GetOperands[Constant].Type != SYMBOL_NUM_TYPE)
+        {
+            continue;
+        }
+
+        Value = Stage->GetOperands[Constant].Value & Mask;
+
+        switch (Stage->Operator.Value)
+        {
+        case FUNC_ADD:
+        case FUNC_OR:
+        case FUNC_XOR:
+
+            if (Value == 0)
+            {
+                return 1 - Constant;
+            }
+            break;
+
+        case FUNC_MUL:
+
+            if (Value == 1)
+            {
+                return 1 - Constant;
+            }
+            break;
+
+        case FUNC_SUB:
+
+            if (Constant == 1 && Value == 0)
+            {
+                return 0;
+            }
+            break;
+
+        case FUNC_DIV:
+
+            if (Constant == 1 && Value == 1)
+            {
+                return 0;
+            }
+            break;
+
+        case FUNC_ASR:
+        case FUNC_ASL:
+
+            if (Constant == 1 && (Stage->GetOperands[1].Value & ShiftMask) == 0)
+            {
+                return 0;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Read the stages of a script
+ *
+ * @details The jumps to the previous (or the same) stages and to the symbols
+ * that are not a stage never match a later stage of the pipeline, so they are
+ * converted to the jumps to the end of the script
+ *
+ * @param Symbols
+ * @param NumberOfSymbols
+ * @param Stages
+ * @param MaximumNumberOfStages
+ * @param NumberOfStages
+ *
+ * @return BOOLEAN FALSE if the script is not supported by the optimizer
+ */
+static BOOLEAN
+HwdbgOptimizerReadStages(const SYMBOL *          Symbols,
+                         UINT32                  NumberOfSymbols,
+                         HWDBG_OPTIMIZER_STAGE * Stages,
+                         UINT32                  MaximumNumberOfStages,
+                         UINT32 *                NumberOfStages)
+{
+    UINT32 Count = 0;
+    UINT32 Index = 0;
+
+    while (Index < NumberOfSymbols)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[Count];
+
+        if (Count == MaximumNumberOfStages || Symbols[Index].Type != SYMBOL_SEMANTIC_RULE_TYPE)
+        {
+            return FALSE;
+        }
+
+        memset(Stage, 0, sizeof(HWDBG_OPTIMIZER_STAGE));
+
+        Stage->Operator    = Symbols[Index];
+        Stage->SymbolIndex = Index;
+
+        if (!HwdbgOptimizerGetNumberOfOperands(Stage->Operator.Value, &Stage->NumberOfGetOperands, &Stage->NumberOfSetOperands) ||
+            NumberOfSymbols - Index - 1 < Stage->NumberOfGetOperands + Stage->NumberOfSetOperands)
+        {
+            return FALSE;
+        }
+
+        Index++;
+
+        for (UINT32 i = 0; i < Stage->NumberOfGetOperands + Stage->NumberOfSetOperands; i++, Index++)
+        {
+            const SYMBOL * Operand = &Symbols[Index];
+
+            switch (Operand->Type)
+            {
+            case SYMBOL_NUM_TYPE:
+
+                if (i >= Stage->NumberOfGetOperands)
+                {
+                    return FALSE;
+                }
+                break;
+
+            case SYMBOL_TEMP_TYPE:
+
+                if (Operand->Value >= HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES)
+                {
+                    return FALSE;
+                }
+                break;
+
+            case SYMBOL_GLOBAL_ID_TYPE:
+            case SYMBOL_LOCAL_ID_TYPE:
+            case SYMBOL_REGISTER_TYPE:
+            case SYMBOL_PSEUDO_REG_TYPE:
+            case SYMBOL_STACK_INDEX_TYPE:
+                break;
+
+            default:
+                return FALSE;
+            }
+
+            if (i < Stage->NumberOfGetOperands)
+            {
+                Stage->GetOperands[i] = *Operand;
+            }
+            else
+            {
+                Stage->SetOperands[i - Stage->NumberOfGetOperands] = *Operand;
+            }
+        }
+
+        //
+        // The target of a jump should be a constant
+        //
+        if (HwdbgOptimizerIsJump(Stage) && Stage->GetOperands[0].Type != SYMBOL_NUM_TYPE)
+        {
+            return FALSE;
+        }
+
+        Count++;
+    }
+
+    //
+    // Convert the targets of the jumps to the index of the stages
+    //
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        if (!HwdbgOptimizerIsJump(&Stages[i]))
+        {
+            continue;
+        }
+
+        Stages[i].TargetStage = Count;
+
+        for (UINT32 j = i + 1; j < Count; j++)
+        {
+            if (Stages[j].SymbolIndex == Stages[i].GetOperands[0].Value)
+            {
+                Stages[i].TargetStage = j;
+                break;
+            }
+        }
+    }
+
+    *NumberOfStages = Count;
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the jump targets, the reachable stages and the live temporary
+ * variables
+ *
+ * @details As the jumps only move forward, a single backward walk over the
+ * stages is enough for the live variables
+ *
+ * @param Stages
+ * @param NumberOfStages
+ *
+ * @return VOID
+ */
+static VOID
+HwdbgOptimizerAnalyze(HWDBG_OPTIMIZER_STAGE * Stages, UINT32 NumberOfStages)
+{
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        Stages[i].IsJumpTarget = FALSE;
+        Stages[i].IsReachable  = i == 0;
+    }
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+
+        if (HwdbgOptimizerIsJump(Stage) && Stage->TargetStage < NumberOfStages)
+        {
+            Stages[Stage->TargetStage].IsJumpTarget = TRUE;
+
+            if (Stage->IsReachable)
+            {
+                Stages[Stage->TargetStage].IsReachable = TRUE;
+            }
+        }
+
+        if (Stage->IsReachable && Stage->Operator.Value != FUNC_JMP && i + 1 < NumberOfStages)
+        {
+            Stages[i + 1].IsReachable = TRUE;
+        }
+    }
+
+    for (UINT32 i = NumberOfStages; i-- > 0;)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+        UINT64                  Out   = 0;
+        UINT64                  In;
+
+        if (Stage->Operator.Value != FUNC_JMP && i + 1 < NumberOfStages)
+        {
+            Out |= Stages[i + 1].LiveIn;
+        }
+
+        if (HwdbgOptimizerIsJump(Stage) && Stage->TargetStage < NumberOfStages)
+        {
+            Out |= Stages[Stage->TargetStage].LiveIn;
+        }
+
+        In = Out;
+
+        if (Stage->NumberOfSetOperands != 0 && HwdbgOptimizerIsTemp(&Stage->SetOperands[0]))
+        {
+            In &= ~(1ull << Stage->SetOperands[0].Value);
+        }
+
+        for (UINT32 j = 0; j < Stage->NumberOfGetOperands; j++)
+        {
+            if (HwdbgOptimizerIsTemp(&Stage->GetOperands[j]))
+            {
+                In |= 1ull << Stage->GetOperands[j].Value;
+            }
+        }
+
+        Stage->LiveIn  = In;
+        Stage->LiveOut = Out;
+    }
+}
+
+/**
+ * @brief Remove the stages that are marked as removed and move the targets
+ * of the jumps to the next remaining stage
+ *
+ * @param Stages
+ * @param NumberOfStages
+ *
+ * @return UINT32 The new number of stages
+ */
+static UINT32
+HwdbgOptimizerCompact(HWDBG_OPTIMIZER_STAGE * Stages, UINT32 NumberOfStages)
+{
+    UINT32 Count = 0;
+
+    //
+    // The index of the symbols is not used until the stages are written, so
+    // it keeps the new index of each stage (the index of the next remaining
+    // stage for the removed ones)
+    //
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        Stages[i].SymbolIndex = Count;
+
+        if (!Stages[i].IsRemoved)
+        {
+            Count++;
+        }
+    }
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        if (Stages[i].IsRemoved)
+        {
+            continue;
+        }
+
+        if (HwdbgOptimizerIsJump(&Stages[i]))
+        {
+            Stages[i].TargetStage = Stages[i].TargetStage < NumberOfStages ? Stages[Stages[i].TargetStage].SymbolIndex : Count;
+        }
+
+        Stages[Stages[i].SymbolIndex] = Stages[i];
+    }
+
+    return Count;
+}
+
+/**
+ * @brief Propagate the moved constants and variables into the operands of the
+ * next stages, and fold the operators with constant operands
+ *
+ * @param Stages
+ * @param NumberOfStages
+ * @param ScriptVariableLength
+ * @param Result
+ *
+ * @return BOOLEAN TRUE if any stage is changed
+ */
+static BOOLEAN
+HwdbgOptimizerPropagate(HWDBG_OPTIMIZER_STAGE *  Stages,
+                        UINT32                   NumberOfStages,
+                        UINT32                   ScriptVariableLength,
+                        HWDBG_OPTIMIZER_RESULT * Result)
+{
+    SYMBOL  Known[HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES];
+    UINT64  KnownTemps = 0;
+    BOOLEAN Changed    = FALSE;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+        UINT32                  FirstOperand;
+        UINT64                  Value;
+        INT32                   Identity;
+
+        //
+        // The moved values are not known on the stages that are targeted
+        // by the jumps
+        //
+        if (Stage->IsJumpTarget)
+        {
+            KnownTemps = 0;
+        }
+
+        //
+        // Replace the temporary variables with their moved values (the target
+        // of the jumps is not an operand)
+        //
+        FirstOperand = HwdbgOptimizerIsJump(Stage) ? 1 : 0;
+
+        for (UINT32 j = FirstOperand; j < Stage->NumberOfGetOperands; j++)
+        {
+            SYMBOL * Operand = &Stage->GetOperands[j];
+
+            if (HwdbgOptimizerIsTemp(Operand) && (KnownTemps & (1ull << Operand->Value)))
+            {
+                *Operand = Known[Operand->Value];
+                Changed  = TRUE;
+            }
+        }
+
+        if (Stage->Operator.Value == FUNC_JZ || Stage->Operator.Value == FUNC_JNZ)
+        {
+            //
+            // A conditional jump with a constant condition is either a jump
+            // or nothing
+            //
+            if (Stage->GetOperands[1].Type == SYMBOL_NUM_TYPE)
+            {
+                BOOLEAN IsZero = (Stage->GetOperands[1].Value & HwdbgOptimizerGetValueMask(ScriptVariableLength)) == 0;
+
+                if (IsZero == (Stage->Operator.Value == FUNC_JZ))
+                {
+                    Stage->Operator.Value      = FUNC_JMP;
+                    Stage->NumberOfGetOperands = 1;
+                }
+                else
+                {
+                    Stage->IsRemoved = TRUE;
+                }
+
+                Result->NumberOfFoldedStages++;
+                Changed = TRUE;
+            }
+
+            continue;
+        }
+
+        if (Stage->NumberOfGetOperands == 2)
+        {
+            if (Stage->GetOperands[0].Type == SYMBOL_NUM_TYPE &&
+                Stage->GetOperands[1].Type == SYMBOL_NUM_TYPE &&
+                HwdbgOptimizerFoldOperator(Stage->Operator.Value,
+                                           Stage->GetOperands[0].Value,
+                                           Stage->GetOperands[1].Value,
+                                           ScriptVariableLength,
+                                           &Value))
+            {
+                Stage->GetOperands[0].Value = Value;
+                Stage->GetOperands[0].Len   = 0;
+                Stage->Operator.Value       = FUNC_MOV;
+                Stage->NumberOfGetOperands  = 1;
+
+                Result->NumberOfFoldedStages++;
+                Changed = TRUE;
+            }
+            else if ((Identity = HwdbgOptimizerFindIdentityOperand(Stage, ScriptVariableLength)) != -1)
+            {
+                Stage->GetOperands[0]      = Stage->GetOperands[Identity];
+                Stage->Operator.Value      = FUNC_MOV;
+                Stage->NumberOfGetOperands = 1;
+
+                Result->NumberOfFoldedStages++;
+                Changed = TRUE;
+            }
+        }
+
+        if (Stage->NumberOfSetOperands == 0)
+        {
+            continue;
+        }
+
+        //
+        // The values that are moved into (or from) the destination are not
+        // known anymore
+        //
+        for (UINT32 Temp = 0; Temp < HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES; Temp++)
+        {
+            SYMBOL TempOperand = {SYMBOL_TEMP_TYPE, 0, Temp};
+
+            if ((KnownTemps & (1ull << Temp)) &&
+                (HwdbgOptimizerIsSameVariable(&TempOperand, &Stage->SetOperands[0]) ||
+                 HwdbgOptimizerIsSameVariable(&Known[Temp], &Stage->SetOperands[0])))
+            {
+                KnownTemps &= ~(1ull << Temp);
+            }
+        }
+
+        if (Stage->Operator.Value == FUNC_MOV &&
+            HwdbgOptimizerIsTemp(&Stage->SetOperands[0]) &&
+            !HwdbgOptimizerIsSameVariable(&Stage->GetOperands[0], &Stage->SetOperands[0]))
+        {
+            switch (Stage->GetOperands[0].Type)
+            {
+            case SYMBOL_NUM_TYPE:
+            case SYMBOL_TEMP_TYPE:
+            case SYMBOL_GLOBAL_ID_TYPE:
+            case SYMBOL_LOCAL_ID_TYPE:
+
+                Known[Stage->SetOperands[0].Value] = Stage->GetOperands[0];
+                KnownTemps |= 1ull << Stage->SetOperands[0].Value;
+                break;
+
+            default:
+
+                //
+                // The pins and ports overlap, so they are not propagated
+                //
+                break;
+            }
+        }
+    }
+
+    return Changed;
+}
+
+/**
+ * @brief Write the result of an operator directly into the destination of the
+ * next move (if the moved temporary variable is not used anymore)
+ *
+ * @param Stages
+ * @param NumberOfStages
+ * @param Result
+ *
+ * @return BOOLEAN TRUE if any stage is changed
+ */
+static BOOLEAN
+HwdbgOptimizerForward(HWDBG_OPTIMIZER_STAGE *  Stages,
+                      UINT32                   NumberOfStages,
+                      HWDBG_OPTIMIZER_RESULT * Result)
+{
+    BOOLEAN Changed = FALSE;
+
+    for (UINT32 i = 1; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Previous = &Stages[i - 1];
+        HWDBG_OPTIMIZER_STAGE * Move     = &Stages[i];
+
+        if (Previous->IsRemoved ||
+            Previous->NumberOfSetOperands == 0 ||
+            Move->Operator.Value != FUNC_MOV ||
+            Move->IsJumpTarget ||
+            !HwdbgOptimizerIsTemp(&Move->GetOperands[0]) ||
+            !HwdbgOptimizerIsSameVariable(&Previous->SetOperands[0], &Move->GetOperands[0]) ||
+            (Move->LiveOut & (1ull << Move->GetOperands[0].Value)))
+        {
+            continue;
+        }
+
+        Previous->SetOperands[0] = Move->SetOperands[0];
+        Move->IsRemoved          = TRUE;
+
+        Result->NumberOfForwardedStages++;
+        Changed = TRUE;
+    }
+
+    return Changed;
+}
+
+/**
+ * @brief Remove the unreachable stages, the stages that write a temporary
+ * variable that is not used, the moves of a temporary, local, or global
+ * variable into itself, and the jumps to the next stage
+ *
+ * @param Stages
+ * @param NumberOfStages
+ *
+ * @return BOOLEAN TRUE if any stage is changed
+ */
+static BOOLEAN
+HwdbgOptimizerRemoveStages(HWDBG_OPTIMIZER_STAGE * Stages, UINT32 NumberOfStages)
+{
+    BOOLEAN Changed = FALSE;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+
+        if (!Stage->IsReachable)
+        {
+            Stage->IsRemoved = TRUE;
+        }
+        else if (Stage->NumberOfSetOperands != 0 &&
+                 HwdbgOptimizerIsTemp(&Stage->SetOperands[0]) &&
+                 !(Stage->LiveOut & (1ull << Stage->SetOperands[0].Value)))
+        {
+            Stage->IsRemoved = TRUE;
+        }
+        else if (Stage->Operator.Value == FUNC_MOV &&
+                 HwdbgOptimizerIsSameVariable(&Stage->GetOperands[0], &Stage->SetOperands[0]) &&
+                 (HwdbgOptimizerIsTemp(&Stage->SetOperands[0]) ||
+                  Stage->SetOperands[0].Type == SYMBOL_LOCAL_ID_TYPE ||
+                  Stage->SetOperands[0].Type == SYMBOL_GLOBAL_ID_TYPE))
+        {
+            //
+            // Only the variables are removed, a move of a register into itself
+            // may change the pins (a port wider than the variables, the pins
+            // above the last port, or all of the pins for a register that is
+            // not a port)
+            //
+            Stage->IsRemoved = TRUE;
+        }
+        else if (Stage->Operator.Value == FUNC_JMP)
+        {
+            //
+            // Jump directly to the target of the targeted jumps
+            //
+            while (Stage->TargetStage < NumberOfStages &&
+                   Stages[Stage->TargetStage].Operator.Value == FUNC_JMP)
+            {
+                Stage->TargetStage = Stages[Stage->TargetStage].TargetStage;
+                Changed            = TRUE;
+            }
+        }
+
+        if (Stage->IsRemoved)
+        {
+            Changed = TRUE;
+        }
+    }
+
+    //
+    // A jump (or a conditional jump) is not needed if all of the stages to its
+    // target are removed (from the end, so the removed jumps are also skipped)
+    //
+    for (UINT32 i = NumberOfStages; i-- > 0;)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage    = &Stages[i];
+        BOOLEAN                 IsNeeded = FALSE;
+
+        if (Stage->IsRemoved || !HwdbgOptimizerIsJump(Stage))
+        {
+            continue;
+        }
+
+        for (UINT32 j = i + 1; j < Stage->TargetStage && j < NumberOfStages; j++)
+        {
+            if (!Stages[j].IsRemoved)
+            {
+                IsNeeded = TRUE;
+                break;
+            }
+        }
+
+        if (!IsNeeded)
+        {
+            Stage->IsRemoved = TRUE;
+            Changed          = TRUE;
+        }
+    }
+
+    return Changed;
+}
+
+/**
+ * @brief Renumber the temporary variables, so the ones that are not live at
+ * the same time share a single variable of the chip
+ *
+ * @param Stages
+ * @param NumberOfStages
+ *
+ * @return UINT32 The number of the needed temporary variables
+ */
+static UINT32
+HwdbgOptimizerRenumberTemps(HWDBG_OPTIMIZER_STAGE * Stages, UINT32 NumberOfStages)
+{
+    UINT64 Interference[HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES] = {0};
+    UINT32 Colors[HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES];
+    UINT64 Colored              = 0;
+    UINT32 NumberOfColors       = 0;
+    UINT64 LiveOnEntry          = NumberOfStages != 0 ? Stages[0].LiveIn : 0;
+
+    //
+    // A written variable interferes with all of the variables that are live
+    // after the stage, and the variables that are read before they are written
+    // interfere with each other
+    //
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+        UINT64                  Written;
+        UINT64                  Live;
+
+        if (Stage->NumberOfSetOperands == 0 || !HwdbgOptimizerIsTemp(&Stage->SetOperands[0]))
+        {
+            continue;
+        }
+
+        Written = Stage->SetOperands[0].Value;
+        Live    = Stage->LiveOut & ~(1ull << Written);
+
+        Interference[Written] |= Live;
+
+        for (UINT32 Temp = 0; Temp < HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES; Temp++)
+        {
+            if (Live & (1ull << Temp))
+            {
+                Interference[Temp] |= 1ull << Written;
+            }
+        }
+    }
+
+    for (UINT32 Temp = 0; Temp < HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES; Temp++)
+    {
+        if (LiveOnEntry & (1ull << Temp))
+        {
+            Interference[Temp] |= LiveOnEntry & ~(1ull << Temp);
+        }
+    }
+
+    //
+    // Give each variable the first number that is not used by the variables
+    // that interfere with it (in the order of their appearance)
+    //
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+
+        for (UINT32 j = 0; j < Stage->NumberOfGetOperands + Stage->NumberOfSetOperands; j++)
+        {
+            SYMBOL * Operand = j < Stage->NumberOfGetOperands ? &Stage->GetOperands[j] : &Stage->SetOperands[j - Stage->NumberOfGetOperands];
+            UINT64   Used    = 0;
+            UINT32   Temp;
+            UINT32   Color;
+
+            if (!HwdbgOptimizerIsTemp(Operand))
+            {
+                continue;
+            }
+
+            Temp = (UINT32)Operand->Value;
+
+            if (!(Colored & (1ull << Temp)))
+            {
+                for (UINT32 Other = 0; Other < HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES; Other++)
+                {
+                    if ((Interference[Temp] & (1ull << Other)) && (Colored & (1ull << Other)))
+                    {
+                        Used |= 1ull << Colors[Other];
+                    }
+                }
+
+                for (Color = 0; Used & (1ull << Color); Color++)
+                {
+                }
+
+                Colors[Temp] = Color;
+                Colored |= 1ull << Temp;
+
+                if (Color + 1 > NumberOfColors)
+                {
+                    NumberOfColors = Color + 1;
+                }
+            }
+
+            Operand->Value = Colors[Temp];
+        }
+    }
+
+    return NumberOfColors;
+}
+
+/**
+ * @brief Optimize the stages of a hwdbg script
+ *
+ * @details The script is only changed if it's optimized successfully, and its
+ * number of symbols never grows. The script should only contain the operators
+ * and the operands that are supported by hwdbg (otherwise it's not optimized)
+ *
+ * @param Symbols The symbols of the script (the optimized script is written back)
+ * @param NumberOfSymbols
+ * @param ScriptVariableLength Length of the script variables of the instance
+ * @param Stages A buffer for the stages (at least HwdbgOptimizerCountStages stages)
+ * @param MaximumNumberOfStages
+ * @param NewNumberOfSymbols Number of the symbols of the optimized script
+ * @param Result
+ *
+ * @return BOOLEAN FALSE if the script is not optimized
+ */
+BOOLEAN
+HwdbgOptimizerOptimizeScript(SYMBOL *                 Symbols,
+                             UINT32                   NumberOfSymbols,
+                             UINT32                   ScriptVariableLength,
+                             HWDBG_OPTIMIZER_STAGE *  Stages,
+                             UINT32                   MaximumNumberOfStages,
+                             UINT32 *                 NewNumberOfSymbols,
+                             HWDBG_OPTIMIZER_RESULT * Result)
+{
+    UINT32 NumberOfStages = 0;
+    UINT32 Index          = 0;
+
+    memset(Result, 0, sizeof(HWDBG_OPTIMIZER_RESULT));
+
+    if (ScriptVariableLength == 0 || ScriptVariableLength > 64 ||
+        !HwdbgOptimizerReadStages(Symbols, NumberOfSymbols, Stages, MaximumNumberOfStages, &NumberOfStages))
+    {
+        return FALSE;
+    }
+
+    Result->NumberOfStagesBefore = NumberOfStages;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        for (UINT32 j = 0; j < Stages[i].NumberOfGetOperands + Stages[i].NumberOfSetOperands; j++)
+        {
+            const SYMBOL * Operand = j < Stages[i].NumberOfGetOperands ? &Stages[i].GetOperands[j] : &Stages[i].SetOperands[j - Stages[i].NumberOfGetOperands];
+
+            if (HwdbgOptimizerIsTemp(Operand) && Operand->Value + 1 > Result->NumberOfTemporaryVariablesBefore)
+            {
+                Result->NumberOfTemporaryVariablesBefore = (UINT32)Operand->Value + 1;
+            }
+        }
+    }
+
+    for (UINT32 Pass = 0; Pass < HWDBG_OPTIMIZER_MAXIMUM_PASSES; Pass++)
+    {
+        BOOLEAN Changed;
+
+        HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+        Changed        = HwdbgOptimizerPropagate(Stages, NumberOfStages, ScriptVariableLength, Result);
+        NumberOfStages = HwdbgOptimizerCompact(Stages, NumberOfStages);
+
+        HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+        Changed |= HwdbgOptimizerForward(Stages, NumberOfStages, Result);
+        NumberOfStages = HwdbgOptimizerCompact(Stages, NumberOfStages);
+
+        HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+        Changed |= HwdbgOptimizerRemoveStages(Stages, NumberOfStages);
+        NumberOfStages = HwdbgOptimizerCompact(Stages, NumberOfStages);
+
+        if (!Changed)
+        {
+            //
+            // Renumbering the temporary variables may turn a move between two
+            // of them into a move of a variable to itself, so these moves are
+            // removed and the stages are optimized again
+            //
+            HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+            HwdbgOptimizerRenumberTemps(Stages, NumberOfStages);
+
+            HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+            Changed        = HwdbgOptimizerRemoveStages(Stages, NumberOfStages);
+            NumberOfStages = HwdbgOptimizerCompact(Stages, NumberOfStages);
+
+            if (!Changed)
+            {
+                break;
+            }
+        }
+    }
+
+    HwdbgOptimizerAnalyze(Stages, NumberOfStages);
+
+    Result->NumberOfTemporaryVariablesAfter = HwdbgOptimizerRenumberTemps(Stages, NumberOfStages);
+    Result->NumberOfStagesAfter             = NumberOfStages;
+    Result->NumberOfRemovedStages           = Result->NumberOfStagesBefore - NumberOfStages - Result->NumberOfForwardedStages;
+
+    //
+    // Set the index of the symbols of the stages, and then write the stages
+    // (with the targets of the jumps as the index of the symbols)
+    //
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        Stages[i].SymbolIndex = Index;
+        Index += 1 + Stages[i].NumberOfGetOperands + Stages[i].NumberOfSetOperands;
+    }
+
+    *NewNumberOfSymbols = Index;
+    Index               = 0;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        HWDBG_OPTIMIZER_STAGE * Stage = &Stages[i];
+
+        if (HwdbgOptimizerIsJump(Stage))
+        {
+            Stage->GetOperands[0].Value = Stage->TargetStage < NumberOfStages ? Stages[Stage->TargetStage].SymbolIndex : *NewNumberOfSymbols;
+        }
+
+        Symbols[Index++] = Stage->Operator;
+
+        for (UINT32 j = 0; j < Stage->NumberOfGetOperands; j++)
+        {
+            Symbols[Index++] = Stage->GetOperands[j];
+        }
+
+        for (UINT32 j = 0; j < Stage->NumberOfSetOperands; j++)
+        {
+            Symbols[Index++] = Stage->SetOperands[j];
+        }
+    }
+
+    return TRUE;
+}
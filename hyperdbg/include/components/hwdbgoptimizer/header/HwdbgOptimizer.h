@@ -0,0 +1,102 @@
+/**
+ * @file HwdbgOptimizer.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the optimizer of the hwdbg script stages
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of the GET and SET operands of the operators that
+ * are supported by hwdbg
+ *
+ */
+#define HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS 2
+#define HWDBG_OPTIMIZER_MAXIMUM_SET_OPERANDS 1
+
+/**
+ * @brief Maximum number of the temporary variables that are tracked (the
+ * live temporary variables are kept as a bitmap)
+ *
+ */
+#define HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES 64
+
+/**
+ * @brief Maximum number of the optimization passes (the passes are repeated
+ * until the stages are not changed anymore)
+ *
+ */
+#define HWDBG_OPTIMIZER_MAXIMUM_PASSES 32
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A stage of a hwdbg script (an operator and its operands)
+ *
+ * @details The targets of the jumps are kept as the index of the target stage
+ * (the number of the stages means the end of the script) and are converted to
+ * the index of the symbols once the script is written again
+ *
+ */
+typedef struct _HWDBG_OPTIMIZER_STAGE
+{
+    SYMBOL  Operator;
+    SYMBOL  GetOperands[HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS];
+    SYMBOL  SetOperands[HWDBG_OPTIMIZER_MAXIMUM_SET_OPERANDS];
+    UINT32  NumberOfGetOperands;
+    UINT32  NumberOfSetOperands;
+    UINT32  SymbolIndex;
+    UINT32  TargetStage;
+    UINT64  LiveIn;  // temporary variables that are live before the stage
+    UINT64  LiveOut; // temporary variables that are live after the stage
+    BOOLEAN IsJumpTarget;
+    BOOLEAN IsReachable;
+    BOOLEAN IsRemoved;
+
+} HWDBG_OPTIMIZER_STAGE, *PHWDBG_OPTIMIZER_STAGE;
+
+/**
+ * @brief Result of optimizing a script
+ *
+ */
+typedef struct _HWDBG_OPTIMIZER_RESULT
+{
+    UINT32 NumberOfStagesBefore;
+    UINT32 NumberOfStagesAfter;
+    UINT32 NumberOfTemporaryVariablesBefore;
+    UINT32 NumberOfTemporaryVariablesAfter;
+    UINT32 NumberOfFoldedStages;    // operators with constant (or identity) operands
+    UINT32 NumberOfForwardedStages; // moves that are merged into the previous operator
+    UINT32 NumberOfRemovedStages;   // dead, unreachable, and no-op stages
+
+} HWDBG_OPTIMIZER_RESULT, *PHWDBG_OPTIMIZER_RESULT;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+HwdbgOptimizerGetNumberOfOperands(UINT64 Operator, UINT32 * NumberOfGetOperands, UINT32 * NumberOfSetOperands);
+
+UINT32
+HwdbgOptimizerCountStages(const SYMBOL * Symbols, UINT32 NumberOfSymbols);
+
+BOOLEAN
+HwdbgOptimizerOptimizeScript(SYMBOL *                 Symbols,
+                             UINT32                   NumberOfSymbols,
+                             UINT32                   ScriptVariableLength,
+                             HWDBG_OPTIMIZER_STAGE *  Stages,
+                             UINT32                   MaximumNumberOfStages,
+                             UINT32 *                 NewNumberOfSymbols,
+                             HWDBG_OPTIMIZER_RESULT * Result);
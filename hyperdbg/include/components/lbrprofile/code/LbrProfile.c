@@ -0,0 +1,780 @@
+/**
+ * @file LbrProfile.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Aggregating the samples of the LBR into branch and call profiles
+ * @details The samples are taken by the hypertrace (in the order of the MSRs)
+ * and this component puts their branches in the order of the execution, folds
+ * them into the counts of the edges and the call chains, and summarizes the
+ * edges for each function. It has no dependency on the platform, so the same
+ * code reads the samples of the debugger and the recorded files in the
+ * user-mode tests
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Mix the bits of a value (the finalizer of splitmix64)
+ *
+ * @param Value
+ *
+ * @return UINT64
+ */
+static UINT64
+LbrProfileMix(UINT64 Value)
+{
+    Value ^= Value >> 30;
+    Value *= 0xbf58476d1ce4e5b9ull;
+    Value ^= Value >> 27;
+    Value *= 0x94d049bb133111ebull;
+    Value ^= Value >> 31;
+
+    return Value;
+}
+
+/**
+ * @brief Check whether a branch type is a call
+ *
+ * @param BranchType
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+LbrProfileIsCall(UINT32 BranchType)
+{
+    return BranchType == LBR_BR_TYPE_CALL_DIRECT || BranchType == LBR_BR_TYPE_CALL_INDIRECT;
+}
+
+/**
+ * @brief Get the size of a sample (including its header)
+ *
+ * @param NumberOfEntries
+ *
+ * @return UINT32
+ */
+UINT32
+LbrProfileGetSampleSize(UINT32 NumberOfEntries)
+{
+    return sizeof(LBR_SAMPLE_HEADER) + NumberOfEntries * sizeof(LBR_SAMPLE_ENTRY);
+}
+
+/**
+ * @brief Validate the sample at the start of a buffer
+ *
+ * @param Sample
+ * @param Size Size of the buffer
+ *
+ * @return UINT32 Size of the sample, or zero if the sample is not valid
+ */
+UINT32
+LbrProfileValidateSample(const VOID * Sample, UINT64 Size)
+{
+    const LBR_SAMPLE_HEADER * Header = (const LBR_SAMPLE_HEADER *)Sample;
+    UINT32                    SampleSize;
+
+    if (Size < sizeof(LBR_SAMPLE_HEADER))
+    {
+        return 0;
+    }
+
+    if (Header->NumberOfEntries == 0 || Header->NumberOfEntries > MAXIMUM_LBR_CAPACITY || Header->ArchBasedLbr > 1)
+    {
+        return 0;
+    }
+
+    //
+    // The arch LBR has no top of the stack
+    //
+    if (!Header->ArchBasedLbr && Header->Tos >= Header->NumberOfEntries)
+    {
+        return 0;
+    }
+
+    SampleSize = LbrProfileGetSampleSize(Header->NumberOfEntries);
+
+    if (Size < SampleSize)
+    {
+        return 0;
+    }
+
+    return SampleSize;
+}
+
+/**
+ * @brief Put the branches of a sample in the order of the execution
+ *
+ * @details In the legacy LBR, the most recent branch is at the top of the
+ * stack and the entries are circular, and in the arch LBR the most recent
+ * branch is always the first entry. The entries that are not written yet (or
+ * are cleared) are skipped
+ *
+ * @param Sample A sample (followed by its entries)
+ * @param Branches MAXIMUM_LBR_CAPACITY branches (the oldest branch first)
+ *
+ * @return UINT32 Count of the branches
+ */
+UINT32
+LbrProfileNormalizeSample(const LBR_SAMPLE_HEADER * Sample, LBR_PROFILE_BRANCH * Branches)
+{
+    const LBR_SAMPLE_ENTRY * Entries          = (const LBR_SAMPLE_ENTRY *)(Sample + 1);
+    UINT32                   NumberOfEntries  = Sample->NumberOfEntries;
+    UINT32                   NumberOfBranches = 0;
+
+    if (NumberOfEntries > MAXIMUM_LBR_CAPACITY)
+    {
+        NumberOfEntries = MAXIMUM_LBR_CAPACITY;
+    }
+
+    for (UINT32 i = 1; i <= NumberOfEntries; i++)
+    {
+        const LBR_SAMPLE_ENTRY * Entry;
+        LBR_PROFILE_BRANCH *     Branch;
+
+        if (Sample->ArchBasedLbr)
+        {
+            Entry = &Entries[NumberOfEntries - i];
+        }
+        else
+        {
+            Entry = &Entries[(Sample->Tos + i) % NumberOfEntries];
+        }
+
+        if (Entry->From == 0 && Entry->To == 0)
+        {
+            continue;
+        }
+
+        Branch               = &Branches[NumberOfBranches++];
+        Branch->From         = Entry->From;
+        Branch->To           = Entry->To;
+        Branch->Cycles       = (UINT32)Entry->Info.CycleCount;
+        Branch->Mispredicted = (BOOLEAN)Entry->Info.Mispred;
+
+        if (Sample->ArchBasedLbr)
+        {
+            Branch->BranchType  = (UINT32)Entry->Info.BrType_OnlyArchLbr;
+            Branch->CyclesValid = (BOOLEAN)Entry->Info.CycCntValid_OnlyArchLbr;
+        }
+        else
+        {
+            //
+            // The legacy LBR has no type and no valid bit, the count of the
+            // cycles is zero on the processors that don't record it
+            //
+            Branch->BranchType  = LBR_PROFILE_UNKNOWN_BRANCH_TYPE;
+            Branch->CyclesValid = Branch->Cycles != 0;
+        }
+    }
+
+    return NumberOfBranches;
+}
+
+/**
+ * @brief Build the call chain of the branches of a sample
+ *
+ * @details The calls push their targets and the returns pop them, so the
+ * remaining targets are the calls that are still active at the time of the
+ * sample (the returns of the calls before the sample are ignored). Only the
+ * arch LBR records the types of the branches
+ *
+ * @param Branches The branches in the order of the execution
+ * @param NumberOfBranches
+ * @param Frames LBR_PROFILE_MAXIMUM_CHAIN_DEPTH frames (the innermost first)
+ *
+ * @return UINT32 Depth of the chain
+ */
+UINT32
+LbrProfileBuildChain(const LBR_PROFILE_BRANCH * Branches, UINT32 NumberOfBranches, UINT64 * Frames)
+{
+    UINT64 Stack[MAXIMUM_LBR_CAPACITY];
+    UINT32 Depth = 0;
+    UINT32 ChainDepth;
+
+    for (UINT32 i = 0; i < NumberOfBranches && i < MAXIMUM_LBR_CAPACITY; i++)
+    {
+        if (LbrProfileIsCall(Branches[i].BranchType))
+        {
+            Stack[Depth++] = Branches[i].To;
+        }
+        else if (Branches[i].BranchType == LBR_BR_TYPE_RET && Depth != 0)
+        {
+            Depth--;
+        }
+    }
+
+    ChainDepth = Depth < LBR_PROFILE_MAXIMUM_CHAIN_DEPTH ? Depth : LBR_PROFILE_MAXIMUM_CHAIN_DEPTH;
+
+    for (UINT32 i = 0; i < ChainDepth; i++)
+    {
+        Frames[i] = Stack[Depth - 1 - i];
+    }
+
+    return ChainDepth;
+}
+
+/**
+ * @brief Get the size of the buffer of a profile
+ *
+ * @param EdgeTableSize Entries of the table of the edges (a power of two)
+ * @param ChainTableSize Entries of the table of the chains (a power of two)
+ *
+ * @return SIZE_T
+ */
+SIZE_T
+LbrProfileGetBufferSize(UINT32 EdgeTableSize, UINT32 ChainTableSize)
+{
+    return (SIZE_T)EdgeTableSize * sizeof(LBR_PROFILE_EDGE) + (SIZE_T)ChainTableSize * sizeof(LBR_PROFILE_CHAIN);
+}
+
+/**
+ * @brief Initialize an empty profile
+ *
+ * @param Profile
+ * @param EdgeTableSize Entries of the table of the edges (a power of two)
+ * @param ChainTableSize Entries of the table of the chains (a power of two)
+ * @param Buffer A buffer of LbrProfileGetBufferSize bytes (8-byte aligned)
+ * @param BufferSize
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LbrProfileInitialize(LBR_PROFILE * Profile, UINT32 EdgeTableSize, UINT32 ChainTableSize, PVOID Buffer, SIZE_T BufferSize)
+{
+    if (EdgeTableSize < 4 || (EdgeTableSize & (EdgeTableSize - 1)) != 0 ||
+        ChainTableSize < 4 || (ChainTableSize & (ChainTableSize - 1)) != 0 ||
+        BufferSize < LbrProfileGetBufferSize(EdgeTableSize, ChainTableSize))
+    {
+        return FALSE;
+    }
+
+    memset(Profile, 0, sizeof(LBR_PROFILE));
+    memset(Buffer, 0, LbrProfileGetBufferSize(EdgeTableSize, ChainTableSize));
+
+    Profile->Edges          = (LBR_PROFILE_EDGE *)Buffer;
+    Profile->Chains         = (LBR_PROFILE_CHAIN *)(Profile->Edges + EdgeTableSize);
+    Profile->EdgeTableSize  = EdgeTableSize;
+    Profile->ChainTableSize = ChainTableSize;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a branch to the table of the edges
+ *
+ * @param Profile
+ * @param Branch
+ *
+ * @return VOID
+ */
+static VOID
+LbrProfileAddEdge(LBR_PROFILE * Profile, const LBR_PROFILE_BRANCH * Branch)
+{
+    UINT32             Mask  = Profile->EdgeTableSize - 1;
+    UINT32             Index = (UINT32)LbrProfileMix(Branch->From ^ LbrProfileMix(Branch->To)) & Mask;
+    LBR_PROFILE_EDGE * Edge;
+
+    for (;;)
+    {
+        Edge = &Profile->Edges[Index];
+
+        if (Edge->Count == 0)
+        {
+            //
+            // A new edge, the table is kept at most three-quarters full
+            //
+            if (Profile->NumberOfEdges >= Profile->EdgeTableSize - Profile->EdgeTableSize / 4)
+            {
+                Profile->DroppedEdges++;
+                return;
+            }
+
+            Edge->From       = Branch->From;
+            Edge->To         = Branch->To;
+            Edge->BranchType = Branch->BranchType;
+            Profile->NumberOfEdges++;
+            break;
+        }
+
+        if (Edge->From == Branch->From && Edge->To == Branch->To)
+        {
+            break;
+        }
+
+        Index = (Index + 1) & Mask;
+    }
+
+    Edge->Count++;
+    Edge->Mispredicted += Branch->Mispredicted ? 1 : 0;
+
+    if (Branch->CyclesValid)
+    {
+        Edge->Cycles += Branch->Cycles;
+        Edge->CycleSamples++;
+    }
+}
+
+/**
+ * @brief Add a call chain to the table of the chains
+ *
+ * @param Profile
+ * @param Frames
+ * @param Depth
+ *
+ * @return VOID
+ */
+static VOID
+LbrProfileAddChain(LBR_PROFILE * Profile, const UINT64 * Frames, UINT32 Depth)
+{
+    UINT32              Mask = Profile->ChainTableSize - 1;
+    UINT64              Hash = Depth;
+    UINT32              Index;
+    LBR_PROFILE_CHAIN * Chain;
+
+    for (UINT32 i = 0; i < Depth; i++)
+    {
+        Hash = LbrProfileMix(Hash ^ Frames[i]);
+    }
+
+    Index = (UINT32)Hash & Mask;
+
+    for (;;)
+    {
+        Chain = &Profile->Chains[Index];
+
+        if (Chain->Depth == 0)
+        {
+            if (Profile->NumberOfChains >= Profile->ChainTableSize - Profile->ChainTableSize / 4)
+            {
+                Profile->DroppedChains++;
+                return;
+            }
+
+            Chain->Hash  = Hash;
+            Chain->Depth = Depth;
+            memcpy(Chain->Frames, Frames, Depth * sizeof(UINT64));
+            Profile->NumberOfChains++;
+            break;
+        }
+
+        if (Chain->Hash == Hash && Chain->Depth == Depth && memcmp(Chain->Frames, Frames, Depth * sizeof(UINT64)) == 0)
+        {
+            break;
+        }
+
+        Index = (Index + 1) & Mask;
+    }
+
+    Chain->Count++;
+}
+
+/**
+ * @brief Add a sample to the profile
+ *
+ * @param Profile
+ * @param Sample A validated sample (followed by its entries)
+ *
+ * @return BOOLEAN FALSE if the profile is already finalized
+ */
+BOOLEAN
+LbrProfileAddSample(LBR_PROFILE * Profile, const LBR_SAMPLE_HEADER * Sample)
+{
+    LBR_PROFILE_BRANCH Branches[MAXIMUM_LBR_CAPACITY];
+    UINT64             Frames[LBR_PROFILE_MAXIMUM_CHAIN_DEPTH];
+    UINT32             NumberOfBranches;
+    UINT32             Depth;
+
+    if (Profile->IsFinalized)
+    {
+        return FALSE;
+    }
+
+    NumberOfBranches = LbrProfileNormalizeSample(Sample, Branches);
+
+    for (UINT32 i = 0; i < NumberOfBranches; i++)
+    {
+        LbrProfileAddEdge(Profile, &Branches[i]);
+    }
+
+    Depth = LbrProfileBuildChain(Branches, NumberOfBranches, Frames);
+
+    if (Depth != 0)
+    {
+        LbrProfileAddChain(Profile, Frames, Depth);
+    }
+
+    Profile->NumberOfSamples++;
+    Profile->NumberOfBranches += NumberOfBranches;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a buffer of consecutive samples to the profile
+ *
+ * @param Profile
+ * @param Samples
+ * @param Size
+ * @param NumberOfSamples Count of the added samples (optional)
+ *
+ * @return BOOLEAN FALSE if a sample is not valid (the previous samples are
+ * added)
+ */
+BOOLEAN
+LbrProfileAddSamples(LBR_PROFILE * Profile, const VOID * Samples, UINT64 Size, UINT64 * NumberOfSamples)
+{
+    const BYTE * Current = (const BYTE *)Samples;
+    UINT64       Added   = 0;
+    BOOLEAN      Result  = TRUE;
+
+    while (Size != 0)
+    {
+        UINT32 SampleSize = LbrProfileValidateSample(Current, Size);
+
+        if (SampleSize == 0 || !LbrProfileAddSample(Profile, (const LBR_SAMPLE_HEADER *)Current))
+        {
+            Result = FALSE;
+            break;
+        }
+
+        Current += SampleSize;
+        Size -= SampleSize;
+        Added++;
+    }
+
+    if (NumberOfSamples != NULL)
+    {
+        *NumberOfSamples = Added;
+    }
+
+    return Result;
+}
+
+//
+// The edges and the chains with the same counts are sorted by their keys, so
+// the order doesn't depend on the sizes of the tables
+//
+
+static int
+LbrProfileCompareEdges(const void * First, const void * Second)
+{
+    const LBR_PROFILE_EDGE * A = (const LBR_PROFILE_EDGE *)First;
+    const LBR_PROFILE_EDGE * B = (const LBR_PROFILE_EDGE *)Second;
+
+    if (A->Count != B->Count)
+        return A->Count > B->Count ? -1 : 1;
+
+    if (A->From != B->From)
+        return A->From < B->From ? -1 : 1;
+
+    return A->To < B->To ? -1 : A->To > B->To;
+}
+
+static int
+LbrProfileCompareChains(const void * First, const void * Second)
+{
+    const LBR_PROFILE_CHAIN * A = (const LBR_PROFILE_CHAIN *)First;
+    const LBR_PROFILE_CHAIN * B = (const LBR_PROFILE_CHAIN *)Second;
+
+    if (A->Count != B->Count)
+        return A->Count > B->Count ? -1 : 1;
+
+    if (A->Depth != B->Depth)
+        return A->Depth < B->Depth ? -1 : 1;
+
+    for (UINT32 i = 0; i < A->Depth; i++)
+    {
+        if (A->Frames[i] != B->Frames[i])
+            return A->Frames[i] < B->Frames[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static int
+LbrProfileCompareSummaries(const void * First, const void * Second)
+{
+    const LBR_PROFILE_FUNCTION_SUMMARY * A = (const LBR_PROFILE_FUNCTION_SUMMARY *)First;
+    const LBR_PROFILE_FUNCTION_SUMMARY * B = (const LBR_PROFILE_FUNCTION_SUMMARY *)Second;
+
+    if (A->Cycles != B->Cycles)
+        return A->Cycles > B->Cycles ? -1 : 1;
+
+    if (A->Branches != B->Branches)
+        return A->Branches > B->Branches ? -1 : 1;
+
+    return A->Function < B->Function ? -1 : A->Function > B->Function;
+}
+
+/**
+ * @brief Finalize the profile (no sample can be added after it)
+ *
+ * @details The used entries are moved to the start of the tables and sorted
+ * by their counts (the most frequent first)
+ *
+ * @param Profile
+ *
+ * @return VOID
+ */
+VOID
+LbrProfileFinalize(LBR_PROFILE * Profile)
+{
+    UINT32 Used = 0;
+
+    if (Profile->IsFinalized)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < Profile->EdgeTableSize; i++)
+    {
+        if (Profile->Edges[i].Count != 0)
+        {
+            Profile->Edges[Used++] = Profile->Edges[i];
+        }
+    }
+
+    qsort(Profile->Edges, Used, sizeof(LBR_PROFILE_EDGE), LbrProfileCompareEdges);
+
+    Used = 0;
+
+    for (UINT32 i = 0; i < Profile->ChainTableSize; i++)
+    {
+        if (Profile->Chains[i].Depth != 0)
+        {
+            Profile->Chains[Used++] = Profile->Chains[i];
+        }
+    }
+
+    qsort(Profile->Chains, Used, sizeof(LBR_PROFILE_CHAIN), LbrProfileCompareChains);
+
+    Profile->IsFinalized = TRUE;
+}
+
+/**
+ * @brief Find the function of an address
+ *
+ * @param Functions The ranges of the functions (sorted by their starts)
+ * @param NumberOfFunctions
+ * @param Address
+ *
+ * @return UINT32 Index of the function, or LBR_PROFILE_NO_FUNCTION
+ */
+UINT32
+LbrProfileFindFunction(const LBR_PROFILE_FUNCTION_RANGE * Functions, UINT32 NumberOfFunctions, UINT64 Address)
+{
+    UINT32 Low  = 0;
+    UINT32 High = NumberOfFunctions;
+
+    //
+    // Find the first function that starts after the address
+    //
+    while (Low < High)
+    {
+        UINT32 Middle = Low + (High - Low) / 2;
+
+        if (Functions[Middle].Start <= Address)
+        {
+            Low = Middle + 1;
+        }
+        else
+        {
+            High = Middle;
+        }
+    }
+
+    if (Low == 0 || Address - Functions[Low - 1].Start >= Functions[Low - 1].Size)
+    {
+        return LBR_PROFILE_NO_FUNCTION;
+    }
+
+    return Low - 1;
+}
+
+/**
+ * @brief Add an edge to a summary
+ *
+ * @param Summary
+ * @param Edge
+ *
+ * @return VOID
+ */
+static VOID
+LbrProfileAddEdgeToSummary(LBR_PROFILE_FUNCTION_SUMMARY * Summary, const LBR_PROFILE_EDGE * Edge)
+{
+    Summary->Branches += Edge->Count;
+    Summary->Mispredicted += Edge->Mispredicted;
+    Summary->Cycles += Edge->Cycles;
+    Summary->CycleSamples += Edge->CycleSamples;
+}
+
+/**
+ * @brief Summarize the edges of the profile for each function
+ *
+ * @details All of the functions are resolved by a binary search on the same
+ * sorted ranges (the symbols are converted into the ranges once)
+ *
+ * @param Profile
+ * @param Functions The ranges of the functions (sorted by their starts)
+ * @param NumberOfFunctions
+ * @param Summaries NumberOfFunctions summaries, the summaries of the active
+ * functions are put at the start (the most cycles first)
+ * @param Unresolved The summary of the addresses out of the functions (optional)
+ *
+ * @return UINT32 Count of the active functions
+ */
+UINT32
+LbrProfileSummarizeFunctions(const LBR_PROFILE *                Profile,
+                             const LBR_PROFILE_FUNCTION_RANGE * Functions,
+                             UINT32                             NumberOfFunctions,
+                             LBR_PROFILE_FUNCTION_SUMMARY *     Summaries,
+                             LBR_PROFILE_FUNCTION_SUMMARY *     Unresolved)
+{
+    LBR_PROFILE_FUNCTION_SUMMARY Outside;
+    UINT32                       NumberOfEntries;
+    UINT32                       Active = 0;
+
+    memset(&Outside, 0, sizeof(LBR_PROFILE_FUNCTION_SUMMARY));
+    Outside.Function = LBR_PROFILE_NO_FUNCTION;
+
+    memset(Summaries, 0, NumberOfFunctions * sizeof(LBR_PROFILE_FUNCTION_SUMMARY));
+
+    for (UINT32 i = 0; i < NumberOfFunctions; i++)
+    {
+        Summaries[i].Function = i;
+    }
+
+    NumberOfEntries = Profile->IsFinalized ? Profile->NumberOfEdges : Profile->EdgeTableSize;
+
+    for (UINT32 i = 0; i < NumberOfEntries; i++)
+    {
+        const LBR_PROFILE_EDGE * Edge = &Profile->Edges[i];
+        UINT32                   Function;
+
+        if (Edge->Count == 0)
+        {
+            continue;
+        }
+
+        Function = LbrProfileFindFunction(Functions, NumberOfFunctions, Edge->From);
+
+        LbrProfileAddEdgeToSummary(Function == LBR_PROFILE_NO_FUNCTION ? &Outside : &Summaries[Function], Edge);
+
+        if (LbrProfileIsCall(Edge->BranchType))
+        {
+            Function = LbrProfileFindFunction(Functions, NumberOfFunctions, Edge->To);
+
+            if (Function == LBR_PROFILE_NO_FUNCTION)
+            {
+                Outside.Calls += Edge->Count;
+            }
+            else
+            {
+                Summaries[Function].Calls += Edge->Count;
+            }
+        }
+    }
+
+    for (UINT32 i = 0; i < NumberOfFunctions; i++)
+    {
+        if (Summaries[i].Branches != 0 || Summaries[i].Calls != 0)
+        {
+            Summaries[Active++] = Summaries[i];
+        }
+    }
+
+    qsort(Summaries, Active, sizeof(LBR_PROFILE_FUNCTION_SUMMARY), LbrProfileCompareSummaries);
+
+    if (Unresolved != NULL)
+    {
+        *Unresolved = Outside;
+    }
+
+    return Active;
+}
+
+/**
+ * @brief Initialize the header of a file of the samples
+ *
+ * @param Header
+ * @param NumberOfSamples Count of the samples that follow the header
+ * @param DroppedSamples Count of the samples that are dropped by the rings
+ *
+ * @return VOID
+ */
+VOID
+LbrProfileInitializeFileHeader(LBR_PROFILE_FILE_HEADER * Header, UINT64 NumberOfSamples, UINT64 DroppedSamples)
+{
+    memset(Header, 0, sizeof(LBR_PROFILE_FILE_HEADER));
+
+    Header->Magic           = LBR_PROFILE_FILE_MAGIC;
+    Header->Version         = LBR_PROFILE_FILE_VERSION;
+    Header->NumberOfSamples = NumberOfSamples;
+    Header->DroppedSamples  = DroppedSamples;
+}
+
+/**
+ * @brief Validate a file of the samples
+ *
+ * @details All of the samples are validated and their count should be the
+ * same as the header
+ *
+ * @param File
+ * @param FileSize
+ * @param Samples The first sample
+ * @param SamplesSize Size of the samples
+ * @param NumberOfSamples
+ * @param DroppedSamples
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LbrProfileReadFile(const VOID *  File,
+                   UINT64        FileSize,
+                   const VOID ** Samples,
+                   UINT64 *      SamplesSize,
+                   UINT64 *      NumberOfSamples,
+                   UINT64 *      DroppedSamples)
+{
+    const LBR_PROFILE_FILE_HEADER * Header = (const LBR_PROFILE_FILE_HEADER *)File;
+    const BYTE *                    Current;
+    UINT64                          Remaining;
+    UINT64                          Count = 0;
+
+    if (FileSize < sizeof(LBR_PROFILE_FILE_HEADER) || Header->Magic != LBR_PROFILE_FILE_MAGIC ||
+        Header->Version != LBR_PROFILE_FILE_VERSION)
+    {
+        return FALSE;
+    }
+
+    Current   = (const BYTE *)(Header + 1);
+    Remaining = FileSize - sizeof(LBR_PROFILE_FILE_HEADER);
+
+    while (Remaining != 0)
+    {
+        UINT32 SampleSize = LbrProfileValidateSample(Current, Remaining);
+
+        if (SampleSize == 0)
+        {
+            return FALSE;
+        }
+
+        Current += SampleSize;
+        Remaining -= SampleSize;
+        Count++;
+    }
+
+    if (Count != Header->NumberOfSamples)
+    {
+        return FALSE;
+    }
+
+    *Samples         = Header + 1;
+    *SamplesSize     = FileSize - sizeof(LBR_PROFILE_FILE_HEADER);
+    *NumberOfSamples = Header->NumberOfSamples;
+    *DroppedSamples  = Header->DroppedSamples;
+
+    return TRUE;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file LbrProfile.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for aggregating the samples of the LBR into branch and call profiles
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Magic of the files of the LBR samples ('HDLS')
+ *
+ */
+#define LBR_PROFILE_FILE_MAGIC 0x534c4448
+
+/**
+ * @brief Version of the format of the files of the LBR samples
+ *
+ */
+#define LBR_PROFILE_FILE_VERSION 1
+
+/**
+ * @brief Maximum depth of the call chains (the outer frames are cut)
+ *
+ */
+#define LBR_PROFILE_MAXIMUM_CHAIN_DEPTH 8
+
+/**
+ * @brief Branch type of the branches of the legacy LBR (no type is recorded)
+ *
+ */
+#define LBR_PROFILE_UNKNOWN_BRANCH_TYPE 0xffffffff
+
+/**
+ * @brief Shows that an address is not in any of the functions
+ *
+ */
+#define LBR_PROFILE_NO_FUNCTION 0xffffffff
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A branch of a sample in the order of the execution
+ *
+ */
+typedef struct _LBR_PROFILE_BRANCH
+{
+    UINT64  From;
+    UINT64  To;
+    UINT32  BranchType; // LBR_BR_TYPE_* or LBR_PROFILE_UNKNOWN_BRANCH_TYPE
+    UINT32  Cycles;     // cycles since the previous branch (if CyclesValid)
+    BOOLEAN CyclesValid;
+    BOOLEAN Mispredicted;
+
+} LBR_PROFILE_BRANCH, *PLBR_PROFILE_BRANCH;
+
+/**
+ * @brief Aggregated statistics of a single branch (edge)
+ *
+ */
+typedef struct _LBR_PROFILE_EDGE
+{
+    UINT64 From;
+    UINT64 To;
+    UINT64 Count;
+    UINT64 Mispredicted;
+    UINT64 Cycles;
+    UINT64 CycleSamples; // count of the branches with valid cycles
+    UINT32 BranchType;
+    UINT32 Reserved;
+
+} LBR_PROFILE_EDGE, *PLBR_PROFILE_EDGE;
+
+/**
+ * @brief Aggregated count of a call chain
+ *
+ * @details The frames are the targets of the calls that are not returned in
+ * the sample, Frames[0] is the innermost call
+ *
+ */
+typedef struct _LBR_PROFILE_CHAIN
+{
+    UINT64 Hash;
+    UINT64 Count;
+    UINT32 Depth; // zero for the unused entries of the table
+    UINT32 Reserved;
+    UINT64 Frames[LBR_PROFILE_MAXIMUM_CHAIN_DEPTH];
+
+} LBR_PROFILE_CHAIN, *PLBR_PROFILE_CHAIN;
+
+/**
+ * @brief Range of a function (sorted by the start address)
+ *
+ */
+typedef struct _LBR_PROFILE_FUNCTION_RANGE
+{
+    UINT64 Start;
+    UINT64 Size;
+
+} LBR_PROFILE_FUNCTION_RANGE, *PLBR_PROFILE_FUNCTION_RANGE;
+
+/**
+ * @brief Branch statistics of a function
+ *
+ * @details The branches, the mispredictions and the cycles are counted for
+ * the function of the source of the branches, and the calls are counted for
+ * the function of the target of the calls
+ *
+ */
+typedef struct _LBR_PROFILE_FUNCTION_SUMMARY
+{
+    UINT32 Function; // index of the range (or LBR_PROFILE_NO_FUNCTION)
+    UINT32 Reserved;
+    UINT64 Branches;
+    UINT64 Mispredicted;
+    UINT64 Cycles;
+    UINT64 CycleSamples;
+    UINT64 Calls;
+
+} LBR_PROFILE_FUNCTION_SUMMARY, *PLBR_PROFILE_FUNCTION_SUMMARY;
+
+/**
+ * @brief The aggregated profile
+ *
+ * @details The edges and the chains are kept in open-addressing tables in the
+ * buffer of the caller, a new edge or chain is dropped (and counted) when its
+ * table is three-quarters full. After finalizing, the edges and the chains are
+ * at the start of their tables, sorted by their counts
+ *
+ */
+typedef struct _LBR_PROFILE
+{
+    LBR_PROFILE_EDGE *  Edges;
+    LBR_PROFILE_CHAIN * Chains;
+    UINT32              EdgeTableSize;  // a power of two
+    UINT32              ChainTableSize; // a power of two
+    UINT32              NumberOfEdges;
+    UINT32              NumberOfChains;
+    BOOLEAN             IsFinalized;
+
+    UINT64 NumberOfSamples;
+    UINT64 NumberOfBranches;
+    UINT64 DroppedSamples; // reported by the rings (or the file)
+    UINT64 DroppedEdges;
+    UINT64 DroppedChains;
+
+} LBR_PROFILE, *PLBR_PROFILE;
+
+/**
+ * @brief Header of a file of the LBR samples
+ *
+ * @details The header is followed by the samples (LBR_SAMPLE_HEADER and its
+ * entries)
+ *
+ */
+typedef struct _LBR_PROFILE_FILE_HEADER
+{
+    UINT32 Magic;
+    UINT32 Version;
+    UINT64 NumberOfSamples;
+    UINT64 DroppedSamples;
+
+} LBR_PROFILE_FILE_HEADER, *PLBR_PROFILE_FILE_HEADER;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT32
+LbrProfileGetSampleSize(UINT32 NumberOfEntries);
+
+UINT32
+LbrProfileValidateSample(const VOID * Sample, UINT64 Size);
+
+UINT32
+LbrProfileNormalizeSample(const LBR_SAMPLE_HEADER * Sample, LBR_PROFILE_BRANCH * Branches);
+
+UINT32
+LbrProfileBuildChain(const LBR_PROFILE_BRANCH * Branches, UINT32 NumberOfBranches, UINT64 * Frames);
+
+SIZE_T
+LbrProfileGetBufferSize(UINT32 EdgeTableSize, UINT32 ChainTableSize);
+
+BOOLEAN
+LbrProfileInitialize(LBR_PROFILE * Profile, UINT32 EdgeTableSize, UINT32 ChainTableSize, PVOID Buffer, SIZE_T BufferSize);
+
+BOOLEAN
+LbrProfileAddSample(LBR_PROFILE * Profile, const LBR_SAMPLE_HEADER * Sample);
+
+BOOLEAN
+LbrProfileAddSamples(LBR_PROFILE * Profile, const VOID * Samples, UINT64 Size, UINT64 * NumberOfSamples);
+
+VOID
+LbrProfileFinalize(LBR_PROFILE * Profile);
+
+UINT32
+LbrProfileFindFunction(const LBR_PROFILE_FUNCTION_RANGE * Functions, UINT32 NumberOfFunctions, UINT64 Address);
+
+UINT32
+LbrProfileSummarizeFunctions(const LBR_PROFILE *                Profile,
+                             const LBR_PROFILE_FUNCTION_RANGE * Functions,
+                             UINT32                             NumberOfFunctions,
+                             LBR_PROFILE_FUNCTION_SUMMARY *     Summaries,
+                             LBR_PROFILE_FUNCTION_SUMMARY *     Unresolved);
+
+VOID
+LbrProfileInitializeFileHeader(LBR_PROFILE_FILE_HEADER * Header, UINT64 NumberOfSamples, UINT64 DroppedSamples);
+
+BOOLEAN
+LbrProfileReadFile(const VOID *  File,
+                   UINT64        FileSize,
+                   const VOID ** Samples,
+                   UINT64 *      SamplesSize,
+                   UINT64 *      NumberOfSamples,
+                   UINT64 *      DroppedSamples);
@@ -0,0 +1,243 @@
+/**
+ * @file LogRing.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Single-producer rings of variable-length log records
+ * @details Each core writes its messages into its own ring without taking
+ * any lock, and the reader takes the records of all of the rings in the
+ * order of their time-stamps. The rings have no dependency on the platform,
+ * so they're used both in the kernel (hyperlog) and in the user-mode tests
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the size of a record in the ring (including its header)
+ *
+ * @param Length Length of the data of the record
+ *
+ * @return UINT32
+ */
+UINT32
+LogRingGetRecordSize(UINT32 Length)
+{
+    return (UINT32)((sizeof(LOG_RING_RECORD) + Length + LOG_RING_ALIGNMENT - 1) & ~(LOG_RING_ALIGNMENT - 1));
+}
+
+/**
+ * @brief Initialize a ring
+ *
+ * @param Ring
+ * @param Buffer Memory of the ring (kept by the ring)
+ * @param Size Size of the buffer, a power of two (at least LOG_RING_MINIMUM_SIZE)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LogRingInitialize(PLOG_RING Ring, PVOID Buffer, UINT32 Size)
+{
+    if (Buffer == NULL || Size < LOG_RING_MINIMUM_SIZE || (Size & (Size - 1)) != 0)
+    {
+        return FALSE;
+    }
+
+    memset(Ring, 0, sizeof(LOG_RING));
+
+    Ring->Buffer = (UINT8 *)Buffer;
+    Ring->Size   = Size;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the number of the bytes that a record needs at the head
+ * (including the padding at the end of the ring)
+ *
+ * @param Ring
+ * @param Head
+ * @param RecordSize
+ *
+ * @return UINT32
+ */
+static UINT32
+LogRingGetNeededSpace(PLOG_RING Ring, UINT64 Head, UINT32 RecordSize)
+{
+    UINT32 Contiguous = Ring->Size - (UINT32)(Head & (Ring->Size - 1));
+
+    return RecordSize <= Contiguous ? RecordSize : Contiguous + RecordSize;
+}
+
+/**
+ * @brief Write a record to the ring (only called by the producer)
+ *
+ * @param Ring
+ * @param OperationCode
+ * @param TimeStamp
+ * @param Buffer Data of the record
+ * @param Length Length of the data
+ *
+ * @return BOOLEAN FALSE if the record is dropped
+ */
+BOOLEAN
+LogRingWrite(PLOG_RING Ring, UINT32 OperationCode, UINT64 TimeStamp, const VOID * Buffer, UINT32 Length)
+{
+    UINT64            Head       = Ring->Head;
+    UINT64            Tail       = AtomicLoadAcquire64(&Ring->Tail);
+    UINT32            RecordSize = LogRingGetRecordSize(Length);
+    UINT32            Offset     = (UINT32)(Head & (Ring->Size - 1));
+    LOG_RING_RECORD * Record;
+
+    //
+    // The records are at most half of the ring, so the ring never has to wrap
+    // more than once for a record
+    //
+    if (RecordSize > Ring->Size / 2 ||
+        LogRingGetNeededSpace(Ring, Head, RecordSize) > Ring->Size - (UINT32)(Head - Tail))
+    {
+        Ring->DroppedRecords++;
+        return FALSE;
+    }
+
+    //
+    // Fill the end of the ring if the record doesn't fit there
+    //
+    if (RecordSize > Ring->Size - Offset)
+    {
+        Record                = (LOG_RING_RECORD *)(Ring->Buffer + Offset);
+        Record->TimeStamp     = 0;
+        Record->OperationCode = LOG_RING_PADDING_RECORD;
+        Record->Length        = Ring->Size - Offset - sizeof(LOG_RING_RECORD);
+
+        Head += Ring->Size - Offset;
+        Offset = 0;
+    }
+
+    Record                = (LOG_RING_RECORD *)(Ring->Buffer + Offset);
+    Record->TimeStamp     = TimeStamp;
+    Record->OperationCode = OperationCode;
+    Record->Length        = Length;
+
+    memcpy(Record + 1, Buffer, Length);
+
+    //
+    // Publish the record (and the padding) to the consumer
+    //
+    AtomicStoreRelease64(&Ring->Head, Head + RecordSize);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the ring has space for a record (only called by the
+ * producer)
+ *
+ * @param Ring
+ * @param Length Length of the data of the record
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LogRingHasSpace(PLOG_RING Ring, UINT32 Length)
+{
+    UINT64 Head = Ring->Head;
+    UINT64 Tail = AtomicLoadAcquire64(&Ring->Tail);
+
+    return LogRingGetNeededSpace(Ring, Head, LogRingGetRecordSize(Length)) <= Ring->Size - (UINT32)(Head - Tail);
+}
+
+/**
+ * @brief Check whether the ring has no record (a ring that only has a padding
+ * record is not empty)
+ *
+ * @param Ring
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+LogRingIsEmpty(PLOG_RING Ring)
+{
+    return AtomicLoadAcquire64(&Ring->Head) == Ring->Tail;
+}
+
+/**
+ * @brief Get the oldest record of the ring without removing it (only called
+ * by the consumer)
+ *
+ * @param Ring
+ *
+ * @return const LOG_RING_RECORD * NULL if the ring has no record
+ */
+const LOG_RING_RECORD *
+LogRingPeek(PLOG_RING Ring)
+{
+    UINT64            Head = AtomicLoadAcquire64(&Ring->Head);
+    LOG_RING_RECORD * Record;
+
+    while (Ring->Tail != Head)
+    {
+        Record = (LOG_RING_RECORD *)(Ring->Buffer + (Ring->Tail & (Ring->Size - 1)));
+
+        if (Record->OperationCode != LOG_RING_PADDING_RECORD)
+        {
+            return Record;
+        }
+
+        //
+        // Skip the padding at the end of the ring
+        //
+        AtomicStoreRelease64(&Ring->Tail, Ring->Tail + sizeof(LOG_RING_RECORD) + Record->Length);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remove the record that is returned by LogRingPeek (only called by
+ * the consumer)
+ *
+ * @param Ring
+ *
+ * @return VOID
+ */
+VOID
+LogRingRelease(PLOG_RING Ring)
+{
+    const LOG_RING_RECORD * Record = (const LOG_RING_RECORD *)(Ring->Buffer + (Ring->Tail & (Ring->Size - 1)));
+
+    AtomicStoreRelease64(&Ring->Tail, Ring->Tail + LogRingGetRecordSize(Record->Length));
+}
+
+/**
+ * @brief Get the record with the lowest time-stamp of all of the rings
+ * (only called by the consumer)
+ *
+ * @param Rings
+ * @param NumberOfRings
+ * @param Record The found record
+ *
+ * @return UINT32 Index of the ring of the record (or LOG_RING_NO_RECORD)
+ */
+UINT32
+LogRingPeekOldest(PLOG_RING Rings, UINT32 NumberOfRings, const LOG_RING_RECORD ** Record)
+{
+    const LOG_RING_RECORD * Current;
+    UINT32                  Oldest = LOG_RING_NO_RECORD;
+
+    *Record = NULL;
+
+    for (UINT32 i = 0; i < NumberOfRings; i++)
+    {
+        Current = LogRingPeek(&Rings[i]);
+
+        if (Current != NULL && (*Record == NULL || Current->TimeStamp < (*Record)->TimeStamp))
+        {
+            *Record = Current;
+            Oldest  = i;
+        }
+    }
+
+    return Oldest;
+}
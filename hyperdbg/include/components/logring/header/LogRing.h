@@ -0,0 +1,111 @@
+/**
+ * @file LogRing.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the single-producer rings of variable-length log records
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Alignment of the records (and the size of their header)
+ *
+ */
+#define LOG_RING_ALIGNMENT 16
+
+/**
+ * @brief Minimum size of a ring
+ *
+ */
+#define LOG_RING_MINIMUM_SIZE 0x10000
+
+/**
+ * @brief Operation code of the records that only fill the end of the ring
+ *
+ */
+#define LOG_RING_PADDING_RECORD 0xffffffff
+
+/**
+ * @brief Shows that none of the rings has a record
+ *
+ */
+#define LOG_RING_NO_RECORD 0xffffffff
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Header of each record (followed by the data of the record)
+ *
+ */
+typedef struct _LOG_RING_RECORD
+{
+    UINT64 TimeStamp;     // time-stamp counter when the record is written
+    UINT32 OperationCode; // operation code of the message (or LOG_RING_PADDING_RECORD)
+    UINT32 Length;        // length of the data
+
+} LOG_RING_RECORD, *PLOG_RING_RECORD;
+
+/**
+ * @brief A ring with a single producer and a single consumer
+ *
+ * @details The producer only moves the head and the consumer only moves the
+ * tail, so none of them needs a lock. Both of the counters keep growing, and
+ * the offset in the ring is the counter modulo the size. Each record is
+ * contiguous, if a record doesn't fit at the end of the ring, the end is
+ * filled with a padding record. If there is no space for a record, the record
+ * is dropped (the previous records are never overwritten) and the drop is
+ * counted
+ *
+ */
+typedef struct _LOG_RING
+{
+    volatile UINT64 Head; // written bytes (only changed by the producer)
+    UINT64          DroppedRecords;
+    UINT8           Reserved0[48];
+
+    volatile UINT64 Tail; // consumed bytes (only changed by the consumer)
+    UINT64          ReportedDroppedRecords;
+    UINT8           Reserved1[48];
+
+    UINT8 * Buffer;
+    UINT32  Size; // a power of two
+
+} LOG_RING, *PLOG_RING;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT32
+LogRingGetRecordSize(UINT32 Length);
+
+BOOLEAN
+LogRingInitialize(PLOG_RING Ring, PVOID Buffer, UINT32 Size);
+
+BOOLEAN
+LogRingWrite(PLOG_RING Ring, UINT32 OperationCode, UINT64 TimeStamp, const VOID * Buffer, UINT32 Length);
+
+BOOLEAN
+LogRingHasSpace(PLOG_RING Ring, UINT32 Length);
+
+BOOLEAN
+LogRingIsEmpty(PLOG_RING Ring);
+
+const LOG_RING_RECORD *
+LogRingPeek(PLOG_RING Ring);
+
+VOID
+LogRingRelease(PLOG_RING Ring);
+
+UINT32
+LogRingPeekOldest(PLOG_RING Rings, UINT32 NumberOfRings, const LOG_RING_RECORD ** Record);
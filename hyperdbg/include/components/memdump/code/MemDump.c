@@ -0,0 +1,796 @@
+/**
+ * @file MemDump.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Chunks, sparse writer, and manifest of the memory dumps
+ * @details The range of a dump is split into chunks that are read by single
+ * requests, the pages of each chunk are classified (data, zero, or unreadable),
+ * the data pages are written with large aligned writes (the other pages are holes
+ * of the sparse file), and each chunk is recorded in the manifest with its masks
+ * and its hash, so an interrupted dump can be verified and resumed
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Hash a buffer (FNV-1a over 8-byte words)
+ *
+ * @param Hash The previous hash (or MEM_DUMP_HASH_SEED)
+ * @param Buffer
+ * @param Length
+ *
+ * @return UINT64
+ */
+UINT64
+MemDumpHash(UINT64 Hash, const VOID * Buffer, UINT32 Length)
+{
+    const UINT8 * Bytes = (const UINT8 *)Buffer;
+    UINT64        Word;
+    UINT32        i = 0;
+
+    for (; i + sizeof(UINT64) <= Length; i += sizeof(UINT64))
+    {
+        memcpy(&Word, Bytes + i, sizeof(UINT64));
+
+        Hash ^= Word;
+        Hash *= 0x100000001b3ull;
+    }
+
+    for (; i < Length; i++)
+    {
+        Hash ^= Bytes[i];
+        Hash *= 0x100000001b3ull;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Initialize the plan of a dump
+ *
+ * @param Plan
+ * @param StartAddress
+ * @param EndAddress The first address after the dump
+ * @param IsPhysical
+ * @param Pid
+ *
+ * @return BOOLEAN FALSE if the range is empty
+ */
+BOOLEAN
+MemDumpInitializePlan(PMEM_DUMP_PLAN Plan, UINT64 StartAddress, UINT64 EndAddress, BOOLEAN IsPhysical, UINT32 Pid)
+{
+    if (StartAddress >= EndAddress)
+    {
+        return FALSE;
+    }
+
+    memset(Plan, 0, sizeof(MEM_DUMP_PLAN));
+
+    Plan->StartAddress   = StartAddress;
+    Plan->EndAddress     = EndAddress;
+    Plan->IsPhysical     = IsPhysical;
+    Plan->Pid            = Pid;
+    Plan->NumberOfChunks = (EndAddress - 1) / MEM_DUMP_CHUNK_SIZE - StartAddress / MEM_DUMP_CHUNK_SIZE + 1;
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the range of a chunk
+ *
+ * @param Plan
+ * @param Index
+ * @param Chunk The masks and the hash are cleared
+ *
+ * @return VOID
+ */
+VOID
+MemDumpGetChunk(const MEM_DUMP_PLAN * Plan, UINT64 Index, PMEM_DUMP_CHUNK Chunk)
+{
+    UINT64 Base = (Plan->StartAddress & ~((UINT64)MEM_DUMP_CHUNK_SIZE - 1)) + Index * MEM_DUMP_CHUNK_SIZE;
+    UINT64 End;
+
+    memset(Chunk, 0, sizeof(MEM_DUMP_CHUNK));
+
+    //
+    // The end of the last chunk might be the end of the address space
+    //
+    End = Plan->EndAddress - Base <= MEM_DUMP_CHUNK_SIZE ? Plan->EndAddress : Base + MEM_DUMP_CHUNK_SIZE;
+
+    Chunk->Index         = Index;
+    Chunk->Address       = Base < Plan->StartAddress ? Plan->StartAddress : Base;
+    Chunk->Length        = (UINT32)(End - Chunk->Address);
+    Chunk->NumberOfPages = (UINT32)((End - 1) / MEM_DUMP_PAGE_SIZE - Chunk->Address / MEM_DUMP_PAGE_SIZE + 1);
+}
+
+/**
+ * @brief Get the range of a page (or the part of the page) in a chunk
+ *
+ * @param Chunk
+ * @param Page
+ * @param Offset Offset of the page in the chunk
+ * @param Length
+ *
+ * @return VOID
+ */
+VOID
+MemDumpGetPage(const MEM_DUMP_CHUNK * Chunk, UINT32 Page, UINT32 * Offset, UINT32 * Length)
+{
+    UINT64 Base  = (Chunk->Address & ~((UINT64)MEM_DUMP_PAGE_SIZE - 1)) + (UINT64)Page * MEM_DUMP_PAGE_SIZE;
+    UINT64 Start = Base < Chunk->Address ? Chunk->Address : Base;
+    UINT64 End   = Chunk->Address + Chunk->Length;
+
+    if (End - Base > MEM_DUMP_PAGE_SIZE)
+    {
+        End = Base + MEM_DUMP_PAGE_SIZE;
+    }
+
+    *Offset = (UINT32)(Start - Chunk->Address);
+    *Length = (UINT32)(End - Start);
+}
+
+/**
+ * @brief Check whether a buffer is all zero
+ *
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemDumpIsZero(const UINT8 * Buffer, UINT32 Length)
+{
+    UINT64 Word;
+    UINT64 Accumulated = 0;
+    UINT32 i           = 0;
+
+    for (; i + sizeof(UINT64) <= Length; i += sizeof(UINT64))
+    {
+        memcpy(&Word, Buffer + i, sizeof(UINT64));
+        Accumulated |= Word;
+    }
+
+    for (; i < Length; i++)
+    {
+        Accumulated |= Buffer[i];
+    }
+
+    return Accumulated == 0;
+}
+
+/**
+ * @brief Find the zero pages and compute the hash of the readable pages of a chunk
+ *
+ * @param Chunk The readable mask should be set
+ * @param Buffer Contents of the chunk (only the readable pages are used)
+ *
+ * @return VOID
+ */
+VOID
+MemDumpClassifyChunk(PMEM_DUMP_CHUNK Chunk, const UINT8 * Buffer)
+{
+    UINT32 Offset;
+    UINT32 Length;
+
+    Chunk->ZeroMask = 0;
+    Chunk->Hash     = MEM_DUMP_HASH_SEED;
+
+    for (UINT32 i = 0; i < Chunk->NumberOfPages; i++)
+    {
+        if (!(Chunk->ReadableMask & (1u << i)))
+        {
+            continue;
+        }
+
+        MemDumpGetPage(Chunk, i, &Offset, &Length);
+
+        if (MemDumpIsZero(Buffer + Offset, Length))
+        {
+            Chunk->ZeroMask |= 1u << i;
+        }
+
+        Chunk->Hash = MemDumpHash(Chunk->Hash, Buffer + Offset, Length);
+    }
+}
+
+/**
+ * @brief Verify the contents of a chunk (e.g., read back from the dump file)
+ * against the chunk that is recorded in the manifest
+ *
+ * @param Chunk
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+MemDumpVerifyChunk(const MEM_DUMP_CHUNK * Chunk, const UINT8 * Buffer)
+{
+    MEM_DUMP_CHUNK Computed;
+
+    memcpy(&Computed, Chunk, sizeof(MEM_DUMP_CHUNK));
+
+    MemDumpClassifyChunk(&Computed, Buffer);
+
+    return Computed.Hash == Chunk->Hash && Computed.ZeroMask == Chunk->ZeroMask;
+}
+
+/**
+ * @brief Format the first line of the manifest
+ *
+ * @param Plan
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+MemDumpFormatHeader(const MEM_DUMP_PLAN * Plan, CHAR * Buffer, UINT32 BufferSize)
+{
+    int Length;
+
+    Length = snprintf(Buffer,
+                      BufferSize,
+                      "%s %u %s %x %llx %llx %x\n",
+                      MEM_DUMP_MANIFEST_SIGNATURE,
+                      MEM_DUMP_MANIFEST_VERSION,
+                      Plan->IsPhysical ? "physical" : "virtual",
+                      Plan->Pid,
+                      (unsigned long long)Plan->StartAddress,
+                      (unsigned long long)Plan->EndAddress,
+                      MEM_DUMP_CHUNK_SIZE);
+
+    return Length > 0 && (UINT32)Length < BufferSize ? (UINT32)Length : 0;
+}
+
+/**
+ * @brief Format the line of a chunk
+ *
+ * @param Chunk
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+MemDumpFormatChunk(const MEM_DUMP_CHUNK * Chunk, CHAR * Buffer, UINT32 BufferSize)
+{
+    int Length;
+
+    Length = snprintf(Buffer,
+                      BufferSize,
+                      "c %llx %x %x %016llx\n",
+                      (unsigned long long)Chunk->Index,
+                      Chunk->ReadableMask,
+                      Chunk->ZeroMask,
+                      (unsigned long long)Chunk->Hash);
+
+    return Length > 0 && (UINT32)Length < BufferSize ? (UINT32)Length : 0;
+}
+
+/**
+ * @brief Format the line of a range of the readable pages
+ *
+ * @param StartAddress
+ * @param EndAddress
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+MemDumpFormatRange(UINT64 StartAddress, UINT64 EndAddress, CHAR * Buffer, UINT32 BufferSize)
+{
+    int Length;
+
+    Length = snprintf(Buffer,
+                      BufferSize,
+                      "r %llx %llx\n",
+                      (unsigned long long)StartAddress,
+                      (unsigned long long)EndAddress);
+
+    return Length > 0 && (UINT32)Length < BufferSize ? (UINT32)Length : 0;
+}
+
+/**
+ * @brief Format the last line of the manifest (the dump is complete)
+ *
+ * @param Writer
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+MemDumpFormatSummary(const MEM_DUMP_WRITER * Writer, CHAR * Buffer, UINT32 BufferSize)
+{
+    int Length;
+
+    Length = snprintf(Buffer,
+                      BufferSize,
+                      "e %llx %llx %llx\n",
+                      (unsigned long long)Writer->DataBytes,
+                      (unsigned long long)Writer->ZeroBytes,
+                      (unsigned long long)Writer->UnreadableBytes);
+
+    return Length > 0 && (UINT32)Length < BufferSize ? (UINT32)Length : 0;
+}
+
+/**
+ * @brief Parse the line of a chunk
+ *
+ * @param Plan
+ * @param Line A null-terminated line
+ * @param Chunk
+ *
+ * @return BOOLEAN FALSE if the line is malformed or doesn't belong to the plan
+ */
+static BOOLEAN
+MemDumpParseChunk(const MEM_DUMP_PLAN * Plan, const CHAR * Line, PMEM_DUMP_CHUNK Chunk)
+{
+    unsigned long long Index;
+    unsigned long long Hash;
+    unsigned int       ReadableMask;
+    unsigned int       ZeroMask;
+    UINT32             PagesMask;
+    int                Consumed = 0;
+
+    if (sscanf(Line, "c %llx %x %x %llx%n", &Index, &ReadableMask, &ZeroMask, &Hash, &Consumed) != 4 ||
+        Line[Consumed] != '\0' || Index >= Plan->NumberOfChunks)
+    {
+        return FALSE;
+    }
+
+    MemDumpGetChunk(Plan, Index, Chunk);
+
+    PagesMask = Chunk->NumberOfPages == 32 ? 0xffffffff : (1u << Chunk->NumberOfPages) - 1;
+
+    //
+    // The zero pages are also readable
+    //
+    if ((ReadableMask & ~PagesMask) != 0 || (ZeroMask & ~ReadableMask) != 0)
+    {
+        return FALSE;
+    }
+
+    Chunk->ReadableMask = ReadableMask;
+    Chunk->ZeroMask     = ZeroMask;
+    Chunk->Hash         = Hash;
+
+    return TRUE;
+}
+
+/**
+ * @brief Parse the chunks of a manifest
+ *
+ * @details The parsing stops at the first malformed line (e.g., the last line of
+ * an interrupted dump), the chunks after it are dumped again
+ *
+ * @param Plan The manifest should belong to the same dump
+ * @param Manifest
+ * @param ManifestSize
+ * @param Callback
+ * @param Context
+ *
+ * @return BOOLEAN FALSE if the manifest doesn't belong to the plan or the callback stopped parsing
+ */
+BOOLEAN
+MemDumpParseManifest(const MEM_DUMP_PLAN *   Plan,
+                     const CHAR *            Manifest,
+                     SIZE_T                  ManifestSize,
+                     MEM_DUMP_CHUNK_CALLBACK Callback,
+                     PVOID                   Context)
+{
+    CHAR           Header[MEM_DUMP_MAXIMUM_LINE];
+    CHAR           Line[MEM_DUMP_MAXIMUM_LINE];
+    UINT32         HeaderLength;
+    SIZE_T         Offset = 0;
+    MEM_DUMP_CHUNK Chunk;
+
+    HeaderLength = MemDumpFormatHeader(Plan, Header, sizeof(Header));
+
+    if (HeaderLength == 0 || ManifestSize < HeaderLength || memcmp(Manifest, Header, HeaderLength) != 0)
+    {
+        return FALSE;
+    }
+
+    Offset = HeaderLength;
+
+    while (Offset < ManifestSize)
+    {
+        SIZE_T Length = 0;
+
+        while (Offset + Length < ManifestSize && Manifest[Offset + Length] != '\n')
+        {
+            Length++;
+        }
+
+        //
+        // A line without its new line is not completely written
+        //
+        if (Offset + Length == ManifestSize || Length >= sizeof(Line))
+        {
+            break;
+        }
+
+        memcpy(Line, Manifest + Offset, Length);
+        Line[Length] = '\0';
+        Offset += Length + 1;
+
+        //
+        // The ranges and the summary are written again after resuming
+        //
+        if (Line[0] != 'c')
+        {
+            continue;
+        }
+
+        if (!MemDumpParseChunk(Plan, Line, &Chunk))
+        {
+            break;
+        }
+
+        if (!Callback(Context, &Chunk))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Enumerate the ranges of the readable pages (including the zero pages)
+ *
+ * @param Plan
+ * @param ReadableMasks The readable mask of each chunk
+ * @param Callback
+ * @param Context
+ *
+ * @return BOOLEAN FALSE if the callback stopped the enumeration
+ */
+BOOLEAN
+MemDumpForEachReadableRange(const MEM_DUMP_PLAN *   Plan,
+                            const UINT32 *          ReadableMasks,
+                            MEM_DUMP_RANGE_CALLBACK Callback,
+                            PVOID                   Context)
+{
+    MEM_DUMP_CHUNK Chunk;
+    UINT64         RangeStart = 0;
+    UINT64         RangeEnd   = 0;
+    BOOLEAN        IsInRange  = FALSE;
+    UINT32         Offset;
+    UINT32         Length;
+
+    for (UINT64 Index = 0; Index < Plan->NumberOfChunks; Index++)
+    {
+        if (ReadableMasks[Index] == 0 && !IsInRange)
+        {
+            continue;
+        }
+
+        MemDumpGetChunk(Plan, Index, &Chunk);
+
+        for (UINT32 i = 0; i < Chunk.NumberOfPages; i++)
+        {
+            MemDumpGetPage(&Chunk, i, &Offset, &Length);
+
+            if (ReadableMasks[Index] & (1u << i))
+            {
+                if (!IsInRange)
+                {
+                    RangeStart = Chunk.Address + Offset;
+                    IsInRange  = TRUE;
+                }
+
+                RangeEnd = Chunk.Address + Offset + Length;
+            }
+            else if (IsInRange)
+            {
+                IsInRange = FALSE;
+
+                if (!Callback(Context, RangeStart, RangeEnd))
+                {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    if (IsInRange)
+    {
+        return Callback(Context, RangeStart, RangeEnd);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Initialize a writer
+ *
+ * @param Writer
+ * @param Plan
+ * @param Callbacks
+ * @param Context
+ * @param Staging A buffer of MEM_DUMP_WRITE_SIZE bytes
+ * @param Pending A buffer for the lines of the chunks that are not written yet
+ * @param PendingSize At least MEM_DUMP_MAXIMUM_LINE
+ * @param PunchHoles Whether the holes should be punched (the file is not new)
+ *
+ * @return VOID
+ */
+VOID
+MemDumpWriterInitialize(PMEM_DUMP_WRITER                  Writer,
+                        const MEM_DUMP_PLAN *             Plan,
+                        const MEM_DUMP_WRITER_CALLBACKS * Callbacks,
+                        PVOID                             Context,
+                        UINT8 *                           Staging,
+                        CHAR *                            Pending,
+                        UINT32                            PendingSize,
+                        BOOLEAN                           PunchHoles)
+{
+    memset(Writer, 0, sizeof(MEM_DUMP_WRITER));
+
+    Writer->Plan        = Plan;
+    Writer->Callbacks   = Callbacks;
+    Writer->Context     = Context;
+    Writer->Staging     = Staging;
+    Writer->Pending     = Pending;
+    Writer->PendingSize = PendingSize;
+    Writer->PunchHoles  = PunchHoles;
+}
+
+/**
+ * @brief Write the staged pages
+ *
+ * @param Writer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemDumpWriterFlushStaging(PMEM_DUMP_WRITER Writer)
+{
+    if (Writer->StagingLength == 0)
+    {
+        return TRUE;
+    }
+
+    if (!Writer->Callbacks->WriteData(Writer->Context, Writer->StagingOffset, Writer->Staging, Writer->StagingLength))
+    {
+        return FALSE;
+    }
+
+    Writer->NumberOfWrites++;
+    Writer->StagingLength = 0;
+
+    return TRUE;
+}
+
+/**
+ * @brief Stage a data page
+ *
+ * @param Writer
+ * @param FileOffset
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemDumpWriterStage(PMEM_DUMP_WRITER Writer, UINT64 FileOffset, const UINT8 * Buffer, UINT32 Length)
+{
+    UINT32 Room;
+
+    //
+    // Only contiguous pages are written together
+    //
+    if (Writer->StagingLength != 0 && Writer->StagingOffset + Writer->StagingLength != FileOffset)
+    {
+        if (!MemDumpWriterFlushStaging(Writer))
+        {
+            return FALSE;
+        }
+    }
+
+    while (Length != 0)
+    {
+        if (Writer->StagingLength == 0)
+        {
+            Writer->StagingOffset = FileOffset;
+        }
+
+        //
+        // Each write ends on the next aligned offset of the file
+        //
+        Room = MEM_DUMP_WRITE_SIZE - (UINT32)(Writer->StagingOffset % MEM_DUMP_WRITE_SIZE) - Writer->StagingLength;
+        Room = Room < Length ? Room : Length;
+
+        memcpy(Writer->Staging + Writer->StagingLength, Buffer, Room);
+
+        Writer->StagingLength += Room;
+        FileOffset += Room;
+        Buffer += Room;
+        Length -= Room;
+
+        if ((Writer->StagingOffset + Writer->StagingLength) % MEM_DUMP_WRITE_SIZE == 0)
+        {
+            if (!MemDumpWriterFlushStaging(Writer))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Record the line of a chunk in the manifest
+ *
+ * @param Writer
+ * @param Chunk
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemDumpWriterRecordChunk(PMEM_DUMP_WRITER Writer, const MEM_DUMP_CHUNK * Chunk)
+{
+    UINT32 LineLength;
+
+    if (Writer->PendingSize - Writer->PendingLength < MEM_DUMP_MAXIMUM_LINE)
+    {
+        if (!MemDumpWriterFlush(Writer))
+        {
+            return FALSE;
+        }
+    }
+
+    LineLength = MemDumpFormatChunk(Chunk, Writer->Pending + Writer->PendingLength, Writer->PendingSize - Writer->PendingLength);
+
+    Writer->PendingLength += LineLength;
+
+    return LineLength != 0;
+}
+
+/**
+ * @brief Write the pages of a chunk and record it in the manifest
+ *
+ * @param Writer
+ * @param Chunk A classified chunk
+ * @param Buffer Contents of the chunk
+ *
+ * @return BOOLEAN FALSE if writing into the dump file or the manifest failed
+ */
+BOOLEAN
+MemDumpWriterPutChunk(PMEM_DUMP_WRITER Writer, const MEM_DUMP_CHUNK * Chunk, const UINT8 * Buffer)
+{
+    UINT64 ChunkOffset = Chunk->Address - Writer->Plan->StartAddress;
+    UINT64 HoleOffset  = 0;
+    UINT64 HoleLength  = 0;
+    UINT32 Offset;
+    UINT32 Length;
+
+    for (UINT32 i = 0; i < Chunk->NumberOfPages; i++)
+    {
+        MemDumpGetPage(Chunk, i, &Offset, &Length);
+
+        if (!(Chunk->ReadableMask & (1u << i)))
+        {
+            Writer->UnreadableBytes += Length;
+        }
+        else if (Chunk->ZeroMask & (1u << i))
+        {
+            Writer->ZeroBytes += Length;
+        }
+        else
+        {
+            Writer->DataBytes += Length;
+
+            if (HoleLength != 0)
+            {
+                if (!Writer->Callbacks->PunchHole(Writer->Context, HoleOffset, HoleLength))
+                {
+                    return FALSE;
+                }
+
+                HoleLength = 0;
+            }
+
+            if (!MemDumpWriterStage(Writer, ChunkOffset + Offset, Buffer + Offset, Length))
+            {
+                return FALSE;
+            }
+
+            continue;
+        }
+
+        //
+        // The holes of a new file are not written at all
+        //
+        if (Writer->PunchHoles)
+        {
+            if (HoleLength == 0)
+            {
+                HoleOffset = ChunkOffset + Offset;
+            }
+
+            HoleLength += Length;
+        }
+    }
+
+    if (HoleLength != 0 && !Writer->Callbacks->PunchHole(Writer->Context, HoleOffset, HoleLength))
+    {
+        return FALSE;
+    }
+
+    //
+    // The line of the chunk is written after its pages
+    //
+    return MemDumpWriterRecordChunk(Writer, Chunk);
+}
+
+/**
+ * @brief Record a chunk that is already in the dump file (a verified chunk of
+ * a resumed dump) in the manifest
+ *
+ * @param Writer
+ * @param Chunk
+ *
+ * @return BOOLEAN FALSE if writing into the manifest failed
+ */
+BOOLEAN
+MemDumpWriterSkipChunk(PMEM_DUMP_WRITER Writer, const MEM_DUMP_CHUNK * Chunk)
+{
+    UINT32 Offset;
+    UINT32 Length;
+
+    for (UINT32 i = 0; i < Chunk->NumberOfPages; i++)
+    {
+        MemDumpGetPage(Chunk, i, &Offset, &Length);
+
+        if (!(Chunk->ReadableMask & (1u << i)))
+        {
+            Writer->UnreadableBytes += Length;
+        }
+        else if (Chunk->ZeroMask & (1u << i))
+        {
+            Writer->ZeroBytes += Length;
+        }
+        else
+        {
+            Writer->DataBytes += Length;
+        }
+    }
+
+    return MemDumpWriterRecordChunk(Writer, Chunk);
+}
+
+/**
+ * @brief Write the staged pages and the lines of their chunks
+ *
+ * @param Writer
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+MemDumpWriterFlush(PMEM_DUMP_WRITER Writer)
+{
+    if (!MemDumpWriterFlushStaging(Writer))
+    {
+        return FALSE;
+    }
+
+    if (Writer->PendingLength != 0)
+    {
+        if (!Writer->Callbacks->WriteManifest(Writer->Context, Writer->Pending, Writer->PendingLength))
+        {
+            return FALSE;
+        }
+
+        Writer->PendingLength = 0;
+    }
+
+    return TRUE;
+}
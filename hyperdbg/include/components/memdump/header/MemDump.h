@@ -0,0 +1,219 @@
+/**
+ * @file MemDump.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the chunks, the sparse writer, and the manifest of the memory dumps
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Size of the pages of the dumps
+ *
+ */
+#define MEM_DUMP_PAGE_SIZE 0x1000
+
+/**
+ * @brief Size of the chunks (each chunk is read by a single request)
+ *
+ */
+#define MEM_DUMP_CHUNK_SIZE 0x10000
+
+/**
+ * @brief Number of the pages in a chunk
+ *
+ */
+#define MEM_DUMP_PAGES_PER_CHUNK (MEM_DUMP_CHUNK_SIZE / MEM_DUMP_PAGE_SIZE)
+
+/**
+ * @brief Alignment (and maximum size) of the writes into the dump file
+ *
+ */
+#define MEM_DUMP_WRITE_SIZE 0x100000
+
+/**
+ * @brief Maximum length of a line of the manifest
+ *
+ */
+#define MEM_DUMP_MAXIMUM_LINE 160
+
+/**
+ * @brief Signature and version of the manifests
+ *
+ */
+#define MEM_DUMP_MANIFEST_SIGNATURE "hyperdbg-dump-manifest"
+#define MEM_DUMP_MANIFEST_VERSION   1
+
+/**
+ * @brief Seed of the hashes of the chunks
+ *
+ */
+#define MEM_DUMP_HASH_SEED 0xcbf29ce484222325ull
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The range of a dump
+ *
+ * @details The chunks are aligned to MEM_DUMP_CHUNK_SIZE on the addresses (except
+ * the first and the last chunk), and the offset of each address in the dump file
+ * is its distance from the start address
+ *
+ */
+typedef struct _MEM_DUMP_PLAN
+{
+    UINT64  StartAddress;
+    UINT64  EndAddress;
+    UINT64  NumberOfChunks;
+    BOOLEAN IsPhysical;
+    UINT32  Pid;
+
+} MEM_DUMP_PLAN, *PMEM_DUMP_PLAN;
+
+/**
+ * @brief A chunk of a dump
+ *
+ * @details Each bit of the masks is a page of the chunk, the readable pages that
+ * are not zero are stored in the dump file, and the other pages are holes (the
+ * manifest tells the zero pages and the unreadable pages apart)
+ *
+ */
+typedef struct _MEM_DUMP_CHUNK
+{
+    UINT64 Index;
+    UINT64 Address;
+    UINT32 Length;
+    UINT32 NumberOfPages;
+    UINT32 ReadableMask;
+    UINT32 ZeroMask;
+    UINT64 Hash; // hash of the readable pages
+
+} MEM_DUMP_CHUNK, *PMEM_DUMP_CHUNK;
+
+/**
+ * @brief Callbacks of the writer for the dump file and the manifest
+ *
+ */
+typedef struct _MEM_DUMP_WRITER_CALLBACKS
+{
+    BOOLEAN (*WriteData)(PVOID Context, UINT64 Offset, const VOID * Buffer, UINT32 Length);
+    BOOLEAN (*PunchHole)(PVOID Context, UINT64 Offset, UINT64 Length);
+    BOOLEAN (*WriteManifest)(PVOID Context, const CHAR * Text, UINT32 Length);
+
+} MEM_DUMP_WRITER_CALLBACKS, *PMEM_DUMP_WRITER_CALLBACKS;
+
+/**
+ * @brief The writer of the chunks
+ *
+ * @details Contiguous pages are staged into writes that end on MEM_DUMP_WRITE_SIZE
+ * boundaries of the file, and the lines of the chunks are only written into the
+ * manifest after their pages are written (so the manifest never records a chunk
+ * that is not in the dump file)
+ *
+ */
+typedef struct _MEM_DUMP_WRITER
+{
+    const MEM_DUMP_PLAN *             Plan;
+    const MEM_DUMP_WRITER_CALLBACKS * Callbacks;
+    PVOID                             Context;
+    BOOLEAN                           PunchHoles; // the file may already contain data (resuming)
+    UINT8 *                           Staging;    // MEM_DUMP_WRITE_SIZE bytes
+    UINT64                            StagingOffset;
+    UINT32                            StagingLength;
+    CHAR *                            Pending; // lines of the chunks that are not written yet
+    UINT32                            PendingSize;
+    UINT32                            PendingLength;
+    UINT64                            DataBytes;
+    UINT64                            ZeroBytes;
+    UINT64                            UnreadableBytes;
+    UINT64                            NumberOfWrites;
+
+} MEM_DUMP_WRITER, *PMEM_DUMP_WRITER;
+
+/**
+ * @brief Callback for each chunk of a manifest (returns FALSE to stop parsing)
+ *
+ */
+typedef BOOLEAN (*MEM_DUMP_CHUNK_CALLBACK)(PVOID Context, const MEM_DUMP_CHUNK * Chunk);
+
+/**
+ * @brief Callback for each range of the readable pages (returns FALSE to stop)
+ *
+ */
+typedef BOOLEAN (*MEM_DUMP_RANGE_CALLBACK)(PVOID Context, UINT64 StartAddress, UINT64 EndAddress);
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT64
+MemDumpHash(UINT64 Hash, const VOID * Buffer, UINT32 Length);
+
+BOOLEAN
+MemDumpInitializePlan(PMEM_DUMP_PLAN Plan, UINT64 StartAddress, UINT64 EndAddress, BOOLEAN IsPhysical, UINT32 Pid);
+
+VOID
+MemDumpGetChunk(const MEM_DUMP_PLAN * Plan, UINT64 Index, PMEM_DUMP_CHUNK Chunk);
+
+VOID
+MemDumpGetPage(const MEM_DUMP_CHUNK * Chunk, UINT32 Page, UINT32 * Offset, UINT32 * Length);
+
+VOID
+MemDumpClassifyChunk(PMEM_DUMP_CHUNK Chunk, const UINT8 * Buffer);
+
+BOOLEAN
+MemDumpVerifyChunk(const MEM_DUMP_CHUNK * Chunk, const UINT8 * Buffer);
+
+UINT32
+MemDumpFormatHeader(const MEM_DUMP_PLAN * Plan, CHAR * Buffer, UINT32 BufferSize);
+
+UINT32
+MemDumpFormatChunk(const MEM_DUMP_CHUNK * Chunk, CHAR * Buffer, UINT32 BufferSize);
+
+UINT32
+MemDumpFormatRange(UINT64 StartAddress, UINT64 EndAddress, CHAR * Buffer, UINT32 BufferSize);
+
+UINT32
+MemDumpFormatSummary(const MEM_DUMP_WRITER * Writer, CHAR * Buffer, UINT32 BufferSize);
+
+BOOLEAN
+MemDumpParseManifest(const MEM_DUMP_PLAN *   Plan,
+                     const CHAR *            Manifest,
+                     SIZE_T                  ManifestSize,
+                     MEM_DUMP_CHUNK_CALLBACK Callback,
+                     PVOID                   Context);
+
+BOOLEAN
+MemDumpForEachReadableRange(const MEM_DUMP_PLAN *   Plan,
+                            const UINT32 *          ReadableMasks,
+                            MEM_DUMP_RANGE_CALLBACK Callback,
+                            PVOID                   Context);
+
+VOID
+MemDumpWriterInitialize(PMEM_DUMP_WRITER                  Writer,
+                        const MEM_DUMP_PLAN *             Plan,
+                        const MEM_DUMP_WRITER_CALLBACKS * Callbacks,
+                        PVOID                             Context,
+                        UINT8 *                           Staging,
+                        CHAR *                            Pending,
+                        UINT32                            PendingSize,
+                        BOOLEAN                           PunchHoles);
+
+BOOLEAN
+MemDumpWriterPutChunk(PMEM_DUMP_WRITER Writer, const MEM_DUMP_CHUNK * Chunk, const UINT8 * Buffer);
+
+BOOLEAN
+MemDumpWriterSkipChunk(PMEM_DUMP_WRITER Writer, const MEM_DUMP_CHUNK * Chunk);
+
+BOOLEAN
+MemDumpWriterFlush(PMEM_DUMP_WRITER Writer);
@@ -0,0 +1,493 @@
+/**
+ * @file MemorySearch.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Multi-pattern memory search engine
+ * @details The candidates are found by comparing two fixed bytes of each
+ * pattern (the anchor) against 16 positions at once, and then each candidate
+ * is verified against the whole pattern (and its mask). The engine has no
+ * dependency on the platform, so it's used both in the kernel (the 's'
+ * commands) and in the user-mode tests
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#    define MEMORY_SEARCH_USE_SSE2
+#    include <emmintrin.h>
+#endif
+
+#if defined(MEMORY_SEARCH_USE_SSE2)
+
+/**
+ * @brief Get the index of the lowest set bit
+ *
+ * @param Mask A non-zero mask
+ *
+ * @return UINT32
+ */
+static UINT32
+MemorySearchLowestBit(UINT32 Mask)
+{
+#    if defined(_MSC_VER)
+    unsigned long Index = 0;
+
+    _BitScanForward(&Index, Mask);
+
+    return (UINT32)Index;
+#    else
+    return (UINT32)__builtin_ctz(Mask);
+#    endif
+}
+
+#endif // defined(MEMORY_SEARCH_USE_SSE2)
+
+/**
+ * @brief Get how common a byte is in the memory (lower is rarer)
+ *
+ * @param Byte
+ *
+ * @return UINT32
+ */
+static UINT32
+MemorySearchByteScore(UINT8 Byte)
+{
+    if (Byte == 0x00 || Byte == 0xff)
+    {
+        return 2;
+    }
+    else if (Byte == 0xcc || Byte == 0x90)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether a byte of the pattern is fixed (not masked)
+ *
+ * @param Pattern
+ * @param Index
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemorySearchIsFixedByte(const MEMORY_SEARCH_PATTERN * Pattern, UINT32 Index)
+{
+    return Pattern->Mask == NULL || Pattern->Mask[Index] == 0xff;
+}
+
+/**
+ * @brief Choose the anchor of the pattern
+ *
+ * @details The anchor is the rarest pair of the adjacent fixed bytes,
+ * or the rarest fixed byte if there is no such pair. A pattern without
+ * any fixed byte has no anchor, and all of its positions are candidates
+ *
+ * @param Pattern
+ *
+ * @return VOID
+ */
+static VOID
+MemorySearchChooseAnchor(PMEMORY_SEARCH_PATTERN Pattern)
+{
+    UINT32 BestScore = (UINT32)-1;
+    UINT32 Score;
+
+    Pattern->AnchorOffset = 0;
+    Pattern->AnchorSize   = 0;
+
+    for (UINT32 i = 0; i + 1 < Pattern->Size; i++)
+    {
+        if (MemorySearchIsFixedByte(Pattern, i) && MemorySearchIsFixedByte(Pattern, i + 1))
+        {
+            Score = MemorySearchByteScore(Pattern->Bytes[i]) + MemorySearchByteScore(Pattern->Bytes[i + 1]);
+
+            if (Score < BestScore)
+            {
+                BestScore             = Score;
+                Pattern->AnchorOffset = i;
+                Pattern->AnchorSize   = 2;
+            }
+        }
+    }
+
+    if (Pattern->AnchorSize != 0)
+    {
+        return;
+    }
+
+    for (UINT32 i = 0; i < Pattern->Size; i++)
+    {
+        if (MemorySearchIsFixedByte(Pattern, i))
+        {
+            Score = MemorySearchByteScore(Pattern->Bytes[i]);
+
+            if (Score < BestScore)
+            {
+                BestScore             = Score;
+                Pattern->AnchorOffset = i;
+                Pattern->AnchorSize   = 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Initialize a search
+ *
+ * @param Context
+ * @param BaseAddress Address that the alignment of the matches is based on
+ * @param Callback Called for each match
+ * @param CallbackContext Passed to the callback
+ *
+ * @return VOID
+ */
+VOID
+MemorySearchInitialize(PMEMORY_SEARCH_CONTEXT       Context,
+                       UINT64                       BaseAddress,
+                       MEMORY_SEARCH_MATCH_CALLBACK Callback,
+                       PVOID                        CallbackContext)
+{
+    Context->NumberOfPatterns   = 0;
+    Context->MaximumPatternSize = 0;
+    Context->BaseAddress        = BaseAddress;
+    Context->NextAddress        = BaseAddress;
+    Context->NumberOfMatches    = 0;
+    Context->Callback           = Callback;
+    Context->CallbackContext    = CallbackContext;
+    Context->Stopped            = FALSE;
+    Context->CarrySize          = 0;
+}
+
+/**
+ * @brief Add a pattern to the search (should be called before scanning)
+ *
+ * @param Context
+ * @param Bytes Bytes of the pattern
+ * @param Mask Mask of the pattern (NULL if all of the bytes should match)
+ * @param Size Size of the pattern
+ * @param Alignment Alignment of the matches (1 for any position)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+MemorySearchAddPattern(PMEMORY_SEARCH_CONTEXT Context,
+                       const UINT8 *          Bytes,
+                       const UINT8 *          Mask,
+                       UINT32                 Size,
+                       UINT32                 Alignment)
+{
+    PMEMORY_SEARCH_PATTERN Pattern;
+
+    if (Context->NumberOfPatterns >= MEMORY_SEARCH_MAXIMUM_PATTERNS ||
+        Size == 0 ||
+        Size > MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE ||
+        Alignment == 0)
+    {
+        return FALSE;
+    }
+
+    Pattern            = &Context->Patterns[Context->NumberOfPatterns];
+    Pattern->Bytes     = Bytes;
+    Pattern->Mask      = Mask;
+    Pattern->Size      = Size;
+    Pattern->Alignment = Alignment;
+
+    MemorySearchChooseAnchor(Pattern);
+
+    if (Size > Context->MaximumPatternSize)
+    {
+        Context->MaximumPatternSize = Size;
+    }
+
+    Context->NumberOfPatterns++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether the pattern matches the buffer
+ *
+ * @param Pattern
+ * @param Buffer At least Pattern->Size bytes
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+MemorySearchVerify(const MEMORY_SEARCH_PATTERN * Pattern, const UINT8 * Buffer)
+{
+    if (Pattern->Mask == NULL)
+    {
+        return memcmp(Buffer, Pattern->Bytes, Pattern->Size) == 0;
+    }
+
+    for (UINT32 i = 0; i < Pattern->Size; i++)
+    {
+        if (((Buffer[i] ^ Pattern->Bytes[i]) & Pattern->Mask[i]) != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Verify a candidate and report it if it matches
+ *
+ * @param Context
+ * @param PatternIndex
+ * @param Address Address of the candidate
+ * @param Buffer Bytes of the candidate
+ *
+ * @return BOOLEAN FALSE if the search should be stopped
+ */
+static BOOLEAN
+MemorySearchReport(PMEMORY_SEARCH_CONTEXT Context, UINT32 PatternIndex, UINT64 Address, const UINT8 * Buffer)
+{
+    const MEMORY_SEARCH_PATTERN * Pattern = &Context->Patterns[PatternIndex];
+
+    if (Pattern->Alignment != 1 && ((Address - Context->BaseAddress) % Pattern->Alignment) != 0)
+    {
+        return TRUE;
+    }
+
+    if (!MemorySearchVerify(Pattern, Buffer))
+    {
+        return TRUE;
+    }
+
+    Context->NumberOfMatches++;
+
+    if (!Context->Callback(Context->CallbackContext, Address, PatternIndex))
+    {
+        Context->Stopped = TRUE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Search the positions of a chunk whose patterns fully fit in it
+ *
+ * @param Context
+ * @param Address Address of the chunk
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN FALSE if the search should be stopped
+ */
+static BOOLEAN
+MemorySearchScanChunk(PMEMORY_SEARCH_CONTEXT Context, UINT64 Address, const UINT8 * Buffer, UINT32 Size)
+{
+    const MEMORY_SEARCH_PATTERN * Pattern;
+    UINT32                        Position = 0;
+
+#if defined(MEMORY_SEARCH_USE_SSE2)
+
+    __m128i First[MEMORY_SEARCH_MAXIMUM_PATTERNS];
+    __m128i Second[MEMORY_SEARCH_MAXIMUM_PATTERNS];
+    UINT32  PatternCandidates[MEMORY_SEARCH_MAXIMUM_PATTERNS];
+    UINT32  Candidates;
+    UINT32  Bit;
+
+    for (UINT32 i = 0; i < Context->NumberOfPatterns; i++)
+    {
+        Pattern   = &Context->Patterns[i];
+        First[i]  = _mm_set1_epi8((char)Pattern->Bytes[Pattern->AnchorOffset]);
+        Second[i] = _mm_set1_epi8((char)Pattern->Bytes[Pattern->AnchorOffset + (Pattern->AnchorSize == 2 ? 1 : 0)]);
+    }
+
+    //
+    // Each block checks 16 positions, and all of the patterns fit in the
+    // chunk at all of these positions (so the anchors can be loaded, and
+    // the candidates can be verified without checking the bounds)
+    //
+    while ((UINT64)Position + MEMORY_SEARCH_BLOCK_SIZE + Context->MaximumPatternSize <= Size)
+    {
+        Candidates = 0;
+
+        for (UINT32 i = 0; i < Context->NumberOfPatterns; i++)
+        {
+            const UINT8 * Anchor = Buffer + Position + Context->Patterns[i].AnchorOffset;
+            __m128i       Equal;
+
+            switch (Context->Patterns[i].AnchorSize)
+            {
+            case 2:
+                Equal = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)Anchor), First[i]),
+                                      _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(Anchor + 1)), Second[i]));
+
+                PatternCandidates[i] = (UINT32)_mm_movemask_epi8(Equal);
+                break;
+
+            case 1:
+                Equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)Anchor), First[i]);
+
+                PatternCandidates[i] = (UINT32)_mm_movemask_epi8(Equal);
+                break;
+
+            default:
+                PatternCandidates[i] = 0xffff;
+                break;
+            }
+
+            Candidates |= PatternCandidates[i];
+        }
+
+        //
+        // Verify the candidates in the order of their addresses
+        //
+        while (Candidates != 0)
+        {
+            Bit = MemorySearchLowestBit(Candidates);
+            Candidates &= Candidates - 1;
+
+            for (UINT32 i = 0; i < Context->NumberOfPatterns; i++)
+            {
+                if ((PatternCandidates[i] & (1u << Bit)) != 0 &&
+                    !MemorySearchReport(Context, i, Address + Position + Bit, Buffer + Position + Bit))
+                {
+                    return FALSE;
+                }
+            }
+        }
+
+        Position += MEMORY_SEARCH_BLOCK_SIZE;
+    }
+
+#endif // defined(MEMORY_SEARCH_USE_SSE2)
+
+    //
+    // The rest of the positions (or all of them if there is no SIMD support)
+    //
+    for (; Position < Size; Position++)
+    {
+        for (UINT32 i = 0; i < Context->NumberOfPatterns; i++)
+        {
+            Pattern = &Context->Patterns[i];
+
+            if (Pattern->Size > Size - Position ||
+                (Pattern->AnchorSize != 0 && Buffer[Position + Pattern->AnchorOffset] != Pattern->Bytes[Pattern->AnchorOffset]))
+            {
+                continue;
+            }
+
+            if (!MemorySearchReport(Context, i, Address + Position, Buffer + Position))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Search a chunk of the memory
+ *
+ * @details The chunks are expected in the order of their addresses. If the
+ * chunk is contiguous to the previous chunk, the matches that start in the
+ * previous chunk and end in this chunk are also reported, otherwise (e.g.,
+ * a page was not readable) the previous bytes are dropped
+ *
+ * @param Context
+ * @param Address Address of the chunk
+ * @param Buffer Bytes of the chunk
+ * @param Size Size of the chunk
+ *
+ * @return BOOLEAN FALSE if the search is stopped by the callback
+ */
+BOOLEAN
+MemorySearchScan(PMEMORY_SEARCH_CONTEXT Context, UINT64 Address, const UINT8 * Buffer, UINT32 Size)
+{
+    const MEMORY_SEARCH_PATTERN * Pattern;
+    UINT32                        CarryLimit;
+    UINT32                        HeadSize;
+    UINT32                        BridgeSize;
+    UINT32                        First;
+    UINT64                        BridgeAddress;
+
+    if (Context->Stopped)
+    {
+        return FALSE;
+    }
+
+    if (Context->NumberOfPatterns == 0 || Size == 0)
+    {
+        return TRUE;
+    }
+
+    if (Address != Context->NextAddress)
+    {
+        Context->CarrySize = 0;
+    }
+
+    CarryLimit = Context->MaximumPatternSize - 1;
+    HeadSize   = Size < CarryLimit ? Size : CarryLimit;
+
+    //
+    // Search the positions that start in the previous chunks and end in
+    // this chunk (the positions whose pattern ends before this chunk are
+    // already reported)
+    //
+    if (Context->CarrySize != 0)
+    {
+        memcpy(&Context->Bridge[Context->CarrySize], Buffer, HeadSize);
+
+        BridgeSize    = Context->CarrySize + HeadSize;
+        BridgeAddress = Address - Context->CarrySize;
+
+        for (UINT32 Position = 0; Position < Context->CarrySize; Position++)
+        {
+            for (UINT32 i = 0; i < Context->NumberOfPatterns; i++)
+            {
+                Pattern = &Context->Patterns[i];
+
+                if (Position + Pattern->Size > Context->CarrySize &&
+                    Position + Pattern->Size <= BridgeSize &&
+                    !MemorySearchReport(Context, i, BridgeAddress + Position, &Context->Bridge[Position]))
+                {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    if (!MemorySearchScanChunk(Context, Address, Buffer, Size))
+    {
+        return FALSE;
+    }
+
+    //
+    // Keep the last bytes for the next chunk
+    //
+    if (Size >= CarryLimit)
+    {
+        memcpy(Context->Bridge, Buffer + Size - CarryLimit, CarryLimit);
+        Context->CarrySize = CarryLimit;
+    }
+    else
+    {
+        if (Context->CarrySize == 0)
+        {
+            memcpy(Context->Bridge, Buffer, Size);
+        }
+
+        BridgeSize = Context->CarrySize + Size;
+        First      = BridgeSize > CarryLimit ? BridgeSize - CarryLimit : 0;
+
+        memmove(Context->Bridge, &Context->Bridge[First], BridgeSize - First);
+        Context->CarrySize = BridgeSize - First;
+    }
+
+    Context->NextAddress = Address + Size;
+
+    return TRUE;
+}
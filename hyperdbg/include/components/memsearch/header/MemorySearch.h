@@ -0,0 +1,109 @@
+/**
+ * @file MemorySearch.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the multi-pattern memory search engine
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of the patterns that are searched in one pass
+ *
+ */
+#define MEMORY_SEARCH_MAXIMUM_PATTERNS 4
+
+/**
+ * @brief Maximum size of each pattern (in bytes)
+ *
+ */
+#define MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE 256
+
+/**
+ * @brief Number of the positions that are filtered at once
+ *
+ */
+#define MEMORY_SEARCH_BLOCK_SIZE 16
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Callback that is called for each match (returning FALSE stops
+ * the search)
+ *
+ */
+typedef BOOLEAN (*MEMORY_SEARCH_MATCH_CALLBACK)(PVOID Context, UINT64 Address, UINT32 PatternIndex);
+
+/**
+ * @brief A pattern of the search
+ *
+ * @details The bytes (and the mask) are not copied, so they should
+ * remain valid during the search. A mask byte of 0xff means that the
+ * byte should match, 0x00 means a wildcard and the other values only
+ * compare the set bits
+ *
+ */
+typedef struct _MEMORY_SEARCH_PATTERN
+{
+    const UINT8 * Bytes;
+    const UINT8 * Mask;         // NULL if all of the bytes should match
+    UINT32        Size;
+    UINT32        Alignment;    // matches are only reported at multiples of it from the base address
+    UINT32        AnchorOffset; // offset of the fixed bytes that are checked by the filter
+    UINT32        AnchorSize;   // number of the fixed bytes in the anchor (0, 1 or 2)
+
+} MEMORY_SEARCH_PATTERN, *PMEMORY_SEARCH_PATTERN;
+
+/**
+ * @brief State of a search
+ *
+ * @details The memory is given to the search as a stream of chunks (e.g.,
+ * pages). The last bytes of each chunk are kept in the bridge, so the
+ * matches that span two contiguous chunks are also found
+ *
+ */
+typedef struct _MEMORY_SEARCH_CONTEXT
+{
+    MEMORY_SEARCH_PATTERN        Patterns[MEMORY_SEARCH_MAXIMUM_PATTERNS];
+    UINT32                       NumberOfPatterns;
+    UINT32                       MaximumPatternSize;
+    UINT64                       BaseAddress;
+    UINT64                       NextAddress;
+    UINT64                       NumberOfMatches;
+    MEMORY_SEARCH_MATCH_CALLBACK Callback;
+    PVOID                        CallbackContext;
+    BOOLEAN                      Stopped;
+    UINT32                       CarrySize;
+    UINT8                        Bridge[2 * MEMORY_SEARCH_MAXIMUM_PATTERN_SIZE];
+
+} MEMORY_SEARCH_CONTEXT, *PMEMORY_SEARCH_CONTEXT;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+MemorySearchInitialize(PMEMORY_SEARCH_CONTEXT       Context,
+                       UINT64                       BaseAddress,
+                       MEMORY_SEARCH_MATCH_CALLBACK Callback,
+                       PVOID                        CallbackContext);
+
+BOOLEAN
+MemorySearchAddPattern(PMEMORY_SEARCH_CONTEXT Context,
+                       const UINT8 *          Bytes,
+                       const UINT8 *          Mask,
+                       UINT32                 Size,
+                       UINT32                 Alignment);
+
+BOOLEAN
+MemorySearchScan(PMEMORY_SEARCH_CONTEXT Context, UINT64 Address, const UINT8 * Buffer, UINT32 Size);
@@ -0,0 +1,261 @@
+/**
+ * @file PageWalk.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Cached walks of the page tables (batched translations)
+ * @details The upper levels of the recent walks are cached, so translating
+ * a contiguous range reads (almost) a single entry for each 4 KB page and
+ * a single walk for each large page, the entries are read by a callback, so
+ * it could be used on the guest page tables from vmx-root
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Bits of the virtual address that are translated by each level
+ * (PML4E, PDPTE, PDE and PTE)
+ *
+ */
+static const UINT32 PageWalkLevelShifts[PAGE_WALK_CACHED_LEVELS + 1] = {39, 30, 21, 12};
+
+/**
+ * @brief Find a cached entry
+ *
+ * @param Cache
+ * @param Level
+ * @param VirtualAddress
+ * @param Entry
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PageWalkLookup(PPAGE_WALK_CACHE Cache, UINT32 Level, UINT64 VirtualAddress, UINT64 * Entry)
+{
+    UINT64 Tag = ((VirtualAddress >> PageWalkLevelShifts[Level]) << 1) | 1;
+
+    for (UINT32 i = 0; i < PAGE_WALK_CACHE_ENTRIES; i++)
+    {
+        if (Cache->Levels[Level][i].Tag == Tag)
+        {
+            *Entry = Cache->Levels[Level][i].Entry;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Cache an entry (replaces the oldest entry of the level)
+ *
+ * @param Cache
+ * @param Level
+ * @param VirtualAddress
+ * @param Entry
+ *
+ * @return VOID
+ */
+static VOID
+PageWalkInsert(PPAGE_WALK_CACHE Cache, UINT32 Level, UINT64 VirtualAddress, UINT64 Entry)
+{
+    PPAGE_WALK_CACHE_ENTRY CacheEntry = &Cache->Levels[Level][Cache->NextEntry[Level]];
+
+    CacheEntry->Tag   = ((VirtualAddress >> PageWalkLevelShifts[Level]) << 1) | 1;
+    CacheEntry->Entry = Entry;
+
+    Cache->NextEntry[Level] = (Cache->NextEntry[Level] + 1) % PAGE_WALK_CACHE_ENTRIES;
+}
+
+/**
+ * @brief Read an entry of a table
+ *
+ * @param Cache
+ * @param TableAddress Physical address of the table
+ * @param Level Level of the entry
+ * @param VirtualAddress
+ * @param Entry
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PageWalkReadEntry(PPAGE_WALK_CACHE Cache, UINT64 TableAddress, UINT32 Level, UINT64 VirtualAddress, UINT64 * Entry)
+{
+    UINT64 Index = (VirtualAddress >> PageWalkLevelShifts[Level]) & 0x1ff;
+
+    Cache->EntryReads++;
+
+    if (!Cache->ReadEntry(Cache->Context, TableAddress + Index * sizeof(UINT64), Entry))
+    {
+        return FALSE;
+    }
+
+    return (*Entry & PAGE_WALK_ENTRY_PRESENT) != 0;
+}
+
+/**
+ * @brief Initialize the state of the walks
+ *
+ * @param Cache
+ * @param Cr3 Physical address of the PML4 table
+ * @param ReadEntry Callback to read the entries
+ * @param Context Context of the callback
+ *
+ * @return VOID
+ */
+VOID
+PageWalkInitialize(PPAGE_WALK_CACHE Cache, UINT64 Cr3, PAGE_WALK_READ_ENTRY ReadEntry, PVOID Context)
+{
+    memset(Cache, 0, sizeof(PAGE_WALK_CACHE));
+
+    Cache->Cr3       = Cr3 & PAGE_WALK_ENTRY_ADDRESS;
+    Cache->ReadEntry = ReadEntry;
+    Cache->Context   = Context;
+}
+
+/**
+ * @brief Translate a virtual address
+ *
+ * @param Cache
+ * @param VirtualAddress
+ * @param PhysicalAddress The translated address
+ * @param MappingSize Count of bytes from the address to the end of its mapping
+ * (the page or the large page)
+ *
+ * @return BOOLEAN FALSE if the address is not mapped
+ */
+BOOLEAN
+PageWalkTranslate(PPAGE_WALK_CACHE Cache, UINT64 VirtualAddress, UINT64 * PhysicalAddress, UINT64 * MappingSize)
+{
+    UINT64 Entry;
+    UINT64 PageSize;
+    INT32  Level;
+
+    //
+    // Bits 63:47 should be the same (canonical address)
+    //
+    if (((INT64)VirtualAddress >> 47) != 0 && ((INT64)VirtualAddress >> 47) != -1)
+    {
+        return FALSE;
+    }
+
+    //
+    // Start from the deepest cached level
+    //
+    for (Level = PAGE_WALK_CACHED_LEVELS - 1; Level >= 0; Level--)
+    {
+        if (PageWalkLookup(Cache, Level, VirtualAddress, &Entry))
+        {
+            break;
+        }
+    }
+
+    if (Level < 0)
+    {
+        if (!PageWalkReadEntry(Cache, Cache->Cr3, 0, VirtualAddress, &Entry))
+        {
+            return FALSE;
+        }
+
+        Level = 0;
+        PageWalkInsert(Cache, 0, VirtualAddress, Entry);
+    }
+
+    //
+    // Walk the remaining levels (until a large page or the PTE)
+    //
+    while (Level < PAGE_WALK_CACHED_LEVELS && !(Level != 0 && (Entry & PAGE_WALK_ENTRY_LARGE_PAGE)))
+    {
+        if (!PageWalkReadEntry(Cache, Entry & PAGE_WALK_ENTRY_ADDRESS, Level + 1, VirtualAddress, &Entry))
+        {
+            return FALSE;
+        }
+
+        Level++;
+
+        if (Level < PAGE_WALK_CACHED_LEVELS)
+        {
+            PageWalkInsert(Cache, Level, VirtualAddress, Entry);
+        }
+    }
+
+    //
+    // The PDPTE maps a 1 GB page, the PDE maps a 2 MB page and the PTE maps a 4 KB page
+    //
+    PageSize = 1ull << PageWalkLevelShifts[Level];
+
+    *PhysicalAddress = (Entry & PAGE_WALK_ENTRY_ADDRESS & ~(PageSize - 1)) | (VirtualAddress & (PageSize - 1));
+    *MappingSize     = PageSize - (VirtualAddress & (PageSize - 1));
+
+    return TRUE;
+}
+
+/**
+ * @brief Translate a virtual range into physically contiguous runs
+ *
+ * @param Cache
+ * @param VirtualAddress
+ * @param Size
+ * @param Runs The translated runs
+ * @param MaximumRuns Count of the runs
+ * @param TranslatedSize Count of the bytes that are translated (less than the
+ * size if there are more runs or an address is not mapped)
+ *
+ * @return UINT32 Count of the runs
+ */
+UINT32
+PageWalkBuildRuns(PPAGE_WALK_CACHE Cache,
+                  UINT64           VirtualAddress,
+                  UINT64           Size,
+                  PPAGE_WALK_RUN   Runs,
+                  UINT32           MaximumRuns,
+                  UINT64 *         TranslatedSize)
+{
+    UINT32 Count      = 0;
+    UINT64 Translated = 0;
+
+    while (Translated < Size)
+    {
+        UINT64 Address = VirtualAddress + Translated;
+        UINT64 PhysicalAddress;
+        UINT64 Length;
+
+        if (!PageWalkTranslate(Cache, Address, &PhysicalAddress, &Length))
+        {
+            break;
+        }
+
+        if (Length > Size - Translated)
+        {
+            Length = Size - Translated;
+        }
+
+        if (Count != 0 && Runs[Count - 1].PhysicalAddress + Runs[Count - 1].Size == PhysicalAddress)
+        {
+            //
+            // Physically contiguous with the previous run
+            //
+            Runs[Count - 1].Size += Length;
+        }
+        else
+        {
+            if (Count == MaximumRuns)
+            {
+                break;
+            }
+
+            Runs[Count].VirtualAddress  = Address;
+            Runs[Count].PhysicalAddress = PhysicalAddress;
+            Runs[Count].Size            = Length;
+            Count++;
+        }
+
+        Translated += Length;
+    }
+
+    *TranslatedSize = Translated;
+
+    return Count;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file PageWalk.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the cached walks of the page tables (batched translations)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Count of the cached entries for each level of the page tables
+ *
+ */
+#define PAGE_WALK_CACHE_ENTRIES 4
+
+/**
+ * @brief Count of the cached levels (PML4E, PDPTE and PDE)
+ *
+ */
+#define PAGE_WALK_CACHED_LEVELS 3
+
+/**
+ * @brief Bits of a paging-structure entry
+ *
+ */
+#define PAGE_WALK_ENTRY_PRESENT    0x1ull
+#define PAGE_WALK_ENTRY_LARGE_PAGE 0x80ull
+#define PAGE_WALK_ENTRY_ADDRESS    0x000ffffffffff000ull
+
+/**
+ * @brief Sizes of the mappings
+ *
+ */
+#define PAGE_WALK_SIZE_4KB 0x1000ull
+#define PAGE_WALK_SIZE_2MB 0x200000ull
+#define PAGE_WALK_SIZE_1GB 0x40000000ull
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Read a 64-bit entry of the page tables from a physical address
+ * (returns FALSE if the entry is not readable)
+ *
+ */
+typedef BOOLEAN (*PAGE_WALK_READ_ENTRY)(PVOID Context, UINT64 PhysicalAddress, UINT64 * Entry);
+
+/**
+ * @brief A cached entry of the page tables
+ *
+ */
+typedef struct _PAGE_WALK_CACHE_ENTRY
+{
+    UINT64 Tag; // (bits of the virtual address translated by the entry << 1) | 1
+    UINT64 Entry;
+
+} PAGE_WALK_CACHE_ENTRY, *PPAGE_WALK_CACHE_ENTRY;
+
+/**
+ * @brief The state of the walks of a range (the cache is only valid for a
+ * single operation as the page tables might be changed later)
+ *
+ */
+typedef struct _PAGE_WALK_CACHE
+{
+    UINT64               Cr3; // physical address of the PML4 table
+    PAGE_WALK_READ_ENTRY ReadEntry;
+    PVOID                Context;
+
+    PAGE_WALK_CACHE_ENTRY Levels[PAGE_WALK_CACHED_LEVELS][PAGE_WALK_CACHE_ENTRIES];
+    UINT32                NextEntry[PAGE_WALK_CACHED_LEVELS];
+
+    UINT64 EntryReads; // count of the entries that are read from the page tables
+
+} PAGE_WALK_CACHE, *PPAGE_WALK_CACHE;
+
+/**
+ * @brief A physically contiguous run of a virtual range
+ *
+ */
+typedef struct _PAGE_WALK_RUN
+{
+    UINT64 VirtualAddress;
+    UINT64 PhysicalAddress;
+    UINT64 Size;
+
+} PAGE_WALK_RUN, *PPAGE_WALK_RUN;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+PageWalkInitialize(PPAGE_WALK_CACHE Cache, UINT64 Cr3, PAGE_WALK_READ_ENTRY ReadEntry, PVOID Context);
+
+BOOLEAN
+PageWalkTranslate(PPAGE_WALK_CACHE Cache, UINT64 VirtualAddress, UINT64 * PhysicalAddress, UINT64 * MappingSize);
+
+UINT32
+PageWalkBuildRuns(PPAGE_WALK_CACHE Cache,
+                  UINT64           VirtualAddress,
+                  UINT64           Size,
+                  PPAGE_WALK_RUN   Runs,
+                  UINT32           MaximumRuns,
+                  UINT64 *         TranslatedSize);
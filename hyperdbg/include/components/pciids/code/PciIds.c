@@ -0,0 +1,519 @@
+/**
+ * @file PciIds.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Binary index of the PCI ID database
+ * @details The text database (pci.ids) is compiled once into sorted tables of
+ * the vendors, the devices, and the subsystems with a pool of the names, so
+ * the index can be mapped as is and each lookup is a binary search without
+ * any allocation
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Parse an ID (exactly four hex digits)
+ *
+ * @param Text
+ * @param Id
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PciIdsParseId(const CHAR * Text, UINT16 * Id)
+{
+    UINT16 Value = 0;
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        CHAR Digit = Text[i];
+
+        if (Digit >= '0' && Digit <= '9')
+            Value = (UINT16)(Value << 4 | (Digit - '0'));
+        else if (Digit >= 'a' && Digit <= 'f')
+            Value = (UINT16)(Value << 4 | (Digit - 'a' + 10));
+        else if (Digit >= 'A' && Digit <= 'F')
+            Value = (UINT16)(Value << 4 | (Digit - 'A' + 10));
+        else
+            return FALSE;
+    }
+
+    *Id = Value;
+
+    return TRUE;
+}
+
+/**
+ * @brief Add a name to the pool
+ *
+ * @param Build
+ * @param Line
+ * @param Length Length of the line
+ * @param Offset Offset of the name in the line (after the IDs)
+ *
+ * @return UINT32 Offset of the name in the pool
+ */
+static UINT32
+PciIdsAddName(PPCI_IDS_BUILD Build, const CHAR * Line, SIZE_T Length, SIZE_T Offset)
+{
+    UINT32 Name = Build->NamesSize;
+
+    while (Offset < Length && (Line[Offset] == ' ' || Line[Offset] == '\t'))
+    {
+        Offset++;
+    }
+
+    if (Build->Names != NULL)
+    {
+        memcpy(Build->Names + Name, Line + Offset, Length - Offset);
+        Build->Names[Name + Length - Offset] = '\0';
+    }
+
+    Build->NamesSize += (UINT32)(Length - Offset + 1);
+
+    return Name;
+}
+
+/**
+ * @brief Parse the database (or only count its entries if the tables are NULL)
+ *
+ * @details The lines of a vendor are followed by its devices (one tab) and the
+ * lines of a device are followed by its subsystems (two tabs). The other
+ * top-level lines (e.g., the classes at the end of the database) end the
+ * current vendor
+ *
+ * @param Text
+ * @param TextSize
+ * @param Build
+ *
+ * @return VOID
+ */
+static VOID
+PciIdsParse(const CHAR * Text, SIZE_T TextSize, PPCI_IDS_BUILD Build)
+{
+    SIZE_T  Offset     = 0;
+    BOOLEAN IsInVendor = FALSE;
+    BOOLEAN IsInDevice = FALSE;
+    UINT16  Id;
+    UINT16  SubId;
+
+    while (Offset < TextSize)
+    {
+        const CHAR * Line   = Text + Offset;
+        SIZE_T       Length = 0;
+
+        while (Offset + Length < TextSize && Line[Length] != '\n')
+        {
+            Length++;
+        }
+
+        Offset += Length + 1;
+
+        while (Length != 0 && (Line[Length - 1] == '\r' || Line[Length - 1] == ' ' || Line[Length - 1] == '\t'))
+        {
+            Length--;
+        }
+
+        if (Length == 0 || Line[0] == '#')
+        {
+            continue;
+        }
+
+        if (Line[0] != '\t')
+        {
+            IsInVendor = Length > 5 && PciIdsParseId(Line, &Id) && Line[4] == ' ';
+            IsInDevice = FALSE;
+
+            if (IsInVendor)
+            {
+                UINT32 Name = PciIdsAddName(Build, Line, Length, 5);
+
+                if (Build->Vendors != NULL)
+                {
+                    PCI_IDS_VENDOR * Vendor = &Build->Vendors[Build->NumberOfVendors];
+
+                    Vendor->VendorId        = Id;
+                    Vendor->Reserved        = 0;
+                    Vendor->Name            = Name;
+                    Vendor->FirstDevice     = Build->NumberOfDevices;
+                    Vendor->NumberOfDevices = 0;
+                }
+
+                Build->NumberOfVendors++;
+            }
+        }
+        else if (Line[1] != '\t')
+        {
+            IsInDevice = IsInVendor && Length > 6 && PciIdsParseId(Line + 1, &Id) && Line[5] == ' ';
+
+            if (IsInDevice)
+            {
+                UINT32 Name = PciIdsAddName(Build, Line, Length, 6);
+
+                if (Build->Devices != NULL)
+                {
+                    PCI_IDS_DEVICE * Device = &Build->Devices[Build->NumberOfDevices];
+
+                    Device->DeviceId           = Id;
+                    Device->Reserved           = 0;
+                    Device->Name               = Name;
+                    Device->FirstSubDevice     = Build->NumberOfSubDevices;
+                    Device->NumberOfSubDevices = 0;
+
+                    Build->Vendors[Build->NumberOfVendors - 1].NumberOfDevices++;
+                }
+
+                Build->NumberOfDevices++;
+            }
+        }
+        else if (IsInDevice && Length > 12 && PciIdsParseId(Line + 2, &Id) && Line[6] == ' ' &&
+                 PciIdsParseId(Line + 7, &SubId) && Line[11] == ' ')
+        {
+            UINT32 Name = PciIdsAddName(Build, Line, Length, 12);
+
+            if (Build->SubDevices != NULL)
+            {
+                PCI_IDS_SUBDEVICE * SubDevice = &Build->SubDevices[Build->NumberOfSubDevices];
+
+                SubDevice->SubVendorId = Id;
+                SubDevice->SubDeviceId = SubId;
+                SubDevice->Name        = Name;
+
+                Build->Devices[Build->NumberOfDevices - 1].NumberOfSubDevices++;
+            }
+
+            Build->NumberOfSubDevices++;
+        }
+    }
+}
+
+//
+// The names are added in the order of the database, so comparing them after
+// the IDs keeps the first of the duplicated entries first
+//
+
+static int
+PciIdsCompareVendors(const void * First, const void * Second)
+{
+    const PCI_IDS_VENDOR * A = (const PCI_IDS_VENDOR *)First;
+    const PCI_IDS_VENDOR * B = (const PCI_IDS_VENDOR *)Second;
+
+    if (A->VendorId != B->VendorId)
+        return A->VendorId < B->VendorId ? -1 : 1;
+
+    return A->Name < B->Name ? -1 : A->Name > B->Name;
+}
+
+static int
+PciIdsCompareDevices(const void * First, const void * Second)
+{
+    const PCI_IDS_DEVICE * A = (const PCI_IDS_DEVICE *)First;
+    const PCI_IDS_DEVICE * B = (const PCI_IDS_DEVICE *)Second;
+
+    if (A->DeviceId != B->DeviceId)
+        return A->DeviceId < B->DeviceId ? -1 : 1;
+
+    return A->Name < B->Name ? -1 : A->Name > B->Name;
+}
+
+static int
+PciIdsCompareSubDevices(const void * First, const void * Second)
+{
+    const PCI_IDS_SUBDEVICE * A = (const PCI_IDS_SUBDEVICE *)First;
+    const PCI_IDS_SUBDEVICE * B = (const PCI_IDS_SUBDEVICE *)Second;
+
+    if (A->SubVendorId != B->SubVendorId)
+        return A->SubVendorId < B->SubVendorId ? -1 : 1;
+
+    if (A->SubDeviceId != B->SubDeviceId)
+        return A->SubDeviceId < B->SubDeviceId ? -1 : 1;
+
+    return A->Name < B->Name ? -1 : A->Name > B->Name;
+}
+
+/**
+ * @brief Compile the database into an index
+ *
+ * @details Call it once without a buffer to get the size of the index
+ *
+ * @param Text
+ * @param TextSize
+ * @param SourceSize Size of the database file
+ * @param SourceTimestamp Last write time of the database file
+ * @param Buffer NULL to only compute the size
+ * @param BufferSize
+ *
+ * @return UINT32 Size of the index (the index is only compiled if the buffer
+ * is large enough), or zero if the index is too large
+ */
+UINT32
+PciIdsCompile(const CHAR * Text,
+              SIZE_T       TextSize,
+              UINT64       SourceSize,
+              UINT64       SourceTimestamp,
+              VOID *       Buffer,
+              UINT32       BufferSize)
+{
+    PCI_IDS_BUILD    Build;
+    PCI_IDS_HEADER * Header = (PCI_IDS_HEADER *)Buffer;
+    UINT64           DevicesOffset;
+    UINT64           SubDevicesOffset;
+    UINT64           NamesOffset;
+    UINT64           TotalSize;
+
+    memset(&Build, 0, sizeof(PCI_IDS_BUILD));
+
+    PciIdsParse(Text, TextSize, &Build);
+
+    DevicesOffset    = sizeof(PCI_IDS_HEADER) + (UINT64)Build.NumberOfVendors * sizeof(PCI_IDS_VENDOR);
+    SubDevicesOffset = DevicesOffset + (UINT64)Build.NumberOfDevices * sizeof(PCI_IDS_DEVICE);
+    NamesOffset      = SubDevicesOffset + (UINT64)Build.NumberOfSubDevices * sizeof(PCI_IDS_SUBDEVICE);
+    TotalSize        = NamesOffset + Build.NamesSize;
+
+    if (TotalSize > 0xffffffff)
+    {
+        return 0;
+    }
+
+    if (Buffer == NULL || BufferSize < TotalSize)
+    {
+        return (UINT32)TotalSize;
+    }
+
+    //
+    // Parse the database again into the tables
+    //
+    memset(&Build, 0, sizeof(PCI_IDS_BUILD));
+
+    Build.Vendors    = (PCI_IDS_VENDOR *)((UINT8 *)Buffer + sizeof(PCI_IDS_HEADER));
+    Build.Devices    = (PCI_IDS_DEVICE *)((UINT8 *)Buffer + DevicesOffset);
+    Build.SubDevices = (PCI_IDS_SUBDEVICE *)((UINT8 *)Buffer + SubDevicesOffset);
+    Build.Names      = (CHAR *)Buffer + NamesOffset;
+
+    PciIdsParse(Text, TextSize, &Build);
+
+    //
+    // Each vendor keeps the range of its devices (and each device keeps the
+    // range of its subsystems) while the tables are sorted
+    //
+    qsort(Build.Vendors, Build.NumberOfVendors, sizeof(PCI_IDS_VENDOR), PciIdsCompareVendors);
+
+    for (UINT32 i = 0; i < Build.NumberOfVendors; i++)
+    {
+        qsort(&Build.Devices[Build.Vendors[i].FirstDevice],
+              Build.Vendors[i].NumberOfDevices,
+              sizeof(PCI_IDS_DEVICE),
+              PciIdsCompareDevices);
+    }
+
+    for (UINT32 i = 0; i < Build.NumberOfDevices; i++)
+    {
+        qsort(&Build.SubDevices[Build.Devices[i].FirstSubDevice],
+              Build.Devices[i].NumberOfSubDevices,
+              sizeof(PCI_IDS_SUBDEVICE),
+              PciIdsCompareSubDevices);
+    }
+
+    memset(Header, 0, sizeof(PCI_IDS_HEADER));
+
+    Header->Signature          = PCI_IDS_SIGNATURE;
+    Header->Version            = PCI_IDS_VERSION;
+    Header->SourceSize         = SourceSize;
+    Header->SourceTimestamp    = SourceTimestamp;
+    Header->TotalSize          = (UINT32)TotalSize;
+    Header->NumberOfVendors    = Build.NumberOfVendors;
+    Header->NumberOfDevices    = Build.NumberOfDevices;
+    Header->NumberOfSubDevices = Build.NumberOfSubDevices;
+    Header->VendorsOffset      = sizeof(PCI_IDS_HEADER);
+    Header->DevicesOffset      = (UINT32)DevicesOffset;
+    Header->SubDevicesOffset   = (UINT32)SubDevicesOffset;
+    Header->NamesOffset        = (UINT32)NamesOffset;
+    Header->NamesSize          = Build.NamesSize;
+
+    return (UINT32)TotalSize;
+}
+
+/**
+ * @brief Check whether an index is intact and belongs to the current database
+ *
+ * @details All of the offsets and the ranges are checked once here, so the
+ * lookups don't check them again
+ *
+ * @param Index
+ * @param IndexSize
+ * @param SourceSize
+ * @param SourceTimestamp
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PciIdsValidate(const VOID * Index, SIZE_T IndexSize, UINT64 SourceSize, UINT64 SourceTimestamp)
+{
+    const PCI_IDS_HEADER *    Header = (const PCI_IDS_HEADER *)Index;
+    const PCI_IDS_VENDOR *    Vendors;
+    const PCI_IDS_DEVICE *    Devices;
+    const PCI_IDS_SUBDEVICE * SubDevices;
+
+    if (IndexSize < sizeof(PCI_IDS_HEADER) || Header->Signature != PCI_IDS_SIGNATURE ||
+        Header->Version != PCI_IDS_VERSION || Header->SourceSize != SourceSize ||
+        Header->SourceTimestamp != SourceTimestamp || Header->TotalSize != IndexSize)
+    {
+        return FALSE;
+    }
+
+    if (Header->VendorsOffset != sizeof(PCI_IDS_HEADER) ||
+        Header->DevicesOffset != Header->VendorsOffset + (UINT64)Header->NumberOfVendors * sizeof(PCI_IDS_VENDOR) ||
+        Header->SubDevicesOffset != Header->DevicesOffset + (UINT64)Header->NumberOfDevices * sizeof(PCI_IDS_DEVICE) ||
+        Header->NamesOffset != Header->SubDevicesOffset + (UINT64)Header->NumberOfSubDevices * sizeof(PCI_IDS_SUBDEVICE) ||
+        Header->TotalSize != (UINT64)Header->NamesOffset + Header->NamesSize)
+    {
+        return FALSE;
+    }
+
+    if (Header->NamesSize != 0 && ((const CHAR *)Index)[Header->TotalSize - 1] != '\0')
+    {
+        return FALSE;
+    }
+
+    Vendors    = (const PCI_IDS_VENDOR *)((const UINT8 *)Index + Header->VendorsOffset);
+    Devices    = (const PCI_IDS_DEVICE *)((const UINT8 *)Index + Header->DevicesOffset);
+    SubDevices = (const PCI_IDS_SUBDEVICE *)((const UINT8 *)Index + Header->SubDevicesOffset);
+
+    for (UINT32 i = 0; i < Header->NumberOfVendors; i++)
+    {
+        if (Vendors[i].Name >= Header->NamesSize ||
+            (UINT64)Vendors[i].FirstDevice + Vendors[i].NumberOfDevices > Header->NumberOfDevices)
+        {
+            return FALSE;
+        }
+    }
+
+    for (UINT32 i = 0; i < Header->NumberOfDevices; i++)
+    {
+        if (Devices[i].Name >= Header->NamesSize ||
+            (UINT64)Devices[i].FirstSubDevice + Devices[i].NumberOfSubDevices > Header->NumberOfSubDevices)
+        {
+            return FALSE;
+        }
+    }
+
+    for (UINT32 i = 0; i < Header->NumberOfSubDevices; i++)
+    {
+        if (SubDevices[i].Name >= Header->NamesSize)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Find a vendor (the first one if it's duplicated)
+ *
+ * @param Index A validated index
+ * @param VendorId
+ *
+ * @return const PCI_IDS_VENDOR * NULL if it's not found
+ */
+const PCI_IDS_VENDOR *
+PciIdsFindVendor(const PCI_IDS_HEADER * Index, UINT16 VendorId)
+{
+    const PCI_IDS_VENDOR * Vendors = (const PCI_IDS_VENDOR *)((const UINT8 *)Index + Index->VendorsOffset);
+    UINT32                 Low     = 0;
+    UINT32                 High    = Index->NumberOfVendors;
+
+    while (Low < High)
+    {
+        UINT32 Middle = Low + (High - Low) / 2;
+
+        if (Vendors[Middle].VendorId < VendorId)
+            Low = Middle + 1;
+        else
+            High = Middle;
+    }
+
+    return Low < Index->NumberOfVendors && Vendors[Low].VendorId == VendorId ? &Vendors[Low] : NULL;
+}
+
+/**
+ * @brief Find a device of a vendor
+ *
+ * @param Index A validated index
+ * @param Vendor
+ * @param DeviceId
+ *
+ * @return const PCI_IDS_DEVICE * NULL if it's not found
+ */
+const PCI_IDS_DEVICE *
+PciIdsFindDevice(const PCI_IDS_HEADER * Index, const PCI_IDS_VENDOR * Vendor, UINT16 DeviceId)
+{
+    const PCI_IDS_DEVICE * Devices = (const PCI_IDS_DEVICE *)((const UINT8 *)Index + Index->DevicesOffset) + Vendor->FirstDevice;
+    UINT32                 Low     = 0;
+    UINT32                 High    = Vendor->NumberOfDevices;
+
+    while (Low < High)
+    {
+        UINT32 Middle = Low + (High - Low) / 2;
+
+        if (Devices[Middle].DeviceId < DeviceId)
+            Low = Middle + 1;
+        else
+            High = Middle;
+    }
+
+    return Low < Vendor->NumberOfDevices && Devices[Low].DeviceId == DeviceId ? &Devices[Low] : NULL;
+}
+
+/**
+ * @brief Find a subsystem of a device
+ *
+ * @param Index A validated index
+ * @param Device
+ * @param SubVendorId
+ * @param SubDeviceId
+ *
+ * @return const PCI_IDS_SUBDEVICE * NULL if it's not found
+ */
+const PCI_IDS_SUBDEVICE *
+PciIdsFindSubDevice(const PCI_IDS_HEADER * Index, const PCI_IDS_DEVICE * Device, UINT16 SubVendorId, UINT16 SubDeviceId)
+{
+    const PCI_IDS_SUBDEVICE * SubDevices = (const PCI_IDS_SUBDEVICE *)((const UINT8 *)Index + Index->SubDevicesOffset) + Device->FirstSubDevice;
+    UINT32                    Key        = (UINT32)SubVendorId << 16 | SubDeviceId;
+    UINT32                    Low        = 0;
+    UINT32                    High       = Device->NumberOfSubDevices;
+
+    while (Low < High)
+    {
+        UINT32 Middle = Low + (High - Low) / 2;
+
+        if (((UINT32)SubDevices[Middle].SubVendorId << 16 | SubDevices[Middle].SubDeviceId) < Key)
+            Low = Middle + 1;
+        else
+            High = Middle;
+    }
+
+    if (Low < Device->NumberOfSubDevices && SubDevices[Low].SubVendorId == SubVendorId && SubDevices[Low].SubDeviceId == SubDeviceId)
+    {
+        return &SubDevices[Low];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get a name from the pool
+ *
+ * @param Index A validated index
+ * @param Name
+ *
+ * @return const CHAR *
+ */
+const CHAR *
+PciIdsGetName(const PCI_IDS_HEADER * Index, UINT32 Name)
+{
+    return (const CHAR *)Index + Index->NamesOffset + Name;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file PciIds.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the binary index of the PCI ID database
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Signature ('PIDX') and version of the indexes
+ *
+ */
+#define PCI_IDS_SIGNATURE 0x58444950
+#define PCI_IDS_VERSION   1
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Header of an index
+ *
+ * @details The header is followed by the vendors (sorted by their IDs), the
+ * devices (each vendor's devices are sorted by their IDs), the subsystems
+ * (each device's subsystems are sorted by their sub-vendor and sub-device
+ * IDs), and the pool of the null-terminated names. The size and the last
+ * write time of the database are kept to rebuild the index when it changes
+ *
+ */
+typedef struct _PCI_IDS_HEADER
+{
+    UINT32 Signature;
+    UINT32 Version;
+    UINT64 SourceSize;
+    UINT64 SourceTimestamp;
+    UINT32 TotalSize;
+    UINT32 NumberOfVendors;
+    UINT32 NumberOfDevices;
+    UINT32 NumberOfSubDevices;
+    UINT32 VendorsOffset;
+    UINT32 DevicesOffset;
+    UINT32 SubDevicesOffset;
+    UINT32 NamesOffset;
+    UINT32 NamesSize;
+    UINT32 Reserved;
+
+} PCI_IDS_HEADER, *PPCI_IDS_HEADER;
+
+/**
+ * @brief A vendor of the index
+ *
+ */
+typedef struct _PCI_IDS_VENDOR
+{
+    UINT16 VendorId;
+    UINT16 Reserved;
+    UINT32 Name; // offset in the pool of the names
+    UINT32 FirstDevice;
+    UINT32 NumberOfDevices;
+
+} PCI_IDS_VENDOR, *PPCI_IDS_VENDOR;
+
+/**
+ * @brief A device of the index
+ *
+ */
+typedef struct _PCI_IDS_DEVICE
+{
+    UINT16 DeviceId;
+    UINT16 Reserved;
+    UINT32 Name;
+    UINT32 FirstSubDevice;
+    UINT32 NumberOfSubDevices;
+
+} PCI_IDS_DEVICE, *PPCI_IDS_DEVICE;
+
+/**
+ * @brief A subsystem of the index
+ *
+ */
+typedef struct _PCI_IDS_SUBDEVICE
+{
+    UINT16 SubVendorId;
+    UINT16 SubDeviceId;
+    UINT32 Name;
+
+} PCI_IDS_SUBDEVICE, *PPCI_IDS_SUBDEVICE;
+
+/**
+ * @brief State of compiling an index (the tables are NULL while counting)
+ *
+ */
+typedef struct _PCI_IDS_BUILD
+{
+    PCI_IDS_VENDOR *    Vendors;
+    PCI_IDS_DEVICE *    Devices;
+    PCI_IDS_SUBDEVICE * SubDevices;
+    CHAR *              Names;
+    UINT32              NumberOfVendors;
+    UINT32              NumberOfDevices;
+    UINT32              NumberOfSubDevices;
+    UINT32              NamesSize;
+
+} PCI_IDS_BUILD, *PPCI_IDS_BUILD;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT32
+PciIdsCompile(const CHAR * Text,
+              SIZE_T       TextSize,
+              UINT64       SourceSize,
+              UINT64       SourceTimestamp,
+              VOID *       Buffer,
+              UINT32       BufferSize);
+
+BOOLEAN
+PciIdsValidate(const VOID * Index, SIZE_T IndexSize, UINT64 SourceSize, UINT64 SourceTimestamp);
+
+const PCI_IDS_VENDOR *
+PciIdsFindVendor(const PCI_IDS_HEADER * Index, UINT16 VendorId);
+
+const PCI_IDS_DEVICE *
+PciIdsFindDevice(const PCI_IDS_HEADER * Index, const PCI_IDS_VENDOR * Vendor, UINT16 DeviceId);
+
+const PCI_IDS_SUBDEVICE *
+PciIdsFindSubDevice(const PCI_IDS_HEADER * Index, const PCI_IDS_DEVICE * Device, UINT16 SubVendorId, UINT16 SubDeviceId);
+
+const CHAR *
+PciIdsGetName(const PCI_IDS_HEADER * Index, UINT32 Name);
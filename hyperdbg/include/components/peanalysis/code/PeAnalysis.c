@@ -0,0 +1,957 @@
+/**
+ * @file PeAnalysis.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The kernels and the summaries of analyzing the PE images in batches
+ * @details The images are parsed by the offsets of the fields (no structure of
+ * the Windows headers is needed), so the same code is used by the '.pe' command
+ * and tested on Linux
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Offsets of the fields of the headers
+//
+#define PE_ANALYSIS_DOS_HEADER_SIZE          0x40
+#define PE_ANALYSIS_DOS_LFANEW_OFFSET        0x3c
+#define PE_ANALYSIS_DOS_SIGNATURE            0x5a4d
+#define PE_ANALYSIS_NT_SIGNATURE             0x00004550
+#define PE_ANALYSIS_FILE_HEADER_SIZE         20
+#define PE_ANALYSIS_OPTIONAL_HEADER32_MAGIC  0x10b
+#define PE_ANALYSIS_OPTIONAL_HEADER64_MAGIC  0x20b
+#define PE_ANALYSIS_OPTIONAL_HEADER32_SIZE   224
+#define PE_ANALYSIS_OPTIONAL_HEADER64_SIZE   240
+#define PE_ANALYSIS_SECTION_HEADER_SIZE      40
+#define PE_ANALYSIS_CHECKSUM_FIELD_OFFSET    64
+#define PE_ANALYSIS_CHECKSUM_BLOCK_SIZE      0x40000000
+
+/**
+ * @brief Read a 16-bit field of the image
+ *
+ * @param Data
+ *
+ * @return UINT16
+ */
+static UINT16
+PeAnalysisRead16(const BYTE * Data)
+{
+    UINT16 Value;
+
+    memcpy(&Value, Data, sizeof(Value));
+
+    return Value;
+}
+
+/**
+ * @brief Read a 32-bit field of the image
+ *
+ * @param Data
+ *
+ * @return UINT32
+ */
+static UINT32
+PeAnalysisRead32(const BYTE * Data)
+{
+    UINT32 Value;
+
+    memcpy(&Value, Data, sizeof(Value));
+
+    return Value;
+}
+
+/**
+ * @brief Read a 64-bit field of the image
+ *
+ * @param Data
+ *
+ * @return UINT64
+ */
+static UINT64
+PeAnalysisRead64(const BYTE * Data)
+{
+    UINT64 Value;
+
+    memcpy(&Value, Data, sizeof(Value));
+
+    return Value;
+}
+
+/**
+ * @brief Compute the FNV-1a (64-bit) hash of a buffer
+ *
+ * @param Data
+ * @param Size
+ *
+ * @return UINT64
+ */
+UINT64
+PeAnalysisFnv1a64(const BYTE * Data, SIZE_T Size)
+{
+    UINT64 Hash = PE_ANALYSIS_FNV1A64_OFFSET_BASIS;
+    SIZE_T i    = 0;
+
+    //
+    // Each byte depends on the hash of the previous bytes, reading eight bytes
+    // at once only saves the loads
+    //
+    for (; i + 8 <= Size; i += 8)
+    {
+        UINT64 Word = PeAnalysisRead64(&Data[i]);
+
+        for (UINT32 j = 0; j < 8; j++)
+        {
+            Hash ^= (BYTE)(Word >> (j * 8));
+            Hash *= PE_ANALYSIS_FNV1A64_PRIME;
+        }
+    }
+
+    for (; i < Size; i++)
+    {
+        Hash ^= Data[i];
+        Hash *= PE_ANALYSIS_FNV1A64_PRIME;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Merge the tables of the counters into the counts of the caller
+ *
+ * @param Tables
+ * @param Counts
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisMergeCounts(UINT64 Tables[4][256], UINT64 * Counts)
+{
+    for (UINT32 i = 0; i < 256; i++)
+    {
+        Counts[i] += Tables[0][i] + Tables[1][i] + Tables[2][i] + Tables[3][i];
+    }
+}
+
+/**
+ * @brief Count the bytes of a buffer
+ *
+ * @details The bytes are counted into four tables, so the increments of the
+ * same value in a row don't wait for each other
+ *
+ * @param Data
+ * @param Size
+ * @param Counts 256 counters, the bytes are added to them
+ *
+ * @return VOID
+ */
+VOID
+PeAnalysisCountBytes(const BYTE * Data, SIZE_T Size, UINT64 * Counts)
+{
+    UINT64 Tables[4][256];
+    SIZE_T i = 0;
+
+    memset(Tables, 0, sizeof(Tables));
+
+    for (; i + 8 <= Size; i += 8)
+    {
+        UINT64 Word = PeAnalysisRead64(&Data[i]);
+
+        Tables[0][(BYTE)Word]++;
+        Tables[1][(BYTE)(Word >> 8)]++;
+        Tables[2][(BYTE)(Word >> 16)]++;
+        Tables[3][(BYTE)(Word >> 24)]++;
+        Tables[0][(BYTE)(Word >> 32)]++;
+        Tables[1][(BYTE)(Word >> 40)]++;
+        Tables[2][(BYTE)(Word >> 48)]++;
+        Tables[3][(BYTE)(Word >> 56)]++;
+    }
+
+    for (; i < Size; i++)
+    {
+        Tables[0][Data[i]]++;
+    }
+
+    PeAnalysisMergeCounts(Tables, Counts);
+}
+
+/**
+ * @brief Compute the FNV-1a (64-bit) hash and count the bytes of a buffer in a
+ * single pass
+ *
+ * @param Data
+ * @param Size
+ * @param Counts 256 counters, the bytes are added to them
+ *
+ * @return UINT64 The hash
+ */
+UINT64
+PeAnalysisHashAndCountBytes(const BYTE * Data, SIZE_T Size, UINT64 * Counts)
+{
+    UINT64 Tables[4][256];
+    UINT64 Hash = PE_ANALYSIS_FNV1A64_OFFSET_BASIS;
+    SIZE_T i    = 0;
+
+    memset(Tables, 0, sizeof(Tables));
+
+    for (; i + 8 <= Size; i += 8)
+    {
+        UINT64 Word = PeAnalysisRead64(&Data[i]);
+
+        for (UINT32 j = 0; j < 8; j++)
+        {
+            BYTE Value = (BYTE)(Word >> (j * 8));
+
+            Tables[j & 3][Value]++;
+
+            Hash ^= Value;
+            Hash *= PE_ANALYSIS_FNV1A64_PRIME;
+        }
+    }
+
+    for (; i < Size; i++)
+    {
+        Tables[0][Data[i]]++;
+
+        Hash ^= Data[i];
+        Hash *= PE_ANALYSIS_FNV1A64_PRIME;
+    }
+
+    PeAnalysisMergeCounts(Tables, Counts);
+
+    return Hash;
+}
+
+/**
+ * @brief Compute the Shannon entropy (bits per byte) from the counts of the bytes
+ *
+ * @param Counts 256 counters
+ * @param Size Number of the counted bytes
+ *
+ * @return double
+ */
+double
+PeAnalysisEntropy(const UINT64 * Counts, UINT64 Size)
+{
+    double Entropy = 0.0;
+
+    for (UINT32 i = 0; i < 256; i++)
+    {
+        if (Counts[i] != 0)
+        {
+            double Probability = (double)Counts[i] / (double)Size;
+            Entropy -= Probability * (log(Probability) / log(2.0));
+        }
+    }
+
+    return Entropy;
+}
+
+/**
+ * @brief Compute the Shannon entropy (bits per byte) of a buffer
+ *
+ * @param Data
+ * @param Size
+ *
+ * @return double
+ */
+double
+PeAnalysisCalculateEntropy(const BYTE * Data, SIZE_T Size)
+{
+    UINT64 Counts[256] = {0};
+
+    PeAnalysisCountBytes(Data, Size, Counts);
+
+    return PeAnalysisEntropy(Counts, Size);
+}
+
+/**
+ * @brief Add the 16-bit words of a part of the image
+ *
+ * @details The words are added without folding the carries, both halves of
+ * eight bytes are added at once as the sum is only needed modulo 0xffff (and
+ * 0x10000 is 1 modulo 0xffff)
+ *
+ * @param Data
+ * @param Size
+ * @param Sum
+ * @param NonZero Bits of the words (zero if all of the words are zero)
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisSumWords(const BYTE * Data, SIZE_T Size, UINT64 * Sum, UINT64 * NonZero)
+{
+    while (Size != 0)
+    {
+        SIZE_T BlockSize = Size < PE_ANALYSIS_CHECKSUM_BLOCK_SIZE ? Size : PE_ANALYSIS_CHECKSUM_BLOCK_SIZE;
+        UINT64 Sum0      = 0;
+        UINT64 Sum1      = 0;
+        UINT64 Bits      = 0;
+        SIZE_T i         = 0;
+
+        //
+        // A block adds less than 2^34 to each sum for every 16 bytes, so the
+        // sums can't overflow before the block is folded
+        //
+        for (; i + 16 <= BlockSize; i += 16)
+        {
+            UINT64 Word0 = PeAnalysisRead64(&Data[i]);
+            UINT64 Word1 = PeAnalysisRead64(&Data[i + 8]);
+
+            Sum0 += (Word0 & 0xffffffff) + (Word0 >> 32);
+            Sum1 += (Word1 & 0xffffffff) + (Word1 >> 32);
+            Bits |= Word0 | Word1;
+        }
+
+        for (; i + 2 <= BlockSize; i += 2)
+        {
+            UINT16 Word = PeAnalysisRead16(&Data[i]);
+
+            Sum0 += Word;
+            Bits |= Word;
+        }
+
+        //
+        // The last byte of an odd size is added as the low byte of a word
+        //
+        if (i < BlockSize)
+        {
+            Sum0 += Data[i];
+            Bits |= Data[i];
+        }
+
+        Sum0 += Sum1;
+        Sum0 = (Sum0 & 0xffffffff) + (Sum0 >> 32);
+
+        *Sum += Sum0;
+        *Sum = (*Sum & 0xffffffff) + (*Sum >> 32);
+        *NonZero |= Bits;
+
+        Data += BlockSize;
+        Size -= BlockSize;
+    }
+}
+
+/**
+ * @brief Compute the checksum of an image (the same value as the PE loader)
+ *
+ * @details The 16-bit words of the image (the checksum field is zero) are added
+ * with end-around carries, and the size of the image is added to the result.
+ * The end-around carries of all of the words are the same as the sum modulo
+ * 0xffff, except that a non-zero sum is never folded to zero
+ *
+ * @param Image
+ * @param ImageSize
+ * @param ChecksumOffset Offset of the (4-byte) checksum field
+ * @param Checksum
+ *
+ * @return BOOLEAN FALSE if the checksum field is not in the image
+ */
+BOOLEAN
+PeAnalysisChecksum(const BYTE * Image, SIZE_T ImageSize, SIZE_T ChecksumOffset, UINT32 * Checksum)
+{
+    UINT64 Sum     = 0;
+    UINT64 NonZero = 0;
+    SIZE_T FieldStart;
+    SIZE_T FieldEnd;
+
+    if (ChecksumOffset > ImageSize || ImageSize - ChecksumOffset < sizeof(UINT32))
+    {
+        return FALSE;
+    }
+
+    //
+    // The words at the even offsets in the checksum field are skipped
+    //
+    FieldStart = (ChecksumOffset + 1) & ~(SIZE_T)1;
+    FieldEnd   = FieldStart + sizeof(UINT32) < ImageSize ? FieldStart + sizeof(UINT32) : ImageSize;
+
+    PeAnalysisSumWords(Image, FieldStart, &Sum, &NonZero);
+    PeAnalysisSumWords(&Image[FieldEnd], ImageSize - FieldEnd, &Sum, &NonZero);
+
+    if (NonZero != 0)
+    {
+        Sum %= 0xffff;
+
+        if (Sum == 0)
+        {
+            Sum = 0xffff;
+        }
+    }
+
+    *Checksum = (UINT32)Sum + (UINT32)ImageSize;
+
+    return TRUE;
+}
+
+/**
+ * @brief Analyze the sections of an image
+ *
+ * @param Image
+ * @param ImageSize
+ * @param SectionTable Offset of the section table (all of the headers are in the image)
+ * @param SizeOfHeaders
+ * @param Summary
+ * @param Sections
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAnalyzeSections(const BYTE *          Image,
+                          SIZE_T                ImageSize,
+                          SIZE_T                SectionTable,
+                          UINT32                SizeOfHeaders,
+                          PE_ANALYSIS_IMAGE *   Summary,
+                          PE_ANALYSIS_SECTION * Sections)
+{
+    UINT64 RawDataEnd     = SizeOfHeaders < ImageSize ? SizeOfHeaders : ImageSize;
+    double HighestEntropy = -1.0;
+
+    for (UINT32 i = 0; i < Summary->NumberOfSections; i++)
+    {
+        const BYTE *        Header          = &Image[SectionTable + (SIZE_T)i * PE_ANALYSIS_SECTION_HEADER_SIZE];
+        UINT32              PointerToRaw    = PeAnalysisRead32(&Header[20]);
+        UINT32              SizeOfRawData   = PeAnalysisRead32(&Header[16]);
+        UINT32              Characteristics = PeAnalysisRead32(&Header[36]);
+        UINT32              AnalyzedSize    = 0;
+        PE_ANALYSIS_SECTION Section;
+        UINT64              Counts[256] = {0};
+
+        //
+        // Only the part of the raw data that is in the file is analyzed
+        //
+        if (SizeOfRawData != 0 && PointerToRaw < ImageSize)
+        {
+            AnalyzedSize = ImageSize - PointerToRaw < SizeOfRawData ? (UINT32)(ImageSize - PointerToRaw) : SizeOfRawData;
+
+            if ((UINT64)PointerToRaw + AnalyzedSize > RawDataEnd)
+            {
+                RawDataEnd = (UINT64)PointerToRaw + AnalyzedSize;
+            }
+        }
+
+        if ((Characteristics & PE_ANALYSIS_SECTION_MEM_EXECUTE) && (Characteristics & PE_ANALYSIS_SECTION_MEM_WRITE))
+        {
+            Summary->WritableExecutableSections++;
+        }
+
+        if (i >= PE_ANALYSIS_MAXIMUM_SECTIONS)
+        {
+            continue;
+        }
+
+        memset(&Section, 0, sizeof(Section));
+        memcpy(Section.Name, Header, 8);
+
+        Section.VirtualSize      = PeAnalysisRead32(&Header[8]);
+        Section.VirtualAddress   = PeAnalysisRead32(&Header[12]);
+        Section.PointerToRawData = PointerToRaw;
+        Section.SizeOfRawData    = SizeOfRawData;
+        Section.AnalyzedSize     = AnalyzedSize;
+        Section.Characteristics  = Characteristics;
+        Section.Fnv1a64          = PeAnalysisHashAndCountBytes(&Image[AnalyzedSize != 0 ? PointerToRaw : 0], AnalyzedSize, Counts);
+        Section.Entropy          = PeAnalysisEntropy(Counts, AnalyzedSize);
+
+        if (AnalyzedSize != 0 && Section.Entropy > HighestEntropy)
+        {
+            HighestEntropy                 = Section.Entropy;
+            Summary->HighestEntropySection = i;
+        }
+
+        Sections[i] = Section;
+        Summary->NumberOfAnalyzedSections++;
+    }
+
+    Summary->OverlaySize = ImageSize - RawDataEnd;
+}
+
+/**
+ * @brief Analyze an image
+ *
+ * @details The fields are filled until the first error, the sections after
+ * PE_ANALYSIS_MAXIMUM_SECTIONS are only counted
+ *
+ * @param Image
+ * @param ImageSize
+ * @param Summary
+ * @param Sections Should have room for PE_ANALYSIS_MAXIMUM_SECTIONS sections
+ *
+ * @return PE_ANALYSIS_STATUS
+ */
+PE_ANALYSIS_STATUS
+PeAnalysisAnalyzeImage(const BYTE * Image, SIZE_T ImageSize, PE_ANALYSIS_IMAGE * Summary, PE_ANALYSIS_SECTION * Sections)
+{
+    INT32  NtHeaders;
+    SIZE_T OptionalHeader;
+    SIZE_T SectionTable;
+    UINT16 SizeOfOptionalHeader;
+    UINT16 Magic;
+    UINT32 MinimumOptionalHeaderSize;
+
+    memset(Summary, 0, sizeof(PE_ANALYSIS_IMAGE));
+
+    Summary->FileSize = ImageSize;
+    Summary->Status   = PE_ANALYSIS_STATUS_NOT_PE_IMAGE;
+
+    if (ImageSize < PE_ANALYSIS_DOS_HEADER_SIZE || PeAnalysisRead16(Image) != PE_ANALYSIS_DOS_SIGNATURE)
+    {
+        return Summary->Status;
+    }
+
+    NtHeaders = (INT32)PeAnalysisRead32(&Image[PE_ANALYSIS_DOS_LFANEW_OFFSET]);
+
+    if (NtHeaders < 0 || (UINT64)NtHeaders + sizeof(UINT32) > ImageSize)
+    {
+        return Summary->Status;
+    }
+
+    if (PeAnalysisRead32(&Image[NtHeaders]) != PE_ANALYSIS_NT_SIGNATURE)
+    {
+        return Summary->Status;
+    }
+
+    Summary->Status = PE_ANALYSIS_STATUS_TRUNCATED_HEADERS;
+    OptionalHeader  = (SIZE_T)NtHeaders + sizeof(UINT32) + PE_ANALYSIS_FILE_HEADER_SIZE;
+
+    if (ImageSize < OptionalHeader + sizeof(UINT16))
+    {
+        return Summary->Status;
+    }
+
+    Summary->Machine          = PeAnalysisRead16(&Image[NtHeaders + 4]);
+    Summary->NumberOfSections = PeAnalysisRead16(&Image[NtHeaders + 6]);
+    Summary->TimeDateStamp    = PeAnalysisRead32(&Image[NtHeaders + 8]);
+    SizeOfOptionalHeader      = PeAnalysisRead16(&Image[NtHeaders + 20]);
+    Summary->Characteristics  = PeAnalysisRead16(&Image[NtHeaders + 22]);
+    Magic                     = PeAnalysisRead16(&Image[OptionalHeader]);
+
+    if (Magic == PE_ANALYSIS_OPTIONAL_HEADER32_MAGIC)
+    {
+        MinimumOptionalHeaderSize = PE_ANALYSIS_OPTIONAL_HEADER32_SIZE;
+    }
+    else if (Magic == PE_ANALYSIS_OPTIONAL_HEADER64_MAGIC)
+    {
+        MinimumOptionalHeaderSize = PE_ANALYSIS_OPTIONAL_HEADER64_SIZE;
+        Summary->IsPe32Plus       = TRUE;
+    }
+    else
+    {
+        Summary->Status = PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER;
+        return Summary->Status;
+    }
+
+    if (SizeOfOptionalHeader < MinimumOptionalHeaderSize)
+    {
+        Summary->Status = PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER;
+        return Summary->Status;
+    }
+
+    SectionTable = OptionalHeader + SizeOfOptionalHeader;
+
+    if (ImageSize < SectionTable ||
+        (ImageSize - SectionTable) / PE_ANALYSIS_SECTION_HEADER_SIZE < Summary->NumberOfSections)
+    {
+        return Summary->Status;
+    }
+
+    Summary->AddressOfEntryPoint = PeAnalysisRead32(&Image[OptionalHeader + 16]);
+    Summary->ImageBase           = Summary->IsPe32Plus ? PeAnalysisRead64(&Image[OptionalHeader + 24]) : PeAnalysisRead32(&Image[OptionalHeader + 28]);
+    Summary->SizeOfImage         = PeAnalysisRead32(&Image[OptionalHeader + 56]);
+    Summary->HeaderChecksum      = PeAnalysisRead32(&Image[OptionalHeader + PE_ANALYSIS_CHECKSUM_FIELD_OFFSET]);
+    Summary->Subsystem           = PeAnalysisRead16(&Image[OptionalHeader + 68]);
+    Summary->DllCharacteristics  = PeAnalysisRead16(&Image[OptionalHeader + 70]);
+
+    PeAnalysisChecksum(Image, ImageSize, OptionalHeader + PE_ANALYSIS_CHECKSUM_FIELD_OFFSET, &Summary->ComputedChecksum);
+
+    PeAnalysisAnalyzeSections(Image,
+                              ImageSize,
+                              SectionTable,
+                              PeAnalysisRead32(&Image[OptionalHeader + 60]),
+                              Summary,
+                              Sections);
+
+    Summary->FileEntropy = PeAnalysisCalculateEntropy(Image, ImageSize);
+    Summary->Status      = PE_ANALYSIS_STATUS_SUCCESS;
+
+    return Summary->Status;
+}
+
+/**
+ * @brief Get the name of a status (as it appears in the summaries)
+ *
+ * @param Status
+ *
+ * @return const CHAR *
+ */
+const CHAR *
+PeAnalysisGetStatusName(PE_ANALYSIS_STATUS Status)
+{
+    switch (Status)
+    {
+    case PE_ANALYSIS_STATUS_SUCCESS:
+        return "ok";
+    case PE_ANALYSIS_STATUS_NOT_PE_IMAGE:
+        return "not-pe";
+    case PE_ANALYSIS_STATUS_TRUNCATED_HEADERS:
+        return "truncated-headers";
+    case PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER:
+        return "unsupported-optional-header";
+    case PE_ANALYSIS_STATUS_UNABLE_TO_OPEN:
+        return "unable-to-open";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief Append a string to the line
+ *
+ * @param Writer
+ * @param String
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppend(PE_ANALYSIS_WRITER * Writer, const CHAR * String)
+{
+    SIZE_T Length = strlen(String);
+
+    if (Writer->IsOverflowed || Length >= Writer->BufferSize - Writer->Length)
+    {
+        Writer->IsOverflowed = TRUE;
+        return;
+    }
+
+    memcpy(&Writer->Buffer[Writer->Length], String, Length + 1);
+    Writer->Length += (UINT32)Length;
+}
+
+/**
+ * @brief Append a number to the line
+ *
+ * @param Writer
+ * @param IsHex
+ * @param Value
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppendNumber(PE_ANALYSIS_WRITER * Writer, BOOLEAN IsHex, UINT64 Value)
+{
+    CHAR Number[24];
+
+    snprintf(Number, sizeof(Number), IsHex ? "0x%llx" : "%llu", (unsigned long long)Value);
+
+    PeAnalysisAppend(Writer, Number);
+}
+
+/**
+ * @brief Append an entropy to the line
+ *
+ * @param Writer
+ * @param Entropy
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppendEntropy(PE_ANALYSIS_WRITER * Writer, double Entropy)
+{
+    CHAR Number[24];
+
+    snprintf(Number, sizeof(Number), "%.4f", Entropy);
+
+    PeAnalysisAppend(Writer, Number);
+}
+
+/**
+ * @brief Append a quoted and escaped string to a JSON line
+ *
+ * @details The bytes outside of the printable ASCII are escaped (the paths and
+ * the names of the sections are not always UTF-8)
+ *
+ * @param Writer
+ * @param String
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppendJsonString(PE_ANALYSIS_WRITER * Writer, const CHAR * String)
+{
+    CHAR Character[8];
+
+    PeAnalysisAppend(Writer, "\"");
+
+    for (; *String != '\0' && !Writer->IsOverflowed; String++)
+    {
+        BYTE Value = (BYTE)*String;
+
+        if (Value == '"' || Value == '\\')
+        {
+            Character[0] = '\\';
+            Character[1] = (CHAR)Value;
+            Character[2] = '\0';
+        }
+        else if (Value < 0x20 || Value >= 0x7f)
+        {
+            snprintf(Character, sizeof(Character), "\\u%04x", Value);
+        }
+        else
+        {
+            Character[0] = (CHAR)Value;
+            Character[1] = '\0';
+        }
+
+        PeAnalysisAppend(Writer, Character);
+    }
+
+    PeAnalysisAppend(Writer, "\"");
+}
+
+/**
+ * @brief Append a quoted string to a CSV line
+ *
+ * @details The quotes are doubled, and the line breaks are replaced (a row is
+ * always a single line)
+ *
+ * @param Writer
+ * @param String
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppendCsvString(PE_ANALYSIS_WRITER * Writer, const CHAR * String)
+{
+    CHAR Character[3];
+
+    PeAnalysisAppend(Writer, "\"");
+
+    for (; *String != '\0' && !Writer->IsOverflowed; String++)
+    {
+        Character[0] = *String == '\r' || *String == '\n' ? ' ' : *String;
+        Character[1] = *String == '"' ? '"' : '\0';
+        Character[2] = '\0';
+
+        PeAnalysisAppend(Writer, Character);
+    }
+
+    PeAnalysisAppend(Writer, "\"");
+}
+
+/**
+ * @brief Append a field of a JSON object
+ *
+ * @param Writer
+ * @param Name
+ * @param IsHex
+ * @param Value
+ *
+ * @return VOID
+ */
+static VOID
+PeAnalysisAppendJsonNumber(PE_ANALYSIS_WRITER * Writer, const CHAR * Name, BOOLEAN IsHex, UINT64 Value)
+{
+    PeAnalysisAppend(Writer, ",\"");
+    PeAnalysisAppend(Writer, Name);
+    PeAnalysisAppend(Writer, IsHex ? "\":\"" : "\":");
+    PeAnalysisAppendNumber(Writer, IsHex, Value);
+
+    if (IsHex)
+    {
+        PeAnalysisAppend(Writer, "\"");
+    }
+}
+
+/**
+ * @brief Finish a line
+ *
+ * @param Writer
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+static UINT32
+PeAnalysisFinishLine(PE_ANALYSIS_WRITER * Writer)
+{
+    PeAnalysisAppend(Writer, "\n");
+
+    return Writer->IsOverflowed ? 0 : Writer->Length;
+}
+
+/**
+ * @brief Format the summary of an image as a JSON object (a single line)
+ *
+ * @details The hashes, the addresses, and the flags are hex strings (the hashes
+ * don't fit into the numbers of JSON)
+ *
+ * @param Path
+ * @param Summary
+ * @param Sections
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+PeAnalysisFormatJson(const CHAR *                Path,
+                     const PE_ANALYSIS_IMAGE *   Summary,
+                     const PE_ANALYSIS_SECTION * Sections,
+                     CHAR *                      Buffer,
+                     UINT32                      BufferSize)
+{
+    PE_ANALYSIS_WRITER Writer = {Buffer, BufferSize, 0, FALSE};
+
+    PeAnalysisAppend(&Writer, "{\"path\":");
+    PeAnalysisAppendJsonString(&Writer, Path);
+    PeAnalysisAppend(&Writer, ",\"status\":\"");
+    PeAnalysisAppend(&Writer, PeAnalysisGetStatusName(Summary->Status));
+    PeAnalysisAppend(&Writer, "\"");
+    PeAnalysisAppendJsonNumber(&Writer, "file_size", FALSE, Summary->FileSize);
+
+    if (Summary->Status != PE_ANALYSIS_STATUS_SUCCESS)
+    {
+        PeAnalysisAppend(&Writer, "}");
+        return PeAnalysisFinishLine(&Writer);
+    }
+
+    PeAnalysisAppendJsonNumber(&Writer, "machine", TRUE, Summary->Machine);
+    PeAnalysisAppend(&Writer, Summary->IsPe32Plus ? ",\"format\":\"pe32+\"" : ",\"format\":\"pe32\"");
+    PeAnalysisAppendJsonNumber(&Writer, "timestamp", TRUE, Summary->TimeDateStamp);
+    PeAnalysisAppendJsonNumber(&Writer, "characteristics", TRUE, Summary->Characteristics);
+    PeAnalysisAppendJsonNumber(&Writer, "subsystem", FALSE, Summary->Subsystem);
+    PeAnalysisAppendJsonNumber(&Writer, "dll_characteristics", TRUE, Summary->DllCharacteristics);
+    PeAnalysisAppendJsonNumber(&Writer, "entry_point", TRUE, Summary->AddressOfEntryPoint);
+    PeAnalysisAppendJsonNumber(&Writer, "image_base", TRUE, Summary->ImageBase);
+    PeAnalysisAppendJsonNumber(&Writer, "size_of_image", TRUE, Summary->SizeOfImage);
+    PeAnalysisAppendJsonNumber(&Writer, "checksum", TRUE, Summary->HeaderChecksum);
+    PeAnalysisAppendJsonNumber(&Writer, "computed_checksum", TRUE, Summary->ComputedChecksum);
+    PeAnalysisAppend(&Writer, Summary->HeaderChecksum == Summary->ComputedChecksum ? ",\"checksum_matches\":true" : ",\"checksum_matches\":false");
+    PeAnalysisAppendJsonNumber(&Writer, "number_of_sections", FALSE, Summary->NumberOfSections);
+    PeAnalysisAppendJsonNumber(&Writer, "wx_sections", FALSE, Summary->WritableExecutableSections);
+    PeAnalysisAppendJsonNumber(&Writer, "overlay_size", FALSE, Summary->OverlaySize);
+    PeAnalysisAppend(&Writer, ",\"file_entropy\":");
+    PeAnalysisAppendEntropy(&Writer, Summary->FileEntropy);
+    PeAnalysisAppend(&Writer, ",\"sections\":[");
+
+    for (UINT32 i = 0; i < Summary->NumberOfAnalyzedSections; i++)
+    {
+        PeAnalysisAppend(&Writer, i == 0 ? "{\"name\":" : ",{\"name\":");
+        PeAnalysisAppendJsonString(&Writer, Sections[i].Name);
+        PeAnalysisAppendJsonNumber(&Writer, "rva", TRUE, Sections[i].VirtualAddress);
+        PeAnalysisAppendJsonNumber(&Writer, "virtual_size", TRUE, Sections[i].VirtualSize);
+        PeAnalysisAppendJsonNumber(&Writer, "raw_offset", TRUE, Sections[i].PointerToRawData);
+        PeAnalysisAppendJsonNumber(&Writer, "raw_size", TRUE, Sections[i].SizeOfRawData);
+        PeAnalysisAppendJsonNumber(&Writer, "analyzed_size", TRUE, Sections[i].AnalyzedSize);
+        PeAnalysisAppendJsonNumber(&Writer, "characteristics", TRUE, Sections[i].Characteristics);
+        PeAnalysisAppendJsonNumber(&Writer, "fnv1a64", TRUE, Sections[i].Fnv1a64);
+        PeAnalysisAppend(&Writer, ",\"entropy\":");
+        PeAnalysisAppendEntropy(&Writer, Sections[i].Entropy);
+        PeAnalysisAppend(&Writer, "}");
+    }
+
+    PeAnalysisAppend(&Writer, "]}");
+
+    return PeAnalysisFinishLine(&Writer);
+}
+
+/**
+ * @brief Format the header line of the CSV summaries
+ *
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+PeAnalysisFormatCsvHeader(CHAR * Buffer, UINT32 BufferSize)
+{
+    PE_ANALYSIS_WRITER Writer = {Buffer, BufferSize, 0, FALSE};
+
+    PeAnalysisAppend(&Writer,
+                     "path,status,file_size,machine,format,timestamp,characteristics,subsystem,"
+                     "dll_characteristics,entry_point,image_base,size_of_image,checksum,computed_checksum,"
+                     "checksum_matches,number_of_sections,wx_sections,overlay_size,file_entropy,"
+                     "highest_entropy_section,highest_entropy");
+
+    return PeAnalysisFinishLine(&Writer);
+}
+
+/**
+ * @brief Format the summary of an image as a CSV row
+ *
+ * @details The sections are summarized by the section with the highest entropy
+ * (the JSON lines have all of the sections)
+ *
+ * @param Path
+ * @param Summary
+ * @param Sections
+ * @param Buffer
+ * @param BufferSize
+ *
+ * @return UINT32 Length of the line (zero if it doesn't fit)
+ */
+UINT32
+PeAnalysisFormatCsv(const CHAR *                Path,
+                    const PE_ANALYSIS_IMAGE *   Summary,
+                    const PE_ANALYSIS_SECTION * Sections,
+                    CHAR *                      Buffer,
+                    UINT32                      BufferSize)
+{
+    PE_ANALYSIS_WRITER Writer = {Buffer, BufferSize, 0, FALSE};
+
+    PeAnalysisAppendCsvString(&Writer, Path);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppend(&Writer, PeAnalysisGetStatusName(Summary->Status));
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, FALSE, Summary->FileSize);
+
+    if (Summary->Status != PE_ANALYSIS_STATUS_SUCCESS)
+    {
+        PeAnalysisAppend(&Writer, ",,,,,,,,,,,,,,,,,,");
+        return PeAnalysisFinishLine(&Writer);
+    }
+
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->Machine);
+    PeAnalysisAppend(&Writer, Summary->IsPe32Plus ? ",pe32+," : ",pe32,");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->TimeDateStamp);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->Characteristics);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, FALSE, Summary->Subsystem);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->DllCharacteristics);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->AddressOfEntryPoint);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->ImageBase);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->SizeOfImage);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->HeaderChecksum);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, TRUE, Summary->ComputedChecksum);
+    PeAnalysisAppend(&Writer, Summary->HeaderChecksum == Summary->ComputedChecksum ? ",true," : ",false,");
+    PeAnalysisAppendNumber(&Writer, FALSE, Summary->NumberOfSections);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, FALSE, Summary->WritableExecutableSections);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendNumber(&Writer, FALSE, Summary->OverlaySize);
+    PeAnalysisAppend(&Writer, ",");
+    PeAnalysisAppendEntropy(&Writer, Summary->FileEntropy);
+    PeAnalysisAppend(&Writer, ",");
+
+    if (Summary->NumberOfAnalyzedSections != 0)
+    {
+        PeAnalysisAppendCsvString(&Writer, Sections[Summary->HighestEntropySection].Name);
+        PeAnalysisAppend(&Writer, ",");
+        PeAnalysisAppendEntropy(&Writer, Sections[Summary->HighestEntropySection].Entropy);
+    }
+    else
+    {
+        PeAnalysisAppend(&Writer, ",");
+    }
+
+    return PeAnalysisFinishLine(&Writer);
+}
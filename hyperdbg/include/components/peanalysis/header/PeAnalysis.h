@@ -0,0 +1,167 @@
+/**
+ * @file PeAnalysis.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the kernels and the summaries of analyzing the PE images in batches
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of the sections that are analyzed in an image
+ *
+ */
+#define PE_ANALYSIS_MAXIMUM_SECTIONS 96
+
+/**
+ * @brief Size of the buffer that always fits the summary of an image (without its path)
+ *
+ */
+#define PE_ANALYSIS_MAXIMUM_SUMMARY_SIZE (1024 + PE_ANALYSIS_MAXIMUM_SECTIONS * 320)
+
+/**
+ * @brief Offset basis and prime of the FNV-1a (64-bit) hashes of the sections
+ *
+ */
+#define PE_ANALYSIS_FNV1A64_OFFSET_BASIS 14695981039346656037ull
+#define PE_ANALYSIS_FNV1A64_PRIME        1099511628211ull
+
+/**
+ * @brief Characteristics of the sections that are checked by the analysis
+ *
+ */
+#define PE_ANALYSIS_SECTION_MEM_EXECUTE 0x20000000
+#define PE_ANALYSIS_SECTION_MEM_WRITE   0x80000000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Result of analyzing an image
+ *
+ */
+typedef enum _PE_ANALYSIS_STATUS
+{
+    PE_ANALYSIS_STATUS_SUCCESS = 0,
+    PE_ANALYSIS_STATUS_NOT_PE_IMAGE,
+    PE_ANALYSIS_STATUS_TRUNCATED_HEADERS,
+    PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER,
+    PE_ANALYSIS_STATUS_UNABLE_TO_OPEN, // set by the callers (the file is not mapped)
+
+} PE_ANALYSIS_STATUS;
+
+/**
+ * @brief Summary of a section of an image
+ *
+ * @details The analyzed size is the part of the raw data that is in the file,
+ * the hash and the entropy are computed over it
+ *
+ */
+typedef struct _PE_ANALYSIS_SECTION
+{
+    CHAR   Name[9];
+    UINT32 VirtualAddress;
+    UINT32 VirtualSize;
+    UINT32 PointerToRawData;
+    UINT32 SizeOfRawData;
+    UINT32 AnalyzedSize;
+    UINT32 Characteristics;
+    UINT64 Fnv1a64;
+    double Entropy;
+
+} PE_ANALYSIS_SECTION, *PPE_ANALYSIS_SECTION;
+
+/**
+ * @brief Summary of an image
+ *
+ */
+typedef struct _PE_ANALYSIS_IMAGE
+{
+    PE_ANALYSIS_STATUS Status;
+    UINT64             FileSize;
+    BOOLEAN            IsPe32Plus;
+    UINT16             Machine;
+    UINT16             Characteristics;
+    UINT16             Subsystem;
+    UINT16             DllCharacteristics;
+    UINT32             TimeDateStamp;
+    UINT32             AddressOfEntryPoint;
+    UINT64             ImageBase;
+    UINT32             SizeOfImage;
+    UINT32             HeaderChecksum;
+    UINT32             ComputedChecksum;
+    UINT32             NumberOfSections;         // as in the file header
+    UINT32             NumberOfAnalyzedSections; // at most PE_ANALYSIS_MAXIMUM_SECTIONS
+    UINT32             WritableExecutableSections;
+    UINT32             HighestEntropySection; // index of the analyzed section (if there is any)
+    UINT64             OverlaySize;           // bytes after the headers and the raw data of the sections
+    double             FileEntropy;
+
+} PE_ANALYSIS_IMAGE, *PPE_ANALYSIS_IMAGE;
+
+/**
+ * @brief A line that is being formatted into the buffer of the caller
+ *
+ */
+typedef struct _PE_ANALYSIS_WRITER
+{
+    CHAR *  Buffer;
+    UINT32  BufferSize;
+    UINT32  Length;
+    BOOLEAN IsOverflowed;
+
+} PE_ANALYSIS_WRITER, *PPE_ANALYSIS_WRITER;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT64
+PeAnalysisFnv1a64(const BYTE * Data, SIZE_T Size);
+
+VOID
+PeAnalysisCountBytes(const BYTE * Data, SIZE_T Size, UINT64 * Counts);
+
+UINT64
+PeAnalysisHashAndCountBytes(const BYTE * Data, SIZE_T Size, UINT64 * Counts);
+
+double
+PeAnalysisEntropy(const UINT64 * Counts, UINT64 Size);
+
+double
+PeAnalysisCalculateEntropy(const BYTE * Data, SIZE_T Size);
+
+BOOLEAN
+PeAnalysisChecksum(const BYTE * Image, SIZE_T ImageSize, SIZE_T ChecksumOffset, UINT32 * Checksum);
+
+PE_ANALYSIS_STATUS
+PeAnalysisAnalyzeImage(const BYTE * Image, SIZE_T ImageSize, PE_ANALYSIS_IMAGE * Summary, PE_ANALYSIS_SECTION * Sections);
+
+const CHAR *
+PeAnalysisGetStatusName(PE_ANALYSIS_STATUS Status);
+
+UINT32
+PeAnalysisFormatJson(const CHAR *                Path,
+                     const PE_ANALYSIS_IMAGE *   Summary,
+                     const PE_ANALYSIS_SECTION * Sections,
+                     CHAR *                      Buffer,
+                     UINT32                      BufferSize);
+
+UINT32
+PeAnalysisFormatCsvHeader(CHAR * Buffer, UINT32 BufferSize);
+
+UINT32
+PeAnalysisFormatCsv(const CHAR *                Path,
+                    const PE_ANALYSIS_IMAGE *   Summary,
+                    const PE_ANALYSIS_SECTION * Sections,
+                    CHAR *                      Buffer,
+                    UINT32                      BufferSize);
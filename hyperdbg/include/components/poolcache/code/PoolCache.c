@@ -0,0 +1,670 @@
+/**
+ * @file PoolCache.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Size-class free lists of the pre-allocated pools
+ * @details The free blocks of each intention are kept in lock-free stacks
+ * (one for each size class) and in small caches of each core, so taking a
+ * block doesn't need to walk all of the pools or to hold a lock. The cache
+ * doesn't allocate any memory, the blocks and their descriptors are given
+ * by the caller
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Mask of the address of the top block in the head of a stack
+ *
+ */
+#define POOL_CACHE_ADDRESS_MASK 0x0000ffffffffffffull
+
+/**
+ * @brief Shift of the counter of the changes in the head of a stack
+ *
+ */
+#define POOL_CACHE_COUNTER_SHIFT 48
+
+/**
+ * @brief Push a block to the free list of a class
+ *
+ * @param Class
+ * @param Entry
+ *
+ * @return VOID
+ */
+static VOID
+PoolCachePush(PPOOL_CACHE_CLASS Class, PPOOL_CACHE_ENTRY Entry)
+{
+    UINT64 Head;
+    UINT64 NewHead;
+
+    do
+    {
+        Head = AtomicLoadAcquire64(&Class->Head);
+
+        //
+        // The address is sign-extended from its 48th bit when it's popped
+        //
+        AtomicStoreReleasePointer((PVOID volatile *)&Entry->Next, (PPOOL_CACHE_ENTRY)(UINT64)((INT64)(Head << 16) >> 16));
+
+        NewHead = (((Head >> POOL_CACHE_COUNTER_SHIFT) + 1) << POOL_CACHE_COUNTER_SHIFT) |
+                  ((UINT64)Entry & POOL_CACHE_ADDRESS_MASK);
+
+    } while (AtomicCompareExchange64(&Class->Head, NewHead, Head) != Head);
+}
+
+/**
+ * @brief Pop a block from the free list of a class
+ *
+ * @param Class
+ *
+ * @return PPOOL_CACHE_ENTRY The block or NULL if the list is empty
+ */
+static PPOOL_CACHE_ENTRY
+PoolCachePop(PPOOL_CACHE_CLASS Class)
+{
+    UINT64            Head;
+    UINT64            NewHead;
+    PPOOL_CACHE_ENTRY Entry;
+
+    do
+    {
+        Head  = AtomicLoadAcquire64(&Class->Head);
+        Entry = (PPOOL_CACHE_ENTRY)(UINT64)((INT64)(Head << 16) >> 16);
+
+        if (Entry == NULL)
+        {
+            return NULL;
+        }
+
+        //
+        // The block might be popped by another core at the same time, then
+        // its link is not valid but the counter of the head is changed too
+        //
+        NewHead = (((Head >> POOL_CACHE_COUNTER_SHIFT) + 1) << POOL_CACHE_COUNTER_SHIFT) |
+                  ((UINT64)AtomicLoadAcquirePointer((PVOID volatile *)&Entry->Next) & POOL_CACHE_ADDRESS_MASK);
+
+    } while (AtomicCompareExchange64(&Class->Head, NewHead, Head) != Head);
+
+    return Entry;
+}
+
+/**
+ * @brief Get the size class of a block (the block is added by PoolCacheInsert)
+ *
+ * @param Cache
+ * @param Entry
+ *
+ * @return PPOOL_CACHE_CLASS
+ */
+static PPOOL_CACHE_CLASS
+PoolCacheGetClassOfEntry(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry)
+{
+    return &Cache->Classes[(SIZE_T)Entry->Intention * POOL_CACHE_SIZE_CLASSES + Entry->SizeClass];
+}
+
+/**
+ * @brief Get the slots of the cache of a core for an intention
+ *
+ * @param Cache
+ * @param CoreId
+ * @param Intention
+ *
+ * @return PPOOL_CACHE_ENTRY volatile *
+ */
+static PPOOL_CACHE_ENTRY volatile *
+PoolCacheGetCoreSlots(PPOOL_CACHE Cache, UINT32 CoreId, UINT32 Intention)
+{
+    return &Cache->CoreSlots[((SIZE_T)CoreId * Cache->NumberOfIntentions + Intention) * POOL_CACHE_CORE_SLOTS];
+}
+
+/**
+ * @brief Take a block with the needed size from the cache of a core
+ *
+ * @param Cache
+ * @param CoreId
+ * @param Intention
+ * @param Size
+ *
+ * @return PPOOL_CACHE_ENTRY The block or NULL if there is no block
+ */
+static PPOOL_CACHE_ENTRY
+PoolCacheTakeFromCore(PPOOL_CACHE Cache, UINT32 CoreId, UINT32 Intention, SIZE_T Size)
+{
+    PPOOL_CACHE_ENTRY volatile * Slots = PoolCacheGetCoreSlots(Cache, CoreId, Intention);
+    PPOOL_CACHE_ENTRY            Entry;
+
+    for (UINT32 i = 0; i < POOL_CACHE_CORE_SLOTS; i++)
+    {
+        Entry = (PPOOL_CACHE_ENTRY)AtomicLoadAcquirePointer((PVOID volatile *)&Slots[i]);
+
+        if (Entry != NULL && Entry->Size >= Size && AtomicCompareExchangePointer((PVOID volatile *)&Slots[i], NULL, Entry) == Entry)
+        {
+            return Entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Move a few blocks of a class to the empty slots of the cache of a core
+ *
+ * @param Cache
+ * @param CoreId
+ * @param Intention
+ * @param Class
+ *
+ * @return VOID
+ */
+static VOID
+PoolCacheFillCore(PPOOL_CACHE Cache, UINT32 CoreId, UINT32 Intention, PPOOL_CACHE_CLASS Class)
+{
+    PPOOL_CACHE_ENTRY volatile * Slots = PoolCacheGetCoreSlots(Cache, CoreId, Intention);
+    PPOOL_CACHE_ENTRY            Entry;
+    UINT32                       Moved = 0;
+
+    for (UINT32 i = 0; i < POOL_CACHE_CORE_SLOTS && Moved < POOL_CACHE_CORE_SLOTS / 2; i++)
+    {
+        if (AtomicLoadAcquirePointer((PVOID volatile *)&Slots[i]) != NULL)
+        {
+            continue;
+        }
+
+        Entry = PoolCachePop(Class);
+
+        if (Entry == NULL)
+        {
+            return;
+        }
+
+        if (AtomicCompareExchangePointer((PVOID volatile *)&Slots[i], Entry, NULL) != NULL)
+        {
+            //
+            // The slot is filled by the same core (e.g., from vmx-root)
+            //
+            PoolCachePush(Class, Entry);
+            return;
+        }
+
+        Moved++;
+    }
+}
+
+/**
+ * @brief Release one of the reserved blocks of a class (the reservation is used
+ * by a block that is not replaced, or its free block is removed)
+ *
+ * @param Class
+ *
+ * @return VOID
+ */
+static VOID
+PoolCacheReleaseReservation(PPOOL_CACHE_CLASS Class)
+{
+    LONG Target;
+
+    do
+    {
+        Target = Class->Target;
+
+        if (Target <= 0)
+        {
+            return;
+        }
+
+    } while (AtomicCompareExchange(&Class->Target, Target - 1, Target) != Target);
+}
+
+/**
+ * @brief Check whether the free blocks of a class reached the low watermark
+ *
+ * @param Class
+ * @param Available
+ *
+ * @return BOOLEAN TRUE if the refill should be signaled (only once until the class is refilled)
+ */
+static BOOLEAN
+PoolCacheCheckWatermark(PPOOL_CACHE_CLASS Class, LONG Available)
+{
+    LONG Target = Class->Target;
+
+    if (Target == 0 || Class->BlockSize == 0 ||
+        (INT64)Available * 100 > (INT64)Target * POOL_CACHE_LOW_WATERMARK ||
+        Available + Class->Pending >= Target)
+    {
+        return FALSE;
+    }
+
+    if (AtomicExchange(&Class->RefillSignaled, TRUE) != FALSE)
+    {
+        return FALSE;
+    }
+
+    AtomicAdd64(&Class->Statistics.Refills, 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Initialize a cache in a buffer
+ *
+ * @param Buffer A zeroed buffer with the size of POOL_CACHE_SIZE(NumberOfCores, NumberOfIntentions)
+ * @param NumberOfCores
+ * @param NumberOfIntentions
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PoolCacheInitialize(PVOID Buffer, UINT32 NumberOfCores, UINT32 NumberOfIntentions)
+{
+    PPOOL_CACHE Cache = (PPOOL_CACHE)Buffer;
+
+    if (Buffer == NULL || NumberOfCores == 0 || NumberOfIntentions == 0)
+    {
+        return FALSE;
+    }
+
+    Cache->NumberOfCores      = NumberOfCores;
+    Cache->NumberOfIntentions = NumberOfIntentions;
+    Cache->Classes            = (PPOOL_CACHE_CLASS)(Cache + 1);
+    Cache->CoreSlots          = (PPOOL_CACHE_ENTRY volatile *)(Cache->Classes + (SIZE_T)NumberOfIntentions * POOL_CACHE_SIZE_CLASSES);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the size class of a size
+ *
+ * @param Size
+ *
+ * @return UINT32
+ */
+UINT32
+PoolCacheGetSizeClass(SIZE_T Size)
+{
+    UINT32 SizeClass = 0;
+
+    while (SizeClass < POOL_CACHE_SIZE_CLASSES - 1 && Size > ((SIZE_T)1 << (POOL_CACHE_MINIMUM_CLASS_SHIFT + SizeClass)))
+    {
+        SizeClass++;
+    }
+
+    return SizeClass;
+}
+
+/**
+ * @brief Get a size class of an intention (e.g., to show its statistics)
+ *
+ * @param Cache
+ * @param Intention
+ * @param SizeClass
+ *
+ * @return PPOOL_CACHE_CLASS The class or NULL if the intention is not valid
+ */
+PPOOL_CACHE_CLASS
+PoolCacheGetClass(PPOOL_CACHE Cache, UINT32 Intention, UINT32 SizeClass)
+{
+    if (Intention >= Cache->NumberOfIntentions || SizeClass >= POOL_CACHE_SIZE_CLASSES)
+    {
+        return NULL;
+    }
+
+    return &Cache->Classes[(SIZE_T)Intention * POOL_CACHE_SIZE_CLASSES + SizeClass];
+}
+
+/**
+ * @brief Record the blocks that are requested to be allocated
+ *
+ * @param Cache
+ * @param Intention
+ * @param Size
+ * @param Count
+ * @param IsReplacement Whether the blocks replace the taken blocks (or they are reserved
+ * until they are taken without a replacement or removed)
+ *
+ * @return VOID
+ */
+VOID
+PoolCacheReserve(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 Count, BOOLEAN IsReplacement)
+{
+    PPOOL_CACHE_CLASS Class = PoolCacheGetClass(Cache, Intention, PoolCacheGetSizeClass(Size));
+
+    if (Class == NULL)
+    {
+        return;
+    }
+
+    if (Size > Class->BlockSize)
+    {
+        Class->BlockSize = Size;
+    }
+
+    AtomicAdd(&Class->Pending, (LONG)Count);
+
+    if (!IsReplacement)
+    {
+        AtomicAdd(&Class->Target, (LONG)Count);
+    }
+}
+
+/**
+ * @brief Add a free block to the cache
+ * @details Should be called where the block is allocated (or recycled)
+ *
+ * @param Cache
+ * @param Entry The descriptor of the block (should not be freed while the cache is used)
+ * @param Intention
+ * @param Size
+ * @param IsPending Whether the block is one of the requested (pending) blocks
+ *
+ * @return VOID
+ */
+VOID
+PoolCacheInsert(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry, UINT32 Intention, SIZE_T Size, BOOLEAN IsPending)
+{
+    PPOOL_CACHE_CLASS Class = PoolCacheGetClass(Cache, Intention, PoolCacheGetSizeClass(Size));
+
+    if (Class == NULL)
+    {
+        return;
+    }
+
+    Entry->Size      = Size;
+    Entry->Intention = Intention;
+    Entry->SizeClass = PoolCacheGetSizeClass(Size);
+
+    PoolCachePush(Class, Entry);
+    AtomicAdd(&Class->Available, 1);
+
+    if (IsPending && Class->Pending > 0)
+    {
+        AtomicAdd(&Class->Pending, -1);
+    }
+}
+
+/**
+ * @brief Take a free block of an intention
+ * @details Could be called from vmx-root on all of the cores at the same time
+ *
+ * @param Cache
+ * @param Intention
+ * @param Size The needed size (zero if any block of the intention could be used)
+ * @param CoreId The current core
+ * @param IsReplaced Whether a replacement of the block is requested (otherwise
+ * the block uses one of the reserved blocks of its class)
+ * @param RefillNeeded Set if the free blocks of the class reached the low watermark
+ *
+ * @return PPOOL_CACHE_ENTRY The block or NULL if there is no free block
+ */
+PPOOL_CACHE_ENTRY
+PoolCacheTake(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 CoreId, BOOLEAN IsReplaced, BOOLEAN * RefillNeeded)
+{
+    PPOOL_CACHE_ENTRY Entry      = NULL;
+    UINT32            FirstClass = PoolCacheGetSizeClass(Size);
+    PPOOL_CACHE_CLASS Class;
+
+    *RefillNeeded = FALSE;
+
+    if (Intention >= Cache->NumberOfIntentions)
+    {
+        return NULL;
+    }
+
+    CoreId %= Cache->NumberOfCores;
+
+    //
+    // The cache of the current core
+    //
+    Entry = PoolCacheTakeFromCore(Cache, CoreId, Intention, Size);
+
+    if (Entry != NULL)
+    {
+        AtomicAdd64(&PoolCacheGetClassOfEntry(Cache, Entry)->Statistics.CacheHits, 1);
+    }
+
+    //
+    // The free lists of the size class and the larger classes (a few more
+    // blocks are moved to the cache of the core for the next requests)
+    //
+    for (UINT32 i = FirstClass; Entry == NULL && i < POOL_CACHE_SIZE_CLASSES; i++)
+    {
+        Class = PoolCacheGetClass(Cache, Intention, i);
+        Entry = PoolCachePop(Class);
+
+        if (Entry != NULL)
+        {
+            PoolCacheFillCore(Cache, CoreId, Intention, Class);
+        }
+    }
+
+    //
+    // The caches of the other cores
+    //
+    for (UINT32 i = 1; Entry == NULL && i < Cache->NumberOfCores; i++)
+    {
+        Entry = PoolCacheTakeFromCore(Cache, (CoreId + i) % Cache->NumberOfCores, Intention, Size);
+
+        if (Entry != NULL)
+        {
+            AtomicAdd64(&PoolCacheGetClassOfEntry(Cache, Entry)->Statistics.Steals, 1);
+        }
+    }
+
+    //
+    // The smaller blocks, as the pools were previously only matched by their
+    // intentions (the callers always use the same size for an intention)
+    //
+    for (UINT32 i = 0; Entry == NULL && i < FirstClass; i++)
+    {
+        Entry = PoolCachePop(PoolCacheGetClass(Cache, Intention, i));
+    }
+
+    for (UINT32 i = 0; Entry == NULL && Size != 0 && i < Cache->NumberOfCores; i++)
+    {
+        Entry = PoolCacheTakeFromCore(Cache, (CoreId + i) % Cache->NumberOfCores, Intention, 0);
+    }
+
+    if (Entry == NULL)
+    {
+        Class = &Cache->Classes[(SIZE_T)Intention * POOL_CACHE_SIZE_CLASSES + FirstClass];
+
+        //
+        // If the size is not given, the failure is counted for the reserved class
+        //
+        for (UINT32 i = FirstClass; Size == 0 && i < POOL_CACHE_SIZE_CLASSES; i++)
+        {
+            if (Cache->Classes[(SIZE_T)Intention * POOL_CACHE_SIZE_CLASSES + i].Target != 0)
+            {
+                Class = &Cache->Classes[(SIZE_T)Intention * POOL_CACHE_SIZE_CLASSES + i];
+                break;
+            }
+        }
+
+        AtomicAdd64(&Class->Statistics.Failures, 1);
+        *RefillNeeded = PoolCacheCheckWatermark(Class, Class->Available);
+
+        return NULL;
+    }
+
+    Class = PoolCacheGetClassOfEntry(Cache, Entry);
+
+    //
+    // The class is only refilled up to its remaining reservations, so the
+    // refills don't keep the blocks that are already used
+    //
+    if (!IsReplaced)
+    {
+        PoolCacheReleaseReservation(Class);
+    }
+
+    AtomicAdd64(&Class->Statistics.Requests, 1);
+    *RefillNeeded = PoolCacheCheckWatermark(Class, AtomicAdd(&Class->Available, -1));
+
+    return Entry;
+}
+
+/**
+ * @brief Remove a free block from the cache (e.g., to free it)
+ * @details Should be called where the freed blocks are deallocated. The other
+ * blocks of the class are popped until the block is found and then pushed
+ * back, so they might not be taken by the other cores for a moment. The block
+ * might be moved between the free list and the caches of the cores, so they
+ * are checked a few times
+ *
+ * @param Cache
+ * @param Entry
+ *
+ * @return BOOLEAN FALSE if the block is not in the cache (e.g., it's taken)
+ */
+BOOLEAN
+PoolCacheRemove(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry)
+{
+    PPOOL_CACHE_CLASS            Class = PoolCacheGetClass(Cache, Entry->Intention, Entry->SizeClass);
+    PPOOL_CACHE_ENTRY volatile * Slots;
+    PPOOL_CACHE_ENTRY            Popped;
+    PPOOL_CACHE_ENTRY            Current;
+    BOOLEAN                      Found = FALSE;
+
+    if (Class == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 Round = 0; Round < POOL_CACHE_REMOVE_ROUNDS && !Found; Round++)
+    {
+        //
+        // The caches of the cores
+        //
+        for (UINT32 i = 0; i < Cache->NumberOfCores && !Found; i++)
+        {
+            Slots = PoolCacheGetCoreSlots(Cache, i, Entry->Intention);
+
+            for (UINT32 j = 0; j < POOL_CACHE_CORE_SLOTS && !Found; j++)
+            {
+                Found = AtomicLoadAcquirePointer((PVOID volatile *)&Slots[j]) == Entry &&
+                        AtomicCompareExchangePointer((PVOID volatile *)&Slots[j], NULL, Entry) == Entry;
+            }
+        }
+
+        //
+        // The free list of the class
+        //
+        Popped = NULL;
+
+        while (!Found && (Current = PoolCachePop(Class)) != NULL)
+        {
+            if (Current == Entry)
+            {
+                Found = TRUE;
+                break;
+            }
+
+            AtomicStoreReleasePointer((PVOID volatile *)&Current->Next, Popped);
+            Popped = Current;
+        }
+
+        while (Popped != NULL)
+        {
+            Current = Popped;
+            Popped  = (PPOOL_CACHE_ENTRY)AtomicLoadAcquirePointer((PVOID volatile *)&Current->Next);
+
+            PoolCachePush(Class, Current);
+        }
+    }
+
+    if (!Found)
+    {
+        return FALSE;
+    }
+
+    AtomicAdd(&Class->Available, -1);
+    PoolCacheReleaseReservation(Class);
+
+    return TRUE;
+}
+
+/**
+ * @brief Use a freed block instead of one of the pending blocks of its class
+ * @details Should be called where the freed blocks are deallocated, if it returns
+ * TRUE, the block should be cleared and added again by PoolCacheInsert as a
+ * pending block
+ *
+ * @param Cache
+ * @param Entry
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PoolCacheClaimPending(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry)
+{
+    PPOOL_CACHE_CLASS Class = PoolCacheGetClass(Cache, Entry->Intention, Entry->SizeClass);
+
+    if (Class == NULL || Entry->Size < Class->BlockSize || Class->Pending - Class->Cancelled <= 0)
+    {
+        return FALSE;
+    }
+
+    AtomicAdd(&Class->Cancelled, 1);
+    AtomicAdd64(&Class->Statistics.Recycled, 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Get the number of the requested blocks that are replaced by the recycled blocks
+ *
+ * @param Cache
+ * @param Intention
+ * @param Size
+ * @param Count Count of the requested blocks
+ *
+ * @return UINT32 Count of the requested blocks that should not be allocated
+ */
+UINT32
+PoolCacheConsumeCancelled(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 Count)
+{
+    PPOOL_CACHE_CLASS Class = PoolCacheGetClass(Cache, Intention, PoolCacheGetSizeClass(Size));
+    UINT32            Cancelled;
+
+    if (Class == NULL || Class->Cancelled <= 0)
+    {
+        return 0;
+    }
+
+    Cancelled = (UINT32)Class->Cancelled < Count ? (UINT32)Class->Cancelled : Count;
+
+    AtomicAdd(&Class->Cancelled, -(LONG)Cancelled);
+
+    return Cancelled;
+}
+
+/**
+ * @brief Get the number of the blocks that should be allocated for a signaled class
+ *
+ * @param Cache
+ * @param Intention
+ * @param SizeClass
+ * @param BlockSize The size of the blocks of the class
+ *
+ * @return UINT32 Count of the blocks (zero if the class is not signaled)
+ */
+UINT32
+PoolCacheGetRefillCount(PPOOL_CACHE Cache, UINT32 Intention, UINT32 SizeClass, SIZE_T * BlockSize)
+{
+    PPOOL_CACHE_CLASS Class = PoolCacheGetClass(Cache, Intention, SizeClass);
+    LONG              Deficit;
+
+    if (Class == NULL || AtomicExchange(&Class->RefillSignaled, FALSE) == FALSE)
+    {
+        return 0;
+    }
+
+    Deficit    = Class->Target - Class->Available - Class->Pending;
+    *BlockSize = Class->BlockSize;
+
+    return Deficit > 0 ? (UINT32)Deficit : 0;
+}
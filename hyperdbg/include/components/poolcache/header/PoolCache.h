@@ -0,0 +1,169 @@
+/**
+ * @file PoolCache.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the size-class free lists of the pre-allocated pools
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of the size classes of each intention
+ *
+ */
+#define POOL_CACHE_SIZE_CLASSES 16
+
+/**
+ * @brief Shift of the size of the smallest class (64 bytes)
+ *
+ */
+#define POOL_CACHE_MINIMUM_CLASS_SHIFT 6
+
+/**
+ * @brief Number of the cached blocks of each intention on each core
+ *
+ */
+#define POOL_CACHE_CORE_SLOTS 4
+
+/**
+ * @brief A refill is signaled once the free blocks of a class are below
+ * this percent of the reserved blocks
+ *
+ */
+#define POOL_CACHE_LOW_WATERMARK 25
+
+/**
+ * @brief Number of the times that a removed block is searched in the cache
+ *
+ */
+#define POOL_CACHE_REMOVE_ROUNDS 3
+
+/**
+ * @brief Size of a cache (including its classes and the caches of the cores)
+ *
+ */
+#define POOL_CACHE_SIZE(NumberOfCores, NumberOfIntentions)                                       \
+    (sizeof(POOL_CACHE) +                                                                        \
+     (SIZE_T)(NumberOfIntentions) * POOL_CACHE_SIZE_CLASSES * sizeof(POOL_CACHE_CLASS) +         \
+     (SIZE_T)(NumberOfCores) * (NumberOfIntentions) * POOL_CACHE_CORE_SLOTS * sizeof(PVOID))
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An entry of the cache (embedded in the descriptor of each block)
+ *
+ */
+typedef struct _POOL_CACHE_ENTRY
+{
+    struct _POOL_CACHE_ENTRY * volatile Next;
+
+    SIZE_T Size;
+    UINT32 Intention;
+    UINT32 SizeClass;
+
+} POOL_CACHE_ENTRY, *PPOOL_CACHE_ENTRY;
+
+/**
+ * @brief Statistics of a size class
+ *
+ */
+typedef struct _POOL_CACHE_STATISTICS
+{
+    volatile UINT64 Requests;  // blocks that are taken
+    volatile UINT64 CacheHits; // blocks that are taken from the cache of the core
+    volatile UINT64 Steals;    // blocks that are taken from the cache of another core
+    volatile UINT64 Failures;  // requests without any free block
+    volatile UINT64 Recycled;  // freed blocks that are used instead of the pending allocations
+    volatile UINT64 Refills;   // signals of reaching the low watermark
+
+} POOL_CACHE_STATISTICS, *PPOOL_CACHE_STATISTICS;
+
+/**
+ * @brief Free blocks of a size class of an intention
+ *
+ * @details The free blocks are kept in a lock-free stack, the head contains
+ * the address of the top block (48 bits) and a counter of the changes of the
+ * head (16 bits), so a block that is popped and pushed again while another
+ * core is popping the stack doesn't corrupt the stack. The descriptors of the
+ * blocks should never be freed while the cache is used
+ *
+ */
+typedef struct _POOL_CACHE_CLASS
+{
+    volatile UINT64 Head;
+
+    volatile LONG Available;     // free blocks (including the blocks in the caches of the cores)
+    volatile LONG Pending;       // blocks that are requested but not allocated yet
+    volatile LONG Target;        // blocks that are reserved (and not taken without a replacement)
+    volatile LONG Cancelled;     // pending blocks that are replaced by the recycled blocks
+    volatile LONG RefillSignaled;
+
+    SIZE_T BlockSize; // the largest size that is requested for the class
+
+    POOL_CACHE_STATISTICS Statistics;
+
+} POOL_CACHE_CLASS, *PPOOL_CACHE_CLASS;
+
+/**
+ * @brief Free lists of all of the intentions and size classes
+ *
+ * @details A block is taken from the cache of the current core, then from the
+ * free list of its size class (or the larger classes), then from the caches of
+ * the other cores. None of them needs a lock, so the blocks could be taken
+ * from vmx-root on all of the cores at the same time. The blocks are added to
+ * the cache where it's safe to allocate them (vmx non-root)
+ *
+ */
+typedef struct _POOL_CACHE
+{
+    UINT32 NumberOfCores;
+    UINT32 NumberOfIntentions;
+
+    PPOOL_CACHE_CLASS            Classes;   // [Intention][SizeClass]
+    PPOOL_CACHE_ENTRY volatile * CoreSlots; // [Core][Intention][Slot]
+
+} POOL_CACHE, *PPOOL_CACHE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+PoolCacheInitialize(PVOID Buffer, UINT32 NumberOfCores, UINT32 NumberOfIntentions);
+
+UINT32
+PoolCacheGetSizeClass(SIZE_T Size);
+
+PPOOL_CACHE_CLASS
+PoolCacheGetClass(PPOOL_CACHE Cache, UINT32 Intention, UINT32 SizeClass);
+
+VOID
+PoolCacheReserve(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 Count, BOOLEAN IsReplacement);
+
+VOID
+PoolCacheInsert(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry, UINT32 Intention, SIZE_T Size, BOOLEAN IsPending);
+
+PPOOL_CACHE_ENTRY
+PoolCacheTake(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 CoreId, BOOLEAN IsReplaced, BOOLEAN * RefillNeeded);
+
+BOOLEAN
+PoolCacheRemove(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry);
+
+BOOLEAN
+PoolCacheClaimPending(PPOOL_CACHE Cache, PPOOL_CACHE_ENTRY Entry);
+
+UINT32
+PoolCacheConsumeCancelled(PPOOL_CACHE Cache, UINT32 Intention, SIZE_T Size, UINT32 Count);
+
+UINT32
+PoolCacheGetRefillCount(PPOOL_CACHE Cache, UINT32 Intention, UINT32 SizeClass, SIZE_T * BlockSize);
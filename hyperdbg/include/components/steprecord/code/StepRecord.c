@@ -0,0 +1,664 @@
+/**
+ * @file StepRecord.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Compact records of the batched (debuggee-side) steps
+ * @details The debuggee steps the instructions by itself and encodes a record
+ * for each of them (rip, length, classification, and the deltas of the changed
+ * registers) into chunks, then the debugger decodes the chunks and renders them
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Write an unsigned LEB128 varint
+ *
+ * @param Buffer
+ * @param Value
+ *
+ * @return UINT32 Number of the written bytes
+ */
+static UINT32
+StepRecordWriteVarint(UINT8 * Buffer, UINT64 Value)
+{
+    UINT32 Size = 0;
+
+    while (Value >= 0x80)
+    {
+        Buffer[Size++] = (UINT8)(Value | 0x80);
+        Value >>= 7;
+    }
+
+    Buffer[Size++] = (UINT8)Value;
+
+    return Size;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ *
+ * @param Cursor
+ * @param End
+ * @param Value
+ *
+ * @return BOOLEAN FALSE if the varint is truncated or too long
+ */
+static BOOLEAN
+StepRecordReadVarint(const UINT8 ** Cursor, const UINT8 * End, UINT64 * Value)
+{
+    const UINT8 * Current = *Cursor;
+    UINT64        Result  = 0;
+    UINT32        Shift   = 0;
+
+    while (Current < End && Shift < 64)
+    {
+        UINT8 Byte = *Current++;
+
+        Result |= (UINT64)(Byte & 0x7f) << Shift;
+
+        if ((Byte & 0x80) == 0)
+        {
+            *Cursor = Current;
+            *Value  = Result;
+            return TRUE;
+        }
+
+        Shift += 7;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Zigzag encoding of a signed delta (small negative deltas stay small)
+ *
+ * @param Delta
+ *
+ * @return UINT64
+ */
+static UINT64
+StepRecordZigzagEncode(UINT64 Delta)
+{
+    return (Delta << 1) ^ (UINT64)((INT64)Delta >> 63);
+}
+
+/**
+ * @brief Zigzag decoding of a signed delta
+ *
+ * @param Value
+ *
+ * @return UINT64
+ */
+static UINT64
+StepRecordZigzagDecode(UINT64 Value)
+{
+    return (Value >> 1) ^ (0 - (Value & 1));
+}
+
+/**
+ * @brief Check whether a register is tracked by the flags of the chunk
+ *
+ * @param Flags
+ * @param Index
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+StepRecordIsRegisterTracked(UINT32 Flags, UINT32 Index)
+{
+    return (Flags & STEP_RECORD_CHUNK_FLAG_REGISTERS) || Index == STEP_RECORD_REGISTER_RFLAGS;
+}
+
+/**
+ * @brief Classify an instruction (call, ret, branch, or normal) based on its opcode
+ *
+ * @param InstructionBytes
+ * @param Length
+ * @param Is32Bit
+ *
+ * @return STEP_RECORD_KIND
+ */
+STEP_RECORD_KIND
+StepRecordClassify(const UINT8 * InstructionBytes, UINT32 Length, BOOLEAN Is32Bit)
+{
+    UINT32 Index = 0;
+    UINT8  Opcode;
+    UINT8  Next;
+
+    if (Length > STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH)
+    {
+        Length = STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH;
+    }
+
+    //
+    // Skip the legacy prefixes
+    //
+    while (Index < Length)
+    {
+        Opcode = InstructionBytes[Index];
+
+        if (Opcode == 0xf0 || Opcode == 0xf2 || Opcode == 0xf3 || Opcode == 0x2e || Opcode == 0x36 ||
+            Opcode == 0x3e || Opcode == 0x26 || Opcode == 0x64 || Opcode == 0x65 || Opcode == 0x66 || Opcode == 0x67)
+        {
+            Index++;
+            continue;
+        }
+
+        break;
+    }
+
+    //
+    // Skip the REX prefix (only on the 64-bit mode, otherwise it's inc/dec)
+    //
+    if (!Is32Bit && Index < Length && (InstructionBytes[Index] & 0xf0) == 0x40)
+    {
+        Index++;
+    }
+
+    if (Index >= Length)
+    {
+        return STEP_RECORD_KIND_NORMAL;
+    }
+
+    Opcode = InstructionBytes[Index];
+    Next   = Index + 1 < Length ? InstructionBytes[Index + 1] : 0;
+
+    //
+    // jcc (short), loop/loope/loopne/jcxz
+    //
+    if ((Opcode >= 0x70 && Opcode <= 0x7f) || (Opcode >= 0xe0 && Opcode <= 0xe3))
+    {
+        return STEP_RECORD_KIND_BRANCH;
+    }
+
+    switch (Opcode)
+    {
+    case 0xe8:
+        return STEP_RECORD_KIND_CALL;
+
+    case 0x9a:
+        return Is32Bit ? STEP_RECORD_KIND_CALL : STEP_RECORD_KIND_NORMAL;
+
+    case 0xc2:
+    case 0xc3:
+    case 0xca:
+    case 0xcb:
+        return STEP_RECORD_KIND_RET;
+
+    case 0xe9:
+    case 0xeb:
+    case 0xcc:
+    case 0xcd:
+    case 0xcf:
+    case 0xf1:
+        return STEP_RECORD_KIND_BRANCH;
+
+    case 0xce:
+    case 0xea:
+        return Is32Bit ? STEP_RECORD_KIND_BRANCH : STEP_RECORD_KIND_NORMAL;
+
+    case 0xff:
+
+        if (Index + 1 >= Length)
+        {
+            return STEP_RECORD_KIND_NORMAL;
+        }
+
+        //
+        // The reg field of the ModR/M selects the operation
+        //
+        switch ((Next >> 3) & 7)
+        {
+        case 2:
+        case 3:
+            return STEP_RECORD_KIND_CALL;
+        case 4:
+        case 5:
+            return STEP_RECORD_KIND_BRANCH;
+        default:
+            return STEP_RECORD_KIND_NORMAL;
+        }
+
+    case 0x0f:
+
+        if (Index + 1 >= Length)
+        {
+            return STEP_RECORD_KIND_NORMAL;
+        }
+
+        //
+        // jcc (near), syscall, sysret, sysenter, sysexit
+        //
+        if ((Next >= 0x80 && Next <= 0x8f) || Next == 0x05 || Next == 0x07 || Next == 0x34 || Next == 0x35)
+        {
+            return STEP_RECORD_KIND_BRANCH;
+        }
+
+        return STEP_RECORD_KIND_NORMAL;
+
+    default:
+        return STEP_RECORD_KIND_NORMAL;
+    }
+}
+
+/**
+ * @brief Write the header of the current chunk with the state before its first record
+ *
+ * @param Encoder
+ *
+ * @return VOID
+ */
+static VOID
+StepRecordEncoderStartChunk(PSTEP_RECORD_ENCODER Encoder)
+{
+    STEP_RECORD_CHUNK_HEADER Header;
+
+    memset(&Header, 0, sizeof(Header));
+
+    Header.Flags    = Encoder->Flags & (STEP_RECORD_CHUNK_FLAG_REGISTERS | STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES);
+    Header.Sequence = Encoder->Sequence;
+
+    if (Encoder->Is32Bit)
+    {
+        Header.Flags |= STEP_RECORD_CHUNK_FLAG_32BIT_MODE;
+    }
+
+    memcpy(Header.Registers, Encoder->Registers, sizeof(Header.Registers));
+    memcpy(Encoder->Buffer, &Header, sizeof(Header));
+
+    Encoder->Offset          = sizeof(STEP_RECORD_CHUNK_HEADER);
+    Encoder->NumberOfRecords = 0;
+}
+
+/**
+ * @brief Initialize an encoder
+ *
+ * @param Encoder
+ * @param Buffer The buffer of the chunks (at least a header and a record)
+ * @param BufferSize
+ * @param Flags STEP_RECORD_CHUNK_FLAG_REGISTERS and STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES
+ * @param Is32Bit Operating mode of the first instruction
+ * @param Registers State of the registers before the first instruction
+ *
+ * @return VOID
+ */
+VOID
+StepRecordEncoderInitialize(PSTEP_RECORD_ENCODER Encoder,
+                            VOID *               Buffer,
+                            UINT32               BufferSize,
+                            UINT32               Flags,
+                            BOOLEAN              Is32Bit,
+                            const UINT64 *       Registers)
+{
+    memset(Encoder, 0, sizeof(STEP_RECORD_ENCODER));
+
+    Encoder->Buffer     = (UINT8 *)Buffer;
+    Encoder->BufferSize = BufferSize;
+    Encoder->Flags      = Flags;
+    Encoder->Is32Bit    = Is32Bit;
+
+    memcpy(Encoder->Registers, Registers, sizeof(Encoder->Registers));
+
+    StepRecordEncoderStartChunk(Encoder);
+}
+
+/**
+ * @brief Encode the record of an executed instruction
+ *
+ * @param Encoder
+ * @param Rip Address of the instruction
+ * @param InstructionBytes Bytes of the instruction (only stored if requested by the flags)
+ * @param Length Length of the instruction (zero if it's unknown)
+ * @param Kind
+ * @param Is32Bit Operating mode of the instruction
+ * @param Registers State of the registers after executing the instruction
+ *
+ * @return BOOLEAN FALSE if the chunk is full (the chunk should be finished and sent)
+ */
+BOOLEAN
+StepRecordEncode(PSTEP_RECORD_ENCODER Encoder,
+                 UINT64               Rip,
+                 const UINT8 *        InstructionBytes,
+                 UINT32               Length,
+                 STEP_RECORD_KIND     Kind,
+                 BOOLEAN              Is32Bit,
+                 const UINT64 *       Registers)
+{
+    UINT8 * Cursor;
+    UINT32  ChangedRegisters = 0;
+    UINT8   Extension        = 0;
+    UINT8   FirstByte;
+
+    if (Encoder->BufferSize - Encoder->Offset < STEP_RECORD_MAXIMUM_RECORD_SIZE)
+    {
+        return FALSE;
+    }
+
+    if (Length > STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH)
+    {
+        Length = 0;
+    }
+
+    //
+    // The first record of each chunk is the start rip of the chunk
+    //
+    if (Encoder->NumberOfRecords == 0)
+    {
+        Encoder->StartRip    = Rip;
+        Encoder->ExpectedRip = Rip;
+    }
+
+    for (UINT32 i = 0; i < STEP_RECORD_NUMBER_OF_REGISTERS; i++)
+    {
+        if (StepRecordIsRegisterTracked(Encoder->Flags, i) && Registers[i] != Encoder->Registers[i])
+        {
+            ChangedRegisters |= 1 << i;
+        }
+    }
+
+    if (ChangedRegisters != 0)
+    {
+        Extension |= STEP_RECORD_EXTENSION_REGISTERS;
+    }
+
+    if (Is32Bit != Encoder->Is32Bit)
+    {
+        Extension |= STEP_RECORD_EXTENSION_MODE_SWITCH;
+    }
+
+    FirstByte = (UINT8)(Length | ((UINT32)Kind << STEP_RECORD_BYTE_KIND_SHIFT));
+
+    if (Rip != Encoder->ExpectedRip)
+    {
+        FirstByte |= STEP_RECORD_BYTE_EXPLICIT_RIP;
+    }
+
+    if (Extension != 0)
+    {
+        FirstByte |= STEP_RECORD_BYTE_EXTENDED;
+    }
+
+    Cursor    = Encoder->Buffer + Encoder->Offset;
+    *Cursor++ = FirstByte;
+
+    if (Extension != 0)
+    {
+        *Cursor++ = Extension;
+    }
+
+    if (FirstByte & STEP_RECORD_BYTE_EXPLICIT_RIP)
+    {
+        Cursor += StepRecordWriteVarint(Cursor, StepRecordZigzagEncode(Rip - Encoder->ExpectedRip));
+    }
+
+    if (Encoder->Flags & STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES)
+    {
+        memcpy(Cursor, InstructionBytes, Length);
+        Cursor += Length;
+    }
+
+    if (ChangedRegisters != 0)
+    {
+        Cursor += StepRecordWriteVarint(Cursor, ChangedRegisters);
+
+        for (UINT32 i = 0; i < STEP_RECORD_NUMBER_OF_REGISTERS; i++)
+        {
+            if (ChangedRegisters & (1 << i))
+            {
+                Cursor += StepRecordWriteVarint(Cursor, StepRecordZigzagEncode(Registers[i] - Encoder->Registers[i]));
+                Encoder->Registers[i] = Registers[i];
+            }
+        }
+    }
+
+    Encoder->Offset      = (UINT32)(Cursor - Encoder->Buffer);
+    Encoder->ExpectedRip = Rip + Length;
+    Encoder->Is32Bit     = Is32Bit;
+    Encoder->NumberOfRecords++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Finish the current chunk
+ *
+ * @param Encoder
+ * @param NextRip Rip after the last record (target of the last record if it's a call)
+ * @param IsLastChunk Whether it's the last chunk of the batch
+ *
+ * @return UINT32 Size of the chunk
+ */
+UINT32
+StepRecordEncoderFinish(PSTEP_RECORD_ENCODER Encoder, UINT64 NextRip, BOOLEAN IsLastChunk)
+{
+    STEP_RECORD_CHUNK_HEADER Header;
+
+    memcpy(&Header, Encoder->Buffer, sizeof(Header));
+
+    if (IsLastChunk)
+    {
+        Header.Flags |= STEP_RECORD_CHUNK_FLAG_LAST_CHUNK;
+    }
+
+    Header.NumberOfRecords = Encoder->NumberOfRecords;
+    Header.RecordsSize     = Encoder->Offset - sizeof(STEP_RECORD_CHUNK_HEADER);
+    Header.NextRip         = NextRip;
+    Header.StartRip        = Encoder->NumberOfRecords == 0 ? NextRip : Encoder->StartRip;
+
+    memcpy(Encoder->Buffer, &Header, sizeof(Header));
+
+    return Encoder->Offset;
+}
+
+/**
+ * @brief Reuse the buffer of a finished (and sent) chunk for the next chunk
+ *
+ * @param Encoder
+ *
+ * @return VOID
+ */
+VOID
+StepRecordEncoderNextChunk(PSTEP_RECORD_ENCODER Encoder)
+{
+    Encoder->Sequence++;
+
+    StepRecordEncoderStartChunk(Encoder);
+}
+
+/**
+ * @brief Decode a single record
+ *
+ * @param Cursor
+ * @param End
+ * @param Flags Flags of the chunk
+ * @param ExpectedRip Rip after the previous record
+ * @param Previous State after the previous record (registers and mode)
+ * @param Record
+ *
+ * @return BOOLEAN FALSE if the record is malformed
+ */
+static BOOLEAN
+StepRecordDecodeOne(const UINT8 **      Cursor,
+                    const UINT8 *       End,
+                    UINT32              Flags,
+                    UINT64              ExpectedRip,
+                    const STEP_RECORD * Previous,
+                    PSTEP_RECORD        Record)
+{
+    const UINT8 * Current   = *Cursor;
+    UINT8         FirstByte = 0;
+    UINT8         Extension = 0;
+    UINT64        Value;
+
+    if (Current >= End)
+    {
+        return FALSE;
+    }
+
+    FirstByte = *Current++;
+
+    if (FirstByte & STEP_RECORD_BYTE_EXTENDED)
+    {
+        if (Current >= End)
+        {
+            return FALSE;
+        }
+
+        Extension = *Current++;
+
+        if (Extension & ~(STEP_RECORD_EXTENSION_REGISTERS | STEP_RECORD_EXTENSION_MODE_SWITCH))
+        {
+            return FALSE;
+        }
+    }
+
+    memset(Record, 0, sizeof(STEP_RECORD));
+    memcpy(Record->Registers, Previous->Registers, sizeof(Record->Registers));
+
+    Record->Length  = FirstByte & STEP_RECORD_BYTE_LENGTH_MASK;
+    Record->Kind    = (STEP_RECORD_KIND)((FirstByte & STEP_RECORD_BYTE_KIND_MASK) >> STEP_RECORD_BYTE_KIND_SHIFT);
+    Record->Is32Bit = (Extension & STEP_RECORD_EXTENSION_MODE_SWITCH) ? !Previous->Is32Bit : Previous->Is32Bit;
+    Record->Rip     = ExpectedRip;
+
+    if (FirstByte & STEP_RECORD_BYTE_EXPLICIT_RIP)
+    {
+        if (!StepRecordReadVarint(&Current, End, &Value))
+        {
+            return FALSE;
+        }
+
+        Record->Rip = ExpectedRip + StepRecordZigzagDecode(Value);
+    }
+
+    if (Flags & STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES)
+    {
+        if ((UINT64)(End - Current) < Record->Length)
+        {
+            return FALSE;
+        }
+
+        memcpy(Record->InstructionBytes, Current, Record->Length);
+        Current += Record->Length;
+    }
+
+    if (Extension & STEP_RECORD_EXTENSION_REGISTERS)
+    {
+        if (!StepRecordReadVarint(&Current, End, &Value) || Value == 0 || Value >= (1ull << STEP_RECORD_NUMBER_OF_REGISTERS))
+        {
+            return FALSE;
+        }
+
+        Record->ChangedRegisters = (UINT32)Value;
+
+        for (UINT32 i = 0; i < STEP_RECORD_NUMBER_OF_REGISTERS; i++)
+        {
+            if (!(Record->ChangedRegisters & (1 << i)))
+            {
+                continue;
+            }
+
+            if (!StepRecordIsRegisterTracked(Flags, i) || !StepRecordReadVarint(&Current, End, &Value))
+            {
+                return FALSE;
+            }
+
+            Record->Registers[i] += StepRecordZigzagDecode(Value);
+        }
+    }
+
+    *Cursor = Current;
+
+    return TRUE;
+}
+
+/**
+ * @brief Decode the records of a chunk
+ *
+ * @details Each record is passed to the callback after its next record is
+ * decoded, so the rip after the instruction (the target of calls) is known
+ *
+ * @param Chunk
+ * @param ChunkSize
+ * @param Callback
+ * @param Context
+ *
+ * @return BOOLEAN FALSE if the chunk is malformed or the callback stopped decoding
+ */
+BOOLEAN
+StepRecordDecodeChunk(const VOID * Chunk, UINT32 ChunkSize, STEP_RECORD_CALLBACK Callback, PVOID Context)
+{
+    STEP_RECORD_CHUNK_HEADER Header;
+    STEP_RECORD              Records[2];
+    STEP_RECORD *            Previous;
+    STEP_RECORD *            Current;
+    const UINT8 *            Cursor;
+    const UINT8 *            End;
+
+    if (ChunkSize < sizeof(STEP_RECORD_CHUNK_HEADER))
+    {
+        return FALSE;
+    }
+
+    memcpy(&Header, Chunk, sizeof(Header));
+
+    if (Header.RecordsSize > ChunkSize - sizeof(STEP_RECORD_CHUNK_HEADER))
+    {
+        return FALSE;
+    }
+
+    Cursor = (const UINT8 *)Chunk + sizeof(STEP_RECORD_CHUNK_HEADER);
+    End    = Cursor + Header.RecordsSize;
+
+    //
+    // The state before the first record
+    //
+    memset(&Records[1], 0, sizeof(STEP_RECORD));
+    memcpy(Records[1].Registers, Header.Registers, sizeof(Header.Registers));
+
+    Records[1].Is32Bit = (Header.Flags & STEP_RECORD_CHUNK_FLAG_32BIT_MODE) ? TRUE : FALSE;
+    Records[1].NextRip = Header.StartRip;
+
+    for (UINT32 i = 0; i < Header.NumberOfRecords; i++)
+    {
+        Previous = &Records[(i + 1) & 1];
+        Current  = &Records[i & 1];
+
+        if (!StepRecordDecodeOne(&Cursor, End, Header.Flags, Previous->NextRip, Previous, Current))
+        {
+            return FALSE;
+        }
+
+        //
+        // The next rip is the expected rip of the next record until it's decoded
+        //
+        Current->NextRip = Current->Rip + Current->Length;
+
+        if (i != 0)
+        {
+            Previous->NextRip = Current->Rip;
+
+            if (!Callback(Context, Previous))
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    if (Cursor != End)
+    {
+        return FALSE;
+    }
+
+    if (Header.NumberOfRecords != 0)
+    {
+        Current          = &Records[(Header.NumberOfRecords - 1) & 1];
+        Current->NextRip = Header.NextRip;
+
+        return Callback(Context, Current);
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file StepRecord.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the compact records of the batched (debuggee-side) steps
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of the registers that are tracked in the records (the general
+ * purpose registers with the same order as GUEST_REGS, and RFLAGS)
+ *
+ */
+#define STEP_RECORD_NUMBER_OF_REGISTERS 17
+
+/**
+ * @brief Index of RFLAGS in the tracked registers
+ *
+ */
+#define STEP_RECORD_REGISTER_RFLAGS 16
+
+/**
+ * @brief Maximum length of an x86 instruction
+ *
+ */
+#define STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH 15
+
+/**
+ * @brief Upper bound of the size of a single encoded record
+ *
+ */
+#define STEP_RECORD_MAXIMUM_RECORD_SIZE 224
+
+/**
+ * @brief Flags of the chunks
+ *
+ */
+#define STEP_RECORD_CHUNK_FLAG_REGISTERS         0x1 // all registers are tracked (otherwise only RFLAGS)
+#define STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES 0x2 // bytes of the instructions are stored
+#define STEP_RECORD_CHUNK_FLAG_32BIT_MODE        0x4 // the first record is on the 32-bit mode
+#define STEP_RECORD_CHUNK_FLAG_LAST_CHUNK        0x8 // last chunk of the batch
+
+/**
+ * @brief Fields of the first byte of the records
+ *
+ */
+#define STEP_RECORD_BYTE_LENGTH_MASK  0x0f
+#define STEP_RECORD_BYTE_KIND_SHIFT   4
+#define STEP_RECORD_BYTE_KIND_MASK    0x30
+#define STEP_RECORD_BYTE_EXPLICIT_RIP 0x40 // rip is not the next instruction of the previous record
+#define STEP_RECORD_BYTE_EXTENDED     0x80 // an extension byte follows
+
+/**
+ * @brief Fields of the extension byte of the records
+ *
+ */
+#define STEP_RECORD_EXTENSION_REGISTERS   0x1 // the mask and deltas of the changed registers follow
+#define STEP_RECORD_EXTENSION_MODE_SWITCH 0x2 // the operating mode (32-bit/64-bit) is switched
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Classification of the stepped instructions
+ *
+ */
+typedef enum _STEP_RECORD_KIND
+{
+    STEP_RECORD_KIND_NORMAL = 0,
+    STEP_RECORD_KIND_CALL,
+    STEP_RECORD_KIND_RET,
+    STEP_RECORD_KIND_BRANCH, // jumps, loops, interrupts, and system calls
+
+} STEP_RECORD_KIND;
+
+/**
+ * @brief Header of a chunk of the records
+ *
+ * @details The header is followed by the records, the registers are the state
+ * before the first record and each record contains the zigzag varint deltas of
+ * the registers that are changed by the instruction
+ *
+ */
+typedef struct _STEP_RECORD_CHUNK_HEADER
+{
+    UINT32 Flags;
+    UINT32 Sequence;
+    UINT32 NumberOfRecords;
+    UINT32 RecordsSize;
+    UINT64 StartRip; // rip of the first record
+    UINT64 NextRip;  // rip after the last record
+    UINT64 Registers[STEP_RECORD_NUMBER_OF_REGISTERS];
+
+} STEP_RECORD_CHUNK_HEADER, *PSTEP_RECORD_CHUNK_HEADER;
+
+/**
+ * @brief A decoded record
+ *
+ */
+typedef struct _STEP_RECORD
+{
+    UINT64           Rip;
+    UINT64           NextRip; // rip after executing the instruction (target of calls)
+    UINT32           Length;
+    STEP_RECORD_KIND Kind;
+    BOOLEAN          Is32Bit;
+    UINT32           ChangedRegisters; // bitmask of the registers changed by the instruction
+    UINT8            InstructionBytes[STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH + 1];
+    UINT64           Registers[STEP_RECORD_NUMBER_OF_REGISTERS]; // state after the instruction
+
+} STEP_RECORD, *PSTEP_RECORD;
+
+/**
+ * @brief The encoder of the records into the chunks
+ *
+ */
+typedef struct _STEP_RECORD_ENCODER
+{
+    UINT8 * Buffer;
+    UINT32  BufferSize;
+    UINT32  Offset;
+    UINT32  Flags;
+    UINT32  Sequence;
+    UINT32  NumberOfRecords;
+    UINT64  StartRip;
+    UINT64  ExpectedRip;
+    BOOLEAN Is32Bit;
+    UINT64  Registers[STEP_RECORD_NUMBER_OF_REGISTERS]; // state after the last record
+
+} STEP_RECORD_ENCODER, *PSTEP_RECORD_ENCODER;
+
+/**
+ * @brief Callback for each decoded record (returns FALSE to stop decoding)
+ *
+ */
+typedef BOOLEAN (*STEP_RECORD_CALLBACK)(PVOID Context, const STEP_RECORD * Record);
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+STEP_RECORD_KIND
+StepRecordClassify(const UINT8 * InstructionBytes, UINT32 Length, BOOLEAN Is32Bit);
+
+VOID
+StepRecordEncoderInitialize(PSTEP_RECORD_ENCODER Encoder,
+                            VOID *               Buffer,
+                            UINT32               BufferSize,
+                            UINT32               Flags,
+                            BOOLEAN              Is32Bit,
+                            const UINT64 *       Registers);
+
+BOOLEAN
+StepRecordEncode(PSTEP_RECORD_ENCODER Encoder,
+                 UINT64               Rip,
+                 const UINT8 *        InstructionBytes,
+                 UINT32               Length,
+                 STEP_RECORD_KIND     Kind,
+                 BOOLEAN              Is32Bit,
+                 const UINT64 *       Registers);
+
+UINT32
+StepRecordEncoderFinish(PSTEP_RECORD_ENCODER Encoder, UINT64 NextRip, BOOLEAN IsLastChunk);
+
+VOID
+StepRecordEncoderNextChunk(PSTEP_RECORD_ENCODER Encoder);
+
+BOOLEAN
+StepRecordDecodeChunk(const VOID * Chunk, UINT32 ChunkSize, STEP_RECORD_CALLBACK Callback, PVOID Context);
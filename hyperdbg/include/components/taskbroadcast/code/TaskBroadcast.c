@@ -0,0 +1,262 @@
+/**
+ * @file TaskBroadcast.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Broadcasting rounds of tasks to the cores (shared descriptor)
+ * @details All of the cores take the tasks of a round from a single descriptor
+ * at the same time and the completion of the round is tracked by a countdown,
+ * so the cores are not served one after another
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the shared descriptor
+ *
+ * @param Broadcast
+ *
+ * @return VOID
+ */
+VOID
+TaskBroadcastInitialize(PTASK_BROADCAST Broadcast)
+{
+    memset(Broadcast, 0, sizeof(TASK_BROADCAST));
+}
+
+/**
+ * @brief Initialize a round (without any task)
+ *
+ * @param Round
+ * @param WaitAfterTasks Whether the cores wait for the next round after the tasks
+ *
+ * @return VOID
+ */
+VOID
+TaskBroadcastRoundInitialize(PTASK_BROADCAST_ROUND Round, BOOLEAN WaitAfterTasks)
+{
+    Round->NumberOfTasks  = 0;
+    Round->WaitAfterTasks = WaitAfterTasks;
+}
+
+/**
+ * @brief Add a task to a round (the tasks are performed in the same order)
+ *
+ * @param Round
+ * @param TargetTask
+ * @param Context The context should be valid until the round is finished
+ *
+ * @return BOOLEAN FALSE if the round is full
+ */
+BOOLEAN
+TaskBroadcastRoundAddTask(PTASK_BROADCAST_ROUND Round, UINT64 TargetTask, PVOID Context)
+{
+    if (Round->NumberOfTasks == TASK_BROADCAST_MAXIMUM_TASKS)
+    {
+        return FALSE;
+    }
+
+    Round->Tasks[Round->NumberOfTasks].TargetTask = TargetTask;
+    Round->Tasks[Round->NumberOfTasks].Context    = Context;
+    Round->NumberOfTasks++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Publish a round to the cores
+ * @details Only a single core publishes the rounds at a time
+ *
+ * @param Broadcast
+ * @param Round
+ * @param NumberOfCores Count of the cores that should take the round
+ * @param Sequence The sequence of the published round (the publisher doesn't
+ * take its own round)
+ *
+ * @return BOOLEAN FALSE if the previous round is not finished yet
+ */
+BOOLEAN
+TaskBroadcastPublish(PTASK_BROADCAST       Broadcast,
+                     PTASK_BROADCAST_ROUND Round,
+                     UINT32                NumberOfCores,
+                     UINT64 *              Sequence)
+{
+    if (!TaskBroadcastIsCompleted(Broadcast))
+    {
+        return FALSE;
+    }
+
+    memcpy(&Broadcast->Round, Round, sizeof(TASK_BROADCAST_ROUND));
+
+    Broadcast->Remaining = (LONG)NumberOfCores;
+
+    //
+    // The round and the countdown are visible before the new sequence
+    //
+    *Sequence = Broadcast->Sequence + 1;
+
+    AtomicStoreRelease64(&Broadcast->Sequence, *Sequence);
+
+    return TRUE;
+}
+
+/**
+ * @brief Take the published round (if it's not taken by this core before)
+ *
+ * @param Broadcast
+ * @param LastSequence Sequence of the last round that is taken by this core
+ *
+ * @return PTASK_BROADCAST_ROUND NULL if there is no new round
+ */
+PTASK_BROADCAST_ROUND
+TaskBroadcastTake(PTASK_BROADCAST Broadcast, UINT64 * LastSequence)
+{
+    UINT64 Sequence = AtomicLoadAcquire64(&Broadcast->Sequence);
+
+    if (Sequence == *LastSequence)
+    {
+        return NULL;
+    }
+
+    *LastSequence = Sequence;
+
+    return &Broadcast->Round;
+}
+
+/**
+ * @brief Count down the cores of the round (after performing its tasks)
+ * @details The round should not be accessed after this call
+ *
+ * @param Broadcast
+ *
+ * @return VOID
+ */
+VOID
+TaskBroadcastComplete(PTASK_BROADCAST Broadcast)
+{
+    AtomicDecrement(&Broadcast->Remaining);
+}
+
+/**
+ * @brief Check whether all of the cores are finished the round
+ *
+ * @param Broadcast
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+TaskBroadcastIsCompleted(PTASK_BROADCAST Broadcast)
+{
+    return AtomicLoadAcquire32(&Broadcast->Remaining) == 0;
+}
+
+/**
+ * @brief Initialize a batch (without any task)
+ *
+ * @param Batch
+ *
+ * @return VOID
+ */
+VOID
+TaskBroadcastBatchInitialize(PTASK_BROADCAST_BATCH Batch)
+{
+    Batch->NumberOfTasks = 0;
+    Batch->NextTask      = 0;
+}
+
+/**
+ * @brief Add a task to a batch (the tasks are performed in the same order)
+ * @details If the same task with the same context is already in the batch,
+ * the task is not added again
+ *
+ * @param Batch
+ * @param TargetTask
+ * @param Context The context is copied to the batch
+ * @param ContextSize
+ *
+ * @return BOOLEAN FALSE if the batch is full or the context is too large
+ */
+BOOLEAN
+TaskBroadcastBatchAddTask(PTASK_BROADCAST_BATCH Batch,
+                          UINT64                TargetTask,
+                          PVOID                 Context,
+                          UINT32                ContextSize)
+{
+    PTASK_BROADCAST_BATCH_TASK Task;
+
+    if (ContextSize > TASK_BROADCAST_BATCH_MAXIMUM_CONTEXT_SIZE)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Batch->NumberOfTasks; i++)
+    {
+        Task = &Batch->Tasks[i];
+
+        if (Task->TargetTask == TargetTask &&
+            Task->ContextSize == ContextSize &&
+            (ContextSize == 0 || memcmp(Task->Context, Context, ContextSize) == 0))
+        {
+            //
+            // The task is already in the batch
+            //
+            return TRUE;
+        }
+    }
+
+    if (Batch->NumberOfTasks == TASK_BROADCAST_BATCH_MAXIMUM_TASKS)
+    {
+        return FALSE;
+    }
+
+    Task = &Batch->Tasks[Batch->NumberOfTasks];
+
+    memset(Task->Context, 0, sizeof(Task->Context));
+
+    if (ContextSize != 0)
+    {
+        memcpy(Task->Context, Context, ContextSize);
+    }
+
+    Task->TargetTask  = TargetTask;
+    Task->ContextSize = ContextSize;
+    Batch->NumberOfTasks++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Fill the next round with the tasks of a batch
+ * @details The contexts of the round point to the batch, so the batch should
+ * not be changed until the round is finished
+ *
+ * @param Batch
+ * @param Round
+ * @param WaitAfterTasks Whether the cores wait for the next round after the tasks
+ *
+ * @return BOOLEAN FALSE if all of the tasks of the batch are added to rounds
+ */
+BOOLEAN
+TaskBroadcastBatchNextRound(PTASK_BROADCAST_BATCH Batch,
+                            PTASK_BROADCAST_ROUND Round,
+                            BOOLEAN               WaitAfterTasks)
+{
+    if (Batch->NextTask == Batch->NumberOfTasks)
+    {
+        return FALSE;
+    }
+
+    TaskBroadcastRoundInitialize(Round, WaitAfterTasks);
+
+    while (Batch->NextTask != Batch->NumberOfTasks &&
+           TaskBroadcastRoundAddTask(Round,
+                                     Batch->Tasks[Batch->NextTask].TargetTask,
+                                     Batch->Tasks[Batch->NextTask].Context))
+    {
+        Batch->NextTask++;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file TaskBroadcast.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for broadcasting rounds of tasks to the cores (shared descriptor)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of the tasks of a single round
+ *
+ */
+#define TASK_BROADCAST_MAXIMUM_TASKS 8
+
+/**
+ * @brief Maximum number of the tasks of a batch
+ *
+ */
+#define TASK_BROADCAST_BATCH_MAXIMUM_TASKS 64
+
+/**
+ * @brief Maximum size of the context of a task of a batch (in bytes)
+ *
+ */
+#define TASK_BROADCAST_BATCH_MAXIMUM_CONTEXT_SIZE 32
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A task of a round
+ *
+ */
+typedef struct _TASK_BROADCAST_TASK
+{
+    UINT64 TargetTask;
+    PVOID  Context;
+
+} TASK_BROADCAST_TASK, *PTASK_BROADCAST_TASK;
+
+/**
+ * @brief The tasks that are performed by all of the cores in a single round
+ *
+ */
+typedef struct _TASK_BROADCAST_ROUND
+{
+    TASK_BROADCAST_TASK Tasks[TASK_BROADCAST_MAXIMUM_TASKS];
+    UINT32              NumberOfTasks;
+    BOOLEAN             WaitAfterTasks; // the cores wait for the next round after the tasks
+
+} TASK_BROADCAST_ROUND, *PTASK_BROADCAST_ROUND;
+
+/**
+ * @brief The shared descriptor of the rounds
+ *
+ * @details A single core publishes a round by increasing the sequence, each
+ * core takes the round once (its last sequence is not the same as the published
+ * sequence), performs the tasks and then counts down the remaining cores, the
+ * round is not changed until all of the cores are finished
+ *
+ */
+typedef struct _TASK_BROADCAST
+{
+    volatile UINT64      Sequence;  // sequence of the last published round
+    volatile LONG        Remaining; // count of the cores that are not finished the round
+    TASK_BROADCAST_ROUND Round;
+
+} TASK_BROADCAST, *PTASK_BROADCAST;
+
+/**
+ * @brief A task of a batch (the context is copied to the batch)
+ *
+ */
+typedef struct _TASK_BROADCAST_BATCH_TASK
+{
+    UINT64 TargetTask;
+    UINT32 ContextSize;
+    UINT64 Context[TASK_BROADCAST_BATCH_MAXIMUM_CONTEXT_SIZE / sizeof(UINT64)];
+
+} TASK_BROADCAST_BATCH_TASK, *PTASK_BROADCAST_BATCH_TASK;
+
+/**
+ * @brief The tasks that are deferred and then broadcast in as few rounds as possible
+ *
+ * @details The identical tasks (same task and same context) are only performed
+ * once, so the tasks of a batch should not undo each other
+ *
+ */
+typedef struct _TASK_BROADCAST_BATCH
+{
+    TASK_BROADCAST_BATCH_TASK Tasks[TASK_BROADCAST_BATCH_MAXIMUM_TASKS];
+    UINT32                    NumberOfTasks;
+    UINT32                    NextTask; // the first task that is not added to a round
+
+} TASK_BROADCAST_BATCH, *PTASK_BROADCAST_BATCH;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+VOID
+TaskBroadcastInitialize(PTASK_BROADCAST Broadcast);
+
+VOID
+TaskBroadcastRoundInitialize(PTASK_BROADCAST_ROUND Round, BOOLEAN WaitAfterTasks);
+
+BOOLEAN
+TaskBroadcastRoundAddTask(PTASK_BROADCAST_ROUND Round, UINT64 TargetTask, PVOID Context);
+
+BOOLEAN
+TaskBroadcastPublish(PTASK_BROADCAST       Broadcast,
+                     PTASK_BROADCAST_ROUND Round,
+                     UINT32                NumberOfCores,
+                     UINT64 *              Sequence);
+
+PTASK_BROADCAST_ROUND
+TaskBroadcastTake(PTASK_BROADCAST Broadcast, UINT64 * LastSequence);
+
+VOID
+TaskBroadcastComplete(PTASK_BROADCAST Broadcast);
+
+BOOLEAN
+TaskBroadcastIsCompleted(PTASK_BROADCAST Broadcast);
+
+VOID
+TaskBroadcastBatchInitialize(PTASK_BROADCAST_BATCH Batch);
+
+BOOLEAN
+TaskBroadcastBatchAddTask(PTASK_BROADCAST_BATCH Batch,
+                          UINT64                TargetTask,
+                          PVOID                 Context,
+                          UINT32                ContextSize);
+
+BOOLEAN
+TaskBroadcastBatchNextRound(PTASK_BROADCAST_BATCH Batch,
+                            PTASK_BROADCAST_ROUND Round,
+                            BOOLEAN               WaitAfterTasks);
@@ -0,0 +1,420 @@
+/**
+ * @file Unwind.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Unwinding the x64 frames by their unwind data
+ * @details The caller's frame is computed from the RUNTIME_FUNCTION and the
+ * UNWIND_INFO of the function (the same as RtlVirtualUnwind), so only the
+ * saved registers and the return address are read from the stack. The code,
+ * the unwind infos and the stack are read by the callbacks of the image, so
+ * the frames could be unwound from the memory of the debuggee or from the
+ * local files of the modules
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Read a 32-bit immediate (or displacement) of an instruction
+ *
+ * @param Code
+ *
+ * @return INT32
+ */
+static INT32
+UnwindReadImmediate32(const BYTE * Code)
+{
+    return (INT32)(Code[0] | (Code[1] << 8) | (Code[2] << 16) | ((UINT32)Code[3] << 24));
+}
+
+/**
+ * @brief Unwind the frame by emulating the epilog if the instruction is in
+ * an epilog of the function
+ *
+ * @details Same as RtlVirtualUnwind, the prolog codes can't be used in an
+ * epilog as some of them are already undone. The epilog is an optional
+ * "add rsp, imm" (or "lea rsp, [frame register + disp]"), then the pops of the
+ * nonvolatile registers and then a "ret" or a jump out of the function. Only
+ * the exact instruction pointers (e.g., the current frame) can be in an epilog
+ *
+ * @param Image
+ * @param Function
+ * @param Context The context of the current frame, it will be changed to the
+ * caller's context if the instruction is in an epilog
+ * @param IsInEpilog Whether the frame is unwound by its epilog
+ *
+ * @return BOOLEAN FALSE if the instruction is in an epilog but the stack is not readable
+ */
+BOOLEAN
+UnwindEpilog(const UNWIND_IMAGE *            Image,
+             const UNWIND_RUNTIME_FUNCTION * Function,
+             PUNWIND_CONTEXT                 Context,
+             BOOLEAN *                       IsInEpilog)
+{
+    BYTE         Code[UNWIND_EPILOG_MAXIMUM_SIZE];
+    BYTE         Pops[UNWIND_REGISTER_MAX];
+    UINT32       Rva           = (UINT32)(Context->Rip - Image->BaseAddress);
+    UINT32       Size          = Function->EndAddress - Rva;
+    UINT64       Rsp           = Context->Gpr[UNWIND_REGISTER_RSP];
+    UINT32       NumberOfPops  = 0;
+    UINT32       i             = 0;
+    BOOLEAN      IsTerminated  = FALSE;
+    BYTE         FrameRegister = 0;
+    const BYTE * UnwindInfo;
+
+    *IsInEpilog = FALSE;
+
+    if (Size > UNWIND_EPILOG_MAXIMUM_SIZE)
+    {
+        Size = UNWIND_EPILOG_MAXIMUM_SIZE;
+    }
+
+    if (!Image->ReadCode(Image->Context, Context->Rip, Size, Code))
+    {
+        return TRUE;
+    }
+
+    UnwindInfo = Image->GetUnwindInfo(Image->Context, Function->UnwindInfoAddress);
+
+    if (UnwindInfo != NULL)
+    {
+        FrameRegister = UnwindInfo[3] & 0xf;
+    }
+
+    //
+    // Deallocation of the fixed part of the frame
+    //
+    if (Size >= 4 && Code[0] == 0x48 && Code[1] == 0x83 && Code[2] == 0xc4)
+    {
+        Rsp += (INT64)(INT8)Code[3];
+        i = 4;
+    }
+    else if (Size >= 7 && Code[0] == 0x48 && Code[1] == 0x81 && Code[2] == 0xc4)
+    {
+        Rsp += (INT64)UnwindReadImmediate32(&Code[3]);
+        i = 7;
+    }
+    else if (Size >= 4 && (Code[0] & 0xfe) == 0x48 && Code[1] == 0x8d)
+    {
+        BYTE Mod = Code[2] >> 6;
+        BYTE Reg = (Code[2] >> 3) & 0x7;
+        BYTE Rm  = (Code[2] & 0x7) | ((Code[0] & 1) << 3);
+
+        //
+        // Only "lea rsp, [frame register + disp]" is allowed
+        //
+        if (Reg != UNWIND_REGISTER_RSP || FrameRegister == 0 || Rm != FrameRegister)
+        {
+            return TRUE;
+        }
+
+        if (Mod == 1)
+        {
+            Rsp = Context->Gpr[Rm] + (INT64)(INT8)Code[3];
+            i   = 4;
+        }
+        else if (Mod == 2 && Size >= 7)
+        {
+            Rsp = Context->Gpr[Rm] + (INT64)UnwindReadImmediate32(&Code[3]);
+            i   = 7;
+        }
+        else
+        {
+            return TRUE;
+        }
+    }
+
+    //
+    // Pops of the nonvolatile registers
+    //
+    while (NumberOfPops < UNWIND_REGISTER_MAX)
+    {
+        if (i < Size && (Code[i] & 0xf8) == 0x58)
+        {
+            Pops[NumberOfPops++] = Code[i] & 0x7;
+            i += 1;
+        }
+        else if (i + 1 < Size && Code[i] == 0x41 && (Code[i + 1] & 0xf8) == 0x58)
+        {
+            Pops[NumberOfPops++] = 8 + (Code[i + 1] & 0x7);
+            i += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    //
+    // The epilog ends with a "ret" (also "rep ret" and "ret imm16") or with a
+    // jump out of the function (tail calls)
+    //
+    if (i < Size && (Code[i] == 0xc3 || Code[i] == 0xc2))
+    {
+        IsTerminated = TRUE;
+    }
+    else if (i + 1 < Size && Code[i] == 0xf3 && Code[i + 1] == 0xc3)
+    {
+        IsTerminated = TRUE;
+    }
+    else if (i + 4 < Size && Code[i] == 0xe9)
+    {
+        UINT32 Target = Rva + i + 5 + (UINT32)UnwindReadImmediate32(&Code[i + 1]);
+
+        IsTerminated = Target < Function->BeginAddress || Target >= Function->EndAddress;
+    }
+    else if (i + 5 < Size && Code[i] == 0xff && Code[i + 1] == 0x25)
+    {
+        IsTerminated = TRUE;
+    }
+    else if (i + 6 < Size && Code[i] == 0x48 && Code[i + 1] == 0xff && Code[i + 2] == 0x25)
+    {
+        IsTerminated = TRUE;
+    }
+
+    if (!IsTerminated)
+    {
+        return TRUE;
+    }
+
+    *IsInEpilog = TRUE;
+
+    //
+    // Emulate the rest of the epilog
+    //
+    for (UINT32 j = 0; j < NumberOfPops; j++)
+    {
+        if (!Image->ReadStack(Image->Context, Rsp, &Context->Gpr[Pops[j]]))
+        {
+            return FALSE;
+        }
+
+        Rsp += sizeof(UINT64);
+    }
+
+    if (!Image->ReadStack(Image->Context, Rsp, &Context->Rip))
+    {
+        return FALSE;
+    }
+
+    Context->Gpr[UNWIND_REGISTER_RSP] = Rsp + sizeof(UINT64);
+
+    return TRUE;
+}
+
+/**
+ * @brief Virtually unwind a single frame based on the function's unwind codes
+ *
+ * @param Image
+ * @param Function
+ * @param Context The context of the current frame, it will be changed to the caller's context
+ * @param IsMachineFrame Whether the caller's context is an interrupted context
+ * (so its instruction pointer is not a return address)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+UnwindVirtualUnwind(const UNWIND_IMAGE *            Image,
+                    const UNWIND_RUNTIME_FUNCTION * Function,
+                    PUNWIND_CONTEXT                 Context,
+                    BOOLEAN *                       IsMachineFrame)
+{
+    UNWIND_RUNTIME_FUNCTION CurrentFunction = *Function;
+    UINT64                  FrameBase       = Context->Gpr[UNWIND_REGISTER_RSP];
+    UINT32                  OffsetInFunction;
+    BOOLEAN                 IsChained = FALSE;
+    UINT64                  Value;
+
+    *IsMachineFrame = FALSE;
+
+    OffsetInFunction = (UINT32)(Context->Rip - Image->BaseAddress) - CurrentFunction.BeginAddress;
+
+    for (UINT32 Depth = 0; Depth < UNWIND_MAXIMUM_CHAIN_DEPTH; Depth++)
+    {
+        const BYTE * Info = Image->GetUnwindInfo(Image->Context, CurrentFunction.UnwindInfoAddress);
+
+        if (Info == NULL)
+        {
+            return FALSE;
+        }
+
+        BYTE         Version       = Info[0] & 0x7;
+        BYTE         Flags         = Info[0] >> 3;
+        BYTE         CountOfCodes  = Info[2];
+        BYTE         FrameRegister = Info[3] & 0xf;
+        BYTE         FrameOffset   = Info[3] >> 4;
+        const BYTE * Codes         = &Info[4];
+
+        if (Version != 1 && Version != 2)
+        {
+            return FALSE;
+        }
+
+        //
+        // If the frame pointer is established, the fixed part of the frame is
+        // relative to the frame register (and not the RSP, which might be changed
+        // by alloca). For the primary function we can only use it when the
+        // prolog is already executed
+        //
+        if (!IsChained && FrameRegister != 0 && OffsetInFunction >= Info[1])
+        {
+            FrameBase = Context->Gpr[FrameRegister] - (UINT64)FrameOffset * 16;
+        }
+
+        for (UINT32 i = 0; i < CountOfCodes;)
+        {
+            BYTE   CodeOffset = Codes[i * 2];
+            BYTE   UnwindOp   = Codes[i * 2 + 1] & 0xf;
+            BYTE   OpInfo     = Codes[i * 2 + 1] >> 4;
+            UINT32 Slots      = 1;
+            UINT32 Operand;
+
+            //
+            // Find the number of slots used by this code
+            //
+            switch (UnwindOp)
+            {
+            case UNWIND_OP_ALLOC_LARGE:
+                Slots = OpInfo == 0 ? 2 : 3;
+                break;
+            case UNWIND_OP_SAVE_NONVOL:
+            case UNWIND_OP_SAVE_XMM128:
+                Slots = 2;
+                break;
+            case UNWIND_OP_SAVE_NONVOL_FAR:
+            case UNWIND_OP_SAVE_XMM128_FAR:
+                Slots = 3;
+                break;
+            case UNWIND_OP_EPILOG:
+                Slots = Version == 1 ? 2 : 1;
+                break;
+            case UNWIND_OP_SPARE_CODE:
+                Slots = Version == 1 ? 3 : 2;
+                break;
+            default:
+                break;
+            }
+
+            if (i + Slots > CountOfCodes)
+            {
+                return FALSE;
+            }
+
+            //
+            // The operand of the code is in the next slot (or the next two slots)
+            //
+            Operand = Slots == 1 ? 0 : Codes[i * 2 + 2] | (Codes[i * 2 + 3] << 8);
+
+            if (Slots == 3)
+            {
+                Operand |= (UINT32)(Codes[i * 2 + 4] | (Codes[i * 2 + 5] << 8)) << 16;
+            }
+
+            //
+            // Skip the operations of the prolog which are not executed yet, for the
+            // chained infos, the whole prolog is already executed
+            //
+            if (!IsChained && CodeOffset > OffsetInFunction && UnwindOp != UNWIND_OP_EPILOG)
+            {
+                i += Slots;
+                continue;
+            }
+
+            switch (UnwindOp)
+            {
+            case UNWIND_OP_PUSH_NONVOL:
+
+                if (!Image->ReadStack(Image->Context, Context->Gpr[UNWIND_REGISTER_RSP], &Value))
+                {
+                    return FALSE;
+                }
+
+                Context->Gpr[OpInfo] = Value;
+                Context->Gpr[UNWIND_REGISTER_RSP] += sizeof(UINT64);
+                break;
+
+            case UNWIND_OP_ALLOC_LARGE:
+
+                Context->Gpr[UNWIND_REGISTER_RSP] += OpInfo == 0 ? (UINT64)Operand * 8 : (UINT64)Operand;
+                break;
+
+            case UNWIND_OP_ALLOC_SMALL:
+
+                Context->Gpr[UNWIND_REGISTER_RSP] += (UINT64)OpInfo * 8 + 8;
+                break;
+
+            case UNWIND_OP_SET_FPREG:
+
+                Context->Gpr[UNWIND_REGISTER_RSP] = Context->Gpr[FrameRegister] - (UINT64)FrameOffset * 16;
+                FrameBase                         = Context->Gpr[UNWIND_REGISTER_RSP];
+                break;
+
+            case UNWIND_OP_SAVE_NONVOL:
+            case UNWIND_OP_SAVE_NONVOL_FAR:
+
+                if (!Image->ReadStack(Image->Context,
+                                      FrameBase + (UnwindOp == UNWIND_OP_SAVE_NONVOL ? (UINT64)Operand * 8 : (UINT64)Operand),
+                                      &Value))
+                {
+                    return FALSE;
+                }
+
+                Context->Gpr[OpInfo] = Value;
+                break;
+
+            case UNWIND_OP_PUSH_MACHFRAME:
+
+                //
+                // The interrupted context is stored on the stack (with an optional error code)
+                //
+                Value = Context->Gpr[UNWIND_REGISTER_RSP] + (OpInfo ? sizeof(UINT64) : 0);
+
+                if (!Image->ReadStack(Image->Context, Value, &Context->Rip) ||
+                    !Image->ReadStack(Image->Context, Value + 3 * sizeof(UINT64), &Context->Gpr[UNWIND_REGISTER_RSP]))
+                {
+                    return FALSE;
+                }
+
+                *IsMachineFrame = TRUE;
+                break;
+
+            default:
+
+                //
+                // XMM registers are not tracked and epilog codes don't change the frame
+                //
+                break;
+            }
+
+            i += Slots;
+        }
+
+        if (!(Flags & UNWIND_FLAG_CHAININFO))
+        {
+            break;
+        }
+
+        //
+        // Continue with the chained (parent) function
+        //
+        memcpy(&CurrentFunction, &Codes[((CountOfCodes + 1) & ~1) * sizeof(UINT16)], sizeof(UNWIND_RUNTIME_FUNCTION));
+        IsChained = TRUE;
+    }
+
+    if (!*IsMachineFrame)
+    {
+        //
+        // Pop the return address
+        //
+        if (!Image->ReadStack(Image->Context, Context->Gpr[UNWIND_REGISTER_RSP], &Context->Rip))
+        {
+            return FALSE;
+        }
+
+        Context->Gpr[UNWIND_REGISTER_RSP] += sizeof(UINT64);
+    }
+
+    return TRUE;
+}
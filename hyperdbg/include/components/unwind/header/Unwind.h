@@ -0,0 +1,122 @@
+/**
+ * @file Unwind.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for unwinding the x64 frames by their unwind data
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of chained unwind infos followed for a single frame
+ *
+ */
+#define UNWIND_MAXIMUM_CHAIN_DEPTH 32
+
+/**
+ * @brief Maximum number of the bytes of an epilog (add rsp, up to 16 pops and
+ * an indirect jump) that are read to detect it
+ *
+ */
+#define UNWIND_EPILOG_MAXIMUM_SIZE 0x40
+
+/**
+ * @brief Unwind info flags
+ *
+ */
+#define UNWIND_FLAG_CHAININFO 0x4
+
+/**
+ * @brief Unwind operation codes (UNWIND_CODE.UnwindOp)
+ *
+ */
+#define UNWIND_OP_PUSH_NONVOL     0
+#define UNWIND_OP_ALLOC_LARGE     1
+#define UNWIND_OP_ALLOC_SMALL     2
+#define UNWIND_OP_SET_FPREG       3
+#define UNWIND_OP_SAVE_NONVOL     4
+#define UNWIND_OP_SAVE_NONVOL_FAR 5
+#define UNWIND_OP_EPILOG          6
+#define UNWIND_OP_SPARE_CODE      7
+#define UNWIND_OP_SAVE_XMM128     8
+#define UNWIND_OP_SAVE_XMM128_FAR 9
+#define UNWIND_OP_PUSH_MACHFRAME  10
+
+/**
+ * @brief Register numbers used by the unwind codes
+ *
+ */
+#define UNWIND_REGISTER_RSP 4
+#define UNWIND_REGISTER_MAX 16
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A single RUNTIME_FUNCTION entry of the exception directory
+ *
+ */
+typedef struct _UNWIND_RUNTIME_FUNCTION
+{
+    UINT32 BeginAddress;
+    UINT32 EndAddress;
+    UINT32 UnwindInfoAddress;
+
+} UNWIND_RUNTIME_FUNCTION, *PUNWIND_RUNTIME_FUNCTION;
+
+/**
+ * @brief Register context which is used while unwinding
+ *
+ */
+typedef struct _UNWIND_CONTEXT
+{
+    UINT64 Rip;
+    UINT64 Gpr[UNWIND_REGISTER_MAX]; // indexed by the x64 register number (rax, rcx, rdx, rbx, rsp, ...)
+
+} UNWIND_CONTEXT, *PUNWIND_CONTEXT;
+
+/**
+ * @brief The image of the unwound functions and the readers of its code, its
+ * unwind infos and the stack
+ *
+ * @details GetUnwindInfo returns the whole UNWIND_INFO (the header, the unwind
+ * codes and the chained runtime function if there is one) or NULL if it's not
+ * readable
+ *
+ */
+typedef struct _UNWIND_IMAGE
+{
+    UINT64 BaseAddress;
+
+    BOOLEAN (*ReadCode)(PVOID Context, UINT64 Address, UINT32 Size, BYTE * Buffer);
+    BOOLEAN (*ReadStack)(PVOID Context, UINT64 Address, UINT64 * Value);
+    const BYTE * (*GetUnwindInfo)(PVOID Context, UINT32 UnwindInfoRva);
+
+    PVOID Context;
+
+} UNWIND_IMAGE, *PUNWIND_IMAGE;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+BOOLEAN
+UnwindEpilog(const UNWIND_IMAGE *            Image,
+             const UNWIND_RUNTIME_FUNCTION * Function,
+             PUNWIND_CONTEXT                 Context,
+             BOOLEAN *                       IsInEpilog);
+
+BOOLEAN
+UnwindVirtualUnwind(const UNWIND_IMAGE *            Image,
+                    const UNWIND_RUNTIME_FUNCTION * Function,
+                    PUNWIND_CONTEXT                 Context,
+                    BOOLEAN *                       IsMachineFrame);
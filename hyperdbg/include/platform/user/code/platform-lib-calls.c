@@ -20,6 +20,12 @@
 #    include <stdint.h>
 #    include <string.h>
 #    include <signal.h>
+#    include <time.h>
+#    include <fcntl.h>
+#    include <limits.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <linux/falloc.h>
 #endif // defined(__linux__)
 
 /**
@@ -299,6 +305,29 @@ PlatformGetCurrentProcessorNumber(VOID)
 #endif
 }
 
+/**
+ * @brief Platform independent wrapper to get the number of logical processors
+ *
+ * @return UINT32 number of logical processors that are online (at least 1)
+ */
+UINT32
+PlatformGetNumberOfProcessors(VOID)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO SystemInfo = {0};
+
+    GetSystemInfo(&SystemInfo);
+
+    return SystemInfo.dwNumberOfProcessors != 0 ? (UINT32)SystemInfo.dwNumberOfProcessors : 1;
+#elif defined(__linux__)
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return Count > 0 ? (UINT32)Count : 1;
+#else
+#    error "Unsupported platform"
+#endif
+}
+
 /**
  * @brief Platform independent wrapper for GetCurrentProcessId / getpid
  *
@@ -531,6 +560,27 @@ PlatformWriteConsole(const VOID * Buffer, DWORD NumberOfBytes)
 #endif
 }
 
+#if defined(__linux__)
+
+/**
+ * @brief Narrow a wide path for the file APIs of Linux
+ *
+ * @details The callers pass a std::wstring, so the path is made of 4-byte
+ *          wchar_t characters (see the cast of WCHAR on Linux)
+ *
+ * @param Path wide path of the file
+ * @param NarrowPath output — the narrowed path
+ * @param NarrowPathSize size of NarrowPath in bytes
+ * @return BOOLEAN TRUE if the whole path is narrowed
+ */
+static BOOLEAN
+PlatformNarrowPath(const WCHAR * Path, CHAR * NarrowPath, SIZE_T NarrowPathSize)
+{
+    return (BOOLEAN)(wcstombs(NarrowPath, (const wchar_t *)Path, NarrowPathSize) < NarrowPathSize);
+}
+
+#endif // defined(__linux__)
+
 /**
  * @brief Platform independent wrapper to create/open a file for writing
  *
@@ -543,15 +593,21 @@ PlatformOpenFileForWriting(const WCHAR * Path)
 #if defined(_WIN32)
     return CreateFileW(Path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
 #elif defined(__linux__)
+    CHAR NarrowPath[PATH_MAX];
+    int  FileDescriptor;
+
     //
-    // TODO: handle this later. The path arrives as a std::wstring (4-byte
-    //       wchar_t on Linux) and must be narrowed to a UTF-8 char* before it
-    //       can be handed to fopen. Until that conversion is wired up, fail the
-    //       open so callers (e.g. dump.cpp) bail out cleanly instead of writing
-    //       to a bogus handle.
+    // The handles of the files are the descriptors on Linux (the same as
+    // PlatformMapFileReadOnly)
     //
-    (void)Path;
-    return INVALID_HANDLE_VALUE;
+    if (!PlatformNarrowPath(Path, NarrowPath, sizeof(NarrowPath)))
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    FileDescriptor = open(NarrowPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    return FileDescriptor < 0 ? INVALID_HANDLE_VALUE : (HANDLE)(intptr_t)FileDescriptor;
 #else
 #    error "Unsupported platform"
 #endif
@@ -572,7 +628,28 @@ PlatformWriteFile(HANDLE FileHandle, const VOID * Buffer, DWORD NumberOfBytes)
     DWORD BytesWritten;
     return (BOOLEAN)WriteFile(FileHandle, Buffer, NumberOfBytes, &BytesWritten, NULL);
 #elif defined(__linux__)
-    return (BOOLEAN)(fwrite(Buffer, 1, NumberOfBytes, (FILE *)FileHandle) == NumberOfBytes);
+    const BYTE * Current = (const BYTE *)Buffer;
+    ssize_t      Result;
+
+    while (NumberOfBytes != 0)
+    {
+        Result = write((int)(intptr_t)FileHandle, Current, NumberOfBytes);
+
+        if (Result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (Result <= 0)
+        {
+            return FALSE;
+        }
+
+        Current += Result;
+        NumberOfBytes -= (DWORD)Result;
+    }
+
+    return TRUE;
 #else
 #    error "Unsupported platform"
 #endif
@@ -591,7 +668,168 @@ PlatformCloseFile(HANDLE FileHandle)
 #if defined(_WIN32)
     return (BOOLEAN)CloseHandle(FileHandle);
 #elif defined(__linux__)
-    return (BOOLEAN)(fclose((FILE *)FileHandle) == 0);
+    return (BOOLEAN)(close((int)(intptr_t)FileHandle) == 0);
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper to open a file for positioned reads and
+ *        writes without truncating it (the file is created if it doesn't exist)
+ *
+ * @param Path wide path of the file
+ * @return HANDLE handle of the file, or INVALID_HANDLE_VALUE on failure
+ */
+HANDLE
+PlatformOpenFileForUpdate(const WCHAR * Path)
+{
+#if defined(_WIN32)
+    return CreateFileW(Path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+#elif defined(__linux__)
+    CHAR NarrowPath[PATH_MAX];
+    int  FileDescriptor;
+
+    if (!PlatformNarrowPath(Path, NarrowPath, sizeof(NarrowPath)))
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+
+    FileDescriptor = open(NarrowPath, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    return FileDescriptor < 0 ? INVALID_HANDLE_VALUE : (HANDLE)(intptr_t)FileDescriptor;
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper for a positioned file write
+ *
+ * @param FileHandle handle returned by PlatformOpenFileForWriting or PlatformOpenFileForUpdate
+ * @param Offset byte offset to write at (absolute, from start of file)
+ * @param Buffer pointer to the bytes to write
+ * @param NumberOfBytes number of bytes to write
+ * @return BOOLEAN TRUE if all of the bytes are written
+ */
+BOOLEAN
+PlatformWriteFileAtOffset(HANDLE FileHandle, UINT64 Offset, const VOID * Buffer, DWORD NumberOfBytes)
+{
+#if defined(_WIN32)
+    OVERLAPPED Overlapped = {0};
+    DWORD      BytesWritten;
+
+    Overlapped.Offset     = (DWORD)Offset;
+    Overlapped.OffsetHigh = (DWORD)(Offset >> 32);
+
+    return (BOOLEAN)(WriteFile(FileHandle, Buffer, NumberOfBytes, &BytesWritten, &Overlapped) && BytesWritten == NumberOfBytes);
+#elif defined(__linux__)
+    const BYTE * Current = (const BYTE *)Buffer;
+    ssize_t      Result;
+
+    while (NumberOfBytes != 0)
+    {
+        Result = pwrite((int)(intptr_t)FileHandle, Current, NumberOfBytes, (off_t)Offset);
+
+        if (Result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (Result <= 0)
+        {
+            return FALSE;
+        }
+
+        Current += Result;
+        Offset += (UINT64)Result;
+        NumberOfBytes -= (DWORD)Result;
+    }
+
+    return TRUE;
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper to mark a file as sparse, so the ranges
+ *        that are never written (or are punched) don't occupy the disk
+ *
+ * @param FileHandle handle of the file
+ * @return BOOLEAN TRUE on success
+ */
+BOOLEAN
+PlatformSetFileSparse(HANDLE FileHandle)
+{
+#if defined(_WIN32)
+    DWORD BytesReturned;
+
+    return (BOOLEAN)DeviceIoControl(FileHandle, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &BytesReturned, NULL);
+#elif defined(__linux__)
+    //
+    // The files are sparse by default on Linux
+    //
+    (void)FileHandle;
+    return TRUE;
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper to deallocate (and zero) a range of a
+ *        sparse file without changing the size of the file
+ *
+ * @param FileHandle handle of the file
+ * @param Offset byte offset of the range
+ * @param Length length of the range
+ * @return BOOLEAN TRUE on success
+ */
+BOOLEAN
+PlatformPunchFileHole(HANDLE FileHandle, UINT64 Offset, UINT64 Length)
+{
+#if defined(_WIN32)
+    FILE_ZERO_DATA_INFORMATION ZeroData;
+    DWORD                      BytesReturned;
+
+    ZeroData.FileOffset.QuadPart      = (LONGLONG)Offset;
+    ZeroData.BeyondFinalZero.QuadPart = (LONGLONG)(Offset + Length);
+
+    return (BOOLEAN)DeviceIoControl(FileHandle, FSCTL_SET_ZERO_DATA, &ZeroData, sizeof(ZeroData), NULL, 0, &BytesReturned, NULL);
+#elif defined(__linux__)
+    return (BOOLEAN)(fallocate((int)(intptr_t)FileHandle,
+                               FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                               (off_t)Offset,
+                               (off_t)Length) == 0);
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper to set the size of a file (the file is
+ *        truncated or extended with a hole)
+ *
+ * @param FileHandle handle of the file
+ * @param Size the new size in bytes
+ * @return BOOLEAN TRUE on success
+ */
+BOOLEAN
+PlatformSetFileSize(HANDLE FileHandle, UINT64 Size)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER Distance;
+    Distance.QuadPart = (LONGLONG)Size;
+
+    if (!SetFilePointerEx(FileHandle, Distance, NULL, FILE_BEGIN))
+    {
+        return FALSE;
+    }
+
+    return (BOOLEAN)SetEndOfFile(FileHandle);
+#elif defined(__linux__)
+    return (BOOLEAN)(ftruncate((int)(intptr_t)FileHandle, (off_t)Size) == 0);
 #else
 #    error "Unsupported platform"
 #endif
@@ -601,8 +839,8 @@ PlatformCloseFile(HANDLE FileHandle)
  * @brief Platform independent wrapper to map an entire file read-only into memory
  *
  * @details The returned pointer stays valid until released with PlatformUnmapFile;
- *          the underlying file/descriptor is closed before returning (the mapping
- *          outlives it on both platforms).
+ *          the file handle (a descriptor on Linux) is handed back for the raw
+ *          reads and is closed by PlatformUnmapFile.
  *
  * @param Path wide path of the file to map
  * @param OutFileSize output — size of the file in bytes (0 on failure)
@@ -658,27 +896,48 @@ PlatformMapFileReadOnly(const WCHAR * Path, PSIZE_T OutFileSize, PHANDLE OutFile
     *OutFileHandle = FileHandle;
     return BaseAddr;
 #elif defined(__linux__)
+    CHAR        NarrowPath[PATH_MAX];
+    int         FileDescriptor;
+    struct stat FileStatus;
+    VOID *      BaseAddr;
+
+    *OutFileSize   = 0;
+    *OutFileHandle = INVALID_HANDLE_VALUE;
+
+    if (!PlatformNarrowPath(Path, NarrowPath, sizeof(NarrowPath)))
+    {
+        return NULL;
+    }
+
+    FileDescriptor = open(NarrowPath, O_RDONLY | O_CLOEXEC);
+    if (FileDescriptor < 0)
+    {
+        return NULL;
+    }
+
+    //
+    // An empty file can't be mapped
     //
-    // TODO (linux): implement the real mapping. Expected contract:
-    //   1. Narrow the 4-byte wchar_t 'Path' to a UTF-8 char* (the project still
-    //      lacks a wchar_t->UTF-8 helper; the same one is needed by
-    //      PlatformOpenFileForWriting for the dump.cpp write path).
-    //   2. fd = open(narrowed_path, O_RDONLY);                  // fail -> NULL
-    //   3. fstat(fd, &st) to get the file size.
-    //   4. base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
-    //   5. *OutFileHandle = (HANDLE)(intptr_t)fd;  // keep fd open for raw reads
-    //   6. *OutFileSize = st.st_size; return base;  (return NULL on any failure)
-    // PlatformUnmapFile must then munmap(base, size) and close the fd — which is
-    // why both the size and the handle are passed back in on unmap. The raw-read
-    // path (PlatformReadFileAtOffset) would pread() from that same fd.
+    if (fstat(FileDescriptor, &FileStatus) != 0 || !S_ISREG(FileStatus.st_mode) || FileStatus.st_size == 0)
+    {
+        close(FileDescriptor);
+        return NULL;
+    }
+
+    BaseAddr = mmap(NULL, (SIZE_T)FileStatus.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+    if (BaseAddr == MAP_FAILED)
+    {
+        close(FileDescriptor);
+        return NULL;
+    }
+
     //
-    // Until implemented, fail the map so PE-parser callers print "could not open
-    // the file" and bail out cleanly instead of dereferencing a bogus pointer.
+    // The descriptor is kept open for the raw reads (PlatformReadFileAtOffset),
+    // it is closed by PlatformUnmapFile
     //
-    (void)Path;
-    *OutFileSize   = 0;
-    *OutFileHandle = INVALID_HANDLE_VALUE;
-    return NULL;
+    *OutFileSize   = (SIZE_T)FileStatus.st_size;
+    *OutFileHandle = (HANDLE)(intptr_t)FileDescriptor;
+    return BaseAddr;
 #else
 #    error "Unsupported platform"
 #endif
@@ -708,20 +967,14 @@ PlatformReadFileAtOffset(HANDLE FileHandle, UINT64 Offset, VOID * Buffer, DWORD
 
     return (BOOLEAN)ReadFile(FileHandle, Buffer, NumberOfBytes, BytesRead, NULL);
 #elif defined(__linux__)
-    //
-    // TODO (linux): pread((int)(intptr_t)FileHandle, Buffer, NumberOfBytes, Offset)
-    //               once PlatformMapFileReadOnly wraps a real fd. Unreached today
-    //               because the map returns NULL on Linux, so callers bail first.
-    //
-    (void)FileHandle;
-    (void)Offset;
-    (void)Buffer;
-    (void)NumberOfBytes;
+    ssize_t Result = pread((int)(intptr_t)FileHandle, Buffer, NumberOfBytes, (off_t)Offset);
+
     if (BytesRead != NULL)
     {
-        *BytesRead = 0;
+        *BytesRead = Result > 0 ? (DWORD)Result : 0;
     }
-    return FALSE;
+
+    return (BOOLEAN)(Result >= 0);
 #else
 #    error "Unsupported platform"
 #endif
@@ -748,14 +1001,65 @@ PlatformUnmapFile(VOID * BaseAddress, SIZE_T FileSize, HANDLE FileHandle)
         CloseHandle(FileHandle);
     }
 #elif defined(__linux__)
-    //
-    // TODO (linux): munmap(BaseAddress, FileSize) and close the fd behind
-    //               FileHandle once PlatformMapFileReadOnly is implemented.
-    //               No-op for now since the map always returns NULL.
-    //
-    (void)BaseAddress;
-    (void)FileSize;
-    (void)FileHandle;
+    if (BaseAddress != NULL)
+    {
+        munmap(BaseAddress, FileSize);
+    }
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        close((int)(intptr_t)FileHandle);
+    }
+#else
+#    error "Unsupported platform"
+#endif
+}
+
+/**
+ * @brief Platform independent wrapper to get the size and the last write time
+ *        of a file without opening it
+ *
+ * @param Path wide path of the file
+ * @param FileSize output — size of the file in bytes
+ * @param LastWriteTime output — last write time (only comparable with the other
+ *        values of this function)
+ * @return BOOLEAN TRUE on success
+ */
+BOOLEAN
+PlatformGetFileSizeAndTime(const WCHAR * Path, UINT64 * FileSize, UINT64 * LastWriteTime)
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA Attributes;
+
+    if (!GetFileAttributesExW(Path, GetFileExInfoStandard, &Attributes))
+    {
+        return FALSE;
+    }
+
+    *FileSize      = (UINT64)Attributes.nFileSizeHigh << 32 | Attributes.nFileSizeLow;
+    *LastWriteTime = (UINT64)Attributes.ftLastWriteTime.dwHighDateTime << 32 | Attributes.ftLastWriteTime.dwLowDateTime;
+
+    return TRUE;
+#elif defined(__linux__)
+    CHAR        NarrowPath[PATH_MAX];
+    struct stat FileStatus;
+
+    *FileSize      = 0;
+    *LastWriteTime = 0;
+
+    if (!PlatformNarrowPath(Path, NarrowPath, sizeof(NarrowPath)))
+    {
+        return FALSE;
+    }
+
+    if (stat(NarrowPath, &FileStatus) != 0)
+    {
+        return FALSE;
+    }
+
+    *FileSize      = (UINT64)FileStatus.st_size;
+    *LastWriteTime = (UINT64)FileStatus.st_mtim.tv_sec * 1000000000ull + (UINT64)FileStatus.st_mtim.tv_nsec;
+
+    return TRUE;
 #else
 #    error "Unsupported platform"
 #endif
@@ -142,6 +142,8 @@ PlatformWriteConsole(const VOID * Buffer, DWORD NumberOfBytes);
 //
 // FILE I/O
 //
+// On Linux, the handles of the files are the file descriptors.
+//
 HANDLE
 PlatformOpenFileForWriting(const WCHAR * Path);
 
@@ -151,6 +153,27 @@ PlatformWriteFile(HANDLE FileHandle, const VOID * Buffer, DWORD NumberOfBytes);
 BOOLEAN
 PlatformCloseFile(HANDLE FileHandle);
 
+//
+// POSITIONED AND SPARSE FILE I/O
+//
+// PlatformOpenFileForUpdate keeps the existing contents of the file (it is
+// created if it doesn't exist), the handle is released with PlatformCloseFile.
+//
+HANDLE
+PlatformOpenFileForUpdate(const WCHAR * Path);
+
+BOOLEAN
+PlatformWriteFileAtOffset(HANDLE FileHandle, UINT64 Offset, const VOID * Buffer, DWORD NumberOfBytes);
+
+BOOLEAN
+PlatformSetFileSparse(HANDLE FileHandle);
+
+BOOLEAN
+PlatformPunchFileHole(HANDLE FileHandle, UINT64 Offset, UINT64 Length);
+
+BOOLEAN
+PlatformSetFileSize(HANDLE FileHandle, UINT64 Size);
+
 //
 // READ-ONLY FILE MAPPING
 //
@@ -167,6 +190,12 @@ PlatformReadFileAtOffset(HANDLE FileHandle, UINT64 Offset, VOID * Buffer, DWORD
 VOID
 PlatformUnmapFile(VOID * BaseAddress, SIZE_T FileSize, HANDLE FileHandle);
 
+//
+// FILE ATTRIBUTES
+//
+BOOLEAN
+PlatformGetFileSizeAndTime(const WCHAR * Path, UINT64 * FileSize, UINT64 * LastWriteTime);
+
 //
 // PROCESS / THREAD IDENTITY
 //
@@ -176,6 +205,9 @@ PlatformGetCurrentThreadId(VOID);
 UINT32
 PlatformGetCurrentProcessorNumber(VOID);
 
+UINT32
+PlatformGetNumberOfProcessors(VOID);
+
 UINT32
 PlatformGetCurrentProcessId(VOID);
 
@@ -232,6 +232,14 @@ ReadIrpBasedBuffer()
 
                 break;
 
+            case OPERATION_DEBUGGEE_REGISTER_EVENT_SET:
+
+                KdRegisterEventSetInDebuggee(
+                    (PDEBUGGER_EVENT_SET)(OutputBuffer + sizeof(UINT32)),
+                    ReturnedLength);
+
+                break;
+
             case OPERATION_DEBUGGEE_CLEAR_EVENTS:
 
                 KdSendModifyEventInDebuggee(
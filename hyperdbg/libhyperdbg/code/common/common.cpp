@@ -829,10 +829,16 @@ ListDirectory(const std::string & Directory, const std::string & Extension)
     if (Find == INVALID_HANDLE_VALUE)
         throw std::runtime_error("invalid handle value! please check your path...");
 
-    while (FindNextFileA(Find, &FindData) != 0)
+    //
+    // The first file is already found by FindFirstFileA
+    //
+    do
     {
+        if (FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            continue;
+
         DirList.push_back(Directory + "\\" + std::string(FindData.cFileName));
-    }
+    } while (FindNextFileA(Find, &FindData) != 0);
 
     FindClose(Find);
 
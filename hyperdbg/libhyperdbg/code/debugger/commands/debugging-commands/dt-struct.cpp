@@ -299,6 +299,326 @@ CommandDtAndStructConvertHyperDbgArgsToPdbex(vector<CommandToken> ExtraArgs,
     return TRUE;
 }
 
+/**
+ * @brief expansion of the nested structures in the dt command
+ *
+ */
+typedef enum _DEBUGGER_DT_INLINE_EXPANSION
+{
+    DEBUGGER_DT_INLINE_EXPANSION_NONE,
+    DEBUGGER_DT_INLINE_EXPANSION_UNNAMED,
+    DEBUGGER_DT_INLINE_EXPANSION_ALL,
+
+} DEBUGGER_DT_INLINE_EXPANSION;
+
+/**
+ * @brief Get the expansion of the nested structures from the pdbex arguments
+ *
+ * @param PdbexArgs
+ * @param InlineExpansion
+ *
+ * @return BOOLEAN FALSE if the arguments contain other options than the
+ * expansion
+ */
+static BOOLEAN
+CommandDtGetInlineExpansion(const CHAR * PdbexArgs, DEBUGGER_DT_INLINE_EXPANSION * InlineExpansion)
+{
+    if (PdbexArgs == NULL)
+    {
+        return FALSE;
+    }
+    else if (strcmp(PdbexArgs, PDBEX_DEFAULT_CONFIGURATION) == 0 || strcmp(PdbexArgs, "-e n ") == 0)
+    {
+        *InlineExpansion = DEBUGGER_DT_INLINE_EXPANSION_NONE;
+    }
+    else if (strcmp(PdbexArgs, "") == 0 || strcmp(PdbexArgs, "-e i ") == 0)
+    {
+        //
+        // Unnamed structures are expanded by default
+        //
+        *InlineExpansion = DEBUGGER_DT_INLINE_EXPANSION_UNNAMED;
+    }
+    else if (strcmp(PdbexArgs, "-e a ") == 0)
+    {
+        *InlineExpansion = DEBUGGER_DT_INLINE_EXPANSION_ALL;
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the value of a member from the buffer of the structure
+ *
+ * @param Member
+ * @param Buffer
+ *
+ * @return UINT64
+ */
+static UINT64
+CommandDtReadLayoutValue(const SYMBOL_TYPE_LAYOUT_MEMBER * Member, const UINT8 * Buffer)
+{
+    UINT64 Value = 0;
+    UINT32 Size  = Member->Size > sizeof(UINT64) ? sizeof(UINT64) : Member->Size;
+
+    memcpy(&Value, Buffer + Member->Offset, Size);
+
+    if (Member->BitLength != 0)
+    {
+        Value >>= Member->BitPosition;
+
+        if (Member->BitLength < 64)
+        {
+            Value &= (1ull << Member->BitLength) - 1;
+        }
+    }
+    else if (Member->IsSigned && Size != 0 && Size < sizeof(UINT64))
+    {
+        //
+        // Extend the sign
+        //
+        Value = (UINT64)((INT64)(Value << (64 - Size * 8)) >> (64 - Size * 8));
+    }
+
+    return Value;
+}
+
+/**
+ * @brief Show the members of a structure from its compiled layout
+ *
+ * @param Layout
+ * @param FirstMember
+ * @param NumberOfMembers
+ * @param ParentOffset
+ * @param Depth
+ * @param Buffer
+ * @param InlineExpansion
+ *
+ * @return VOID
+ */
+static VOID
+CommandDtShowLayoutMembers(const SYMBOL_TYPE_LAYOUT *   Layout,
+                           UINT32                       FirstMember,
+                           UINT32                       NumberOfMembers,
+                           UINT32                       ParentOffset,
+                           UINT32                       Depth,
+                           const UINT8 *                Buffer,
+                           DEBUGGER_DT_INLINE_EXPANSION InlineExpansion)
+{
+    SIZE_T NameWidth = 0;
+
+    //
+    // Align the values of the members
+    //
+    for (UINT32 i = FirstMember; i < FirstMember + NumberOfMembers; i++)
+    {
+        SIZE_T NameLength = strlen(Layout->Names + Layout->Members[i].Name);
+
+        if (NameLength > NameWidth)
+        {
+            NameWidth = NameLength;
+        }
+    }
+
+    for (UINT32 i = FirstMember; i < FirstMember + NumberOfMembers; i++)
+    {
+        const SYMBOL_TYPE_LAYOUT_MEMBER * Member   = &Layout->Members[i];
+        const CHAR *                      TypeName = Layout->Names + Member->TypeName;
+        UINT64                            Value;
+
+        ShowMessages("%*s+0x%03x %-*s : ",
+                     (int)(Depth + 1) * 3,
+                     "",
+                     Member->Offset - ParentOffset,
+                     (int)NameWidth,
+                     Layout->Names + Member->Name);
+
+        if ((UINT64)Member->Offset + Member->Size > Layout->TypeSize)
+        {
+            ShowMessages("%s\n", TypeName);
+            continue;
+        }
+
+        if (Member->BitLength != 0)
+        {
+            Value = CommandDtReadLayoutValue(Member, Buffer);
+
+            ShowMessages("0y");
+
+            for (INT32 Bit = Member->BitLength - 1; Bit >= 0; Bit--)
+            {
+                ShowMessages("%d", (UINT32)((Value >> Bit) & 1));
+            }
+
+            ShowMessages("\n");
+            continue;
+        }
+
+        switch (Member->Kind)
+        {
+        case SYMBOL_TYPE_LAYOUT_KIND_INTEGER:
+
+            Value = CommandDtReadLayoutValue(Member, Buffer);
+
+            if (Member->IsSigned)
+            {
+                ShowMessages("0n%lld\n", (INT64)Value);
+            }
+            else
+            {
+                ShowMessages("0x%llx\n", Value);
+            }
+
+            break;
+
+        case SYMBOL_TYPE_LAYOUT_KIND_FLOAT:
+
+            if (Member->Size == sizeof(float))
+            {
+                float FloatValue;
+                memcpy(&FloatValue, Buffer + Member->Offset, sizeof(float));
+                ShowMessages("%g\n", FloatValue);
+            }
+            else
+            {
+                double DoubleValue;
+                memcpy(&DoubleValue, Buffer + Member->Offset, sizeof(double));
+                ShowMessages("%g\n", DoubleValue);
+            }
+
+            break;
+
+        case SYMBOL_TYPE_LAYOUT_KIND_POINTER:
+
+            Value = CommandDtReadLayoutValue(Member, Buffer);
+
+            ShowMessages("0x%s %s\n", SeparateTo64BitValue(Value).c_str(), TypeName);
+
+            break;
+
+        case SYMBOL_TYPE_LAYOUT_KIND_ENUM:
+
+            Value = CommandDtReadLayoutValue(Member, Buffer);
+
+            ShowMessages("0x%llx", Value);
+
+            for (UINT32 j = Member->FirstEnumerator; j < Member->FirstEnumerator + Member->NumberOfEnumerators; j++)
+            {
+                if (Layout->Enumerators[j].Value == Value)
+                {
+                    ShowMessages(" ( %s )", Layout->Names + Layout->Enumerators[j].Name);
+                    break;
+                }
+            }
+
+            ShowMessages("\n");
+
+            break;
+
+        case SYMBOL_TYPE_LAYOUT_KIND_ARRAY:
+
+            //
+            // Show the arrays of characters as strings
+            //
+            if (Member->ElementKind == SYMBOL_TYPE_LAYOUT_KIND_INTEGER && Member->ElementSize == 1)
+            {
+                ShowMessages("%s \"", TypeName);
+
+                for (UINT32 j = 0; j < Member->Size && Buffer[Member->Offset + j] != '\0'; j++)
+                {
+                    CHAR Character = Buffer[Member->Offset + j];
+                    ShowMessages("%c", isprint((UCHAR)Character) ? Character : '.');
+                }
+
+                ShowMessages("\"\n");
+            }
+            else
+            {
+                ShowMessages("%s\n", TypeName);
+            }
+
+            break;
+
+        case SYMBOL_TYPE_LAYOUT_KIND_UDT:
+
+            ShowMessages("%s\n", TypeName);
+
+            if (InlineExpansion == DEBUGGER_DT_INLINE_EXPANSION_ALL ||
+                (InlineExpansion == DEBUGGER_DT_INLINE_EXPANSION_UNNAMED && Member->IsUnnamed))
+            {
+                CommandDtShowLayoutMembers(Layout,
+                                           Member->FirstChild,
+                                           Member->NumberOfChildren,
+                                           Member->Offset,
+                                           Depth + 1,
+                                           Buffer,
+                                           InlineExpansion);
+            }
+
+            break;
+
+        default:
+
+            ShowMessages("%s\n", TypeName);
+
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Show the data of a structure from its compiled layout
+ * @details The whole structure is read once, then the members are formatted
+ * from the layout without querying the symbols again
+ *
+ * @param DtDetails
+ * @param Buffer
+ * @param BufferLength
+ *
+ * @return BOOLEAN FALSE if the data should be shown by pdbex (the layout is
+ * not available or the options are not supported by the layout)
+ */
+BOOLEAN
+CommandDtShowDataBasedOnTypeLayout(PDEBUGGER_DT_COMMAND_OPTIONS DtDetails, PVOID Buffer, UINT32 BufferLength)
+{
+    const SYMBOL_TYPE_LAYOUT *   Layout;
+    DEBUGGER_DT_INLINE_EXPANSION InlineExpansion;
+
+    //
+    // The layout only supports the expansion options, other options
+    // are shown by pdbex
+    //
+    if (DtDetails->TypeName == NULL ||
+        !CommandDtGetInlineExpansion(DtDetails->AdditionalParameters, &InlineExpansion))
+    {
+        return FALSE;
+    }
+
+    //
+    // Get the layout of the type (it's compiled once and cached by the
+    // symbol parser)
+    //
+    Layout = ScriptEngineGetTypeLayoutWrapper(DtDetails->TypeName);
+
+    if (Layout == NULL || Layout->TypeSize == 0 || Layout->TypeSize > BufferLength)
+    {
+        return FALSE;
+    }
+
+    CommandDtShowLayoutMembers(Layout,
+                               0,
+                               Layout->NumberOfTopLevelMembers,
+                               0,
+                               0,
+                               (const UINT8 *)Buffer,
+                               InlineExpansion);
+
+    return TRUE;
+}
+
 /**
  * @brief Show data based on the symbol structure and data types
  *
@@ -322,9 +642,9 @@ CommandDtShowDataBasedOnSymbolTypes(
     BOOLEAN      IsPhysicalAddress,
     const CHAR * AdditionalParameters)
 {
-    UINT64                      StructureSize       = 0;
-    BOOLEAN                     ResultOfFindingSize = FALSE;
-    DEBUGGER_DT_COMMAND_OPTIONS DtOptions           = {0};
+    UINT64                      StructureSize = 0;
+    const SYMBOL_TYPE_LAYOUT *  Layout        = NULL;
+    DEBUGGER_DT_COMMAND_OPTIONS DtOptions     = {0};
 
     //
     // Check for pid
@@ -374,14 +694,15 @@ CommandDtShowDataBasedOnSymbolTypes(
         //
 
         //
-        // Get the field size
+        // Get the layout of the type (it's compiled once and cached by the
+        // symbol parser)
         //
-        ResultOfFindingSize = ScriptEngineGetDataTypeSizeWrapper((char *)TypeName, &StructureSize);
+        Layout = ScriptEngineGetTypeLayoutWrapper(TypeName);
 
         //
         // Check if size is found
         //
-        if (!ResultOfFindingSize || StructureSize == 0)
+        if (Layout == NULL || Layout->TypeSize == 0)
         {
             //
             // Field not found or size is invalid
@@ -390,6 +711,8 @@ CommandDtShowDataBasedOnSymbolTypes(
             return FALSE;
         }
 
+        StructureSize = Layout->TypeSize;
+
         //
         // Set the type (structure) size
         //
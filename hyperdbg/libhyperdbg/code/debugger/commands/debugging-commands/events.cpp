@@ -37,13 +37,20 @@ CommandEventsHelp()
     ShowMessages("syntax : \tevents\n");
     ShowMessages("syntax : \tevents [e|d|c all|EventNumber (hex)]\n");
     ShowMessages("syntax : \tevents [sc State (on|off)]\n");
+    ShowMessages("syntax : \tevents [begin|commit|abort]\n");
+    ShowMessages("syntax : \tevents [load FilePath (string)] [Args (string)]\n");
 
     ShowMessages("e : enable\n");
     ShowMessages("d : disable\n");
     ShowMessages("c : clear\n");
+    ShowMessages("begin : record the next events into an event set (instead of applying them one by one)\n");
+    ShowMessages("commit : apply all of the events of the event set at once\n");
+    ShowMessages("abort : discard the events of the event set\n");
+    ShowMessages("load : run the commands of a script file and apply all of its events as an event set\n");
 
     ShowMessages("note : If you specify 'all' then e, d, or c will be applied to "
-                 "all of the events.\n\n");
+                 "all of the events.\n");
+    ShowMessages("note : the events of an event set are either all applied or none of them are applied.\n\n");
 
     ShowMessages("\n");
     ShowMessages("\te.g : events \n");
@@ -53,6 +60,79 @@ CommandEventsHelp()
     ShowMessages("\te.g : events c all\n");
     ShowMessages("\te.g : events sc on\n");
     ShowMessages("\te.g : events sc off\n");
+    ShowMessages("\te.g : events begin\n");
+    ShowMessages("\te.g : events commit\n");
+    ShowMessages("\te.g : events load c:\\scripts\\profile.ds\n");
+}
+
+/**
+ * @brief Handle the event set requests of the events command
+ *
+ * @param CommandTokens
+ *
+ * @return BOOLEAN TRUE if the command is an event set request
+ */
+static BOOLEAN
+CommandEventsHandleEventSet(vector<CommandToken> CommandTokens)
+{
+    vector<string> PathAndArgs;
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "begin") && CommandTokens.size() == 2)
+    {
+        if (!EventSetBegin())
+        {
+            ShowMessages("err, an event set is already started, use 'events commit' or 'events abort' first\n");
+        }
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "commit") && CommandTokens.size() == 2)
+    {
+        EventSetCommit();
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "abort") && CommandTokens.size() == 2)
+    {
+        if (!EventSetIsRecording())
+        {
+            ShowMessages("err, there is no event set to abort\n");
+        }
+        else
+        {
+            EventSetAbort();
+        }
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "load") && CommandTokens.size() >= 3)
+    {
+        //
+        // Add the path and the arguments
+        //
+        for (SIZE_T i = 2; i < CommandTokens.size(); i++)
+        {
+            PathAndArgs.push_back(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)));
+        }
+
+        if (!EventSetBegin())
+        {
+            ShowMessages("err, an event set is already started, use 'events commit' or 'events abort' first\n");
+            return TRUE;
+        }
+
+        //
+        // The events of the script are applied once the whole script is executed
+        //
+        if (HyperDbgScriptReadFileAndExecuteCommand(PathAndArgs))
+        {
+            EventSetCommit();
+        }
+        else
+        {
+            EventSetAbort();
+        }
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
 }
 
 /**
@@ -69,6 +149,14 @@ CommandEvents(vector<CommandToken> CommandTokens, string Command)
     DEBUGGER_MODIFY_EVENTS_TYPE RequestedAction;
     UINT64                      RequestedTag;
 
+    //
+    // Check for the event set requests
+    //
+    if (CommandTokens.size() >= 2 && CommandEventsHandleEventSet(CommandTokens))
+    {
+        return;
+    }
+
     //
     // Validate the parameters (size)
     //
@@ -42,6 +42,9 @@ CommandIHelp()
     ShowMessages("\t\te.g : i\n");
     ShowMessages("\t\te.g : ir\n");
     ShowMessages("\t\te.g : ir 1f\n");
+
+    ShowMessages("\nnote : in the Debugger Mode, the debuggee steps the instructions of 'i [Count]' by itself "
+                 "and sends back the records of the steps in chunks.\n");
 }
 
 /**
@@ -104,39 +107,50 @@ CommandI(vector<CommandToken> CommandTokens, string Command)
         //
         g_IsInstrumentingInstructions = TRUE;
 
-        for (SIZE_T i = 0; i < StepCount; i++)
+        if (StepCount > 1)
         {
             //
-            // For logging purpose
-            //
-            // ShowMessages("percentage : %f %% (%x)\n", 100.0 * (i /
-            //   (float)StepCount), i);
-            //
-
-            //
-            // It's stepping over serial connection in kernel debugger
+            // The debuggee performs the steps by itself and sends back the
+            // records of the steps in chunks (instead of a round trip per step)
             //
-            SteppingInstrumentationStepIn();
-
-            if (CompareLowerCaseStrings(CommandTokens.at(0), "ir"))
+            SteppingBatchedInstrumentationStepInAndShow(StepCount, CompareLowerCaseStrings(CommandTokens.at(0), "ir"));
+        }
+        else
+        {
+            for (SIZE_T i = 0; i < StepCount; i++)
             {
                 //
-                // Show registers
+                // For logging purpose
+                //
+                // ShowMessages("percentage : %f %% (%x)\n", 100.0 * (i /
+                //   (float)StepCount), i);
                 //
-                HyperDbgRegisterShowAll();
 
-                if (i != StepCount - 1)
+                //
+                // It's stepping over serial connection in kernel debugger
+                //
+                SteppingInstrumentationStepIn();
+
+                if (CompareLowerCaseStrings(CommandTokens.at(0), "ir"))
                 {
-                    ShowMessages("\n");
+                    //
+                    // Show registers
+                    //
+                    HyperDbgRegisterShowAll();
+
+                    if (i != StepCount - 1)
+                    {
+                        ShowMessages("\n");
+                    }
                 }
-            }
 
-            //
-            // Check if user pressed CTRL+C
-            //
-            if (!g_IsInstrumentingInstructions)
-            {
-                break;
+                //
+                // Check if user pressed CTRL+C
+                //
+                if (!g_IsInstrumentingInstructions)
+                {
+                    break;
+                }
             }
         }
 
@@ -42,6 +42,9 @@ CommandKHelp()
     ShowMessages("\t\te.g : kq base fffff8077356f010\n");
     ShowMessages("\t\te.g : kq base @rbx-10\n");
     ShowMessages("\t\te.g : kq base fffff8077356f010 l 100\n");
+
+    ShowMessages("\nnote : 'k' walks x64 frames by using the unwind data (.pdata) of the loaded modules "
+                 "and only scans the stack for call sites where no unwind data is available.\n");
 }
 
 /**
@@ -159,6 +162,16 @@ CommandK(vector<CommandToken> CommandTokens, string Command)
 
     if (CompareLowerCaseStrings(CommandTokens.at(0), "k"))
     {
+        //
+        // For x64 frames of the current thread, the unwind tables of the
+        // modules are used and only if the current instruction has no unwind
+        // data, the entire stack is scanned heuristically
+        //
+        if (BaseAddress == NULL && !g_IsRunningInstruction32Bit && CallstackUnwindAndShowFrames(Length))
+        {
+            return;
+        }
+
         KdSendCallStackPacketToDebuggee(BaseAddress,
                                         Length,
                                         DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS,
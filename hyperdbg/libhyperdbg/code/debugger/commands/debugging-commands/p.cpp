@@ -39,6 +39,9 @@ CommandPHelp()
     ShowMessages("\t\te.g : p\n");
     ShowMessages("\t\te.g : pr\n");
     ShowMessages("\t\te.g : pr 1f\n");
+
+    ShowMessages("\nnote : each instruction of 'p [Count]' is a separate step (a round trip to the debuggee), "
+                 "only 'i [Count]' and '!track' are stepped in batches on the debuggee.\n");
 }
 
 /**
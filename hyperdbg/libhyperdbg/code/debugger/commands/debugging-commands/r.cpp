@@ -346,26 +346,22 @@ HyperDbgWriteTargetRegister(REGS_ENUM RegisterId, UINT64 Value)
 }
 
 /**
- * @brief handler of r show all registers
+ * @brief Show the values of all registers
+ * @param Regs
+ * @param ExtraRegs
+ * @param ShowSegmentRegisters Whether the segment registers are valid (and shown) or not
  *
- * @return BOOLEAN
+ * @return VOID
  */
-BOOLEAN
-HyperDbgRegisterShowAll()
+VOID
+HyperDbgRegisterShowValues(GUEST_REGS * Regs, GUEST_EXTRA_REGISTERS * ExtraRegs, BOOLEAN ShowSegmentRegisters)
 {
-    GUEST_REGS            Regs      = {0};
-    GUEST_EXTRA_REGISTERS ExtraRegs = {0};
-    RFLAGS                Rflags    = {0};
-
-    if (!HyperDbgReadAllRegisters(&Regs, &ExtraRegs))
-    {
-        return FALSE;
-    }
+    RFLAGS Rflags = {0};
 
     //
     // Show the result of reading registers like rax=0000000000018b01
     //
-    Rflags.AsUInt = ExtraRegs.RFLAGS;
+    Rflags.AsUInt = ExtraRegs->RFLAGS;
 
     ShowMessages(
         "RAX=%016llx RBX=%016llx RCX=%016llx\n"
@@ -374,26 +370,24 @@ HyperDbgRegisterShowAll()
         "R8 =%016llx R9 =%016llx R10=%016llx\n"
         "R11=%016llx R12=%016llx R13=%016llx\n"
         "R14=%016llx R15=%016llx IOPL=%02x\n"
-        "%s  %s  %s  %s\n%s  %s  %s  %s\n"
-        "CS %04x SS %04x DS %04x ES %04x FS %04x GS %04x\n"
-        "RFLAGS=%016llx\n",
-        Regs.rax,
-        Regs.rbx,
-        Regs.rcx,
-        Regs.rdx,
-        Regs.rsi,
-        Regs.rdi,
-        ExtraRegs.RIP,
-        Regs.rsp,
-        Regs.rbp,
-        Regs.r8,
-        Regs.r9,
-        Regs.r10,
-        Regs.r11,
-        Regs.r12,
-        Regs.r13,
-        Regs.r14,
-        Regs.r15,
+        "%s  %s  %s  %s\n%s  %s  %s  %s\n",
+        Regs->rax,
+        Regs->rbx,
+        Regs->rcx,
+        Regs->rdx,
+        Regs->rsi,
+        Regs->rdi,
+        ExtraRegs->RIP,
+        Regs->rsp,
+        Regs->rbp,
+        Regs->r8,
+        Regs->r9,
+        Regs->r10,
+        Regs->r11,
+        Regs->r12,
+        Regs->r13,
+        Regs->r14,
+        Regs->r15,
         Rflags.IoPrivilegeLevel,
         Rflags.OverflowFlag ? "OF 1" : "OF 0",
         Rflags.DirectionFlag ? "DF 1" : "DF 0",
@@ -402,14 +396,39 @@ HyperDbgRegisterShowAll()
         Rflags.ZeroFlag ? "ZF 1" : "ZF 0",
         Rflags.ParityFlag ? "PF 1" : "PF 0",
         Rflags.CarryFlag ? "CF 1" : "CF 0",
-        Rflags.AuxiliaryCarryFlag ? "AXF 1" : "AXF 0",
-        ExtraRegs.CS,
-        ExtraRegs.SS,
-        ExtraRegs.DS,
-        ExtraRegs.ES,
-        ExtraRegs.FS,
-        ExtraRegs.GS,
-        ExtraRegs.RFLAGS);
+        Rflags.AuxiliaryCarryFlag ? "AXF 1" : "AXF 0");
+
+    if (ShowSegmentRegisters)
+    {
+        ShowMessages("CS %04x SS %04x DS %04x ES %04x FS %04x GS %04x\n",
+                     ExtraRegs->CS,
+                     ExtraRegs->SS,
+                     ExtraRegs->DS,
+                     ExtraRegs->ES,
+                     ExtraRegs->FS,
+                     ExtraRegs->GS);
+    }
+
+    ShowMessages("RFLAGS=%016llx\n", ExtraRegs->RFLAGS);
+}
+
+/**
+ * @brief handler of r show all registers
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HyperDbgRegisterShowAll()
+{
+    GUEST_REGS            Regs      = {0};
+    GUEST_EXTRA_REGISTERS ExtraRegs = {0};
+
+    if (!HyperDbgReadAllRegisters(&Regs, &ExtraRegs))
+    {
+        return FALSE;
+    }
+
+    HyperDbgRegisterShowValues(&Regs, &ExtraRegs, TRUE);
 
     return TRUE;
 }
@@ -17,6 +17,8 @@
 extern BOOLEAN g_AutoUnpause;
 extern BOOLEAN g_AutoFlush;
 extern BOOLEAN g_AddressConversion;
+extern BOOLEAN g_HwdbgScriptOptimizer;
+extern BOOLEAN g_HwdbgScriptSimulator;
 extern BOOLEAN g_IsConnectedToRemoteDebuggee;
 extern UINT32  g_DisassemblerSyntax;
 
@@ -47,6 +49,10 @@ CommandSettingsHelp()
     ShowMessages("\t\te.g : settings syntax intel\n");
     ShowMessages("\t\te.g : settings syntax att\n");
     ShowMessages("\t\te.g : settings syntax masm\n");
+    ShowMessages("\t\te.g : settings hwdbgoptimizer on\n");
+    ShowMessages("\t\te.g : settings hwdbgoptimizer off\n");
+    ShowMessages("\t\te.g : settings hwdbgsimulator on\n");
+    ShowMessages("\t\te.g : settings hwdbgsimulator off\n");
 }
 
 /**
@@ -261,6 +267,50 @@ CommandSettingsLoadDefaultValuesFromConfigFile()
             ShowMessages("err, incorrect address conversion settings\n");
         }
     }
+
+    //
+    // Set the optimizer of the hwdbg scripts
+    //
+    if (CommandSettingsGetValueFromConfigFile("HwdbgOptimizer", OptionValue))
+    {
+        if (!OptionValue.compare("on"))
+        {
+            g_HwdbgScriptOptimizer = TRUE;
+        }
+        else if (!OptionValue.compare("off"))
+        {
+            g_HwdbgScriptOptimizer = FALSE;
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("err, incorrect hwdbg optimizer settings\n");
+        }
+    }
+
+    //
+    // Set the simulator of the hwdbg scripts
+    //
+    if (CommandSettingsGetValueFromConfigFile("HwdbgSimulator", OptionValue))
+    {
+        if (!OptionValue.compare("on"))
+        {
+            g_HwdbgScriptSimulator = TRUE;
+        }
+        else if (!OptionValue.compare("off"))
+        {
+            g_HwdbgScriptSimulator = FALSE;
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("err, incorrect hwdbg simulator settings\n");
+        }
+    }
 }
 
 /**
@@ -396,6 +446,138 @@ CommandSettingsAutoFlush(vector<CommandToken> CommandTokens)
     }
 }
 
+/**
+ * @brief set the optimizer of the hwdbg scripts to enabled and disabled
+ * and query the status of this mode
+ *
+ * @param CommandTokens
+ * @return VOID
+ */
+VOID
+CommandSettingsHwdbgOptimizer(vector<CommandToken> CommandTokens)
+{
+    if (CommandTokens.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (g_HwdbgScriptOptimizer)
+        {
+            ShowMessages("hwdbg optimizer is enabled\n");
+        }
+        else
+        {
+            ShowMessages("hwdbg optimizer is disabled\n");
+        }
+    }
+    else if (CommandTokens.size() == 3)
+    {
+        //
+        // The user tries to set a value as the hwdbg optimizer
+        //
+        if (CompareLowerCaseStrings(CommandTokens.at(2), "on"))
+        {
+            g_HwdbgScriptOptimizer = TRUE;
+            CommandSettingsSetValueFromConfigFile("HwdbgOptimizer", "on");
+
+            ShowMessages("set hwdbg optimizer to enabled\n");
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(2), "off"))
+        {
+            g_HwdbgScriptOptimizer = FALSE;
+            CommandSettingsSetValueFromConfigFile("HwdbgOptimizer", "off");
+
+            ShowMessages("set hwdbg optimizer to disabled\n");
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+            return;
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        return;
+    }
+}
+
+/**
+ * @brief set the simulator of the hwdbg scripts to enabled and disabled
+ * and query the status of this mode
+ *
+ * @param CommandTokens
+ * @return VOID
+ */
+VOID
+CommandSettingsHwdbgSimulator(vector<CommandToken> CommandTokens)
+{
+    if (CommandTokens.size() == 2)
+    {
+        //
+        // It's a query
+        //
+        if (g_HwdbgScriptSimulator)
+        {
+            ShowMessages("hwdbg simulator is enabled\n");
+        }
+        else
+        {
+            ShowMessages("hwdbg simulator is disabled\n");
+        }
+    }
+    else if (CommandTokens.size() == 3)
+    {
+        //
+        // The user tries to set a value as the hwdbg simulator
+        //
+        if (CompareLowerCaseStrings(CommandTokens.at(2), "on"))
+        {
+            g_HwdbgScriptSimulator = TRUE;
+            CommandSettingsSetValueFromConfigFile("HwdbgSimulator", "on");
+
+            ShowMessages("set hwdbg simulator to enabled\n");
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(2), "off"))
+        {
+            g_HwdbgScriptSimulator = FALSE;
+            CommandSettingsSetValueFromConfigFile("HwdbgSimulator", "off");
+
+            ShowMessages("set hwdbg simulator to disabled\n");
+        }
+        else
+        {
+            //
+            // Sth is incorrect
+            //
+            ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+            return;
+        }
+    }
+    else
+    {
+        //
+        // Sth is incorrect
+        //
+        ShowMessages("incorrect use of the '%s', please use 'help %s' for more information\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str(),
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        return;
+    }
+}
+
 /**
  * @brief set auto-unpause mode to enabled or disabled
  *
@@ -624,6 +806,20 @@ CommandSettings(vector<CommandToken> CommandTokens, string Command)
             CommandSettingsAddressConversion(CommandTokens);
         }
     }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "hwdbgoptimizer"))
+    {
+        //
+        // The hwdbg scripts are created locally, so it's handled locally
+        //
+        CommandSettingsHwdbgOptimizer(CommandTokens);
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "hwdbgsimulator"))
+    {
+        //
+        // The hwdbg scripts are simulated locally, so it's handled locally
+        //
+        CommandSettingsHwdbgSimulator(CommandTokens);
+    }
     else
     {
         //
@@ -39,6 +39,9 @@ CommandTHelp()
     ShowMessages("\t\te.g : t\n");
     ShowMessages("\t\te.g : tr\n");
     ShowMessages("\t\te.g : tr 1f\n");
+
+    ShowMessages("\nnote : each instruction of 't [Count]' is a separate step (a round trip to the debuggee), "
+                 "only 'i [Count]' and '!track' are stepped in batches on the debuggee.\n");
 }
 
 /**
@@ -0,0 +1,409 @@
+/**
+ * @file dirty.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !dirty command
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsKdModuleLoaded;
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+
+/**
+ * @brief Count of pages that are read and written at once while saving snapshots
+ *
+ */
+#define DIRTY_SNAPSHOT_BUFFER_PAGES 16
+
+/**
+ * @brief help of the !dirty command
+ *
+ * @return VOID
+ */
+VOID
+CommandDirtyHelp()
+{
+    ShowMessages("!dirty : tracks the physical pages that are modified by the guest using page-modification logging (PML) "
+                 "and saves incremental snapshots of them.\n");
+    ShowMessages("Note : 'query' shows the pages that are dirtied since the last reset, 'reset' starts a new epoch, and "
+                 "'snapshot' saves the content of the dirty pages since the last reset (and starts a new epoch).\n");
+    ShowMessages("Note : a snapshot is applied over the image of the previous snapshot (the first one is a full dump of the "
+                 "physical memory, e.g., using '!dump'), pause the debuggee to get consistent snapshots.\n\n");
+
+    ShowMessages("syntax : \t!dirty [Function (string)]\n");
+    ShowMessages("syntax : \t!dirty [snapshot] [path Path (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !dirty enable\n");
+    ShowMessages("\t\te.g : !dirty query\n");
+    ShowMessages("\t\te.g : !dirty reset\n");
+    ShowMessages("\t\te.g : !dirty snapshot path c:\\snapshots\\epoch1.bin\n");
+    ShowMessages("\t\te.g : !dirty disable\n");
+}
+
+/**
+ * @brief Send dirty logging requests
+ *
+ * @param DirtyLoggingRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDirtySendRequest(DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    AssertShowMessageReturnStmt(g_IsKdModuleLoaded, g_DeviceHandle, ASSERT_MESSAGE_KD_NOT_LOADED, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    //
+    // Send IOCTL
+    //
+    Status = PlatformDeviceIoControl(
+        g_DeviceHandle,                         // Handle to device
+        IOCTL_PERFORM_DIRTY_LOGGING_OPERATION,  // IO Control Code (IOCTL)
+        DirtyLoggingRequest,                    // Input Buffer to driver.
+        SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS, // Input buffer length
+        DirtyLoggingRequest,                    // Output Buffer from driver.
+        SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS, // Length of output buffer in bytes.
+        &ReturnedLength,                        // Bytes placed in buffer.
+        NULL                                    // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+
+        return FALSE;
+    }
+
+    if (DirtyLoggingRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return TRUE;
+    }
+    else
+    {
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Fetch the dirty bits of all of the physical pages (range by range)
+ *
+ * @param Reset Whether to start a new epoch
+ * @param Bits The bits of all of the pages
+ * @param NumberOfPages Count of the physical pages
+ * @param Epoch The epoch after fetching the bits
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandDirtyFetchBitmap(BOOLEAN Reset, std::vector<UINT64> & Bits, UINT64 * NumberOfPages, UINT64 * Epoch)
+{
+    DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest;
+    UINT64                            FirstPage = 0;
+
+    //
+    // The packet has the bits of a range, so it's not kept on the stack
+    //
+    DirtyLoggingRequest = (DIRTY_LOGGING_OPERATION_PACKETS *)malloc(SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS);
+
+    if (DirtyLoggingRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the dirty bitmap\n");
+        return FALSE;
+    }
+
+    do
+    {
+        PlatformZeroMemory(DirtyLoggingRequest, SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS);
+
+        DirtyLoggingRequest->DirtyLoggingOperationType = DIRTY_LOGGING_OPERATION_REQUEST_TYPE_QUERY;
+        DirtyLoggingRequest->FirstPage                 = FirstPage;
+        DirtyLoggingRequest->ResetBitmap               = Reset;
+
+        if (!CommandDirtySendRequest(DirtyLoggingRequest))
+        {
+            ShowErrorMessage(DirtyLoggingRequest->KernelStatus);
+            free(DirtyLoggingRequest);
+            return FALSE;
+        }
+
+        if (FirstPage == 0)
+        {
+            Bits.assign(DIRTY_BITMAP_WORDS(DirtyLoggingRequest->NumberOfPages), 0);
+        }
+
+        memcpy(&Bits[FirstPage / 64],
+               DirtyLoggingRequest->Bitmap,
+               DIRTY_BITMAP_WORDS(DirtyLoggingRequest->FetchedPages) * sizeof(UINT64));
+
+        FirstPage += DirtyLoggingRequest->FetchedPages;
+
+    } while (FirstPage < DirtyLoggingRequest->NumberOfPages);
+
+    *NumberOfPages = DirtyLoggingRequest->NumberOfPages;
+    *Epoch         = DirtyLoggingRequest->Epoch;
+
+    if (DirtyLoggingRequest->DroppedEntries != 0)
+    {
+        ShowMessages("warning, %llx logged addresses are beyond the physical memory and are not tracked\n",
+                     DirtyLoggingRequest->DroppedEntries);
+    }
+
+    free(DirtyLoggingRequest);
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the content of the dirty pages for the snapshot
+ *
+ * @param Context
+ * @param FirstPage
+ * @param NumberOfPages
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CommandDirtySnapshotReadPages(PVOID Context, UINT64 FirstPage, UINT32 NumberOfPages, PVOID Buffer)
+{
+    UINT32                            ReturnLength;
+    DEBUGGER_READ_MEMORY_ADDRESS_MODE AddressMode;
+
+    UNREFERENCED_PARAMETER(Context);
+
+    for (UINT32 i = 0; i < NumberOfPages; i++)
+    {
+        if (!HyperDbgReadMemory((FirstPage + i) << DIRTY_BITMAP_PAGE_SHIFT,
+                                DEBUGGER_READ_PHYSICAL_ADDRESS,
+                                READ_FROM_KERNEL,
+                                0,
+                                PAGE_SIZE,
+                                FALSE,
+                                &AddressMode,
+                                (BYTE *)Buffer + (SIZE_T)i * PAGE_SIZE,
+                                &ReturnLength))
+        {
+            ShowMessages("err, unable to read the physical page at %llx\n", (FirstPage + i) << DIRTY_BITMAP_PAGE_SHIFT);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Write a part of the snapshot into the file
+ *
+ * @param Context
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CommandDirtySnapshotWrite(PVOID Context, const VOID * Buffer, UINT64 Size)
+{
+    if (!PlatformWriteFile((HANDLE)Context, Buffer, (DWORD)Size))
+    {
+        ShowMessages("err, unable to write buffer into the snapshot\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the dirty pages since the last reset into a file
+ *
+ * @param Filepath
+ *
+ * @return VOID
+ */
+VOID
+CommandDirtySaveSnapshot(std::wstring & Filepath)
+{
+    std::vector<UINT64> Bits;
+    UINT64              NumberOfPages;
+    UINT64              Epoch;
+    HANDLE              SnapshotFileHandle;
+    BYTE *              Buffer;
+    BOOLEAN             Result;
+
+    //
+    // Fetch the dirty pages and start a new epoch
+    //
+    if (!CommandDirtyFetchBitmap(TRUE, Bits, &NumberOfPages, &Epoch))
+    {
+        return;
+    }
+
+    Buffer = (BYTE *)malloc(DIRTY_SNAPSHOT_BUFFER_PAGES * PAGE_SIZE);
+
+    if (Buffer == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the snapshot\n");
+        return;
+    }
+
+    //
+    // Create or open the file for writing the snapshot (see the TEMPORARY
+    // LINUX SHIM in dump.cpp for the cast)
+    //
+#ifdef __linux__
+    SnapshotFileHandle = PlatformOpenFileForWriting((const WCHAR *)Filepath.c_str());
+#else
+    SnapshotFileHandle = PlatformOpenFileForWriting(Filepath.c_str());
+#endif
+
+    if (SnapshotFileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create or open the file\n");
+        free(Buffer);
+        return;
+    }
+
+    Result = DirtyBitmapWriteDelta(Bits.data(),
+                                   NumberOfPages,
+                                   Epoch,
+                                   Buffer,
+                                   DIRTY_SNAPSHOT_BUFFER_PAGES,
+                                   CommandDirtySnapshotReadPages,
+                                   CommandDirtySnapshotWrite,
+                                   SnapshotFileHandle);
+
+    PlatformCloseFile(SnapshotFileHandle);
+    free(Buffer);
+
+    if (Result)
+    {
+        ShowMessages("%llx dirty pages (of %llx pages) of the epoch %llx are saved at: %ls\n",
+                     DirtyBitmapCountPages(Bits.data(), NumberOfPages),
+                     NumberOfPages,
+                     Epoch,
+                     Filepath.c_str());
+    }
+}
+
+/**
+ * @brief !dirty command handler
+ *
+ * @param CommandTokens
+ * @param Command
+ *
+ * @return VOID
+ */
+VOID
+CommandDirty(vector<CommandToken> CommandTokens, string Command)
+{
+    DIRTY_LOGGING_OPERATION_PACKETS * DirtyLoggingRequest;
+    std::vector<UINT64>               Bits;
+    std::wstring                      Filepath;
+    UINT64                            NumberOfPages;
+    UINT64                            Epoch;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        //
+        // The bitmap is fetched by broadcasting to all of the cores, which is
+        // not possible while the debuggee is halted
+        //
+        ShowMessages("err, dirty logging is only available in local (VMI) mode\n");
+        return;
+    }
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "snapshot") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "path"))
+    {
+        //
+        // Convert path to wstring
+        //
+        StringToWString(Filepath, GetCaseSensitiveStringFromCommandToken(CommandTokens.at(3)));
+
+        CommandDirtySaveSnapshot(Filepath);
+        return;
+    }
+
+    if (CommandTokens.size() != 2)
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+
+        CommandDirtyHelp();
+        return;
+    }
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "query") || CompareLowerCaseStrings(CommandTokens.at(1), "reset"))
+    {
+        if (CommandDirtyFetchBitmap(CompareLowerCaseStrings(CommandTokens.at(1), "reset"), Bits, &NumberOfPages, &Epoch))
+        {
+            ShowMessages("dirty pages: %llx (of %llx pages), epoch: %llx\n",
+                         DirtyBitmapCountPages(Bits.data(), NumberOfPages),
+                         NumberOfPages,
+                         Epoch);
+        }
+
+        return;
+    }
+
+    //
+    // The packet has the bits of a range, so it's not kept on the stack
+    //
+    DirtyLoggingRequest = (DIRTY_LOGGING_OPERATION_PACKETS *)malloc(SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS);
+
+    if (DirtyLoggingRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the dirty bitmap\n");
+        return;
+    }
+
+    PlatformZeroMemory(DirtyLoggingRequest, SIZEOF_DIRTY_LOGGING_OPERATION_PACKETS);
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "enable"))
+    {
+        DirtyLoggingRequest->DirtyLoggingOperationType = DIRTY_LOGGING_OPERATION_REQUEST_TYPE_ENABLE;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "disable"))
+    {
+        DirtyLoggingRequest->DirtyLoggingOperationType = DIRTY_LOGGING_OPERATION_REQUEST_TYPE_DISABLE;
+    }
+    else
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandDirtyHelp();
+        free(DirtyLoggingRequest);
+        return;
+    }
+
+    //
+    // Send the dirty logging operation request
+    //
+    if (CommandDirtySendRequest(DirtyLoggingRequest))
+    {
+        if (DirtyLoggingRequest->DirtyLoggingOperationType == DIRTY_LOGGING_OPERATION_REQUEST_TYPE_ENABLE)
+        {
+            ShowMessages("dirty logging is enabled for %llx physical pages\n", DirtyLoggingRequest->NumberOfPages);
+        }
+        else
+        {
+            ShowMessages("dirty logging is disabled\n");
+        }
+    }
+    else
+    {
+        ShowErrorMessage(DirtyLoggingRequest->KernelStatus);
+    }
+
+    free(DirtyLoggingRequest);
+}
@@ -0,0 +1,603 @@
+/**
+ * @file exitprof.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !exitprof command
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsKdModuleLoaded;
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+
+/**
+ * @brief help of the !exitprof command
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofHelp()
+{
+    ShowMessages("!exitprof : profiles the count and the latency (TSC cycles) of the vm-exits for each exit reason, "
+                 "including the time that is spent on the triggered events and scripts.\n");
+    ShowMessages("Note : 'query' shows the statistics of all of the cores (or a single core) since the last reset, "
+                 "'sample' shows the statistics of each interval, 'dump' saves the statistics of the cores into a file "
+                 "and 'load' shows the statistics of a saved file (without loading the debugger).\n");
+    ShowMessages("Note : the latencies are the upper bounds of the log2 buckets of the histograms.\n\n");
+
+    ShowMessages("syntax : \t!exitprof [Function (string)]\n");
+    ShowMessages("syntax : \t!exitprof [query] [core CoreId (hex)]\n");
+    ShowMessages("syntax : \t!exitprof [sample] [Interval (hex - milliseconds)] [Count (hex)]\n");
+    ShowMessages("syntax : \t!exitprof [dump] [path Path (string)]\n");
+    ShowMessages("syntax : \t!exitprof [load] [path Path (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !exitprof enable\n");
+    ShowMessages("\t\te.g : !exitprof query\n");
+    ShowMessages("\t\te.g : !exitprof query core 2\n");
+    ShowMessages("\t\te.g : !exitprof sample 3e8 5\n");
+    ShowMessages("\t\te.g : !exitprof reset\n");
+    ShowMessages("\t\te.g : !exitprof dump path c:\\profiles\\exits.bin\n");
+    ShowMessages("\t\te.g : !exitprof load path c:\\profiles\\exits.bin\n");
+    ShowMessages("\t\te.g : !exitprof disable\n");
+}
+
+/**
+ * @brief Send vm-exit profiler requests
+ *
+ * @param ExitProfilerRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandExitprofSendRequest(EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    AssertShowMessageReturnStmt(g_IsKdModuleLoaded, g_DeviceHandle, ASSERT_MESSAGE_KD_NOT_LOADED, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    //
+    // Send IOCTL
+    //
+    Status = PlatformDeviceIoControl(
+        g_DeviceHandle,                         // Handle to device
+        IOCTL_PERFORM_EXIT_PROFILER_OPERATION,  // IO Control Code (IOCTL)
+        ExitProfilerRequest,                    // Input Buffer to driver.
+        SIZEOF_EXIT_PROFILER_OPERATION_PACKETS, // Input buffer length
+        ExitProfilerRequest,                    // Output Buffer from driver.
+        SIZEOF_EXIT_PROFILER_OPERATION_PACKETS, // Length of output buffer in bytes.
+        &ReturnedLength,                        // Bytes placed in buffer.
+        NULL                                    // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+
+        return FALSE;
+    }
+
+    if (ExitProfilerRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return TRUE;
+    }
+    else
+    {
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Fetch the statistics of all of the cores
+ *
+ * @param Cores The statistics of each core
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandExitprofFetchCores(std::vector<EXIT_PROFILER_STATISTICS> & Cores)
+{
+    EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest;
+    UINT32                            CoreId = 0;
+
+    //
+    // The packet has the histograms of all of the exit reasons, so it's not
+    // kept on the stack
+    //
+    ExitProfilerRequest = (EXIT_PROFILER_OPERATION_PACKETS *)malloc(SIZEOF_EXIT_PROFILER_OPERATION_PACKETS);
+
+    if (ExitProfilerRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the vm-exit statistics\n");
+        return FALSE;
+    }
+
+    Cores.clear();
+
+    do
+    {
+        PlatformZeroMemory(ExitProfilerRequest, SIZEOF_EXIT_PROFILER_OPERATION_PACKETS);
+
+        ExitProfilerRequest->ExitProfilerOperationType = EXIT_PROFILER_OPERATION_REQUEST_TYPE_QUERY;
+        ExitProfilerRequest->CoreId                    = CoreId;
+
+        if (!CommandExitprofSendRequest(ExitProfilerRequest))
+        {
+            ShowErrorMessage(ExitProfilerRequest->KernelStatus);
+            free(ExitProfilerRequest);
+            return FALSE;
+        }
+
+        Cores.push_back(ExitProfilerRequest->Statistics);
+        CoreId++;
+
+    } while (CoreId < ExitProfilerRequest->NumberOfCores);
+
+    free(ExitProfilerRequest);
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the statistics of the exit reasons
+ *
+ * @param Statistics
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofShowStatistics(const EXIT_PROFILER_STATISTICS * Statistics)
+{
+    EXIT_PROFILER_ROW Rows[EXIT_PROFILER_MAXIMUM_EXIT_REASONS];
+    UINT32            NumberOfRows;
+    UINT64            TotalCount = 0;
+
+    NumberOfRows = ExitProfilerBuildRows(Statistics, Rows, EXIT_PROFILER_MAXIMUM_EXIT_REASONS);
+
+    if (NumberOfRows == 0)
+    {
+        ShowMessages("no vm-exit is recorded\n");
+        return;
+    }
+
+    ShowMessages("%-34s %12s %7s %7s %10s %10s %10s %10s %12s %10s\n",
+                 "exit reason",
+                 "count",
+                 "exits%",
+                 "cycles%",
+                 "average",
+                 "median",
+                 "p99",
+                 "events",
+                 "event cycles",
+                 "event p99");
+
+    for (UINT32 i = 0; i < NumberOfRows; i++)
+    {
+        ShowMessages("%-34s %12llu %5u.%u %5u.%u %10llu %10llu %10llu %10llu %12llu %10llu\n",
+                     ExitProfilerGetReasonName(Rows[i].ExitReason),
+                     Rows[i].Count,
+                     Rows[i].CountPermille / 10,
+                     Rows[i].CountPermille % 10,
+                     Rows[i].CyclesPermille / 10,
+                     Rows[i].CyclesPermille % 10,
+                     Rows[i].AverageCycles,
+                     Rows[i].MedianCycles,
+                     Rows[i].P99Cycles,
+                     Rows[i].EventCount,
+                     Rows[i].EventCycles,
+                     Rows[i].EventP99Cycles);
+
+        TotalCount += Rows[i].Count;
+    }
+
+    ShowMessages("total exits: %llu", TotalCount);
+
+    if (Statistics->UnknownExits != 0)
+    {
+        ShowMessages(" (and %llu exits of unknown reasons)", Statistics->UnknownExits);
+    }
+
+    ShowMessages("\n");
+}
+
+/**
+ * @brief Merge the statistics of all of the cores
+ *
+ * @param Cores
+ * @param Total
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofMergeCores(std::vector<EXIT_PROFILER_STATISTICS> & Cores, EXIT_PROFILER_STATISTICS * Total)
+{
+    PlatformZeroMemory(Total, sizeof(EXIT_PROFILER_STATISTICS));
+
+    for (const EXIT_PROFILER_STATISTICS & Core : Cores)
+    {
+        ExitProfilerMerge(Total, &Core);
+    }
+}
+
+/**
+ * @brief Show the statistics of each sampling interval
+ *
+ * @param Interval Milliseconds of each interval
+ * @param Count Count of the intervals
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofSample(UINT32 Interval, UINT32 Count)
+{
+    std::vector<EXIT_PROFILER_STATISTICS> Cores;
+    EXIT_PROFILER_STATISTICS *            Statistics;
+
+    //
+    // The previous, the current, and the delta statistics
+    //
+    Statistics = (EXIT_PROFILER_STATISTICS *)malloc(3 * sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Statistics == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the vm-exit statistics\n");
+        return;
+    }
+
+    if (!CommandExitprofFetchCores(Cores))
+    {
+        free(Statistics);
+        return;
+    }
+
+    CommandExitprofMergeCores(Cores, &Statistics[0]);
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        PlatformSleep(Interval);
+
+        if (!CommandExitprofFetchCores(Cores))
+        {
+            break;
+        }
+
+        CommandExitprofMergeCores(Cores, &Statistics[1]);
+        ExitProfilerDelta(&Statistics[2], &Statistics[1], &Statistics[0]);
+
+        ShowMessages("\ninterval %x (%u ms):\n", i + 1, Interval);
+        CommandExitprofShowStatistics(&Statistics[2]);
+
+        memcpy(&Statistics[0], &Statistics[1], sizeof(EXIT_PROFILER_STATISTICS));
+    }
+
+    free(Statistics);
+}
+
+/**
+ * @brief Write a part of the dump into the file
+ *
+ * @param Context
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CommandExitprofDumpWrite(PVOID Context, const VOID * Buffer, UINT64 Size)
+{
+    if (!PlatformWriteFile((HANDLE)Context, Buffer, (DWORD)Size))
+    {
+        ShowMessages("err, unable to write buffer into the dump\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Save the statistics of all of the cores into a file
+ *
+ * @param Filepath
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofSaveDump(std::wstring & Filepath)
+{
+    std::vector<EXIT_PROFILER_STATISTICS> Cores;
+    HANDLE                                DumpFileHandle;
+    BOOLEAN                               Result;
+
+    if (!CommandExitprofFetchCores(Cores))
+    {
+        return;
+    }
+
+    //
+    // Create or open the file for writing the dump (see the TEMPORARY LINUX
+    // SHIM in dump.cpp for the cast)
+    //
+#ifdef __linux__
+    DumpFileHandle = PlatformOpenFileForWriting((const WCHAR *)Filepath.c_str());
+#else
+    DumpFileHandle = PlatformOpenFileForWriting(Filepath.c_str());
+#endif
+
+    if (DumpFileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create or open the file\n");
+        return;
+    }
+
+    Result = ExitProfilerWriteDump(Cores.data(), (UINT32)Cores.size(), CommandExitprofDumpWrite, DumpFileHandle);
+
+    PlatformCloseFile(DumpFileHandle);
+
+    if (Result)
+    {
+        ShowMessages("the vm-exit statistics of %x cores are saved at: %ls\n", (UINT32)Cores.size(), Filepath.c_str());
+    }
+}
+
+/**
+ * @brief Show the statistics of a saved dump
+ *
+ * @param Filepath
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofLoadDump(std::wstring & Filepath)
+{
+    std::vector<EXIT_PROFILER_STATISTICS> Cores;
+    EXIT_PROFILER_STATISTICS *            Total;
+    HANDLE                                DumpFileHandle = INVALID_HANDLE_VALUE;
+    SIZE_T                                DumpSize       = 0;
+    UINT32                                NumberOfCores  = 0;
+    VOID *                                Dump;
+
+#ifdef __linux__
+    Dump = PlatformMapFileReadOnly((const WCHAR *)Filepath.c_str(), &DumpSize, &DumpFileHandle);
+#else
+    Dump = PlatformMapFileReadOnly(Filepath.c_str(), &DumpSize, &DumpFileHandle);
+#endif
+
+    if (Dump == NULL)
+    {
+        ShowMessages("err, unable to open the file\n");
+        return;
+    }
+
+    if (!ExitProfilerReadDump(Dump, DumpSize, &NumberOfCores, NULL))
+    {
+        ShowMessages("err, the file is not a valid dump of the vm-exit profiler\n");
+        PlatformUnmapFile(Dump, DumpSize, DumpFileHandle);
+        return;
+    }
+
+    Cores.resize(NumberOfCores);
+    ExitProfilerReadDump(Dump, DumpSize, &NumberOfCores, Cores.data());
+
+    PlatformUnmapFile(Dump, DumpSize, DumpFileHandle);
+
+    Total = (EXIT_PROFILER_STATISTICS *)malloc(sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Total == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the vm-exit statistics\n");
+        return;
+    }
+
+    CommandExitprofMergeCores(Cores, Total);
+
+    ShowMessages("vm-exit statistics of %x cores:\n", NumberOfCores);
+    CommandExitprofShowStatistics(Total);
+
+    free(Total);
+}
+
+/**
+ * @brief Show the statistics of all of the cores (or a single core)
+ *
+ * @param IsSingleCore
+ * @param CoreId
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprofQuery(BOOLEAN IsSingleCore, UINT32 CoreId)
+{
+    std::vector<EXIT_PROFILER_STATISTICS> Cores;
+    EXIT_PROFILER_STATISTICS *            Total;
+
+    if (!CommandExitprofFetchCores(Cores))
+    {
+        return;
+    }
+
+    if (IsSingleCore && CoreId >= Cores.size())
+    {
+        ShowMessages("err, the core id is not valid (there are %x cores)\n", (UINT32)Cores.size());
+        return;
+    }
+
+    Total = (EXIT_PROFILER_STATISTICS *)malloc(sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Total == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the vm-exit statistics\n");
+        return;
+    }
+
+    if (IsSingleCore)
+    {
+        memcpy(Total, &Cores[CoreId], sizeof(EXIT_PROFILER_STATISTICS));
+    }
+    else
+    {
+        CommandExitprofMergeCores(Cores, Total);
+    }
+
+    CommandExitprofShowStatistics(Total);
+
+    free(Total);
+}
+
+/**
+ * @brief !exitprof command handler
+ *
+ * @param CommandTokens
+ * @param Command
+ *
+ * @return VOID
+ */
+VOID
+CommandExitprof(vector<CommandToken> CommandTokens, string Command)
+{
+    EXIT_PROFILER_OPERATION_PACKETS * ExitProfilerRequest;
+    std::wstring                      Filepath;
+    UINT32                            CoreId;
+    UINT32                            Interval;
+    UINT32                            Count;
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "load") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "path"))
+    {
+        //
+        // Showing a saved dump doesn't need the debugger
+        //
+        StringToWString(Filepath, GetCaseSensitiveStringFromCommandToken(CommandTokens.at(3)));
+
+        CommandExitprofLoadDump(Filepath);
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the vm-exit profiler is only available in local (VMI) mode\n");
+        return;
+    }
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "dump") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "path"))
+    {
+        StringToWString(Filepath, GetCaseSensitiveStringFromCommandToken(CommandTokens.at(3)));
+
+        CommandExitprofSaveDump(Filepath);
+        return;
+    }
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "query") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "core"))
+    {
+        if (!ConvertTokenToUInt32(CommandTokens.at(3), &CoreId))
+        {
+            ShowMessages("please specify a correct hex value for the core id\n\n");
+            CommandExitprofHelp();
+            return;
+        }
+
+        CommandExitprofQuery(TRUE, CoreId);
+        return;
+    }
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "sample"))
+    {
+        if (!ConvertTokenToUInt32(CommandTokens.at(2), &Interval) || !ConvertTokenToUInt32(CommandTokens.at(3), &Count) ||
+            Interval == 0)
+        {
+            ShowMessages("please specify correct hex values for the interval (milliseconds) and the count\n\n");
+            CommandExitprofHelp();
+            return;
+        }
+
+        CommandExitprofSample(Interval, Count);
+        return;
+    }
+
+    if (CommandTokens.size() != 2)
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+
+        CommandExitprofHelp();
+        return;
+    }
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "query"))
+    {
+        CommandExitprofQuery(FALSE, 0);
+        return;
+    }
+
+    //
+    // The packet has the histograms of all of the exit reasons, so it's not
+    // kept on the stack
+    //
+    ExitProfilerRequest = (EXIT_PROFILER_OPERATION_PACKETS *)malloc(SIZEOF_EXIT_PROFILER_OPERATION_PACKETS);
+
+    if (ExitProfilerRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the vm-exit statistics\n");
+        return;
+    }
+
+    PlatformZeroMemory(ExitProfilerRequest, SIZEOF_EXIT_PROFILER_OPERATION_PACKETS);
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "enable"))
+    {
+        ExitProfilerRequest->ExitProfilerOperationType = EXIT_PROFILER_OPERATION_REQUEST_TYPE_ENABLE;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "disable"))
+    {
+        ExitProfilerRequest->ExitProfilerOperationType = EXIT_PROFILER_OPERATION_REQUEST_TYPE_DISABLE;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "reset"))
+    {
+        ExitProfilerRequest->ExitProfilerOperationType = EXIT_PROFILER_OPERATION_REQUEST_TYPE_RESET;
+    }
+    else
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandExitprofHelp();
+        free(ExitProfilerRequest);
+        return;
+    }
+
+    //
+    // Send the vm-exit profiler operation request
+    //
+    if (CommandExitprofSendRequest(ExitProfilerRequest))
+    {
+        switch (ExitProfilerRequest->ExitProfilerOperationType)
+        {
+        case EXIT_PROFILER_OPERATION_REQUEST_TYPE_ENABLE:
+            ShowMessages("the vm-exits of %x cores are profiled\n", ExitProfilerRequest->NumberOfCores);
+            break;
+
+        case EXIT_PROFILER_OPERATION_REQUEST_TYPE_DISABLE:
+            ShowMessages("the vm-exit profiler is disabled (the statistics are kept)\n");
+            break;
+
+        default:
+            ShowMessages("the vm-exit statistics are reset\n");
+            break;
+        }
+    }
+    else
+    {
+        ShowErrorMessage(ExitProfilerRequest->KernelStatus);
+    }
+
+    free(ExitProfilerRequest);
+}
@@ -0,0 +1,725 @@
+/**
+ * @file lbrprof.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !lbrprof command
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN                                      g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                                      g_IsHyperTraceModuleLoaded;
+extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+
+/**
+ * @brief Entries of the tables of the edges and the call chains of the profiles
+ *
+ */
+#define LBRPROF_EDGE_TABLE_SIZE  0x10000
+#define LBRPROF_CHAIN_TABLE_SIZE 0x4000
+
+/**
+ * @brief Count of the rows that are shown for the edges, chains and functions
+ *
+ */
+#define LBRPROF_MAXIMUM_ROWS 0x10
+
+/**
+ * @brief help of the !lbrprof command
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofHelp()
+{
+    ShowMessages("!lbrprof : samples the Last Branch Record (LBR) of the cores into per-core rings and aggregates "
+                 "the samples into the hot branches (edges), the hot call chains and the branch statistics of the functions.\n");
+    ShowMessages("Note : while the sampling is started, every save of the LBR (e.g., lbr_save() in the script of an event, "
+                 "like the clock interrupt or a syscall) is also written as a sample, so the LBR should be enabled by the '!lbr' command.\n");
+    ShowMessages("Note : 'collect' drains the rings in each interval and shows the profile, 'path' also saves the samples "
+                 "into a file, and 'load' shows the profile of a saved file (without loading the debugger).\n");
+    ShowMessages("Note : the call chains, the types of the branches and the valid cycles need the architectural LBR, "
+                 "and the addresses are resolved based on the loaded symbols.\n\n");
+
+    ShowMessages("syntax : \t!lbrprof [start] [size RingSize (hex)]\n");
+    ShowMessages("syntax : \t!lbrprof [stop]\n");
+    ShowMessages("syntax : \t!lbrprof [collect] [Interval (hex - milliseconds)] [Count (hex)] [path Path (string)]\n");
+    ShowMessages("syntax : \t!lbrprof [load] [path Path (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !lbr enable\n");
+    ShowMessages("\t\te.g : !lbrprof start\n");
+    ShowMessages("\t\te.g : !lbrprof start size 100000\n");
+    ShowMessages("\t\te.g : !interrupt d1 script { lbr_save(); }\n");
+    ShowMessages("\t\te.g : !lbrprof collect 3e8 a\n");
+    ShowMessages("\t\te.g : !lbrprof collect 3e8 a path c:\\profiles\\lbr.bin\n");
+    ShowMessages("\t\te.g : !lbrprof stop\n");
+    ShowMessages("\t\te.g : !lbrprof load path c:\\profiles\\lbr.bin\n");
+}
+
+/**
+ * @brief Send LBR sampling requests
+ *
+ * @param LbrSampleRequest
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandLbrprofSendRequest(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest)
+{
+    BOOL  Status;
+    ULONG ReturnedLength;
+
+    AssertShowMessageReturnStmt(g_IsHyperTraceModuleLoaded, g_DeviceHandle, ASSERT_MESSAGE_HYPERTRACE_NOT_LOADED, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    //
+    // Send IOCTL
+    //
+    Status = PlatformDeviceIoControl(
+        g_DeviceHandle,                       // Handle to device
+        IOCTL_PERFORM_HYPERTRACE_LBR_SAMPLE,  // IO Control Code (IOCTL)
+        LbrSampleRequest,                     // Input Buffer to driver.
+        SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS, // Input buffer length
+        LbrSampleRequest,                     // Output Buffer from driver.
+        SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS, // Length of output buffer in bytes.
+        &ReturnedLength,                      // Bytes placed in buffer.
+        NULL                                  // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+
+        return FALSE;
+    }
+
+    if (LbrSampleRequest->KernelStatus == DEBUGGER_OPERATION_WAS_SUCCESSFUL)
+    {
+        return TRUE;
+    }
+    else
+    {
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Drain the samples of all of the cores
+ *
+ * @param LbrSampleRequest A buffer for the requests
+ * @param Samples The drained samples are appended to it
+ * @param NumberOfSamples
+ * @param DroppedSamples
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandLbrprofDrainCores(HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest,
+                         std::vector<BYTE> &             Samples,
+                         UINT64 *                        NumberOfSamples,
+                         UINT64 *                        DroppedSamples)
+{
+    UINT32 CoreId = 0;
+
+    do
+    {
+        PlatformZeroMemory(LbrSampleRequest, SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS);
+
+        LbrSampleRequest->LbrSampleOperationType = HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_DRAIN;
+        LbrSampleRequest->CoreId                 = CoreId;
+
+        if (!CommandLbrprofSendRequest(LbrSampleRequest))
+        {
+            ShowErrorMessage(LbrSampleRequest->KernelStatus);
+            return FALSE;
+        }
+
+        Samples.insert(Samples.end(), LbrSampleRequest->Buffer, LbrSampleRequest->Buffer + LbrSampleRequest->BufferLength);
+
+        *NumberOfSamples += LbrSampleRequest->NumberOfSamples;
+        *DroppedSamples += LbrSampleRequest->DroppedSamples;
+
+        //
+        // The buffer of the request is full, the same core is drained again
+        //
+        if (!LbrSampleRequest->HasMoreSamples)
+        {
+            CoreId++;
+        }
+
+    } while (CoreId < LbrSampleRequest->NumberOfCores);
+
+    return TRUE;
+}
+
+/**
+ * @brief Convert the symbols into the sorted ranges of the functions
+ *
+ * @details The symbols are converted once, and then all of the addresses of
+ * the profile are resolved by a binary search on the ranges
+ *
+ * @param Ranges
+ * @param Names
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofBuildFunctionRanges(std::vector<LBR_PROFILE_FUNCTION_RANGE> & Ranges,
+                                  std::vector<const std::string *> &        Names)
+{
+    LBR_PROFILE_FUNCTION_RANGE Range;
+
+    Ranges.clear();
+    Names.clear();
+
+    //
+    // The map is sorted by the addresses
+    //
+    for (const auto & Symbol : g_DisassemblerSymbolMap)
+    {
+        Range.Start = Symbol.first;
+        Range.Size  = Symbol.second.ObjectSize;
+
+        Ranges.push_back(Range);
+        Names.push_back(&Symbol.second.ObjectName);
+    }
+}
+
+/**
+ * @brief Get the name of an address (function+offset, or the address itself)
+ *
+ * @param Address
+ * @param Ranges
+ * @param Names
+ *
+ * @return std::string
+ */
+std::string
+CommandLbrprofGetAddressName(UINT64                                    Address,
+                             std::vector<LBR_PROFILE_FUNCTION_RANGE> & Ranges,
+                             std::vector<const std::string *> &        Names)
+{
+    CHAR   Buffer[64];
+    UINT32 Function;
+
+    Function = LbrProfileFindFunction(Ranges.data(), (UINT32)Ranges.size(), Address);
+
+    if (Function == LBR_PROFILE_NO_FUNCTION)
+    {
+        snprintf(Buffer, sizeof(Buffer), "%llx", Address);
+        return std::string(Buffer);
+    }
+
+    if (Address == Ranges[Function].Start)
+    {
+        return *Names[Function];
+    }
+
+    snprintf(Buffer, sizeof(Buffer), "+0x%llx", Address - Ranges[Function].Start);
+
+    return *Names[Function] + Buffer;
+}
+
+/**
+ * @brief Get the permille of a count
+ *
+ * @param Count
+ * @param Total
+ *
+ * @return UINT32
+ */
+static UINT32
+CommandLbrprofPermille(UINT64 Count, UINT64 Total)
+{
+    return Total == 0 ? 0 : (UINT32)(Count * 1000 / Total);
+}
+
+/**
+ * @brief Show the hot edges, the hot call chains and the functions of a profile
+ *
+ * @param Profile A finalized profile
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofShowProfile(LBR_PROFILE * Profile)
+{
+    std::vector<LBR_PROFILE_FUNCTION_RANGE>   Ranges;
+    std::vector<const std::string *>          Names;
+    std::vector<LBR_PROFILE_FUNCTION_SUMMARY> Summaries;
+    LBR_PROFILE_FUNCTION_SUMMARY              Unresolved;
+    CHAR                                      BrTypeName[LBR_BR_TYPE_NAME_MAX_LEN] = {0};
+    UINT32                                    NumberOfRows;
+    UINT32                                    NumberOfFunctions;
+
+    ShowMessages("samples: %llu, branches: %llu, dropped samples: %llu\n",
+                 Profile->NumberOfSamples,
+                 Profile->NumberOfBranches,
+                 Profile->DroppedSamples);
+
+    if (Profile->NumberOfEdges == 0)
+    {
+        ShowMessages("no branch is sampled\n");
+        return;
+    }
+
+    if (Profile->DroppedEdges != 0 || Profile->DroppedChains != 0)
+    {
+        ShowMessages("warning, %llu branches and %llu call chains are not counted as the tables of the profile were full\n",
+                     Profile->DroppedEdges,
+                     Profile->DroppedChains);
+    }
+
+    CommandLbrprofBuildFunctionRanges(Ranges, Names);
+
+    if (Ranges.empty())
+    {
+        ShowMessages("warning, no symbol is loaded, the addresses are not resolved (use the '.sym' command)\n");
+    }
+
+    //
+    // Hot edges
+    //
+    NumberOfRows = Profile->NumberOfEdges < LBRPROF_MAXIMUM_ROWS ? Profile->NumberOfEdges : LBRPROF_MAXIMUM_ROWS;
+
+    ShowMessages("\nhot branches (%x of %x):\n", NumberOfRows, Profile->NumberOfEdges);
+    ShowMessages("%12s %7s %8s %10s  %-13s  %s\n", "count", "branch%", "mispred%", "avg cycles", "type", "from -> to");
+
+    for (UINT32 i = 0; i < NumberOfRows; i++)
+    {
+        const LBR_PROFILE_EDGE * Edge = &Profile->Edges[i];
+        UINT32                   MispredictedPermille;
+
+        if (Edge->BranchType == LBR_PROFILE_UNKNOWN_BRANCH_TYPE)
+        {
+            strncpy(BrTypeName, "-", LBR_BR_TYPE_NAME_MAX_LEN);
+        }
+        else
+        {
+            CommandLbrdumpGetArchBranchTypet(Edge->BranchType, BrTypeName);
+        }
+
+        MispredictedPermille = CommandLbrprofPermille(Edge->Mispredicted, Edge->Count);
+
+        ShowMessages("%12llu %5u.%u %6u.%u %10llu  %-13s  %s -> %s\n",
+                     Edge->Count,
+                     CommandLbrprofPermille(Edge->Count, Profile->NumberOfBranches) / 10,
+                     CommandLbrprofPermille(Edge->Count, Profile->NumberOfBranches) % 10,
+                     MispredictedPermille / 10,
+                     MispredictedPermille % 10,
+                     Edge->CycleSamples == 0 ? 0 : Edge->Cycles / Edge->CycleSamples,
+                     BrTypeName,
+                     CommandLbrprofGetAddressName(Edge->From, Ranges, Names).c_str(),
+                     CommandLbrprofGetAddressName(Edge->To, Ranges, Names).c_str());
+    }
+
+    //
+    // Hot call chains
+    //
+    if (Profile->NumberOfChains != 0)
+    {
+        NumberOfRows = Profile->NumberOfChains < LBRPROF_MAXIMUM_ROWS ? Profile->NumberOfChains : LBRPROF_MAXIMUM_ROWS;
+
+        ShowMessages("\nhot call chains (%x of %x, the innermost call first):\n", NumberOfRows, Profile->NumberOfChains);
+        ShowMessages("%12s %8s  %s\n", "count", "samples%", "chain");
+
+        for (UINT32 i = 0; i < NumberOfRows; i++)
+        {
+            const LBR_PROFILE_CHAIN * Chain = &Profile->Chains[i];
+            std::string               Frames;
+
+            for (UINT32 j = 0; j < Chain->Depth; j++)
+            {
+                if (j != 0)
+                {
+                    Frames += " <- ";
+                }
+
+                Frames += CommandLbrprofGetAddressName(Chain->Frames[j], Ranges, Names);
+            }
+
+            ShowMessages("%12llu %6u.%u  %s\n",
+                         Chain->Count,
+                         CommandLbrprofPermille(Chain->Count, Profile->NumberOfSamples) / 10,
+                         CommandLbrprofPermille(Chain->Count, Profile->NumberOfSamples) % 10,
+                         Frames.c_str());
+        }
+    }
+
+    //
+    // Functions
+    //
+    if (Ranges.empty())
+    {
+        return;
+    }
+
+    Summaries.resize(Ranges.size());
+
+    NumberOfFunctions = LbrProfileSummarizeFunctions(Profile, Ranges.data(), (UINT32)Ranges.size(), Summaries.data(), &Unresolved);
+    NumberOfRows      = NumberOfFunctions < LBRPROF_MAXIMUM_ROWS ? NumberOfFunctions : LBRPROF_MAXIMUM_ROWS;
+
+    ShowMessages("\nfunctions (%x of %x, by the cycles of their branches):\n", NumberOfRows, NumberOfFunctions);
+    ShowMessages("%12s %12s %8s %10s %10s  %s\n", "cycles", "branches", "mispred%", "avg cycles", "calls", "function");
+
+    for (UINT32 i = 0; i < NumberOfRows; i++)
+    {
+        const LBR_PROFILE_FUNCTION_SUMMARY * Summary = &Summaries[i];
+        UINT32                               MispredictedPermille;
+
+        MispredictedPermille = CommandLbrprofPermille(Summary->Mispredicted, Summary->Branches);
+
+        ShowMessages("%12llu %12llu %6u.%u %10llu %10llu  %s\n",
+                     Summary->Cycles,
+                     Summary->Branches,
+                     MispredictedPermille / 10,
+                     MispredictedPermille % 10,
+                     Summary->CycleSamples == 0 ? 0 : Summary->Cycles / Summary->CycleSamples,
+                     Summary->Calls,
+                     Names[Summary->Function]->c_str());
+    }
+
+    if (Unresolved.Branches != 0)
+    {
+        ShowMessages("%llu branches are not in any of the functions of the symbols\n", Unresolved.Branches);
+    }
+}
+
+/**
+ * @brief Aggregate the samples and show the profile
+ *
+ * @param Samples
+ * @param SamplesSize
+ * @param DroppedSamples
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofShowSamples(const VOID * Samples, UINT64 SamplesSize, UINT64 DroppedSamples)
+{
+    LBR_PROFILE Profile;
+    SIZE_T      BufferSize = LbrProfileGetBufferSize(LBRPROF_EDGE_TABLE_SIZE, LBRPROF_CHAIN_TABLE_SIZE);
+    PVOID       Buffer;
+
+    Buffer = malloc(BufferSize);
+
+    if (Buffer == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the LBR profile\n");
+        return;
+    }
+
+    LbrProfileInitialize(&Profile, LBRPROF_EDGE_TABLE_SIZE, LBRPROF_CHAIN_TABLE_SIZE, Buffer, BufferSize);
+
+    if (!LbrProfileAddSamples(&Profile, Samples, SamplesSize, NULL))
+    {
+        ShowMessages("warning, the samples are malformed, only the valid samples before it are aggregated\n");
+    }
+
+    Profile.DroppedSamples = DroppedSamples;
+
+    LbrProfileFinalize(&Profile);
+
+    CommandLbrprofShowProfile(&Profile);
+
+    free(Buffer);
+}
+
+/**
+ * @brief Save the samples into a file
+ *
+ * @param Filepath
+ * @param Samples
+ * @param NumberOfSamples
+ * @param DroppedSamples
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofSaveSamples(std::wstring & Filepath, std::vector<BYTE> & Samples, UINT64 NumberOfSamples, UINT64 DroppedSamples)
+{
+    LBR_PROFILE_FILE_HEADER Header;
+    HANDLE                  FileHandle;
+    BOOLEAN                 Result;
+
+    //
+    // Create or open the file for writing the samples (see the TEMPORARY LINUX
+    // SHIM in dump.cpp for the cast)
+    //
+#ifdef __linux__
+    FileHandle = PlatformOpenFileForWriting((const WCHAR *)Filepath.c_str());
+#else
+    FileHandle = PlatformOpenFileForWriting(Filepath.c_str());
+#endif
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create or open the file\n");
+        return;
+    }
+
+    LbrProfileInitializeFileHeader(&Header, NumberOfSamples, DroppedSamples);
+
+    Result = PlatformWriteFile(FileHandle, &Header, sizeof(LBR_PROFILE_FILE_HEADER)) &&
+             (Samples.empty() || PlatformWriteFile(FileHandle, Samples.data(), (DWORD)Samples.size()));
+
+    PlatformCloseFile(FileHandle);
+
+    if (Result)
+    {
+        ShowMessages("%llu LBR samples are saved at: %ls\n", NumberOfSamples, Filepath.c_str());
+    }
+    else
+    {
+        ShowMessages("err, unable to write the samples into the file\n");
+    }
+}
+
+/**
+ * @brief Drain the samples in each interval and show the profile
+ *
+ * @param Interval Milliseconds of each interval
+ * @param Count Count of the intervals
+ * @param Filepath The file of the samples (optional)
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofCollect(UINT32 Interval, UINT32 Count, std::wstring * Filepath)
+{
+    HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest;
+    std::vector<BYTE>               Samples;
+    UINT64                          NumberOfSamples = 0;
+    UINT64                          DroppedSamples  = 0;
+    UINT64                          PreviousSamples;
+
+    //
+    // The packet has the buffer of the samples, so it's not kept on the stack
+    //
+    LbrSampleRequest = (HYPERTRACE_LBR_SAMPLE_PACKETS *)malloc(SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS);
+
+    if (LbrSampleRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the LBR samples\n");
+        return;
+    }
+
+    for (UINT32 i = 0; i < Count; i++)
+    {
+        PlatformSleep(Interval);
+
+        PreviousSamples = NumberOfSamples;
+
+        if (!CommandLbrprofDrainCores(LbrSampleRequest, Samples, &NumberOfSamples, &DroppedSamples))
+        {
+            break;
+        }
+
+        ShowMessages("interval %x: %llu samples\n", i + 1, NumberOfSamples - PreviousSamples);
+    }
+
+    free(LbrSampleRequest);
+
+    if (DroppedSamples != 0)
+    {
+        ShowMessages("warning, %llu samples are dropped as the rings were full (use a shorter interval or a larger ring)\n",
+                     DroppedSamples);
+    }
+
+    if (Filepath != NULL)
+    {
+        CommandLbrprofSaveSamples(*Filepath, Samples, NumberOfSamples, DroppedSamples);
+    }
+
+    CommandLbrprofShowSamples(Samples.data(), Samples.size(), DroppedSamples);
+}
+
+/**
+ * @brief Show the profile of a saved file of the samples
+ *
+ * @param Filepath
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprofLoadSamples(std::wstring & Filepath)
+{
+    HANDLE       FileHandle = INVALID_HANDLE_VALUE;
+    SIZE_T       FileSize   = 0;
+    const VOID * Samples;
+    UINT64       SamplesSize;
+    UINT64       NumberOfSamples;
+    UINT64       DroppedSamples;
+    VOID *       File;
+
+#ifdef __linux__
+    File = PlatformMapFileReadOnly((const WCHAR *)Filepath.c_str(), &FileSize, &FileHandle);
+#else
+    File = PlatformMapFileReadOnly(Filepath.c_str(), &FileSize, &FileHandle);
+#endif
+
+    if (File == NULL)
+    {
+        ShowMessages("err, unable to open the file\n");
+        return;
+    }
+
+    if (!LbrProfileReadFile(File, FileSize, &Samples, &SamplesSize, &NumberOfSamples, &DroppedSamples))
+    {
+        ShowMessages("err, the file is not a valid file of the LBR samples\n");
+        PlatformUnmapFile(File, FileSize, FileHandle);
+        return;
+    }
+
+    CommandLbrprofShowSamples(Samples, SamplesSize, DroppedSamples);
+
+    PlatformUnmapFile(File, FileSize, FileHandle);
+}
+
+/**
+ * @brief !lbrprof command handler
+ *
+ * @param CommandTokens
+ * @param Command
+ *
+ * @return VOID
+ */
+VOID
+CommandLbrprof(vector<CommandToken> CommandTokens, string Command)
+{
+    HYPERTRACE_LBR_SAMPLE_PACKETS * LbrSampleRequest;
+    std::wstring                    Filepath;
+    UINT32                          RingSize = 0;
+    UINT32                          Interval;
+    UINT32                          Count;
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "load") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "path"))
+    {
+        //
+        // Showing a saved file doesn't need the debugger
+        //
+        StringToWString(Filepath, GetCaseSensitiveStringFromCommandToken(CommandTokens.at(3)));
+
+        CommandLbrprofLoadSamples(Filepath);
+        return;
+    }
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("err, the LBR sampling is only available in local (VMI) mode\n");
+        return;
+    }
+
+    if ((CommandTokens.size() == 4 || CommandTokens.size() == 6) && CompareLowerCaseStrings(CommandTokens.at(1), "collect"))
+    {
+        if (!ConvertTokenToUInt32(CommandTokens.at(2), &Interval) || !ConvertTokenToUInt32(CommandTokens.at(3), &Count) ||
+            Interval == 0)
+        {
+            ShowMessages("please specify correct hex values for the interval (milliseconds) and the count\n\n");
+            CommandLbrprofHelp();
+            return;
+        }
+
+        if (CommandTokens.size() == 6)
+        {
+            if (!CompareLowerCaseStrings(CommandTokens.at(4), "path"))
+            {
+                ShowMessages("incorrect use of the '%s'\n\n",
+                             GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+                CommandLbrprofHelp();
+                return;
+            }
+
+            StringToWString(Filepath, GetCaseSensitiveStringFromCommandToken(CommandTokens.at(5)));
+
+            CommandLbrprofCollect(Interval, Count, &Filepath);
+        }
+        else
+        {
+            CommandLbrprofCollect(Interval, Count, NULL);
+        }
+
+        return;
+    }
+
+    if (CommandTokens.size() == 4 && CompareLowerCaseStrings(CommandTokens.at(1), "start") &&
+        CompareLowerCaseStrings(CommandTokens.at(2), "size"))
+    {
+        if (!ConvertTokenToUInt32(CommandTokens.at(3), &RingSize))
+        {
+            ShowMessages("please specify a correct hex value for the size of the rings\n\n");
+            CommandLbrprofHelp();
+            return;
+        }
+    }
+    else if (CommandTokens.size() != 2)
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+
+        CommandLbrprofHelp();
+        return;
+    }
+
+    //
+    // The packet has the buffer of the samples, so it's not kept on the stack
+    //
+    LbrSampleRequest = (HYPERTRACE_LBR_SAMPLE_PACKETS *)malloc(SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS);
+
+    if (LbrSampleRequest == NULL)
+    {
+        ShowMessages("err, unable to allocate the buffer for the LBR samples\n");
+        return;
+    }
+
+    PlatformZeroMemory(LbrSampleRequest, SIZEOF_HYPERTRACE_LBR_SAMPLE_PACKETS);
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "start"))
+    {
+        LbrSampleRequest->LbrSampleOperationType = HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_START;
+        LbrSampleRequest->RingSize               = RingSize;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "stop") && CommandTokens.size() == 2)
+    {
+        LbrSampleRequest->LbrSampleOperationType = HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_STOP;
+    }
+    else
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandLbrprofHelp();
+        free(LbrSampleRequest);
+        return;
+    }
+
+    //
+    // Send the LBR sampling request
+    //
+    if (CommandLbrprofSendRequest(LbrSampleRequest))
+    {
+        if (LbrSampleRequest->LbrSampleOperationType == HYPERTRACE_LBR_SAMPLE_REQUEST_TYPE_START)
+        {
+            ShowMessages("the LBR of %x cores is sampled into rings of %x bytes\n",
+                         LbrSampleRequest->NumberOfCores,
+                         LbrSampleRequest->RingSize);
+        }
+        else
+        {
+            ShowMessages("the LBR sampling is stopped (the remaining samples can be collected)\n");
+        }
+    }
+    else
+    {
+        ShowErrorMessage(LbrSampleRequest->KernelStatus);
+    }
+
+    free(LbrSampleRequest);
+}
@@ -166,18 +166,18 @@ CommandPcicam(vector<CommandToken> CommandTokens, string Command)
 
             if (!PcidevinfoPacket.PrintRaw)
             {
-                Vendor * CurrentVendor     = GetVendorById(PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.VendorId);
-                CHAR *   CurrentVendorName = (CHAR *)"N/A";
-                CHAR *   CurrentDeviceName = (CHAR *)"N/A";
+                const Vendor * CurrentVendor     = GetVendorById(PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.VendorId);
+                const CHAR *   CurrentVendorName = "N/A";
+                const CHAR *   CurrentDeviceName = "N/A";
 
                 if (CurrentVendor != NULL)
                 {
-                    CurrentVendorName      = CurrentVendor->VendorName;
-                    Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.DeviceId);
+                    CurrentVendorName            = GetVendorName(CurrentVendor);
+                    const Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.DeviceId);
 
                     if (CurrentDevice != NULL)
                     {
-                        CurrentDeviceName = CurrentDevice->DeviceName;
+                        CurrentDeviceName = GetDeviceName(CurrentDevice);
                     }
                 }
 
@@ -207,7 +207,6 @@ CommandPcicam(vector<CommandToken> CommandTokens, string Command)
                              PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.HeaderType,
                              (PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.HeaderType & 0x1) ? "True" : "False",
                              PcidevinfoPacket.DeviceInfo.ConfigSpace.CommonHeader.Bist);
-                FreeVendor(CurrentVendor);
                 FreePciIdDatabase();
 
                 ShowMessages("\nDevice Header:\n");
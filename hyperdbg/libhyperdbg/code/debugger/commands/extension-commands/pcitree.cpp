@@ -96,18 +96,18 @@ CommandPcitree(vector<CommandToken> CommandTokens, string Command)
             ShowMessages("%-12s | %-9s | %-17s | %s \n%s\n", "DBDF", "VID:DID", "Vendor Name", "Device Name", "----------------------------------------------------------------------");
             for (UINT8 i = 0; i < (PcitreePacket.DeviceInfoListNum < DEV_MAX_NUM ? PcitreePacket.DeviceInfoListNum : DEV_MAX_NUM); i++)
             {
-                Vendor * CurrentVendor     = GetVendorById(PcitreePacket.DeviceInfoList[i].ConfigSpace.VendorId);
-                CHAR *   CurrentVendorName = (CHAR *)"N/A";
-                CHAR *   CurrentDeviceName = (CHAR *)"N/A";
+                const Vendor * CurrentVendor     = GetVendorById(PcitreePacket.DeviceInfoList[i].ConfigSpace.VendorId);
+                const CHAR *   CurrentVendorName = "N/A";
+                const CHAR *   CurrentDeviceName = "N/A";
 
                 if (CurrentVendor != NULL)
                 {
-                    CurrentVendorName      = CurrentVendor->VendorName;
-                    Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcitreePacket.DeviceInfoList[i].ConfigSpace.DeviceId);
+                    CurrentVendorName            = GetVendorName(CurrentVendor);
+                    const Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcitreePacket.DeviceInfoList[i].ConfigSpace.DeviceId);
 
                     if (CurrentDevice != NULL)
                     {
-                        CurrentDeviceName = CurrentDevice->DeviceName;
+                        CurrentDeviceName = GetDeviceName(CurrentDevice);
                     }
                 }
 
@@ -124,8 +124,6 @@ CommandPcitree(vector<CommandToken> CommandTokens, string Command)
                              CurrentDeviceName
 
                 );
-
-                FreeVendor(CurrentVendor);
             }
             FreePciIdDatabase();
         }
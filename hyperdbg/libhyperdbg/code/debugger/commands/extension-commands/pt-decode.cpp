@@ -0,0 +1,106 @@
+/**
+ * @file pt-decode.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief !pt decode command
+ * @details Decoding a saved trace needs neither the driver nor a live target,
+ * so this part of the !pt command is shared by Windows and Linux
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Parse !pt decode parameters and decode the saved trace
+ *
+ * @param CommandTokens The command tokens to parse
+ *
+ * @return VOID
+ */
+VOID
+CommandPtDecode(vector<CommandToken> & CommandTokens)
+{
+    PT_ANALYSIS_OPTIONS Analysis = {0};
+    BOOLEAN             Packets  = FALSE;
+    string              TraceFile;
+
+    if (CommandTokens.size() < 3)
+    {
+        ShowMessages("err, 'decode' expects the path of a trace file\n\n");
+        CommandPtHelp();
+        return;
+    }
+
+    TraceFile = GetCaseSensitiveStringFromCommandToken(CommandTokens.at(2));
+
+    for (SIZE_T i = 3; i < CommandTokens.size(); i++)
+    {
+        if (i + 1 >= CommandTokens.size())
+        {
+            ShowMessages("err, '%s' expects a value\n\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+            CommandPtHelp();
+            return;
+        }
+
+        if (CompareLowerCaseStrings(CommandTokens.at(i), "type"))
+        {
+            i++;
+            if (CompareLowerCaseStrings(CommandTokens.at(i), "packet"))
+                Packets = TRUE;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "instruction"))
+                Packets = FALSE;
+            else
+            {
+                ShowMessages("err, decode type must be 'instruction' or 'packet', got '%s'\n\n",
+                             GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+                CommandPtHelp();
+                return;
+            }
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "analysis"))
+        {
+            i++;
+            if (CompareLowerCaseStrings(CommandTokens.at(i), "coverage"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_COVERAGE;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "edge"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_EDGES;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "profile"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_PROFILE;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "all"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_ALL;
+            else
+            {
+                ShowMessages("err, unknown analysis '%s'\n\n",
+                             GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+                CommandPtHelp();
+                return;
+            }
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "export"))
+        {
+            i++;
+            PlatformStrCpy(Analysis.ExportPath,
+                           sizeof(Analysis.ExportPath),
+                           GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+        }
+        else
+        {
+            ShowMessages("err, unknown 'decode' option '%s'\n\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+            CommandPtHelp();
+            return;
+        }
+    }
+
+    if (Packets && Analysis.Modes != 0)
+    {
+        ShowMessages("err, 'analysis' is only available for the instructions\n\n");
+        CommandPtHelp();
+        return;
+    }
+
+    PtTraceFileDecode(TraceFile.c_str(), Packets, &Analysis);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file pt-linux.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Linux implementation of the !pt command
+ * @details The Windows implementation (pt.cpp) drives the hypertrace module of
+ *          the driver: it launches or opens the target process, captures its
+ *          image and maps the per-core buffers. None of that exists on Linux,
+ *          but a trace that is saved by '!pt enable ... save' only needs the
+ *          decoder, so the saved traces can be decoded on Linux (e.g., on an
+ *          analysis machine or in CI).
+ *
+ *          The whole translation unit is swapped on Linux (CMake `if(UNIX)`
+ *          REMOVE_ITEM pt.cpp + APPEND pt-linux.cpp), mirroring the
+ *          install.cpp -> install-linux.cpp pattern. The decoding itself is
+ *          shared with Windows (pt-decode.cpp, pt-trace-file.cpp) and is
+ *          only built if libipt is found (HAVE_LIBIPT). The other subcommands
+ *          and the two exported requests of the hypertrace module are not
+ *          supported on Linux.
+ *
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+#ifdef __linux__
+
+/**
+ * @brief help of the !pt command
+ *
+ * @return VOID
+ */
+VOID
+CommandPtHelp()
+{
+    ShowMessages("!pt : decodes the Intel Processor Trace (PT) traces that are saved on Windows.\n\n");
+
+    ShowMessages("syntax : \t!pt decode [TraceFile (string)] [type TypeOfDump (string)] [analysis Analysis (string)] [export ExportPath (string)]\n");
+
+    ShowMessages("\n");
+    ShowMessages("\t\te.g : !pt decode /traces/test.hdpt type packet\n");
+    ShowMessages("\t\te.g : !pt decode /traces/test.hdpt analysis profile export /out/test\n");
+
+    ShowMessages("\n");
+    ShowMessages("Where:\n");
+    ShowMessages("\t[TypeOfDump (string)] could be 'instruction' or 'packet'\n");
+    ShowMessages("\t[Analysis (string)] could be 'coverage', 'edge', 'profile', or 'all' (can be repeated)\n");
+    ShowMessages("\t[ExportPath (string)] is the prefix of the exported files: .cov (module+offset coverage), "
+                 ".edges.csv, .profile.csv, and .folded (flamegraph stacks)\n");
+    ShowMessages("\t[TraceFile (string)] is a trace file which is saved by '!pt enable ... save' on Windows\n");
+    ShowMessages("\n");
+}
+
+/**
+ * @brief !pt command handler
+ *
+ * @param CommandTokens
+ * @param Command
+ *
+ * @return VOID
+ */
+VOID
+CommandPt(vector<CommandToken> CommandTokens, string Command)
+{
+    UNREFERENCED_PARAMETER(Command);
+
+    if (CommandTokens.size() == 1)
+    {
+        ShowMessages("incorrect use of the '%s'\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandPtHelp();
+        return;
+    }
+
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "decode"))
+    {
+#ifdef HAVE_LIBIPT
+        //
+        // Decode a saved trace file (no driver is needed)
+        //
+        CommandPtDecode(CommandTokens);
+#else
+        ShowMessages("err, decoding the traces is not supported as libhyperdbg is built without libipt\n");
+#endif
+    }
+    else
+    {
+        ShowMessages("err, tracing is not supported on Linux, only the saved traces can be decoded\n\n");
+        CommandPtHelp();
+    }
+}
+
+/**
+ * @brief Request to perform an PT operation
+ *
+ * @param PtRequest
+ *
+ * @return BOOLEAN FALSE — there is no hypertrace module on Linux
+ */
+BOOLEAN
+HyperDbgPerformPtOperation(HYPERTRACE_PT_OPERATION_PACKETS * PtRequest)
+{
+    UNREFERENCED_PARAMETER(PtRequest);
+
+    ShowMessages("err, tracing is not supported on Linux\n");
+    return FALSE;
+}
+
+/**
+ * @brief Map the per-CPU PT output buffers into the current process
+ *
+ * @param MmapRequest
+ *
+ * @return BOOLEAN FALSE — there is no hypertrace module on Linux
+ */
+BOOLEAN
+HyperDbgPtMmapSendRequest(HYPERTRACE_PT_MMAP_PACKETS * MmapRequest)
+{
+    UNREFERENCED_PARAMETER(MmapRequest);
+
+    ShowMessages("err, tracing is not supported on Linux\n");
+    return FALSE;
+}
+
+#endif // __linux__
@@ -24,6 +24,18 @@ extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 //
 static HANDLE g_PtTraceStopEvent = NULL;
 
+//
+// Analysis of the running trace: set by '!pt enable ... analysis ...' before
+// the trace thread is launched (only one trace runs at a time)
+//
+static PT_ANALYSIS_OPTIONS g_PtTraceAnalysis = {0};
+
+//
+// Path of the container that the running trace is saved into instead of
+// being decoded (empty if the trace is decoded right away)
+//
+static CHAR g_PtTraceSavePath[MAX_PATH] = {0};
+
 /**
  * @brief Argument block passed to the background trace thread
  */
@@ -57,6 +69,8 @@ CommandPtHelp()
     ShowMessages("syntax : \t!pt enable [tid ThreadId (hex)] [size BufferSize (hex)] [core CoreId (hex)]\n");
     ShowMessages("syntax : \t!pt enable [pname ProcessName (string)] [size BufferSize (hex)] [core CoreId (hex)]\n");
     ShowMessages("syntax : \t!pt enable [path Path (string)] [size BufferSize (hex)] [core CoreId (hex)]\n");
+    ShowMessages("syntax : \t!pt enable [path Path (string)] [analysis Analysis (string)] [export ExportPath (string)]\n");
+    ShowMessages("syntax : \t!pt enable [path Path (string)] [save TraceFile (string)]\n");
     ShowMessages("syntax : \t!pt enable [cr3 Cr3Value (hex)] [size BufferSize (hex)]\n");
     ShowMessages("syntax : \t!pt disable\n");
     ShowMessages("syntax : \t!pt pause\n");
@@ -70,6 +84,7 @@ CommandPtHelp()
     ShowMessages("syntax : \t!pt filter [stoprange1 FromAddress (hex) ToAddress (hex)] [stoprange2 FromAddress (hex) ToAddress (hex)] [stoprange3 FromAddress (hex) ToAddress (hex)] [stoprange4 FromAddress (hex) ToAddress (hex)]\n");
     ShowMessages("syntax : \t!pt filter [stoprange1 module ModuleName (string)] [stoprange2 module ModuleName (string)] [stoprange3 module ModuleName (string)] [stoprange4 module ModuleName (string)]\n");
     ShowMessages("syntax : \t!pt packet [PacketType (string)]\n");
+    ShowMessages("syntax : \t!pt decode [TraceFile (string)] [type TypeOfDump (string)] [analysis Analysis (string)] [export ExportPath (string)]\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : !pt enable\n");
@@ -80,6 +95,8 @@ CommandPtHelp()
     ShowMessages("\t\te.g : !pt enable cr3 0x1aabb000\n");
     ShowMessages("\t\te.g : !pt enable pid 0x4a8 size 0x200000\n");
     ShowMessages("\t\te.g : !pt enable path \"c:\\programs\\my exe file.exe\" size 0x200000 core 3\n");
+    ShowMessages("\t\te.g : !pt enable path c:\\test.exe analysis coverage analysis edge export c:\\out\\test\n");
+    ShowMessages("\t\te.g : !pt enable pid 0x4a8 analysis all\n");
     ShowMessages("\t\te.g : !pt disable\n");
     ShowMessages("\t\te.g : !pt pause\n");
     ShowMessages("\t\te.g : !pt resume\n");
@@ -94,11 +111,18 @@ CommandPtHelp()
     ShowMessages("\t\te.g : !pt filter range1 module ntdll range2 module nt\n");
     ShowMessages("\t\te.g : !pt filter stoprange1 0x140003000 0x140004000\n");
     ShowMessages("\t\te.g : !pt packet psb pip tsc\n");
+    ShowMessages("\t\te.g : !pt enable pid 0x4a8 save c:\\traces\\test.hdpt\n");
+    ShowMessages("\t\te.g : !pt decode c:\\traces\\test.hdpt type packet\n");
+    ShowMessages("\t\te.g : !pt decode c:\\traces\\test.hdpt analysis profile export c:\\out\\test\n");
 
     ShowMessages("\n");
     ShowMessages("Where:\n");
     ShowMessages("\t[Mode (string)] could be 'kernel' or/and 'user'\n");
     ShowMessages("\t[TypeOfDump (string)] could be 'instruction' or 'packet'\n");
+    ShowMessages("\t[Analysis (string)] could be 'coverage', 'edge', 'profile', or 'all' (can be repeated)\n");
+    ShowMessages("\t[ExportPath (string)] is the prefix of the exported files: .cov (module+offset coverage), "
+                 ".edges.csv, .profile.csv, and .folded (flamegraph stacks)\n");
+    ShowMessages("\t[TraceFile (string)] is a trace file which is saved by 'save' and can be decoded later (even on another machine, also on Linux)\n");
     ShowMessages("\t[ModuleName (string)] could be 'main' (the main module of the process), 'nt', 'win32k', or any other module name\n");
     ShowMessages("\t[PacketType (string)] could be either or a combination of 'psb', 'pip', 'tsc', 'mtc', 'cyc', 'tnt', 'tip', 'fup', or 'mode'\n");
     ShowMessages("\n");
@@ -321,20 +345,24 @@ CommandPtSendFlush()
 /**
  * @brief Send pt filter command
  *
+ * @param ResolvedCr3 Receives the address space of the process that is
+ * resolved by the driver (optional)
+ *
  * @return BOOLEAN
  */
 static BOOLEAN
-CommandPtSendFilterByPid(UINT32  ProcessId,
-                         BOOLEAN IsUserMode,
-                         BOOLEAN IsKernelMode,
-                         UINT64  StartRange1,
-                         UINT64  EndRange1,
-                         UINT64  StartRange2,
-                         UINT64  EndRange2,
-                         UINT64  StartRange3,
-                         UINT64  EndRange3,
-                         UINT64  StartRange4,
-                         UINT64  EndRange4)
+CommandPtSendFilterByPid(UINT32   ProcessId,
+                         BOOLEAN  IsUserMode,
+                         BOOLEAN  IsKernelMode,
+                         UINT64   StartRange1,
+                         UINT64   EndRange1,
+                         UINT64   StartRange2,
+                         UINT64   EndRange2,
+                         UINT64   StartRange3,
+                         UINT64   EndRange3,
+                         UINT64   StartRange4,
+                         UINT64   EndRange4,
+                         UINT64 * ResolvedCr3)
 {
     HYPERTRACE_PT_OPERATION_PACKETS Op             = {};
     UINT8                           NumberOfRanges = 0;
@@ -416,6 +444,9 @@ CommandPtSendFilterByPid(UINT32  ProcessId,
                      Op.FilterOptions.TraceKernel,
                      Op.FilterOptions.NumAddrRanges);
 
+        if (ResolvedCr3 != NULL)
+            *ResolvedCr3 = Op.EnableOptions.Cr3;
+
         return TRUE;
     }
 
@@ -449,15 +480,16 @@ CommandPtRunAndTraceCore(PROCESS_INFORMATION * Process,
                          int                   PinCore,
                          BOOLEAN               LaunchedNew)
 {
-    DWORD_PTR                       Mask;
-    HYPERTRACE_PT_MMAP_PACKETS      Mmap        = {};
-    HYPERTRACE_PT_OPERATION_PACKETS Sizes       = {};
-    IMAGE_SYMBOL_CONTEXT            Ctx         = {};
-    UINT64                          TextStart   = 0;
-    UINT64                          TextEnd     = 0;
-    UINT64                          FilterStart = 0;
-    UINT64                          FilterEnd   = 0;
-    UINT64                          Total       = 0;
+    DWORD_PTR                         Mask;
+    std::vector<PT_HELPER_CORE_TRACE> Traces;
+    HYPERTRACE_PT_MMAP_PACKETS        Mmap        = {};
+    HYPERTRACE_PT_OPERATION_PACKETS   Sizes       = {};
+    IMAGE_SYMBOL_CONTEXT              Ctx         = {};
+    UINT64                            TextStart   = 0;
+    UINT64                            TextEnd     = 0;
+    UINT64                            FilterStart = 0;
+    UINT64                            FilterEnd   = 0;
+    UINT64                            Total       = 0;
 
     if (PinCore < 0)
     {
@@ -520,8 +552,9 @@ CommandPtRunAndTraceCore(PROCESS_INFORMATION * Process,
 
     //
     // Enable PT with the specified filter and wait for the target process to exit
+    // (the image is only decoded in the address space of the process)
     //
-    if (!CommandPtSendFilterByPid(Process->dwProcessId, TRUE, FALSE, FilterStart, FilterEnd, NULL, NULL, NULL, NULL, NULL, NULL) ||
+    if (!CommandPtSendFilterByPid(Process->dwProcessId, TRUE, FALSE, FilterStart, FilterEnd, NULL, NULL, NULL, NULL, NULL, NULL, &Ctx.Cr3) ||
         !CommandPtSendEnable())
     {
         ShowMessages("[-] cannot enable Intel PT\n");
@@ -592,12 +625,13 @@ CommandPtRunAndTraceCore(PROCESS_INFORMATION * Process,
     }
 
     //
-    // Decode the trace for each core that has a non-zero buffer size
+    // Collect the trace of each core that has a non-zero buffer size
     //
     for (UINT32 i = 0; i < Mmap.NumCpus; i++)
     {
-        UINT32 Cpu   = Mmap.Cpus[i].CpuId;
-        UINT64 Bytes = (Cpu < Sizes.NumCpus) ? Sizes.BytesPerCpu[Cpu] : 0;
+        PT_HELPER_CORE_TRACE Trace;
+        UINT32               Cpu   = Mmap.Cpus[i].CpuId;
+        UINT64               Bytes = (Cpu < Sizes.NumCpus) ? Sizes.BytesPerCpu[Cpu] : 0;
 
         if (Bytes == 0)
             continue;
@@ -605,10 +639,59 @@ CommandPtRunAndTraceCore(PROCESS_INFORMATION * Process,
         if (Bytes > Mmap.Cpus[i].Size)
             Bytes = Mmap.Cpus[i].Size;
 
-        ShowMessages("\n[*] core %u: %llu bytes of trace\n", Cpu, (UINT64)Bytes);
-        Total += Packets
-                     ? PtHelperDecodeCorePackets(Cpu, (const UINT8 *)(ULONG_PTR)Mmap.Cpus[i].UserVa, Bytes, Ctx.ImageBase)
-                     : PtHelperDecodeCore(Cpu, (const UINT8 *)(ULONG_PTR)Mmap.Cpus[i].UserVa, Bytes, &Ctx);
+        Trace.Cpu    = Cpu;
+        Trace.Buffer = (const UINT8 *)(ULONG_PTR)Mmap.Cpus[i].UserVa;
+        Trace.Size   = Bytes;
+
+        Traces.push_back(Trace);
+    }
+
+    //
+    // Save the traces for decoding them later, or decode the traces of all cores
+    // in parallel (the output is still shown in order), or aggregate them if an
+    // analysis is requested
+    //
+    if (g_PtTraceSavePath[0] != '\0')
+    {
+        PT_TRACE_FILE_CONFIG Config        = {0};
+        DWORD                ImagePathSize = sizeof(Config.ImagePath);
+
+        Config.ProcessId   = Process->dwProcessId;
+        Config.PinCore     = PinCore;
+        Config.FilterStart = FilterStart;
+        Config.FilterEnd   = FilterEnd;
+
+        if (Path != NULL)
+            strcpy_s(Config.ImagePath, sizeof(Config.ImagePath), Path);
+        else
+            QueryFullProcessImageNameA(Process->hProcess, 0, Config.ImagePath, &ImagePathSize);
+
+        if (PtTraceFileSave(g_PtTraceSavePath, Traces.data(), (UINT32)Traces.size(), &Ctx, &Config))
+        {
+            ShowMessages("[+] trace saved to '%s', decode it by '!pt decode %s'\n", g_PtTraceSavePath, g_PtTraceSavePath);
+        }
+
+        CommandPtSendDisable();
+        goto Cleanup;
+    }
+    else if (!Packets && g_PtTraceAnalysis.Modes != 0)
+    {
+        PT_ANALYSIS_STATE Analysis;
+        CHAR              ImagePath[MAX_PATH] = {0};
+        DWORD             ImagePathSize       = sizeof(ImagePath);
+
+        PtAnalysisInitialize(&Analysis, g_PtTraceAnalysis.Modes, &Ctx);
+
+        Total = PtHelperDecodeCoresParallel(Traces.data(), (UINT32)Traces.size(), FALSE, &Ctx, &Analysis);
+
+        if (Path == NULL && QueryFullProcessImageNameA(Process->hProcess, 0, ImagePath, &ImagePathSize))
+            Path = ImagePath;
+
+        PtAnalysisShowAndExport(&Analysis, Process->hProcess, Path, &g_PtTraceAnalysis);
+    }
+    else
+    {
+        Total = PtHelperDecodeCoresParallel(Traces.data(), (UINT32)Traces.size(), Packets, &Ctx, NULL);
     }
 
     ShowMessages("\n[+] decoded %llu %s total\n", (UINT64)Total, Packets ? "packet(s)" : "instruction(s)");
@@ -888,17 +971,22 @@ PtTraceThreadProc(LPVOID Param)
  * @param ProcessId  PID of an existing process, or 0
  * @param ThreadId   TID of an existing thread, or 0
  * @param PName      Process name to search for, or NULL
+ * @param Analysis   Analysis of the decoded trace (no modes means printing it)
+ * @param SavePath   Path of the container to save the trace into, or NULL
+ *                   to decode it right away
  *
  * @return BOOLEAN TRUE if the thread was successfully launched
  */
 static BOOLEAN
-CommandPtLaunchTraceThread(const CHAR * Path,
-                           const CHAR * Function,
-                           BOOLEAN      Packets,
-                           int          PinCore,
-                           UINT32       ProcessId,
-                           UINT32       ThreadId,
-                           const CHAR * PName)
+CommandPtLaunchTraceThread(const CHAR *                Path,
+                           const CHAR *                Function,
+                           BOOLEAN                     Packets,
+                           int                         PinCore,
+                           UINT32                      ProcessId,
+                           UINT32                      ThreadId,
+                           const CHAR *                PName,
+                           const PT_ANALYSIS_OPTIONS * Analysis,
+                           const CHAR *                SavePath)
 {
     PT_TRACE_THREAD_ARGS * Args;
     HANDLE                 Thread;
@@ -942,6 +1030,9 @@ CommandPtLaunchTraceThread(const CHAR * Path,
         Args->HasFunction = TRUE;
     }
 
+    g_PtTraceAnalysis = *Analysis;
+    strcpy_s(g_PtTraceSavePath, sizeof(g_PtTraceSavePath), SavePath != NULL ? SavePath : "");
+
     Args->Packets   = Packets;
     Args->PinCore   = PinCore;
     Args->ProcessId = ProcessId;
@@ -1029,20 +1120,23 @@ HyperDbgPtMmapSendRequest(HYPERTRACE_PT_MMAP_PACKETS * MmapRequest)
 static VOID
 CommandPtParseEnable(vector<CommandToken> & CommandTokens, HYPERTRACE_PT_OPERATION_PACKETS * PtRequest)
 {
-    BOOLEAN HasPid   = FALSE;
-    BOOLEAN HasPname = FALSE;
-    BOOLEAN HasPath  = FALSE;
-    BOOLEAN HasTid   = FALSE;
-    BOOLEAN HasCr3   = FALSE;
-    BOOLEAN HasSize  = FALSE;
-    BOOLEAN HasCore  = FALSE;
-    UINT64  Pid      = 0;
-    UINT64  Tid      = 0;
-    UINT64  Cr3      = 0;
-    UINT64  Size     = 0;
-    UINT32  Core     = 0;
-    string  Pname;
-    string  Path;
+    BOOLEAN             HasPid   = FALSE;
+    BOOLEAN             HasPname = FALSE;
+    BOOLEAN             HasPath  = FALSE;
+    BOOLEAN             HasTid   = FALSE;
+    BOOLEAN             HasCr3   = FALSE;
+    BOOLEAN             HasSize  = FALSE;
+    BOOLEAN             HasCore  = FALSE;
+    BOOLEAN             HasSave  = FALSE;
+    UINT64              Pid      = 0;
+    UINT64              Tid      = 0;
+    UINT64              Cr3      = 0;
+    UINT64              Size     = 0;
+    UINT32              Core     = 0;
+    string              Pname;
+    string              Path;
+    string              SavePath;
+    PT_ANALYSIS_OPTIONS Analysis = {0};
 
     for (SIZE_T i = 2; i < CommandTokens.size(); i++)
     {
@@ -1160,6 +1254,56 @@ CommandPtParseEnable(vector<CommandToken> & CommandTokens, HYPERTRACE_PT_OPERATI
             }
             HasCore = TRUE;
         }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "analysis"))
+        {
+            if (i + 1 >= CommandTokens.size())
+            {
+                ShowMessages("err, 'analysis' expects 'coverage', 'edge', 'profile', or 'all'\n\n");
+                CommandPtHelp();
+                return;
+            }
+            i++;
+            if (CompareLowerCaseStrings(CommandTokens.at(i), "coverage"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_COVERAGE;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "edge"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_EDGES;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "profile"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_PROFILE;
+            else if (CompareLowerCaseStrings(CommandTokens.at(i), "all"))
+                Analysis.Modes |= PT_ANALYSIS_MODE_ALL;
+            else
+            {
+                ShowMessages("err, unknown analysis '%s'\n\n",
+                             GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+                CommandPtHelp();
+                return;
+            }
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "save"))
+        {
+            if (i + 1 >= CommandTokens.size())
+            {
+                ShowMessages("err, 'save' expects a path for the trace file\n\n");
+                CommandPtHelp();
+                return;
+            }
+            i++;
+            SavePath = GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i));
+            HasSave  = TRUE;
+        }
+        else if (CompareLowerCaseStrings(CommandTokens.at(i), "export"))
+        {
+            if (i + 1 >= CommandTokens.size())
+            {
+                ShowMessages("err, 'export' expects a path prefix for the exported files\n\n");
+                CommandPtHelp();
+                return;
+            }
+            i++;
+            strcpy_s(Analysis.ExportPath,
+                     sizeof(Analysis.ExportPath),
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(i)).c_str());
+        }
         else
         {
             ShowMessages("err, unknown 'enable' option '%s'\n\n",
@@ -1254,6 +1398,40 @@ CommandPtParseEnable(vector<CommandToken> & CommandTokens, HYPERTRACE_PT_OPERATI
         PtRequest->CoreId = PT_DEFAULT_PINNING_CORE;
     }
 
+    //
+    // Check for analysis options
+    //
+    if (Analysis.Modes != 0)
+    {
+        ShowMessages("  analysis     :%s%s%s\n",
+                     (Analysis.Modes & PT_ANALYSIS_MODE_COVERAGE) ? " coverage" : "",
+                     (Analysis.Modes & PT_ANALYSIS_MODE_EDGES) ? " edge" : "",
+                     (Analysis.Modes & PT_ANALYSIS_MODE_PROFILE) ? " profile" : "");
+    }
+    else if (Analysis.ExportPath[0] != '\0')
+    {
+        ShowMessages("err, 'export' requires at least one 'analysis'\n\n");
+        CommandPtHelp();
+        return;
+    }
+
+    if (Analysis.ExportPath[0] != '\0')
+    {
+        ShowMessages("  export       : %s\n", Analysis.ExportPath);
+    }
+
+    if (HasSave)
+    {
+        if (Analysis.Modes != 0)
+        {
+            ShowMessages("err, a saved trace is not decoded, use 'analysis' with '!pt decode' instead\n\n");
+            CommandPtHelp();
+            return;
+        }
+
+        ShowMessages("  save         : %s\n", SavePath.c_str());
+    }
+
     //
     // Fill the PtRequest structure with parsed options
     //
@@ -1268,22 +1446,22 @@ CommandPtParseEnable(vector<CommandToken> & CommandTokens, HYPERTRACE_PT_OPERATI
     if (HasPath)
     {
         ShowMessages("  Running '%s' on core: %llx\n", Path.c_str(), PtRequest->CoreId);
-        CommandPtLaunchTraceThread(Path.c_str(), NULL, FALSE, PtRequest->CoreId, 0, 0, NULL);
+        CommandPtLaunchTraceThread(Path.c_str(), NULL, FALSE, PtRequest->CoreId, 0, 0, NULL, &Analysis, HasSave ? SavePath.c_str() : NULL);
     }
     else if (HasPid)
     {
         ShowMessages("  Tracing pid 0x%llx on core: %llx\n", Pid, PtRequest->CoreId);
-        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, (UINT32)Pid, 0, NULL);
+        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, (UINT32)Pid, 0, NULL, &Analysis, HasSave ? SavePath.c_str() : NULL);
     }
     else if (HasTid)
     {
         ShowMessages("  Tracing tid 0x%llx on core: %llx\n", Tid, PtRequest->CoreId);
-        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, 0, (UINT32)Tid, NULL);
+        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, 0, (UINT32)Tid, NULL, &Analysis, HasSave ? SavePath.c_str() : NULL);
     }
     else if (HasPname)
     {
         ShowMessages("  Tracing pname '%s' on core: %llx\n", Pname.c_str(), PtRequest->CoreId);
-        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, 0, 0, Pname.c_str());
+        CommandPtLaunchTraceThread(NULL, NULL, FALSE, PtRequest->CoreId, 0, 0, Pname.c_str(), &Analysis, HasSave ? SavePath.c_str() : NULL);
     }
 }
 
@@ -1820,6 +1998,13 @@ CommandPt(vector<CommandToken> CommandTokens, string Command)
         //
         CommandPtParsePacket(CommandTokens, &PtRequest);
     }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "decode"))
+    {
+        //
+        // Decode a saved trace file (no driver is needed)
+        //
+        CommandPtDecode(CommandTokens);
+    }
     else
     {
         ShowMessages("incorrect use of the '%s'\n\n",
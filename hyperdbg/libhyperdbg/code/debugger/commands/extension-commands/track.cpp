@@ -19,6 +19,8 @@ extern BOOLEAN                  g_IsInstrumentingInstructions;
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
 extern BOOLEAN                  g_AddressConversion;
 
+extern std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION> g_DisassemblerSymbolMap;
+
 //
 // Local (global) variables
 //
@@ -27,6 +29,9 @@ BOOLEAN          IsCallInstructionVisited = FALSE;
 BOOLEAN          ShowRegs                 = FALSE;
 volatile BOOLEAN RequestShowingRegs       = FALSE;
 
+GUEST_REGS            PreviousRegs      = {0};
+GUEST_EXTRA_REGISTERS PreviousExtraRegs = {0};
+
 /**
  * @brief help of the !track command
  *
@@ -46,6 +51,9 @@ CommandTrackHelp()
     ShowMessages("\n");
     ShowMessages("\t\te.g : !track tree 10000\n");
     ShowMessages("\t\te.g : !track reg 10000\n");
+
+    ShowMessages("\nnote : the debuggee steps the instructions by itself and sends back the records of "
+                 "the steps in chunks.\n");
 }
 
 /**
@@ -60,6 +68,7 @@ VOID
 CommandTrack(vector<CommandToken> CommandTokens, string Command)
 {
     UINT32 StepCount;
+    UINT32 BatchCount;
     string SymbolServer;
 
     //
@@ -151,32 +160,35 @@ CommandTrack(vector<CommandToken> CommandTokens, string Command)
         //
         g_IsInstrumentingInstructions = TRUE;
 
-        for (SIZE_T i = 0; i < StepCount; i++)
+        //
+        // The registers before the first step (the call sites of the calls)
+        //
+        if (ShowRegs && !HyperDbgReadAllRegisters(&PreviousRegs, &PreviousExtraRegs))
         {
-            //
-            // For logging purpose
-            //
-            // ShowMessages("percentage : %f %% (%x)\n", 100.0 * (i /
-            //   (float)StepCount), i);
-            //
+            ShowRegs = FALSE;
+        }
 
+        while (StepCount != 0)
+        {
             //
-            // It's stepping over serial connection in kernel debugger
+            // The debuggee performs the steps by itself and sends back the records
+            // of the steps in chunks, each batch is a round trip so the user is able
+            // to stop tracking (CTRL+C) between the batches
             //
-            SteppingInstrumentationStepInForTracking();
-
-            if (ShowRegs && RequestShowingRegs)
+            BatchCount = StepCount > DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT ? DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT : StepCount;
+
+            if (!SteppingBatchedInstrumentationStepIn(BatchCount,
+                                                      TRUE,
+                                                      ShowRegs,
+                                                      FALSE,
+                                                      CommandTrackHandleBatchedRecord,
+                                                      NULL))
             {
-                RequestShowingRegs = FALSE;
-
-                //
-                // Show registers
-                //
-                HyperDbgRegisterShowAll();
-
-                ShowMessages("\n");
+                break;
             }
 
+            StepCount -= BatchCount;
+
             //
             // Check if user pressed CTRL+C
             //
@@ -198,6 +210,70 @@ CommandTrack(vector<CommandToken> CommandTokens, string Command)
     }
 }
 
+/**
+ * @brief Handle a record of the batched steps of tracking
+ *
+ * @param Context
+ * @param Record
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+CommandTrackHandleBatchedRecord(PVOID Context, const STEP_RECORD * Record)
+{
+    std::map<UINT64, LOCAL_FUNCTION_DESCRIPTION>::iterator Iterate;
+    const CHAR *                                           NameOfFunctionFromSymbols = NULL;
+
+    UNREFERENCED_PARAMETER(Context);
+
+    if (Record->Kind == STEP_RECORD_KIND_CALL)
+    {
+        //
+        // The target of the call is the rip after executing it (it's also
+        // accurate for the indirect calls)
+        //
+        if (g_AddressConversion)
+        {
+            Iterate = g_DisassemblerSymbolMap.find(Record->NextRip);
+
+            if (Iterate != g_DisassemblerSymbolMap.end())
+            {
+                NameOfFunctionFromSymbols = Iterate->second.ObjectName.c_str();
+            }
+        }
+
+        CommandTrackHandleReceivedCallInstructions(NameOfFunctionFromSymbols, Record->NextRip);
+
+        if (ShowRegs && RequestShowingRegs)
+        {
+            RequestShowingRegs = FALSE;
+
+            //
+            // Show registers of the call site
+            //
+            PreviousExtraRegs.RIP = Record->Rip;
+            HyperDbgRegisterShowValues(&PreviousRegs, &PreviousExtraRegs, FALSE);
+
+            ShowMessages("\n");
+        }
+    }
+    else if (Record->Kind == STEP_RECORD_KIND_RET)
+    {
+        CommandTrackHandleReceivedRetInstructions(Record->Rip);
+    }
+
+    //
+    // Keep the registers for the next call site
+    //
+    if (ShowRegs)
+    {
+        memcpy(&PreviousRegs, Record->Registers, sizeof(GUEST_REGS));
+        PreviousExtraRegs.RFLAGS = Record->Registers[STEP_RECORD_REGISTER_RFLAGS];
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Handle received 'call' or 'ret'
  *
@@ -37,9 +37,12 @@ CommandDumpHelp()
 {
     ShowMessages(".dump & !dump : saves memory context into a file.\n\n");
 
-    ShowMessages("syntax : \t.dump [FromAddress (hex)] [ToAddress (hex)] [pid ProcessId (hex)] [path Path (string)]\n");
+    ShowMessages("syntax : \t.dump [FromAddress (hex)] [ToAddress (hex)] [pid ProcessId (hex)] [path Path (string)] [resume]\n");
     ShowMessages("\nIf you want to dump physical memory then add '!' at the "
                  "start of the command\n\n");
+    ShowMessages("The unreadable and the zero pages are holes of the (sparse) dump file, and "
+                 "a manifest (Path.manifest) records the readable ranges and the hash of each chunk.\n"
+                 "If a dump is stopped (CTRL+C), it can be continued by running the same command with 'resume'.\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : .dump 401000 40b000 path c:\\rev\\dump1.dmp\n");
@@ -49,6 +52,7 @@ CommandDumpHelp()
     ShowMessages("\t\te.g : .dump 00007ff8349f2000 00007ff8349f8000 path c:\\rev\\dump5.dmp\n");
     ShowMessages("\t\te.g : .dump @rax+@rcx @rax+@rcx+1000 path c:\\rev\\dump6.dmp\n");
     ShowMessages("\t\te.g : !dump 1000 2100 path c:\\rev\\dump7.dmp\n");
+    ShowMessages("\t\te.g : !dump 0 200000000 path c:\\rev\\dump8.dmp resume\n");
 }
 
 /**
@@ -62,10 +66,7 @@ VOID
 CommandDump(vector<CommandToken> CommandTokens, string Command)
 {
     wstring                   Filepath;
-    UINT32                    ActualLength;
-    UINT32                    Iterator;
     UINT32                    Pid                 = 0;
-    UINT32                    Length              = 0;
     UINT64                    StartAddress        = 0;
     UINT64                    EndAddress          = 0;
     BOOLEAN                   IsFirstCommand      = TRUE;
@@ -74,6 +75,8 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
     BOOLEAN                   IsTheFirstAddr      = FALSE;
     BOOLEAN                   IsTheSecondAddr     = FALSE;
     BOOLEAN                   IsDumpPathSpecified = FALSE;
+    BOOLEAN                   IsPidSpecified      = FALSE;
+    BOOLEAN                   Resume              = FALSE;
     string                    FirstCommand        = GetLowerStringFromCommandToken(CommandTokens.front());
     DEBUGGER_READ_MEMORY_TYPE MemoryType          = DEBUGGER_READ_VIRTUAL_ADDRESS;
 
@@ -90,7 +93,8 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
     //
     if (g_ActiveProcessDebuggingState.IsActive)
     {
-        Pid = g_ActiveProcessDebuggingState.ProcessId;
+        Pid            = g_ActiveProcessDebuggingState.ProcessId;
+        IsPidSpecified = TRUE;
     }
 
     for (auto Section : CommandTokens)
@@ -108,7 +112,8 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
                 CommandDumpHelp();
                 return;
             }
-            NextIsProcId = FALSE;
+            NextIsProcId   = FALSE;
+            IsPidSpecified = TRUE;
             continue;
         }
         else if (NextIsPath)
@@ -131,6 +136,11 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
             NextIsPath = TRUE;
             continue;
         }
+        else if (CompareLowerCaseStrings(Section, "resume"))
+        {
+            Resume = TRUE;
+            continue;
+        }
         //
         // Check the 'From' address
         //
@@ -224,76 +234,12 @@ CommandDump(vector<CommandToken> CommandTokens, string Command)
     }
 
     //
-    // Create or open the file for writing the dump file
-    //
-    // TEMPORARY LINUX SHIM (same as in pe.cpp): std::wstring stores native
-    // wchar_t (4 bytes on Linux), but the HyperDbg WCHAR type is 2 bytes
-    // (UINT16) and PlatformOpenFileForWriting takes a const WCHAR *. On Linux
-    // the cast is a bogus 2-byte reinterpretation, acceptable only because
-    // Linux file I/O is still stubbed (the path is never opened). On Windows
-    // WCHAR == wchar_t, so it is a plain correct pointer. TODO(Linux): remove
-    // once real file I/O lands and convert wchar_t -> 2-byte WCHAR properly.
-    //
-#ifdef __linux__
-    DumpFileHandle = PlatformOpenFileForWriting((const WCHAR *)Filepath.c_str());
-#else
-    DumpFileHandle = PlatformOpenFileForWriting(Filepath.c_str());
-#endif
-
-    if (DumpFileHandle == INVALID_HANDLE_VALUE)
-    {
-        ShowMessages("err, unable to create or open the file\n");
-        return;
-    }
-
-    //
-    // Compute the length
-    //
-    Length = (UINT32)(EndAddress - StartAddress);
-
-    ActualLength = NULL;
-    Iterator     = Length / PAGE_SIZE;
-
-    for (SIZE_T i = 0; i <= Iterator; i++)
-    {
-        UINT64 Address = StartAddress + (i * PAGE_SIZE);
-
-        if (Length >= PAGE_SIZE)
-        {
-            ActualLength = PAGE_SIZE;
-        }
-        else
-        {
-            ActualLength = Length;
-        }
-
-        Length -= ActualLength;
-
-        if (ActualLength != 0)
-        {
-            // ShowMessages("address: 0x%llx | actual length: 0x%llx\n", Address, ActualLength);
-
-            HyperDbgShowMemoryOrDisassemble(
-                DEBUGGER_SHOW_COMMAND_DUMP,
-                Address,
-                MemoryType,
-                READ_FROM_KERNEL,
-                Pid,
-                ActualLength,
-                NULL);
-        }
-    }
-
-    //
-    // Close the file handle if it's not already closed
+    // Dump the range (several chunks are read while the previous ones are written)
     //
-    if (DumpFileHandle != NULL)
+    if (DumpEngineDump(Filepath, StartAddress, EndAddress, MemoryType, Pid, IsPidSpecified, Resume))
     {
-        PlatformCloseFile(DumpFileHandle);
-        DumpFileHandle = NULL;
+        ShowMessages("the dump file is saved at: %ls\n", Filepath.c_str());
     }
-
-    ShowMessages("the dump file is saved at: %ls\n", Filepath.c_str());
 }
 
 /**
@@ -23,12 +23,91 @@ CommandPeHelp()
 
     ShowMessages("syntax : \t.pe [header] [FilePath (string)]\n");
     ShowMessages("syntax : \t.pe [section] [SectionName (string)] [FilePath (string)]\n");
+    ShowMessages("syntax : \t.pe [batch] [json|csv] [dir Directory (string) Pattern (string)] [out FilePath (string)]\n");
+    ShowMessages("syntax : \t.pe [batch] [json|csv] [list ListFilePath (string)] [out FilePath (string)]\n");
     ShowMessages("\n.pe section dumps are capped at 1 MiB per matching section and 4 MiB total.\n");
+    ShowMessages(".pe batch analyzes the images in parallel and shows (or writes) one summary for each image, either as a JSON\n"
+                 "line (the default, with the hash and the entropy of each section) or as a CSV row. The list file has a path\n"
+                 "in each line.\n");
 
     ShowMessages("\n");
     ShowMessages("\t\te.g : .pe header c:\\reverse\\myfile.exe\n");
     ShowMessages("\t\te.g : .pe section .text \"c:\\reverse files\\myfile.exe\"\n");
     ShowMessages("\t\te.g : .pe section .rdata \"c:\\reverse files\\myfile.exe\"\n");
+    ShowMessages("\t\te.g : .pe batch dir c:\\windows\\system32 *.dll out c:\\reverse\\system32.jsonl\n");
+    ShowMessages("\t\te.g : .pe batch csv list c:\\reverse\\samples.txt out c:\\reverse\\samples.csv\n");
+}
+
+/**
+ * @brief .pe batch command handler
+ *
+ * @param CommandTokens
+ * @return VOID
+ */
+static VOID
+CommandPeBatch(vector<CommandToken> CommandTokens)
+{
+    vector<string> Paths;
+    string         OutputPath;
+    BOOLEAN        IsCsv = FALSE;
+    size_t         Index = 2;
+
+    if (Index < CommandTokens.size() && CompareLowerCaseStrings(CommandTokens.at(Index), "csv"))
+    {
+        IsCsv = TRUE;
+        Index++;
+    }
+    else if (Index < CommandTokens.size() && CompareLowerCaseStrings(CommandTokens.at(Index), "json"))
+    {
+        Index++;
+    }
+
+    if (Index + 2 < CommandTokens.size() && CompareLowerCaseStrings(CommandTokens.at(Index), "dir"))
+    {
+        try
+        {
+            Paths = ListDirectory(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(Index + 1)),
+                                  GetCaseSensitiveStringFromCommandToken(CommandTokens.at(Index + 2)));
+        }
+        catch (const std::exception &)
+        {
+            ShowMessages("err, unable to list the directory '%s'\n",
+                         GetCaseSensitiveStringFromCommandToken(CommandTokens.at(Index + 1)).c_str());
+            return;
+        }
+
+        Index += 3;
+    }
+    else if (Index + 1 < CommandTokens.size() && CompareLowerCaseStrings(CommandTokens.at(Index), "list"))
+    {
+        if (!PeBatchReadList(GetCaseSensitiveStringFromCommandToken(CommandTokens.at(Index + 1)), Paths))
+        {
+            return;
+        }
+
+        Index += 2;
+    }
+    else
+    {
+        ShowMessages("err, incorrect use of the '%s' command\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandPeHelp();
+        return;
+    }
+
+    if (Index + 2 == CommandTokens.size() && CompareLowerCaseStrings(CommandTokens.at(Index), "out"))
+    {
+        OutputPath = GetCaseSensitiveStringFromCommandToken(CommandTokens.at(Index + 1));
+    }
+    else if (Index != CommandTokens.size())
+    {
+        ShowMessages("err, incorrect use of the '%s' command\n\n",
+                     GetCaseSensitiveStringFromCommandToken(CommandTokens.at(0)).c_str());
+        CommandPeHelp();
+        return;
+    }
+
+    PeBatchAnalyze(Paths, IsCsv, OutputPath);
 }
 
 /**
@@ -57,7 +136,12 @@ CommandPe(vector<CommandToken> CommandTokens, string Command)
     //
     // Check for first option
     //
-    if (CompareLowerCaseStrings(CommandTokens.at(1), "section"))
+    if (CompareLowerCaseStrings(CommandTokens.at(1), "batch"))
+    {
+        CommandPeBatch(CommandTokens);
+        return;
+    }
+    else if (CompareLowerCaseStrings(CommandTokens.at(1), "section"))
     {
         if (CommandTokens.size() == 3)
         {
@@ -102,9 +102,9 @@ CommandScriptRunCommand(std::string Input, vector<string> PathAndArgs)
 /**
  * @brief Read file and run the script
  *
- * @return VOID
+ * @return BOOLEAN FALSE if the file could not be opened
  */
-VOID
+BOOLEAN
 HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
 {
     std::string Line;
@@ -212,6 +212,8 @@ HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs)
     {
         ShowMessages("err, invalid file specified for the script\n");
     }
+
+    return IsOpened;
 }
 
 /**
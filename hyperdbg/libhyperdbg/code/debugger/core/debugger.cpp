@@ -638,6 +638,81 @@ ShowErrorMessage(UINT32 Error)
                      Error);
         break;
 
+    case DEBUGGER_ERROR_DIRTY_LOGGING_NOT_SUPPORTED:
+        ShowMessages("err, the processor doesn't support page-modification logging (PML) (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_DIRTY_LOGGING_CANNOT_BE_INITIALIZED:
+        ShowMessages("err, unable to initialize the dirty logging (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_DIRTY_LOGGING_ALREADY_ENABLED:
+        ShowMessages("err, the dirty logging is already enabled (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_DIRTY_LOGGING_NOT_ENABLED:
+        ShowMessages("err, the dirty logging is not enabled (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_DIRTY_LOGGING_OPERATION_PARAMETERS:
+        ShowMessages("err, invalid parameters for the dirty logging operation (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EXIT_PROFILER_CANNOT_BE_INITIALIZED:
+        ShowMessages("err, unable to initialize the vm-exit profiler (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EXIT_PROFILER_NOT_ENABLED:
+        ShowMessages("err, the vm-exit profiler is not enabled (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EXIT_PROFILER_OPERATION_PARAMETERS:
+        ShowMessages("err, invalid parameters for the vm-exit profiler operation (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_EVENT_SET:
+        ShowMessages("err, the event set is malformed (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EVENT_SET_ACTION_WITHOUT_EVENT:
+        ShowMessages("err, an action of the event set belongs to an event which is not in the same set (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EVENT_SET_TAG_IS_NOT_UNIQUE:
+        ShowMessages("err, the tag of an event of the event set is already used (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_LBR_SAMPLING_CANNOT_BE_INITIALIZED:
+        ShowMessages("err, unable to allocate the rings of the LBR sampling (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_LBR_SAMPLING_NOT_STARTED:
+        ShowMessages("err, the LBR sampling is not started (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_INVALID_LBR_SAMPLING_PARAMETERS:
+        ShowMessages("err, invalid parameters for the LBR sampling operation (%x)\n",
+                     Error);
+        break;
+
+    case DEBUGGER_ERROR_EVENT_SET_ENTRY_CANNOT_BE_APPLIED:
+        ShowMessages("err, an entry of the event set cannot be applied, none of the entries are applied (%x)\n",
+                     Error);
+        break;
+
     default:
         ShowMessages("err, error not found (%x)\n",
                      Error);
@@ -1372,6 +1447,14 @@ SendEventToKernel(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     DEBUGGER_EVENT_AND_ACTION_RESULT  ReturnedBuffer = {0};
     PDEBUGGER_EVENT_AND_ACTION_RESULT TempRegResult;
 
+    //
+    // The event is registered along with the other events of the set
+    //
+    if (EventSetIsRecording())
+    {
+        return EventSetAddEvent(Event, EventBufferLength);
+    }
+
     if (g_IsSerialConnectedToRemoteDebuggee)
     {
         //
@@ -1493,6 +1576,20 @@ RegisterActionToEvent(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     DEBUGGER_EVENT_AND_ACTION_RESULT  ReturnedBuffer = {0};
     PDEBUGGER_EVENT_AND_ACTION_RESULT TempAddingResult;
 
+    //
+    // The actions are registered along with the other events of the set
+    //
+    if (EventSetIsRecording())
+    {
+        return EventSetAddActions(Event,
+                                  ActionBreakToDebugger,
+                                  ActionBreakToDebuggerLength,
+                                  ActionCustomCode,
+                                  ActionCustomCodeLength,
+                                  ActionScript,
+                                  ActionScriptLength);
+    }
+
     if (g_IsSerialConnectedToRemoteDebuggee)
     {
         //
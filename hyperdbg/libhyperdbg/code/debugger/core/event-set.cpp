@@ -0,0 +1,470 @@
+/**
+ * @file event-set.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Registering sets of events at once
+ * @details While a set is recorded, the events and actions of the event
+ * commands are not sent one by one, instead, all of them are sent in a
+ * single buffer which is applied (or rejected) as a whole by the debuggee
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN                              g_EventSetRecording;
+extern std::vector<EVENT_SET_PENDING_EVENT> g_EventSetPendingEvents;
+extern BOOLEAN                              g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                              g_IsSerialConnectedToRemoteDebugger;
+extern BOOLEAN                              g_IsConnectedToRemoteDebuggee;
+extern BOOLEAN                              g_IsVmmModuleLoaded;
+extern BOOLEAN                              g_BreakPrintingOutput;
+extern BOOLEAN                              g_AutoUnpause;
+extern LIST_ENTRY                           g_EventTrace;
+
+/**
+ * @brief Append an entry to the entries of a pending event
+ *
+ * @param Entries
+ * @param Type
+ * @param Buffer
+ * @param BufferLength
+ *
+ * @return VOID
+ */
+static VOID
+EventSetAppendEntry(std::vector<BYTE> &           Entries,
+                    DEBUGGER_EVENT_SET_ENTRY_TYPE Type,
+                    PVOID                         Buffer,
+                    UINT32                        BufferLength)
+{
+    DEBUGGER_EVENT_SET_ENTRY Entry  = {0};
+    SIZE_T                   Offset = Entries.size();
+
+    //
+    // Each entry is aligned, so the next entry is also aligned
+    //
+    Entry.Type   = Type;
+    Entry.Length = (sizeof(DEBUGGER_EVENT_SET_ENTRY) + BufferLength + DEBUGGER_EVENT_SET_ENTRY_ALIGNMENT - 1) &
+                   ~(DEBUGGER_EVENT_SET_ENTRY_ALIGNMENT - 1);
+
+    Entries.resize(Offset + Entry.Length, 0);
+
+    memcpy(&Entries[Offset], &Entry, sizeof(DEBUGGER_EVENT_SET_ENTRY));
+    memcpy(&Entries[Offset + sizeof(DEBUGGER_EVENT_SET_ENTRY)], Buffer, BufferLength);
+}
+
+/**
+ * @brief Send a set of events to the kernel (or the debuggee)
+ *
+ * @param EventSet
+ * @param Result
+ *
+ * @return BOOLEAN FALSE if the set could not be sent
+ */
+static BOOLEAN
+EventSetSendToKernel(PDEBUGGER_EVENT_SET EventSet, PDEBUGGER_EVENT_SET_RESULT Result)
+{
+    BOOL                       Status;
+    ULONG                      ReturnedLength;
+    PDEBUGGER_EVENT_SET_RESULT TempRegResult;
+
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        TempRegResult = KdSendRegisterEventSetPacketToDebuggee(EventSet);
+
+        if (TempRegResult == NULL)
+        {
+            return FALSE;
+        }
+
+        memcpy(Result, TempRegResult, sizeof(DEBUGGER_EVENT_SET_RESULT));
+
+        return TRUE;
+    }
+
+    AssertShowMessageReturnStmt(g_IsVmmModuleLoaded, g_DeviceHandle, ASSERT_MESSAGE_VMM_NOT_LOADED, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    Status = PlatformDeviceIoControl(g_DeviceHandle,                    // Handle to device
+                                     IOCTL_DEBUGGER_REGISTER_EVENT_SET, // IO Control Code (IOCTL)
+                                     EventSet,                          // Input Buffer to driver.
+                                     EventSet->Length,                  // Input buffer length
+                                     Result,                            // Output Buffer from driver.
+                                     sizeof(DEBUGGER_EVENT_SET_RESULT), // Length of output buffer in bytes.
+                                     &ReturnedLength,                   // Bytes placed in buffer.
+                                     NULL                               // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the pending event that contains an entry of a sent set
+ *
+ * @param First The first pending event of the set
+ * @param EntryIndex
+ *
+ * @return SIZE_T index of the pending event
+ */
+static SIZE_T
+EventSetFindPendingEventByEntry(SIZE_T First, UINT32 EntryIndex)
+{
+    PDEBUGGER_EVENT_SET_ENTRY Entry;
+    SIZE_T                    Index = First;
+
+    for (; Index < g_EventSetPendingEvents.size(); Index++)
+    {
+        if (!g_EventSetPendingEvents[Index].HasActions)
+        {
+            continue;
+        }
+
+        for (SIZE_T Offset = 0; Offset < g_EventSetPendingEvents[Index].Entries.size(); Offset += Entry->Length)
+        {
+            Entry = (PDEBUGGER_EVENT_SET_ENTRY)&g_EventSetPendingEvents[Index].Entries[Offset];
+
+            if (EntryIndex == 0)
+            {
+                return Index;
+            }
+
+            EntryIndex--;
+        }
+    }
+
+    return Index;
+}
+
+/**
+ * @brief Free the pending events and stop recording
+ *
+ * @param First The first pending event that is freed
+ *
+ * @return VOID
+ */
+static VOID
+EventSetFreePendingEvents(SIZE_T First)
+{
+    for (SIZE_T i = First; i < g_EventSetPendingEvents.size(); i++)
+    {
+        //
+        // The events without actions are already freed by the command
+        //
+        if (g_EventSetPendingEvents[i].HasActions)
+        {
+            FreeEventsAndActionsMemory(g_EventSetPendingEvents[i].Event, NULL, NULL, NULL);
+        }
+    }
+
+    g_EventSetPendingEvents.clear();
+    g_EventSetRecording = FALSE;
+}
+
+/**
+ * @brief Start recording a set of events
+ *
+ * @return BOOLEAN FALSE if a set is already being recorded
+ */
+BOOLEAN
+EventSetBegin()
+{
+    if (g_EventSetRecording)
+    {
+        return FALSE;
+    }
+
+    g_EventSetPendingEvents.clear();
+    g_EventSetRecording = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether a set of events is being recorded
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventSetIsRecording()
+{
+    return g_EventSetRecording;
+}
+
+/**
+ * @brief Add an event to the recorded set (instead of registering it)
+ *
+ * @param Event the event structure
+ * @param EventBufferLength the buffer length of event
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventSetAddEvent(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                 UINT32                         EventBufferLength)
+{
+    EVENT_SET_PENDING_EVENT PendingEvent;
+
+    PendingEvent.Event      = Event;
+    PendingEvent.HasActions = FALSE;
+
+    EventSetAppendEntry(PendingEvent.Entries, DEBUGGER_EVENT_SET_ENTRY_TYPE_EVENT, Event, EventBufferLength);
+
+    g_EventSetPendingEvents.push_back(std::move(PendingEvent));
+
+    return TRUE;
+}
+
+/**
+ * @brief Add the actions of an event to the recorded set (instead of
+ * registering them)
+ * @details The action buffers are freed here, the event is kept until
+ * the set is committed
+ *
+ * @param Event the event instance buffer
+ * @param ActionBreakToDebugger the action of breaking into the debugger
+ * @param ActionBreakToDebuggerLength the action of breaking into the debugger (length)
+ * @param ActionCustomCode the action of custom code
+ * @param ActionCustomCodeLength the action of custom code (length)
+ * @param ActionScript the action of script buffer
+ * @param ActionScriptLength the action of script buffer (length)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventSetAddActions(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                   PDEBUGGER_GENERAL_ACTION       ActionBreakToDebugger,
+                   UINT32                         ActionBreakToDebuggerLength,
+                   PDEBUGGER_GENERAL_ACTION       ActionCustomCode,
+                   UINT32                         ActionCustomCodeLength,
+                   PDEBUGGER_GENERAL_ACTION       ActionScript,
+                   UINT32                         ActionScriptLength)
+{
+    PEVENT_SET_PENDING_EVENT PendingEvent = NULL;
+
+    //
+    // The actions come right after the event
+    //
+    if (!g_EventSetPendingEvents.empty() && g_EventSetPendingEvents.back().Event == Event)
+    {
+        PendingEvent = &g_EventSetPendingEvents.back();
+    }
+
+    if (PendingEvent == NULL)
+    {
+        ShowMessages("err, the event is not found in the event set\n");
+        return FALSE;
+    }
+
+    if (ActionBreakToDebugger != NULL)
+    {
+        EventSetAppendEntry(PendingEvent->Entries, DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION, ActionBreakToDebugger, ActionBreakToDebuggerLength);
+    }
+
+    if (ActionCustomCode != NULL)
+    {
+        EventSetAppendEntry(PendingEvent->Entries, DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION, ActionCustomCode, ActionCustomCodeLength);
+    }
+
+    if (ActionScript != NULL)
+    {
+        EventSetAppendEntry(PendingEvent->Entries, DEBUGGER_EVENT_SET_ENTRY_TYPE_ACTION, ActionScript, ActionScriptLength);
+    }
+
+    PendingEvent->HasActions = TRUE;
+
+    FreeEventsAndActionsMemory(NULL, ActionBreakToDebugger, ActionCustomCode, ActionScript);
+
+    return TRUE;
+}
+
+/**
+ * @brief Register the recorded set of events
+ * @details In the Debugger Mode, the set is split into packets (each event
+ * and its actions are always in the same packet), if a packet is not applied,
+ * the events of the previous packets are cleared, so either all of the events
+ * are applied or none of them
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+EventSetCommit()
+{
+    DEBUGGER_EVENT_SET_RESULT Result = {0};
+    std::vector<BYTE>         SetBuffer;
+    PDEBUGGER_EVENT_SET       EventSet;
+    SIZE_T                    MaximumSetLength = MAXUINT32;
+    SIZE_T                    First            = 0;
+    SIZE_T                    Last;
+    SIZE_T                    FailedEvent;
+    UINT32                    NumberOfEvents = 0;
+
+    if (!g_EventSetRecording)
+    {
+        ShowMessages("err, there is no event set to commit, use 'events begin' first\n");
+        return FALSE;
+    }
+
+    g_EventSetRecording = FALSE;
+
+    //
+    // The whole set should fit in a single packet in the Debugger Mode
+    //
+    if (g_IsSerialConnectedToRemoteDebuggee)
+    {
+        MaximumSetLength = MaxSerialPacketSize - sizeof(DEBUGGER_REMOTE_PACKET) -
+                           sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET) - SERIAL_END_OF_BUFFER_CHARS_COUNT;
+    }
+
+    while (First < g_EventSetPendingEvents.size())
+    {
+        //
+        // Fill a set with as many events as fit
+        //
+        SetBuffer.assign(sizeof(DEBUGGER_EVENT_SET), 0);
+
+        for (Last = First; Last < g_EventSetPendingEvents.size(); Last++)
+        {
+            if (!g_EventSetPendingEvents[Last].HasActions)
+            {
+                continue;
+            }
+
+            if (SetBuffer.size() + g_EventSetPendingEvents[Last].Entries.size() > MaximumSetLength)
+            {
+                break;
+            }
+
+            SetBuffer.insert(SetBuffer.end(),
+                             g_EventSetPendingEvents[Last].Entries.begin(),
+                             g_EventSetPendingEvents[Last].Entries.end());
+        }
+
+        EventSet = (PDEBUGGER_EVENT_SET)SetBuffer.data();
+
+        if (Last == First && Last < g_EventSetPendingEvents.size())
+        {
+            ShowMessages("err, the event (tag: %llx) and its actions are above the maximum buffer size "
+                         "that can be sent to the debuggee\n",
+                         g_EventSetPendingEvents[First].Event->Tag - DebuggerEventTagStartSeed);
+
+            Result.IsSuccessful = FALSE;
+            Result.Error        = 0;
+            FailedEvent         = First;
+        }
+        else if (SetBuffer.size() == sizeof(DEBUGGER_EVENT_SET))
+        {
+            //
+            // Only the events without actions remain
+            //
+            First = Last;
+            continue;
+        }
+        else
+        {
+            //
+            // Count the entries (the event and the actions of each event)
+            //
+            for (SIZE_T Offset = sizeof(DEBUGGER_EVENT_SET); Offset < SetBuffer.size();)
+            {
+                Offset += ((PDEBUGGER_EVENT_SET_ENTRY)&SetBuffer[Offset])->Length;
+                EventSet->NumberOfEntries++;
+            }
+
+            EventSet->Length = (UINT32)SetBuffer.size();
+
+            if (!EventSetSendToKernel(EventSet, &Result))
+            {
+                Result.IsSuccessful = FALSE;
+                Result.Error        = 0;
+                Result.FailedEntry  = 0;
+            }
+
+            FailedEvent = EventSetFindPendingEventByEntry(First, Result.FailedEntry);
+        }
+
+        if (!Result.IsSuccessful)
+        {
+            if (Result.Error != 0)
+            {
+                ShowMessages("err, the event set is not applied, the event (tag: %llx) is failed\n",
+                             FailedEvent < g_EventSetPendingEvents.size() ? g_EventSetPendingEvents[FailedEvent].Event->Tag - DebuggerEventTagStartSeed : 0);
+
+                ShowErrorMessage(Result.Error);
+            }
+
+            //
+            // Clear the events that are already applied by the previous sets
+            //
+            for (SIZE_T i = 0; i < First; i++)
+            {
+                if (g_EventSetPendingEvents[i].HasActions)
+                {
+                    CommandEventsModifyAndQueryEvents(g_EventSetPendingEvents[i].Event->Tag, DEBUGGER_MODIFY_EVENTS_CLEAR);
+                }
+            }
+
+            EventSetFreePendingEvents(First);
+
+            return FALSE;
+        }
+
+        //
+        // The events are registered, add them to the list of events
+        //
+        for (SIZE_T i = First; i < Last; i++)
+        {
+            if (g_EventSetPendingEvents[i].HasActions)
+            {
+                InsertHeadList(&g_EventTrace, &(g_EventSetPendingEvents[i].Event->CommandsEventList));
+                NumberOfEvents++;
+            }
+        }
+
+        First = Last;
+    }
+
+    g_EventSetPendingEvents.clear();
+
+    ShowMessages("%d event(s) are applied\n", NumberOfEvents);
+
+    //
+    // Check for auto-unpause mode
+    //
+    if (NumberOfEvents != 0 && !g_IsSerialConnectedToRemoteDebuggee && !g_IsSerialConnectedToRemoteDebugger && g_BreakPrintingOutput && g_AutoUnpause)
+    {
+        g_BreakPrintingOutput = FALSE;
+
+        //
+        // If it's a remote debugger then we send the remote debuggee a 'g'
+        //
+        if (g_IsConnectedToRemoteDebuggee)
+        {
+            RemoteConnectionSendCommand("g", (UINT32)strlen("g") + 1);
+        }
+
+        ShowMessages("\n");
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Discard the recorded set of events
+ *
+ * @return VOID
+ */
+VOID
+EventSetAbort()
+{
+    EventSetFreePendingEvents(0);
+}
@@ -1632,12 +1632,18 @@ InitializeCommandsDictionary()
 
     g_CommandsList["!smi"] = {&CommandSmi, &CommandSmiHelp, DEBUGGER_COMMAND_SMI_ATTRIBUTES};
 
+    g_CommandsList["!dirty"] = {&CommandDirty, &CommandDirtyHelp, DEBUGGER_COMMAND_DIRTY_ATTRIBUTES};
+
+    g_CommandsList["!exitprof"] = {&CommandExitprof, &CommandExitprofHelp, DEBUGGER_COMMAND_EXITPROF_ATTRIBUTES};
+
     g_CommandsList["!lbr"] = {&CommandLbr, &CommandLbrHelp, DEBUGGER_COMMAND_LBR_ATTRIBUTES};
 
     g_CommandsList["!lbrdump"]  = {&CommandLbrdump, &CommandLbrdumpHelp, DEBUGGER_COMMAND_LBRDUMP_ATTRIBUTES};
     g_CommandsList["!lbrdmp"]   = {&CommandLbrdump, &CommandLbrdumpHelp, DEBUGGER_COMMAND_LBRDUMP_ATTRIBUTES};
     g_CommandsList["!lbrprint"] = {&CommandLbrdump, &CommandLbrdumpHelp, DEBUGGER_COMMAND_LBRDUMP_ATTRIBUTES};
 
+    g_CommandsList["!lbrprof"] = {&CommandLbrprof, &CommandLbrprofHelp, DEBUGGER_COMMAND_LBRPROF_ATTRIBUTES};
+
     g_CommandsList["!pt"] = {&CommandPt, &CommandPtHelp, DEBUGGER_COMMAND_PT_ATTRIBUTES};
 
     //
@@ -16,6 +16,9 @@
 //
 extern ACTIVE_DEBUGGING_PROCESS g_ActiveProcessDebuggingState;
 extern BOOLEAN                  g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN                  g_IsInstrumentingInstructions;
+extern STEP_RECORD_CALLBACK     g_BatchedSteppingCallback;
+extern PVOID                    g_BatchedSteppingCallbackContext;
 
 /**
  * @brief Perform Instrumentation Step-in
@@ -192,3 +195,225 @@ SteppingStepOverForGu(BOOLEAN LastInstruction)
         return FALSE;
     }
 }
+
+/**
+ * @brief Perform a batch of instrumentation step-ins on the debuggee
+ * @details The debuggee performs the steps by itself and sends the records of
+ * the executed instructions in chunks, the records are passed to the callback
+ * before this function returns
+ *
+ * @param StepCount at most DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT
+ * @param ForTracking
+ * @param WithRegisters
+ * @param WithInstructionBytes
+ * @param Callback
+ * @param Context
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SteppingBatchedInstrumentationStepIn(UINT32               StepCount,
+                                     BOOLEAN              ForTracking,
+                                     BOOLEAN              WithRegisters,
+                                     BOOLEAN              WithInstructionBytes,
+                                     STEP_RECORD_CALLBACK Callback,
+                                     PVOID                Context)
+{
+    DEBUGGER_REMOTE_STEPPING_REQUEST RequestFormat;
+    BOOLEAN                          Result;
+
+    //
+    // The batched steps are only performed by the kernel debugger
+    //
+    if (!g_IsSerialConnectedToRemoteDebuggee)
+    {
+        ShowMessages("the batched steps are only supported in Debugger Mode\n");
+        return FALSE;
+    }
+
+    //
+    // Set type of step
+    //
+    if (ForTracking)
+    {
+        RequestFormat = DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN_FOR_TRACKING;
+    }
+    else
+    {
+        RequestFormat = DEBUGGER_REMOTE_STEPPING_REQUEST_BATCHED_INSTRUMENTATION_STEP_IN;
+    }
+
+    //
+    // Set the receiver of the records
+    //
+    g_BatchedSteppingCallback        = Callback;
+    g_BatchedSteppingCallbackContext = Context;
+
+    Result = KdSendBatchedStepPacketToDebuggee(RequestFormat,
+                                               StepCount,
+                                               WithRegisters,
+                                               WithInstructionBytes);
+
+    g_BatchedSteppingCallback        = NULL;
+    g_BatchedSteppingCallbackContext = NULL;
+
+    return Result;
+}
+
+/**
+ * @brief Show a record of the batched steps the same way as the regular steps
+ *
+ * @param Context
+ * @param Record
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SteppingShowBatchedRecord(PVOID Context, const STEP_RECORD * Record)
+{
+    PSTEPPING_BATCHED_SHOW_CONTEXT ShowContext = (PSTEPPING_BATCHED_SHOW_CONTEXT)Context;
+    UCHAR                          InstructionBytes[MAXIMUM_INSTR_SIZE] = {0};
+    GUEST_REGS                     Regs;
+    GUEST_EXTRA_REGISTERS          ExtraRegs = {0};
+    RFLAGS                         Rflags    = {0};
+
+    //
+    // The first record of each batch is the instruction that is already shown
+    // by the previous pause of the debuggee
+    //
+    if (ShowContext->IsFirstRecordOfBatch)
+    {
+        ShowContext->IsFirstRecordOfBatch = FALSE;
+        memcpy(&ShowContext->PreviousRecord, Record, sizeof(STEP_RECORD));
+
+        return TRUE;
+    }
+
+    //
+    // Show the instruction (the flags before executing it are needed for showing
+    // whether the conditional jumps are taken or not)
+    //
+    Rflags.AsUInt = ShowContext->PreviousRecord.Registers[STEP_RECORD_REGISTER_RFLAGS];
+
+    if (Record->Length == 0)
+    {
+        ShowMessages("%s\t<unknown instruction>\n", SeparateTo64BitValue(Record->Rip).c_str());
+    }
+    else
+    {
+        memcpy(InstructionBytes, Record->InstructionBytes, Record->Length);
+
+        if (Record->Is32Bit)
+        {
+            HyperDbgDisassembler32(InstructionBytes, Record->Rip, Record->Length, 1, TRUE, &Rflags);
+        }
+        else
+        {
+            HyperDbgDisassembler64(InstructionBytes, Record->Rip, Record->Length, 1, TRUE, &Rflags);
+        }
+    }
+
+    //
+    // Show the registers before executing the instruction
+    //
+    if (ShowContext->ShowRegisters)
+    {
+        memcpy(&Regs, ShowContext->PreviousRecord.Registers, sizeof(GUEST_REGS));
+
+        ExtraRegs.RIP    = Record->Rip;
+        ExtraRegs.RFLAGS = ShowContext->PreviousRecord.Registers[STEP_RECORD_REGISTER_RFLAGS];
+
+        HyperDbgRegisterShowValues(&Regs, &ExtraRegs, FALSE);
+        ShowMessages("\n");
+    }
+
+    memcpy(&ShowContext->PreviousRecord, Record, sizeof(STEP_RECORD));
+
+    return TRUE;
+}
+
+/**
+ * @brief Perform the instrumentation step-ins in batches and show the
+ * instructions (and registers) of the steps
+ *
+ * @param StepCount
+ * @param ShowRegisters
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+SteppingBatchedInstrumentationStepInAndShow(UINT32 StepCount, BOOLEAN ShowRegisters)
+{
+    STEPPING_BATCHED_SHOW_CONTEXT ShowContext = {0};
+    UINT32                        BatchCount;
+
+    ShowContext.ShowRegisters = ShowRegisters;
+
+    while (StepCount != 0)
+    {
+        //
+        // Each batch is a round trip, so the user is able to stop the steps
+        // (CTRL+C) between the batches
+        //
+        BatchCount = StepCount > DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT ? DEBUGGER_REMOTE_BATCHED_STEPPING_MAXIMUM_COUNT : StepCount;
+
+        ShowContext.IsFirstRecordOfBatch = TRUE;
+
+        if (!SteppingBatchedInstrumentationStepIn(BatchCount,
+                                                  FALSE,
+                                                  ShowRegisters,
+                                                  TRUE,
+                                                  SteppingShowBatchedRecord,
+                                                  &ShowContext))
+        {
+            return FALSE;
+        }
+
+        StepCount -= BatchCount;
+
+        //
+        // The registers of the paused state contain the segment registers
+        //
+        if (ShowRegisters)
+        {
+            HyperDbgRegisterShowAll();
+
+            if (StepCount != 0)
+            {
+                ShowMessages("\n");
+            }
+        }
+
+        if (!g_IsInstrumentingInstructions)
+        {
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Handle a received chunk of the records of the batched steps
+ *
+ * @param Chunk
+ * @param ChunkSize
+ *
+ * @return VOID
+ */
+VOID
+SteppingHandleReceivedBatchedRecords(PVOID Chunk, UINT32 ChunkSize)
+{
+    //
+    // Check whether anyone is waiting for the records
+    //
+    if (g_BatchedSteppingCallback == NULL)
+    {
+        return;
+    }
+
+    if (!StepRecordDecodeChunk(Chunk, ChunkSize, g_BatchedSteppingCallback, g_BatchedSteppingCallbackContext))
+    {
+        ShowMessages("err, invalid records of the batched steps are received\n");
+    }
+}
@@ -27,6 +27,7 @@ extern OVERLAPPED                       g_OverlappedIoStructureForWriteDebugger;
 extern OVERLAPPED                       g_OverlappedIoStructureForReadDebuggee;
 #endif // _WIN32
 extern DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfRegisteringEvent;
+extern DEBUGGER_EVENT_SET_RESULT        g_DebuggeeResultOfRegisteringEventSet;
 extern DEBUGGER_EVENT_AND_ACTION_RESULT
                g_DebuggeeResultOfAddingActionsToEvent;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
@@ -724,6 +725,72 @@ KdSendRegisterEventPacketToDebuggee(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
     return &g_DebuggeeResultOfRegisteringEvent;
 }
 
+/**
+ * @brief Send a register event set request to the debuggee
+ * @details as this command uses one global variable to transfer the buffers
+ * so should not be called simultaneously
+ *
+ * @param EventSet
+ *
+ * @return PDEBUGGER_EVENT_SET_RESULT
+ */
+PDEBUGGER_EVENT_SET_RESULT
+KdSendRegisterEventSetPacketToDebuggee(PDEBUGGER_EVENT_SET EventSet)
+{
+    PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET Header;
+    UINT32                                              Len;
+
+    Len = EventSet->Length +
+          sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET);
+
+    Header = (PDEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)malloc(Len);
+
+    if (Header == NULL)
+    {
+        return NULL;
+    }
+
+    PlatformZeroMemory(Header, Len);
+
+    //
+    // Set length in header
+    //
+    Header->Length = EventSet->Length;
+
+    //
+    // Move buffer
+    //
+    memcpy((PVOID)((UINT64)Header +
+                   sizeof(DEBUGGEE_EVENT_AND_ACTION_HEADER_FOR_REMOTE_PACKET)),
+           (PVOID)EventSet,
+           EventSet->Length);
+
+    PlatformZeroMemory(&g_DebuggeeResultOfRegisteringEventSet,
+                       sizeof(DEBUGGER_EVENT_SET_RESULT));
+
+    //
+    // Send register event set packet
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_REGISTER_EVENT_SET,
+            (CHAR *)Header,
+            Len))
+    {
+        free(Header);
+        return NULL;
+    }
+
+    //
+    // Wait until the result of registering received
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENT_SET);
+
+    free(Header);
+
+    return &g_DebuggeeResultOfRegisteringEventSet;
+}
+
 /**
  * @brief Send an add action to event request to the debuggee
  * @details as this command uses one global variable to transfer the buffers
@@ -1453,6 +1520,55 @@ KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType)
     return TRUE;
 }
 
+/**
+ * @brief Sends a batched step-in packet to the debuggee
+ * @details The debuggee performs all of the steps by itself and the chunks of
+ * the records are received (and passed to the callback of the batched steps)
+ * before the debuggee is paused again
+ *
+ * @param StepRequestType
+ * @param StepCount
+ * @param WithRegisters
+ * @param WithInstructionBytes
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdSendBatchedStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType,
+                                  UINT32                           StepCount,
+                                  BOOLEAN                          WithRegisters,
+                                  BOOLEAN                          WithInstructionBytes)
+{
+    DEBUGGEE_STEP_PACKET StepPacket = {};
+
+    //
+    // Set the type and the details of the batched steps
+    //
+    StepPacket.StepType                    = StepRequestType;
+    StepPacket.BatchedStepCount            = StepCount;
+    StepPacket.BatchedWithRegisters        = WithRegisters;
+    StepPacket.BatchedWithInstructionBytes = WithInstructionBytes;
+
+    //
+    // Send step packet to the serial
+    //
+    if (!KdCommandPacketAndBufferToDebuggee(
+            DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_EXECUTE_ON_VMX_ROOT,
+            DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_ON_VMX_ROOT_MODE_STEP,
+            (CHAR *)&StepPacket,
+            sizeof(DEBUGGEE_STEP_PACKET)))
+    {
+        return FALSE;
+    }
+
+    //
+    // Wait until the debuggee is paused after the last step
+    //
+    DbgWaitForKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_IS_DEBUGGER_RUNNING);
+
+    return TRUE;
+}
+
 /**
  * @brief Sends a PAUSE packet to the debuggee
  *
@@ -3268,6 +3384,53 @@ KdAddActionToEventInDebuggee(PDEBUGGER_GENERAL_ACTION ActionAddingBuffer,
         TRUE);
 }
 
+/**
+ * @brief Register an event set in the debuggee
+ * @param EventSet
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+KdRegisterEventSetInDebuggee(PDEBUGGER_EVENT_SET EventSet,
+                             UINT32              Length)
+{
+    BOOL                      Status;
+    ULONG                     ReturnedLength;
+    DEBUGGER_EVENT_SET_RESULT ReturnedBuffer = {0};
+
+    AssertShowMessageReturnStmt(g_IsVmmModuleLoaded, g_DeviceHandle, ASSERT_MESSAGE_VMM_NOT_LOADED, ASSERT_MESSAGE_DRIVER_NOT_LOADED, AssertReturnFalse);
+
+    //
+    // Send IOCTL
+    //
+    Status = PlatformDeviceIoControl(g_DeviceHandle,                    // Handle to device
+                                     IOCTL_DEBUGGER_REGISTER_EVENT_SET, // IO Control Code (IOCTL)
+                                     EventSet,                          // Input Buffer to driver.
+                                     Length,                            // Input buffer length
+                                     &ReturnedBuffer,                   // Output Buffer from driver.
+                                     sizeof(DEBUGGER_EVENT_SET_RESULT), // Length of output buffer in bytes.
+                                     &ReturnedLength,                   // Bytes placed in buffer.
+                                     NULL                               // synchronous call
+    );
+
+    if (!Status)
+    {
+        ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+        return FALSE;
+    }
+
+    //
+    // Now that we registered the set (with or without error),
+    // we should send the results back to the debugger
+    //
+    return KdSendGeneralBuffersFromDebuggeeToDebugger(
+        DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENT_SET,
+        &ReturnedBuffer,
+        sizeof(DEBUGGER_EVENT_SET_RESULT),
+        TRUE);
+}
+
 /**
  * @brief Modify the event ioctl in the debuggee
  * @param ModifyEvent
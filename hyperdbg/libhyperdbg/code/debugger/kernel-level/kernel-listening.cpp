@@ -26,6 +26,7 @@ extern BOOLEAN                          g_OutputSourcesInitialized;
 extern ULONG                            g_CurrentRemoteCore;
 extern DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfRegisteringEvent;
 extern DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfAddingActionsToEvent;
+extern DEBUGGER_EVENT_SET_RESULT        g_DebuggeeResultOfRegisteringEventSet;
 extern UINT64                           g_ResultOfEvaluatedExpression;
 extern UINT32                           g_ErrorStateOfResultOfEvaluatedExpression;
 extern UINT64                           g_KernelBaseAddress;
@@ -357,6 +358,7 @@ StartAgain:
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_HARDWARE_DEBUG_REGISTER_HIT:
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_EVENT_TRIGGERED:
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_STEPPED:
+            case DEBUGGEE_PAUSING_REASON_DEBUGGEE_BATCHED_STEPPED:
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_PROCESS_SWITCHED:
             case DEBUGGEE_PAUSING_REASON_DEBUGGEE_THREAD_SWITCHED:
 
@@ -730,6 +732,22 @@ StartAgain:
 
             break;
 
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_REGISTERING_EVENT_SET:
+
+            //
+            // Move the buffer to the global variable
+            //
+            memcpy(&g_DebuggeeResultOfRegisteringEventSet,
+                   ((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET),
+                   sizeof(DEBUGGER_EVENT_SET_RESULT));
+
+            //
+            // Signal the event relating to receiving result of registering event set
+            //
+            DbgReceivedKernelResponse(DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENT_SET);
+
+            break;
+
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_QUERY_AND_MODIFY_EVENT:
 
             EventModifyAndQueryPacket = (DEBUGGER_MODIFY_EVENTS *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -1048,6 +1066,20 @@ StartAgain:
 
             break;
 
+        case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BATCHED_STEPPING:
+
+            //
+            // A chunk of the records of the batched steps (the debuggee is still
+            // stepping, so the debugger is not unpaused here)
+            //
+            if (LengthReceived > sizeof(DEBUGGER_REMOTE_PACKET))
+            {
+                SteppingHandleReceivedBatchedRecords(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET),
+                                                     LengthReceived - sizeof(DEBUGGER_REMOTE_PACKET));
+            }
+
+            break;
+
         case DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION_DEBUGGEE_RESULT_OF_BRINGING_PAGES_IN:
 
             PageinPacket = (DEBUGGER_PAGE_IN_REQUEST *)(((CHAR *)TheActualPacket) + sizeof(DEBUGGER_REMOTE_PACKET));
@@ -1144,18 +1176,18 @@ StartAgain:
                 ShowMessages("%-12s | %-9s | %-17s | %s \n%s\n", "DBDF", "VID:DID", "Vendor Name", "Device Name", "----------------------------------------------------------------------");
                 for (UINT8 i = 0; i < (PcitreePacket->DeviceInfoListNum < DEV_MAX_NUM ? PcitreePacket->DeviceInfoListNum : DEV_MAX_NUM); i++)
                 {
-                    Vendor * CurrentVendor     = GetVendorById(PcitreePacket->DeviceInfoList[i].ConfigSpace.VendorId);
-                    char *   CurrentVendorName = (char *)"N/A";
-                    char *   CurrentDeviceName = (char *)"N/A";
+                    const Vendor * CurrentVendor     = GetVendorById(PcitreePacket->DeviceInfoList[i].ConfigSpace.VendorId);
+                    const char *   CurrentVendorName = "N/A";
+                    const char *   CurrentDeviceName = "N/A";
 
                     if (CurrentVendor != NULL)
                     {
-                        CurrentVendorName      = CurrentVendor->VendorName;
-                        Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcitreePacket->DeviceInfoList[i].ConfigSpace.DeviceId);
+                        CurrentVendorName            = GetVendorName(CurrentVendor);
+                        const Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcitreePacket->DeviceInfoList[i].ConfigSpace.DeviceId);
 
                         if (CurrentDevice != NULL)
                         {
-                            CurrentDeviceName = CurrentDevice->DeviceName;
+                            CurrentDeviceName = GetDeviceName(CurrentDevice);
                         }
                     }
 
@@ -1172,8 +1204,6 @@ StartAgain:
                                  CurrentDeviceName
 
                     );
-
-                    FreeVendor(CurrentVendor);
                 }
                 FreePciIdDatabase();
             }
@@ -1211,18 +1241,18 @@ StartAgain:
 
                 if (!PcidevinfoPacket->PrintRaw)
                 {
-                    Vendor * CurrentVendor     = GetVendorById(PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.VendorId);
-                    CHAR *   CurrentVendorName = (CHAR *)"N/A";
-                    CHAR *   CurrentDeviceName = (CHAR *)"N/A";
+                    const Vendor * CurrentVendor     = GetVendorById(PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.VendorId);
+                    const CHAR *   CurrentVendorName = "N/A";
+                    const CHAR *   CurrentDeviceName = "N/A";
 
                     if (CurrentVendor != NULL)
                     {
-                        CurrentVendorName      = CurrentVendor->VendorName;
-                        Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.DeviceId);
+                        CurrentVendorName            = GetVendorName(CurrentVendor);
+                        const Device * CurrentDevice = GetDeviceFromVendor(CurrentVendor, PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.DeviceId);
 
                         if (CurrentDevice != NULL)
                         {
-                            CurrentDeviceName = CurrentDevice->DeviceName;
+                            CurrentDeviceName = GetDeviceName(CurrentDevice);
                         }
                     }
 
@@ -1252,7 +1282,6 @@ StartAgain:
                                  PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.HeaderType,
                                  (PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.HeaderType & 0x1) ? "True" : "False",
                                  PcidevinfoPacket->DeviceInfo.ConfigSpace.CommonHeader.Bist);
-                    FreeVendor(CurrentVendor);
                     FreePciIdDatabase();
 
                     ShowMessages("\nDevice Header:\n");
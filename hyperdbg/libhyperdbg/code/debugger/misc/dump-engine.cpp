@@ -0,0 +1,622 @@
+/**
+ * @file dump-engine.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief The engine of the .dump and !dump commands
+ * @details Several chunks are read at the same time while a background thread
+ * writes the previous chunks into a sparse file, and each written chunk is
+ * recorded in a manifest (<path>.manifest) so an interrupted dump can be resumed
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
+extern BOOLEAN g_IsInstrumentingInstructions;
+
+/**
+ * @brief Get the path for the platform file APIs
+ *
+ * @details std::wstring stores native wchar_t (4 bytes on Linux) while the
+ * HyperDbg WCHAR type is 2 bytes, so on Linux the pointer is only cast and the
+ * file wrappers of the platform narrow it back as wchar_t (wcstombs) before
+ * opening the file. On Windows WCHAR == wchar_t, so it is a plain pointer
+ *
+ * @param Path
+ *
+ * @return const WCHAR *
+ */
+static const WCHAR *
+DumpEngineGetPlatformPath(const std::wstring & Path)
+{
+#ifdef __linux__
+    return (const WCHAR *)Path.c_str();
+#else
+    return Path.c_str();
+#endif
+}
+
+/**
+ * @brief Callback of the writer for writing the pages into the dump file
+ *
+ * @param Context
+ * @param Offset
+ * @param Buffer
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEngineWriteData(PVOID Context, UINT64 Offset, const VOID * Buffer, UINT32 Length)
+{
+    DUMP_ENGINE_JOB * Job = (DUMP_ENGINE_JOB *)Context;
+
+    return PlatformWriteFileAtOffset(Job->DataFile, Offset, Buffer, Length);
+}
+
+/**
+ * @brief Callback of the writer for punching the holes into the dump file
+ *
+ * @param Context
+ * @param Offset
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEnginePunchHole(PVOID Context, UINT64 Offset, UINT64 Length)
+{
+    DUMP_ENGINE_JOB * Job = (DUMP_ENGINE_JOB *)Context;
+
+    return PlatformPunchFileHole(Job->DataFile, Offset, Length);
+}
+
+/**
+ * @brief Callback of the writer for appending the lines of the manifest
+ *
+ * @param Context
+ * @param Text
+ * @param Length
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEngineWriteManifest(PVOID Context, const CHAR * Text, UINT32 Length)
+{
+    DUMP_ENGINE_JOB * Job = (DUMP_ENGINE_JOB *)Context;
+
+    return PlatformWriteFile(Job->ManifestFile, Text, Length);
+}
+
+/**
+ * @brief Callback for appending the ranges of the readable pages to the manifest
+ *
+ * @param Context
+ * @param StartAddress
+ * @param EndAddress
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEngineWriteRange(PVOID Context, UINT64 StartAddress, UINT64 EndAddress)
+{
+    DUMP_ENGINE_JOB * Job = (DUMP_ENGINE_JOB *)Context;
+    CHAR              Line[MEM_DUMP_MAXIMUM_LINE];
+    UINT32            Length;
+
+    Length = MemDumpFormatRange(StartAddress, EndAddress, Line, sizeof(Line));
+
+    return Length != 0 && PlatformWriteFile(Job->ManifestFile, Line, Length);
+}
+
+/**
+ * @brief Check whether the dump is stopped (CTRL+C or a failed write)
+ *
+ * @param Job
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEngineIsStopped(DUMP_ENGINE_JOB * Job)
+{
+    return !g_IsInstrumentingInstructions || Job->IsWriteFailed;
+}
+
+/**
+ * @brief Read a chunk and classify its pages
+ *
+ * @details The whole chunk is read by a single request, and only if it fails
+ * (e.g., some of the pages are not present), the pages are read one by one to
+ * find the readable ones
+ *
+ * @param Job
+ * @param Slot
+ *
+ * @return VOID
+ */
+static VOID
+DumpEngineReadChunk(DUMP_ENGINE_JOB * Job, DUMP_ENGINE_SLOT * Slot)
+{
+    MEM_DUMP_CHUNK * Chunk = &Slot->Chunk;
+    UINT32           ReturnLength;
+    UINT32           Offset;
+    UINT32           Length;
+
+    if (HyperDbgReadMemoryQuietly(Chunk->Address,
+                                  Job->MemoryType,
+                                  READ_FROM_KERNEL,
+                                  Job->Pid,
+                                  Chunk->Length,
+                                  Slot->Buffer,
+                                  &ReturnLength) &&
+        ReturnLength == Chunk->Length)
+    {
+        Chunk->ReadableMask = Chunk->NumberOfPages == 32 ? 0xffffffff : (1u << Chunk->NumberOfPages) - 1;
+    }
+    else
+    {
+        for (UINT32 i = 0; i < Chunk->NumberOfPages; i++)
+        {
+            MemDumpGetPage(Chunk, i, &Offset, &Length);
+
+            if (HyperDbgReadMemoryQuietly(Chunk->Address + Offset,
+                                          Job->MemoryType,
+                                          READ_FROM_KERNEL,
+                                          Job->Pid,
+                                          Length,
+                                          Slot->Buffer + Offset,
+                                          &ReturnLength) &&
+                ReturnLength == Length)
+            {
+                Chunk->ReadableMask |= 1u << i;
+            }
+        }
+    }
+
+    MemDumpClassifyChunk(Chunk, Slot->Buffer);
+}
+
+/**
+ * @brief Read the chunks of a reader into the slots
+ *
+ * @param Reader
+ *
+ * @return VOID
+ */
+static VOID
+DumpEngineRead(DUMP_ENGINE_READER * Reader)
+{
+    DUMP_ENGINE_JOB * Job = Reader->Job;
+
+    for (UINT64 Index = Reader->Index; Index < Job->Plan.NumberOfChunks; Index += Job->NumberOfReaders)
+    {
+        DUMP_ENGINE_SLOT * Slot = &Job->Slots[Index % DUMP_ENGINE_NUMBER_OF_SLOTS];
+
+        PlatformWaitForSingleObject(Slot->FreeEvent, INFINITE);
+
+        auto Verified = Job->VerifiedChunks.find(Index);
+
+        if (Verified != Job->VerifiedChunks.end())
+        {
+            Slot->Chunk      = Verified->second;
+            Slot->IsVerified = TRUE;
+        }
+        else
+        {
+            MemDumpGetChunk(&Job->Plan, Index, &Slot->Chunk);
+            Slot->IsVerified = FALSE;
+
+            //
+            // The remaining chunks are only passed to the writer after stopping
+            //
+            if (!DumpEngineIsStopped(Job))
+            {
+                DumpEngineReadChunk(Job, Slot);
+            }
+        }
+
+        PlatformSetEvent(Slot->FilledEvent);
+    }
+}
+
+/**
+ * @brief The reading threads
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+DumpEngineReaderThread(PVOID Param)
+{
+    DumpEngineRead((DUMP_ENGINE_READER *)Param);
+
+    return 0;
+}
+
+/**
+ * @brief The writing thread (writes the slots in the order of the chunks)
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+DumpEngineWriterThread(PVOID Param)
+{
+    DUMP_ENGINE_JOB * Job = (DUMP_ENGINE_JOB *)Param;
+
+    for (UINT64 Index = 0; Index < Job->Plan.NumberOfChunks; Index++)
+    {
+        DUMP_ENGINE_SLOT * Slot = &Job->Slots[Index % DUMP_ENGINE_NUMBER_OF_SLOTS];
+
+        PlatformWaitForSingleObject(Slot->FilledEvent, INFINITE);
+
+        if (!DumpEngineIsStopped(Job))
+        {
+            BOOLEAN Status = Slot->IsVerified ? MemDumpWriterSkipChunk(&Job->Writer, &Slot->Chunk)
+                                              : MemDumpWriterPutChunk(&Job->Writer, &Slot->Chunk, Slot->Buffer);
+
+            if (Status)
+            {
+                Job->ReadableMasks[Index] = Slot->Chunk.ReadableMask;
+            }
+            else
+            {
+                Job->IsWriteFailed = TRUE;
+            }
+        }
+
+        PlatformSetEvent(Slot->FreeEvent);
+    }
+
+    if (!MemDumpWriterFlush(&Job->Writer))
+    {
+        Job->IsWriteFailed = TRUE;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Callback for the chunks of a previous manifest
+ *
+ * @param Context
+ * @param Chunk
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+DumpEngineAddRecordedChunk(PVOID Context, const MEM_DUMP_CHUNK * Chunk)
+{
+    std::vector<MEM_DUMP_CHUNK> * Chunks = (std::vector<MEM_DUMP_CHUNK> *)Context;
+
+    Chunks->push_back(*Chunk);
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the chunks of a previous dump that are intact in the dump file
+ *
+ * @param Job The dump file should be open
+ * @param ManifestPath
+ *
+ * @return BOOLEAN FALSE if the manifest can't be used for resuming
+ */
+static BOOLEAN
+DumpEngineVerifyPreviousDump(DUMP_ENGINE_JOB * Job, const std::wstring & ManifestPath)
+{
+    std::vector<MEM_DUMP_CHUNK> Recorded;
+    std::vector<UINT8>          Buffer(MEM_DUMP_CHUNK_SIZE);
+    SIZE_T                      ManifestSize;
+    HANDLE                      ManifestHandle;
+    DWORD                       BytesRead;
+    VOID *                      Manifest;
+    BOOLEAN                     Status;
+
+    Manifest = PlatformMapFileReadOnly(DumpEngineGetPlatformPath(ManifestPath), &ManifestSize, &ManifestHandle);
+
+    if (Manifest == NULL)
+    {
+        ShowMessages("err, unable to open the manifest of the previous dump\n");
+        return FALSE;
+    }
+
+    Status = MemDumpParseManifest(&Job->Plan, (const CHAR *)Manifest, ManifestSize, DumpEngineAddRecordedChunk, &Recorded);
+
+    PlatformUnmapFile(Manifest, ManifestSize, ManifestHandle);
+
+    if (!Status)
+    {
+        ShowMessages("err, the manifest doesn't belong to a dump of the same range\n");
+        return FALSE;
+    }
+
+    for (auto & Chunk : Recorded)
+    {
+        //
+        // The holes (and the end of a shorter file) are read as zeros
+        //
+        memset(Buffer.data(), 0, Chunk.Length);
+
+        if (!PlatformReadFileAtOffset(Job->DataFile,
+                                      Chunk.Address - Job->Plan.StartAddress,
+                                      Buffer.data(),
+                                      Chunk.Length,
+                                      &BytesRead))
+        {
+            continue;
+        }
+
+        if (MemDumpVerifyChunk(&Chunk, Buffer.data()))
+        {
+            Job->VerifiedChunks[Chunk.Index] = Chunk;
+        }
+    }
+
+    ShowMessages("resuming the dump, %llu of %llu chunk(s) are verified\n",
+                 (UINT64)Job->VerifiedChunks.size(),
+                 Job->Plan.NumberOfChunks);
+
+    return TRUE;
+}
+
+/**
+ * @brief Run the readers and the writer of a dump
+ *
+ * @param Job
+ *
+ * @return VOID
+ */
+static VOID
+DumpEngineRun(DUMP_ENGINE_JOB * Job)
+{
+    std::vector<DUMP_ENGINE_READER> Readers(Job->NumberOfReaders);
+    std::vector<HANDLE>             Threads;
+    HANDLE                          Writer;
+
+    Writer = PlatformCreateThread(DumpEngineWriterThread, Job);
+
+    if (Writer == NULL)
+    {
+        ShowMessages("err, unable to create the writing thread\n");
+        Job->IsWriteFailed = TRUE;
+        return;
+    }
+
+    for (UINT32 i = 0; i < Job->NumberOfReaders; i++)
+    {
+        Readers[i].Job   = Job;
+        Readers[i].Index = i;
+    }
+
+    //
+    // The first reader runs on the caller's thread
+    //
+    for (UINT32 i = 1; i < Job->NumberOfReaders; i++)
+    {
+        HANDLE Thread = PlatformCreateThread(DumpEngineReaderThread, &Readers[i]);
+
+        if (Thread == NULL)
+        {
+            //
+            // The chunks of this reader are read on the caller's thread
+            //
+            DumpEngineRead(&Readers[i]);
+            continue;
+        }
+
+        Threads.push_back(Thread);
+    }
+
+    DumpEngineRead(&Readers[0]);
+
+    for (auto Thread : Threads)
+    {
+        PlatformWaitForSingleObject(Thread, INFINITE);
+        PlatformCloseHandle(Thread);
+    }
+
+    PlatformWaitForSingleObject(Writer, INFINITE);
+    PlatformCloseHandle(Writer);
+}
+
+/**
+ * @brief Dump a range of the memory into a sparse file with a manifest
+ *
+ * @param Path
+ * @param StartAddress
+ * @param EndAddress The first address after the dump
+ * @param MemoryType
+ * @param Pid The process that is read
+ * @param IsPidSpecified Whether the process is a part of the dump (recorded in the manifest)
+ * @param Resume Whether the verified chunks of a previous dump are kept
+ *
+ * @return BOOLEAN TRUE if the whole range is dumped
+ */
+BOOLEAN
+DumpEngineDump(const std::wstring &      Path,
+               UINT64                    StartAddress,
+               UINT64                    EndAddress,
+               DEBUGGER_READ_MEMORY_TYPE MemoryType,
+               UINT32                    Pid,
+               BOOLEAN                   IsPidSpecified,
+               BOOLEAN                   Resume)
+{
+    DUMP_ENGINE_JOB           Job;
+    MEM_DUMP_WRITER_CALLBACKS Callbacks;
+    std::wstring              ManifestPath = Path + L".manifest";
+    std::vector<UINT8>        Staging(MEM_DUMP_WRITE_SIZE);
+    std::vector<CHAR>         Pending(DUMP_ENGINE_PENDING_MANIFEST_SIZE);
+    CHAR                      Line[MEM_DUMP_MAXIMUM_LINE];
+    UINT32                    Length;
+    BOOLEAN                   Status = FALSE;
+
+    if (!MemDumpInitializePlan(&Job.Plan,
+                               StartAddress,
+                               EndAddress,
+                               MemoryType == DEBUGGER_READ_PHYSICAL_ADDRESS,
+                               IsPidSpecified ? Pid : 0))
+    {
+        return FALSE;
+    }
+
+    Job.MemoryType = MemoryType;
+    Job.Pid        = Pid;
+
+    //
+    // The serial connection serves a single request at a time, so only the
+    // reading and the writing are overlapped
+    //
+    Job.NumberOfReaders = g_IsSerialConnectedToRemoteDebuggee ? 1 : DUMP_ENGINE_NUMBER_OF_READERS;
+
+    Job.ReadableMasks.resize((SIZE_T)Job.Plan.NumberOfChunks);
+
+    //
+    // Open the dump file (a resumed dump keeps the previous contents)
+    //
+    if (Resume)
+    {
+        Job.DataFile = PlatformOpenFileForUpdate(DumpEngineGetPlatformPath(Path));
+    }
+    else
+    {
+        Job.DataFile = PlatformOpenFileForWriting(DumpEngineGetPlatformPath(Path));
+    }
+
+    if (Job.DataFile == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create or open the file\n");
+        return FALSE;
+    }
+
+    if (!PlatformSetFileSparse(Job.DataFile))
+    {
+        ShowMessages("warning, unable to make the dump file sparse, the holes are stored as zeros\n");
+    }
+
+    if (Resume && !DumpEngineVerifyPreviousDump(&Job, ManifestPath))
+    {
+        PlatformCloseFile(Job.DataFile);
+        return FALSE;
+    }
+
+    //
+    // The manifest is written again (the verified chunks are recorded by the writer)
+    //
+    Job.ManifestFile = PlatformOpenFileForWriting(DumpEngineGetPlatformPath(ManifestPath));
+
+    if (Job.ManifestFile == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create or open the manifest file\n");
+        PlatformCloseFile(Job.DataFile);
+        return FALSE;
+    }
+
+    Length = MemDumpFormatHeader(&Job.Plan, Line, sizeof(Line));
+
+    if (Length == 0 || !PlatformWriteFile(Job.ManifestFile, Line, Length))
+    {
+        ShowMessages("err, unable to write the manifest file\n");
+        PlatformCloseFile(Job.ManifestFile);
+        PlatformCloseFile(Job.DataFile);
+        return FALSE;
+    }
+
+    //
+    // Prepare the slots and the writer
+    //
+    Callbacks.WriteData     = DumpEngineWriteData;
+    Callbacks.PunchHole     = DumpEnginePunchHole;
+    Callbacks.WriteManifest = DumpEngineWriteManifest;
+
+    MemDumpWriterInitialize(&Job.Writer,
+                            &Job.Plan,
+                            &Callbacks,
+                            &Job,
+                            Staging.data(),
+                            Pending.data(),
+                            (UINT32)Pending.size(),
+                            Resume);
+
+    std::vector<UINT8> Buffers((SIZE_T)DUMP_ENGINE_NUMBER_OF_SLOTS * MEM_DUMP_CHUNK_SIZE);
+
+    for (UINT32 i = 0; i < DUMP_ENGINE_NUMBER_OF_SLOTS; i++)
+    {
+        Job.Slots[i].Buffer      = Buffers.data() + (SIZE_T)i * MEM_DUMP_CHUNK_SIZE;
+        Job.Slots[i].FreeEvent   = PlatformCreateEvent(FALSE, TRUE);
+        Job.Slots[i].FilledEvent = PlatformCreateEvent(FALSE, FALSE);
+
+        if (Job.Slots[i].FreeEvent == NULL || Job.Slots[i].FilledEvent == NULL)
+        {
+            ShowMessages("err, unable to create the events of the dump\n");
+            Job.IsWriteFailed = TRUE;
+        }
+    }
+
+    //
+    // CTRL+C stops the dump (the dump can be resumed later)
+    //
+    g_IsInstrumentingInstructions = TRUE;
+
+    if (!Job.IsWriteFailed)
+    {
+        DumpEngineRun(&Job);
+    }
+
+    if (Job.IsWriteFailed)
+    {
+        ShowMessages("err, unable to write the dump file\n");
+    }
+    else if (!g_IsInstrumentingInstructions)
+    {
+        ShowMessages("the dump is stopped, use 'resume' with the same range and path to continue it\n");
+    }
+    else
+    {
+        //
+        // The dump is complete, record the readable ranges and the summary
+        //
+        MemDumpForEachReadableRange(&Job.Plan, Job.ReadableMasks.data(), DumpEngineWriteRange, &Job);
+
+        Length = MemDumpFormatSummary(&Job.Writer, Line, sizeof(Line));
+
+        if (Length != 0 && PlatformWriteFile(Job.ManifestFile, Line, Length) &&
+            PlatformSetFileSize(Job.DataFile, EndAddress - StartAddress))
+        {
+            ShowMessages("data: 0x%llx bytes, zero: 0x%llx bytes, unreadable: 0x%llx bytes (%llu writes)\n",
+                         Job.Writer.DataBytes,
+                         Job.Writer.ZeroBytes,
+                         Job.Writer.UnreadableBytes,
+                         Job.Writer.NumberOfWrites);
+
+            Status = TRUE;
+        }
+        else
+        {
+            ShowMessages("err, unable to complete the dump file\n");
+        }
+    }
+
+    g_IsInstrumentingInstructions = FALSE;
+
+    for (UINT32 i = 0; i < DUMP_ENGINE_NUMBER_OF_SLOTS; i++)
+    {
+        if (Job.Slots[i].FreeEvent != NULL)
+            PlatformCloseHandle(Job.Slots[i].FreeEvent);
+
+        if (Job.Slots[i].FilledEvent != NULL)
+            PlatformCloseHandle(Job.Slots[i].FilledEvent);
+    }
+
+    PlatformCloseFile(Job.ManifestFile);
+    PlatformCloseFile(Job.DataFile);
+
+    return Status;
+}
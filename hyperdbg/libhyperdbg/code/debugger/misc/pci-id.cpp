@@ -11,321 +11,201 @@
  */
 #include "pch.h"
 
-static CHAR * PciIdDatabaseBuffer = NULL;
+//
+// The index is either mapped from the cache file or (if the cache can't be
+// written) compiled in memory
+//
+static const PCI_IDS_HEADER * PciIdIndex           = NULL;
+static SIZE_T                 PciIdIndexSize       = 0;
+static HANDLE                 PciIdIndexFileHandle = INVALID_HANDLE_VALUE;
+static BOOLEAN                PciIdIndexIsMapped   = FALSE;
 
 /**
- * @brief Trims whitespaces in passed string
+ * @brief Get the path of a file of the PCI ID database
  *
- * @param Str
- * @param MaxLen
- * @return CHAR*
+ * @param RelativePath Path relative to the directory of the executable
+ * @return std::wstring
  */
-CHAR *
-TrimWhitespace(CHAR * Str, UINT8 MaxLen)
+static std::wstring
+GetPciIdFilePath(const WCHAR * RelativePath)
 {
-    CHAR * End;
-    while (*Str == ' ')
-        Str++; // Trim leading space
-    if (*Str == '\0')
-        return Str;
-    End = Str + PlatformStrnlen(Str, MaxLen) - 1;
-    while (End > Str && (*End == ' ' || *End == '\n' || *End == '\r'))
-        End--;
-    *(End + 1) = '\0';
-    return Str;
+    WCHAR CurrentPath[MAX_PATH] = {0};
+    WCHAR FilePath[MAX_PATH]    = {0};
+
+    //
+    // Get path file of current exe
+    //
+    GetModuleFileNameW(NULL, CurrentPath, MAX_PATH);
+
+    //
+    // Remove exe file name
+    //
+    PathRemoveFileSpecW(CurrentPath);
+
+    PathCombineW(FilePath, CurrentPath, RelativePath);
+
+    return std::wstring(FilePath);
 }
 
 /**
- * @brief Converts passed string to lowercase
+ * @brief Compile the database into an index and cache it
  *
- * @param Str
- * @return CHAR*
+ * @param DatabasePath
+ * @param IndexPath
+ * @param SourceSize
+ * @param SourceTimestamp
+ * @return BOOLEAN
  */
-CHAR *
-ToLower(CHAR * Str)
+static BOOLEAN
+CompilePciIdDatabase(const std::wstring & DatabasePath,
+                     const std::wstring & IndexPath,
+                     UINT64               SourceSize,
+                     UINT64               SourceTimestamp)
 {
-    UINT8  StrLength   = (UINT8)PlatformStrnlen(Str, PCI_ID_AS_STR_LENGTH);
-    CHAR * CurrentChar = Str;
+    SIZE_T TextSize   = 0;
+    HANDLE TextHandle = INVALID_HANDLE_VALUE;
+    UINT32 IndexSize  = 0;
+    VOID * Index      = NULL;
+    HANDLE IndexHandle;
+
+    const CHAR * Text = (const CHAR *)PlatformMapFileReadOnly(DatabasePath.c_str(), &TextSize, &TextHandle);
 
-    while (CurrentChar < Str + StrLength)
+    if (Text == NULL)
     {
-        *CurrentChar = tolower(*CurrentChar);
-        CurrentChar++;
+        ShowMessages("err, cannot open file '%ls'\n", DatabasePath.c_str());
+        return FALSE;
     }
-    return Str;
-}
 
-/**
- * @brief Read line from string. Treats SrcBuffer as a stream (similar to fgets and friends), i.e. updates SrcBuffer by number of characters read.
- *
- * @param DestBuffer
- * @param CharLimit
- * @param SrcBuffer
- * @return CHAR*
- */
-CHAR *
-ReadLine(CHAR * DestBuffer, UINT64 CharLimit, CHAR ** SrcBuffer)
-{
-    CHAR * Line = strchr(*SrcBuffer, '\n');
-    if (!Line)
+    IndexSize = PciIdsCompile(Text, TextSize, SourceSize, SourceTimestamp, NULL, 0);
+
+    if (IndexSize != 0)
     {
-        return NULL;
+        Index = malloc(IndexSize);
     }
-    else
+
+    if (Index == NULL || PciIdsCompile(Text, TextSize, SourceSize, SourceTimestamp, Index, IndexSize) != IndexSize)
+    {
+        free(Index);
+        PlatformUnmapFile((VOID *)Text, TextSize, TextHandle);
+        return FALSE;
+    }
+
+    PlatformUnmapFile((VOID *)Text, TextSize, TextHandle);
+
+    //
+    // Cache the index for the next time, a partially written cache is rejected
+    // by the validation (its size differs) and is compiled again
+    //
+    IndexHandle = PlatformOpenFileForWriting(IndexPath.c_str());
+
+    if (IndexHandle != INVALID_HANDLE_VALUE)
     {
-        strncpy_s(DestBuffer, CharLimit, *SrcBuffer, (Line - *SrcBuffer));
-        *SrcBuffer += (Line - *SrcBuffer + 1);
-        return *SrcBuffer;
+        PlatformWriteFile(IndexHandle, Index, IndexSize);
+        PlatformCloseFile(IndexHandle);
     }
+
+    PciIdIndex         = (const PCI_IDS_HEADER *)Index;
+    PciIdIndexSize     = IndexSize;
+    PciIdIndexIsMapped = FALSE;
+
+    return TRUE;
 }
 
 /**
- * @brief Get Vendor by PCI ID, encoded in ASCII. Do not call directly - use GetVendorById() instead.
+ * @brief Load the index of the database (if it's not already loaded)
  *
- * @param Filename
- * @param VendorId
- * @return Vendor *
+ * @return BOOLEAN
  */
-Vendor *
-GetVendorByIdStr(const CHAR * Filename, const CHAR * VendorId)
+static BOOLEAN
+LoadPciIdDatabase()
 {
-    Vendor *    MatchedVendor = NULL;
-    BOOLEAN     FoundVendorId = FALSE;
-    Device *    LastDevice    = NULL;
-    SubDevice * LastSubDevice = NULL;
-    CHAR *      PciIdDbBufPtr = NULL;
-    CHAR        Line[1024]    = {'\0'};
-
-    if (!PciIdDatabaseBuffer)
-    {
-        FILE * f      = fopen(Filename, "rb");
-        SIZE_T Length = 0;
+    UINT64 SourceSize      = 0;
+    UINT64 SourceTimestamp = 0;
+    SIZE_T IndexSize       = 0;
+    HANDLE IndexHandle     = INVALID_HANDLE_VALUE;
+    VOID * Index;
 
-        if (f == NULL)
-        {
-            ShowMessages("Error: Cannot open file '%s': error %d\n", Filename, errno);
-            return NULL;
-        }
-
-        fseek(f, 0, SEEK_END);
-        Length = ftell(f);
+    if (PciIdIndex != NULL)
+    {
+        return TRUE;
+    }
 
-        PciIdDatabaseBuffer = (CHAR *)malloc(Length);
-        if (!PciIdDatabaseBuffer)
-        {
-            return NULL;
-        }
+    std::wstring DatabasePath = GetPciIdFilePath(PCI_ID_DATABASE_PATH);
+    std::wstring IndexPath    = GetPciIdFilePath(PCI_ID_INDEX_PATH);
 
-        fseek(f, 0, SEEK_SET);
-        fread(PciIdDatabaseBuffer, 1, Length, f);
-        fclose(f);
+    if (!PlatformGetFileSizeAndTime(DatabasePath.c_str(), &SourceSize, &SourceTimestamp))
+    {
+        ShowMessages("err, cannot open file '%ls'\n", DatabasePath.c_str());
+        return FALSE;
     }
 
-    PciIdDbBufPtr = PciIdDatabaseBuffer;
+    //
+    // Use the cached index if it's compiled from the current database
+    //
+    Index = PlatformMapFileReadOnly(IndexPath.c_str(), &IndexSize, &IndexHandle);
 
-    while (ReadLine(Line, sizeof(Line), &PciIdDbBufPtr) != NULL)
+    if (Index != NULL)
     {
-        CHAR FormatStr[24];
-
-        // Skip comments and empty lines
-        if (Line[0] == '#' || Line[0] == '\0')
+        if (PciIdsValidate(Index, IndexSize, SourceSize, SourceTimestamp))
         {
-            continue;
-        }
+            PciIdIndex           = (const PCI_IDS_HEADER *)Index;
+            PciIdIndexSize       = IndexSize;
+            PciIdIndexFileHandle = IndexHandle;
+            PciIdIndexIsMapped   = TRUE;
 
-        // Find vendor
-        // We assume PCI ID database comprises unique entries only, i.e. we return the first matching entry
-        if (Line[0] != '\t' && FoundVendorId == FALSE)
-        {
-            CHAR VendorBuf[PCI_ID_AS_STR_LENGTH + 1], VendorNameBuf[PCI_NAME_STR_LENGTH + 1];
-
-            snprintf(FormatStr, sizeof(FormatStr), "%%4s %%%d[^\n]", PCI_NAME_STR_LENGTH); // FormatStr = "%4s %PCI_NAME_STR_LENGTH[^\n]"
-            if (sscanf(Line, FormatStr, VendorBuf, VendorNameBuf) == 2)
-            {
-                if (strncmp(VendorBuf, VendorId, sizeof(VendorId)) == 0)
-                {
-                    MatchedVendor = (Vendor *)malloc(sizeof(Vendor));
-                    if (!MatchedVendor)
-                    {
-                        return NULL;
-                    }
-
-                    INT Result = sscanf(VendorBuf, "%hx", &(MatchedVendor->VendorId));
-                    if (Result != 1)
-                    {
-                        return NULL;
-                    }
-                    strncpy_s(MatchedVendor->VendorName, sizeof(MatchedVendor->VendorName), TrimWhitespace(VendorNameBuf, PCI_NAME_STR_LENGTH), _TRUNCATE);
-                    FoundVendorId = TRUE;
-                }
-            }
-        }
-        // Get all devices for vendor
-        else if (Line[0] == '\t' && Line[1] != '\t' && FoundVendorId == TRUE)
-        {
-            CHAR DeviceBuf[PCI_ID_AS_STR_LENGTH + 1], DeviceNameBuf[PCI_NAME_STR_LENGTH + 1];
-
-            snprintf(FormatStr, sizeof(FormatStr), "%%4s %%%d[^\n]", PCI_NAME_STR_LENGTH); // FormatStr = "%4s %PCI_NAME_STR_LENGTH[^\n]"
-            if (sscanf(Line + 1, FormatStr, DeviceBuf, DeviceNameBuf) == 2)
-            {
-                Device * NewDevice = (Device *)malloc(sizeof(Device));
-                if (!NewDevice)
-                {
-                    FreeVendor(MatchedVendor);
-                    return NULL;
-                }
-
-                int Result = sscanf(DeviceBuf, "%hx", &(NewDevice->DeviceId));
-                if (Result != 1)
-                {
-                    FreeVendor(MatchedVendor);
-                    return NULL;
-                }
-
-                strncpy_s(NewDevice->DeviceName, sizeof(NewDevice->DeviceName), TrimWhitespace(DeviceNameBuf, PCI_NAME_STR_LENGTH), _TRUNCATE);
-                NewDevice->SubDevices = NULL;
-                NewDevice->Next       = NULL;
-
-                if (LastDevice)
-                {
-                    LastDevice->Next = NewDevice;
-                }
-                else
-                {
-                    MatchedVendor->Devices = NewDevice; // First device
-                }
-                LastDevice    = NewDevice;
-                LastSubDevice = NULL;
-            }
-        }
-        // Get all subdevices for device
-        else if (Line[0] == '\t' && Line[1] == '\t' && FoundVendorId == TRUE && LastDevice)
-        {
-            CHAR SubVendorBuf[PCI_ID_AS_STR_LENGTH + 1], SubDeviceBuf[PCI_ID_AS_STR_LENGTH + 1], SubsystemNameBuf[PCI_NAME_STR_LENGTH + 1];
-
-            snprintf(FormatStr, sizeof(FormatStr), "%%4s %%4s %%%d[^\n]", PCI_NAME_STR_LENGTH); // FormatStr = "%4s %4s %PCI_NAME_STR_LENGTH[^\n]"
-            if (sscanf(Line + 2, FormatStr, SubVendorBuf, SubDeviceBuf, SubsystemNameBuf) == 3)
-            {
-                SubDevice * NewSubDevice = (SubDevice *)malloc(sizeof(SubDevice));
-                if (!NewSubDevice)
-                {
-                    FreeVendor(MatchedVendor);
-                    return NULL;
-                }
-
-                int Result = sscanf(SubVendorBuf, "%hx", &NewSubDevice->SubVendorId);
-                if (Result != 1)
-                {
-                    FreeVendor(MatchedVendor);
-                    return NULL;
-                }
-
-                Result = sscanf(SubDeviceBuf, "%hx", &NewSubDevice->SubDeviceId);
-                if (Result != 1)
-                {
-                    FreeVendor(MatchedVendor);
-                    return NULL;
-                }
-
-                strncpy_s(NewSubDevice->SubSystemName, sizeof(NewSubDevice->SubSystemName), TrimWhitespace(SubsystemNameBuf, PCI_NAME_STR_LENGTH), _TRUNCATE);
-                NewSubDevice->Next = NULL;
-
-                if (LastSubDevice)
-                {
-                    LastSubDevice->Next = NewSubDevice;
-                }
-                else
-                {
-                    LastDevice->SubDevices = NewSubDevice; // First subdevice
-                }
-                LastSubDevice = NewSubDevice;
-            }
-        }
-        else if (Line[0] != '\t' && FoundVendorId == TRUE) // We hit the next vendor entry, so we're done parsing
-        {
-            break;
+            return TRUE;
         }
+
+        PlatformUnmapFile(Index, IndexSize, IndexHandle);
     }
 
-    return MatchedVendor;
+    return CompilePciIdDatabase(DatabasePath, IndexPath, SourceSize, SourceTimestamp);
 }
 
 /**
- * @brief Frees Vendor and all of its members
- *
- * @param VendorToFree
+ * @brief Frees the index of the database
  * @return VOID
  */
 VOID
-FreeVendor(Vendor * VendorToFree)
+FreePciIdDatabase()
 {
-    if (VendorToFree == NULL)
+    if (PciIdIndex == NULL)
+    {
         return;
+    }
 
-    Device * CurrentDevice = VendorToFree->Devices;
-    while (CurrentDevice)
+    if (PciIdIndexIsMapped)
     {
-        SubDevice * CurrentSubDevice = CurrentDevice->SubDevices;
-
-        while (CurrentSubDevice)
-        {
-            SubDevice * NextSubDevice = CurrentSubDevice->Next;
-            free(CurrentSubDevice);
-            CurrentSubDevice = NextSubDevice;
-        }
-
-        Device * NextDevice = CurrentDevice->Next;
-        free(CurrentDevice);
-        CurrentDevice = NextDevice;
+        PlatformUnmapFile((VOID *)PciIdIndex, PciIdIndexSize, PciIdIndexFileHandle);
     }
-}
-
-/**
- * @brief Frees PciIdDatabaseBuffer
- * @return VOID
- */
-VOID
-FreePciIdDatabase()
-{
-    if (PciIdDatabaseBuffer != NULL)
+    else
     {
-        free(PciIdDatabaseBuffer);
-        PciIdDatabaseBuffer = NULL;
+        free((VOID *)PciIdIndex);
     }
+
+    PciIdIndex           = NULL;
+    PciIdIndexSize       = 0;
+    PciIdIndexFileHandle = INVALID_HANDLE_VALUE;
+    PciIdIndexIsMapped   = FALSE;
 }
 
 /**
- * @brief Returns Vendor entry, including corresponding devices and subdevices
- * @details Use FreeVendor() on returned Vendor pointer after usage. First call will initialize database - call FreeDatabase() once done querying.
+ * @brief Returns Vendor entry
+ * @details First call will load the database - call FreePciIdDatabase() once
+ * done querying (the returned entries are valid until then)
  *
  * @param VendorId
- * @return Vendor
+ * @return const Vendor *
  */
-Vendor *
+const Vendor *
 GetVendorById(UINT16 VendorId)
 {
-    CHAR    VendorIdAsStr[5];
-    CHAR    ExecutablePath[MAX_PATH];
-    HMODULE hModule = GetModuleHandle(NULL);
-
-    snprintf(VendorIdAsStr, sizeof(VendorIdAsStr), "%04X", VendorId);
-    GetModuleFileName(hModule, ExecutablePath, sizeof(ExecutablePath));
-
-    // Extract executable name
-    CHAR * ExecutableName = strrchr(ExecutablePath, '\\');
-    if (ExecutableName != NULL)
-    {
-        ExecutableName++;
-    }
-    else
+    if (!LoadPciIdDatabase())
     {
-        ExecutableName = ExecutablePath;
+        return NULL;
     }
 
-    // Swap executable name for PCI_ID_DATABASE_PATH
-    strncpy(ExecutableName, PCI_ID_DATABASE_PATH, sizeof(PCI_ID_DATABASE_PATH));
-
-    return GetVendorByIdStr(ExecutablePath, ToLower(VendorIdAsStr));
+    return PciIdsFindVendor(PciIdIndex, VendorId);
 }
 
 /**
@@ -333,27 +213,17 @@ GetVendorById(UINT16 VendorId)
  *
  * @param VendorToUse
  * @param DeviceId
- * @return Device
+ * @return const Device *
  */
-Device *
-GetDeviceFromVendor(Vendor * VendorToUse, UINT16 DeviceId)
+const Device *
+GetDeviceFromVendor(const Vendor * VendorToUse, UINT16 DeviceId)
 {
-    Device * CurrentDevice = NULL;
     if (!VendorToUse)
     {
         return NULL;
     }
 
-    CurrentDevice = VendorToUse->Devices;
-    while (CurrentDevice != NULL)
-    {
-        if (CurrentDevice->DeviceId == DeviceId)
-        {
-            return CurrentDevice;
-        }
-        CurrentDevice = CurrentDevice->Next;
-    }
-    return NULL;
+    return PciIdsFindDevice(PciIdIndex, VendorToUse, DeviceId);
 }
 
 /**
@@ -362,25 +232,51 @@ GetDeviceFromVendor(Vendor * VendorToUse, UINT16 DeviceId)
  * @param DeviceToUse
  * @param SubVendorId
  * @param SubDeviceId
- * @return SubDevice
+ * @return const SubDevice *
  */
-SubDevice *
-GetSubDeviceFromDevice(Device * DeviceToUse, UINT16 SubVendorId, UINT16 SubDeviceId)
+const SubDevice *
+GetSubDeviceFromDevice(const Device * DeviceToUse, UINT16 SubVendorId, UINT16 SubDeviceId)
 {
-    SubDevice * CurrentSubDevice = NULL;
     if (!DeviceToUse)
     {
         return NULL;
     }
 
-    CurrentSubDevice = DeviceToUse->SubDevices;
-    while (CurrentSubDevice != NULL)
-    {
-        if (CurrentSubDevice->SubVendorId == SubVendorId && CurrentSubDevice->SubDeviceId == SubDeviceId)
-        {
-            return CurrentSubDevice;
-        }
-        CurrentSubDevice = CurrentSubDevice->Next;
-    }
-    return NULL;
+    return PciIdsFindSubDevice(PciIdIndex, DeviceToUse, SubVendorId, SubDeviceId);
+}
+
+/**
+ * @brief Returns the name of a vendor
+ *
+ * @param VendorToUse
+ * @return const CHAR *
+ */
+const CHAR *
+GetVendorName(const Vendor * VendorToUse)
+{
+    return PciIdsGetName(PciIdIndex, VendorToUse->Name);
+}
+
+/**
+ * @brief Returns the name of a device
+ *
+ * @param DeviceToUse
+ * @return const CHAR *
+ */
+const CHAR *
+GetDeviceName(const Device * DeviceToUse)
+{
+    return PciIdsGetName(PciIdIndex, DeviceToUse->Name);
+}
+
+/**
+ * @brief Returns the name of the subsystem of a device
+ *
+ * @param SubDeviceToUse
+ * @return const CHAR *
+ */
+const CHAR *
+GetSubDeviceName(const SubDevice * SubDeviceToUse)
+{
+    return PciIdsGetName(PciIdIndex, SubDeviceToUse->Name);
 }
@@ -0,0 +1,517 @@
+/**
+ * @file pt-analysis.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Aggregating analysis of the decoded PT traces
+ * @details Instead of printing every decoded instruction, the blocks of the
+ * block decoder are aggregated into a coverage bitmap, branch-edge counts and
+ * a per-function profile (with a call tree), which are shown as a summary
+ * and exported to the formats of the coverage and flamegraph tools
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Initialize the analysis state of a decoding thread
+ *
+ * @param State
+ * @param Modes
+ * @param Image
+ *
+ * @return VOID
+ */
+VOID
+PtAnalysisInitialize(PT_ANALYSIS_STATE * State, UINT32 Modes, IMAGE_SYMBOL_CONTEXT * Image)
+{
+    State->Modes = Modes;
+    State->Image = Image;
+
+    if (Modes & PT_ANALYSIS_MODE_COVERAGE)
+    {
+        State->CoverageBitmap.assign((SIZE_T)((Image->CodeSize + 63) / 64), 0);
+    }
+
+    if (Modes & PT_ANALYSIS_MODE_PROFILE)
+    {
+        State->CallNodes.push_back({PT_ANALYSIS_CALL_TREE_ROOT, 0, 0});
+    }
+
+    PtAnalysisResetFlow(State);
+}
+
+/**
+ * @brief Reset the flow of the analysis
+ * @details Should be called whenever the decoder (re)synchronizes, as the
+ * previous block and the call stack are not known anymore
+ *
+ * @param State
+ *
+ * @return VOID
+ */
+VOID
+PtAnalysisResetFlow(PT_ANALYSIS_STATE * State)
+{
+    State->CurrentNode  = PT_ANALYSIS_CALL_TREE_ROOT;
+    State->LastBlockEnd = 0;
+    State->LastClass    = ptic_unknown;
+}
+
+/**
+ * @brief Get (or create) the call tree node of a function called by a node
+ *
+ * @param State
+ * @param Parent
+ * @param Entry
+ *
+ * @return UINT32
+ */
+static UINT32
+PtAnalysisGetCallNode(PT_ANALYSIS_STATE * State, UINT32 Parent, UINT64 Entry)
+{
+    auto Result = State->CallChildren.emplace(std::make_pair(Parent, Entry), (UINT32)State->CallNodes.size());
+
+    if (Result.second)
+    {
+        State->CallNodes.push_back({Parent, Entry, 0});
+    }
+
+    return Result.first->second;
+}
+
+/**
+ * @brief Record a decoded block in the analysis
+ *
+ * @param State
+ * @param Block
+ *
+ * @return VOID
+ */
+VOID
+PtAnalysisRecordBlock(PT_ANALYSIS_STATE * State, const struct pt_block * Block)
+{
+    IMAGE_SYMBOL_CONTEXT * Image = State->Image;
+    UINT64                 Ip    = Block->ip;
+
+    if (Block->ninsn == 0)
+        return;
+
+    State->TotalBlocks++;
+    State->TotalInstructions += Block->ninsn;
+
+    if ((State->Modes & PT_ANALYSIS_MODE_COVERAGE) && Ip >= Image->CodeBase && Ip < Image->CodeBase + Image->CodeSize)
+    {
+        UINT64 Offset = Ip - Image->CodeBase;
+
+        State->CoverageBitmap[(SIZE_T)(Offset / 64)] |= 1ull << (Offset % 64);
+    }
+
+    if ((State->Modes & PT_ANALYSIS_MODE_EDGES) && State->LastBlockEnd != 0)
+    {
+        State->Edges[std::make_pair(State->LastBlockEnd, Ip)]++;
+    }
+
+    if (State->Modes & PT_ANALYSIS_MODE_PROFILE)
+    {
+        State->BlockInstructions[Ip] += Block->ninsn;
+
+        //
+        // The previous block ended with a call (enter the callee's node) or with a
+        // return (go back to the caller's node, unless the caller is not traced)
+        //
+        if (State->LastClass == ptic_call || State->LastClass == ptic_far_call)
+        {
+            State->CurrentNode = PtAnalysisGetCallNode(State, State->CurrentNode, Ip);
+        }
+        else if ((State->LastClass == ptic_return || State->LastClass == ptic_far_return) &&
+                 State->CurrentNode != PT_ANALYSIS_CALL_TREE_ROOT)
+        {
+            State->CurrentNode = State->CallNodes[State->CurrentNode].Parent;
+        }
+
+        State->CallNodes[State->CurrentNode].Instructions += Block->ninsn;
+    }
+
+    State->LastBlockEnd = Block->end_ip;
+    State->LastClass    = Block->iclass;
+}
+
+/**
+ * @brief Merge the analysis state of a decoding thread into another state
+ *
+ * @param Target
+ * @param Source
+ *
+ * @return VOID
+ */
+VOID
+PtAnalysisMerge(PT_ANALYSIS_STATE * Target, const PT_ANALYSIS_STATE * Source)
+{
+    Target->TotalInstructions += Source->TotalInstructions;
+    Target->TotalBlocks += Source->TotalBlocks;
+
+    for (SIZE_T i = 0; i < Source->CoverageBitmap.size() && i < Target->CoverageBitmap.size(); i++)
+    {
+        Target->CoverageBitmap[i] |= Source->CoverageBitmap[i];
+    }
+
+    for (auto & Edge : Source->Edges)
+    {
+        Target->Edges[Edge.first] += Edge.second;
+    }
+
+    for (auto & Block : Source->BlockInstructions)
+    {
+        Target->BlockInstructions[Block.first] += Block.second;
+    }
+
+    //
+    // Parents are always before their children, so the parents of each node
+    // are already mapped to the target's nodes
+    //
+    if (!Source->CallNodes.empty() && !Target->CallNodes.empty())
+    {
+        std::vector<UINT32> Map(Source->CallNodes.size(), PT_ANALYSIS_CALL_TREE_ROOT);
+
+        for (SIZE_T i = 0; i < Source->CallNodes.size(); i++)
+        {
+            const PT_ANALYSIS_CALL_NODE & Node = Source->CallNodes[i];
+
+            if (i != PT_ANALYSIS_CALL_TREE_ROOT)
+                Map[i] = PtAnalysisGetCallNode(Target, Map[Node.Parent], Node.Entry);
+
+            Target->CallNodes[Map[i]].Instructions += Node.Instructions;
+        }
+    }
+}
+
+/**
+ * @brief Open one of the exported files
+ *
+ * @param File
+ * @param Options
+ * @param Extension
+ *
+ * @return BOOLEAN FALSE if the results are not exported or the file cannot be created
+ */
+static BOOLEAN
+PtAnalysisOpenExport(std::ofstream & File, const PT_ANALYSIS_OPTIONS * Options, const CHAR * Extension)
+{
+    std::string FilePath;
+
+    if (Options->ExportPath[0] == '\0')
+        return FALSE;
+
+    FilePath = std::string(Options->ExportPath) + Extension;
+
+    File.open(FilePath, std::ios::out | std::ios::trunc);
+
+    if (!File.is_open())
+    {
+        ShowMessages("err, unable to create '%s'\n", FilePath.c_str());
+        return FALSE;
+    }
+
+    ShowMessages("[+] exporting to '%s'\n", FilePath.c_str());
+    return TRUE;
+}
+
+/**
+ * @brief Show and export the coverage
+ * @details The coverage is exported in the 'module+offset' format (one block
+ * per line) which is supported by the coverage tools (e.g., Lighthouse)
+ *
+ * @param State
+ * @param ModuleName
+ * @param Options
+ *
+ * @return VOID
+ */
+static VOID
+PtAnalysisShowCoverage(PT_ANALYSIS_STATE * State, const std::string & ModuleName, const PT_ANALYSIS_OPTIONS * Options)
+{
+    std::ofstream File;
+    UINT64        CoveredBlocks = 0;
+    BOOLEAN       Export        = PtAnalysisOpenExport(File, Options, ".cov");
+    CHAR          Line[PT_HELPER_MAXIMUM_LINE_SIZE];
+
+    for (SIZE_T i = 0; i < State->CoverageBitmap.size(); i++)
+    {
+        UINT64 Bits = State->CoverageBitmap[i];
+
+        while (Bits != 0)
+        {
+#if defined(_MSC_VER)
+            unsigned long Index;
+
+            _BitScanForward64(&Index, Bits);
+#else
+            UINT64 Index = (UINT64)__builtin_ctzll(Bits);
+#endif
+            Bits &= Bits - 1;
+
+            UINT64 Offset = (UINT64)i * 64 + Index;
+            CoveredBlocks++;
+
+            if (Export)
+            {
+                snprintf(Line, sizeof(Line), "%s+%llx\n", ModuleName.c_str(), (UINT64)(State->Image->CodeBase + Offset - State->Image->ImageBase));
+                File << Line;
+            }
+        }
+    }
+
+    ShowMessages("\n[+] coverage: %llu unique block(s) in .text (0x%llx bytes)\n", CoveredBlocks, State->Image->CodeSize);
+}
+
+/**
+ * @brief Show and export the branch-edge counts
+ *
+ * @param State
+ * @param Options
+ *
+ * @return VOID
+ */
+static VOID
+PtAnalysisShowEdges(PT_ANALYSIS_STATE * State, const PT_ANALYSIS_OPTIONS * Options)
+{
+    std::vector<std::pair<std::pair<UINT64, UINT64>, UINT64>> Edges(State->Edges.begin(), State->Edges.end());
+    std::ofstream                                             File;
+    SIZE_T                                                    Shown;
+    CHAR                                                      Line[PT_HELPER_MAXIMUM_LINE_SIZE];
+
+    Shown = std::min((SIZE_T)PT_ANALYSIS_MAXIMUM_SHOWN_ENTRIES, Edges.size());
+
+    std::partial_sort(Edges.begin(), Edges.begin() + Shown, Edges.end(), [](const auto & A, const auto & B) { return A.second > B.second; });
+
+    ShowMessages("\n[+] edges: %llu unique edge(s), the hottest ones are:\n", (UINT64)Edges.size());
+
+    for (SIZE_T i = 0; i < Shown; i++)
+    {
+        ShowMessages("    0x%016llx -> 0x%016llx  %llu\n", Edges[i].first.first, Edges[i].first.second, Edges[i].second);
+    }
+
+    if (PtAnalysisOpenExport(File, Options, ".edges.csv"))
+    {
+        File << "from,to,count\n";
+
+        for (auto & Edge : Edges)
+        {
+            snprintf(Line, sizeof(Line), "0x%llx,0x%llx,%llu\n", Edge.first.first, Edge.first.second, Edge.second);
+            File << Line;
+        }
+    }
+}
+
+/**
+ * @brief Resolve the function that contains an address
+ *
+ * @param Process
+ * @param HasSymbols
+ * @param Address
+ * @param ImageBase
+ * @param FunctionStart
+ *
+ * @return std::string
+ */
+static std::string
+PtAnalysisResolveFunction(HANDLE Process, BOOLEAN HasSymbols, UINT64 Address, UINT64 ImageBase, UINT64 * FunctionStart)
+{
+    CHAR Name[PT_HELPER_MAXIMUM_LINE_SIZE];
+
+#ifdef _WIN32
+    union
+    {
+        SYMBOL_INFO Info;
+        BYTE        Buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+    } Symbol             = {0};
+    DWORD64 Displacement = 0;
+
+    Symbol.Info.SizeOfStruct = sizeof(SYMBOL_INFO);
+    Symbol.Info.MaxNameLen   = MAX_SYM_NAME;
+
+    if (HasSymbols && SymFromAddr(Process, (DWORD64)Address, &Displacement, &Symbol.Info))
+    {
+        *FunctionStart = Symbol.Info.Address;
+        return std::string(Symbol.Info.Name);
+    }
+#else
+    UNREFERENCED_PARAMETER(Process);
+    UNREFERENCED_PARAMETER(HasSymbols);
+#endif
+
+    //
+    // Without the symbols, each address is its own function
+    //
+    snprintf(Name, sizeof(Name), "exe+0x%llx", (UINT64)(Address - ImageBase));
+
+    *FunctionStart = Address;
+    return std::string(Name);
+}
+
+/**
+ * @brief Show and export the per-function histogram and the call tree
+ * @details The call tree is exported in the folded stacks format (one stack
+ * per line followed by its instruction count) of the flamegraph tools
+ *
+ * @param State
+ * @param Process
+ * @param ImagePath
+ * @param Options
+ *
+ * @return VOID
+ */
+static VOID
+PtAnalysisShowProfile(PT_ANALYSIS_STATE * State, HANDLE Process, const CHAR * ImagePath, const PT_ANALYSIS_OPTIONS * Options)
+{
+    std::map<UINT64, std::pair<std::string, UINT64>> Functions;
+    std::vector<std::pair<std::string, UINT64>>      Histogram;
+    std::vector<std::string>                         NodeNames(State->CallNodes.size());
+    std::ofstream                                    File;
+    BOOLEAN                                          HasSymbols = FALSE;
+    SIZE_T                                           Shown;
+    UINT64                                           ImageBase = State->Image->ImageBase;
+    UINT64                                           Start;
+    CHAR                                             Line[PT_HELPER_MAXIMUM_LINE_SIZE];
+
+#ifdef _WIN32
+    SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+
+    if (ImagePath != NULL && SymInitialize(Process, NULL, FALSE))
+    {
+        HasSymbols = SymLoadModuleEx(Process, NULL, ImagePath, NULL, (DWORD64)ImageBase, 0, NULL, 0) != 0;
+
+        if (!HasSymbols)
+            SymCleanup(Process);
+    }
+#else
+    //
+    // TODO(Linux): no DbgHelp (and no PDB parser) on Linux yet
+    //
+    UNREFERENCED_PARAMETER(ImagePath);
+#endif
+
+    if (!HasSymbols)
+        ShowMessages("[!] symbols of the image are not available, functions are shown by their addresses\n");
+
+    //
+    // Instructions of the blocks are accumulated into their functions
+    //
+    for (auto & Block : State->BlockInstructions)
+    {
+        std::string Name = PtAnalysisResolveFunction(Process, HasSymbols, Block.first, ImageBase, &Start);
+
+        auto & Function = Functions[Start];
+        Function.first  = Name;
+        Function.second += Block.second;
+    }
+
+    for (auto & Function : Functions)
+    {
+        Histogram.push_back(Function.second);
+    }
+
+    Shown = std::min((SIZE_T)PT_ANALYSIS_MAXIMUM_SHOWN_ENTRIES, Histogram.size());
+
+    std::partial_sort(Histogram.begin(), Histogram.begin() + Shown, Histogram.end(), [](const auto & A, const auto & B) { return A.second > B.second; });
+
+    ShowMessages("\n[+] profile: %llu function(s), the hottest ones (by self instructions) are:\n", (UINT64)Histogram.size());
+
+    for (SIZE_T i = 0; i < Shown; i++)
+    {
+        ShowMessages("    %6.2f%%  %14llu  %s\n",
+                     State->TotalInstructions ? (Histogram[i].second * 100.0) / State->TotalInstructions : 0.0,
+                     Histogram[i].second,
+                     Histogram[i].first.c_str());
+    }
+
+    if (PtAnalysisOpenExport(File, Options, ".profile.csv"))
+    {
+        File << "function,instructions,percent\n";
+
+        for (auto & Entry : Histogram)
+        {
+            snprintf(Line,
+                     sizeof(Line),
+                     "\"%s\",%llu,%.4f\n",
+                     Entry.first.c_str(),
+                     Entry.second,
+                     State->TotalInstructions ? (Entry.second * 100.0) / State->TotalInstructions : 0.0);
+            File << Line;
+        }
+
+        File.close();
+    }
+
+    if (PtAnalysisOpenExport(File, Options, ".folded"))
+    {
+        //
+        // Nodes are after their parents, so the name of the parent's stack is already built
+        //
+        for (SIZE_T i = 0; i < State->CallNodes.size(); i++)
+        {
+            const PT_ANALYSIS_CALL_NODE & Node = State->CallNodes[i];
+
+            if (i == PT_ANALYSIS_CALL_TREE_ROOT)
+            {
+                NodeNames[i] = "[trace]";
+            }
+            else
+            {
+                std::string Name = PtAnalysisResolveFunction(Process, HasSymbols, Node.Entry, ImageBase, &Start);
+
+                //
+                // Separators of the folded format are not allowed in the frame names
+                //
+                std::replace(Name.begin(), Name.end(), ';', '_');
+                std::replace(Name.begin(), Name.end(), ' ', '_');
+
+                NodeNames[i] = NodeNames[Node.Parent] + ";" + Name;
+            }
+
+            if (Node.Instructions != 0)
+                File << NodeNames[i] << " " << Node.Instructions << "\n";
+        }
+    }
+
+#ifdef _WIN32
+    if (HasSymbols)
+        SymCleanup(Process);
+#endif
+}
+
+/**
+ * @brief Show the results of the analysis and export them to the files
+ *
+ * @param State
+ * @param Process The traced process (used for resolving the symbols)
+ * @param ImagePath Path of the traced image or NULL if it's unknown
+ * @param Options
+ *
+ * @return VOID
+ */
+VOID
+PtAnalysisShowAndExport(PT_ANALYSIS_STATE * State, HANDLE Process, const CHAR * ImagePath, const PT_ANALYSIS_OPTIONS * Options)
+{
+    std::string ModuleName = "exe";
+
+    if (ImagePath != NULL)
+    {
+        const CHAR * Separator = strrchr(ImagePath, '\\');
+
+        ModuleName = (Separator != NULL) ? Separator + 1 : ImagePath;
+    }
+
+    ShowMessages("\n[+] analyzed %llu instruction(s) in %llu block(s)\n", State->TotalInstructions, State->TotalBlocks);
+
+    if (State->Modes & PT_ANALYSIS_MODE_COVERAGE)
+        PtAnalysisShowCoverage(State, ModuleName, Options);
+
+    if (State->Modes & PT_ANALYSIS_MODE_EDGES)
+        PtAnalysisShowEdges(State, Options);
+
+    if (State->Modes & PT_ANALYSIS_MODE_PROFILE)
+        PtAnalysisShowProfile(State, Process, ImagePath, Options);
+}
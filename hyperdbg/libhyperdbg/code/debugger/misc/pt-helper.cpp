@@ -13,6 +13,9 @@
 
 /**
  * @brief Read the process image for PT decoding
+ * @details The image is only mapped into the address space of the traced
+ * process, the other address spaces (known from the PIP packets) have nothing
+ * mapped
  *
  * @param Buffer
  * @param Size
@@ -23,15 +26,17 @@
  * @return int
  */
 int
-PtHelperReadImage(UINT8 * Buffer, SIZE_T Size, const struct pt_asid * Asid, UINT64 Ip, VOID * Context)
+PtHelperReadImage(uint8_t * Buffer, size_t Size, const struct pt_asid * Asid, uint64_t Ip, VOID * Context)
 {
-    (VOID) Asid;
-
     IMAGE_SYMBOL_CONTEXT * Ctx = (IMAGE_SYMBOL_CONTEXT *)Context;
 
     if (Ctx == NULL || Ctx->Code == NULL || Ip < Ctx->CodeBase || Ip >= Ctx->CodeBase + Ctx->CodeSize)
         return -pte_nomap;
 
+    if (Ctx->Cr3 != 0 && Asid != NULL && Asid->cr3 != pt_asid_no_cr3 &&
+        ((Asid->cr3 ^ Ctx->Cr3) & PT_HELPER_CR3_ADDRESS_MASK) != 0)
+        return -pte_nomap;
+
     UINT64 Available = Ctx->CodeBase + Ctx->CodeSize - Ip;
     SIZE_T Count     = (Size < Available) ? Size : (SIZE_T)Available;
 
@@ -52,6 +57,7 @@ PtHelperReadImage(UINT8 * Buffer, SIZE_T Size, const struct pt_asid * Asid, UINT
 BOOLEAN
 PtHelperCaptureImage(HANDLE Process, UINT64 * TextStart, UINT64 * TextEnd, IMAGE_SYMBOL_CONTEXT * Ctx)
 {
+#ifdef _WIN32
     HMODULE            Ntdll = GetModuleHandleA("ntdll.dll");
     PFN_NT_QIP         NtQip = Ntdll ? (PFN_NT_QIP)GetProcAddress(Ntdll, "NtQueryInformationProcess") : NULL;
     PROC_BASIC_INFO    Pbi   = {0};
@@ -112,6 +118,18 @@ PtHelperCaptureImage(HANDLE Process, UINT64 * TextStart, UINT64 * TextEnd, IMAGE
     }
 
     return FALSE;
+#else
+    //
+    // TODO(Linux): the traces are only captured on Windows, Linux only
+    // decodes the saved traces
+    //
+    UNREFERENCED_PARAMETER(Process);
+    UNREFERENCED_PARAMETER(TextStart);
+    UNREFERENCED_PARAMETER(TextEnd);
+    UNREFERENCED_PARAMETER(Ctx);
+
+    return FALSE;
+#endif
 }
 
 /**
@@ -129,6 +147,7 @@ PtHelperCaptureImage(HANDLE Process, UINT64 * TextStart, UINT64 * TextEnd, IMAGE
 BOOLEAN
 PtHelperResolveFunction(HANDLE Process, const CHAR * Path, const CHAR * Name, UINT64 ImageBase, UINT64 * Start, UINT64 * End)
 {
+#ifdef _WIN32
     union
     {
         SYMBOL_INFO Info;
@@ -155,6 +174,19 @@ PtHelperResolveFunction(HANDLE Process, const CHAR * Path, const CHAR * Name, UI
 
     SymCleanup(Process);
     return Ok;
+#else
+    //
+    // TODO(Linux): no DbgHelp, the same as the other symbol functions
+    //
+    UNREFERENCED_PARAMETER(Process);
+    UNREFERENCED_PARAMETER(Path);
+    UNREFERENCED_PARAMETER(Name);
+    UNREFERENCED_PARAMETER(ImageBase);
+    UNREFERENCED_PARAMETER(Start);
+    UNREFERENCED_PARAMETER(End);
+
+    return FALSE;
+#endif
 }
 
 /**
@@ -257,17 +289,97 @@ PtHelperReconstructIp(const struct pt_packet_ip * Packet, UINT64 * LastIp)
 }
 
 /**
- * @brief Decode PT packets
+ * @brief Append a formatted line to the decoder's output
+ * @details If the output is streamed, the text is shown as soon as it
+ * exceeds the flush size, otherwise it is kept until the caller shows it
+ *
+ * @param Output
+ * @param Format
+ *
+ * @return VOID
+ */
+static VOID
+PtHelperAppendOutput(PT_HELPER_DECODE_OUTPUT * Output, const CHAR * Format, ...)
+{
+    CHAR    Line[PT_HELPER_MAXIMUM_LINE_SIZE];
+    va_list ArgList;
+    INT     Length;
+
+    va_start(ArgList, Format);
+    Length = PlatformVsnprintf(Line, sizeof(Line), Format, ArgList);
+    va_end(ArgList);
+
+    if (Length <= 0)
+        return;
+
+    Output->Text.append(Line, std::min((SIZE_T)Length, (SIZE_T)(sizeof(Line) - 1)));
+
+    if (Output->Stream && Output->Text.size() >= PT_HELPER_OUTPUT_FLUSH_SIZE)
+        PtHelperShowOutput(Output);
+}
+
+/**
+ * @brief Append an already formatted text to the decoder's output
+ *
+ * @param Output
+ * @param Text
+ *
+ * @return VOID
+ */
+static VOID
+PtHelperAppendText(PT_HELPER_DECODE_OUTPUT * Output, const std::string & Text)
+{
+    Output->Text += Text;
+
+    if (Output->Stream && Output->Text.size() >= PT_HELPER_OUTPUT_FLUSH_SIZE)
+        PtHelperShowOutput(Output);
+}
+
+/**
+ * @brief Show (and clear) the buffered output of a decoder
+ * @details The text is shown in chunks that end on a line boundary, as
+ * ShowMessages has a limited buffer
+ *
+ * @param Output
+ *
+ * @return VOID
+ */
+VOID
+PtHelperShowOutput(PT_HELPER_DECODE_OUTPUT * Output)
+{
+    SIZE_T Offset = 0;
+
+    while (Offset < Output->Text.size())
+    {
+        SIZE_T Length = Output->Text.size() - Offset;
+
+        if (Length > PT_HELPER_OUTPUT_CHUNK_SIZE)
+        {
+            SIZE_T LineEnd = Output->Text.rfind('\n', Offset + PT_HELPER_OUTPUT_CHUNK_SIZE - 1);
+
+            Length = (LineEnd != std::string::npos && LineEnd >= Offset) ? LineEnd - Offset + 1 : PT_HELPER_OUTPUT_CHUNK_SIZE;
+        }
+
+        ShowMessages("%.*s", (int)Length, Output->Text.c_str() + Offset);
+        Offset += Length;
+    }
+
+    Output->Text.clear();
+}
+
+/**
+ * @brief Decode PT packets into the output
  *
  * @param Cpu
  * @param Buffer
  * @param Size
  * @param ImageBase
+ * @param Output
  *
  * @return UINT64
  */
-UINT64
-PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64 ImageBase)
+static UINT64
+PtHelperDecodePacketsToOutput(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64 ImageBase, PT_HELPER_DECODE_OUTPUT * Output)
 {
     struct pt_config           Config;
     struct pt_packet_decoder * Decoder;
@@ -282,7 +394,7 @@ PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64
     Decoder = pt_pkt_alloc_decoder(&Config);
     if (Decoder == NULL)
     {
-        ShowMessages("[-] core %u: cannot allocate packet decoder\n", Cpu);
+        PtHelperAppendOutput(Output, "[-] core %u: cannot allocate packet decoder\n", Cpu);
         return 0;
     }
 
@@ -306,10 +418,10 @@ PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64
             {
             case ppt_tnt_8:
             case ppt_tnt_64:
-                ShowMessages("    %-8s %2u  ", PtHelperPacketName(Packet.type), Packet.payload.tnt.bit_size);
+                PtHelperAppendOutput(Output, "    %-8s %2u  ", PtHelperPacketName(Packet.type), Packet.payload.tnt.bit_size);
                 for (UINT8 Bit = 0; Bit < Packet.payload.tnt.bit_size && Bit < 64; Bit++)
-                    putchar(((Packet.payload.tnt.payload >> (Packet.payload.tnt.bit_size - 1 - Bit)) & 1) ? 'T' : 'N');
-                putchar('\n');
+                    Output->Text.push_back(((Packet.payload.tnt.payload >> (Packet.payload.tnt.bit_size - 1 - Bit)) & 1) ? 'T' : 'N');
+                Output->Text.push_back('\n');
                 break;
 
             case ppt_tip:
@@ -317,31 +429,32 @@ PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64
             case ppt_tip_pge:
             case ppt_tip_pgd:
                 if (Packet.payload.ip.ipc == pt_ipc_suppressed)
-                    ShowMessages("    %-8s (ip suppressed)\n", PtHelperPacketName(Packet.type));
+                    PtHelperAppendOutput(Output, "    %-8s (ip suppressed)\n", PtHelperPacketName(Packet.type));
                 else
                 {
                     UINT64 Ip = PtHelperReconstructIp(&Packet.payload.ip, &LastIp);
-                    ShowMessages("    %-8s 0x%016llx  exe+0x%llx\n",
-                                 PtHelperPacketName(Packet.type),
-                                 (UINT64)Ip,
-                                 (UINT64)(Ip - ImageBase));
+                    PtHelperAppendOutput(Output,
+                                         "    %-8s 0x%016llx  exe+0x%llx\n",
+                                         PtHelperPacketName(Packet.type),
+                                         (UINT64)Ip,
+                                         (UINT64)(Ip - ImageBase));
                 }
                 break;
 
             case ppt_pip:
-                ShowMessages("    %-8s cr3=0x%llx\n", PtHelperPacketName(Packet.type), (UINT64)Packet.payload.pip.cr3);
+                PtHelperAppendOutput(Output, "    %-8s cr3=0x%llx\n", PtHelperPacketName(Packet.type), (UINT64)Packet.payload.pip.cr3);
                 break;
 
             case ppt_cbr:
-                // ShowMessages("    %-8s ratio=%u\n", PtHelperPacketName(Packet.type), Packet.payload.cbr.ratio);
+                // PtHelperAppendOutput(Output, "    %-8s ratio=%u\n", PtHelperPacketName(Packet.type), Packet.payload.cbr.ratio);
                 break;
 
             case ppt_tsc:
-                ShowMessages("    %-8s tsc=0x%llx\n", PtHelperPacketName(Packet.type), (UINT64)Packet.payload.tsc.tsc);
+                PtHelperAppendOutput(Output, "    %-8s tsc=0x%llx\n", PtHelperPacketName(Packet.type), (UINT64)Packet.payload.tsc.tsc);
                 break;
 
             default:
-                // ShowMessages("    %-8s\n", PtHelperPacketName(Packet.type));
+                // PtHelperAppendOutput(Output, "    %-8s\n", PtHelperPacketName(Packet.type));
                 break;
             }
         }
@@ -352,52 +465,166 @@ PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64
 }
 
 /**
- * @brief Decode PT instructions
+ * @brief Get the decoded instruction at the IP from the cache
+ * @details The instruction is disassembled (and its line is formatted) only
+ * the first time it's executed, afterwards it's just a lookup
+ *
+ * @param Cache
+ * @param Ip
+ * @param Mode
+ * @param Raw Bytes of the instruction if it's truncated in the captured image
+ * @param RawSize
+ *
+ * @return const PT_HELPER_CACHED_INSTRUCTION *
+ */
+static const PT_HELPER_CACHED_INSTRUCTION *
+PtHelperGetCachedInstruction(PT_HELPER_INSTRUCTION_CACHE * Cache, UINT64 Ip, enum pt_exec_mode Mode, const UINT8 * Raw, UINT8 RawSize)
+{
+    IMAGE_SYMBOL_CONTEXT *       Ctx = Cache->Image;
+    PT_HELPER_CACHED_INSTRUCTION Entry;
+    ZydisDisassembledInstruction Disasm;
+    CHAR                         Line[PT_HELPER_MAXIMUM_LINE_SIZE];
+    const UINT8 *                Bytes     = Raw;
+    SIZE_T                       BytesSize = RawSize;
+
+    auto Found = Cache->Instructions.find(Ip);
+
+    if (Found != Cache->Instructions.end() && Found->second.Mode == Mode)
+        return &Found->second;
+
+    if (Raw == NULL && Ip >= Ctx->CodeBase && Ip < Ctx->CodeBase + Ctx->CodeSize)
+    {
+        Bytes     = Ctx->Code + (Ip - Ctx->CodeBase);
+        BytesSize = (SIZE_T)std::min<UINT64>(Ctx->CodeBase + Ctx->CodeSize - Ip, ZYDIS_MAX_INSTRUCTION_LENGTH);
+    }
+
+    Entry.Mode = Mode;
+    Entry.Size = 0;
+
+    if (Bytes != NULL && BytesSize != 0 &&
+        ZYAN_SUCCESS(ZydisDisassembleIntel((Mode == ptem_32bit) ? ZYDIS_MACHINE_MODE_LEGACY_32 : ZYDIS_MACHINE_MODE_LONG_64,
+                                           Ip,
+                                           Bytes,
+                                           BytesSize,
+                                           &Disasm)))
+    {
+        Entry.Size = Disasm.info.length;
+        snprintf(Line, sizeof(Line), "    0x%016llx  exe+0x%-6llx  %s\n", (UINT64)Ip, (UINT64)(Ip - Ctx->ImageBase), Disasm.text);
+    }
+    else
+    {
+        snprintf(Line, sizeof(Line), "    0x%016llx  (undecodable)\n", (UINT64)Ip);
+    }
+
+    Entry.Text = Line;
+
+    return &(Cache->Instructions[Ip] = std::move(Entry));
+}
+
+/**
+ * @brief Show the instructions of a single PT block into the output
+ *
+ * @param Block
+ * @param Cache
+ * @param Output
+ *
+ * @return UINT64 Number of shown instructions
+ */
+static UINT64
+PtHelperShowBlock(const struct pt_block * Block, PT_HELPER_INSTRUCTION_CACHE * Cache, PT_HELPER_DECODE_OUTPUT * Output)
+{
+    UINT64 Ip = Block->ip;
+
+    for (UINT16 i = 0; i < Block->ninsn; i++)
+    {
+        BOOLEAN IsTruncated = (i == Block->ninsn - 1) && Block->truncated;
+
+        //
+        // The decoder only gives the bytes of the last instruction, and only if
+        // it crosses the end of the captured image
+        //
+        const PT_HELPER_CACHED_INSTRUCTION * Instruction = PtHelperGetCachedInstruction(Cache,
+                                                                                         Ip,
+                                                                                         Block->mode,
+                                                                                         IsTruncated ? Block->raw : NULL,
+                                                                                         IsTruncated ? Block->size : 0);
+
+        PtHelperAppendText(Output, Instruction->Text);
+
+        if (Instruction->Size == 0)
+        {
+            //
+            // Cannot find the next instruction of the block without its length
+            //
+            return (UINT64)i + 1;
+        }
+
+        Ip += Instruction->Size;
+    }
+
+    return Block->ninsn;
+}
+
+/**
+ * @brief Decode PT instructions into the output
+ * @details Uses the block decoder, so the trace is walked once per block (not
+ * once per instruction) and the instructions of the blocks come from the cache.
+ * If an analysis is given, the blocks are recorded in it instead of being shown
  *
  * @param Cpu
  * @param Buffer
  * @param Size
- * @param Ctx
+ * @param Cache
+ * @param Analysis The analysis of the decoding thread, or NULL
+ * @param Output
  *
  * @return UINT64
  */
-UINT64
-PtHelperDecodeCore(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, IMAGE_SYMBOL_CONTEXT * Ctx)
+static UINT64
+PtHelperDecodeInstructionsToOutput(UINT32                        Cpu,
+                                   const UINT8 *                 Buffer,
+                                   UINT64                        Size,
+                                   PT_HELPER_INSTRUCTION_CACHE * Cache,
+                                   PT_ANALYSIS_STATE *           Analysis,
+                                   PT_HELPER_DECODE_OUTPUT *     Output)
 {
-    struct pt_config         Config;
-    struct pt_insn_decoder * Decoder;
-    struct pt_image *        Image;
-    UINT64                   Count = 0;
-    int                      Status;
+    struct pt_config          Config;
+    struct pt_block_decoder * Decoder;
+    struct pt_image *         Image;
+    UINT64                    Count = 0;
+    int                       Status;
 
     pt_config_init(&Config);
     Config.begin = (UINT8 *)Buffer;
     Config.end   = (UINT8 *)Buffer + Size;
 
-    Decoder = pt_insn_alloc_decoder(&Config);
+    Decoder = pt_blk_alloc_decoder(&Config);
     if (Decoder == NULL)
     {
-        ShowMessages("[-] core %u: cannot allocate instruction decoder\n", Cpu);
+        PtHelperAppendOutput(Output, "[-] core %u: cannot allocate block decoder\n", Cpu);
         return 0;
     }
 
-    Image = pt_insn_get_image(Decoder);
-    pt_image_set_callback(Image, PtHelperReadImage, Ctx);
+    Image = pt_blk_get_image(Decoder);
+    pt_image_set_callback(Image, PtHelperReadImage, Cache->Image);
 
     for (;;)
     {
-        Status = pt_insn_sync_forward(Decoder);
+        Status = pt_blk_sync_forward(Decoder);
         if (Status < 0)
             break;
 
+        if (Analysis != NULL)
+            PtAnalysisResetFlow(Analysis);
+
         for (;;)
         {
-            struct pt_insn Insn;
+            struct pt_block Block = {0};
 
             while (Status & pts_event_pending)
             {
                 struct pt_event Event;
-                Status = pt_insn_event(Decoder, &Event, sizeof(Event));
+                Status = pt_blk_event(Decoder, &Event, sizeof(Event));
                 if (Status < 0)
                     break;
             }
@@ -405,28 +632,340 @@ PtHelperDecodeCore(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, IMAGE_SYMBOL_C
             if (Status < 0 || (Status & pts_eos))
                 break;
 
-            Status = pt_insn_next(Decoder, &Insn, sizeof(Insn));
+            Status = pt_blk_next(Decoder, &Block, sizeof(Block));
+
+            //
+            // The block is not consumed if the decoder fails, it resyncs at the next PSB
+            //
             if (Status < 0)
                 break;
 
-            ZydisDisassembledInstruction Disasm;
-            ZydisMachineMode             Mode = (Insn.mode == ptem_32bit) ? ZYDIS_MACHINE_MODE_LEGACY_32 : ZYDIS_MACHINE_MODE_LONG_64;
-
-            if (ZYAN_SUCCESS(ZydisDisassembleIntel(Mode, Insn.ip, Insn.raw, Insn.size, &Disasm)))
-                ShowMessages("    0x%016llx  exe+0x%-6llx  %s\n",
-                             (UINT64)Insn.ip,
-                             (UINT64)(Insn.ip - Ctx->ImageBase),
-                             Disasm.text);
+            if (Analysis != NULL)
+            {
+                PtAnalysisRecordBlock(Analysis, &Block);
+                Count += Block.ninsn;
+            }
             else
-                ShowMessages("    0x%016llx  (undecodable)\n", (UINT64)Insn.ip);
-
-            Count++;
+            {
+                Count += PtHelperShowBlock(&Block, Cache, Output);
+            }
         }
 
         if (Status >= 0 && (Status & pts_eos))
             break;
     }
 
-    pt_insn_free_decoder(Decoder);
+    pt_blk_free_decoder(Decoder);
     return Count;
 }
+
+/**
+ * @brief Decode PT packets
+ *
+ * @param Cpu
+ * @param Buffer
+ * @param Size
+ * @param ImageBase
+ *
+ * @return UINT64
+ */
+UINT64
+PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64 ImageBase)
+{
+    PT_HELPER_DECODE_OUTPUT Output;
+    UINT64                  Count;
+
+    Output.Stream = TRUE;
+
+    Count = PtHelperDecodePacketsToOutput(Cpu, Buffer, Size, ImageBase, &Output);
+    PtHelperShowOutput(&Output);
+
+    return Count;
+}
+
+/**
+ * @brief Decode PT instructions
+ *
+ * @param Cpu
+ * @param Buffer
+ * @param Size
+ * @param Ctx
+ *
+ * @return UINT64
+ */
+UINT64
+PtHelperDecodeCore(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, IMAGE_SYMBOL_CONTEXT * Ctx)
+{
+    PT_HELPER_INSTRUCTION_CACHE Cache;
+    PT_HELPER_DECODE_OUTPUT     Output;
+    UINT64                      Count;
+
+    Cache.Image   = Ctx;
+    Output.Stream = TRUE;
+
+    Count = PtHelperDecodeInstructionsToOutput(Cpu, Buffer, Size, &Cache, NULL, &Output);
+    PtHelperShowOutput(&Output);
+
+    return Count;
+}
+
+/**
+ * @brief Find the offset of the next PSB packet
+ *
+ * @param Buffer
+ * @param Size
+ * @param From
+ *
+ * @return UINT64 The offset of the PSB, or Size if there is no more PSB
+ */
+static UINT64
+PtHelperFindNextPsb(const UINT8 * Buffer, UINT64 Size, UINT64 From)
+{
+    //
+    // PSB is the 16-byte pattern of 02 82 repeated 8 times
+    //
+    static const UINT8 PsbPattern[] = {0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82};
+
+    while (From + sizeof(PsbPattern) <= Size)
+    {
+        const UINT8 * Candidate = (const UINT8 *)memchr(Buffer + From, PsbPattern[0], (SIZE_T)(Size - From - sizeof(PsbPattern) + 1));
+
+        if (Candidate == NULL)
+            break;
+
+        From = (UINT64)(Candidate - Buffer);
+
+        if (memcmp(Candidate, PsbPattern, sizeof(PsbPattern)) == 0)
+            return From;
+
+        From++;
+    }
+
+    return Size;
+}
+
+/**
+ * @brief Decode a single segment of the parallel decoding
+ *
+ * @param Thread The decoding thread
+ * @param Task
+ *
+ * @return VOID
+ */
+static VOID
+PtHelperDecodeTask(PT_HELPER_DECODE_THREAD * Thread, PT_HELPER_DECODE_TASK * Task)
+{
+    PT_HELPER_DECODE_JOB * Job  = Thread->Job;
+    PT_HELPER_CORE_TRACE * Core = &Job->Cores[Task->CoreIndex];
+
+    Task->Count = Job->Packets
+                      ? PtHelperDecodePacketsToOutput(Core->Cpu, Task->Buffer, Task->Size, Job->Ctx->ImageBase, &Task->Output)
+                      : PtHelperDecodeInstructionsToOutput(Core->Cpu,
+                                                           Task->Buffer,
+                                                           Task->Size,
+                                                           &Thread->Cache,
+                                                           Job->Analysis != NULL ? &Thread->Analysis : NULL,
+                                                           &Task->Output);
+}
+
+/**
+ * @brief Worker thread of the parallel decoding
+ * @details Claims the segments in order (so the first segments, which are
+ * shown first, are decoded first) and signals each one once it's decoded.
+ * A segment is only claimed once it's in the window of the segments after
+ * the one that is being shown. Each thread has its own instruction cache and
+ * analysis, so they need no locking
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+PtHelperDecodeWorkerThread(PVOID Param)
+{
+    PT_HELPER_DECODE_THREAD * Thread = (PT_HELPER_DECODE_THREAD *)Param;
+
+    for (auto & Task : Thread->Job->Tasks)
+    {
+        PlatformWaitForSingleObject(Task.StartEvent, INFINITE);
+
+        if (CpuInterlockedBitTestAndSet(&Task.Claimed, 0))
+            continue;
+
+        PtHelperDecodeTask(Thread, &Task);
+        PlatformSetEvent(Task.DoneEvent);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Decode the trace of several cores in parallel
+ * @details The trace of each core is split at PSB packets into segments of
+ * about PT_HELPER_DECODE_SEGMENT_SIZE bytes. As a PSB resets the decoder
+ * state, each segment is decoded independently on a pool of worker threads,
+ * while the caller's thread shows the results of the segments in their
+ * original order (and decodes the segments that are not claimed yet by the
+ * workers). At the segment boundaries, the instruction decoder resyncs at
+ * the PSB exactly as if the decoder had lost the sync. Only a fixed window of
+ * segments is decoded ahead of the shown one, so the buffered text of the
+ * segments doesn't grow with the size of the trace
+ *
+ * If an analysis is given, the instructions are not shown and instead the
+ * analysis of all the decoding threads are merged into it
+ *
+ * @param Cores
+ * @param NumberOfCores
+ * @param Packets
+ * @param Ctx
+ * @param Analysis An initialized analysis state, or NULL to show the instructions
+ *
+ * @return UINT64 Total number of decoded packets or instructions
+ */
+UINT64
+PtHelperDecodeCoresParallel(PT_HELPER_CORE_TRACE * Cores,
+                            UINT32                 NumberOfCores,
+                            BOOLEAN                Packets,
+                            IMAGE_SYMBOL_CONTEXT * Ctx,
+                            PT_ANALYSIS_STATE *    Analysis)
+{
+    PT_HELPER_DECODE_JOB                 Job;
+    std::vector<PT_HELPER_DECODE_THREAD> Threads;
+    std::vector<HANDLE>                  Workers;
+    UINT32                               NumberOfWorkers;
+    SIZE_T                               Window;
+    UINT64                               Total = 0;
+
+    Job.Cores    = Cores;
+    Job.Packets  = Packets;
+    Job.Ctx      = Ctx;
+    Job.Analysis = Analysis;
+
+    //
+    // Split the trace of each core into the segments
+    //
+    for (UINT32 i = 0; i < NumberOfCores; i++)
+    {
+        UINT64 Start = 0;
+
+        while (Start < Cores[i].Size)
+        {
+            UINT64 End = Start + PT_HELPER_DECODE_SEGMENT_SIZE;
+
+            End = (End >= Cores[i].Size) ? Cores[i].Size : PtHelperFindNextPsb(Cores[i].Buffer, Cores[i].Size, End);
+
+            PT_HELPER_DECODE_TASK Task;
+
+            Task.CoreIndex      = i;
+            Task.Buffer         = Cores[i].Buffer + Start;
+            Task.Size           = End - Start;
+            Task.IsFirstSegment = Start == 0;
+
+            Job.Tasks.push_back(std::move(Task));
+            Start = End;
+        }
+    }
+
+    if (Job.Tasks.empty())
+        return 0;
+
+    for (auto & Task : Job.Tasks)
+    {
+        Task.StartEvent = PlatformCreateEvent(TRUE, FALSE);
+        Task.DoneEvent  = PlatformCreateEvent(TRUE, FALSE);
+    }
+
+    //
+    // The current thread also decodes, so one worker less than the processors
+    //
+    NumberOfWorkers = PlatformGetNumberOfProcessors() - 1;
+
+    if (NumberOfWorkers > Job.Tasks.size() - 1)
+        NumberOfWorkers = (UINT32)Job.Tasks.size() - 1;
+
+    //
+    // The first one is the current thread (not resized afterward, as the
+    // workers hold pointers to their own entry)
+    //
+    Threads.resize((SIZE_T)NumberOfWorkers + 1);
+
+    //
+    // Open the window of the first segments before the workers start
+    //
+    Window = Threads.size() * PT_HELPER_DECODE_SEGMENTS_PER_THREAD;
+
+    for (SIZE_T i = 0; i < Job.Tasks.size() && i < Window; i++)
+    {
+        PlatformSetEvent(Job.Tasks[i].StartEvent);
+    }
+
+    for (auto & Thread : Threads)
+    {
+        Thread.Job         = &Job;
+        Thread.Cache.Image = Ctx;
+
+        if (Analysis != NULL)
+            PtAnalysisInitialize(&Thread.Analysis, Analysis->Modes, Ctx);
+    }
+
+    for (UINT32 i = 0; i < NumberOfWorkers; i++)
+    {
+        HANDLE Worker = PlatformCreateThread(PtHelperDecodeWorkerThread, &Threads[i + 1]);
+
+        if (Worker != NULL)
+            Workers.push_back(Worker);
+    }
+
+    //
+    // Show the segments in order, decoding the ones that no worker has claimed,
+    // and move the window forward once each segment is shown
+    //
+    for (SIZE_T i = 0; i < Job.Tasks.size(); i++)
+    {
+        PT_HELPER_DECODE_TASK & Task = Job.Tasks[i];
+
+        if (!CpuInterlockedBitTestAndSet(&Task.Claimed, 0))
+            PtHelperDecodeTask(&Threads[0], &Task);
+        else
+            PlatformWaitForSingleObject(Task.DoneEvent, INFINITE);
+
+        if (Task.IsFirstSegment)
+            ShowMessages("\n[*] core %u: %llu bytes of trace\n", Cores[Task.CoreIndex].Cpu, (UINT64)Cores[Task.CoreIndex].Size);
+
+        PtHelperShowOutput(&Task.Output);
+        Total += Task.Count;
+
+        //
+        // The text is not needed anymore
+        //
+        std::string().swap(Task.Output.Text);
+
+        if (i + Window < Job.Tasks.size())
+            PlatformSetEvent(Job.Tasks[i + Window].StartEvent);
+    }
+
+    for (HANDLE Worker : Workers)
+    {
+        PlatformWaitForSingleObject(Worker, INFINITE);
+        PlatformCloseHandle(Worker);
+    }
+
+    for (auto & Task : Job.Tasks)
+    {
+        if (Task.StartEvent != NULL)
+            PlatformCloseHandle(Task.StartEvent);
+
+        if (Task.DoneEvent != NULL)
+            PlatformCloseHandle(Task.DoneEvent);
+    }
+
+    if (Analysis != NULL)
+    {
+        for (auto & Thread : Threads)
+        {
+            PtAnalysisMerge(Analysis, &Thread.Analysis);
+        }
+    }
+
+    return Total;
+}
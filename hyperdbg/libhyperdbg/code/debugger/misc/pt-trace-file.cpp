@@ -0,0 +1,550 @@
+/**
+ * @file pt-trace-file.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Offline PT trace container
+ * @details The raw per-core PT data, the captured image sections, the process
+ * sideband (the address spaces) and the capture configuration are saved into
+ * a single file (with large sequential writes), so the trace can be captured
+ * quickly and decoded later, without the driver (also on Linux), by mapping
+ * the file
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Align an offset of the container to PT_TRACE_FILE_ALIGNMENT
+ *
+ * @param Offset
+ *
+ * @return UINT64
+ */
+static UINT64
+PtTraceFileAlign(UINT64 Offset)
+{
+    return (Offset + PT_TRACE_FILE_ALIGNMENT - 1) & ~((UINT64)PT_TRACE_FILE_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Get the path in the form of the platform APIs
+ *
+ * @details Same as the other users of the file APIs, the cast on Linux stays
+ * until the paths are converted to UTF-16
+ *
+ * @param Path
+ *
+ * @return const WCHAR *
+ */
+static const WCHAR *
+PtTraceFileGetPlatformPath(const std::wstring & Path)
+{
+#ifdef __linux__
+    return (const WCHAR *)Path.c_str();
+#else
+    return Path.c_str();
+#endif
+}
+
+/**
+ * @brief Write a buffer to the container in large sequential chunks
+ *
+ * @param FileHandle
+ * @param Buffer
+ * @param Size
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PtTraceFileWrite(HANDLE FileHandle, const VOID * Buffer, UINT64 Size)
+{
+    const UINT8 * Current = (const UINT8 *)Buffer;
+
+    while (Size != 0)
+    {
+        DWORD Chunk = (DWORD)std::min<UINT64>(Size, PT_TRACE_FILE_WRITE_CHUNK_SIZE);
+
+        if (!PlatformWriteFile(FileHandle, Current, Chunk))
+            return FALSE;
+
+        Current += Chunk;
+        Size -= Chunk;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Write zeros to the container up to the next aligned offset
+ *
+ * @param FileHandle
+ * @param Offset The current offset, which is updated
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PtTraceFilePad(HANDLE FileHandle, UINT64 * Offset)
+{
+    static const UINT8 Zeros[PT_TRACE_FILE_ALIGNMENT] = {0};
+    UINT64             Aligned                        = PtTraceFileAlign(*Offset);
+
+    if (Aligned != *Offset && !PtTraceFileWrite(FileHandle, Zeros, Aligned - *Offset))
+        return FALSE;
+
+    *Offset = Aligned;
+    return TRUE;
+}
+
+/**
+ * @brief Fill the details of the current processor
+ *
+ * @param Cpu
+ *
+ * @return VOID
+ */
+static VOID
+PtTraceFileQueryCpu(PT_TRACE_FILE_CPU * Cpu)
+{
+    INT32 CpuInfo[4] = {0};
+
+    CpuCpuId(CpuInfo, 0);
+
+    UINT32 MaximumLeaf = (UINT32)CpuInfo[0];
+
+    CpuCpuId(CpuInfo, 1);
+
+    Cpu->Family   = ((CpuInfo[0] >> 8) & 0xf) + ((CpuInfo[0] >> 20) & 0xff);
+    Cpu->Model    = ((CpuInfo[0] >> 4) & 0xf) | ((CpuInfo[0] >> 12) & 0xf0);
+    Cpu->Stepping = CpuInfo[0] & 0xf;
+
+    if (MaximumLeaf >= 0x15)
+    {
+        CpuCpuId(CpuInfo, 0x15);
+
+        Cpu->Cpuid15Eax = (UINT32)CpuInfo[0];
+        Cpu->Cpuid15Ebx = (UINT32)CpuInfo[1];
+    }
+
+    if (MaximumLeaf >= 0x16)
+    {
+        //
+        // Base frequency (in MHz) over the 100 MHz bus clock
+        //
+        CpuCpuId(CpuInfo, 0x16);
+
+        Cpu->NominalFrequency = ((UINT32)CpuInfo[0] & 0xffff) / 100;
+    }
+
+    Cpu->CaptureTsc = CpuReadTsc();
+}
+
+/**
+ * @brief Collect the process sideband of the traces
+ * @details The traced process is recorded with the address space that is
+ * resolved by the driver, and the PIP packets of each core are recorded as
+ * the switches of the address space (with the last TSC before them)
+ *
+ * @param Cores
+ * @param NumberOfCores
+ * @param ProcessId
+ * @param Cr3 Address space of the traced process (zero if it's not known)
+ * @param Records
+ *
+ * @return VOID
+ */
+static VOID
+PtTraceFileCollectSideband(const PT_HELPER_CORE_TRACE *          Cores,
+                           UINT32                                NumberOfCores,
+                           UINT32                                ProcessId,
+                           UINT64                                Cr3,
+                           std::vector<PT_TRACE_FILE_SIDEBAND> & Records)
+{
+    PT_TRACE_FILE_SIDEBAND Record = {0};
+
+    Record.Type      = PT_TRACE_FILE_SIDEBAND_PROCESS;
+    Record.Cpu       = PT_TRACE_FILE_SIDEBAND_ALL_CORES;
+    Record.ProcessId = ProcessId;
+    Record.Cr3       = Cr3;
+
+    Records.push_back(Record);
+
+    for (UINT32 i = 0; i < NumberOfCores; i++)
+    {
+        struct pt_config           Config;
+        struct pt_packet_decoder * Decoder;
+        UINT64                     Tsc     = 0;
+        UINT64                     LastCr3 = pt_asid_no_cr3;
+
+        pt_config_init(&Config);
+        Config.begin = (UINT8 *)Cores[i].Buffer;
+        Config.end   = (UINT8 *)Cores[i].Buffer + Cores[i].Size;
+
+        Decoder = pt_pkt_alloc_decoder(&Config);
+        if (Decoder == NULL)
+            continue;
+
+        //
+        // Only the packets are walked, so it's much cheaper than decoding
+        //
+        while (pt_pkt_sync_forward(Decoder) >= 0)
+        {
+            for (;;)
+            {
+                struct pt_packet Packet;
+                uint64_t         Offset = 0;
+
+                pt_pkt_get_offset(Decoder, &Offset);
+
+                if (pt_pkt_next(Decoder, &Packet, sizeof(Packet)) < 0)
+                    break;
+
+                if (Packet.type == ppt_tsc)
+                {
+                    Tsc = Packet.payload.tsc.tsc;
+                }
+                else if (Packet.type == ppt_pip && Packet.payload.pip.cr3 != LastCr3)
+                {
+                    //
+                    // The PIP is repeated in each PSB+, only the switches are recorded
+                    //
+                    LastCr3 = Packet.payload.pip.cr3;
+
+                    Record.Type      = PT_TRACE_FILE_SIDEBAND_CR3_SWITCH;
+                    Record.Cpu       = Cores[i].Cpu;
+                    Record.ProcessId = (Cr3 != 0 && ((LastCr3 ^ Cr3) & PT_HELPER_CR3_ADDRESS_MASK) == 0) ? ProcessId : 0;
+                    Record.Offset    = Offset;
+                    Record.Tsc       = Tsc;
+                    Record.Cr3       = LastCr3;
+
+                    Records.push_back(Record);
+                }
+            }
+        }
+
+        pt_pkt_free_decoder(Decoder);
+    }
+}
+
+/**
+ * @brief Save a trace into a container
+ *
+ * @param Path
+ * @param Cores The raw PT data of each core
+ * @param NumberOfCores
+ * @param Image The captured image section (and the address space of the process)
+ * @param Config
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PtTraceFileSave(const CHAR *                 Path,
+                const PT_HELPER_CORE_TRACE * Cores,
+                UINT32                       NumberOfCores,
+                const IMAGE_SYMBOL_CONTEXT * Image,
+                const PT_TRACE_FILE_CONFIG * Config)
+{
+    std::vector<UINT8>                  Metadata;
+    std::vector<PT_TRACE_FILE_SIDEBAND> Sideband;
+    PT_TRACE_FILE_HEADER                Header = {0};
+    PT_TRACE_FILE_CORE *                CoreEntries;
+    PT_TRACE_FILE_IMAGE *               ImageEntry;
+    std::wstring                        PathW;
+    HANDLE                              FileHandle;
+    UINT64                              Offset;
+    BOOLEAN                             Result = FALSE;
+
+    PtTraceFileCollectSideband(Cores, NumberOfCores, Config->ProcessId, Image->Cr3, Sideband);
+
+    //
+    // The header and the tables are written at once, so the offsets of all the
+    // data blocks are computed first
+    //
+    Metadata.resize(sizeof(PT_TRACE_FILE_HEADER) + NumberOfCores * sizeof(PT_TRACE_FILE_CORE) + sizeof(PT_TRACE_FILE_IMAGE) +
+                    Sideband.size() * sizeof(PT_TRACE_FILE_SIDEBAND));
+
+    CoreEntries = (PT_TRACE_FILE_CORE *)(Metadata.data() + sizeof(PT_TRACE_FILE_HEADER));
+    ImageEntry  = (PT_TRACE_FILE_IMAGE *)(CoreEntries + NumberOfCores);
+
+    memcpy(ImageEntry + 1, Sideband.data(), Sideband.size() * sizeof(PT_TRACE_FILE_SIDEBAND));
+
+    Offset = PtTraceFileAlign(Metadata.size());
+
+    ImageEntry->ImageBase   = Image->ImageBase;
+    ImageEntry->LoadAddress = Image->CodeBase;
+    ImageEntry->Offset      = Offset;
+    ImageEntry->Size        = Image->CodeSize;
+
+    Offset = PtTraceFileAlign(Offset + Image->CodeSize);
+
+    for (UINT32 i = 0; i < NumberOfCores; i++)
+    {
+        CoreEntries[i].Cpu    = Cores[i].Cpu;
+        CoreEntries[i].Offset = Offset;
+        CoreEntries[i].Size   = Cores[i].Size;
+
+        Offset = PtTraceFileAlign(Offset + Cores[i].Size);
+    }
+
+    Header.Magic                   = PT_TRACE_FILE_MAGIC;
+    Header.Version                 = PT_TRACE_FILE_VERSION;
+    Header.NumberOfCores           = NumberOfCores;
+    Header.NumberOfImages          = 1;
+    Header.NumberOfSidebandRecords = (UINT32)Sideband.size();
+    Header.FileSize                = Offset;
+    Header.Config                  = *Config;
+
+    PtTraceFileQueryCpu(&Header.Cpu);
+
+    memcpy(Metadata.data(), &Header, sizeof(Header));
+
+    StringToWString(PathW, Path);
+
+    FileHandle = PlatformOpenFileForWriting(PtTraceFileGetPlatformPath(PathW));
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        ShowMessages("err, unable to create the trace file '%s'\n", Path);
+        return FALSE;
+    }
+
+    //
+    // Write the metadata, the image and the traces in order
+    //
+    Offset = Metadata.size();
+
+    if (!PtTraceFileWrite(FileHandle, Metadata.data(), Metadata.size()) ||
+        !PtTraceFilePad(FileHandle, &Offset) ||
+        !PtTraceFileWrite(FileHandle, Image->Code, Image->CodeSize))
+    {
+        goto Cleanup;
+    }
+
+    Offset += Image->CodeSize;
+
+    for (UINT32 i = 0; i < NumberOfCores; i++)
+    {
+        if (!PtTraceFilePad(FileHandle, &Offset) ||
+            !PtTraceFileWrite(FileHandle, Cores[i].Buffer, Cores[i].Size))
+        {
+            goto Cleanup;
+        }
+
+        Offset += Cores[i].Size;
+    }
+
+    Result = PtTraceFilePad(FileHandle, &Offset);
+
+Cleanup:
+
+    PlatformCloseFile(FileHandle);
+
+    if (!Result)
+    {
+        ShowMessages("err, unable to write the trace file '%s' (error 0x%x)\n", Path, PlatformGetLastError());
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Check that a data block is inside the mapped container
+ *
+ * @param Offset
+ * @param Size
+ * @param FileSize
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+PtTraceFileIsValidBlock(UINT64 Offset, UINT64 Size, UINT64 FileSize)
+{
+    return Offset <= FileSize && Size <= FileSize - Offset;
+}
+
+/**
+ * @brief Decode a trace from a container
+ * @details The file is mapped, so the traces are decoded directly from the
+ * mapped view and no driver (or live target) is needed. The image is only
+ * decoded in the address space of the traced process (from the sideband)
+ *
+ * @param Path
+ * @param Packets TRUE → decode raw packets; FALSE → decode instructions
+ * @param Analysis Analysis of the decoded trace (no modes means printing it)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PtTraceFileDecode(const CHAR * Path, BOOLEAN Packets, const PT_ANALYSIS_OPTIONS * Analysis)
+{
+    std::vector<PT_HELPER_CORE_TRACE> Traces;
+    const PT_TRACE_FILE_HEADER *      Header;
+    const PT_TRACE_FILE_CORE *        CoreEntries;
+    const PT_TRACE_FILE_IMAGE *       ImageEntry;
+    const PT_TRACE_FILE_SIDEBAND *    Sideband;
+    IMAGE_SYMBOL_CONTEXT              Ctx                 = {0};
+    HANDLE                            FileHandle          = INVALID_HANDLE_VALUE;
+    SIZE_T                            FileSize            = 0;
+    UINT32                            Switches            = 0;
+    UINT32                            SwitchesIntoProcess = 0;
+    CHAR                              ImagePath[MAX_PATH];
+    std::wstring                      PathW;
+    const UINT8 *                     Base;
+    UINT64                            Total;
+    BOOLEAN                           Result = FALSE;
+
+    StringToWString(PathW, Path);
+
+    Base = (const UINT8 *)PlatformMapFileReadOnly(PtTraceFileGetPlatformPath(PathW), &FileSize, &FileHandle);
+
+    if (Base == NULL)
+    {
+        ShowMessages("err, unable to open the trace file '%s'\n", Path);
+        return FALSE;
+    }
+
+    //
+    // Validate the header, the tables and all the data blocks
+    //
+    Header = (const PT_TRACE_FILE_HEADER *)Base;
+
+    if (FileSize < sizeof(PT_TRACE_FILE_HEADER) || Header->Magic != PT_TRACE_FILE_MAGIC)
+    {
+        ShowMessages("err, '%s' is not a PT trace file\n", Path);
+        goto Cleanup;
+    }
+
+    if (Header->Version != PT_TRACE_FILE_VERSION)
+    {
+        ShowMessages("err, version %u of the trace file is not supported\n", Header->Version);
+        goto Cleanup;
+    }
+
+    if (Header->NumberOfImages == 0 ||
+        !PtTraceFileIsValidBlock(sizeof(PT_TRACE_FILE_HEADER),
+                                 (UINT64)Header->NumberOfCores * sizeof(PT_TRACE_FILE_CORE) + (UINT64)Header->NumberOfImages * sizeof(PT_TRACE_FILE_IMAGE) +
+                                     (UINT64)Header->NumberOfSidebandRecords * sizeof(PT_TRACE_FILE_SIDEBAND),
+                                 FileSize))
+    {
+        ShowMessages("err, the trace file is truncated or corrupted\n");
+        goto Cleanup;
+    }
+
+    CoreEntries = (const PT_TRACE_FILE_CORE *)(Base + sizeof(PT_TRACE_FILE_HEADER));
+    ImageEntry  = (const PT_TRACE_FILE_IMAGE *)(CoreEntries + Header->NumberOfCores);
+    Sideband    = (const PT_TRACE_FILE_SIDEBAND *)(ImageEntry + Header->NumberOfImages);
+
+    //
+    // The path comes from the file, so it's not trusted to be terminated
+    //
+    memcpy(ImagePath, Header->Config.ImagePath, sizeof(ImagePath));
+    ImagePath[sizeof(ImagePath) - 1] = '\0';
+
+    if (!PtTraceFileIsValidBlock(ImageEntry->Offset, ImageEntry->Size, FileSize))
+    {
+        ShowMessages("err, the trace file is truncated or corrupted\n");
+        goto Cleanup;
+    }
+
+    Ctx.ImageBase = ImageEntry->ImageBase;
+    Ctx.CodeBase  = ImageEntry->LoadAddress;
+    Ctx.CodeSize  = ImageEntry->Size;
+    Ctx.Code      = (UINT8 *)(Base + ImageEntry->Offset); // only read by the decoders
+
+    //
+    // The address space of the traced process, and the switches into it and
+    // out of it
+    //
+    for (UINT32 i = 0; i < Header->NumberOfSidebandRecords; i++)
+    {
+        if (Sideband[i].Type == PT_TRACE_FILE_SIDEBAND_PROCESS && Sideband[i].ProcessId == Header->Config.ProcessId)
+        {
+            Ctx.Cr3 = Sideband[i].Cr3;
+        }
+        else if (Sideband[i].Type == PT_TRACE_FILE_SIDEBAND_CR3_SWITCH)
+        {
+            Switches++;
+
+            if (Sideband[i].ProcessId != 0 && Sideband[i].ProcessId == Header->Config.ProcessId)
+                SwitchesIntoProcess++;
+        }
+    }
+
+    for (UINT32 i = 0; i < Header->NumberOfCores; i++)
+    {
+        PT_HELPER_CORE_TRACE Trace;
+
+        if (!PtTraceFileIsValidBlock(CoreEntries[i].Offset, CoreEntries[i].Size, FileSize))
+        {
+            ShowMessages("err, the trace of core %u is truncated or corrupted\n", CoreEntries[i].Cpu);
+            goto Cleanup;
+        }
+
+        if (CoreEntries[i].Size == 0)
+            continue;
+
+        Trace.Cpu    = CoreEntries[i].Cpu;
+        Trace.Buffer = Base + CoreEntries[i].Offset;
+        Trace.Size   = CoreEntries[i].Size;
+
+        Traces.push_back(Trace);
+    }
+
+    ShowMessages("[+] trace of '%s' (pid %u), %u core(s), cpu %u/0x%x/%u\n",
+                 ImagePath[0] != '\0' ? ImagePath : "(unknown)",
+                 Header->Config.ProcessId,
+                 Header->NumberOfCores,
+                 Header->Cpu.Family,
+                 Header->Cpu.Model,
+                 Header->Cpu.Stepping);
+
+    ShowMessages("[+] image base 0x%llx, .text 0x%llx-0x%llx (%llu bytes)\n",
+                 Ctx.ImageBase,
+                 Ctx.CodeBase,
+                 Ctx.CodeBase + Ctx.CodeSize - 1,
+                 Ctx.CodeSize);
+
+    if (Ctx.Cr3 != 0)
+    {
+        ShowMessages("[+] address space cr3=0x%llx, %u switch(es) of the address space (%u into the process)\n",
+                     Ctx.Cr3,
+                     Switches,
+                     SwitchesIntoProcess);
+    }
+    else
+    {
+        ShowMessages("[!] address space of the process is not known, the image is decoded in all address spaces\n");
+    }
+
+    //
+    // Decode (or analyze) the same way as a live trace
+    //
+    if (!Packets && Analysis->Modes != 0)
+    {
+        PT_ANALYSIS_STATE AnalysisState;
+
+        PtAnalysisInitialize(&AnalysisState, Analysis->Modes, &Ctx);
+
+        Total = PtHelperDecodeCoresParallel(Traces.data(), (UINT32)Traces.size(), FALSE, &Ctx, &AnalysisState);
+
+        PtAnalysisShowAndExport(&AnalysisState,
+                                PT_TRACE_FILE_SYMBOL_HANDLE,
+                                ImagePath[0] != '\0' ? ImagePath : NULL,
+                                Analysis);
+    }
+    else
+    {
+        Total = PtHelperDecodeCoresParallel(Traces.data(), (UINT32)Traces.size(), Packets, &Ctx, NULL);
+    }
+
+    ShowMessages("\n[+] decoded %llu %s total\n", Total, Packets ? "packet(s)" : "instruction(s)");
+
+    Result = TRUE;
+
+Cleanup:
+
+    PlatformUnmapFile((VOID *)Base, FileSize, FileHandle);
+
+    return Result;
+}
@@ -19,7 +19,7 @@ extern BOOLEAN g_IsKdModuleLoaded;
 extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
 
 /**
- * @brief Read memory and disassembler
+ * @brief Read memory (and optionally show the errors)
  *
  * @param TargetAddress location of where to read the memory
  * @param MemoryType type of memory (phyical or virtual)
@@ -30,19 +30,21 @@ extern BOOLEAN g_IsSerialConnectedToRemoteDebuggee;
  * @param AddressMode Address mode (32 or 64)
  * @param TargetBufferToStore The buffer to store the read memory
  * @param ReturnLength The length of the read memory
+ * @param ShowErrors Whether the errors of the reading should be shown
  *
  * @return BOOLEAN TRUE if the operation was successful, otherwise FALSE
  */
-BOOLEAN
-HyperDbgReadMemory(UINT64                              TargetAddress,
-                   DEBUGGER_READ_MEMORY_TYPE           MemoryType,
-                   DEBUGGER_READ_READING_TYPE          ReadingType,
-                   UINT32                              Pid,
-                   UINT32                              Size,
-                   BOOLEAN                             GetAddressMode,
-                   DEBUGGER_READ_MEMORY_ADDRESS_MODE * AddressMode,
-                   BYTE *                              TargetBufferToStore,
-                   UINT32 *                            ReturnLength)
+static BOOLEAN
+ReadMemoryAndCheckStatus(UINT64                              TargetAddress,
+                         DEBUGGER_READ_MEMORY_TYPE           MemoryType,
+                         DEBUGGER_READ_READING_TYPE          ReadingType,
+                         UINT32                              Pid,
+                         UINT32                              Size,
+                         BOOLEAN                             GetAddressMode,
+                         DEBUGGER_READ_MEMORY_ADDRESS_MODE * AddressMode,
+                         BYTE *                              TargetBufferToStore,
+                         UINT32 *                            ReturnLength,
+                         BOOLEAN                             ShowErrors)
 {
     BOOL                 Status;
     ULONG                ReturnedLength;
@@ -119,7 +121,11 @@ HyperDbgReadMemory(UINT64                              TargetAddress,
 
         if (!Status)
         {
-            ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+            if (ShowErrors)
+            {
+                ShowMessages("ioctl failed with code 0x%x\n", PlatformGetLastError());
+            }
+
             std::free(MemReadRequest);
             return FALSE;
         }
@@ -130,7 +136,11 @@ HyperDbgReadMemory(UINT64                              TargetAddress,
     //
     if (MemReadRequest->KernelStatus != DEBUGGER_OPERATION_WAS_SUCCESSFUL)
     {
-        ShowErrorMessage(MemReadRequest->KernelStatus);
+        if (ShowErrors)
+        {
+            ShowErrorMessage(MemReadRequest->KernelStatus);
+        }
+
         std::free(MemReadRequest);
         return FALSE;
     }
@@ -176,6 +186,79 @@ HyperDbgReadMemory(UINT64                              TargetAddress,
     }
 }
 
+/**
+ * @brief Read memory and disassembler
+ *
+ * @param TargetAddress location of where to read the memory
+ * @param MemoryType type of memory (phyical or virtual)
+ * @param ReadingType read from kernel or vmx-root
+ * @param Pid The target process id
+ * @param Size size of memory to read
+ * @param GetAddressMode check for address mode
+ * @param AddressMode Address mode (32 or 64)
+ * @param TargetBufferToStore The buffer to store the read memory
+ * @param ReturnLength The length of the read memory
+ *
+ * @return BOOLEAN TRUE if the operation was successful, otherwise FALSE
+ */
+BOOLEAN
+HyperDbgReadMemory(UINT64                              TargetAddress,
+                   DEBUGGER_READ_MEMORY_TYPE           MemoryType,
+                   DEBUGGER_READ_READING_TYPE          ReadingType,
+                   UINT32                              Pid,
+                   UINT32                              Size,
+                   BOOLEAN                             GetAddressMode,
+                   DEBUGGER_READ_MEMORY_ADDRESS_MODE * AddressMode,
+                   BYTE *                              TargetBufferToStore,
+                   UINT32 *                            ReturnLength)
+{
+    return ReadMemoryAndCheckStatus(TargetAddress,
+                                    MemoryType,
+                                    ReadingType,
+                                    Pid,
+                                    Size,
+                                    GetAddressMode,
+                                    AddressMode,
+                                    TargetBufferToStore,
+                                    ReturnLength,
+                                    TRUE);
+}
+
+/**
+ * @brief Read memory without showing the errors (e.g., for probing the
+ * readable pages of a range)
+ *
+ * @param TargetAddress location of where to read the memory
+ * @param MemoryType type of memory (phyical or virtual)
+ * @param ReadingType read from kernel or vmx-root
+ * @param Pid The target process id
+ * @param Size size of memory to read
+ * @param TargetBufferToStore The buffer to store the read memory
+ * @param ReturnLength The length of the read memory
+ *
+ * @return BOOLEAN TRUE if the operation was successful, otherwise FALSE
+ */
+BOOLEAN
+HyperDbgReadMemoryQuietly(UINT64                     TargetAddress,
+                          DEBUGGER_READ_MEMORY_TYPE  MemoryType,
+                          DEBUGGER_READ_READING_TYPE ReadingType,
+                          UINT32                     Pid,
+                          UINT32                     Size,
+                          BYTE *                     TargetBufferToStore,
+                          UINT32 *                   ReturnLength)
+{
+    return ReadMemoryAndCheckStatus(TargetAddress,
+                                    MemoryType,
+                                    ReadingType,
+                                    Pid,
+                                    Size,
+                                    FALSE,
+                                    NULL,
+                                    TargetBufferToStore,
+                                    ReturnLength,
+                                    FALSE);
+}
+
 /**
  * @brief Show memory or disassembler
  *
@@ -269,11 +352,18 @@ HyperDbgShowMemoryOrDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
         //
         if (Size == ReturnedLength)
         {
-            ScriptEngineShowDataBasedOnSymbolTypesWrapper(DtDetails->TypeName,
-                                                          Address,
-                                                          FALSE,
-                                                          Buffer,
-                                                          DtDetails->AdditionalParameters);
+            //
+            // The structure is formatted from its compiled layout, otherwise
+            // it's shown by pdbex
+            //
+            if (!CommandDtShowDataBasedOnTypeLayout(DtDetails, Buffer, ReturnedLength))
+            {
+                ScriptEngineShowDataBasedOnSymbolTypesWrapper(DtDetails->TypeName,
+                                                              Address,
+                                                              FALSE,
+                                                              Buffer,
+                                                              DtDetails->AdditionalParameters);
+            }
         }
         else if (ReturnedLength == 0)
         {
@@ -0,0 +1,717 @@
+/**
+ * @file unwind.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief x64 unwind-table based callstack walker
+ * @details Instead of pulling the whole stack range and checking every slot
+ * for a call instruction (see callstack.cpp), this walker uses the
+ * RUNTIME_FUNCTION and UNWIND_INFO records of the loaded modules to compute
+ * the caller's frame exactly, so only a few stack slots per frame are read
+ * from the debuggee. The heuristic walker is only used for the part of the
+ * stack where no unwind data is available
+ *
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+extern BOOLEAN                               g_AddressConversion;
+extern PMODULE_SYMBOL_DETAIL                 g_SymbolTable;
+extern UINT32                                g_SymbolTableSize;
+extern std::map<UINT64, UNWIND_MODULE_CACHE> g_UnwindModuleCache;
+
+/**
+ * @brief Read a range of the debuggee's virtual memory without showing
+ * the errors as the callers fall back on failed reads
+ *
+ * @param Address
+ * @param Size
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadMemory(UINT64 Address, UINT32 Size, BYTE * Buffer)
+{
+    UINT32 ReturnLength = 0;
+    UINT32 ChunkSize;
+
+    //
+    // Read the memory page by page as the debuggee handles a page in each request
+    //
+    while (Size != 0)
+    {
+        ChunkSize = PAGE_SIZE - (UINT32)(Address & (PAGE_SIZE - 1));
+
+        if (ChunkSize > Size)
+        {
+            ChunkSize = Size;
+        }
+
+        if (!HyperDbgReadMemoryQuietly(Address,
+                                       DEBUGGER_READ_VIRTUAL_ADDRESS,
+                                       READ_FROM_KERNEL,
+                                       0,
+                                       ChunkSize,
+                                       Buffer,
+                                       &ReturnLength) ||
+            ReturnLength != ChunkSize)
+        {
+            return FALSE;
+        }
+
+        Address += ChunkSize;
+        Buffer += ChunkSize;
+        Size -= ChunkSize;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read a range of the local file of a module
+ *
+ * @param Module
+ * @param FileOffset
+ * @param Size
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadLocalFile(PUNWIND_MODULE_CACHE Module, UINT64 FileOffset, UINT32 Size, BYTE * Buffer)
+{
+    if (FileOffset + Size > Module->LocalFileSize)
+    {
+        return FALSE;
+    }
+
+    Module->LocalFile.clear();
+    Module->LocalFile.seekg((std::streamoff)FileOffset);
+    Module->LocalFile.read((CHAR *)Buffer, Size);
+
+    return Module->LocalFile.gcount() == (std::streamsize)Size;
+}
+
+/**
+ * @brief Read a range of a module (RVA-based) either from a local file
+ * or from the debuggee's memory
+ *
+ * @param Module
+ * @param Rva
+ * @param Size
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadModule(PUNWIND_MODULE_CACHE Module, UINT32 Rva, UINT32 Size, BYTE * Buffer)
+{
+    if (!Module->IsLocalFile)
+    {
+        return CallstackUnwindReadMemory(Module->BaseAddress + Rva, Size, Buffer);
+    }
+
+    //
+    // Convert the RVA to the file offset based on the sections of the local file
+    //
+    for (auto & Section : Module->LocalSections)
+    {
+        UINT32 SectionSize = std::max(Section.Misc.VirtualSize, Section.SizeOfRawData);
+
+        if (Rva >= Section.VirtualAddress && (UINT64)Rva + Size <= (UINT64)Section.VirtualAddress + SectionSize)
+        {
+            return CallstackUnwindReadLocalFile(Module, (UINT64)Section.PointerToRawData + (Rva - Section.VirtualAddress), Size, Buffer);
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Parse the PE headers of a module and fill the unwind cache from its
+ * exception directory
+ *
+ * @param Module The module which its BaseAddress (and LocalFile if it's a
+ * local file) is already filled
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindLoadExceptionDirectory(PUNWIND_MODULE_CACHE Module)
+{
+    BYTE   Headers[PAGE_SIZE] = {0};
+    UINT32 NtOffset;
+    UINT32 OptionalHeaderOffset;
+    UINT32 SectionsOffset;
+    UINT16 NumberOfSections;
+    UINT16 SizeOfOptionalHeader;
+    UINT32 ExceptionRva;
+    UINT32 ExceptionSize;
+
+    //
+    // Read the first page which contains the headers
+    //
+    if (Module->IsLocalFile)
+    {
+        if (!CallstackUnwindReadLocalFile(Module, 0, sizeof(Headers), Headers))
+        {
+            return FALSE;
+        }
+    }
+    else if (!CallstackUnwindReadMemory(Module->BaseAddress, sizeof(Headers), Headers))
+    {
+        return FALSE;
+    }
+
+    //
+    // Validate the DOS and NT headers, only PE32+ (x64) images are unwindable
+    //
+    if (*(UINT16 *)&Headers[0] != 0x5a4d)
+    {
+        return FALSE;
+    }
+
+    NtOffset = *(UINT32 *)&Headers[0x3c];
+
+    if (NtOffset > sizeof(Headers) - 0x108 || *(UINT32 *)&Headers[NtOffset] != 0x00004550)
+    {
+        return FALSE;
+    }
+
+    NumberOfSections     = *(UINT16 *)&Headers[NtOffset + 6];
+    SizeOfOptionalHeader = *(UINT16 *)&Headers[NtOffset + 20];
+    OptionalHeaderOffset = NtOffset + 24;
+
+    if (*(UINT16 *)&Headers[OptionalHeaderOffset] != 0x20b)
+    {
+        return FALSE;
+    }
+
+    //
+    // SizeOfImage is at 0x38 and the exception directory (index 3) is at
+    // 0x70 + 3 * 8 of the PE32+ optional header
+    //
+    Module->SizeOfImage = *(UINT32 *)&Headers[OptionalHeaderOffset + 0x38];
+    ExceptionRva        = *(UINT32 *)&Headers[OptionalHeaderOffset + 0x70 + 3 * 8];
+    ExceptionSize       = *(UINT32 *)&Headers[OptionalHeaderOffset + 0x70 + 3 * 8 + 4];
+
+    //
+    // Keep the sections of local files to convert RVAs to file offsets
+    //
+    if (Module->IsLocalFile)
+    {
+        SectionsOffset = OptionalHeaderOffset + SizeOfOptionalHeader;
+
+        if ((UINT64)SectionsOffset + (UINT64)NumberOfSections * sizeof(IMAGE_SECTION_HEADER) > sizeof(Headers))
+        {
+            return FALSE;
+        }
+
+        Module->LocalSections.resize(NumberOfSections);
+        memcpy(Module->LocalSections.data(), &Headers[SectionsOffset], NumberOfSections * sizeof(IMAGE_SECTION_HEADER));
+    }
+
+    if (ExceptionRva == 0 || ExceptionSize < sizeof(UNWIND_RUNTIME_FUNCTION))
+    {
+        //
+        // The module is valid, but it doesn't have unwind data
+        //
+        return TRUE;
+    }
+
+    //
+    // Fetch the whole exception directory once
+    //
+    Module->RuntimeFunctions.resize(ExceptionSize / sizeof(UNWIND_RUNTIME_FUNCTION));
+
+    if (!CallstackUnwindReadModule(Module,
+                                   ExceptionRva,
+                                   (UINT32)(Module->RuntimeFunctions.size() * sizeof(UNWIND_RUNTIME_FUNCTION)),
+                                   (BYTE *)Module->RuntimeFunctions.data()))
+    {
+        Module->RuntimeFunctions.clear();
+        return FALSE;
+    }
+
+    //
+    // The table is normally sorted by the linker, but we don't trust the
+    // debuggee and make sure binary search works
+    //
+    std::sort(Module->RuntimeFunctions.begin(),
+              Module->RuntimeFunctions.end(),
+              [](const UNWIND_RUNTIME_FUNCTION & A, const UNWIND_RUNTIME_FUNCTION & B) {
+                  return A.BeginAddress < B.BeginAddress;
+              });
+
+    Module->HasUnwindData = TRUE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Find (or create) the unwind cache of the module that contains the address
+ *
+ * @param Address
+ *
+ * @return PUNWIND_MODULE_CACHE NULL if the address is not within a known module
+ */
+static PUNWIND_MODULE_CACHE
+CallstackUnwindGetModule(UINT64 Address)
+{
+    PMODULE_SYMBOL_DETAIL ModuleDetail = NULL;
+
+    //
+    // Check the already cached modules
+    //
+    auto Iterate = g_UnwindModuleCache.upper_bound(Address);
+
+    if (Iterate != g_UnwindModuleCache.begin())
+    {
+        Iterate--;
+
+        if (Address < Iterate->second.BaseAddress + Iterate->second.SizeOfImage)
+        {
+            return &Iterate->second;
+        }
+    }
+
+    //
+    // Find the nearest module base from the symbol table
+    //
+    if (g_SymbolTable == NULL)
+    {
+        return NULL;
+    }
+
+    for (SIZE_T i = 0; i < g_SymbolTableSize / sizeof(MODULE_SYMBOL_DETAIL); i++)
+    {
+        if (g_SymbolTable[i].BaseAddress <= Address &&
+            (ModuleDetail == NULL || g_SymbolTable[i].BaseAddress > ModuleDetail->BaseAddress))
+        {
+            ModuleDetail = &g_SymbolTable[i];
+        }
+    }
+
+    if (ModuleDetail == NULL || g_UnwindModuleCache.count(ModuleDetail->BaseAddress) != 0)
+    {
+        //
+        // Either no module, or the address is beyond the end of a cached module,
+        // or the module is not readable
+        //
+        return NULL;
+    }
+
+    UNWIND_MODULE_CACHE Module = {};
+    Module.BaseAddress         = ModuleDetail->BaseAddress;
+
+    //
+    // Try the mapped image in the debuggee first, and if it's not available
+    // (e.g., the headers or .pdata are paged out), use the local file. The file
+    // is kept open and only its headers, the exception directory and the
+    // unwind infos are read from it
+    //
+    if (!CallstackUnwindLoadExceptionDirectory(&Module))
+    {
+        Module             = {};
+        Module.BaseAddress = ModuleDetail->BaseAddress;
+        Module.IsLocalFile = TRUE;
+
+        Module.LocalFile.open(ModuleDetail->FilePath, std::ios::binary | std::ios::ate);
+
+        if (Module.LocalFile.is_open())
+        {
+            Module.LocalFileSize = (UINT64)Module.LocalFile.tellg();
+        }
+
+        if (!Module.LocalFile.is_open() || !CallstackUnwindLoadExceptionDirectory(&Module))
+        {
+            //
+            // Keep the module as not readable, so the other frames of the
+            // module (and the next walks) don't read it again
+            //
+            g_UnwindModuleCache[ModuleDetail->BaseAddress].BaseAddress = ModuleDetail->BaseAddress;
+
+            return NULL;
+        }
+    }
+
+    PUNWIND_MODULE_CACHE CachedModule = &(g_UnwindModuleCache[Module.BaseAddress] = std::move(Module));
+
+    if (Address >= CachedModule->BaseAddress + CachedModule->SizeOfImage)
+    {
+        return NULL;
+    }
+
+    return CachedModule;
+}
+
+/**
+ * @brief Find the runtime function that contains the RVA (binary search)
+ *
+ * @param Module
+ * @param Rva
+ *
+ * @return PUNWIND_RUNTIME_FUNCTION NULL if it's a leaf function
+ */
+static PUNWIND_RUNTIME_FUNCTION
+CallstackUnwindLookupFunction(PUNWIND_MODULE_CACHE Module, UINT32 Rva)
+{
+    auto Iterate = std::upper_bound(Module->RuntimeFunctions.begin(),
+                                    Module->RuntimeFunctions.end(),
+                                    Rva,
+                                    [](UINT32 Value, const UNWIND_RUNTIME_FUNCTION & Function) {
+                                        return Value < Function.BeginAddress;
+                                    });
+
+    if (Iterate == Module->RuntimeFunctions.begin())
+    {
+        return NULL;
+    }
+
+    Iterate--;
+
+    if (Rva >= Iterate->EndAddress)
+    {
+        return NULL;
+    }
+
+    return &(*Iterate);
+}
+
+/**
+ * @brief Get the UNWIND_INFO (including its unwind codes and the chained
+ * function) of a runtime function
+ *
+ * @param Module
+ * @param UnwindInfoRva
+ *
+ * @return std::vector<BYTE> * NULL if it's not readable
+ */
+static std::vector<BYTE> *
+CallstackUnwindGetUnwindInfo(PUNWIND_MODULE_CACHE Module, UINT32 UnwindInfoRva)
+{
+    BYTE   Header[4];
+    UINT32 Size;
+
+    auto Iterate = Module->UnwindInfos.find(UnwindInfoRva);
+
+    if (Iterate != Module->UnwindInfos.end())
+    {
+        return &Iterate->second;
+    }
+
+    if (!CallstackUnwindReadModule(Module, UnwindInfoRva, sizeof(Header), Header))
+    {
+        return NULL;
+    }
+
+    //
+    // Header + unwind codes (aligned to an even count) + optional chained runtime function
+    //
+    Size = sizeof(Header) + ((Header[2] + 1) & ~1) * sizeof(UINT16);
+
+    if ((Header[0] >> 3) & UNWIND_FLAG_CHAININFO)
+    {
+        Size += sizeof(UNWIND_RUNTIME_FUNCTION);
+    }
+
+    std::vector<BYTE> UnwindInfo(Size);
+
+    if (!CallstackUnwindReadModule(Module, UnwindInfoRva, Size, UnwindInfo.data()))
+    {
+        return NULL;
+    }
+
+    return &(Module->UnwindInfos[UnwindInfoRva] = std::move(UnwindInfo));
+}
+
+/**
+ * @brief Read a stack slot through a small per-walk cache
+ *
+ * @param StackCache
+ * @param Address
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadStack(std::map<UINT64, std::array<BYTE, UNWIND_STACK_CACHE_LINE_SIZE>> & StackCache,
+                         UINT64                                                             Address,
+                         UINT64 *                                                           Value)
+{
+    UINT64 Line   = Address & ~((UINT64)UNWIND_STACK_CACHE_LINE_SIZE - 1);
+    UINT64 Offset = Address - Line;
+
+    if (Offset + sizeof(UINT64) > UNWIND_STACK_CACHE_LINE_SIZE)
+    {
+        //
+        // Misaligned slot that crosses the line
+        //
+        return CallstackUnwindReadMemory(Address, sizeof(UINT64), (BYTE *)Value);
+    }
+
+    auto Iterate = StackCache.find(Line);
+
+    if (Iterate == StackCache.end())
+    {
+        std::array<BYTE, UNWIND_STACK_CACHE_LINE_SIZE> Data;
+
+        if (!CallstackUnwindReadMemory(Line, UNWIND_STACK_CACHE_LINE_SIZE, Data.data()))
+        {
+            return FALSE;
+        }
+
+        Iterate = StackCache.emplace(Line, Data).first;
+    }
+
+    memcpy(Value, Iterate->second.data() + Offset, sizeof(UINT64));
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the code of a module for the unwinder (UNWIND_IMAGE)
+ * @details The bytes that are executed are read from the debuggee, the local
+ * file is only used if the code is not readable
+ *
+ * @param Context
+ * @param Address
+ * @param Size
+ * @param Buffer
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadCode(PVOID Context, UINT64 Address, UINT32 Size, BYTE * Buffer)
+{
+    PUNWIND_MODULE_CACHE Module = ((PUNWIND_READER_CONTEXT)Context)->Module;
+
+    return CallstackUnwindReadMemory(Address, Size, Buffer) ||
+           (Module->IsLocalFile && CallstackUnwindReadModule(Module, (UINT32)(Address - Module->BaseAddress), Size, Buffer));
+}
+
+/**
+ * @brief Read a stack slot for the unwinder (UNWIND_IMAGE)
+ *
+ * @param Context
+ * @param Address
+ * @param Value
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+CallstackUnwindReadStackSlot(PVOID Context, UINT64 Address, UINT64 * Value)
+{
+    return CallstackUnwindReadStack(*((PUNWIND_READER_CONTEXT)Context)->StackCache, Address, Value);
+}
+
+/**
+ * @brief Get the UNWIND_INFO of a module for the unwinder (UNWIND_IMAGE)
+ *
+ * @param Context
+ * @param UnwindInfoRva
+ *
+ * @return const BYTE * NULL if it's not readable
+ */
+static const BYTE *
+CallstackUnwindGetUnwindInfoOfModule(PVOID Context, UINT32 UnwindInfoRva)
+{
+    std::vector<BYTE> * UnwindInfo = CallstackUnwindGetUnwindInfo(((PUNWIND_READER_CONTEXT)Context)->Module, UnwindInfoRva);
+
+    return UnwindInfo != NULL ? UnwindInfo->data() : NULL;
+}
+
+/**
+ * @brief Show a single frame of the unwound callstack
+ *
+ * @param StackOffset
+ * @param Address
+ * @param IsCurrentInstruction
+ *
+ * @return VOID
+ */
+static VOID
+CallstackUnwindShowFrame(UINT64 StackOffset, UINT64 Address, BOOLEAN IsCurrentInstruction)
+{
+    UINT64 UsedBaseAddress = NULL;
+
+    ShowMessages("[$+%03llx] ", StackOffset);
+
+    if (IsCurrentInstruction)
+    {
+        ShowMessages("     %016llx (addr ", Address);
+    }
+    else
+    {
+        ShowMessages("  %016llx    (from ", Address);
+    }
+
+    if (g_AddressConversion)
+    {
+        if (SymbolShowFunctionNameBasedOnAddress(Address, &UsedBaseAddress))
+        {
+            ShowMessages(" ");
+        }
+    }
+
+    ShowMessages("<%016llx>)\n", Address);
+}
+
+/**
+ * @brief Walk the callstack of the current thread using the unwind tables
+ * and show the frames
+ * @details If a frame is reached that has no unwind data, the rest of the
+ * stack is shown by the heuristic (call-site) walker
+ *
+ * @param Length The maximum length of the stack (from the current RSP) to walk
+ *
+ * @return BOOLEAN FALSE if the unwinder couldn't be used for the current
+ * frame, the caller should use the heuristic walker in this case
+ */
+BOOLEAN
+CallstackUnwindAndShowFrames(UINT32 Length)
+{
+    GUEST_REGS                                                       Regs       = {0};
+    GUEST_EXTRA_REGISTERS                                            ExtraRegs  = {0};
+    UNWIND_CONTEXT                                                   Context    = {0};
+    std::map<UINT64, std::array<BYTE, UNWIND_STACK_CACHE_LINE_SIZE>> StackCache;
+    UNWIND_READER_CONTEXT                                            Reader     = {NULL, &StackCache};
+    UNWIND_IMAGE                                                     Image      = {0};
+    PUNWIND_MODULE_CACHE                                             Module     = NULL;
+    PUNWIND_RUNTIME_FUNCTION                                         Function   = NULL;
+    UINT64                                                           InitialRsp = 0;
+    BOOLEAN                                                          IsExactRip = TRUE;
+    BOOLEAN                                                          IsInEpilog;
+    BOOLEAN                                                          IsMachineFrame;
+    UINT64                                                           LookupRip;
+    UINT64                                                           PreviousRsp;
+    UINT32                                                           FrameIndex;
+
+    if (!HyperDbgReadAllRegisters(&Regs, &ExtraRegs))
+    {
+        return FALSE;
+    }
+
+    //
+    // GUEST_REGS is in the same order as the x64 register numbers
+    //
+    memcpy(Context.Gpr, &Regs, sizeof(Context.Gpr));
+    Context.Rip = ExtraRegs.RIP;
+    InitialRsp  = Context.Gpr[UNWIND_REGISTER_RSP];
+
+    Image.ReadCode      = CallstackUnwindReadCode;
+    Image.ReadStack     = CallstackUnwindReadStackSlot;
+    Image.GetUnwindInfo = CallstackUnwindGetUnwindInfoOfModule;
+    Image.Context       = &Reader;
+
+    //
+    // Check whether the current instruction has unwind data or not
+    //
+    Module = CallstackUnwindGetModule(Context.Rip);
+
+    if (Module == NULL || !Module->HasUnwindData)
+    {
+        return FALSE;
+    }
+
+    for (FrameIndex = 0; FrameIndex < UNWIND_MAXIMUM_FRAMES; FrameIndex++)
+    {
+        CallstackUnwindShowFrame(Context.Gpr[UNWIND_REGISTER_RSP] - InitialRsp, Context.Rip, FrameIndex == 0);
+
+        if (Context.Gpr[UNWIND_REGISTER_RSP] - InitialRsp >= Length)
+        {
+            break;
+        }
+
+        //
+        // The return addresses are looked up by the call instruction (the
+        // previous byte), as a call to a noreturn function might be the last
+        // instruction of the caller. Only the current instruction and the
+        // interrupted contexts (machine frames) are exact
+        //
+        LookupRip = IsExactRip ? Context.Rip : Context.Rip - 1;
+        Module    = CallstackUnwindGetModule(LookupRip);
+
+        if (Module == NULL || !Module->HasUnwindData)
+        {
+            //
+            // No unwind data, continue heuristically from here
+            //
+            ShowMessages("(no unwind data for %016llx, scanning the rest of the stack)\n", Context.Rip);
+
+            KdSendCallStackPacketToDebuggee(Context.Gpr[UNWIND_REGISTER_RSP],
+                                            Length - (UINT32)(Context.Gpr[UNWIND_REGISTER_RSP] - InitialRsp),
+                                            DEBUGGER_CALLSTACK_DISPLAY_METHOD_WITHOUT_PARAMS,
+                                            FALSE);
+            break;
+        }
+
+        PreviousRsp = Context.Gpr[UNWIND_REGISTER_RSP];
+        Function    = CallstackUnwindLookupFunction(Module, (UINT32)(LookupRip - Module->BaseAddress));
+
+        if (Function != NULL)
+        {
+            IsInEpilog        = FALSE;
+            IsMachineFrame    = FALSE;
+            Reader.Module     = Module;
+            Image.BaseAddress = Module->BaseAddress;
+
+            if ((IsExactRip && !UnwindEpilog(&Image, Function, &Context, &IsInEpilog)) ||
+                (!IsInEpilog && !UnwindVirtualUnwind(&Image, Function, &Context, &IsMachineFrame)))
+            {
+                ShowMessages("err, unable to unwind the frame at %016llx\n", Context.Rip);
+                break;
+            }
+
+            IsExactRip = IsMachineFrame;
+        }
+        else if (IsExactRip)
+        {
+            //
+            // Leaf functions don't have unwind data, the return address is on top of the stack
+            //
+            if (!CallstackUnwindReadStack(StackCache, Context.Gpr[UNWIND_REGISTER_RSP], &Context.Rip))
+            {
+                break;
+            }
+
+            Context.Gpr[UNWIND_REGISTER_RSP] += sizeof(UINT64);
+            IsExactRip = FALSE;
+        }
+        else
+        {
+            //
+            // Return addresses can't be in a leaf function
+            //
+            ShowMessages("err, no runtime function for %016llx\n", Context.Rip);
+            break;
+        }
+
+        //
+        // Check the end of the stack (the stack only grows toward the lower addresses)
+        //
+        if (Context.Rip == 0 || Context.Gpr[UNWIND_REGISTER_RSP] <= PreviousRsp)
+        {
+            break;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Clear the cached unwind tables of the modules
+ *
+ * @return VOID
+ */
+VOID
+CallstackUnwindClearCache()
+{
+    g_UnwindModuleCache.clear();
+}
@@ -149,6 +149,19 @@ ScriptEngineGetDataTypeSizeWrapper(CHAR * TypeName, UINT64 * TypeSize)
     return ScriptEngineGetDataTypeSize(TypeName, TypeSize);
 }
 
+/**
+ * @brief ScriptEngineGetTypeLayout wrapper
+ *
+ * @param TypeName
+ *
+ * @return const SYMBOL_TYPE_LAYOUT *
+ */
+const SYMBOL_TYPE_LAYOUT *
+ScriptEngineGetTypeLayoutWrapper(const CHAR * TypeName)
+{
+    return ScriptEngineGetTypeLayout(TypeName);
+}
+
 /**
  * @brief ScriptEngineCreateSymbolTableForDisassembler wrapper
  *
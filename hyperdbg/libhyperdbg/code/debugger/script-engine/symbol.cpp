@@ -721,6 +721,11 @@ SymbolDeleteSymTable()
     //
     ScriptEngineUnloadAllSymbolsWrapper();
 
+    //
+    // The cached unwind tables belong to the modules of the old symbol table
+    //
+    CallstackUnwindClearCache();
+
     //
     // Delete symbols
     //
@@ -0,0 +1,308 @@
+/**
+ * @file pe-batch.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Analyzing the PE images in batches (the .pe batch command)
+ * @details The images are mapped, analyzed, and formatted on a pool of worker
+ * threads, while the caller's thread shows (or writes) the summaries in the
+ * order of the paths
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+/**
+ * @brief Get the path in the form of the platform APIs
+ *
+ * @details Same as the dump engine, the path is only cast on Linux and the file
+ * wrappers of the platform narrow it back as wchar_t before opening the file
+ *
+ * @param Path
+ *
+ * @return const WCHAR *
+ */
+static const WCHAR *
+PeBatchGetPlatformPath(const std::wstring & Path)
+{
+#ifdef __linux__
+    return (const WCHAR *)Path.c_str();
+#else
+    return Path.c_str();
+#endif
+}
+
+/**
+ * @brief Read the paths of a list file (one path in each line)
+ *
+ * @details The empty lines and the lines that start with '#' are ignored, and
+ * the paths can be quoted
+ *
+ * @param ListPath
+ * @param Paths
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PeBatchReadList(const std::string & ListPath, std::vector<std::string> & Paths)
+{
+    std::ifstream List(ListPath);
+    std::string   Line;
+
+    if (!List.is_open())
+    {
+        ShowMessages("err, unable to open the list file '%s'\n", ListPath.c_str());
+        return FALSE;
+    }
+
+    while (std::getline(List, Line))
+    {
+        Trim(Line);
+
+        if (Line.empty() || Line[0] == '#')
+        {
+            continue;
+        }
+
+        if (Line.size() >= 2 && Line.front() == '"' && Line.back() == '"')
+        {
+            Line = Line.substr(1, Line.size() - 2);
+        }
+
+        Paths.push_back(Line);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Analyze and format a single image of the batch
+ *
+ * @param Thread
+ * @param Task
+ *
+ * @return VOID
+ */
+static VOID
+PeBatchAnalyzeTask(PE_BATCH_THREAD * Thread, PE_BATCH_TASK * Task)
+{
+    PE_ANALYSIS_IMAGE Summary;
+    std::wstring      Path;
+    HANDLE            FileHandle = NULL;
+    SIZE_T            FileSize   = 0;
+    VOID *            Image;
+    UINT32            Length;
+
+    StringToWString(Path, *Task->Path);
+
+    Image = PlatformMapFileReadOnly(PeBatchGetPlatformPath(Path), &FileSize, &FileHandle);
+
+    if (Image != NULL)
+    {
+        PeAnalysisAnalyzeImage((const BYTE *)Image, FileSize, &Summary, Thread->Sections.data());
+        PlatformUnmapFile(Image, FileSize, FileHandle);
+    }
+    else
+    {
+        memset(&Summary, 0, sizeof(Summary));
+        Summary.Status = PE_ANALYSIS_STATUS_UNABLE_TO_OPEN;
+    }
+
+    //
+    // Each character of the path takes at most six characters once it's escaped
+    //
+    if (Thread->Buffer.size() < PE_ANALYSIS_MAXIMUM_SUMMARY_SIZE + Task->Path->size() * 6)
+    {
+        Thread->Buffer.resize(PE_ANALYSIS_MAXIMUM_SUMMARY_SIZE + Task->Path->size() * 6);
+    }
+
+    Length = Thread->Job->IsCsv
+                 ? PeAnalysisFormatCsv(Task->Path->c_str(), &Summary, Thread->Sections.data(), Thread->Buffer.data(), (UINT32)Thread->Buffer.size())
+                 : PeAnalysisFormatJson(Task->Path->c_str(), &Summary, Thread->Sections.data(), Thread->Buffer.data(), (UINT32)Thread->Buffer.size());
+
+    Task->Status = Summary.Status;
+    Task->Summary.assign(Thread->Buffer.data(), Length);
+}
+
+/**
+ * @brief Worker thread of the batch
+ * @details Claims the images in order (so the first images, which are shown
+ * first, are analyzed first) and signals each one once it's formatted
+ *
+ * @param Param
+ *
+ * @return DWORD
+ */
+static DWORD WINAPI
+PeBatchWorkerThread(PVOID Param)
+{
+    PE_BATCH_THREAD * Thread = (PE_BATCH_THREAD *)Param;
+
+    for (auto & Task : Thread->Job->Tasks)
+    {
+        if (CpuInterlockedBitTestAndSet(&Task.Claimed, 0))
+            continue;
+
+        PeBatchAnalyzeTask(Thread, &Task);
+        PlatformSetEvent(Task.DoneEvent);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Analyze a batch of images in parallel
+ * @details Each image is a task of the pool, the current thread shows (or
+ * writes) the summaries in the order of the paths and analyzes the images that
+ * are not claimed yet by the workers. The summaries are JSON lines (one object
+ * for each image) or a CSV table
+ *
+ * @param Paths
+ * @param IsCsv
+ * @param OutputPath The summaries are written into this file (empty to show them)
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+PeBatchAnalyze(const std::vector<std::string> & Paths, BOOLEAN IsCsv, const std::string & OutputPath)
+{
+    PE_BATCH_JOB                 Job;
+    std::vector<PE_BATCH_THREAD> Threads;
+    std::vector<HANDLE>          Workers;
+    std::wstring                 OutputPathW;
+    UINT32                       NumberOfWorkers;
+    HANDLE                       OutputFile       = INVALID_HANDLE_VALUE;
+    UINT32                       NumberOfImages   = 0;
+    UINT32                       NumberOfFailures = 0;
+    BOOLEAN                      IsWritten        = TRUE;
+    CHAR                         Header[512];
+
+    if (Paths.empty())
+    {
+        ShowMessages("err, no file is found to analyze\n");
+        return FALSE;
+    }
+
+    if (!OutputPath.empty())
+    {
+        StringToWString(OutputPathW, OutputPath);
+
+        OutputFile = PlatformOpenFileForWriting(PeBatchGetPlatformPath(OutputPathW));
+
+        if (OutputFile == INVALID_HANDLE_VALUE)
+        {
+            ShowMessages("err, unable to create the output file '%s'\n", OutputPath.c_str());
+            return FALSE;
+        }
+    }
+
+    Job.IsCsv = IsCsv;
+    Job.Tasks.resize(Paths.size());
+
+    for (SIZE_T i = 0; i < Paths.size(); i++)
+    {
+        Job.Tasks[i].Path      = &Paths[i];
+        Job.Tasks[i].DoneEvent = PlatformCreateEvent(TRUE, FALSE);
+    }
+
+    //
+    // The current thread also analyzes, so one worker less than the processors
+    //
+    NumberOfWorkers = PlatformGetNumberOfProcessors() - 1;
+
+    if (NumberOfWorkers > Job.Tasks.size() - 1)
+        NumberOfWorkers = (UINT32)Job.Tasks.size() - 1;
+
+    //
+    // The first one is the current thread (not resized afterward, as the
+    // workers hold pointers to their own entry)
+    //
+    Threads.resize((SIZE_T)NumberOfWorkers + 1);
+
+    for (auto & Thread : Threads)
+    {
+        Thread.Job = &Job;
+        Thread.Sections.resize(PE_ANALYSIS_MAXIMUM_SECTIONS);
+    }
+
+    for (UINT32 i = 0; i < NumberOfWorkers; i++)
+    {
+        HANDLE Worker = PlatformCreateThread(PeBatchWorkerThread, &Threads[i + 1]);
+
+        if (Worker != NULL)
+            Workers.push_back(Worker);
+    }
+
+    if (IsCsv)
+    {
+        UINT32 Length = PeAnalysisFormatCsvHeader(Header, sizeof(Header));
+
+        if (OutputFile != INVALID_HANDLE_VALUE)
+            IsWritten = PlatformWriteFile(OutputFile, Header, Length);
+        else
+            ShowMessages("%s", Header);
+    }
+
+    //
+    // Show the summaries in order, analyzing the images that no worker has claimed
+    //
+    for (auto & Task : Job.Tasks)
+    {
+        if (!CpuInterlockedBitTestAndSet(&Task.Claimed, 0))
+            PeBatchAnalyzeTask(&Threads[0], &Task);
+        else
+            PlatformWaitForSingleObject(Task.DoneEvent, INFINITE);
+
+        NumberOfImages++;
+
+        if (Task.Status != PE_ANALYSIS_STATUS_SUCCESS)
+            NumberOfFailures++;
+
+        if (OutputFile != INVALID_HANDLE_VALUE)
+        {
+            if (IsWritten && !Task.Summary.empty())
+                IsWritten = PlatformWriteFile(OutputFile, Task.Summary.data(), (DWORD)Task.Summary.size());
+        }
+        else
+        {
+            ShowMessages("%s", Task.Summary.c_str());
+        }
+
+        //
+        // The summary is not needed anymore
+        //
+        std::string().swap(Task.Summary);
+    }
+
+    for (HANDLE Worker : Workers)
+    {
+        PlatformWaitForSingleObject(Worker, INFINITE);
+        PlatformCloseHandle(Worker);
+    }
+
+    for (auto & Task : Job.Tasks)
+    {
+        if (Task.DoneEvent != NULL)
+            PlatformCloseHandle(Task.DoneEvent);
+    }
+
+    if (OutputFile != INVALID_HANDLE_VALUE)
+    {
+        PlatformCloseFile(OutputFile);
+
+        if (!IsWritten)
+        {
+            ShowMessages("err, unable to write into the output file '%s'\n", OutputPath.c_str());
+            return FALSE;
+        }
+
+        ShowMessages("the summaries are written into '%s'\n", OutputPath.c_str());
+    }
+
+    ShowMessages("%u images are analyzed (%u of them are not valid PE images or couldn't be opened)\n",
+                 NumberOfImages,
+                 NumberOfFailures);
+
+    return TRUE;
+}
@@ -597,36 +597,14 @@ PeReadAsciiStringInDirectory(PPE_IMAGE_READER             Reader,
 static BOOLEAN
 PeComputeChecksum(PPE_IMAGE_READER Reader, SIZE_T ChecksumOffset, DWORD * Checksum)
 {
-    ULONGLONG Sum = 0;
+    UINT32 Computed;
 
-    if (Reader == NULL || Checksum == NULL || ChecksumOffset > Reader->ImageSize || sizeof(DWORD) > Reader->ImageSize - ChecksumOffset)
+    if (Reader == NULL || Checksum == NULL || !PeAnalysisChecksum(Reader->ImageBase, Reader->ImageSize, ChecksumOffset, &Computed))
     {
         return FALSE;
     }
 
-    for (SIZE_T Offset = 0; Offset < Reader->ImageSize; Offset += sizeof(WORD))
-    {
-        WORD Value = 0;
-
-        if (Offset >= ChecksumOffset && Offset < ChecksumOffset + sizeof(DWORD))
-        {
-            Value = 0;
-        }
-        else if (Offset + 1 < Reader->ImageSize)
-        {
-            CopyMemory(&Value, Reader->ImageBase + Offset, sizeof(Value));
-        }
-        else
-        {
-            Value = Reader->ImageBase[Offset];
-        }
-
-        Sum += Value;
-        Sum = (Sum & 0xffff) + (Sum >> 16);
-    }
-
-    Sum       = (Sum & 0xffff) + (Sum >> 16);
-    *Checksum = (DWORD)Sum + (DWORD)Reader->ImageSize;
+    *Checksum = Computed;
     return TRUE;
 }
 
@@ -1006,67 +984,6 @@ PeShowBoundImports(PPE_IMAGE_READER Reader, const IMAGE_DATA_DIRECTORY * BoundIm
     }
 }
 
-/**
- * @brief Computes the 64-bit FNV-1a hash of a byte buffer
- *
- * Uses the standard FNV-1a parameters: offset basis 14695981039346656037
- * and prime 1099511628211. Suitable for non-cryptographic fingerprinting.
- *
- * @param Data Pointer to the input data
- * @param Size Number of bytes to hash
- *
- * @return ULONGLONG The 64-bit FNV-1a hash value
- */
-static ULONGLONG
-PeFnv1a64(const BYTE * Data, DWORD Size)
-{
-    ULONGLONG Hash = 14695981039346656037ull;
-
-    for (DWORD Index = 0; Index < Size; Index++)
-    {
-        Hash ^= Data[Index];
-        Hash *= 1099511628211ull;
-    }
-
-    return Hash;
-}
-
-/**
- * @brief Computes the Shannon entropy of a byte buffer
- *
- * Calculates the frequency of each byte value (0-255) and applies the
- * standard information-entropy formula. A return value near 8.0 indicates
- * high entropy (e.g. compressed or encrypted data); values near 0.0 indicate
- * low entropy (e.g. sparse, mostly-zero data).
- *
- * @param Data Pointer to the input data
- * @param Size Number of bytes to analyse
- *
- * @return double Shannon entropy in bits per byte (0.0 to 8.0)
- */
-static double
-PeCalculateEntropy(const BYTE * Data, DWORD Size)
-{
-    DWORD  Counts[256] = {0};
-    double Entropy     = 0.0;
-
-    for (DWORD Index = 0; Index < Size; Index++)
-    {
-        Counts[Data[Index]]++;
-    }
-
-    for (DWORD Index = 0; Index < RTL_NUMBER_OF(Counts); Index++)
-    {
-        if (Counts[Index] != 0)
-        {
-            double Probability = (double)Counts[Index] / (double)Size;
-            Entropy -= Probability * (log(Probability) / log(2.0));
-        }
-    }
-
-    return Entropy;
-}
-
 /**
  * @brief Reads a 16-bit word from the image at the location mapped by an RVA
  *
@@ -4321,8 +4238,8 @@ SkipRichHeader:
             }
             else
             {
-                ShowMessages("\n%-36s%.4f", "Raw data entropy :", PeCalculateEntropy(Pointer, SecHeader->SizeOfRawData));
-                ShowMessages("\n%-36s%#llx", "Raw data FNV-1a64 :", PeFnv1a64(Pointer, SecHeader->SizeOfRawData));
+                ShowMessages("\n%-36s%.4f", "Raw data entropy :", PeAnalysisCalculateEntropy(Pointer, SecHeader->SizeOfRawData));
+                ShowMessages("\n%-36s%#llx", "Raw data FNV-1a64 :", PeAnalysisFnv1a64(Pointer, SecHeader->SizeOfRawData));
                 RemainingSectionScanBytes -= SecHeader->SizeOfRawData;
             }
         }
@@ -16,6 +16,9 @@
 //
 extern HWDBG_INSTANCE_INFORMATION g_HwdbgInstanceInfo;
 extern BOOLEAN                    g_HwdbgInstanceInfoIsValid;
+extern std::vector<UINT32>        g_HwdbgPortConfiguration;
+extern BOOLEAN                    g_HwdbgScriptOptimizer;
+extern BOOLEAN                    g_HwdbgScriptSimulator;
 
 /**
  * @brief Print the actual script
@@ -221,6 +224,97 @@ HwdbgScriptWriteScriptConfigurationPacketIntoFile(HWDBG_INSTANCE_INFORMATION * I
     }
 }
 
+/**
+ * @brief Optimize the stages of the script (constant operators are folded,
+ * the results are written directly into their destination, the dead and the
+ * unreachable stages are removed, and the temporary variables are reused)
+ *
+ * @param InstanceInfo
+ * @param ScriptBuffer
+ * @param ScriptBufferSize
+ * @param OptimizedScriptBuffer The optimized script (should be freed by the caller)
+ * @param OptimizedScriptBufferSize
+ *
+ * @return BOOLEAN FALSE if the script is not optimized
+ */
+BOOLEAN
+HwdbgScriptOptimizeScriptBuffer(HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                                CHAR *                       ScriptBuffer,
+                                UINT32                       ScriptBufferSize,
+                                CHAR **                      OptimizedScriptBuffer,
+                                UINT32 *                     OptimizedScriptBufferSize)
+{
+    UINT32                  NumberOfSymbols    = ScriptBufferSize / sizeof(SYMBOL);
+    UINT32                  NumberOfStages     = HwdbgOptimizerCountStages((SYMBOL *)ScriptBuffer, NumberOfSymbols);
+    UINT32                  NewNumberOfSymbols = 0;
+    SYMBOL *                Symbols            = NULL;
+    HWDBG_OPTIMIZER_STAGE * Stages             = NULL;
+    HWDBG_OPTIMIZER_RESULT  Result             = {0};
+
+    if (NumberOfStages == 0)
+    {
+        return FALSE;
+    }
+
+    Symbols = (SYMBOL *)malloc(NumberOfSymbols * sizeof(SYMBOL));
+    Stages  = (HWDBG_OPTIMIZER_STAGE *)malloc(NumberOfStages * sizeof(HWDBG_OPTIMIZER_STAGE));
+
+    if (Symbols == NULL || Stages == NULL)
+    {
+        free(Symbols);
+        free(Stages);
+        return FALSE;
+    }
+
+    //
+    // The script is optimized on a copy, so the original script is used if the
+    // script is not supported by the optimizer
+    //
+    memcpy(Symbols, ScriptBuffer, NumberOfSymbols * sizeof(SYMBOL));
+
+    if (!HwdbgOptimizerOptimizeScript(Symbols,
+                                      NumberOfSymbols,
+                                      InstanceInfo->scriptVariableLength,
+                                      Stages,
+                                      NumberOfStages,
+                                      &NewNumberOfSymbols,
+                                      &Result))
+    {
+        free(Symbols);
+        free(Stages);
+        return FALSE;
+    }
+
+    free(Stages);
+
+    //
+    // The chip needs at least a stage, and an empty script does nothing, the
+    // same as the original script
+    //
+    if (NewNumberOfSymbols == 0)
+    {
+        free(Symbols);
+        return FALSE;
+    }
+
+    ShowMessages("[*] script is optimized, stages: %d -> %d (flip-flops: %lld -> %lld), temporary variables: %d -> %d "
+                 "(folded: %d, forwarded: %d, removed: %d)\n",
+                 Result.NumberOfStagesBefore,
+                 Result.NumberOfStagesAfter,
+                 (UINT64)HwdbgComputeNumberOfFlipFlopsNeeded(InstanceInfo, Result.NumberOfStagesBefore),
+                 (UINT64)HwdbgComputeNumberOfFlipFlopsNeeded(InstanceInfo, Result.NumberOfStagesAfter),
+                 Result.NumberOfTemporaryVariablesBefore,
+                 Result.NumberOfTemporaryVariablesAfter,
+                 Result.NumberOfFoldedStages,
+                 Result.NumberOfForwardedStages,
+                 Result.NumberOfRemovedStages);
+
+    *OptimizedScriptBuffer     = (CHAR *)Symbols;
+    *OptimizedScriptBufferSize = NewNumberOfSymbols * sizeof(SYMBOL);
+
+    return TRUE;
+}
+
 /**
  * @brief Create hwdbg script
  * @param ScriptBuffer
@@ -241,6 +335,24 @@ HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
     SIZE_T               NumberOfNeededFlipFlopsInTargetDevice = 0;
     SIZE_T               NumberOfBytesPerChunk                 = 0;
     HWDBG_SHORT_SYMBOL * NewScriptBuffer                       = NULL;
+    CHAR *               OptimizedScriptBuffer                 = NULL;
+    UINT32               OptimizedScriptBufferSize             = 0;
+    BOOLEAN              Result                                = FALSE;
+
+    //
+    // *** Optimize the stages of the script (fewer stages and temporary variables
+    // are needed from the instance), only if it's enabled by 'settings hwdbgoptimizer on' ***
+    //
+    if (g_HwdbgScriptOptimizer &&
+        HwdbgScriptOptimizeScriptBuffer(&g_HwdbgInstanceInfo,
+                                        ScriptBuffer,
+                                        ScriptBufferSize,
+                                        &OptimizedScriptBuffer,
+                                        &OptimizedScriptBufferSize))
+    {
+        ScriptBuffer     = OptimizedScriptBuffer;
+        ScriptBufferSize = OptimizedScriptBufferSize;
+    }
 
     //
     // *** Check the script capabilities with the generated script ***
@@ -253,7 +365,7 @@ HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
                                                                           &NumberOfOperandsImplemented))
     {
         ShowMessages("\n[-] target script is NOT supported by this instance of hwdbg!\n");
-        return FALSE;
+        goto Cleanup;
     }
     else
     {
@@ -272,7 +384,7 @@ HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
                                          &NumberOfBytesPerChunk))
     {
         ShowMessages("err, unable to compress the script buffer\n");
-        return FALSE;
+        goto Cleanup;
     }
 
     //
@@ -302,9 +414,29 @@ HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
                                                            NewCompressedBufferSize))
     {
         ShowMessages("err, unable to write script buffer\n");
-        return FALSE;
+        goto Cleanup;
+    }
+
+    //
+    // *** Simulate the script on a model of the stages (only the result is
+    // shown, the packet is already written), only if it's enabled by
+    // 'settings hwdbgsimulator on' ***
+    //
+    if (g_HwdbgScriptSimulator)
+    {
+        HwdbgScriptSimulateScript(&g_HwdbgInstanceInfo,
+                                  NumberOfStagesForScript + NumberOfOperandsImplemented - 1,
+                                  NewScriptBuffer,
+                                  (UINT32)NewCompressedBufferSize);
     }
 
+    //
+    // The script buffer is created successfully
+    //
+    Result = TRUE;
+
+Cleanup:
+
     //
     // *** Free the allocated memory ***
     //
@@ -318,9 +450,14 @@ HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
     }
 
     //
-    // The script buffer is created successfully
+    // Free the optimized script buffer
     //
-    return TRUE;
+    if (OptimizedScriptBuffer != NULL)
+    {
+        free(OptimizedScriptBuffer);
+    }
+
+    return Result;
 }
 
 /** Get script buffer from raw string
@@ -377,6 +514,143 @@ HwdbgScriptGetScriptBufferFromRawString(string   ScriptString,
     return TRUE;
 }
 
+/**
+ * @brief Simulate the script on a cycle-level model of the stages of hwdbg
+ *
+ * @details The packet is written into a BRAM image the same way as the packet
+ * that is sent to the chip, so the model configures its stages from the same
+ * bytes, then the outputs of a few inputs (zeros, ones, and walking ones) are
+ * shown after the latency of the stages
+ *
+ * @param InstanceInfo
+ * @param NumberOfSymbols
+ * @param Buffer
+ * @param BufferLength
+ *
+ * @return BOOLEAN
+ */
+BOOLEAN
+HwdbgScriptSimulateScript(HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                          UINT32                       NumberOfSymbols,
+                          HWDBG_SHORT_SYMBOL *         Buffer,
+                          UINT32                       BufferLength)
+{
+    DEBUGGER_REMOTE_PACKET           Packet       = {0};
+    HWDBG_SCRIPT_BUFFER              ScriptBuffer = {0};
+    HWDBG_MODEL                      Model        = {0};
+    SIZE_T                           Offset       = InstanceInfo->debuggerAreaOffset;
+    SIZE_T                           NumberOfPins = InstanceInfo->numberOfPins;
+    UINT32                           PinWords     = HWDBG_MODEL_PIN_WORDS(InstanceInfo->numberOfPins);
+    UINT32                           Latency      = 0;
+    std::vector<BYTE>                Bram;
+    std::vector<UINT64>              ModelBuffer;
+    std::vector<std::vector<UINT64>> Inputs;
+    std::vector<UINT64>              Output(PinWords);
+
+    if (g_HwdbgPortConfiguration.size() != InstanceInfo->numberOfPorts)
+    {
+        ShowMessages("err, the ports of the instance are not available for the simulation\n");
+        return FALSE;
+    }
+
+    //
+    // The model is kept in 8-byte aligned memory
+    //
+    ModelBuffer.resize((HwdbgModelGetBufferSize(InstanceInfo) + sizeof(UINT64) - 1) / sizeof(UINT64));
+
+    if (ModelBuffer.empty() ||
+        !HwdbgModelInitialize(&Model,
+                              InstanceInfo,
+                              g_HwdbgPortConfiguration.data(),
+                              ModelBuffer.data(),
+                              ModelBuffer.size() * sizeof(UINT64)))
+    {
+        ShowMessages("err, this instance of hwdbg cannot be simulated\n");
+        return FALSE;
+    }
+
+    //
+    // Write the packet into the BRAM image (the same as
+    // HwdbgScriptSendScriptPacket and HwdbgInterpreterSendPacketAndBufferToHwdbg)
+    //
+    Packet.Indicator                  = INDICATOR_OF_HYPERDBG_PACKET;
+    Packet.TypeOfThePacket            = DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_HARDWARE_LEVEL;
+    Packet.RequestedActionOfThePacket = (DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION)hwdbgActionConfigureScriptBuffer;
+
+    ScriptBuffer.scriptNumberOfSymbols = NumberOfSymbols;
+
+    Bram.resize(Offset + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(HWDBG_SCRIPT_BUFFER) + BufferLength);
+
+    memcpy(&Bram[Offset], &Packet, sizeof(DEBUGGER_REMOTE_PACKET));
+    memcpy(&Bram[Offset + sizeof(DEBUGGER_REMOTE_PACKET)], &ScriptBuffer, sizeof(HWDBG_SCRIPT_BUFFER));
+
+    if (Buffer != NULL && BufferLength != 0)
+    {
+        memcpy(&Bram[Offset + sizeof(DEBUGGER_REMOTE_PACKET) + sizeof(HWDBG_SCRIPT_BUFFER)], Buffer, BufferLength);
+    }
+
+    if (!HwdbgModelReceivePacket(&Model, Bram.data(), Bram.size()))
+    {
+        ShowMessages("err, the script buffer is not accepted by the model of the stages of hwdbg\n");
+        return FALSE;
+    }
+
+    //
+    // Zeros, ones, and walking ones on the first pins
+    //
+    Inputs.push_back(std::vector<UINT64>(PinWords, 0));
+    Inputs.push_back(std::vector<UINT64>(PinWords, ~0ull));
+
+    if (NumberOfPins % 64 != 0)
+    {
+        Inputs.back()[PinWords - 1] = (1ull << (NumberOfPins % 64)) - 1;
+    }
+
+    for (SIZE_T i = 0; i < NumberOfPins && i < 8; i++)
+    {
+        Inputs.push_back(std::vector<UINT64>(PinWords, 0));
+        Inputs.back()[i / 64] = 1ull << (i % 64);
+    }
+
+    Latency = HwdbgModelGetLatency(&Model);
+
+    ShowMessages("\nsimulating the script on a model of the stages of hwdbg (latency: %d clocks, %d pins):\n\n",
+                 Latency,
+                 InstanceInfo->numberOfPins);
+
+    //
+    // A new input is given at each clock, and each output is shown after the
+    // latency of the stages
+    //
+    for (SIZE_T Clock = 0; Clock < Inputs.size() + Latency; Clock++)
+    {
+        HwdbgModelClock(&Model, Clock < Inputs.size() ? Inputs[Clock].data() : Model.ZeroPins, Output.data());
+
+        if (Clock < Latency)
+        {
+            continue;
+        }
+
+        ShowMessages("input: ");
+
+        for (UINT32 i = PinWords; i > 0; i--)
+        {
+            ShowMessages("%016llx", Inputs[Clock - Latency][i - 1]);
+        }
+
+        ShowMessages(" -> output: ");
+
+        for (UINT32 i = PinWords; i > 0; i--)
+        {
+            ShowMessages("%016llx", Output[i - 1]);
+        }
+
+        ShowMessages("\n");
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Sends a HyperDbg (hwdbg) script packet to the hwdbg
  *
@@ -64,6 +64,9 @@ ShowMemoryCommandDQ(UCHAR * OutputBuffer, UINT32 Size, UINT64 Address, DEBUGGER_
 VOID
 CommandPteShowResults(UINT64 TargetVa, PDEBUGGER_READ_PAGE_TABLE_ENTRIES_DETAILS PteRead);
 
+BOOLEAN
+CommandDtShowDataBasedOnTypeLayout(PDEBUGGER_DT_COMMAND_OPTIONS DtDetails, PVOID Buffer, UINT32 BufferLength);
+
 DEBUGGER_CONDITIONAL_JUMP_STATUS
 HyperDbgIsConditionalJumpTaken(UCHAR * BufferToDisassemble,
                                UINT64  BuffLength,
@@ -130,6 +133,15 @@ HyperDbgReadMemory(UINT64                              TargetAddress,
                    BYTE *                              TargetBufferToStore,
                    UINT32 *                            ReturnLength);
 
+BOOLEAN
+HyperDbgReadMemoryQuietly(UINT64                     TargetAddress,
+                          DEBUGGER_READ_MEMORY_TYPE  MemoryType,
+                          DEBUGGER_READ_READING_TYPE ReadingType,
+                          UINT32                     Pid,
+                          UINT32                     Size,
+                          BYTE *                     TargetBufferToStore,
+                          UINT32 *                   ReturnLength);
+
 VOID
 HyperDbgShowMemoryOrDisassemble(DEBUGGER_SHOW_MEMORY_STYLE   Style,
                                 UINT64                       Address,
@@ -161,6 +173,9 @@ ContinuePreviousCommand();
 VOID
 CommandDumpSaveIntoFile(PVOID Buffer, UINT32 Length);
 
+BOOLEAN
+HyperDbgScriptReadFileAndExecuteCommand(std::vector<std::string> & PathAndArgs);
+
 //////////////////////////////////////////////////
 //              Type of Commands                //
 //////////////////////////////////////////////////
@@ -484,12 +499,21 @@ typedef std::map<std::string, COMMAND_DETAIL> CommandType;
 #define DEBUGGER_COMMAND_SMI_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
 
+#define DEBUGGER_COMMAND_DIRTY_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
+
+#define DEBUGGER_COMMAND_EXITPROF_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
+
 #define DEBUGGER_COMMAND_LBR_ATTRIBUTES \
     NULL
 
 #define DEBUGGER_COMMAND_LBRDUMP_ATTRIBUTES \
     DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
 
+#define DEBUGGER_COMMAND_LBRPROF_ATTRIBUTES \
+    DEBUGGER_COMMAND_ATTRIBUTE_LOCAL_COMMAND_IN_DEBUGGER_MODE
+
 #define DEBUGGER_COMMAND_PT_ATTRIBUTES \
     NULL
 
@@ -779,15 +803,30 @@ CommandIdt(vector<CommandToken> CommandTokens, string Command);
 VOID
 CommandSmi(vector<CommandToken> CommandTokens, string Command);
 
+VOID
+CommandDirty(vector<CommandToken> CommandTokens, string Command);
+
+VOID
+CommandExitprof(vector<CommandToken> CommandTokens, string Command);
+
 VOID
 CommandLbr(vector<CommandToken> CommandTokens, string Command);
 
 VOID
 CommandLbrdump(vector<CommandToken> CommandTokens, string Command);
 
+VOID
+CommandLbrdumpGetArchBranchTypet(UINT32 BrType, CHAR * BrTypeName);
+
+VOID
+CommandLbrprof(vector<CommandToken> CommandTokens, string Command);
+
 VOID
 CommandPt(vector<CommandToken> CommandTokens, string Command);
 
+VOID
+CommandPtDecode(vector<CommandToken> & CommandTokens);
+
 //
 // hwdbg commands
 //
@@ -309,12 +309,21 @@ CommandIdtHelp();
 VOID
 CommandSmiHelp();
 
+VOID
+CommandDirtyHelp();
+
+VOID
+CommandExitprofHelp();
+
 VOID
 CommandLbrHelp();
 
 VOID
 CommandLbrdumpHelp();
 
+VOID
+CommandLbrprofHelp();
+
 VOID
 CommandPtHelp();
 
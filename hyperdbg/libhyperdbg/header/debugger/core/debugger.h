@@ -64,6 +64,7 @@
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_SMI_OPERATION_RESULT                0x1f
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_HYPERTRACE_LBR_DUMP_RESULT          0x20
 #define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_HYPERTRACE_PT_OPERATION_RESULT      0x21
+#define DEBUGGER_SYNCRONIZATION_OBJECT_KERNEL_DEBUGGER_REGISTER_EVENT_SET                  0x22
 
 //////////////////////////////////////////////////
 //               Event Details                  //
@@ -248,6 +249,9 @@ CommandTrackHandleReceivedCallInstructions(const CHAR * NameOfFunctionFromSymbol
 VOID
 CommandTrackHandleReceivedRetInstructions(UINT64 CurrentRip);
 
+BOOLEAN
+CommandTrackHandleBatchedRecord(PVOID Context, const STEP_RECORD * Record);
+
 BOOLEAN
 HyperDbgWriteMemory(PVOID                     DestinationAddress,
                     DEBUGGER_EDIT_MEMORY_TYPE MemoryType,
@@ -278,6 +282,9 @@ HyperDbgReadTargetRegister(REGS_ENUM RegisterId, UINT64 * TargetRegister);
 BOOLEAN
 HyperDbgWriteTargetRegister(REGS_ENUM RegisterId, UINT64 Value);
 
+VOID
+HyperDbgRegisterShowValues(GUEST_REGS * Regs, GUEST_EXTRA_REGISTERS * ExtraRegs, BOOLEAN ShowSegmentRegisters);
+
 BOOLEAN
 HyperDbgRegisterShowAll();
 
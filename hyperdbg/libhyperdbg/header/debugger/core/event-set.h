@@ -0,0 +1,57 @@
+/**
+ * @file event-set.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief headers for registering sets of events at once
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//            	    Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief An event of the event set that is not registered yet
+ *
+ */
+typedef struct _EVENT_SET_PENDING_EVENT
+{
+    PDEBUGGER_GENERAL_EVENT_DETAIL Event;
+    std::vector<BYTE>              Entries; // the event and its actions (DEBUGGER_EVENT_SET_ENTRY)
+    BOOLEAN                        HasActions;
+
+} EVENT_SET_PENDING_EVENT, *PEVENT_SET_PENDING_EVENT;
+
+//////////////////////////////////////////////////
+//            	    Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+EventSetBegin();
+
+BOOLEAN
+EventSetIsRecording();
+
+BOOLEAN
+EventSetAddEvent(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                 UINT32                         EventBufferLength);
+
+BOOLEAN
+EventSetAddActions(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
+                   PDEBUGGER_GENERAL_ACTION       ActionBreakToDebugger,
+                   UINT32                         ActionBreakToDebuggerLength,
+                   PDEBUGGER_GENERAL_ACTION       ActionCustomCode,
+                   UINT32                         ActionCustomCodeLength,
+                   PDEBUGGER_GENERAL_ACTION       ActionScript,
+                   UINT32                         ActionScriptLength);
+
+BOOLEAN
+EventSetCommit();
+
+VOID
+EventSetAbort();
@@ -11,6 +11,22 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//            	    Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The context of showing the records of the batched steps
+ *
+ */
+typedef struct _STEPPING_BATCHED_SHOW_CONTEXT
+{
+    BOOLEAN     ShowRegisters;
+    BOOLEAN     IsFirstRecordOfBatch; // already shown by the previous pause
+    STEP_RECORD PreviousRecord;
+
+} STEPPING_BATCHED_SHOW_CONTEXT, *PSTEPPING_BATCHED_SHOW_CONTEXT;
+
 //////////////////////////////////////////////////
 //            	    Functions                   //
 //////////////////////////////////////////////////
@@ -29,3 +45,17 @@ SteppingInstrumentationStepInForTracking();
 
 BOOLEAN
 SteppingStepOverForGu(BOOLEAN LastInstruction);
+
+BOOLEAN
+SteppingBatchedInstrumentationStepIn(UINT32               StepCount,
+                                     BOOLEAN              ForTracking,
+                                     BOOLEAN              WithRegisters,
+                                     BOOLEAN              WithInstructionBytes,
+                                     STEP_RECORD_CALLBACK Callback,
+                                     PVOID                Context);
+
+BOOLEAN
+SteppingBatchedInstrumentationStepInAndShow(UINT32 StepCount, BOOLEAN ShowRegisters);
+
+VOID
+SteppingHandleReceivedBatchedRecords(PVOID Chunk, UINT32 ChunkSize);
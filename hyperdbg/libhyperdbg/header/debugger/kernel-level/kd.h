@@ -128,6 +128,9 @@ PDEBUGGER_EVENT_AND_ACTION_RESULT
 KdSendRegisterEventPacketToDebuggee(PDEBUGGER_GENERAL_EVENT_DETAIL Event,
                                     UINT32                         EventBufferLength);
 
+PDEBUGGER_EVENT_SET_RESULT
+KdSendRegisterEventSetPacketToDebuggee(PDEBUGGER_EVENT_SET EventSet);
+
 PDEBUGGER_EVENT_AND_ACTION_RESULT
 KdSendAddActionToEventPacketToDebuggee(PDEBUGGER_GENERAL_ACTION GeneralAction,
                                        UINT32                   GeneralActionLength);
@@ -189,6 +192,12 @@ KdSendSearchRequestPacketToDebuggee(UINT64 * SearchRequestBuffer, UINT32 SearchR
 BOOLEAN
 KdSendStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType);
 
+BOOLEAN
+KdSendBatchedStepPacketToDebuggee(DEBUGGER_REMOTE_STEPPING_REQUEST StepRequestType,
+                                  UINT32                           StepCount,
+                                  BOOLEAN                          WithRegisters,
+                                  BOOLEAN                          WithInstructionBytes);
+
 BYTE
 KdComputeDataChecksum(PVOID Buffer, UINT32 Length);
 
@@ -200,6 +209,10 @@ BOOLEAN
 KdAddActionToEventInDebuggee(PDEBUGGER_GENERAL_ACTION ActionAddingBuffer,
                              UINT32                   Length);
 
+BOOLEAN
+KdRegisterEventSetInDebuggee(PDEBUGGER_EVENT_SET EventSet,
+                             UINT32              Length);
+
 BOOLEAN
 KdSendModifyEventInDebuggee(PDEBUGGER_MODIFY_EVENTS ModifyEvent, BOOLEAN SendTheResultBackToDebugger);
 
@@ -0,0 +1,101 @@
+/**
+ * @file dump-engine.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the engine of the .dump and !dump commands
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Number of the chunks that are in flight (read but not written yet)
+ *
+ */
+#define DUMP_ENGINE_NUMBER_OF_SLOTS 8
+
+/**
+ * @brief Number of the reading threads on the local debugging (VMI) mode (the
+ * number of the slots should be a multiple of it)
+ *
+ */
+#define DUMP_ENGINE_NUMBER_OF_READERS 4
+
+/**
+ * @brief Size of the buffer of the lines of the manifest that are not written yet
+ *
+ */
+#define DUMP_ENGINE_PENDING_MANIFEST_SIZE 0x10000
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A chunk that is in flight between a reader and the writer
+ *
+ */
+typedef struct _DUMP_ENGINE_SLOT
+{
+    UINT8 *        Buffer      = NULL;
+    MEM_DUMP_CHUNK Chunk       = {0};
+    BOOLEAN        IsVerified  = FALSE; // the chunk is already in the dump file (resuming)
+    HANDLE         FreeEvent   = NULL;
+    HANDLE         FilledEvent = NULL;
+
+} DUMP_ENGINE_SLOT, *PDUMP_ENGINE_SLOT;
+
+/**
+ * @brief State shared between the threads of a dump
+ *
+ * @details Reader r reads the chunks r, r + R, r + 2R, ... into the slots (the
+ * chunk i always uses the slot i % DUMP_ENGINE_NUMBER_OF_SLOTS), and the writer
+ * thread writes the slots in the order of the chunks
+ *
+ */
+typedef struct _DUMP_ENGINE_JOB
+{
+    MEM_DUMP_PLAN                              Plan;
+    DEBUGGER_READ_MEMORY_TYPE                  MemoryType;
+    UINT32                                     Pid; // the process that is read
+    UINT32                                     NumberOfReaders;
+    DUMP_ENGINE_SLOT                           Slots[DUMP_ENGINE_NUMBER_OF_SLOTS];
+    std::unordered_map<UINT64, MEM_DUMP_CHUNK> VerifiedChunks;
+    std::vector<UINT32>                        ReadableMasks;
+    HANDLE                                     DataFile     = INVALID_HANDLE_VALUE;
+    HANDLE                                     ManifestFile = INVALID_HANDLE_VALUE;
+    MEM_DUMP_WRITER                            Writer;
+    volatile BOOLEAN                           IsWriteFailed = FALSE;
+
+} DUMP_ENGINE_JOB, *PDUMP_ENGINE_JOB;
+
+/**
+ * @brief State of each reading thread
+ *
+ */
+typedef struct _DUMP_ENGINE_READER
+{
+    DUMP_ENGINE_JOB * Job   = NULL;
+    UINT32            Index = 0;
+
+} DUMP_ENGINE_READER, *PDUMP_ENGINE_READER;
+
+//////////////////////////////////////////////////
+//					  Functions                 //
+//////////////////////////////////////////////////
+
+BOOLEAN
+DumpEngineDump(const std::wstring &      Path,
+               UINT64                    StartAddress,
+               UINT64                    EndAddress,
+               DEBUGGER_READ_MEMORY_TYPE MemoryType,
+               UINT32                    Pid,
+               BOOLEAN                   IsPidSpecified,
+               BOOLEAN                   Resume);
@@ -11,49 +11,43 @@
  */
 #pragma once
 
-#define PCI_ID_AS_STR_LENGTH (sizeof(UINT16) * 2)
-#define PCI_NAME_STR_LENGTH  255
+#define PCI_NAME_STR_LENGTH 255
 
-typedef struct SubDevice
-{
-    UINT16             SubVendorId;
-    UINT16             SubDeviceId;
-    CHAR               SubSystemName[PCI_NAME_STR_LENGTH];
-    struct SubDevice * Next;
-} SubDevice;
-
-typedef struct Device
-{
-    UINT16          DeviceId;
-    CHAR            DeviceName[PCI_NAME_STR_LENGTH];
-    SubDevice *     SubDevices;
-    struct Device * Next;
-} Device;
-
-typedef struct Vendor
-{
-    UINT16   VendorId;
-    CHAR     VendorName[PCI_NAME_STR_LENGTH];
-    Device * Devices;
-} Vendor;
+//
+// The entries point into the index of the database (PciIds.h), they stay
+// valid until FreePciIdDatabase() is called
+//
+typedef PCI_IDS_SUBDEVICE SubDevice;
+typedef PCI_IDS_DEVICE    Device;
+typedef PCI_IDS_VENDOR    Vendor;
 
 //
 // PCI ID database courtesy of PCI ID Database (pciutils) project at
 // https://pci-ids.ucw.cz/
 //
-#define PCI_ID_DATABASE_PATH "constants\\pci.ids"
+#define PCI_ID_DATABASE_PATH L"constants\\pci.ids"
+
+//
+// Index of the database, it's compiled again whenever the size or the last
+// write time of the database changes
+//
+#define PCI_ID_INDEX_PATH L"constants\\pci.ids.idx"
 
 //////////////////////////////////////////////////
 //					  Functions                 //
 //////////////////////////////////////////////////
 
-Vendor *
+const Vendor *
 GetVendorById(UINT16 VendorId);
 void
-FreeVendor(Vendor * VendorToFree);
-void
 FreePciIdDatabase();
-Device *
-GetDeviceFromVendor(Vendor * VendorToUse, UINT16 DeviceId);
-SubDevice *
-GetSubDeviceFromDevice(Device * DeviceToUse, UINT16 SubVendorId, UINT16 SubDeviceId);
+const Device *
+GetDeviceFromVendor(const Vendor * VendorToUse, UINT16 DeviceId);
+const SubDevice *
+GetSubDeviceFromDevice(const Device * DeviceToUse, UINT16 SubVendorId, UINT16 SubDeviceId);
+const CHAR *
+GetVendorName(const Vendor * VendorToUse);
+const CHAR *
+GetDeviceName(const Device * DeviceToUse);
+const CHAR *
+GetSubDeviceName(const SubDevice * SubDeviceToUse);
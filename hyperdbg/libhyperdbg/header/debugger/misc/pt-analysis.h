@@ -0,0 +1,139 @@
+/**
+ * @file pt-analysis.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the aggregating analysis of the decoded PT traces
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Analysis modes of the PT traces
+ *
+ */
+#define PT_ANALYSIS_MODE_COVERAGE 0x1 // basic-block coverage bitmap
+#define PT_ANALYSIS_MODE_EDGES    0x2 // branch-edge hit counts
+#define PT_ANALYSIS_MODE_PROFILE  0x4 // per-function histogram and call tree
+#define PT_ANALYSIS_MODE_ALL      (PT_ANALYSIS_MODE_COVERAGE | PT_ANALYSIS_MODE_EDGES | PT_ANALYSIS_MODE_PROFILE)
+
+/**
+ * @brief Number of the hottest entries that are shown on the console
+ *
+ */
+#define PT_ANALYSIS_MAXIMUM_SHOWN_ENTRIES 20
+
+/**
+ * @brief Index of the root node of the call tree
+ *
+ */
+#define PT_ANALYSIS_CALL_TREE_ROOT 0
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Options of the analysis which are given by the user
+ *
+ */
+typedef struct _PT_ANALYSIS_OPTIONS
+{
+    UINT32 Modes;                // zero means printing the instructions
+    CHAR   ExportPath[MAX_PATH]; // prefix of the exported files (empty if not exported)
+
+} PT_ANALYSIS_OPTIONS, *PPT_ANALYSIS_OPTIONS;
+
+/**
+ * @brief Hash of the pairs that are used as the keys of the analysis maps
+ *
+ */
+typedef struct _PT_ANALYSIS_PAIR_HASH
+{
+    template <typename FIRST, typename SECOND>
+    SIZE_T operator()(const std::pair<FIRST, SECOND> & Pair) const
+    {
+        return std::hash<UINT64>()((UINT64)Pair.first * 0x9e3779b97f4a7c15ull ^ (UINT64)Pair.second);
+    }
+
+} PT_ANALYSIS_PAIR_HASH, *PPT_ANALYSIS_PAIR_HASH;
+
+/**
+ * @brief A node of the call tree (a function entry under a caller)
+ *
+ */
+typedef struct _PT_ANALYSIS_CALL_NODE
+{
+    UINT32 Parent;
+    UINT64 Entry;        // address of the called function (zero for the root)
+    UINT64 Instructions; // instructions executed in this node, excluding the callees
+
+} PT_ANALYSIS_CALL_NODE, *PPT_ANALYSIS_CALL_NODE;
+
+/**
+ * @brief State of the analysis
+ *
+ * @details Each decoding thread has its own state (so recording a block
+ * needs no locking) and the states are merged once the decoding is done.
+ * The call tree nodes are always created after their parents, so walking
+ * CallNodes in order visits the parents first
+ *
+ */
+typedef struct _PT_ANALYSIS_STATE
+{
+    UINT32                 Modes             = 0;
+    IMAGE_SYMBOL_CONTEXT * Image             = NULL;
+    UINT64                 TotalInstructions = 0;
+    UINT64                 TotalBlocks       = 0;
+
+    //
+    // Coverage, one bit per byte of the captured .text (set at block starts)
+    //
+    std::vector<UINT64> CoverageBitmap;
+
+    //
+    // Edges, keyed by (the last instruction of a block, the next block)
+    //
+    std::unordered_map<std::pair<UINT64, UINT64>, UINT64, PT_ANALYSIS_PAIR_HASH> Edges;
+
+    //
+    // Profile, instructions by block start and the call tree
+    //
+    std::unordered_map<UINT64, UINT64>                                           BlockInstructions;
+    std::vector<PT_ANALYSIS_CALL_NODE>                                           CallNodes;
+    std::unordered_map<std::pair<UINT32, UINT64>, UINT32, PT_ANALYSIS_PAIR_HASH> CallChildren;
+
+    //
+    // The flow of the current decoder
+    //
+    UINT32             CurrentNode  = PT_ANALYSIS_CALL_TREE_ROOT;
+    UINT64             LastBlockEnd = 0;
+    enum pt_insn_class LastClass    = ptic_unknown;
+
+} PT_ANALYSIS_STATE, *PPT_ANALYSIS_STATE;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+VOID
+PtAnalysisInitialize(PT_ANALYSIS_STATE * State, UINT32 Modes, IMAGE_SYMBOL_CONTEXT * Image);
+
+VOID
+PtAnalysisResetFlow(PT_ANALYSIS_STATE * State);
+
+VOID
+PtAnalysisRecordBlock(PT_ANALYSIS_STATE * State, const struct pt_block * Block);
+
+VOID
+PtAnalysisMerge(PT_ANALYSIS_STATE * Target, const PT_ANALYSIS_STATE * Source);
+
+VOID
+PtAnalysisShowAndExport(PT_ANALYSIS_STATE * State, HANDLE Process, const CHAR * ImagePath, const PT_ANALYSIS_OPTIONS * Options);
@@ -11,6 +11,150 @@
  */
 #pragma once
 
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Bits of the CR3 that select the address space (the PCID bits are
+ * ignored, the same as in the PIP packets)
+ *
+ */
+#define PT_HELPER_CR3_ADDRESS_MASK 0x000ffffffffff000ull
+
+/**
+ * @brief Target size of each independently decoded segment of a core's
+ * trace (segments end at the first PSB after this size)
+ *
+ */
+#define PT_HELPER_DECODE_SEGMENT_SIZE (8 * 1024 * 1024)
+
+/**
+ * @brief Number of the segments (for each decoding thread) that can be decoded
+ * ahead of the segment that is being shown, it bounds the buffered output
+ *
+ */
+#define PT_HELPER_DECODE_SEGMENTS_PER_THREAD 2
+
+/**
+ * @brief Maximum size of a single formatted line of the decoders
+ *
+ */
+#define PT_HELPER_MAXIMUM_LINE_SIZE 512
+
+/**
+ * @brief Maximum size of each chunk of the decoded text that is shown
+ *
+ */
+#define PT_HELPER_OUTPUT_CHUNK_SIZE (COMMUNICATION_BUFFER_SIZE / 2)
+
+/**
+ * @brief Size after which a streamed output is shown
+ *
+ */
+#define PT_HELPER_OUTPUT_FLUSH_SIZE (64 * 1024)
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The trace buffer of a single core
+ *
+ */
+typedef struct _PT_HELPER_CORE_TRACE
+{
+    UINT32        Cpu;
+    const UINT8 * Buffer;
+    UINT64        Size;
+
+} PT_HELPER_CORE_TRACE, *PPT_HELPER_CORE_TRACE;
+
+/**
+ * @brief The text output of a decoder
+ *
+ * @details If Stream is set, the text is shown while decoding, otherwise
+ * it's buffered until the caller shows it
+ *
+ */
+typedef struct _PT_HELPER_DECODE_OUTPUT
+{
+    std::string Text;
+    BOOLEAN     Stream = FALSE;
+
+} PT_HELPER_DECODE_OUTPUT, *PPT_HELPER_DECODE_OUTPUT;
+
+/**
+ * @brief A disassembled instruction of the captured image with its
+ * formatted line
+ *
+ */
+typedef struct _PT_HELPER_CACHED_INSTRUCTION
+{
+    enum pt_exec_mode Mode;
+    UINT8             Size; // zero if the instruction is undecodable
+    std::string       Text;
+
+} PT_HELPER_CACHED_INSTRUCTION, *PPT_HELPER_CACHED_INSTRUCTION;
+
+/**
+ * @brief Decoded-instruction cache of a captured image (keyed by IP)
+ *
+ * @details Loops execute the same few addresses again and again, so each
+ * instruction is disassembled and formatted only once per decoding thread
+ *
+ */
+typedef struct _PT_HELPER_INSTRUCTION_CACHE
+{
+    IMAGE_SYMBOL_CONTEXT *                                   Image = NULL;
+    std::unordered_map<UINT64, PT_HELPER_CACHED_INSTRUCTION> Instructions;
+
+} PT_HELPER_INSTRUCTION_CACHE, *PPT_HELPER_INSTRUCTION_CACHE;
+
+/**
+ * @brief A single segment of the parallel decoding
+ *
+ */
+typedef struct _PT_HELPER_DECODE_TASK
+{
+    UINT32                  CoreIndex      = 0;
+    const UINT8 *           Buffer         = NULL;
+    UINT64                  Size           = 0;
+    BOOLEAN                 IsFirstSegment = FALSE;
+    volatile LONG           Claimed        = 0;
+    HANDLE                  StartEvent     = NULL; // set once the segment is in the window
+    HANDLE                  DoneEvent      = NULL;
+    UINT64                  Count          = 0;
+    PT_HELPER_DECODE_OUTPUT Output;
+
+} PT_HELPER_DECODE_TASK, *PPT_HELPER_DECODE_TASK;
+
+/**
+ * @brief State shared between the threads of the parallel decoding
+ *
+ */
+typedef struct _PT_HELPER_DECODE_JOB
+{
+    PT_HELPER_CORE_TRACE *             Cores;
+    BOOLEAN                            Packets;
+    IMAGE_SYMBOL_CONTEXT *             Ctx;
+    PT_ANALYSIS_STATE *                Analysis; // NULL if the instructions are shown
+    std::vector<PT_HELPER_DECODE_TASK> Tasks;
+
+} PT_HELPER_DECODE_JOB, *PPT_HELPER_DECODE_JOB;
+
+/**
+ * @brief State of each thread of the parallel decoding
+ *
+ */
+typedef struct _PT_HELPER_DECODE_THREAD
+{
+    PT_HELPER_DECODE_JOB *      Job = NULL;
+    PT_HELPER_INSTRUCTION_CACHE Cache;
+    PT_ANALYSIS_STATE           Analysis;
+
+} PT_HELPER_DECODE_THREAD, *PPT_HELPER_DECODE_THREAD;
+
 //////////////////////////////////////////////////
 //					  Functions                 //
 //////////////////////////////////////////////////
@@ -21,6 +165,16 @@ PtHelperDecodeCorePackets(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, UINT64
 UINT64
 PtHelperDecodeCore(UINT32 Cpu, const UINT8 * Buffer, UINT64 Size, IMAGE_SYMBOL_CONTEXT * Ctx);
 
+UINT64
+PtHelperDecodeCoresParallel(PT_HELPER_CORE_TRACE * Cores,
+                            UINT32                 NumberOfCores,
+                            BOOLEAN                Packets,
+                            IMAGE_SYMBOL_CONTEXT * Ctx,
+                            PT_ANALYSIS_STATE *    Analysis);
+
+VOID
+PtHelperShowOutput(PT_HELPER_DECODE_OUTPUT * Output);
+
 BOOLEAN
 PtHelperCaptureImage(HANDLE Process, UINT64 * TextStart, UINT64 * TextEnd, IMAGE_SYMBOL_CONTEXT * Ctx);
 
@@ -0,0 +1,175 @@
+/**
+ * @file pt-trace-file.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the offline PT trace container
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Magic ('HDPT') and version of the trace container
+ *
+ */
+#define PT_TRACE_FILE_MAGIC   0x54504448
+#define PT_TRACE_FILE_VERSION 2
+
+/**
+ * @brief Alignment of the data blocks (the per-core traces and the images)
+ * in the container, so they are page-aligned once the file is mapped
+ *
+ */
+#define PT_TRACE_FILE_ALIGNMENT 0x1000
+
+/**
+ * @brief Size of each sequential write to the container
+ *
+ */
+#define PT_TRACE_FILE_WRITE_CHUNK_SIZE (64 * 1024 * 1024)
+
+/**
+ * @brief Handle that identifies the symbols of the offline decoding in
+ * DbgHelp (it's not a process handle, which is allowed as the process is
+ * not invaded)
+ *
+ */
+#define PT_TRACE_FILE_SYMBOL_HANDLE ((HANDLE)(ULONG_PTR)PT_TRACE_FILE_MAGIC)
+
+/**
+ * @brief Types of the sideband records
+ *
+ */
+#define PT_TRACE_FILE_SIDEBAND_PROCESS    1 // a traced process and its address space
+#define PT_TRACE_FILE_SIDEBAND_CR3_SWITCH 2 // a switch of the address space in a core's trace
+
+/**
+ * @brief Core of the sideband records that are not specific to a core
+ *
+ */
+#define PT_TRACE_FILE_SIDEBAND_ALL_CORES 0xffffffff
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Details of the processor that captured the trace (needed for
+ * converting the timing packets of the trace)
+ *
+ */
+typedef struct _PT_TRACE_FILE_CPU
+{
+    UINT32 Family;
+    UINT32 Model;
+    UINT32 Stepping;
+    UINT32 Cpuid15Eax;       // TSC / core crystal clock ratio (denominator)
+    UINT32 Cpuid15Ebx;       // TSC / core crystal clock ratio (numerator)
+    UINT32 NominalFrequency; // nominal core-to-bus ratio (the CBR of the base frequency)
+    UINT64 CaptureTsc;       // TSC when the trace is saved
+
+} PT_TRACE_FILE_CPU, *PPT_TRACE_FILE_CPU;
+
+/**
+ * @brief Configuration of the capture
+ *
+ */
+typedef struct _PT_TRACE_FILE_CONFIG
+{
+    UINT32 ProcessId;
+    INT32  PinCore;
+    UINT64 FilterStart;
+    UINT64 FilterEnd;
+    CHAR   ImagePath[MAX_PATH];
+
+} PT_TRACE_FILE_CONFIG, *PPT_TRACE_FILE_CONFIG;
+
+/**
+ * @brief Header of the container
+ *
+ * @details The header is followed by NumberOfCores PT_TRACE_FILE_CORE,
+ * NumberOfImages PT_TRACE_FILE_IMAGE and NumberOfSidebandRecords
+ * PT_TRACE_FILE_SIDEBAND entries, and then the data blocks which are
+ * aligned to PT_TRACE_FILE_ALIGNMENT
+ *
+ */
+typedef struct _PT_TRACE_FILE_HEADER
+{
+    UINT32               Magic;
+    UINT32               Version;
+    UINT32               NumberOfCores;
+    UINT32               NumberOfImages;
+    UINT32               NumberOfSidebandRecords;
+    UINT32               Reserved;
+    UINT64               FileSize;
+    PT_TRACE_FILE_CPU    Cpu;
+    PT_TRACE_FILE_CONFIG Config;
+
+} PT_TRACE_FILE_HEADER, *PPT_TRACE_FILE_HEADER;
+
+/**
+ * @brief The raw PT data of a single core
+ *
+ */
+typedef struct _PT_TRACE_FILE_CORE
+{
+    UINT32 Cpu;
+    UINT32 Reserved;
+    UINT64 Offset;
+    UINT64 Size;
+
+} PT_TRACE_FILE_CORE, *PPT_TRACE_FILE_CORE;
+
+/**
+ * @brief A captured image section with its load address
+ *
+ */
+typedef struct _PT_TRACE_FILE_IMAGE
+{
+    UINT64 ImageBase;
+    UINT64 LoadAddress;
+    UINT64 Offset;
+    UINT64 Size;
+
+} PT_TRACE_FILE_IMAGE, *PPT_TRACE_FILE_IMAGE;
+
+/**
+ * @brief A record of the process sideband
+ *
+ * @details The process records map the traced processes to their address
+ * spaces, and the switch records are the PIP packets of each core's trace
+ * (where the core switched to another address space)
+ *
+ */
+typedef struct _PT_TRACE_FILE_SIDEBAND
+{
+    UINT32 Type;
+    UINT32 Cpu;       // PT_TRACE_FILE_SIDEBAND_ALL_CORES for the processes
+    UINT32 ProcessId; // zero if the address space is not of a traced process
+    UINT32 Reserved;
+    UINT64 Offset;    // offset of the PIP packet in the core's trace
+    UINT64 Tsc;       // last TSC before the PIP packet (zero if there is none)
+    UINT64 Cr3;
+
+} PT_TRACE_FILE_SIDEBAND, *PPT_TRACE_FILE_SIDEBAND;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+PtTraceFileSave(const CHAR *                 Path,
+                const PT_HELPER_CORE_TRACE * Cores,
+                UINT32                       NumberOfCores,
+                const IMAGE_SYMBOL_CONTEXT * Image,
+                const PT_TRACE_FILE_CONFIG * Config);
+
+BOOLEAN
+PtTraceFileDecode(const CHAR * Path, BOOLEAN Packets, const PT_ANALYSIS_OPTIONS * Analysis);
@@ -0,0 +1,78 @@
+/**
+ * @file unwind.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for the x64 unwind-table based callstack walker
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum number of frames that the unwinder walks
+ *
+ */
+#define UNWIND_MAXIMUM_FRAMES 0x100
+
+/**
+ * @brief Size of each cached line of the stack (never crosses a page)
+ *
+ */
+#define UNWIND_STACK_CACHE_LINE_SIZE 0x40
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Cached unwind details of a single loaded module
+ *
+ * @details RuntimeFunctions is kept sorted by BeginAddress so a lookup is
+ * a binary search, and UnwindInfos caches the raw UNWIND_INFO blobs which
+ * are fetched lazily (keyed by their RVA). The modules that can't be read
+ * are cached without unwind data (and with a zero SizeOfImage), so they're
+ * not read again until the symbol table is deleted
+ *
+ */
+typedef struct _UNWIND_MODULE_CACHE
+{
+    UINT64                               BaseAddress;
+    UINT32                               SizeOfImage;
+    BOOLEAN                              HasUnwindData;
+    BOOLEAN                              IsLocalFile;
+    std::vector<UNWIND_RUNTIME_FUNCTION> RuntimeFunctions;
+    std::map<UINT32, std::vector<BYTE>>  UnwindInfos;
+    std::ifstream                        LocalFile; // only used if the module is read from a local file
+    UINT64                               LocalFileSize;
+    std::vector<IMAGE_SECTION_HEADER>    LocalSections;
+
+} UNWIND_MODULE_CACHE, *PUNWIND_MODULE_CACHE;
+
+/**
+ * @brief The module and the stack cache that are read by the callbacks of
+ * the unwinder (UNWIND_IMAGE)
+ *
+ */
+typedef struct _UNWIND_READER_CONTEXT
+{
+    PUNWIND_MODULE_CACHE                                               Module;
+    std::map<UINT64, std::array<BYTE, UNWIND_STACK_CACHE_LINE_SIZE>> * StackCache;
+
+} UNWIND_READER_CONTEXT, *PUNWIND_READER_CONTEXT;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+CallstackUnwindAndShowFrames(UINT32 Length);
+
+VOID
+CallstackUnwindClearCache();
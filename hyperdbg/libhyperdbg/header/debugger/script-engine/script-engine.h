@@ -38,6 +38,9 @@ ScriptEngineGetFieldOffsetWrapper(CHAR * TypeName, CHAR * FieldName, UINT32 * Fi
 BOOLEAN
 ScriptEngineGetDataTypeSizeWrapper(CHAR * TypeName, UINT64 * TypeSize);
 
+const SYMBOL_TYPE_LAYOUT *
+ScriptEngineGetTypeLayoutWrapper(const CHAR * TypeName);
+
 BOOLEAN
 ScriptEngineCreateSymbolTableForDisassemblerWrapper(VOID * CallbackFunction);
 
@@ -36,6 +36,7 @@ typedef struct _IMAGE_SYMBOL_CONTEXT
     UINT64  CodeBase;
     UINT64  CodeSize;
     UINT8 * Code;
+    UINT64  Cr3; // address space of the image (zero if it's not known)
 } IMAGE_SYMBOL_CONTEXT;
 
 /*
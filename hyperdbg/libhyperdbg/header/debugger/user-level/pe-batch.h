@@ -0,0 +1,63 @@
+/**
+ * @file pe-batch.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers for analyzing the PE images in batches (the .pe batch command)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief An image of the batch
+ *
+ */
+typedef struct _PE_BATCH_TASK
+{
+    const std::string * Path      = NULL;
+    volatile LONG       Claimed   = 0;
+    HANDLE              DoneEvent = NULL;
+    PE_ANALYSIS_STATUS  Status    = PE_ANALYSIS_STATUS_UNABLE_TO_OPEN;
+    std::string         Summary; // the formatted line
+
+} PE_BATCH_TASK, *PPE_BATCH_TASK;
+
+/**
+ * @brief State shared between the threads of the batch
+ *
+ */
+typedef struct _PE_BATCH_JOB
+{
+    BOOLEAN                    IsCsv = FALSE;
+    std::vector<PE_BATCH_TASK> Tasks;
+
+} PE_BATCH_JOB, *PPE_BATCH_JOB;
+
+/**
+ * @brief State of each thread of the batch
+ *
+ */
+typedef struct _PE_BATCH_THREAD
+{
+    PE_BATCH_JOB *                   Job = NULL;
+    std::vector<CHAR>                Buffer;
+    std::vector<PE_ANALYSIS_SECTION> Sections;
+
+} PE_BATCH_THREAD, *PPE_BATCH_THREAD;
+
+//////////////////////////////////////////////////
+//					  Functions                 //
+//////////////////////////////////////////////////
+
+BOOLEAN
+PeBatchReadList(const std::string & ListPath, std::vector<std::string> & Paths);
+
+BOOLEAN
+PeBatchAnalyze(const std::vector<std::string> & Paths, BOOLEAN IsCsv, const std::string & OutputPath);
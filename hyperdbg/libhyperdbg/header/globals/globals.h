@@ -311,6 +311,12 @@ DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfRegisteringEvent = {0};
 DEBUGGER_EVENT_AND_ACTION_RESULT g_DebuggeeResultOfAddingActionsToEvent = {
     0};
 
+/**
+ * @brief Holds the result of registering event sets from the remote debuggee
+ *
+ */
+DEBUGGER_EVENT_SET_RESULT g_DebuggeeResultOfRegisteringEventSet = {0};
+
 /**
  * @brief This is an OVERLAPPED structure for managing simultaneous
  * read and writes for debugger (in current design debuggee is not needed
@@ -409,6 +415,20 @@ BOOLEAN g_EventTraceInitialized = FALSE;
  */
 LIST_ENTRY g_EventTrace = {0};
 
+/**
+ * @brief Shows whether the events are recorded into an event set
+ * instead of registering them one by one
+ *
+ */
+BOOLEAN g_EventSetRecording = FALSE;
+
+/**
+ * @brief The events (and their actions) of the event set that is
+ * being recorded
+ *
+ */
+std::vector<EVENT_SET_PENDING_EVENT> g_EventSetPendingEvents;
+
 /**
  * @brief it shows whether the debugger started using
  * output sources or not or in other words, is g_OutputSources
@@ -570,6 +590,17 @@ UINT64 g_RdtscMedian = 0;
  */
 BOOLEAN g_IsInstrumentingInstructions = FALSE;
 
+/**
+ * @brief The callback that receives the records of the batched steps
+ * (valid only while the batched steps are running)
+ */
+STEP_RECORD_CALLBACK g_BatchedSteppingCallback = NULL;
+
+/**
+ * @brief The context of the callback of the batched steps
+ */
+PVOID g_BatchedSteppingCallbackContext = NULL;
+
 /**
  * @brief Shows the kernel base address
  */
@@ -632,6 +663,13 @@ UINT32 g_SymbolTableSize = NULL;
  */
 UINT32 g_SymbolTableCurrentIndex = NULL;
 
+/**
+ * @brief Cached unwind tables (RUNTIME_FUNCTIONs) of the loaded
+ * modules, keyed by the base address of the module
+ *
+ */
+std::map<UINT64, UNWIND_MODULE_CACHE> g_UnwindModuleCache;
+
 /**
  * @brief Result of the expression that is evaluated in the
  * debuggee
@@ -707,3 +745,18 @@ std::vector<UINT32> g_HwdbgPortConfiguration;
  *
  */
 UINT64 * g_HwdbgPinsStatus;
+
+/**
+ * @brief Whether the stages of the hwdbg scripts are optimized or not
+ * @details it is disabled by default
+ *
+ */
+BOOLEAN g_HwdbgScriptOptimizer = FALSE;
+
+/**
+ * @brief Whether the hwdbg scripts are simulated on the model of the stages
+ * or not
+ * @details it is disabled by default
+ *
+ */
+BOOLEAN g_HwdbgScriptSimulator = FALSE;
@@ -18,6 +18,13 @@
 VOID
 HwdbgScriptPrintScriptBuffer(CHAR * ScriptBuffer, UINT32 ScriptBufferSize);
 
+BOOLEAN
+HwdbgScriptOptimizeScriptBuffer(HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                                CHAR *                       ScriptBuffer,
+                                UINT32                       ScriptBufferSize,
+                                CHAR **                      OptimizedScriptBuffer,
+                                UINT32 *                     OptimizedScriptBufferSize);
+
 BOOLEAN
 HwdbgScriptCreateHwdbgScript(CHAR *        ScriptBuffer,
                              UINT32        ScriptBufferSize,
@@ -30,6 +37,12 @@ HwdbgScriptSendScriptPacket(HWDBG_INSTANCE_INFORMATION * InstanceInfo,
                             HWDBG_SHORT_SYMBOL *         Buffer,
                             UINT32                       BufferLength);
 
+BOOLEAN
+HwdbgScriptSimulateScript(HWDBG_INSTANCE_INFORMATION * InstanceInfo,
+                          UINT32                       NumberOfSymbols,
+                          HWDBG_SHORT_SYMBOL *         Buffer,
+                          UINT32                       BufferLength);
+
 BOOLEAN
 HwdbgScriptGetScriptBufferFromRawString(string   ScriptString,
                                         PVOID *  CodeBuffer,
@@ -106,6 +106,7 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 #include <cctype>
 #include <cstring>
 #include <unordered_set>
+#include <unordered_map>
 #include <regex>
 #ifdef _WIN32
 #    include <dbghelp.h>
@@ -185,8 +186,9 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 #include "platform/user/header/windows-only/windows-privilege.h"
 
 //
-// PCI IDs
+// PCI IDs (the entries point into the index of the database)
 //
+#include "../include/components/pciids/header/PciIds.h"
 #include "header/debugger/misc/pci-id.h"
 
 //
@@ -194,6 +196,11 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 //
 #include "../dependencies/libipt/intel-pt.h"
 
+//
+// Records of the batched steps (used by the headers of the commands)
+//
+#include "../include/components/steprecord/header/StepRecord.h"
+
 //
 // General
 //
@@ -203,8 +210,11 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 #include "header/debugger/commands/commands.h"
 #include "header/common/common.h"
 #include "header/debugger/script-engine/symbol.h"
+#include "header/debugger/misc/pt-analysis.h"
 #include "header/debugger/misc/pt-helper.h"
+#include "header/debugger/misc/pt-trace-file.h"
 #include "header/debugger/core/debugger.h"
+#include "header/debugger/core/event-set.h"
 #include "header/debugger/script-engine/script-engine.h"
 #include "header/debugger/commands/help.h"
 #include "header/debugger/driver-loader/install.h"
@@ -222,8 +232,18 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 // Components
 //
 #include "../include/components/pe/header/pe-image-reader.h"
+#include "../include/components/atomics/header/Atomics.h"
+#include "../include/components/dirtybitmap/header/DirtyBitmap.h"
+#include "../include/components/exitprofiler/header/ExitProfiler.h"
+#include "../include/components/lbrprofile/header/LbrProfile.h"
+#include "../include/components/memdump/header/MemDump.h"
+#include "../include/components/peanalysis/header/PeAnalysis.h"
+#include "../include/components/unwind/header/Unwind.h"
 
 #include "header/debugger/user-level/pe-parser.h"
+#include "header/debugger/user-level/pe-batch.h"
+#include "header/debugger/misc/unwind.h"
+#include "header/debugger/misc/dump-engine.h"
 #include "header/debugger/user-level/ud.h"
 #include "header/objects/objects.h"
 #include "header/debugger/core/steppings.h"
@@ -233,6 +253,8 @@ typedef const wchar_t *LPCWCHAR, *PCWCHAR;
 //
 // hwdbg
 //
+#include "../include/components/hwdbgoptimizer/header/HwdbgOptimizer.h"
+#include "../include/components/hwdbgmodel/header/HwdbgModel.h"
 #include "header/hwdbg/hwdbg-interpreter.h"
 #include "header/hwdbg/hwdbg-scripts.h"
 
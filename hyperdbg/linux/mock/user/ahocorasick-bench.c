@@ -0,0 +1,537 @@
+/**
+ * @file ahocorasick-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the multi-string matcher of the transparent-mode footprints
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <strings.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_NUMBER_OF_TEXTS   8192
+#define BENCH_MAXIMUM_TEXT      256
+#define BENCH_MAXIMUM_MATCHES   1024
+#define BENCH_BENCHMARK_ROUNDS  32
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A text of the tests, in both of the narrow and wide forms
+ *
+ */
+typedef struct _BENCH_TEXT
+{
+    char   Narrow[BENCH_MAXIMUM_TEXT + 1];
+    WCHAR  Wide[BENCH_MAXIMUM_TEXT + 1];
+    SIZE_T Length;
+
+} BENCH_TEXT, *PBENCH_TEXT;
+
+/**
+ * @brief The collected matches
+ *
+ */
+typedef struct _BENCH_MATCHES
+{
+    AHO_CORASICK_MATCH Entries[BENCH_MAXIMUM_MATCHES];
+    UINT32             Count;
+
+} BENCH_MATCHES, *PBENCH_MATCHES;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+
+/**
+ * @brief The same strings as the HV_REGKEYS list of hyperevade
+ *
+ */
+static const char * g_Patterns[] = {
+    "VEN_80EE",
+    "VEN_15AD",
+    "VEN_5333",
+    "Virtual",
+    "VIRTUAL",
+    "virtual",
+    "Hypervisor",
+    "hypervisor",
+    "HYPERVISOR",
+    "VMware Tools",
+    "VMware, Inc.",
+    "vmusbmouse",
+    "VMware",
+    "VMWARE",
+    "VMWare",
+    "vmdebug",
+    "vmmouse",
+    "VMTools",
+    "VMMEMCTL",
+    "vmware tools",
+    "VMW0001",
+    "VMW0002",
+    "VMW0003",
+    "sandbox",
+    "Sandboxie",
+    "VirtualBox Guest Additions",
+    "VBOX__",
+    "VBoxGuest",
+    "VBoxMouse",
+    "VBoxService",
+    "VBoxSF",
+    "VBoxVideo",
+    "VIRTUALBOX",
+    "SUN MICROSYSTEMS",
+    "VBOXVER",
+    "VBOXAPIC",
+    "INNOTEK GMBH",
+    "qemu-ga",
+    "SPICE Guest Tools",
+    "vpcbus",
+    "vpc-s3",
+    "vpcuhub",
+    "msvmmouf",
+    "Wine",
+    "xen",
+    "VIRTUAL MACHINE",
+    "GOOGLE COMPUTE ENGINE",
+    "sandbox",
+    "Sandboxie",
+    "vioscsi",
+    "viostor",
+    "VirtIO-FS Service",
+    "VirtioSerial",
+    "BALLOON",
+    "BalloonService",
+    "netkvm",
+};
+
+#define BENCH_NUMBER_OF_PATTERNS (sizeof(g_Patterns) / sizeof(g_Patterns[0]))
+
+static WCHAR  g_WidePatterns[BENCH_NUMBER_OF_PATTERNS][64];
+static UINT32 g_CanonicalIndex[BENCH_NUMBER_OF_PATTERNS];
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static char
+BenchFold(char Char)
+{
+    return (Char >= 'A' && Char <= 'Z') ? Char + ('a' - 'A') : Char;
+}
+
+static char
+BenchFlipCase(char Char)
+{
+    if (Char >= 'A' && Char <= 'Z')
+    {
+        return Char + ('a' - 'A');
+    }
+
+    if (Char >= 'a' && Char <= 'z')
+    {
+        return Char - ('a' - 'A');
+    }
+
+    return Char;
+}
+
+/**
+ * @brief Case-insensitive compare of a pattern at an offset of the text
+ *
+ */
+static BOOLEAN
+BenchMatchesAt(const BENCH_TEXT * Text, SIZE_T Offset, UINT32 PatternIndex)
+{
+    SIZE_T Length = strlen(g_Patterns[PatternIndex]);
+
+    if (Offset + Length > Text->Length)
+    {
+        return FALSE;
+    }
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        if (BenchFold(Text->Narrow[Offset + i]) != BenchFold(g_Patterns[PatternIndex][i]))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static void
+BenchPreparePatterns(void)
+{
+    for (UINT32 i = 0; i < BENCH_NUMBER_OF_PATTERNS; i++)
+    {
+        SIZE_T Length = strlen(g_Patterns[i]);
+
+        for (SIZE_T j = 0; j <= Length; j++)
+        {
+            g_WidePatterns[i][j] = (WCHAR)(UINT8)g_Patterns[i][j];
+        }
+
+        //
+        // The patterns that only differ in case are reported with the first of them
+        //
+        g_CanonicalIndex[i] = i;
+
+        for (UINT32 j = 0; j < i; j++)
+        {
+            if (strlen(g_Patterns[j]) == Length && strncasecmp(g_Patterns[j], g_Patterns[i], Length) == 0)
+            {
+                g_CanonicalIndex[i] = g_CanonicalIndex[j];
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Build a random text with planted patterns (in random case)
+ *
+ */
+static void
+BenchBuildText(PBENCH_TEXT Text)
+{
+    static const char Alphabet[] = "abcdeilmnorstuvwxyzABEGIMRSTUVWX0123456789_-. \\";
+    SIZE_T            Length     = BenchRandom() % (BENCH_MAXIMUM_TEXT + 1);
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        Text->Narrow[i] = Alphabet[BenchRandom() % (sizeof(Alphabet) - 1)];
+    }
+
+    //
+    // Some of the texts are a pattern on their own, the others have a few
+    // patterns planted in them
+    //
+    if (BenchRandom() % 8 == 0)
+    {
+        const char * Pattern = g_Patterns[BenchRandom() % BENCH_NUMBER_OF_PATTERNS];
+
+        Length = strlen(Pattern);
+        memcpy(Text->Narrow, Pattern, Length);
+    }
+    else
+    {
+        for (UINT32 Planted = (UINT32)(BenchRandom() % 4); Planted != 0 && Length != 0; Planted--)
+        {
+            const char * Pattern       = g_Patterns[BenchRandom() % BENCH_NUMBER_OF_PATTERNS];
+            SIZE_T       PatternLength = strlen(Pattern);
+
+            if (PatternLength <= Length)
+            {
+                memcpy(Text->Narrow + BenchRandom() % (Length - PatternLength + 1), Pattern, PatternLength);
+            }
+        }
+    }
+
+    for (SIZE_T i = 0; i < Length; i++)
+    {
+        if (BenchRandom() % 4 == 0)
+        {
+            Text->Narrow[i] = BenchFlipCase(Text->Narrow[i]);
+        }
+
+        Text->Wide[i] = (WCHAR)(UINT8)Text->Narrow[i];
+    }
+
+    Text->Narrow[Length] = '\0';
+    Text->Wide[Length]   = 0;
+    Text->Length         = Length;
+}
+
+/**
+ * @brief All of the matches, in the order of their end (and the longest first)
+ *
+ */
+static void
+BenchReferenceMatches(const BENCH_TEXT * Text, PBENCH_MATCHES Matches)
+{
+    Matches->Count = 0;
+
+    for (SIZE_T End = 1; End <= Text->Length; End++)
+    {
+        for (SIZE_T Start = 0; Start < End; Start++)
+        {
+            for (UINT32 i = 0; i < BENCH_NUMBER_OF_PATTERNS; i++)
+            {
+                if (g_CanonicalIndex[i] == i && strlen(g_Patterns[i]) == End - Start && BenchMatchesAt(Text, Start, i))
+                {
+                    Matches->Entries[Matches->Count].Offset       = Start;
+                    Matches->Entries[Matches->Count].Length       = (UINT32)(End - Start);
+                    Matches->Entries[Matches->Count].PatternIndex = i;
+                    Matches->Count++;
+                }
+            }
+        }
+    }
+}
+
+static BOOLEAN
+BenchSaveMatch(PVOID Context, const AHO_CORASICK_MATCH * Match)
+{
+    PBENCH_MATCHES Matches = (PBENCH_MATCHES)Context;
+
+    assert(Matches->Count < BENCH_MAXIMUM_MATCHES);
+
+    Matches->Entries[Matches->Count++] = *Match;
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchSameMatch(const AHO_CORASICK_MATCH * Expected, const AHO_CORASICK_MATCH * Actual)
+{
+    return Expected->Offset == Actual->Offset &&
+           Expected->Length == Actual->Length &&
+           Expected->PatternIndex == Actual->PatternIndex;
+}
+
+/**
+ * @brief Check all of the functions of the matcher on a text, against the
+ * reference matches
+ *
+ */
+static BOOLEAN
+BenchCheckText(const AHO_CORASICK_AUTOMATON * Narrow, const AHO_CORASICK_AUTOMATON * Wide, const BENCH_TEXT * Text)
+{
+    static BENCH_MATCHES Expected;
+    static BENCH_MATCHES Actual;
+    AHO_CORASICK_MATCH   First    = {0};
+    AHO_CORASICK_MATCH   Match    = {0};
+    BOOLEAN              Whole    = FALSE;
+    UINT32               WholeIdx = 0;
+    UINT32               Index    = 0;
+
+    BenchReferenceMatches(Text, &Expected);
+
+    //
+    // The leftmost match, and the longest of the matches that start there
+    //
+    for (UINT32 i = 0; i < Expected.Count; i++)
+    {
+        if (i == 0 ||
+            Expected.Entries[i].Offset < First.Offset ||
+            (Expected.Entries[i].Offset == First.Offset && Expected.Entries[i].Length > First.Length))
+        {
+            First = Expected.Entries[i];
+        }
+
+        if (Expected.Entries[i].Offset == 0 && Expected.Entries[i].Length == Text->Length)
+        {
+            Whole    = TRUE;
+            WholeIdx = Expected.Entries[i].PatternIndex;
+        }
+    }
+
+    for (UINT32 Form = 0; Form < 4; Form++)
+    {
+        //
+        // Narrow and wide texts, given by their length or null-terminated
+        //
+        const AHO_CORASICK_AUTOMATON * Automaton = (Form & 1) ? Wide : Narrow;
+        const VOID *                   String    = (Form & 1) ? (const VOID *)Text->Wide : (const VOID *)Text->Narrow;
+        SIZE_T                         Length    = (Form & 2) ? AHO_CORASICK_NULL_TERMINATED : Text->Length;
+        BOOLEAN                        IsWide    = (Form & 1) ? TRUE : FALSE;
+
+        Actual.Count = 0;
+        AhoCorasickForEachMatch(Automaton, String, Length, IsWide, BenchSaveMatch, &Actual);
+
+        if (Actual.Count != Expected.Count)
+        {
+            printf("err, \"%s\" (form %u): expected %u matches, found %u\n", Text->Narrow, Form, Expected.Count, Actual.Count);
+            return FALSE;
+        }
+
+        for (UINT32 i = 0; i < Expected.Count; i++)
+        {
+            if (!BenchSameMatch(&Expected.Entries[i], &Actual.Entries[i]))
+            {
+                printf("err, \"%s\" (form %u): match %u differs\n", Text->Narrow, Form, i);
+                return FALSE;
+            }
+        }
+
+        if (AhoCorasickContains(Automaton, String, Length, IsWide) != (Expected.Count != 0))
+        {
+            printf("err, \"%s\" (form %u): contains differs\n", Text->Narrow, Form);
+            return FALSE;
+        }
+
+        if (AhoCorasickFindFirst(Automaton, String, Length, IsWide, &Match) != (Expected.Count != 0) ||
+            (Expected.Count != 0 && !BenchSameMatch(&First, &Match)))
+        {
+            printf("err, \"%s\" (form %u): first match differs\n", Text->Narrow, Form);
+            return FALSE;
+        }
+
+        if (AhoCorasickMatchesWhole(Automaton, String, Length, IsWide, &Index) != Whole ||
+            (Whole && Index != WholeIdx))
+        {
+            printf("err, \"%s\" (form %u): whole match differs\n", Text->Narrow, Form);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief The previous search, one pass over the text for each of the patterns
+ *
+ */
+static UINT64
+BenchSearchLegacy(const BENCH_TEXT * Texts)
+{
+    UINT64 Count = 0;
+
+    for (UINT32 i = 0; i < BENCH_NUMBER_OF_TEXTS; i++)
+    {
+        for (UINT32 j = 0; j < BENCH_NUMBER_OF_PATTERNS; j++)
+        {
+            if (strstr(Texts[i].Narrow, g_Patterns[j]) != NULL)
+            {
+                Count++;
+                break;
+            }
+        }
+    }
+
+    return Count;
+}
+
+static UINT64
+BenchSearchEngine(const AHO_CORASICK_AUTOMATON * Automaton, const BENCH_TEXT * Texts)
+{
+    UINT64 Count = 0;
+
+    for (UINT32 i = 0; i < BENCH_NUMBER_OF_TEXTS; i++)
+    {
+        if (AhoCorasickContains(Automaton, Texts[i].Narrow, AHO_CORASICK_NULL_TERMINATED, FALSE))
+        {
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+int
+main(void)
+{
+    AHO_CORASICK_AUTOMATON Narrow;
+    AHO_CORASICK_AUTOMATON Wide;
+    const VOID *           WidePatterns[BENCH_NUMBER_OF_PATTERNS];
+    PBENCH_TEXT            Texts;
+    SIZE_T                 Size;
+    SIZE_T                 WideSize;
+    PVOID                  NarrowStorage;
+    PVOID                  WideStorage;
+    BOOLEAN                Passed = TRUE;
+    UINT64                 TotalLength = 0;
+    UINT64                 EngineCount = 0;
+    UINT64                 LegacyCount = 0;
+    double                 Start;
+    double                 EngineTime;
+    double                 LegacyTime;
+
+    BenchPreparePatterns();
+
+    for (UINT32 i = 0; i < BENCH_NUMBER_OF_PATTERNS; i++)
+    {
+        WidePatterns[i] = g_WidePatterns[i];
+    }
+
+    Size          = AhoCorasickGetRequiredSize((const VOID * const *)g_Patterns, BENCH_NUMBER_OF_PATTERNS, FALSE);
+    NarrowStorage = malloc(Size);
+    WideSize      = AhoCorasickGetRequiredSize(WidePatterns, BENCH_NUMBER_OF_PATTERNS, TRUE);
+    WideStorage   = malloc(WideSize);
+    Texts         = malloc(BENCH_NUMBER_OF_TEXTS * sizeof(BENCH_TEXT));
+
+    if (Size == 0 || WideSize == 0 || NarrowStorage == NULL || WideStorage == NULL || Texts == NULL)
+    {
+        printf("err, unable to allocate the automata\n");
+        return 1;
+    }
+
+    if (!AhoCorasickBuild(&Narrow, (const VOID * const *)g_Patterns, BENCH_NUMBER_OF_PATTERNS, FALSE, NarrowStorage, Size) ||
+        !AhoCorasickBuild(&Wide, WidePatterns, BENCH_NUMBER_OF_PATTERNS, TRUE, WideStorage, WideSize))
+    {
+        printf("err, unable to build the automata\n");
+        return 1;
+    }
+
+    printf("%u patterns, %u states, %u classes, %llu bytes\n",
+           (UINT32)BENCH_NUMBER_OF_PATTERNS,
+           Narrow.NumberOfStates,
+           Narrow.NumberOfClasses,
+           (unsigned long long)Size);
+
+    //
+    // Check the matches on random texts
+    //
+    for (UINT32 i = 0; i < BENCH_NUMBER_OF_TEXTS && Passed; i++)
+    {
+        BenchBuildText(&Texts[i]);
+        TotalLength += Texts[i].Length;
+
+        Passed = BenchCheckText(&Narrow, &Wide, &Texts[i]);
+    }
+
+    //
+    // Throughput of the engine and of the previous search
+    //
+    if (Passed)
+    {
+        Start = BenchNow();
+        for (UINT32 Round = 0; Round < BENCH_BENCHMARK_ROUNDS; Round++)
+        {
+            EngineCount = BenchSearchEngine(&Narrow, Texts);
+        }
+        EngineTime = BenchNow() - Start;
+
+        Start = BenchNow();
+        for (UINT32 Round = 0; Round < BENCH_BENCHMARK_ROUNDS; Round++)
+        {
+            LegacyCount = BenchSearchLegacy(Texts);
+        }
+        LegacyTime = BenchNow() - Start;
+
+        printf("engine:     %8.1f MB/s (%llu of %u texts, case-insensitive)\n",
+               BenchThroughput(TotalLength * BENCH_BENCHMARK_ROUNDS, EngineTime),
+               (unsigned long long)EngineCount,
+               BENCH_NUMBER_OF_TEXTS);
+        printf("per-string: %8.1f MB/s (%llu of %u texts, case-sensitive)\n",
+               BenchThroughput(TotalLength * BENCH_BENCHMARK_ROUNDS, LegacyTime),
+               (unsigned long long)LegacyCount,
+               BENCH_NUMBER_OF_TEXTS);
+    }
+
+    free(NarrowStorage);
+    free(WideStorage);
+    free(Texts);
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("aho-corasick tests passed\n");
+
+    return 0;
+}
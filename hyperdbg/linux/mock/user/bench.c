@@ -0,0 +1,86 @@
+/**
+ * @file bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Helpers that are shared between the benches (random numbers and time)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <time.h>
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief State of the random numbers of the main thread (the same seed in
+ * each run, so the failed cases could be repeated)
+ *
+ */
+static UINT64 g_BenchRandomState = 0x9e3779b97f4a7c15ull;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Get the next random number of a state (xorshift64)
+ * @details The threads keep their own states
+ *
+ * @param State
+ *
+ * @return UINT64
+ */
+UINT64
+BenchRandomFrom(UINT64 * State)
+{
+    *State ^= *State << 13;
+    *State ^= *State >> 7;
+    *State ^= *State << 17;
+
+    return *State;
+}
+
+/**
+ * @brief Get the next random number of the main thread
+ *
+ * @return UINT64
+ */
+UINT64
+BenchRandom(void)
+{
+    return BenchRandomFrom(&g_BenchRandomState);
+}
+
+/**
+ * @brief Get the monotonic time in seconds
+ *
+ * @return double
+ */
+double
+BenchNow(void)
+{
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+
+    return (double)Time.tv_sec + (double)Time.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Get the throughput of a measurement in MB/s
+ *
+ * @param NumberOfBytes
+ * @param Seconds
+ *
+ * @return double
+ */
+double
+BenchThroughput(UINT64 NumberOfBytes, double Seconds)
+{
+    return Seconds <= 0 ? 0 : (double)NumberOfBytes / (1024 * 1024) / Seconds;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file bench.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the helpers that are shared between the benches
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+UINT64
+BenchRandom(void);
+
+UINT64
+BenchRandomFrom(UINT64 * State);
+
+double
+BenchNow(void);
+
+double
+BenchThroughput(UINT64 NumberOfBytes, double Seconds);
+
+#endif // BENCH_H
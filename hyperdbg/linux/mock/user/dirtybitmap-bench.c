@@ -0,0 +1,603 @@
+/**
+ * @file dirtybitmap-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the dirty page bitmaps and the incremental snapshots
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_PAGES             16384 // 64 MB of guest memory
+#define BENCH_LARGE_PAGE_FIRST  8192  // the pages of [32 MB, 40 MB) are mapped by large pages
+#define BENCH_LARGE_PAGE_LAST   10240
+#define BENCH_PML_ENTRIES       512
+#define BENCH_CORES             4
+#define BENCH_EPOCHS            64
+#define BENCH_WRITES_PER_EPOCH  20000
+#define BENCH_FETCH_PAGES       4096 // pages of each fetch (like the chunks of the IOCTLs)
+#define BENCH_BUFFER_PAGES      64
+#define BENCH_TEST_OPERATIONS   200000
+#define BENCH_MARKERS           4
+#define BENCH_MARKS_PER_THREAD  2000000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The page-modification log of a simulated core
+ *
+ */
+typedef struct _BENCH_PML
+{
+    UINT64 Entries[BENCH_PML_ENTRIES];
+    UINT32 Index; // the next free entry (the log is filled from the last entry)
+
+} BENCH_PML, *PBENCH_PML;
+
+/**
+ * @brief A growing buffer that receives an incremental snapshot
+ *
+ */
+typedef struct _BENCH_DELTA
+{
+    UINT8 * Data;
+    UINT64  Size;
+    UINT64  Capacity;
+    UINT8 * Memory; // the simulated guest memory
+
+} BENCH_DELTA, *PBENCH_DELTA;
+
+/**
+ * @brief State of a thread that marks the pages
+ *
+ */
+typedef struct _BENCH_MARKER
+{
+    pthread_t Thread;
+    UINT32    Index;
+
+} BENCH_MARKER, *PBENCH_MARKER;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static PDIRTY_BITMAP   g_Bitmap;
+static BENCH_PML       g_Pml[BENCH_CORES];
+static BOOLEAN         g_EptDirty[BENCH_PAGES]; // the dirty flags of the EPT entries
+static UINT8           g_Marked[BENCH_MARKERS][BENCH_PAGES];
+static volatile UINT32 g_FinishedMarkers;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static PDIRTY_BITMAP
+BenchCreateBitmap(UINT64 NumberOfPages)
+{
+    PVOID Buffer = calloc(1, DIRTY_BITMAP_SIZE(NumberOfPages));
+
+    if (Buffer == NULL || !DirtyBitmapInitialize(Buffer, NumberOfPages))
+    {
+        free(Buffer);
+        return NULL;
+    }
+
+    return (PDIRTY_BITMAP)Buffer;
+}
+
+static BOOLEAN
+BenchIsLargePage(UINT64 Page)
+{
+    return Page >= BENCH_LARGE_PAGE_FIRST && Page < BENCH_LARGE_PAGE_LAST;
+}
+
+/**
+ * @brief Fetch (and reset) the whole bitmap in ranges, like the IOCTLs
+ *
+ */
+static UINT64
+BenchFetchAll(PDIRTY_BITMAP Bitmap, UINT64 * Bits, BOOLEAN Reset)
+{
+    UINT64 DirtyPages = 0;
+
+    for (UINT64 Page = 0; Page < Bitmap->NumberOfPages; Page += BENCH_FETCH_PAGES)
+    {
+        DirtyPages += DirtyBitmapFetch(Bitmap, Page, BENCH_FETCH_PAGES, &Bits[Page / 64], Reset);
+    }
+
+    return DirtyPages;
+}
+
+/**
+ * @brief Mark random pages (and large pages) and check the fetched bitmaps
+ * and the runs against an array of the pages
+ *
+ */
+static BOOLEAN
+BenchTestOperations(void)
+{
+    static BOOLEAN Expected[BENCH_PAGES + 100];
+    static UINT64  Bits[DIRTY_BITMAP_WORDS(BENCH_PAGES + 100)];
+    const UINT64   NumberOfPages = BENCH_PAGES + 100; // not a multiple of 64
+    PDIRTY_BITMAP  Bitmap        = BenchCreateBitmap(NumberOfPages);
+    UINT64         Dropped       = 0;
+
+    if (Bitmap == NULL)
+    {
+        printf("err, unable to create the bitmap\n");
+        return FALSE;
+    }
+
+    for (UINT32 Round = 0; Round < 100; Round++)
+    {
+        UINT64 ExpectedCount = 0;
+        UINT64 Density       = 1 + BenchRandom() % 64;
+
+        for (UINT32 i = 0; i < BENCH_TEST_OPERATIONS / 100 / Density * 8; i++)
+        {
+            UINT64  Page        = BenchRandom() % (NumberOfPages + 600);
+            BOOLEAN IsLargePage = BenchRandom() % 32 == 0;
+            UINT64  First       = IsLargePage ? Page & ~511ull : Page;
+            UINT64  Last        = IsLargePage ? First + 512 : Page + 1;
+
+            if (DirtyBitmapMarkPage(Bitmap, Page << DIRTY_BITMAP_PAGE_SHIFT | (BenchRandom() & 0xfff), IsLargePage) !=
+                (First < NumberOfPages))
+            {
+                printf("err, marking the page %llx is not expected\n", (unsigned long long)Page);
+                free(Bitmap);
+                return FALSE;
+            }
+
+            Dropped += First >= NumberOfPages;
+
+            for (UINT64 j = First; j < Last && j < NumberOfPages; j++)
+            {
+                Expected[j] = TRUE;
+            }
+        }
+
+        for (UINT64 j = 0; j < NumberOfPages; j++)
+        {
+            ExpectedCount += Expected[j];
+        }
+
+        if (Bitmap->MarkedPages != ExpectedCount || BenchFetchAll(Bitmap, Bits, TRUE) != ExpectedCount ||
+            DirtyBitmapCountPages(Bits, NumberOfPages) != ExpectedCount || Bitmap->Epoch != Round + 1)
+        {
+            printf("err, %llu pages are marked instead of %llu\n",
+                   (unsigned long long)Bitmap->MarkedPages,
+                   (unsigned long long)ExpectedCount);
+            free(Bitmap);
+            return FALSE;
+        }
+
+        //
+        // Walk the runs and check each page
+        //
+        UINT64 Next = 0;
+        UINT64 RunLength;
+
+        for (UINT64 Page = DirtyBitmapFindRun(Bits, NumberOfPages, 0, &RunLength);
+             Page < NumberOfPages;
+             Page = DirtyBitmapFindRun(Bits, NumberOfPages, Page + RunLength, &RunLength))
+        {
+            for (; Next < Page; Next++)
+            {
+                if (Expected[Next])
+                {
+                    printf("err, the dirty page %llx is not in any run\n", (unsigned long long)Next);
+                    free(Bitmap);
+                    return FALSE;
+                }
+            }
+
+            for (; Next < Page + RunLength; Next++)
+            {
+                if (!Expected[Next])
+                {
+                    printf("err, the clean page %llx is in a run\n", (unsigned long long)Next);
+                    free(Bitmap);
+                    return FALSE;
+                }
+            }
+
+            if (Next < NumberOfPages && Expected[Next])
+            {
+                printf("err, the run before the page %llx is not complete\n", (unsigned long long)Next);
+                free(Bitmap);
+                return FALSE;
+            }
+        }
+
+        for (; Next < NumberOfPages; Next++)
+        {
+            if (Expected[Next])
+            {
+                printf("err, the dirty page %llx is not in any run\n", (unsigned long long)Next);
+                free(Bitmap);
+                return FALSE;
+            }
+        }
+
+        //
+        // The bitmap is empty after the reset
+        //
+        if (BenchFetchAll(Bitmap, Bits, FALSE) != 0)
+        {
+            printf("err, the bitmap is not empty after the reset\n");
+            free(Bitmap);
+            return FALSE;
+        }
+
+        memset(Expected, 0, sizeof(Expected));
+    }
+
+    if (Bitmap->DroppedEntries != Dropped)
+    {
+        printf("err, %llu addresses are dropped instead of %llu\n",
+               (unsigned long long)Bitmap->DroppedEntries,
+               (unsigned long long)Dropped);
+        free(Bitmap);
+        return FALSE;
+    }
+
+    printf("operations: 100 rounds of marks, fetches and runs are the same as the reference\n");
+
+    free(Bitmap);
+
+    return TRUE;
+}
+
+/**
+ * @brief Flush the log of a core, like DirtyLoggingFlushPmlBuffer
+ *
+ */
+static VOID
+BenchFlushPml(PBENCH_PML Pml)
+{
+    for (UINT32 i = Pml->Index; i < BENCH_PML_ENTRIES; i++)
+    {
+        UINT64 Page = Pml->Entries[i] >> DIRTY_BITMAP_PAGE_SHIFT;
+
+        DirtyBitmapMarkPage(g_Bitmap, Pml->Entries[i], BenchIsLargePage(Page));
+
+        //
+        // Clear the dirty flag of the EPT entry (of the large page)
+        //
+        g_EptDirty[BenchIsLargePage(Page) ? Page & ~511ull : Page] = FALSE;
+    }
+
+    Pml->Index = BENCH_PML_ENTRIES;
+}
+
+/**
+ * @brief Write to a page of the guest from a core, the address is only logged
+ * if the dirty flag of its EPT entry is not set (a large page has a single flag)
+ *
+ */
+static VOID
+BenchGuestWrite(UINT8 * Memory, UINT32 Core, UINT64 Page)
+{
+    UINT64 Entry  = BenchIsLargePage(Page) ? Page & ~511ull : Page;
+    UINT64 Offset = BenchRandom() % DIRTY_BITMAP_PAGE_SIZE;
+
+    Memory[Page * DIRTY_BITMAP_PAGE_SIZE + Offset] = (UINT8)BenchRandom();
+
+    if (g_EptDirty[Entry])
+    {
+        return;
+    }
+
+    g_EptDirty[Entry] = TRUE;
+
+    //
+    // The log is full, so a vm-exit flushes it
+    //
+    if (g_Pml[Core].Index == 0)
+    {
+        BenchFlushPml(&g_Pml[Core]);
+    }
+
+    g_Pml[Core].Entries[--g_Pml[Core].Index] = Page << DIRTY_BITMAP_PAGE_SHIFT | Offset;
+}
+
+static BOOLEAN
+BenchReadPages(PVOID Context, UINT64 FirstPage, UINT32 NumberOfPages, PVOID Buffer)
+{
+    PBENCH_DELTA Delta = (PBENCH_DELTA)Context;
+
+    memcpy(Buffer, Delta->Memory + FirstPage * DIRTY_BITMAP_PAGE_SIZE, NumberOfPages * DIRTY_BITMAP_PAGE_SIZE);
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchWrite(PVOID Context, const VOID * Buffer, UINT64 Size)
+{
+    PBENCH_DELTA Delta = (PBENCH_DELTA)Context;
+
+    if (Delta->Size + Size > Delta->Capacity)
+    {
+        UINT64  Capacity = (Delta->Size + Size) * 2;
+        UINT8 * Data     = realloc(Delta->Data, Capacity);
+
+        if (Data == NULL)
+        {
+            return FALSE;
+        }
+
+        Delta->Data     = Data;
+        Delta->Capacity = Capacity;
+    }
+
+    memcpy(Delta->Data + Delta->Size, Buffer, Size);
+    Delta->Size += Size;
+
+    return TRUE;
+}
+
+/**
+ * @brief Replay the writes of the guest (a hot working set and random pages)
+ * through the simulated page-modification logs, take an incremental snapshot
+ * at the end of each epoch and apply it to the image of the previous snapshot,
+ * the image should be the same as the guest memory
+ *
+ */
+static BOOLEAN
+BenchTestReplay(void)
+{
+    static UINT64 Bits[DIRTY_BITMAP_WORDS(BENCH_PAGES)];
+    static UINT8  Buffer[BENCH_BUFFER_PAGES * DIRTY_BITMAP_PAGE_SIZE];
+    UINT8 *       Memory        = malloc(BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE);
+    UINT8 *       Image         = malloc(BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE);
+    UINT8 *       Full          = malloc(BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE);
+    BENCH_DELTA   Delta         = {0};
+    UINT64        CopiedPages   = 0;
+    double        DeltaTime     = 0;
+    double        FullTime      = 0;
+    double        Start;
+    BOOLEAN       Result        = FALSE;
+
+    g_Bitmap = BenchCreateBitmap(BENCH_PAGES);
+
+    if (Memory == NULL || Image == NULL || Full == NULL || g_Bitmap == NULL)
+    {
+        printf("err, insufficient memory\n");
+        goto Exit;
+    }
+
+    for (UINT64 i = 0; i < BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE; i++)
+    {
+        Memory[i] = (UINT8)BenchRandom();
+    }
+
+    memset(g_EptDirty, 0, sizeof(g_EptDirty));
+
+    for (UINT32 Core = 0; Core < BENCH_CORES; Core++)
+    {
+        g_Pml[Core].Index = BENCH_PML_ENTRIES;
+    }
+
+    //
+    // The base snapshot is a full copy of the memory
+    //
+    memcpy(Image, Memory, BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE);
+    Delta.Memory = Memory;
+
+    for (UINT32 Epoch = 1; Epoch <= BENCH_EPOCHS; Epoch++)
+    {
+        UINT64 HotPage = BenchRandom() % (BENCH_PAGES - 256);
+
+        for (UINT32 i = 0; i < BENCH_WRITES_PER_EPOCH; i++)
+        {
+            UINT64 Page = BenchRandom() % 8 == 0 ? BenchRandom() % BENCH_PAGES : HotPage + BenchRandom() % 256;
+
+            BenchGuestWrite(Memory, (UINT32)(BenchRandom() % BENCH_CORES), Page);
+        }
+
+        //
+        // The logs of all of the cores are flushed before the bitmap is fetched
+        //
+        for (UINT32 Core = 0; Core < BENCH_CORES; Core++)
+        {
+            BenchFlushPml(&g_Pml[Core]);
+        }
+
+        BenchFetchAll(g_Bitmap, Bits, TRUE);
+
+        Delta.Size = 0;
+        Start      = BenchNow();
+
+        if (!DirtyBitmapWriteDelta(Bits,
+                                   BENCH_PAGES,
+                                   g_Bitmap->Epoch,
+                                   Buffer,
+                                   BENCH_BUFFER_PAGES,
+                                   BenchReadPages,
+                                   BenchWrite,
+                                   &Delta) ||
+            !DirtyBitmapApplyDelta(Delta.Data, Delta.Size, Image, BENCH_PAGES))
+        {
+            printf("err, unable to write or apply the snapshot of the epoch %u\n", Epoch);
+            goto Exit;
+        }
+
+        DeltaTime += BenchNow() - Start;
+        CopiedPages += DirtyBitmapCountPages(Bits, BENCH_PAGES);
+
+        //
+        // A full snapshot (the previous way of resetting)
+        //
+        Start = BenchNow();
+        memcpy(Full, Memory, BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE);
+        FullTime += BenchNow() - Start;
+
+        if (memcmp(Image, Memory, BENCH_PAGES * DIRTY_BITMAP_PAGE_SIZE) != 0)
+        {
+            printf("err, the image is not the same as the memory after the epoch %u\n", Epoch);
+            goto Exit;
+        }
+    }
+
+    //
+    // Invalid snapshots are not applied
+    //
+    ((PDIRTY_SNAPSHOT_DELTA_HEADER)Delta.Data)->NumberOfRuns += 1;
+
+    if (DirtyBitmapApplyDelta(Delta.Data, Delta.Size, Image, BENCH_PAGES) ||
+        DirtyBitmapApplyDelta(Delta.Data, sizeof(DIRTY_SNAPSHOT_DELTA_HEADER) - 1, Image, BENCH_PAGES))
+    {
+        printf("err, an invalid snapshot is applied\n");
+        goto Exit;
+    }
+
+    printf("replay:     %u epochs of %u writes on %u cores are restored from %llu dirty pages (%.1f%% of the memory)\n",
+           BENCH_EPOCHS,
+           BENCH_WRITES_PER_EPOCH,
+           BENCH_CORES,
+           (unsigned long long)CopiedPages,
+           100.0 * CopiedPages / ((double)BENCH_PAGES * BENCH_EPOCHS));
+
+    printf("snapshot:   incremental: %8.2f ms/epoch, full copy: %8.2f ms/epoch\n",
+           DeltaTime * 1000 / BENCH_EPOCHS,
+           FullTime * 1000 / BENCH_EPOCHS);
+
+    Result = TRUE;
+
+Exit:
+    free(Memory);
+    free(Image);
+    free(Full);
+    free(Delta.Data);
+    free(g_Bitmap);
+
+    return Result;
+}
+
+/**
+ * @brief Mark random pages while the bitmap is fetched and reset
+ *
+ */
+static void *
+BenchMarker(void * Parameter)
+{
+    PBENCH_MARKER Marker = (PBENCH_MARKER)Parameter;
+    UINT64        State  = (UINT64)(uintptr_t)Parameter | 1;
+
+    for (UINT32 i = 0; i < BENCH_MARKS_PER_THREAD; i++)
+    {
+        UINT64 Page;
+
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Page = State % BENCH_PAGES;
+
+        g_Marked[Marker->Index][Page] = TRUE;
+        DirtyBitmapMarkPage(g_Bitmap, Page << DIRTY_BITMAP_PAGE_SHIFT, FALSE);
+    }
+
+    __atomic_add_fetch(&g_FinishedMarkers, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+static BOOLEAN
+BenchTestConcurrent(void)
+{
+    static UINT64 Bits[DIRTY_BITMAP_WORDS(BENCH_PAGES)];
+    static UINT64 Union[DIRTY_BITMAP_WORDS(BENCH_PAGES)];
+    BENCH_MARKER  Markers[BENCH_MARKERS] = {0};
+    UINT32        Fetches                = 0;
+    UINT32        Finished;
+
+    g_Bitmap = BenchCreateBitmap(BENCH_PAGES);
+
+    if (g_Bitmap == NULL)
+    {
+        printf("err, unable to create the bitmap\n");
+        return FALSE;
+    }
+
+    memset(Union, 0, sizeof(Union));
+    memset(g_Marked, 0, sizeof(g_Marked));
+    g_FinishedMarkers = 0;
+
+    for (UINT32 i = 0; i < BENCH_MARKERS; i++)
+    {
+        Markers[i].Index = i;
+        pthread_create(&Markers[i].Thread, NULL, BenchMarker, &Markers[i]);
+    }
+
+    //
+    // Fetch the bitmap while the pages are marked, until all of the markers finish
+    //
+    do
+    {
+        Finished = __atomic_load_n(&g_FinishedMarkers, __ATOMIC_ACQUIRE);
+
+        BenchFetchAll(g_Bitmap, Bits, TRUE);
+        Fetches++;
+
+        for (UINT32 i = 0; i < DIRTY_BITMAP_WORDS(BENCH_PAGES); i++)
+        {
+            Union[i] |= Bits[i];
+        }
+
+    } while (Finished != BENCH_MARKERS);
+
+    for (UINT32 i = 0; i < BENCH_MARKERS; i++)
+    {
+        pthread_join(Markers[i].Thread, NULL);
+    }
+
+    free(g_Bitmap);
+
+    for (UINT64 Page = 0; Page < BENCH_PAGES; Page++)
+    {
+        BOOLEAN Marked = FALSE;
+
+        for (UINT32 i = 0; i < BENCH_MARKERS; i++)
+        {
+            Marked |= g_Marked[i][Page];
+        }
+
+        if (Marked != ((Union[Page / 64] >> (Page % 64)) & 1))
+        {
+            printf("err, the page %llx is %s\n", (unsigned long long)Page, Marked ? "lost" : "marked without any write");
+            return FALSE;
+        }
+    }
+
+    printf("concurrent: %u threads marked %u pages while the bitmap is fetched %u times, none of them is lost\n",
+           BENCH_MARKERS,
+           BENCH_MARKERS * BENCH_MARKS_PER_THREAD,
+           Fetches);
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    if (!BenchTestOperations() || !BenchTestReplay() || !BenchTestConcurrent())
+    {
+        return 1;
+    }
+
+    printf("dirty bitmap tests passed\n");
+
+    return 0;
+}
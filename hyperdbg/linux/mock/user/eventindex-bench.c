@@ -0,0 +1,508 @@
+/**
+ * @file eventindex-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the index of the events (dispatching the triggered events)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_MAXIMUM_EVENTS       5000
+#define BENCH_TEST_OPERATIONS      200000
+#define BENCH_TRIGGERS             200000
+#define BENCH_KEYS_COUNT           600 // e.g., syscall numbers
+#define BENCH_ALL_CORES            0xffffffff
+#define BENCH_CORES_COUNT          8
+#define BENCH_PAUSED_READER_EVENTS 60
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A registered event (the fields that are checked on triggering)
+ *
+ */
+typedef struct _BENCH_EVENT
+{
+    struct _BENCH_EVENT * Next;     // list of all of the events of the type (newest first)
+    struct _BENCH_EVENT * Previous;
+
+    UINT64  Key;
+    BOOLEAN IsWildcard;
+    BOOLEAN Enabled;
+    BOOLEAN Registered;
+    UINT32  CoreId;
+    UINT64  Triggered;
+
+    EVENT_INDEX_ENTRY IndexEntry;
+
+} BENCH_EVENT, *PBENCH_EVENT;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static BENCH_EVENT  g_BenchEvents[BENCH_MAXIMUM_EVENTS];
+static PBENCH_EVENT g_EventsList;
+static EVENT_INDEX  g_Index;
+static UINT64       g_Order;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The checks of the event in DebuggerTriggerEvents
+ *
+ */
+static BOOLEAN
+BenchIsEventTriggered(PBENCH_EVENT Event, UINT64 Key, UINT32 CoreId)
+{
+    return Event->Enabled &&
+           (Event->CoreId == BENCH_ALL_CORES || Event->CoreId == CoreId) &&
+           (Event->IsWildcard || Event->Key == Key);
+}
+
+static void
+BenchRegisterEvent(PBENCH_EVENT Event)
+{
+    Event->Registered       = TRUE;
+    Event->Previous         = NULL;
+    Event->Next             = g_EventsList;
+    Event->IndexEntry.Order = ++g_Order;
+
+    if (g_EventsList != NULL)
+    {
+        g_EventsList->Previous = Event;
+    }
+
+    g_EventsList = Event;
+
+    EventIndexInsert(&g_Index, &Event->IndexEntry, Event->Key, Event->IsWildcard);
+}
+
+static void
+BenchRemoveEvent(PBENCH_EVENT Event)
+{
+    if (Event->Previous != NULL)
+    {
+        Event->Previous->Next = Event->Next;
+    }
+    else
+    {
+        g_EventsList = Event->Next;
+    }
+
+    if (Event->Next != NULL)
+    {
+        Event->Next->Previous = Event->Previous;
+    }
+
+    EventIndexRemove(&g_Index, &Event->IndexEntry);
+
+    Event->Registered = FALSE;
+}
+
+/**
+ * @brief Enable or disable an event (the event stays in the index)
+ *
+ */
+static void
+BenchSetEventState(PBENCH_EVENT Event, BOOLEAN Enabled)
+{
+    Event->Enabled = Enabled;
+}
+
+/**
+ * @brief Create an event in the memory of a removed event (the same as
+ * freeing it after the cores are synchronized and allocating a new event)
+ *
+ */
+static void
+BenchCreateEvent(PBENCH_EVENT Event, BOOLEAN Enabled)
+{
+    memset(Event, 0, sizeof(BENCH_EVENT));
+
+    Event->IsWildcard = BenchRandom() % 20 == 0;
+    Event->Key        = BenchRandom() % BENCH_KEYS_COUNT;
+    Event->CoreId     = BenchRandom() % 4 == 0 ? (UINT32)(BenchRandom() % BENCH_CORES_COUNT) : BENCH_ALL_CORES;
+    Event->Enabled    = Enabled;
+
+    //
+    // Some of the keys are far from each other (e.g., addresses or hooking tags)
+    //
+    if (BenchRandom() % 4 == 0)
+    {
+        Event->Key = 0xfffff80000000000ull + (BenchRandom() % BENCH_KEYS_COUNT) * 0x1000;
+    }
+}
+
+static UINT64
+BenchRandomKey(void)
+{
+    UINT64 Key = BenchRandom() % BENCH_KEYS_COUNT;
+
+    return BenchRandom() % 4 == 0 ? 0xfffff80000000000ull + Key * 0x1000 : Key;
+}
+
+/**
+ * @brief Trigger the events by walking the list of all of the events (previous dispatching)
+ *
+ */
+static UINT32
+BenchTriggerLinear(UINT64 Key, UINT32 CoreId, PBENCH_EVENT * Triggered)
+{
+    UINT32 Count = 0;
+
+    for (PBENCH_EVENT Event = g_EventsList; Event != NULL; Event = Event->Next)
+    {
+        if (BenchIsEventTriggered(Event, Key, CoreId))
+        {
+            if (Triggered != NULL)
+            {
+                Triggered[Count] = Event;
+            }
+
+            Event->Triggered++;
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+/**
+ * @brief Trigger the events by walking the candidates of the index
+ *
+ */
+static UINT32
+BenchTriggerIndexed(UINT64 Key, UINT32 CoreId, PBENCH_EVENT * Triggered)
+{
+    EVENT_INDEX_ITERATOR Iterator;
+    UINT32               Count = 0;
+
+    for (PEVENT_INDEX_ENTRY Entry = EventIndexFirst(&g_Index, Key, &Iterator);
+         Entry != NULL;
+         Entry = EventIndexNext(&Iterator))
+    {
+        PBENCH_EVENT Event = (PBENCH_EVENT)((UINT8 *)Entry - offsetof(BENCH_EVENT, IndexEntry));
+
+        if (BenchIsEventTriggered(Event, Key, CoreId))
+        {
+            if (Triggered != NULL)
+            {
+                Triggered[Count] = Event;
+            }
+
+            Event->Triggered++;
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+static void
+BenchReset(void)
+{
+    memset(&g_Index, 0, sizeof(g_Index));
+    g_EventsList = NULL;
+    g_Order      = 0;
+}
+
+/**
+ * @brief Register, enable, disable and remove random events, and check that
+ * triggering the index runs the same events in the same order as walking the
+ * list of all of the events
+ *
+ */
+static BOOLEAN
+BenchTestDispatch(void)
+{
+    static PBENCH_EVENT Expected[BENCH_MAXIMUM_EVENTS];
+    static PBENCH_EVENT Result[BENCH_MAXIMUM_EVENTS];
+    UINT64              Triggers = 0;
+    UINT64              Matches  = 0;
+
+    BenchReset();
+
+    for (UINT32 i = 0; i < BENCH_TEST_OPERATIONS; i++)
+    {
+        PBENCH_EVENT Event = &g_BenchEvents[BenchRandom() % 1000];
+
+        switch (BenchRandom() % 4)
+        {
+        case 0:
+
+            if (!Event->Registered)
+            {
+                BenchCreateEvent(Event, BenchRandom() % 2);
+                BenchRegisterEvent(Event);
+            }
+
+            break;
+
+        case 1:
+
+            if (Event->Registered)
+            {
+                BenchSetEventState(Event, !Event->Enabled);
+            }
+
+            break;
+
+        case 2:
+
+            if (Event->Registered && BenchRandom() % 4 == 0)
+            {
+                BenchRemoveEvent(Event);
+            }
+
+            break;
+
+        default:
+        {
+            UINT64 Key          = BenchRandomKey();
+            UINT32 CoreId       = (UINT32)(BenchRandom() % BENCH_CORES_COUNT);
+            UINT32 ExpectedSize = BenchTriggerLinear(Key, CoreId, Expected);
+            UINT32 ResultSize   = BenchTriggerIndexed(Key, CoreId, Result);
+
+            if (ExpectedSize != ResultSize || memcmp(Expected, Result, ExpectedSize * sizeof(PBENCH_EVENT)) != 0)
+            {
+                printf("err, trigger %llu (key: %llx) runs %u events instead of %u\n",
+                       (unsigned long long)Triggers,
+                       (unsigned long long)Key,
+                       ResultSize,
+                       ExpectedSize);
+                return FALSE;
+            }
+
+            Triggers++;
+            Matches += ExpectedSize;
+
+            break;
+        }
+        }
+    }
+
+    printf("dispatch:   %llu triggers (%llu triggered events) are the same as the list of all events\n",
+           (unsigned long long)Triggers,
+           (unsigned long long)Matches);
+
+    return TRUE;
+}
+
+/**
+ * @brief Create an event of a key (or a wildcard event) for the paused reader
+ *
+ */
+static void
+BenchCreateKeyedEvent(PBENCH_EVENT Event, UINT64 Key, BOOLEAN IsWildcard)
+{
+    memset(Event, 0, sizeof(BENCH_EVENT));
+
+    Event->Key        = Key;
+    Event->IsWildcard = IsWildcard;
+    Event->CoreId     = BENCH_ALL_CORES;
+    Event->Enabled    = TRUE;
+
+    BenchRegisterEvent(Event);
+}
+
+/**
+ * @brief Stop a reader on the first entry of a key, change the index under
+ * it, and check that the reader continues through the entries of its key
+ * (or the wildcard entries) in their order, once each
+ *
+ */
+static BOOLEAN
+BenchTestPausedReader(void)
+{
+    EVENT_INDEX_ITERATOR Iterator;
+    PEVENT_INDEX_ENTRY   Entry;
+    PBENCH_EVENT         Event;
+    UINT64               LastOrder = (UINT64)-1;
+    UINT32               Visited   = 0;
+    UINT32               Kept      = 0;
+
+    BenchReset();
+
+    //
+    // Events of keys 1 and 2, and wildcard events
+    //
+    for (UINT32 i = 0; i < BENCH_PAUSED_READER_EVENTS; i++)
+    {
+        BenchCreateKeyedEvent(&g_BenchEvents[i], 1 + (i % 3), i % 3 == 2);
+    }
+
+    Entry = EventIndexFirst(&g_Index, 1, &Iterator);
+
+    //
+    // Inserting an indexed entry by its key keeps it where it is, and
+    // inserting it by another key is refused
+    //
+    Event = &g_BenchEvents[0];
+
+    if (!EventIndexInsert(&g_Index, &Event->IndexEntry, Event->Key, Event->IsWildcard) ||
+        EventIndexInsert(&g_Index, &Event->IndexEntry, 2, FALSE) ||
+        EventIndexInsert(&g_Index, &Event->IndexEntry, 0, TRUE))
+    {
+        printf("err, an indexed entry is linked again\n");
+        return FALSE;
+    }
+
+    //
+    // Disable and enable all of the events, remove half of them, and register
+    // new events of the same keys
+    //
+    for (UINT32 i = 0; i < BENCH_PAUSED_READER_EVENTS; i++)
+    {
+        Event = &g_BenchEvents[i];
+
+        BenchSetEventState(Event, FALSE);
+        BenchSetEventState(Event, TRUE);
+
+        if (i % 2 == 0)
+        {
+            BenchRemoveEvent(Event);
+
+            if (EventIndexInsert(&g_Index, &Event->IndexEntry, Event->Key, Event->IsWildcard))
+            {
+                printf("err, a removed entry is linked again\n");
+                return FALSE;
+            }
+
+            BenchCreateKeyedEvent(&g_BenchEvents[BENCH_PAUSED_READER_EVENTS + i], 1 + (i % 3), i % 3 == 2);
+        }
+        else if (Event->IsWildcard || Event->Key == 1)
+        {
+            Kept++;
+        }
+    }
+
+    //
+    // Continue the reader, it visits all of the kept entries after the first
+    // entry, and might visit the removed entries that it already holds, but
+    // not the new entries (they're newer than the first entry)
+    //
+    for (Entry = EventIndexNext(&Iterator); Entry != NULL; Entry = EventIndexNext(&Iterator))
+    {
+        Event = (PBENCH_EVENT)((UINT8 *)Entry - offsetof(BENCH_EVENT, IndexEntry));
+
+        if (Entry->Order >= LastOrder || Entry->Order > BENCH_PAUSED_READER_EVENTS || (!Event->IsWildcard && Event->Key != 1))
+        {
+            printf("err, the paused reader visits the event of the order %llu\n",
+                   (unsigned long long)Entry->Order);
+            return FALSE;
+        }
+
+        LastOrder = Entry->Order;
+        Visited++;
+    }
+
+    if (Visited < Kept - 1 || Visited > Kept + 1)
+    {
+        printf("err, the paused reader visits %u events instead of %u\n", Visited, Kept);
+        return FALSE;
+    }
+
+    printf("paused reader: %u events are visited once each while the index is changed\n", Visited);
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure the triggers for a number of registered events
+ *
+ */
+static BOOLEAN
+BenchMeasure(UINT32 NumberOfEvents)
+{
+    static UINT64 Keys[BENCH_TRIGGERS];
+    UINT64        LinearMatches  = 0;
+    UINT64        IndexedMatches = 0;
+    double        Start;
+    double        LinearTime;
+    double        IndexedTime;
+
+    BenchReset();
+
+    for (UINT32 i = 0; i < NumberOfEvents; i++)
+    {
+        BenchCreateEvent(&g_BenchEvents[i], TRUE);
+
+        //
+        // Only a few events are triggered for all of the keys
+        //
+        g_BenchEvents[i].IsWildcard = BenchRandom() % 200 == 0;
+
+        BenchRegisterEvent(&g_BenchEvents[i]);
+    }
+
+    for (UINT32 i = 0; i < BENCH_TRIGGERS; i++)
+    {
+        Keys[i] = BenchRandomKey();
+    }
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_TRIGGERS; i++)
+    {
+        LinearMatches += BenchTriggerLinear(Keys[i], i % BENCH_CORES_COUNT, NULL);
+    }
+
+    LinearTime = BenchNow() - Start;
+    Start      = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_TRIGGERS; i++)
+    {
+        IndexedMatches += BenchTriggerIndexed(Keys[i], i % BENCH_CORES_COUNT, NULL);
+    }
+
+    IndexedTime = BenchNow() - Start;
+
+    if (LinearMatches != IndexedMatches)
+    {
+        printf("err, %llu events are triggered instead of %llu\n",
+               (unsigned long long)IndexedMatches,
+               (unsigned long long)LinearMatches);
+        return FALSE;
+    }
+
+    printf("%5u events: index: %8.2f M triggers/s, list of all events: %8.2f M triggers/s\n",
+           NumberOfEvents,
+           BENCH_TRIGGERS / IndexedTime / 1e6,
+           BENCH_TRIGGERS / LinearTime / 1e6);
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    static const UINT32 Counts[] = {10, 100, 500, 1000, 5000};
+    BOOLEAN             Passed   = BenchTestDispatch() && BenchTestPausedReader();
+
+    for (UINT32 i = 0; i < sizeof(Counts) / sizeof(Counts[0]) && Passed; i++)
+    {
+        Passed = BenchMeasure(Counts[i]);
+    }
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("event index tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,793 @@
+/**
+ * @file exitprofiler-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the vm-exit profiler (and viewer of its dumps)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_CORES          4
+#define BENCH_EXITS_PER_CORE 200000
+#define BENCH_SAMPLES        100000
+#define BENCH_MEASURE_EXITS  20000000
+#define BENCH_DUMP_PATH      "exitprofiler-bench.bin"
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A simulated core that records its own exits
+ *
+ */
+typedef struct _BENCH_CORE
+{
+    pthread_t                Thread;
+    UINT64                   RandomState;
+    EXIT_PROFILER_STATISTICS Reference;
+
+} BENCH_CORE, *PBENCH_CORE;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static EXIT_PROFILER_CORE g_Profilers[BENCH_CORES];
+static BENCH_CORE         g_Cores[BENCH_CORES];
+static volatile UINT64    g_Generation;
+static volatile LONG      g_RunningCores;
+
+/**
+ * @brief The common exit reasons and their weights and base latencies
+ *
+ */
+static const UINT32 g_ExitReasons[][3] = {
+    {10, 30, 1200},  // cpuid
+    {48, 20, 4000},  // ept violation
+    {18, 10, 2500},  // vmcall
+    {31, 8, 900},    // rdmsr
+    {32, 8, 1100},   // wrmsr
+    {0, 6, 3000},    // exception or nmi
+    {1, 6, 700},     // external interrupt
+    {28, 5, 1500},   // mov cr
+    {30, 4, 6000},   // i/o instruction
+    {37, 2, 2000},   // monitor trap flag
+    {0x80, 1, 500},  // beyond the profiled reasons
+};
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The bucket of a latency (without bit scanning)
+ *
+ */
+static UINT32
+BenchBucket(UINT64 Cycles)
+{
+    UINT32 Bucket = 0;
+
+    while (Cycles > 1 && Bucket < EXIT_PROFILER_HISTOGRAM_BUCKETS - 1)
+    {
+        Cycles >>= 1;
+        Bucket++;
+    }
+
+    return Bucket;
+}
+
+/**
+ * @brief Record an exit into the reference statistics
+ *
+ */
+static void
+BenchReferenceRecord(PEXIT_PROFILER_STATISTICS Reference,
+                     UINT32                    ExitReason,
+                     UINT64                    HandlerCycles,
+                     UINT64                    EventCount,
+                     UINT64                    EventCycles)
+{
+    PEXIT_PROFILER_REASON_STATISTICS Reason;
+
+    if (ExitReason >= EXIT_PROFILER_MAXIMUM_EXIT_REASONS)
+    {
+        Reference->UnknownExits++;
+        return;
+    }
+
+    Reason = &Reference->Reasons[ExitReason];
+
+    Reason->Count++;
+    Reason->HandlerCycles += HandlerCycles;
+    Reason->HandlerHistogram[BenchBucket(HandlerCycles)]++;
+
+    if (EventCount != 0)
+    {
+        Reason->EventCount += EventCount;
+        Reason->EventCycles += EventCycles;
+        Reason->EventHistogram[BenchBucket(EventCycles)]++;
+    }
+}
+
+/**
+ * @brief Simulate a random exit (like VmxVmexitHandler and VmmCallbackTriggerEvents)
+ *
+ */
+static void
+BenchExit(PEXIT_PROFILER_CORE Core, UINT64 * RandomState, PEXIT_PROFILER_STATISTICS Reference, UINT64 Generation)
+{
+    UINT32 Total       = 0;
+    UINT32 Weight;
+    UINT32 Index       = 0;
+    UINT64 Events      = 0;
+    UINT64 EventCycles = 0;
+    UINT64 HandlerCycles;
+
+    for (UINT32 i = 0; i < sizeof(g_ExitReasons) / sizeof(g_ExitReasons[0]); i++)
+    {
+        Total += g_ExitReasons[i][1];
+    }
+
+    Weight = (UINT32)(BenchRandomFrom(RandomState) % Total);
+
+    while (Weight >= g_ExitReasons[Index][1])
+    {
+        Weight -= g_ExitReasons[Index][1];
+        Index++;
+    }
+
+    //
+    // Some of the exits trigger events (and scripts)
+    //
+    if (BenchRandomFrom(RandomState) % 4 == 0)
+    {
+        Events = 1 + BenchRandomFrom(RandomState) % 3;
+
+        for (UINT64 i = 0; i < Events; i++)
+        {
+            UINT64 Cycles = 200 + BenchRandomFrom(RandomState) % 50000;
+
+            ExitProfilerAddEventCycles(Core, Cycles);
+            EventCycles += Cycles;
+        }
+    }
+
+    HandlerCycles = g_ExitReasons[Index][2] / 2 + BenchRandomFrom(RandomState) % g_ExitReasons[Index][2] + EventCycles;
+
+    //
+    // A few of the exits are very slow
+    //
+    if (BenchRandomFrom(RandomState) % 1000 == 0)
+    {
+        HandlerCycles <<= 12;
+    }
+
+    ExitProfilerRecordExit(Core, g_ExitReasons[Index][0], HandlerCycles, Generation);
+
+    if (Reference != NULL)
+    {
+        BenchReferenceRecord(Reference, g_ExitReasons[Index][0], HandlerCycles, Events, EventCycles);
+    }
+}
+
+static void *
+BenchCoreRoutine(void * Parameter)
+{
+    PBENCH_CORE Core  = (PBENCH_CORE)Parameter;
+    UINT32      Index = (UINT32)(Core - g_Cores);
+
+    for (UINT32 i = 0; i < BENCH_EXITS_PER_CORE; i++)
+    {
+        BenchExit(&g_Profilers[Index], &Core->RandomState, &Core->Reference, g_Generation);
+    }
+
+    __atomic_sub_fetch(&g_RunningCores, 1, __ATOMIC_ACQ_REL);
+
+    return NULL;
+}
+
+/**
+ * @brief Show the statistics (like the !exitprof command)
+ *
+ */
+static void
+BenchShowStatistics(const EXIT_PROFILER_STATISTICS * Statistics)
+{
+    EXIT_PROFILER_ROW Rows[EXIT_PROFILER_MAXIMUM_EXIT_REASONS];
+    UINT32            NumberOfRows;
+
+    NumberOfRows = ExitProfilerBuildRows(Statistics, Rows, EXIT_PROFILER_MAXIMUM_EXIT_REASONS);
+
+    printf("%-34s %12s %7s %7s %10s %10s %10s %10s %12s %10s\n",
+           "exit reason",
+           "count",
+           "exits%",
+           "cycles%",
+           "average",
+           "median",
+           "p99",
+           "events",
+           "event cycles",
+           "event p99");
+
+    for (UINT32 i = 0; i < NumberOfRows; i++)
+    {
+        printf("%-34s %12llu %5u.%u %5u.%u %10llu %10llu %10llu %10llu %12llu %10llu\n",
+               ExitProfilerGetReasonName(Rows[i].ExitReason),
+               (unsigned long long)Rows[i].Count,
+               Rows[i].CountPermille / 10,
+               Rows[i].CountPermille % 10,
+               Rows[i].CyclesPermille / 10,
+               Rows[i].CyclesPermille % 10,
+               (unsigned long long)Rows[i].AverageCycles,
+               (unsigned long long)Rows[i].MedianCycles,
+               (unsigned long long)Rows[i].P99Cycles,
+               (unsigned long long)Rows[i].EventCount,
+               (unsigned long long)Rows[i].EventCycles,
+               (unsigned long long)Rows[i].EventP99Cycles);
+    }
+
+    printf("unknown exits: %llu\n", (unsigned long long)Statistics->UnknownExits);
+}
+
+static BOOLEAN
+BenchWriteFile(PVOID Context, const VOID * Buffer, UINT64 Size)
+{
+    return fwrite(Buffer, 1, Size, (FILE *)Context) == Size;
+}
+
+/**
+ * @brief Read a whole file
+ *
+ */
+static UINT8 *
+BenchReadFile(const char * Path, UINT64 * Size)
+{
+    FILE *  File = fopen(Path, "rb");
+    UINT8 * Buffer;
+    long    Length;
+
+    if (File == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(File, 0, SEEK_END);
+    Length = ftell(File);
+    fseek(File, 0, SEEK_SET);
+
+    Buffer = (UINT8 *)malloc(Length > 0 ? (size_t)Length : 1);
+
+    if (Buffer == NULL || fread(Buffer, 1, (size_t)Length, File) != (size_t)Length)
+    {
+        free(Buffer);
+        fclose(File);
+        return NULL;
+    }
+
+    fclose(File);
+    *Size = (UINT64)Length;
+
+    return Buffer;
+}
+
+/**
+ * @brief Show a captured dump (e.g., saved by '!exitprof dump')
+ *
+ */
+static int
+BenchShowDump(const char * Path)
+{
+    EXIT_PROFILER_STATISTICS * Cores;
+    EXIT_PROFILER_STATISTICS   Total;
+    UINT64                     Size;
+    UINT32                     NumberOfCores;
+    UINT8 *                    Dump = BenchReadFile(Path, &Size);
+
+    if (Dump == NULL || !ExitProfilerReadDump(Dump, Size, &NumberOfCores, NULL))
+    {
+        printf("err, '%s' is not a valid dump of the vm-exit profiler\n", Path);
+        free(Dump);
+        return 1;
+    }
+
+    Cores = (EXIT_PROFILER_STATISTICS *)malloc(NumberOfCores * sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Cores == NULL)
+    {
+        free(Dump);
+        return 1;
+    }
+
+    ExitProfilerReadDump(Dump, Size, &NumberOfCores, Cores);
+    memset(&Total, 0, sizeof(Total));
+
+    for (UINT32 i = 0; i < NumberOfCores; i++)
+    {
+        ExitProfilerMerge(&Total, &Cores[i]);
+    }
+
+    printf("vm-exit statistics of %u cores:\n", NumberOfCores);
+    BenchShowStatistics(&Total);
+
+    free(Cores);
+    free(Dump);
+
+    return 0;
+}
+
+/**
+ * @brief Record the exits of all of the cores at the same time (while they
+ * are queried) and compare each core and the merged statistics
+ *
+ */
+static BOOLEAN
+BenchTestCores(PEXIT_PROFILER_STATISTICS Snapshots)
+{
+    EXIT_PROFILER_STATISTICS Total;
+    EXIT_PROFILER_STATISTICS Reference;
+    UINT64                   Queries = 0;
+
+    memset(&Reference, 0, sizeof(Reference));
+
+    g_RunningCores = BENCH_CORES;
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        ExitProfilerResetCore(&g_Profilers[i], g_Generation);
+        memset(&g_Cores[i].Reference, 0, sizeof(EXIT_PROFILER_STATISTICS));
+        g_Cores[i].RandomState = BenchRandom();
+
+        pthread_create(&g_Cores[i].Thread, NULL, BenchCoreRoutine, &g_Cores[i]);
+    }
+
+    //
+    // The snapshots are taken while the cores record (without any lock)
+    //
+    while (__atomic_load_n(&g_RunningCores, __ATOMIC_ACQUIRE) != 0)
+    {
+        ExitProfilerSnapshot(&g_Profilers[Queries % BENCH_CORES], g_Generation, &Snapshots[0]);
+        Queries++;
+    }
+
+    memset(&Total, 0, sizeof(Total));
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        pthread_join(g_Cores[i].Thread, NULL);
+
+        ExitProfilerSnapshot(&g_Profilers[i], g_Generation, &Snapshots[i]);
+
+        if (memcmp(&Snapshots[i], &g_Cores[i].Reference, sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+        {
+            printf("err, the statistics of core %u are not the same as the reference\n", i);
+            return FALSE;
+        }
+
+        ExitProfilerMerge(&Total, &Snapshots[i]);
+
+        for (UINT32 j = 0; j < EXIT_PROFILER_MAXIMUM_EXIT_REASONS; j++)
+        {
+            EXIT_PROFILER_REASON_STATISTICS * Reason = &g_Cores[i].Reference.Reasons[j];
+
+            Reference.Reasons[j].Count += Reason->Count;
+            Reference.Reasons[j].HandlerCycles += Reason->HandlerCycles;
+            Reference.Reasons[j].EventCount += Reason->EventCount;
+            Reference.Reasons[j].EventCycles += Reason->EventCycles;
+
+            for (UINT32 k = 0; k < EXIT_PROFILER_HISTOGRAM_BUCKETS; k++)
+            {
+                Reference.Reasons[j].HandlerHistogram[k] += Reason->HandlerHistogram[k];
+                Reference.Reasons[j].EventHistogram[k] += Reason->EventHistogram[k];
+            }
+        }
+
+        Reference.UnknownExits += g_Cores[i].Reference.UnknownExits;
+    }
+
+    if (memcmp(&Total, &Reference, sizeof(Total)) != 0)
+    {
+        printf("err, the merged statistics are not the same as the reference\n");
+        return FALSE;
+    }
+
+    printf("%u exits of %u cores match (%llu snapshots during the exits)\n",
+           BENCH_CORES * BENCH_EXITS_PER_CORE,
+           BENCH_CORES,
+           (unsigned long long)Queries);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the lazy reset of the cores and the statistics of intervals
+ *
+ */
+static BOOLEAN
+BenchTestResetAndDelta(void)
+{
+    EXIT_PROFILER_STATISTICS * Statistics;
+    EXIT_PROFILER_CORE *       Core        = &g_Profilers[0];
+    UINT64                     RandomState = 0x1234567ull;
+
+    //
+    // The previous, the current, the delta and the reference statistics
+    //
+    Statistics = (EXIT_PROFILER_STATISTICS *)calloc(4, sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Statistics == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // After a reset, the cores are empty until their next exit
+    //
+    g_Generation++;
+
+    ExitProfilerSnapshot(Core, g_Generation, &Statistics[0]);
+
+    if (memcmp(&Statistics[0], &Statistics[3], sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+    {
+        printf("err, a core is not empty after the reset\n");
+        free(Statistics);
+        return FALSE;
+    }
+
+    //
+    // The events of the exit that resets the core are kept
+    //
+    ExitProfilerAddEventCycles(Core, 300);
+    ExitProfilerRecordExit(Core, 10, 1000, g_Generation);
+    BenchReferenceRecord(&Statistics[3], 10, 1000, 1, 300);
+
+    ExitProfilerSnapshot(Core, g_Generation, &Statistics[0]);
+
+    if (memcmp(&Statistics[0], &Statistics[3], sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+    {
+        printf("err, the first exit after the reset is not recorded\n");
+        free(Statistics);
+        return FALSE;
+    }
+
+    //
+    // The delta of an interval only has the exits of the interval
+    //
+    memset(&Statistics[3], 0, sizeof(EXIT_PROFILER_STATISTICS));
+
+    for (UINT32 i = 0; i < 50000; i++)
+    {
+        BenchExit(Core, &RandomState, &Statistics[3], g_Generation);
+    }
+
+    ExitProfilerSnapshot(Core, g_Generation, &Statistics[1]);
+    ExitProfilerDelta(&Statistics[2], &Statistics[1], &Statistics[0]);
+
+    if (memcmp(&Statistics[2], &Statistics[3], sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+    {
+        printf("err, the statistics of the interval are not the same as the reference\n");
+        free(Statistics);
+        return FALSE;
+    }
+
+    //
+    // A reset in the middle of an interval keeps the exits after the reset
+    //
+    memcpy(&Statistics[0], &Statistics[1], sizeof(EXIT_PROFILER_STATISTICS));
+    memset(&Statistics[3], 0, sizeof(EXIT_PROFILER_STATISTICS));
+
+    g_Generation++;
+
+    for (UINT32 i = 0; i < 1000; i++)
+    {
+        BenchExit(Core, &RandomState, &Statistics[3], g_Generation);
+    }
+
+    ExitProfilerSnapshot(Core, g_Generation, &Statistics[1]);
+    ExitProfilerDelta(&Statistics[2], &Statistics[1], &Statistics[0]);
+
+    if (memcmp(&Statistics[2], &Statistics[3], sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+    {
+        printf("err, the statistics of an interval with a reset are not the same as the reference\n");
+        free(Statistics);
+        return FALSE;
+    }
+
+    free(Statistics);
+
+    printf("reset and interval statistics match\n");
+
+    return TRUE;
+}
+
+static int
+BenchCompare(const void * First, const void * Second)
+{
+    UINT64 A = *(const UINT64 *)First;
+    UINT64 B = *(const UINT64 *)Second;
+
+    return A < B ? -1 : A > B;
+}
+
+/**
+ * @brief Check the percentiles and the rows
+ *
+ */
+static BOOLEAN
+BenchTestPercentilesAndRows(PEXIT_PROFILER_STATISTICS Snapshots)
+{
+    static const UINT32      Percents[] = {0, 1, 50, 90, 99, 100};
+    UINT32                   Histogram[EXIT_PROFILER_HISTOGRAM_BUCKETS] = {0};
+    UINT64 *                 Samples;
+    UINT64                   RandomState = 0xfeedull;
+    EXIT_PROFILER_STATISTICS Total;
+    EXIT_PROFILER_ROW        Rows[EXIT_PROFILER_MAXIMUM_EXIT_REASONS];
+    UINT32                   NumberOfRows;
+    UINT64                   Count = 0;
+
+    Samples = (UINT64 *)malloc(BENCH_SAMPLES * sizeof(UINT64));
+
+    if (Samples == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_SAMPLES; i++)
+    {
+        //
+        // Latencies of all of the magnitudes
+        //
+        Samples[i] = BenchRandomFrom(&RandomState) >> (BenchRandomFrom(&RandomState) % 64);
+        Histogram[ExitProfilerGetBucket(Samples[i])]++;
+
+        if (ExitProfilerGetBucket(Samples[i]) != BenchBucket(Samples[i]))
+        {
+            printf("err, the bucket of %llx is not correct\n", (unsigned long long)Samples[i]);
+            free(Samples);
+            return FALSE;
+        }
+    }
+
+    qsort(Samples, BENCH_SAMPLES, sizeof(UINT64), BenchCompare);
+
+    for (UINT32 i = 0; i < sizeof(Percents) / sizeof(Percents[0]); i++)
+    {
+        UINT64 Rank     = ((UINT64)BENCH_SAMPLES * Percents[i] + 99) / 100;
+        UINT64 Expected = (((UINT64)1 << (BenchBucket(Samples[Rank == 0 ? 0 : Rank - 1]) + 1)) - 1);
+
+        if (ExitProfilerPercentile(Histogram, Percents[i]) != Expected)
+        {
+            printf("err, the percentile %u is not correct\n", Percents[i]);
+            free(Samples);
+            return FALSE;
+        }
+    }
+
+    free(Samples);
+
+    //
+    // The rows of the merged statistics of the cores
+    //
+    memset(&Total, 0, sizeof(Total));
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        ExitProfilerMerge(&Total, &Snapshots[i]);
+    }
+
+    NumberOfRows = ExitProfilerBuildRows(&Total, Rows, EXIT_PROFILER_MAXIMUM_EXIT_REASONS);
+
+    for (UINT32 i = 0; i < NumberOfRows; i++)
+    {
+        EXIT_PROFILER_REASON_STATISTICS * Reason = &Total.Reasons[Rows[i].ExitReason];
+
+        if ((i != 0 && Rows[i - 1].HandlerCycles < Rows[i].HandlerCycles) || Rows[i].Count != Reason->Count ||
+            Rows[i].AverageCycles != Reason->HandlerCycles / Reason->Count ||
+            Rows[i].P99Cycles != ExitProfilerPercentile(Reason->HandlerHistogram, 99) ||
+            Rows[i].MedianCycles > Rows[i].P99Cycles)
+        {
+            printf("err, the row of %s is not correct\n", ExitProfilerGetReasonName(Rows[i].ExitReason));
+            return FALSE;
+        }
+
+        Count += Rows[i].Count;
+    }
+
+    if (NumberOfRows != sizeof(g_ExitReasons) / sizeof(g_ExitReasons[0]) - 1 ||
+        Count + Total.UnknownExits != BENCH_CORES * BENCH_EXITS_PER_CORE)
+    {
+        printf("err, the rows don't have all of the exits\n");
+        return FALSE;
+    }
+
+    BenchShowStatistics(&Total);
+
+    return TRUE;
+}
+
+/**
+ * @brief Write the statistics of the cores as a dump and read it again
+ *
+ */
+static BOOLEAN
+BenchTestDump(PEXIT_PROFILER_STATISTICS Snapshots)
+{
+    EXIT_PROFILER_STATISTICS * Cores;
+    EXIT_PROFILER_DUMP_HEADER  Header;
+    FILE *                     File;
+    UINT8 *                    Dump;
+    UINT64                     Size;
+    UINT32                     NumberOfCores = 0;
+    BOOLEAN                    Result;
+
+    File = fopen(BENCH_DUMP_PATH, "wb");
+
+    if (File == NULL)
+    {
+        printf("err, unable to create the dump\n");
+        return FALSE;
+    }
+
+    Result = ExitProfilerWriteDump(Snapshots, BENCH_CORES, BenchWriteFile, File);
+    fclose(File);
+
+    Dump = BenchReadFile(BENCH_DUMP_PATH, &Size);
+    remove(BENCH_DUMP_PATH);
+
+    if (!Result || Dump == NULL || Size != sizeof(Header) + BENCH_CORES * sizeof(EXIT_PROFILER_STATISTICS))
+    {
+        printf("err, unable to write the dump\n");
+        free(Dump);
+        return FALSE;
+    }
+
+    Cores = (EXIT_PROFILER_STATISTICS *)malloc(BENCH_CORES * sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Cores == NULL || !ExitProfilerReadDump(Dump, Size, &NumberOfCores, Cores) || NumberOfCores != BENCH_CORES ||
+        memcmp(Cores, Snapshots, BENCH_CORES * sizeof(EXIT_PROFILER_STATISTICS)) != 0)
+    {
+        printf("err, the statistics of the dump are not the same\n");
+        free(Cores);
+        free(Dump);
+        return FALSE;
+    }
+
+    //
+    // Truncated and corrupted dumps are rejected
+    //
+    memcpy(&Header, Dump, sizeof(Header));
+
+    Result = !ExitProfilerReadDump(Dump, Size - 1, &NumberOfCores, NULL) &&
+             !ExitProfilerReadDump(Dump, sizeof(Header) - 1, &NumberOfCores, NULL);
+
+    Header.Magic ^= 1;
+    memcpy(Dump, &Header, sizeof(Header));
+    Result = Result && !ExitProfilerReadDump(Dump, Size, &NumberOfCores, NULL);
+
+    Header.Magic ^= 1;
+    Header.NumberOfCores = 0x10000;
+    memcpy(Dump, &Header, sizeof(Header));
+    Result = Result && !ExitProfilerReadDump(Dump, Size, &NumberOfCores, NULL);
+
+    free(Cores);
+    free(Dump);
+
+    if (!Result)
+    {
+        printf("err, an invalid dump is not rejected\n");
+        return FALSE;
+    }
+
+    printf("the dump of %u cores is read again\n", BENCH_CORES);
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure the cost of recording the exits
+ *
+ */
+static void
+BenchMeasure(PEXIT_PROFILER_STATISTICS Snapshots)
+{
+    EXIT_PROFILER_CORE * Core        = &g_Profilers[0];
+    UINT64               RandomState = 0xabcdefull;
+    UINT32 *             Reasons;
+    UINT64 *             Cycles;
+    double               Start;
+    double               Recording;
+    double               Snapshot;
+
+    Reasons = (UINT32 *)malloc(0x10000 * sizeof(UINT32));
+    Cycles  = (UINT64 *)malloc(0x10000 * sizeof(UINT64));
+
+    if (Reasons == NULL || Cycles == NULL)
+    {
+        free(Reasons);
+        free(Cycles);
+        return;
+    }
+
+    for (UINT32 i = 0; i < 0x10000; i++)
+    {
+        Reasons[i] = g_ExitReasons[BenchRandomFrom(&RandomState) % 10][0];
+        Cycles[i]  = 500 + BenchRandomFrom(&RandomState) % 20000;
+    }
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_MEASURE_EXITS; i++)
+    {
+        ExitProfilerRecordExit(Core, Reasons[i & 0xffff], Cycles[i & 0xffff], g_Generation);
+        __asm__ __volatile__("" ::: "memory");
+    }
+
+    Recording = BenchNow() - Start;
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < 10000; i++)
+    {
+        ExitProfilerSnapshot(&g_Profilers[i % BENCH_CORES], g_Generation, &Snapshots[0]);
+        __asm__ __volatile__("" ::: "memory");
+    }
+
+    Snapshot = BenchNow() - Start;
+
+    printf("\nrecording an exit: %.2f ns, snapshot of a core (%u bytes): %.2f us\n",
+           Recording * 1e9 / BENCH_MEASURE_EXITS,
+           (UINT32)sizeof(EXIT_PROFILER_STATISTICS),
+           Snapshot * 1e6 / 10000);
+
+    free(Reasons);
+    free(Cycles);
+}
+
+int
+main(int argc, char ** argv)
+{
+    EXIT_PROFILER_STATISTICS * Snapshots;
+    BOOLEAN                    Result;
+
+    if (argc > 1)
+    {
+        return BenchShowDump(argv[1]);
+    }
+
+    Snapshots = (EXIT_PROFILER_STATISTICS *)calloc(BENCH_CORES, sizeof(EXIT_PROFILER_STATISTICS));
+
+    if (Snapshots == NULL)
+    {
+        return 1;
+    }
+
+    Result = BenchTestCores(Snapshots) && BenchTestDump(Snapshots) && BenchTestPercentilesAndRows(Snapshots) &&
+             BenchTestResetAndDelta();
+
+    if (Result)
+    {
+        BenchMeasure(Snapshots);
+    }
+
+    free(Snapshots);
+
+    if (!Result)
+    {
+        return 1;
+    }
+
+    printf("vm-exit profiler tests passed\n");
+
+    return 0;
+}
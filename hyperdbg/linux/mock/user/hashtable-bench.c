@@ -0,0 +1,618 @@
+/**
+ * @file hashtable-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the hash tables (looking up EPT hooks and detours)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_CAPACITY         4096 // the same as EPT_HOOK_LOOKUP_TABLE_CAPACITY
+#define BENCH_KEYS_COUNT       2048
+#define BENCH_TEST_OPERATIONS  1000000
+#define BENCH_LOOKUPS          2000000
+#define BENCH_READERS          4
+#define BENCH_STRESS_WRITES    2000000
+#define BENCH_REBUILDS         2000
+#define BENCH_REBUILD_KEYS     256
+#define BENCH_PAGE_SHIFT       12
+#define BENCH_MAXIMUM_HOOKS    2000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A hooked page (the fields that are checked on the EPT violations)
+ *
+ */
+typedef struct _BENCH_HOOKED_PAGE
+{
+    struct _BENCH_HOOKED_PAGE * Next;
+
+    UINT64 PhysicalBaseAddress;
+    UINT64 Handled;
+
+} BENCH_HOOKED_PAGE, *PBENCH_HOOKED_PAGE;
+
+/**
+ * @brief State of a reader of the stress test
+ *
+ */
+typedef struct _BENCH_READER
+{
+    pthread_t Thread;
+    UINT64    Lookups;
+    UINT64    Found;
+    UINT64    Errors;
+
+} BENCH_READER, *PBENCH_READER;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static PHASH_TABLE          g_Table;
+static HASH_TABLE_REFERENCE g_Reference;
+static volatile BOOLEAN     g_StopReaders;
+static BENCH_HOOKED_PAGE    g_HookedPages[BENCH_MAXIMUM_HOOKS];
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A key of the test (page frame numbers and addresses)
+ *
+ */
+static UINT64
+BenchKey(UINT32 Index)
+{
+    return Index % 2 == 0 ? (UINT64)Index * 0x1000 : 0xfffff80000000000ull + (UINT64)Index * 0x10;
+}
+
+static PHASH_TABLE
+BenchCreateTable(UINT32 Capacity)
+{
+    PVOID Buffer = calloc(1, HASH_TABLE_SIZE(Capacity));
+
+    if (Buffer == NULL || !HashTableInitialize(Buffer, Capacity))
+    {
+        free(Buffer);
+        return NULL;
+    }
+
+    return (PHASH_TABLE)Buffer;
+}
+
+/**
+ * @brief Insert, remove and find random keys and check them against an array
+ * of all of the keys
+ *
+ */
+static BOOLEAN
+BenchTestOperations(void)
+{
+    static UINT64 Expected[BENCH_KEYS_COUNT];
+    PHASH_TABLE   Table = BenchCreateTable(BENCH_CAPACITY);
+    UINT32        Count = 0;
+
+    if (Table == NULL)
+    {
+        printf("err, unable to create the table\n");
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_TEST_OPERATIONS; i++)
+    {
+        UINT32 Index = (UINT32)(BenchRandom() % BENCH_KEYS_COUNT);
+        UINT64 Key   = BenchKey(Index);
+
+        switch (BenchRandom() % 3)
+        {
+        case 0:
+        {
+            UINT64 Value = BenchRandom() | 1;
+
+            if (!HashTableInsert(Table, Key, Value))
+            {
+                printf("err, unable to insert the key %llx (%u entries)\n", (unsigned long long)Key, Count);
+                free(Table);
+                return FALSE;
+            }
+
+            Count += Expected[Index] == 0;
+            Expected[Index] = Value;
+
+            break;
+        }
+        case 1:
+
+            if (HashTableRemove(Table, Key) != (Expected[Index] != 0))
+            {
+                printf("err, removing the key %llx is not expected\n", (unsigned long long)Key);
+                free(Table);
+                return FALSE;
+            }
+
+            Count -= Expected[Index] != 0;
+            Expected[Index] = 0;
+
+            break;
+
+        default:
+
+            if (HashTableFind(Table, Key) != Expected[Index])
+            {
+                printf("err, the value of the key %llx is not expected\n", (unsigned long long)Key);
+                free(Table);
+                return FALSE;
+            }
+
+            break;
+        }
+
+        if (Table->Count != Count || !HashTableIsReliable(Table))
+        {
+            printf("err, the table has %u entries instead of %u\n", Table->Count, Count);
+            free(Table);
+            return FALSE;
+        }
+    }
+
+    //
+    // Keys that are never inserted
+    //
+    for (UINT32 i = 0; i < BENCH_KEYS_COUNT; i++)
+    {
+        if (HashTableFind(Table, BenchKey(i) + 1) != 0)
+        {
+            printf("err, an unknown key is found\n");
+            free(Table);
+            return FALSE;
+        }
+    }
+
+    printf("operations: %u random inserts, removes and finds are the same as the reference\n", BENCH_TEST_OPERATIONS);
+
+    free(Table);
+
+    return TRUE;
+}
+
+/**
+ * @brief Fill a table until it overflows, and check that it's not reliable
+ * anymore, and that removing all of the entries clears the removed slots
+ *
+ */
+static BOOLEAN
+BenchTestOverflow(void)
+{
+    PHASH_TABLE Table    = BenchCreateTable(64);
+    UINT32      Inserted = 0;
+
+    if (Table == NULL)
+    {
+        printf("err, unable to create the table\n");
+        return FALSE;
+    }
+
+    while (HashTableInsert(Table, BenchKey(Inserted), Inserted + 1))
+    {
+        Inserted++;
+    }
+
+    if (Inserted != 64 * HASH_TABLE_MAXIMUM_LOAD / 100 || HashTableIsReliable(Table))
+    {
+        printf("err, the table overflows after %u entries\n", Inserted);
+        free(Table);
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Inserted; i++)
+    {
+        if (HashTableFind(Table, BenchKey(i)) != i + 1 || !HashTableRemove(Table, BenchKey(i)))
+        {
+            printf("err, the entry %u is lost after the overflow\n", i);
+            free(Table);
+            return FALSE;
+        }
+    }
+
+    if (Table->Count != 0 || Table->UsedSlots != 0 || HashTableIsReliable(Table))
+    {
+        printf("err, the empty table still has %u used slots\n", Table->UsedSlots);
+        free(Table);
+        return FALSE;
+    }
+
+    HashTableInitialize(Table, 64);
+
+    if (!HashTableIsReliable(Table) || !HashTableInsert(Table, 1, 1))
+    {
+        printf("err, the initialized table is still overflowed\n");
+        free(Table);
+        return FALSE;
+    }
+
+    printf("overflow:   a table of 64 slots overflows after %u entries\n", Inserted);
+
+    free(Table);
+
+    return TRUE;
+}
+
+/**
+ * @brief Look up the keys while the writer changes the table, the value of
+ * each key is derived from the key so a reader can check it
+ *
+ */
+static void *
+BenchReader(void * Parameter)
+{
+    PBENCH_READER Reader = (PBENCH_READER)Parameter;
+    UINT64        State  = (UINT64)(uintptr_t)Parameter | 1;
+
+    while (!__atomic_load_n(&g_StopReaders, __ATOMIC_ACQUIRE))
+    {
+        UINT64 Key;
+        UINT64 Value;
+
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Key   = BenchKey((UINT32)(State % BENCH_KEYS_COUNT));
+        Value = HashTableFind(g_Table, Key);
+
+        if (Value != 0)
+        {
+            Reader->Found++;
+
+            if (Value != ~Key)
+            {
+                Reader->Errors++;
+            }
+        }
+
+        Reader->Lookups++;
+    }
+
+    return NULL;
+}
+
+static BOOLEAN
+BenchTestConcurrent(void)
+{
+    BENCH_READER Readers[BENCH_READERS] = {0};
+    UINT64       Lookups                = 0;
+    UINT64       Found                  = 0;
+    UINT64       Errors                 = 0;
+
+    g_Table = BenchCreateTable(BENCH_CAPACITY);
+
+    if (g_Table == NULL)
+    {
+        printf("err, unable to create the table\n");
+        return FALSE;
+    }
+
+    g_StopReaders = FALSE;
+
+    for (UINT32 i = 0; i < BENCH_READERS; i++)
+    {
+        pthread_create(&Readers[i].Thread, NULL, BenchReader, &Readers[i]);
+    }
+
+    //
+    // A single writer (like the core that applies or removes the hooks)
+    //
+    for (UINT32 i = 0; i < BENCH_STRESS_WRITES; i++)
+    {
+        UINT64 Key = BenchKey((UINT32)(BenchRandom() % BENCH_KEYS_COUNT));
+
+        if (BenchRandom() % 2 == 0)
+        {
+            HashTableInsert(g_Table, Key, ~Key);
+        }
+        else
+        {
+            HashTableRemove(g_Table, Key);
+        }
+    }
+
+    __atomic_store_n(&g_StopReaders, TRUE, __ATOMIC_RELEASE);
+
+    for (UINT32 i = 0; i < BENCH_READERS; i++)
+    {
+        pthread_join(Readers[i].Thread, NULL);
+
+        Lookups += Readers[i].Lookups;
+        Found += Readers[i].Found;
+        Errors += Readers[i].Errors;
+    }
+
+    if (Errors != 0 || !HashTableIsReliable(g_Table))
+    {
+        printf("err, %llu lookups got the value of another key\n", (unsigned long long)Errors);
+        free(g_Table);
+        return FALSE;
+    }
+
+    free(g_Table);
+
+    printf("concurrent: %u readers did %llu lookups (%llu found) while %u changes are made\n",
+           BENCH_READERS,
+           (unsigned long long)Lookups,
+           (unsigned long long)Found,
+           BENCH_STRESS_WRITES);
+
+    return TRUE;
+}
+
+/**
+ * @brief Look up the keys while the writer replaces the table (like freeing
+ * the pools while the table of the addresses is rebuilt), all of the keys
+ * are in every table
+ *
+ */
+static void *
+BenchReferenceReader(void * Parameter)
+{
+    PBENCH_READER Reader = (PBENCH_READER)Parameter;
+    UINT64        State  = (UINT64)(uintptr_t)Parameter | 1;
+
+    while (!__atomic_load_n(&g_StopReaders, __ATOMIC_ACQUIRE))
+    {
+        PHASH_TABLE Table;
+        LONG        Epoch;
+        UINT64      Key;
+        UINT64      Value;
+
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Key   = BenchKey((UINT32)(State % BENCH_REBUILD_KEYS));
+        Table = HashTableAcquireReference(&g_Reference, &Epoch);
+        Value = HashTableFind(Table, Key);
+
+        HashTableReleaseReference(&g_Reference, Epoch);
+
+        Reader->Found += Value != 0;
+        Reader->Errors += Value != ~Key;
+        Reader->Lookups++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Build a table with all of the keys of the rebuild test
+ *
+ */
+static PHASH_TABLE
+BenchCreateFullTable(UINT32 Capacity)
+{
+    PHASH_TABLE Table = BenchCreateTable(Capacity);
+
+    for (UINT32 i = 0; i < BENCH_REBUILD_KEYS && Table != NULL; i++)
+    {
+        HashTableInsert(Table, BenchKey(i), ~BenchKey(i));
+    }
+
+    return Table;
+}
+
+/**
+ * @brief Replace the table while the readers look it up, the previous table
+ * is spoiled (each key gets a wrong value) and freed right after it's
+ * replaced, so a reader that still uses it gets a wrong value (or crashes)
+ *
+ */
+static BOOLEAN
+BenchTestRebuild(void)
+{
+    BENCH_READER Readers[BENCH_READERS] = {0};
+    UINT64       Lookups                = 0;
+    UINT64       Found                  = 0;
+    UINT64       Errors                 = 0;
+    PHASH_TABLE  Table;
+    double       Start;
+
+    g_Reference.Table = BenchCreateFullTable(BENCH_REBUILD_KEYS * 2);
+
+    if (g_Reference.Table == NULL)
+    {
+        printf("err, unable to create the table\n");
+        return FALSE;
+    }
+
+    g_StopReaders = FALSE;
+
+    for (UINT32 i = 0; i < BENCH_READERS; i++)
+    {
+        pthread_create(&Readers[i].Thread, NULL, BenchReferenceReader, &Readers[i]);
+    }
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_REBUILDS; i++)
+    {
+        //
+        // The tables have different sizes, so the keys are in other slots
+        //
+        Table = BenchCreateFullTable(BENCH_REBUILD_KEYS * (2 << (i % 3)));
+
+        if (Table == NULL)
+        {
+            break;
+        }
+
+        Table = HashTableReplaceReference(&g_Reference, Table);
+
+        for (UINT32 j = 0; j < Table->Capacity; j++)
+        {
+            Table->Slots[j].Value = 1;
+        }
+
+        free(Table);
+    }
+
+    Start = BenchNow() - Start;
+
+    __atomic_store_n(&g_StopReaders, TRUE, __ATOMIC_RELEASE);
+
+    for (UINT32 i = 0; i < BENCH_READERS; i++)
+    {
+        pthread_join(Readers[i].Thread, NULL);
+
+        Lookups += Readers[i].Lookups;
+        Found += Readers[i].Found;
+        Errors += Readers[i].Errors;
+    }
+
+    free(HashTableReplaceReference(&g_Reference, NULL));
+
+    if (Errors != 0 || Found != Lookups)
+    {
+        printf("err, %llu of %llu lookups got a wrong value while the table is rebuilt\n",
+               (unsigned long long)Errors,
+               (unsigned long long)Lookups);
+        return FALSE;
+    }
+
+    printf("rebuild:    %u readers did %llu lookups while the table is replaced %u times (%.2f us per replacement)\n",
+           BENCH_READERS,
+           (unsigned long long)Lookups,
+           BENCH_REBUILDS,
+           Start / BENCH_REBUILDS * 1e6);
+
+    return TRUE;
+}
+
+/**
+ * @brief Find the hooked page by walking the list of the hooked pages (previous lookups)
+ *
+ */
+static PBENCH_HOOKED_PAGE
+BenchFindLinear(PBENCH_HOOKED_PAGE List, UINT64 PhysicalBaseAddress)
+{
+    for (PBENCH_HOOKED_PAGE Page = List; Page != NULL; Page = Page->Next)
+    {
+        if (Page->PhysicalBaseAddress == PhysicalBaseAddress)
+        {
+            return Page;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Measure the lookups of the EPT violations for a number of hooked pages
+ *
+ */
+static BOOLEAN
+BenchMeasure(UINT32 NumberOfHooks)
+{
+    static UINT64      Addresses[BENCH_LOOKUPS];
+    PBENCH_HOOKED_PAGE List          = NULL;
+    PHASH_TABLE        Table         = BenchCreateTable(BENCH_CAPACITY);
+    UINT64             LinearFound   = 0;
+    UINT64             HashedFound   = 0;
+    double             Start;
+    double             LinearTime;
+    double             HashedTime;
+
+    if (Table == NULL)
+    {
+        printf("err, unable to create the table\n");
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < NumberOfHooks; i++)
+    {
+        g_HookedPages[i].PhysicalBaseAddress = (0x100000 + (BenchRandom() % 0x400000)) << BENCH_PAGE_SHIFT;
+        g_HookedPages[i].Next                = List;
+        List                                 = &g_HookedPages[i];
+
+        HashTableInsert(Table, g_HookedPages[i].PhysicalBaseAddress >> BENCH_PAGE_SHIFT, (UINT64)&g_HookedPages[i]);
+    }
+
+    //
+    // Most of the violations are for the hooked pages
+    //
+    for (UINT32 i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        Addresses[i] = BenchRandom() % 8 == 0 ? (BenchRandom() % 0x100000) << BENCH_PAGE_SHIFT
+                                               : g_HookedPages[BenchRandom() % NumberOfHooks].PhysicalBaseAddress;
+    }
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        LinearFound += BenchFindLinear(List, Addresses[i]) != NULL;
+    }
+
+    LinearTime = BenchNow() - Start;
+    Start      = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_LOOKUPS; i++)
+    {
+        PBENCH_HOOKED_PAGE Page = (PBENCH_HOOKED_PAGE)HashTableFind(Table, Addresses[i] >> BENCH_PAGE_SHIFT);
+
+        HashedFound += Page != NULL && Page->PhysicalBaseAddress == Addresses[i];
+    }
+
+    HashedTime = BenchNow() - Start;
+
+    free(Table);
+
+    if (LinearFound != HashedFound)
+    {
+        printf("err, %llu hooked pages are found instead of %llu\n",
+               (unsigned long long)HashedFound,
+               (unsigned long long)LinearFound);
+        return FALSE;
+    }
+
+    printf("%4u hooks: table: %8.2f M lookups/s, list of hooked pages: %8.2f M lookups/s\n",
+           NumberOfHooks,
+           BENCH_LOOKUPS / HashedTime / 1e6,
+           BENCH_LOOKUPS / LinearTime / 1e6);
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    static const UINT32 Counts[] = {1, 10, 100, 500, 2000};
+    BOOLEAN             Passed   = BenchTestOperations() && BenchTestOverflow() && BenchTestConcurrent() &&
+                                   BenchTestRebuild();
+
+    for (UINT32 i = 0; i < sizeof(Counts) / sizeof(Counts[0]) && Passed; i++)
+    {
+        Passed = BenchMeasure(Counts[i]);
+    }
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("hash table tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,1405 @@
+/**
+ * @file hwdbgmodel-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the cycle-level model of the hwdbg script stages
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_MAXIMUM_STAGES      130
+#define BENCH_MAXIMUM_OPERANDS    3
+#define BENCH_MAXIMUM_PINS        256
+#define BENCH_MAXIMUM_PORTS       8
+#define BENCH_MAXIMUM_VARIABLES   4
+#define BENCH_PIN_WORDS           HWDBG_MODEL_PIN_WORDS(BENCH_MAXIMUM_PINS)
+#define BENCH_MAXIMUM_BUFFER      (BENCH_MAXIMUM_STAGES * (1 + 2 * BENCH_MAXIMUM_OPERANDS) * 2 * 8 + 64)
+#define BENCH_BRAM_SIZE           8192
+#define BENCH_NO_TARGET           0xffffffff
+#define BENCH_RANDOM_SCRIPTS      3000
+#define BENCH_RANDOM_INPUTS       48
+#define BENCH_MEASURE_STAGE_EVALS 20000000ull
+
+#define BENCH_SCRIPT_BUFFER_FILE  "../../../../hwdbg/src/test/bram/script_buffer.hex.txt"
+#define BENCH_INSTANCE_INFO_FILE  "../../../../hwdbg/sim/hwdbg/DebuggerModuleTestingBRAM/bram_instance_info.txt"
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A stage of a script (the operands that are not used are empty)
+ *
+ */
+typedef struct _BENCH_STAGE
+{
+    HWDBG_SHORT_SYMBOL Operator;
+    HWDBG_SHORT_SYMBOL GetOperands[BENCH_MAXIMUM_OPERANDS];
+    HWDBG_SHORT_SYMBOL SetOperands[BENCH_MAXIMUM_OPERANDS];
+    UINT32             TargetStage; // the target of a jump (a stage number)
+
+} BENCH_STAGE, *PBENCH_STAGE;
+
+/**
+ * @brief A script and the index of the symbol of each stage
+ *
+ */
+typedef struct _BENCH_SCRIPT
+{
+    BENCH_STAGE Stages[BENCH_MAXIMUM_STAGES];
+    UINT64      Indexes[BENCH_MAXIMUM_STAGES + 1];
+    UINT32      NumberOfStages;
+
+} BENCH_SCRIPT, *PBENCH_SCRIPT;
+
+/**
+ * @brief An instance with its ports
+ *
+ */
+typedef struct _BENCH_INSTANCE
+{
+    HWDBG_INSTANCE_INFORMATION Info;
+    UINT32                     Ports[BENCH_MAXIMUM_PORTS];
+
+} BENCH_INSTANCE, *PBENCH_INSTANCE;
+
+/**
+ * @brief Pins and variables of the reference interpreter (a pin per byte)
+ *
+ */
+typedef struct _BENCH_STATE
+{
+    UINT8  Pins[BENCH_MAXIMUM_PINS];
+    UINT64 Variables[BENCH_MAXIMUM_VARIABLES];
+    UINT64 Temps[BENCH_MAXIMUM_VARIABLES];
+
+} BENCH_STATE, *PBENCH_STATE;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static BENCH_SCRIPT g_Script;
+static BYTE         g_Buffer[BENCH_MAXIMUM_BUFFER];
+static BYTE         g_Bram[BENCH_BRAM_SIZE];
+static const UINT64 g_Operators[] = {FUNC_OR, FUNC_XOR, FUNC_AND, FUNC_ASR, FUNC_ASL, FUNC_ADD, FUNC_SUB, FUNC_MUL, FUNC_DIV, FUNC_MOD, FUNC_GT, FUNC_LT, FUNC_EGT, FUNC_ELT, FUNC_EQUAL, FUNC_NEQ, FUNC_MOV, FUNC_MOV, FUNC_JMP, FUNC_JZ, FUNC_JNZ};
+static const UINT32 g_Lengths[]   = {8, 13, 16, 32, 64};
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static UINT64
+BenchMask(UINT32 Length)
+{
+    return Length >= 64 ? ~0ull : (1ull << Length) - 1;
+}
+
+static UINT32
+BenchLog2Ceil(UINT64 Count)
+{
+    UINT32 Width = 0;
+
+    while ((1ull << Width) < Count)
+    {
+        Width++;
+    }
+
+    return Width;
+}
+
+static HWDBG_SHORT_SYMBOL
+BenchSymbol(UINT64 Type, UINT64 Value)
+{
+    HWDBG_SHORT_SYMBOL Symbol;
+
+    Symbol.Type  = Type;
+    Symbol.Value = Value;
+
+    return Symbol;
+}
+
+static VOID
+BenchSetCapabilities(PBENCH_INSTANCE Instance, UINT64 Capabilities)
+{
+    //
+    // The bit-fields are only 4 bytes with GCC (the chip sends 8 bytes)
+    //
+    memcpy(&Instance->Info.scriptCapabilities, &Capabilities, sizeof(Instance->Info.scriptCapabilities));
+}
+
+/**
+ * @brief The instance of the shared test corpus of the Chisel design
+ * (bram_instance_info.txt)
+ *
+ */
+static VOID
+BenchDefaultInstance(PBENCH_INSTANCE Instance)
+{
+    memset(Instance, 0, sizeof(BENCH_INSTANCE));
+
+    Instance->Info.version                                    = 0x100;
+    Instance->Info.maximumNumberOfStages                      = 32;
+    Instance->Info.scriptVariableLength                       = 8;
+    Instance->Info.numberOfSupportedLocalAndGlobalVariables   = 2;
+    Instance->Info.numberOfSupportedTemporaryVariables        = 2;
+    Instance->Info.maximumNumberOfSupportedGetScriptOperators = 2;
+    Instance->Info.maximumNumberOfSupportedSetScriptOperators = 1;
+    Instance->Info.sharedMemorySize                           = 0x400;
+    Instance->Info.debuggerAreaOffset                         = 0;
+    Instance->Info.debuggeeAreaOffset                         = 0x200;
+    Instance->Info.numberOfPins                               = 32;
+    Instance->Info.numberOfPorts                              = 2;
+    Instance->Info.bramAddrWidth                              = 13;
+    Instance->Info.bramDataWidth                              = 32;
+    Instance->Ports[0]                                        = 12;
+    Instance->Ports[1]                                        = 20;
+
+    BenchSetCapabilities(Instance, 0x01ff9efb);
+}
+
+/**
+ * @brief Set the capabilities of an instance (as the mask of the instance info)
+ *
+ */
+static VOID
+BenchAddStage(PBENCH_SCRIPT Script, UINT64 Operator, UINT32 NumberOfGets, const HWDBG_SHORT_SYMBOL * Operands, UINT32 NumberOfSets)
+{
+    BENCH_STAGE * Stage = &Script->Stages[Script->NumberOfStages++];
+
+    memset(Stage, 0, sizeof(BENCH_STAGE));
+
+    Stage->Operator    = BenchSymbol(SYMBOL_SEMANTIC_RULE_TYPE, Operator);
+    Stage->TargetStage = BENCH_NO_TARGET;
+
+    for (UINT32 i = 0; i < NumberOfGets; i++)
+    {
+        Stage->GetOperands[i] = Operands[i];
+    }
+
+    for (UINT32 i = 0; i < NumberOfSets; i++)
+    {
+        Stage->SetOperands[i] = Operands[NumberOfGets + i];
+    }
+}
+
+/**
+ * @brief Compute the index of the symbol of each stage (the empty operands are
+ * not a part of the script) and write the targets of the jumps
+ *
+ */
+static VOID
+BenchIndexScript(PBENCH_SCRIPT Script)
+{
+    UINT64 Index = 0;
+
+    for (UINT32 i = 0; i < Script->NumberOfStages; i++)
+    {
+        Script->Indexes[i] = Index++;
+
+        for (UINT32 j = 0; j < BENCH_MAXIMUM_OPERANDS; j++)
+        {
+            Index += Script->Stages[i].GetOperands[j].Type != 0;
+            Index += Script->Stages[i].SetOperands[j].Type != 0;
+        }
+    }
+
+    Script->Indexes[Script->NumberOfStages] = Index;
+
+    for (UINT32 i = 0; i < Script->NumberOfStages; i++)
+    {
+        if (Script->Stages[i].TargetStage != BENCH_NO_TARGET)
+        {
+            Script->Stages[i].GetOperands[0] = BenchSymbol(SYMBOL_NUM_TYPE, Script->Indexes[Script->Stages[i].TargetStage]);
+        }
+    }
+}
+
+static VOID
+BenchWriteChunk(BYTE * Buffer, SIZE_T * Offset, UINT64 Value, UINT32 BramDataWidth)
+{
+    for (UINT32 i = 0; i < (BramDataWidth + 7) / 8; i++)
+    {
+        Buffer[(*Offset)++] = (BYTE)(Value >> (i * 8));
+    }
+}
+
+/**
+ * @brief Write the script buffer the way the host writes it after the packet
+ * (the number of the symbols, then each symbol of each stage with its empty
+ * operands, each field in a chunk of the width of the BRAM)
+ *
+ */
+static SIZE_T
+BenchWriteScriptBuffer(const BENCH_INSTANCE * Instance, const BENCH_SCRIPT * Script, BYTE * Buffer)
+{
+    UINT32 NumberOfGets   = Instance->Info.maximumNumberOfSupportedGetScriptOperators;
+    UINT32 NumberOfSets   = Instance->Info.maximumNumberOfSupportedSetScriptOperators;
+    UINT32 BramDataWidth  = Instance->Info.bramDataWidth;
+    SIZE_T Offset         = 0;
+    UINT64 NumberOfSymbol = (UINT64)Script->NumberOfStages * (1 + NumberOfGets + NumberOfSets);
+
+    BenchWriteChunk(Buffer, &Offset, NumberOfSymbol - 1, BramDataWidth);
+
+    for (UINT32 i = 0; i < Script->NumberOfStages; i++)
+    {
+        const BENCH_STAGE * Stage = &Script->Stages[i];
+
+        BenchWriteChunk(Buffer, &Offset, Stage->Operator.Type, BramDataWidth);
+        BenchWriteChunk(Buffer, &Offset, Stage->Operator.Value, BramDataWidth);
+
+        for (UINT32 j = 0; j < NumberOfGets; j++)
+        {
+            BenchWriteChunk(Buffer, &Offset, Stage->GetOperands[j].Type, BramDataWidth);
+            BenchWriteChunk(Buffer, &Offset, Stage->GetOperands[j].Value, BramDataWidth);
+        }
+
+        for (UINT32 j = 0; j < NumberOfSets; j++)
+        {
+            BenchWriteChunk(Buffer, &Offset, Stage->SetOperands[j].Type, BramDataWidth);
+            BenchWriteChunk(Buffer, &Offset, Stage->SetOperands[j].Value, BramDataWidth);
+        }
+    }
+
+    return Offset;
+}
+
+/**
+ * @brief Write the packet of the script into the BRAM (the same way as
+ * HwdbgInterpreterSendPacketAndBufferToHwdbg)
+ *
+ */
+static VOID
+BenchWritePacket(const BENCH_INSTANCE * Instance, const BYTE * Buffer, SIZE_T BufferSize, BYTE * Bram)
+{
+    DEBUGGER_REMOTE_PACKET Packet;
+
+    memset(&Packet, 0, sizeof(Packet));
+    memset(Bram, 0, BENCH_BRAM_SIZE);
+
+    Packet.Indicator                  = INDICATOR_OF_HYPERDBG_PACKET;
+    Packet.TypeOfThePacket            = DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_HARDWARE_LEVEL;
+    Packet.RequestedActionOfThePacket = (DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION)hwdbgActionConfigureScriptBuffer;
+
+    memcpy(Bram + Instance->Info.debuggerAreaOffset, &Packet, sizeof(Packet));
+    memcpy(Bram + Instance->Info.debuggerAreaOffset + sizeof(Packet), Buffer, BufferSize);
+}
+
+/**
+ * @brief Get a value of the reference interpreter
+ *
+ */
+static UINT64
+BenchGet(const BENCH_INSTANCE * Instance, const BENCH_STATE * State, const HWDBG_SHORT_SYMBOL * Symbol)
+{
+    UINT32 Length  = Instance->Info.scriptVariableLength;
+    UINT64 Operand = Symbol->Value & BenchMask(Length);
+    UINT64 Value   = 0;
+    UINT32 Port    = 0;
+    UINT32 Low     = 0;
+
+    //
+    // The operands are as wide as the variables (so are the numbers of the
+    // registers)
+    //
+    switch (Symbol->Type)
+    {
+    case SYMBOL_GLOBAL_ID_TYPE:
+    case SYMBOL_LOCAL_ID_TYPE:
+        return State->Variables[Operand];
+
+    case SYMBOL_TEMP_TYPE:
+        return State->Temps[Operand];
+
+    case SYMBOL_NUM_TYPE:
+        return Operand;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        if (Operand < Instance->Info.numberOfPins)
+        {
+            return State->Pins[Operand];
+        }
+
+        //
+        // The number of the port is truncated to the width of the index of
+        // the ports (e.g., any port is the first port if there is only one)
+        //
+        Port = (UINT32)((Operand - Instance->Info.numberOfPins) & BenchMask(BenchLog2Ceil(Instance->Info.numberOfPorts)));
+
+        if (Port >= Instance->Info.numberOfPorts)
+        {
+            return 0;
+        }
+
+        for (UINT32 i = 0; i < Port; i++)
+        {
+            Low += Instance->Ports[i];
+        }
+
+        //
+        // The first bits of the port (up to the length of the variables)
+        //
+        for (UINT32 i = 0; i < Instance->Ports[Port] && i < Length; i++)
+        {
+            Value |= (UINT64)State->Pins[Low + i] << i;
+        }
+
+        return Value;
+
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Set a value of the reference interpreter
+ *
+ */
+static VOID
+BenchSet(const BENCH_INSTANCE * Instance, PBENCH_STATE State, const HWDBG_SHORT_SYMBOL * Symbol, UINT64 Value)
+{
+    UINT32 Length  = Instance->Info.scriptVariableLength;
+    UINT64 Operand = Symbol->Value & BenchMask(Length);
+    UINT32 Port, Width, Low = 0;
+
+    switch (Symbol->Type)
+    {
+    case SYMBOL_GLOBAL_ID_TYPE:
+    case SYMBOL_LOCAL_ID_TYPE:
+        State->Variables[Operand] = Value;
+        return;
+
+    case SYMBOL_TEMP_TYPE:
+        State->Temps[Operand] = Value;
+        return;
+
+    case SYMBOL_REGISTER_TYPE:
+
+        if (Operand < Instance->Info.numberOfPins)
+        {
+            State->Pins[Operand] = Value & 1;
+            return;
+        }
+
+        Port = (UINT32)(Operand - Instance->Info.numberOfPins);
+
+        if (Operand - Instance->Info.numberOfPins >= Instance->Info.numberOfPorts)
+        {
+            //
+            // Not a port, all of the pins are cleared
+            //
+            memset(State->Pins, 0, sizeof(State->Pins));
+            return;
+        }
+
+        for (UINT32 i = 0; i < Port; i++)
+        {
+            Low += Instance->Ports[i];
+        }
+
+        Width = Instance->Ports[Port];
+
+        //
+        // The value is at the top of a port that is wider than the variables
+        //
+        for (UINT32 i = 0; i < Width; i++)
+        {
+            if (Width > Length)
+            {
+                State->Pins[Low + i] = i < Width - Length ? 0 : (Value >> (i - (Width - Length))) & 1;
+            }
+            else
+            {
+                State->Pins[Low + i] = (Value >> i) & 1;
+            }
+        }
+
+        //
+        // The last port clears the pins above it
+        //
+        if (Port != 0 && Port == Instance->Info.numberOfPorts - 1)
+        {
+            memset(&State->Pins[Low + Width], 0, Instance->Info.numberOfPins - (Low + Width));
+        }
+
+        return;
+
+    default:
+        return;
+    }
+}
+
+/**
+ * @brief Run a script on the input pins with the reference interpreter (all
+ * of the capabilities are supported, and each stage can only run once after
+ * the previous stages, the same as the stages of the chip)
+ *
+ */
+static VOID
+BenchInterpret(const BENCH_INSTANCE * Instance, const BENCH_SCRIPT * Script, const UINT64 * InputPins, UINT64 * OutputPins)
+{
+    UINT32      Length     = Instance->Info.scriptVariableLength;
+    UINT64      IndexMask  = BenchMask(BenchLog2Ceil((UINT64)Instance->Info.maximumNumberOfStages *
+                                                (Instance->Info.maximumNumberOfSupportedGetScriptOperators +
+                                                 Instance->Info.maximumNumberOfSupportedSetScriptOperators + 1)));
+    UINT32      Evaluated  = Instance->Info.maximumNumberOfStages - 2;
+    UINT64      Target     = 0;
+    BENCH_STATE State;
+
+    memset(&State, 0, sizeof(State));
+
+    for (UINT32 i = 0; i < Instance->Info.numberOfPins; i++)
+    {
+        State.Pins[i] = (InputPins[i / 64] >> (i % 64)) & 1;
+    }
+
+    for (UINT32 i = 0; i < Script->NumberOfStages && i < Evaluated; i++)
+    {
+        const BENCH_STAGE * Stage = &Script->Stages[i];
+        UINT64              A     = BenchGet(Instance, &State, &Stage->GetOperands[0]);
+        UINT64              B     = BenchGet(Instance, &State, &Stage->GetOperands[1]);
+        UINT64              Count = B % (2ull << BenchLog2Ceil(Length));
+        UINT64              Value = 0;
+        UINT64              Next  = Script->Indexes[i] + 4;
+
+        if (Script->Indexes[i] != Target)
+        {
+            continue;
+        }
+
+        switch (Stage->Operator.Value)
+        {
+        case FUNC_OR: Value = A | B; break;
+        case FUNC_XOR: Value = A ^ B; break;
+        case FUNC_AND: Value = A & B; break;
+        case FUNC_ASR: Value = Count < 64 ? A >> Count : 0; break;
+        case FUNC_ASL: Value = Count < 64 ? A << Count : 0; break;
+        case FUNC_ADD: Value = A + B; break;
+        case FUNC_SUB: Value = A - B; break;
+        case FUNC_MUL: Value = A * B; break;
+        case FUNC_DIV: Value = B ? A / B : 0; break;
+        case FUNC_MOD: Value = B ? A % B : 0; break;
+        case FUNC_GT: Value = A > B; break;
+        case FUNC_LT: Value = A < B; break;
+        case FUNC_EGT: Value = A >= B; break;
+        case FUNC_ELT: Value = A <= B; break;
+        case FUNC_EQUAL: Value = A == B; break;
+        case FUNC_NEQ: Value = A != B; break;
+        case FUNC_MOV: Value = A; Next = Script->Indexes[i] + 3; break;
+        case FUNC_JMP: Next = A; break;
+        case FUNC_JZ: Next = B == 0 ? A : Script->Indexes[i] + 3; break;
+        case FUNC_JNZ: Next = B != 0 ? A : Script->Indexes[i] + 3; break;
+        default: Next = 0; break;
+        }
+
+        BenchSet(Instance, &State, &Stage->SetOperands[0], Value & BenchMask(Length));
+
+        Target = Next & IndexMask;
+    }
+
+    memset(OutputPins, 0, BENCH_PIN_WORDS * sizeof(UINT64));
+
+    for (UINT32 i = 0; i < Instance->Info.numberOfPins; i++)
+    {
+        OutputPins[i / 64] |= (UINT64)State.Pins[i] << (i % 64);
+    }
+}
+
+static VOID
+BenchPrintScript(const BENCH_INSTANCE * Instance, const BENCH_SCRIPT * Script)
+{
+    printf("instance: stages %u, length %u, pins %u, ports %u, operands %u/%u, bram %u bits\n",
+           Instance->Info.maximumNumberOfStages,
+           Instance->Info.scriptVariableLength,
+           Instance->Info.numberOfPins,
+           Instance->Info.numberOfPorts,
+           Instance->Info.maximumNumberOfSupportedGetScriptOperators,
+           Instance->Info.maximumNumberOfSupportedSetScriptOperators,
+           Instance->Info.bramDataWidth);
+
+    for (UINT32 i = 0; i < Instance->Info.numberOfPorts; i++)
+    {
+        printf("  port%u: %u pins\n", i, Instance->Ports[i]);
+    }
+
+    for (UINT32 i = 0; i < Script->NumberOfStages; i++)
+    {
+        const BENCH_STAGE * Stage = &Script->Stages[i];
+
+        printf("  %3llu: op %-3llu get (%llu, %llx) (%llu, %llx) set (%llu, %llx)\n",
+               (unsigned long long)Script->Indexes[i],
+               (unsigned long long)Stage->Operator.Value,
+               (unsigned long long)Stage->GetOperands[0].Type,
+               (unsigned long long)Stage->GetOperands[0].Value,
+               (unsigned long long)Stage->GetOperands[1].Type,
+               (unsigned long long)Stage->GetOperands[1].Value,
+               (unsigned long long)Stage->SetOperands[0].Type,
+               (unsigned long long)Stage->SetOperands[0].Value);
+    }
+}
+
+/**
+ * @brief Initialize a model of an instance (the buffer is allocated)
+ *
+ */
+static BOOLEAN
+BenchCreateModel(const BENCH_INSTANCE * Instance, PHWDBG_MODEL Model, PVOID * Buffer)
+{
+    SIZE_T BufferSize = HwdbgModelGetBufferSize(&Instance->Info);
+
+    *Buffer = BufferSize ? malloc(BufferSize) : NULL;
+
+    if (*Buffer == NULL || !HwdbgModelInitialize(Model, &Instance->Info, Instance->Ports, *Buffer, BufferSize))
+    {
+        printf("err, unable to initialize the model\n");
+        free(*Buffer);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Clock the model until the output of the given input pins
+ *
+ */
+static VOID
+BenchRun(PHWDBG_MODEL Model, const UINT64 * InputPins, UINT64 * OutputPins)
+{
+    for (UINT32 i = 0; i < HwdbgModelGetLatency(Model); i++)
+    {
+        HwdbgModelClock(Model, InputPins, NULL);
+    }
+
+    HwdbgModelClock(Model, InputPins, OutputPins);
+}
+
+/**
+ * @brief Configure a handwritten script and check the output of the input pins
+ *
+ */
+static BOOLEAN
+BenchCheckHandwritten(const char *           Name,
+                      const BENCH_INSTANCE * Instance,
+                      PBENCH_SCRIPT          Script,
+                      UINT64                 Input,
+                      UINT64                 Expected)
+{
+    HWDBG_MODEL Model;
+    PVOID       Buffer;
+    UINT64      Pins[BENCH_PIN_WORDS] = {0};
+    UINT64      Output[BENCH_PIN_WORDS];
+    SIZE_T      Size;
+    BOOLEAN     Result = TRUE;
+
+    if (!BenchCreateModel(Instance, &Model, &Buffer))
+    {
+        return FALSE;
+    }
+
+    BenchIndexScript(Script);
+    Size = BenchWriteScriptBuffer(Instance, Script, g_Buffer);
+    BenchWritePacket(Instance, g_Buffer, Size, g_Bram);
+
+    Pins[0] = Input;
+
+    if (!HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE))
+    {
+        printf("err, %s: the script is not applied\n", Name);
+        Result = FALSE;
+    }
+    else
+    {
+        BenchRun(&Model, Pins, Output);
+
+        if (Output[0] != Expected)
+        {
+            printf("err, %s: the output of %llx is %llx instead of %llx\n",
+                   Name,
+                   (unsigned long long)Input,
+                   (unsigned long long)Output[0],
+                   (unsigned long long)Expected);
+            BenchPrintScript(Instance, Script);
+            Result = FALSE;
+        }
+    }
+
+    free(Buffer);
+
+    return Result;
+}
+
+/**
+ * @brief Read the words of a BRAM file of the test corpus (the first hex
+ * number of each line of the script buffer, or each "mem_N:" line of the
+ * dump of the instance info)
+ *
+ */
+static BOOLEAN
+BenchReadCorpusFile(const char * Path, BOOLEAN IsMemoryDump, BYTE * Bram)
+{
+    FILE *        File = fopen(Path, "r");
+    char          Line[256];
+    unsigned long Address = 0, Word;
+
+    if (File == NULL)
+    {
+        return FALSE;
+    }
+
+    memset(Bram, 0, BENCH_BRAM_SIZE);
+
+    while (fgets(Line, sizeof(Line), File) != NULL)
+    {
+        if (IsMemoryDump)
+        {
+            if (sscanf(Line, "mem_%lu: %lx", &Address, &Word) != 2)
+            {
+                continue;
+            }
+        }
+        else if (sscanf(Line, "%lx", &Word) != 1)
+        {
+            continue;
+        }
+
+        if ((Address + 1) * 4 <= BENCH_BRAM_SIZE)
+        {
+            for (UINT32 i = 0; i < 4; i++)
+            {
+                Bram[Address * 4 + i] = (BYTE)(Word >> (i * 8));
+            }
+        }
+
+        Address++;
+    }
+
+    fclose(File);
+
+    return TRUE;
+}
+
+/**
+ * @brief The script of the test corpus (script_buffer.hex.txt), a subtraction
+ * with the stack operands and an operator that is not implemented
+ *
+ */
+static VOID
+BenchCorpusScript(PBENCH_SCRIPT Script)
+{
+    HWDBG_SHORT_SYMBOL Operands[3];
+
+    Script->NumberOfStages = 0;
+
+    Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+    Operands[1] = BenchSymbol(SYMBOL_STACK_INDEX_TYPE, 0);
+    Operands[2] = BenchSymbol(SYMBOL_STACK_INDEX_TYPE, 0);
+    BenchAddStage(Script, FUNC_SUB, 2, Operands, 1);
+
+    Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+    Operands[1] = BenchSymbol(SYMBOL_UNDEFINED, 0);
+    Operands[2] = BenchSymbol(SYMBOL_REGISTER_TYPE, 0);
+    BenchAddStage(Script, FUNC_START_OF_DO_WHILE, 2, Operands, 1);
+
+    BenchIndexScript(Script);
+}
+
+/**
+ * @brief Check the model with the shared test corpus of the Chisel design
+ *
+ */
+static BOOLEAN
+BenchTestCorpus(void)
+{
+    BENCH_INSTANCE Instance, Parsed;
+    HWDBG_MODEL    Model;
+    PVOID          Buffer;
+    UINT64         Pins[BENCH_PIN_WORDS] = {0};
+    UINT64         Output[BENCH_PIN_WORDS];
+    SIZE_T         Size, InfoOffset;
+    UINT64         Capabilities;
+    BOOLEAN        Result = TRUE;
+
+    BenchDefaultInstance(&Instance);
+
+    //
+    // The instance info that is sent by the chip (after the packet, in the
+    // area of the debuggee)
+    //
+    if (BenchReadCorpusFile(BENCH_INSTANCE_INFO_FILE, TRUE, g_Bram))
+    {
+        InfoOffset = Instance.Info.debuggeeAreaOffset + sizeof(DEBUGGER_REMOTE_PACKET);
+
+        //
+        // Twelve words, the capabilities (two words), the widths of the BRAM,
+        // and then the ports
+        //
+        memset(&Parsed, 0, sizeof(Parsed));
+        memcpy(&Parsed.Info, g_Bram + InfoOffset, 12 * sizeof(UINT32));
+        memcpy(&Capabilities, g_Bram + InfoOffset + 12 * sizeof(UINT32), sizeof(Capabilities));
+        memcpy(&Parsed.Info.bramAddrWidth, g_Bram + InfoOffset + 14 * sizeof(UINT32), sizeof(UINT32));
+        memcpy(&Parsed.Info.bramDataWidth, g_Bram + InfoOffset + 15 * sizeof(UINT32), sizeof(UINT32));
+        memcpy(Parsed.Ports, g_Bram + InfoOffset + 16 * sizeof(UINT32), Instance.Info.numberOfPorts * sizeof(UINT32));
+
+        BenchSetCapabilities(&Parsed, Capabilities);
+
+        if (memcmp(&Parsed, &Instance, sizeof(Instance)) != 0)
+        {
+            printf("err, the instance info of the corpus is not the expected instance\n");
+            return FALSE;
+        }
+    }
+    else
+    {
+        printf("corpus:      %s is not found, using the same instance\n", BENCH_INSTANCE_INFO_FILE);
+    }
+
+    //
+    // The script buffer of the corpus, or the same script if the corpus is not
+    // available
+    //
+    BenchCorpusScript(&g_Script);
+
+    if (!BenchReadCorpusFile(BENCH_SCRIPT_BUFFER_FILE, FALSE, g_Bram))
+    {
+        printf("corpus:      %s is not found, using the same script\n", BENCH_SCRIPT_BUFFER_FILE);
+
+        Size = BenchWriteScriptBuffer(&Instance, &g_Script, g_Buffer);
+        BenchWritePacket(&Instance, g_Buffer, Size, g_Bram);
+    }
+    else
+    {
+        //
+        // The script buffer of the corpus should be the same as the buffer of
+        // the script (the symbols after the packet)
+        //
+        Size = BenchWriteScriptBuffer(&Instance, &g_Script, g_Buffer);
+
+        if (memcmp(g_Bram + sizeof(DEBUGGER_REMOTE_PACKET), g_Buffer, Size) != 0)
+        {
+            printf("err, the script buffer of the corpus is not the expected script\n");
+            return FALSE;
+        }
+    }
+
+    if (!BenchCreateModel(&Instance, &Model, &Buffer))
+    {
+        return FALSE;
+    }
+
+    if (!HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE))
+    {
+        printf("err, the script of the corpus is not applied\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    //
+    // The stages are configured the same as the chip (the stage index counts
+    // the symbols that are not empty)
+    //
+    if (Model.Stages[0].StageIndex != 0 || Model.Stages[1].StageIndex != 4 ||
+        Model.Stages[0].StageSymbol.Value != FUNC_SUB || Model.Stages[1].StageSymbol.Value != FUNC_START_OF_DO_WHILE ||
+        Model.Stages[1].SetOperatorSymbols[0].Type != SYMBOL_REGISTER_TYPE ||
+        !Model.Stages[0].StageEnable || !Model.Stages[1].StageEnable || Model.Stages[2].StageEnable)
+    {
+        printf("err, the stages of the corpus are not configured as expected\n");
+        Result = FALSE;
+    }
+
+    //
+    // The operator of the second stage is not implemented, so zero is written
+    // into the first pin
+    //
+    for (UINT32 i = 0; i < 256 && Result; i++)
+    {
+        Pins[0] = (BenchRandom() & 0xffffffff) | (i & 1);
+
+        BenchRun(&Model, Pins, Output);
+
+        if (Output[0] != (Pins[0] & ~1ull))
+        {
+            printf("err, the output of the corpus script for %llx is %llx\n", (unsigned long long)Pins[0], (unsigned long long)Output[0]);
+            Result = FALSE;
+        }
+    }
+
+    if (Result)
+    {
+        printf("corpus:      the stages and the outputs of the corpus script are the same as the chip\n");
+    }
+
+    free(Buffer);
+
+    return Result;
+}
+
+/**
+ * @brief Check the handwritten scripts, the quirks of the chip, and the
+ * invalid packets
+ *
+ */
+static BOOLEAN
+BenchTestHandwritten(void)
+{
+    BENCH_INSTANCE     Instance;
+    HWDBG_SHORT_SYMBOL Operands[3];
+    HWDBG_MODEL        Model;
+    PVOID              Buffer;
+    UINT64             Pins[BENCH_PIN_WORDS] = {0};
+    UINT64             Output[BENCH_PIN_WORDS];
+    UINT64             Input;
+    UINT32             ElseJump, EndJump;
+    SIZE_T             Size;
+
+    BenchDefaultInstance(&Instance);
+
+    for (UINT32 Round = 0; Round < 64; Round++)
+    {
+        Input = BenchRandom() & 0xffffffff;
+
+        //
+        // port0 = port0 + 1 (the port is wider than the variables, so the
+        // value is read from its first bits and written to its last bits)
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 32);
+        Operands[1]             = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+        Operands[2]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 32);
+        BenchAddStage(&g_Script, FUNC_ADD, 2, Operands, 1);
+
+        if (!BenchCheckHandwritten("port0 = port0 + 1", &Instance, &g_Script, Input, (Input & ~0xfffull) | ((((Input & 0xff) + 1) & 0xff) << 4)))
+        {
+            return FALSE;
+        }
+
+        //
+        // port1 = @hw_pin5
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 5);
+        Operands[1]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 33);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        if (!BenchCheckHandwritten("port1 = pin5", &Instance, &g_Script, Input, (Input & 0xfff) | (((Input >> 5) & 1) << 24)))
+        {
+            return FALSE;
+        }
+
+        //
+        // x = @hw_pin0 ^ @hw_pin1; if (x == 1) { @hw_pin31 = 1; } else { @hw_pin30 = 0; }
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 0);
+        Operands[1]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 1);
+        Operands[2]             = BenchSymbol(SYMBOL_GLOBAL_ID_TYPE, 1);
+        BenchAddStage(&g_Script, FUNC_XOR, 2, Operands, 1);
+
+        Operands[0] = BenchSymbol(SYMBOL_GLOBAL_ID_TYPE, 1);
+        Operands[1] = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+        Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, 0);
+        BenchAddStage(&g_Script, FUNC_EQUAL, 2, Operands, 1);
+
+        ElseJump    = g_Script.NumberOfStages;
+        Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+        Operands[1] = BenchSymbol(SYMBOL_TEMP_TYPE, 0);
+        BenchAddStage(&g_Script, FUNC_JZ, 2, Operands, 0);
+
+        Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+        Operands[1] = BenchSymbol(SYMBOL_REGISTER_TYPE, 31);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        EndJump     = g_Script.NumberOfStages;
+        Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+        BenchAddStage(&g_Script, FUNC_JMP, 1, Operands, 0);
+
+        g_Script.Stages[ElseJump].TargetStage = g_Script.NumberOfStages;
+
+        Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+        Operands[1] = BenchSymbol(SYMBOL_REGISTER_TYPE, 30);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        g_Script.Stages[EndJump].TargetStage = g_Script.NumberOfStages;
+
+        if (!BenchCheckHandwritten("if (pin0 ^ pin1)", &Instance, &g_Script, Input, ((Input ^ (Input >> 1)) & 1) ? (Input | (1ull << 31)) : (Input & ~(1ull << 30))))
+        {
+            return FALSE;
+        }
+
+        //
+        // x = x + @hw_pin0; @hw_pin1 = x (each input starts with zero variables,
+        // the variables are not kept between the inputs)
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_LOCAL_ID_TYPE, 0);
+        Operands[1]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 0);
+        Operands[2]             = BenchSymbol(SYMBOL_LOCAL_ID_TYPE, 0);
+        BenchAddStage(&g_Script, FUNC_ADD, 2, Operands, 1);
+
+        Operands[0] = BenchSymbol(SYMBOL_LOCAL_ID_TYPE, 0);
+        Operands[1] = BenchSymbol(SYMBOL_REGISTER_TYPE, 1);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        if (!BenchCheckHandwritten("x = x + pin0", &Instance, &g_Script, Input, (Input & ~2ull) | ((Input & 1) << 1)))
+        {
+            return FALSE;
+        }
+
+        //
+        // A register that is neither a pin nor a port clears all of the pins
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_NUM_TYPE, 5);
+        Operands[1]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 40);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        if (!BenchCheckHandwritten("not a port", &Instance, &g_Script, Input, 0))
+        {
+            return FALSE;
+        }
+
+        //
+        // The chip checks the capability of 'egt' for 'elt' (an operator that
+        // is not supported writes zero and the next stages are not evaluated)
+        //
+        g_Script.NumberOfStages = 0;
+        Operands[0]             = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+        Operands[1]             = BenchSymbol(SYMBOL_NUM_TYPE, 2);
+        Operands[2]             = BenchSymbol(SYMBOL_REGISTER_TYPE, 3);
+        BenchAddStage(&g_Script, FUNC_ELT, 2, Operands, 1);
+
+        Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+        Operands[1] = BenchSymbol(SYMBOL_REGISTER_TYPE, 4);
+        BenchAddStage(&g_Script, FUNC_MOV, 1, Operands, 1);
+
+        if (!BenchCheckHandwritten("elt", &Instance, &g_Script, Input, Input | 0x18))
+        {
+            return FALSE;
+        }
+
+        BenchSetCapabilities(&Instance, 0x01ff9efb & ~(1ull << 17));
+
+        if (!BenchCheckHandwritten("elt without egt", &Instance, &g_Script, Input, Input & ~0x8ull))
+        {
+            return FALSE;
+        }
+
+        BenchDefaultInstance(&Instance);
+    }
+
+    //
+    // The latency is the number of the stages minus one, and the stages only
+    // pass the pins until the last symbol of a script is configured
+    //
+    if (!BenchCreateModel(&Instance, &Model, &Buffer))
+    {
+        return FALSE;
+    }
+
+    Pins[0] = 0x12345678;
+
+    for (UINT32 i = 0; i < HwdbgModelGetLatency(&Model) + 1; i++)
+    {
+        HwdbgModelClock(&Model, i == 0 ? Pins : Model.ZeroPins, Output);
+
+        if (Output[0] != (i == HwdbgModelGetLatency(&Model) ? Pins[0] : 0))
+        {
+            printf("err, the latency of the model is not %u clocks\n", HwdbgModelGetLatency(&Model));
+            free(Buffer);
+            return FALSE;
+        }
+    }
+
+    Size = BenchWriteScriptBuffer(&Instance, &g_Script, g_Buffer);
+
+    if (HwdbgModelConfigureScript(&Model, g_Buffer, Size - 1) ||
+        HwdbgModelConfigureScript(&Model, g_Buffer, 2))
+    {
+        printf("err, a truncated script buffer is applied\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    //
+    // A script that ends in the middle of a stage is not applied
+    //
+    g_Buffer[0] -= 1;
+
+    BenchRun(&Model, Pins, Output);
+
+    if (HwdbgModelConfigureScript(&Model, g_Buffer, Size) || Model.StageConfigurationValid)
+    {
+        printf("err, a script that ends in the middle of a stage is applied\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    BenchRun(&Model, Pins, Output);
+
+    if (Output[0] != Pins[0])
+    {
+        printf("err, the pins are changed without a script\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    //
+    // Only the packets that configure the script buffer are received
+    //
+    free(Buffer);
+    g_Buffer[0] += 1;
+
+    BenchCreateModel(&Instance, &Model, &Buffer);
+    BenchWritePacket(&Instance, g_Buffer, Size, g_Bram);
+
+    g_Bram[offsetof(DEBUGGER_REMOTE_PACKET, RequestedActionOfThePacket)] = hwdbgActionSendInstanceInfo;
+
+    if (HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE))
+    {
+        printf("err, a packet of another action is received\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    BenchWritePacket(&Instance, g_Buffer, Size, g_Bram);
+    g_Bram[offsetof(DEBUGGER_REMOTE_PACKET, Indicator)] ^= 1;
+
+    if (HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE) || HwdbgModelReceivePacket(&Model, g_Bram, 16))
+    {
+        printf("err, an invalid packet is received\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    free(Buffer);
+
+    printf("handwritten: ports, pins, variables, jumps, and the capabilities are the same as the chip\n");
+
+    return TRUE;
+}
+
+/**
+ * @brief Generate a random instance with all of the capabilities
+ *
+ */
+static VOID
+BenchRandomInstance(PBENCH_INSTANCE Instance)
+{
+    UINT32 Remaining;
+
+    BenchDefaultInstance(Instance);
+    BenchSetCapabilities(Instance, 0x1ffffff);
+
+    Instance->Info.maximumNumberOfStages                    = 2 + (UINT32)(BenchRandom() % 64);
+    Instance->Info.scriptVariableLength                     = g_Lengths[BenchRandom() % (sizeof(g_Lengths) / sizeof(g_Lengths[0]))];
+    Instance->Info.bramDataWidth                            = Instance->Info.scriptVariableLength <= 32 && BenchRandom() % 2 ? 32 : 64;
+    Instance->Info.numberOfPins                             = 1 + (UINT32)(BenchRandom() % BENCH_MAXIMUM_PINS);
+    Instance->Info.numberOfSupportedLocalAndGlobalVariables = 1 + (UINT32)(BenchRandom() % BENCH_MAXIMUM_VARIABLES);
+    Instance->Info.numberOfSupportedTemporaryVariables      = 1 + (UINT32)(BenchRandom() % BENCH_MAXIMUM_VARIABLES);
+    Instance->Info.numberOfPorts                            = 0;
+
+    //
+    // Some of the instances have more operands than the operators need
+    //
+    if (BenchRandom() % 4 == 0)
+    {
+        Instance->Info.maximumNumberOfSupportedGetScriptOperators = 3;
+        Instance->Info.maximumNumberOfSupportedSetScriptOperators = 2;
+    }
+
+    Remaining = Instance->Info.numberOfPins;
+
+    while (Remaining != 0 && Instance->Info.numberOfPorts < BENCH_MAXIMUM_PORTS && BenchRandom() % 4 != 0)
+    {
+        UINT32 Port = 1 + (UINT32)(BenchRandom() % (Remaining < 80 ? Remaining : 80));
+
+        Instance->Ports[Instance->Info.numberOfPorts++] = Port;
+        Remaining -= Port;
+    }
+}
+
+static HWDBG_SHORT_SYMBOL
+BenchRandomOperand(const BENCH_INSTANCE * Instance, BOOLEAN IsDestination)
+{
+    UINT64 Random = BenchRandom();
+    UINT32 Kind   = (UINT32)(Random % 5);
+
+    if (!IsDestination && Kind == 0)
+    {
+        return BenchSymbol(SYMBOL_NUM_TYPE, Random % 3 ? (Random >> 8) % 70 : BenchRandom());
+    }
+
+    switch (Kind)
+    {
+    case 1:
+        return BenchSymbol(SYMBOL_TEMP_TYPE, (Random >> 8) % Instance->Info.numberOfSupportedTemporaryVariables);
+
+    case 2:
+        return BenchSymbol(Random & 0x100 ? SYMBOL_GLOBAL_ID_TYPE : SYMBOL_LOCAL_ID_TYPE, (Random >> 9) % Instance->Info.numberOfSupportedLocalAndGlobalVariables);
+
+    case 3:
+
+        //
+        // A port (rarely a register that is not a port)
+        //
+        if (Instance->Info.numberOfPorts != 0 || (IsDestination && (Random >> 8) % 64 == 0))
+        {
+            return BenchSymbol(SYMBOL_REGISTER_TYPE, Instance->Info.numberOfPins + (Random >> 14) % (Instance->Info.numberOfPorts + ((Random >> 8) % 64 == 0)));
+        }
+
+        return BenchSymbol(SYMBOL_REGISTER_TYPE, (Random >> 8) % Instance->Info.numberOfPins);
+
+    default:
+        return BenchSymbol(SYMBOL_REGISTER_TYPE, (Random >> 8) % Instance->Info.numberOfPins);
+    }
+}
+
+/**
+ * @brief Generate a random script (the jumps are mostly forward, and a few
+ * operators are not supported by the chip)
+ *
+ */
+static VOID
+BenchRandomScript(const BENCH_INSTANCE * Instance, PBENCH_SCRIPT Script, UINT32 NumberOfStages)
+{
+    HWDBG_SHORT_SYMBOL Operands[3];
+
+    Script->NumberOfStages = 0;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        UINT64 Operator = g_Operators[BenchRandom() % (sizeof(g_Operators) / sizeof(g_Operators[0]))];
+
+        if (BenchRandom() % 40 == 0)
+        {
+            Operator = FUNC_INC;
+        }
+
+        Operands[0] = BenchRandomOperand(Instance, FALSE);
+        Operands[1] = BenchRandomOperand(Instance, FALSE);
+        Operands[2] = BenchRandomOperand(Instance, TRUE);
+
+        switch (Operator)
+        {
+        case FUNC_JMP:
+            BenchAddStage(Script, Operator, 1, Operands, 0);
+            break;
+
+        case FUNC_JZ:
+        case FUNC_JNZ:
+            BenchAddStage(Script, Operator, 2, Operands, 0);
+            break;
+
+        case FUNC_MOV:
+            Operands[1] = Operands[2];
+            BenchAddStage(Script, Operator, 1, Operands, 1);
+            break;
+
+        default:
+            BenchAddStage(Script, Operator, 2, Operands, 1);
+            break;
+        }
+
+        if (Operator == FUNC_JMP || Operator == FUNC_JZ || Operator == FUNC_JNZ)
+        {
+            Script->Stages[i].TargetStage = BenchRandom() % 10 == 0 ? (UINT32)(BenchRandom() % (i + 1))
+                                                                    : i + 1 + (UINT32)(BenchRandom() % (NumberOfStages - i));
+        }
+    }
+
+    BenchIndexScript(Script);
+}
+
+/**
+ * @brief Check random scripts on random instances against the reference
+ * interpreter, with a new input at each clock
+ *
+ */
+static BOOLEAN
+BenchTestRandom(void)
+{
+    static UINT64  Inputs[BENCH_RANDOM_INPUTS][BENCH_PIN_WORDS];
+    BENCH_INSTANCE Instance;
+    HWDBG_MODEL    Model;
+    PVOID          Buffer;
+    UINT64         Output[BENCH_PIN_WORDS];
+    UINT64         Expected[BENCH_PIN_WORDS];
+    UINT64         Clocks = 0;
+    SIZE_T         Size;
+
+    for (UINT32 Round = 0; Round < BENCH_RANDOM_SCRIPTS; Round++)
+    {
+        UINT32  Latency;
+        BOOLEAN Applied;
+
+        BenchRandomInstance(&Instance);
+
+        if (!BenchCreateModel(&Instance, &Model, &Buffer))
+        {
+            return FALSE;
+        }
+
+        //
+        // Up to all of the stages (the last two configured stages are never
+        // evaluated)
+        //
+        BenchRandomScript(&Instance, &g_Script, 1 + (UINT32)(BenchRandom() % Instance.Info.maximumNumberOfStages));
+
+        memset(Inputs, 0, sizeof(Inputs));
+
+        for (UINT32 i = 0; i < BENCH_RANDOM_INPUTS; i++)
+        {
+            for (UINT32 j = 0; j < Instance.Info.numberOfPins; j += 64)
+            {
+                Inputs[i][j / 64] = BenchRandom() & BenchMask(Instance.Info.numberOfPins - j);
+            }
+        }
+
+        //
+        // Some inputs before the script are in the stages while the script is
+        // configured
+        //
+        for (UINT32 i = 0; i < BENCH_RANDOM_INPUTS / 2; i++)
+        {
+            HwdbgModelClock(&Model, Inputs[i], NULL);
+        }
+
+        Size = BenchWriteScriptBuffer(&Instance, &g_Script, g_Buffer);
+
+        //
+        // The packets that fit into the area of the debugger are received the
+        // same way as the chip
+        //
+        if (Instance.Info.bramDataWidth == 32 && Round % 2 == 0 &&
+            sizeof(DEBUGGER_REMOTE_PACKET) + Size <= Instance.Info.debuggeeAreaOffset)
+        {
+            BenchWritePacket(&Instance, g_Buffer, Size, g_Bram);
+            Applied = HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE);
+        }
+        else
+        {
+            Applied = HwdbgModelConfigureScript(&Model, g_Buffer, Size);
+        }
+
+        if (!Applied)
+        {
+            printf("err, a random script is not applied\n");
+            BenchPrintScript(&Instance, &g_Script);
+            free(Buffer);
+            return FALSE;
+        }
+
+        Latency = HwdbgModelGetLatency(&Model);
+
+        for (UINT32 Clock = 0; Clock < BENCH_RANDOM_INPUTS + Latency; Clock++)
+        {
+            HwdbgModelClock(&Model, Inputs[Clock % BENCH_RANDOM_INPUTS], Output);
+            Clocks++;
+
+            if (Clock < Latency)
+            {
+                continue;
+            }
+
+            BenchInterpret(&Instance, &g_Script, Inputs[Clock - Latency], Expected);
+
+            if (memcmp(Output, Expected, Model.NumberOfPinWords * sizeof(UINT64)) != 0)
+            {
+                printf("err, the output of input %u differs (model %llx, interpreter %llx)\n",
+                       Clock - Latency,
+                       (unsigned long long)Output[0],
+                       (unsigned long long)Expected[0]);
+                BenchPrintScript(&Instance, &g_Script);
+                free(Buffer);
+                return FALSE;
+            }
+        }
+
+        free(Buffer);
+    }
+
+    printf("random:      %u scripts on random instances give the same pins as the interpreter (%llu clocks)\n",
+           BENCH_RANDOM_SCRIPTS,
+           (unsigned long long)Clocks);
+
+    return TRUE;
+}
+
+/**
+ * @brief Print the latency and the speed of the model for instances with
+ * different number of stages
+ *
+ */
+static VOID
+BenchMeasure(void)
+{
+    static const UINT32 StageCounts[] = {8, 16, 32, 64, 128};
+    BENCH_INSTANCE      Instance;
+    HWDBG_MODEL         Model;
+    PVOID               Buffer;
+    UINT64              Pins[BENCH_PIN_WORDS] = {0};
+    UINT64              Output[BENCH_PIN_WORDS];
+    SIZE_T              Size;
+    double              Start, Time;
+
+    for (UINT32 i = 0; i < sizeof(StageCounts) / sizeof(StageCounts[0]); i++)
+    {
+        UINT64 Clocks = BENCH_MEASURE_STAGE_EVALS / StageCounts[i];
+
+        BenchDefaultInstance(&Instance);
+        BenchSetCapabilities(&Instance, 0x1ffffff);
+        Instance.Info.maximumNumberOfStages = StageCounts[i];
+
+        if (!BenchCreateModel(&Instance, &Model, &Buffer))
+        {
+            return;
+        }
+
+        BenchRandomScript(&Instance, &g_Script, StageCounts[i] - 2);
+        Size = BenchWriteScriptBuffer(&Instance, &g_Script, g_Buffer);
+        HwdbgModelConfigureScript(&Model, g_Buffer, Size);
+
+        Start = BenchNow();
+
+        for (UINT64 Clock = 0; Clock < Clocks; Clock++)
+        {
+            Pins[0] = Clock * 0x9e3779b97f4a7c15ull & 0xffffffff;
+            HwdbgModelClock(&Model, Pins, Output);
+        }
+
+        Time = BenchNow() - Start;
+
+        printf("stages %3u:  up to %3u script stages, latency %3u clocks (%.2f us at 100 MHz), %.2f M clocks/s of the model\n",
+               StageCounts[i],
+               StageCounts[i] - 2,
+               HwdbgModelGetLatency(&Model),
+               HwdbgModelGetLatency(&Model) / 100.0,
+               Clocks / Time / 1e6);
+
+        free(Buffer);
+    }
+}
+
+int
+main(void)
+{
+    if (!BenchTestCorpus() || !BenchTestHandwritten() || !BenchTestRandom())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("hwdbg model tests passed\n");
+
+    return 0;
+}
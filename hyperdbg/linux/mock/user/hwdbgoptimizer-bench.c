@@ -0,0 +1,788 @@
+/**
+ * @file hwdbgoptimizer-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the optimizer of the hwdbg script stages
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_VARIABLES        4
+#define BENCH_PINS             40
+#define BENCH_PORTS            2
+#define BENCH_PIN_WORDS        HWDBG_MODEL_PIN_WORDS(BENCH_PINS)
+#define BENCH_TEMPS            8
+#define BENCH_MAXIMUM_STAGES   48
+#define BENCH_MAXIMUM_SYMBOLS  (BENCH_MAXIMUM_STAGES * 4)
+#define BENCH_BRAM_SIZE        8192
+#define BENCH_RANDOM_SCRIPTS   20000
+#define BENCH_INPUTS           8
+#define BENCH_MEASURE_SCRIPTS  2000
+#define BENCH_MEASURE_REPEATS  20
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The output pins and the variables of the model of the chip for an
+ * input
+ *
+ */
+typedef struct _BENCH_OUTPUT
+{
+    UINT64 Pins[BENCH_PIN_WORDS];
+    UINT64 Variables[BENCH_VARIABLES];
+
+} BENCH_OUTPUT, *PBENCH_OUTPUT;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static HWDBG_OPTIMIZER_STAGE g_Stages[BENCH_MAXIMUM_STAGES];
+static BYTE                  g_Bram[BENCH_BRAM_SIZE];
+static const UINT32          g_Ports[BENCH_PORTS] = {12, 20}; // the first port is wider than some of the variables
+static const UINT32          g_Lengths[]          = {8, 13, 32, 64};
+static const UINT64          g_BinaryOperators[]  = {FUNC_OR, FUNC_XOR, FUNC_AND, FUNC_ASR, FUNC_ASL, FUNC_ADD, FUNC_SUB, FUNC_MUL, FUNC_DIV, FUNC_MOD, FUNC_GT, FUNC_LT, FUNC_EGT, FUNC_ELT, FUNC_EQUAL, FUNC_NEQ};
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static UINT64
+BenchMask(UINT32 Length)
+{
+    return Length >= 64 ? ~0ull : (1ull << Length) - 1;
+}
+
+static SYMBOL
+BenchSymbol(UINT64 Type, UINT64 Value)
+{
+    SYMBOL Symbol = {Type, 0, Value};
+
+    return Symbol;
+}
+
+/**
+ * @brief The instance of the model for a script (the stages and the temporary
+ * variables of the script, and the input and the output stages)
+ *
+ */
+static VOID
+BenchCreateInstance(PHWDBG_INSTANCE_INFORMATION Instance, UINT32 Length, UINT32 NumberOfStages, UINT32 NumberOfTemps)
+{
+    memset(Instance, 0, sizeof(HWDBG_INSTANCE_INFORMATION));
+
+    Instance->version                                    = 0x100;
+    Instance->maximumNumberOfStages                      = NumberOfStages + 2;
+    Instance->scriptVariableLength                       = Length;
+    Instance->numberOfSupportedLocalAndGlobalVariables   = BENCH_VARIABLES;
+    Instance->numberOfSupportedTemporaryVariables        = NumberOfTemps != 0 ? NumberOfTemps : 1;
+    Instance->maximumNumberOfSupportedGetScriptOperators = HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS;
+    Instance->maximumNumberOfSupportedSetScriptOperators = HWDBG_OPTIMIZER_MAXIMUM_SET_OPERANDS;
+    Instance->sharedMemorySize                           = BENCH_BRAM_SIZE;
+    Instance->debuggerAreaOffset                         = 0;
+    Instance->debuggeeAreaOffset                         = BENCH_BRAM_SIZE / 2;
+    Instance->numberOfPins                               = BENCH_PINS;
+    Instance->numberOfPorts                              = BENCH_PORTS;
+    Instance->bramAddrWidth                              = 13;
+    Instance->bramDataWidth                              = Length > 32 ? 64 : 32;
+
+    //
+    // All of the operators and the operands are supported
+    //
+    memset(&Instance->scriptCapabilities, 0xff, sizeof(Instance->scriptCapabilities));
+}
+
+static VOID
+BenchWriteChunk(BYTE * Buffer, SIZE_T * Offset, UINT64 Value, UINT32 BramDataWidth)
+{
+    for (UINT32 i = 0; i < (BramDataWidth + 7) / 8; i++)
+    {
+        Buffer[(*Offset)++] = (BYTE)(Value >> (i * 8));
+    }
+}
+
+/**
+ * @brief Write the packet of a script into the BRAM, the same way as
+ * HwdbgScriptCompressScriptBuffer (each stage with its empty operands, each
+ * field in a chunk of the width of the BRAM) and HwdbgInterpreterSendPacketAndBufferToHwdbg
+ *
+ */
+static VOID
+BenchWritePacket(const HWDBG_INSTANCE_INFORMATION * Instance, const SYMBOL * Symbols, UINT32 NumberOfSymbols, BYTE * Bram)
+{
+    DEBUGGER_REMOTE_PACKET Packet;
+    UINT32                 NumberOfStages = HwdbgOptimizerCountStages(Symbols, NumberOfSymbols);
+    UINT32                 Index          = 0;
+    SIZE_T                 Offset         = 0;
+
+    memset(&Packet, 0, sizeof(Packet));
+    memset(Bram, 0, BENCH_BRAM_SIZE);
+
+    Packet.Indicator                  = INDICATOR_OF_HYPERDBG_PACKET;
+    Packet.TypeOfThePacket            = DEBUGGER_REMOTE_PACKET_TYPE_DEBUGGER_TO_DEBUGGEE_HARDWARE_LEVEL;
+    Packet.RequestedActionOfThePacket = (DEBUGGER_REMOTE_PACKET_REQUESTED_ACTION)hwdbgActionConfigureScriptBuffer;
+
+    memcpy(Bram + Instance->debuggerAreaOffset, &Packet, sizeof(Packet));
+
+    //
+    // The chip reads the buffer after the requested action (a read of the BRAM)
+    //
+    Offset = Instance->debuggerAreaOffset + offsetof(DEBUGGER_REMOTE_PACKET, RequestedActionOfThePacket) + Instance->bramDataWidth / 8;
+
+    BenchWriteChunk(Bram, &Offset, NumberOfStages * (1 + HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS + HWDBG_OPTIMIZER_MAXIMUM_SET_OPERANDS) - 1, Instance->bramDataWidth);
+
+    while (Index < NumberOfSymbols)
+    {
+        UINT32 NumberOfGetOperands = 0, NumberOfSetOperands = 0;
+
+        HwdbgOptimizerGetNumberOfOperands(Symbols[Index].Value, &NumberOfGetOperands, &NumberOfSetOperands);
+
+        BenchWriteChunk(Bram, &Offset, Symbols[Index].Type, Instance->bramDataWidth);
+        BenchWriteChunk(Bram, &Offset, Symbols[Index].Value, Instance->bramDataWidth);
+
+        for (UINT32 i = 0; i < HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS + HWDBG_OPTIMIZER_MAXIMUM_SET_OPERANDS; i++)
+        {
+            const SYMBOL * Operand = NULL;
+
+            if (i < HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS && i < NumberOfGetOperands)
+            {
+                Operand = &Symbols[Index + 1 + i];
+            }
+            else if (i >= HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS && i - HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS < NumberOfSetOperands)
+            {
+                Operand = &Symbols[Index + 1 + NumberOfGetOperands + i - HWDBG_OPTIMIZER_MAXIMUM_GET_OPERANDS];
+            }
+
+            BenchWriteChunk(Bram, &Offset, Operand != NULL ? Operand->Type : 0, Instance->bramDataWidth);
+            BenchWriteChunk(Bram, &Offset, Operand != NULL ? Operand->Value : 0, Instance->bramDataWidth);
+        }
+
+        Index += 1 + NumberOfGetOperands + NumberOfSetOperands;
+    }
+}
+
+/**
+ * @brief Run a script on the model of the chip (HwdbgModel, the same model
+ * as the simulation of the scripts) and get the output pins and the variables
+ * of the last stage for each input
+ *
+ */
+static BOOLEAN
+BenchExecute(const HWDBG_INSTANCE_INFORMATION * Instance,
+             const SYMBOL *                     Symbols,
+             UINT32                             NumberOfSymbols,
+             UINT64                             Inputs[BENCH_INPUTS][BENCH_PIN_WORDS],
+             BENCH_OUTPUT                       Outputs[BENCH_INPUTS])
+{
+    HWDBG_MODEL Model;
+    SIZE_T      BufferSize = HwdbgModelGetBufferSize(Instance);
+    PVOID       Buffer     = BufferSize ? malloc(BufferSize) : NULL;
+    UINT32      LastStage  = Instance->maximumNumberOfStages - 2;
+
+    if (Buffer == NULL || !HwdbgModelInitialize(&Model, Instance, g_Ports, Buffer, BufferSize))
+    {
+        printf("err, unable to initialize the model\n");
+        free(Buffer);
+        return FALSE;
+    }
+
+    //
+    // An empty script is not sent (the stages of the chip only pass the pins)
+    //
+    if (NumberOfSymbols != 0)
+    {
+        BenchWritePacket(Instance, Symbols, NumberOfSymbols, g_Bram);
+
+        if (!HwdbgModelReceivePacket(&Model, g_Bram, BENCH_BRAM_SIZE))
+        {
+            printf("err, the script is not applied to the model\n");
+            free(Buffer);
+            return FALSE;
+        }
+    }
+
+    for (UINT32 i = 0; i < BENCH_INPUTS; i++)
+    {
+        for (UINT32 j = 0; j < HwdbgModelGetLatency(&Model); j++)
+        {
+            HwdbgModelClock(&Model, Inputs[i], NULL);
+        }
+
+        HwdbgModelClock(&Model, Inputs[i], Outputs[i].Pins);
+
+        memcpy(Outputs[i].Variables, Model.Stages[LastStage].LocalGlobalVariables, sizeof(Outputs[i].Variables));
+    }
+
+    free(Buffer);
+
+    return TRUE;
+}
+
+/**
+ * @brief Print the stages of a script (used once a check fails)
+ *
+ */
+static VOID
+BenchPrintScript(const char * Name, const SYMBOL * Symbols, UINT32 NumberOfSymbols)
+{
+    UINT32 Index = 0;
+
+    printf("%s:\n", Name);
+
+    while (Index < NumberOfSymbols)
+    {
+        UINT32 NumberOfGetOperands = 0, NumberOfSetOperands = 0;
+
+        HwdbgOptimizerGetNumberOfOperands(Symbols[Index].Value, &NumberOfGetOperands, &NumberOfSetOperands);
+
+        printf("  %3u: %2llu", Index, (unsigned long long)Symbols[Index].Value);
+
+        for (UINT32 i = 1; i <= NumberOfGetOperands + NumberOfSetOperands && Index + i < NumberOfSymbols; i++)
+        {
+            printf(" %llu:%llx", (unsigned long long)Symbols[Index + i].Type, (unsigned long long)Symbols[Index + i].Value);
+        }
+
+        printf("\n");
+
+        Index += 1 + NumberOfGetOperands + NumberOfSetOperands;
+    }
+}
+
+/**
+ * @brief A random pin, port, or a register that is not a port (the ports are
+ * the registers after the pins)
+ *
+ */
+static SYMBOL
+BenchRandomRegister(void)
+{
+    UINT32 Kind = (UINT32)(BenchRandom() % 8);
+
+    if (Kind < 3)
+    {
+        return BenchSymbol(SYMBOL_REGISTER_TYPE, BenchRandom() % 4);
+    }
+    else if (Kind < 7)
+    {
+        return BenchSymbol(SYMBOL_REGISTER_TYPE, BENCH_PINS + BenchRandom() % BENCH_PORTS);
+    }
+    else
+    {
+        return BenchSymbol(SYMBOL_REGISTER_TYPE, BENCH_PINS + BENCH_PORTS);
+    }
+}
+
+static SYMBOL
+BenchRandomOperand(BOOLEAN IsDestination, UINT32 NumberOfTemps)
+{
+    UINT32 Kind = (UINT32)(BenchRandom() % (IsDestination ? 10 : 12));
+
+    if (Kind < 5)
+    {
+        return BenchSymbol(SYMBOL_TEMP_TYPE, BenchRandom() % NumberOfTemps);
+    }
+    else if (Kind < 7)
+    {
+        return BenchSymbol(BenchRandom() % 2 ? SYMBOL_GLOBAL_ID_TYPE : SYMBOL_LOCAL_ID_TYPE, BenchRandom() % BENCH_VARIABLES);
+    }
+    else if (Kind < 10)
+    {
+        return BenchRandomRegister();
+    }
+    else
+    {
+        static const UINT64 Constants[] = {0, 1, 2, 3, 7, 0xff, 0x80000000, ~0ull};
+
+        return BenchSymbol(SYMBOL_NUM_TYPE, BenchRandom() % 3 ? Constants[BenchRandom() % 8] : BenchRandom());
+    }
+}
+
+/**
+ * @brief Write a stage and its operands
+ *
+ */
+static VOID
+BenchAddStage(SYMBOL * Symbols, UINT32 * Index, UINT64 Operator, const SYMBOL * Operands, UINT32 NumberOfOperands)
+{
+    Symbols[(*Index)++] = BenchSymbol(SYMBOL_SEMANTIC_RULE_TYPE, Operator);
+
+    for (UINT32 i = 0; i < NumberOfOperands; i++)
+    {
+        Symbols[(*Index)++] = Operands[i];
+    }
+}
+
+/**
+ * @brief Generate a random script (random operators, operands, and jumps to the
+ * later stages, the end, the previous stages and the middle of the stages)
+ *
+ */
+static UINT32
+BenchGenerateRandomScript(SYMBOL * Symbols, UINT32 NumberOfStages)
+{
+    UINT32 Starts[BENCH_MAXIMUM_STAGES + 1];
+    UINT32 Index = 0;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        UINT32 Kind = (UINT32)(BenchRandom() % 20);
+        SYMBOL Operands[3];
+
+        Starts[i] = Index;
+
+        if (Kind < 9)
+        {
+            Operands[0] = BenchRandomOperand(FALSE, BENCH_TEMPS);
+            Operands[1] = BenchRandomOperand(FALSE, BENCH_TEMPS);
+            Operands[2] = BenchRandomOperand(TRUE, BENCH_TEMPS);
+
+            BenchAddStage(Symbols, &Index, g_BinaryOperators[BenchRandom() % 16], Operands, 3);
+        }
+        else if (Kind < 15)
+        {
+            Operands[0] = BenchRandomOperand(FALSE, BENCH_TEMPS);
+            Operands[1] = BenchRandomOperand(TRUE, BENCH_TEMPS);
+
+            BenchAddStage(Symbols, &Index, FUNC_MOV, Operands, 2);
+        }
+        else if (Kind < 18)
+        {
+            Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0); // the target is set later
+            Operands[1] = BenchRandomOperand(FALSE, BENCH_TEMPS);
+
+            BenchAddStage(Symbols, &Index, BenchRandom() % 2 ? FUNC_JZ : FUNC_JNZ, Operands, 2);
+        }
+        else
+        {
+            Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+
+            BenchAddStage(Symbols, &Index, FUNC_JMP, Operands, 1);
+        }
+    }
+
+    Starts[NumberOfStages] = Index;
+
+    for (UINT32 i = 0; i < NumberOfStages; i++)
+    {
+        UINT64 Operator = Symbols[Starts[i]].Value;
+        UINT32 Kind     = (UINT32)(BenchRandom() % 16);
+
+        if (Operator != FUNC_JMP && Operator != FUNC_JZ && Operator != FUNC_JNZ)
+        {
+            continue;
+        }
+
+        if (Kind == 0)
+        {
+            Symbols[Starts[i] + 1].Value = Starts[BenchRandom() % (i + 1)]; // a previous stage (or itself)
+        }
+        else if (Kind == 1)
+        {
+            Symbols[Starts[i] + 1].Value = Starts[i] + 1 + BenchRandom() % (Index - Starts[i]); // maybe an operand
+        }
+        else
+        {
+            Symbols[Starts[i] + 1].Value = Starts[i + 1 + BenchRandom() % (NumberOfStages - i)];
+        }
+    }
+
+    return Index;
+}
+
+/**
+ * @brief Generate a script like the script engine (each statement computes into
+ * new temporary variables and moves the result to a variable or a pin, and the
+ * conditions are jumps over the blocks)
+ *
+ */
+static UINT32
+BenchGenerateEngineScript(SYMBOL * Symbols, UINT32 NumberOfStatements)
+{
+    UINT32 Index     = 0;
+    UINT32 NextTemp  = 0;
+    UINT32 JumpStart = 0;
+    UINT32 OpenJump  = 0;
+
+    for (UINT32 i = 0; i < NumberOfStatements && Index + 16 < BENCH_MAXIMUM_SYMBOLS; i++)
+    {
+        SYMBOL Operands[3];
+        SYMBOL Value = BenchRandomOperand(FALSE, 1);
+
+        if (Value.Type == SYMBOL_TEMP_TYPE)
+        {
+            Value = BenchSymbol(SYMBOL_NUM_TYPE, BenchRandom() % 10);
+        }
+
+        //
+        // An expression with one or two operators (the script engine gives a
+        // new temporary variable to each operator)
+        //
+        for (UINT32 j = 0; j < 1 + BenchRandom() % 2; j++)
+        {
+            Operands[0] = Value;
+            Operands[1] = BenchRandom() % 2 ? BenchSymbol(SYMBOL_NUM_TYPE, BenchRandom() % 4) : BenchRandomRegister();
+            Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, NextTemp++ % HWDBG_OPTIMIZER_MAXIMUM_TEMPORARY_VARIABLES);
+
+            BenchAddStage(Symbols, &Index, g_BinaryOperators[BenchRandom() % 16], Operands, 3);
+
+            Value = Operands[2];
+        }
+
+        if (OpenJump == 0 && BenchRandom() % 3 == 0)
+        {
+            //
+            // if (expression) { ... }
+            //
+            Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+            Operands[1] = Value;
+            JumpStart   = Index;
+            OpenJump    = 1 + (UINT32)(BenchRandom() % 3);
+
+            BenchAddStage(Symbols, &Index, FUNC_JZ, Operands, 2);
+            continue;
+        }
+
+        Operands[0] = Value;
+        Operands[1] = BenchRandom() % 2 ? BenchSymbol(SYMBOL_LOCAL_ID_TYPE, BenchRandom() % BENCH_VARIABLES) : BenchRandomRegister();
+
+        BenchAddStage(Symbols, &Index, FUNC_MOV, Operands, 2);
+
+        if (OpenJump != 0 && --OpenJump == 0)
+        {
+            Symbols[JumpStart + 1].Value = Index;
+        }
+    }
+
+    if (OpenJump != 0)
+    {
+        Symbols[JumpStart + 1].Value = Index;
+    }
+
+    return Index;
+}
+
+/**
+ * @brief Optimize a script and check that it gives the same output pins and
+ * variables as the original script on the model of the chip for random inputs
+ *
+ */
+static BOOLEAN
+BenchCheckScript(const SYMBOL * Symbols, UINT32 NumberOfSymbols, UINT32 Length, PHWDBG_OPTIMIZER_RESULT Result)
+{
+    SYMBOL                     Optimized[BENCH_MAXIMUM_SYMBOLS];
+    SYMBOL                     Again[BENCH_MAXIMUM_SYMBOLS];
+    UINT32                     NumberOfOptimizedSymbols, NumberOfAgainSymbols;
+    HWDBG_OPTIMIZER_RESULT     AgainResult;
+    HWDBG_INSTANCE_INFORMATION Instance;
+    UINT64                     Inputs[BENCH_INPUTS][BENCH_PIN_WORDS];
+    BENCH_OUTPUT               Expected[BENCH_INPUTS], Actual[BENCH_INPUTS];
+
+    memcpy(Optimized, Symbols, NumberOfSymbols * sizeof(SYMBOL));
+
+    if (!HwdbgOptimizerOptimizeScript(Optimized, NumberOfSymbols, Length, g_Stages, BENCH_MAXIMUM_STAGES, &NumberOfOptimizedSymbols, Result))
+    {
+        printf("err, a script is not optimized\n");
+        return FALSE;
+    }
+
+    if (NumberOfOptimizedSymbols > NumberOfSymbols ||
+        Result->NumberOfStagesAfter > Result->NumberOfStagesBefore ||
+        Result->NumberOfStagesAfter != HwdbgOptimizerCountStages(Optimized, NumberOfOptimizedSymbols) ||
+        Result->NumberOfTemporaryVariablesAfter > Result->NumberOfTemporaryVariablesBefore)
+    {
+        printf("err, the optimized script is larger (%u -> %u stages, %u -> %u temps)\n",
+               Result->NumberOfStagesBefore,
+               Result->NumberOfStagesAfter,
+               Result->NumberOfTemporaryVariablesBefore,
+               Result->NumberOfTemporaryVariablesAfter);
+        return FALSE;
+    }
+
+    //
+    // The optimized script runs on the same instance (its stages and temporary
+    // variables are not more than the original script)
+    //
+    BenchCreateInstance(&Instance, Length, Result->NumberOfStagesBefore, Result->NumberOfTemporaryVariablesBefore);
+
+    for (UINT32 i = 0; i < BENCH_INPUTS; i++)
+    {
+        for (UINT32 j = 0; j < BENCH_PIN_WORDS; j++)
+        {
+            Inputs[i][j] = i == 0 ? 0 : BenchRandom() % (i < 4 ? 4 : ~0ull) & BenchMask(BENCH_PINS - j * 64);
+        }
+    }
+
+    if (!BenchExecute(&Instance, Symbols, NumberOfSymbols, Inputs, Expected) ||
+        !BenchExecute(&Instance, Optimized, NumberOfOptimizedSymbols, Inputs, Actual))
+    {
+        BenchPrintScript("original", Symbols, NumberOfSymbols);
+        BenchPrintScript("optimized", Optimized, NumberOfOptimizedSymbols);
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_INPUTS; i++)
+    {
+        if (memcmp(&Expected[i], &Actual[i], sizeof(BENCH_OUTPUT)) != 0)
+        {
+            printf("err, the optimized script (%u -> %u stages) gives other results with %u-bit variables (input %llx)\n",
+                   Result->NumberOfStagesBefore,
+                   Result->NumberOfStagesAfter,
+                   Length,
+                   (unsigned long long)Inputs[i][0]);
+
+            BenchPrintScript("original", Symbols, NumberOfSymbols);
+            BenchPrintScript("optimized", Optimized, NumberOfOptimizedSymbols);
+            return FALSE;
+        }
+    }
+
+    //
+    // An optimized script is not changed again
+    //
+    memcpy(Again, Optimized, NumberOfOptimizedSymbols * sizeof(SYMBOL));
+
+    if (!HwdbgOptimizerOptimizeScript(Again, NumberOfOptimizedSymbols, Length, g_Stages, BENCH_MAXIMUM_STAGES, &NumberOfAgainSymbols, &AgainResult) ||
+        AgainResult.NumberOfStagesAfter != Result->NumberOfStagesAfter)
+    {
+        printf("err, an optimized script is optimized again (%u -> %u stages)\n",
+               Result->NumberOfStagesAfter,
+               AgainResult.NumberOfStagesAfter);
+
+        BenchPrintScript("original", Symbols, NumberOfSymbols);
+        BenchPrintScript("optimized", Optimized, NumberOfOptimizedSymbols);
+        BenchPrintScript("optimized again", Again, NumberOfAgainSymbols);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check a handwritten script and the scripts that are not supported
+ *
+ */
+static BOOLEAN
+BenchTestHandwritten(void)
+{
+    SYMBOL                 Symbols[BENCH_MAXIMUM_SYMBOLS];
+    SYMBOL                 Copy[BENCH_MAXIMUM_SYMBOLS];
+    SYMBOL                 Operands[3];
+    UINT32                 Index = 0, ElseJump, EndJump, NewNumberOfSymbols;
+    HWDBG_OPTIMIZER_RESULT Result;
+
+    //
+    // if (@hw_pin0 == 1) { x = @hw_pin1 + 2 * 3; } else { @hw_pin2 = x + 0; }
+    //
+    Operands[0] = BenchSymbol(SYMBOL_REGISTER_TYPE, 0);
+    Operands[1] = BenchSymbol(SYMBOL_NUM_TYPE, 1);
+    Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, 0);
+    BenchAddStage(Symbols, &Index, FUNC_EQUAL, Operands, 3);
+
+    ElseJump    = Index;
+    Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+    Operands[1] = BenchSymbol(SYMBOL_TEMP_TYPE, 0);
+    BenchAddStage(Symbols, &Index, FUNC_JZ, Operands, 2);
+
+    Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 2);
+    Operands[1] = BenchSymbol(SYMBOL_NUM_TYPE, 3);
+    Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, 1);
+    BenchAddStage(Symbols, &Index, FUNC_MUL, Operands, 3);
+
+    Operands[0] = BenchSymbol(SYMBOL_REGISTER_TYPE, 1);
+    Operands[1] = BenchSymbol(SYMBOL_TEMP_TYPE, 1);
+    Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, 2);
+    BenchAddStage(Symbols, &Index, FUNC_ADD, Operands, 3);
+
+    Operands[0] = BenchSymbol(SYMBOL_TEMP_TYPE, 2);
+    Operands[1] = BenchSymbol(SYMBOL_LOCAL_ID_TYPE, 0);
+    BenchAddStage(Symbols, &Index, FUNC_MOV, Operands, 2);
+
+    EndJump     = Index;
+    Operands[0] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+    BenchAddStage(Symbols, &Index, FUNC_JMP, Operands, 1);
+
+    Symbols[ElseJump + 1].Value = Index;
+
+    Operands[0] = BenchSymbol(SYMBOL_LOCAL_ID_TYPE, 0);
+    Operands[1] = BenchSymbol(SYMBOL_NUM_TYPE, 0);
+    Operands[2] = BenchSymbol(SYMBOL_TEMP_TYPE, 3);
+    BenchAddStage(Symbols, &Index, FUNC_ADD, Operands, 3);
+
+    Operands[0] = BenchSymbol(SYMBOL_TEMP_TYPE, 3);
+    Operands[1] = BenchSymbol(SYMBOL_REGISTER_TYPE, 2);
+    BenchAddStage(Symbols, &Index, FUNC_MOV, Operands, 2);
+
+    Symbols[EndJump + 1].Value = Index;
+
+    if (!BenchCheckScript(Symbols, Index, 32, &Result))
+    {
+        return FALSE;
+    }
+
+    //
+    // The multiplication is folded into the addition, the additions write
+    // directly into the variable and the pin, and a single temporary variable
+    // is used for the condition
+    //
+    if (Result.NumberOfStagesBefore != 8 || Result.NumberOfStagesAfter != 5 ||
+        Result.NumberOfTemporaryVariablesBefore != 4 || Result.NumberOfTemporaryVariablesAfter != 1)
+    {
+        printf("err, the handwritten script is optimized to %u stages and %u temps\n",
+               Result.NumberOfStagesAfter,
+               Result.NumberOfTemporaryVariablesAfter);
+        return FALSE;
+    }
+
+    printf("handwritten: %u -> %u stages (%u folded, %u forwarded, %u removed), %u -> %u temps\n",
+           Result.NumberOfStagesBefore,
+           Result.NumberOfStagesAfter,
+           Result.NumberOfFoldedStages,
+           Result.NumberOfForwardedStages,
+           Result.NumberOfRemovedStages,
+           Result.NumberOfTemporaryVariablesBefore,
+           Result.NumberOfTemporaryVariablesAfter);
+
+    //
+    // The scripts with other operators (or operands) are not changed
+    //
+    memcpy(Copy, Symbols, Index * sizeof(SYMBOL));
+    Copy[0].Value = FUNC_PRINTF;
+
+    if (HwdbgOptimizerOptimizeScript(Copy, Index, 32, g_Stages, BENCH_MAXIMUM_STAGES, &NewNumberOfSymbols, &Result) ||
+        Copy[0].Value != FUNC_PRINTF || memcmp(&Copy[1], &Symbols[1], (Index - 1) * sizeof(SYMBOL)) != 0)
+    {
+        printf("err, a script with an unsupported operator is changed\n");
+        return FALSE;
+    }
+
+    memcpy(Copy, Symbols, Index * sizeof(SYMBOL));
+    Copy[1].Type = SYMBOL_STRING_TYPE;
+
+    if (HwdbgOptimizerOptimizeScript(Copy, Index, 32, g_Stages, BENCH_MAXIMUM_STAGES, &NewNumberOfSymbols, &Result) ||
+        HwdbgOptimizerOptimizeScript(Symbols, Index - 1, 32, g_Stages, BENCH_MAXIMUM_STAGES, &NewNumberOfSymbols, &Result) ||
+        HwdbgOptimizerOptimizeScript(Symbols, Index, 32, g_Stages, 4, &NewNumberOfSymbols, &Result))
+    {
+        printf("err, an unsupported or truncated script is optimized\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check random scripts and scripts like the ones of the script engine
+ *
+ */
+static BOOLEAN
+BenchTestRandom(void)
+{
+    SYMBOL                 Symbols[BENCH_MAXIMUM_SYMBOLS];
+    HWDBG_OPTIMIZER_RESULT Result;
+    UINT64                 StagesBefore = 0, StagesAfter = 0;
+
+    for (UINT32 i = 0; i < BENCH_RANDOM_SCRIPTS; i++)
+    {
+        UINT32 Length = g_Lengths[i % (sizeof(g_Lengths) / sizeof(g_Lengths[0]))];
+        UINT32 NumberOfSymbols;
+
+        if (i % 2 == 0)
+        {
+            NumberOfSymbols = BenchGenerateRandomScript(Symbols, 1 + (UINT32)(BenchRandom() % BENCH_MAXIMUM_STAGES));
+        }
+        else
+        {
+            NumberOfSymbols = BenchGenerateEngineScript(Symbols, 1 + (UINT32)(BenchRandom() % 16));
+        }
+
+        if (!BenchCheckScript(Symbols, NumberOfSymbols, Length, &Result))
+        {
+            return FALSE;
+        }
+
+        StagesBefore += Result.NumberOfStagesBefore;
+        StagesAfter += Result.NumberOfStagesAfter;
+    }
+
+    printf("random:      %u scripts give the same results (%llu -> %llu stages)\n",
+           BENCH_RANDOM_SCRIPTS,
+           (unsigned long long)StagesBefore,
+           (unsigned long long)StagesAfter);
+
+    return TRUE;
+}
+
+/**
+ * @brief Print the stages and the temporary variables of the scripts like the
+ * ones of the script engine before and after the optimization
+ *
+ */
+static VOID
+BenchMeasure(void)
+{
+    static SYMBOL          Scripts[BENCH_MEASURE_SCRIPTS][BENCH_MAXIMUM_SYMBOLS];
+    static UINT32          Sizes[BENCH_MEASURE_SCRIPTS];
+    SYMBOL                 Copy[BENCH_MAXIMUM_SYMBOLS];
+    HWDBG_OPTIMIZER_RESULT Result;
+    UINT64                 StagesBefore = 0, StagesAfter = 0, TempsBefore = 0, TempsAfter = 0;
+    UINT32                 NewNumberOfSymbols;
+    double                 Start, Time;
+
+    for (UINT32 i = 0; i < BENCH_MEASURE_SCRIPTS; i++)
+    {
+        Sizes[i] = BenchGenerateEngineScript(Scripts[i], 4 + (UINT32)(BenchRandom() % 8));
+    }
+
+    Start = BenchNow();
+
+    for (UINT32 Repeat = 0; Repeat < BENCH_MEASURE_REPEATS; Repeat++)
+    {
+        for (UINT32 i = 0; i < BENCH_MEASURE_SCRIPTS; i++)
+        {
+            memcpy(Copy, Scripts[i], Sizes[i] * sizeof(SYMBOL));
+            HwdbgOptimizerOptimizeScript(Copy, Sizes[i], 32, g_Stages, BENCH_MAXIMUM_STAGES, &NewNumberOfSymbols, &Result);
+
+            if (Repeat == 0)
+            {
+                StagesBefore += Result.NumberOfStagesBefore;
+                StagesAfter += Result.NumberOfStagesAfter;
+                TempsBefore += Result.NumberOfTemporaryVariablesBefore;
+                TempsAfter += Result.NumberOfTemporaryVariablesAfter;
+            }
+        }
+    }
+
+    Time = BenchNow() - Start;
+
+    printf("engine-like: %.2f -> %.2f stages, %.2f -> %.2f temps for each script, %.2f us for optimizing a script\n",
+           (double)StagesBefore / BENCH_MEASURE_SCRIPTS,
+           (double)StagesAfter / BENCH_MEASURE_SCRIPTS,
+           (double)TempsBefore / BENCH_MEASURE_SCRIPTS,
+           (double)TempsAfter / BENCH_MEASURE_SCRIPTS,
+           Time * 1e6 / (BENCH_MEASURE_SCRIPTS * BENCH_MEASURE_REPEATS));
+}
+
+int
+main(void)
+{
+    if (!BenchTestHandwritten() || !BenchTestRandom())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("hwdbg optimizer tests passed\n");
+
+    return 0;
+}
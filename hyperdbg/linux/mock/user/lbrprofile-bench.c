@@ -0,0 +1,1242 @@
+/**
+ * @file lbrprofile-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the LBR profiles (and viewer of the samples)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_IMAGE_BASE       0xfffff80012340000ull
+#define BENCH_FUNCTIONS        32
+#define BENCH_FUNCTION_STRIDE  0x400
+#define BENCH_FUNCTION_SIZE    0x300
+#define BENCH_MAXIMUM_DEPTH    12
+#define BENCH_SAMPLES          6000
+#define BENCH_EDGE_TABLE_SIZE  0x8000
+#define BENCH_CHAIN_TABLE_SIZE 0x4000
+#define BENCH_MEASURE_SAMPLES  20000
+#define BENCH_MEASURE_ROUNDS   20
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief An active call of the simulated program
+ *
+ */
+typedef struct _BENCH_FRAME
+{
+    UINT32 Function;
+    UINT64 ReturnAddress;
+    UINT64 Sequence; // sequence of the call branch
+
+} BENCH_FRAME, *PBENCH_FRAME;
+
+/**
+ * @brief A simulated program that executes branches on a core
+ *
+ * @details The last branches are kept the same way as the LBR, so a snapshot
+ * of them is a sample that the hypertrace would save
+ *
+ */
+typedef struct _BENCH_PROGRAM
+{
+    UINT64             RandomState;
+    BOOLEAN            ArchBasedLbr;
+    UINT64             Sequence; // count of the executed branches
+    LBR_PROFILE_BRANCH History[MAXIMUM_LBR_CAPACITY];
+    BENCH_FRAME        Stack[BENCH_MAXIMUM_DEPTH];
+    UINT32             Depth;
+
+} BENCH_PROGRAM, *PBENCH_PROGRAM;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static const UINT32 g_Capacities[] = {4, 8, 16, 32};
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static UINT64
+BenchFunctionStart(UINT32 Function)
+{
+    return BENCH_IMAGE_BASE + (UINT64)Function * BENCH_FUNCTION_STRIDE;
+}
+
+/**
+ * @brief Execute a branch of the program
+ *
+ * @details Each source slot of a function has a single type of branch (so the
+ * type of an edge doesn't depend on the sample), the calls go to the start of
+ * the functions and the returns go after the calls
+ *
+ */
+static void
+BenchStep(PBENCH_PROGRAM Program)
+{
+    LBR_PROFILE_BRANCH * Branch   = &Program->History[Program->Sequence % MAXIMUM_LBR_CAPACITY];
+    UINT32               Current  = Program->Depth != 0 ? Program->Stack[Program->Depth - 1].Function : 0;
+    UINT64               Start    = BenchFunctionStart(Current);
+    UINT32               Decision = (UINT32)(BenchRandomFrom(&Program->RandomState) % 100);
+    UINT32               Slot;
+    UINT32               Type;
+
+    if (Program->Depth != 0 && Decision < 20)
+    {
+        Slot = 14 + (UINT32)(BenchRandomFrom(&Program->RandomState) % 2);
+        Type = LBR_BR_TYPE_RET;
+
+        Branch->From = Start + 0x20 + 0x10 * Slot;
+        Branch->To   = Program->Stack[--Program->Depth].ReturnAddress;
+    }
+    else if (Program->Depth < BENCH_MAXIMUM_DEPTH && Decision < 45)
+    {
+        PBENCH_FRAME Frame = &Program->Stack[Program->Depth++];
+
+        Slot = 11 + (UINT32)(BenchRandomFrom(&Program->RandomState) % 3);
+        Type = Slot == 13 ? LBR_BR_TYPE_CALL_INDIRECT : LBR_BR_TYPE_CALL_DIRECT;
+
+        Frame->Function      = (UINT32)(BenchRandomFrom(&Program->RandomState) % BENCH_FUNCTIONS);
+        Frame->ReturnAddress = Start + 0x20 + 0x10 * Slot + 5;
+        Frame->Sequence      = Program->Sequence;
+
+        Branch->From = Start + 0x20 + 0x10 * Slot;
+        Branch->To   = BenchFunctionStart(Frame->Function);
+    }
+    else
+    {
+        Slot = (UINT32)(BenchRandomFrom(&Program->RandomState) % 11);
+        Type = Slot < 8 ? LBR_BR_TYPE_COND : (Slot < 10 ? LBR_BR_TYPE_JMP_DIRECT : LBR_BR_TYPE_JMP_INDIRECT);
+
+        Branch->From = Start + 0x20 + 0x10 * Slot;
+        Branch->To   = Start + 0x100 + 0x10 * (BenchRandomFrom(&Program->RandomState) % 8);
+    }
+
+    Branch->Mispredicted = BenchRandomFrom(&Program->RandomState) % 10 == 0;
+
+    if (Program->ArchBasedLbr)
+    {
+        Branch->BranchType  = Type;
+        Branch->Cycles      = (UINT32)(BenchRandomFrom(&Program->RandomState) % 2000) + 1;
+        Branch->CyclesValid = BenchRandomFrom(&Program->RandomState) % 10 != 0;
+    }
+    else
+    {
+        //
+        // The legacy LBR has no type, and zero cycles are not valid
+        //
+        Branch->BranchType  = LBR_PROFILE_UNKNOWN_BRANCH_TYPE;
+        Branch->Cycles      = BenchRandomFrom(&Program->RandomState) % 10 == 0 ? 0 : (UINT32)(BenchRandomFrom(&Program->RandomState) % 2000) + 1;
+        Branch->CyclesValid = Branch->Cycles != 0;
+    }
+
+    Program->Sequence++;
+}
+
+/**
+ * @brief Take a sample of the last branches in the layout of the MSRs
+ *
+ * @param Program
+ * @param Capacity Entries of the LBR
+ * @param Sample The sample is written here
+ * @param Expected The branches in the order of the execution
+ * @param NumberOfExpected
+ * @param Frames The expected call chain (the innermost first)
+ * @param Depth
+ *
+ * @return UINT32 Size of the sample
+ */
+static UINT32
+BenchSnapshot(PBENCH_PROGRAM       Program,
+              UINT32               Capacity,
+              BYTE *               Sample,
+              LBR_PROFILE_BRANCH * Expected,
+              UINT32 *             NumberOfExpected,
+              UINT64 *             Frames,
+              UINT32 *             Depth)
+{
+    LBR_SAMPLE_HEADER * Header  = (LBR_SAMPLE_HEADER *)Sample;
+    LBR_SAMPLE_ENTRY *  Entries = (LBR_SAMPLE_ENTRY *)(Header + 1);
+    UINT32              Window  = Program->Sequence < Capacity ? (UINT32)Program->Sequence : Capacity;
+    UINT32              Active  = 0;
+
+    memset(Sample, 0, LbrProfileGetSampleSize(Capacity));
+
+    Header->TimeStamp       = Program->Sequence;
+    Header->NumberOfEntries = (UINT8)Capacity;
+    Header->ArchBasedLbr    = Program->ArchBasedLbr;
+    Header->Tos             = Program->ArchBasedLbr ? 0 : (UINT8)(BenchRandomFrom(&Program->RandomState) % Capacity);
+
+    //
+    // The most recent branch is the first entry of the arch LBR, and it's the
+    // top of the stack of the legacy LBR (the older ones are below it)
+    //
+    for (UINT32 k = 0; k < Window; k++)
+    {
+        const LBR_PROFILE_BRANCH * Branch = &Program->History[(Program->Sequence - 1 - k) % MAXIMUM_LBR_CAPACITY];
+        LBR_SAMPLE_ENTRY *         Entry  = &Entries[Program->ArchBasedLbr ? k : (Header->Tos + Capacity - k) % Capacity];
+
+        Entry->From            = Branch->From;
+        Entry->To              = Branch->To;
+        Entry->Info.CycleCount = Branch->Cycles;
+        Entry->Info.Mispred    = Branch->Mispredicted;
+
+        if (Program->ArchBasedLbr)
+        {
+            Entry->Info.BrType_OnlyArchLbr      = Branch->BranchType;
+            Entry->Info.CycCntValid_OnlyArchLbr = Branch->CyclesValid;
+        }
+    }
+
+    for (UINT32 i = 0; i < Window; i++)
+    {
+        Expected[i] = Program->History[(Program->Sequence - Window + i) % MAXIMUM_LBR_CAPACITY];
+    }
+
+    *NumberOfExpected = Window;
+
+    //
+    // The chain is the calls of the window that are still active, which are
+    // the top of the real stack (only the arch LBR has the types)
+    //
+    if (Program->ArchBasedLbr)
+    {
+        while (Active < Program->Depth && Program->Stack[Program->Depth - 1 - Active].Sequence >= Program->Sequence - Window)
+        {
+            Active++;
+        }
+    }
+
+    *Depth = Active < LBR_PROFILE_MAXIMUM_CHAIN_DEPTH ? Active : LBR_PROFILE_MAXIMUM_CHAIN_DEPTH;
+
+    for (UINT32 i = 0; i < *Depth; i++)
+    {
+        Frames[i] = BenchFunctionStart(Program->Stack[Program->Depth - 1 - i].Function);
+    }
+
+    return LbrProfileGetSampleSize(Capacity);
+}
+
+static int
+BenchCompareEdgeKeys(const void * First, const void * Second)
+{
+    const LBR_PROFILE_EDGE * A = (const LBR_PROFILE_EDGE *)First;
+    const LBR_PROFILE_EDGE * B = (const LBR_PROFILE_EDGE *)Second;
+
+    if (A->From != B->From)
+        return A->From < B->From ? -1 : 1;
+
+    return A->To < B->To ? -1 : A->To > B->To;
+}
+
+static int
+BenchCompareChainKeys(const void * First, const void * Second)
+{
+    const LBR_PROFILE_CHAIN * A = (const LBR_PROFILE_CHAIN *)First;
+    const LBR_PROFILE_CHAIN * B = (const LBR_PROFILE_CHAIN *)Second;
+
+    if (A->Depth != B->Depth)
+        return A->Depth < B->Depth ? -1 : 1;
+
+    for (UINT32 i = 0; i < A->Depth; i++)
+    {
+        if (A->Frames[i] != B->Frames[i])
+            return A->Frames[i] < B->Frames[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Find the function of an address by scanning the ranges
+ *
+ */
+static UINT32
+BenchFindFunction(const LBR_PROFILE_FUNCTION_RANGE * Ranges, UINT32 NumberOfRanges, UINT64 Address)
+{
+    for (UINT32 i = 0; i < NumberOfRanges; i++)
+    {
+        if (Address >= Ranges[i].Start && Address - Ranges[i].Start < Ranges[i].Size)
+        {
+            return i;
+        }
+    }
+
+    return LBR_PROFILE_NO_FUNCTION;
+}
+
+/**
+ * @brief Check the edges of a finalized profile against the reference edges
+ *
+ * @param Profile
+ * @param Reference The reference edges (sorted by their keys)
+ * @param NumberOfReference
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+BenchCheckEdges(LBR_PROFILE * Profile, LBR_PROFILE_EDGE * Reference, UINT32 NumberOfReference)
+{
+    LBR_PROFILE_EDGE * Edges;
+
+    if (Profile->NumberOfEdges != NumberOfReference || Profile->DroppedEdges != 0)
+    {
+        printf("err, %u edges (%llu dropped) instead of %u\n",
+               Profile->NumberOfEdges,
+               (unsigned long long)Profile->DroppedEdges,
+               NumberOfReference);
+        return FALSE;
+    }
+
+    for (UINT32 i = 1; i < Profile->NumberOfEdges; i++)
+    {
+        if (Profile->Edges[i - 1].Count < Profile->Edges[i].Count)
+        {
+            printf("err, the edges are not sorted by their counts at %u\n", i);
+            return FALSE;
+        }
+    }
+
+    Edges = (LBR_PROFILE_EDGE *)malloc((NumberOfReference + 1) * sizeof(LBR_PROFILE_EDGE));
+
+    if (Edges == NULL)
+    {
+        return FALSE;
+    }
+
+    memcpy(Edges, Profile->Edges, NumberOfReference * sizeof(LBR_PROFILE_EDGE));
+    qsort(Edges, NumberOfReference, sizeof(LBR_PROFILE_EDGE), BenchCompareEdgeKeys);
+
+    for (UINT32 i = 0; i < NumberOfReference; i++)
+    {
+        if (Edges[i].From != Reference[i].From || Edges[i].To != Reference[i].To || Edges[i].Count != Reference[i].Count ||
+            Edges[i].Mispredicted != Reference[i].Mispredicted || Edges[i].Cycles != Reference[i].Cycles ||
+            Edges[i].CycleSamples != Reference[i].CycleSamples || Edges[i].BranchType != Reference[i].BranchType)
+        {
+            printf("err, edge %llx -> %llx differs (count %llu instead of %llu)\n",
+                   (unsigned long long)Edges[i].From,
+                   (unsigned long long)Edges[i].To,
+                   (unsigned long long)Edges[i].Count,
+                   (unsigned long long)Reference[i].Count);
+            free(Edges);
+            return FALSE;
+        }
+    }
+
+    free(Edges);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the chains of a finalized profile against the reference chains
+ *
+ * @param Profile
+ * @param Reference The reference chains (sorted by their keys)
+ * @param NumberOfReference
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+BenchCheckChains(LBR_PROFILE * Profile, LBR_PROFILE_CHAIN * Reference, UINT32 NumberOfReference)
+{
+    LBR_PROFILE_CHAIN * Chains;
+
+    if (Profile->NumberOfChains != NumberOfReference || Profile->DroppedChains != 0)
+    {
+        printf("err, %u chains (%llu dropped) instead of %u\n",
+               Profile->NumberOfChains,
+               (unsigned long long)Profile->DroppedChains,
+               NumberOfReference);
+        return FALSE;
+    }
+
+    for (UINT32 i = 1; i < Profile->NumberOfChains; i++)
+    {
+        if (Profile->Chains[i - 1].Count < Profile->Chains[i].Count)
+        {
+            printf("err, the chains are not sorted by their counts at %u\n", i);
+            return FALSE;
+        }
+    }
+
+    Chains = (LBR_PROFILE_CHAIN *)malloc((NumberOfReference + 1) * sizeof(LBR_PROFILE_CHAIN));
+
+    if (Chains == NULL)
+    {
+        return FALSE;
+    }
+
+    memcpy(Chains, Profile->Chains, NumberOfReference * sizeof(LBR_PROFILE_CHAIN));
+    qsort(Chains, NumberOfReference, sizeof(LBR_PROFILE_CHAIN), BenchCompareChainKeys);
+
+    for (UINT32 i = 0; i < NumberOfReference; i++)
+    {
+        if (BenchCompareChainKeys(&Chains[i], &Reference[i]) != 0 || Chains[i].Count != Reference[i].Count)
+        {
+            printf("err, chain %u (depth %u) differs (count %llu instead of %llu)\n",
+                   i,
+                   Chains[i].Depth,
+                   (unsigned long long)Chains[i].Count,
+                   (unsigned long long)Reference[i].Count);
+            free(Chains);
+            return FALSE;
+        }
+    }
+
+    free(Chains);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the summaries of the functions against summing the edges
+ *
+ * @details Every eighth function has no symbol, so its branches are not
+ * resolved
+ *
+ */
+static BOOLEAN
+BenchCheckFunctions(LBR_PROFILE * Profile, LBR_PROFILE_EDGE * Reference, UINT32 NumberOfReference, UINT64 * RandomState)
+{
+    LBR_PROFILE_FUNCTION_RANGE   Ranges[BENCH_FUNCTIONS];
+    LBR_PROFILE_FUNCTION_SUMMARY Summaries[BENCH_FUNCTIONS];
+    LBR_PROFILE_FUNCTION_SUMMARY Expected[BENCH_FUNCTIONS];
+    LBR_PROFILE_FUNCTION_SUMMARY Unresolved;
+    LBR_PROFILE_FUNCTION_SUMMARY ExpectedUnresolved;
+    UINT32                       NumberOfRanges = 0;
+    UINT32                       NumberOfActive = 0;
+    UINT32                       Active;
+
+    for (UINT32 i = 0; i < BENCH_FUNCTIONS; i++)
+    {
+        if (i % 8 != 7)
+        {
+            Ranges[NumberOfRanges].Start = BenchFunctionStart(i);
+            Ranges[NumberOfRanges].Size  = BENCH_FUNCTION_SIZE;
+            NumberOfRanges++;
+        }
+    }
+
+    //
+    // The binary search, also between and around the functions
+    //
+    for (UINT32 i = 0; i < 100000; i++)
+    {
+        UINT64 Address = BENCH_IMAGE_BASE - 0x100 + BenchRandomFrom(RandomState) % (BENCH_FUNCTIONS * BENCH_FUNCTION_STRIDE + 0x200);
+
+        if (LbrProfileFindFunction(Ranges, NumberOfRanges, Address) != BenchFindFunction(Ranges, NumberOfRanges, Address))
+        {
+            printf("err, function of %llx differs\n", (unsigned long long)Address);
+            return FALSE;
+        }
+    }
+
+    if (LbrProfileFindFunction(Ranges, 0, BENCH_IMAGE_BASE) != LBR_PROFILE_NO_FUNCTION)
+    {
+        printf("err, an address is found without any function\n");
+        return FALSE;
+    }
+
+    memset(Expected, 0, sizeof(Expected));
+    memset(&ExpectedUnresolved, 0, sizeof(ExpectedUnresolved));
+
+    for (UINT32 i = 0; i < NumberOfReference; i++)
+    {
+        const LBR_PROFILE_EDGE *       Edge     = &Reference[i];
+        UINT32                         Function = BenchFindFunction(Ranges, NumberOfRanges, Edge->From);
+        LBR_PROFILE_FUNCTION_SUMMARY * Summary  = Function == LBR_PROFILE_NO_FUNCTION ? &ExpectedUnresolved : &Expected[Function];
+
+        Summary->Branches += Edge->Count;
+        Summary->Mispredicted += Edge->Mispredicted;
+        Summary->Cycles += Edge->Cycles;
+        Summary->CycleSamples += Edge->CycleSamples;
+
+        if (Edge->BranchType == LBR_BR_TYPE_CALL_DIRECT || Edge->BranchType == LBR_BR_TYPE_CALL_INDIRECT)
+        {
+            Function = BenchFindFunction(Ranges, NumberOfRanges, Edge->To);
+            Summary  = Function == LBR_PROFILE_NO_FUNCTION ? &ExpectedUnresolved : &Expected[Function];
+
+            Summary->Calls += Edge->Count;
+        }
+    }
+
+    for (UINT32 i = 0; i < NumberOfRanges; i++)
+    {
+        if (Expected[i].Branches != 0 || Expected[i].Calls != 0)
+        {
+            NumberOfActive++;
+        }
+    }
+
+    Active = LbrProfileSummarizeFunctions(Profile, Ranges, NumberOfRanges, Summaries, &Unresolved);
+
+    if (Active != NumberOfActive || Unresolved.Branches != ExpectedUnresolved.Branches ||
+        Unresolved.Calls != ExpectedUnresolved.Calls || Unresolved.Cycles != ExpectedUnresolved.Cycles ||
+        Unresolved.Function != LBR_PROFILE_NO_FUNCTION)
+    {
+        printf("err, %u active functions instead of %u (%llu unresolved branches instead of %llu)\n",
+               Active,
+               NumberOfActive,
+               (unsigned long long)Unresolved.Branches,
+               (unsigned long long)ExpectedUnresolved.Branches);
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < Active; i++)
+    {
+        const LBR_PROFILE_FUNCTION_SUMMARY * Summary = &Summaries[i];
+        const LBR_PROFILE_FUNCTION_SUMMARY * Correct = &Expected[Summary->Function];
+
+        if (Summary->Branches != Correct->Branches || Summary->Mispredicted != Correct->Mispredicted ||
+            Summary->Cycles != Correct->Cycles || Summary->CycleSamples != Correct->CycleSamples ||
+            Summary->Calls != Correct->Calls || (i != 0 && Summaries[i - 1].Cycles < Summary->Cycles))
+        {
+            printf("err, summary of function %u differs\n", Summary->Function);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the files of the samples
+ *
+ */
+static BOOLEAN
+BenchCheckFile(LBR_PROFILE * Profile, const BYTE * Samples, UINT64 SamplesSize, UINT64 NumberOfSamples)
+{
+    LBR_PROFILE_FILE_HEADER * Header;
+    LBR_PROFILE               Loaded;
+    const VOID *              LoadedSamples;
+    UINT64                    LoadedSize;
+    UINT64                    LoadedCount;
+    UINT64                    LoadedDropped;
+    SIZE_T                    BufferSize = LbrProfileGetBufferSize(BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE);
+    PVOID                     Buffer     = malloc(BufferSize);
+    BYTE *                    File       = (BYTE *)malloc(sizeof(LBR_PROFILE_FILE_HEADER) + SamplesSize);
+    UINT64                    FileSize   = sizeof(LBR_PROFILE_FILE_HEADER) + SamplesSize;
+    BOOLEAN                   Result     = FALSE;
+
+    if (Buffer == NULL || File == NULL)
+    {
+        free(Buffer);
+        free(File);
+        return FALSE;
+    }
+
+    Header = (LBR_PROFILE_FILE_HEADER *)File;
+
+    LbrProfileInitializeFileHeader(Header, NumberOfSamples, 7);
+    memcpy(File + sizeof(LBR_PROFILE_FILE_HEADER), Samples, SamplesSize);
+
+    if (!LbrProfileReadFile(File, FileSize, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped) ||
+        LoadedSize != SamplesSize || LoadedCount != NumberOfSamples || LoadedDropped != 7 ||
+        LoadedSamples != File + sizeof(LBR_PROFILE_FILE_HEADER))
+    {
+        printf("err, the file of the samples is not read\n");
+        goto Exit;
+    }
+
+    //
+    // The same samples make the same profile (the ties are sorted by the keys)
+    //
+    LbrProfileInitialize(&Loaded, BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE, Buffer, BufferSize);
+
+    if (!LbrProfileAddSamples(&Loaded, LoadedSamples, LoadedSize, NULL))
+    {
+        printf("err, the samples of the file are not added\n");
+        goto Exit;
+    }
+
+    LbrProfileFinalize(&Loaded);
+
+    if (Loaded.NumberOfEdges != Profile->NumberOfEdges || Loaded.NumberOfChains != Profile->NumberOfChains ||
+        memcmp(Loaded.Edges, Profile->Edges, Loaded.NumberOfEdges * sizeof(LBR_PROFILE_EDGE)) != 0 ||
+        memcmp(Loaded.Chains, Profile->Chains, Loaded.NumberOfChains * sizeof(LBR_PROFILE_CHAIN)) != 0)
+    {
+        printf("err, the profile of the file differs\n");
+        goto Exit;
+    }
+
+    if (LbrProfileAddSample(&Loaded, (const LBR_SAMPLE_HEADER *)LoadedSamples))
+    {
+        printf("err, a sample is added to a finalized profile\n");
+        goto Exit;
+    }
+
+    //
+    // Truncated files, another magic or version, and a different count
+    //
+    if (LbrProfileReadFile(File, FileSize - 1, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped) ||
+        LbrProfileReadFile(File, sizeof(LBR_PROFILE_FILE_HEADER) - 1, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped))
+    {
+        printf("err, a truncated file is read\n");
+        goto Exit;
+    }
+
+    Header->Magic++;
+
+    if (LbrProfileReadFile(File, FileSize, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped))
+    {
+        printf("err, a file with another magic is read\n");
+        goto Exit;
+    }
+
+    Header->Magic--;
+    Header->Version++;
+
+    if (LbrProfileReadFile(File, FileSize, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped))
+    {
+        printf("err, a file with another version is read\n");
+        goto Exit;
+    }
+
+    Header->Version--;
+    Header->NumberOfSamples++;
+
+    if (LbrProfileReadFile(File, FileSize, &LoadedSamples, &LoadedSize, &LoadedCount, &LoadedDropped))
+    {
+        printf("err, a file with another count of the samples is read\n");
+        goto Exit;
+    }
+
+    Header->NumberOfSamples--;
+
+    Result = TRUE;
+
+Exit:
+    free(Buffer);
+    free(File);
+
+    return Result;
+}
+
+/**
+ * @brief Check the invalid samples
+ *
+ */
+static BOOLEAN
+BenchTestInvalidSamples(void)
+{
+    BYTE                Sample[sizeof(LBR_SAMPLE_HEADER) + (MAXIMUM_LBR_CAPACITY + 1) * sizeof(LBR_SAMPLE_ENTRY)];
+    BYTE                Samples[3 * sizeof(Sample)];
+    LBR_SAMPLE_HEADER * Header = (LBR_SAMPLE_HEADER *)Sample;
+    LBR_PROFILE         Profile;
+    LBR_PROFILE_EDGE    Buffer[64];
+    UINT64              Added;
+    UINT32              Size;
+
+    memset(Sample, 0, sizeof(Sample));
+
+    Header->NumberOfEntries = 8;
+    Header->Tos             = 7;
+    Size                    = LbrProfileGetSampleSize(8);
+
+    if (LbrProfileValidateSample(Sample, Size) != Size || LbrProfileValidateSample(Sample, Size - 1) != 0 ||
+        LbrProfileValidateSample(Sample, sizeof(LBR_SAMPLE_HEADER) - 1) != 0)
+    {
+        printf("err, the size of a sample is not validated\n");
+        return FALSE;
+    }
+
+    Header->Tos = 8;
+
+    if (LbrProfileValidateSample(Sample, Size) != 0)
+    {
+        printf("err, a legacy sample with the top of the stack out of its entries is valid\n");
+        return FALSE;
+    }
+
+    //
+    // The arch LBR has no top of the stack
+    //
+    Header->ArchBasedLbr = 1;
+    Header->Tos          = 0;
+
+    if (LbrProfileValidateSample(Sample, Size) != Size)
+    {
+        printf("err, an arch sample is not valid\n");
+        return FALSE;
+    }
+
+    Header->ArchBasedLbr = 2;
+
+    if (LbrProfileValidateSample(Sample, Size) != 0)
+    {
+        printf("err, a sample with an unknown kind of the LBR is valid\n");
+        return FALSE;
+    }
+
+    Header->ArchBasedLbr    = 1;
+    Header->NumberOfEntries = 0;
+
+    if (LbrProfileValidateSample(Sample, sizeof(Sample)) != 0)
+    {
+        printf("err, an empty sample is valid\n");
+        return FALSE;
+    }
+
+    Header->NumberOfEntries = MAXIMUM_LBR_CAPACITY + 1;
+
+    if (LbrProfileValidateSample(Sample, sizeof(Sample)) != 0)
+    {
+        printf("err, a sample with more entries than the LBR is valid\n");
+        return FALSE;
+    }
+
+    //
+    // The samples before an invalid sample are added
+    //
+    Header->NumberOfEntries = 8;
+
+    memcpy(Samples, Sample, Size);
+    memcpy(Samples + Size, Sample, Size);
+    memcpy(Samples + 2 * Size, Sample, Size);
+    ((LBR_SAMPLE_HEADER *)(Samples + 2 * Size))->NumberOfEntries = 0;
+
+    if (!LbrProfileInitialize(&Profile, 4, 4, Buffer, sizeof(Buffer)))
+    {
+        printf("err, a profile is not initialized\n");
+        return FALSE;
+    }
+
+    if (LbrProfileAddSamples(&Profile, Samples, 3 * Size, &Added) || Added != 2 || Profile.NumberOfSamples != 2 ||
+        Profile.NumberOfBranches != 0)
+    {
+        printf("err, %llu samples are added before an invalid sample\n", (unsigned long long)Added);
+        return FALSE;
+    }
+
+    if (LbrProfileInitialize(&Profile, 6, 4, Buffer, sizeof(Buffer)) || LbrProfileInitialize(&Profile, 2, 4, Buffer, sizeof(Buffer)) ||
+        LbrProfileInitialize(&Profile, 4, 3, Buffer, sizeof(Buffer)) ||
+        LbrProfileInitialize(&Profile, 16, 16, Buffer, LbrProfileGetBufferSize(16, 16) - 1))
+    {
+        printf("err, a profile is initialized with invalid tables\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the full tables (the new edges and chains are dropped)
+ *
+ */
+static BOOLEAN
+BenchTestFullTables(void)
+{
+    BYTE                Sample[sizeof(LBR_SAMPLE_HEADER) + MAXIMUM_LBR_CAPACITY * sizeof(LBR_SAMPLE_ENTRY)];
+    LBR_SAMPLE_HEADER * Header  = (LBR_SAMPLE_HEADER *)Sample;
+    LBR_SAMPLE_ENTRY *  Entries = (LBR_SAMPLE_ENTRY *)(Header + 1);
+    LBR_PROFILE         Profile;
+    PVOID               Buffer = malloc(LbrProfileGetBufferSize(16, 4));
+
+    if (Buffer == NULL)
+    {
+        return FALSE;
+    }
+
+    LbrProfileInitialize(&Profile, 16, 4, Buffer, LbrProfileGetBufferSize(16, 4));
+
+    //
+    // 20 different branches, only 12 of them fit in a table of 16 edges
+    //
+    memset(Sample, 0, sizeof(Sample));
+
+    Header->NumberOfEntries = 20;
+    Header->ArchBasedLbr    = 1;
+
+    for (UINT32 i = 0; i < 20; i++)
+    {
+        Entries[i].From = 0x1000 + i * 0x10;
+        Entries[i].To   = 0x2000 + i * 0x10;
+    }
+
+    LbrProfileAddSample(&Profile, Header);
+    LbrProfileAddSample(&Profile, Header);
+
+    if (Profile.NumberOfEdges != 12 || Profile.DroppedEdges != 16 || Profile.NumberOfBranches != 40)
+    {
+        printf("err, %u edges and %llu dropped edges in a full table\n",
+               Profile.NumberOfEdges,
+               (unsigned long long)Profile.DroppedEdges);
+        free(Buffer);
+        return FALSE;
+    }
+
+    //
+    // 5 different chains, only 3 of them fit in a table of 4 chains
+    //
+    LbrProfileInitialize(&Profile, 16, 4, Buffer, LbrProfileGetBufferSize(16, 4));
+
+    Header->NumberOfEntries = 1;
+
+    for (UINT32 i = 0; i < 5; i++)
+    {
+        Entries[0].From                    = 0x1000;
+        Entries[0].To                      = 0x3000 + i * 0x100;
+        Entries[0].Info.BrType_OnlyArchLbr = LBR_BR_TYPE_CALL_DIRECT;
+
+        LbrProfileAddSample(&Profile, Header);
+    }
+
+    LbrProfileFinalize(&Profile);
+
+    if (Profile.NumberOfChains != 3 || Profile.DroppedChains != 2 || Profile.NumberOfEdges != 5)
+    {
+        printf("err, %u chains and %llu dropped chains in a full table\n",
+               Profile.NumberOfChains,
+               (unsigned long long)Profile.DroppedChains);
+        free(Buffer);
+        return FALSE;
+    }
+
+    free(Buffer);
+
+    return TRUE;
+}
+
+/**
+ * @brief Sample a simulated program and check the profile against a reference
+ *
+ * @param ArchBasedLbr
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+BenchTestProfile(BOOLEAN ArchBasedLbr)
+{
+    BENCH_PROGRAM       Program;
+    LBR_PROFILE         Profile;
+    LBR_PROFILE_BRANCH  Expected[MAXIMUM_LBR_CAPACITY];
+    LBR_PROFILE_BRANCH  Branches[MAXIMUM_LBR_CAPACITY];
+    UINT64              Frames[LBR_PROFILE_MAXIMUM_CHAIN_DEPTH];
+    UINT64              ChainFrames[LBR_PROFILE_MAXIMUM_CHAIN_DEPTH];
+    UINT64              Added;
+    UINT64              SamplesSize       = 0;
+    UINT32              NumberOfReference = 0;
+    UINT32              NumberOfChains    = 0;
+    SIZE_T              BufferSize        = LbrProfileGetBufferSize(BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE);
+    PVOID               Buffer            = malloc(BufferSize);
+    BYTE *              Samples           = (BYTE *)malloc((SIZE_T)BENCH_SAMPLES * LbrProfileGetSampleSize(MAXIMUM_LBR_CAPACITY));
+    LBR_PROFILE_EDGE *  Reference         = (LBR_PROFILE_EDGE *)malloc((SIZE_T)BENCH_SAMPLES * MAXIMUM_LBR_CAPACITY * sizeof(LBR_PROFILE_EDGE));
+    LBR_PROFILE_CHAIN * Chains            = (LBR_PROFILE_CHAIN *)malloc((SIZE_T)BENCH_SAMPLES * sizeof(LBR_PROFILE_CHAIN));
+    BOOLEAN             Result            = FALSE;
+    UINT32              Unique;
+
+    if (Buffer == NULL || Samples == NULL || Reference == NULL || Chains == NULL)
+    {
+        goto Exit;
+    }
+
+    memset(&Program, 0, sizeof(Program));
+
+    Program.RandomState  = ArchBasedLbr ? 0x9e3779b97f4a7c15ull : 0xd1b54a32d192ed03ull;
+    Program.ArchBasedLbr = ArchBasedLbr;
+
+    for (UINT32 i = 0; i < BENCH_SAMPLES; i++)
+    {
+        UINT32              Capacity = g_Capacities[BenchRandomFrom(&Program.RandomState) % (sizeof(g_Capacities) / sizeof(g_Capacities[0]))];
+        BYTE *              Sample   = Samples + SamplesSize;
+        UINT32              NumberOfExpected;
+        UINT32              Depth;
+        UINT32              SampleSize;
+        UINT32              Count;
+        UINT32              ChainDepth;
+
+        //
+        // The first samples are taken before the LBR is full
+        //
+        UINT32 Steps = i < 16 ? (UINT32)(BenchRandomFrom(&Program.RandomState) % 4) : (UINT32)(BenchRandomFrom(&Program.RandomState) % 64) + 1;
+
+        for (UINT32 j = 0; j < Steps; j++)
+        {
+            BenchStep(&Program);
+        }
+
+        SampleSize = BenchSnapshot(&Program, Capacity, Sample, Expected, &NumberOfExpected, Frames, &Depth);
+
+        if (LbrProfileValidateSample(Sample, SampleSize) != SampleSize)
+        {
+            printf("err, sample %u is not valid\n", i);
+            goto Exit;
+        }
+
+        Count = LbrProfileNormalizeSample((const LBR_SAMPLE_HEADER *)Sample, Branches);
+
+        if (Count != NumberOfExpected)
+        {
+            printf("err, %u branches instead of %u in sample %u\n", Count, NumberOfExpected, i);
+            goto Exit;
+        }
+
+        for (UINT32 j = 0; j < Count; j++)
+        {
+            if (Branches[j].From != Expected[j].From || Branches[j].To != Expected[j].To ||
+                Branches[j].BranchType != Expected[j].BranchType || Branches[j].Cycles != Expected[j].Cycles ||
+                Branches[j].CyclesValid != Expected[j].CyclesValid || Branches[j].Mispredicted != Expected[j].Mispredicted)
+            {
+                printf("err, branch %u of sample %u (capacity %u, tos %u) differs\n",
+                       j,
+                       i,
+                       Capacity,
+                       ((LBR_SAMPLE_HEADER *)Sample)->Tos);
+                goto Exit;
+            }
+        }
+
+        ChainDepth = LbrProfileBuildChain(Branches, Count, ChainFrames);
+
+        if (ChainDepth != Depth || memcmp(ChainFrames, Frames, Depth * sizeof(UINT64)) != 0)
+        {
+            printf("err, chain of sample %u has %u frames instead of %u\n", i, ChainDepth, Depth);
+            goto Exit;
+        }
+
+        //
+        // The reference of the edges and the chains
+        //
+        for (UINT32 j = 0; j < Count; j++)
+        {
+            LBR_PROFILE_EDGE * Edge = &Reference[NumberOfReference++];
+
+            memset(Edge, 0, sizeof(LBR_PROFILE_EDGE));
+
+            Edge->From         = Expected[j].From;
+            Edge->To           = Expected[j].To;
+            Edge->Count        = 1;
+            Edge->Mispredicted = Expected[j].Mispredicted ? 1 : 0;
+            Edge->Cycles       = Expected[j].CyclesValid ? Expected[j].Cycles : 0;
+            Edge->CycleSamples = Expected[j].CyclesValid ? 1 : 0;
+            Edge->BranchType   = Expected[j].BranchType;
+        }
+
+        if (Depth != 0)
+        {
+            LBR_PROFILE_CHAIN * Chain = &Chains[NumberOfChains++];
+
+            memset(Chain, 0, sizeof(LBR_PROFILE_CHAIN));
+
+            Chain->Count = 1;
+            Chain->Depth = Depth;
+            memcpy(Chain->Frames, Frames, Depth * sizeof(UINT64));
+        }
+
+        SamplesSize += SampleSize;
+    }
+
+    //
+    // Merge the reference edges and chains with the same keys
+    //
+    qsort(Reference, NumberOfReference, sizeof(LBR_PROFILE_EDGE), BenchCompareEdgeKeys);
+
+    Unique = 0;
+
+    for (UINT32 i = 0; i < NumberOfReference; i++)
+    {
+        if (Unique != 0 && BenchCompareEdgeKeys(&Reference[Unique - 1], &Reference[i]) == 0)
+        {
+            Reference[Unique - 1].Count += Reference[i].Count;
+            Reference[Unique - 1].Mispredicted += Reference[i].Mispredicted;
+            Reference[Unique - 1].Cycles += Reference[i].Cycles;
+            Reference[Unique - 1].CycleSamples += Reference[i].CycleSamples;
+        }
+        else
+        {
+            Reference[Unique++] = Reference[i];
+        }
+    }
+
+    NumberOfReference = Unique;
+
+    qsort(Chains, NumberOfChains, sizeof(LBR_PROFILE_CHAIN), BenchCompareChainKeys);
+
+    Unique = 0;
+
+    for (UINT32 i = 0; i < NumberOfChains; i++)
+    {
+        if (Unique != 0 && BenchCompareChainKeys(&Chains[Unique - 1], &Chains[i]) == 0)
+        {
+            Chains[Unique - 1].Count++;
+        }
+        else
+        {
+            Chains[Unique++] = Chains[i];
+        }
+    }
+
+    NumberOfChains = Unique;
+
+    if (ArchBasedLbr == (NumberOfChains == 0))
+    {
+        printf("err, %u chains are sampled by the %s LBR\n", NumberOfChains, ArchBasedLbr ? "arch" : "legacy");
+        goto Exit;
+    }
+
+    //
+    // Aggregate all of the samples at once
+    //
+    LbrProfileInitialize(&Profile, BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE, Buffer, BufferSize);
+
+    if (!LbrProfileAddSamples(&Profile, Samples, SamplesSize, &Added) || Added != BENCH_SAMPLES ||
+        Profile.NumberOfSamples != BENCH_SAMPLES)
+    {
+        printf("err, %llu samples are added\n", (unsigned long long)Added);
+        goto Exit;
+    }
+
+    //
+    // The summaries are the same before and after finalizing
+    //
+    if (!BenchCheckFunctions(&Profile, Reference, NumberOfReference, &Program.RandomState))
+    {
+        goto Exit;
+    }
+
+    LbrProfileFinalize(&Profile);
+
+    if (!BenchCheckEdges(&Profile, Reference, NumberOfReference) || !BenchCheckChains(&Profile, Chains, NumberOfChains) ||
+        !BenchCheckFunctions(&Profile, Reference, NumberOfReference, &Program.RandomState) ||
+        !BenchCheckFile(&Profile, Samples, SamplesSize, BENCH_SAMPLES))
+    {
+        goto Exit;
+    }
+
+    printf("%s LBR: %u samples, %llu branches, %u edges, %u chains\n",
+           ArchBasedLbr ? "arch" : "legacy",
+           BENCH_SAMPLES,
+           (unsigned long long)Profile.NumberOfBranches,
+           Profile.NumberOfEdges,
+           Profile.NumberOfChains);
+
+    Result = TRUE;
+
+Exit:
+    free(Buffer);
+    free(Samples);
+    free(Reference);
+    free(Chains);
+
+    return Result;
+}
+
+/**
+ * @brief Measure the aggregation of full samples of the arch LBR
+ *
+ */
+static void
+BenchMeasure(void)
+{
+    BENCH_PROGRAM              Program;
+    LBR_PROFILE                Profile;
+    LBR_PROFILE_BRANCH         Expected[MAXIMUM_LBR_CAPACITY];
+    LBR_PROFILE_FUNCTION_RANGE Ranges[BENCH_FUNCTIONS];
+    LBR_PROFILE_FUNCTION_SUMMARY Summaries[BENCH_FUNCTIONS];
+    UINT64                     Frames[LBR_PROFILE_MAXIMUM_CHAIN_DEPTH];
+    UINT32                     NumberOfExpected;
+    UINT32                     Depth;
+    UINT32                     SampleSize = LbrProfileGetSampleSize(MAXIMUM_LBR_CAPACITY);
+    SIZE_T                     BufferSize = LbrProfileGetBufferSize(BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE);
+    PVOID                      Buffer     = malloc(BufferSize);
+    BYTE *                     Samples    = (BYTE *)malloc((SIZE_T)BENCH_MEASURE_SAMPLES * SampleSize);
+    double                     Start;
+    double                     Aggregate;
+    double                     Summarize;
+
+    if (Buffer == NULL || Samples == NULL)
+    {
+        free(Buffer);
+        free(Samples);
+        return;
+    }
+
+    memset(&Program, 0, sizeof(Program));
+
+    Program.RandomState  = 0x2545f4914f6cdd1dull;
+    Program.ArchBasedLbr = TRUE;
+
+    for (UINT32 i = 0; i < BENCH_MEASURE_SAMPLES; i++)
+    {
+        UINT32 Steps = (UINT32)(BenchRandomFrom(&Program.RandomState) % 64) + MAXIMUM_LBR_CAPACITY;
+
+        for (UINT32 j = 0; j < Steps; j++)
+        {
+            BenchStep(&Program);
+        }
+
+        BenchSnapshot(&Program, MAXIMUM_LBR_CAPACITY, Samples + (SIZE_T)i * SampleSize, Expected, &NumberOfExpected, Frames, &Depth);
+    }
+
+    for (UINT32 i = 0; i < BENCH_FUNCTIONS; i++)
+    {
+        Ranges[i].Start = BenchFunctionStart(i);
+        Ranges[i].Size  = BENCH_FUNCTION_SIZE;
+    }
+
+    Aggregate = 0;
+    Summarize = 0;
+
+    for (UINT32 Round = 0; Round < BENCH_MEASURE_ROUNDS; Round++)
+    {
+        LbrProfileInitialize(&Profile, BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE, Buffer, BufferSize);
+
+        Start = BenchNow();
+        LbrProfileAddSamples(&Profile, Samples, (UINT64)BENCH_MEASURE_SAMPLES * SampleSize, NULL);
+        LbrProfileFinalize(&Profile);
+        Aggregate += BenchNow() - Start;
+
+        Start = BenchNow();
+        LbrProfileSummarizeFunctions(&Profile, Ranges, BENCH_FUNCTIONS, Summaries, NULL);
+        Summarize += BenchNow() - Start;
+    }
+
+    printf("aggregating samples of %u branches: %.1f ns per sample, %.1f M branches/s\n",
+           MAXIMUM_LBR_CAPACITY,
+           Aggregate * 1e9 / ((double)BENCH_MEASURE_SAMPLES * BENCH_MEASURE_ROUNDS),
+           (double)BENCH_MEASURE_SAMPLES * BENCH_MEASURE_ROUNDS * MAXIMUM_LBR_CAPACITY / Aggregate / 1e6);
+    printf("summarizing %u edges into %u functions: %.1f us\n",
+           Profile.NumberOfEdges,
+           BENCH_FUNCTIONS,
+           Summarize * 1e6 / BENCH_MEASURE_ROUNDS);
+
+    free(Buffer);
+    free(Samples);
+}
+
+/**
+ * @brief Read a whole file
+ *
+ */
+static UINT8 *
+BenchReadFile(const char * Path, UINT64 * Size)
+{
+    FILE *  File = fopen(Path, "rb");
+    UINT8 * Buffer;
+    long    Length;
+
+    if (File == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(File, 0, SEEK_END);
+    Length = ftell(File);
+    fseek(File, 0, SEEK_SET);
+
+    Buffer = (UINT8 *)malloc(Length > 0 ? (size_t)Length : 1);
+
+    if (Buffer == NULL || fread(Buffer, 1, (size_t)Length, File) != (size_t)Length)
+    {
+        free(Buffer);
+        fclose(File);
+        return NULL;
+    }
+
+    fclose(File);
+    *Size = (UINT64)Length;
+
+    return Buffer;
+}
+
+/**
+ * @brief Show the hot edges and chains of a file of the samples (e.g., saved
+ * by '!lbrprof collect')
+ *
+ */
+static int
+BenchShowSamples(const char * Path)
+{
+    LBR_PROFILE  Profile;
+    const VOID * Samples;
+    UINT64       SamplesSize;
+    UINT64       NumberOfSamples;
+    UINT64       DroppedSamples;
+    UINT64       Size;
+    UINT8 *      File       = BenchReadFile(Path, &Size);
+    SIZE_T       BufferSize = LbrProfileGetBufferSize(BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE);
+    PVOID        Buffer;
+
+    if (File == NULL || !LbrProfileReadFile(File, Size, &Samples, &SamplesSize, &NumberOfSamples, &DroppedSamples))
+    {
+        printf("err, '%s' is not a valid file of the LBR samples\n", Path);
+        free(File);
+        return 1;
+    }
+
+    Buffer = malloc(BufferSize);
+
+    if (Buffer == NULL)
+    {
+        free(File);
+        return 1;
+    }
+
+    LbrProfileInitialize(&Profile, BENCH_EDGE_TABLE_SIZE, BENCH_CHAIN_TABLE_SIZE, Buffer, BufferSize);
+    LbrProfileAddSamples(&Profile, Samples, SamplesSize, NULL);
+    LbrProfileFinalize(&Profile);
+
+    printf("samples: %llu, branches: %llu, dropped samples: %llu\n",
+           (unsigned long long)NumberOfSamples,
+           (unsigned long long)Profile.NumberOfBranches,
+           (unsigned long long)DroppedSamples);
+
+    for (UINT32 i = 0; i < Profile.NumberOfEdges && i < 16; i++)
+    {
+        printf("%12llu  %016llx -> %016llx\n",
+               (unsigned long long)Profile.Edges[i].Count,
+               (unsigned long long)Profile.Edges[i].From,
+               (unsigned long long)Profile.Edges[i].To);
+    }
+
+    for (UINT32 i = 0; i < Profile.NumberOfChains && i < 16; i++)
+    {
+        printf("%12llu ", (unsigned long long)Profile.Chains[i].Count);
+
+        for (UINT32 j = 0; j < Profile.Chains[i].Depth; j++)
+        {
+            printf(" %s%016llx", j == 0 ? "" : "<- ", (unsigned long long)Profile.Chains[i].Frames[j]);
+        }
+
+        printf("\n");
+    }
+
+    free(Buffer);
+    free(File);
+
+    return 0;
+}
+
+int
+main(int argc, char ** argv)
+{
+    if (argc > 1)
+    {
+        return BenchShowSamples(argv[1]);
+    }
+
+    if (!BenchTestInvalidSamples() || !BenchTestFullTables() || !BenchTestProfile(TRUE) || !BenchTestProfile(FALSE))
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("LBR profile tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,495 @@
+/**
+ * @file logring-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the per-core log rings of hyperlog
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_RING_SIZE           (4 * LOG_RING_MINIMUM_SIZE)
+#define BENCH_MAXIMUM_THREADS     16
+#define BENCH_MAXIMUM_LENGTH      (PacketChunkSize - 1)
+#define BENCH_ORDER_RECORDS       200000
+#define BENCH_THREAD_RECORDS      200000
+#define BENCH_MESSAGE_LENGTH      96
+#define BENCH_LEGACY_CAPACITY     1000 // MaximumPacketsCapacity
+#define BENCH_LEGACY_CHUNK_SIZE   (PacketChunkSize + 16)
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The payload of the records of the tests
+ *
+ */
+typedef struct _BENCH_PAYLOAD
+{
+    UINT32 Thread;
+    UINT32 Sequence;
+    UINT32 Length;
+    UINT32 Checksum;
+
+} BENCH_PAYLOAD, *PBENCH_PAYLOAD;
+
+/**
+ * @brief A producer of the concurrent tests
+ *
+ */
+typedef struct _BENCH_PRODUCER
+{
+    pthread_t Thread;
+    UINT32    Index;
+    UINT32    Records;
+    BOOLEAN   Legacy;
+    double    Time;
+
+} BENCH_PRODUCER, *PBENCH_PRODUCER;
+
+/**
+ * @brief The previous shared buffer, one lock and fixed-size chunks (the oldest
+ * chunk is overwritten when the buffer is full)
+ *
+ */
+typedef struct _BENCH_LEGACY_BUFFER
+{
+    volatile LONG Lock;
+    UINT32        CurrentIndexToWrite;
+    UINT32        CurrentIndexToSend;
+    UINT8 *       Chunks;
+
+} BENCH_LEGACY_BUFFER, *PBENCH_LEGACY_BUFFER;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static volatile UINT64     g_TimeStamp;
+static LOG_RING            g_Rings[BENCH_MAXIMUM_THREADS];
+static BENCH_LEGACY_BUFFER g_LegacyBuffer;
+static volatile UINT32     g_RunningProducers;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A synchronized time-stamp counter (strictly increasing, so the order
+ * of the records is exactly known)
+ *
+ */
+static UINT64
+BenchReadTimeStamp(void)
+{
+    return __atomic_add_fetch(&g_TimeStamp, 1, __ATOMIC_RELAXED);
+}
+
+static UINT32
+BenchChecksum(UINT32 Thread, UINT32 Sequence, UINT32 Length)
+{
+    return (Thread * 0x9e3779b1u) ^ (Sequence * 0x85ebca6bu) ^ (Length * 0xc2b2ae35u);
+}
+
+/**
+ * @brief Build the data of a record (the payload and then a pattern)
+ *
+ */
+static void
+BenchFillRecord(UINT8 * Buffer, UINT32 Thread, UINT32 Sequence, UINT32 Length)
+{
+    BENCH_PAYLOAD Payload = {Thread, Sequence, Length, BenchChecksum(Thread, Sequence, Length)};
+
+    memcpy(Buffer, &Payload, sizeof(Payload));
+
+    for (UINT32 i = sizeof(Payload); i < Length; i++)
+    {
+        Buffer[i] = (UINT8)(Sequence + i);
+    }
+}
+
+static BOOLEAN
+BenchCheckRecord(const LOG_RING_RECORD * Record, PBENCH_PAYLOAD Payload)
+{
+    const UINT8 * Data = (const UINT8 *)(Record + 1);
+
+    if (Record->Length < sizeof(BENCH_PAYLOAD))
+    {
+        return FALSE;
+    }
+
+    memcpy(Payload, Data, sizeof(BENCH_PAYLOAD));
+
+    if (Payload->Length != Record->Length ||
+        Payload->Checksum != BenchChecksum(Payload->Thread, Payload->Sequence, Payload->Length) ||
+        Record->OperationCode != Payload->Thread)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = sizeof(BENCH_PAYLOAD); i < Record->Length; i++)
+    {
+        if (Data[i] != (UINT8)(Payload->Sequence + i))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchInitializeRings(UINT32 NumberOfRings)
+{
+    for (UINT32 i = 0; i < NumberOfRings; i++)
+    {
+        free(g_Rings[i].Buffer);
+
+        if (!LogRingInitialize(&g_Rings[i], malloc(BENCH_RING_SIZE), BENCH_RING_SIZE))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Write records of random lengths to random rings, drain them at random
+ * points, and check that the records are read in the order of their time-stamps
+ * and that the full rings drop the new records (and never overwrite the old ones)
+ *
+ */
+static BOOLEAN
+BenchTestOrder(UINT32 NumberOfRings)
+{
+    static UINT8            Buffer[BENCH_MAXIMUM_LENGTH];
+    UINT32                  Sequences[BENCH_MAXIMUM_THREADS] = {0};
+    UINT32                  Expected[BENCH_MAXIMUM_THREADS]  = {0};
+    UINT64                  Written                          = 0;
+    UINT64                  Read                             = 0;
+    UINT64                  Dropped                          = 0;
+    UINT64                  LastTimeStamp                    = 0;
+    const LOG_RING_RECORD * Record;
+    BENCH_PAYLOAD           Payload;
+    UINT32                  RingIndex;
+
+    if (!BenchInitializeRings(NumberOfRings))
+    {
+        printf("err, unable to allocate the rings\n");
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_ORDER_RECORDS; i++)
+    {
+        UINT32 Ring   = (UINT32)(BenchRandom() % NumberOfRings);
+        UINT32 Length = sizeof(BENCH_PAYLOAD) + (UINT32)(BenchRandom() % 8 == 0 ? BenchRandom() % (BENCH_MAXIMUM_LENGTH - sizeof(BENCH_PAYLOAD) + 1) : BenchRandom() % 200);
+
+        BenchFillRecord(Buffer, Ring, Sequences[Ring], Length);
+
+        if (LogRingWrite(&g_Rings[Ring], Ring, BenchReadTimeStamp(), Buffer, Length))
+        {
+            Written++;
+            Sequences[Ring]++;
+        }
+        else
+        {
+            Dropped++;
+        }
+
+        //
+        // Drain some of the records (sometimes none, so the rings get full)
+        //
+        if (BenchRandom() % 64 == 0)
+        {
+            UINT32 Count = (UINT32)(BenchRandom() % 512);
+
+            while (Count-- != 0 &&
+                   (RingIndex = LogRingPeekOldest(g_Rings, NumberOfRings, &Record)) != LOG_RING_NO_RECORD)
+            {
+                if (!BenchCheckRecord(Record, &Payload) || Payload.Thread != RingIndex ||
+                    Payload.Sequence != Expected[RingIndex] || Record->TimeStamp <= LastTimeStamp)
+                {
+                    printf("err, record %llu of the rings is not in order or is corrupted\n", (unsigned long long)Read);
+                    return FALSE;
+                }
+
+                LastTimeStamp = Record->TimeStamp;
+                Expected[RingIndex]++;
+                Read++;
+
+                LogRingRelease(&g_Rings[RingIndex]);
+            }
+        }
+    }
+
+    while ((RingIndex = LogRingPeekOldest(g_Rings, NumberOfRings, &Record)) != LOG_RING_NO_RECORD)
+    {
+        if (!BenchCheckRecord(Record, &Payload) || Payload.Sequence != Expected[RingIndex] || Record->TimeStamp <= LastTimeStamp)
+        {
+            printf("err, record %llu of the rings is not in order or is corrupted\n", (unsigned long long)Read);
+            return FALSE;
+        }
+
+        LastTimeStamp = Record->TimeStamp;
+        Expected[RingIndex]++;
+        Read++;
+
+        LogRingRelease(&g_Rings[RingIndex]);
+    }
+
+    for (UINT32 i = 0; i < NumberOfRings; i++)
+    {
+        Dropped -= g_Rings[i].DroppedRecords;
+
+        if (!LogRingIsEmpty(&g_Rings[i]) || Expected[i] != Sequences[i])
+        {
+            printf("err, ring %u has unread records\n", i);
+            return FALSE;
+        }
+    }
+
+    if (Read != Written || Dropped != 0)
+    {
+        printf("err, %llu records are written but %llu are read\n", (unsigned long long)Written, (unsigned long long)Read);
+        return FALSE;
+    }
+
+    printf("%2u rings:   %8llu records in time-stamp order, %llu dropped on the full rings\n",
+           NumberOfRings,
+           (unsigned long long)Read,
+           (unsigned long long)(BENCH_ORDER_RECORDS - Written));
+
+    return TRUE;
+}
+
+static void
+BenchLegacyLock(volatile LONG * Lock)
+{
+    while (__atomic_exchange_n(Lock, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        while (__atomic_load_n(Lock, __ATOMIC_RELAXED) != 0)
+        {
+            __builtin_ia32_pause();
+        }
+    }
+}
+
+static void
+BenchLegacyUnlock(volatile LONG * Lock)
+{
+    __atomic_store_n(Lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief The previous way of saving a message (the shared lock of all of the cores)
+ *
+ */
+static void
+BenchLegacyWrite(UINT32 OperationCode, const VOID * Buffer, UINT32 Length)
+{
+    BenchLegacyLock(&g_LegacyBuffer.Lock);
+
+    if (g_LegacyBuffer.CurrentIndexToWrite > BENCH_LEGACY_CAPACITY - 1)
+    {
+        g_LegacyBuffer.CurrentIndexToWrite = 0;
+    }
+
+    UINT8 * Chunk = g_LegacyBuffer.Chunks + (SIZE_T)g_LegacyBuffer.CurrentIndexToWrite * BENCH_LEGACY_CHUNK_SIZE;
+
+    ((UINT32 *)Chunk)[0] = OperationCode;
+    ((UINT32 *)Chunk)[1] = Length;
+    ((UINT32 *)Chunk)[2] = TRUE;
+
+    memcpy(Chunk + 16, Buffer, Length);
+
+    g_LegacyBuffer.CurrentIndexToWrite++;
+
+    BenchLegacyUnlock(&g_LegacyBuffer.Lock);
+}
+
+static void *
+BenchProducer(void * Context)
+{
+    PBENCH_PRODUCER Producer = (PBENCH_PRODUCER)Context;
+    UINT8           Buffer[BENCH_MESSAGE_LENGTH];
+    double          Start = BenchNow();
+
+    for (UINT32 i = 0; i < Producer->Records; i++)
+    {
+        BenchFillRecord(Buffer, Producer->Index, i, BENCH_MESSAGE_LENGTH);
+
+        if (Producer->Legacy)
+        {
+            BenchLegacyWrite(Producer->Index, Buffer, BENCH_MESSAGE_LENGTH);
+        }
+        else
+        {
+            LogRingWrite(&g_Rings[Producer->Index], Producer->Index, BenchReadTimeStamp(), Buffer, BENCH_MESSAGE_LENGTH);
+        }
+    }
+
+    Producer->Time = BenchNow() - Start;
+
+    __atomic_sub_fetch(&g_RunningProducers, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/**
+ * @brief Run the producers on their own rings while the reader drains and
+ * merges them, then check that each producer's records are read in order and
+ * that the dropped records are counted
+ *
+ */
+static BOOLEAN
+BenchTestConcurrent(UINT32 NumberOfThreads, BOOLEAN Legacy, double * Throughput)
+{
+    BENCH_PRODUCER          Producers[BENCH_MAXIMUM_THREADS];
+    UINT32                  Expected[BENCH_MAXIMUM_THREADS] = {0};
+    UINT64                  Read                            = 0;
+    UINT64                  Dropped                         = 0;
+    const LOG_RING_RECORD * Record;
+    BENCH_PAYLOAD           Payload;
+    UINT32                  RingIndex;
+    double                  Time = 0;
+
+    if (!Legacy && !BenchInitializeRings(NumberOfThreads))
+    {
+        printf("err, unable to allocate the rings\n");
+        return FALSE;
+    }
+
+    g_LegacyBuffer.CurrentIndexToWrite = 0;
+    g_RunningProducers                 = NumberOfThreads;
+
+    for (UINT32 i = 0; i < NumberOfThreads; i++)
+    {
+        Producers[i].Index   = i;
+        Producers[i].Records = BENCH_THREAD_RECORDS;
+        Producers[i].Legacy  = Legacy;
+
+        pthread_create(&Producers[i].Thread, NULL, BenchProducer, &Producers[i]);
+    }
+
+    //
+    // The reader (the DPC that completes the IRPs of user-mode)
+    //
+    while (!Legacy)
+    {
+        BOOLEAN Finished = __atomic_load_n(&g_RunningProducers, __ATOMIC_ACQUIRE) == 0;
+
+        while ((RingIndex = LogRingPeekOldest(g_Rings, NumberOfThreads, &Record)) != LOG_RING_NO_RECORD)
+        {
+            //
+            // The records of each ring are read in order, the gaps are the dropped records
+            //
+            if (!BenchCheckRecord(Record, &Payload) || Payload.Thread != RingIndex || Payload.Sequence < Expected[RingIndex])
+            {
+                printf("err, record %llu of the rings is not in order or is corrupted\n", (unsigned long long)Read);
+                return FALSE;
+            }
+
+            Expected[RingIndex] = Payload.Sequence + 1;
+            Read++;
+
+            LogRingRelease(&g_Rings[RingIndex]);
+        }
+
+        if (Finished)
+        {
+            break;
+        }
+    }
+
+    for (UINT32 i = 0; i < NumberOfThreads; i++)
+    {
+        pthread_join(Producers[i].Thread, NULL);
+
+        Time = Producers[i].Time > Time ? Producers[i].Time : Time;
+
+        if (!Legacy)
+        {
+            Dropped += g_Rings[i].DroppedRecords;
+        }
+    }
+
+    if (!Legacy && Read + Dropped != (UINT64)NumberOfThreads * BENCH_THREAD_RECORDS)
+    {
+        printf("err, %llu records are read and %llu are dropped of %llu\n",
+               (unsigned long long)Read,
+               (unsigned long long)Dropped,
+               (unsigned long long)NumberOfThreads * BENCH_THREAD_RECORDS);
+        return FALSE;
+    }
+
+    *Throughput = (double)NumberOfThreads * BENCH_THREAD_RECORDS / Time;
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    BOOLEAN Passed = TRUE;
+    double  RingThroughput;
+    double  LegacyThroughput;
+
+    g_LegacyBuffer.Chunks = malloc((SIZE_T)BENCH_LEGACY_CAPACITY * BENCH_LEGACY_CHUNK_SIZE);
+
+    if (g_LegacyBuffer.Chunks == NULL)
+    {
+        printf("err, unable to allocate the buffers\n");
+        return 1;
+    }
+
+    //
+    // Merging of the rings in the order of the time-stamps
+    //
+    for (UINT32 NumberOfRings = 1; NumberOfRings <= BENCH_MAXIMUM_THREADS && Passed; NumberOfRings *= 4)
+    {
+        Passed = BenchTestOrder(NumberOfRings);
+    }
+
+    //
+    // Concurrent producers, compared with the shared lock of the previous buffer
+    //
+    for (UINT32 NumberOfThreads = 1; NumberOfThreads <= BENCH_MAXIMUM_THREADS && Passed; NumberOfThreads *= 2)
+    {
+        Passed = BenchTestConcurrent(NumberOfThreads, FALSE, &RingThroughput) &&
+                 BenchTestConcurrent(NumberOfThreads, TRUE, &LegacyThroughput);
+
+        if (Passed)
+        {
+            printf("%2u threads: per-core rings: %8.2f M messages/s, shared lock: %8.2f M messages/s\n",
+                   NumberOfThreads,
+                   RingThroughput / 1e6,
+                   LegacyThroughput / 1e6);
+        }
+    }
+
+    for (UINT32 i = 0; i < BENCH_MAXIMUM_THREADS; i++)
+    {
+        free(g_Rings[i].Buffer);
+    }
+
+    free(g_LegacyBuffer.Chunks);
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("log ring tests passed\n");
+
+    return 0;
+}
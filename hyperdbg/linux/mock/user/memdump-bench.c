@@ -0,0 +1,959 @@
+/**
+ * @file memdump-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the chunks, the sparse writer, and the manifest
+ * of the memory dumps
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_DUMP_START     0x7ff8349f1800ull
+#define BENCH_DUMP_SIZE      (0x400000 + 0x1a40)
+#define BENCH_MEASURE_SIZE   (64 * 1024 * 1024)
+#define BENCH_MANIFEST_SIZE  (1024 * 1024)
+#define BENCH_PENDING_SIZE   1024
+#define BENCH_GARBAGE        0xcc
+#define BENCH_GEOMETRY_CASES 2000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A simulated memory (with zero pages and unreadable pages) and its
+ * in-memory dump file and manifest
+ *
+ */
+typedef struct _BENCH_DUMP
+{
+    MEM_DUMP_PLAN Plan;
+    UINT8 *       Memory;     // contents of the range
+    UINT8 *       Unreadable; // one byte for each page of the address space in the range
+    UINT64        FirstPage;
+    UINT8 *       File;
+    CHAR *        Manifest;
+    UINT32        ManifestLength;
+    UINT64        NumberOfWrites;
+    UINT64        NumberOfPunches;
+    BOOLEAN       IsFailed;
+    BOOLEAN       IsOrderChecked; // check that the chunks of the manifest are in the file
+
+} BENCH_DUMP, *PBENCH_DUMP;
+
+/**
+ * @brief The chunks that are parsed from a manifest
+ *
+ */
+typedef struct _BENCH_PARSED
+{
+    UINT32           Count;
+    UINT32           Maximum;
+    MEM_DUMP_CHUNK * Chunks;
+
+} BENCH_PARSED, *PBENCH_PARSED;
+
+/**
+ * @brief The state of checking the readable ranges
+ *
+ */
+typedef struct _BENCH_RANGES
+{
+    UINT64 * Starts;
+    UINT64 * Ends;
+    UINT32   Count;
+    UINT32   Maximum;
+
+} BENCH_RANGES, *PBENCH_RANGES;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Check the chunks and the pages of a range (they should cover the range
+ * without gaps, and the pages should not cross the page boundaries)
+ *
+ */
+static BOOLEAN
+BenchCheckGeometry(UINT64 StartAddress, UINT64 EndAddress)
+{
+    MEM_DUMP_PLAN  Plan;
+    MEM_DUMP_CHUNK Chunk;
+    UINT64         Expected = StartAddress;
+    UINT32         Offset;
+    UINT32         Length;
+
+    if (!MemDumpInitializePlan(&Plan, StartAddress, EndAddress, FALSE, 0))
+    {
+        printf("err, the range %llx-%llx is rejected\n", (unsigned long long)StartAddress, (unsigned long long)EndAddress);
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i < Plan.NumberOfChunks; i++)
+    {
+        UINT64 PageExpected;
+
+        MemDumpGetChunk(&Plan, i, &Chunk);
+
+        if (Chunk.Address != Expected || Chunk.Length == 0 || Chunk.Length > MEM_DUMP_CHUNK_SIZE ||
+            Chunk.NumberOfPages == 0 || Chunk.NumberOfPages > MEM_DUMP_PAGES_PER_CHUNK ||
+            (i != 0 && Chunk.Address % MEM_DUMP_CHUNK_SIZE != 0))
+        {
+            printf("err, chunk %llu of the range %llx-%llx is wrong\n",
+                   (unsigned long long)i,
+                   (unsigned long long)StartAddress,
+                   (unsigned long long)EndAddress);
+            return FALSE;
+        }
+
+        PageExpected = Chunk.Address;
+
+        for (UINT32 j = 0; j < Chunk.NumberOfPages; j++)
+        {
+            MemDumpGetPage(&Chunk, j, &Offset, &Length);
+
+            if (Chunk.Address + Offset != PageExpected || Length == 0 ||
+                (PageExpected & ~((UINT64)MEM_DUMP_PAGE_SIZE - 1)) != ((PageExpected + Length - 1) & ~((UINT64)MEM_DUMP_PAGE_SIZE - 1)))
+            {
+                printf("err, page %u of the chunk at %llx is wrong\n", j, (unsigned long long)Chunk.Address);
+                return FALSE;
+            }
+
+            PageExpected += Length;
+        }
+
+        if (PageExpected - Chunk.Address != Chunk.Length)
+        {
+            printf("err, the pages of the chunk at %llx don't cover it\n", (unsigned long long)Chunk.Address);
+            return FALSE;
+        }
+
+        Expected += Chunk.Length;
+    }
+
+    if (Expected != EndAddress)
+    {
+        printf("err, the chunks of the range %llx-%llx end at %llx\n",
+               (unsigned long long)StartAddress,
+               (unsigned long long)EndAddress,
+               (unsigned long long)Expected);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the geometry of the aligned, unaligned, and top of the address
+ * space ranges
+ *
+ */
+static BOOLEAN
+BenchTestGeometry(void)
+{
+    static const UINT64 Cases[][2] = {
+        {0x1000, 0x2000},
+        {0x1001, 0x1002},
+        {0x10ff0, 0x30010},
+        {0x0, 0x10000},
+        {0xffff, 0x10001},
+        {0xfffffffffff00000ull, 0xffffffffffffffffull},
+        {0xffffffffffff0800ull, 0xffffffffffffffffull},
+        {0xfffffffffffffffeull, 0xffffffffffffffffull},
+    };
+    MEM_DUMP_PLAN Plan;
+
+    for (UINT32 i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        if (!BenchCheckGeometry(Cases[i][0], Cases[i][1]))
+        {
+            return FALSE;
+        }
+    }
+
+    for (UINT32 i = 0; i < BENCH_GEOMETRY_CASES; i++)
+    {
+        UINT64 Start = BenchRandom() & 0xffffffffffffull;
+        UINT64 Size  = BenchRandom() % (8 * MEM_DUMP_CHUNK_SIZE) + 1;
+
+        if (!BenchCheckGeometry(Start, Start + Size))
+        {
+            return FALSE;
+        }
+    }
+
+    if (MemDumpInitializePlan(&Plan, 0x2000, 0x2000, FALSE, 0) || MemDumpInitializePlan(&Plan, 0x3000, 0x2000, FALSE, 0))
+    {
+        printf("err, an empty range is accepted\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the classification, the hash, and the verification of the chunks
+ *
+ */
+static BOOLEAN
+BenchTestClassify(void)
+{
+    static UINT8   Buffer[MEM_DUMP_CHUNK_SIZE];
+    MEM_DUMP_PLAN  Plan;
+    MEM_DUMP_CHUNK Chunk;
+    UINT32         Offset;
+    UINT32         Length;
+
+    MemDumpInitializePlan(&Plan, 0x40000, 0x80000, TRUE, 0);
+    MemDumpGetChunk(&Plan, 1, &Chunk);
+
+    for (UINT32 i = 0; i < MEM_DUMP_CHUNK_SIZE; i++)
+    {
+        Buffer[i] = (UINT8)BenchRandom();
+    }
+
+    //
+    // Pages 2 and 9 are zero, 5 and 9 are not readable (an unreadable page is
+    // never zero)
+    //
+    memset(Buffer + 2 * MEM_DUMP_PAGE_SIZE, 0, MEM_DUMP_PAGE_SIZE);
+    memset(Buffer + 9 * MEM_DUMP_PAGE_SIZE, 0, MEM_DUMP_PAGE_SIZE);
+
+    Chunk.ReadableMask = 0xffff & ~(1u << 5) & ~(1u << 9);
+
+    MemDumpClassifyChunk(&Chunk, Buffer);
+
+    if (Chunk.ZeroMask != (1u << 2))
+    {
+        printf("err, the zero mask is %x\n", Chunk.ZeroMask);
+        return FALSE;
+    }
+
+    if (!MemDumpVerifyChunk(&Chunk, Buffer))
+    {
+        printf("err, the chunk is not verified\n");
+        return FALSE;
+    }
+
+    //
+    // The unreadable pages are not a part of the hash
+    //
+    MemDumpGetPage(&Chunk, 5, &Offset, &Length);
+    memset(Buffer + Offset, BENCH_GARBAGE, Length);
+
+    if (!MemDumpVerifyChunk(&Chunk, Buffer))
+    {
+        printf("err, an unreadable page changed the hash\n");
+        return FALSE;
+    }
+
+    Buffer[7 * MEM_DUMP_PAGE_SIZE + 100] ^= 1;
+
+    if (MemDumpVerifyChunk(&Chunk, Buffer))
+    {
+        printf("err, a changed data page is verified\n");
+        return FALSE;
+    }
+
+    Buffer[7 * MEM_DUMP_PAGE_SIZE + 100] ^= 1;
+    Buffer[2 * MEM_DUMP_PAGE_SIZE + 7] = 1;
+
+    if (MemDumpVerifyChunk(&Chunk, Buffer))
+    {
+        printf("err, a changed zero page is verified\n");
+        return FALSE;
+    }
+
+    //
+    // The word-wise hash should handle any length
+    //
+    if (MemDumpHash(MEM_DUMP_HASH_SEED, Buffer, 13) == MemDumpHash(MEM_DUMP_HASH_SEED, Buffer, 12) ||
+        MemDumpHash(MEM_DUMP_HASH_SEED, Buffer, 0) != MEM_DUMP_HASH_SEED)
+    {
+        printf("err, the hash of the tail is wrong\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchAddParsedChunk(PVOID Context, const MEM_DUMP_CHUNK * Chunk)
+{
+    BENCH_PARSED * Parsed = (BENCH_PARSED *)Context;
+
+    if (Parsed->Count == Parsed->Maximum)
+    {
+        return FALSE;
+    }
+
+    Parsed->Chunks[Parsed->Count++] = *Chunk;
+
+    return TRUE;
+}
+
+static UINT32
+BenchParse(const MEM_DUMP_PLAN * Plan, const CHAR * Manifest, SIZE_T Size, BENCH_PARSED * Parsed, BOOLEAN * Status)
+{
+    Parsed->Count = 0;
+    *Status       = MemDumpParseManifest(Plan, Manifest, Size, BenchAddParsedChunk, Parsed);
+
+    return Parsed->Count;
+}
+
+/**
+ * @brief Check formatting and parsing the manifests (a torn or an invalid line
+ * ends the parsing)
+ *
+ */
+static BOOLEAN
+BenchTestManifest(void)
+{
+    static CHAR    Manifest[64 * MEM_DUMP_MAXIMUM_LINE];
+    MEM_DUMP_CHUNK Chunks[8];
+    MEM_DUMP_CHUNK ParsedChunks[16];
+    BENCH_PARSED   Parsed = {0, 16, ParsedChunks};
+    MEM_DUMP_PLAN  Plan;
+    MEM_DUMP_PLAN  Other;
+    UINT32         Length;
+    UINT32         Full;
+    BOOLEAN        Status;
+
+    MemDumpInitializePlan(&Plan, 0xfffff80100001800ull, 0xfffff80100081000ull, FALSE, 0x1c0);
+
+    Length = MemDumpFormatHeader(&Plan, Manifest, sizeof(Manifest));
+
+    for (UINT32 i = 0; i < 8; i++)
+    {
+        MemDumpGetChunk(&Plan, i, &Chunks[i]);
+
+        Chunks[i].ReadableMask = (UINT32)BenchRandom() & ((1u << Chunks[i].NumberOfPages) - 1);
+        Chunks[i].ZeroMask     = (UINT32)BenchRandom() & Chunks[i].ReadableMask;
+        Chunks[i].Hash         = BenchRandom();
+
+        Length += MemDumpFormatChunk(&Chunks[i], Manifest + Length, sizeof(Manifest) - Length);
+
+        if (i == 3)
+        {
+            Length += MemDumpFormatRange(0x1000, 0x2000, Manifest + Length, sizeof(Manifest) - Length);
+        }
+    }
+
+    Full = Length;
+
+    if (BenchParse(&Plan, Manifest, Full, &Parsed, &Status) != 8 || !Status ||
+        memcmp(ParsedChunks, Chunks, sizeof(Chunks)) != 0)
+    {
+        printf("err, the chunks of the manifest are not parsed\n");
+        return FALSE;
+    }
+
+    //
+    // The manifest of another range (or process) is rejected
+    //
+    MemDumpInitializePlan(&Other, 0xfffff80100001800ull, 0xfffff80100081000ull, FALSE, 0x1c4);
+
+    if (BenchParse(&Other, Manifest, Full, &Parsed, &Status) != 0 || Status)
+    {
+        printf("err, the manifest of another dump is accepted\n");
+        return FALSE;
+    }
+
+    //
+    // A torn line is ignored
+    //
+    if (BenchParse(&Plan, Manifest, Full - 1, &Parsed, &Status) != 7 || !Status)
+    {
+        printf("err, a torn line is parsed\n");
+        return FALSE;
+    }
+
+    //
+    // An invalid line (and everything after it) is ignored
+    //
+    Length = MemDumpFormatChunk(&Chunks[0], Manifest + Full, sizeof(Manifest) - Full);
+
+    Manifest[Full + 2] = 'x';
+
+    Full += Length;
+    Full += MemDumpFormatChunk(&Chunks[1], Manifest + Full, sizeof(Manifest) - Full);
+
+    if (BenchParse(&Plan, Manifest, Full, &Parsed, &Status) != 8 || !Status)
+    {
+        printf("err, the lines after an invalid line are parsed\n");
+        return FALSE;
+    }
+
+    //
+    // The chunks outside of the range and the masks outside of the chunks
+    //
+    Length = MemDumpFormatHeader(&Plan, Manifest, sizeof(Manifest));
+    Full   = Length + (UINT32)snprintf(Manifest + Length, sizeof(Manifest) - Length, "c 9 1 0 0\n");
+
+    if (BenchParse(&Plan, Manifest, Full, &Parsed, &Status) != 0 || !Status)
+    {
+        printf("err, a chunk outside of the range is parsed\n");
+        return FALSE;
+    }
+
+    Full = Length + (UINT32)snprintf(Manifest + Length, sizeof(Manifest) - Length, "c 0 10000 0 0\n");
+
+    if (BenchParse(&Plan, Manifest, Full, &Parsed, &Status) != 0)
+    {
+        printf("err, a page outside of the chunk is parsed\n");
+        return FALSE;
+    }
+
+    Full = Length + (UINT32)snprintf(Manifest + Length, sizeof(Manifest) - Length, "c 1 1 3 0\n");
+
+    if (BenchParse(&Plan, Manifest, Full, &Parsed, &Status) != 0)
+    {
+        printf("err, an unreadable zero page is parsed\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchAddRange(PVOID Context, UINT64 StartAddress, UINT64 EndAddress)
+{
+    BENCH_RANGES * Ranges = (BENCH_RANGES *)Context;
+
+    if (Ranges->Count == Ranges->Maximum)
+    {
+        return FALSE;
+    }
+
+    Ranges->Starts[Ranges->Count] = StartAddress;
+    Ranges->Ends[Ranges->Count]   = EndAddress;
+    Ranges->Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the readable ranges against the pages one by one
+ *
+ */
+static BOOLEAN
+BenchTestRanges(void)
+{
+    static UINT32  Masks[64];
+    static UINT64  Starts[1024];
+    static UINT64  Ends[1024];
+    BENCH_RANGES   Ranges = {Starts, Ends, 0, 1024};
+    MEM_DUMP_PLAN  Plan;
+    MEM_DUMP_CHUNK Chunk;
+    UINT32         Current = 0;
+    UINT64         Expected;
+    UINT32         Offset;
+    UINT32         Length;
+
+    MemDumpInitializePlan(&Plan, 0x123456, 0x123456 + 40 * MEM_DUMP_CHUNK_SIZE + 0x345, TRUE, 0);
+
+    for (UINT64 i = 0; i < Plan.NumberOfChunks; i++)
+    {
+        UINT64 Kind = BenchRandom() % 4;
+
+        MemDumpGetChunk(&Plan, i, &Chunk);
+
+        Masks[i] = Kind == 0 ? 0 : Kind == 1 ? 0xffffffff : (UINT32)BenchRandom();
+        Masks[i] &= (1u << Chunk.NumberOfPages) - 1;
+    }
+
+    if (!MemDumpForEachReadableRange(&Plan, Masks, BenchAddRange, &Ranges))
+    {
+        printf("err, too many ranges\n");
+        return FALSE;
+    }
+
+    //
+    // Each readable page should be in the current range, and each range should
+    // end at an unreadable page (or the end of the dump)
+    //
+    for (UINT64 i = 0; i < Plan.NumberOfChunks; i++)
+    {
+        MemDumpGetChunk(&Plan, i, &Chunk);
+
+        for (UINT32 j = 0; j < Chunk.NumberOfPages; j++)
+        {
+            MemDumpGetPage(&Chunk, j, &Offset, &Length);
+
+            Expected = Chunk.Address + Offset;
+
+            if (Masks[i] & (1u << j))
+            {
+                if (Current == Ranges.Count || Expected < Starts[Current] || Expected + Length > Ends[Current])
+                {
+                    printf("err, the readable page at %llx is not in a range\n", (unsigned long long)Expected);
+                    return FALSE;
+                }
+
+                if (Expected + Length == Ends[Current])
+                {
+                    Current++;
+                }
+            }
+            else if (Current < Ranges.Count && Expected >= Starts[Current])
+            {
+                printf("err, the unreadable page at %llx is in a range\n", (unsigned long long)Expected);
+                return FALSE;
+            }
+        }
+    }
+
+    if (Current != Ranges.Count)
+    {
+        printf("err, %u ranges are expected (%u)\n", Current, Ranges.Count);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchWriteData(PVOID Context, UINT64 Offset, const VOID * Buffer, UINT32 Length)
+{
+    BENCH_DUMP * Dump = (BENCH_DUMP *)Context;
+
+    //
+    // Each write should end on the next aligned offset
+    //
+    if (Length == 0 || Length > MEM_DUMP_WRITE_SIZE ||
+        Offset / MEM_DUMP_WRITE_SIZE != (Offset + Length - 1) / MEM_DUMP_WRITE_SIZE ||
+        Offset + Length > Dump->Plan.EndAddress - Dump->Plan.StartAddress)
+    {
+        printf("err, write of %x bytes at %llx\n", Length, (unsigned long long)Offset);
+        Dump->IsFailed = TRUE;
+        return FALSE;
+    }
+
+    if (Dump->File != NULL)
+    {
+        memcpy(Dump->File + Offset, Buffer, Length);
+    }
+
+    Dump->NumberOfWrites++;
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchPunchHole(PVOID Context, UINT64 Offset, UINT64 Length)
+{
+    BENCH_DUMP * Dump = (BENCH_DUMP *)Context;
+
+    memset(Dump->File + Offset, 0, (SIZE_T)Length);
+    Dump->NumberOfPunches++;
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchCheckWrittenChunk(PVOID Context, const MEM_DUMP_CHUNK * Chunk)
+{
+    BENCH_DUMP * Dump = (BENCH_DUMP *)Context;
+
+    return MemDumpVerifyChunk(Chunk, Dump->File + (Chunk->Address - Dump->Plan.StartAddress));
+}
+
+static BOOLEAN
+BenchWriteManifest(PVOID Context, const CHAR * Text, UINT32 Length)
+{
+    BENCH_DUMP * Dump = (BENCH_DUMP *)Context;
+    static CHAR  Lines[BENCH_PENDING_SIZE + MEM_DUMP_MAXIMUM_LINE];
+    UINT32       HeaderLength;
+
+    if (Dump->ManifestLength + Length > BENCH_MANIFEST_SIZE)
+    {
+        Dump->IsFailed = TRUE;
+        return FALSE;
+    }
+
+    //
+    // The chunks of the manifest should already be in the file
+    //
+    if (Dump->IsOrderChecked)
+    {
+        HeaderLength = MemDumpFormatHeader(&Dump->Plan, Lines, sizeof(Lines));
+        memcpy(Lines + HeaderLength, Text, Length);
+
+        if (!MemDumpParseManifest(&Dump->Plan, Lines, HeaderLength + Length, BenchCheckWrittenChunk, Dump))
+        {
+            printf("err, a chunk is recorded before it's written\n");
+            Dump->IsFailed = TRUE;
+            return FALSE;
+        }
+    }
+
+    memcpy(Dump->Manifest + Dump->ManifestLength, Text, Length);
+    Dump->ManifestLength += Length;
+
+    return TRUE;
+}
+
+static const MEM_DUMP_WRITER_CALLBACKS g_BenchCallbacks = {BenchWriteData, BenchPunchHole, BenchWriteManifest};
+
+/**
+ * @brief Simulate a memory with runs of data, zero, and unreadable pages
+ *
+ */
+static BOOLEAN
+BenchCreateDump(PBENCH_DUMP Dump, UINT64 StartAddress, UINT64 Size, BOOLEAN IsFileNeeded)
+{
+    UINT64 NumberOfPages;
+    UINT64 Kind = 0;
+
+    memset(Dump, 0, sizeof(BENCH_DUMP));
+
+    MemDumpInitializePlan(&Dump->Plan, StartAddress, StartAddress + Size, TRUE, 0);
+
+    Dump->FirstPage  = StartAddress / MEM_DUMP_PAGE_SIZE;
+    NumberOfPages    = (StartAddress + Size - 1) / MEM_DUMP_PAGE_SIZE - Dump->FirstPage + 1;
+    Dump->Memory     = (UINT8 *)malloc((SIZE_T)Size);
+    Dump->Unreadable = (UINT8 *)calloc((SIZE_T)NumberOfPages, 1);
+    Dump->File       = IsFileNeeded ? (UINT8 *)malloc((SIZE_T)Size) : NULL;
+    Dump->Manifest   = (CHAR *)malloc(BENCH_MANIFEST_SIZE);
+
+    if (Dump->Memory == NULL || Dump->Unreadable == NULL || (IsFileNeeded && Dump->File == NULL) || Dump->Manifest == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i < Size; i += sizeof(UINT64))
+    {
+        UINT64 Value = BenchRandom();
+
+        memcpy(Dump->Memory + i, &Value, Size - i < sizeof(UINT64) ? (SIZE_T)(Size - i) : sizeof(UINT64));
+    }
+
+    for (UINT64 i = 0; i < NumberOfPages; i++)
+    {
+        UINT64 Base = (Dump->FirstPage + i) * MEM_DUMP_PAGE_SIZE;
+        UINT64 From = Base < StartAddress ? StartAddress : Base;
+        UINT64 To   = Base + MEM_DUMP_PAGE_SIZE > StartAddress + Size ? StartAddress + Size : Base + MEM_DUMP_PAGE_SIZE;
+
+        //
+        // Keep the kind of the pages for a few pages (0: data, 1: zero, 2: unreadable)
+        //
+        if (BenchRandom() % 6 == 0)
+        {
+            Kind = BenchRandom() % 3;
+        }
+
+        if (Kind == 1)
+        {
+            memset(Dump->Memory + (From - StartAddress), 0, (SIZE_T)(To - From));
+        }
+        else if (Kind == 2)
+        {
+            Dump->Unreadable[i] = 1;
+        }
+    }
+
+    return TRUE;
+}
+
+static VOID
+BenchFreeDump(PBENCH_DUMP Dump)
+{
+    free(Dump->Memory);
+    free(Dump->Unreadable);
+    free(Dump->File);
+    free(Dump->Manifest);
+}
+
+/**
+ * @brief Read a chunk from the simulated memory like the readers of the engine
+ *
+ */
+static VOID
+BenchReadChunk(const BENCH_DUMP * Dump, UINT64 Index, PMEM_DUMP_CHUNK Chunk, UINT8 * Buffer)
+{
+    UINT64 FirstPage;
+
+    MemDumpGetChunk(&Dump->Plan, Index, Chunk);
+
+    FirstPage = Chunk->Address / MEM_DUMP_PAGE_SIZE - Dump->FirstPage;
+
+    memcpy(Buffer, Dump->Memory + (Chunk->Address - Dump->Plan.StartAddress), Chunk->Length);
+
+    for (UINT32 i = 0; i < Chunk->NumberOfPages; i++)
+    {
+        UINT32 Offset;
+        UINT32 Length;
+
+        MemDumpGetPage(Chunk, i, &Offset, &Length);
+
+        if (Dump->Unreadable[FirstPage + i])
+        {
+            memset(Buffer + Offset, BENCH_GARBAGE, Length);
+        }
+        else
+        {
+            Chunk->ReadableMask |= 1u << i;
+        }
+    }
+
+    MemDumpClassifyChunk(Chunk, Buffer);
+}
+
+/**
+ * @brief Write the chunks [From, To) of a dump (the verified chunks are skipped)
+ *
+ */
+static BOOLEAN
+BenchWriteChunks(PBENCH_DUMP Dump, UINT64 From, UINT64 To, const BENCH_PARSED * Verified, BOOLEAN PunchHoles, PMEM_DUMP_WRITER Writer)
+{
+    static UINT8   Staging[MEM_DUMP_WRITE_SIZE];
+    static UINT8   Buffer[MEM_DUMP_CHUNK_SIZE];
+    static CHAR    Pending[BENCH_PENDING_SIZE];
+    MEM_DUMP_CHUNK Chunk;
+    UINT32         Next = 0;
+    BOOLEAN        Status;
+
+    MemDumpWriterInitialize(Writer, &Dump->Plan, &g_BenchCallbacks, Dump, Staging, Pending, sizeof(Pending), PunchHoles);
+
+    for (UINT64 i = From; i < To; i++)
+    {
+        if (Verified != NULL && Next < Verified->Count && Verified->Chunks[Next].Index == i)
+        {
+            Status = MemDumpWriterSkipChunk(Writer, &Verified->Chunks[Next++]);
+        }
+        else
+        {
+            BenchReadChunk(Dump, i, &Chunk, Buffer);
+
+            Status = MemDumpWriterPutChunk(Writer, &Chunk, Buffer);
+        }
+
+        if (!Status)
+        {
+            return FALSE;
+        }
+    }
+
+    return MemDumpWriterFlush(Writer);
+}
+
+/**
+ * @brief Check the dump file (the data pages are stored, the others are zero)
+ *
+ */
+static BOOLEAN
+BenchCheckFile(const BENCH_DUMP * Dump, const MEM_DUMP_WRITER * Writer)
+{
+    UINT64 Size = Dump->Plan.EndAddress - Dump->Plan.StartAddress;
+
+    for (UINT64 i = 0; i < Size; i++)
+    {
+        UINT64 Page     = (Dump->Plan.StartAddress + i) / MEM_DUMP_PAGE_SIZE - Dump->FirstPage;
+        UINT8  Expected = Dump->Unreadable[Page] ? 0 : Dump->Memory[i];
+
+        if (Dump->File[i] != Expected)
+        {
+            printf("err, byte %llx of the dump file is %x (expected %x)\n", (unsigned long long)i, Dump->File[i], Expected);
+            return FALSE;
+        }
+    }
+
+    if (Writer->DataBytes + Writer->ZeroBytes + Writer->UnreadableBytes != Size)
+    {
+        printf("err, the statistics don't cover the dump\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the sparse writer, the order of the manifest, and resuming an
+ * interrupted dump
+ *
+ */
+static BOOLEAN
+BenchTestWriter(void)
+{
+    static MEM_DUMP_CHUNK VerifiedChunks[0x1000];
+    BENCH_PARSED          Verified = {0, 0x1000, VerifiedChunks};
+    BENCH_PARSED          All      = {0, 0x1000, VerifiedChunks};
+    BENCH_DUMP            Dump;
+    MEM_DUMP_WRITER       Writer;
+    CHAR                  Header[MEM_DUMP_MAXIMUM_LINE];
+    UINT32                HeaderLength;
+    UINT64                Half;
+    UINT64                Corrupted;
+    UINT32                Count = 0;
+    BOOLEAN               Status;
+
+    if (!BenchCreateDump(&Dump, BENCH_DUMP_START, BENCH_DUMP_SIZE, TRUE))
+    {
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    Dump.IsOrderChecked = TRUE;
+
+    //
+    // A new (sparse) file, the holes are never written
+    //
+    memset(Dump.File, 0, BENCH_DUMP_SIZE);
+
+    HeaderLength = MemDumpFormatHeader(&Dump.Plan, Header, sizeof(Header));
+    memcpy(Dump.Manifest, Header, HeaderLength);
+    Dump.ManifestLength = HeaderLength;
+
+    if (!BenchWriteChunks(&Dump, 0, Dump.Plan.NumberOfChunks, NULL, FALSE, &Writer) || Dump.IsFailed ||
+        !BenchCheckFile(&Dump, &Writer) || Dump.NumberOfPunches != 0)
+    {
+        printf("err, the new dump file is wrong\n");
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    if (BenchParse(&Dump.Plan, Dump.Manifest, Dump.ManifestLength, &All, &Status) != Dump.Plan.NumberOfChunks || !Status)
+    {
+        printf("err, the manifest doesn't record all of the chunks\n");
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    printf("new dump: 0x%llx data, 0x%llx zero, 0x%llx unreadable bytes, %llu writes\n",
+           (unsigned long long)Writer.DataBytes,
+           (unsigned long long)Writer.ZeroBytes,
+           (unsigned long long)Writer.UnreadableBytes,
+           (unsigned long long)Dump.NumberOfWrites);
+
+    //
+    // Interrupt a dump into an old file in the middle (the old contents are
+    // garbage), then corrupt a written chunk and resume it
+    //
+    memset(Dump.File, BENCH_GARBAGE, BENCH_DUMP_SIZE);
+    memcpy(Dump.Manifest, Header, HeaderLength);
+    Dump.ManifestLength = HeaderLength;
+
+    Half = Dump.Plan.NumberOfChunks / 2;
+
+    if (!BenchWriteChunks(&Dump, 0, Half, NULL, TRUE, &Writer) || Dump.IsFailed)
+    {
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    //
+    // The torn last line of the interrupted manifest
+    //
+    Dump.ManifestLength -= 3;
+
+    Corrupted = Half / 3;
+    MemDumpGetChunk(&Dump.Plan, Corrupted, &VerifiedChunks[0]);
+    memset(Dump.File + (VerifiedChunks[0].Address - Dump.Plan.StartAddress), 0x5a, VerifiedChunks[0].Length);
+
+    BenchParse(&Dump.Plan, Dump.Manifest, Dump.ManifestLength, &Verified, &Status);
+
+    for (UINT32 i = 0; i < Verified.Count; i++)
+    {
+        if (BenchCheckWrittenChunk(&Dump, &VerifiedChunks[i]))
+        {
+            VerifiedChunks[Count++] = VerifiedChunks[i];
+        }
+    }
+
+    Verified.Count = Count;
+
+    if (!Status || Count != Half - 2)
+    {
+        printf("err, %u chunks of the interrupted dump are verified (expected %llu)\n", Count, (unsigned long long)Half - 2);
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    memcpy(Dump.Manifest, Header, HeaderLength);
+    Dump.ManifestLength = HeaderLength;
+
+    if (!BenchWriteChunks(&Dump, 0, Dump.Plan.NumberOfChunks, &Verified, TRUE, &Writer) || Dump.IsFailed ||
+        !BenchCheckFile(&Dump, &Writer))
+    {
+        printf("err, the resumed dump file is wrong\n");
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    if (BenchParse(&Dump.Plan, Dump.Manifest, Dump.ManifestLength, &All, &Status) != Dump.Plan.NumberOfChunks || !Status)
+    {
+        printf("err, the resumed manifest doesn't record all of the chunks\n");
+        BenchFreeDump(&Dump);
+        return FALSE;
+    }
+
+    BenchFreeDump(&Dump);
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure classifying and writing the chunks
+ *
+ */
+static VOID
+BenchMeasure(void)
+{
+    BENCH_DUMP      Dump;
+    MEM_DUMP_WRITER Writer;
+    double          Start;
+    double          Elapsed;
+
+    if (!BenchCreateDump(&Dump, 0x100000000ull, BENCH_MEASURE_SIZE, TRUE))
+    {
+        BenchFreeDump(&Dump);
+        return;
+    }
+
+    Start = BenchNow();
+
+    BenchWriteChunks(&Dump, 0, Dump.Plan.NumberOfChunks, NULL, FALSE, &Writer);
+
+    Elapsed = BenchNow() - Start;
+
+    printf("dump of %u MB: %.1f MB/s (%.1f%% data, %llu writes of %.1f KB on average)\n",
+           BENCH_MEASURE_SIZE >> 20,
+           BenchThroughput(BENCH_MEASURE_SIZE, Elapsed),
+           100.0 * Writer.DataBytes / BENCH_MEASURE_SIZE,
+           (unsigned long long)Writer.NumberOfWrites,
+           Writer.NumberOfWrites == 0 ? 0.0 : Writer.DataBytes / 1024.0 / Writer.NumberOfWrites);
+
+    Start = BenchNow();
+
+    MemDumpHash(MEM_DUMP_HASH_SEED, Dump.Memory, BENCH_MEASURE_SIZE);
+
+    Elapsed = BenchNow() - Start;
+
+    printf("hash: %.1f MB/s\n", BenchThroughput(BENCH_MEASURE_SIZE, Elapsed));
+
+    BenchFreeDump(&Dump);
+}
+
+int
+main(void)
+{
+    if (!BenchTestGeometry() || !BenchTestClassify() || !BenchTestManifest() || !BenchTestRanges() || !BenchTestWriter())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("memory dump tests passed\n");
+
+    return 0;
+}
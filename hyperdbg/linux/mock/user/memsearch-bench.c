@@ -0,0 +1,434 @@
+/**
+ * @file memsearch-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the memory search engine over synthetic address spaces
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_PAGE_SIZE         0x1000
+#define BENCH_BASE_ADDRESS      0xfffff80000000000ull
+#define BENCH_SPACE_SIZE        (64 * 1024 * 1024)
+#define BENCH_HOLE_INTERVAL     97 // every n-th page is not readable
+#define BENCH_PLANTED_PATTERNS  4096
+#define BENCH_MAXIMUM_MATCHES   (1024 * 1024)
+#define BENCH_CHUNKING_ROUNDS   4
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A synthetic address space
+ *
+ */
+typedef struct _BENCH_SPACE
+{
+    UINT8 * Memory;
+    UINT64  Size;
+
+} BENCH_SPACE, *PBENCH_SPACE;
+
+/**
+ * @brief A match of the search
+ *
+ */
+typedef struct _BENCH_MATCH
+{
+    UINT64 Address;
+    UINT32 PatternIndex;
+
+} BENCH_MATCH, *PBENCH_MATCH;
+
+/**
+ * @brief The collected matches
+ *
+ */
+typedef struct _BENCH_MATCHES
+{
+    BENCH_MATCH * Entries;
+    UINT64        Count;
+
+} BENCH_MATCHES, *PBENCH_MATCHES;
+
+/**
+ * @brief A pattern of the tests
+ *
+ */
+typedef struct _BENCH_PATTERN
+{
+    const char * Name;
+    UINT8        Bytes[32];
+    UINT8        Mask[32];
+    BOOLEAN      Masked;
+    UINT32       Size;
+    UINT32       Alignment;
+
+} BENCH_PATTERN, *PBENCH_PATTERN;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static BOOLEAN
+BenchIsPageReadable(UINT64 Offset)
+{
+    return ((Offset / BENCH_PAGE_SIZE) % BENCH_HOLE_INTERVAL) != (BENCH_HOLE_INTERVAL - 1);
+}
+
+/**
+ * @brief Fill the space like kernel memory (zero pages, pointers and random data)
+ * and plant the patterns, some of them across the pages
+ *
+ */
+static void
+BenchBuildSpace(PBENCH_SPACE Space, const BENCH_PATTERN * Patterns, UINT32 NumberOfPatterns)
+{
+    UINT64 * Qwords = (UINT64 *)Space->Memory;
+
+    for (UINT64 i = 0; i < Space->Size / sizeof(UINT64); i++)
+    {
+        switch ((i / (BENCH_PAGE_SIZE / sizeof(UINT64))) % 4)
+        {
+        case 0:
+            Qwords[i] = 0;
+            break;
+        case 1:
+            Qwords[i] = BENCH_BASE_ADDRESS + (BenchRandom() % Space->Size & ~0x7ull);
+            break;
+        default:
+            Qwords[i] = BenchRandom();
+            break;
+        }
+    }
+
+    for (UINT32 i = 0; i < BENCH_PLANTED_PATTERNS; i++)
+    {
+        const BENCH_PATTERN * Pattern = &Patterns[i % NumberOfPatterns];
+        UINT64                Offset;
+
+        if (i % 3 == 0)
+        {
+            //
+            // Across a page boundary
+            //
+            Offset = ((BenchRandom() % (Space->Size / BENCH_PAGE_SIZE - 1)) + 1) * BENCH_PAGE_SIZE;
+            Offset -= 1 + BenchRandom() % (Pattern->Size - 1);
+        }
+        else
+        {
+            Offset = BenchRandom() % (Space->Size - Pattern->Size);
+        }
+
+        Offset -= Offset % Pattern->Alignment;
+
+        memcpy(Space->Memory + Offset, Pattern->Bytes, Pattern->Size);
+    }
+}
+
+static BOOLEAN
+BenchSaveMatch(PVOID Context, UINT64 Address, UINT32 PatternIndex)
+{
+    PBENCH_MATCHES Matches = (PBENCH_MATCHES)Context;
+
+    if (Matches->Count == BENCH_MAXIMUM_MATCHES)
+    {
+        return FALSE;
+    }
+
+    Matches->Entries[Matches->Count].Address      = Address;
+    Matches->Entries[Matches->Count].PatternIndex = PatternIndex;
+    Matches->Count++;
+
+    return TRUE;
+}
+
+/**
+ * @brief Search the space by the engine, each readable run is given in
+ * chunks (pages, or random sizes if Chunking is set)
+ *
+ */
+static void
+BenchSearchEngine(PBENCH_SPACE          Space,
+                  const BENCH_PATTERN * Patterns,
+                  UINT32                NumberOfPatterns,
+                  BOOLEAN               Chunking,
+                  PBENCH_MATCHES        Matches)
+{
+    MEMORY_SEARCH_CONTEXT Context;
+    UINT64                Offset = 0;
+    UINT64                Size;
+
+    Matches->Count = 0;
+
+    MemorySearchInitialize(&Context, BENCH_BASE_ADDRESS, BenchSaveMatch, Matches);
+
+    for (UINT32 i = 0; i < NumberOfPatterns; i++)
+    {
+        BOOLEAN Added = MemorySearchAddPattern(&Context,
+                                               Patterns[i].Bytes,
+                                               Patterns[i].Masked ? Patterns[i].Mask : NULL,
+                                               Patterns[i].Size,
+                                               Patterns[i].Alignment);
+        assert(Added);
+        (void)Added;
+    }
+
+    while (Offset < Space->Size)
+    {
+        if (Chunking)
+        {
+            Size = 1 + BenchRandom() % (2 * BENCH_PAGE_SIZE);
+        }
+        else
+        {
+            Size = BENCH_PAGE_SIZE - Offset % BENCH_PAGE_SIZE;
+        }
+
+        //
+        // Don't cross the unreadable pages
+        //
+        if (Offset / BENCH_PAGE_SIZE != (Offset + Size - 1) / BENCH_PAGE_SIZE)
+        {
+            Size = BENCH_PAGE_SIZE - Offset % BENCH_PAGE_SIZE;
+        }
+
+        if (Offset + Size > Space->Size)
+        {
+            Size = Space->Size - Offset;
+        }
+
+        if (BenchIsPageReadable(Offset) &&
+            !MemorySearchScan(&Context, BENCH_BASE_ADDRESS + Offset, Space->Memory + Offset, (UINT32)Size))
+        {
+            break;
+        }
+
+        Offset += Size;
+    }
+}
+
+/**
+ * @brief The reference search (checks every position of every pattern)
+ *
+ */
+static void
+BenchSearchReference(PBENCH_SPACE Space, const BENCH_PATTERN * Patterns, UINT32 NumberOfPatterns, PBENCH_MATCHES Matches)
+{
+    UINT64 RunStart = 0;
+    UINT64 RunEnd;
+
+    Matches->Count = 0;
+
+    while (RunStart < Space->Size)
+    {
+        if (!BenchIsPageReadable(RunStart))
+        {
+            RunStart += BENCH_PAGE_SIZE;
+            continue;
+        }
+
+        for (RunEnd = RunStart; RunEnd < Space->Size && BenchIsPageReadable(RunEnd); RunEnd += BENCH_PAGE_SIZE)
+            ;
+
+        for (UINT64 Position = RunStart; Position < RunEnd; Position++)
+        {
+            for (UINT32 i = 0; i < NumberOfPatterns; i++)
+            {
+                const BENCH_PATTERN * Pattern = &Patterns[i];
+                BOOLEAN               Match   = TRUE;
+
+                if (Position + Pattern->Size > RunEnd || (Position % Pattern->Alignment) != 0)
+                {
+                    continue;
+                }
+
+                for (UINT32 j = 0; j < Pattern->Size && Match; j++)
+                {
+                    UINT8 Mask = Pattern->Masked ? Pattern->Mask[j] : 0xff;
+
+                    Match = ((Space->Memory[Position + j] ^ Pattern->Bytes[j]) & Mask) == 0;
+                }
+
+                if (Match)
+                {
+                    BenchSaveMatch(Matches, BENCH_BASE_ADDRESS + Position, i);
+                }
+            }
+        }
+
+        RunStart = RunEnd;
+    }
+}
+
+/**
+ * @brief The search of the 's' commands before the engine (reads one chunk of
+ * the pattern at a time, at each position)
+ *
+ */
+static UINT64
+BenchSearchLegacy(PBENCH_SPACE Space, const BENCH_PATTERN * Pattern)
+{
+    UINT64 Count = 0;
+    UINT64 Cmp64;
+    UINT64 Value;
+
+    for (UINT64 Position = 0; Position + Pattern->Size <= Space->Size; Position += Pattern->Alignment)
+    {
+        BOOLEAN StillMatch = TRUE;
+
+        if (!BenchIsPageReadable(Position))
+        {
+            continue;
+        }
+
+        for (UINT32 i = 0; i < Pattern->Size && StillMatch; i += Pattern->Alignment)
+        {
+            Cmp64 = 0;
+            Value = 0;
+
+            memcpy(&Cmp64, Space->Memory + Position + i, Pattern->Alignment);
+            memcpy(&Value, Pattern->Bytes + i, Pattern->Alignment);
+
+            StillMatch = Cmp64 == Value;
+        }
+
+        if (StillMatch)
+        {
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+static BOOLEAN
+BenchCompare(const char * Name, const BENCH_MATCHES * Expected, const BENCH_MATCHES * Actual)
+{
+    if (Expected->Count != Actual->Count)
+    {
+        printf("err, %s: expected %llu matches, found %llu\n",
+               Name,
+               (unsigned long long)Expected->Count,
+               (unsigned long long)Actual->Count);
+        return FALSE;
+    }
+
+    for (UINT64 i = 0; i < Expected->Count; i++)
+    {
+        if (Expected->Entries[i].Address != Actual->Entries[i].Address ||
+            Expected->Entries[i].PatternIndex != Actual->Entries[i].PatternIndex)
+        {
+            printf("err, %s: match %llu differs (%llx:%u, %llx:%u)\n",
+                   Name,
+                   (unsigned long long)i,
+                   (unsigned long long)Expected->Entries[i].Address,
+                   Expected->Entries[i].PatternIndex,
+                   (unsigned long long)Actual->Entries[i].Address,
+                   Actual->Entries[i].PatternIndex);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    static const BENCH_PATTERN Patterns[] = {
+        {"pool tag", {'H', 'v', 'D', 'b'}, {0}, FALSE, 4, 4},
+        {"pointer", {0x10, 0x20, 0x30, 0x40, 0x00, 0xf8, 0xff, 0xff}, {0}, FALSE, 8, 8},
+        {"masked bytes", {0x48, 0x89, 0x5c, 0x24, 0x00, 0x57, 0x48, 0x83, 0xec}, {0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0xff}, TRUE, 9, 1},
+        {"long bytes", {0x4d, 0x5a, 0x90, 0x00, 0x03, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, {0}, FALSE, 24, 1},
+    };
+    UINT32        NumberOfPatterns = sizeof(Patterns) / sizeof(Patterns[0]);
+    BENCH_SPACE   Space;
+    BENCH_MATCHES Expected;
+    BENCH_MATCHES Actual;
+    BOOLEAN       Passed = TRUE;
+    double        Start;
+    double        EngineTime;
+    double        LegacyTime = 0;
+    UINT64        LegacyCount;
+
+    Space.Size       = BENCH_SPACE_SIZE;
+    Space.Memory     = malloc(Space.Size);
+    Expected.Entries = malloc(BENCH_MAXIMUM_MATCHES * sizeof(BENCH_MATCH));
+    Actual.Entries   = malloc(BENCH_MAXIMUM_MATCHES * sizeof(BENCH_MATCH));
+
+    if (Space.Memory == NULL || Expected.Entries == NULL || Actual.Entries == NULL)
+    {
+        printf("err, unable to allocate the synthetic address space\n");
+        return 1;
+    }
+
+    BenchBuildSpace(&Space, Patterns, NumberOfPatterns);
+
+    //
+    // Each pattern on its own, and all of them in one pass
+    //
+    for (UINT32 i = 0; i <= NumberOfPatterns && Passed; i++)
+    {
+        const BENCH_PATTERN * Selected = i == NumberOfPatterns ? Patterns : &Patterns[i];
+        UINT32                Count    = i == NumberOfPatterns ? NumberOfPatterns : 1;
+        const char *          Name     = i == NumberOfPatterns ? "all patterns" : Patterns[i].Name;
+
+        BenchSearchReference(&Space, Selected, Count, &Expected);
+
+        Start = BenchNow();
+        BenchSearchEngine(&Space, Selected, Count, FALSE, &Actual);
+        EngineTime = BenchNow() - Start;
+
+        Passed = BenchCompare(Name, &Expected, &Actual);
+
+        for (UINT32 Round = 0; Round < BENCH_CHUNKING_ROUNDS && Passed; Round++)
+        {
+            BenchSearchEngine(&Space, Selected, Count, TRUE, &Actual);
+            Passed = BenchCompare(Name, &Expected, &Actual);
+        }
+
+        if (i != NumberOfPatterns && !Patterns[i].Masked)
+        {
+            Start       = BenchNow();
+            LegacyCount = BenchSearchLegacy(&Space, &Patterns[i]);
+            LegacyTime  = BenchNow() - Start;
+
+            printf("%-14s %8llu matches, engine: %8.1f MB/s, per-chunk: %8.1f MB/s (%llu matches)\n",
+                   Name,
+                   (unsigned long long)Actual.Count,
+                   BenchThroughput(Space.Size, EngineTime),
+                   BenchThroughput(Space.Size, LegacyTime),
+                   (unsigned long long)LegacyCount);
+        }
+        else
+        {
+            printf("%-14s %8llu matches, engine: %8.1f MB/s\n",
+                   Name,
+                   (unsigned long long)Actual.Count,
+                   BenchThroughput(Space.Size, EngineTime));
+        }
+    }
+
+    free(Space.Memory);
+    free(Expected.Entries);
+    free(Actual.Entries);
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("memory search tests passed\n");
+
+    return 0;
+}
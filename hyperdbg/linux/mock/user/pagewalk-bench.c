@@ -0,0 +1,598 @@
+/**
+ * @file pagewalk-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the cached walks of the page tables (batched reads)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_PHYSICAL_PAGES   32768 // 128 MB of simulated physical memory
+#define BENCH_TABLE_PAGES      1024  // the first 4 MB keep the page tables
+#define BENCH_SMALL_PAGES_LAST 16384 // 4 KB pages are from [4 MB, 64 MB), 2 MB pages are from [64 MB, 128 MB)
+#define BENCH_SMALL_VA         0x00007ff000000000ull
+#define BENCH_SMALL_SIZE       0x3000000ull // 48 MB of 4 KB pages
+#define BENCH_LARGE_VA         0xfffff80000000000ull
+#define BENCH_LARGE_SIZE       0x4000000ull // 64 MB of 2 MB pages
+#define BENCH_HUGE_VA          0xffffc00000000000ull
+#define BENCH_HUGE_SIZE        0x80000000ull // 2 GB of 1 GB pages (beyond the simulated memory)
+#define BENCH_SLOTS            16           // reserved mapping slots of each core
+#define BENCH_TEST_ADDRESSES   200000
+#define BENCH_TEST_RANGES      5000
+#define BENCH_ROUNDS           8
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static UINT8 *  g_Memory;
+static UINT64   g_Cr3;
+static UINT64   g_NextTablePage = 1;
+static UINT64   g_ReferenceReads;
+static UINT64   g_Mappings;
+static UINT64 * g_Slots; // the pages that are mapped into the slots (like the PTEs of the reserved range)
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static UINT64 *
+BenchTable(UINT64 PhysicalAddress)
+{
+    return (UINT64 *)(g_Memory + (PhysicalAddress & PAGE_WALK_ENTRY_ADDRESS));
+}
+
+/**
+ * @brief Get (or create) the table of the next level
+ *
+ */
+static UINT64 *
+BenchGetNextTable(UINT64 * Table, UINT32 Index)
+{
+    if (!(Table[Index] & PAGE_WALK_ENTRY_PRESENT))
+    {
+        Table[Index] = (g_NextTablePage++ << 12) | 0x3;
+    }
+
+    return BenchTable(Table[Index]);
+}
+
+/**
+ * @brief Map a page (Level 1 is a 1 GB page, 2 is a 2 MB page and 3 is a 4 KB page)
+ *
+ */
+static VOID
+BenchMap(UINT64 VirtualAddress, UINT64 PhysicalAddress, UINT32 Level)
+{
+    UINT64 * Table = BenchTable(g_Cr3);
+
+    for (UINT32 i = 0; i < Level; i++)
+    {
+        Table = BenchGetNextTable(Table, (VirtualAddress >> (39 - 9 * i)) & 0x1ff);
+    }
+
+    Table[(VirtualAddress >> (39 - 9 * Level)) & 0x1ff] = PhysicalAddress | (Level != 3 ? PAGE_WALK_ENTRY_LARGE_PAGE : 0) | 0x3;
+}
+
+/**
+ * @brief Translate without any cache (like a walk for each page)
+ *
+ */
+static BOOLEAN
+BenchReferenceTranslate(UINT64 VirtualAddress, UINT64 * PhysicalAddress, UINT64 * MappingSize)
+{
+    UINT64 Entry = g_Cr3;
+
+    if (((INT64)VirtualAddress >> 47) != 0 && ((INT64)VirtualAddress >> 47) != -1)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 Level = 0; Level < 4; Level++)
+    {
+        UINT32 Shift = 39 - 9 * Level;
+
+        Entry = BenchTable(Entry)[(VirtualAddress >> Shift) & 0x1ff];
+        g_ReferenceReads++;
+
+        if (!(Entry & PAGE_WALK_ENTRY_PRESENT))
+        {
+            return FALSE;
+        }
+
+        if (Level == 3 || (Level != 0 && (Entry & PAGE_WALK_ENTRY_LARGE_PAGE)))
+        {
+            UINT64 PageSize = 1ull << Shift;
+
+            *PhysicalAddress = (Entry & PAGE_WALK_ENTRY_ADDRESS & ~(PageSize - 1)) | (VirtualAddress & (PageSize - 1));
+            *MappingSize     = PageSize - (VirtualAddress & (PageSize - 1));
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static BOOLEAN
+BenchReadEntry(PVOID Context, UINT64 PhysicalAddress, UINT64 * Entry)
+{
+    (void)Context;
+
+    if (PhysicalAddress >= (UINT64)BENCH_PHYSICAL_PAGES * PAGE_WALK_SIZE_4KB)
+    {
+        return FALSE;
+    }
+
+    *Entry = *(UINT64 *)(g_Memory + PhysicalAddress);
+
+    return TRUE;
+}
+
+/**
+ * @brief Build the page tables, 4 KB pages are mapped in physically contiguous
+ * streaks (with holes), 2 MB pages are shuffled and 1 GB pages are beyond the memory
+ *
+ */
+static BOOLEAN
+BenchBuildPageTables(void)
+{
+    UINT64 LargePages[(BENCH_PHYSICAL_PAGES - BENCH_SMALL_PAGES_LAST) / 512];
+    UINT64 NumberOfLargePages = sizeof(LargePages) / sizeof(LargePages[0]);
+    UINT64 NextPage           = BENCH_TABLE_PAGES;
+
+    g_Memory = calloc(BENCH_PHYSICAL_PAGES, PAGE_WALK_SIZE_4KB);
+
+    if (g_Memory == NULL)
+    {
+        return FALSE;
+    }
+
+    //
+    // The content of the pages is the physical address of each 8 bytes
+    //
+    for (UINT64 i = BENCH_TABLE_PAGES * PAGE_WALK_SIZE_4KB; i < BENCH_PHYSICAL_PAGES * PAGE_WALK_SIZE_4KB; i += 8)
+    {
+        *(UINT64 *)(g_Memory + i) = i;
+    }
+
+    g_Cr3 = 0;
+
+    for (UINT64 Offset = 0; Offset < BENCH_SMALL_SIZE;)
+    {
+        UINT64 Streak = 1 + BenchRandom() % 64;
+
+        if (BenchRandom() % 20 == 0)
+        {
+            //
+            // A hole
+            //
+            Offset += Streak * PAGE_WALK_SIZE_4KB;
+            continue;
+        }
+
+        if (NextPage + Streak > BENCH_SMALL_PAGES_LAST)
+        {
+            NextPage = BENCH_TABLE_PAGES;
+        }
+
+        for (UINT64 i = 0; i < Streak && Offset < BENCH_SMALL_SIZE; i++, Offset += PAGE_WALK_SIZE_4KB)
+        {
+            BenchMap(BENCH_SMALL_VA + Offset, (NextPage + i) << 12, 3);
+        }
+
+        NextPage += Streak + BenchRandom() % 2;
+    }
+
+    for (UINT64 i = 0; i < NumberOfLargePages; i++)
+    {
+        LargePages[i] = BENCH_SMALL_PAGES_LAST * PAGE_WALK_SIZE_4KB + i * PAGE_WALK_SIZE_2MB;
+    }
+
+    //
+    // Swap some of the large pages (others remain contiguous)
+    //
+    for (UINT64 i = 0; i < NumberOfLargePages / 2; i++)
+    {
+        UINT64 j = BenchRandom() % NumberOfLargePages;
+        UINT64 k = BenchRandom() % NumberOfLargePages;
+        UINT64 t = LargePages[j];
+
+        LargePages[j] = LargePages[k];
+        LargePages[k] = t;
+    }
+
+    for (UINT64 i = 0; i < NumberOfLargePages; i++)
+    {
+        BenchMap(BENCH_LARGE_VA + i * PAGE_WALK_SIZE_2MB, LargePages[i], 2);
+    }
+
+    //
+    // The 4 KB pages right after the large pages (a PDE that points to a page table)
+    //
+    for (UINT64 i = 0; i < 512; i++)
+    {
+        BenchMap(BENCH_LARGE_VA + BENCH_LARGE_SIZE + i * PAGE_WALK_SIZE_4KB, (BENCH_TABLE_PAGES + 4096 + i) << 12, 3);
+    }
+
+    BenchMap(BENCH_HUGE_VA, 0x4000000000ull, 1);
+    BenchMap(BENCH_HUGE_VA + PAGE_WALK_SIZE_1GB, 0x4040000000ull, 1);
+
+    return g_NextTablePage <= BENCH_TABLE_PAGES;
+}
+
+static UINT64
+BenchRandomAddress(void)
+{
+    switch (BenchRandom() % 5)
+    {
+    case 0:
+        return BENCH_SMALL_VA + BenchRandom() % (BENCH_SMALL_SIZE + 0x100000);
+    case 1:
+        return BENCH_LARGE_VA + BenchRandom() % (BENCH_LARGE_SIZE + 0x300000);
+    case 2:
+        return BENCH_HUGE_VA + BenchRandom() % (BENCH_HUGE_SIZE + 0x1000000);
+    case 3:
+        return BenchRandom(); // mostly non-canonical or not mapped
+    default:
+        return BENCH_SMALL_VA + (BenchRandom() % 64) * PAGE_WALK_SIZE_1GB; // not mapped
+    }
+}
+
+/**
+ * @brief Translate random addresses and compare them with the reference
+ *
+ */
+static BOOLEAN
+BenchTestTranslate(void)
+{
+    PAGE_WALK_CACHE Cache;
+    UINT64          Mapped = 0;
+
+    PageWalkInitialize(&Cache, g_Cr3, BenchReadEntry, NULL);
+
+    for (UINT32 i = 0; i < BENCH_TEST_ADDRESSES; i++)
+    {
+        UINT64  Address = BenchRandomAddress();
+        UINT64  PhysicalAddress, MappingSize, ExpectedAddress, ExpectedSize;
+        BOOLEAN Result   = PageWalkTranslate(&Cache, Address, &PhysicalAddress, &MappingSize);
+        BOOLEAN Expected = BenchReferenceTranslate(Address, &ExpectedAddress, &ExpectedSize);
+
+        if (Result != Expected || (Result && (PhysicalAddress != ExpectedAddress || MappingSize != ExpectedSize)))
+        {
+            printf("err, the translation of %llx is not the same as the reference\n", (unsigned long long)Address);
+            return FALSE;
+        }
+
+        Mapped += Result;
+
+        //
+        // Sometimes start again (a new operation)
+        //
+        if (BenchRandom() % 1000 == 0)
+        {
+            PageWalkInitialize(&Cache, g_Cr3, BenchReadEntry, NULL);
+        }
+    }
+
+    printf("translate:  %u addresses (%llu mapped) are the same as the reference\n",
+           BENCH_TEST_ADDRESSES,
+           (unsigned long long)Mapped);
+
+    return TRUE;
+}
+
+/**
+ * @brief Build the runs of random ranges and check each page of them
+ *
+ */
+static BOOLEAN
+BenchTestRuns(void)
+{
+    PAGE_WALK_RUN Runs[64];
+    UINT64        TotalRuns = 0;
+
+    for (UINT32 i = 0; i < BENCH_TEST_RANGES; i++)
+    {
+        PAGE_WALK_CACHE Cache;
+        UINT64          Address     = BenchRandomAddress();
+        UINT64          Size        = 1 + BenchRandom() % (BenchRandom() % 2 ? 0x10000 : 0x800000);
+        UINT32          MaximumRuns = 1 + BenchRandom() % 64;
+        UINT64          Translated;
+        UINT32          Count;
+        UINT64          Next = Address;
+
+        PageWalkInitialize(&Cache, g_Cr3, BenchReadEntry, NULL);
+
+        Count = PageWalkBuildRuns(&Cache, Address, Size, Runs, MaximumRuns, &Translated);
+        TotalRuns += Count;
+
+        for (UINT32 j = 0; j < Count; j++)
+        {
+            //
+            // The runs are contiguous and not physically contiguous with the previous run
+            //
+            if (Runs[j].VirtualAddress != Next || Runs[j].Size == 0 ||
+                (j != 0 && Runs[j - 1].PhysicalAddress + Runs[j - 1].Size == Runs[j].PhysicalAddress))
+            {
+                printf("err, the runs of %llx are not correct\n", (unsigned long long)Address);
+                return FALSE;
+            }
+
+            for (UINT64 Offset = 0; Offset < Runs[j].Size;)
+            {
+                UINT64 ExpectedAddress, ExpectedSize;
+
+                if (!BenchReferenceTranslate(Runs[j].VirtualAddress + Offset, &ExpectedAddress, &ExpectedSize) ||
+                    ExpectedAddress != Runs[j].PhysicalAddress + Offset)
+                {
+                    printf("err, the run of %llx is not the same as the reference\n",
+                           (unsigned long long)(Runs[j].VirtualAddress + Offset));
+                    return FALSE;
+                }
+
+                Offset += ExpectedSize;
+            }
+
+            Next += Runs[j].Size;
+        }
+
+        //
+        // A range is only partially translated if there is no more runs or
+        // the next address is not mapped
+        //
+        if (Next != Address + Translated || Translated > Size)
+        {
+            printf("err, the translated size of %llx is not correct\n", (unsigned long long)Address);
+            return FALSE;
+        }
+
+        if (Translated < Size && Count != MaximumRuns)
+        {
+            UINT64 ExpectedAddress, ExpectedSize;
+
+            if (BenchReferenceTranslate(Next, &ExpectedAddress, &ExpectedSize))
+            {
+                printf("err, the range of %llx stopped at a mapped address\n", (unsigned long long)Address);
+                return FALSE;
+            }
+        }
+    }
+
+    printf("runs:       %u ranges are split into %llu runs that are the same as the reference\n",
+           BENCH_TEST_RANGES,
+           (unsigned long long)TotalRuns);
+
+    return TRUE;
+}
+
+/**
+ * @brief Map a page into a slot (like changing the PTE of the slot and invlpg)
+ *
+ */
+static UINT8 *
+BenchMapSlot(UINT32 Slot, UINT64 PhysicalAddress)
+{
+    g_Slots[Slot] = PhysicalAddress & PAGE_WALK_ENTRY_ADDRESS;
+    g_Mappings++;
+
+    return g_Memory + g_Slots[Slot];
+}
+
+/**
+ * @brief The previous way of reading, a translation and a mapping for each page
+ *
+ */
+static BOOLEAN
+BenchReadPerPage(UINT64 Address, UINT8 * Buffer, UINT64 Size)
+{
+    while (Size != 0)
+    {
+        UINT64 PhysicalAddress, MappingSize;
+        UINT64 Length = PAGE_WALK_SIZE_4KB - (Address & (PAGE_WALK_SIZE_4KB - 1));
+
+        if (Length > Size)
+        {
+            Length = Size;
+        }
+
+        if (!BenchReferenceTranslate(Address, &PhysicalAddress, &MappingSize))
+        {
+            return FALSE;
+        }
+
+        memcpy(Buffer, BenchMapSlot(0, PhysicalAddress) + (PhysicalAddress & (PAGE_WALK_SIZE_4KB - 1)), Length);
+
+        Address += Length;
+        Buffer += Length;
+        Size -= Length;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief The batched reads, the runs are mapped into the slots of the core
+ * and each chunk of the slots is copied at once
+ *
+ */
+static BOOLEAN
+BenchReadBatched(UINT64 Address, UINT8 * Buffer, UINT64 Size, UINT64 * EntryReads)
+{
+    PAGE_WALK_CACHE Cache;
+    PAGE_WALK_RUN   Runs[BENCH_SLOTS];
+
+    PageWalkInitialize(&Cache, g_Cr3, BenchReadEntry, NULL);
+
+    while (Size != 0)
+    {
+        UINT64 Translated;
+        UINT32 Count = PageWalkBuildRuns(&Cache, Address, Size, Runs, BENCH_SLOTS, &Translated);
+
+        if (Count == 0)
+        {
+            return FALSE;
+        }
+
+        for (UINT32 i = 0; i < Count; i++)
+        {
+            UINT64 PhysicalAddress = Runs[i].PhysicalAddress;
+            UINT64 Remaining       = Runs[i].Size;
+
+            while (Remaining != 0)
+            {
+                UINT64 Offset = PhysicalAddress & (PAGE_WALK_SIZE_4KB - 1);
+                UINT64 Length = BENCH_SLOTS * PAGE_WALK_SIZE_4KB - Offset;
+                UINT8 *Mapped = NULL;
+
+                if (Length > Remaining)
+                {
+                    Length = Remaining;
+                }
+
+                for (UINT32 Slot = 0; Slot * PAGE_WALK_SIZE_4KB < Offset + Length; Slot++)
+                {
+                    UINT8 * SlotAddress = BenchMapSlot(Slot, PhysicalAddress + Slot * PAGE_WALK_SIZE_4KB);
+
+                    if (Slot == 0)
+                    {
+                        Mapped = SlotAddress;
+                    }
+                }
+
+                //
+                // The slots are virtually contiguous, so are the simulated pages
+                //
+                memcpy(Buffer, Mapped + Offset, Length);
+
+                PhysicalAddress += Length;
+                Buffer += Length;
+                Remaining -= Length;
+            }
+        }
+
+        Address += Translated;
+        Size -= Translated;
+    }
+
+    *EntryReads += Cache.EntryReads;
+
+    return TRUE;
+}
+
+/**
+ * @brief Compare the batched reads with the reads of each page
+ *
+ */
+static BOOLEAN
+BenchMeasure(const char * Name, UINT64 Address, UINT64 Size)
+{
+    UINT8 * Expected = malloc(Size);
+    UINT8 * Buffer   = malloc(Size);
+    UINT64  EntryReads = 0;
+    UINT64  PerPageMappings, BatchedMappings;
+    double  PerPageTime, BatchedTime, Start;
+
+    if (Expected == NULL || Buffer == NULL)
+    {
+        free(Expected);
+        free(Buffer);
+        return FALSE;
+    }
+
+    memset(Expected, 0, Size);
+    memset(Buffer, 0xff, Size);
+
+    g_ReferenceReads = 0;
+    g_Mappings       = 0;
+    Start            = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_ROUNDS; i++)
+    {
+        if (!BenchReadPerPage(Address, Expected, Size))
+        {
+            printf("err, unable to read %llx\n", (unsigned long long)Address);
+            free(Expected);
+            free(Buffer);
+            return FALSE;
+        }
+    }
+
+    PerPageTime     = BenchNow() - Start;
+    PerPageMappings = g_Mappings;
+    g_Mappings      = 0;
+    Start           = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_ROUNDS; i++)
+    {
+        if (!BenchReadBatched(Address, Buffer, Size, &EntryReads))
+        {
+            printf("err, unable to read %llx in batches\n", (unsigned long long)Address);
+            free(Expected);
+            free(Buffer);
+            return FALSE;
+        }
+    }
+
+    BatchedTime     = BenchNow() - Start;
+    BatchedMappings = g_Mappings;
+
+    if (memcmp(Expected, Buffer, Size) != 0)
+    {
+        printf("err, the batched read of %llx is not the same as the read of each page\n", (unsigned long long)Address);
+        free(Expected);
+        free(Buffer);
+        return FALSE;
+    }
+
+    printf("%-10s  per page: %8.2f ms, %7llu entry reads, %6llu mappings | batched: %8.2f ms, %7llu entry reads, %6llu mappings\n",
+           Name,
+           PerPageTime * 1000 / BENCH_ROUNDS,
+           (unsigned long long)(g_ReferenceReads / BENCH_ROUNDS),
+           (unsigned long long)(PerPageMappings / BENCH_ROUNDS),
+           BatchedTime * 1000 / BENCH_ROUNDS,
+           (unsigned long long)(EntryReads / BENCH_ROUNDS),
+           (unsigned long long)(BatchedMappings / BENCH_ROUNDS));
+
+    free(Expected);
+    free(Buffer);
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    UINT64 Slots[BENCH_SLOTS];
+
+    g_Slots = Slots;
+
+    if (!BenchBuildPageTables())
+    {
+        printf("err, unable to build the page tables\n");
+        return 1;
+    }
+
+    if (!BenchTestTranslate() || !BenchTestRuns() ||
+        !BenchMeasure("4 KB", BENCH_SMALL_VA + 0x1800, 0x40000 - 0x1800) ||
+        !BenchMeasure("2 MB", BENCH_LARGE_VA + 0x123, BENCH_LARGE_SIZE - 0x123) ||
+        !BenchMeasure("mixed", BENCH_LARGE_VA + BENCH_LARGE_SIZE - 0x400000, 0x5ff000))
+    {
+        free(g_Memory);
+        return 1;
+    }
+
+    free(g_Memory);
+
+    printf("page walk tests passed\n");
+
+    return 0;
+}
@@ -22,8 +22,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <assert.h>
 
+//
+// Environment headers
+//
+#include "../../../include/platform/general/header/Environment.h"
+
 //
 // SDK headers
 //
@@ -33,5 +39,34 @@
 // Platform headers
 //
 #include "../../../include/platform/user/header/platform-intrinsics.h"
+#include "../../../include/platform/user/header/platform-lib-calls.h"
+
+//
+// Components
+//
+#include "../../../include/components/memsearch/header/MemorySearch.h"
+#include "../../../include/components/ahocorasick/header/AhoCorasick.h"
+#include "../../../include/components/atomics/header/Atomics.h"
+#include "../../../include/components/logring/header/LogRing.h"
+#include "../../../include/components/eventindex/header/EventIndex.h"
+#include "../../../include/components/hashtable/header/HashTable.h"
+#include "../../../include/components/poolcache/header/PoolCache.h"
+#include "../../../include/components/dirtybitmap/header/DirtyBitmap.h"
+#include "../../../include/components/pagewalk/header/PageWalk.h"
+#include "../../../include/components/taskbroadcast/header/TaskBroadcast.h"
+#include "../../../include/components/exitprofiler/header/ExitProfiler.h"
+#include "../../../include/components/steprecord/header/StepRecord.h"
+#include "../../../include/components/memdump/header/MemDump.h"
+#include "../../../include/components/pciids/header/PciIds.h"
+#include "../../../include/components/hwdbgoptimizer/header/HwdbgOptimizer.h"
+#include "../../../include/components/hwdbgmodel/header/HwdbgModel.h"
+#include "../../../include/components/lbrprofile/header/LbrProfile.h"
+#include "../../../include/components/peanalysis/header/PeAnalysis.h"
+#include "../../../include/components/unwind/header/Unwind.h"
+
+//
+// Helpers of the benches
+//
+#include "bench.h"
 
 #endif // PCH_H
@@ -0,0 +1,754 @@
+/**
+ * @file pciids-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the index of the PCI ID database
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <stdarg.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_VENDORS         400
+#define BENCH_MEASURE_VENDORS 2500
+#define BENCH_LOOKUPS         2500
+#define BENCH_MEASURE_LOOKUPS 2000000
+#define BENCH_MEASURE_SCANS   200
+#define BENCH_SOURCE_SIZE     0x1234
+#define BENCH_SOURCE_TIME     0x01dc000012345678ull
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A generated database
+ *
+ */
+typedef struct _BENCH_TEXT
+{
+    CHAR * Data;
+    SIZE_T Size;
+    SIZE_T Capacity;
+
+} BENCH_TEXT, *PBENCH_TEXT;
+
+/**
+ * @brief A lookup (the IDs of the levels that are not looked up are -1)
+ *
+ */
+typedef struct _BENCH_QUERY
+{
+    INT32 VendorId;
+    INT32 DeviceId;
+    INT32 SubVendorId;
+    INT32 SubDeviceId;
+
+} BENCH_QUERY, *PBENCH_QUERY;
+
+/**
+ * @brief The lookups of a generated database
+ *
+ */
+typedef struct _BENCH_QUERIES
+{
+    BENCH_QUERY * Queries;
+    UINT32        NumberOfQueries;
+    UINT32        Capacity;
+
+} BENCH_QUERIES, *PBENCH_QUERIES;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static VOID
+BenchAppend(PBENCH_TEXT Text, const CHAR * Format, ...)
+{
+    va_list Arguments;
+    int     Length;
+
+    va_start(Arguments, Format);
+    Length = vsnprintf(NULL, 0, Format, Arguments);
+    va_end(Arguments);
+
+    if (Text->Size + Length + 1 > Text->Capacity)
+    {
+        Text->Capacity = (Text->Size + Length + 1) * 2;
+        Text->Data     = (CHAR *)realloc(Text->Data, Text->Capacity);
+    }
+
+    va_start(Arguments, Format);
+    vsnprintf(Text->Data + Text->Size, Length + 1, Format, Arguments);
+    va_end(Arguments);
+
+    Text->Size += Length;
+}
+
+static VOID
+BenchAddQuery(PBENCH_QUERIES Queries, INT32 VendorId, INT32 DeviceId, INT32 SubVendorId, INT32 SubDeviceId)
+{
+    BENCH_QUERY * Query;
+
+    if (Queries->NumberOfQueries == Queries->Capacity)
+    {
+        Queries->Capacity = Queries->Capacity == 0 ? 256 : Queries->Capacity * 2;
+        Queries->Queries  = (BENCH_QUERY *)realloc(Queries->Queries, Queries->Capacity * sizeof(BENCH_QUERY));
+    }
+
+    Query = &Queries->Queries[Queries->NumberOfQueries++];
+
+    Query->VendorId    = VendorId;
+    Query->DeviceId    = DeviceId;
+    Query->SubVendorId = SubVendorId;
+    Query->SubDeviceId = SubDeviceId;
+}
+
+/**
+ * @brief Append the end of a line (some of the lines end with spaces and CRLF)
+ *
+ */
+static VOID
+BenchEndLine(PBENCH_TEXT Text)
+{
+    UINT64 Random = BenchRandom();
+
+    BenchAppend(Text, "%s%s", Random % 16 == 0 ? "  " : "", Random % 8 == 1 ? "\r\n" : "\n");
+}
+
+/**
+ * @brief Append a name (a few of them are longer than the old limit of the names)
+ *
+ */
+static VOID
+BenchAppendName(PBENCH_TEXT Text, const CHAR * Kind, UINT32 Number)
+{
+    BenchAppend(Text, "%s %u [rev %u]", Kind, Number, (UINT32)(BenchRandom() % 100));
+
+    if (BenchRandom() % 64 == 0)
+    {
+        for (UINT32 i = 0; i < 30; i++)
+        {
+            BenchAppend(Text, " long-name");
+        }
+    }
+}
+
+/**
+ * @brief Generate a database in the format of pci.ids
+ *
+ * @details The vendors and the devices are not sorted and some of them are
+ * duplicated, the database also has comments, empty lines, CRLF, uppercase IDs,
+ * and the section of the classes at the end
+ *
+ */
+static VOID
+BenchGenerateDatabase(PBENCH_TEXT Text, PBENCH_QUERIES Queries, UINT32 NumberOfVendors)
+{
+    UINT16 VendorIds[64] = {0};
+    UINT32 Number        = 0;
+
+    memset(Text, 0, sizeof(BENCH_TEXT));
+    memset(Queries, 0, sizeof(BENCH_QUERIES));
+
+    BenchAppend(Text, "#\n#\tList of PCI ID's\n#\n#\tVersion: 2026.10.18\n#\n\n");
+
+    for (UINT32 v = 0; v < NumberOfVendors; v++)
+    {
+        UINT16 VendorId        = (UINT16)BenchRandom();
+        UINT32 NumberOfDevices = (UINT32)(BenchRandom() % 12);
+        UINT16 DeviceIds[16]   = {0};
+
+        //
+        // Duplicate a few of the vendors (only the first one is used)
+        //
+        if (v >= 64 && BenchRandom() % 40 == 0)
+        {
+            VendorId = VendorIds[BenchRandom() % 64];
+        }
+
+        VendorIds[v % 64] = VendorId;
+
+        BenchAppend(Text, BenchRandom() % 10 == 0 ? "%04X  " : "%04x  ", VendorId);
+        BenchAppendName(Text, "Vendor", Number++);
+        BenchEndLine(Text);
+
+        BenchAddQuery(Queries, VendorId, -1, -1, -1);
+
+        for (UINT32 d = 0; d < NumberOfDevices; d++)
+        {
+            UINT16 DeviceId           = (UINT16)BenchRandom();
+            UINT32 NumberOfSubDevices = (UINT32)(BenchRandom() % 4);
+
+            if (d != 0 && BenchRandom() % 20 == 0)
+            {
+                DeviceId = DeviceIds[BenchRandom() % d];
+            }
+
+            DeviceIds[d] = DeviceId;
+
+            BenchAppend(Text, "\t%04x  ", DeviceId);
+            BenchAppendName(Text, "Device", Number++);
+            BenchEndLine(Text);
+
+            BenchAddQuery(Queries, VendorId, DeviceId, -1, -1);
+
+            for (UINT32 s = 0; s < NumberOfSubDevices; s++)
+            {
+                UINT16 SubVendorId = BenchRandom() % 2 == 0 ? VendorId : (UINT16)BenchRandom();
+                UINT16 SubDeviceId = (UINT16)BenchRandom();
+
+                BenchAppend(Text, "\t\t%04x %04x  ", SubVendorId, SubDeviceId);
+                BenchAppendName(Text, "Subsystem", Number++);
+                BenchEndLine(Text);
+
+                BenchAddQuery(Queries, VendorId, DeviceId, SubVendorId, SubDeviceId);
+                BenchAddQuery(Queries, VendorId, DeviceId, SubDeviceId, SubVendorId);
+            }
+
+            BenchAddQuery(Queries, VendorId, (UINT16)BenchRandom(), -1, -1);
+        }
+
+        if (BenchRandom() % 30 == 0)
+        {
+            BenchAppend(Text, "# Comment between the vendors\n");
+        }
+
+        if (BenchRandom() % 30 == 0)
+        {
+            BenchAppend(Text, "\n");
+        }
+
+        BenchAddQuery(Queries, (UINT16)BenchRandom(), -1, -1, -1);
+    }
+
+    //
+    // The classes have the same shape as the vendors, but they are not vendors
+    //
+    BenchAppend(Text,
+                "\n# List of known device classes, subclasses and programming interfaces\n\n"
+                "C 00  Unclassified device\n"
+                "\t00  Non-VGA unclassified device\n"
+                "\t01  VGA compatible unclassified device\n"
+                "\t\t00  VGA controller\n"
+                "C 0c  Serial bus controller\n"
+                "\t03  USB controller\n"
+                "\t\t30  XHCI\n");
+}
+
+/**
+ * @brief Look up a name by scanning the text (the way the database was looked
+ * up before the index)
+ *
+ */
+static BOOLEAN
+BenchReferenceLookup(const CHAR * Text, SIZE_T Size, const BENCH_QUERY * Query, CHAR * Name, SIZE_T NameSize)
+{
+    SIZE_T  Offset      = 0;
+    BOOLEAN FoundVendor = FALSE;
+    BOOLEAN FoundDevice = FALSE;
+
+    while (Offset < Size)
+    {
+        const CHAR * Line   = Text + Offset;
+        const CHAR * End    = (const CHAR *)memchr(Line, '\n', Size - Offset);
+        SIZE_T       Length = End != NULL ? (SIZE_T)(End - Line) : Size - Offset;
+        UINT32       Depth  = 0;
+        unsigned int Id;
+        unsigned int SubId;
+        int          NameOffset;
+        CHAR         Buffer[1024];
+
+        Offset += Length + 1;
+
+        while (Length != 0 && (Line[Length - 1] == '\r' || Line[Length - 1] == ' '))
+        {
+            Length--;
+        }
+
+        if (Length == 0 || Line[0] == '#')
+        {
+            continue;
+        }
+
+        memcpy(Buffer, Line, Length);
+        Buffer[Length] = '\0';
+
+        while (Buffer[Depth] == '\t')
+        {
+            Depth++;
+        }
+
+        if (Depth == 0)
+        {
+            if (FoundVendor)
+            {
+                return FALSE;
+            }
+
+            if (sscanf(Buffer, "%4x  %n", &Id, &NameOffset) == 1 && NameOffset > 4 && Buffer[4] == ' ' && (INT32)Id == Query->VendorId)
+            {
+                if (Query->DeviceId < 0)
+                {
+                    snprintf(Name, NameSize, "%s", Buffer + NameOffset);
+                    return TRUE;
+                }
+
+                FoundVendor = TRUE;
+            }
+        }
+        else if (Depth == 1 && FoundVendor)
+        {
+            if (FoundDevice)
+            {
+                return FALSE;
+            }
+
+            if (sscanf(Buffer + 1, "%4x  %n", &Id, &NameOffset) == 1 && (INT32)Id == Query->DeviceId)
+            {
+                if (Query->SubVendorId < 0)
+                {
+                    snprintf(Name, NameSize, "%s", Buffer + 1 + NameOffset);
+                    return TRUE;
+                }
+
+                FoundDevice = TRUE;
+            }
+        }
+        else if (Depth == 2 && FoundDevice)
+        {
+            if (sscanf(Buffer + 2, "%4x %4x  %n", &Id, &SubId, &NameOffset) == 2 &&
+                (INT32)Id == Query->SubVendorId && (INT32)SubId == Query->SubDeviceId)
+            {
+                snprintf(Name, NameSize, "%s", Buffer + 2 + NameOffset);
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Look up a name in an index
+ *
+ */
+static const CHAR *
+BenchIndexLookup(const PCI_IDS_HEADER * Index, const BENCH_QUERY * Query)
+{
+    const PCI_IDS_VENDOR *    Vendor;
+    const PCI_IDS_DEVICE *    Device;
+    const PCI_IDS_SUBDEVICE * SubDevice;
+
+    Vendor = PciIdsFindVendor(Index, (UINT16)Query->VendorId);
+
+    if (Vendor == NULL || Query->DeviceId < 0)
+    {
+        return Vendor != NULL ? PciIdsGetName(Index, Vendor->Name) : NULL;
+    }
+
+    Device = PciIdsFindDevice(Index, Vendor, (UINT16)Query->DeviceId);
+
+    if (Device == NULL || Query->SubVendorId < 0)
+    {
+        return Device != NULL ? PciIdsGetName(Index, Device->Name) : NULL;
+    }
+
+    SubDevice = PciIdsFindSubDevice(Index, Device, (UINT16)Query->SubVendorId, (UINT16)Query->SubDeviceId);
+
+    return SubDevice != NULL ? PciIdsGetName(Index, SubDevice->Name) : NULL;
+}
+
+/**
+ * @brief Compile an index (NULL if it fails)
+ *
+ */
+static PCI_IDS_HEADER *
+BenchCompile(const CHAR * Text, SIZE_T Size, UINT32 * IndexSize)
+{
+    VOID * Index;
+
+    *IndexSize = PciIdsCompile(Text, Size, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME, NULL, 0);
+
+    if (*IndexSize < sizeof(PCI_IDS_HEADER))
+    {
+        printf("err, the size of the index is %u\n", *IndexSize);
+        return NULL;
+    }
+
+    Index = malloc(*IndexSize);
+
+    if (Index == NULL ||
+        PciIdsCompile(Text, Size, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME, Index, *IndexSize) != *IndexSize ||
+        !PciIdsValidate(Index, *IndexSize, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME))
+    {
+        printf("err, unable to compile the index\n");
+        free(Index);
+        return NULL;
+    }
+
+    return (PCI_IDS_HEADER *)Index;
+}
+
+/**
+ * @brief Check the lookups of a small handwritten database
+ *
+ */
+static BOOLEAN
+BenchTestHandwritten(void)
+{
+    static const CHAR Database[] =
+        "# Comment\r\n"
+        "\t1234  Device before any vendor\n"
+        "\n"
+        "8086  Intel Corporation  \r\n"
+        "\t1237  440FX - 82441FX PMC [Natoma]\r\n"
+        "\t\t1af4 1100  Qemu virtual machine\n"
+        "\t\t1AF4 1000  Another subsystem\n"
+        "\t0007  82379AB\n"
+        "\t1237  Duplicated device\n"
+        "\t\t1af4 1001  Subsystem of the duplicated device\n"
+        "# Comment in a vendor\n"
+        "\tzzzz  Invalid device\n"
+        "\t\t1af4 1002  Subsystem of the invalid device\n"
+        "10DE  NVIDIA Corporation\n"
+        "8086  Duplicated vendor\n"
+        "\t0001  Device of the duplicated vendor\n"
+        "0000  Zero vendor\n"
+        "ffff  Illegal Vendor ID\n"
+        "C 03  Display controller\n"
+        "\t00  VGA compatible controller\n"
+        "\t\t0000  0000  Not a subsystem\n"
+        "1af4  Red Hat, Inc.\n"
+        "\t1000  Virtio network device";
+
+    static const struct
+    {
+        BENCH_QUERY  Query;
+        const CHAR * Name;
+    } Expected[] = {
+        {{0x8086, -1, -1, -1}, "Intel Corporation"},
+        {{0x8086, 0x1237, -1, -1}, "440FX - 82441FX PMC [Natoma]"},
+        {{0x8086, 0x0007, -1, -1}, "82379AB"},
+        {{0x8086, 0x1237, 0x1af4, 0x1100}, "Qemu virtual machine"},
+        {{0x8086, 0x1237, 0x1af4, 0x1000}, "Another subsystem"},
+        {{0x8086, 0x1237, 0x1af4, 0x1001}, NULL},
+        {{0x8086, 0x1234, -1, -1}, NULL},
+        {{0x8086, 0x0001, -1, -1}, NULL},
+        {{0x10de, -1, -1, -1}, "NVIDIA Corporation"},
+        {{0x10de, 0x0001, -1, -1}, NULL},
+        {{0x0000, -1, -1, -1}, "Zero vendor"},
+        {{0xffff, -1, -1, -1}, "Illegal Vendor ID"},
+        {{0xffff, 0x0000, -1, -1}, NULL},
+        {{0x1af4, 0x1000, -1, -1}, "Virtio network device"},
+        {{0x1234, -1, -1, -1}, NULL},
+    };
+
+    UINT32           IndexSize;
+    PCI_IDS_HEADER * Index  = BenchCompile(Database, sizeof(Database) - 1, &IndexSize);
+    UINT32           Errors = 0;
+
+    if (Index == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < sizeof(Expected) / sizeof(Expected[0]); i++)
+    {
+        const CHAR * Name = BenchIndexLookup(Index, &Expected[i].Query);
+
+        if ((Name == NULL) != (Expected[i].Name == NULL) || (Name != NULL && strcmp(Name, Expected[i].Name) != 0))
+        {
+            printf("err, lookup %u returned '%s' instead of '%s'\n",
+                   i,
+                   Name != NULL ? Name : "(null)",
+                   Expected[i].Name != NULL ? Expected[i].Name : "(null)");
+            Errors++;
+        }
+    }
+
+    if (Index->NumberOfVendors != 6 || Index->NumberOfDevices != 5 || Index->NumberOfSubDevices != 3)
+    {
+        printf("err, the index has %u vendors, %u devices, and %u subsystems\n",
+               Index->NumberOfVendors,
+               Index->NumberOfDevices,
+               Index->NumberOfSubDevices);
+        Errors++;
+    }
+
+    free(Index);
+
+    //
+    // An empty database has an empty index
+    //
+    Index = BenchCompile("", 0, &IndexSize);
+
+    if (Index == NULL || IndexSize != sizeof(PCI_IDS_HEADER) || PciIdsFindVendor(Index, 0x8086) != NULL)
+    {
+        printf("err, the index of an empty database is not empty\n");
+        Errors++;
+    }
+
+    free(Index);
+
+    return Errors == 0;
+}
+
+/**
+ * @brief Check the lookups of a generated database against scanning it
+ *
+ */
+static BOOLEAN
+BenchTestLookups(void)
+{
+    BENCH_TEXT       Text;
+    BENCH_QUERIES    Queries;
+    UINT32           IndexSize;
+    PCI_IDS_HEADER * Index;
+    UINT32           Errors = 0;
+    UINT32           Found  = 0;
+    CHAR             Expected[1024];
+
+    BenchGenerateDatabase(&Text, &Queries, BENCH_VENDORS);
+
+    Index = BenchCompile(Text.Data, Text.Size, &IndexSize);
+
+    if (Index == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_LOOKUPS && Errors < 10; i++)
+    {
+        const BENCH_QUERY * Query = &Queries.Queries[BenchRandom() % Queries.NumberOfQueries];
+        BOOLEAN             IsFound;
+        const CHAR *        Name;
+
+        IsFound = BenchReferenceLookup(Text.Data, Text.Size, Query, Expected, sizeof(Expected));
+        Name    = BenchIndexLookup(Index, Query);
+
+        if (IsFound != (Name != NULL) || (IsFound && strcmp(Name, Expected) != 0))
+        {
+            printf("err, %04x:%04x:%04x:%04x is '%s' instead of '%s'\n",
+                   Query->VendorId,
+                   Query->DeviceId,
+                   Query->SubVendorId,
+                   Query->SubDeviceId,
+                   Name != NULL ? Name : "(null)",
+                   IsFound ? Expected : "(null)");
+            Errors++;
+        }
+
+        Found += IsFound;
+    }
+
+    printf("%u lookups (%u found) in a database of %zu bytes, the index has %u vendors, %u devices, "
+           "%u subsystems, and %u bytes\n",
+           BENCH_LOOKUPS,
+           Found,
+           Text.Size,
+           Index->NumberOfVendors,
+           Index->NumberOfDevices,
+           Index->NumberOfSubDevices,
+           IndexSize);
+
+    free(Index);
+    free(Text.Data);
+    free(Queries.Queries);
+
+    return Errors == 0;
+}
+
+/**
+ * @brief Check that the stale, truncated, and corrupted indexes are rejected
+ *
+ */
+static BOOLEAN
+BenchTestValidate(void)
+{
+    BENCH_TEXT       Text;
+    BENCH_QUERIES    Queries;
+    UINT32           IndexSize;
+    PCI_IDS_HEADER * Index;
+    PCI_IDS_HEADER * Copy;
+    UINT32           Errors = 0;
+    UINT8            Small[sizeof(PCI_IDS_HEADER)];
+
+    BenchGenerateDatabase(&Text, &Queries, 50);
+
+    Index = BenchCompile(Text.Data, Text.Size, &IndexSize);
+
+    if (Index == NULL)
+    {
+        return FALSE;
+    }
+
+    Copy = (PCI_IDS_HEADER *)malloc(IndexSize);
+
+    //
+    // A buffer that is too small is not touched
+    //
+    memset(Small, 0xcc, sizeof(Small));
+
+    if (PciIdsCompile(Text.Data, Text.Size, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME, Small, sizeof(Small)) != IndexSize ||
+        Small[0] != 0xcc)
+    {
+        printf("err, a small buffer is written\n");
+        Errors++;
+    }
+
+    if (PciIdsValidate(Index, IndexSize, BENCH_SOURCE_SIZE + 1, BENCH_SOURCE_TIME) ||
+        PciIdsValidate(Index, IndexSize, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME + 1))
+    {
+        printf("err, a stale index is accepted\n");
+        Errors++;
+    }
+
+    for (UINT32 Size = 0; Size < IndexSize; Size += 1 + Size / 4)
+    {
+        if (PciIdsValidate(Index, Size, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME))
+        {
+            printf("err, an index that is truncated to %u bytes is accepted\n", Size);
+            Errors++;
+        }
+    }
+
+    for (UINT32 i = 0; i < 8; i++)
+    {
+        const CHAR * Corruption[] = {"signature", "version", "total size", "vendor name", "device range", "subsystem name", "pool", "offset"};
+        UINT8 *      Data         = (UINT8 *)Copy;
+
+        memcpy(Copy, Index, IndexSize);
+
+        switch (i)
+        {
+        case 0:
+            Copy->Signature ^= 1;
+            break;
+        case 1:
+            Copy->Version++;
+            break;
+        case 2:
+            Copy->TotalSize--;
+            break;
+        case 3:
+            ((PCI_IDS_VENDOR *)(Data + Copy->VendorsOffset))[Copy->NumberOfVendors - 1].Name = Copy->NamesSize;
+            break;
+        case 4:
+            ((PCI_IDS_VENDOR *)(Data + Copy->VendorsOffset))[0].FirstDevice = Copy->NumberOfDevices;
+            ((PCI_IDS_VENDOR *)(Data + Copy->VendorsOffset))[0].NumberOfDevices++;
+            break;
+        case 5:
+            ((PCI_IDS_SUBDEVICE *)(Data + Copy->SubDevicesOffset))[0].Name = 0xffffffff;
+            break;
+        case 6:
+            Data[IndexSize - 1] = 'x';
+            break;
+        case 7:
+            Copy->DevicesOffset += 4;
+            break;
+        }
+
+        if (PciIdsValidate(Copy, IndexSize, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME))
+        {
+            printf("err, an index with a corrupted %s is accepted\n", Corruption[i]);
+            Errors++;
+        }
+    }
+
+    free(Copy);
+    free(Index);
+    free(Text.Data);
+    free(Queries.Queries);
+
+    return Errors == 0;
+}
+
+/**
+ * @brief Measure compiling the index and the lookups
+ *
+ */
+static VOID
+BenchMeasure(void)
+{
+    BENCH_TEXT       Text;
+    BENCH_QUERIES    Queries;
+    UINT32           IndexSize;
+    PCI_IDS_HEADER * Index;
+    double           Start;
+    double           Compiling;
+    double           Validating;
+    double           Lookups;
+    double           Scans;
+    UINT32           Found = 0;
+    CHAR             Name[1024];
+
+    BenchGenerateDatabase(&Text, &Queries, BENCH_MEASURE_VENDORS);
+
+    Start     = BenchNow();
+    Index     = BenchCompile(Text.Data, Text.Size, &IndexSize);
+    Compiling = BenchNow() - Start;
+
+    if (Index == NULL)
+    {
+        free(Text.Data);
+        free(Queries.Queries);
+        return;
+    }
+
+    Start      = BenchNow();
+    Found      = PciIdsValidate(Index, IndexSize, BENCH_SOURCE_SIZE, BENCH_SOURCE_TIME);
+    Validating = BenchNow() - Start;
+
+    Start = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_MEASURE_LOOKUPS; i++)
+    {
+        Found += BenchIndexLookup(Index, &Queries.Queries[i % Queries.NumberOfQueries]) != NULL;
+    }
+
+    Lookups = BenchNow() - Start;
+    Start   = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_MEASURE_SCANS; i++)
+    {
+        Found += BenchReferenceLookup(Text.Data, Text.Size, &Queries.Queries[BenchRandom() % Queries.NumberOfQueries], Name, sizeof(Name));
+    }
+
+    Scans = BenchNow() - Start;
+
+    printf("database of %zu bytes: compiling %.2f ms, validating %.2f ms, lookup %.2f ns, scanning %.2f us "
+           "(%u found)\n",
+           Text.Size,
+           Compiling * 1e3,
+           Validating * 1e3,
+           Lookups * 1e9 / BENCH_MEASURE_LOOKUPS,
+           Scans * 1e6 / BENCH_MEASURE_SCANS,
+           Found);
+
+    free(Index);
+    free(Text.Data);
+    free(Queries.Queries);
+}
+
+int
+main(void)
+{
+    if (!BenchTestHandwritten() || !BenchTestLookups() || !BenchTestValidate())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("pci ids tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,1023 @@
+/**
+ * @file peanalysis-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the PE analysis kernels (and summaries of the images)
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_LFANEW            0x80
+#define BENCH_SIZE_OF_HEADERS   0x400
+#define BENCH_SECTIONS          4
+#define BENCH_TAIL_SIZE         0x123
+#define BENCH_IMAGE_SIZE        (BENCH_SIZE_OF_HEADERS + 0x3000 + BENCH_TAIL_SIZE)
+#define BENCH_MEASURE_SIZE      (64 * 1024 * 1024)
+#define BENCH_MEASURE_ROUNDS    4
+#define BENCH_CSV_COLUMNS       21
+#define BENCH_MAXIMUM_PATH      4096
+#define BENCH_WRITTEN_FILE_SIZE 0xa000
+#define BENCH_DLL_PATH          "../../../libraries/libipt/libipt.dll"
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static void
+BenchFill(BYTE * Buffer, SIZE_T Size, UINT64 * State)
+{
+    for (SIZE_T i = 0; i < Size; i++)
+    {
+        Buffer[i] = (BYTE)BenchRandomFrom(State);
+    }
+}
+
+static void
+BenchWrite16(BYTE * Data, UINT16 Value)
+{
+    memcpy(Data, &Value, sizeof(Value));
+}
+
+static void
+BenchWrite32(BYTE * Data, UINT32 Value)
+{
+    memcpy(Data, &Value, sizeof(Value));
+}
+
+static void
+BenchWrite64(BYTE * Data, UINT64 Value)
+{
+    memcpy(Data, &Value, sizeof(Value));
+}
+
+/**
+ * @brief Reference FNV-1a (the loop of '.pe section')
+ *
+ */
+static UINT64
+BenchReferenceFnv1a64(const BYTE * Data, SIZE_T Size)
+{
+    UINT64 Hash = 14695981039346656037ull;
+
+    for (SIZE_T i = 0; i < Size; i++)
+    {
+        Hash ^= Data[i];
+        Hash *= 1099511628211ull;
+    }
+
+    return Hash;
+}
+
+/**
+ * @brief Reference entropy (the loop of '.pe section')
+ *
+ */
+static double
+BenchReferenceEntropy(const BYTE * Data, SIZE_T Size)
+{
+    UINT32 Counts[256] = {0};
+    double Entropy     = 0.0;
+
+    for (SIZE_T i = 0; i < Size; i++)
+    {
+        Counts[Data[i]]++;
+    }
+
+    for (UINT32 i = 0; i < 256; i++)
+    {
+        if (Counts[i] != 0)
+        {
+            double Probability = (double)Counts[i] / (double)Size;
+            Entropy -= Probability * (log(Probability) / log(2.0));
+        }
+    }
+
+    return Entropy;
+}
+
+/**
+ * @brief Reference checksum (the loop of '.pe header', a word at a time with
+ * the end-around carries)
+ *
+ */
+static UINT32
+BenchReferenceChecksum(const BYTE * Image, SIZE_T ImageSize, SIZE_T ChecksumOffset)
+{
+    UINT64 Sum = 0;
+
+    for (SIZE_T Offset = 0; Offset < ImageSize; Offset += 2)
+    {
+        UINT16 Value = 0;
+
+        if (Offset >= ChecksumOffset && Offset < ChecksumOffset + 4)
+        {
+            Value = 0;
+        }
+        else if (Offset + 1 < ImageSize)
+        {
+            memcpy(&Value, Image + Offset, sizeof(Value));
+        }
+        else
+        {
+            Value = Image[Offset];
+        }
+
+        Sum += Value;
+        Sum = (Sum & 0xffff) + (Sum >> 16);
+    }
+
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+
+    return (UINT32)Sum + (UINT32)ImageSize;
+}
+
+/**
+ * @brief Check the kernels of a buffer against the references
+ *
+ */
+static BOOLEAN
+BenchCheckBuffer(const BYTE * Data, SIZE_T Size, UINT64 * State)
+{
+    UINT64 Counts[256]   = {0};
+    UINT64 Expected[256] = {0};
+    UINT64 Hash;
+    UINT32 Checksum;
+
+    for (SIZE_T i = 0; i < Size; i++)
+    {
+        Expected[Data[i]]++;
+    }
+
+    Hash = PeAnalysisHashAndCountBytes(Data, Size, Counts);
+
+    if (Hash != BenchReferenceFnv1a64(Data, Size) || PeAnalysisFnv1a64(Data, Size) != Hash)
+    {
+        printf("err, hash of %zu bytes\n", (size_t)Size);
+        return FALSE;
+    }
+
+    if (memcmp(Counts, Expected, sizeof(Counts)) != 0)
+    {
+        printf("err, counts of %zu bytes\n", (size_t)Size);
+        return FALSE;
+    }
+
+    //
+    // The entropy is computed by the same operations in the same order
+    //
+    if (Size != 0 && (PeAnalysisEntropy(Counts, Size) != BenchReferenceEntropy(Data, Size) ||
+                      PeAnalysisCalculateEntropy(Data, Size) != BenchReferenceEntropy(Data, Size)))
+    {
+        printf("err, entropy of %zu bytes\n", (size_t)Size);
+        return FALSE;
+    }
+
+    if (Size < 4)
+    {
+        return PeAnalysisChecksum(Data, Size, 0, &Checksum) == FALSE;
+    }
+
+    for (UINT32 i = 0; i < 8; i++)
+    {
+        SIZE_T Offset;
+
+        //
+        // Even and odd offsets, at the start and at the end of the image
+        //
+        if (i == 0)
+            Offset = 0;
+        else if (i == 1)
+            Offset = Size - 4;
+        else if (i == 2)
+            Offset = Size >= 5 ? Size - 5 : 0;
+        else
+            Offset = (SIZE_T)(BenchRandomFrom(State) % (Size - 3));
+
+        if (!PeAnalysisChecksum(Data, Size, Offset, &Checksum) || Checksum != BenchReferenceChecksum(Data, Size, Offset))
+        {
+            printf("err, checksum of %zu bytes (checksum at %zu)\n", (size_t)Size, (size_t)Offset);
+            return FALSE;
+        }
+    }
+
+    if (PeAnalysisChecksum(Data, Size, Size - 3, &Checksum) || PeAnalysisChecksum(Data, Size, Size + 1, &Checksum))
+    {
+        printf("err, checksum field out of %zu bytes\n", (size_t)Size);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the kernels on random, zero, and 0xff buffers of all of the small
+ * sizes and alignments
+ *
+ */
+static BOOLEAN
+BenchTestKernels(void)
+{
+    UINT64  State  = 0x9e3779b97f4a7c15ull;
+    SIZE_T  Size   = 1024 * 1024 + 13;
+    BYTE *  Buffer = (BYTE *)malloc(Size + 8);
+    BOOLEAN Status = TRUE;
+
+    if (Buffer == NULL)
+    {
+        return FALSE;
+    }
+
+    for (UINT32 Pattern = 0; Pattern < 3 && Status; Pattern++)
+    {
+        if (Pattern == 0)
+            BenchFill(Buffer, Size + 8, &State);
+        else
+            memset(Buffer, Pattern == 1 ? 0 : 0xff, Size + 8);
+
+        for (SIZE_T Length = 0; Length < 300 && Status; Length++)
+        {
+            for (UINT32 Alignment = 0; Alignment < 8 && Status; Alignment++)
+            {
+                Status = BenchCheckBuffer(Buffer + Alignment, Length, &State);
+            }
+        }
+
+        if (Status)
+        {
+            Status = BenchCheckBuffer(Buffer + 3, Size, &State) && BenchCheckBuffer(Buffer, Size - 1, &State);
+        }
+    }
+
+    free(Buffer);
+
+    return Status;
+}
+
+/**
+ * @brief Build an image with a section of code, a writable and executable
+ * section, a section of zeros, and a section that is cut by the end of the
+ * file
+ *
+ */
+static void
+BenchBuildImage(BYTE * Image, BOOLEAN IsPe32Plus, UINT64 * State)
+{
+    static const char * Names[BENCH_SECTIONS]           = {".text", ".data", ".bss\"\\", ".rsrc"};
+    static const UINT32 Characteristics[BENCH_SECTIONS] = {0x60000020, 0xe0000040, 0xc0000080, 0x40000040};
+    BYTE *              Nt                              = Image + BENCH_LFANEW;
+    BYTE *              Optional                        = Nt + 24;
+    BYTE *              Sections                        = Optional + (IsPe32Plus ? 240 : 224);
+    UINT32              Checksum;
+
+    memset(Image, 0, BENCH_IMAGE_SIZE);
+    BenchFill(Image + BENCH_SIZE_OF_HEADERS, BENCH_IMAGE_SIZE - BENCH_SIZE_OF_HEADERS, State);
+
+    //
+    // The third section is zeros
+    //
+    memset(Image + BENCH_SIZE_OF_HEADERS + 0x2000, 0, 0x800);
+
+    BenchWrite16(Image, 0x5a4d);
+    BenchWrite32(Image + 0x3c, BENCH_LFANEW);
+    BenchWrite32(Nt, 0x00004550);
+    BenchWrite16(Nt + 4, IsPe32Plus ? 0x8664 : 0x14c);
+    BenchWrite16(Nt + 6, BENCH_SECTIONS);
+    BenchWrite32(Nt + 8, 0x5f5e100);
+    BenchWrite16(Nt + 20, IsPe32Plus ? 240 : 224);
+    BenchWrite16(Nt + 22, IsPe32Plus ? 0x22 : 0x102);
+    BenchWrite16(Optional, IsPe32Plus ? 0x20b : 0x10b);
+    BenchWrite32(Optional + 16, 0x1234);
+    BenchWrite32(Optional + 56, 0x6000);
+    BenchWrite32(Optional + 60, BENCH_SIZE_OF_HEADERS);
+    BenchWrite16(Optional + 68, 3);
+    BenchWrite16(Optional + 70, 0x8160);
+
+    if (IsPe32Plus)
+        BenchWrite64(Optional + 24, 0x140000000ull);
+    else
+        BenchWrite32(Optional + 28, 0x400000);
+
+    for (UINT32 i = 0; i < BENCH_SECTIONS; i++)
+    {
+        BYTE * Header = Sections + i * 40;
+
+        memcpy(Header, Names[i], strlen(Names[i]) < 8 ? strlen(Names[i]) : 8);
+        BenchWrite32(Header + 8, 0x1000);
+        BenchWrite32(Header + 12, 0x1000 * (i + 1));
+        BenchWrite32(Header + 16, i == 2 ? 0x800 : 0x1000);
+        BenchWrite32(Header + 20, BENCH_SIZE_OF_HEADERS + 0x1000 * i);
+        BenchWrite32(Header + 36, Characteristics[i]);
+    }
+
+    //
+    // Only the first 0x100 bytes of the raw data of the last section are in the
+    // file (so there is no overlay)
+    //
+    BenchWrite32(Sections + 3 * 40 + 20, BENCH_IMAGE_SIZE - 0x100);
+    BenchWrite32(Sections + 3 * 40 + 16, 0x1000);
+
+    Checksum = BenchReferenceChecksum(Image, BENCH_IMAGE_SIZE, (SIZE_T)(Optional + 64 - Image));
+    BenchWrite32(Optional + 64, Checksum);
+}
+
+/**
+ * @brief Check the summary of the images and of the invalid images
+ *
+ */
+static BOOLEAN
+BenchTestImages(void)
+{
+    static BYTE         Image[BENCH_IMAGE_SIZE];
+    PE_ANALYSIS_IMAGE   Summary;
+    PE_ANALYSIS_SECTION Sections[PE_ANALYSIS_MAXIMUM_SECTIONS];
+    UINT64              State = 0x2545f4914f6cdd1dull;
+
+    for (UINT32 Format = 0; Format < 2; Format++)
+    {
+        BOOLEAN IsPe32Plus = Format == 1;
+
+        BenchBuildImage(Image, IsPe32Plus, &State);
+
+        if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_SUCCESS)
+        {
+            printf("err, image is not analyzed\n");
+            return FALSE;
+        }
+
+        if (Summary.IsPe32Plus != IsPe32Plus || Summary.Machine != (IsPe32Plus ? 0x8664 : 0x14c) ||
+            Summary.ImageBase != (IsPe32Plus ? 0x140000000ull : 0x400000) || Summary.AddressOfEntryPoint != 0x1234 ||
+            Summary.SizeOfImage != 0x6000 || Summary.Subsystem != 3 || Summary.DllCharacteristics != 0x8160 ||
+            Summary.TimeDateStamp != 0x5f5e100 || Summary.NumberOfSections != BENCH_SECTIONS ||
+            Summary.NumberOfAnalyzedSections != BENCH_SECTIONS || Summary.FileSize != BENCH_IMAGE_SIZE)
+        {
+            printf("err, fields of the headers\n");
+            return FALSE;
+        }
+
+        if (Summary.HeaderChecksum == 0 || Summary.ComputedChecksum != Summary.HeaderChecksum)
+        {
+            printf("err, checksum %x (expected %x)\n", Summary.ComputedChecksum, Summary.HeaderChecksum);
+            return FALSE;
+        }
+
+        if (Summary.WritableExecutableSections != 1 || Summary.OverlaySize != 0 ||
+            Summary.FileEntropy != BenchReferenceEntropy(Image, BENCH_IMAGE_SIZE))
+        {
+            printf("err, summary of the image\n");
+            return FALSE;
+        }
+
+        for (UINT32 i = 0; i < BENCH_SECTIONS; i++)
+        {
+            const BYTE * Raw      = Image + Sections[i].PointerToRawData;
+            UINT32       Expected = i == 2 ? 0x800 : (i == 3 ? 0x100 : 0x1000);
+
+            if (Sections[i].AnalyzedSize != Expected || Sections[i].Fnv1a64 != BenchReferenceFnv1a64(Raw, Expected) ||
+                Sections[i].Entropy != BenchReferenceEntropy(Raw, Expected) || Sections[i].VirtualAddress != 0x1000 * (i + 1))
+            {
+                printf("err, section %u\n", i);
+                return FALSE;
+            }
+        }
+
+        if (strcmp(Sections[0].Name, ".text") != 0 || strcmp(Sections[2].Name, ".bss\"\\") != 0 || Sections[2].Entropy != 0.0 ||
+            Summary.HighestEntropySection > 1)
+        {
+            printf("err, names or entropy of the sections\n");
+            return FALSE;
+        }
+
+        //
+        // The last section is moved inside the file, so the bytes after the
+        // third section are the overlay
+        //
+        BenchWrite32(Image + BENCH_LFANEW + 24 + (IsPe32Plus ? 240 : 224) + 3 * 40 + 20, BENCH_SIZE_OF_HEADERS + 0x2800);
+        BenchWrite32(Image + BENCH_LFANEW + 24 + (IsPe32Plus ? 240 : 224) + 3 * 40 + 16, 0x200);
+
+        if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_SUCCESS ||
+            Summary.OverlaySize != BENCH_IMAGE_SIZE - (BENCH_SIZE_OF_HEADERS + 0x2a00) || Summary.ComputedChecksum == Summary.HeaderChecksum)
+        {
+            printf("err, overlay of the image\n");
+            return FALSE;
+        }
+    }
+
+    //
+    // Invalid and truncated images
+    //
+    BenchBuildImage(Image, TRUE, &State);
+
+    if (PeAnalysisAnalyzeImage(Image, 0x30, &Summary, Sections) != PE_ANALYSIS_STATUS_NOT_PE_IMAGE ||
+        PeAnalysisAnalyzeImage(Image, BENCH_LFANEW + 2, &Summary, Sections) != PE_ANALYSIS_STATUS_NOT_PE_IMAGE ||
+        PeAnalysisAnalyzeImage(Image, BENCH_LFANEW + 24 + 100, &Summary, Sections) != PE_ANALYSIS_STATUS_TRUNCATED_HEADERS ||
+        PeAnalysisAnalyzeImage(Image, BENCH_LFANEW + 24 + 240 + 3 * 40, &Summary, Sections) != PE_ANALYSIS_STATUS_TRUNCATED_HEADERS ||
+        PeAnalysisAnalyzeImage(Image, BENCH_LFANEW + 24 + 240 + 4 * 40, &Summary, Sections) != PE_ANALYSIS_STATUS_SUCCESS)
+    {
+        printf("err, truncated images\n");
+        return FALSE;
+    }
+
+    BenchWrite16(Image + BENCH_LFANEW + 20, 224);
+
+    if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER)
+    {
+        printf("err, small optional header\n");
+        return FALSE;
+    }
+
+    BenchWrite16(Image + BENCH_LFANEW + 20, 240);
+    BenchWrite16(Image + BENCH_LFANEW + 24, 0x107);
+
+    if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_UNSUPPORTED_OPTIONAL_HEADER)
+    {
+        printf("err, unknown optional header\n");
+        return FALSE;
+    }
+
+    BenchWrite32(Image + 0x3c, 0x80000000);
+
+    if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_NOT_PE_IMAGE)
+    {
+        printf("err, negative e_lfanew\n");
+        return FALSE;
+    }
+
+    BenchWrite32(Image + 0x3c, BENCH_IMAGE_SIZE - 2);
+
+    if (PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections) != PE_ANALYSIS_STATUS_NOT_PE_IMAGE)
+    {
+        printf("err, e_lfanew at the end of the file\n");
+        return FALSE;
+    }
+
+    //
+    // More sections than the maximum are counted but not analyzed
+    //
+    {
+        SIZE_T  Size  = BENCH_LFANEW + 24 + 240 + 200 * 40;
+        BYTE *  Large = (BYTE *)calloc(1, Size);
+        BOOLEAN IsValid;
+
+        if (Large == NULL)
+        {
+            return FALSE;
+        }
+
+        memcpy(Large, Image, BENCH_LFANEW + 24 + 240);
+        BenchWrite32(Large + 0x3c, BENCH_LFANEW);
+        BenchWrite16(Large + BENCH_LFANEW + 24, 0x20b);
+        BenchWrite16(Large + BENCH_LFANEW + 6, 200);
+
+        for (UINT32 i = 0; i < 200; i++)
+        {
+            BenchWrite32(Large + BENCH_LFANEW + 24 + 240 + i * 40 + 36, 0xa0000020);
+        }
+
+        IsValid = PeAnalysisAnalyzeImage(Large, Size, &Summary, Sections) == PE_ANALYSIS_STATUS_SUCCESS &&
+                  Summary.NumberOfSections == 200 && Summary.NumberOfAnalyzedSections == PE_ANALYSIS_MAXIMUM_SECTIONS &&
+                  Summary.WritableExecutableSections == 200;
+
+        free(Large);
+
+        if (!IsValid)
+        {
+            printf("err, sections after the maximum\n");
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Count the columns of a CSV row
+ *
+ */
+static UINT32
+BenchCountColumns(const CHAR * Line)
+{
+    UINT32  Columns  = 1;
+    BOOLEAN IsQuoted = FALSE;
+
+    for (; *Line != '\0' && *Line != '\n'; Line++)
+    {
+        if (*Line == '"')
+            IsQuoted = !IsQuoted;
+        else if (*Line == ',' && !IsQuoted)
+            Columns++;
+    }
+
+    return Columns;
+}
+
+/**
+ * @brief Check the JSON lines and the CSV rows
+ *
+ */
+static BOOLEAN
+BenchTestFormat(void)
+{
+    static BYTE         Image[BENCH_IMAGE_SIZE];
+    static CHAR         Line[PE_ANALYSIS_MAXIMUM_SUMMARY_SIZE + 256];
+    PE_ANALYSIS_IMAGE   Summary;
+    PE_ANALYSIS_SECTION Sections[PE_ANALYSIS_MAXIMUM_SECTIONS];
+    UINT64              State = 0x5851f42d4c957f2dull;
+    const CHAR *        Path  = "c:\\samples\\\"a\"\n\xe9.exe";
+    UINT32              Length;
+
+    BenchBuildImage(Image, TRUE, &State);
+    PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Summary, Sections);
+
+    Length = PeAnalysisFormatJson(Path, &Summary, Sections, Line, sizeof(Line));
+
+    if (Length == 0 || Length != strlen(Line) || Line[Length - 1] != '\n' || strchr(Line, '\n') != &Line[Length - 1] ||
+        strstr(Line, "{\"path\":\"c:\\\\samples\\\\\\\"a\\\"\\u000a\\u00e9.exe\",\"status\":\"ok\"") != Line ||
+        strstr(Line, "\"format\":\"pe32+\"") == NULL || strstr(Line, "\"checksum_matches\":true") == NULL ||
+        strstr(Line, "\"name\":\".bss\\\"\\\\\"") == NULL || strstr(Line, "\"image_base\":\"0x140000000\"") == NULL)
+    {
+        printf("err, JSON line: %s", Line);
+        return FALSE;
+    }
+
+    //
+    // A line that doesn't fit is not formatted
+    //
+    for (UINT32 Size = 0; Size <= Length; Size += 7)
+    {
+        if (PeAnalysisFormatJson(Path, &Summary, Sections, Line, Size) != 0)
+        {
+            printf("err, JSON line in %u bytes\n", Size);
+            return FALSE;
+        }
+    }
+
+    if (PeAnalysisFormatJson(Path, &Summary, Sections, Line, Length + 1) != Length)
+    {
+        printf("err, JSON line in the exact size\n");
+        return FALSE;
+    }
+
+    Length = PeAnalysisFormatCsv(Path, &Summary, Sections, Line, sizeof(Line));
+
+    if (Length == 0 || strstr(Line, "\"c:\\samples\\\"\"a\"\" \xe9.exe\",ok,") != Line ||
+        BenchCountColumns(Line) != BENCH_CSV_COLUMNS || strchr(Line, '\n') != &Line[Length - 1])
+    {
+        printf("err, CSV row: %s", Line);
+        return FALSE;
+    }
+
+    Length = PeAnalysisFormatCsvHeader(Line, sizeof(Line));
+
+    if (Length == 0 || BenchCountColumns(Line) != BENCH_CSV_COLUMNS)
+    {
+        printf("err, CSV header: %s", Line);
+        return FALSE;
+    }
+
+    PeAnalysisAnalyzeImage(Image, 0x20, &Summary, Sections);
+
+    if (PeAnalysisFormatCsv("a.exe", &Summary, Sections, Line, sizeof(Line)) == 0 || BenchCountColumns(Line) != BENCH_CSV_COLUMNS ||
+        strcmp(Line, "\"a.exe\",not-pe,32,,,,,,,,,,,,,,,,,,\n") != 0 ||
+        PeAnalysisFormatJson("a.exe", &Summary, Sections, Line, sizeof(Line)) == 0 ||
+        strcmp(Line, "{\"path\":\"a.exe\",\"status\":\"not-pe\",\"file_size\":32}\n") != 0)
+    {
+        printf("err, summary of an invalid image: %s", Line);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure the kernels against the byte-at-a-time loops
+ *
+ */
+static void
+BenchMeasure(void)
+{
+    BYTE * Buffer = (BYTE *)malloc(BENCH_MEASURE_SIZE);
+    UINT64 State  = 0x853c49e6748fea9bull;
+    UINT64 Counts[256];
+    UINT64 Hash     = 0;
+    UINT32 Checksum = 0;
+    double Entropy  = 0;
+    double Start;
+    double Times[6] = {0};
+
+    if (Buffer == NULL)
+    {
+        return;
+    }
+
+    BenchFill(Buffer, BENCH_MEASURE_SIZE, &State);
+
+    for (UINT32 Round = 0; Round < BENCH_MEASURE_ROUNDS; Round++)
+    {
+        Start = BenchNow();
+        Hash ^= BenchReferenceFnv1a64(Buffer, BENCH_MEASURE_SIZE);
+        Entropy += BenchReferenceEntropy(Buffer, BENCH_MEASURE_SIZE);
+        Times[0] += BenchNow() - Start;
+
+        Start = BenchNow();
+        memset(Counts, 0, sizeof(Counts));
+        Hash ^= PeAnalysisHashAndCountBytes(Buffer, BENCH_MEASURE_SIZE, Counts);
+        Entropy += PeAnalysisEntropy(Counts, BENCH_MEASURE_SIZE);
+        Times[1] += BenchNow() - Start;
+
+        Start = BenchNow();
+        Entropy += BenchReferenceEntropy(Buffer, BENCH_MEASURE_SIZE);
+        Times[2] += BenchNow() - Start;
+
+        Start = BenchNow();
+        Entropy += PeAnalysisCalculateEntropy(Buffer, BENCH_MEASURE_SIZE);
+        Times[3] += BenchNow() - Start;
+
+        Start = BenchNow();
+        Checksum ^= BenchReferenceChecksum(Buffer, BENCH_MEASURE_SIZE, 0xd8);
+        Times[4] += BenchNow() - Start;
+
+        Start = BenchNow();
+        PeAnalysisChecksum(Buffer, BENCH_MEASURE_SIZE, 0xd8, &Checksum);
+        Times[5] += BenchNow() - Start;
+    }
+
+    printf("hash and entropy of sections : %8.1f MB/s (byte loops: %8.1f MB/s)\n",
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[1]),
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[0]));
+    printf("entropy of files             : %8.1f MB/s (byte loop : %8.1f MB/s)\n",
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[3]),
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[2]));
+    printf("checksum                     : %8.1f MB/s (word loop : %8.1f MB/s)\n",
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[5]),
+           BenchThroughput((UINT64)BENCH_MEASURE_ROUNDS * BENCH_MEASURE_SIZE, Times[4]));
+
+    //
+    // Keeps the results alive
+    //
+    if (Hash == 0 && Checksum == 0 && Entropy == 0)
+    {
+        printf("\n");
+    }
+
+    free(Buffer);
+}
+
+/**
+ * @brief Map a whole file through the platform layer (the same way as
+ * '.pe batch', which passes the paths as wide strings)
+ *
+ */
+static const UINT8 *
+BenchMapFile(const char * Path, SIZE_T * Size, HANDLE * FileHandle)
+{
+    wchar_t WidePath[BENCH_MAXIMUM_PATH];
+
+    *Size       = 0;
+    *FileHandle = INVALID_HANDLE_VALUE;
+
+    if (mbstowcs(WidePath, Path, BENCH_MAXIMUM_PATH) >= BENCH_MAXIMUM_PATH)
+    {
+        return NULL;
+    }
+
+    return (const UINT8 *)PlatformMapFileReadOnly((const WCHAR *)WidePath, Size, FileHandle);
+}
+
+/**
+ * @brief Get the size and the last write time of a file through the platform
+ * layer
+ *
+ */
+static BOOLEAN
+BenchGetFileSizeAndTime(const char * Path, UINT64 * FileSize, UINT64 * LastWriteTime)
+{
+    wchar_t WidePath[BENCH_MAXIMUM_PATH];
+
+    if (mbstowcs(WidePath, Path, BENCH_MAXIMUM_PATH) >= BENCH_MAXIMUM_PATH)
+    {
+        return FALSE;
+    }
+
+    return PlatformGetFileSizeAndTime((const WCHAR *)WidePath, FileSize, LastWriteTime);
+}
+
+/**
+ * @brief Check the analysis of the images that are mapped from the files (a
+ * written image, an empty and a missing file, and a real DLL of the tree)
+ *
+ */
+static BOOLEAN
+BenchTestMappedImages(void)
+{
+    static BYTE         Image[BENCH_IMAGE_SIZE];
+    PE_ANALYSIS_IMAGE   Expected;
+    PE_ANALYSIS_IMAGE   Summary;
+    PE_ANALYSIS_SECTION ExpectedSections[PE_ANALYSIS_MAXIMUM_SECTIONS];
+    PE_ANALYSIS_SECTION Sections[PE_ANALYSIS_MAXIMUM_SECTIONS];
+    char                Path[] = "/tmp/peanalysis-bench-XXXXXX";
+    BYTE                Header[0x40];
+    UINT64              State = 0x5851f42d4c957f2dull;
+    const UINT8 *       File;
+    SIZE_T              Size;
+    UINT64              FileSize;
+    UINT64              LastWriteTime;
+    HANDLE              FileHandle;
+    DWORD               BytesRead;
+    int                 Descriptor;
+    BOOLEAN             Status;
+
+    BenchBuildImage(Image, TRUE, &State);
+    PeAnalysisAnalyzeImage(Image, BENCH_IMAGE_SIZE, &Expected, ExpectedSections);
+
+    Descriptor = mkstemp(Path);
+
+    if (Descriptor < 0 || write(Descriptor, Image, sizeof(Image)) != (ssize_t)sizeof(Image))
+    {
+        printf("err, unable to write the image file\n");
+        return FALSE;
+    }
+
+    close(Descriptor);
+
+    //
+    // The size and the time are found without opening the file
+    //
+    if (!BenchGetFileSizeAndTime(Path, &FileSize, &LastWriteTime) || FileSize != BENCH_IMAGE_SIZE ||
+        LastWriteTime == 0)
+    {
+        unlink(Path);
+        printf("err, size and time of the image file\n");
+        return FALSE;
+    }
+
+    //
+    // The mapped view, the raw reads of the handle, and the summary must be the
+    // same as the image in the memory
+    //
+    File   = BenchMapFile(Path, &Size, &FileHandle);
+    Status = File != NULL && Size == BENCH_IMAGE_SIZE && memcmp(File, Image, Size) == 0;
+
+    if (Status)
+    {
+        Status = PlatformReadFileAtOffset(FileHandle, BENCH_LFANEW, Header, sizeof(Header), &BytesRead) &&
+                 BytesRead == sizeof(Header) && memcmp(Header, Image + BENCH_LFANEW, sizeof(Header)) == 0;
+    }
+
+    if (Status)
+    {
+        Status = PeAnalysisAnalyzeImage(File, Size, &Summary, Sections) == PE_ANALYSIS_STATUS_SUCCESS &&
+                 Summary.FileSize == Expected.FileSize && Summary.ComputedChecksum == Expected.HeaderChecksum &&
+                 Summary.FileEntropy == Expected.FileEntropy && Summary.NumberOfAnalyzedSections == BENCH_SECTIONS;
+
+        for (UINT32 i = 0; i < BENCH_SECTIONS && Status; i++)
+        {
+            Status = Sections[i].Fnv1a64 == ExpectedSections[i].Fnv1a64 && Sections[i].Entropy == ExpectedSections[i].Entropy;
+        }
+    }
+
+    PlatformUnmapFile((VOID *)File, Size, FileHandle);
+
+    if (!Status)
+    {
+        unlink(Path);
+        printf("err, mapped image\n");
+        return FALSE;
+    }
+
+    //
+    // Empty and missing files are not mapped, a missing file has no size
+    //
+    Descriptor = open(Path, O_WRONLY | O_TRUNC);
+
+    if (Descriptor >= 0)
+    {
+        close(Descriptor);
+    }
+
+    File = BenchMapFile(Path, &Size, &FileHandle);
+    unlink(Path);
+
+    if (Descriptor < 0 || File != NULL || FileHandle != INVALID_HANDLE_VALUE ||
+        BenchMapFile(Path, &Size, &FileHandle) != NULL || Size != 0 ||
+        BenchGetFileSizeAndTime(Path, &FileSize, &LastWriteTime))
+    {
+        printf("err, empty or missing file is mapped or found\n");
+        return FALSE;
+    }
+
+    //
+    // A real image (the prebuilt libipt of the tree)
+    //
+    File = BenchMapFile(BENCH_DLL_PATH, &Size, &FileHandle);
+
+    if (File == NULL)
+    {
+        printf("'%s' is not found, the real image is not checked\n", BENCH_DLL_PATH);
+        return TRUE;
+    }
+
+    Status = PeAnalysisAnalyzeImage(File, Size, &Summary, Sections) == PE_ANALYSIS_STATUS_SUCCESS &&
+             Summary.IsPe32Plus && Summary.Machine == 0x8664 && Summary.FileSize == Size &&
+             Summary.NumberOfAnalyzedSections != 0 &&
+             (Summary.HeaderChecksum == 0 || Summary.ComputedChecksum == Summary.HeaderChecksum);
+
+    PlatformUnmapFile((VOID *)File, Size, FileHandle);
+
+    if (!Status)
+    {
+        printf("err, summary of '%s' (status %u)\n", BENCH_DLL_PATH, Summary.Status);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the file writers of the platform (the ones of the dump engine):
+ * the sequential and the positioned writes, the holes, and the size of the file
+ *
+ */
+static BOOLEAN
+BenchTestWrittenFiles(void)
+{
+    static BYTE Expected[BENCH_WRITTEN_FILE_SIZE];
+    static BYTE Buffer[BENCH_WRITTEN_FILE_SIZE];
+    char        Path[] = "/tmp/peanalysis-bench-XXXXXX";
+    wchar_t     WidePath[BENCH_MAXIMUM_PATH];
+    BYTE        Data[0x3000];
+    UINT64      State = 0x2545f4914f6cdd1dull;
+    UINT64      FileSize;
+    UINT64      LastWriteTime;
+    HANDLE      FileHandle = INVALID_HANDLE_VALUE;
+    DWORD       BytesRead;
+    int         Descriptor;
+    BOOLEAN     Status;
+
+    Descriptor = mkstemp(Path);
+
+    if (Descriptor < 0)
+    {
+        printf("err, unable to create the temporary file\n");
+        return FALSE;
+    }
+
+    close(Descriptor);
+    mbstowcs(WidePath, Path, BENCH_MAXIMUM_PATH);
+
+    for (UINT32 i = 0; i < sizeof(Data); i++)
+    {
+        State   = State * 6364136223846793005ull + 1442695040888963407ull;
+        Data[i] = (BYTE)(State >> 56);
+    }
+
+    //
+    // Sequential writes truncate the file that exists
+    //
+    FileHandle = PlatformOpenFileForWriting((const WCHAR *)WidePath);
+    Status     = FileHandle != INVALID_HANDLE_VALUE && PlatformWriteFile(FileHandle, Data, sizeof(Data));
+
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        PlatformCloseFile(FileHandle);
+        FileHandle = INVALID_HANDLE_VALUE;
+    }
+
+    Status = Status && BenchGetFileSizeAndTime(Path, &FileSize, &LastWriteTime) && FileSize == sizeof(Data);
+
+    //
+    // Positioned writes, then a hole in the middle of the written pages and
+    // the size of the file (the same calls as the writer of the dumps)
+    //
+    if (Status)
+    {
+        FileHandle = PlatformOpenFileForUpdate((const WCHAR *)WidePath);
+        Status     = FileHandle != INVALID_HANDLE_VALUE && PlatformSetFileSize(FileHandle, 0);
+    }
+
+    if (Status)
+    {
+        Status = PlatformWriteFileAtOffset(FileHandle, 0x5000, Data, 0x3000) &&
+                 PlatformWriteFileAtOffset(FileHandle, 0x1000, Data, 0x2000) &&
+                 PlatformPunchFileHole(FileHandle, 0x6000, 0x1000) && PlatformSetFileSize(FileHandle, BENCH_WRITTEN_FILE_SIZE);
+
+        memcpy(Expected + 0x5000, Data, 0x1000);
+        memcpy(Expected + 0x7000, Data + 0x2000, 0x1000);
+        memcpy(Expected + 0x1000, Data, 0x2000);
+    }
+
+    //
+    // The hole and the extended tail are read as zeros
+    //
+    if (Status)
+    {
+        Status = PlatformReadFileAtOffset(FileHandle, 0, Buffer, sizeof(Buffer), &BytesRead) &&
+                 BytesRead == sizeof(Buffer) && memcmp(Buffer, Expected, sizeof(Buffer)) == 0;
+    }
+
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        PlatformCloseFile(FileHandle);
+    }
+
+    unlink(Path);
+
+    if (!Status)
+    {
+        printf("err, written file\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Show the summaries of the images (the same lines as '.pe batch')
+ *
+ */
+static int
+BenchShowImages(int Count, char ** Paths, BOOLEAN IsCsv)
+{
+    static PE_ANALYSIS_SECTION Sections[PE_ANALYSIS_MAXIMUM_SECTIONS];
+    PE_ANALYSIS_IMAGE          Summary;
+    CHAR *                     Line;
+    UINT32                     LineSize;
+    SIZE_T                     Size;
+    HANDLE                     FileHandle;
+
+    if (IsCsv)
+    {
+        CHAR Header[512];
+
+        PeAnalysisFormatCsvHeader(Header, sizeof(Header));
+        printf("%s", Header);
+    }
+
+    for (int i = 0; i < Count; i++)
+    {
+        const UINT8 * File = BenchMapFile(Paths[i], &Size, &FileHandle);
+
+        if (File != NULL)
+        {
+            PeAnalysisAnalyzeImage(File, Size, &Summary, Sections);
+        }
+        else
+        {
+            memset(&Summary, 0, sizeof(Summary));
+            Summary.Status = PE_ANALYSIS_STATUS_UNABLE_TO_OPEN;
+        }
+
+        LineSize = PE_ANALYSIS_MAXIMUM_SUMMARY_SIZE + (UINT32)strlen(Paths[i]) * 6;
+        Line     = (CHAR *)malloc(LineSize);
+
+        if (Line != NULL)
+        {
+            if (IsCsv ? PeAnalysisFormatCsv(Paths[i], &Summary, Sections, Line, LineSize)
+                      : PeAnalysisFormatJson(Paths[i], &Summary, Sections, Line, LineSize))
+            {
+                printf("%s", Line);
+            }
+
+            free(Line);
+        }
+
+        PlatformUnmapFile((VOID *)File, Size, FileHandle);
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char ** argv)
+{
+    if (argc > 2 && strcmp(argv[1], "--csv") == 0)
+    {
+        return BenchShowImages(argc - 2, argv + 2, TRUE);
+    }
+
+    if (argc > 1)
+    {
+        return BenchShowImages(argc - 1, argv + 1, FALSE);
+    }
+
+    if (!BenchTestKernels() || !BenchTestImages() || !BenchTestMappedImages() || !BenchTestWrittenFiles() ||
+        !BenchTestFormat())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("PE analysis tests passed\n");
+
+    return 0;
+}
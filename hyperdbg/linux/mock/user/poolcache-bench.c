@@ -0,0 +1,772 @@
+/**
+ * @file poolcache-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the free lists of the pre-allocated pools
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_CORES           8
+#define BENCH_INTENTIONS      4
+#define BENCH_BLOCKS          1024
+#define BENCH_TEST_OPERATIONS 1000000
+#define BENCH_STRESS_ROUNDS   500000
+#define BENCH_OPERATIONS      2000000
+#define BENCH_MAXIMUM_THREADS 8
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A pre-allocated block (the fields of the pool table that are used)
+ *
+ */
+typedef struct _BENCH_BLOCK
+{
+    struct _BENCH_BLOCK * Next; // the previous list of all of the pools
+    POOL_CACHE_ENTRY      CacheEntry;
+
+    UINT32          Intention;
+    SIZE_T          Size;
+    volatile UINT32 IsBusy;
+    BOOLEAN         IsFree; // reference state of the test
+
+} BENCH_BLOCK, *PBENCH_BLOCK;
+
+/**
+ * @brief State of a thread of the stress test and the benchmark
+ *
+ */
+typedef struct _BENCH_THREAD
+{
+    pthread_t Thread;
+    UINT32    CoreId;
+    UINT32    Operations;
+    BOOLEAN   UseCache;
+    UINT64    Taken;
+    UINT64    Errors;
+
+} BENCH_THREAD, *PBENCH_THREAD;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static PPOOL_CACHE     g_Cache;
+static BENCH_BLOCK     g_Blocks[BENCH_BLOCKS];
+static PBENCH_BLOCK    g_List;
+static volatile UINT32 g_ListLock;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static PPOOL_CACHE
+BenchCreateCache(UINT32 NumberOfCores)
+{
+    PVOID Buffer = calloc(1, POOL_CACHE_SIZE(NumberOfCores, BENCH_INTENTIONS));
+
+    if (Buffer == NULL || !PoolCacheInitialize(Buffer, NumberOfCores, BENCH_INTENTIONS))
+    {
+        free(Buffer);
+        return NULL;
+    }
+
+    return (PPOOL_CACHE)Buffer;
+}
+
+static PBENCH_BLOCK
+BenchGetBlock(PPOOL_CACHE_ENTRY Entry)
+{
+    return (PBENCH_BLOCK)((CHAR *)Entry - offsetof(BENCH_BLOCK, CacheEntry));
+}
+
+/**
+ * @brief Check the size classes of a few sizes
+ *
+ */
+static BOOLEAN
+BenchTestSizeClasses(void)
+{
+    static const struct
+    {
+        SIZE_T Size;
+        UINT32 SizeClass;
+    } Tests[] = {{0, 0}, {1, 0}, {64, 0}, {65, 1}, {128, 1}, {129, 2}, {4096, 6}, {0x200000, 15}, {0x10000000, 15}};
+
+    for (UINT32 i = 0; i < sizeof(Tests) / sizeof(Tests[0]); i++)
+    {
+        if (PoolCacheGetSizeClass(Tests[i].Size) != Tests[i].SizeClass)
+        {
+            printf("err, the size class of %llx is %u instead of %u\n",
+                   (unsigned long long)Tests[i].Size,
+                   PoolCacheGetSizeClass(Tests[i].Size),
+                   Tests[i].SizeClass);
+            return FALSE;
+        }
+    }
+
+    printf("classes:    %u size classes from %u bytes\n", POOL_CACHE_SIZE_CLASSES, 1u << POOL_CACHE_MINIMUM_CLASS_SHIFT);
+
+    return TRUE;
+}
+
+/**
+ * @brief Take and insert random blocks from random cores and check them against
+ * the free blocks of the reference
+ *
+ */
+static BOOLEAN
+BenchTestOperations(void)
+{
+    static const SIZE_T Sizes[] = {0x40, 0x100, 0x1000, 0x2000};
+    PPOOL_CACHE         Cache   = BenchCreateCache(BENCH_CORES);
+    BOOLEAN             RefillNeeded;
+
+    if (Cache == NULL)
+    {
+        printf("err, unable to create the cache\n");
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < BENCH_BLOCKS; i++)
+    {
+        g_Blocks[i].Intention = (UINT32)(BenchRandom() % BENCH_INTENTIONS);
+        g_Blocks[i].Size      = Sizes[BenchRandom() % 4];
+        g_Blocks[i].IsFree    = TRUE;
+
+        PoolCacheReserve(Cache, g_Blocks[i].Intention, g_Blocks[i].Size, 1, FALSE);
+        PoolCacheInsert(Cache, &g_Blocks[i].CacheEntry, g_Blocks[i].Intention, g_Blocks[i].Size, TRUE);
+    }
+
+    for (UINT32 i = 0; i < BENCH_TEST_OPERATIONS; i++)
+    {
+        UINT32            Intention = (UINT32)(BenchRandom() % BENCH_INTENTIONS);
+        SIZE_T            Size      = BenchRandom() % 2 == 0 ? 0 : Sizes[BenchRandom() % 4];
+        BOOLEAN           AnyFree   = FALSE;
+        BOOLEAN           LargeFree = FALSE;
+        PPOOL_CACHE_ENTRY Entry;
+        PBENCH_BLOCK      Block;
+
+        if (BenchRandom() % 2 == 0)
+        {
+            //
+            // Free a random busy block
+            //
+            Block = &g_Blocks[BenchRandom() % BENCH_BLOCKS];
+
+            if (!Block->IsFree)
+            {
+                Block->IsFree = TRUE;
+                PoolCacheInsert(Cache, &Block->CacheEntry, Block->Intention, Block->Size, FALSE);
+            }
+
+            continue;
+        }
+
+        for (UINT32 j = 0; j < BENCH_BLOCKS; j++)
+        {
+            if (g_Blocks[j].IsFree && g_Blocks[j].Intention == Intention)
+            {
+                AnyFree = TRUE;
+                LargeFree |= g_Blocks[j].Size >= Size;
+            }
+        }
+
+        Entry = PoolCacheTake(Cache, Intention, Size, (UINT32)(BenchRandom() % BENCH_CORES), BenchRandom() % 2 == 0, &RefillNeeded);
+
+        if ((Entry != NULL) != AnyFree)
+        {
+            printf("err, a free block of intention %u is %s\n", Intention, AnyFree ? "not found" : "found");
+            free(Cache);
+            return FALSE;
+        }
+
+        if (Entry == NULL)
+        {
+            continue;
+        }
+
+        Block = BenchGetBlock(Entry);
+
+        if (!Block->IsFree || Block->Intention != Intention || (LargeFree && Block->Size < Size))
+        {
+            printf("err, the block of %llx bytes (intention %u) is taken for %llx bytes (intention %u)\n",
+                   (unsigned long long)Block->Size,
+                   Block->Intention,
+                   (unsigned long long)Size,
+                   Intention);
+            free(Cache);
+            return FALSE;
+        }
+
+        Block->IsFree = FALSE;
+    }
+
+    //
+    // The counters of the classes should be the same as the free blocks
+    //
+    for (UINT32 Intention = 0; Intention < BENCH_INTENTIONS; Intention++)
+    {
+        for (UINT32 SizeClass = 0; SizeClass < POOL_CACHE_SIZE_CLASSES; SizeClass++)
+        {
+            LONG Free = 0;
+
+            for (UINT32 j = 0; j < BENCH_BLOCKS; j++)
+            {
+                Free += g_Blocks[j].IsFree && g_Blocks[j].Intention == Intention &&
+                        PoolCacheGetSizeClass(g_Blocks[j].Size) == SizeClass;
+            }
+
+            if (PoolCacheGetClass(Cache, Intention, SizeClass)->Available != Free ||
+                PoolCacheGetClass(Cache, Intention, SizeClass)->Pending != 0)
+            {
+                printf("err, intention %u class %u has %ld free blocks instead of %ld\n",
+                       Intention,
+                       SizeClass,
+                       (long)PoolCacheGetClass(Cache, Intention, SizeClass)->Available,
+                       (long)Free);
+                free(Cache);
+                return FALSE;
+            }
+        }
+    }
+
+    printf("operations: %u random takes and inserts are the same as the reference\n", BENCH_TEST_OPERATIONS);
+
+    free(Cache);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the signal of the low watermark, the refill count and the
+ * freed blocks that are used instead of the pending blocks
+ *
+ */
+static BOOLEAN
+BenchTestRefill(void)
+{
+    PPOOL_CACHE       Cache = BenchCreateCache(1);
+    PPOOL_CACHE_CLASS Class;
+    BOOLEAN           RefillNeeded;
+    UINT32            Signals   = 0;
+    SIZE_T            BlockSize = 0;
+    UINT32            Count;
+
+    if (Cache == NULL)
+    {
+        printf("err, unable to create the cache\n");
+        return FALSE;
+    }
+
+    Class = PoolCacheGetClass(Cache, 1, PoolCacheGetSizeClass(0x100));
+
+    PoolCacheReserve(Cache, 1, 0x100, 8, FALSE);
+
+    for (UINT32 i = 0; i < 8; i++)
+    {
+        PoolCacheInsert(Cache, &g_Blocks[i].CacheEntry, 1, 0x100, TRUE);
+    }
+
+    //
+    // The refill is signaled once when 2 of 8 blocks are free
+    //
+    for (UINT32 i = 0; i < 8; i++)
+    {
+        if (PoolCacheTake(Cache, 1, 0, 0, TRUE, &RefillNeeded) == NULL)
+        {
+            printf("err, the block %u is not taken\n", i);
+            free(Cache);
+            return FALSE;
+        }
+
+        if (RefillNeeded && (Signals++ != 0 || i != 5))
+        {
+            printf("err, the refill is signaled after %u blocks\n", i + 1);
+            free(Cache);
+            return FALSE;
+        }
+    }
+
+    if (Signals != 1 || PoolCacheTake(Cache, 1, 0, 0, TRUE, &RefillNeeded) != NULL || RefillNeeded ||
+        Class->Statistics.Failures != 1)
+    {
+        printf("err, the refill is signaled %u times\n", Signals);
+        free(Cache);
+        return FALSE;
+    }
+
+    Count = PoolCacheGetRefillCount(Cache, 1, PoolCacheGetSizeClass(0x100), &BlockSize);
+
+    if (Count != 8 || BlockSize != 0x100 || PoolCacheGetRefillCount(Cache, 1, PoolCacheGetSizeClass(0x100), &BlockSize) != 0)
+    {
+        printf("err, the refill count is %u\n", Count);
+        free(Cache);
+        return FALSE;
+    }
+
+    //
+    // A replacement is requested, then a freed block is used instead of it
+    //
+    PoolCacheReserve(Cache, 1, 0x100, 1, TRUE);
+
+    g_Blocks[0].CacheEntry.Size = 0x80;
+
+    if (PoolCacheClaimPending(Cache, &g_Blocks[0].CacheEntry))
+    {
+        printf("err, a smaller block is used instead of a pending block\n");
+        free(Cache);
+        return FALSE;
+    }
+
+    g_Blocks[0].CacheEntry.Size = 0x100;
+
+    if (!PoolCacheClaimPending(Cache, &g_Blocks[0].CacheEntry) || PoolCacheClaimPending(Cache, &g_Blocks[1].CacheEntry))
+    {
+        printf("err, the freed blocks are not used instead of the pending block\n");
+        free(Cache);
+        return FALSE;
+    }
+
+    PoolCacheInsert(Cache, &g_Blocks[0].CacheEntry, 1, 0x100, TRUE);
+
+    if (PoolCacheConsumeCancelled(Cache, 1, 0x100, 1) != 1 || Class->Pending != 0 || Class->Cancelled != 0 ||
+        Class->Available != 1 || Class->Target != 8 || Class->Statistics.Recycled != 1)
+    {
+        printf("err, the counters of the class are not expected after recycling a block\n");
+        free(Cache);
+        return FALSE;
+    }
+
+    printf("refill:     signaled once at %u%% and %u blocks are refilled\n", POOL_CACHE_LOW_WATERMARK, Count);
+
+    free(Cache);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check that the reservations are released by the blocks that are taken
+ * without a replacement and by the removed blocks, so the refills don't keep
+ * the blocks that are already used
+ *
+ */
+static BOOLEAN
+BenchTestReservations(void)
+{
+    PPOOL_CACHE       Cache = BenchCreateCache(2);
+    PPOOL_CACHE_CLASS Class;
+    PPOOL_CACHE_ENTRY Taken = NULL;
+    BOOLEAN           RefillNeeded;
+    SIZE_T            BlockSize = 0;
+    UINT32            Removed   = 0;
+
+    if (Cache == NULL)
+    {
+        printf("err, unable to create the cache\n");
+        return FALSE;
+    }
+
+    Class = PoolCacheGetClass(Cache, 2, PoolCacheGetSizeClass(0x200));
+
+    //
+    // The blocks are reserved and used many times (e.g., by the events of a session)
+    //
+    for (UINT32 Round = 0; Round < 100; Round++)
+    {
+        PoolCacheReserve(Cache, 2, 0x200, 4, FALSE);
+
+        for (UINT32 i = 0; i < 4; i++)
+        {
+            PoolCacheInsert(Cache, &g_Blocks[i].CacheEntry, 2, 0x200, TRUE);
+        }
+
+        for (UINT32 i = 0; i < 4; i++)
+        {
+            if (PoolCacheTake(Cache, 2, 0, Round % 2, FALSE, &RefillNeeded) == NULL || RefillNeeded)
+            {
+                printf("err, the reserved block %u of the round %u is not taken or signals a refill\n", i, Round);
+                free(Cache);
+                return FALSE;
+            }
+        }
+    }
+
+    if (Class->Target != 0 || Class->Available != 0 || PoolCacheGetRefillCount(Cache, 2, PoolCacheGetSizeClass(0x200), &BlockSize) != 0)
+    {
+        printf("err, %ld blocks are still reserved after they're used\n", (long)Class->Target);
+        free(Cache);
+        return FALSE;
+    }
+
+    //
+    // The free blocks are removed from the free list and from the caches of
+    // the cores, but not the taken block
+    //
+    PoolCacheReserve(Cache, 2, 0x200, 4, FALSE);
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        PoolCacheInsert(Cache, &g_Blocks[i].CacheEntry, 2, 0x200, TRUE);
+    }
+
+    Taken = PoolCacheTake(Cache, 2, 0x200, 0, TRUE, &RefillNeeded);
+
+    for (UINT32 i = 0; i < 4; i++)
+    {
+        if (PoolCacheRemove(Cache, &g_Blocks[i].CacheEntry))
+        {
+            Removed++;
+        }
+        else if (&g_Blocks[i].CacheEntry != Taken)
+        {
+            printf("err, the free block %u is not removed\n", i);
+            free(Cache);
+            return FALSE;
+        }
+    }
+
+    if (Taken == NULL || Removed != 3 || Class->Available != 0 || Class->Target != 1 ||
+        PoolCacheTake(Cache, 2, 0, 1, TRUE, &RefillNeeded) != NULL)
+    {
+        printf("err, %u blocks are removed and %ld blocks are still free\n", Removed, (long)Class->Available);
+        free(Cache);
+        return FALSE;
+    }
+
+    printf("reserve:    the reservations are released by the used and the removed blocks\n");
+
+    free(Cache);
+
+    return TRUE;
+}
+
+/**
+ * @brief Take a block and give it back from each core, each block should be
+ * owned by a single core at a time
+ *
+ */
+static void *
+BenchStressThread(void * Parameter)
+{
+    PBENCH_THREAD Thread = (PBENCH_THREAD)Parameter;
+    UINT64        State  = (UINT64)(uintptr_t)Parameter | 1;
+    BOOLEAN       RefillNeeded;
+
+    for (UINT32 i = 0; i < Thread->Operations; i++)
+    {
+        PPOOL_CACHE_ENTRY Entry;
+        PBENCH_BLOCK      Block;
+        UINT32            Intention;
+
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Intention = (UINT32)(State % BENCH_INTENTIONS);
+        Entry     = PoolCacheTake(g_Cache, Intention, 0, Thread->CoreId, FALSE, &RefillNeeded);
+
+        if (Entry == NULL)
+        {
+            continue;
+        }
+
+        Block = BenchGetBlock(Entry);
+
+        if (__atomic_exchange_n(&Block->IsBusy, 1, __ATOMIC_ACQ_REL) != 0 || Block->Intention != Intention)
+        {
+            Thread->Errors++;
+        }
+
+        Thread->Taken++;
+
+        __atomic_store_n(&Block->IsBusy, 0, __ATOMIC_RELEASE);
+
+        PoolCacheInsert(g_Cache, Entry, Block->Intention, Block->Size, FALSE);
+    }
+
+    return NULL;
+}
+
+static BOOLEAN
+BenchTestConcurrent(void)
+{
+    BENCH_THREAD Threads[BENCH_CORES] = {0};
+    UINT64       Taken                = 0;
+    UINT64       Errors               = 0;
+    UINT32       Found                = 0;
+    BOOLEAN      RefillNeeded;
+
+    g_Cache = BenchCreateCache(BENCH_CORES);
+
+    if (g_Cache == NULL)
+    {
+        printf("err, unable to create the cache\n");
+        return FALSE;
+    }
+
+    //
+    // A few blocks for each intention, so the cores compete for them
+    //
+    for (UINT32 i = 0; i < 64; i++)
+    {
+        g_Blocks[i].Intention = i % BENCH_INTENTIONS;
+        g_Blocks[i].Size      = (SIZE_T)0x40 << (i % 3);
+        g_Blocks[i].IsBusy    = 0;
+        g_Blocks[i].IsFree    = FALSE;
+
+        PoolCacheInsert(g_Cache, &g_Blocks[i].CacheEntry, g_Blocks[i].Intention, g_Blocks[i].Size, FALSE);
+    }
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        Threads[i].CoreId     = i;
+        Threads[i].Operations = BENCH_STRESS_ROUNDS;
+
+        pthread_create(&Threads[i].Thread, NULL, BenchStressThread, &Threads[i]);
+    }
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        pthread_join(Threads[i].Thread, NULL);
+
+        Taken += Threads[i].Taken;
+        Errors += Threads[i].Errors;
+    }
+
+    //
+    // All of the blocks should be free, and each of them only once
+    //
+    for (UINT32 Intention = 0; Intention < BENCH_INTENTIONS; Intention++)
+    {
+        PPOOL_CACHE_ENTRY Entry;
+
+        while ((Entry = PoolCacheTake(g_Cache, Intention, 0, 0, FALSE, &RefillNeeded)) != NULL)
+        {
+            PBENCH_BLOCK Block = BenchGetBlock(Entry);
+
+            if (Block->IsFree || Block->Intention != Intention)
+            {
+                Errors++;
+            }
+
+            Block->IsFree = TRUE;
+            Found++;
+        }
+    }
+
+    free(g_Cache);
+
+    if (Errors != 0 || Found != 64)
+    {
+        printf("err, %llu blocks are owned by two cores and %u of 64 blocks are found\n",
+               (unsigned long long)Errors,
+               Found);
+        return FALSE;
+    }
+
+    printf("concurrent: %u cores took %llu blocks of 64 blocks without any conflict\n",
+           BENCH_CORES,
+           (unsigned long long)Taken);
+
+    return TRUE;
+}
+
+/**
+ * @brief Take a block by walking the list of all of the pools under a lock (previous requests)
+ *
+ */
+static PBENCH_BLOCK
+BenchTakeLinear(UINT32 Intention)
+{
+    PBENCH_BLOCK Found = NULL;
+
+    while (__atomic_exchange_n(&g_ListLock, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        while (__atomic_load_n(&g_ListLock, __ATOMIC_RELAXED) != 0)
+            ;
+    }
+
+    for (PBENCH_BLOCK Block = g_List; Block != NULL; Block = Block->Next)
+    {
+        if (Block->Intention == Intention && !__atomic_load_n(&Block->IsBusy, __ATOMIC_RELAXED))
+        {
+            Block->IsBusy = 1;
+            Found         = Block;
+            break;
+        }
+    }
+
+    __atomic_store_n(&g_ListLock, 0, __ATOMIC_RELEASE);
+
+    return Found;
+}
+
+static void *
+BenchMeasureThread(void * Parameter)
+{
+    PBENCH_THREAD Thread = (PBENCH_THREAD)Parameter;
+    UINT64        State  = (UINT64)(uintptr_t)Parameter | 1;
+    BOOLEAN       RefillNeeded;
+
+    for (UINT32 i = 0; i < Thread->Operations; i++)
+    {
+        UINT32 Intention;
+
+        State ^= State << 13;
+        State ^= State >> 7;
+        State ^= State << 17;
+
+        Intention = (UINT32)(State % BENCH_INTENTIONS);
+
+        if (Thread->UseCache)
+        {
+            PPOOL_CACHE_ENTRY Entry = PoolCacheTake(g_Cache, Intention, 0, Thread->CoreId, FALSE, &RefillNeeded);
+
+            if (Entry != NULL)
+            {
+                Thread->Taken++;
+                PoolCacheInsert(g_Cache, Entry, Intention, Entry->Size, FALSE);
+            }
+        }
+        else
+        {
+            PBENCH_BLOCK Block = BenchTakeLinear(Intention);
+
+            if (Block != NULL)
+            {
+                Thread->Taken++;
+                __atomic_store_n(&Block->IsBusy, 0, __ATOMIC_RELEASE);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static double
+BenchRun(UINT32 NumberOfThreads, BOOLEAN UseCache, UINT64 * Taken)
+{
+    BENCH_THREAD Threads[BENCH_MAXIMUM_THREADS] = {0};
+    double       Start                          = BenchNow();
+
+    for (UINT32 i = 0; i < NumberOfThreads; i++)
+    {
+        Threads[i].CoreId     = i;
+        Threads[i].UseCache   = UseCache;
+        Threads[i].Operations = BENCH_OPERATIONS / NumberOfThreads;
+
+        pthread_create(&Threads[i].Thread, NULL, BenchMeasureThread, &Threads[i]);
+    }
+
+    *Taken = 0;
+
+    for (UINT32 i = 0; i < NumberOfThreads; i++)
+    {
+        pthread_join(Threads[i].Thread, NULL);
+        *Taken += Threads[i].Taken;
+    }
+
+    return BenchNow() - Start;
+}
+
+/**
+ * @brief Measure the requests of the pools for a number of pools and cores
+ *
+ */
+static BOOLEAN
+BenchMeasure(UINT32 NumberOfPools, UINT32 NumberOfThreads)
+{
+    UINT64 LinearTaken;
+    UINT64 CachedTaken;
+    double LinearTime;
+    double CachedTime;
+
+    g_Cache = BenchCreateCache(NumberOfThreads);
+    g_List  = NULL;
+
+    if (g_Cache == NULL)
+    {
+        printf("err, unable to create the cache\n");
+        return FALSE;
+    }
+
+    //
+    // Most of the pools are of other intentions (e.g., the event buffers) and
+    // they are added after the requested pools, so they are at the head of the list
+    //
+    for (UINT32 i = 0; i < NumberOfPools; i++)
+    {
+        g_Blocks[i].Intention = i < 4 * BENCH_INTENTIONS ? i % BENCH_INTENTIONS : BENCH_INTENTIONS;
+        g_Blocks[i].Size      = 0x100;
+        g_Blocks[i].IsBusy    = 0;
+        g_Blocks[i].Next      = g_List;
+        g_List                = &g_Blocks[i];
+
+        if (g_Blocks[i].Intention < BENCH_INTENTIONS)
+        {
+            PoolCacheInsert(g_Cache, &g_Blocks[i].CacheEntry, g_Blocks[i].Intention, g_Blocks[i].Size, FALSE);
+        }
+    }
+
+    LinearTime = BenchRun(NumberOfThreads, FALSE, &LinearTaken);
+    CachedTime = BenchRun(NumberOfThreads, TRUE, &CachedTaken);
+
+    free(g_Cache);
+
+    //
+    // With more cores, a request might not find a free block while the others
+    // are moving the blocks
+    //
+    if (NumberOfThreads == 1 && CachedTaken != BENCH_OPERATIONS)
+    {
+        printf("err, only %llu requests are taken from the free lists\n", (unsigned long long)CachedTaken);
+        return FALSE;
+    }
+
+    printf("%4u pools, %u cores: free lists: %8.2f M requests/s, list of pools: %8.2f M requests/s\n",
+           NumberOfPools,
+           NumberOfThreads,
+           BENCH_OPERATIONS / CachedTime / 1e6,
+           BENCH_OPERATIONS / LinearTime / 1e6);
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    static const UINT32 Pools[]   = {32, 256, 1024};
+    static const UINT32 Threads[] = {1, 4};
+    BOOLEAN             Passed    = BenchTestSizeClasses() && BenchTestOperations() && BenchTestRefill() && BenchTestReservations() &&
+                                      BenchTestConcurrent();
+
+    for (UINT32 i = 0; i < sizeof(Pools) / sizeof(Pools[0]) && Passed; i++)
+    {
+        for (UINT32 j = 0; j < sizeof(Threads) / sizeof(Threads[0]) && Passed; j++)
+        {
+            Passed = BenchMeasure(Pools[i], Threads[j]);
+        }
+    }
+
+    if (!Passed)
+    {
+        return 1;
+    }
+
+    printf("pool cache tests passed\n");
+
+    return 0;
+}
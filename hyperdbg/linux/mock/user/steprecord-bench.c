@@ -0,0 +1,730 @@
+/**
+ * @file steprecord-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of the records of the batched steps
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_STEPS         200000
+#define BENCH_MEASURE_STEPS 500000
+#define BENCH_CHUNK_SIZE    (8 * 4096)
+#define BENCH_SMALL_CHUNK   1024
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A simulated trace of executed instructions
+ *
+ */
+typedef struct _BENCH_TRACE
+{
+    UINT32             NumberOfSteps;
+    UINT64             InitialRegisters[STEP_RECORD_NUMBER_OF_REGISTERS];
+    BOOLEAN            InitialIs32Bit;
+    UINT64             FinalRip;
+    UINT64 *           Rip;
+    UINT8 *            Length;
+    STEP_RECORD_KIND * Kind;
+    BOOLEAN *          Is32Bit;
+    UINT8 *            Bytes;     // STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH for each step
+    UINT64 *           Registers; // state after each step
+
+} BENCH_TRACE, *PBENCH_TRACE;
+
+/**
+ * @brief The chunks of an encoded trace
+ *
+ */
+typedef struct _BENCH_CHUNKS
+{
+    UINT32   NumberOfChunks;
+    UINT32   TotalSize;
+    UINT8 *  Data;  // all chunks one after another
+    UINT32 * Sizes; // size of each chunk
+
+} BENCH_CHUNKS, *PBENCH_CHUNKS;
+
+/**
+ * @brief The state of checking the decoded records against a trace
+ *
+ */
+typedef struct _BENCH_CHECK
+{
+    const BENCH_TRACE * Trace;
+    UINT32              Flags;
+    UINT32              Index;
+    UINT32              Errors;
+
+} BENCH_CHECK, *PBENCH_CHECK;
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Check the classification of the common instructions
+ *
+ */
+static BOOLEAN
+BenchTestClassify(void)
+{
+    static const struct
+    {
+        UINT8            Bytes[8];
+        UINT32           Length;
+        BOOLEAN          Is32Bit;
+        STEP_RECORD_KIND Expected;
+    } Cases[] = {
+        {{0xe8, 0x10, 0x00, 0x00, 0x00}, 5, FALSE, STEP_RECORD_KIND_CALL},             // call rel32
+        {{0xff, 0x15, 0, 0, 0, 0}, 6, FALSE, STEP_RECORD_KIND_CALL},                   // call [rip+x]
+        {{0x41, 0xff, 0xd3}, 3, FALSE, STEP_RECORD_KIND_CALL},                         // call r11
+        {{0xff, 0x1d, 0, 0, 0, 0}, 6, FALSE, STEP_RECORD_KIND_CALL},                   // call far [rip+x]
+        {{0x9a, 0, 0, 0, 0, 0x08, 0x00}, 7, TRUE, STEP_RECORD_KIND_CALL},              // call far ptr (32-bit)
+        {{0xc3}, 1, FALSE, STEP_RECORD_KIND_RET},                                      // ret
+        {{0xf3, 0xc3}, 2, FALSE, STEP_RECORD_KIND_RET},                                // rep ret
+        {{0xc2, 0x08, 0x00}, 3, TRUE, STEP_RECORD_KIND_RET},                           // ret 8
+        {{0x48, 0xcb}, 2, FALSE, STEP_RECORD_KIND_RET},                                // retfq
+        {{0x74, 0x05}, 2, FALSE, STEP_RECORD_KIND_BRANCH},                             // je
+        {{0x0f, 0x85, 0, 0, 0, 0}, 6, FALSE, STEP_RECORD_KIND_BRANCH},                 // jne rel32
+        {{0xe9, 0, 0, 0, 0}, 5, FALSE, STEP_RECORD_KIND_BRANCH},                       // jmp rel32
+        {{0xff, 0xe0}, 2, FALSE, STEP_RECORD_KIND_BRANCH},                             // jmp rax
+        {{0xe2, 0xfe}, 2, FALSE, STEP_RECORD_KIND_BRANCH},                             // loop
+        {{0x0f, 0x05}, 2, FALSE, STEP_RECORD_KIND_BRANCH},                             // syscall
+        {{0x48, 0x0f, 0x07}, 3, FALSE, STEP_RECORD_KIND_BRANCH},                       // sysretq
+        {{0xcd, 0x2e}, 2, TRUE, STEP_RECORD_KIND_BRANCH},                              // int 2e
+        {{0x48, 0xcf}, 2, FALSE, STEP_RECORD_KIND_BRANCH},                             // iretq
+        {{0x48, 0x89, 0xe5}, 3, FALSE, STEP_RECORD_KIND_NORMAL},                       // mov rbp, rsp
+        {{0xff, 0xc0}, 2, FALSE, STEP_RECORD_KIND_NORMAL},                             // inc eax
+        {{0xff, 0x30}, 2, FALSE, STEP_RECORD_KIND_NORMAL},                             // push [rax]
+        {{0x0f, 0x1f, 0x44, 0x00, 0x00}, 5, FALSE, STEP_RECORD_KIND_NORMAL},           // nop
+        {{0x9a, 0, 0, 0, 0, 0, 0}, 7, FALSE, STEP_RECORD_KIND_NORMAL},                 // invalid on 64-bit
+        {{0x48, 0xe8, 0, 0, 0, 0}, 6, TRUE, STEP_RECORD_KIND_NORMAL},                  // dec eax (32-bit)
+        {{0x66, 0x2e, 0x0f, 0x1f, 0x84, 0, 0, 0}, 8, FALSE, STEP_RECORD_KIND_NORMAL},  // prefixed nop
+        {{0xff}, 1, FALSE, STEP_RECORD_KIND_NORMAL},                                   // truncated
+        {{0x66, 0x66}, 2, FALSE, STEP_RECORD_KIND_NORMAL},                             // prefixes only
+    };
+
+    for (UINT32 i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        STEP_RECORD_KIND Kind = StepRecordClassify(Cases[i].Bytes, Cases[i].Length, Cases[i].Is32Bit);
+
+        if (Kind != Cases[i].Expected)
+        {
+            printf("err, case %u is classified as %u (expected %u)\n", i, Kind, Cases[i].Expected);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static VOID
+BenchFreeTrace(PBENCH_TRACE Trace)
+{
+    free(Trace->Rip);
+    free(Trace->Length);
+    free(Trace->Kind);
+    free(Trace->Is32Bit);
+    free(Trace->Bytes);
+    free(Trace->Registers);
+}
+
+/**
+ * @brief Generate a trace (mostly sequential instructions with a few changed
+ * registers, and some calls, jumps, far jumps, and switches of the mode)
+ *
+ */
+static BOOLEAN
+BenchGenerateTrace(PBENCH_TRACE Trace, UINT32 NumberOfSteps)
+{
+    UINT64   Registers[STEP_RECORD_NUMBER_OF_REGISTERS];
+    UINT64   Rip     = 0xfffff80312345000ull;
+    BOOLEAN  Is32Bit = FALSE;
+    UINT64 * After;
+
+    memset(Trace, 0, sizeof(BENCH_TRACE));
+
+    Trace->NumberOfSteps = NumberOfSteps;
+    Trace->Rip           = (UINT64 *)malloc(NumberOfSteps * sizeof(UINT64));
+    Trace->Length        = (UINT8 *)malloc(NumberOfSteps);
+    Trace->Kind          = (STEP_RECORD_KIND *)malloc(NumberOfSteps * sizeof(STEP_RECORD_KIND));
+    Trace->Is32Bit       = (BOOLEAN *)malloc(NumberOfSteps * sizeof(BOOLEAN));
+    Trace->Bytes         = (UINT8 *)malloc((SIZE_T)NumberOfSteps * STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH);
+    Trace->Registers     = (UINT64 *)malloc((SIZE_T)NumberOfSteps * sizeof(Registers));
+
+    if (Trace->Rip == NULL || Trace->Length == NULL || Trace->Kind == NULL || Trace->Is32Bit == NULL ||
+        Trace->Bytes == NULL || Trace->Registers == NULL)
+    {
+        BenchFreeTrace(Trace);
+        return FALSE;
+    }
+
+    for (UINT32 i = 0; i < STEP_RECORD_NUMBER_OF_REGISTERS; i++)
+    {
+        Registers[i] = BenchRandom();
+    }
+
+    Registers[STEP_RECORD_REGISTER_RFLAGS] = 0x246;
+
+    memcpy(Trace->InitialRegisters, Registers, sizeof(Registers));
+    Trace->InitialIs32Bit = Is32Bit;
+
+    for (UINT32 i = 0; i < NumberOfSteps; i++)
+    {
+        UINT64 Random = BenchRandom();
+        UINT32 Length = 1 + (UINT32)(Random % STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH);
+
+        //
+        // A few instructions are unknown (not read or not disassembled)
+        //
+        if ((Random >> 8) % 500 == 0)
+        {
+            Length = 0;
+        }
+
+        Trace->Rip[i]     = Rip;
+        Trace->Length[i]  = (UINT8)Length;
+        Trace->Kind[i]    = (STEP_RECORD_KIND)((Random >> 16) % 4);
+        Trace->Is32Bit[i] = Is32Bit;
+
+        for (UINT32 j = 0; j < STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH; j++)
+        {
+            Trace->Bytes[(SIZE_T)i * STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH + j] = j < Length ? (UINT8)BenchRandom() : 0;
+        }
+
+        //
+        // Change a few registers (small deltas, and sometimes a whole new value)
+        //
+        for (UINT32 j = (UINT32)((Random >> 24) % 4); j != 0; j--)
+        {
+            UINT32 Index = (UINT32)(BenchRandom() % STEP_RECORD_NUMBER_OF_REGISTERS);
+
+            if (BenchRandom() % 8 == 0)
+            {
+                Registers[Index] = BenchRandom();
+            }
+            else
+            {
+                Registers[Index] += (BenchRandom() % 64) - 32;
+            }
+        }
+
+        if ((Random >> 32) % 3 == 0)
+        {
+            Registers[STEP_RECORD_REGISTER_RFLAGS] ^= 0x8d5;
+        }
+
+        After = &Trace->Registers[(SIZE_T)i * STEP_RECORD_NUMBER_OF_REGISTERS];
+        memcpy(After, Registers, sizeof(Registers));
+
+        //
+        // The next instruction
+        //
+        if (Trace->Kind[i] != STEP_RECORD_KIND_NORMAL && (Random >> 40) % 2 == 0)
+        {
+            Rip += (BenchRandom() % 0x20000) - 0x10000;
+        }
+        else if ((Random >> 40) % 997 == 0)
+        {
+            Rip = BenchRandom();
+        }
+        else
+        {
+            Rip += Length;
+        }
+
+        if ((Random >> 48) % 1000 == 0)
+        {
+            Is32Bit = !Is32Bit;
+        }
+    }
+
+    Trace->FinalRip = Rip;
+
+    return TRUE;
+}
+
+/**
+ * @brief Encode a trace the same way as the debuggee (a full chunk is finished
+ * with the rip of the record that didn't fit, and the record is encoded again)
+ *
+ */
+static BOOLEAN
+BenchEncodeTrace(const BENCH_TRACE * Trace, UINT32 Flags, UINT32 ChunkSize, PBENCH_CHUNKS Chunks)
+{
+    STEP_RECORD_ENCODER Encoder;
+    UINT8 *             Buffer;
+    UINT32              Capacity = 64;
+    UINT32              Size;
+    UINT32              Allocated;
+
+    Buffer                 = (UINT8 *)malloc(ChunkSize);
+    Chunks->Sizes          = (UINT32 *)malloc(Capacity * sizeof(UINT32));
+    Chunks->Data           = (UINT8 *)malloc((SIZE_T)Capacity * ChunkSize);
+    Allocated              = Capacity;
+    Chunks->TotalSize      = 0;
+    Chunks->NumberOfChunks = 0;
+
+    if (Buffer == NULL || Chunks->Sizes == NULL || Chunks->Data == NULL)
+    {
+        free(Buffer);
+        return FALSE;
+    }
+
+    StepRecordEncoderInitialize(&Encoder, Buffer, ChunkSize, Flags, Trace->InitialIs32Bit, Trace->InitialRegisters);
+
+    for (UINT32 i = 0; i <= Trace->NumberOfSteps; i++)
+    {
+        BOOLEAN IsLast = i == Trace->NumberOfSteps;
+
+        if (!IsLast && StepRecordEncode(&Encoder,
+                                        Trace->Rip[i],
+                                        &Trace->Bytes[(SIZE_T)i * STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH],
+                                        Trace->Length[i],
+                                        Trace->Kind[i],
+                                        Trace->Is32Bit[i],
+                                        &Trace->Registers[(SIZE_T)i * STEP_RECORD_NUMBER_OF_REGISTERS]))
+        {
+            continue;
+        }
+
+        Size = StepRecordEncoderFinish(&Encoder, IsLast ? Trace->FinalRip : Trace->Rip[i], IsLast);
+
+        if (Chunks->NumberOfChunks == Allocated)
+        {
+            Allocated *= 2;
+            Chunks->Sizes = (UINT32 *)realloc(Chunks->Sizes, Allocated * sizeof(UINT32));
+            Chunks->Data  = (UINT8 *)realloc(Chunks->Data, (SIZE_T)Allocated * ChunkSize);
+
+            if (Chunks->Sizes == NULL || Chunks->Data == NULL)
+            {
+                free(Buffer);
+                return FALSE;
+            }
+        }
+
+        memcpy(Chunks->Data + Chunks->TotalSize, Buffer, Size);
+        Chunks->Sizes[Chunks->NumberOfChunks++] = Size;
+        Chunks->TotalSize += Size;
+
+        if (IsLast)
+        {
+            break;
+        }
+
+        StepRecordEncoderNextChunk(&Encoder);
+
+        if (!StepRecordEncode(&Encoder,
+                              Trace->Rip[i],
+                              &Trace->Bytes[(SIZE_T)i * STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH],
+                              Trace->Length[i],
+                              Trace->Kind[i],
+                              Trace->Is32Bit[i],
+                              &Trace->Registers[(SIZE_T)i * STEP_RECORD_NUMBER_OF_REGISTERS]))
+        {
+            printf("err, a record doesn't fit in an empty chunk\n");
+            free(Buffer);
+            return FALSE;
+        }
+    }
+
+    free(Buffer);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check a decoded record against the trace
+ *
+ */
+static BOOLEAN
+BenchCheckRecord(PVOID Context, const STEP_RECORD * Record)
+{
+    PBENCH_CHECK        Check = (PBENCH_CHECK)Context;
+    const BENCH_TRACE * Trace = Check->Trace;
+    UINT32              Index = Check->Index++;
+    const UINT64 *      Registers;
+    UINT64              NextRip;
+
+    if (Index >= Trace->NumberOfSteps)
+    {
+        Check->Errors++;
+        return FALSE;
+    }
+
+    NextRip   = Index + 1 < Trace->NumberOfSteps ? Trace->Rip[Index + 1] : Trace->FinalRip;
+    Registers = &Trace->Registers[(SIZE_T)Index * STEP_RECORD_NUMBER_OF_REGISTERS];
+
+    if (Record->Rip != Trace->Rip[Index] || Record->NextRip != NextRip || Record->Length != Trace->Length[Index] ||
+        Record->Kind != Trace->Kind[Index] || Record->Is32Bit != Trace->Is32Bit[Index])
+    {
+        Check->Errors++;
+    }
+
+    if ((Check->Flags & STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES) &&
+        memcmp(Record->InstructionBytes, &Trace->Bytes[(SIZE_T)Index * STEP_RECORD_MAXIMUM_INSTRUCTION_LENGTH], Record->Length) != 0)
+    {
+        Check->Errors++;
+    }
+
+    for (UINT32 i = 0; i < STEP_RECORD_NUMBER_OF_REGISTERS; i++)
+    {
+        //
+        // The registers that are not tracked keep their state before the batch
+        //
+        UINT64 Expected = (Check->Flags & STEP_RECORD_CHUNK_FLAG_REGISTERS) || i == STEP_RECORD_REGISTER_RFLAGS ? Registers[i] : Trace->InitialRegisters[i];
+
+        if (Record->Registers[i] != Expected)
+        {
+            Check->Errors++;
+            break;
+        }
+    }
+
+    return Check->Errors == 0;
+}
+
+/**
+ * @brief Decode all chunks and check them against the trace
+ *
+ */
+static BOOLEAN
+BenchDecodeAndCheck(const BENCH_TRACE * Trace, UINT32 Flags, const BENCH_CHUNKS * Chunks)
+{
+    BENCH_CHECK   Check  = {0};
+    const UINT8 * Cursor = Chunks->Data;
+
+    Check.Trace = Trace;
+    Check.Flags = Flags;
+
+    for (UINT32 i = 0; i < Chunks->NumberOfChunks; i++)
+    {
+        STEP_RECORD_CHUNK_HEADER Header;
+
+        memcpy(&Header, Cursor, sizeof(Header));
+
+        if (Header.Sequence != i || ((Header.Flags & STEP_RECORD_CHUNK_FLAG_LAST_CHUNK) != 0) != (i == Chunks->NumberOfChunks - 1))
+        {
+            printf("err, invalid sequence or flags of chunk %u\n", i);
+            return FALSE;
+        }
+
+        if (!StepRecordDecodeChunk(Cursor, Chunks->Sizes[i], BenchCheckRecord, &Check))
+        {
+            printf("err, chunk %u is not decoded (record %u, %u errors)\n", i, Check.Index, Check.Errors);
+            return FALSE;
+        }
+
+        Cursor += Chunks->Sizes[i];
+    }
+
+    if (Check.Index != Trace->NumberOfSteps || Check.Errors != 0)
+    {
+        printf("err, %u of %u records are decoded (%u errors)\n", Check.Index, Trace->NumberOfSteps, Check.Errors);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Encode and decode a trace with all combinations of the flags and
+ * with both sizes of the chunks
+ *
+ */
+static BOOLEAN
+BenchTestRoundTrips(const BENCH_TRACE * Trace)
+{
+    static const UINT32 ChunkSizes[] = {BENCH_CHUNK_SIZE, BENCH_SMALL_CHUNK};
+
+    for (UINT32 Flags = 0; Flags < 4; Flags++)
+    {
+        for (UINT32 j = 0; j < 2; j++)
+        {
+            BENCH_CHUNKS Chunks = {0};
+            BOOLEAN      Result;
+
+            Result = BenchEncodeTrace(Trace, Flags, ChunkSizes[j], &Chunks) && BenchDecodeAndCheck(Trace, Flags, &Chunks);
+
+            if (Result && j == 0)
+            {
+                printf("flags %u: %u chunks, %.2f bytes per record\n",
+                       Flags,
+                       Chunks.NumberOfChunks,
+                       (double)Chunks.TotalSize / Trace->NumberOfSteps);
+            }
+
+            free(Chunks.Data);
+            free(Chunks.Sizes);
+
+            if (!Result)
+            {
+                printf("err, round trip with flags %u and chunks of %u bytes failed\n", Flags, ChunkSizes[j]);
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchCountRecord(PVOID Context, const STEP_RECORD * Record)
+{
+    (void)Record;
+
+    (*(UINT32 *)Context)++;
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchStopRecord(PVOID Context, const STEP_RECORD * Record)
+{
+    (void)Record;
+
+    (*(UINT32 *)Context)++;
+
+    return FALSE;
+}
+
+/**
+ * @brief Build a chunk with the given records (without an encoder)
+ *
+ */
+static UINT32
+BenchBuildChunk(UINT8 * Chunk, UINT32 Flags, UINT32 NumberOfRecords, const UINT8 * Records, UINT32 RecordsSize)
+{
+    STEP_RECORD_CHUNK_HEADER Header;
+
+    memset(&Header, 0, sizeof(Header));
+
+    Header.Flags           = Flags;
+    Header.NumberOfRecords = NumberOfRecords;
+    Header.RecordsSize     = RecordsSize;
+    Header.StartRip        = 0x1000;
+    Header.NextRip         = 0x2000;
+
+    memcpy(Chunk, &Header, sizeof(Header));
+    memcpy(Chunk + sizeof(Header), Records, RecordsSize);
+
+    return sizeof(Header) + RecordsSize;
+}
+
+/**
+ * @brief Check that the malformed chunks are rejected
+ *
+ */
+static BOOLEAN
+BenchTestMalformed(const BENCH_TRACE * Trace)
+{
+    static const UINT8 ReservedExtension[] = {0x80 | 1, 0x04};
+    static const UINT8 UntrackedRegister[] = {0x80 | 1, STEP_RECORD_EXTENSION_REGISTERS, 0x01, 0x02};
+    static const UINT8 EmptyMask[]         = {0x80 | 1, STEP_RECORD_EXTENSION_REGISTERS, 0x00};
+    static const UINT8 TruncatedRip[]      = {0x40 | 1, 0x80, 0x80};
+    static const UINT8 TruncatedBytes[]    = {3, 0x90, 0x90};
+    static const UINT8 TwoRecords[]        = {1, 0x40 | 2, 0x11};
+    UINT8              Chunk[sizeof(STEP_RECORD_CHUNK_HEADER) + 64];
+    BENCH_CHUNKS       Chunks = {0};
+    UINT32             Size;
+    UINT32             Count  = 0;
+    BENCH_TRACE        Small  = *Trace;
+    BOOLEAN            Result = TRUE;
+
+    Size = BenchBuildChunk(Chunk, 0, 1, ReservedExtension, sizeof(ReservedExtension));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, 0, 1, UntrackedRegister, sizeof(UntrackedRegister));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, STEP_RECORD_CHUNK_FLAG_REGISTERS, 1, EmptyMask, sizeof(EmptyMask));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, 0, 1, TruncatedRip, sizeof(TruncatedRip));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES, 1, TruncatedBytes, sizeof(TruncatedBytes));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    //
+    // More records than the declared number, fewer records, a larger size than
+    // the chunk, and a chunk smaller than the header
+    //
+    Size = BenchBuildChunk(Chunk, 0, 1, TwoRecords, sizeof(TwoRecords));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, 0, 3, TwoRecords, sizeof(TwoRecords));
+    Result &= !StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count);
+
+    Size = BenchBuildChunk(Chunk, 0, 2, TwoRecords, sizeof(TwoRecords));
+    Result &= !StepRecordDecodeChunk(Chunk, Size - 1, BenchCountRecord, &Count);
+    Result &= !StepRecordDecodeChunk(Chunk, sizeof(STEP_RECORD_CHUNK_HEADER) - 1, BenchCountRecord, &Count);
+
+    if (!Result)
+    {
+        printf("err, a malformed chunk is decoded\n");
+        return FALSE;
+    }
+
+    //
+    // A valid chunk (the second record jumps back, and the last one gets the
+    // next rip of the header), and a callback that stops decoding
+    //
+    Count = 0;
+
+    if (!StepRecordDecodeChunk(Chunk, Size, BenchCountRecord, &Count) || Count != 2)
+    {
+        printf("err, a valid chunk is not decoded\n");
+        return FALSE;
+    }
+
+    Count = 0;
+
+    if (StepRecordDecodeChunk(Chunk, Size, BenchStopRecord, &Count) || Count != 1)
+    {
+        printf("err, the callback didn't stop decoding\n");
+        return FALSE;
+    }
+
+    Count = 0;
+    Size  = BenchBuildChunk(Chunk, 0, 0, TwoRecords, 0);
+
+    if (!StepRecordDecodeChunk(Chunk, Size, BenchStopRecord, &Count) || Count != 0)
+    {
+        printf("err, an empty chunk is not decoded\n");
+        return FALSE;
+    }
+
+    //
+    // Truncating any chunk of a trace by a single byte is rejected
+    //
+    Small.NumberOfSteps = 5000;
+
+    if (!BenchEncodeTrace(&Small, STEP_RECORD_CHUNK_FLAG_REGISTERS | STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES, BENCH_SMALL_CHUNK, &Chunks))
+    {
+        return FALSE;
+    }
+
+    for (UINT32 i = 0, Offset = 0; i < Chunks.NumberOfChunks; Offset += Chunks.Sizes[i], i++)
+    {
+        STEP_RECORD_CHUNK_HEADER Header;
+        UINT8 *                  Current = Chunks.Data + Offset;
+
+        if (Chunks.Sizes[i] == sizeof(Header))
+        {
+            continue;
+        }
+
+        memcpy(&Header, Current, sizeof(Header));
+        Header.RecordsSize--;
+        memcpy(Current, &Header, sizeof(Header));
+
+        if (StepRecordDecodeChunk(Current, Chunks.Sizes[i] - 1, BenchCountRecord, &Count))
+        {
+            printf("err, truncated chunk %u is decoded\n", i);
+            Result = FALSE;
+            break;
+        }
+    }
+
+    free(Chunks.Data);
+    free(Chunks.Sizes);
+
+    return Result;
+}
+
+/**
+ * @brief Measure encoding and decoding of the records
+ *
+ */
+static VOID
+BenchMeasure(const BENCH_TRACE * Trace)
+{
+    UINT32 Flags = STEP_RECORD_CHUNK_FLAG_REGISTERS | STEP_RECORD_CHUNK_FLAG_INSTRUCTION_BYTES;
+    double Start;
+    double Encoding;
+    double Decoding;
+    UINT32 Count = 0;
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        BENCH_CHUNKS  Chunks = {0};
+        const UINT8 * Cursor;
+
+        Start = BenchNow();
+
+        if (!BenchEncodeTrace(Trace, Flags, BENCH_CHUNK_SIZE, &Chunks))
+        {
+            return;
+        }
+
+        Encoding = BenchNow() - Start;
+        Cursor   = Chunks.Data;
+        Start    = BenchNow();
+
+        for (UINT32 j = 0; j < Chunks.NumberOfChunks; j++)
+        {
+            StepRecordDecodeChunk(Cursor, Chunks.Sizes[j], BenchCountRecord, &Count);
+            Cursor += Chunks.Sizes[j];
+        }
+
+        Decoding = BenchNow() - Start;
+
+        printf("%s: encoding %.2f ns, decoding %.2f ns per record, %.2f bytes per record "
+               "(%u records in a chunk of %u bytes)\n",
+               i == 0 ? "registers and bytes" : "tracking",
+               Encoding * 1e9 / Trace->NumberOfSteps,
+               Decoding * 1e9 / Trace->NumberOfSteps,
+               (double)Chunks.TotalSize / Trace->NumberOfSteps,
+               Trace->NumberOfSteps / Chunks.NumberOfChunks,
+               BENCH_CHUNK_SIZE);
+
+        free(Chunks.Data);
+        free(Chunks.Sizes);
+
+        Flags = 0;
+    }
+}
+
+int
+main(void)
+{
+    BENCH_TRACE Trace;
+    BOOLEAN     Result;
+
+    if (!BenchGenerateTrace(&Trace, BENCH_STEPS))
+    {
+        return 1;
+    }
+
+    Result = BenchTestClassify() && BenchTestRoundTrips(&Trace) && BenchTestMalformed(&Trace);
+
+    BenchFreeTrace(&Trace);
+
+    if (!Result)
+    {
+        return 1;
+    }
+
+    if (BenchGenerateTrace(&Trace, BENCH_MEASURE_STEPS))
+    {
+        BenchMeasure(&Trace);
+        BenchFreeTrace(&Trace);
+    }
+
+    printf("step record tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,560 @@
+/**
+ * @file taskbroadcast-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of broadcasting the tasks to the halted cores
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+#include <pthread.h>
+#include <sched.h>
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_CORES        8 // the halted cores (the main core is not counted)
+#define BENCH_TASK_TYPES   4
+#define BENCH_STRESS_ROUNDS 20000
+#define BENCH_ROUNDS       2000
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief A simulated core (like the state of the debugger on the core)
+ *
+ */
+typedef struct _BENCH_CORE
+{
+    pthread_t     Thread;
+    volatile LONG Lock;
+    UINT64        BroadcastSequence;
+    UINT64        Performed[BENCH_TASK_TYPES + 1]; // sum of the contexts of each task
+    UINT64        PerformedTasks;
+
+} BENCH_CORE, *PBENCH_CORE;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+static TASK_BROADCAST g_Broadcast;
+static BENCH_CORE     g_Cores[BENCH_CORES];
+static BENCH_CORE     g_MainCore;
+static volatile LONG  g_Exit;
+static UINT64         g_Contexts[2][TASK_BROADCAST_MAXIMUM_TASKS]; // the contexts of the current and the previous rounds
+static UINT64         g_Handoffs;                                  // count of the times that the main core waits for others
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static void
+BenchPause(void)
+{
+    //
+    // The simulated cores might be more than the processors
+    //
+    sched_yield();
+}
+
+static void
+BenchLock(volatile LONG * Lock)
+{
+    LONG Expected = 0;
+
+    while (!__atomic_compare_exchange_n(Lock, &Expected, 1, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        Expected = 0;
+        BenchPause();
+    }
+}
+
+static void
+BenchUnlock(volatile LONG * Lock)
+{
+    __atomic_store_n(Lock, 0, __ATOMIC_RELEASE);
+}
+
+static BOOLEAN
+BenchIsLocked(volatile LONG * Lock)
+{
+    return __atomic_load_n(Lock, __ATOMIC_ACQUIRE) != 0;
+}
+
+static void
+BenchPerformTask(PBENCH_CORE Core, PTASK_BROADCAST_TASK Task)
+{
+    Core->Performed[Task->TargetTask] += *(UINT64 *)Task->Context;
+    Core->PerformedTasks++;
+}
+
+/**
+ * @brief The halted loop of a core (like KdManageSystemHaltOnVmxRoot and
+ * HaltedCorePerformBroadcastTasks)
+ *
+ */
+static void *
+BenchHaltedCore(void * Parameter)
+{
+    PBENCH_CORE Core = (PBENCH_CORE)Parameter;
+
+    while (TRUE)
+    {
+        PTASK_BROADCAST_ROUND Round;
+        BOOLEAN               WaitAfterTasks;
+
+        //
+        // Wait until the core is unlocked
+        //
+        BenchLock(&Core->Lock);
+        BenchUnlock(&Core->Lock);
+
+        if (__atomic_load_n(&g_Exit, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        Round = TaskBroadcastTake(&g_Broadcast, &Core->BroadcastSequence);
+
+        if (Round == NULL)
+        {
+            continue;
+        }
+
+        for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+        {
+            BenchPerformTask(Core, &Round->Tasks[i]);
+        }
+
+        WaitAfterTasks = Round->WaitAfterTasks;
+
+        if (WaitAfterTasks)
+        {
+            BenchLock(&Core->Lock);
+        }
+
+        TaskBroadcastComplete(&g_Broadcast);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Broadcast a round to all of the cores (like HaltedCoreBroadcastRoundAllCores)
+ *
+ */
+static void
+BenchBroadcastRound(PTASK_BROADCAST_ROUND Round, BOOLEAN Synchronize)
+{
+    while (!TaskBroadcastPublish(&g_Broadcast, Round, BENCH_CORES, &g_MainCore.BroadcastSequence))
+    {
+        BenchPause();
+    }
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        BenchUnlock(&g_Cores[i].Lock);
+    }
+
+    for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+    {
+        BenchPerformTask(&g_MainCore, &Round->Tasks[i]);
+    }
+
+    if (Synchronize)
+    {
+        g_Handoffs++;
+
+        while (!TaskBroadcastIsCompleted(&g_Broadcast))
+        {
+            BenchPause();
+        }
+    }
+}
+
+/**
+ * @brief Send a round to the cores one after another and wait for each core
+ *
+ */
+static void
+BenchSerialRound(PTASK_BROADCAST_ROUND Round)
+{
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        while (!TaskBroadcastPublish(&g_Broadcast, Round, 1, &g_MainCore.BroadcastSequence))
+        {
+            BenchPause();
+        }
+
+        BenchUnlock(&g_Cores[i].Lock);
+
+        g_Handoffs++;
+
+        while (!TaskBroadcastIsCompleted(&g_Broadcast))
+        {
+            BenchPause();
+        }
+    }
+
+    for (UINT32 i = 0; i < Round->NumberOfTasks; i++)
+    {
+        BenchPerformTask(&g_MainCore, &Round->Tasks[i]);
+    }
+}
+
+/**
+ * @brief Check that all of the cores performed the same tasks as the main core
+ * and they are locked again
+ *
+ */
+static BOOLEAN
+BenchCheckCores(BOOLEAN CheckLocks)
+{
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        if (CheckLocks && !BenchIsLocked(&g_Cores[i].Lock))
+        {
+            printf("err, core %u is not locked again after the round\n", i);
+            return FALSE;
+        }
+
+        if (g_Cores[i].PerformedTasks != g_MainCore.PerformedTasks ||
+            memcmp(g_Cores[i].Performed, g_MainCore.Performed, sizeof(g_MainCore.Performed)) != 0)
+        {
+            printf("err, core %u performed %llu tasks instead of %llu\n",
+                   i,
+                   (unsigned long long)g_Cores[i].PerformedTasks,
+                   (unsigned long long)g_MainCore.PerformedTasks);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Build a round with random tasks
+ *
+ */
+static void
+BenchRandomRound(PTASK_BROADCAST_ROUND Round, UINT32 RoundIndex, UINT32 NumberOfTasks)
+{
+    TaskBroadcastRoundInitialize(Round, TRUE);
+
+    for (UINT32 i = 0; i < NumberOfTasks; i++)
+    {
+        UINT64 * Context = &g_Contexts[RoundIndex % 2][i];
+
+        *Context = BenchRandom() % 1000;
+
+        if (!TaskBroadcastRoundAddTask(Round, 1 + BenchRandom() % BENCH_TASK_TYPES, Context))
+        {
+            printf("err, unable to add a task\n");
+        }
+    }
+}
+
+/**
+ * @brief Broadcast random rounds (some of them are not synchronized) and check the
+ * tasks of the cores
+ *
+ */
+static BOOLEAN
+BenchTestRounds(void)
+{
+    TASK_BROADCAST_ROUND Round;
+    UINT64               Dummy = 0;
+
+    for (UINT32 i = 0; i < BENCH_STRESS_ROUNDS; i++)
+    {
+        BOOLEAN Synchronize = BenchRandom() % 4 != 0;
+
+        BenchRandomRound(&Round, i, 1 + BenchRandom() % TASK_BROADCAST_MAXIMUM_TASKS);
+        BenchBroadcastRound(&Round, Synchronize);
+
+        if (Synchronize && !BenchCheckCores(TRUE))
+        {
+            return FALSE;
+        }
+    }
+
+    //
+    // Wait for the last round
+    //
+    while (!TaskBroadcastIsCompleted(&g_Broadcast))
+    {
+        BenchPause();
+    }
+
+    if (!BenchCheckCores(TRUE))
+    {
+        return FALSE;
+    }
+
+    //
+    // A full round is rejected
+    //
+    TaskBroadcastRoundInitialize(&Round, TRUE);
+
+    for (UINT32 i = 0; i < TASK_BROADCAST_MAXIMUM_TASKS; i++)
+    {
+        TaskBroadcastRoundAddTask(&Round, 1, &Dummy);
+    }
+
+    if (TaskBroadcastRoundAddTask(&Round, 1, &Dummy))
+    {
+        printf("err, a task is added to a full round\n");
+        return FALSE;
+    }
+
+    printf("rounds:     %u random rounds (%llu tasks) are performed by %u cores\n",
+           BENCH_STRESS_ROUNDS,
+           (unsigned long long)g_MainCore.PerformedTasks,
+           BENCH_CORES + 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Check the batches of tasks (like the deferred tasks of an event set) and
+ * broadcast their rounds to the cores
+ *
+ */
+static BOOLEAN
+BenchTestBatches(void)
+{
+    static TASK_BROADCAST_BATCH Batch;
+    TASK_BROADCAST_ROUND        Round;
+    UINT64                      Context[2];
+    UINT64                      Expected[BENCH_TASK_TYPES + 1] = {0};
+    UINT32                      NumberOfRounds                 = 0;
+    UINT32                      NumberOfTasks                  = 0;
+
+    TaskBroadcastBatchInitialize(&Batch);
+
+    //
+    // The same task with the same context is only added once, but another
+    // context is a separate task
+    //
+    Context[0] = 7;
+    Context[1] = 0;
+
+    if (!TaskBroadcastBatchAddTask(&Batch, 1, Context, sizeof(Context)) ||
+        !TaskBroadcastBatchAddTask(&Batch, 1, Context, sizeof(Context)) ||
+        Batch.NumberOfTasks != 1)
+    {
+        printf("err, the same task is added twice to a batch\n");
+        return FALSE;
+    }
+
+    Context[1] = 1;
+
+    if (!TaskBroadcastBatchAddTask(&Batch, 1, Context, sizeof(Context)) ||
+        !TaskBroadcastBatchAddTask(&Batch, 2, Context, sizeof(Context)) ||
+        Batch.NumberOfTasks != 3)
+    {
+        printf("err, a distinct task is not added to a batch\n");
+        return FALSE;
+    }
+
+    //
+    // The contexts are copied into the batch
+    //
+    Context[0] = 0;
+
+    if (Batch.Tasks[0].Context[0] != 7 || Batch.Tasks[2].Context[1] != 1)
+    {
+        printf("err, the context of a task is not copied into the batch\n");
+        return FALSE;
+    }
+
+    if (TaskBroadcastBatchAddTask(&Batch, 1, Context, TASK_BROADCAST_BATCH_MAXIMUM_CONTEXT_SIZE + 1))
+    {
+        printf("err, a task with a large context is added to a batch\n");
+        return FALSE;
+    }
+
+    //
+    // Fill the batch with random tasks (duplicates are expected)
+    //
+    TaskBroadcastBatchInitialize(&Batch);
+
+    while (Batch.NumberOfTasks != TASK_BROADCAST_BATCH_MAXIMUM_TASKS)
+    {
+        UINT64 TargetTask = 1 + BenchRandom() % BENCH_TASK_TYPES;
+        UINT32 Count      = Batch.NumberOfTasks;
+
+        Context[0] = BenchRandom() % 32;
+        Context[1] = 0;
+
+        if (!TaskBroadcastBatchAddTask(&Batch, TargetTask, Context, sizeof(Context)))
+        {
+            printf("err, unable to add a task to a batch\n");
+            return FALSE;
+        }
+
+        if (Batch.NumberOfTasks != Count)
+        {
+            Expected[TargetTask] += Context[0];
+        }
+    }
+
+    Context[0] = 1000;
+
+    if (TaskBroadcastBatchAddTask(&Batch, 1, Context, sizeof(Context)) ||
+        !TaskBroadcastBatchAddTask(&Batch, Batch.Tasks[0].TargetTask, Batch.Tasks[0].Context, sizeof(Context)))
+    {
+        printf("err, a full batch is not handled\n");
+        return FALSE;
+    }
+
+    //
+    // Broadcast the rounds of the batch
+    //
+    for (UINT32 i = 0; i <= BENCH_TASK_TYPES; i++)
+    {
+        Expected[i] += g_MainCore.Performed[i];
+    }
+
+    while (TaskBroadcastBatchNextRound(&Batch, &Round, TRUE))
+    {
+        NumberOfRounds++;
+        NumberOfTasks += Round.NumberOfTasks;
+
+        BenchBroadcastRound(&Round, TRUE);
+    }
+
+    if (NumberOfRounds != TASK_BROADCAST_BATCH_MAXIMUM_TASKS / TASK_BROADCAST_MAXIMUM_TASKS ||
+        NumberOfTasks != TASK_BROADCAST_BATCH_MAXIMUM_TASKS ||
+        memcmp(Expected, g_MainCore.Performed, sizeof(Expected)) != 0)
+    {
+        printf("err, the batch is broadcasted as %u rounds with %u tasks\n", NumberOfRounds, NumberOfTasks);
+        return FALSE;
+    }
+
+    if (!BenchCheckCores(TRUE))
+    {
+        return FALSE;
+    }
+
+    printf("batches:    %u tasks are broadcasted in %u rounds\n", NumberOfTasks, NumberOfRounds);
+
+    return TRUE;
+}
+
+/**
+ * @brief Compare the serial broadcast (and a round for each task) with the
+ * concurrent rounds of batched tasks
+ *
+ */
+static BOOLEAN
+BenchMeasure(void)
+{
+    TASK_BROADCAST_ROUND Round;
+    double               Start, SerialTime, ConcurrentTime, BatchedTime;
+    UINT64               SerialHandoffs, ConcurrentHandoffs, BatchedHandoffs;
+    UINT32               TasksPerEvent = 2; // e.g., exception bitmap and invept
+
+    g_Handoffs = 0;
+    Start      = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_ROUNDS; i++)
+    {
+        for (UINT32 j = 0; j < TasksPerEvent; j++)
+        {
+            BenchRandomRound(&Round, i, 1);
+            BenchSerialRound(&Round);
+        }
+    }
+
+    SerialTime     = BenchNow() - Start;
+    SerialHandoffs = g_Handoffs;
+    g_Handoffs     = 0;
+    Start          = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_ROUNDS; i++)
+    {
+        for (UINT32 j = 0; j < TasksPerEvent; j++)
+        {
+            BenchRandomRound(&Round, i, 1);
+            BenchBroadcastRound(&Round, TRUE);
+        }
+    }
+
+    ConcurrentTime     = BenchNow() - Start;
+    ConcurrentHandoffs = g_Handoffs;
+    g_Handoffs         = 0;
+    Start              = BenchNow();
+
+    for (UINT32 i = 0; i < BENCH_ROUNDS; i++)
+    {
+        BenchRandomRound(&Round, i, TasksPerEvent);
+        BenchBroadcastRound(&Round, TRUE);
+    }
+
+    BatchedTime     = BenchNow() - Start;
+    BatchedHandoffs = g_Handoffs;
+
+    if (!BenchCheckCores(TRUE))
+    {
+        return FALSE;
+    }
+
+    printf("serial:     %8.2f us, %3llu waits for each event (a core at a time, a round for each task)\n",
+           SerialTime * 1e6 / BENCH_ROUNDS,
+           (unsigned long long)(SerialHandoffs / BENCH_ROUNDS));
+    printf("concurrent: %8.2f us, %3llu waits for each event (all cores at a time, a round for each task)\n",
+           ConcurrentTime * 1e6 / BENCH_ROUNDS,
+           (unsigned long long)(ConcurrentHandoffs / BENCH_ROUNDS));
+    printf("batched:    %8.2f us, %3llu waits for each event (all cores at a time, a single round)\n",
+           BatchedTime * 1e6 / BENCH_ROUNDS,
+           (unsigned long long)(BatchedHandoffs / BENCH_ROUNDS));
+
+    return TRUE;
+}
+
+int
+main(void)
+{
+    BOOLEAN Result;
+
+    TaskBroadcastInitialize(&g_Broadcast);
+
+    //
+    // All of the cores are halted (locked by the main core)
+    //
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        g_Cores[i].Lock = 1;
+        pthread_create(&g_Cores[i].Thread, NULL, BenchHaltedCore, &g_Cores[i]);
+    }
+
+    Result = BenchTestRounds() && BenchTestBatches() && BenchMeasure();
+
+    //
+    // Continue the cores
+    //
+    __atomic_store_n(&g_Exit, 1, __ATOMIC_RELEASE);
+
+    for (UINT32 i = 0; i < BENCH_CORES; i++)
+    {
+        BenchUnlock(&g_Cores[i].Lock);
+        pthread_join(g_Cores[i].Thread, NULL);
+    }
+
+    if (!Result)
+    {
+        return 1;
+    }
+
+    printf("task broadcast tests passed\n");
+
+    return 0;
+}
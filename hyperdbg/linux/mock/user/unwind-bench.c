@@ -0,0 +1,574 @@
+/**
+ * @file unwind-bench.c
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Tests and benchmark of unwinding the x64 frames by their unwind data
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//////////////////////////////////////////////////
+//					Constants					//
+//////////////////////////////////////////////////
+
+#define BENCH_IMAGE_BASE        0x140000000ull
+#define BENCH_FUNCTION_RVA      0x1000
+#define BENCH_MAXIMUM_CODE_SIZE 0x40
+#define BENCH_STACK_BASE        0x7ff000ull
+#define BENCH_RETURN_ADDRESS    0x140002345ull
+#define BENCH_INTERRUPTED_RIP   0x140005000ull
+#define BENCH_INTERRUPTED_RSP   0x800100ull
+#define BENCH_ROUNDS            200000
+
+#define BENCH_RBX 3
+#define BENCH_RBP 5
+#define BENCH_RSI 6
+
+/**
+ * @brief An unwind code (UNWIND_CODE) of the cases
+ *
+ */
+#define BENCH_CODE(Offset, Op, Info) ((UINT16)((Offset) | ((Op) << 8) | ((Info) << 12)))
+
+//////////////////////////////////////////////////
+//					Structures					//
+//////////////////////////////////////////////////
+
+/**
+ * @brief Bytes of the code of the function (the other bytes are nops)
+ *
+ */
+typedef struct _BENCH_CODE_BYTES
+{
+    UINT32 Offset;
+    UINT32 Size;
+    BYTE   Bytes[16];
+
+} BENCH_CODE_BYTES;
+
+/**
+ * @brief An UNWIND_INFO of the cases (the Rva of the unused infos is zero)
+ *
+ */
+typedef struct _BENCH_UNWIND_INFO
+{
+    UINT32                  Rva;
+    BYTE                    Version;
+    BYTE                    Flags;
+    BYTE                    SizeOfProlog;
+    BYTE                    FrameRegister;
+    BYTE                    FrameOffset; // scaled by 16
+    BYTE                    CountOfCodes;
+    UINT16                  Codes[8];
+    UNWIND_RUNTIME_FUNCTION Chained;
+
+} BENCH_UNWIND_INFO;
+
+/**
+ * @brief A readable slot of the stack (the slots with a zero value are unused)
+ *
+ */
+typedef struct _BENCH_STACK_SLOT
+{
+    UINT64 Offset; // from BENCH_STACK_BASE
+    UINT64 Value;
+
+} BENCH_STACK_SLOT;
+
+/**
+ * @brief An expected register of the caller (the registers with a zero value are unused)
+ *
+ */
+typedef struct _BENCH_REGISTER
+{
+    UINT32 Number;
+    UINT64 Value;
+
+} BENCH_REGISTER;
+
+/**
+ * @brief A frame that is unwound, and its expected caller
+ *
+ */
+typedef struct _BENCH_UNWIND_CASE
+{
+    const CHAR *      Name;
+    UINT32            CodeSize;
+    BENCH_CODE_BYTES  Code[2];
+    BENCH_UNWIND_INFO Infos[2]; // the first info is the info of the function
+    UINT32            RipOffset;
+    UINT64            Rsp; // BENCH_STACK_BASE if it's zero
+    UINT64            Rbp;
+    BENCH_STACK_SLOT  Stack[4];
+
+    BOOLEAN        Result;
+    BOOLEAN        IsInEpilog;
+    BOOLEAN        IsMachineFrame;
+    UINT64         CallerRip;
+    UINT64         CallerRsp;
+    BENCH_REGISTER Registers[2];
+
+} BENCH_UNWIND_CASE;
+
+//////////////////////////////////////////////////
+//					Globals						//
+//////////////////////////////////////////////////
+
+/**
+ * @brief The frames of the push/alloc prologs, the epilogs, the chained infos,
+ * the machine frames and the frame pointers
+ *
+ */
+static const BENCH_UNWIND_CASE g_Cases[] = {
+    {.Name = "prolog: push, sub rsp (after the prolog)",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 5, .Bytes = {0x53, 0x48, 0x83, 0xec, 0x20}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 5, .CountOfCodes = 2, .Codes = {BENCH_CODE(5, UNWIND_OP_ALLOC_SMALL, 3), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x20, 0x3333}, {0x28, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x30,
+     .Registers = {{BENCH_RBX, 0x3333}}},
+
+    {.Name = "prolog: only the push is executed",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 5, .Bytes = {0x53, 0x48, 0x83, 0xec, 0x20}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 5, .CountOfCodes = 2, .Codes = {BENCH_CODE(5, UNWIND_OP_ALLOC_SMALL, 3), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 1,
+     .Stack = {{0, 0x3333}, {0x8, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x10,
+     .Registers = {{BENCH_RBX, 0x3333}}},
+
+    {.Name = "epilog: add rsp, pops and ret",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 6, .Bytes = {0x53, 0x56, 0x48, 0x83, 0xec, 0x28}}, {.Offset = 0x20, .Size = 7, .Bytes = {0x48, 0x83, 0xc4, 0x28, 0x5e, 0x5b, 0xc3}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 6, .CountOfCodes = 3, .Codes = {BENCH_CODE(6, UNWIND_OP_ALLOC_SMALL, 4), BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x20,
+     .Stack = {{0x28, 0x6666}, {0x30, 0x3333}, {0x38, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .IsInEpilog = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x40,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "epilog: the frame is already deallocated",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 6, .Bytes = {0x53, 0x56, 0x48, 0x83, 0xec, 0x28}}, {.Offset = 0x20, .Size = 7, .Bytes = {0x48, 0x83, 0xc4, 0x28, 0x5e, 0x5b, 0xc3}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 6, .CountOfCodes = 3, .Codes = {BENCH_CODE(6, UNWIND_OP_ALLOC_SMALL, 4), BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x24,
+     .Stack = {{0, 0x6666}, {0x8, 0x3333}, {0x10, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .IsInEpilog = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x18,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "epilog: add rsp, imm32",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 8, .Bytes = {0x53, 0x48, 0x81, 0xec, 0x00, 0x01, 0x00, 0x00}}, {.Offset = 0x20, .Size = 9, .Bytes = {0x48, 0x81, 0xc4, 0x00, 0x01, 0x00, 0x00, 0x5b, 0xc3}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 8, .CountOfCodes = 3, .Codes = {BENCH_CODE(8, UNWIND_OP_ALLOC_LARGE, 0), 0x20, BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x20,
+     .Stack = {{0x100, 0x3333}, {0x108, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .IsInEpilog = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x110,
+     .Registers = {{BENCH_RBX, 0x3333}}},
+
+    {.Name = "epilog: lea rsp, [frame register + disp]",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 4, .Bytes = {0x55, 0x48, 0x8b, 0xec}}, {.Offset = 0x20, .Size = 6, .Bytes = {0x48, 0x8d, 0x65, 0x10, 0x5d, 0xc3}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 4, .FrameRegister = BENCH_RBP, .CountOfCodes = 2, .Codes = {BENCH_CODE(4, UNWIND_OP_SET_FPREG, 0), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBP)}}},
+     .RipOffset = 0x20,
+     .Rsp = BENCH_STACK_BASE - 0x40,
+     .Rbp = BENCH_STACK_BASE + 0x10,
+     .Stack = {{0x20, 0x5555}, {0x28, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .IsInEpilog = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x30,
+     .Registers = {{BENCH_RBP, 0x5555}}},
+
+    {.Name = "epilog: tail call out of the function",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 6, .Bytes = {0x53, 0x56, 0x48, 0x83, 0xec, 0x28}}, {.Offset = 0x20, .Size = 11, .Bytes = {0x48, 0x83, 0xc4, 0x28, 0x5e, 0x5b, 0xe9, 0x00, 0x10, 0x00, 0x00}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 6, .CountOfCodes = 3, .Codes = {BENCH_CODE(6, UNWIND_OP_ALLOC_SMALL, 4), BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x20,
+     .Stack = {{0x28, 0x6666}, {0x30, 0x3333}, {0x38, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .IsInEpilog = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x40,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "epilog: a jump into the function is not an epilog",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 6, .Bytes = {0x53, 0x56, 0x48, 0x83, 0xec, 0x28}}, {.Offset = 0x20, .Size = 11, .Bytes = {0x48, 0x83, 0xc4, 0x28, 0x5e, 0x5b, 0xe9, 0xe0, 0xff, 0xff, 0xff}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 6, .CountOfCodes = 3, .Codes = {BENCH_CODE(6, UNWIND_OP_ALLOC_SMALL, 4), BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x20,
+     .Stack = {{0x28, 0x6666}, {0x30, 0x3333}, {0x38, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x40,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "chained info: after the prolog",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 4, .Bytes = {0x48, 0x83, 0xec, 0x10}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .Flags = UNWIND_FLAG_CHAININFO, .SizeOfProlog = 4, .CountOfCodes = 1, .Codes = {BENCH_CODE(4, UNWIND_OP_ALLOC_SMALL, 1)}, .Chained = {0xf00, 0x1000, 0x3100}}, {.Rva = 0x3100, .Version = 1, .SizeOfProlog = 2, .CountOfCodes = 2, .Codes = {BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x10, 0x6666}, {0x18, 0x3333}, {0x20, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x28,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "chained info: the parent's prolog is already executed",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 4, .Bytes = {0x48, 0x83, 0xec, 0x10}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .Flags = UNWIND_FLAG_CHAININFO, .SizeOfProlog = 4, .CountOfCodes = 1, .Codes = {BENCH_CODE(4, UNWIND_OP_ALLOC_SMALL, 1)}, .Chained = {0xf00, 0x1000, 0x3100}}, {.Rva = 0x3100, .Version = 1, .SizeOfProlog = 2, .CountOfCodes = 2, .Codes = {BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0,
+     .Stack = {{0, 0x6666}, {0x8, 0x3333}, {0x10, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x18,
+     .Registers = {{BENCH_RSI, 0x6666}, {BENCH_RBX, 0x3333}}},
+
+    {.Name = "machine frame",
+     .CodeSize = 0x30,
+     .Infos = {{.Rva = 0x3000, .Version = 1, .CountOfCodes = 1, .Codes = {BENCH_CODE(0, UNWIND_OP_PUSH_MACHFRAME, 0)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0, BENCH_INTERRUPTED_RIP}, {0x18, BENCH_INTERRUPTED_RSP}},
+     .Result = TRUE,
+     .IsMachineFrame = TRUE,
+     .CallerRip = BENCH_INTERRUPTED_RIP,
+     .CallerRsp = BENCH_INTERRUPTED_RSP},
+
+    {.Name = "machine frame with an error code",
+     .CodeSize = 0x30,
+     .Infos = {{.Rva = 0x3000, .Version = 1, .CountOfCodes = 1, .Codes = {BENCH_CODE(0, UNWIND_OP_PUSH_MACHFRAME, 1)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x8, BENCH_INTERRUPTED_RIP}, {0x20, BENCH_INTERRUPTED_RSP}},
+     .Result = TRUE,
+     .IsMachineFrame = TRUE,
+     .CallerRip = BENCH_INTERRUPTED_RIP,
+     .CallerRsp = BENCH_INTERRUPTED_RSP},
+
+    {.Name = "frame pointer: saved register and alloca",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 14, .Bytes = {0x55, 0x48, 0x83, 0xec, 0x40, 0x48, 0x8d, 0x6c, 0x24, 0x20, 0x48, 0x89, 0x5d, 0x18}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 0xe, .FrameRegister = BENCH_RBP, .FrameOffset = 2, .CountOfCodes = 5, .Codes = {BENCH_CODE(0xe, UNWIND_OP_SAVE_NONVOL, BENCH_RBX), 7, BENCH_CODE(0xa, UNWIND_OP_SET_FPREG, 0), BENCH_CODE(5, UNWIND_OP_ALLOC_SMALL, 7), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBP)}}},
+     .RipOffset = 0x20,
+     .Rsp = BENCH_STACK_BASE - 0x80,
+     .Rbp = BENCH_STACK_BASE + 0x20,
+     .Stack = {{0x38, 0x3333}, {0x40, 0x5555}, {0x48, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x50,
+     .Registers = {{BENCH_RBX, 0x3333}, {BENCH_RBP, 0x5555}}},
+
+    {.Name = "large allocation (32-bit size)",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 8, .Bytes = {0x53, 0x48, 0x81, 0xec, 0x10, 0x00, 0x01, 0x00}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 8, .CountOfCodes = 4, .Codes = {BENCH_CODE(8, UNWIND_OP_ALLOC_LARGE, 1), 0x0010, 0x0001, BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x10010, 0x3333}, {0x10018, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x10020,
+     .Registers = {{BENCH_RBX, 0x3333}}},
+
+    {.Name = "large allocation (scaled size)",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 7, .Bytes = {0x48, 0x81, 0xec, 0x80, 0x01, 0x00, 0x00}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 7, .CountOfCodes = 2, .Codes = {BENCH_CODE(7, UNWIND_OP_ALLOC_LARGE, 0), 0x0030}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x180, BENCH_RETURN_ADDRESS}},
+     .Result = TRUE,
+     .CallerRip = BENCH_RETURN_ADDRESS,
+     .CallerRsp = BENCH_STACK_BASE + 0x188},
+
+    {.Name = "unknown version of the unwind info",
+     .CodeSize = 0x30,
+     .Infos = {{.Rva = 0x3000, .Version = 3}},
+     .RipOffset = 0x10,
+     .Stack = {{0, BENCH_RETURN_ADDRESS}},
+     .Result = FALSE},
+
+    {.Name = "unreadable return address",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 5, .Bytes = {0x53, 0x48, 0x83, 0xec, 0x20}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 5, .CountOfCodes = 2, .Codes = {BENCH_CODE(5, UNWIND_OP_ALLOC_SMALL, 3), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x10,
+     .Stack = {{0x20, 0x3333}},
+     .Result = FALSE},
+
+    {.Name = "epilog: unreadable return address",
+     .CodeSize = 0x30,
+     .Code = {{.Offset = 0, .Size = 6, .Bytes = {0x53, 0x56, 0x48, 0x83, 0xec, 0x28}}, {.Offset = 0x20, .Size = 7, .Bytes = {0x48, 0x83, 0xc4, 0x28, 0x5e, 0x5b, 0xc3}}},
+     .Infos = {{.Rva = 0x3000, .Version = 1, .SizeOfProlog = 6, .CountOfCodes = 3, .Codes = {BENCH_CODE(6, UNWIND_OP_ALLOC_SMALL, 4), BENCH_CODE(2, UNWIND_OP_PUSH_NONVOL, BENCH_RSI), BENCH_CODE(1, UNWIND_OP_PUSH_NONVOL, BENCH_RBX)}}},
+     .RipOffset = 0x24,
+     .Stack = {{0, 0x6666}, {0x8, 0x3333}},
+     .Result = FALSE},
+};
+
+static const BENCH_UNWIND_CASE * g_Case;
+static BYTE                      g_Code[BENCH_MAXIMUM_CODE_SIZE];
+static BYTE                      g_Infos[2][64];
+
+//////////////////////////////////////////////////
+//					Functions					//
+//////////////////////////////////////////////////
+
+static BOOLEAN
+BenchReadCode(PVOID Context, UINT64 Address, UINT32 Size, BYTE * Buffer)
+{
+    UINT64 Offset = Address - (BENCH_IMAGE_BASE + BENCH_FUNCTION_RVA);
+
+    UNREFERENCED_PARAMETER(Context);
+
+    if (Address < BENCH_IMAGE_BASE + BENCH_FUNCTION_RVA || Offset + Size > g_Case->CodeSize)
+    {
+        return FALSE;
+    }
+
+    memcpy(Buffer, &g_Code[Offset], Size);
+
+    return TRUE;
+}
+
+static BOOLEAN
+BenchReadStack(PVOID Context, UINT64 Address, UINT64 * Value)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    for (UINT32 i = 0; i < sizeof(g_Case->Stack) / sizeof(g_Case->Stack[0]); i++)
+    {
+        if (g_Case->Stack[i].Value != 0 && BENCH_STACK_BASE + g_Case->Stack[i].Offset == Address)
+        {
+            *Value = g_Case->Stack[i].Value;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static const BYTE *
+BenchGetUnwindInfo(PVOID Context, UINT32 UnwindInfoRva)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        if (g_Case->Infos[i].Rva != 0 && g_Case->Infos[i].Rva == UnwindInfoRva)
+        {
+            return g_Infos[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Build the code and the unwind infos of a case
+ *
+ */
+static VOID
+BenchSetupCase(const BENCH_UNWIND_CASE * Case)
+{
+    g_Case = Case;
+
+    memset(g_Code, 0x90, sizeof(g_Code));
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        memcpy(&g_Code[Case->Code[i].Offset], Case->Code[i].Bytes, Case->Code[i].Size);
+    }
+
+    for (UINT32 i = 0; i < 2; i++)
+    {
+        const BENCH_UNWIND_INFO * Info   = &Case->Infos[i];
+        BYTE *                    Buffer = g_Infos[i];
+
+        memset(Buffer, 0, sizeof(g_Infos[i]));
+
+        Buffer[0] = Info->Version | (Info->Flags << 3);
+        Buffer[1] = Info->SizeOfProlog;
+        Buffer[2] = Info->CountOfCodes;
+        Buffer[3] = Info->FrameRegister | (Info->FrameOffset << 4);
+
+        memcpy(&Buffer[4], Info->Codes, Info->CountOfCodes * sizeof(UINT16));
+
+        //
+        // The chained function is after the codes (aligned to an even count)
+        //
+        memcpy(&Buffer[4 + ((Info->CountOfCodes + 1) & ~1) * sizeof(UINT16)], &Info->Chained, sizeof(UNWIND_RUNTIME_FUNCTION));
+    }
+}
+
+/**
+ * @brief Unwind the frame of the current case (the same as the unwinder of
+ * the debugger does for the current instruction)
+ *
+ */
+static BOOLEAN
+BenchUnwind(PUNWIND_CONTEXT Context, BOOLEAN * IsInEpilog, BOOLEAN * IsMachineFrame)
+{
+    static const UNWIND_IMAGE Image = {BENCH_IMAGE_BASE, BenchReadCode, BenchReadStack, BenchGetUnwindInfo, NULL};
+    UNWIND_RUNTIME_FUNCTION   Function;
+
+    Function.BeginAddress      = BENCH_FUNCTION_RVA;
+    Function.EndAddress        = BENCH_FUNCTION_RVA + g_Case->CodeSize;
+    Function.UnwindInfoAddress = g_Case->Infos[0].Rva;
+
+    for (UINT32 i = 0; i < UNWIND_REGISTER_MAX; i++)
+    {
+        Context->Gpr[i] = 0xdead0000 + i;
+    }
+
+    Context->Rip                      = BENCH_IMAGE_BASE + BENCH_FUNCTION_RVA + g_Case->RipOffset;
+    Context->Gpr[UNWIND_REGISTER_RSP] = g_Case->Rsp != 0 ? g_Case->Rsp : BENCH_STACK_BASE;
+
+    if (g_Case->Rbp != 0)
+    {
+        Context->Gpr[BENCH_RBP] = g_Case->Rbp;
+    }
+
+    *IsInEpilog     = FALSE;
+    *IsMachineFrame = FALSE;
+
+    return UnwindEpilog(&Image, &Function, Context, IsInEpilog) &&
+           (*IsInEpilog || UnwindVirtualUnwind(&Image, &Function, Context, IsMachineFrame));
+}
+
+/**
+ * @brief Check the caller of each case, the registers that are not restored
+ * should be the same as the registers of the frame
+ *
+ */
+static BOOLEAN
+BenchTestCases(void)
+{
+    UNWIND_CONTEXT Context;
+    BOOLEAN        IsInEpilog;
+    BOOLEAN        IsMachineFrame;
+
+    for (UINT32 i = 0; i < sizeof(g_Cases) / sizeof(g_Cases[0]); i++)
+    {
+        const BENCH_UNWIND_CASE * Case = &g_Cases[i];
+        BOOLEAN                   Result;
+
+        BenchSetupCase(Case);
+
+        Result = BenchUnwind(&Context, &IsInEpilog, &IsMachineFrame);
+
+        if (Result != Case->Result)
+        {
+            printf("err, %s: the unwinding %s\n", Case->Name, Result ? "succeeds" : "fails");
+            return FALSE;
+        }
+
+        if (!Result)
+        {
+            continue;
+        }
+
+        if (IsInEpilog != Case->IsInEpilog || IsMachineFrame != Case->IsMachineFrame ||
+            Context.Rip != Case->CallerRip || Context.Gpr[UNWIND_REGISTER_RSP] != Case->CallerRsp)
+        {
+            printf("err, %s: the caller is %llx (rsp: %llx, epilog: %u, machine frame: %u) instead of %llx (rsp: %llx)\n",
+                   Case->Name,
+                   (unsigned long long)Context.Rip,
+                   (unsigned long long)Context.Gpr[UNWIND_REGISTER_RSP],
+                   IsInEpilog,
+                   IsMachineFrame,
+                   (unsigned long long)Case->CallerRip,
+                   (unsigned long long)Case->CallerRsp);
+            return FALSE;
+        }
+
+        for (UINT32 Register = 0; Register < UNWIND_REGISTER_MAX; Register++)
+        {
+            UINT64 Expected = 0xdead0000 + Register;
+
+            if (Register == UNWIND_REGISTER_RSP)
+            {
+                continue;
+            }
+
+            if (Register == BENCH_RBP && Case->Rbp != 0)
+            {
+                Expected = Case->Rbp;
+            }
+
+            for (UINT32 j = 0; j < sizeof(Case->Registers) / sizeof(Case->Registers[0]); j++)
+            {
+                if (Case->Registers[j].Value != 0 && Case->Registers[j].Number == Register)
+                {
+                    Expected = Case->Registers[j].Value;
+                }
+            }
+
+            if (Context.Gpr[Register] != Expected)
+            {
+                printf("err, %s: register %u is %llx instead of %llx\n",
+                       Case->Name,
+                       Register,
+                       (unsigned long long)Context.Gpr[Register],
+                       (unsigned long long)Expected);
+                return FALSE;
+            }
+        }
+    }
+
+    printf("cases:  %u frames (prologs, epilogs, chained infos and machine frames) are unwound to their callers\n",
+           (UINT32)(sizeof(g_Cases) / sizeof(g_Cases[0])));
+
+    return TRUE;
+}
+
+/**
+ * @brief Measure the frames that are unwound in a second
+ *
+ */
+static VOID
+BenchMeasure(void)
+{
+    UNWIND_CONTEXT Context;
+    BOOLEAN        IsInEpilog;
+    BOOLEAN        IsMachineFrame;
+    UINT64         Frames = 0;
+    double         Start  = BenchNow();
+
+    for (UINT32 Round = 0; Round < BENCH_ROUNDS; Round++)
+    {
+        BenchSetupCase(&g_Cases[Round % (sizeof(g_Cases) / sizeof(g_Cases[0]))]);
+
+        Frames += BenchUnwind(&Context, &IsInEpilog, &IsMachineFrame);
+    }
+
+    printf("unwind: %8.2f M frames/s (including building the frames)\n", Frames / (BenchNow() - Start) / 1e6);
+}
+
+int
+main(void)
+{
+    if (!BenchTestCases())
+    {
+        return 1;
+    }
+
+    BenchMeasure();
+
+    printf("unwind tests passed\n");
+
+    return 0;
+}
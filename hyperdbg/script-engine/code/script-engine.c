@@ -132,6 +132,14 @@ PopStructBaseType(PSCRIPT_ENGINE_TOKEN_LIST MatchedStack, PSCRIPT_ENGINE_ERROR_T
 
     TagToken = Pop(MatchedStack);
     Type     = FindStructType(TagToken->Value);
+
+    //
+    // Structures of the modules (module!type) are imported from the symbols
+    //
+    if (!Type)
+    {
+        Type = ImportStructType(TagToken->Value);
+    }
     RemoveToken(&TagToken);
     if (!Type)
     {
@@ -307,6 +315,21 @@ ScriptEngineGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize)
     return SymGetDataTypeSize(TypeName, TypeSize);
 }
 
+/**
+ * @brief Get the compiled layout of a data type (structure)
+ *
+ * @param TypeName
+ * @return const SYMBOL_TYPE_LAYOUT *
+ */
+const SYMBOL_TYPE_LAYOUT *
+ScriptEngineGetTypeLayout(const CHAR * TypeName)
+{
+    //
+    // A wrapper for getting the layout of the structure
+    //
+    return SymGetTypeLayout(TypeName);
+}
+
 /**
  * @brief Create symbol table for disassembler
  *
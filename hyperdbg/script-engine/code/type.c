@@ -296,6 +296,164 @@ CreateArrayType(PVARIABLE_TYPE BaseType, unsigned int ArrayLength)
     return Type;
 }
 
+static PVARIABLE_TYPE
+ImportLayoutMemberType(const SYMBOL_TYPE_LAYOUT * Layout, const SYMBOL_TYPE_LAYOUT_MEMBER * Member);
+
+static PVARIABLE_TYPE
+ImportIntegerType(UINT32 Size, BOOLEAN IsSigned)
+{
+    switch (Size)
+    {
+    case 1:
+        return IsSigned ? VARIABLE_TYPE_CHAR : VARIABLE_TYPE_UCHAR;
+    case 2:
+        return IsSigned ? VARIABLE_TYPE_SHORT : VARIABLE_TYPE_USHORT;
+    case 4:
+        return IsSigned ? VARIABLE_TYPE_INT : VARIABLE_TYPE_UINT;
+    case 8:
+        return IsSigned ? VARIABLE_TYPE_LONG : VARIABLE_TYPE_ULONG;
+    default:
+        return NULL;
+    }
+}
+
+static int
+ImportedTypeAlign(UINT64 Size)
+{
+    int Align = 1;
+
+    while (Align < 8 && Size && (Size % (Align * 2)) == 0)
+    {
+        Align *= 2;
+    }
+    return Align;
+}
+
+static VOID
+ImportLayoutMembers(PVARIABLE_TYPE             StructType,
+                    const SYMBOL_TYPE_LAYOUT * Layout,
+                    UINT32                     FirstMember,
+                    UINT32                     NumberOfMembers,
+                    UINT32                     ParentOffset,
+                    UINT64                     Size)
+{
+    UINT32 i;
+
+    for (i = FirstMember; i < FirstMember + NumberOfMembers; i++)
+    {
+        const SYMBOL_TYPE_LAYOUT_MEMBER * Member = &Layout->Members[i];
+        const char *                      Name   = Layout->Names + Member->Name;
+        PVARIABLE_TYPE                    MemberType;
+
+        //
+        // Bitfields can't be addressed by the members of the script engine
+        //
+        if (Member->BitLength || !Name[0])
+        {
+            continue;
+        }
+
+        MemberType = ImportLayoutMemberType(Layout, Member);
+        if (!MemberType || !AddStructMember(StructType, Name, MemberType))
+        {
+            continue;
+        }
+        FindStructMember(StructType, Name)->Offset = Member->Offset - ParentOffset;
+    }
+
+    StructType->Size       = (int)Size;
+    StructType->Align      = ImportedTypeAlign(Size);
+    StructType->IsComplete = TRUE;
+}
+
+static PVARIABLE_TYPE
+ImportLayoutMemberType(const SYMBOL_TYPE_LAYOUT * Layout, const SYMBOL_TYPE_LAYOUT_MEMBER * Member)
+{
+    PVARIABLE_TYPE Type = NULL;
+
+    switch (Member->Kind)
+    {
+    case SYMBOL_TYPE_LAYOUT_KIND_INTEGER:
+        Type = ImportIntegerType(Member->Size, Member->IsSigned);
+        break;
+    case SYMBOL_TYPE_LAYOUT_KIND_ENUM:
+        Type = ImportIntegerType(Member->Size, FALSE);
+        break;
+    case SYMBOL_TYPE_LAYOUT_KIND_FLOAT:
+        Type = Member->Size == 4 ? VARIABLE_TYPE_FLOAT : VARIABLE_TYPE_DOUBLE;
+        break;
+    case SYMBOL_TYPE_LAYOUT_KIND_POINTER:
+        return CreatePointerType(VARIABLE_TYPE_VOID);
+    case SYMBOL_TYPE_LAYOUT_KIND_ARRAY:
+        if (Member->ElementSize && Member->ElementKind == SYMBOL_TYPE_LAYOUT_KIND_INTEGER)
+        {
+            Type = ImportIntegerType(Member->ElementSize, Member->IsSigned);
+        }
+        else if (Member->ElementSize == 8 && Member->ElementKind == SYMBOL_TYPE_LAYOUT_KIND_POINTER)
+        {
+            Type = VARIABLE_TYPE_ULONG;
+        }
+        if (Type)
+        {
+            return CreateArrayType(Type, Member->Size / Member->ElementSize);
+        }
+        break;
+    case SYMBOL_TYPE_LAYOUT_KIND_UDT:
+        Type = AllocateType();
+        if (Type)
+        {
+            Type->Kind    = TY_STRUCT;
+            Type->TagName = PlatformStrDup(Layout->Names + Member->TypeName);
+            ImportLayoutMembers(Type, Layout, Member->FirstChild, Member->NumberOfChildren, Member->Offset, Member->Size);
+        }
+        return Type;
+    default:
+        break;
+    }
+
+    //
+    // Other types are kept as raw bytes
+    //
+    if (!Type && Member->Size)
+    {
+        Type = CreateArrayType(VARIABLE_TYPE_UCHAR, Member->Size);
+    }
+    return Type;
+}
+
+/**
+ * @brief Import a structure from the symbols (e.g., struct nt!_EPROCESS)
+ * @details Offsets and sizes come from the compiled layout of the type, the
+ * nested structures are imported as anonymous complete structures
+ *
+ * @param TagName module!type name of the structure
+ * @return PVARIABLE_TYPE NULL if the type is not found in the symbols
+ */
+PVARIABLE_TYPE
+ImportStructType(const char * TagName)
+{
+    const SYMBOL_TYPE_LAYOUT * Layout;
+    PVARIABLE_TYPE             Type;
+
+    if (!strchr(TagName, '!'))
+    {
+        return NULL;
+    }
+
+    Layout = SymGetTypeLayout(TagName);
+    if (!Layout || !Layout->TypeSize || Layout->TypeSize > 0x7fffffffU)
+    {
+        return NULL;
+    }
+
+    Type = DeclareStructType(TagName);
+    if (Type && !Type->IsComplete)
+    {
+        ImportLayoutMembers(Type, Layout, 0, Layout->NumberOfTopLevelMembers, 0, Layout->TypeSize);
+    }
+    return Type;
+}
+
 BOOLEAN
 AddTypedefType(const char * Name, PVARIABLE_TYPE Type)
 {
@@ -129,6 +129,9 @@ AddStructMember(PVARIABLE_TYPE StructType, const char * Name, PVARIABLE_TYPE Mem
 PSTRUCT_MEMBER
 FindStructMember(PVARIABLE_TYPE StructType, const char * Name);
 
+PVARIABLE_TYPE
+ImportStructType(const char * TagName);
+
 PVARIABLE_TYPE
 CreatePointerType(PVARIABLE_TYPE BaseType);
 
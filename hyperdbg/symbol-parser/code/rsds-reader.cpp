@@ -0,0 +1,551 @@
+/**
+ * @file rsds-reader.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Reading the CodeView RSDS identity of the image files
+ * @details The images are mapped instead of being read, so only the pages of
+ * the headers, the section table, the debug directory, and the CodeView record
+ * are brought from the disk. The identities are also cached (in a file next to
+ * the executable) by the path, the size, and the last write time of the files
+ * so reloading the symbols doesn't open the unchanged images again
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+#include "header/codeview-rsds.h"
+#include "header/rsds-reader.h"
+
+//
+// The cached identities (the keys are the lowercase paths)
+//
+static std::unordered_map<std::string, SYMBOL_RSDS_IDENTITY> g_RsdsCache;
+static std::string                                           g_RsdsCacheFilePath;
+static BOOLEAN                                               g_RsdsCacheIsLoaded   = FALSE;
+static BOOLEAN                                               g_RsdsCacheIsWritable = FALSE;
+
+/**
+ * @brief Parse the RSDS record of a mapped image
+ *
+ * @details The view is guarded, as the file might be truncated (or its volume
+ * removed) while it's mapped, which is raised as an in-page error once the
+ * missing page is touched. There should be no object that needs unwinding here
+ *
+ * @param View
+ * @param ViewSize
+ * @param Identity
+ * @param IsRsdsFound
+ *
+ * @return BOOLEAN FALSE if the view couldn't be read
+ */
+static BOOLEAN
+SymRsdsExtractFromView(const BYTE * View, SIZE_T ViewSize, SYMBOL_RSDS_IDENTITY * Identity, BOOLEAN * IsRsdsFound)
+{
+    __try
+    {
+        *IsRsdsFound = SymExtractCodeViewRsdsInfoFromPeImage(View,
+                                                             ViewSize,
+                                                             Identity->PdbFile,
+                                                             sizeof(Identity->PdbFile),
+                                                             &Identity->Guid,
+                                                             &Identity->Age);
+    }
+    __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Read the CodeView RSDS identity of an image file
+ *
+ * @details The file is mapped and the bounded parser only touches the pages
+ * that it needs, the size and the last write time are taken from the same
+ * handle so they describe the file that is parsed
+ *
+ * @param FilePath
+ * @param Identity
+ *
+ * @return BOOLEAN FALSE if the file couldn't be read, otherwise the
+ * IsRsdsFound shows whether the file has a valid RSDS record
+ */
+BOOLEAN
+SymReadRsdsIdentityFromFile(const CHAR * FilePath, SYMBOL_RSDS_IDENTITY * Identity)
+{
+    BY_HANDLE_FILE_INFORMATION Information;
+    HANDLE                     FileHandle;
+    HANDLE                     MappingHandle;
+    const BYTE *               View;
+    BOOLEAN                    IsRead = FALSE;
+
+    if (FilePath == NULL || Identity == NULL)
+    {
+        return FALSE;
+    }
+
+    ZeroMemory(Identity, sizeof(*Identity));
+
+    FileHandle = CreateFileA(FilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    if (!GetFileInformationByHandle(FileHandle, &Information))
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    Identity->FileSize      = ((UINT64)Information.nFileSizeHigh << 32) | Information.nFileSizeLow;
+    Identity->LastWriteTime = ((UINT64)Information.ftLastWriteTime.dwHighDateTime << 32) | Information.ftLastWriteTime.dwLowDateTime;
+
+    //
+    // Empty files can't be mapped, they're just not images
+    //
+    if (Identity->FileSize == 0)
+    {
+        CloseHandle(FileHandle);
+        return TRUE;
+    }
+
+    if (Identity->FileSize > (SIZE_T)-1)
+    {
+        CloseHandle(FileHandle);
+        return FALSE;
+    }
+
+    MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle != NULL)
+    {
+        View = (const BYTE *)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+        if (View != NULL)
+        {
+            IsRead = SymRsdsExtractFromView(View, (SIZE_T)Identity->FileSize, Identity, &Identity->IsRsdsFound);
+            UnmapViewOfFile(View);
+        }
+
+        CloseHandle(MappingHandle);
+    }
+
+    CloseHandle(FileHandle);
+
+    return IsRead;
+}
+
+/**
+ * @brief Get the path of the cache file (next to the executable by default)
+ *
+ * @return const std::string &
+ */
+static const std::string &
+SymRsdsCacheGetFilePath()
+{
+    CHAR   CurrentPath[MAX_PATH] = {0};
+    SIZE_T Separator;
+
+    if (g_RsdsCacheFilePath.empty())
+    {
+        GetModuleFileNameA(NULL, CurrentPath, MAX_PATH);
+
+        g_RsdsCacheFilePath = CurrentPath;
+        Separator           = g_RsdsCacheFilePath.find_last_of('\\');
+
+        g_RsdsCacheFilePath = (Separator == std::string::npos ? std::string() : g_RsdsCacheFilePath.substr(0, Separator + 1)) +
+                              SYMBOL_RSDS_CACHE_FILE_NAME;
+    }
+
+    return g_RsdsCacheFilePath;
+}
+
+/**
+ * @brief Format an entry of the cache file
+ *
+ * @details The fields are separated by tabs (which can't be in the paths),
+ * the GUID is in the order of its bytes in the memory and the path is the last
+ * field
+ *
+ * @param Key
+ * @param Identity
+ * @param Line
+ *
+ * @return BOOLEAN FALSE if the entry can't be stored in a line
+ */
+static BOOLEAN
+SymRsdsCacheFormatLine(const std::string & Key, const SYMBOL_RSDS_IDENTITY * Identity, std::string & Line)
+{
+    CHAR         Fields[128];
+    const BYTE * GuidBytes = (const BYTE *)&Identity->Guid;
+
+    if (strpbrk(Identity->PdbFile, "\t\r\n") != NULL || Key.find_first_of("\t\r\n") != std::string::npos)
+    {
+        return FALSE;
+    }
+
+    StringCchPrintfA(Fields,
+                     sizeof(Fields),
+                     "%llx\t%llx\t%u\t",
+                     Identity->FileSize,
+                     Identity->LastWriteTime,
+                     Identity->IsRsdsFound ? 1 : 0);
+
+    Line = Fields;
+
+    for (SIZE_T i = 0; i < sizeof(GUID); i++)
+    {
+        StringCchPrintfA(Fields, sizeof(Fields), "%02x", GuidBytes[i]);
+        Line += Fields;
+    }
+
+    StringCchPrintfA(Fields, sizeof(Fields), "\t%x\t", Identity->Age);
+
+    Line += Fields;
+    Line += Identity->PdbFile;
+    Line += '\t';
+    Line += Key;
+    Line += '\n';
+
+    return TRUE;
+}
+
+/**
+ * @brief Parse an entry of the cache file
+ *
+ * @param Line
+ * @param Key
+ * @param Identity
+ *
+ * @return BOOLEAN FALSE if the line is not a valid entry
+ */
+static BOOLEAN
+SymRsdsCacheParseLine(const std::string & Line, std::string & Key, SYMBOL_RSDS_IDENTITY * Identity)
+{
+    std::vector<std::string> Fields;
+    SIZE_T                   Start = 0;
+    SIZE_T                   Separator;
+    CHAR *                   End;
+    BYTE *                   GuidBytes = (BYTE *)&Identity->Guid;
+
+    ZeroMemory(Identity, sizeof(*Identity));
+
+    //
+    // The path is the last field and it takes the rest of the line
+    //
+    while (Fields.size() < 6 && (Separator = Line.find('\t', Start)) != std::string::npos)
+    {
+        Fields.push_back(Line.substr(Start, Separator - Start));
+        Start = Separator + 1;
+    }
+
+    if (Fields.size() != 6 || Start >= Line.size() || Fields[3].size() != sizeof(GUID) * 2 ||
+        Fields[5].size() >= sizeof(Identity->PdbFile))
+    {
+        return FALSE;
+    }
+
+    Key = Line.substr(Start);
+
+    Identity->FileSize = strtoull(Fields[0].c_str(), &End, 16);
+    if (Fields[0].empty() || *End != '\0')
+    {
+        return FALSE;
+    }
+
+    Identity->LastWriteTime = strtoull(Fields[1].c_str(), &End, 16);
+    if (Fields[1].empty() || *End != '\0')
+    {
+        return FALSE;
+    }
+
+    if (Fields[2] != "0" && Fields[2] != "1")
+    {
+        return FALSE;
+    }
+
+    Identity->IsRsdsFound = Fields[2] == "1";
+
+    for (SIZE_T i = 0; i < sizeof(GUID); i++)
+    {
+        CHAR Byte[3] = {Fields[3][i * 2], Fields[3][i * 2 + 1], '\0'};
+
+        GuidBytes[i] = (BYTE)strtoul(Byte, &End, 16);
+        if (*End != '\0')
+        {
+            return FALSE;
+        }
+    }
+
+    Identity->Age = (DWORD)strtoul(Fields[4].c_str(), &End, 16);
+    if (Fields[4].empty() || *End != '\0')
+    {
+        return FALSE;
+    }
+
+    memcpy(Identity->PdbFile, Fields[5].c_str(), Fields[5].size() + 1);
+
+    return TRUE;
+}
+
+/**
+ * @brief Write all the cached identities into the cache file (replacing it)
+ *
+ * @return BOOLEAN
+ */
+static BOOLEAN
+SymRsdsCacheWriteAll()
+{
+    std::string Contents = SYMBOL_RSDS_CACHE_SIGNATURE "\n";
+    std::string Line;
+    HANDLE      FileHandle;
+    DWORD       BytesWritten = 0;
+    BOOLEAN     IsWritten;
+
+    for (const auto & Entry : g_RsdsCache)
+    {
+        if (SymRsdsCacheFormatLine(Entry.first, &Entry.second, Line))
+        {
+            Contents += Line;
+        }
+    }
+
+    FileHandle = CreateFileA(SymRsdsCacheGetFilePath().c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return FALSE;
+    }
+
+    IsWritten = WriteFile(FileHandle, Contents.data(), (DWORD)Contents.size(), &BytesWritten, NULL) &&
+                BytesWritten == Contents.size();
+
+    CloseHandle(FileHandle);
+
+    return IsWritten;
+}
+
+/**
+ * @brief Append a new identity to the cache file
+ *
+ * @details The later lines of a path replace its earlier ones once the file is
+ * loaded, so the file is only appended while the symbols are loaded and it's
+ * compacted when it's loaded again
+ *
+ * @param Key
+ * @param Identity
+ *
+ * @return VOID
+ */
+static VOID
+SymRsdsCacheAppend(const std::string & Key, const SYMBOL_RSDS_IDENTITY * Identity)
+{
+    std::string Line;
+    HANDLE      FileHandle;
+    DWORD       BytesWritten = 0;
+
+    if (!g_RsdsCacheIsWritable || !SymRsdsCacheFormatLine(Key, Identity, Line))
+    {
+        return;
+    }
+
+    FileHandle = CreateFileA(SymRsdsCacheGetFilePath().c_str(),
+                             FILE_APPEND_DATA,
+                             FILE_SHARE_READ,
+                             NULL,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        g_RsdsCacheIsWritable = FALSE;
+        return;
+    }
+
+    WriteFile(FileHandle, Line.data(), (DWORD)Line.size(), &BytesWritten, NULL);
+    CloseHandle(FileHandle);
+}
+
+/**
+ * @brief Load the cache file (if it's not already loaded)
+ *
+ * @details A missing or a corrupted file is written again, and so is a file
+ * that most of its lines are replaced by the later lines
+ *
+ * @return VOID
+ */
+static VOID
+SymRsdsCacheLoad()
+{
+    std::string          Contents;
+    std::string          Line;
+    std::string          Key;
+    SYMBOL_RSDS_IDENTITY Identity;
+    LARGE_INTEGER        FileSize      = {0};
+    DWORD                BytesRead     = 0;
+    SIZE_T               NumberOfLines = 0;
+    BOOLEAN              IsValid       = FALSE;
+    HANDLE               FileHandle;
+
+    if (g_RsdsCacheIsLoaded)
+    {
+        return;
+    }
+
+    g_RsdsCacheIsLoaded = TRUE;
+
+    FileHandle = CreateFileA(SymRsdsCacheGetFilePath().c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             NULL,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL);
+
+    if (FileHandle != INVALID_HANDLE_VALUE)
+    {
+        if (GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0 && FileSize.QuadPart < MAXDWORD)
+        {
+            Contents.resize((SIZE_T)FileSize.QuadPart);
+
+            if (!ReadFile(FileHandle, &Contents[0], (DWORD)Contents.size(), &BytesRead, NULL))
+            {
+                BytesRead = 0;
+            }
+
+            Contents.resize(BytesRead);
+        }
+
+        CloseHandle(FileHandle);
+    }
+
+    std::istringstream Stream(Contents);
+
+    if (std::getline(Stream, Line) && Line == SYMBOL_RSDS_CACHE_SIGNATURE)
+    {
+        IsValid = TRUE;
+
+        while (std::getline(Stream, Line))
+        {
+            NumberOfLines++;
+
+            if (SymRsdsCacheParseLine(Line, Key, &Identity))
+            {
+                g_RsdsCache[Key] = Identity;
+            }
+        }
+    }
+
+    g_RsdsCacheIsWritable = TRUE;
+
+    if (!IsValid || NumberOfLines > g_RsdsCache.size() * 2 + 64)
+    {
+        g_RsdsCacheIsWritable = SymRsdsCacheWriteAll();
+    }
+}
+
+/**
+ * @brief Get the CodeView RSDS identity of an image file from the cache, or
+ * read it (and cache it) if the file is not cached or it's changed since then
+ *
+ * @param FilePath
+ * @param Identity
+ * @param IsCacheHit Optional, shows whether the file is read
+ *
+ * @return BOOLEAN FALSE if the file couldn't be read, otherwise the
+ * IsRsdsFound shows whether the file has a valid RSDS record
+ */
+BOOLEAN
+SymRsdsCacheGetIdentity(const CHAR * FilePath, SYMBOL_RSDS_IDENTITY * Identity, BOOLEAN * IsCacheHit)
+{
+    WIN32_FILE_ATTRIBUTE_DATA Attributes;
+    UINT64                    FileSize;
+    UINT64                    LastWriteTime;
+
+    if (IsCacheHit != NULL)
+    {
+        *IsCacheHit = FALSE;
+    }
+
+    if (FilePath == NULL || Identity == NULL)
+    {
+        return FALSE;
+    }
+
+    SymRsdsCacheLoad();
+
+    //
+    // Querying the attributes doesn't open the file
+    //
+    if (!GetFileAttributesExA(FilePath, GetFileExInfoStandard, &Attributes) ||
+        (Attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        return FALSE;
+    }
+
+    FileSize      = ((UINT64)Attributes.nFileSizeHigh << 32) | Attributes.nFileSizeLow;
+    LastWriteTime = ((UINT64)Attributes.ftLastWriteTime.dwHighDateTime << 32) | Attributes.ftLastWriteTime.dwLowDateTime;
+
+    std::string Key(FilePath);
+    std::transform(Key.begin(), Key.end(), Key.begin(), ::tolower);
+
+    auto Entry = g_RsdsCache.find(Key);
+
+    if (Entry != g_RsdsCache.end() && Entry->second.FileSize == FileSize && Entry->second.LastWriteTime == LastWriteTime)
+    {
+        *Identity = Entry->second;
+
+        if (IsCacheHit != NULL)
+        {
+            *IsCacheHit = TRUE;
+        }
+
+        return TRUE;
+    }
+
+    if (!SymReadRsdsIdentityFromFile(FilePath, Identity))
+    {
+        return FALSE;
+    }
+
+    g_RsdsCache[Key] = *Identity;
+    SymRsdsCacheAppend(Key, Identity);
+
+    return TRUE;
+}
+
+/**
+ * @brief Use another cache file (the cached identities are unloaded)
+ *
+ * @param CacheFilePath The cache file, or NULL to use the default file
+ *
+ * @return VOID
+ */
+VOID
+SymRsdsCacheSetFilePath(const CHAR * CacheFilePath)
+{
+    SymRsdsCacheUnload();
+
+    g_RsdsCacheFilePath = CacheFilePath == NULL ? "" : CacheFilePath;
+}
+
+/**
+ * @brief Unload the cached identities, they're loaded from the cache file once
+ * they're needed again
+ *
+ * @return VOID
+ */
+VOID
+SymRsdsCacheUnload()
+{
+    g_RsdsCache.clear();
+
+    g_RsdsCacheIsLoaded   = FALSE;
+    g_RsdsCacheIsWritable = FALSE;
+}
@@ -13,6 +13,7 @@
 #include "pch.h"
 
 #include "header/pdb-identity.h"
+#include "header/rsds-reader.h"
 
 //
 // Global Variables
@@ -25,96 +26,80 @@ PVOID                                      g_MessageHandler             = NULL;
 SymbolMapCallback                          g_SymbolMapForDisassembler   = NULL;
 
 /**
- * @brief Reads the contents of a file into a byte vector
+ * @brief Fallback callback function to retrieve PDB file name, GUID, and age information using SymSrvGetFileIndexInfo when the primary extractor fails
  *
- * @param LocalFilePath The path to the local file to read
- * @param FileBytes An output reference to a vector that will receive the file bytes on success; will be cleared on failure
+ * @param Context A context pointer that is expected to be a string representing the file path to query with SymSrvGetFileIndexInfo
+ * @param PdbFile An output buffer to receive the base name of the PDB file extracted from SymSrvGetFileIndexInfo. Must be at least PdbFileSize bytes
+ * @param PdbFileSize The size of the PdbFile buffer in bytes
+ * @param Guid An output pointer to receive the GUID extracted from SymSrvGetFileIndexInfo
+ * @param Age An output pointer to receive the age extracted from SymSrvGetFileIndexInfo
  *
- * @return BOOLEAN TRUE if the file was successfully read, FALSE on failure (e.g. file not found, access denied, read error)
+ * @return BOOLEAN TRUE if the information was successfully retrieved and output buffers were filled as requested, FALSE otherwise (e.g., if Context is invalid or SymSrvGetFileIndexInfo fails)
  */
 static BOOLEAN
-SymReadFileBytes(const char * LocalFilePath, std::vector<BYTE> & FileBytes)
+SymSrvGetFileIndexInfoFallback(PVOID Context, CHAR * PdbFile, SIZE_T PdbFileSize, GUID * Guid, DWORD * Age)
 {
-    FileBytes.clear();
+    SYMSRV_INDEX_INFO SymInfo = {0};
+    SymInfo.sizeofstruct      = sizeof(SYMSRV_INDEX_INFO);
 
-    if (LocalFilePath == NULL)
+    if (Context == NULL || PdbFile == NULL || Guid == NULL || Age == NULL)
     {
         return FALSE;
     }
 
-    HANDLE FileHandle = CreateFileA(LocalFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (FileHandle == INVALID_HANDLE_VALUE)
+    if (!SymSrvGetFileIndexInfo((const char *)Context, &SymInfo, 0))
     {
         return FALSE;
     }
 
-    LARGE_INTEGER FileSize = {0};
-    if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart <= 0 || (ULONGLONG)FileSize.QuadPart > FileBytes.max_size())
+    if (FAILED(StringCchCopyA(PdbFile, PdbFileSize, SymInfo.pdbfile)))
     {
-        CloseHandle(FileHandle);
         return FALSE;
     }
 
-    FileBytes.resize((SIZE_T)FileSize.QuadPart);
-
-    BYTE * WriteCursor = FileBytes.data();
-    SIZE_T Remaining   = FileBytes.size();
-    while (Remaining != 0)
-    {
-        DWORD ChunkSize = Remaining > MAXDWORD ? MAXDWORD : (DWORD)Remaining;
-        DWORD BytesRead = 0;
-
-        if (!ReadFile(FileHandle, WriteCursor, ChunkSize, &BytesRead, NULL) || BytesRead == 0)
-        {
-            CloseHandle(FileHandle);
-            FileBytes.clear();
-            return FALSE;
-        }
-
-        WriteCursor += BytesRead;
-        Remaining -= BytesRead;
-    }
+    *Guid = SymInfo.guid;
+    *Age  = SymInfo.age;
 
-    CloseHandle(FileHandle);
     return TRUE;
 }
 
 /**
- * @brief Fallback callback function to retrieve PDB file name, GUID, and age information using SymSrvGetFileIndexInfo when the primary extractor fails
+ * @brief Callback function to retrieve PDB file name, GUID, and age information of an image file
+ * from the identity cache (or the headers of the file), falling back to SymSrvGetFileIndexInfo if the
+ * file has no RSDS record
  *
- * @param Context A context pointer that is expected to be a string representing the file path to query with SymSrvGetFileIndexInfo
- * @param PdbFile An output buffer to receive the base name of the PDB file extracted from SymSrvGetFileIndexInfo. Must be at least PdbFileSize bytes
+ * @param Context A context pointer that is expected to be a string representing the file path
+ * @param PdbFile An output buffer to receive the base name of the PDB file. Must be at least PdbFileSize bytes
  * @param PdbFileSize The size of the PdbFile buffer in bytes
- * @param Guid An output pointer to receive the GUID extracted from SymSrvGetFileIndexInfo
- * @param Age An output pointer to receive the age extracted from SymSrvGetFileIndexInfo
+ * @param Guid An output pointer to receive the GUID
+ * @param Age An output pointer to receive the age
  *
- * @return BOOLEAN TRUE if the information was successfully retrieved and output buffers were filled as requested, FALSE otherwise (e.g., if Context is invalid or SymSrvGetFileIndexInfo fails)
+ * @return BOOLEAN TRUE if the information was successfully retrieved, FALSE otherwise
  */
 static BOOLEAN
-SymSrvGetFileIndexInfoFallback(PVOID Context, CHAR * PdbFile, SIZE_T PdbFileSize, GUID * Guid, DWORD * Age)
+SymGetFileRsdsIdentityOrFileIndexInfo(PVOID Context, CHAR * PdbFile, SIZE_T PdbFileSize, GUID * Guid, DWORD * Age)
 {
-    SYMSRV_INDEX_INFO SymInfo = {0};
-    SymInfo.sizeofstruct      = sizeof(SYMSRV_INDEX_INFO);
+    SYMBOL_RSDS_IDENTITY Identity;
 
     if (Context == NULL || PdbFile == NULL || Guid == NULL || Age == NULL)
     {
         return FALSE;
     }
 
-    if (!SymSrvGetFileIndexInfo((const char *)Context, &SymInfo, 0))
+    if (SymRsdsCacheGetIdentity((const char *)Context, &Identity, NULL) && Identity.IsRsdsFound)
     {
-        return FALSE;
-    }
+        if (FAILED(StringCchCopyA(PdbFile, PdbFileSize, Identity.PdbFile)))
+        {
+            return FALSE;
+        }
 
-    if (FAILED(StringCchCopyA(PdbFile, PdbFileSize, SymInfo.pdbfile)))
-    {
-        return FALSE;
-    }
+        *Guid = Identity.Guid;
+        *Age  = Identity.Age;
 
-    *Guid = SymInfo.guid;
-    *Age  = SymInfo.age;
+        return TRUE;
+    }
 
-    return TRUE;
+    return SymSrvGetFileIndexInfoFallback(Context, PdbFile, PdbFileSize, Guid, Age);
 }
 
 /**
@@ -788,6 +773,11 @@ SymUnloadModuleSymbol(char * ModuleName)
 
             free(item);
 
+            //
+            // The compiled type layouts are based on the module base
+            //
+            SymClearTypeLayouts();
+
             break;
         }
     }
@@ -869,6 +859,11 @@ SymUnloadAllSymbols()
     //
     g_LoadedModules.clear();
 
+    //
+    // Remove the compiled type layouts
+    //
+    SymClearTypeLayouts();
+
     //
     // Uninitialize DbgHelp
     //
@@ -1037,10 +1032,10 @@ SymConvertNameToAddress(const char * FunctionOrVariableName, PBOOLEAN WasFound)
 BOOLEAN
 SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset)
 {
-    BOOL                          Ret        = FALSE;
-    UINT32                        Index      = 0;
-    PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo = NULL;
-    BOOLEAN                       Result     = FALSE;
+    UINT32                            Index      = 0;
+    PSYMBOL_LOADED_MODULE_DETAILS     SymbolInfo = NULL;
+    const SYMBOL_TYPE_LAYOUT *        Layout     = NULL;
+    const SYMBOL_TYPE_LAYOUT_MEMBER * Member     = NULL;
 
     //
     // Find module info
@@ -1074,44 +1069,28 @@ SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset)
     }
 
     //
-    // Convert TypeName to wide-char, it's because SymGetTypeInfo supports
-    // wide-char
+    // The type is compiled once, the next queries only search the table
     //
-    const SIZE_T TypeNameSize = strlen(TypeName) + 1;
-    WCHAR *      TypeNameW    = (WCHAR *)malloc(sizeof(wchar_t) * TypeNameSize);
+    Layout = SymGetTypeLayoutFromModule(SymbolInfo->ModuleBase, TypeName);
 
-    if (TypeNameW == NULL)
+    if (Layout == NULL)
     {
-        printf("err, could not allocate buffer");
         return FALSE;
     }
 
-    RtlZeroMemory(TypeNameW, sizeof(wchar_t) * TypeNameSize);
-    mbstowcs(TypeNameW, TypeName, TypeNameSize);
+    Member = SymFindTypeLayoutMember(Layout, FieldName);
 
-    //
-    // Convert FieldName to wide-char, it's because SymGetTypeInfo supports
-    // wide-char
-    //
-    const SIZE_T FieldNameSize = strlen(FieldName) + 1;
-    WCHAR *      FieldNameW    = (WCHAR *)malloc(sizeof(wchar_t) * FieldNameSize);
-
-    if (FieldNameW == NULL)
+    if (Member == NULL)
     {
-        printf("err, could not allocate buffer");
-        free(TypeNameW);
         return FALSE;
     }
 
-    RtlZeroMemory(FieldNameW, sizeof(wchar_t) * FieldNameSize);
-    mbstowcs(FieldNameW, FieldName, FieldNameSize);
-
-    Result = SymGetFieldOffsetFromModule(SymbolInfo->ModuleBase, TypeNameW, FieldNameW, FieldOffset);
-
-    free(TypeNameW);
-    free(FieldNameW);
+    //
+    // The single bits are queried by their bit position
+    //
+    *FieldOffset = Member->BitLength == 1 ? Member->BitPosition : Member->Offset;
 
-    return Result;
+    return TRUE;
 }
 
 /**
@@ -1125,10 +1104,9 @@ SymGetFieldOffset(CHAR * TypeName, CHAR * FieldName, UINT32 * FieldOffset)
 BOOLEAN
 SymGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize)
 {
-    BOOL                          Ret        = FALSE;
     UINT32                        Index      = 0;
     PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo = NULL;
-    BOOLEAN                       Result     = FALSE;
+    const SYMBOL_TYPE_LAYOUT *    Layout     = NULL;
 
     //
     // Find module info
@@ -1161,27 +1139,49 @@ SymGetDataTypeSize(CHAR * TypeName, UINT64 * TypeSize)
         Index++;
     }
 
-    //
-    // Convert FieldName to wide-char, it's because SymGetTypeInfo supports
-    // wide-char
-    //
-    const SIZE_T TypeNameSize = strlen(TypeName) + 1;
-    WCHAR *      TypeNameW    = (WCHAR *)malloc(sizeof(wchar_t) * TypeNameSize);
+    Layout = SymGetTypeLayoutFromModule(SymbolInfo->ModuleBase, TypeName);
 
-    if (TypeNameW == NULL)
+    if (Layout == NULL)
     {
-        printf("err, could not allocate buffer");
         return FALSE;
     }
 
-    RtlZeroMemory(TypeNameW, sizeof(wchar_t) * TypeNameSize);
-    mbstowcs(TypeNameW, TypeName, TypeNameSize);
+    *TypeSize = Layout->TypeSize;
 
-    Result = SymGetDataTypeSizeFromModule(SymbolInfo->ModuleBase, TypeNameW, TypeSize);
+    return TRUE;
+}
 
-    free(TypeNameW);
+/**
+ * @brief Get the compiled layout of a type (structure) from the symbols
+ *
+ * @param TypeName the type (structure) name to query
+ *
+ * @return const SYMBOL_TYPE_LAYOUT * NULL if the type is not found, the
+ * layout is valid until the symbols are unloaded
+ */
+const SYMBOL_TYPE_LAYOUT *
+SymGetTypeLayout(const CHAR * TypeName)
+{
+    PSYMBOL_LOADED_MODULE_DETAILS SymbolInfo = NULL;
+    const CHAR *                  Separator  = NULL;
 
-    return Result;
+    //
+    // Find module info
+    //
+    SymbolInfo = SymGetModuleBaseFromSearchMask(TypeName, TRUE);
+
+    if (SymbolInfo == NULL)
+    {
+        return NULL;
+    }
+
+    //
+    // Remove the *!Name from TypeName as it not supports module name
+    // at the beginning of a type name
+    //
+    Separator = strchr(TypeName, '!');
+
+    return SymGetTypeLayoutFromModule(SymbolInfo->ModuleBase, Separator != NULL ? Separator + 1 : TypeName);
 }
 
 /**
@@ -1782,24 +1782,24 @@ SymTagStr(ULONG Tag)
 BOOLEAN
 SymConvertFileToPdbPath(const char * LocalFilePath, char * ResultPath, SIZE_T ResultPathSize)
 {
-    std::vector<BYTE> FileBytes;
-
     if (LocalFilePath == NULL && ResultPath == NULL)
     {
         return FALSE;
     }
 
-    SymReadFileBytes(LocalFilePath, FileBytes);
-
-    return SymFormatPdbIdentityFromPeImageOrFallback(FileBytes.empty() ? NULL : FileBytes.data(),
-                                                     FileBytes.size(),
+    //
+    // The image is not read here, the identity is taken from the cache (or the
+    // headers of the file) by the callback
+    //
+    return SymFormatPdbIdentityFromPeImageOrFallback(NULL,
+                                                     0,
                                                      ResultPath,
                                                      ResultPathSize,
                                                      NULL,
                                                      0,
                                                      NULL,
                                                      0,
-                                                     SymSrvGetFileIndexInfoFallback,
+                                                     SymGetFileRsdsIdentityOrFileIndexInfo,
                                                      (PVOID)LocalFilePath);
 }
 
@@ -1853,9 +1853,8 @@ SymConvertWow64CompatibilityPaths(const char * LocalFilePath, std::string & Wow6
 BOOLEAN
 SymConvertFileToPdbFileAndGuidAndAgeDetails(const char * LocalFilePath, char * PdbFilePath, char * GuidAndAgeDetails, BOOLEAN Is32BitModule)
 {
-    std::string       Wow64ConvertedPath;
-    std::vector<BYTE> FileBytes;
-    const char *      ActualLocalFilePath = NULL;
+    std::string  Wow64ConvertedPath;
+    const char * ActualLocalFilePath = NULL;
 
     if (Is32BitModule)
     {
@@ -1870,17 +1869,15 @@ SymConvertFileToPdbFileAndGuidAndAgeDetails(const char * LocalFilePath, char * P
 
     // ShowMessages("the final (actual) address is: %s\n", ActualLocalFilePath);
 
-    SymReadFileBytes(ActualLocalFilePath, FileBytes);
-
-    return SymFormatPdbIdentityFromPeImageOrFallback(FileBytes.empty() ? NULL : FileBytes.data(),
-                                                     FileBytes.size(),
+    return SymFormatPdbIdentityFromPeImageOrFallback(NULL,
+                                                     0,
                                                      NULL,
                                                      0,
                                                      PdbFilePath,
                                                      MAX_PATH,
                                                      GuidAndAgeDetails,
                                                      MAXIMUM_GUID_AND_AGE_SIZE,
-                                                     SymSrvGetFileIndexInfoFallback,
+                                                     SymGetFileRsdsIdentityOrFileIndexInfo,
                                                      (PVOID)ActualLocalFilePath);
 }
 
@@ -1916,7 +1913,7 @@ SymConvertLoadedModuleToPdbFileAndGuidAndAgeDetails(const BYTE * LoadedImageByte
                                                            MAX_PATH,
                                                            GuidAndAgeDetails,
                                                            MAXIMUM_GUID_AND_AGE_SIZE,
-                                                           SymSrvGetFileIndexInfoFallback,
+                                                           SymGetFileRsdsIdentityOrFileIndexInfo,
                                                            (PVOID)ActualLocalFilePath);
 }
 
@@ -0,0 +1,600 @@
+/**
+ * @file type-layout.cpp
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Compiled type layouts
+ * @details A type is compiled once (for each module) into a flat table of its
+ * members, so the next queries of the type (dt, field offsets, and sizes) don't
+ * call DbgHelp again
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#include "pch.h"
+
+//
+// Global Variables
+//
+std::unordered_map<std::string, std::unique_ptr<SYMBOL_TYPE_LAYOUT_ENTRY>> g_TypeLayouts;
+
+/**
+ * @brief Add a name to the pool of the names of a layout
+ *
+ * @param Entry
+ * @param Name
+ *
+ * @return UINT32 Offset of the name in the pool
+ */
+static UINT32
+SymTypeLayoutAddName(PSYMBOL_TYPE_LAYOUT_ENTRY Entry, const std::string & Name)
+{
+    UINT32 Offset = (UINT32)Entry->Names.size();
+
+    Entry->Names.append(Name);
+    Entry->Names.push_back('\0');
+
+    return Offset;
+}
+
+/**
+ * @brief Get the name of a symbol
+ *
+ * @param Base
+ * @param TypeIndex
+ *
+ * @return std::string Empty if the symbol doesn't have a name
+ */
+static std::string
+SymTypeLayoutGetSymbolName(UINT64 Base, ULONG TypeIndex)
+{
+    WCHAR * Name                     = NULL;
+    CHAR    NameBuffer[MAX_SYM_NAME] = {0};
+
+    if (!SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_SYMNAME, &Name) || Name == NULL)
+    {
+        return std::string();
+    }
+
+    if (wcstombs(NameBuffer, Name, sizeof(NameBuffer) - 1) == (size_t)-1)
+    {
+        NameBuffer[0] = '\0';
+    }
+
+    LocalFree(Name);
+
+    return std::string(NameBuffer);
+}
+
+/**
+ * @brief Skip the typedefs of a type
+ *
+ * @param Base
+ * @param TypeIndex
+ *
+ * @return ULONG
+ */
+static ULONG
+SymTypeLayoutResolveTypedefs(UINT64 Base, ULONG TypeIndex)
+{
+    DWORD Tag = SymTagNull;
+
+    for (UINT32 i = 0; i < SYMBOL_TYPE_LAYOUT_MAXIMUM_DEPTH; i++)
+    {
+        if (!SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_SYMTAG, &Tag) || Tag != SymTagTypedef ||
+            !SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_TYPEID, &TypeIndex))
+        {
+            break;
+        }
+    }
+
+    return TypeIndex;
+}
+
+/**
+ * @brief Get the children of a type
+ *
+ * @param Base
+ * @param TypeIndex
+ * @param Children
+ *
+ * @return VOID
+ */
+static VOID
+SymTypeLayoutGetChildren(UINT64 Base, ULONG TypeIndex, std::vector<ULONG> & Children)
+{
+    DWORD ChildrenCount = 0;
+
+    Children.clear();
+
+    if (!SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_CHILDRENCOUNT, &ChildrenCount) || ChildrenCount == 0)
+    {
+        return;
+    }
+
+    std::vector<UINT8> FindChildrenParamsBacking(sizeof(TI_FINDCHILDREN_PARAMS) + ChildrenCount * sizeof(ULONG));
+    auto               FindChildrenParams = (TI_FINDCHILDREN_PARAMS *)FindChildrenParamsBacking.data();
+
+    FindChildrenParams->Count = ChildrenCount;
+    FindChildrenParams->Start = 0;
+
+    if (SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_FINDCHILDREN, FindChildrenParams))
+    {
+        Children.assign(FindChildrenParams->ChildId, FindChildrenParams->ChildId + ChildrenCount);
+    }
+}
+
+/**
+ * @brief Get the name of a basic type (the same names as WinDbg)
+ *
+ * @param BasicType
+ * @param Length
+ *
+ * @return std::string
+ */
+static std::string
+SymTypeLayoutGetBasicTypeName(DWORD BasicType, UINT64 Length)
+{
+    switch (BasicType)
+    {
+    case SYMBOL_BASIC_TYPE_VOID:
+        return "Void";
+    case SYMBOL_BASIC_TYPE_CHAR:
+        return "Char";
+    case SYMBOL_BASIC_TYPE_WCHAR:
+        return "Wchar";
+    case SYMBOL_BASIC_TYPE_BOOL:
+        return "Bool";
+    case SYMBOL_BASIC_TYPE_HRESULT:
+        return "HRESULT";
+    case SYMBOL_BASIC_TYPE_FLOAT:
+        return Length == 4 ? "Float" : "Double";
+    case SYMBOL_BASIC_TYPE_INT:
+    case SYMBOL_BASIC_TYPE_LONG:
+        return Length == 1 ? "Char" : "Int" + std::to_string(Length) + "B";
+    default:
+        return Length == 1 ? "UChar" : "Uint" + std::to_string(Length) + "B";
+    }
+}
+
+/**
+ * @brief Get the name of a type
+ *
+ * @param Base
+ * @param TypeIndex
+ * @param Depth
+ *
+ * @return std::string
+ */
+static std::string
+SymTypeLayoutGetTypeName(UINT64 Base, ULONG TypeIndex, UINT32 Depth)
+{
+    DWORD   Tag         = SymTagNull;
+    DWORD   BasicType   = 0;
+    ULONG   InnerType   = 0;
+    ULONG64 Length      = 0;
+    ULONG64 InnerLength = 0;
+
+    TypeIndex = SymTypeLayoutResolveTypedefs(Base, TypeIndex);
+
+    if (Depth >= SYMBOL_TYPE_LAYOUT_MAXIMUM_DEPTH ||
+        !SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_SYMTAG, &Tag))
+    {
+        return "?";
+    }
+
+    SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_LENGTH, &Length);
+
+    switch (Tag)
+    {
+    case SymTagBaseType:
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_BASETYPE, &BasicType);
+        return SymTypeLayoutGetBasicTypeName(BasicType, Length);
+
+    case SymTagPointerType:
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_TYPEID, &InnerType);
+        return (Length == 4 ? "Ptr32 " : "Ptr64 ") + SymTypeLayoutGetTypeName(Base, InnerType, Depth + 1);
+
+    case SymTagArrayType:
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_TYPEID, &InnerType);
+        SymGetTypeInfo(GetCurrentProcess(), Base, SymTypeLayoutResolveTypedefs(Base, InnerType), TI_GET_LENGTH, &InnerLength);
+
+        return "[" + std::to_string(InnerLength != 0 ? Length / InnerLength : 0) + "] " +
+               SymTypeLayoutGetTypeName(Base, InnerType, Depth + 1);
+
+    case SymTagUDT:
+    case SymTagEnum:
+
+        return SymTypeLayoutGetSymbolName(Base, TypeIndex);
+
+    case SymTagFunctionType:
+
+        return "Function";
+
+    default:
+
+        return "?";
+    }
+}
+
+/**
+ * @brief Get the kind of a type
+ *
+ * @param Base
+ * @param TypeIndex A type without typedefs
+ * @param IsSigned
+ *
+ * @return SYMBOL_TYPE_LAYOUT_KIND
+ */
+static SYMBOL_TYPE_LAYOUT_KIND
+SymTypeLayoutGetKind(UINT64 Base, ULONG TypeIndex, BOOLEAN * IsSigned)
+{
+    DWORD Tag       = SymTagNull;
+    DWORD BasicType = 0;
+
+    *IsSigned = FALSE;
+
+    SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_SYMTAG, &Tag);
+
+    switch (Tag)
+    {
+    case SymTagBaseType:
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, TypeIndex, TI_GET_BASETYPE, &BasicType);
+
+        if (BasicType == SYMBOL_BASIC_TYPE_FLOAT)
+        {
+            return SYMBOL_TYPE_LAYOUT_KIND_FLOAT;
+        }
+
+        *IsSigned = BasicType == SYMBOL_BASIC_TYPE_CHAR || BasicType == SYMBOL_BASIC_TYPE_INT ||
+                    BasicType == SYMBOL_BASIC_TYPE_LONG || BasicType == SYMBOL_BASIC_TYPE_HRESULT;
+
+        return SYMBOL_TYPE_LAYOUT_KIND_INTEGER;
+
+    case SymTagPointerType:
+        return SYMBOL_TYPE_LAYOUT_KIND_POINTER;
+
+    case SymTagArrayType:
+        return SYMBOL_TYPE_LAYOUT_KIND_ARRAY;
+
+    case SymTagEnum:
+        return SYMBOL_TYPE_LAYOUT_KIND_ENUM;
+
+    case SymTagUDT:
+        return SYMBOL_TYPE_LAYOUT_KIND_UDT;
+
+    default:
+        return SYMBOL_TYPE_LAYOUT_KIND_OTHER;
+    }
+}
+
+/**
+ * @brief Add the values of an enum to a layout (once for each enum)
+ *
+ * @param Base
+ * @param TypeIndex
+ * @param Entry
+ * @param Member
+ *
+ * @return VOID
+ */
+static VOID
+SymTypeLayoutAddEnumerators(UINT64 Base, ULONG TypeIndex, PSYMBOL_TYPE_LAYOUT_ENTRY Entry, SYMBOL_TYPE_LAYOUT_MEMBER * Member)
+{
+    std::vector<ULONG> Children;
+    auto               Found = Entry->EnumRanges.find(TypeIndex);
+
+    if (Found == Entry->EnumRanges.end())
+    {
+        UINT32 First = (UINT32)Entry->Enumerators.size();
+
+        SymTypeLayoutGetChildren(Base, TypeIndex, Children);
+
+        for (ULONG Child : Children)
+        {
+            SYMBOL_TYPE_LAYOUT_ENUMERATOR Enumerator = {0};
+            VARIANT                       Value;
+
+            VariantInit(&Value);
+
+            if (!SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_VALUE, &Value))
+            {
+                continue;
+            }
+
+            switch (Value.vt)
+            {
+            case VT_I1:
+                Enumerator.Value = (UINT64)(INT64)Value.cVal;
+                break;
+            case VT_I2:
+                Enumerator.Value = (UINT64)(INT64)Value.iVal;
+                break;
+            case VT_I4:
+            case VT_INT:
+                Enumerator.Value = (UINT64)(INT64)Value.lVal;
+                break;
+            case VT_I8:
+                Enumerator.Value = (UINT64)Value.llVal;
+                break;
+            case VT_UI1:
+                Enumerator.Value = Value.bVal;
+                break;
+            case VT_UI2:
+                Enumerator.Value = Value.uiVal;
+                break;
+            case VT_UI4:
+            case VT_UINT:
+                Enumerator.Value = Value.ulVal;
+                break;
+            case VT_UI8:
+                Enumerator.Value = Value.ullVal;
+                break;
+            default:
+                continue;
+            }
+
+            Enumerator.Name = SymTypeLayoutAddName(Entry, SymTypeLayoutGetSymbolName(Base, Child));
+            Entry->Enumerators.push_back(Enumerator);
+        }
+
+        Found = Entry->EnumRanges.emplace(TypeIndex, std::make_pair(First, (UINT32)Entry->Enumerators.size() - First)).first;
+    }
+
+    Member->FirstEnumerator     = Found->second.first;
+    Member->NumberOfEnumerators = Found->second.second;
+}
+
+/**
+ * @brief Add the data members of a type (and of its nested types) to a layout
+ *
+ * @details The members of each type are contiguous, so the members of the
+ * nested types are added after all of the members of their parent
+ *
+ * @param Base
+ * @param TypeIndex
+ * @param BaseOffset Offset of the type from the top of the compiled type
+ * @param Depth
+ * @param Entry
+ * @param FirstMember
+ * @param NumberOfMembers
+ *
+ * @return VOID
+ */
+static VOID
+SymTypeLayoutAddMembers(UINT64                    Base,
+                        ULONG                     TypeIndex,
+                        UINT32                    BaseOffset,
+                        UINT32                    Depth,
+                        PSYMBOL_TYPE_LAYOUT_ENTRY Entry,
+                        UINT32 *                  FirstMember,
+                        UINT32 *                  NumberOfMembers)
+{
+    std::vector<ULONG> Children;
+    UINT32             First = (UINT32)Entry->Members.size();
+
+    SymTypeLayoutGetChildren(Base, TypeIndex, Children);
+
+    for (ULONG Child : Children)
+    {
+        SYMBOL_TYPE_LAYOUT_MEMBER Member     = {0};
+        DWORD                     Tag        = SymTagNull;
+        DWORD                     DataKind   = SYMBOL_DATA_KIND_MEMBER;
+        DWORD                     Offset     = 0;
+        DWORD                     BitPos     = 0;
+        ULONG64                   BitLength  = 0;
+        ULONG64                   Length     = 0;
+        ULONG                     MemberType = 0;
+        BOOLEAN                   IsSigned   = FALSE;
+
+        if (Entry->Members.size() >= SYMBOL_TYPE_LAYOUT_MAXIMUM_MEMBERS)
+        {
+            break;
+        }
+
+        //
+        // Only the data members are a part of the layout (not the static
+        // members, the functions, the base classes, and the nested types)
+        //
+        SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_SYMTAG, &Tag);
+        SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_DATAKIND, &DataKind);
+
+        if (Tag != SymTagData || DataKind != SYMBOL_DATA_KIND_MEMBER ||
+            !SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_TYPEID, &MemberType))
+        {
+            continue;
+        }
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_OFFSET, &Offset);
+
+        MemberType = SymTypeLayoutResolveTypedefs(Base, MemberType);
+
+        SymGetTypeInfo(GetCurrentProcess(), Base, MemberType, TI_GET_LENGTH, &Length);
+
+        Member.Name     = SymTypeLayoutAddName(Entry, SymTypeLayoutGetSymbolName(Base, Child));
+        Member.TypeName = SymTypeLayoutAddName(Entry, SymTypeLayoutGetTypeName(Base, MemberType, 0));
+        Member.Offset   = BaseOffset + Offset;
+        Member.Size     = (UINT32)Length;
+        Member.Kind     = (UINT8)SymTypeLayoutGetKind(Base, MemberType, &IsSigned);
+        Member.IsSigned = IsSigned;
+
+        //
+        // The bit position is only available for the bitfields (the length of
+        // the member itself is the number of its bits)
+        //
+        if (SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_BITPOSITION, &BitPos) &&
+            SymGetTypeInfo(GetCurrentProcess(), Base, Child, TI_GET_LENGTH, &BitLength))
+        {
+            Member.BitPosition = (UINT8)BitPos;
+            Member.BitLength   = (UINT8)BitLength;
+        }
+
+        if (Member.Kind == SYMBOL_TYPE_LAYOUT_KIND_ARRAY)
+        {
+            ULONG   ElementType   = 0;
+            ULONG64 ElementLength = 0;
+            BOOLEAN IsElementSigned;
+
+            SymGetTypeInfo(GetCurrentProcess(), Base, MemberType, TI_GET_TYPEID, &ElementType);
+
+            ElementType = SymTypeLayoutResolveTypedefs(Base, ElementType);
+
+            SymGetTypeInfo(GetCurrentProcess(), Base, ElementType, TI_GET_LENGTH, &ElementLength);
+
+            Member.ElementSize = (UINT32)ElementLength;
+            Member.ElementKind = (UINT8)SymTypeLayoutGetKind(Base, ElementType, &IsElementSigned);
+            Member.IsSigned    = IsElementSigned;
+        }
+        else if (Member.Kind == SYMBOL_TYPE_LAYOUT_KIND_ENUM)
+        {
+            SymTypeLayoutAddEnumerators(Base, MemberType, Entry, &Member);
+        }
+        else if (Member.Kind == SYMBOL_TYPE_LAYOUT_KIND_UDT)
+        {
+            Member.IsUnnamed = Entry->Names[Member.TypeName] == '<' || Entry->Names[Member.TypeName] == '\0';
+        }
+
+        Entry->Members.push_back(Member);
+        Entry->MemberTypes.push_back(MemberType);
+    }
+
+    *FirstMember     = First;
+    *NumberOfMembers = (UINT32)Entry->Members.size() - First;
+
+    //
+    // Add the members of the nested structures and unions
+    //
+    if (Depth + 1 < SYMBOL_TYPE_LAYOUT_MAXIMUM_DEPTH)
+    {
+        for (UINT32 i = First; i < First + *NumberOfMembers; i++)
+        {
+            UINT32 FirstChild;
+            UINT32 NumberOfChildren;
+
+            if (Entry->Members[i].Kind != SYMBOL_TYPE_LAYOUT_KIND_UDT)
+            {
+                continue;
+            }
+
+            SymTypeLayoutAddMembers(Base, Entry->MemberTypes[i], Entry->Members[i].Offset, Depth + 1, Entry, &FirstChild, &NumberOfChildren);
+
+            Entry->Members[i].FirstChild       = FirstChild;
+            Entry->Members[i].NumberOfChildren = NumberOfChildren;
+        }
+    }
+}
+
+/**
+ * @brief Get the compiled layout of a type (the type is compiled on the first
+ * query)
+ *
+ * @param Base
+ * @param TypeName Name of the type without the module name
+ *
+ * @return const SYMBOL_TYPE_LAYOUT * NULL if the type is not found
+ */
+const SYMBOL_TYPE_LAYOUT *
+SymGetTypeLayoutFromModule(UINT64 Base, const CHAR * TypeName)
+{
+    std::string Key   = std::to_string(Base) + "!" + TypeName;
+    auto        Found = g_TypeLayouts.find(Key);
+    UINT64      TypeSize;
+    UINT32      FirstMember;
+    UINT32      NumberOfMembers;
+
+    if (Found != g_TypeLayouts.end())
+    {
+        return &Found->second->Layout;
+    }
+
+    //
+    // Allocate a buffer to back the SYMBOL_INFO structure
+    //
+    const DWORD SizeOfStruct =
+        sizeof(SYMBOL_INFOW) + ((MAX_SYM_NAME - 1) * sizeof(wchar_t));
+    UINT8 SymbolInfoBuffer[SizeOfStruct];
+    auto  SymbolInfo = PSYMBOL_INFOW(SymbolInfoBuffer);
+
+    SymbolInfo->SizeOfStruct = sizeof(SYMBOL_INFOW);
+    SymbolInfo->MaxNameLen   = MAX_SYM_NAME;
+
+    //
+    // Convert TypeName to wide-char, it's because SymGetTypeFromNameW supports
+    // wide-char
+    //
+    std::vector<WCHAR> TypeNameW(strlen(TypeName) + 1, 0);
+    mbstowcs(TypeNameW.data(), TypeName, TypeNameW.size());
+
+    if (!SymGetTypeFromNameW(GetCurrentProcess(), Base, TypeNameW.data(), SymbolInfo) ||
+        !SymGetTypeInfo(GetCurrentProcess(), Base, SymbolInfo->TypeIndex, TI_GET_LENGTH, &TypeSize))
+    {
+        return NULL;
+    }
+
+    auto Entry = std::make_unique<SYMBOL_TYPE_LAYOUT_ENTRY>();
+
+    Entry->Layout          = {0};
+    Entry->Layout.TypeSize = TypeSize;
+    Entry->Layout.TypeName = SymTypeLayoutAddName(Entry.get(), TypeName);
+
+    SymTypeLayoutAddMembers(Base,
+                            SymTypeLayoutResolveTypedefs(Base, SymbolInfo->TypeIndex),
+                            0,
+                            0,
+                            Entry.get(),
+                            &FirstMember,
+                            &NumberOfMembers);
+
+    //
+    // The tables don't change anymore
+    //
+    Entry->MemberTypes.clear();
+    Entry->MemberTypes.shrink_to_fit();
+    Entry->EnumRanges.clear();
+
+    Entry->Layout.NumberOfMembers         = (UINT32)Entry->Members.size();
+    Entry->Layout.NumberOfTopLevelMembers = NumberOfMembers;
+    Entry->Layout.NumberOfEnumerators     = (UINT32)Entry->Enumerators.size();
+    Entry->Layout.Members                 = Entry->Members.data();
+    Entry->Layout.Enumerators             = Entry->Enumerators.data();
+    Entry->Layout.Names                   = Entry->Names.c_str();
+
+    return &g_TypeLayouts.emplace(Key, std::move(Entry)).first->second->Layout;
+}
+
+/**
+ * @brief Find a member of a type (not a member of its nested types)
+ *
+ * @param Layout
+ * @param FieldName
+ *
+ * @return const SYMBOL_TYPE_LAYOUT_MEMBER * NULL if it's not found
+ */
+const SYMBOL_TYPE_LAYOUT_MEMBER *
+SymFindTypeLayoutMember(const SYMBOL_TYPE_LAYOUT * Layout, const CHAR * FieldName)
+{
+    for (UINT32 i = 0; i < Layout->NumberOfTopLevelMembers; i++)
+    {
+        if (strcmp(Layout->Names + Layout->Members[i].Name, FieldName) == 0)
+        {
+            return &Layout->Members[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remove the compiled layouts (the symbols are unloaded)
+ *
+ * @return VOID
+ */
+VOID
+SymClearTypeLayouts()
+{
+    g_TypeLayouts.clear();
+}
@@ -0,0 +1,64 @@
+/**
+ * @file rsds-reader.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of reading the CodeView RSDS identity of the image files
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Name of the cache file of the identities (next to the executable)
+ *
+ */
+#define SYMBOL_RSDS_CACHE_FILE_NAME "symbol-identity.cache"
+
+/**
+ * @brief First line of the cache file (the file is ignored if it differs)
+ *
+ */
+#define SYMBOL_RSDS_CACHE_SIGNATURE "hyperdbg-rsds-cache 1"
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief The CodeView identity of an image file and the state of the file
+ * that it's read from
+ *
+ */
+typedef struct _SYMBOL_RSDS_IDENTITY
+{
+    UINT64  FileSize;
+    UINT64  LastWriteTime;
+    BOOLEAN IsRsdsFound; // the file is read but it has no valid RSDS record
+    GUID    Guid;
+    DWORD   Age;
+    CHAR    PdbFile[MAX_PATH];
+
+} SYMBOL_RSDS_IDENTITY, *PSYMBOL_RSDS_IDENTITY;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+BOOLEAN
+SymReadRsdsIdentityFromFile(const CHAR * FilePath, SYMBOL_RSDS_IDENTITY * Identity);
+
+BOOLEAN
+SymRsdsCacheGetIdentity(const CHAR * FilePath, SYMBOL_RSDS_IDENTITY * Identity, BOOLEAN * IsCacheHit);
+
+VOID
+SymRsdsCacheSetFilePath(const CHAR * CacheFilePath);
+
+VOID
+SymRsdsCacheUnload();
@@ -0,0 +1,84 @@
+/**
+ * @file type-layout.h
+ * @author Sina Karvandi (sina@hyperdbg.org)
+ * @brief Headers of the compiled type layouts
+ * @details
+ * @version 0.21
+ * @date 2026-10-18
+ *
+ * @copyright This project is released under the GNU Public License v3.
+ *
+ */
+#pragma once
+
+//////////////////////////////////////////////////
+//					Constants                   //
+//////////////////////////////////////////////////
+
+/**
+ * @brief Maximum depth of the nested (inline) types that are compiled
+ *
+ */
+#define SYMBOL_TYPE_LAYOUT_MAXIMUM_DEPTH 8
+
+/**
+ * @brief Maximum number of the members of a compiled type (with the members
+ * of its nested types)
+ *
+ */
+#define SYMBOL_TYPE_LAYOUT_MAXIMUM_MEMBERS 0x10000
+
+//
+// Basic types of DbgHelp (BasicType of cvconst.h)
+//
+#define SYMBOL_BASIC_TYPE_VOID    1
+#define SYMBOL_BASIC_TYPE_CHAR    2
+#define SYMBOL_BASIC_TYPE_WCHAR   3
+#define SYMBOL_BASIC_TYPE_INT     6
+#define SYMBOL_BASIC_TYPE_UINT    7
+#define SYMBOL_BASIC_TYPE_FLOAT   8
+#define SYMBOL_BASIC_TYPE_BOOL    10
+#define SYMBOL_BASIC_TYPE_LONG    13
+#define SYMBOL_BASIC_TYPE_ULONG   14
+#define SYMBOL_BASIC_TYPE_HRESULT 31
+
+//
+// Kind of the data members of DbgHelp (DataIsMember of cvconst.h)
+//
+#define SYMBOL_DATA_KIND_MEMBER 7
+
+//////////////////////////////////////////////////
+//					Structures                  //
+//////////////////////////////////////////////////
+
+/**
+ * @brief A compiled type layout and the storage of its tables
+ *
+ */
+typedef struct _SYMBOL_TYPE_LAYOUT_ENTRY
+{
+    SYMBOL_TYPE_LAYOUT                         Layout;
+    std::vector<SYMBOL_TYPE_LAYOUT_MEMBER>     Members;
+    std::vector<SYMBOL_TYPE_LAYOUT_ENUMERATOR> Enumerators;
+    std::string                                Names;
+
+    //
+    // Only used while the type is compiled
+    //
+    std::vector<ULONG>                                    MemberTypes;
+    std::unordered_map<ULONG, std::pair<UINT32, UINT32>> EnumRanges;
+
+} SYMBOL_TYPE_LAYOUT_ENTRY, *PSYMBOL_TYPE_LAYOUT_ENTRY;
+
+//////////////////////////////////////////////////
+//					Functions                   //
+//////////////////////////////////////////////////
+
+const SYMBOL_TYPE_LAYOUT *
+SymGetTypeLayoutFromModule(UINT64 Base, const CHAR * TypeName);
+
+const SYMBOL_TYPE_LAYOUT_MEMBER *
+SymFindTypeLayoutMember(const SYMBOL_TYPE_LAYOUT * Layout, const CHAR * FieldName);
+
+VOID
+SymClearTypeLayouts();
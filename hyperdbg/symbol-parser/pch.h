@@ -28,6 +28,8 @@ using namespace std;
 #include <iomanip>
 #include <sstream>
 #include <vector>
+#include <unordered_map>
+#include <memory>
 #include <algorithm>
 #include <strsafe.h>
 #define _NO_CVCONST_H // for symbol parsing
@@ -51,6 +53,7 @@ typedef RFLAGS * PRFLAGS;
 #include "SDK/imports/user/HyperDbgLibImports.h"
 #include "../symbol-parser/header/common-utils.h"
 #include "../symbol-parser/header/symbol-parser.h"
+#include "../symbol-parser/header/type-layout.h"
 
 //
 // Module imports/exports